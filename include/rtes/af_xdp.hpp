@@ -0,0 +1,130 @@
+#pragma once
+
+/**
+ * @file af_xdp.hpp
+ * @brief Minimal AF_XDP transmit socket over the raw syscalls (Linux, no libxdp)
+ *
+ * Just what the UDP publisher's kernel-bypass path needs: a UMEM frame
+ * pool, a TX ring and its completion ring, bound to one queue of one NIC.
+ * Nothing is received, so no XDP program is loaded; the (required) fill
+ * ring is created but never stocked.
+ *
+ *   enqueue ─► [eth|ip|udp|payload] in a free UMEM frame ─► TX ring
+ *   submit  ─► publish the TX producer, kick the kernel if it asks to
+ *   reclaim ◄─ completion ring hands sent frames back to the free list
+ *
+ * Each destination gets its Ethernet/IPv4/UDP header built once by
+ * add_destination(); enqueue() copies it and the datagram into a frame
+ * and patches the three length fields and the IP checksum. Only
+ * multicast destinations are supported: their MAC follows from the group
+ * address, where a unicast one would need ARP.
+ *
+ * Single-threaded: one socket per publisher thread, each on its own NIC
+ * queue. init() returns false when AF_XDP, the interface or the queue is
+ * unavailable (the publisher keeps sending through the kernel); on
+ * non-Linux builds it always does.
+ */
+
+#include <netinet/in.h>
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rtes {
+
+inline constexpr size_t XDP_FRAME_HEADER_BYTES = 14 + 20 + 8;  // Ethernet + IPv4 + UDP
+inline constexpr uint32_t XDP_FRAME_SIZE = 2048;                // UMEM chunk; holds any datagram we send
+
+class AfXdpSocket {
+public:
+    struct Options {
+        std::string interface;       // NIC to transmit on
+        uint32_t    queue{0};        // TX queue of that NIC (one per publisher)
+        uint32_t    frames{4096};    // UMEM frames (rounded up to a power of two)
+        bool        zero_copy{false}; // Require driver zero-copy (else copy mode)
+        uint8_t     ttl{1};          // IPv4 TTL of every frame
+    };
+
+    AfXdpSocket() = default;
+    ~AfXdpSocket();
+
+    AfXdpSocket(const AfXdpSocket&) = delete;
+    AfXdpSocket& operator=(const AfXdpSocket&) = delete;
+
+    /** @return false (errno set) if AF_XDP, the interface or the queue is unavailable */
+    bool init(const Options& options);
+
+    [[nodiscard]] bool ready() const { return fd_ >= 0; }
+
+    /**
+     * Build the frame header toward `dest` once.
+     * @return its id for enqueue(), or -1 (errno = EINVAL) if not multicast
+     */
+    int add_destination(const sockaddr_in& dest);
+
+    /**
+     * Copy one datagram behind destination's header into a free frame and
+     * queue it on the TX ring; sent on submit().
+     * @return false if no frame or TX slot is free even after reclaiming
+     */
+    bool enqueue(int destination, const uint8_t* payload, size_t length);
+
+    /** Publish the queued frames and kick the kernel if it needs waking */
+    void submit();
+
+    /** Frames handed to the kernel and not completed yet */
+    [[nodiscard]] size_t in_flight() const { return frame_count_ - free_frames_.size(); }
+
+    /**
+     * Ethernet/IPv4/UDP header from `src_mac`/`source` to multicast
+     * `dest`, with zero lengths and checksum. source.sin_port = 0 sends
+     * from the destination port.
+     */
+    static std::array<uint8_t, XDP_FRAME_HEADER_BYTES>
+    build_frame_header(const uint8_t (&src_mac)[6], const sockaddr_in& source,
+                       const sockaddr_in& dest, uint8_t ttl);
+
+    /** Patch lengths and IP checksum of a frame whose header carries `payload` bytes */
+    static void finish_frame_header(uint8_t* frame, size_t payload);
+
+private:
+    void reclaim();
+    void release();
+
+    int      fd_{-1};
+    uint8_t  ttl_{1};
+    uint8_t  src_mac_[6]{};
+    sockaddr_in source_{};
+    std::vector<std::array<uint8_t, XDP_FRAME_HEADER_BYTES>> headers_;  // By destination id
+
+    // UMEM
+    uint8_t* umem_{nullptr};
+    size_t   umem_size_{0};
+    uint32_t frame_count_{0};
+    std::vector<uint64_t> free_frames_;  // UMEM offsets, used as a stack
+
+    // TX ring
+    void*     tx_map_{nullptr};
+    size_t    tx_map_size_{0};
+    uint32_t* tx_producer_{nullptr};
+    uint32_t* tx_consumer_{nullptr};
+    uint32_t* tx_flags_{nullptr};
+    void*     tx_descs_{nullptr};
+    uint32_t  tx_mask_{0};
+    uint32_t  tx_local_producer_{0};  // Descriptors written
+    uint32_t  tx_cached_consumer_{0};
+
+    // Completion ring
+    void*     cq_map_{nullptr};
+    size_t    cq_map_size_{0};
+    uint32_t* cq_producer_{nullptr};
+    uint32_t* cq_consumer_{nullptr};
+    uint64_t* cq_addrs_{nullptr};
+    uint32_t  cq_mask_{0};
+};
+
+} // namespace rtes
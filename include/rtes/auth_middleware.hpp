@@ -1,9 +1,15 @@
 #pragma once
 
 #include "security_utils.hpp"
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace rtes {
 
@@ -50,4 +56,95 @@ private:
     bool authorized_;
 };
 
+/** Order-entry operations a session may perform, one bit each */
+enum SessionPermission : uint32_t {
+    SESSION_PLACE_ORDER  = 1u << 0,  // place_order
+    SESSION_CANCEL_ORDER = 1u << 1,  // cancel_order: cancel, modify, mass cancel
+};
+
+/**
+ * What a session keeps after logon: its grant id in the SessionAuthCache
+ * and a snapshot of the grant's permissions, valid while `epoch` is the
+ * cache's epoch.
+ */
+struct SessionGrant {
+    uint32_t id{0};     // [generation:16][slot:16]; 0 = not authenticated
+    uint32_t mask{0};   // SessionPermission bits
+    uint64_t epoch{0};
+};
+
+/**
+ * Authenticate a session once, at logon, and authorize each of its
+ * messages with a bitmask test.
+ *
+ * authenticate() runs the full token check (AuthMiddleware::
+ * validate_session: string hashing, role lookup) and stores the
+ * resulting permissions in a dense slot. The session keeps the slot id
+ * and a copy of the mask. allowed() compares the session's epoch with
+ * the cache's (one acquire load) and tests the mask: no strings, no
+ * locks. Revoking bumps the epoch; each session re-reads its slot on its
+ * next message and sees the mask cleared (or the slot reused, which
+ * clears it as well).
+ *
+ * authenticate(), release() and the revocations lock; allowed() never
+ * does and may run on any number of threads.
+ */
+class SessionAuthCache {
+public:
+    explicit SessionAuthCache(size_t max_sessions);
+
+    SessionAuthCache(const SessionAuthCache&) = delete;
+    SessionAuthCache& operator=(const SessionAuthCache&) = delete;
+
+    /**
+     * Validate a logon token and bind `grant` to a slot. With `client_id`
+     * the token's user must be that client: a session trades as the user
+     * it authenticated. The session's previous grant is released first,
+     * so a refused re-logon leaves it with none.
+     * @return false if refused, bound to another client, or full
+     */
+    bool authenticate(std::string_view token, SessionGrant& grant, std::string_view client_id = {});
+
+    /** The session's current SessionPermission bits (refreshes a stale grant) */
+    [[nodiscard]] uint32_t permissions(SessionGrant& grant) const {
+        if (grant.epoch != epoch_.load(std::memory_order_acquire)) [[unlikely]] refresh(grant);
+        return grant.mask;
+    }
+
+    /** Whether the session holds every bit of `permission` */
+    [[nodiscard]] bool allowed(SessionGrant& grant, uint32_t permission) const {
+        return (permissions(grant) & permission) == permission;
+    }
+
+    /** Free the session's slot (disconnect); the grant is cleared */
+    void release(SessionGrant& grant);
+
+    /** Revoke every live session of a user. @return sessions revoked */
+    size_t revoke_user(std::string_view user_id);
+    void revoke_all();
+
+    [[nodiscard]] uint64_t epoch() const { return epoch_.load(std::memory_order_relaxed); }
+    [[nodiscard]] size_t active() const;
+
+    /** SessionPermission bits an authenticated context is authorized for */
+    static uint32_t permissions_for(const AuthContext& ctx);
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> mask{0};
+        std::atomic<uint16_t> generation{0};
+        std::string           user_id;  // Guarded by mutex_
+        bool                  live{false};
+    };
+
+    void refresh(SessionGrant& grant) const;
+    Slot* slot_of(uint32_t id) const;
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t                  capacity_;
+    std::vector<uint16_t>   free_;
+    mutable std::mutex      mutex_;
+    std::atomic<uint64_t>   epoch_{1};
+};
+
 } // namespace rtes
\ No newline at end of file
@@ -0,0 +1,192 @@
+#pragma once
+
+/**
+ * @file batch_staging.hpp
+ * @brief BATCH entries into risk requests, the part every gateway shares
+ *
+ * TcpGateway (one BATCH frame) and ShmGateway (a slot's request ring)
+ * both hand a run of BatchEntryV2 to the client's risk shard with one
+ * bulk enqueue. BatchStager does what is common to them: the checks that
+ * refuse an entry, the pooled order and the route its reports take back,
+ * and the unwind of whatever the risk lane did not take. Each gateway
+ * only frames the answers (a BATCH_ACK, or one SHM_ACK per entry) from
+ * reason().
+ */
+
+#include "rtes/auth_middleware.hpp"
+#include "rtes/input_validation.hpp"
+#include "rtes/instrument_directory.hpp"
+#include "rtes/memory_pool.hpp"
+#include "rtes/order_id_map.hpp"
+#include "rtes/protocol.hpp"
+#include "rtes/risk_manager.hpp"
+#include "rtes/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rtes {
+
+/** Who a run of entries comes from, as the gateway resolved it at logon */
+struct BatchSender {
+    const ClientID* client_id{nullptr};
+    ClientIDRaw     client_raw{0};     // New orders' owner (directory id; 0 lets risk resolve it)
+    ClientIDRaw     request_owner{0};  // Cancels and modifies: never 0
+    uint32_t        permissions{~0u};  // SessionPermission bits (all without session auth)
+    GatewayReactor  ingress{0};
+    Timestamp       now{0};
+};
+
+/**
+ * Scratch for one run of at most MAX_BATCH_ENTRIES entries, reused run
+ * after run by one gateway thread. `Route` is what the gateway's
+ * OrderIdMap keeps per order to send its reports back.
+ */
+template <typename Route>
+class BatchStager {
+public:
+    /** What the last stage() and submit() counted */
+    struct Counts {
+        uint64_t not_permitted{0};   // Outside the session's grant
+        uint64_t pool_exhausted{0};
+        uint64_t unroutable{0};      // Route table full: the order trades, its reports are lost
+        uint64_t rejected{0};        // Entries answered with a reason other than BATCH_OK
+    };
+
+    BatchStager() {
+        requests_.reserve(MAX_BATCH_ENTRIES);
+        entries_.reserve(MAX_BATCH_ENTRIES);
+    }
+
+    /**
+     * Check `count` entries and stage the ones the gateway takes. Fields
+     * are range-checked for the whole run first, as single messages are
+     * by sanitize_message_fields(). A new order gets a pooled order and,
+     * with `routes`, the `route` its reports follow (also how a repeated
+     * live id is caught). Without an instrument directory every new order
+     * is refused.
+     */
+    void stage(const BatchEntryV2* entries, size_t count, const BatchSender& sender,
+               const InstrumentDirectory* instruments, OrderPool& pool,
+               OrderIdMap<Route>* routes, const Route& route) {
+        requests_.clear();
+        entries_.clear();
+        counts_ = Counts{};
+        count_  = count;
+        (void)MessageValidator::validate_batch_entries(entries, count, valid_);
+
+        for (size_t i = 0; i < count; ++i) {
+            const BatchEntryV2& entry = entries[i];
+            reasons_[i] = BATCH_OK;
+            const uint32_t needed = entry.action == BATCH_NEW_ORDER ? SESSION_PLACE_ORDER : SESSION_CANCEL_ORDER;
+            if (!(sender.permissions & needed)) [[unlikely]] {
+                ++counts_.not_permitted;
+                reasons_[i] = BATCH_NOT_PERMITTED;
+                continue;
+            }
+            // An unknown action fails the range check too: the switch names it
+            if (!valid_[i] && entry.action >= BATCH_NEW_ORDER && entry.action <= BATCH_MODIFY_ORDER) [[unlikely]] {
+                reasons_[i] = BATCH_INVALID_FIELDS;
+                continue;
+            }
+            RiskRequest req;
+
+            switch (entry.action) {
+                case BATCH_NEW_ORDER: {
+                    const Symbol* symbol = instruments ? instruments->symbol(entry.instrument) : nullptr;
+                    if (!symbol) [[unlikely]] {
+                        reasons_[i] = BATCH_UNKNOWN_INSTRUMENT;
+                        continue;
+                    }
+                    // Also catches a repeated id within this run (routed below)
+                    if (routes && routes->contains(entry.order_id)) [[unlikely]] {
+                        reasons_[i] = BATCH_DUPLICATE_ID;
+                        continue;
+                    }
+                    Order* order = pool.allocate();
+                    if (!order) [[unlikely]] {
+                        ++counts_.pool_exhausted;
+                        reasons_[i] = BATCH_POOL_EXHAUSTED;
+                        continue;
+                    }
+                    order->id                 = entry.order_id;
+                    order->client_id          = *sender.client_id;
+                    order->owner              = sender.client_raw;
+                    order->symbol             = *symbol;
+                    order->side               = static_cast<Side>(entry.side);
+                    order->type               = static_cast<OrderType>(entry.order_type);
+                    order->quantity           = entry.quantity;
+                    order->remaining_quantity = entry.quantity;
+                    order->price              = entry.price;
+                    order->display_quantity   = entry.display_quantity;
+                    order->stop_price         = entry.stop_price;
+                    order->hidden_quantity    = 0;
+                    order->status             = OrderStatus::PENDING;
+                    order->timestamp          = sender.now;
+                    order->ingress            = sender.ingress;
+                    if (routes && !routes->insert(entry.order_id, route)) [[unlikely]] {
+                        ++counts_.unroutable;
+                    }
+                    req.type       = RiskRequest::NEW_ORDER;
+                    req.instrument = entry.instrument;
+                    req.order      = order;
+                    break;
+                }
+                case BATCH_CANCEL_ORDER:
+                    req.type            = RiskRequest::CANCEL_ORDER;
+                    req.client_raw      = sender.request_owner;
+                    req.cancel.order_id = entry.order_id;
+                    break;
+                case BATCH_MODIFY_ORDER:
+                    req.type                = RiskRequest::MODIFY_ORDER;
+                    req.client_raw          = sender.request_owner;
+                    req.modify.order_id     = entry.order_id;
+                    req.modify.new_quantity = entry.quantity;
+                    req.modify.new_price    = entry.price;
+                    break;
+                default:
+                    reasons_[i] = BATCH_INVALID_ACTION;
+                    continue;
+            }
+            requests_.push_back(req);
+            entries_.push_back(static_cast<uint16_t>(i));
+        }
+    }
+
+    /**
+     * Hand the staged requests to `risk` with one enqueue. Those the lane
+     * did not take are unwound (order freed, route dropped) and answered
+     * BATCH_QUEUE_FULL. @return requests risk took (the first ones staged)
+     */
+    size_t submit(RiskManager& risk, RiskLane lane, OrderPool& pool, OrderIdMap<Route>* routes) {
+        const size_t staged = requests_.size();
+        const size_t pushed = staged == 0 ? 0 : risk.submit_requests(requests_.data(), staged, lane);
+        for (size_t i = pushed; i < staged; ++i) [[unlikely]] {
+            const RiskRequest& req = requests_[i];
+            if (req.type == RiskRequest::NEW_ORDER) {
+                if (routes) routes->erase(req.order->id);
+                pool.deallocate(req.order);
+            }
+            reasons_[entries_[i]] = BATCH_QUEUE_FULL;
+        }
+        for (size_t i = 0; i < count_; ++i) counts_.rejected += reasons_[i] != BATCH_OK;
+        return pushed;
+    }
+
+    /** BatchRejectReason of entry `entry` of the last run */
+    [[nodiscard]] uint8_t reason(size_t entry) const { return reasons_[entry]; }
+    /** Staged requests, in entry order; the first submit() results were taken */
+    [[nodiscard]] const std::vector<RiskRequest>& requests() const { return requests_; }
+    [[nodiscard]] const Counts& counts() const { return counts_; }
+
+private:
+    std::vector<RiskRequest> requests_;
+    std::vector<uint16_t>    entries_;  // requests_[i] answers entry entries_[i]
+    uint8_t                  reasons_[MAX_BATCH_ENTRIES]{};
+    uint8_t                  valid_[MAX_BATCH_ENTRIES]{};  // validate_batch_entries() per entry
+    size_t                   count_{0};
+    Counts                   counts_;
+};
+
+} // namespace rtes
@@ -0,0 +1,71 @@
+#pragma once
+
+/**
+ * @file bbo_table.hpp
+ * @brief Per-symbol top of book, written by the owning book, read by anyone
+ *
+ * One cache-line slot per symbol, each a Seqlock<BBOSnapshot>, so the
+ * book publishing AAPL never invalidates the line a reader holds for
+ * MSFT. A book publishes into its slot only when its top changed (see
+ * BookChange); risk collars, dashboards and snapshot publishers read any
+ * slot from any thread without asking the engine for anything. Like
+ * ReferencePriceTable, readers resolve Symbol → slot once, off the hot
+ * path.
+ */
+
+#include "rtes/config.hpp"
+#include "rtes/seqlock.hpp"
+#include "rtes/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace rtes {
+
+/** Top of book as published to cross-thread readers */
+struct BBOSnapshot {
+    Price    bid_price{0};
+    Quantity bid_quantity{0};
+    Price    ask_price{0};
+    Quantity ask_quantity{0};
+    uint64_t sequence{0};  // Top changes published so far
+};
+
+struct alignas(64) BBOSlot {
+    Seqlock<BBOSnapshot> bbo;
+
+    /** @return false if the read kept racing the book */
+    [[nodiscard]] bool read(BBOSnapshot& out) const { return bbo.read(out); }
+};
+static_assert(sizeof(BBOSlot) == 64, "BBOSlot fits one cache line");
+
+class BBOTable {
+public:
+    /** One slot per distinct symbol, in config order. */
+    explicit BBOTable(const std::vector<SymbolConfig>& symbols) {
+        for (const auto& sym : symbols) {
+            index_.emplace(Symbol(sym.symbol.c_str()), index_.size());
+        }
+        slots_ = std::make_unique<BBOSlot[]>(index_.size());
+    }
+
+    BBOTable(const BBOTable&) = delete;
+    BBOTable& operator=(const BBOTable&) = delete;
+
+    /** Slot for `symbol`, or nullptr if it was not configured. Cold path. */
+    [[nodiscard]] BBOSlot* slot(const Symbol& symbol) {
+        auto it = index_.find(symbol);
+        return it != index_.end() ? &slots_[it->second] : nullptr;
+    }
+
+    [[nodiscard]] size_t size() const { return index_.size(); }
+
+private:
+    std::unordered_map<Symbol, size_t, Symbol::Hash> index_;
+    std::unique_ptr<BBOSlot[]>                       slots_;
+};
+
+} // namespace rtes
@@ -0,0 +1,86 @@
+#pragma once
+
+/**
+ * @file book_rebalancer.hpp
+ * @brief Moving a symbol's book between shard engines while trading
+ *
+ * Shards are assigned symbols at startup; when one symbol runs hot its
+ * engine thread saturates while another idles. A book can move, in four
+ * steps, with no order lost or reordered:
+ *
+ *   1. to.expect_book()    the target parks what reaches the vacant slot
+ *   2. reroute             producers (risk shards) switch to the target
+ *   3. from.release_book() the source matches what it was sent, detaches
+ *                          the book, waits for its outputs to be read
+ *   4. to.adopt_book()     the target attaches it, replays what it parked
+ *
+ * The symbol pauses from step 2 until step 4 (requests queue up at the
+ * target); the other symbols of both engines keep trading. BookRebalancer
+ * decides what to move; migrate_book() moves it.
+ */
+
+#include "rtes/matching_engine.hpp"
+#include "rtes/types.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace rtes {
+
+struct BookMigrationResult {
+    bool     moved{false};
+    uint64_t pause_ns{0};  // Reroute to adoption: how long the symbol waited
+};
+
+/**
+ * Move `symbol`'s book from `from` to `to`. Both must have a slot for it,
+ * hosted on `from` and vacant on `to`; anything else is refused before
+ * `reroute` runs. `reroute` switches every producer to `to` and returns
+ * once none can still push to `from` for the symbol (false aborts before
+ * anything moved). `lane` is a control lane of both engines nobody else
+ * produces into. One migration per engine at a time; blocks until
+ * done. Once rerouted the move cannot be undone, so only an engine
+ * stopping cuts it short: stop engines after the mover, as Exchange::stop
+ * does, or the symbol's requests stay parked on `to`.
+ */
+BookMigrationResult migrate_book(const Symbol& symbol, MatchingEngine& from, MatchingEngine& to,
+                                 IngressLane lane, const std::function<bool()>& reroute);
+
+/** A move BookRebalancer::sample() proposes */
+struct BookMove {
+    Symbol          symbol;
+    MatchingEngine* from{nullptr};
+    MatchingEngine* to{nullptr};
+    uint64_t        requests{0};  // The book's requests over the last interval
+};
+
+/**
+ * Compares engines' request counts between samples and proposes moving
+ * one book from the busiest to the quietest engine — the book that
+ * evens them out best, never one that would just swap their roles.
+ * Single-threaded: call sample() from one control thread.
+ */
+class BookRebalancer {
+public:
+    struct Options {
+        double   imbalance{1.5};         // Busiest / quietest before anything moves
+        uint64_t min_requests{10000};    // Busiest engine's requests per interval before anything moves
+    };
+
+    BookRebalancer(std::vector<MatchingEngine*> engines, Options options);
+
+    /**
+     * Requests since the last call, per engine and book; a move if the
+     * load is uneven enough and some book would even it out.
+     */
+    [[nodiscard]] std::optional<BookMove> sample();
+
+private:
+    std::vector<MatchingEngine*>       engines_;
+    Options                            options_;
+    std::vector<std::vector<uint64_t>> last_;  // book_requests() at the last sample, per engine
+};
+
+} // namespace rtes
@@ -0,0 +1,152 @@
+#pragma once
+
+/**
+ * @file book_snapshot.hpp
+ * @brief Periodic order book snapshots and warm restart from snapshot + journal tail
+ *
+ * Every snapshot interval an engine copies its books (OrderBook::capture)
+ * between two batches, so the image is consistent and lines up exactly
+ * with the engine's journal sequence: everything up to that record is in
+ * the image, nothing after it. The copy goes into the engine's
+ * BookSnapshotSlot, a single-slot mailbox; the writer thread serializes
+ * it to disk while the engine keeps matching. If the writer is still
+ * busy with the previous image when the next one is due, the engine
+ * skips that snapshot rather than wait.
+ *
+ * File: `snapshot-<engine>-<unix ns>.book`, written to a temporary name,
+ * synced and renamed, so a file that exists is complete. Layout: one
+ * BookSnapshotHeader, then per book a BookImageHeader followed by its
+ * orders (raw Order records, level links cleared).
+ *
+ * Warm restart (restore_engine): load the engine's latest snapshot,
+ * rebuild its books, then replay only the requests that engine journaled
+ * after the snapshot's sequence, with the outputs they caused muted —
+ * they were published by the run that journaled them.
+ */
+
+#include "rtes/event_journal.hpp"
+#include "rtes/matching_engine.hpp"
+#include "rtes/order_book.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rtes {
+
+inline constexpr char     BOOK_SNAPSHOT_MAGIC[8]  = {'R', 'T', 'E', 'S', 'B', 'O', 'O', 'K'};
+inline constexpr uint32_t BOOK_SNAPSHOT_VERSION   = 2;
+inline constexpr size_t   BOOK_SNAPSHOTS_KEPT     = 2;  // Per engine; older files are deleted
+
+/** First bytes of a snapshot file */
+struct BookSnapshotHeader {
+    char     magic[8]{};
+    uint32_t version{BOOK_SNAPSHOT_VERSION};
+    uint32_t order_size{sizeof(Order)};
+    char     engine[32]{};
+    uint64_t journal_seq{0};     // Last record of the engine's journal lane reflected in the books
+    uint16_t journal_engine{0};  // The engine's lane index in that journal
+    uint16_t book_count{0};
+    uint32_t reserved{0};
+    int64_t  unix_ns{0};         // Capture time
+    char     journal_path[256]{};  // Journal (or segment base name) the sequence belongs to; "" if none
+    uint64_t journal_run_id{0};    // That journal's JournalFileHeader::run_id
+};
+
+static_assert(std::is_trivially_copyable_v<BookSnapshotHeader>);
+
+/** One engine's books at one instant */
+struct EngineSnapshot {
+    BookSnapshotHeader     header;
+    std::vector<BookImage> books;  // BookIndex order
+};
+
+/**
+ * Hand-off of one engine's snapshot to the writer. The engine fills
+ * `image` only while `busy` is false and then sets it; the writer
+ * clears it once the file is written, so the image (and its vectors'
+ * capacity) is reused from one snapshot to the next.
+ */
+struct BookSnapshotSlot {
+    EngineSnapshot    image;
+    std::atomic<bool> busy{false};
+    std::atomic<uint64_t> skipped{0};  // Due while the previous one was still being written
+};
+
+/**
+ * Writer thread for every engine's snapshots. Engines attach with
+ * add_engine() (MatchingEngine::set_book_snapshots).
+ */
+class BookSnapshotWriter {
+public:
+    /** @param journal_path, journal_run_id Recorded in each snapshot, for restore_engine() */
+    BookSnapshotWriter(std::string directory, std::string journal_path = {}, uint64_t journal_run_id = 0);
+    ~BookSnapshotWriter();
+
+    BookSnapshotWriter(const BookSnapshotWriter&) = delete;
+    BookSnapshotWriter& operator=(const BookSnapshotWriter&) = delete;
+
+    /** Slot for one more engine. Before start(). */
+    BookSnapshotSlot* add_engine(const std::string& name);
+
+    void start();
+    /** Write what the engines left in their slots, then stop. Stop the engines first. */
+    void stop();
+
+    [[nodiscard]] const std::string& directory() const { return directory_; }
+
+    // Statistics
+    uint64_t snapshots_written() const { return written_.load(std::memory_order_relaxed); }
+    uint64_t bytes_written() const { return bytes_.load(std::memory_order_relaxed); }
+    uint64_t write_errors() const { return write_errors_.load(std::memory_order_relaxed); }
+    /** Snapshots the engines skipped because their slot was still busy */
+    uint64_t snapshots_skipped() const;
+
+private:
+    std::string directory_;
+    std::string journal_path_;
+    uint64_t    journal_run_id_;
+    std::vector<std::string> engine_names_;
+    std::vector<std::unique_ptr<BookSnapshotSlot>> slots_;
+
+    std::thread       thread_;
+    std::atomic<bool> running_{false};
+
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> write_errors_{0};
+
+    void run();
+    /** @return true if a slot was written */
+    bool write_pending();
+    void write(const std::string& engine, BookSnapshotSlot& slot);
+    /** Delete all but the BOOK_SNAPSHOTS_KEPT newest snapshots of `engine` */
+    void prune(const std::string& engine);
+};
+
+/** Path of the newest complete snapshot of `engine` in `directory`, or "" */
+[[nodiscard]] std::string latest_book_snapshot(const std::string& directory, const std::string& engine);
+
+/** @return false if the file is missing, truncated or not a snapshot */
+[[nodiscard]] bool load_book_snapshot(const std::string& path, EngineSnapshot& out);
+
+struct RestoreResult {
+    std::string snapshot;         // File restored from ("" if none was found)
+    uint64_t    orders{0};        // Resting orders restored from the snapshot
+    uint64_t    replayed{0};      // Journaled requests replayed on top
+    uint64_t    journal_gaps{0};  // Breaks in the replayed sequence (records the journal dropped)
+};
+
+/**
+ * Warm restart of one engine from its latest snapshot in `directory`
+ * and the tail of the journal recorded in it. Before engine.start().
+ * A missing snapshot restores nothing; a missing journal restores the
+ * snapshot alone.
+ */
+RestoreResult restore_engine(MatchingEngine& engine, const std::string& directory);
+
+} // namespace rtes
@@ -0,0 +1,350 @@
+#pragma once
+
+/**
+ * @file broadcast_ring.hpp
+ * @brief Lock-free single-producer ring read by several independent consumers
+ *
+ * Disruptor-style fan-out: every reader sees every event, each through
+ * its own cursor over the one buffer, so an event is written once no
+ * matter how many consumers read it (no copy per consumer queue).
+ *
+ *   producer ─► [ ring ] ─┬─► primary reader  (required)
+ *                         ├─► reader 1        (required)
+ *                         └─► reader 2        (optional)
+ *
+ * REQUIRED readers gate the producer: push() fails when the slowest of
+ * them is a full ring behind, exactly like a full SPSCQueue. OPTIONAL
+ * readers never hold the producer back; one that falls a ring behind is
+ * lapped, skips to the oldest event still held and counts what it lost.
+ *
+ * The ring's own pop()/try_pop_bulk() are those of the primary reader
+ * (created with the ring, required), so a ring nobody else reads is a
+ * drop-in SPSCQueue with the same cached-index fast paths.
+ *
+ * Optional readers may read a slot while the producer overwrites it.
+ * Once one exists, each slot carries a seqlock stamp (0 while being
+ * written, position + 1 once written); a reader whose copy straddles a
+ * rewrite discards it. Without optional readers no stamp is written.
+ *
+ * enable_telemetry() samples depth and residence time as SPSCQueue does,
+ * both measured against the primary reader.
+ *
+ * Memory ordering:
+ *   Producer: acquire reads of required cursors (only when the cached
+ *             minimum says full), release store of head_
+ *   Readers:  acquire read of head_ (only when the cached head says
+ *             empty), release store of their cursor (required readers)
+ *
+ * Requirements:
+ *   - T must be trivially copyable
+ *   - One producer thread; each reader is used by one thread
+ *   - add_reader() before the producer starts
+ *
+ * @tparam T Element type (must be trivially copyable)
+ */
+
+#include "rtes/spsc_queue.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace rtes {
+
+template<typename T>
+class BroadcastRing {
+    static_assert(std::is_trivially_copyable_v<T>,
+        "BroadcastRing requires trivially copyable T for lock-free safety.");
+
+public:
+    /** One consumer's view of the ring */
+    class Reader {
+    public:
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        [[nodiscard]] bool pop(T& item) { return try_pop_bulk(&item, 1) == 1; }
+
+        /**
+         * Copy up to `max` events, oldest first. An optional reader that
+         * was lapped first skips to the oldest event still held.
+         * @return Number copied (0 if none)
+         */
+        [[nodiscard]] size_t try_pop_bulk(T* out, size_t max) {
+            return required_ ? pop_gating(out, max) : pop_lapping(out, max);
+        }
+
+        /** Cheaper than empty(): reloads the head only when the cached one says empty */
+        [[nodiscard]] bool consumer_empty() {
+            const size_t cursor = cursor_.load(std::memory_order_relaxed);
+            if (cursor != cached_head_) return false;
+            cached_head_ = ring_.head_.load(std::memory_order_acquire);
+            return cursor == cached_head_;
+        }
+
+        /** Approximate; for monitoring */
+        [[nodiscard]] bool empty() const { return size() == 0; }
+
+        /** Approximate events waiting; for monitoring */
+        [[nodiscard]] size_t size() const {
+            const size_t cursor = cursor_.load(std::memory_order_acquire);
+            const size_t head   = ring_.head_.load(std::memory_order_acquire);
+            return std::min(head - cursor, ring_.capacity_);
+        }
+
+        [[nodiscard]] bool required() const { return required_; }
+
+        /** Events an optional reader lost to being lapped */
+        [[nodiscard]] uint64_t lapped() const { return lapped_.load(std::memory_order_relaxed); }
+
+    private:
+        friend class BroadcastRing;
+
+        Reader(BroadcastRing& ring, bool required, size_t start)
+            : cursor_(start), cached_head_(start), ring_(ring), required_(required) {}
+
+        /** Required reader: the producer never overwrites what it has not read */
+        size_t pop_gating(T* out, size_t max) {
+            const size_t cursor = cursor_.load(std::memory_order_relaxed);
+            size_t available = cached_head_ - cursor;
+            if (available < max) {
+                cached_head_ = ring_.head_.load(std::memory_order_acquire);
+                available = cached_head_ - cursor;
+            }
+            const size_t n = std::min(max, available);
+            if (n == 0) return 0;
+
+            ring_.copy_out(cursor, out, n);
+            if (ring_.probe_ && this == ring_.primary_) [[unlikely]] ring_.probe_->on_pop(cursor, n);
+            cursor_.store(cursor + n, std::memory_order_release);
+            return n;
+        }
+
+        /** Optional reader: check each slot's stamp around the copy */
+        size_t pop_lapping(T* out, size_t max) {
+            size_t cursor = cursor_.load(std::memory_order_relaxed);
+            if (cached_head_ - cursor < max) {
+                cached_head_ = ring_.head_.load(std::memory_order_acquire);
+            }
+            if (cached_head_ - cursor > ring_.capacity_) [[unlikely]] {
+                const size_t oldest = cached_head_ - ring_.capacity_;
+                lapped_.fetch_add(oldest - cursor, std::memory_order_relaxed);
+                cursor = oldest;
+            }
+            const size_t n = std::min(max, cached_head_ - cursor);
+
+            size_t copied = 0;
+            for (; copied < n; ++copied) {
+                const size_t pos  = cursor + copied;
+                const size_t slot = pos & ring_.mask_;
+                if (ring_.stamps_[slot].load(std::memory_order_acquire) != pos + 1) break;
+                out[copied] = ring_.buffer_[slot];
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (ring_.stamps_[slot].load(std::memory_order_relaxed) != pos + 1) break;
+            }
+            // A slot rewritten under us ends the run; the next call reloads
+            // the head and sees the lap
+            if (copied < n) [[unlikely]] cached_head_ = cursor + copied;
+            cursor_.store(cursor + copied, std::memory_order_relaxed);
+            return copied;
+        }
+
+        alignas(detail::CACHE_LINE)
+        std::atomic<size_t>   cursor_;        // Next position to read
+        size_t                cached_head_;   // Last known head_
+        std::atomic<uint64_t> lapped_{0};
+        BroadcastRing&        ring_;
+        const bool            required_;
+    };
+
+    /**
+     * @param min_capacity Minimum number of slots. Rounded UP to power of 2.
+     * @throws std::bad_alloc if buffer allocation fails
+     */
+    explicit BroadcastRing(size_t min_capacity)
+        : capacity_(detail::round_up_pow2(min_capacity))
+        , mask_(capacity_ - 1)
+        , pages_(capacity_ * sizeof(T))
+        , buffer_(static_cast<T*>(pages_.data()))
+    {
+        primary_ = add_reader(true);
+    }
+
+    // Non-copyable, non-movable (shared between producer/consumer threads)
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+    BroadcastRing(BroadcastRing&&) = delete;
+    BroadcastRing& operator=(BroadcastRing&&) = delete;
+
+    /**
+     * Add a consumer that sees every event from now on. Call before the
+     * producer starts.
+     * @param required  Gate the producer on this reader (else it may be lapped)
+     */
+    Reader* add_reader(bool required) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        readers_.push_back(std::unique_ptr<Reader>(new Reader(*this, required, head)));
+        Reader* reader = readers_.back().get();
+        if (required) {
+            gating_.push_back(reader);
+        } else if (!stamps_) {
+            stamps_ = std::make_unique<std::atomic<size_t>[]>(capacity_);
+        }
+        return reader;
+    }
+
+    /**
+     * Sample depth and residence time (primary reader) on one position in
+     * `sample_every` (0 = off). Call before the producer starts.
+     */
+    void enable_telemetry(size_t sample_every) {
+        probe_ = sample_every ? std::make_unique<QueueProbe>(capacity_, sample_every) : nullptr;
+    }
+
+    /** Zeroed when telemetry is off */
+    [[nodiscard]] QueueTelemetry telemetry() const { return probe_ ? probe_->snapshot() : QueueTelemetry{}; }
+
+    // ═══════════════════════════════════════════════════════
+    //  Producer API (call from SINGLE producer thread only)
+    // ═══════════════════════════════════════════════════════
+
+    /** @return false if the slowest required reader is a full ring behind */
+    [[nodiscard]] bool push(const T& item) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - cached_gate_ >= capacity_) [[unlikely]] {
+            cached_gate_ = slowest_required();
+            if (head - cached_gate_ >= capacity_) return false;
+        }
+        write(head, item);
+        if (probe_) [[unlikely]] probe_push(head, 1);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Push up to `count` elements with a single head_ publish.
+     * @return Number pushed (0 if full)
+     */
+    [[nodiscard]] size_t try_push_bulk(const T* items, size_t count) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        size_t room = capacity_ - (head - cached_gate_);
+        if (room < count) [[unlikely]] {
+            cached_gate_ = slowest_required();
+            room = capacity_ - (head - cached_gate_);
+        }
+        const size_t n = std::min(count, room);
+        if (n == 0) return 0;
+
+        if (stamps_) {
+            for (size_t i = 0; i < n; ++i) write(head + i, items[i]);
+        } else {
+            copy_in(head, items, n);
+        }
+        if (probe_) [[unlikely]] probe_push(head, n);
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    // ═══════════════════════════════════════════════════════
+    //  Primary Reader (SPSCQueue-compatible consumer API)
+    // ═══════════════════════════════════════════════════════
+
+    [[nodiscard]] bool pop(T& item) { return primary_->pop(item); }
+    [[nodiscard]] size_t try_pop_bulk(T* out, size_t max) { return primary_->try_pop_bulk(out, max); }
+    [[nodiscard]] bool consumer_empty() { return primary_->consumer_empty(); }
+    [[nodiscard]] bool empty() const { return primary_->empty(); }
+    [[nodiscard]] size_t size() const { return primary_->size(); }
+
+    /** Events pushed so far: a position to compare popped() against. Any thread. */
+    [[nodiscard]] size_t pushed() const { return head_.load(std::memory_order_acquire); }
+
+    /** Position every required reader has read past. Any thread. */
+    [[nodiscard]] size_t popped() const { return slowest_required(); }
+
+    [[nodiscard]] Reader& primary() { return *primary_; }
+    [[nodiscard]] size_t reader_count() const { return readers_.size(); }
+
+    /** Total ring capacity (always a power of 2). */
+    [[nodiscard]] size_t capacity() const { return capacity_; }
+
+    /** What backs the slots (huge pages, THP or heap) */
+    [[nodiscard]] PageBacking page_backing() const { return pages_.backing(); }
+
+private:
+    // ═══════════════════════════════════════════════════════
+    //  SHARED READ-ONLY DATA (fixed once readers are added)
+    // ═══════════════════════════════════════════════════════
+
+    const size_t capacity_;
+    const size_t mask_;
+    PageRegion   pages_;
+    T* const     buffer_;
+    std::unique_ptr<std::atomic<size_t>[]> stamps_;  // Allocated with the first optional reader
+    std::vector<std::unique_ptr<Reader>> readers_;
+    std::vector<Reader*> gating_;   // Required readers
+    Reader*              primary_{nullptr};
+    std::unique_ptr<QueueProbe> probe_;  // Telemetry; nullptr = off
+
+    // ═══════════════════════════════════════════════════════
+    //  PRODUCER CACHE LINE
+    // ═══════════════════════════════════════════════════════
+
+    alignas(detail::CACHE_LINE)
+    std::atomic<size_t> head_{0};      // Monotonically increasing
+    size_t              cached_gate_{0}; // Last known slowest required cursor
+
+    size_t slowest_required() const {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t slowest = head;
+        for (const Reader* reader : gating_) {
+            const size_t cursor = reader->cursor_.load(std::memory_order_acquire);
+            if (head - cursor > head - slowest) slowest = cursor;
+        }
+        return slowest;
+    }
+
+    void probe_push(size_t pos, size_t n) {
+        if (probe_->hits(pos, n)) {
+            probe_->on_push(pos, n, pos - primary_->cursor_.load(std::memory_order_relaxed));
+        }
+    }
+
+    void write(size_t pos, const T& item) {
+        const size_t slot = pos & mask_;
+        if (stamps_) {
+            stamps_[slot].store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            buffer_[slot] = item;
+            stamps_[slot].store(pos + 1, std::memory_order_release);
+        } else {
+            buffer_[slot] = item;
+        }
+    }
+
+    // ═══════════════════════════════════════════════════════
+    //  Bulk Copy (at most two memcpy — the run may wrap)
+    // ═══════════════════════════════════════════════════════
+
+    void copy_in(size_t pos, const T* items, size_t n) {
+        const size_t first = pos & mask_;
+        const size_t head_run = std::min(capacity_ - first, n);
+        std::memcpy(&buffer_[first], items, head_run * sizeof(T));
+        std::memcpy(&buffer_[0], items + head_run, (n - head_run) * sizeof(T));
+    }
+
+    void copy_out(size_t pos, T* out, size_t n) const {
+        const size_t first = pos & mask_;
+        const size_t head_run = std::min(capacity_ - first, n);
+        std::memcpy(out, &buffer_[first], head_run * sizeof(T));
+        std::memcpy(out + head_run, &buffer_[0], (n - head_run) * sizeof(T));
+    }
+};
+
+} // namespace rtes
@@ -6,6 +6,7 @@
 #include <thread>
 #include <chrono>
 #include <random>
+#include <vector>
 
 namespace rtes {
 
@@ -17,6 +18,11 @@ public:
     bool connect();
     void disconnect();
     void run(std::chrono::seconds duration);
+
+    /** Receive on a thread of its own (run() does this); for tools that send on their own schedule */
+    void start_receiver();
+    /** Stop receiving; the socket is shut down so a blocked read returns */
+    void stop_receiver();
     
     // Statistics
     uint64_t orders_sent() const { return orders_sent_.load(); }
@@ -24,9 +30,30 @@ public:
     uint64_t orders_rejected() const { return orders_rejected_.load(); }
     uint64_t trades_received() const { return trades_received_.load(); }
     
+    // ── Multiplexed use: a reactor thread drives many sessions, no threads of their own ──
+
+    /** Socket after connect(), for the caller's poller */
+    int fd() const { return socket_fd_; }
+    /**
+     * Queue outgoing messages in outbox() instead of sending them (the
+     * caller writes them out, many per syscall). A send that would grow
+     * the outbox past MAX_OUTBOX fails, as a full socket would.
+     */
+    void set_buffered(bool buffered) { buffered_ = buffered; }
+    std::vector<std::byte>& outbox() { return outbox_; }
+    /** Feed bytes read from the socket; complete messages reach the strategy */
+    void receive_bytes(const std::byte* data, size_t size);
+    void start_session() { on_start(); }
+    void tick() { on_tick(); }
+    void stop_session() { on_stop(); }
+
+    static constexpr size_t MAX_OUTBOX = 1 << 20;
+
     // Order management (public for testing tools)
-    bool send_new_order(const std::string& symbol, Side side, uint64_t quantity, uint64_t price);
+    bool send_new_order(const std::string& symbol, Side side, uint64_t quantity, uint64_t price,
+                        OrderType type = OrderType::LIMIT);
     bool send_cancel_order(uint64_t order_id, const std::string& symbol);
+    bool send_modify_order(uint64_t order_id, const std::string& symbol, uint64_t new_quantity, uint64_t new_price = 0);
 
 protected:
     std::string host_;
@@ -44,6 +71,10 @@ protected:
     uint64_t sequence_{0};
     
     std::mt19937 rng_;
+
+    bool                   buffered_{false};
+    std::vector<std::byte> outbox_;
+    std::vector<std::byte> inbox_;   // Partial message (receive_bytes)
     
     // Virtual strategy methods
     virtual void on_start() {}
@@ -61,6 +92,8 @@ private:
     std::thread receiver_thread_;
     
     void receiver_loop();
+    /** One complete message: counters and strategy callbacks */
+    void dispatch(const std::byte* message, size_t length);
     bool send_message(const void* message, size_t size);
     bool receive_message(void* buffer, size_t size);
 };
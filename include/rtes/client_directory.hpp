@@ -0,0 +1,55 @@
+#pragma once
+
+/**
+ * @file client_directory.hpp
+ * @brief ClientID → dense ClientIDRaw, resolved once per session
+ *
+ * The order path never hashes the 32-byte ClientID string. The gateway
+ * resolves it here at logon (and again only if a session switches
+ * client ids). It then stamps the dense id on Order::owner and on
+ * cancel/modify requests. Risk indexes a flat per-client array with it,
+ * and the books use it for self-trade prevention.
+ *
+ * Ids are 1..capacity(), assigned in first-seen order and never reused.
+ * 0 means "unknown client". One directory is shared by every risk shard
+ * and gateway thread, so an id names the same client everywhere.
+ *
+ * Thread-safe. resolve() takes a mutex — a cold path, once per session.
+ */
+
+#include "rtes/types.hpp"
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+
+namespace rtes {
+
+/** Default number of distinct clients when not configured */
+inline constexpr size_t CLIENT_DIRECTORY_DEFAULT_CAPACITY = 4096;
+
+class ClientDirectory {
+public:
+    explicit ClientDirectory(size_t capacity = CLIENT_DIRECTORY_DEFAULT_CAPACITY);
+
+    ClientDirectory(const ClientDirectory&) = delete;
+    ClientDirectory& operator=(const ClientDirectory&) = delete;
+
+    /** Dense id for `client`, assigned on first sight. 0 if the directory is full. */
+    [[nodiscard]] ClientIDRaw resolve(const ClientID& client);
+
+    /** Dense id if `client` was ever resolved, else 0. Never assigns. */
+    [[nodiscard]] ClientIDRaw find(const ClientID& client) const;
+
+    /** Largest id that can ever be assigned. Size per-client arrays capacity() + 1. */
+    [[nodiscard]] size_t capacity() const { return capacity_; }
+
+    [[nodiscard]] size_t size() const;
+
+private:
+    const size_t capacity_;
+    mutable std::mutex mutex_;
+    std::unordered_map<ClientID, ClientIDRaw, ClientID::Hash> ids_;
+};
+
+} // namespace rtes
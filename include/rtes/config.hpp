@@ -12,6 +12,16 @@ struct SymbolConfig {
     double tick_size{0.01};
     uint64_t lot_size{1};
     double price_collar_pct{10.0};
+    bool intrusive_levels{false};   // O(1) cancel via intrusive level FIFO
+    bool tick_ladder{false};        // O(1) level index by (price / tick_size)
+    std::string self_trade_prevention{"none"};  // none|cancel_newest|cancel_oldest|cancel_both|decrement
+    int32_t engine_shard{-1};       // Matching thread shared with same-shard symbols (-1 = dedicated)
+    uint32_t engine_weight{1};      // Share of a shard's thread under engine_fair_slice
+    uint32_t md_channel{0};         // Market data channel (index into exchange.udp_channels)
+    bool listed{true};              // false: slot reserved at startup, listed later (Exchange::list_symbol)
+    uint32_t price_band_bps{0};     // Sweeps stop this far from the last trade, then a volatility pause (0 = off)
+    bool queue_positions{false};    // Per-level queue sums: O(log n) quantity ahead of an order
+    int32_t order_feed_channel{-1}; // Market-by-order channel (index into exchange.udp_channels, -1 = off)
 };
 
 struct ExchangeConfig {
@@ -19,35 +29,133 @@ struct ExchangeConfig {
     uint16_t tcp_port{0};
     std::string udp_multicast_group;
     uint16_t udp_port{0};
+    std::string udp_channels;           // "group:port,...": channel i of the feed (empty = udp_multicast_group:udp_port)
     uint16_t metrics_port{0};
+    uint32_t metrics_refresh_ms{1000};  // /metrics rendered this often, not per scrape (0 = per scrape)
+    uint32_t dashboard_stream_ms{1000}; // /events: dashboard deltas pushed this often (0 = no stream)
+    bool cancel_on_disconnect{false};   // Mass cancel a session's client when it drops
+    uint16_t drop_copy_port{0};         // Post-trade drop-copy feed (0 = off)
+    uint16_t retransmit_port{0};        // UDP gap fill for the market data feed (0 = off)
+    std::string retransmit_bind_address{"127.0.0.1"};  // Interface gap fill requests are taken on
+    std::string snapshot_group;         // Depth snapshot channel for late joiners
+    uint16_t snapshot_port{0};          // (0 = off)
+    std::string tls_cert_file;          // Order entry over kernel TLS (empty = plaintext)
+    std::string tls_key_file;
+    std::string tls_ca_file;            // Require client certificates from these CAs (empty = none)
+    bool require_session_auth{false};   // Logon must carry an auth token; messages checked against its grant
+    bool risk_reload_endpoint{false};   // Serve /reload/risk on the metrics port (re-reads the config file)
+    bool symbol_control_endpoint{false};  // Serve /symbols/{list,halt,resume} on the metrics port
+    uint32_t volatility_pause_ms{5000};   // Auction after a price band breach (0 = until set back to continuous)
 };
 
 struct RiskConfig {
     uint64_t max_order_size{100000};
     double   max_notional_per_client{10000000.0};
     uint32_t max_orders_per_second{1000};
+    uint32_t rate_limit_burst{0};       // Token bucket depth (0 = max_orders_per_second)
     bool     price_collar_enabled{true};
+    uint64_t max_position{0};           // Per client and symbol: |net| incl. working orders (0 = off)
+    uint64_t max_open_quantity{0};      // Per client, symbol and side: working quantity (0 = off)
 };
 
 struct PerformanceConfig {
     uint32_t order_pool_size{0};
+    uint32_t order_pool_magazine{128};       // Slots per thread-cache refill/spill (0 = shared stack only)
+    uint32_t order_pool_segment{0};          // Slots per growth segment (0 = fixed-size pool)
+    uint32_t order_pool_low_water{0};        // Grow when fewer slots are free (0 = segment / 4)
+    uint32_t order_pool_max{0};              // Growth stops here; order maps are sized for it (0 = 2 x size)
+    bool     order_pool_release_idle{false}; // madvise empty growth segments' pages back to the kernel
     uint32_t queue_capacity{0};
     bool     enable_cpu_pinning{false};
     bool     tcp_nodelay{false};
     uint32_t udp_buffer_size{0};
-    uint32_t market_data_queue_size{4096};   // ← ADDED (fixes exchange.cpp:101)
+    uint32_t market_data_queue_size{4096};   // Slots per market data lane (engine → publisher)
+    uint32_t queue_telemetry_sample{0};      // Sample lane depth/residence on 1 in N entries (0 = off)
+    uint32_t latency_sample{64};             // Time 1 in N order book add/match/trade calls
+    uint32_t order_trace_sample{0};          // Stamp 1 in N orders at every pipeline stage (0 = off)
+    std::string order_trace_otlp_file;       // Append traced orders as OTLP/JSON span batches (empty = off)
+    std::string stats_shm_name;              // Engine/risk counters in /dev/shm/<name> for sidecars (empty = in-process)
+    uint32_t depth_snapshot_levels{10};      // Cross-thread depth levels per side (1..MAX_DEPTH_LEVELS)
+    uint32_t depth_snapshot_events{0};       // Publish every K book events (0 = off)
+    uint32_t depth_snapshot_interval_us{1000}; // Publish ≤ once per T µs (0 = off)
+    bool     depth_incremental{false};       // Per-level DEPTH_LEVEL market data events
+    std::string engine_shard_cores;          // "4,5,6": shard i pinned to i-th core (needs enable_cpu_pinning)
+    uint32_t risk_ingress_lanes{1};          // SPSC lanes into risk, one per gateway thread
+    uint32_t gateway_reactors{1};            // TCP gateway threads (SO_REUSEPORT listeners)
+    std::string gateway_backend{"epoll"};    // "epoll" or "io_uring" (Linux; falls back to epoll)
+    int32_t  gateway_sqpoll_core{-1};        // io_uring SQPOLL thread core (-1 = no SQPOLL)
+    std::string gateway_idle_policy{"spin_park"};  // Idle reactor: spin_park blocks, busy_spin|spin_yield poll
+    uint32_t gateway_busy_poll_us{0};        // SO_BUSY_POLL budget on client sockets (0 = off)
+    bool     gateway_incoming_cpu{false};    // SO_INCOMING_CPU steering to pinned reactors
+    bool     gateway_rx_timestamps{false};   // Kernel receive timestamps for wire-to-risk latency
+    uint32_t gateway_max_connections{1024};  // Connection slots per reactor, built at start (≤ 65536)
+    std::string shm_entry_name;              // Shared memory order entry logon socket name (empty = off)
+    uint32_t shm_entry_clients{16};          // Concurrent strategy sessions (1..65535)
+    std::string shm_entry_idle_policy{"spin_yield"};  // Empty-poll behaviour of the shm poller
+    int32_t  shm_entry_core{-1};             // shm poller core (needs enable_cpu_pinning, -1 = float)
+    uint32_t drop_copy_journal_size{65536};  // Reports kept for drop-copy gap replay
+    std::string session_capture_file;        // Capture inbound order-entry frames for session_replay (empty = off)
+    uint32_t session_capture_lane_chunks{16384}; // 256-byte chunks buffered per reactor before frames drop
+    uint32_t risk_shards{1};                 // Risk threads, clients partitioned by directory id
+    uint32_t max_clients{4096};              // Client directory capacity (dense risk table size)
+    std::string risk_shard_cores;            // "3,7": risk shard i pinned to i-th core (overrides risk_manager_core)
+    int32_t  risk_manager_core{-1};          // Hot-thread cores (needs enable_cpu_pinning, -1 = float)
+    int32_t  gateway_core{-1};
+    int32_t  market_data_core{-1};
+    int32_t  monitoring_core{-1};            // HTTP/metrics threads: a housekeeping core, never SCHED_FIFO
+    uint32_t realtime_priority{0};           // SCHED_FIFO priority for pinned threads (0 = off)
+    bool     lock_memory{false};             // mlockall before threads start (and mlock pool/queue regions)
+    std::string page_backing{"heap"};        // Pools and queue buffers: heap|thp|2m|1g (falls back down)
+    bool     numa_pools{false};              // One order pool per NUMA node, bound to it (multi-node only)
+    std::string engine_idle_policy{"spin_yield"};      // Empty-queue behaviour: busy_spin|spin_yield|spin_park
+    uint32_t engine_maintenance_budget_ns{2000};       // Stats flush + book pruning per batch boundary / idle pass
+    uint32_t engine_fair_slice{0};                     // Shard engines: requests per book per turn × engine_weight (0 = lane order)
+    uint32_t rebalance_interval_ms{0};                 // > 0 (2+ shards): move hot books between engines at this cadence
+    double   rebalance_imbalance{1.5};                 // Busiest engine's requests / quietest's before a book moves
+    uint32_t rebalance_min_requests{10000};            // Busiest engine's requests per interval before a book moves
+    std::string risk_idle_policy{"spin_yield"};
+    std::string market_data_idle_policy{"spin_yield"};
+    uint32_t market_data_datagram_bytes{1400};  // Max UDP payload messages are packed into
+    uint32_t market_data_publishers{1};      // UDP publisher threads; channel i → publisher i % N
+    bool     bbo_conflation{false};          // Latest BBO per symbol per batch (trades never conflated)
+    bool     sweep_summary{false};           // SWEEP_SUMMARY after the trades of a multi-fill order
+    std::string market_data_xdp_interface;   // AF_XDP transmit NIC (empty = kernel UDP path)
+    uint32_t market_data_xdp_queue{0};       // First NIC queue; publisher i uses queue + i
+    bool     market_data_xdp_zero_copy{false};  // Require driver zero-copy (else copy mode)
+    uint32_t retransmit_history_packets{8192};  // Datagrams kept per channel for gap fill
+    uint32_t snapshot_bytes_per_second{1000000};  // Snapshot channel bandwidth cap
+    uint32_t snapshot_interval_ms{1000};     // Min time between snapshot cycle starts
+    std::string market_data_auth_key;        // HMAC key signing every market data datagram (empty = unsigned)
 };
 
 struct LoggingConfig {
     std::string level;
     uint32_t rate_limit_ms{0};
     bool enable_structured{false};
+    bool async{true};  // Format and write LOG_* calls on a background thread
 };
 
 struct PersistenceConfig {
-    bool enable_event_log{false};
-    uint32_t snapshot_interval_ms{0};
-    std::string log_directory;
+    bool enable_event_log{false};            // Write-ahead journal of engine requests and outputs
+    uint32_t snapshot_interval_ms{0};        // > 0 (with the event log): book snapshots at this cadence
+    bool restore_on_start{false};            // Rebuild books from the latest snapshot + journal tail
+    std::string log_directory;               // events-<unix seconds>.journal and snapshots go here
+    std::string journal_sync{"interval"};    // "none", "interval" (every journal_sync_ms) or "batch" (every write)
+    uint32_t journal_sync_ms{10};
+    bool journal_direct_io{false};           // O_DIRECT writes (falls back if unsupported)
+    uint32_t journal_lane_capacity{16384};   // Records buffered per engine before drops
+    uint32_t journal_segment_mb{0};          // > 0: mapped, preallocated segments of this size
+};
+
+struct ReplicationConfig {
+    std::string role{"none"};                // "none", "primary" or "standby" (needs the event log)
+    std::string peer;                        // Primary: the standby's "host:port"
+    uint16_t port{9300};                     // Standby: where the primary connects
+    std::string bind_address{"127.0.0.1"};   // Standby: the replication interface it listens on (IPv4)
+    std::string secret;                      // Both: shared secret the primary proves at connect (required)
+    std::string mode{"async"};               // "async" or "sync" (reports wait for the standby's ack)
+    uint32_t max_backlog_mb{64};             // Primary: unsent bytes before the standby is dropped
+    uint32_t promote_after_ms{0};            // Standby: > 0 promotes itself after this much primary silence
 };
 
 struct Config {
@@ -57,6 +165,7 @@ struct Config {
     PerformanceConfig performance;
     LoggingConfig logging;
     PersistenceConfig persistence;
+    ReplicationConfig replication;
 
     static std::unique_ptr<Config> load_from_file(const std::string& path);
 };
@@ -11,7 +11,7 @@ namespace rtes {
 struct DashboardWidget {
     std::string id;
     std::string title;
-    std::string type; // "metric", "chart", "table", "alert"
+    std::string type; // "metric", "chart", "table", "alert", "stream"
     std::string query;
     std::unordered_map<std::string, std::string> config;
 };
@@ -35,6 +35,13 @@ public:
     void stop_server();
     
     void add_panel(const DashboardPanel& panel);
+
+    /**
+     * Server-Sent Events URL of the exchange's /events stream (MonitoringService).
+     * When set, the page subscribes to it and "stream" widgets update in place
+     * from its deltas instead of the page reloading every 30 s.
+     */
+    void set_stream_url(const std::string& url);
     std::string render_dashboard() const;
     std::string get_metrics_data() const;
     std::string get_alerts_data() const;
@@ -43,6 +50,7 @@ private:
     atomic_wrapper<bool> server_running_{false};
     std::thread server_thread_;
     uint16_t port_{3000};
+    std::string stream_url_ GUARDED_BY(panels_mutex_);
     
     mutable std::shared_mutex panels_mutex_;
     std::vector<DashboardPanel> panels_ GUARDED_BY(panels_mutex_);
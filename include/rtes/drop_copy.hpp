@@ -0,0 +1,141 @@
+#pragma once
+
+/**
+ * @file drop_copy.hpp
+ * @brief Drop copy: every execution report of a firm, over TCP
+ *
+ * Post-trade consumers (surveillance, clearing) subscribe per firm on a
+ * port of their own instead of reconstructing fills from market data.
+ *
+ *   gateway reactor ─ SPSC ─┐
+ *   gateway reactor ─ SPSC ─┼─► DropCopyServer ─► journal ─► subscribers
+ *
+ * Each reactor copies the reports it routes from its execution queues
+ * into its own SPSC ring with one try_push: a full ring drops the copy
+ * and counts it, so neither the reactor nor the matching engine behind
+ * it ever waits for a subscriber.
+ *
+ * The server thread numbers each firm's reports (1, 2, ...) and appends
+ * them to a bounded journal. Subscribers read from the journal through a
+ * cursor, into a bounded write buffer sent with one sendmsg per loop —
+ * live streaming and replay are the same path. A subscriber that stops
+ * reading stalls only its own cursor; once the journal wraps past it, it
+ * skips ahead and sees the gap in the sequence.
+ *
+ * Every request carries a token: its user must be the firm itself, or
+ * hold the permission "drop_copy:<firm>" (admins hold all), so one firm
+ * cannot read another's fills. A refused request unsubscribes.
+ */
+
+#include "rtes/types.hpp"
+#include "rtes/matching_engine.hpp"
+#include "rtes/client_directory.hpp"
+#include "rtes/memory_safety.hpp"
+#include "rtes/protocol.hpp"
+#include "rtes/spsc_queue.hpp"
+
+#include <poll.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace rtes {
+
+/** One report as routed by a gateway reactor, tagged with the firm it belongs to. */
+struct DropCopyRecord {
+    ExecutionReport report;
+    ClientIDRaw     client{0};         // Directory id of the firm (never 0)
+    Side            side{Side::BUY};   // FILL: the firm's side of report.fill
+};
+
+static_assert(std::is_trivially_copyable_v<DropCopyRecord>,
+              "DropCopyRecord must be trivially copyable for lock-free queues");
+
+/** Journal entries kept for replay (power of two) */
+inline constexpr size_t DROP_COPY_DEFAULT_JOURNAL = 65536;
+/** Per-reactor ring into the server */
+inline constexpr size_t DROP_COPY_QUEUE_CAPACITY  = 16384;
+
+class DropCopyServer {
+public:
+    /**
+     * @param reactors   Ingress reactors feeding it (one queue each; the
+     *                   shared memory gateway's comes after the TCP ones)
+     * @param directory  Firm ids; the gateway tags reports with the same
+     * @param journal    Replay depth in reports (rounded up to a power of two)
+     */
+    DropCopyServer(uint16_t port, size_t reactors, ClientDirectory* directory,
+                   size_t journal = DROP_COPY_DEFAULT_JOURNAL);
+    ~DropCopyServer();
+
+    DropCopyServer(const DropCopyServer&) = delete;
+    DropCopyServer& operator=(const DropCopyServer&) = delete;
+
+    void start();
+    void stop();
+
+    /** Ring reactor `reactor` produces into (TcpGateway/ShmGateway::set_drop_copy). */
+    [[nodiscard]] SPSCQueue<DropCopyRecord>* reactor_queue(size_t reactor) {
+        return queues_.at(reactor).get();
+    }
+
+    [[nodiscard]] size_t reactor_count() const { return queues_.size(); }
+
+    // Statistics
+    uint64_t reports_journaled() const { return reports_journaled_.load(std::memory_order_relaxed); }
+    uint64_t replays() const { return replays_.load(std::memory_order_relaxed); }
+    /** Subscribers the journal wrapped past (they skipped ahead) */
+    uint64_t gaps() const { return gaps_.load(std::memory_order_relaxed); }
+    size_t subscribers() const { return subscriber_count_.load(std::memory_order_relaxed); }
+    /** Requests refused: no valid token, or not entitled to the firm */
+    uint64_t requests_refused() const { return requests_refused_.load(std::memory_order_relaxed); }
+
+private:
+    struct Subscriber;
+
+    struct JournalEntry {
+        DropCopyReport message;
+        ClientIDRaw    firm{0};
+    };
+
+    uint16_t          port_;
+    ClientDirectory*  directory_;
+    FileDescriptor    listen_fd_;
+    std::thread       thread_;
+    std::atomic<bool> running_{false};
+
+    std::vector<std::unique_ptr<SPSCQueue<DropCopyRecord>>> queues_;
+    std::vector<DropCopyRecord>                             drain_buffer_;
+
+    // Journal: entry n lives at journal_[n & journal_mask_]; [head - size, head) is valid
+    std::vector<JournalEntry> journal_;
+    size_t                    journal_mask_;
+    uint64_t                  journal_head_{0};
+    std::vector<uint64_t>     firm_sequence_;  // Next sequence per firm id
+
+    std::vector<std::unique_ptr<Subscriber>> subscribers_;
+    std::vector<pollfd>                      poll_fds_;
+
+    std::atomic<uint64_t> reports_journaled_{0};
+    std::atomic<uint64_t> replays_{0};
+    std::atomic<uint64_t> gaps_{0};
+    std::atomic<uint64_t> requests_refused_{0};
+    std::atomic<size_t>   subscriber_count_{0};
+
+    void run();
+    bool drain_reactors();
+    void journal(const DropCopyRecord& record);
+    void accept_subscribers();
+    bool read_requests(Subscriber& sub);
+    void handle_request(Subscriber& sub, const DropCopyRequest& request);
+    bool pump(Subscriber& sub);
+    uint64_t oldest() const {
+        return journal_head_ > journal_.size() ? journal_head_ - journal_.size() : 0;
+    }
+};
+
+} // namespace rtes
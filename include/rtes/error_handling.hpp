@@ -37,6 +37,9 @@ enum class ErrorCode {
     RISK_LIMIT_EXCEEDED,
     INVALID_CONFIGURATION,
     INVALID_ARGUMENT,
+    ORDER_WOULD_CROSS,        // Post-only order would take liquidity
+    ORDER_UNFILLABLE,         // FOK order cannot fill in full
+    ORDER_HALTED,             // Book is halted (cancel-only)
     
     // System errors
     SYSTEM_SHUTDOWN = 5000,
@@ -0,0 +1,372 @@
+#pragma once
+
+/**
+ * @file event_journal.hpp
+ * @brief Write-ahead journal of every request an engine accepts and every outcome it produces
+ *
+ *   engine ─ JournalLane (SPSC) ─┐
+ *   engine ─ JournalLane (SPSC) ─┼─► journal thread ─► aligned buffer ─► pwrite (+ fdatasync)
+ *
+ * Each engine appends fixed-size JournalRecords to its own lane with one
+ * try_push: a full lane drops the record and counts it, so durability
+ * never blocks matching. Records carry a per-engine sequence assigned
+ * before the push, so a drop shows up in the file as a gap.
+ *
+ * The journal thread drains the lanes in bulk into a block-aligned
+ * buffer and writes it out in whole blocks at block-aligned offsets,
+ * which is what O_DIRECT requires. A partially filled last block is
+ * written zero-padded and rewritten in place by the next write (a zero
+ * record type marks the padding). fsync policy: never, after every
+ * write, or at most every sync interval.
+ *
+ * Segmented mode (JournalOptions::segment_bytes > 0) swaps the buffer
+ * for a sequence of fixed-size files, each pre-allocated with fallocate
+ * and mapped MAP_SHARED: lanes are drained straight into the mapping
+ * (plain stores, no write syscalls), writeback is started with
+ * sync_file_range every millisecond and made durable with msync on the
+ * sync policy. A full segment is synced, trimmed to its records and
+ * unmapped, and the next one is opened. The engines still go through
+ * their lanes: a store into a fresh mapping can fault, which the
+ * journal thread may absorb and a matching thread must not.
+ *
+ * File layout: one JOURNAL_BLOCK-sized JournalFileHeader, then records
+ * up to the first PADDING record or the end of the file. MappedJournal
+ * maps a file read-only and hands out the records in place, so replay
+ * and offline tools iterate a day of segments without parsing or
+ * copying; read_journal() is the callback form.
+ *
+ * Files and segments are created with O_EXCL: a journal never overwrites
+ * another. Each EventJournal draws a random run id, stamped in the header
+ * of every file it writes, so recovery can tell a segment of this run
+ * from a leftover of another one under the same name.
+ */
+
+#include "rtes/types.hpp"
+#include "rtes/matching_engine.hpp"
+#include "rtes/spsc_queue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rtes {
+
+inline constexpr size_t   JOURNAL_BLOCK          = 4096;     // Write alignment and size granularity
+inline constexpr size_t   JOURNAL_DEFAULT_LANE   = 16384;    // Records per engine lane
+inline constexpr size_t   JOURNAL_DEFAULT_BUFFER = 1 << 20;  // Bytes per write, at most
+inline constexpr size_t   JOURNAL_MAX_ENGINES    = 64;
+inline constexpr uint32_t JOURNAL_VERSION        = 2;
+inline constexpr char     JOURNAL_MAGIC[8]       = {'R', 'T', 'E', 'S', 'J', 'R', 'N', 'L'};
+
+enum class JournalRecordType : uint8_t {
+    PADDING      = 0,  // Zero fill after the last record of a block-padded write
+    NEW_ORDER    = 1,  // Accepted by risk, dequeued by the engine
+    CANCEL_ORDER = 2,
+    MODIFY_ORDER = 3,
+    SET_PHASE    = 4,
+    MASS_CANCEL  = 5,
+    TRADE        = 6,  // Engine outputs
+    ORDER_DONE   = 7,
+    ORDER_REJECT = 8,
+};
+
+[[nodiscard]] const char* journal_record_type_name(JournalRecordType type);
+
+/**
+ * One journaled event. Requests are logged as dequeued, before they are
+ * processed, so the outputs they cause follow them in the same lane:
+ *   NEW_ORDER:    new_order (everything needed to rebuild the Order)
+ *   CANCEL_ORDER: order.id
+ *   MODIFY_ORDER: modify.*
+ *   SET_PHASE:    phase
+ *   MASS_CANCEL:  mass_cancel.owner (book NO_BOOK: every book)
+ *   TRADE:        trade
+ *   ORDER_DONE:   done.*  (status FILLED or CANCELLED)
+ *   ORDER_REJECT: reject.* (reason: ErrorCode value)
+ */
+struct alignas(64) JournalRecord {
+    uint64_t          seq{0};   // Per engine, from 1; a gap is records a full lane dropped
+    Timestamp         time{0};  // Engine steady clock at the start of its batch (see the header)
+    JournalRecordType type{JournalRecordType::PADDING};
+    uint8_t           reserved{0};
+    uint16_t          engine{0};  // Index in the header's engine names
+    BookIndex         book{0};
+    uint16_t          reserved2{0};
+
+    union {
+        struct {
+            OrderID        id;
+            Price          price;
+            Quantity       quantity;
+            Quantity       display_quantity;
+            Price          stop_price;
+            Timestamp      timestamp;
+            Symbol         symbol;
+            ClientID       client_id;
+            ClientIDRaw    owner;
+            Side           side;
+            OrderType      type;
+            GatewayReactor ingress;
+        } new_order;
+
+        struct {
+            OrderID id;
+        } order;
+
+        struct {
+            OrderID  id;
+            Quantity new_quantity;
+            Price    new_price;
+        } modify;
+
+        TradingPhase phase;
+
+        struct {
+            ClientIDRaw owner;
+        } mass_cancel;
+
+        Trade trade;
+
+        struct {
+            OrderID     id;
+            Quantity    filled_quantity;
+            Quantity    leaves_quantity;
+            OrderStatus status;
+        } done;
+
+        struct {
+            OrderID  id;
+            uint32_t reason;
+        } reject;
+    };
+
+    // ── Trivial lifecycle (no manual union management) ──
+    JournalRecord() : new_order{} {}
+    ~JournalRecord() = default;
+    JournalRecord(const JournalRecord&) = default;
+    JournalRecord& operator=(const JournalRecord&) = default;
+    JournalRecord(JournalRecord&&) = default;
+    JournalRecord& operator=(JournalRecord&&) = default;
+};
+
+static_assert(std::is_trivially_copyable_v<JournalRecord>,
+              "JournalRecord must be trivially copyable for lock-free queues and raw writes");
+static_assert(sizeof(JournalRecord) == 128, "JournalRecord is two cache lines");
+static_assert(JOURNAL_BLOCK % sizeof(JournalRecord) == 0, "Records must not straddle blocks");
+
+/** First block of a journal file */
+struct JournalFileHeader {
+    char     magic[8]{};
+    uint32_t version{JOURNAL_VERSION};
+    uint32_t record_size{sizeof(JournalRecord)};
+    int64_t  steady_base_ns{0};  // steady clock and Unix time read together at open:
+    int64_t  unix_base_ns{0};    //   unix = record.time - steady_base_ns + unix_base_ns
+    uint32_t engine_count{0};
+    uint32_t segment{0};         // Index in the journal's segment sequence (0 if unsegmented)
+    uint64_t run_id{0};          // Same in every segment of one EventJournal, random per run
+    char     engine_names[JOURNAL_MAX_ENGINES][32]{};
+};
+
+static_assert(sizeof(JournalFileHeader) <= JOURNAL_BLOCK, "Header must fit one block");
+
+enum class JournalSync : uint8_t {
+    NONE     = 0,  // The page cache decides (survives a process crash, not a power loss)
+    INTERVAL = 1,  // fdatasync at most every sync_interval
+    BATCH    = 2,  // fdatasync after every write
+};
+
+/** Parse "none" / "interval" / "batch" (default INTERVAL) */
+[[nodiscard]] JournalSync parse_journal_sync(const std::string& name);
+
+struct JournalOptions {
+    JournalSync               sync{JournalSync::INTERVAL};
+    std::chrono::milliseconds sync_interval{10};
+    bool                      direct_io{false};  // O_DIRECT: bypass the page cache
+    size_t                    lane_capacity{JOURNAL_DEFAULT_LANE};
+    size_t                    buffer_bytes{JOURNAL_DEFAULT_BUFFER};  // Rounded up to JOURNAL_BLOCK
+    size_t                    segment_bytes{0};  // > 0: mapped segments of this size (see the file comment)
+};
+
+/** Segment `index` of the journal at `path`: "<stem>-000042.journal" */
+[[nodiscard]] std::string journal_segment_path(const std::string& path, uint32_t index);
+
+/** The segments of the journal at `path` that exist, in order */
+[[nodiscard]] std::vector<std::string> list_journal_segments(const std::string& path);
+
+/**
+ * Producer end for one engine. append() stamps the next sequence and
+ * tries one push; it never waits. Engine thread only.
+ */
+class ReplicationPrimary;
+
+class JournalLane {
+public:
+    JournalLane(uint16_t engine, size_t capacity) : queue_(capacity), engine_(engine) {}
+
+    void append(JournalRecord& record) {
+        record.seq    = ++seq_;
+        record.engine = engine_;
+        if (!queue_.push(record)) [[unlikely]] {
+            drops_.store(drops_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+    }
+
+    [[nodiscard]] uint64_t drops() const { return drops_.load(std::memory_order_relaxed); }
+    /** Sequence of the last record appended. Engine thread only. */
+    [[nodiscard]] uint64_t sequence() const { return seq_; }
+    [[nodiscard]] uint16_t engine() const { return engine_; }
+
+    SPSCQueue<JournalRecord>& queue() { return queue_; }
+
+private:
+    SPSCQueue<JournalRecord> queue_;
+    uint64_t                 seq_{0};
+    uint16_t                 engine_;
+    std::atomic<uint64_t>    drops_{0};
+};
+
+class EventJournal {
+public:
+    explicit EventJournal(std::string path, const JournalOptions& options = {});
+    ~EventJournal();
+
+    EventJournal(const EventJournal&) = delete;
+    EventJournal& operator=(const EventJournal&) = delete;
+
+    /**
+     * Lane for one more engine (MatchingEngine::set_event_journal). Before start().
+     * @throws std::length_error past JOURNAL_MAX_ENGINES
+     */
+    JournalLane* add_engine(const std::string& name);
+
+    /**
+     * Also hand every drained request to a standby (see replication.hpp):
+     * connected at start(), fed and flushed by the journal thread. Before start().
+     */
+    void set_replicator(ReplicationPrimary* replicator) { replicator_ = replicator; }
+
+    /**
+     * Create the file and its header, then start the journal thread.
+     * @return false if the file cannot be created, or already exists
+     *         (nothing is journaled)
+     */
+    bool start();
+
+    /** Drain what the engines left, write it, sync, and close. Stop the engines first. */
+    void stop();
+
+    /** The file, or the base name of the segments (see journal_segment_path()) */
+    [[nodiscard]] const std::string& path() const { return path_; }
+    [[nodiscard]] uint32_t segments() const { return segments_.load(std::memory_order_relaxed); }
+    /** Stamped in every file header (JournalFileHeader::run_id); never 0 */
+    [[nodiscard]] uint64_t run_id() const { return header_.run_id; }
+
+    // Statistics
+    uint64_t records_written() const { return records_.load(std::memory_order_relaxed); }
+    uint64_t bytes_written() const { return bytes_.load(std::memory_order_relaxed); }
+    uint64_t syncs() const { return syncs_.load(std::memory_order_relaxed); }
+    uint64_t write_errors() const { return write_errors_.load(std::memory_order_relaxed); }
+    /** Records the engines' lanes dropped (full) */
+    uint64_t drops() const;
+
+private:
+    std::string                               path_;
+    JournalOptions                            options_;
+    std::vector<std::string>                  engine_names_;
+    std::vector<std::unique_ptr<JournalLane>> lanes_;
+    ReplicationPrimary*                       replicator_{nullptr};
+
+    int                                              fd_{-1};
+    std::unique_ptr<std::byte, void (*)(void*)>      buffer_{nullptr, std::free};
+    size_t                                           buffer_capacity_{0};
+    size_t                                           buffer_used_{0};
+    uint64_t                                         buffer_offset_{0};  // File offset of buffer_[0] (block aligned)
+    std::chrono::steady_clock::time_point            last_sync_;
+    bool                                             unsynced_{false};
+    bool                                             unwritten_{false};  // Records not yet written (flushed)
+
+    // Segmented mode: the mapped segment, [0, map_used_) holding the header block and records
+    std::byte* map_{nullptr};
+    size_t     map_size_{0};
+    size_t     map_used_{0};
+    size_t     map_flushed_{0};  // Writeback started up to here
+    size_t     map_synced_{0};   // Durable up to here
+    uint64_t   closed_bytes_{0}; // Bytes in the segments already closed
+    uint32_t   segment_index_{0};
+    JournalFileHeader header_;
+
+    std::thread       thread_;
+    std::atomic<bool> running_{false};
+
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> syncs_{0};
+    std::atomic<uint64_t> write_errors_{0};
+    std::atomic<uint32_t> segments_{0};
+
+    void run();
+    /** Move what the lanes hold into the buffer (or segment), writing (rolling) whenever it fills */
+    size_t drain();
+    /** Write the buffer (last block zero-padded) and keep its partial block */
+    void write_buffer();
+    void sync(bool force);
+
+    bool open_file();
+    bool open_segment();
+    size_t drain_to_segment();
+    /** Sync, trim to the records, unmap and close */
+    void close_segment();
+    /** Start writeback of what was stored since the last flush */
+    void flush_segment();
+};
+
+/**
+ * Read-only view of one journal file (or segment), mapped: records() are
+ * the records in place. Move-only; unmaps on destruction.
+ */
+class MappedJournal {
+public:
+    MappedJournal() = default;
+    ~MappedJournal();
+
+    MappedJournal(MappedJournal&& other) noexcept;
+    MappedJournal& operator=(MappedJournal&& other) noexcept;
+    MappedJournal(const MappedJournal&) = delete;
+    MappedJournal& operator=(const MappedJournal&) = delete;
+
+    /** @return false if the file is missing or is not a journal */
+    [[nodiscard]] bool open(const std::string& path);
+
+    [[nodiscard]] const JournalFileHeader& header() const {
+        return *reinterpret_cast<const JournalFileHeader*>(data_);
+    }
+
+    /** Every record, up to the first PADDING one (the unwritten tail of a segment) */
+    [[nodiscard]] std::span<const JournalRecord> records() const { return records_; }
+
+private:
+    void*                          data_{nullptr};
+    size_t                         size_{0};
+    std::span<const JournalRecord> records_;
+
+    void close();
+};
+
+/**
+ * Read a journal file or segment back through MappedJournal, calling
+ * `visit` for every record in file order.
+ * @param header Out: the file header, if not null
+ * @return false if the file is missing or is not a journal
+ */
+bool read_journal(const std::string& path, const std::function<void(const JournalRecord&)>& visit,
+                  JournalFileHeader* header = nullptr);
+
+} // namespace rtes
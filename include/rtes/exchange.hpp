@@ -14,31 +14,54 @@
  *   Exchange owns:
  *     ├── Config (moved in at construction)
  *     ├── OrderPool (pre-allocated memory for orders)
- *     ├── RiskManager (single instance, single thread)
- *     ├── MatchingEngine[] (one per symbol, one thread each)
- *     └── MPMCQueue<MarketDataEvent> (engines → UDP publisher)
+ *     ├── ClientDirectory (ClientID → dense id, shared by gateway and risk)
+ *     ├── InstrumentDirectory (Symbol ↔ 16-bit id, protocol v2)
+ *     ├── RiskManager[] (risk_shards threads; clients partitioned by hash)
+ *     ├── MatchingEngine[] (one thread each; a dedicated symbol or a
+ *     │                     shard of symbols sharing engine_shard)
+ *     ├── MarketDataLane[] (SPSC, each engine → each UDP publisher it feeds)
+ *     ├── SPSCQueue<ExecutionReport>[] (each engine + risk shard → TCP gateway)
+ *     ├── SPSCQueue<RiskFeedback>[] (each engine → each risk shard)
+ *     ├── EventJournal (persistence.enable_event_log: a lane per engine → file)
+ *     └── ReplicationPrimary / ReplicationStandby (replication.role)
  *
  * Thread model:
  *   Exchange itself is NOT thread-safe.
  *   start()/stop() must be called from the main thread.
  *   Component accessors return pointers used by their respective threads:
- *     - Gateway thread uses: risk_manager, order_pool
- *     - Publisher thread uses: market_data_queue
+ *     - Gateway thread uses: risk shards, order_pool, execution queues
+ *     - Publisher thread p uses: market_data_lanes(p)
  *     - Monitoring thread uses: get_stats(), get_health()
  *
  * Lifecycle state machine:
  *   CREATED → STARTING → RUNNING → STOPPING → STOPPED
+ *   A standby (replication.role "standby") waits in STANDBY, applying
+ *   the primary's requests, until promote() takes it to RUNNING.
  *   Only forward transitions allowed. No restart.
  */
 
+#include "rtes/book_snapshot.hpp"
 #include "rtes/config.hpp"
+#include "rtes/event_journal.hpp"
 #include "rtes/memory_pool.hpp"
+#include "rtes/replication.hpp"
 #include "rtes/risk_manager.hpp"
 #include "rtes/matching_engine.hpp"
 #include "rtes/mpmc_queue.hpp"
+#include "rtes/spsc_queue.hpp"
+#include "rtes/stats_region.hpp"
+#include "rtes/idle_strategy.hpp"
+#include "rtes/instrument_directory.hpp"
+#include "rtes/thread_affinity.hpp"
 #include "rtes/types.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
 #include <unordered_map>
 #include <string>
 #include <vector>
@@ -57,6 +80,7 @@ enum class ExchangeState : uint8_t {
     RUNNING  = 2,   // All components active
     STOPPING = 3,   // Shutdown in progress
     STOPPED  = 4,   // All components stopped
+    STANDBY  = 5,   // Engines follow the primary's requests; risk and engines not started
 };
 
 // ═══════════════════════════════════════════════════════════════
@@ -81,6 +105,33 @@ struct ExchangeHealth {
     std::vector<ComponentHealth>  components;
 };
 
+/**
+ * One partition of the UDP feed (exchange.udp_channels): where it is
+ * sent, and which publisher thread serves it (channel i → publisher
+ * i % market_data_publishers). Symbols pick one with md_channel.
+ */
+struct MarketDataChannel {
+    std::string group;
+    uint16_t    port{0};
+    size_t      publisher{0};
+};
+
+/**
+ * One matching engine of a configuration: a dedicated symbol (named
+ * after it) or a shard of the symbols sharing engine_shard ("shard-<id>").
+ */
+struct EngineLayout {
+    std::string           name;
+    std::vector<BookSpec> books;  // BookIndex order; vacant slots (rebalancing) last
+    int32_t               shard{-1};  // -1: dedicated
+};
+
+/**
+ * The engines `config` runs, in creation order — which is also the
+ * order of their journal lanes. Used by Exchange and offline replay.
+ */
+[[nodiscard]] std::vector<EngineLayout> engine_layout(const Config& config);
+
 /**
  * Exchange-wide statistics (aggregated from all components).
  */
@@ -95,6 +146,8 @@ struct ExchangeStats {
     // Market data
     uint64_t market_data_events{0};
     uint64_t market_data_drops{0};
+    uint64_t execution_report_drops{0};
+    uint64_t risk_feedback_drops{0};     // Engine → risk events lost (exposure not released)
     size_t   market_data_queue_depth{0};
 
     // Memory
@@ -102,14 +155,53 @@ struct ExchangeStats {
     size_t   order_pool_allocated{0};
     size_t   order_pool_high_water{0};
     double   order_pool_utilization{0.0};
+    PageBacking order_pool_pages{PageBacking::HEAP};
+    size_t   order_pool_nodes{1};        // Per-NUMA-node pools (1 = a single pool)
+    size_t   order_pool_segments{1};     // Node pools plus growth segments
+    size_t   order_pool_parked{0};       // Slots of growth segments released to the kernel
 
-    // Per-symbol engine stats
+    // Per-engine stats (a dedicated symbol or a shard)
     struct EngineStats {
-        Symbol   symbol;
-        uint64_t orders_processed{0};
-        uint64_t trades_executed{0};
+        std::string name;
+        size_t      books{0};
+        uint64_t    orders_processed{0};
+        uint64_t    trades_executed{0};
+        uint64_t    input_drops{0};  // Requests refused: input lane full
+        std::vector<IngressLaneStats> lanes;
+        std::vector<BookScheduleStats> schedule;  // Per book, fair-scheduled shards only
     };
     std::vector<EngineStats> engines;
+
+    // Risk ingress, one entry per gateway lane (shard-major when sharded)
+    std::vector<IngressLaneStats> risk_lanes;
+
+    // Market data lanes (engine → publisher): depth, capacity and telemetry only
+    std::vector<IngressLaneStats> market_data_lanes;
+
+    // Hot-thread placement as applied (core -1 = floating) and idle behaviour
+    struct ThreadStats {
+        std::string     thread;
+        ThreadPlacement placement;
+        IdleStats       idle;
+    };
+    std::vector<ThreadStats> threads;
+    bool memory_locked{false};
+
+    // Event journal (persistence.enable_event_log)
+    uint64_t journal_records{0};
+    uint64_t journal_drops{0};   // Lost to a full engine lane: gaps in that engine's sequence
+    uint64_t journal_bytes{0};
+    uint64_t journal_syncs{0};
+
+    // Book snapshots (persistence.snapshot_interval_ms)
+    uint64_t snapshots_written{0};
+    uint64_t snapshots_skipped{0};  // Due while the engine's previous one was still being written
+
+    // Replication (replication.role)
+    bool     replication_connected{false};  // Primary: standby attached; standby: primary attached
+    uint64_t replication_frames{0};         // Sent (primary) or applied (standby)
+    uint64_t replication_requests{0};
+    uint64_t replication_backlog{0};        // Primary: bytes the socket has not taken yet
 };
 
 // ═══════════════════════════════════════════════════════════════
@@ -146,17 +238,34 @@ public:
     /**
      * Start all components in dependency order:
      *   1. OrderPool (already ready — pre-allocated)
-     *   2. MatchingEngines (spawn per-symbol threads)
-     *   3. RiskManager (spawn validation thread)
+     *   2. Memory lock (mlockall) if performance.lock_memory
+     *   3. MatchingEngines (spawn one thread per engine)
+     *   4. RiskManager shards (spawn one validation thread each)
+     *
+     * A standby (replication.role "standby") only starts the journal and
+     * the replication listener, and stays in STANDBY until promote().
      *
      * @throws std::runtime_error if any component fails to start
      * @throws std::logic_error if not in CREATED state
      */
     void start();
 
+    /**
+     * Standby → RUNNING: stop applying the primary's stream and start the
+     * engines and risk shards on the books it built. Risk limits and
+     * sessions start empty; clients reconnect.
+     * @throws std::logic_error if not in STANDBY state
+     */
+    void promote();
+
+    /** A standby whose primary has been silent for replication.promote_after_ms */
+    [[nodiscard]] bool promotion_due() const {
+        return replication_standby_ && replication_standby_->promotion_due();
+    }
+
     /**
      * Stop all components in reverse order:
-     *   1. RiskManager (stop accepting new orders)
+     *   1. RiskManager shards (stop accepting new orders)
      *   2. MatchingEngines (drain and stop)
      *   3. OrderPool (no action needed)
      *
@@ -191,20 +300,93 @@ public:
         return *config_;
     }
 
+    /**
+     * Placement for a hot thread configured on `core`: pinned (and
+     * SCHED_FIFO if realtime_priority is set) only when
+     * enable_cpu_pinning is on. Used for components main.cpp owns.
+     */
+    [[nodiscard]] ThreadPlacement thread_placement(int32_t core) const;
+
     // ═══════════════════════════════════════════════════════
     //  Component Access (for wiring external components)
     // ═══════════════════════════════════════════════════════
 
     /**
-     * Risk manager pointer. Used by TcpGateway to submit orders.
+     * Risk shard 0 — the only risk manager unless performance.risk_shards > 1.
      * @pre state >= CREATED
      */
     [[nodiscard]] RiskManager* get_risk_manager() {
-        return risk_manager_.get();
+        return risk_shards_.front().get();
     }
 
     [[nodiscard]] const RiskManager* get_risk_manager() const {
-        return risk_manager_.get();
+        return risk_shards_.front().get();
+    }
+
+    /**
+     * Every risk shard, indexed by shard. Used by TcpGateway to submit a
+     * client's requests to risk_shard_for(client, size()).
+     */
+    [[nodiscard]] std::vector<RiskManager*> get_risk_shards() {
+        std::vector<RiskManager*> shards;
+        shards.reserve(risk_shards_.size());
+        for (auto& shard : risk_shards_) shards.push_back(shard.get());
+        return shards;
+    }
+
+    /**
+     * Client directory shared by every risk shard. The gateway resolves
+     * each session's ClientID here and stamps the dense id on requests.
+     */
+    [[nodiscard]] ClientDirectory* get_client_directory() {
+        return client_directory_.get();
+    }
+
+    /** Published instrument ids (config order); the gateway decodes v2 orders with it. */
+    [[nodiscard]] const InstrumentDirectory* get_instrument_directory() const {
+        return instrument_directory_.get();
+    }
+
+    /** Last-trade reference prices shared by the engines and risk shards. */
+    [[nodiscard]] ReferencePriceTable* get_reference_prices() {
+        return reference_prices_.get();
+    }
+
+    /** Top of book per symbol, readable from any thread (bbo_table.hpp). */
+    [[nodiscard]] BBOTable* get_bbo_table() {
+        return bbo_table_.get();
+    }
+
+    /**
+     * Every engine's and risk shard's counters (stats_region.hpp): engine
+     * blocks first, then risk shards. In /dev/shm when
+     * performance.stats_shm_name is set. nullptr before initialize().
+     */
+    [[nodiscard]] const StatsRegion* get_stats_region() const {
+        return stats_region_.get();
+    }
+
+    /**
+     * Order lifecycle tracer the engines and risk shards stamp into;
+     * pass to TcpGateway::set_order_tracer(). nullptr unless
+     * performance.order_trace_sample > 0.
+     */
+    [[nodiscard]] OrderTracer* get_order_tracer() {
+        return order_tracer_.get();
+    }
+
+    [[nodiscard]] const OrderTracer* get_order_tracer() const {
+        return order_tracer_.get();
+    }
+
+    /** Write-ahead journal, nullptr unless persistence.enable_event_log. */
+    [[nodiscard]] const EventJournal* get_event_journal() const {
+        return event_journal_.get();
+    }
+
+    /** Book snapshot writer, nullptr unless the event log and snapshot_interval_ms are set. */
+    [[nodiscard]] const BookSnapshotWriter* get_book_snapshots() const {
+        return book_snapshots_.get();
     }
 
     /**
@@ -220,32 +402,95 @@ public:
     }
 
     /**
-     * Market data queue. Used by UdpPublisher to consume events.
-     * @pre state >= CREATED
+     * Input lanes of publisher `publisher`, one per engine with a book on
+     * a channel it serves. Pass each to UdpPublisher::add_input().
+     * @pre state >= CREATED, publisher < market_data_publishers()
+     */
+    [[nodiscard]] const std::vector<MarketDataLane*>& get_market_data_lanes(size_t publisher = 0) const {
+        return publisher_lanes_.at(publisher);
+    }
+
+    /**
+     * Idle strategy the engines notify after publishing to `publisher`'s
+     * lanes. Pass to that UdpPublisher so it wakes on new events.
+     * Configured from performance.market_data_idle_policy.
+     */
+    [[nodiscard]] IdleStrategy* get_market_data_idle(size_t publisher = 0) {
+        return market_data_idles_.at(publisher).get();
+    }
+
+    /** UDP publisher threads the market data lanes are laid out for (≥ 1) */
+    [[nodiscard]] size_t market_data_publishers() const { return publisher_lanes_.size(); }
+
+    /** Feed partitions, indexed by MarketDataEvent::channel (≥ 1) */
+    [[nodiscard]] const std::vector<MarketDataChannel>& market_data_channels() const {
+        return market_data_channels_;
+    }
+
+    /** TCP gateway reactor threads the execution queues are laid out for. */
+    [[nodiscard]] size_t gateway_reactors() const {
+        const size_t limit = shm_entry_enabled() ? UINT8_MAX : UINT8_MAX + 1;
+        return std::clamp<size_t>(config_->performance.gateway_reactors, 1, limit);
+    }
+
+    /** Shared memory order entry configured (performance.shm_entry_name). */
+    [[nodiscard]] bool shm_entry_enabled() const {
+        return !config_->performance.shm_entry_name.empty();
+    }
+
+    /**
+     * Reactor index (Order::ingress) and risk lane of the shared memory
+     * order entry poller: the one after the TCP reactors.
      */
-    [[nodiscard]] MPMCQueue<MarketDataEvent>* get_market_data_queue() {
-        return market_data_queue_.get();
+    [[nodiscard]] size_t shm_entry_reactor() const { return gateway_reactors(); }
+
+    /** Every thread submitting orders and reading reports: TCP reactors, then the shm poller. */
+    [[nodiscard]] size_t ingress_reactors() const {
+        return gateway_reactors() + (shm_entry_enabled() ? 1 : 0);
     }
 
-    [[nodiscard]] const MPMCQueue<MarketDataEvent>* get_market_data_queue() const {
-        return market_data_queue_.get();
+    /**
+     * Per-order report queues consumed by ingress `reactor`, one per
+     * producer thread (each engine, then each risk shard).
+     */
+    [[nodiscard]] std::vector<SPSCQueue<ExecutionReport>*> get_execution_queues(size_t reactor = 0) {
+        const size_t reactors = ingress_reactors();
+        std::vector<SPSCQueue<ExecutionReport>*> queues;
+        for (size_t i = reactor; i < execution_queues_.size(); i += reactors) {
+            queues.push_back(execution_queues_[i].get());
+        }
+        return queues;
+    }
+
+    /** Rung by report producers; gateway `reactor` polls its fd. */
+    [[nodiscard]] EventDoorbell* get_execution_doorbell(size_t reactor = 0) {
+        return reactor < execution_doorbells_.size() ? execution_doorbells_[reactor].get() : nullptr;
     }
 
     /**
-     * Matching engine for a specific symbol.
+     * Matching engine hosting a specific symbol. Sharded symbols share
+     * an engine — use engine->book_index(symbol) to address the book.
      * Zero allocation: uses Symbol (FixedString) key directly.
+     * With book rebalancing this stays the engine the config placed the
+     * symbol on (its read_depth() keeps following the book); symbol_host()
+     * tells where the book is now.
      *
      * @param symbol Symbol to look up
      * @return Engine pointer, or nullptr if symbol not found
      */
     [[nodiscard]] MatchingEngine* get_matching_engine(const Symbol& symbol) {
         auto it = matching_engines_.find(symbol);
-        return (it != matching_engines_.end()) ? it->second.get() : nullptr;
+        return (it != matching_engines_.end()) ? it->second : nullptr;
     }
 
     [[nodiscard]] const MatchingEngine* get_matching_engine(const Symbol& symbol) const {
         auto it = matching_engines_.find(symbol);
-        return (it != matching_engines_.end()) ? it->second.get() : nullptr;
+        return (it != matching_engines_.end()) ? it->second : nullptr;
+    }
+
+    /** Engine hosting instrument `id` (InstrumentDirectory), or nullptr: one array index. */
+    [[nodiscard]] MatchingEngine* get_matching_engine(InstrumentID id) {
+        return id < instrument_engines_.size() ? instrument_engines_[id] : nullptr;
     }
 
     /**
@@ -275,6 +520,63 @@ public:
         return matching_engines_.size();
     }
 
+    /**
+     * Number of matching engines (= matching threads).
+     */
+    [[nodiscard]] size_t engine_count() const {
+        return engines_.size();
+    }
+
+    // ═══════════════════════════════════════════════════════
+    //  Instrument Lifecycle
+    // ═══════════════════════════════════════════════════════
+
+    /**
+     * Every configured symbol has its book, risk slot and instrument id
+     * from construction; these change only its state byte
+     * (InstrumentDirectory), which risk shards load on each new order,
+     * and the book's phase, sent on the engine's control lane.
+     *
+     *   list_symbol    UNLISTED → OPEN    ("listed": false in the config)
+     *   halt_symbol    OPEN → HALTED      book cancel-only, new orders rejected
+     *   resume_symbol  HALTED → OPEN      book back to CONTINUOUS
+     *
+     * The book is switched first, then the state byte, so an order that
+     * raced a resume can still meet the halted book (rejected there with
+     * ORDER_HALTED). Safe from any thread; calls are serialized.
+     *
+     * @return false if the symbol is unknown, not in the `from` state, or
+     *         the control lane is full
+     */
+    bool list_symbol(const Symbol& symbol);
+    bool halt_symbol(const Symbol& symbol);
+    bool resume_symbol(const Symbol& symbol);
+
+    // ═══════════════════════════════════════════════════════
+    //  Book Rebalancing
+    // ═══════════════════════════════════════════════════════
+
+    /**
+     * Move `symbol`'s book to shard engine `to` while trading (see
+     * migrate_book()). Needs performance.rebalance_interval_ms, which
+     * gives every shard engine a vacant slot for the other shards'
+     * symbols; the rebalancer thread calls this on its own. Risk shards
+     * are rerouted first, the book follows once the old engine has matched
+     * what they sent it. Safe from any thread; serialized with the
+     * instrument lifecycle calls.
+     * @return false if the symbol has no slot on `to`, is already there,
+     *         or an engine stopped mid-move
+     */
+    bool migrate_symbol(const Symbol& symbol, MatchingEngine* to);
+
+    /** Engine whose thread matches `symbol` now, or nullptr if unknown. */
+    [[nodiscard]] MatchingEngine* symbol_host(const Symbol& symbol);
+
+    /** Current state of `symbol` (UNLISTED if unknown). */
+    [[nodiscard]] InstrumentState symbol_state(const Symbol& symbol) const {
+        return instrument_directory_->state(instrument_directory_->find(symbol));
+    }
+
     // ═══════════════════════════════════════════════════════
     //  Monitoring & Observability
     // ═══════════════════════════════════════════════════════
@@ -295,6 +597,16 @@ public:
      */
     [[nodiscard]] ExchangeStats get_stats() const;
 
+    /**
+     * Report an externally owned hot thread (gateway, publisher) in
+     * get_stats(). The component must outlive monitoring.
+     * @param idle  Idle stats source, if the thread has an IdleStrategy
+     */
+    void track_thread(std::string name, std::function<ThreadPlacement()> applied,
+                      std::function<IdleStats()> idle = {}) {
+        external_threads_.push_back({std::move(name), std::move(applied), std::move(idle)});
+    }
+
 private:
     // ═══════════════════════════════════════════════════════
     //  Owned State
@@ -306,6 +618,17 @@ private:
     /** Lifecycle state (main thread only — not atomic) */
     ExchangeState state_{ExchangeState::CREATED};
 
+    /** mlockall succeeded in start() */
+    bool memory_locked_{false};
+
+    /** Hot threads owned outside Exchange, reported in get_stats() */
+    struct ExternalThread {
+        std::string                      name;
+        std::function<ThreadPlacement()> applied;
+        std::function<IdleStats()>       idle;
+    };
+    std::vector<ExternalThread> external_threads_;
+
     // ═══════════════════════════════════════════════════════
     //  Core Components (owned, created in constructor)
     // ═══════════════════════════════════════════════════════
@@ -313,16 +636,84 @@ private:
     /** Pre-allocated order memory pool */
     std::unique_ptr<OrderPool> order_pool_;
 
-    /** Pre-trade risk validation */
-    std::unique_ptr<RiskManager> risk_manager_;
+    /** Grows the order pool off the hot path (order_pool_segment > 0 only) */
+    std::thread       pool_maintenance_thread_;
+    std::atomic<bool> pool_maintenance_running_{false};
+
+    /** Moves books between shard engines (rebalance_interval_ms > 0 only) */
+    std::thread                  rebalance_thread_;
+    std::atomic<bool>            rebalance_running_{false};
+    std::vector<MatchingEngine*> rebalance_engines_;  // Shard engines with vacant slots
+
+    /** ClientID → dense id (performance.max_clients) */
+    std::unique_ptr<ClientDirectory> client_directory_;
+
+    /** Symbol ↔ InstrumentID, fixed at construction; per-instrument state bytes */
+    std::unique_ptr<InstrumentDirectory> instrument_directory_;
+
+    /** Serializes the instrument lifecycle calls and book moves (one producer on each control lane) */
+    std::mutex control_mutex_;
+
+    /** Symbol → engine hosting its book now (guarded by control_mutex_) */
+    std::unordered_map<Symbol, MatchingEngine*, Symbol::Hash> book_hosts_;
+
+    /** Last trade price per symbol: engines write, risk collars read */
+    std::unique_ptr<ReferencePriceTable> reference_prices_;
+
+    /** Top of book per symbol: books write on change, anyone reads */
+    std::unique_ptr<BBOTable> bbo_table_;
+
+    /** Counters the engines and risk shards publish at each stats flush */
+    std::unique_ptr<StatsRegion> stats_region_;
+
+    /** Sampled per-order stage timestamps (order_trace_sample > 0 only) */
+    std::unique_ptr<OrderTracer> order_tracer_;
+
+    /** Journal of engine requests and outputs (enable_event_log only) */
+    std::unique_ptr<EventJournal> event_journal_;
+
+    /** Periodic copies of the engines' books, aligned with the journal */
+    std::unique_ptr<BookSnapshotWriter> book_snapshots_;
+
+    /** Request stream to the standby (replication.role "primary", fed by the journal) */
+    std::unique_ptr<ReplicationPrimary> replication_primary_;
+
+    /** Applies the primary's stream to the idle engines (replication.role "standby") */
+    std::unique_ptr<ReplicationStandby> replication_standby_;
 
-    /** Per-symbol matching engines */
-    std::unordered_map<Symbol,
-                       std::unique_ptr<MatchingEngine>,
-                       Symbol::Hash> matching_engines_;
+    /** Pre-trade risk validation, one thread per shard (never empty) */
+    std::vector<std::unique_ptr<RiskManager>> risk_shards_;
 
-    /** Market data queue (matching engines → UDP publisher) */
-    std::unique_ptr<MPMCQueue<MarketDataEvent>> market_data_queue_;
+    /** Matching engines, one thread each (dedicated symbols, then shards) */
+    std::vector<std::unique_ptr<MatchingEngine>> engines_;
+
+    /** Symbol → hosting engine (non-owning, points into engines_) */
+    std::unordered_map<Symbol, MatchingEngine*, Symbol::Hash> matching_engines_;
+
+    /** The same, indexed by InstrumentID (nullptr: no engine hosts it) */
+    std::vector<MatchingEngine*> instrument_engines_;
+
+    /** Market data lanes, one per (engine, publisher) pair that carries a book */
+    std::vector<std::unique_ptr<MarketDataLane>> market_data_lanes_;
+
+    /** Lanes each publisher consumes (non-owning, points into market_data_lanes_) */
+    std::vector<std::vector<MarketDataLane*>> publisher_lanes_;
+
+    /** Consumer-side idle strategy of each publisher (engines notify) */
+    std::vector<std::unique_ptr<IdleStrategy>> market_data_idles_;
+
+    /** Feed partitions (exchange.udp_channels, or the single default group) */
+    std::vector<MarketDataChannel> market_data_channels_;
+
+    /** Execution report queues, producer p → gateway reactor r at [p * reactors + r]
+     *  (producers: each engine, then each risk shard) */
+    std::vector<std::unique_ptr<SPSCQueue<ExecutionReport>>> execution_queues_;
+
+    /** Fill/done feedback, engine e → risk shard s at [e * shards + s] */
+    std::vector<std::unique_ptr<SPSCQueue<RiskFeedback>>> risk_feedback_rings_;
+
+    /** Wakes gateway reactor r's epoll loop when reports are published */
+    std::vector<std::unique_ptr<EventDoorbell>> execution_doorbells_;
 
     // ═══════════════════════════════════════════════════════
     //  Initialization (called from constructor)
@@ -335,32 +726,55 @@ private:
     void initialize_order_pool();
 
     /**
-     * Initialize market data queue.
-     * Must be created before matching engines (they publish to it).
+     * Pool maintenance thread: grow the order pool by a segment when
+     * its free slots fall below order_pool_low_water, and (with
+     * order_pool_release_idle) hand empty growth segments' pages back.
+     */
+    void pool_maintenance_loop();
+    [[nodiscard]] size_t pool_low_water() const;
+
+    /** Rebalancer thread: sample engine load every rebalance_interval_ms, move a book when uneven */
+    void rebalance_loop();
+
+    /**
+     * Initialize the market data channels and publishers. Their lanes
+     * are created in wire_components(), once the engines exist.
      */
     void initialize_market_data_queue();
 
     /**
-     * Initialize per-symbol matching engines.
-     * One engine per configured symbol, each with its own thread (on start).
-     * Engines are wired to the market data queue.
+     * Initialize matching engines.
+     * Symbols without engine_shard get a dedicated engine; symbols with
+     * the same engine_shard share one engine (one thread, N books),
+     * optionally pinned via performance.engine_shard_cores.
      */
     void initialize_matching_engines();
+    void check_numa_placement() const;  // Warn about engines pinned off the gateway's pool node
 
     /**
-     * Initialize risk manager.
+     * Initialize the risk shards (performance.risk_shards, default 1).
      * Must be created after matching engines (routes orders to them).
-     * Wired to all matching engines for order routing.
+     * Shard i produces into input lane i of every engine.
      */
     void initialize_risk_manager();
 
     /**
      * Wire components together:
-     *   - Matching engines → market data queue
-     *   - Risk manager → matching engines
+     *   - Matching engines → market data queue (+ reader wake-up)
+     *   - Risk shards → matching engines
      *   - Reference price feedback loop
      */
     void wire_components();
+
+    /** Engines, risk shards, tracer and pool maintenance (start(), or promote() on a standby) */
+    void start_trading();
+
+    /** Health/thread-stats name of a risk shard. */
+    [[nodiscard]] std::string risk_thread_name(size_t shard) const;
+
+    /** `from` → `to`; the book is sent `phase` first, if there is one */
+    bool change_symbol_state(const Symbol& symbol, InstrumentState from, InstrumentState to,
+                             std::optional<TradingPhase> phase);
 };
 
 } // namespace rtes
\ No newline at end of file
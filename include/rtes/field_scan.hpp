@@ -0,0 +1,151 @@
+#pragma once
+
+/**
+ * @file field_scan.hpp
+ * @brief Charset checks on short text fields, 16 bytes per compare
+ *
+ * Symbols and client ids are validated by finding the first byte outside
+ * the field's charset. NUL is outside every charset, so the same scan
+ * also finds the terminator: a fixed-width field is clean when the first
+ * byte outside is its NUL (or there is none).
+ *
+ * Each 16-byte block is range-compared whole (SSE2 on x86-64, NEON on
+ * AArch64, a byte loop elsewhere) and reduced to one bit per byte. The
+ * last partial block is copied into a zeroed block with its padding
+ * masked off, so nothing past `size` is read. Fields are 8-32 bytes:
+ * one or two blocks, no wider registers needed.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RTES_FIELD_SCAN_SSE2 1
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define RTES_FIELD_SCAN_NEON 1
+#endif
+
+namespace rtes {
+
+enum class FieldCharset : uint8_t {
+    SYMBOL,     // A-Z 0-9
+    CLIENT_ID,  // A-Z a-z 0-9 _ -
+    PRINTABLE,  // 0x20-0x7E, tab, LF, CR (what log and network text may keep)
+};
+
+/** Scalar definition of each charset (tail-free reference for the kernels). */
+constexpr bool in_charset(unsigned char c, FieldCharset charset) noexcept {
+    switch (charset) {
+        case FieldCharset::SYMBOL:
+            return (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+        case FieldCharset::CLIENT_ID:
+            return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+                   (c >= '0' && c <= '9') || c == '_' || c == '-';
+        case FieldCharset::PRINTABLE:
+            return (c >= 0x20 && c <= 0x7E) || c == '\t' || c == '\n' || c == '\r';
+    }
+    return false;
+}
+
+namespace detail {
+
+/** Bit i set: byte i of the 16-byte block is outside `charset`. */
+inline uint32_t outside_mask(const unsigned char* block, FieldCharset charset) noexcept {
+#if defined(RTES_FIELD_SCAN_SSE2)
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+    // Unsigned lo <= c <= hi as one signed compare: shift lo to -128
+    auto in = [v](unsigned char lo, unsigned char hi) {
+        const __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(0x80 - lo)));
+        return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(-128 + (hi - lo) + 1)));
+    };
+    auto is = [v](char c) { return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); };
+    __m128i ok;
+    switch (charset) {
+        case FieldCharset::SYMBOL:
+            ok = _mm_or_si128(in('A', 'Z'), in('0', '9'));
+            break;
+        case FieldCharset::CLIENT_ID:
+            ok = _mm_or_si128(_mm_or_si128(in('A', 'Z'), in('a', 'z')),
+                              _mm_or_si128(in('0', '9'), _mm_or_si128(is('_'), is('-'))));
+            break;
+        default:
+            ok = _mm_or_si128(_mm_or_si128(in(0x20, 0x7E), is('\t')),
+                              _mm_or_si128(is('\n'), is('\r')));
+            break;
+    }
+    return ~static_cast<uint32_t>(_mm_movemask_epi8(ok)) & 0xFFFFu;
+#elif defined(RTES_FIELD_SCAN_NEON)
+    const uint8x16_t v = vld1q_u8(block);
+    auto in = [v](unsigned char lo, unsigned char hi) {
+        return vandq_u8(vcgeq_u8(v, vdupq_n_u8(lo)), vcleq_u8(v, vdupq_n_u8(hi)));
+    };
+    auto is = [v](unsigned char c) { return vceqq_u8(v, vdupq_n_u8(c)); };
+    uint8x16_t ok;
+    switch (charset) {
+        case FieldCharset::SYMBOL:
+            ok = vorrq_u8(in('A', 'Z'), in('0', '9'));
+            break;
+        case FieldCharset::CLIENT_ID:
+            ok = vorrq_u8(vorrq_u8(in('A', 'Z'), in('a', 'z')),
+                          vorrq_u8(in('0', '9'), vorrq_u8(is('_'), is('-'))));
+            break;
+        default:
+            ok = vorrq_u8(vorrq_u8(in(0x20, 0x7E), is('\t')), vorrq_u8(is('\n'), is('\r')));
+            break;
+    }
+    // No movemask: weight each lane by its bit and add across each half
+    static const uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    const uint8x16_t bits = vandq_u8(vmvnq_u8(ok), vld1q_u8(weights));
+    return static_cast<uint32_t>(vaddv_u8(vget_low_u8(bits))) |
+           static_cast<uint32_t>(vaddv_u8(vget_high_u8(bits))) << 8;
+#else
+    uint32_t mask = 0;
+    for (unsigned i = 0; i < 16; ++i) {
+        if (!in_charset(block[i], charset)) mask |= 1u << i;
+    }
+    return mask;
+#endif
+}
+
+} // namespace detail
+
+/** Index of the first byte of data[0, size) outside `charset`, or size. */
+inline size_t find_outside(const char* data, size_t size, FieldCharset charset) noexcept {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(data);
+    size_t offset = 0;
+    for (; offset + 16 <= size; offset += 16) {
+        if (const uint32_t mask = detail::outside_mask(bytes + offset, charset)) {
+            return offset + static_cast<size_t>(__builtin_ctz(mask));
+        }
+    }
+    if (offset < size) {
+        alignas(16) unsigned char tail[16] = {};
+        std::memcpy(tail, bytes + offset, size - offset);
+        const uint32_t mask = detail::outside_mask(tail, charset) & ((1u << (size - offset)) - 1);
+        if (mask) return offset + static_cast<size_t>(__builtin_ctz(mask));
+    }
+    return size;
+}
+
+inline size_t find_outside(std::string_view text, FieldCharset charset) noexcept {
+    return find_outside(text.data(), text.size(), charset);
+}
+
+/** Not a clean field (see field_length) */
+inline constexpr size_t INVALID_FIELD = static_cast<size_t>(-1);
+
+/**
+ * Length of a NUL-terminated fixed-width field whose text is all in
+ * `charset`, or INVALID_FIELD. One scan finds both the terminator and
+ * any stray byte. A field with no NUL in its `width` bytes is invalid.
+ */
+inline size_t field_length(const char* field, size_t width, FieldCharset charset) noexcept {
+    const size_t stop = find_outside(field, width, charset);
+    return stop < width && field[stop] == '\0' ? stop : INVALID_FIELD;
+}
+
+} // namespace rtes
@@ -1,43 +1,194 @@
 #pragma once
 
-#include <thread>
+/**
+ * @file http_server.hpp
+ * @brief Non-blocking HTTP/1.1 server for metrics, health and admin endpoints
+ *
+ * One epoll thread serves every connection: sockets are non-blocking,
+ * requests are parsed from per-connection buffers (pipelining and
+ * keep-alive included), and responses that do not fit the socket buffer
+ * are finished on EPOLLOUT, so a slow or stalled client never holds up
+ * another. Idle connections are closed after HTTP_IDLE_TIMEOUT.
+ *
+ * Handlers run on the event thread and must be cheap. Expensive ones
+ * (a full /metrics scrape) go through add_cached_handler(): a refresher
+ * thread renders them every interval and requests are answered from the
+ * last rendering, so the scrape cost is paid once per interval however
+ * many scrapers ask.
+ *
+ * Live views subscribe to an event stream (add_event_stream(), served as
+ * Server-Sent Events). The refresher samples the stream's source once per
+ * tick and renders one snapshot and one delta (the fields that changed)
+ * that every subscriber shares: a subscriber gets the snapshot when it
+ * joins and deltas afterwards. A subscriber whose unsent backlog exceeds
+ * HTTP_STREAM_MAX_BACKLOG skips ticks and is resynchronised with the next
+ * snapshot, so a slow browser costs memory bounded by the backlog limit.
+ */
+
+#include "rtes/thread_affinity.hpp"
+
 #include <atomic>
-#include <string>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 namespace rtes {
 
 using HttpHandler = std::function<std::string(const std::string& path, const std::string& query)>;
 
+/** One sample of an event stream: field name -> value rendered as a JSON value */
+using HttpEventFields = std::vector<std::pair<std::string, std::string>>;
+using HttpEventSource = std::function<HttpEventFields()>;
+
+inline constexpr size_t HTTP_MAX_CONNECTIONS  = 256;
+inline constexpr size_t HTTP_MAX_REQUEST_BYTES = 8192;  // Request line + headers + body
+inline constexpr auto   HTTP_IDLE_TIMEOUT     = std::chrono::seconds(30);
+inline constexpr size_t HTTP_STREAM_MAX_BACKLOG = 64 * 1024;  // Unsent bytes before a subscriber skips ticks
+inline constexpr size_t HTTP_MAX_PENDING_OUTPUT = 1024 * 1024;  // Unsent responses before a non-reading client is closed
+
 class HttpServer {
 public:
     explicit HttpServer(uint16_t port);
     ~HttpServer();
-    
+
     void start();
     void stop();
-    
+
+    /** Called per request on the event thread. Before start(). */
     void add_handler(const std::string& path, HttpHandler handler);
-    
+
+    /**
+     * A state-changing endpoint: called only for a POST whose
+     * "Authorization: Bearer <token>" names a user allowed `operation`
+     * (AuthGuard, e.g. "config_reload"). Other methods get 405, a missing
+     * token 401 and a refused one 403. Before start().
+     */
+    void add_admin_handler(const std::string& path, HttpHandler handler, std::string operation);
+
+    /**
+     * Served from a rendering refreshed every `refresh` on the refresher
+     * thread (the query string is ignored). Rendered once in start().
+     * Before start().
+     */
+    void add_cached_handler(const std::string& path, HttpHandler handler, std::chrono::milliseconds refresh);
+
+    /**
+     * Server-Sent Events endpoint: `source` is sampled on the refresher
+     * thread every `interval` while anyone is subscribed. Events are
+     * `snapshot` (every field) and `delta` (changed fields, null for a
+     * removed one), each a flat JSON object. Before start().
+     */
+    void add_event_stream(const std::string& path, HttpEventSource source, std::chrono::milliseconds interval);
+
+    /** Event and refresher threads: keep off the hot cores, no SCHED_FIFO. Before start(). */
+    void set_thread_placement(const ThreadPlacement& placement) { placement_ = placement; }
+
     // Statistics
     uint64_t requests_served() const { return requests_served_.load(); }
+    uint64_t connections_accepted() const { return connections_accepted_.load(); }
+    size_t   connections_open() const { return connections_open_.load(); }
+    uint64_t stream_ticks() const { return stream_ticks_.load(); }          // Source samples taken
+    uint64_t stream_events_skipped() const { return stream_skipped_.load(); }  // Backlogged subscribers
 
 private:
+    struct EventStream;
+
+    struct Connection {
+        int         fd{-1};
+        std::string in;
+        std::string out;
+        size_t      out_sent{0};
+        bool        close_after{false};   // Close once `out` is flushed
+        bool        want_write{false};    // EPOLLOUT registered
+        EventStream* stream{nullptr};     // Subscribed: requests are no longer read
+        bool        needs_snapshot{true};
+        std::chrono::steady_clock::time_point last_active;
+    };
+
+    struct AdminHandler {
+        HttpHandler handler;
+        std::string operation;
+    };
+
+    struct CachedHandler {
+        HttpHandler                        handler;
+        std::chrono::milliseconds          refresh;
+        std::chrono::steady_clock::time_point next_refresh;
+        std::shared_ptr<const std::string> body;  // Guarded by cache_mutex_
+        bool                               failed{false};
+    };
+
+    struct StreamTick {
+        uint64_t    seq{0};
+        std::string snapshot;  // Complete SSE events
+        std::string delta;     // Empty if nothing changed
+    };
+
+    struct EventStream {
+        HttpEventSource           source;
+        std::chrono::milliseconds interval{0};
+        std::chrono::steady_clock::time_point next_tick;  // Refresher only
+        HttpEventFields           last;                    // Refresher only: sorted by name
+        uint64_t                  seq{0};                  // Refresher only
+        std::shared_ptr<const StreamTick> tick;            // Guarded by cache_mutex_
+        uint64_t                  delivered{0};            // Event thread only: last seq pushed
+        std::vector<int>          subscribers;             // Event thread only
+        std::atomic<size_t>       subscriber_count{0};
+    };
+
     uint16_t port_;
     std::atomic<bool> running_{false};
     std::thread server_thread_;
-    
+    std::thread refresh_thread_;
+    ThreadPlacement placement_;
+
     int listen_fd_{-1};
+    int epoll_fd_{-1};
+    int wake_fd_{-1};  // eventfd: the refresher signals new stream ticks
     std::unordered_map<std::string, HttpHandler> handlers_;
+    std::unordered_map<std::string, AdminHandler> admin_handlers_;
+    std::unordered_map<std::string, CachedHandler> cached_;
+    std::unordered_map<std::string, EventStream> streams_;
+    mutable std::mutex cache_mutex_;
+    std::unordered_map<int, Connection> connections_;  // Event thread only
+
     std::atomic<uint64_t> requests_served_{0};
-    
+    std::atomic<uint64_t> connections_accepted_{0};
+    std::atomic<size_t>   connections_open_{0};
+    std::atomic<uint64_t> stream_ticks_{0};
+    std::atomic<uint64_t> stream_skipped_{0};
+
     bool setup_listen_socket();
     void server_loop();
-    void handle_client(int client_fd);
-    
+    void refresh_loop();
+    void refresh_cached(bool force);
+    /** @return true if a stream ticked (the event thread must be woken) */
+    bool refresh_streams();
+    void publish_stream_ticks();
+    std::string subscribe(Connection& conn, EventStream& stream);
+
+    void accept_connections();
+    void on_readable(Connection& conn);
+    /** Parse and answer every complete request buffered on `conn` */
+    void process_requests(Connection& conn);
+    /** @return false if the connection was closed */
+    bool flush(Connection& conn);
+    void watch_writes(Connection& conn, bool enable);
+    void close_connection(int fd);
+    void close_idle_connections();
+
+    std::string respond(Connection& conn, const std::string& request, bool& keep_alive);
+
     std::string parse_request_path(const std::string& request_line);
-    std::string create_response(int status_code, const std::string& content_type, const std::string& body);
+    std::string create_response(int status_code, const std::string& content_type, const std::string& body,
+                                bool keep_alive = false);
 };
 
-} // namespace rtes
\ No newline at end of file
+} // namespace rtes
@@ -0,0 +1,108 @@
+#pragma once
+
+/**
+ * @file huge_pages.hpp
+ * @brief Page-backed storage for pools and queue buffers (huge pages, mlock)
+ *
+ * A PageRegion is a zeroed, cache-line-aligned block taken at the
+ * process page policy:
+ *
+ *   HUGE_1G ─► HUGE_2M ─► TRANSPARENT ─► HEAP   (each falls back to the next)
+ *
+ *   HUGE_1G / HUGE_2M  mmap(MAP_HUGETLB) from the hugetlbfs reserve
+ *                      (vm.nr_hugepages), pre-faulted with MAP_POPULATE
+ *   TRANSPARENT        2 MB-aligned anonymous mmap, madvise(MADV_HUGEPAGE),
+ *                      then touched so the kernel faults in huge pages
+ *   HEAP               aligned_alloc, as before
+ *
+ * 1 GB pages are only used for regions of at least half a gigabyte, and
+ * regions below PagePolicy::min_bytes always come from the heap, so small
+ * queues do not each round up to a huge page. With PagePolicy::lock the
+ * region is mlocked as well. backing() reports what the region actually
+ * got.
+ *
+ * A region can also be bound to a NUMA node (see numa.hpp): it is then
+ * mapped unpopulated, mbind()ed, and only then faulted in, so its pages
+ * come from that node whichever thread builds it. A heap region bound
+ * this way is plain anonymous mmap instead of aligned_alloc.
+ *
+ * Set the policy once at startup (Exchange does it from the config)
+ * before the pools and queues are built; regions keep the backing they
+ * were created with.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace rtes {
+
+inline constexpr size_t HUGE_PAGE_2M = size_t{2} << 20;
+inline constexpr size_t HUGE_PAGE_1G = size_t{1} << 30;
+
+enum class PageBacking : uint8_t {
+    HEAP        = 0,
+    TRANSPARENT = 1,  // THP requested; the kernel may still use 4 KB pages
+    HUGE_2M     = 2,
+    HUGE_1G     = 3,
+};
+
+[[nodiscard]] const char* page_backing_name(PageBacking backing);
+
+/** "heap" | "thp" | "2m" | "1g"; anything else = HEAP */
+[[nodiscard]] PageBacking parse_page_backing(std::string_view name);
+
+struct PagePolicy {
+    PageBacking backing{PageBacking::HEAP};  // Preferred backing; falls back down the chain
+    bool        lock{false};                 // mlock each region
+    size_t      min_bytes{HUGE_PAGE_2M};     // Smaller regions always come from the heap
+};
+
+/** Process-wide policy for regions created from now on */
+void set_page_policy(const PagePolicy& policy);
+[[nodiscard]] PagePolicy page_policy();
+
+class PageRegion {
+public:
+    PageRegion() = default;
+
+    /**
+     * At least `bytes`, zeroed and 64-byte aligned, at the current policy.
+     * @param numa_node Node to place the pages on, -1 = wherever first touched
+     * @throws std::bad_alloc if even the heap fails
+     */
+    explicit PageRegion(size_t bytes, int numa_node = -1);
+    ~PageRegion();
+
+    PageRegion(const PageRegion&) = delete;
+    PageRegion& operator=(const PageRegion&) = delete;
+    PageRegion(PageRegion&& other) noexcept;
+    PageRegion& operator=(PageRegion&& other) noexcept;
+
+    [[nodiscard]] void*       data() const { return data_; }
+    [[nodiscard]] size_t      size() const { return size_; }
+    [[nodiscard]] PageBacking backing() const { return backing_; }
+    [[nodiscard]] bool        locked() const { return locked_; }
+    [[nodiscard]] int         numa_node() const { return numa_node_; }  // -1 = not bound
+
+    /**
+     * Hand the region's whole pages back to the kernel (MADV_DONTNEED);
+     * they fault back in zeroed on the next touch. The caller must own
+     * every byte: nothing may be using the contents.
+     * @return false if locked, or not supported
+     */
+    bool release_pages();
+
+private:
+    void release();
+
+    void*       data_{nullptr};
+    size_t      size_{0};
+    void*       map_{nullptr};   // mmap base (THP over-maps to align); nullptr = heap
+    size_t      map_size_{0};
+    PageBacking backing_{PageBacking::HEAP};
+    bool        locked_{false};
+    int         numa_node_{-1};
+};
+
+} // namespace rtes
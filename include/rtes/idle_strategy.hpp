@@ -0,0 +1,213 @@
+#pragma once
+
+/**
+ * @file idle_strategy.hpp
+ * @brief What a hot consumer thread does when its input queue is empty
+ *
+ * Policies, fastest wake-up first:
+ *   BUSY_SPIN  : pause-spin and poll again. Lowest latency, burns the core.
+ *   SPIN_YIELD : spin, then sched_yield(). Never sleeps, but a floating
+ *                thread shares its core. (The historical behaviour.)
+ *   SPIN_PARK  : spin, then sleep on a futex until a producer notify()s
+ *                or park_timeout_us elapses. ~0% CPU while idle.
+ *
+ * Parking protocol (Dekker-style — no lost wake-ups):
+ *   consumer: state = PARKED; fence; re-check queue; futex_wait(PARKED)
+ *   producer: push; fence; if state == PARKED → state = IDLE; futex_wake
+ * While the consumer is busy, notify() is one load of a line the consumer
+ * only writes on idle transitions (plus a fence under SPIN_PARK).
+ *
+ * Wake-up latency (first notify() of an idle period → consumer back on
+ * work) is measured under every policy so they can be compared on the
+ * same load. Stats are approximate — a notify racing the end of an idle
+ * period may be attributed to the next one.
+ */
+
+#include "rtes/types.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace rtes {
+
+enum class IdlePolicy : uint8_t {
+    BUSY_SPIN  = 0,
+    SPIN_YIELD = 1,
+    SPIN_PARK  = 2,
+};
+
+/** "busy_spin" | "spin_yield" | "spin_park"; anything else → fallback. */
+IdlePolicy parse_idle_policy(const std::string& name, IdlePolicy fallback);
+const char* idle_policy_name(IdlePolicy policy);
+
+/**
+ * Idle/wake-up counters for one consumer thread.
+ *   idle_periods : transitions from busy to idle
+ *   parks        : futex sleeps entered (SPIN_PARK only)
+ *   wakeups      : idle periods ended with a measured producer notify
+ */
+struct IdleStats {
+    IdlePolicy policy{IdlePolicy::SPIN_YIELD};
+    uint64_t   idle_periods{0};
+    uint64_t   parks{0};
+    uint64_t   wakeups{0};
+    uint64_t   wake_latency_avg_ns{0};
+    uint64_t   wake_latency_max_ns{0};
+};
+
+/** Spin checks before yielding/parking (each check = 4 pauses). */
+inline constexpr size_t   IDLE_DEFAULT_SPINS          = 1024;
+/** Upper bound on one futex sleep — periodic work still runs while idle. */
+inline constexpr uint32_t IDLE_DEFAULT_PARK_TIMEOUT_US = 1000;
+
+class IdleStrategy {
+public:
+    explicit IdleStrategy(IdlePolicy policy = IdlePolicy::SPIN_YIELD,
+                          size_t spin_iterations = IDLE_DEFAULT_SPINS,
+                          uint32_t park_timeout_us = IDLE_DEFAULT_PARK_TIMEOUT_US)
+        : policy_(policy), spin_iterations_(spin_iterations),
+          park_timeout_us_(park_timeout_us) {}
+
+    IdleStrategy(const IdleStrategy&) = delete;
+    IdleStrategy& operator=(const IdleStrategy&) = delete;
+
+    /** Select the policy. Call before consumer and producers start. */
+    void set_policy(IdlePolicy policy) { policy_ = policy; }
+    [[nodiscard]] IdlePolicy policy() const { return policy_; }
+
+    // ── Consumer thread ────────────────────────────────────
+
+    /**
+     * One idle step after a poll found nothing. Returns when has_work()
+     * is true or the policy's backoff round is over; the caller polls again.
+     */
+    template <typename HasWork>
+    void idle(HasWork&& has_work) {
+        if (state_.load(std::memory_order_relaxed) == BUSY) [[unlikely]] begin_idle();
+
+        for (size_t i = 0; i < spin_iterations_; ++i) {
+            if (has_work()) return;
+            cpu_relax();
+        }
+
+        if (policy_ == IdlePolicy::SPIN_PARK) {
+            state_.store(PARKED, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (has_work()) {
+                state_.store(IDLE, std::memory_order_relaxed);
+                return;
+            }
+            park();
+        } else if (policy_ == IdlePolicy::SPIN_YIELD) {
+            yield();
+        }
+    }
+
+    /** Poll found work. Closes the idle period (records wake-up latency). */
+    void on_work() {
+        if (state_.load(std::memory_order_relaxed) != BUSY) [[unlikely]] end_idle();
+    }
+
+    // ── Producer threads (any number) ──────────────────────
+
+    /** Call after a successful push. Wakes the consumer if it is parked. */
+    void notify() {
+        if (policy_ == IdlePolicy::SPIN_PARK) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);  // Push before state read
+        }
+        if (state_.load(std::memory_order_relaxed) == BUSY) [[likely]] return;
+        notify_slow();
+    }
+
+    // ── Monitoring ─────────────────────────────────────────
+
+    [[nodiscard]] IdleStats stats() const;
+
+private:
+    enum : uint32_t { BUSY = 0, IDLE = 1, PARKED = 2 };
+
+    static void cpu_relax() {
+        for (int p = 0; p < 4; ++p) {
+#if defined(__x86_64__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield" ::: "memory");
+#endif
+        }
+    }
+
+    void begin_idle();
+    void end_idle();
+    void notify_slow();
+    void park();
+    static void yield();
+
+    // ── Configuration (before start) ──
+    IdlePolicy policy_;
+    size_t     spin_iterations_;
+    uint32_t   park_timeout_us_;
+
+    // ── Shared with producers: futex word + first-notify stamp ──
+    alignas(64)
+    std::atomic<uint32_t>  state_{BUSY};
+    std::atomic<Timestamp> notify_ns_{0};
+
+    // ── Consumer-written, monitoring-read (once per idle period) ──
+    alignas(64)
+    std::atomic<uint64_t> idle_periods_{0};
+    std::atomic<uint64_t> parks_{0};
+    std::atomic<uint64_t> wakeups_{0};
+    std::atomic<uint64_t> wake_latency_sum_ns_{0};
+    std::atomic<uint64_t> wake_latency_max_ns_{0};
+};
+
+// ═══════════════════════════════════════════════════════════════
+//  EventDoorbell — wake a consumer that blocks in epoll, not a futex
+// ═══════════════════════════════════════════════════════════════
+
+/**
+ * eventfd the consumer registers in its epoll set. Same handshake as
+ * SPIN_PARK: the consumer arm()s and re-checks its queues before
+ * epoll_wait; producers ring() after pushing, which costs a syscall only
+ * when the consumer is armed. Non-Linux: fd() == -1 and ring() is a
+ * no-op (the consumer falls back to its poll timeout).
+ */
+class EventDoorbell {
+public:
+    EventDoorbell();
+    ~EventDoorbell();
+
+    EventDoorbell(const EventDoorbell&) = delete;
+    EventDoorbell& operator=(const EventDoorbell&) = delete;
+
+    [[nodiscard]] int fd() const { return fd_; }
+
+    /** Consumer: about to block. Re-check queues after this call. */
+    void arm() {
+        armed_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    /** Consumer: woke up (any reason). */
+    void disarm() { armed_.store(false, std::memory_order_relaxed); }
+
+    /** Consumer: fd() polled readable — reset the counter. */
+    void clear();
+
+    /** Producer: call after pushing. */
+    void ring() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);  // Push before armed_ read
+        if (!armed_.load(std::memory_order_relaxed)) [[likely]] return;
+        if (armed_.exchange(false, std::memory_order_relaxed)) signal();
+    }
+
+private:
+    void signal();
+
+    int fd_{-1};
+    alignas(64) std::atomic<bool> armed_{false};
+};
+
+} // namespace rtes
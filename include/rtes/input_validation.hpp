@@ -51,12 +51,24 @@ public:
     static Result<void> validate_message_payload(const void* payload, size_t length, MessageType type);
     static Result<void> sanitize_message_fields(NewOrderMessage& message);
     static Result<void> sanitize_message_fields(CancelOrderMessage& message);
+    static Result<void> sanitize_message_fields(ModifyOrderMessage& message);
     static Result<void> sanitize_message_fields(OrderAckMessage& message);
+
+    /**
+     * Range-check a BATCH frame's entries in one pass, with the rules
+     * sanitize_message_fields() applies to single messages. Branch-free
+     * per entry, so the loop costs the same whatever the data.
+     * @param valid Out: 1 or 0 per entry
+     * @return Number of invalid entries
+     */
+    static size_t validate_batch_entries(const BatchEntryV2* entries, size_t count, uint8_t* valid);
     
     // Message type validation
     static bool is_valid_message_type(uint32_t type);
     static bool is_valid_message_size(uint32_t size, MessageType type);
     
+    static constexpr uint64_t MAX_ORDER_QUANTITY = 1000000;
+
 private:
     static constexpr uint32_t MAX_MESSAGE_SIZE = 8192;
     static constexpr uint32_t MIN_MESSAGE_SIZE = sizeof(MessageHeader);
@@ -133,10 +145,6 @@ public:
     static std::string remove_control_chars(const std::string& input);
     static std::string escape_special_chars(const std::string& input);
     static std::string normalize_whitespace(const std::string& input);
-    
-private:
-    static const std::unordered_set<char> DANGEROUS_CHARS;
-    static const std::unordered_set<char> CONTROL_CHARS;
 };
 
 } // namespace rtes
\ No newline at end of file
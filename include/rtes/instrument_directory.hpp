@@ -0,0 +1,116 @@
+#pragma once
+
+/**
+ * @file instrument_directory.hpp
+ * @brief Symbol ↔ dense 16-bit InstrumentID, fixed at startup
+ *
+ * Ids are 0..size()-1 in config order (duplicates keep their first id),
+ * so the directory is the same on every restart with the same config and
+ * can be published to clients. Protocol v2 carries the id instead of an
+ * 8-byte symbol string; the gateway maps it back with one array index.
+ *
+ * Names and ids are immutable after construction, so every thread reads
+ * them without locks. The one thing that changes is each instrument's
+ * trading state: a byte per id, stored by the exchange's control path
+ * (list / halt / resume) and loaded by risk shards on every new order.
+ * Symbols configured with "listed": false hold their id, book and risk
+ * slot from startup but start UNLISTED.
+ */
+
+#include "rtes/config.hpp"
+#include "rtes/types.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace rtes {
+
+/** Not a configured instrument */
+inline constexpr InstrumentID INVALID_INSTRUMENT = std::numeric_limits<InstrumentID>::max();
+
+/** Trading state of an instrument */
+enum class InstrumentState : uint8_t {
+    OPEN     = 0,  // Trading
+    HALTED   = 1,  // Cancel-only: new orders rejected, resting orders kept
+    UNLISTED = 2,  // Configured, not listed yet: treated as an unknown symbol
+};
+
+[[nodiscard]] inline const char* instrument_state_name(InstrumentState state) {
+    switch (state) {
+        case InstrumentState::OPEN:     return "open";
+        case InstrumentState::HALTED:   return "halted";
+        case InstrumentState::UNLISTED: return "unlisted";
+    }
+    return "unknown";
+}
+
+class InstrumentDirectory {
+public:
+    /** Symbols beyond the 16-bit range are left out (and have no id). */
+    explicit InstrumentDirectory(const std::vector<SymbolConfig>& symbols) {
+        std::vector<bool> listed;
+        for (const auto& sym : symbols) {
+            if (symbols_.size() >= INVALID_INSTRUMENT) break;
+            const Symbol symbol(sym.symbol.c_str());
+            if (ids_.emplace(symbol, static_cast<InstrumentID>(symbols_.size())).second) {
+                symbols_.push_back(symbol);
+                listed.push_back(sym.listed);
+            }
+        }
+        states_ = std::make_unique<std::atomic<InstrumentState>[]>(symbols_.size());
+        for (size_t id = 0; id < symbols_.size(); ++id) {
+            states_[id].store(listed[id] ? InstrumentState::OPEN : InstrumentState::UNLISTED,
+                              std::memory_order_relaxed);
+        }
+    }
+
+    InstrumentDirectory(const InstrumentDirectory&) = delete;
+    InstrumentDirectory& operator=(const InstrumentDirectory&) = delete;
+
+    /** Symbol for `id`, or nullptr if out of range. Hot path: one bounds check. */
+    [[nodiscard]] const Symbol* symbol(InstrumentID id) const {
+        return id < symbols_.size() ? &symbols_[id] : nullptr;
+    }
+
+    /** Id of `symbol`, or INVALID_INSTRUMENT. Cold path (hashes). */
+    [[nodiscard]] InstrumentID find(const Symbol& symbol) const {
+        auto it = ids_.find(symbol);
+        return it != ids_.end() ? it->second : INVALID_INSTRUMENT;
+    }
+
+    /** Every instrument, indexed by id (what clients are given). */
+    [[nodiscard]] const std::vector<Symbol>& symbols() const { return symbols_; }
+
+    [[nodiscard]] size_t size() const { return symbols_.size(); }
+
+    /** Trading state of `id` (UNLISTED if out of range) */
+    [[nodiscard]] InstrumentState state(InstrumentID id) const {
+        return id < symbols_.size() ? states_[id].load(std::memory_order_relaxed)
+                                    : InstrumentState::UNLISTED;
+    }
+
+    /** The state byte of `id`, for readers that resolve it once (risk shards) */
+    [[nodiscard]] const std::atomic<InstrumentState>* state_slot(InstrumentID id) const {
+        return id < symbols_.size() ? &states_[id] : nullptr;
+    }
+
+    /**
+     * Publish a new state. Relaxed: the byte guards nothing else, and a
+     * reader that sees the change an order later is as good as one that
+     * sees it an order sooner. Control path only (Exchange).
+     */
+    void set_state(InstrumentID id, InstrumentState state) {
+        if (id < symbols_.size()) states_[id].store(state, std::memory_order_relaxed);
+    }
+
+private:
+    std::vector<Symbol>                                     symbols_;
+    std::unordered_map<Symbol, InstrumentID, Symbol::Hash>  ids_;
+    std::unique_ptr<std::atomic<InstrumentState>[]>         states_;  // By id
+};
+
+} // namespace rtes
@@ -0,0 +1,110 @@
+#pragma once
+
+/**
+ * @file io_uring.hpp
+ * @brief Minimal io_uring ring over the raw syscalls (Linux, no liburing)
+ *
+ * Just what the TCP gateway's io_uring reactor needs: one SQ/CQ pair,
+ * SQE helpers for multishot accept/poll, recv and sendmsg, and optional
+ * SQPOLL. Recv lands directly in the caller's buffer (no provided buffer
+ * ring, so no copy). With SQPOLL a kernel thread (pinned to sqpoll_core)
+ * consumes submissions, so a busy reactor makes no syscalls at all; idle
+ * reactors still block in submit() with a timeout.
+ *
+ * Single-threaded: one ring per reactor thread. init() returns false
+ * when the kernel lacks a required feature (the gateway falls back to
+ * epoll); on non-Linux builds it always does.
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/socket.h>
+#endif
+
+namespace rtes {
+
+class IoUring {
+public:
+    struct Options {
+        unsigned entries{1024};          // SQ size (CQ is 4×)
+        int      sqpoll_core{-1};        // SQPOLL kernel thread core (-1 = no SQPOLL)
+        unsigned sqpoll_idle_ms{1000};   // SQ thread sleeps after this long idle
+    };
+
+    IoUring() = default;
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    /** @return false (errno set) if io_uring or a required feature is unavailable */
+    bool init(const Options& options);
+
+    [[nodiscard]] bool ready() const { return ring_fd_ >= 0; }
+
+#ifdef __linux__
+    /** Zeroed SQE, submitting first if the SQ is full. Published by submit(). */
+    io_uring_sqe* get_sqe();
+
+    /**
+     * Publish queued SQEs and, if wait, block until one completion is
+     * ready or timeout_ms passes. Makes no syscall when SQPOLL is awake
+     * and nothing needs waiting for.
+     */
+    void submit(bool wait = false, unsigned timeout_ms = 0);
+
+    /** Invoke f(const io_uring_cqe&) for every ready completion, then retire them. */
+    template <typename F>
+    unsigned for_each_cqe(F&& f) {
+        unsigned head = *cq_head_;
+        const unsigned tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+        const unsigned count = tail - head;
+        for (; head != tail; ++head) f(cqes_[head & cq_mask_]);
+        std::atomic_ref<unsigned>(*cq_head_).store(head, std::memory_order_release);
+        return count;
+    }
+
+    // ── SQE preparation ──
+    static void prep_accept_multishot(io_uring_sqe* sqe, int listen_fd, uint64_t user_data);
+    static void prep_recv(io_uring_sqe* sqe, int fd, void* buf, size_t len, uint64_t user_data);
+    static void prep_poll_multishot(io_uring_sqe* sqe, int fd, uint64_t user_data);
+    static void prep_sendmsg(io_uring_sqe* sqe, int fd, const msghdr* msg, uint64_t user_data);
+    /** Cancel the request submitted with `target`; its CQE then completes with -ECANCELED */
+    static void prep_cancel(io_uring_sqe* sqe, uint64_t target, uint64_t user_data);
+#endif
+
+private:
+    bool map_rings(unsigned sq_entries, unsigned cq_entries, const void* params);
+    void release();
+
+    int      ring_fd_{-1};
+    bool     sqpoll_{false};
+
+    // SQ ring
+    void*     ring_mem_{nullptr};
+    size_t    ring_size_{0};
+    unsigned* sq_head_{nullptr};
+    unsigned* sq_tail_{nullptr};
+    unsigned* sq_flags_{nullptr};
+    unsigned  sq_mask_{0};
+    unsigned  sq_entries_{0};
+    unsigned  sq_local_tail_{0};    // SQEs handed out
+    unsigned  sq_submitted_{0};     // SQEs published to the kernel
+#ifdef __linux__
+    io_uring_sqe* sqes_{nullptr};
+    io_uring_cqe* cqes_{nullptr};
+#endif
+    size_t    sqes_size_{0};
+
+    // CQ ring
+    unsigned* cq_head_{nullptr};
+    unsigned* cq_tail_{nullptr};
+    unsigned  cq_mask_{0};
+};
+
+} // namespace rtes
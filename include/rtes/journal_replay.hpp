@@ -0,0 +1,75 @@
+#pragma once
+
+/**
+ * @file journal_replay.hpp
+ * @brief Deterministic replay of an event journal, verified against it
+ *
+ * Every engine's journaled requests go straight into a MatchingEngine
+ * (MatchingEngine::replay): no gateway, no risk, no threads, as fast as
+ * the books match. The engine clock is the recorded one: each request is
+ * processed at its batch's recorded time, so the replayed records carry
+ * the same times as the journal's.
+ *
+ * With verification on, the replayed requests and every output they
+ * cause are journaled again into an in-memory lane and compared, record
+ * by record and in order, with what the journal recorded: trades (id,
+ * orders, price, quantity), done and reject records. Any difference is
+ * a mismatch. A recorded trade's timestamp is not compared: it is the
+ * clock at the sweep, which the journal does not keep. The journal does
+ * not carry BBOs either; they follow from the same book states.
+ *
+ * A journal with drops (a gap in an engine's sequence) cannot be
+ * verified past the gap: that engine is still replayed, unverified.
+ */
+
+#include "rtes/event_journal.hpp"
+#include "rtes/exchange.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace rtes {
+
+struct ReplayOptions {
+    bool   verify{true};
+    size_t pool_size{1 << 18};  // Orders resting at once across every engine
+    size_t max_reported{10};    // Mismatches kept per engine
+};
+
+struct ReplayMismatch {
+    std::string engine;
+    uint64_t    seq{0};     // Recorded sequence of the expected record (0: none left)
+    std::string detail;
+};
+
+struct ReplayEngineStats {
+    std::string engine;
+    uint64_t    requests{0};
+    uint64_t    outputs{0};      // Records replayed and compared
+    uint64_t    mismatches{0};
+    uint64_t    gaps{0};         // Breaks in the recorded sequence
+};
+
+struct ReplayReport {
+    std::vector<ReplayEngineStats> engines;  // Journal lane order
+    std::vector<ReplayMismatch>    mismatches;
+    uint64_t    records{0};        // Read from the journal
+    uint64_t    requests{0};       // Replayed
+    double      match_seconds{0};  // Inside MatchingEngine::replay (no reading, no comparing)
+    std::string error;             // Non-empty: the journal could not be replayed
+
+    [[nodiscard]] bool ok() const;
+};
+
+/**
+ * Replay the journal at `path` (a file, or the base name of its
+ * segments). `layout` gives the engines' books and options (see
+ * engine_layout()); engines are matched to journal lanes by name. Empty:
+ * each lane gets the books its NEW_ORDER records name, default options.
+ */
+[[nodiscard]] ReplayReport replay_journal(const std::string& path,
+                                          const std::vector<EngineLayout>& layout = {},
+                                          const ReplayOptions& options = {});
+
+} // namespace rtes
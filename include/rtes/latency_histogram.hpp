@@ -0,0 +1,129 @@
+#pragma once
+
+/**
+ * @file latency_histogram.hpp
+ * @brief Fixed-memory log-linear latency histogram (HdrHistogram-style)
+ *
+ * Values below 32 ns get a bucket each. Above that, every power of two
+ * is split into 32 equal buckets, so a bucket is at most 1/32 (3.1%) as
+ * wide as the values it holds:
+ *
+ *   [0..31] [32..63 by 1] [64..127 by 2] [128..255 by 4] ... [2^42..2^43 by 2^37]
+ *
+ * 1248 buckets (≈10 KB) cover up to 2^43 ns (~2.4 hours); anything
+ * longer lands in the last bucket. Bucket bounds are fixed, so
+ * histograms from different books, threads or runs merge by adding
+ * counts.
+ *
+ * LatencyHistogram is a plain value: fill it on one thread, or take it
+ * as a snapshot of a LatencyTracker (performance_optimizer.hpp) and
+ * query or merge it anywhere.
+ */
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace rtes {
+
+namespace latency_buckets {
+
+inline constexpr unsigned SUB_BITS = 5;                      // 32 buckets per power of two
+inline constexpr uint64_t SUB_COUNT = uint64_t{1} << SUB_BITS;
+inline constexpr unsigned MAX_MSB  = 42;                     // Highest power of two tracked
+inline constexpr size_t   COUNT    = SUB_COUNT + (MAX_MSB - SUB_BITS + 1) * SUB_COUNT;
+
+/** Bucket holding `value` */
+[[nodiscard]] constexpr size_t index(uint64_t value) {
+    if (value < SUB_COUNT) return static_cast<size_t>(value);
+    const unsigned msb = static_cast<unsigned>(std::bit_width(value)) - 1;
+    if (msb > MAX_MSB) return COUNT - 1;
+    const uint64_t sub = (value >> (msb - SUB_BITS)) & (SUB_COUNT - 1);
+    return static_cast<size_t>(SUB_COUNT + (msb - SUB_BITS) * SUB_COUNT + sub);
+}
+
+/** Smallest value in bucket `i` */
+[[nodiscard]] constexpr uint64_t lower(size_t i) {
+    if (i < SUB_COUNT) return i;
+    const unsigned msb = static_cast<unsigned>((i - SUB_COUNT) / SUB_COUNT) + SUB_BITS;
+    const uint64_t sub = (i - SUB_COUNT) % SUB_COUNT;
+    return (uint64_t{1} << msb) + (sub << (msb - SUB_BITS));
+}
+
+/** Largest value in bucket `i` */
+[[nodiscard]] constexpr uint64_t upper(size_t i) {
+    if (i < SUB_COUNT) return i;
+    const unsigned msb = static_cast<unsigned>((i - SUB_COUNT) / SUB_COUNT) + SUB_BITS;
+    return lower(i) + (uint64_t{1} << (msb - SUB_BITS)) - 1;
+}
+
+static_assert(index(lower(COUNT - 1)) == COUNT - 1);
+static_assert(index(upper(100)) == 100 && index(upper(100) + 1) == 101);
+
+} // namespace latency_buckets
+
+class LatencyHistogram {
+public:
+    void record(uint64_t value_ns) {
+        ++counts_[latency_buckets::index(value_ns)];
+        ++count_;
+        sum_ns_ += value_ns;
+        min_ns_ = std::min(min_ns_, value_ns);
+        max_ns_ = std::max(max_ns_, value_ns);
+    }
+
+    /** Add another histogram's counts (same fixed buckets) */
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < latency_buckets::COUNT; ++i) counts_[i] += other.counts_[i];
+        count_  += other.count_;
+        sum_ns_ += other.sum_ns_;
+        min_ns_ = std::min(min_ns_, other.min_ns_);
+        max_ns_ = std::max(max_ns_, other.max_ns_);
+    }
+
+    /**
+     * Value at percentile `p` (0-100): the upper bound of the bucket
+     * holding that rank, capped at the largest value seen. 0 if empty.
+     */
+    [[nodiscard]] uint64_t percentile(double p) const {
+        if (count_ == 0) return 0;
+        const double clamped = std::clamp(p, 0.0, 100.0);
+        auto rank = static_cast<uint64_t>(clamped / 100.0 * static_cast<double>(count_) + 0.5);
+        rank = std::clamp<uint64_t>(rank, 1, count_);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < latency_buckets::COUNT; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return std::min(latency_buckets::upper(i), max_ns_);
+        }
+        return max_ns_;
+    }
+
+    [[nodiscard]] uint64_t count() const { return count_; }
+    [[nodiscard]] uint64_t sum_ns() const { return sum_ns_; }
+    [[nodiscard]] uint64_t min_ns() const { return count_ ? min_ns_ : 0; }
+    [[nodiscard]] uint64_t max_ns() const { return max_ns_; }
+    [[nodiscard]] uint64_t mean_ns() const { return count_ ? sum_ns_ / count_ : 0; }
+
+    /** Bucket export: fn(lower_ns, upper_ns, count) for every non-empty bucket, ascending */
+    template<typename Fn>
+    void for_each_bucket(Fn&& fn) const {
+        for (size_t i = 0; i < latency_buckets::COUNT; ++i) {
+            if (counts_[i]) fn(latency_buckets::lower(i), latency_buckets::upper(i), counts_[i]);
+        }
+    }
+
+    [[nodiscard]] const std::array<uint64_t, latency_buckets::COUNT>& buckets() const { return counts_; }
+
+private:
+    friend class LatencyTracker;  // Fills snapshots directly
+
+    std::array<uint64_t, latency_buckets::COUNT> counts_{};
+    uint64_t count_{0};
+    uint64_t sum_ns_{0};
+    uint64_t min_ns_{UINT64_MAX};
+    uint64_t max_ns_{0};
+};
+
+} // namespace rtes
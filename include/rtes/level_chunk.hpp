@@ -0,0 +1,202 @@
+#pragma once
+
+/**
+ * @file level_chunk.hpp
+ * @brief Chunked FIFO of order handles for the price levels of one book side
+ *
+ * A level's queue is a chain of fixed-size chunks taken from the side's
+ * LevelChunkPool:
+ *
+ *   head ─▶ [begin..end) ─▶ [begin..end) ─▶ [begin..end) ◀─ tail
+ *
+ *   push_back   append to the tail chunk; a full tail links a new chunk
+ *   pop_front   advance the head chunk's begin; a drained chunk goes
+ *               back to the pool at once
+ *   remove      scan, then close the gap inside its chunk only (at most
+ *               LEVEL_CHUNK_ORDERS - 1 moves, whatever the level depth)
+ *
+ * Every chunk in a chain holds at least one live handle, and an empty
+ * queue holds no chunk. Nothing reallocates, nothing accumulates a dead
+ * prefix, so there is no compaction pass; the pool only grows (by
+ * whole slabs, never moving a chunk) when every chunk is in use.
+ *
+ * Single-threaded (owned by the book's thread).
+ */
+
+#include "rtes/types.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace rtes {
+
+inline constexpr size_t LEVEL_CHUNK_ORDERS = 28;  // Handles per chunk (chunk = 2 cache lines)
+inline constexpr size_t LEVEL_CHUNK_SLAB   = 64;  // Chunks of a side's first slab
+
+/** Fixed block of one level's queue: handles[begin..end) are live */
+struct alignas(64) LevelChunk {
+    LevelChunk* next{nullptr};
+    uint32_t    begin{0};
+    uint32_t    end{0};
+    OrderHandle handles[LEVEL_CHUNK_ORDERS];
+};
+static_assert(sizeof(LevelChunk) == 128, "LevelChunk spans exactly two cache lines");
+
+/** Free list of LevelChunks shared by the levels of one book side */
+class LevelChunkPool {
+public:
+    explicit LevelChunkPool(size_t chunks = LEVEL_CHUNK_SLAB) { grow(std::max<size_t>(chunks, 1)); }
+
+    LevelChunkPool(const LevelChunkPool&) = delete;
+    LevelChunkPool& operator=(const LevelChunkPool&) = delete;
+
+    /** An empty chunk. Grows by a slab as large as the pool when none is free (rare). */
+    LevelChunk* acquire() {
+        if (!free_) [[unlikely]] grow(capacity_);
+        LevelChunk* chunk = free_;
+        free_ = chunk->next;
+        chunk->next  = nullptr;
+        chunk->begin = 0;
+        chunk->end   = 0;
+        --available_;
+        return chunk;
+    }
+
+    void release(LevelChunk* chunk) {
+        chunk->next = free_;
+        free_ = chunk;
+        ++available_;
+    }
+
+    [[nodiscard]] size_t capacity()  const { return capacity_; }
+    [[nodiscard]] size_t available() const { return available_; }
+
+private:
+    void grow(size_t chunks) {
+        slabs_.push_back(std::make_unique<LevelChunk[]>(chunks));
+        LevelChunk* slab = slabs_.back().get();
+        for (size_t i = chunks; i-- > 0;) release(&slab[i]);  // First chunk on top
+        capacity_ += chunks;
+    }
+
+    std::vector<std::unique_ptr<LevelChunk[]>> slabs_;
+    LevelChunk* free_{nullptr};
+    size_t capacity_{0};
+    size_t available_{0};
+};
+
+/** One level's FIFO of order handles over chunks of a LevelChunkPool. Move only. */
+class LevelChunkQueue {
+public:
+    LevelChunkQueue() = default;
+    explicit LevelChunkQueue(LevelChunkPool* chunks) : chunks_(chunks) {}
+    ~LevelChunkQueue() { clear(); }
+
+    LevelChunkQueue(LevelChunkQueue&& other) noexcept
+        : chunks_(other.chunks_)
+        , head_(std::exchange(other.head_, nullptr))
+        , tail_(std::exchange(other.tail_, nullptr))
+        , size_(std::exchange(other.size_, 0)) {}
+
+    LevelChunkQueue& operator=(LevelChunkQueue&& other) noexcept {
+        if (this != &other) {
+            clear();
+            chunks_ = other.chunks_;
+            head_   = std::exchange(other.head_, nullptr);
+            tail_   = std::exchange(other.tail_, nullptr);
+            size_   = std::exchange(other.size_, 0);
+        }
+        return *this;
+    }
+
+    LevelChunkQueue(const LevelChunkQueue&) = delete;
+    LevelChunkQueue& operator=(const LevelChunkQueue&) = delete;
+
+    void push_back(OrderHandle handle) {
+        if (!tail_ || tail_->end == LEVEL_CHUNK_ORDERS) [[unlikely]] link_chunk();
+        tail_->handles[tail_->end++] = handle;
+        ++size_;
+    }
+
+    /** @pre !empty() */
+    [[nodiscard]] OrderHandle front() const { return head_->handles[head_->begin]; }
+
+    /** Handle queued behind front(). @pre size() > 1 */
+    [[nodiscard]] OrderHandle second() const {
+        return head_->begin + 1 < head_->end ? head_->handles[head_->begin + 1]
+                                             : head_->next->handles[head_->next->begin];
+    }
+
+    /** @pre !empty() */
+    void pop_front() {
+        if (++head_->begin == head_->end) unlink_chunk(nullptr, head_);
+        --size_;
+    }
+
+    /** Remove `handle` from anywhere in the queue. @return false if it is not queued */
+    bool remove(OrderHandle handle) {
+        LevelChunk* prev = nullptr;
+        for (LevelChunk* chunk = head_; chunk; prev = chunk, chunk = chunk->next) {
+            OrderHandle* const first = chunk->handles + chunk->begin;
+            OrderHandle* const last  = chunk->handles + chunk->end;
+            OrderHandle* const it    = std::find(first, last, handle);
+            if (it == last) continue;
+            if (it == first) ++chunk->begin;
+            else             { std::copy(it + 1, last, it); --chunk->end; }
+            if (chunk->begin == chunk->end) unlink_chunk(prev, chunk);
+            --size_;
+            return true;
+        }
+        return false;
+    }
+
+    /** Give every chunk back to the pool */
+    void clear() {
+        while (head_) {
+            LevelChunk* next = head_->next;
+            chunks_->release(head_);
+            head_ = next;
+        }
+        tail_ = nullptr;
+        size_ = 0;
+    }
+
+    [[nodiscard]] bool   empty() const { return size_ == 0; }
+    [[nodiscard]] size_t size()  const { return size_; }
+
+    /** Visit handles in queue order */
+    template<typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const LevelChunk* chunk = head_; chunk; chunk = chunk->next) {
+            for (uint32_t i = chunk->begin; i < chunk->end; ++i) fn(chunk->handles[i]);
+        }
+    }
+
+private:
+    void link_chunk() {
+        assert(chunks_ && "LevelChunkQueue without a pool");
+        LevelChunk* chunk = chunks_->acquire();
+        if (tail_) tail_->next = chunk;
+        else       head_ = chunk;
+        tail_ = chunk;
+    }
+
+    /** Drop `chunk` (now empty) from the chain; `prev` is the chunk before it or nullptr */
+    void unlink_chunk(LevelChunk* prev, LevelChunk* chunk) {
+        (prev ? prev->next : head_) = chunk->next;
+        if (tail_ == chunk) tail_ = prev;
+        chunks_->release(chunk);
+    }
+
+    LevelChunkPool* chunks_{nullptr};
+    LevelChunk*     head_{nullptr};
+    LevelChunk*     tail_{nullptr};
+    uint32_t        size_{0};
+};
+
+} // namespace rtes
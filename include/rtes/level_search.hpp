@@ -0,0 +1,93 @@
+#pragma once
+
+/**
+ * @file level_search.hpp
+ * @brief Lower bound over a compact, sorted array of level prices
+ *
+ * FlatPriceBook (sorted vector) keeps its level prices in a second,
+ * contiguous array next to the FlatLevels: eight keys per cache line
+ * instead of one level per line, so a search touches a few lines of
+ * keys and then exactly one level.
+ *
+ *   n > LEVEL_SEARCH_BLOCK   branchless halving (cmov, no mispredicts)
+ *                            down to one block of keys
+ *   block                    count the keys ahead of the target:
+ *                              AVX-512  8 keys per compare, masked tail
+ *                              AVX2     4 keys per compare (sign-flipped
+ *                                       for the unsigned order)
+ *                              scalar   one add per key, no branch
+ *
+ * Keys are sorted best-first, so the keys ahead of a price are a prefix
+ * and their count is the lower bound. The instruction set is chosen at
+ * compile time (-march=native in Release); there is no runtime dispatch.
+ */
+
+#include "rtes/types.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace rtes {
+
+inline constexpr size_t LEVEL_SEARCH_BLOCK = 16;  // Keys counted with SIMD after the halving
+
+/** Whether `key` sorts before `target` (bids: higher, asks: lower) */
+template <bool Descending>
+[[nodiscard]] constexpr bool key_ahead(Price key, Price target) {
+    if constexpr (Descending) return key > target;
+    else                      return key < target;
+}
+
+/** Keys of keys[0, n) ahead of target. @pre n <= LEVEL_SEARCH_BLOCK */
+template <bool Descending>
+[[nodiscard]] inline size_t count_keys_ahead(const Price* keys, size_t n, Price target) {
+#if defined(__AVX512F__)
+    constexpr int cmp = Descending ? _MM_CMPINT_NLE : _MM_CMPINT_LT;
+    const __m512i t = _mm512_set1_epi64(static_cast<long long>(target));
+    size_t count = 0;
+    for (size_t i = 0; i < n; i += 8) {
+        const __mmask8 live = static_cast<__mmask8>(n - i >= 8 ? 0xFF : (1u << (n - i)) - 1);
+        const __m512i k = _mm512_maskz_loadu_epi64(live, keys + i);
+        count += std::popcount(static_cast<unsigned>(_mm512_mask_cmp_epu64_mask(live, k, t, cmp)));
+    }
+    return count;
+#elif defined(__AVX2__)
+    // No unsigned 64-bit compare: flip the sign bit of both sides
+    const __m256i flip = _mm256_set1_epi64x(static_cast<long long>(uint64_t{1} << 63));
+    const __m256i t = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(target)), flip);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const __m256i k = _mm256_xor_si256(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), flip);
+        const __m256i ahead = Descending ? _mm256_cmpgt_epi64(k, t) : _mm256_cmpgt_epi64(t, k);
+        count += std::popcount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(ahead))));
+    }
+    for (; i < n; ++i) count += key_ahead<Descending>(keys[i], target);
+    return count;
+#else
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) count += key_ahead<Descending>(keys[i], target);
+    return count;
+#endif
+}
+
+/** First index of keys[0, n) not ahead of target (n if none). Keys sorted best-first. */
+template <bool Descending>
+[[nodiscard]] inline size_t level_lower_bound(const Price* keys, size_t n, Price target) {
+    const Price* base = keys;
+    // Invariant: the answer lies in [base, base + n]
+    while (n > LEVEL_SEARCH_BLOCK) {
+        const size_t half = n / 2;
+        base = key_ahead<Descending>(base[half], target) ? base + half : base;
+        n -= half;
+    }
+    return static_cast<size_t>(base - keys) + count_keys_ahead<Descending>(base, n, target);
+}
+
+} // namespace rtes
@@ -1,11 +1,49 @@
 #pragma once
 
+/**
+ * @file logger.hpp
+ * @brief Leveled logger, synchronous or deferred to a writer thread
+ *
+ * Every LOG_* call site registers itself (file, line, level, format) in
+ * the LogSiteRegistry the first time it runs and keeps the LogSite in a
+ * function-local static. Sites can be switched off or given their own
+ * rate limit at runtime; both are checked before any argument is encoded
+ * or formatted, and a throttled site never affects another.
+ *
+ * Until start_async() the LOG_* macros format, sanitize and write on the
+ * calling thread, as before. After it, they only encode: the 16-bit site
+ * id plus the raw arguments go into a fixed-size LogRecord in the calling
+ * thread's own SPSC ring (one try-push, no allocation, no formatting),
+ * and the writer thread looks the format up by id, formats, sanitizes and
+ * writes them in time order, one write() per batch:
+ *
+ *   hot thread ─ LogRecord ─► ring ─┐
+ *   hot thread ─ LogRecord ─► ring ─┼─► writer: format, sanitize, write(2)
+ *
+ * Integers, floats, bools, chars and strings are encoded as they are
+ * (strings copied, so they may be temporaries); any other formattable
+ * type is formatted with "{}" on the calling thread and sent as text.
+ * A full ring drops the record (dropped()); arguments that do not fit in
+ * a record are cut short (truncated()). Rings of exited threads are
+ * reused by new ones.
+ */
+
+#include <array>
 #include <string>
+#include <string_view>
 #include <chrono>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <format>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
 #include "security_utils.hpp"
+#include "spsc_queue.hpp"
 
 namespace rtes {
 
@@ -17,6 +55,127 @@ enum class LogLevel {
     FATAL = 4
 };
 
+/** Argument bytes per deferred record (a record is 256 bytes) */
+inline constexpr size_t LOG_PAYLOAD_BYTES = 240;
+/** Records per thread ring */
+inline constexpr size_t LOG_RING_CAPACITY = 1024;
+/** Sites with an id; later ones log synchronously */
+inline constexpr size_t LOG_MAX_SITES = 4096;
+
+/** One LOG_* call site, registered on its first call */
+struct LogSite {
+    const char*      file;
+    uint32_t         line;
+    LogLevel         level;
+    std::string_view format;  // The macro's literal (static storage)
+    uint16_t         id;      // LOG_MAX_SITES and up: no id, never deferred
+
+    std::atomic<bool>     enabled{true};
+    std::atomic<int64_t>  rate_limit_ns{-1};  // < 0: Logger::set_rate_limit()'s default
+    std::atomic<int64_t>  last_ns{INT64_MIN / 2};
+    std::atomic<uint64_t> suppressed{0};      // Calls dropped by the rate limit
+
+    LogSite(const char* f, uint32_t l, LogLevel lv, std::string_view fmt, uint16_t i)
+        : file(f), line(l), level(lv), format(fmt), id(i) {}
+};
+
+class LogSiteRegistry {
+public:
+    static LogSiteRegistry& instance();
+
+    /** First call of a site (the LOG_* macros). Sites live for the process. */
+    LogSite& add(const char* file, uint32_t line, LogLevel level, std::string_view format);
+
+    /** Writer side: the site behind a record's id, nullptr if none */
+    [[nodiscard]] const LogSite* find(uint16_t id) const {
+        return id < LOG_MAX_SITES ? by_id_[id].load(std::memory_order_acquire) : nullptr;
+    }
+
+    /** Sites registered so far whose file ends in `file` and, if `line` != 0, on that line */
+    [[nodiscard]] std::vector<LogSite*> match(std::string_view file, uint32_t line = 0) const;
+    [[nodiscard]] std::vector<LogSite*> sites() const { return match({}); }
+
+private:
+    LogSiteRegistry() = default;
+
+    mutable std::mutex                               mutex_;  // Registration and match()
+    std::vector<std::unique_ptr<LogSite>>            sites_;
+    std::array<std::atomic<const LogSite*>, LOG_MAX_SITES> by_id_{};
+};
+
+/** One deferred log call: site id, time, and tagged raw arguments */
+struct LogRecord {
+    int64_t  time_ns{0};  // system_clock
+    uint16_t site{0};
+    uint8_t  arg_count{0};
+    bool     truncated{false};
+    uint16_t used{0};
+    std::array<char, LOG_PAYLOAD_BYTES> payload;
+};
+
+static_assert(sizeof(LogRecord) == 256, "LogRecord is four cache lines");
+
+namespace detail {
+
+enum class LogArg : uint8_t { I64, U64, F64, BOOL, CHAR, STR };
+
+// Once an argument is cut short the rest are dropped, so the indices stay right
+
+template<typename T>
+void log_put(LogRecord& record, LogArg tag, const T& value) {
+    if (record.truncated) return;
+    if (record.used + 1 + sizeof(T) > LOG_PAYLOAD_BYTES) {
+        record.truncated = true;
+        return;
+    }
+    record.payload[record.used++] = static_cast<char>(tag);
+    std::memcpy(record.payload.data() + record.used, &value, sizeof(T));
+    record.used += sizeof(T);
+    ++record.arg_count;
+}
+
+inline void log_put_text(LogRecord& record, std::string_view text) {
+    constexpr size_t header = 1 + sizeof(uint16_t);
+    if (record.truncated) return;
+    if (record.used + header > LOG_PAYLOAD_BYTES) {
+        record.truncated = true;
+        return;
+    }
+    const size_t room = LOG_PAYLOAD_BYTES - record.used - header;
+    if (text.size() > room) {
+        text = text.substr(0, room);
+        record.truncated = true;
+    }
+    const auto size = static_cast<uint16_t>(text.size());
+    record.payload[record.used++] = static_cast<char>(LogArg::STR);
+    std::memcpy(record.payload.data() + record.used, &size, sizeof(size));
+    std::memcpy(record.payload.data() + record.used + sizeof(size), text.data(), text.size());
+    record.used += static_cast<uint16_t>(sizeof(size) + text.size());
+    ++record.arg_count;
+}
+
+template<typename T>
+void log_encode(LogRecord& record, const T& value) {
+    using V = std::remove_cvref_t<T>;
+    if constexpr (std::is_same_v<V, bool>) {
+        log_put(record, LogArg::BOOL, value);
+    } else if constexpr (std::is_same_v<V, char>) {
+        log_put(record, LogArg::CHAR, value);
+    } else if constexpr (std::is_integral_v<V> && std::is_signed_v<V>) {
+        log_put(record, LogArg::I64, static_cast<int64_t>(value));
+    } else if constexpr (std::is_integral_v<V>) {
+        log_put(record, LogArg::U64, static_cast<uint64_t>(value));
+    } else if constexpr (std::is_floating_point_v<V>) {
+        log_put(record, LogArg::F64, static_cast<double>(value));
+    } else if constexpr (std::is_convertible_v<const V&, std::string_view>) {
+        log_put_text(record, std::string_view(value));
+    } else {
+        log_put_text(record, std::format("{}", value));  // Slow path: formatted here
+    }
+}
+
+} // namespace detail
+
 class Logger {
 public:
     static Logger& instance();
@@ -28,6 +187,50 @@ public:
 
     void log(LogLevel level, const std::string& message);
 
+    /**
+     * Log for `site` (the LOG_* macros, after their level check): drop it
+     * if the site is off or inside its rate limit window, then defer it
+     * once start_async() ran, else format here.
+     */
+    template<typename... Args>
+    void write(LogSite& site, std::format_string<Args...> fmt, Args&&... args) {
+        if (!site.enabled.load(std::memory_order_relaxed)) return;
+        const int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        if (rate_limited(site, now_ns)) return;
+        if (!async_.load(std::memory_order_relaxed) || site.id >= LOG_MAX_SITES) [[unlikely]] {
+            print(site.level, SecurityUtils::sanitize_log_input(std::format(fmt, std::forward<Args>(args)...)));
+            return;
+        }
+        LogRecord* record = claim();
+        if (!record) [[unlikely]] return;
+        record->time_ns   = now_ns;
+        record->site      = site.id;
+        record->arg_count = 0;
+        record->truncated = false;
+        record->used      = 0;
+        (detail::log_encode(*record, args), ...);
+        commit();
+    }
+
+    /** Defer LOG_* calls to a writer thread (see the file comment). Idempotent. */
+    void start_async();
+    /** Write everything queued, then log synchronously again */
+    void stop_async();
+    [[nodiscard]] bool is_async() const { return async_.load(std::memory_order_relaxed); }
+
+    /** Deferred records lost to a full ring */
+    [[nodiscard]] uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    /** Deferred records whose arguments were cut short */
+    [[nodiscard]] uint64_t truncated() const { return truncated_.load(std::memory_order_relaxed); }
+    /** Deferred records written */
+    [[nodiscard]] uint64_t written() const { return written_.load(std::memory_order_relaxed); }
+    /** Deferred records taken off a ring but not written (stdout refused them) */
+    [[nodiscard]] uint64_t lost() const { return lost_.load(std::memory_order_relaxed); }
+
+    /** Writer thread side of a record: the message it formats to with its site's `format` */
+    [[nodiscard]] static std::string format_record(std::string_view format, const LogRecord& record);
+
     // Type-safe logging with automatic sanitization
     template<typename... Args>
     void log_safe(LogLevel level, std::string_view format_str, Args&&... args) {
@@ -55,15 +258,68 @@ public:
     void fatal_safe(std::string_view fmt, Args&&... args)  { log_safe(LogLevel::FATAL, fmt, args...); }
 
 private:
+    struct Ring;
+
     Logger() = default;
+    ~Logger();
 
     std::atomic<LogLevel> level_{LogLevel::INFO};
     std::atomic<bool> structured_{false};
     std::chrono::milliseconds rate_limit_{1000};
     std::atomic<std::chrono::steady_clock::time_point> last_log_{};
+    std::atomic<int64_t> site_rate_limit_ns_{1'000'000'000};  // Default for sites without their own
+
+    // ── Deferred path ──
+    std::atomic<bool>                  async_{false};
+    std::mutex                         rings_mutex_;  // Ring registration and the writer's view
+    std::vector<std::unique_ptr<Ring>> rings_;
+    std::thread                        writer_;
+    std::atomic<bool>                  writer_running_{false};
+    std::atomic<uint64_t>              dropped_{0};
+    std::atomic<uint64_t>              truncated_{0};
+    std::atomic<uint64_t>              written_{0};
+    std::atomic<uint64_t>              lost_{0};
 
-    std::string format_message(LogLevel level, const std::string& message);
+    /** The calling thread's ring; nullptr until its first deferred call */
+    static inline thread_local SPSCQueue<LogRecord>* thread_ring_{nullptr};
+
+    /** Slot for the calling thread's next record, nullptr (and counted) if its ring is full */
+    LogRecord* claim() {
+        SPSCQueue<LogRecord>* ring = thread_ring_;
+        if (!ring) [[unlikely]] ring = attach_ring();
+        LogRecord* slot = ring->try_claim();
+        if (!slot) [[unlikely]] dropped_.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+    void commit() { thread_ring_->commit(); }
+
+    /** Lease a ring to the calling thread (a released one if any); it returns it on exit */
+    SPSCQueue<LogRecord>* attach_ring();
+    void run_writer();
+    size_t drain(std::vector<LogRecord>& batch, std::string& out);
+
+    std::string format_message(LogLevel level, const std::string& message,
+                               std::chrono::system_clock::time_point when);
+    std::string format_message(LogLevel level, const std::string& message) {
+        return format_message(level, message, std::chrono::system_clock::now());
+    }
     bool should_rate_limit();
+
+    /** Per-site window; racing threads may both pass, which only lets one extra line through */
+    bool rate_limited(LogSite& site, int64_t now_ns) {
+        int64_t limit = site.rate_limit_ns.load(std::memory_order_relaxed);
+        if (limit < 0) limit = site_rate_limit_ns_.load(std::memory_order_relaxed);
+        if (limit == 0) return false;
+        if (now_ns - site.last_ns.load(std::memory_order_relaxed) < limit) {
+            site.suppressed.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        site.last_ns.store(now_ns, std::memory_order_relaxed);
+        return false;
+    }
+
+    /** Level and site checks already done */
+    void print(LogLevel level, const std::string& message);
 };
 
 // ---------------------------------------------------------------------------
@@ -73,43 +329,34 @@ private:
 //   LOG_INFO("order {} filled at {}", order_id, price);
 //
 // Uses C++20 __VA_OPT__ to conditionally insert the comma only when extra
-// arguments are present, so std::format receives the correct argument list.
+// arguments are present; the format string is checked at compile time as
+// with std::format. Arguments are evaluated only if the level is enabled.
+// Each expansion registers its LogSite on first use (a function-local
+// static), so later calls pay one guard check for it.
 // Wrapped in do { } while(0) for safe use in all statement contexts.
 // ---------------------------------------------------------------------------
 
-#define LOG_DEBUG(fmt_str, ...)                                          \
+#define RTES_LOG_AT(level, fmt_str, ...)                                 \
     do {                                                                 \
-        if (rtes::Logger::instance().getLevel() <= rtes::LogLevel::DEBUG)\
-            rtes::Logger::instance().debug(                              \
-                std::format(fmt_str __VA_OPT__(,) __VA_ARGS__));        \
+        if (rtes::Logger::instance().getLevel() <= (level)) {            \
+            static rtes::LogSite& rtes_log_site_ =                       \
+                rtes::LogSiteRegistry::instance().add(                   \
+                    __FILE__, __LINE__, (level), fmt_str);               \
+            rtes::Logger::instance().write(rtes_log_site_,               \
+                fmt_str __VA_OPT__(,) __VA_ARGS__);                      \
+        }                                                                \
     } while (0)
 
-#define LOG_INFO(fmt_str, ...)                                           \
-    do {                                                                 \
-        if (rtes::Logger::instance().getLevel() <= rtes::LogLevel::INFO) \
-            rtes::Logger::instance().info(                               \
-                std::format(fmt_str __VA_OPT__(,) __VA_ARGS__));        \
-    } while (0)
 
-#define LOG_WARN(fmt_str, ...)                                           \
-    do {                                                                 \
-        if (rtes::Logger::instance().getLevel() <= rtes::LogLevel::WARN) \
-            rtes::Logger::instance().warn(                               \
-                std::format(fmt_str __VA_OPT__(,) __VA_ARGS__));        \
-    } while (0)
+#define LOG_DEBUG(fmt_str, ...) RTES_LOG_AT(rtes::LogLevel::DEBUG, fmt_str __VA_OPT__(,) __VA_ARGS__)
 
-#define LOG_ERROR(fmt_str, ...)                                          \
-    do {                                                                 \
-        if (rtes::Logger::instance().getLevel() <= rtes::LogLevel::ERROR)\
-            rtes::Logger::instance().error(                              \
-                std::format(fmt_str __VA_OPT__(,) __VA_ARGS__));        \
-    } while (0)
+#define LOG_INFO(fmt_str, ...) RTES_LOG_AT(rtes::LogLevel::INFO, fmt_str __VA_OPT__(,) __VA_ARGS__)
 
-#define LOG_FATAL(fmt_str, ...)                                          \
-    do {                                                                 \
-        rtes::Logger::instance().fatal(                                  \
-            std::format(fmt_str __VA_OPT__(,) __VA_ARGS__));            \
-    } while (0)
+#define LOG_WARN(fmt_str, ...) RTES_LOG_AT(rtes::LogLevel::WARN, fmt_str __VA_OPT__(,) __VA_ARGS__)
+
+#define LOG_ERROR(fmt_str, ...) RTES_LOG_AT(rtes::LogLevel::ERROR, fmt_str __VA_OPT__(,) __VA_ARGS__)
+
+#define LOG_FATAL(fmt_str, ...) RTES_LOG_AT(rtes::LogLevel::FATAL, fmt_str __VA_OPT__(,) __VA_ARGS__)
 
 // Type-safe logging macros (with explicit sanitization via log_safe)
 #define LOG_DEBUG_SAFE(fmt_str, ...)                                     \
@@ -8,11 +8,24 @@ namespace rtes {
 
 #pragma pack(push, 1)
 
+// Leads every datagram; message_count messages follow back to back
+struct UdpPacketHeader {
+    uint64_t sequence;       // Sequence of the first message in the packet
+    uint16_t message_count;
+    uint16_t length;         // Header and message bytes (an authentication tag follows, see flags)
+    uint32_t flags;          // UDP_PACKET_AUTHENTICATED: signed (datagram_auth.hpp)
+};
+
 // UDP Market Data Message Types
 enum UdpMessageType : uint32_t {
     BBO_UPDATE = 201,
     TRADE_UPDATE = 202,
-    DEPTH_UPDATE = 203
+    DEPTH_UPDATE = 203,
+    RETRANSMIT_REQUEST = 204,
+    RETRANSMIT_RESPONSE = 205,
+    DEPTH_SNAPSHOT = 206,
+    ORDER_UPDATE = 207,
+    SWEEP_SUMMARY = 208
 };
 
 struct UdpMessageHeader {
@@ -22,7 +35,7 @@ struct UdpMessageHeader {
     uint64_t timestamp_ns;
     
     UdpMessageHeader() = default;
-    UdpMessageHeader(uint32_t t, uint32_t len, uint64_t seq, uint64_t ts)
+    constexpr UdpMessageHeader(uint32_t t, uint32_t len, uint64_t seq, uint64_t ts)
         : type(t), length(len), sequence(seq), timestamp_ns(ts) {}
 };
 
@@ -43,11 +56,40 @@ struct TradeUpdateMessage {
     char symbol[8];
     uint64_t quantity;
     uint64_t price;
-    uint8_t aggressor_side;  // 1=Buy, 2=Sell
+    uint8_t aggressor_side;  // 1=Buy, 2=Sell, 0=Auction
+    uint64_t match_timestamp_ns;  // Engine time of the match
     
     TradeUpdateMessage() { std::memset(this, 0, sizeof(*this)); }
 };
 
+// Market by order: one change to a resting order, no client identity
+struct OrderUpdateMessage {
+    UdpMessageHeader header;
+    char symbol[8];
+    uint64_t order_id;
+    uint64_t price;
+    uint64_t remaining;  // Displayed after the event; 0 = off the book
+    uint64_t quantity;   // Execute: traded
+    uint8_t kind;        // 1=Add (to the back), 2=Execute, 3=Cancel, 4=Modify (in place)
+    uint8_t side;        // 1=Buy, 2=Sell
+
+    OrderUpdateMessage() { std::memset(this, 0, sizeof(*this)); }
+};
+
+// The fills of one incoming order, after its trade messages
+struct SweepSummaryMessage {
+    UdpMessageHeader header;
+    char symbol[8];
+    uint64_t first_trade_id;
+    uint64_t first_price;
+    uint64_t last_price;
+    uint64_t quantity;        // Total traded
+    uint32_t fills;
+    uint8_t aggressor_side;   // 1=Buy, 2=Sell
+
+    SweepSummaryMessage() { std::memset(this, 0, sizeof(*this)); }
+};
+
 struct DepthLevel {
     uint64_t price;
     uint64_t quantity;
@@ -57,6 +99,7 @@ struct DepthLevel {
 struct DepthUpdateMessage {
     UdpMessageHeader header;
     char symbol[8];
+    uint64_t update_sequence;  // Latest book update of the symbol included
     uint8_t num_bid_levels;
     uint8_t num_ask_levels;
     DepthLevel levels[20];  // Max 10 bids + 10 asks
@@ -64,6 +107,46 @@ struct DepthUpdateMessage {
     DepthUpdateMessage() { std::memset(this, 0, sizeof(*this)); }
 };
 
+// Snapshot channel: the full depth of one symbol, book_index of book_count per cycle
+struct DepthSnapshotMessage {
+    UdpMessageHeader header;
+    char symbol[8];
+    uint64_t update_sequence;  // Apply DepthUpdates with a higher one on top
+    uint32_t book_index;
+    uint32_t book_count;
+    uint8_t channel;           // Incremental channel carrying the symbol
+    uint8_t num_bid_levels;
+    uint8_t num_ask_levels;
+    uint8_t reserved;
+    DepthLevel levels[40];     // Max 20 bids + 20 asks
+    
+    DepthSnapshotMessage() { std::memset(this, 0, sizeof(*this)); }
+};
+
+// Gap fill: RetransmitRequest to the retransmission port, answered by a
+// RetransmitResponse and the original datagrams
+struct RetransmitRequest {
+    UdpMessageHeader header;
+    uint64_t from_sequence;
+    uint32_t count;
+    uint8_t  channel;
+    uint8_t  reserved[3];
+
+    RetransmitRequest() { std::memset(this, 0, sizeof(*this)); }
+};
+
+struct RetransmitResponse {
+    UdpMessageHeader header;
+    uint64_t first_sequence;
+    uint64_t last_sequence;
+    uint64_t oldest_sequence;
+    uint16_t packet_count;
+    uint8_t  channel;
+    uint8_t  status;  // 1=OK, 2=Partial, 3=Unavailable, 4=Invalid
+
+    RetransmitResponse() { std::memset(this, 0, sizeof(*this)); }
+};
+
 #pragma pack(pop)
 
 } // namespace rtes
\ No newline at end of file
@@ -2,37 +2,87 @@
 
 /**
  * @file matching_engine.hpp
- * @brief Per-symbol matching engine with dedicated worker thread
+ * @brief Matching engine: one worker thread owning one or more order books
  *
  * Threading model:
- *   - One MatchingEngine per symbol, one dedicated thread each
- *   - Orders arrive via lock-free SPSC queue (from risk manager)
+ *   - One MatchingEngine per shard, one dedicated thread each; a shard
+ *     owns N symbols' OrderBooks (N = 1 for a dedicated engine)
+ *   - Orders arrive via one lock-free SPSC queue (from risk manager),
+ *     shared by the shard's books and dispatched by dense BookIndex
  *   - Trades/BBO published via MPMC queue (to market data publisher)
- *   - Single-writer access to OrderBook (no locks in hot path)
+ *   - Fills/done/rejects published via SPSC queue (to the TCP gateway)
+ *   - Single-writer access to OrderBook (no locks in hot path); a book
+ *     may move to another shard at runtime (release_book / adopt_book)
  *
  * Data flow:
  *   RiskManager → [SPSC] → MatchingEngine → OrderBook → [MPMC] → UdpPublisher
  *
  * Performance:
- *   - Batch drain (up to 256 orders per cycle)
+ *   - Batch drain (up to 256 orders per cycle); multi-book engines can
+ *     share the cycle between books instead (set_fair_scheduling)
  *   - Spin-pause-yield backoff (no sleep)
  *   - Local counters flushed periodically (no per-order atomics)
- *   - Pre-cached symbol (no strncpy in hot path)
+ *   - Pre-cached symbol per book (no strncpy in hot path)
+ *   - Depth snapshots published on a cadence, read lock-free
  */
 
 #include "rtes/order_book.hpp"
+#include "rtes/order_trace.hpp"
+#include "rtes/reference_prices.hpp"
 #include "rtes/spsc_queue.hpp"
+#include "rtes/stats_region.hpp"
+#include "rtes/broadcast_ring.hpp"
 #include "rtes/mpmc_queue.hpp"
+#include "rtes/idle_strategy.hpp"
+#include "rtes/thread_affinity.hpp"
 #include "rtes/types.hpp"
 
+#include <array>
 #include <thread>
 #include <atomic>
+#include <chrono>
 #include <memory>
+#include <span>
+#include <string>
+#include <vector>
 #include <cstring>
 #include <cstdint>
 
 namespace rtes {
 
+class MatchingEngine;
+class JournalLane;     // event_journal.hpp
+struct JournalRecord;
+struct BookSnapshotSlot;  // book_snapshot.hpp
+struct EngineSnapshot;
+
+/** Dense index of an OrderBook within its MatchingEngine (shard). */
+using BookIndex = uint16_t;
+
+inline constexpr BookIndex NO_BOOK = UINT16_MAX;
+inline constexpr size_t TRADE_BATCH = 32;  // Trade events staged per market data push
+
+/** Ingress lane index. Each lane is an SPSC queue owned by one producer thread. */
+using IngressLane = uint16_t;
+
+/** Per-lane ingress counters (monitoring). */
+struct IngressLaneStats {
+    size_t   depth{0};      // Requests waiting (approximate)
+    uint64_t submitted{0};  // Accepted into the lane
+    uint64_t drops{0};      // Refused: lane full
+    size_t   capacity{0};
+    QueueTelemetry telemetry;  // Zeroed unless queue telemetry is enabled
+};
+
+/** Per-book scheduling counters of a fair multi-book engine (monitoring). */
+struct BookScheduleStats {
+    std::string symbol;
+    uint64_t requests{0};      // Requests matched from the book's stage
+    uint64_t delay_sum_ns{0};  // Staged → matched, summed over requests
+    uint64_t delay_max_ns{0};
+    size_t   backlog{0};       // Staged now (approximate)
+};
+
 // ═══════════════════════════════════════════════════════════════
 //  OrderRequest — Input to matching engine via SPSC queue
 // ═══════════════════════════════════════════════════════════════
@@ -41,55 +91,141 @@ namespace rtes {
  * Compact order request message.
  *
  * Uses a union to avoid carrying dead fields:
- *   NEW_ORDER:    uses new_order.order
- *   CANCEL_ORDER: uses cancel.order_id + cancel.client_id
+ *   NEW_ORDER:    uses new_order.order, the order's OrderPool handle
+ *                 (order->type selects MARKET / LIMIT / IOC / FOK /
+ *                 POST_ONLY handling)
+ *   CANCEL_ORDER: uses cancel.order_id
+ *   MODIFY_ORDER: uses modify.* (new_price 0 = keep price)
+ *   SET_PHASE:    uses phase_change.phase (AUCTION begins a call
+ *                 auction, CONTINUOUS uncrosses it, HALTED makes the
+ *                 book cancel-only)
+ *   MASS_CANCEL:  uses mass_cancel.owner; book NO_BOOK sweeps every
+ *                 book of the engine
+ *   RELEASE_BOOK: no payload; the book leaves once drained (release_book)
+ *   ADOPT_BOOK:   uses adopt.from, the engine that released the book
+ *
+ * `book` selects the target OrderBook inside the engine; it sits in
+ * the padding between `type` and the union, so the size is unchanged.
  *
- * Aligned to 32 bytes so two requests fit per cache line,
- * maximizing SPSC queue throughput.
+ * No client id travels with cancels and modifies: risk has checked
+ * ownership before the request reaches the engine. With a 4-byte
+ * handle for new orders the largest payload (modify) is 24 bytes, so
+ * a request is 32 bytes and two fit per cache line, maximizing SPSC
+ * queue throughput.
  */
-struct alignas(64) OrderRequest {
+struct alignas(32) OrderRequest {
     enum Type : uint8_t {
         NEW_ORDER    = 0,
         CANCEL_ORDER = 1,
+        MODIFY_ORDER = 2,
+        SET_PHASE    = 3,
+        MASS_CANCEL  = 4,
+        RELEASE_BOOK = 5,
+        ADOPT_BOOK   = 6,
     };
 
-    Type type;
+    Type      type;
+    BookIndex book{0};
 
     union {
         /** NEW_ORDER payload */
         struct {
-            Order* order;
+            OrderHandle order;
         } new_order;
 
         /** CANCEL_ORDER payload */
         struct {
             OrderID  order_id;
-            ClientID client_id;
         } cancel;
+
+        /** MODIFY_ORDER payload */
+        struct {
+            OrderID  order_id;
+            Quantity new_quantity;
+            Price    new_price;
+        } modify;
+
+        /** SET_PHASE payload */
+        struct {
+            TradingPhase phase;
+        } phase_change;
+
+        /** MASS_CANCEL payload */
+        struct {
+            ClientIDRaw owner;
+        } mass_cancel;
+
+        /** ADOPT_BOOK payload */
+        struct {
+            MatchingEngine* from;
+        } adopt;
     };
 
     // ── Factory methods (clearer than raw field assignment) ──
 
-    // Explicit default constructor ( union member 'cancel' may be non-trivial )
-    OrderRequest() : type(NEW_ORDER), new_order{nullptr} {}
+    OrderRequest() : type(NEW_ORDER), new_order{0} {}
 
-    [[nodiscard]] static OrderRequest make_new_order(Order* order) {
+    [[nodiscard]] static OrderRequest make_new_order(OrderHandle order, BookIndex book = 0) {
         OrderRequest req;
         req.type = NEW_ORDER;
+        req.book = book;
         req.new_order.order = order;
         return req;
     }
 
-    [[nodiscard]] static OrderRequest make_cancel(OrderID id, ClientID client) {
+    [[nodiscard]] static OrderRequest make_cancel(OrderID id, BookIndex book = 0) {
         OrderRequest req;
         req.type = CANCEL_ORDER;
+        req.book = book;
         req.cancel.order_id = id;
-        req.cancel.client_id = client;
+        return req;
+    }
+
+    [[nodiscard]] static OrderRequest make_modify(OrderID id, Quantity new_quantity,
+                                                  Price new_price, BookIndex book = 0) {
+        OrderRequest req;
+        req.type = MODIFY_ORDER;
+        req.book = book;
+        req.modify.order_id = id;
+        req.modify.new_quantity = new_quantity;
+        req.modify.new_price = new_price;
+        return req;
+    }
+
+    [[nodiscard]] static OrderRequest make_phase(TradingPhase phase, BookIndex book = 0) {
+        OrderRequest req;
+        req.type = SET_PHASE;
+        req.book = book;
+        req.phase_change.phase = phase;
+        return req;
+    }
+
+    [[nodiscard]] static OrderRequest make_mass_cancel(ClientIDRaw owner,
+                                                       BookIndex book = NO_BOOK) {
+        OrderRequest req;
+        req.type = MASS_CANCEL;
+        req.book = book;
+        req.mass_cancel.owner = owner;
+        return req;
+    }
+
+    [[nodiscard]] static OrderRequest make_release(BookIndex book) {
+        OrderRequest req;
+        req.type = RELEASE_BOOK;
+        req.book = book;
+        return req;
+    }
+
+    [[nodiscard]] static OrderRequest make_adopt(MatchingEngine* from, BookIndex book) {
+        OrderRequest req;
+        req.type = ADOPT_BOOK;
+        req.book = book;
+        req.adopt.from = from;
         return req;
     }
 };
 
-static_assert(sizeof(OrderRequest) <= 64,
+static_assert(sizeof(OrderRequest) == 32,
               "OrderRequest must fit in 32 bytes for queue efficiency");
 
 // ═══════════════════════════════════════════════════════════════
@@ -111,12 +247,18 @@ static_assert(sizeof(OrderRequest) <= 64,
  */
 struct alignas(64) MarketDataEvent {
     enum Type : uint8_t {
-        TRADE      = 0,
-        BBO_UPDATE = 1,
+        TRADE        = 0,
+        BBO_UPDATE   = 1,
+        PHASE_CHANGE = 2,
+        DEPTH_LEVEL  = 3,
+        ORDER_EVENT  = 4,  // Market by order (set_order_feed_route)
+        SWEEP        = 5,  // One incoming order's fills, after them (set_sweep_summary)
     };
 
-    Type type{TRADE};
-    char symbol[16]{};   // Fixed-size, null-terminated
+    Type    type{TRADE};
+    uint8_t channel{0};         // Market data channel of the symbol (multicast group)
+    uint8_t aggressor_side{0};  // TRADE: side of the incoming order (1=Buy, 2=Sell); 0 = auction
+    char symbol[16]{};          // Fixed-size, null-terminated
 
     /** BBO snapshot — always populated for BBO_UPDATE */
     struct BBOData {
@@ -126,13 +268,48 @@ struct alignas(64) MarketDataEvent {
         Quantity ask_quantity{0};
     };
 
+    /**
+     * Trading phase transition — price/volume set when an auction
+     * uncrosses; volatility_pause marks an AUCTION entered because a
+     * sweep hit the price band (OrderBook price band)
+     */
+    struct PhaseData {
+        TradingPhase phase{TradingPhase::CONTINUOUS};
+        Price        price{0};
+        Quantity     volume{0};
+        bool         volatility_pause{false};
+    };
+
+    /** One price level's new state — quantity 0 means the level is gone */
+    struct LevelData {
+        Side     side{Side::BUY};
+        Price    price{0};
+        Quantity quantity{0};
+        uint32_t order_count{0};
+        uint64_t update_sequence{0};  // Book update it belongs to (see DepthSnapshot)
+    };
+
+    /** The fills of one incoming order: count, total, first and last price */
+    struct SweepData {
+        TradeID  first_trade_id{0};
+        Price    first_price{0};
+        Price    last_price{0};
+        Quantity quantity{0};
+        uint32_t fills{0};
+    };
+
     union {
-        Trade   trade;
-        BBOData bbo;
+        Trade     trade;
+        BBOData   bbo;
+        PhaseData phase;
+        LevelData level;
+        OrderEvent order;
+        SweepData sweep;
     };
 
     // ── Trivial lifecycle (no manual union management) ──
-    MarketDataEvent() { std::memset(&trade, 0, sizeof(trade)); }
+    // Bytes, padding included: Trade is not trivial, so clear it as raw storage
+    MarketDataEvent() { std::memset(static_cast<void*>(&trade), 0, sizeof(trade)); }
     ~MarketDataEvent() = default;
     MarketDataEvent(const MarketDataEvent&) = default;
     MarketDataEvent& operator=(const MarketDataEvent&) = default;
@@ -142,9 +319,10 @@ struct alignas(64) MarketDataEvent {
     // ── Factory methods ──
 
     [[nodiscard]] static MarketDataEvent make_trade(
-            const char* sym, const Trade& t) {
+            const char* sym, const Trade& t, uint8_t aggressor_side = 0) {
         MarketDataEvent event;
         event.type = TRADE;
+        event.aggressor_side = aggressor_side;
         std::memcpy(event.symbol, sym, sizeof(event.symbol));
         event.trade = t;
         return event;
@@ -163,6 +341,41 @@ struct alignas(64) MarketDataEvent {
         event.bbo.ask_quantity = ask_qty;
         return event;
     }
+
+    [[nodiscard]] static MarketDataEvent make_phase(
+            const char* sym, TradingPhase phase,
+            Price price = 0, Quantity volume = 0, bool volatility_pause = false) {
+        MarketDataEvent event;
+        event.type = PHASE_CHANGE;
+        std::memcpy(event.symbol, sym, sizeof(event.symbol));
+        event.phase.phase  = phase;
+        event.phase.price  = price;
+        event.phase.volume = volume;
+        event.phase.volatility_pause = volatility_pause;
+        return event;
+    }
+
+    [[nodiscard]] static MarketDataEvent make_order_event(const char* sym, const OrderEvent& e) {
+        MarketDataEvent event;
+        event.type = ORDER_EVENT;
+        std::memcpy(event.symbol, sym, sizeof(event.symbol));
+        event.order = e;
+        return event;
+    }
+
+    [[nodiscard]] static MarketDataEvent make_level(
+            const char* sym, Side side, Price price,
+            Quantity quantity, uint32_t order_count, uint64_t update_sequence = 0) {
+        MarketDataEvent event;
+        event.type = DEPTH_LEVEL;
+        std::memcpy(event.symbol, sym, sizeof(event.symbol));
+        event.level.side        = side;
+        event.level.price       = price;
+        event.level.quantity    = quantity;
+        event.level.order_count = order_count;
+        event.level.update_sequence = update_sequence;
+        return event;
+    }
 };
 
 // Compile-time verification that Trade is trivially copyable
@@ -172,17 +385,262 @@ static_assert(std::is_trivially_copyable_v<Trade>,
 static_assert(std::is_trivially_copyable_v<MarketDataEvent>,
               "MarketDataEvent must be trivially copyable for lock-free queues");
 
+/**
+ * One engine's market data to one UdpPublisher. Each lane has a single
+ * producer (the engine thread), so engines never contend on a shared
+ * enqueue index; a symbol lives on one engine, so its events stay in
+ * order within that engine's lane. The publisher is the primary reader;
+ * other consumers (journal, dashboard) attach with add_reader() and read
+ * the same slots — required ones gate the engine, optional ones may lap.
+ */
+using MarketDataLane = BroadcastRing<MarketDataEvent>;
+
 // ═══════════════════════════════════════════════════════════════
-//  MatchingEngine — Per-symbol order matching with dedicated thread
+//  ExecutionReport — Per-order outcome back to the gateway via SPSC
 // ═══════════════════════════════════════════════════════════════
 
+/**
+ * Private (per-order) outcome for the session that sent the order.
+ * Unlike MarketDataEvent this is routed by order id, not by symbol.
+ *
+ *   FILL     : one execution; the gateway reports it to both sides
+ *   DONE     : order left the exchange (FILLED or CANCELLED, incl. STP)
+ *   REJECTED : refused by risk or by the book; reason is an ErrorCode
+ *
+ * An order that rests produces no report until it fills or is cancelled.
+ * `reactor` / `sell_reactor` (Order::ingress, in the header padding)
+ * name the gateway reactor that owns each session involved.
+ */
+struct alignas(64) ExecutionReport {
+    enum Type : uint8_t {
+        FILL     = 0,
+        DONE     = 1,
+        REJECTED = 2,
+    };
+
+    Type           type{FILL};
+    OrderStatus    status{OrderStatus::PENDING};  // DONE: final status
+    GatewayReactor reactor{0};                    // The order's; FILL: the buyer's
+    GatewayReactor sell_reactor{0};               // FILL: the seller's
+    uint32_t       reason{0};                     // REJECTED: ErrorCode value
+
+    /** Order-level outcome — populated for DONE and REJECTED */
+    struct OrderData {
+        OrderID  order_id{0};
+        Quantity filled_quantity{0};
+        Quantity leaves_quantity{0};
+    };
+
+    union {
+        Trade     fill;
+        OrderData order;
+    };
+
+    // ── Trivial lifecycle (no manual union management) ──
+    ExecutionReport() { std::memset(static_cast<void*>(&fill), 0, sizeof(fill)); }
+    ~ExecutionReport() = default;
+    ExecutionReport(const ExecutionReport&) = default;
+    ExecutionReport& operator=(const ExecutionReport&) = default;
+    ExecutionReport(ExecutionReport&&) = default;
+    ExecutionReport& operator=(ExecutionReport&&) = default;
+
+    // ── Factory methods ──
+
+    [[nodiscard]] static ExecutionReport make_fill(const Trade& trade) {
+        ExecutionReport report;
+        report.type = FILL;
+        report.fill = trade;
+        return report;
+    }
+
+    [[nodiscard]] static ExecutionReport make_done(const Order& o) {
+        ExecutionReport report;
+        report.type    = DONE;
+        report.status  = o.status;
+        report.reactor = o.ingress;
+        report.order.order_id        = o.id;
+        report.order.filled_quantity = o.quantity - o.open_quantity();
+        report.order.leaves_quantity = o.open_quantity();
+        return report;
+    }
+
+    [[nodiscard]] static ExecutionReport make_reject(OrderID id, uint32_t reason,
+                                                     GatewayReactor reactor = 0) {
+        ExecutionReport report;
+        report.type    = REJECTED;
+        report.status  = OrderStatus::REJECTED;
+        report.reactor = reactor;
+        report.reason  = reason;
+        report.order.order_id = id;
+        return report;
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<ExecutionReport>,
+              "ExecutionReport must be trivially copyable for lock-free queues");
+static_assert(sizeof(ExecutionReport) == 64,
+              "ExecutionReport should occupy exactly one cache line");
+
+/**
+ * Producer end of the report path: one SPSC queue per gateway reactor,
+ * chosen by the reactor that owns the session. Each reactor's doorbell
+ * is rung once per batch that published to it (ring()).
+ * Owned by one producer thread (an engine or a risk shard).
+ */
+class ExecutionEgress {
+public:
+    /**
+     * queues[i] and bells[i] belong to reactor i (queues non-null; bells
+     * may be nullptr). An empty list or a null queues[0] disconnects.
+     */
+    void assign(const std::vector<SPSCQueue<ExecutionReport>*>& queues,
+                const std::vector<EventDoorbell*>& bells) {
+        targets_.clear();
+        if (queues.empty() || !queues[0]) return;
+        for (size_t i = 0; i < queues.size(); ++i) {
+            targets_.push_back({queues[i], i < bells.size() ? bells[i] : nullptr, false});
+        }
+    }
+
+    [[nodiscard]] bool connected() const { return !targets_.empty(); }
+
+    /** @return false if the reactor's queue is full (report dropped) */
+    bool publish(const ExecutionReport& report, GatewayReactor reactor) {
+        Target& target = targets_[reactor < targets_.size() ? reactor : 0];
+        if (!target.queue->push(report)) [[unlikely]] return false;
+        target.pending = pending_ = true;
+        return true;
+    }
+
+    /** Push position of each reactor's queue, by reactor (see drained_through()) */
+    [[nodiscard]] std::vector<size_t> positions() const {
+        std::vector<size_t> out;
+        for (const auto& target : targets_) out.push_back(target.queue->pushed());
+        return out;
+    }
+
+    /** Every reactor has read its queue past `positions`. Any thread. */
+    [[nodiscard]] bool drained_through(const std::vector<size_t>& positions) const {
+        for (size_t i = 0; i < positions.size(); ++i) {
+            if (targets_[i].queue->popped() < positions[i]) return false;
+        }
+        return true;
+    }
+
+    /** Wake the reactors that received reports since the last call. */
+    void ring() {
+        if (!pending_) return;
+        for (auto& target : targets_) {
+            if (target.pending && target.bell) target.bell->ring();
+            target.pending = false;
+        }
+        pending_ = false;
+    }
+
+private:
+    struct Target {
+        SPSCQueue<ExecutionReport>* queue;
+        EventDoorbell*              bell;
+        bool                        pending;
+    };
+    std::vector<Target> targets_;
+    bool                pending_{false};
+};
+
+// ═══════════════════════════════════════════════════════════════
+//  RiskFeedback — Engine → owning risk shard, releases exposure
+// ═══════════════════════════════════════════════════════════════
+
+/**
+ * Risk shard owning a client (by its ClientDirectory id). Every request
+ * for a client (new, cancel, modify) must go to this shard — its state
+ * and live orders live there — and so do the engine's feedback events.
+ */
+[[nodiscard]] inline size_t risk_shard_for(ClientIDRaw client, size_t shards) {
+    return shards > 1 ? client % shards : 0;
+}
+
+
+/**
+ * What risk needs to unwind its live-order state, nothing more.
+ *   FILL : `quantity` of the order executed at `price`
+ *   DONE : order left the engine (filled, cancelled, or rejected by the
+ *          book) — release what is still open and forget the id
+ * Routed to the shard owning Order::owner; one SPSC push per event.
+ */
+struct RiskFeedback {
+    enum Type : uint8_t {
+        FILL = 0,
+        DONE = 1,
+    };
+
+    Type     type{FILL};
+    OrderID  order_id{0};
+    Quantity quantity{0};
+    Price    price{0};
+
+    [[nodiscard]] static RiskFeedback make_fill(OrderID id, Quantity quantity, Price price) {
+        return RiskFeedback{FILL, id, quantity, price};
+    }
+
+    [[nodiscard]] static RiskFeedback make_done(OrderID id) {
+        return RiskFeedback{DONE, id, 0, 0};
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<RiskFeedback>,
+              "RiskFeedback must be trivially copyable for lock-free queues");
+
+// ═══════════════════════════════════════════════════════════════
+//  MatchingEngine — Order matching for one or more symbols on one thread
+// ═══════════════════════════════════════════════════════════════
+
+/**
+ * Cadence for publishing cross-thread depth snapshots.
+ * A snapshot is published after the book changes if either trigger
+ * fires. Both triggers 0 disables depth publishing.
+ *
+ * `incremental` is independent of the snapshot cadence: after every
+ * book-changing event each touched level is pushed to the market data
+ * queue as a DEPTH_LEVEL event (market-by-price deltas).
+ */
+struct DepthPublishPolicy {
+    size_t   levels{10};          // Levels per side (≤ MAX_DEPTH_LEVELS)
+    size_t   every_events{0};     // Publish after K book-changing events
+    uint64_t interval_us{1000};   // Publish once T µs have passed since the last one
+    bool     incremental{false};  // Also emit a DEPTH_LEVEL event per level change
+};
+
+/** One symbol hosted by a MatchingEngine. */
+struct BookSpec {
+    std::string      symbol;
+    OrderBookOptions options;
+    uint32_t         weight{1};  // Share of the thread under fair scheduling
+    bool             hosted{true};  // false: vacant slot a migrating book may move into
+};
+
 class MatchingEngine {
 public:
     /**
-     * @param symbol  Instrument symbol (e.g., "AAPL")
-     * @param pool    Pre-allocated order pool (must outlive engine)
+     * Dedicated engine: one book, one thread.
+     * @param symbol        Instrument symbol (e.g., "AAPL")
+     * @param pool          Pre-allocated order pool (must outlive engine)
+     * @param book_options  Structural options for the owned OrderBook
+     * @param ingress_lanes One SPSC input lane per producing (risk shard)
+     *                      thread, drained round-robin. At least 1.
      */
-    explicit MatchingEngine(const std::string& symbol, OrderPool& pool);
+    explicit MatchingEngine(const std::string& symbol, OrderPool& pool,
+                            const OrderBookOptions& book_options = {},
+                            size_t ingress_lanes = 1);
+
+    /**
+     * Sharded engine: one thread owning every book in `books`.
+     * BookIndex i addresses books[i].
+     * @param name   Shard name for logs/health (e.g., "shard-0")
+     * @throws std::invalid_argument if books is empty or too large
+     */
+    MatchingEngine(std::string name, const std::vector<BookSpec>& books,
+                   OrderPool& pool, size_t ingress_lanes = 1);
     ~MatchingEngine();
 
     // Non-copyable, non-movable (owns thread)
@@ -203,26 +661,365 @@ public:
         return running_.load(std::memory_order_relaxed);
     }
 
-    // ── Order Submission (called from risk manager thread) ──
+    /** Core / SCHED_FIFO for the worker thread. Call before start(). */
+    void set_thread_placement(const ThreadPlacement& placement) { placement_ = placement; }
+
+    /** Placement that took effect on the worker thread (monitoring). */
+    [[nodiscard]] ThreadPlacement applied_placement() const {
+        return applied_placement_.load(std::memory_order_relaxed);
+    }
+
+    /** What the worker does when its queue is empty. Call before start(). */
+    void set_idle_policy(IdlePolicy policy) { idle_.set_policy(policy); }
+
+    /** Idle periods, parks and wake-up latency (monitoring). */
+    [[nodiscard]] IdleStats idle_stats() const { return idle_.stats(); }
+
+    // ── Books ──────────────────────────────────────────────
+
+    [[nodiscard]] const std::string& name() const { return name_; }
+    [[nodiscard]] size_t book_count() const { return books_.size(); }
+
+    /** Dense index of symbol's book, or NO_BOOK. Cold path (routing setup). */
+    [[nodiscard]] BookIndex book_index(const Symbol& symbol) const;
+
+    /** Symbol of slot `book` (< book_count()). */
+    [[nodiscard]] Symbol book_symbol(BookIndex book) const { return Symbol(books_[book].symbol); }
+
+    // ── Order Submission (called from risk manager threads) ──
+    // Each lane must have exactly one producing thread (risk shard i
+    // uses lane i). Out-of-range books or lanes are refused.
 
     /**
      * Submit a new order for matching.
+     * @param order From this engine's pool (travels as its handle)
+     * @param book  Target book (see book_index())
      * @return false if queue is full (order not accepted)
      */
-    [[nodiscard]] bool submit_order(Order* order);
+    [[nodiscard]] bool submit_order(Order* order, BookIndex book = 0,
+                                    IngressLane lane = 0);
 
     /**
      * Submit a cancel request.
      * @param order_id  Order to cancel
-     * @param client_id Client requesting cancel (ownership check)
+     * @param client_id Client requesting cancel; ownership is checked
+     *                  by risk upstream, so it is not queued
+     * @return false if queue is full
+     */
+    [[nodiscard]] bool cancel_order(OrderID order_id, ClientID client_id,
+                                    BookIndex book = 0, IngressLane lane = 0);
+
+    /**
+     * Submit a cancel/replace. See OrderBook::modify_order().
+     * @param new_price 0 keeps the current price
      * @return false if queue is full
      */
-    [[nodiscard]] bool cancel_order(OrderID order_id, ClientID client_id);
+    [[nodiscard]] bool modify_order(OrderID order_id, ClientID client_id,
+                                    Quantity new_quantity, Price new_price = 0,
+                                    BookIndex book = 0, IngressLane lane = 0);
+
+    /**
+     * Switch trading phase. AUCTION accumulates orders without
+     * matching; HALTED is cancel-only (OrderBook::halt()); CONTINUOUS
+     * uncrosses at the equilibrium price first.
+     * The transition is published as a PHASE_CHANGE event.
+     * @return false if queue is full
+     */
+    [[nodiscard]] bool set_trading_phase(TradingPhase phase, BookIndex book = 0,
+                                         IngressLane lane = 0);
+
+    /**
+     * Cancel every order of `owner` in one sweep per book, instead of
+     * one cancel request per order. Each cancelled order is reported
+     * like a single cancel (DONE report, risk feedback).
+     * @param book  One book, or NO_BOOK for every book of this engine
+     * @return false if queue is full
+     */
+    [[nodiscard]] bool mass_cancel(ClientIDRaw owner, BookIndex book = NO_BOOK,
+                                   IngressLane lane = 0);
+
+    /**
+     * Enqueue prepared requests (new_order_request(), OrderRequest::make_*)
+     * with one publish and one wake-up: what a risk shard staged for this
+     * engine during one batch. In order; a short push leaves the suffix
+     * [returned, count) to the caller, counted as drops. An out-of-range
+     * book (or a request type producers may not send) ends the push there.
+     * @return Number enqueued
+     */
+    [[nodiscard]] size_t submit_requests(const OrderRequest* requests, size_t count,
+                                         IngressLane lane = 0);
+
+    /** NEW_ORDER request for `order` (from this engine's pool), for submit_requests(). */
+    [[nodiscard]] OrderRequest new_order_request(Order* order, BookIndex book = 0) const {
+        return OrderRequest::make_new_order(pool_.handle(order), book);
+    }
+
+    [[nodiscard]] size_t lane_count() const { return lanes_.size(); }
+
+    /** Depth and counters per input lane. Safe from any thread. */
+    [[nodiscard]] std::vector<IngressLaneStats> lane_stats() const;
+
+    /** Sample input lane depth and residence on 1 in `sample_every` requests. Call before start(). */
+    void enable_queue_telemetry(size_t sample_every) {
+        for (auto& lane : lanes_) lane->queue->enable_telemetry(sample_every);
+    }
 
     // ── Market Data ────────────────────────────────────────
 
-    /** Set output queue for trade/BBO events. Call before start(). */
-    void set_market_data_queue(MPMCQueue<MarketDataEvent>* queue);
+    /**
+     * Set output lane for trade/BBO events. Call before start().
+     * @param reader_idle  Idle strategy of the lane's consumer, notified
+     *                     once per processed batch so a parked reader wakes
+     */
+    void set_market_data_queue(MarketDataLane* lane, IdleStrategy* reader_idle = nullptr);
+
+    /**
+     * Send one book's events to `lane`, tagged with `channel` (a
+     * partition of the feed, see UdpPublisher::add_channel). Overrides
+     * set_market_data_queue() for that book. Books routed to the same
+     * publisher share one lane. Call before start().
+     */
+    void set_market_data_route(BookIndex book, uint8_t channel, MarketDataLane* lane,
+                               IdleStrategy* reader_idle = nullptr);
+
+    /**
+     * Publish one book's market-by-order events (OrderEvent, one per
+     * change to a resting order) to `lane`, tagged with `channel` — a
+     * channel of its own, so the depth feed's subscribers never see them.
+     * Books without a route pay one branch per book change. Drops on a
+     * full lane count in md_drops. Call before start().
+     */
+    void set_order_feed_route(BookIndex book, uint8_t channel, MarketDataLane* lane,
+                              IdleStrategy* reader_idle = nullptr);
+
+    /**
+     * Set output queue for per-order fill/done/reject reports (gateway).
+     * Call before start(). Reports that do not fit are dropped and
+     * counted in exec_drops.
+     * @param reader_bell  Rung once per batch that published a report
+     */
+    void set_execution_queue(SPSCQueue<ExecutionReport>* queue,
+                             EventDoorbell* reader_bell = nullptr);
+
+    /**
+     * One report queue (and doorbell) per gateway reactor, indexed by
+     * reactor. Each report goes to the reactor of the order's session;
+     * a fill whose sides sit on two reactors goes to both.
+     * Call before start().
+     */
+    void set_execution_queues(const std::vector<SPSCQueue<ExecutionReport>*>& queues,
+                              const std::vector<EventDoorbell*>& reader_bells);
+
+    /**
+     * Feedback rings to the risk shards, indexed by shard: fills and
+     * done events for an order go to rings[risk_shard_for(owner)].
+     * Call before start(). Events that do not fit are dropped and
+     * counted in risk_feedback_drops (the shard keeps that exposure).
+     */
+    void set_risk_feedback(std::vector<SPSCQueue<RiskFeedback>*> rings);
+
+    /**
+     * Publish each book's last trade price into its slot of `table`
+     * (books whose symbol is not in the table publish nothing).
+     * Call before start().
+     */
+    void set_reference_prices(ReferencePriceTable& table);
+
+    /**
+     * Have each book publish its top of book into its slot of `table`
+     * (books whose symbol is not in the table keep their own slot).
+     * Call before start().
+     */
+    void set_bbo_table(BBOTable& table);
+
+    /**
+     * Also publish the counters into `block` (a StatsKind::ENGINE block,
+     * EngineCounter slots) at every stats flush. Call before start().
+     */
+    void set_stats_block(StatsBlock* block) { stats_block_ = block; }
+
+    /**
+     * Stamp sampled new orders on dequeue and once matched, and hand
+     * their records to the tracer through a sink of this engine's own.
+     * Call before start().
+     */
+    void set_order_tracer(OrderTracer* tracer) {
+        tracer_     = tracer;
+        trace_sink_ = tracer ? tracer->add_sink() : nullptr;
+    }
+
+    /**
+     * Journal every dequeued request and every trade, done and reject
+     * into `lane` (EventJournal::add_engine). A full lane drops records,
+     * never blocks. Call before start().
+     */
+    void set_event_journal(JournalLane* lane) { journal_ = lane; }
+
+    /**
+     * Ack-before-ack (replication.mode "sync"): hold each execution report
+     * until `acked` (the last journal sequence of this engine a standby
+     * has applied, ReplicationPrimary::acked) reaches the request behind
+     * it. Matching goes on; the reports go out in order once acked, and
+     * all of them on stop(). Needs the event journal. Call before start().
+     */
+    void set_replication_gate(const std::atomic<uint64_t>* acked) { replication_acked_ = acked; }
+
+    /** Unpark the worker: a replication ack may release held reports */
+    void wake() { idle_.notify(); }
+
+    /**
+     * Copy every book into `slot` each `interval` (and once more on
+     * stop), between batches, for the snapshot writer. Skipped while the
+     * writer still holds the previous copy. Call before start().
+     */
+    void set_book_snapshots(BookSnapshotSlot* slot, std::chrono::milliseconds interval);
+
+    // ── Warm restart (before start()) ──────────────────────
+
+    /**
+     * Rebuild the books from a snapshot; images are matched to books by
+     * symbol (unknown symbols are skipped).
+     * @return Orders restored
+     */
+    size_t restore(const EngineSnapshot& snapshot);
+
+    /**
+     * Process journaled requests (NEW_ORDER, CANCEL_ORDER, MODIFY_ORDER,
+     * SET_PHASE, MASS_CANCEL; other records are ignored) as if dequeued,
+     * with market data, reports, risk feedback and journaling muted.
+     * @param outputs If set, the requests and their outputs are journaled
+     *        there instead, stamped with the recorded times (trades
+     *        included, see OrderBook::set_clock), for verification
+     *        against the journal they came from
+     * @return Requests replayed
+     */
+    size_t replay(std::span<const JournalRecord> records, JournalLane* outputs = nullptr);
+
+    /**
+     * Conflate BBO updates: a book that changes several times in one
+     * drained batch publishes one BBO (its state after the batch)
+     * instead of one per change. Trades, phase and depth events are
+     * never conflated. Call before start().
+     */
+    void set_bbo_conflation(bool enabled) { bbo_conflation_ = enabled; }
+
+    /**
+     * After the trades of an incoming order that filled more than once,
+     * publish a SWEEP event: fills, total quantity, first and last price.
+     * The trades themselves are always published. Call before start().
+     */
+    void set_sweep_summary(bool enabled) { sweep_summary_ = enabled; }
+
+    /**
+     * How long a volatility pause lasts. A book whose sweep hits its
+     * price band enters AUCTION (published as a PHASE_CHANGE with
+     * volatility_pause set); after `duration` the worker submits a
+     * SET_PHASE CONTINUOUS for it through the normal request path, so
+     * the resume is journaled and replays like an operator's. Any
+     * SET_PHASE for the book before then cancels the timer. 0 keeps the
+     * book in AUCTION until a SET_PHASE. Call before start().
+     */
+    void set_volatility_pause(std::chrono::nanoseconds duration) {
+        volatility_pause_ns_ = static_cast<uint64_t>(duration.count());
+    }
+
+    /**
+     * Time one maintenance pass may spend (stats flush, pruning drained
+     * levels book by book) at a batch boundary or idle moment. A pass
+     * starts no new book past the budget and resumes where it stopped.
+     * Call before start().
+     */
+    void set_maintenance_budget(std::chrono::nanoseconds budget) {
+        maintenance_budget_ns_ = static_cast<uint64_t>(budget.count());
+    }
+
+    /**
+     * Share the thread between books instead of matching requests in
+     * lane order. Each batch stages what it takes off the lanes behind
+     * its book, then serves the books deficit round robin: a book
+     * matches up to slice × its BookSpec weight requests per turn, as
+     * one run, and keeps the rest staged for its next turn. A burst on
+     * one symbol then delays that symbol, not the books sharing its
+     * thread. A book's requests keep their order; a mass cancel across
+     * every book waits for everything staged before it.
+     * 0 = off (lane order). Ignored by single-book engines.
+     * Call before start().
+     */
+    void set_fair_scheduling(size_t slice);
+
+    /** Scheduling counters per book; empty unless fair scheduling is on. Any thread. */
+    [[nodiscard]] std::vector<BookScheduleStats> schedule_stats() const;
+
+    /** Requests matched per book since start, by BookIndex (flushed with the stats). Any thread. */
+    [[nodiscard]] std::vector<uint64_t> book_requests() const;
+
+    // ── Book migration (see migrate_book() in book_rebalancer.hpp) ──
+
+    /**
+     * Vacant slot `book` (BookSpec::hosted false) is about to receive its
+     * book: until adopt_book(), a mass cancel keeps a copy for it, as it
+     * does every other request routed to the slot. Any thread; call
+     * before the producers are rerouted.
+     */
+    void expect_book(BookIndex book) { incoming_book_.store(book, std::memory_order_relaxed); }
+
+    /**
+     * Let `book` go to another engine. Queue it only once no producer
+     * routes to the book any more: the worker then matches everything the
+     * lanes held at that point, detaches the book, and waits until the
+     * readers of its outputs (market data, execution reports, risk
+     * feedback) are past its last events, so its next engine cannot
+     * overtake them. book_released() turns true then. One release at a time.
+     * @return false if the lane is full
+     */
+    [[nodiscard]] bool release_book(BookIndex book, IngressLane lane);
+
+    /** The book of the last release_book() waits for adopt_book(). Any thread. */
+    [[nodiscard]] bool book_released() const {
+        return release_state_.load(std::memory_order_acquire) == RELEASED;
+    }
+
+    /**
+     * Slot `book` holds its book now. Any thread; exact while no move
+     * involves this engine (an adopt still being applied reads as vacant).
+     */
+    [[nodiscard]] bool hosts_book(BookIndex book) const {
+        return book < books_.size() && hosting_[book].load(std::memory_order_acquire);
+    }
+
+    /** No release in progress: the last released book was adopted. Any thread. */
+    [[nodiscard]] bool release_idle() const {
+        return release_state_.load(std::memory_order_acquire) == RELEASE_IDLE;
+    }
+
+    /**
+     * Take the book `from` released (book_released()) into vacant slot
+     * `book`, which must name the same symbol. Requests that reached the
+     * slot before it were held; they are matched first, in arrival order.
+     * @return false if the lane is full
+     */
+    [[nodiscard]] bool adopt_book(MatchingEngine& from, BookIndex book, IngressLane lane);
+
+    /**
+     * Set depth snapshot cadence. Call before start().
+     * @throws std::invalid_argument if policy.levels > MAX_DEPTH_LEVELS
+     */
+    void set_depth_publishing(const DepthPublishPolicy& policy);
+
+    /**
+     * Latest published depth snapshot. Safe from any thread —
+     * dashboard/HTTP readers never touch the matching thread.
+     * @return false if nothing published yet
+     */
+    [[nodiscard]] bool read_depth(DepthSnapshot& out, BookIndex book = 0) const {
+        const OrderBook* view = depth_views_[book].load(std::memory_order_acquire);
+        return view && view->read_depth(out);
+    }
+
+    /** Market data channel `book` publishes on. Set before start(). */
+    [[nodiscard]] uint8_t market_data_channel(BookIndex book = 0) const {
+        return books_[book].md_channel;
+    }
 
     // ── Statistics (read by monitoring thread) ─────────────
 
@@ -237,10 +1034,15 @@ public:
         uint64_t cancels_accepted;
         uint64_t cancels_rejected;
         uint64_t md_drops;
+        uint64_t exec_drops;
+        uint64_t risk_feedback_drops;
         uint64_t queue_full_count;
+        uint64_t books_pruned;  // Maintenance prunes of drained levels
     };
 
     [[nodiscard]] Stats get_stats() const {
+        uint64_t queue_full = 0;
+        for (const auto& lane : lanes_) queue_full += lane->drops.load(std::memory_order_relaxed);
         return Stats{
             .orders_accepted = orders_processed_.load(std::memory_order_relaxed),
             .orders_rejected = orders_rejected_.load(std::memory_order_relaxed),
@@ -248,7 +1050,10 @@ public:
             .cancels_accepted = 0,  // TODO: expose from local stats
             .cancels_rejected = 0,
             .md_drops         = md_drops_.load(std::memory_order_relaxed),
-            .queue_full_count = 0,
+            .exec_drops       = exec_drops_.load(std::memory_order_relaxed),
+            .risk_feedback_drops = risk_feedback_drops_.load(std::memory_order_relaxed),
+            .queue_full_count = queue_full,
+            .books_pruned     = books_pruned_.load(std::memory_order_relaxed),
         };
     }
 
@@ -269,18 +1074,133 @@ public:
      */
     void on_trade_internal(const Trade& trade);
 
+    /** Called by OrderBook when it retires a resting order. Same caveat. */
+    void on_order_done_internal(const Order& order);
+
+    /** Called by OrderBook for each side of a trade. Same caveat. */
+    void on_order_fill_internal(const Order& order, Quantity quantity, Price price);
+
+    /** Called by OrderBook for each market-by-order event. Same caveat. */
+    void on_order_event_internal(const OrderEvent& event);
+
 private:
+    /** Per-book state. Trades arrive while the slot is active_. */
+    struct BookSlot {
+        OrderBook* book{nullptr};            // nullptr: vacant (not hosted, or released)
+        char      symbol[16]{};              // Pre-cached (avoid strncpy in hot path)
+        size_t    depth_pending_events{0};   // Book changes since last publish
+        uint64_t  depth_sequence{0};         // Book changes ever: tags DEPTH_LEVEL events and snapshots
+        Timestamp depth_last_publish_ns{0};
+        ReferencePriceSlot* reference_price{nullptr};  // Last trade price → risk collars
+        MarketDataLane* md_queue{nullptr};  // Lane to the publisher serving md_channel
+        uint8_t   md_channel{0};
+        uint8_t   mbo_channel{0};
+        MarketDataLane* mbo_queue{nullptr}; // Market by order (set_order_feed_route)
+        bool      bbo_dirty{false};          // Conflated BBO pending (on bbo_dirty_)
+        Timestamp pause_end_ns{0};           // Volatility pause resumes at (0 = none)
+        uint32_t  weight{1};                 // BookSpec::weight
+        uint64_t  requests{0};               // Matched here (flushed to book_requests_)
+    };
+
+    /** What a released book takes to its next engine (written before RELEASED) */
+    struct BookHandoff {
+        OrderBook* book{nullptr};
+        uint64_t   depth_sequence{0};
+        Timestamp  pause_end_ns{0};
+    };
+
+    /** Worker-side progress of release_book() */
+    struct BookRelease {
+        BookIndex           book{NO_BOOK};
+        bool                detached{false};
+        std::vector<size_t> lanes;     // Input positions the book's last requests sit behind
+        std::vector<std::pair<const MarketDataLane*, size_t>> market_data;  // Output positions
+        std::vector<size_t> reports;   // ... by reactor (ExecutionEgress::positions)
+        std::vector<size_t> feedback;  // ... by risk shard
+    };
+
+    enum ReleaseState : uint8_t { RELEASE_IDLE = 0, RELEASING = 1, RELEASED = 2 };
+
+    /** One book's staged requests under fair scheduling: a ring of FAIR_STAGE_CAPACITY */
+    struct BookStage {
+        std::unique_ptr<OrderRequest[]> requests;
+        std::unique_ptr<Timestamp[]>    staged_at;  // When each was taken off its lane
+        uint32_t head{0};
+        uint32_t count{0};
+        uint64_t deficit{0};  // Requests the book may still match this turn
+    };
+
+    /** Written by the worker once per run, read by schedule_stats() */
+    struct alignas(64) BookScheduleCounters {
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> delay_sum_ns{0};
+        std::atomic<uint64_t> delay_max_ns{0};
+        std::atomic<uint32_t> backlog{0};
+    };
+
     // ═══════════════════════════════════════════════════════
     //  HOT DATA — accessed every iteration of worker loop
     // ═══════════════════════════════════════════════════════
 
-    alignas(64)
-    std::unique_ptr<SPSCQueue<OrderRequest>> input_queue_;
-    std::unique_ptr<OrderBook> book_;
-    MPMCQueue<MarketDataEvent>* market_data_queue_{nullptr};
+    /** One producer's input ring. Counters are producer-written, monitoring-read. */
+    struct InputLane {
+        std::unique_ptr<SPSCQueue<OrderRequest>> queue;
+        alignas(64) std::atomic<uint64_t> submitted{0};
+        std::atomic<uint64_t>             drops{0};
+    };
 
-    // Pre-cached symbol (avoid strncpy in hot path)
-    char symbol_cache_[16]{};
+    alignas(64)
+    std::vector<std::unique_ptr<InputLane>> lanes_;
+    std::vector<OrderRequest> drain_buffer_;  // One bulk pop per lane visit (BATCH_SIZE slots)
+    size_t    next_lane_{0};     // Round-robin start for the next batch
+    // Fair scheduling (set_fair_scheduling): stages indexed by BookIndex,
+    // empty = off. ready_ holds the books with staged requests, in turn order.
+    size_t                 fair_slice_{0};
+    std::vector<BookStage> stages_;
+    std::vector<BookIndex> ready_;
+    std::vector<BookIndex> ready_next_;
+    size_t                 staged_total_{0};
+    std::unique_ptr<BookScheduleCounters[]> schedule_counters_;
+    BookSlot* active_{nullptr};  // Book of the request being processed
+    std::vector<IdleStrategy*> market_data_readers_;  // Distinct publishers to wake per batch
+    ExecutionEgress execution_egress_;  // Per-reactor report queues
+    ExecutionReport pending_fill_;      // Trade awaiting both sides' reactors
+    uint8_t         pending_fill_sides_{0};
+    std::vector<SPSCQueue<RiskFeedback>*> risk_feedback_;  // Indexed by risk shard
+    std::vector<BookSlot> books_;  // Indexed by BookIndex; never resized after construction
+    std::vector<std::unique_ptr<OrderBook>> owned_books_;  // Created here; may be hosted elsewhere now
+    OrderTracer*    tracer_{nullptr};      // Sampled lifecycle stamps (order_trace_sample > 0)
+    StatsBlock*     stats_block_{nullptr}; // Exchange-wide stats region slot, if any
+    OrderTraceSink* trace_sink_{nullptr};
+    JournalLane*    journal_{nullptr};     // Write-ahead journal (persistence.enable_event_log)
+    Timestamp       journal_time_{0};      // Read once per batch, only when journaling
+    uint64_t        request_seq_{0};       // Journal sequence of the request being processed (0: not journaled)
+
+    struct HeldReport {
+        ExecutionReport report;
+        GatewayReactor  reactor;
+        uint64_t        seq;  // Request the standby must have applied first
+    };
+    const std::atomic<uint64_t>* replication_acked_{nullptr};  // Set: reports wait in held_
+    std::vector<HeldReport>      held_;
+    size_t                       held_head_{0};  // Next to release
+    BookSnapshotSlot* snapshot_slot_{nullptr};  // Book snapshots (persistence.snapshot_interval_ms)
+    uint64_t          snapshot_interval_ns_{0};
+    Timestamp         next_snapshot_ns_{0};
+    uint64_t          volatility_pause_ns_{5'000'000'000};  // See set_volatility_pause
+    Timestamp         next_pause_end_ns_{0};  // Earliest BookSlot::pause_end_ns (0 = none)
+
+    // Book migration. parked_ holds requests that reached a vacant slot
+    // (worker only; reserved up front, so the handoff does not allocate in
+    // the batch loop); the release state and handoff are read by the adopter.
+    BookRelease                release_;
+    BookHandoff                handoff_;
+    std::vector<OrderRequest>  parked_;
+    std::atomic<uint8_t>       release_state_{RELEASE_IDLE};
+    std::atomic<BookIndex>     incoming_book_{NO_BOOK};
+    std::unique_ptr<std::atomic<const OrderBook*>[]> depth_views_;  // Set on attach, kept on release
+    std::unique_ptr<std::atomic<uint64_t>[]>         book_requests_;
+    std::unique_ptr<std::atomic<bool>[]>             hosting_;  // BookSlot::book set, for hosts_book()
 
     // ═══════════════════════════════════════════════════════
     //  LOCAL STATS — thread-local counters (no atomics)
@@ -293,11 +1213,35 @@ private:
         size_t orders_rejected{0};
         size_t cancels_accepted{0};
         size_t cancels_rejected{0};
+        size_t modifies_accepted{0};
+        size_t modifies_rejected{0};
         size_t trades_executed{0};
         size_t md_drops{0};
-        size_t queue_full_count{0};
+        size_t exec_drops{0};
+        size_t risk_feedback_drops{0};
+        size_t books_pruned{0};
     };
     LocalStats local_stats_;
+    size_t     last_flush_at_{0};       // total_processed at the last flush_stats()
+    uint64_t   stats_flushes_{0};       // Publishes into stats_block_
+    size_t     maintenance_cursor_{0};  // Next book maintain() looks at
+    uint64_t   maintenance_budget_ns_{2'000};  // See set_maintenance_budget
+
+    // Trades staged for one bulk push (worker thread only): a sweep's
+    // fills go out as one run, its SWEEP summary behind them
+    std::array<MarketDataEvent, TRADE_BATCH> trade_batch_;
+    size_t                      trade_batch_count_{0};
+    MarketDataEvent             sweep_;                // Summary being built (sweep.fills = 0: none)
+    OrderID                     sweep_aggressor_id_{0};
+    bool                        sweep_summary_{false};
+
+    // BBO conflation (worker thread only)
+    bool                   bbo_conflation_{false};
+    std::vector<BookIndex> bbo_dirty_;  // Books whose BBO changed this batch
+
+    // Depth publishing state (worker thread only)
+    DepthPublishPolicy     depth_policy_;
+    std::vector<BookIndex> depth_dirty_;  // Books with pending events (no scan of idle books)
 
     // ═══════════════════════════════════════════════════════
     //  ATOMIC STATS — read by monitoring, written by flush
@@ -308,6 +1252,9 @@ private:
     std::atomic<uint64_t> trades_executed_{0};
     std::atomic<uint64_t> orders_rejected_{0};
     std::atomic<uint64_t> md_drops_{0};
+    std::atomic<uint64_t> exec_drops_{0};
+    std::atomic<uint64_t> risk_feedback_drops_{0};
+    std::atomic<uint64_t> books_pruned_{0};
 
     // ═══════════════════════════════════════════════════════
     //  THREADING
@@ -316,45 +1263,100 @@ private:
     alignas(64)
     std::atomic<bool> running_{false};
     std::thread worker_thread_;
+    ThreadPlacement              placement_;
+    std::atomic<ThreadPlacement> applied_placement_{};
+    IdleStrategy                 idle_{IdlePolicy::SPIN_YIELD};  // Producers notify() after push
 
     // ═══════════════════════════════════════════════════════
     //  COLD DATA — setup only
     // ═══════════════════════════════════════════════════════
 
     alignas(64)
-    std::string symbol_;
+    std::string name_;
     OrderPool& pool_;
+    OrderReleaseBatch released_;  // Orders retired this cycle; flushed at the end of drain_batch()
 
     // ═══════════════════════════════════════════════════════
     //  Worker Thread Internals
     // ═══════════════════════════════════════════════════════
 
-    /** Main worker loop — batch drain + spin-pause-yield */
+    /** Main worker loop — batch drain, idle_ when empty */
     void run();
 
-    /** Drain up to BATCH_SIZE orders. Returns count processed. */
+    /** Drain up to BATCH_SIZE orders across the lanes. Returns count processed. */
     size_t drain_batch();
+    /** Match up to `budget` requests straight off the lanes, in lane order */
+    size_t drain_lanes(size_t budget);
+    /** Stage a batch, then one deficit round robin round of up to `budget` requests */
+    size_t drain_fair(size_t budget);
+    /** Take requests off the lanes into their books' stages. @return Requests matched (barriers) */
+    size_t stage_lanes();
+    /** Match the first `run` staged requests of `book` as one run */
+    void serve_stage(BookIndex book, size_t run);
+    /** Match everything staged, book by book (before a request that spans every book) */
+    size_t flush_stages();
+
+    bool any_lane_pending();
+    bool push_request(const OrderRequest& request, IngressLane lane);
+    void process_request(const OrderRequest& request);
 
     /** Process single new order through matching. */
     void process_new_order(Order* order);
 
     /** Process cancel request with BBO change detection. */
-    void process_cancel(OrderID order_id, ClientID client_id);
+    void process_cancel(OrderID order_id);
+
+    /** Process cancel/replace with BBO change detection. */
+    void process_modify(OrderID order_id, Quantity new_quantity, Price new_price);
+
+    /** Enter AUCTION or HALTED, or uncross and return to CONTINUOUS. */
+    void process_phase_change(TradingPhase phase);
+    /** The active book's sweep tripped its band: publish the pause, arm its resume */
+    void begin_volatility_pause();
+    /** Resume the books whose pause is over. @return Requests processed */
+    size_t end_volatility_pauses();
+    void process_mass_cancel(ClientIDRaw owner, BookIndex book);
+    void begin_release(BookIndex book);
+    /** Detach the releasing book once drained, then publish RELEASED once its outputs were read */
+    void advance_release();
+    void adopt(MatchingEngine& from, BookIndex book);
+    /** Point a book's callbacks and per-engine state at this engine */
+    void attach(BookIndex index, OrderBook* book);
 
     // ── Market Data Publishing ──
 
+    void publish_market_data(MarketDataEvent& event);
     void publish_trade(const Trade& trade);
+    MarketDataEvent& stage_trade_event();
+    void close_sweep();
+    /** Close the current sweep (summary staged) and push the staged trades */
+    void flush_trades();
+    void push_staged_trades();
     void publish_bbo_update();
+    void push_bbo();
+    void publish_conflated_bbo();
+    void publish_phase(TradingPhase phase, const AuctionResult& result, bool volatility_pause = false);
+    void publish_level_changes();
+    void publish_execution(const ExecutionReport& report, GatewayReactor reactor);
+    /** Publish the held reports the standby has acked (`all`: every one). @return Released */
+    size_t release_held(bool all);
+    bool held_ready() const;
+    void publish_risk_feedback(ClientIDRaw owner, const RiskFeedback& feedback);
 
-    // ── Backoff Strategy ──
+    // ── Journal (only called when journal_ is set) ──
 
-    /** Spin-pause-yield (no sleep). See .cpp for detailed docs. */
-    void spin_wait();
+    void journal_request(const OrderRequest& request);
+    void journal_output(JournalRecord& record);
 
     // ── Periodic Maintenance ──
 
-    void maybe_compact();
-    void maybe_flush_stats();
+    /** Budgeted stats flush and book pruning. @return true if a pass may find more */
+    bool maintain(bool idle);
+    void maybe_snapshot();
+    /** Copy the books into snapshot_slot_ unless the writer still holds it */
+    void capture_snapshot();
+    void mark_depth_pending();
+    void maybe_publish_depth();
     void flush_stats();
 };
 
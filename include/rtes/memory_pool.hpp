@@ -7,6 +7,9 @@
  * This pool provides the "allocation-free hot path" guarantee:
  *   - All memory pre-allocated at construction
  *   - allocate() and deallocate() are O(1), lock-free
+ *   - SegmentedPool (OrderPool) can add segments from a background
+ *     thread without moving or reallocating anything the hot path uses
+ *   - deallocate_bulk() returns a batch with one CAS
  *   - No system calls, no heap allocation during operation
  *
  * Thread safety:
@@ -22,11 +25,27 @@
  *   With 32-bit generation, ABA requires 4 billion operations
  *   between a thread's preemption and resume — effectively impossible.
  *
+ * Thread magazines (optional, magazine_block > 0):
+ *   Each thread using the pool claims a magazine of up to 2 × block
+ *   free slots. allocate()/deallocate() pop and push it without
+ *   touching shared memory; an empty magazine refills `block` slots
+ *   from the stack in one CAS, and a full one spills `block` in one
+ *   CAS. So the gateway (allocating) and the engines (freeing) trade
+ *   slots a block at a time instead of bouncing head_ on every order.
+ *   A thread's magazine goes back to the stack when the thread exits.
+ *   Free slots cached in other threads' magazines are not visible to
+ *   allocate(): the pool can report exhaustion up to that many slots
+ *   early (Stats::cached), so the block is capped to a small share of
+ *   the capacity.
+ *
  * Memory layout:
  *   pool_:  Cache-line-aligned array of T (contiguous)
  *   next_:  Cache-line-aligned array of uint32_t (free list links)
+ *           Both are PageRegions: huge pages / THP / heap per the
+ *           process page policy (see huge_pages.hpp), reported in Stats.
  *   head_:  Atomic tagged pointer (own cache line)
  *   stats_: Atomic counters (own cache line)
+ *   magazines_: One cache line of bookkeeping per claimed thread
  *
  * Debug mode (NDEBUG not defined):
  *   - Tracks ownership per slot (detects double-free)
@@ -36,16 +55,25 @@
  * @tparam T Element type. Must be default-constructible.
  */
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
+#include <mutex>
 #include <new>
 #include <type_traits>
 #include <stdexcept>  
 #include <string>     
+#include <unordered_set>
+#include <vector>
+
+#include "rtes/huge_pages.hpp"
+#include "rtes/numa.hpp"
 
 namespace rtes {
 
@@ -56,6 +84,10 @@ namespace detail {
 
 inline constexpr size_t POOL_CACHE_LINE = 64;
 inline constexpr uint32_t POOL_EMPTY = UINT32_MAX;
+inline constexpr size_t POOL_MAX_MAGAZINES = 64;        // Threads with a magazine per pool
+inline constexpr size_t POOL_MIN_MAGAZINE_BLOCK = 8;    // Smaller: magazines off
+inline constexpr size_t POOL_MAX_MAGAZINE_BLOCK = 256;
+inline constexpr size_t POOL_MAGAZINE_SHARE = 1024;     // Block ≤ capacity / this
 
 /**
  * Tagged index for ABA-safe lock-free stack.
@@ -101,6 +133,80 @@ template<typename U>
     return static_cast<U*>(ptr);
 }
 
+// ─── Thread → magazine bindings (cold paths only) ───
+
+/** Pools alive, by id; guards magazine hand-back at thread exit against pool destruction */
+inline std::mutex& pool_registry_mutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+inline std::unordered_set<uint64_t>& live_pools() {
+    static std::unordered_set<uint64_t> pools;
+    return pools;
+}
+
+inline uint64_t next_pool_id() {
+    static std::atomic<uint64_t> id{1};
+    return id.fetch_add(1, std::memory_order_relaxed);
+}
+
+/** A thread's magazine in one pool; magazine == nullptr = none free, use the stack */
+struct MagazineBinding {
+    uint64_t pool_id{0};
+    void*    pool{nullptr};
+    void*    magazine{nullptr};
+    void   (*release)(void* pool, void* magazine){nullptr};
+};
+
+/**
+ * The calling thread's magazine bindings. Pool ids are never reused,
+ * so a binding to a destroyed pool is never matched again; on thread
+ * exit each magazine of a pool still alive goes back to that pool.
+ */
+class ThreadMagazines {
+public:
+    static ThreadMagazines& local() {
+        thread_local ThreadMagazines magazines;
+        return magazines;
+    }
+
+    ~ThreadMagazines() {
+        std::lock_guard<std::mutex> lock(pool_registry_mutex());
+        for (size_t i = 0; i < count_; ++i) {
+            const MagazineBinding& b = bindings_[i];
+            if (b.magazine && live_pools().contains(b.pool_id)) b.release(b.pool, b.magazine);
+        }
+    }
+
+    [[nodiscard]] const MagazineBinding* find(uint64_t pool_id) const {
+        for (size_t i = 0; i < count_; ++i) {
+            if (bindings_[i].pool_id == pool_id) return &bindings_[i];
+        }
+        return nullptr;
+    }
+
+    /** @return the stored binding, or nullptr if every entry is taken by a live pool */
+    const MagazineBinding* bind(const MagazineBinding& binding) {
+        if (count_ == bindings_.size()) {
+            // Drop bindings of destroyed pools
+            std::lock_guard<std::mutex> lock(pool_registry_mutex());
+            size_t kept = 0;
+            for (size_t i = 0; i < count_; ++i) {
+                if (live_pools().contains(bindings_[i].pool_id)) bindings_[kept++] = bindings_[i];
+            }
+            count_ = kept;
+            if (count_ == bindings_.size()) return nullptr;
+        }
+        bindings_[count_] = binding;
+        return &bindings_[count_++];
+    }
+
+private:
+    std::array<MagazineBinding, 8> bindings_{};
+    size_t count_{0};
+};
+
 } // namespace detail
 
 template<typename T>
@@ -112,13 +218,24 @@ public:
     /**
      * @param capacity Maximum number of elements.
      *                 Must be < UINT32_MAX (4 billion).
+     * @param magazine_block Slots a thread magazine moves to/from the
+     *                 shared stack at once; 0 = no magazines. Capped to
+     *                 POOL_MAX_MAGAZINE_BLOCK and capacity /
+     *                 POOL_MAGAZINE_SHARE; below POOL_MIN_MAGAZINE_BLOCK
+     *                 after capping, magazines are off.
+     * @param numa_node Node the slot and link arrays are bound to,
+     *                 -1 = wherever first touched
      * @throws std::bad_alloc if memory allocation fails
      * @throws std::invalid_argument if capacity is 0 or too large
      */
-    explicit MemoryPool(size_t capacity)
+    explicit MemoryPool(size_t capacity, size_t magazine_block = 0, int numa_node = -1)
         : capacity_(validate_capacity(capacity))
-        , pool_(detail::alloc_aligned<T>(capacity))
-        , next_(detail::alloc_aligned<uint32_t>(capacity))
+        , pool_pages_(sizeof(T) * capacity, numa_node)
+        , next_pages_(sizeof(uint32_t) * capacity, numa_node)
+        , pool_(static_cast<T*>(pool_pages_.data()))
+        , next_(static_cast<uint32_t*>(next_pages_.data()))
+        , magazine_block_(effective_block(capacity, magazine_block))
+        , id_(detail::next_pool_id())
     {
         // Default-construct all pool elements
         for (size_t i = 0; i < capacity_; ++i) {
@@ -146,17 +263,30 @@ public:
             owned_[i].store(0, std::memory_order_relaxed);  // 0 = free
         }
 #endif
+
+        if (magazine_block_ != 0) {
+            magazines_ = std::make_unique<Magazine[]>(detail::POOL_MAX_MAGAZINES);
+            magazine_items_ = std::make_unique<uint32_t[]>(
+                detail::POOL_MAX_MAGAZINES * 2 * magazine_block_);
+            for (size_t i = 0; i < detail::POOL_MAX_MAGAZINES; ++i) {
+                magazines_[i].items = &magazine_items_[i * 2 * magazine_block_];
+            }
+            std::lock_guard<std::mutex> lock(detail::pool_registry_mutex());
+            detail::live_pools().insert(id_);
+        }
     }
 
     ~MemoryPool() {
+        if (magazine_block_ != 0) {
+            std::lock_guard<std::mutex> lock(detail::pool_registry_mutex());
+            detail::live_pools().erase(id_);
+        }
         // Destroy all elements (even if pool isn't fully deallocated)
         if constexpr (!std::is_trivially_destructible_v<T>) {
             for (size_t i = 0; i < capacity_; ++i) {
                 pool_[i].~T();
             }
         }
-        std::free(pool_);
-        std::free(next_);
 #ifndef NDEBUG
         std::free(owned_);
 #endif
@@ -183,9 +313,30 @@ public:
      * but may contain stale data from previous use.
      * Caller should initialize all fields before use.
      *
+     * With magazines, taken from the calling thread's magazine, which
+     * refills a block at a time from the shared stack.
+     *
      * @return Pointer to allocated element, or nullptr if pool exhausted
      */
     [[nodiscard]] T* allocate() {
+        if (Magazine* mag = magazine()) {
+            uint32_t count = mag->count.load(std::memory_order_relaxed);
+            if (count == 0) [[unlikely]] {
+                count = refill(*mag);
+                if (count == 0) return nullptr;
+            }
+            const uint32_t index = mag->items[--count];
+            mag->count.store(count, std::memory_order_relaxed);
+            mag->net_allocated.store(mag->net_allocated.load(std::memory_order_relaxed) + 1,
+                                     std::memory_order_relaxed);
+#ifndef NDEBUG
+            uint32_t prev = owned_[index].exchange(1, std::memory_order_relaxed);
+            assert(prev == 0 && "Double allocation detected — "
+                   "slot was already allocated");
+#endif
+            return &pool_[index];
+        }
+
         uint64_t old_head = head_.load(std::memory_order_acquire);
 
         for (;;) {
@@ -244,30 +395,14 @@ public:
      * @param ptr Pointer to deallocate (must be from this pool, non-null)
      */
     void deallocate(T* ptr) {
-        if (!ptr) [[unlikely]] return;
-
-        // Validate pointer is within pool range
-        const auto index = static_cast<size_t>(ptr - pool_);
-
-        assert(ptr >= pool_ && ptr < pool_ + capacity_ &&
-               "Pointer not from this pool");
-        assert(index < capacity_ &&
-               "Index out of range — pointer arithmetic error");
+        const uint32_t index = release_index(ptr);
+        if (index == detail::POOL_EMPTY) [[unlikely]] return;
 
-        // Runtime check (always, not just debug — security critical)
-        if (index >= capacity_) [[unlikely]] {
-            // Log and discard — better than corrupting the free list
+        if (Magazine* mag = magazine()) {
+            magazine_push(*mag, index);
             return;
         }
 
-#ifndef NDEBUG
-        // Debug: verify slot is currently owned (detect double-free)
-        uint32_t prev = owned_[index].exchange(0, std::memory_order_relaxed);
-        assert(prev == 1 && "Double-free detected — "
-               "slot was already free");
-        if (prev != 1) return;  // Graceful handling in release
-#endif
-
         // Push slot back onto free list
         uint64_t old_head = head_.load(std::memory_order_acquire);
 
@@ -278,8 +413,7 @@ public:
             next_[index] = head_index;
 
             // CAS: try to make this slot the new head
-            const uint64_t new_head =
-                detail::pack(static_cast<uint32_t>(index), gen + 1);
+            const uint64_t new_head = detail::pack(index, gen + 1);
 
             if (head_.compare_exchange_weak(old_head, new_head,
                     std::memory_order_acq_rel,
@@ -295,6 +429,41 @@ public:
         }
     }
 
+    /**
+     * Return `count` elements at once (same contract as deallocate()
+     * for each; null entries are skipped).
+     *
+     * Without magazines the slots are linked locally and pushed onto
+     * the stack in one CAS; with magazines they go to the caller's
+     * magazine, which spills a block per CAS as it fills. Either way
+     * the caller pays one shared-memory operation per batch instead of
+     * one per element.
+     */
+    void deallocate_bulk(T* const* ptrs, size_t count) {
+        Magazine* mag = magazine();
+        uint32_t first = detail::POOL_EMPTY;
+        uint32_t last  = detail::POOL_EMPTY;
+        size_t linked = 0;
+
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t index = release_index(ptrs[i]);
+            if (index == detail::POOL_EMPTY) [[unlikely]] continue;
+            if (mag) {
+                magazine_push(*mag, index);
+                continue;
+            }
+            next_[index] = first;
+            first = index;
+            if (last == detail::POOL_EMPTY) last = index;
+            ++linked;
+        }
+
+        if (linked != 0) {
+            push_linked(first, last);
+            allocated_.fetch_sub(linked, std::memory_order_relaxed);
+        }
+    }
+
     // ═══════════════════════════════════════════════════════
     //  Statistics (lock-free, eventually consistent)
     // ═══════════════════════════════════════════════════════
@@ -305,14 +474,23 @@ public:
         size_t available;        // Currently free (approx)
         size_t high_water_mark;  // Peak allocation
         double utilization;      // allocated / capacity
+        size_t cached;           // Free, held in thread magazines (part of available)
+        PageBacking pages;       // What backs the slot array
+        bool   locked;           // Slot array mlocked
     };
 
     /**
      * Get pool statistics. All values are eventually consistent.
      * Safe to call from any thread (monitoring).
+     *
+     * With magazines, allocated sums per-magazine counters that only
+     * their owner thread writes, so it stays exact once the threads are
+     * quiescent; high_water_mark is sampled at each magazine refill and
+     * here, so it can trail the true peak by what the magazines held.
      */
     [[nodiscard]] Stats get_stats() const {
-        const size_t alloc = allocated_.load(std::memory_order_relaxed);
+        const size_t alloc = allocated();
+        note_high_water(alloc);
         return Stats{
             .capacity        = capacity_,
             .allocated       = alloc,
@@ -320,22 +498,60 @@ public:
             .high_water_mark = high_water_.load(std::memory_order_relaxed),
             .utilization     = static_cast<double>(alloc) /
                                static_cast<double>(capacity_),
+            .cached          = cached(),
+            .pages           = pool_pages_.backing(),
+            .locked          = pool_pages_.locked(),
         };
     }
 
     /** Number of currently allocated elements */
     [[nodiscard]] size_t allocated() const {
-        return allocated_.load(std::memory_order_relaxed);
+        auto alloc = static_cast<int64_t>(allocated_.load(std::memory_order_relaxed));
+        if (magazine_block_ != 0) {
+            for (size_t i = 0; i < detail::POOL_MAX_MAGAZINES; ++i) {
+                alloc += magazines_[i].net_allocated.load(std::memory_order_relaxed);
+            }
+        }
+        return alloc > 0 ? static_cast<size_t>(alloc) : 0;
     }
 
     /** Number of currently free elements (approximate) */
     [[nodiscard]] size_t available() const {
-        return capacity_ - allocated_.load(std::memory_order_relaxed);
+        return capacity_ - allocated();
+    }
+
+    /** Free slots held in thread magazines (not allocatable by other threads) */
+    [[nodiscard]] size_t cached() const {
+        size_t held = 0;
+        if (magazine_block_ != 0) {
+            for (size_t i = 0; i < detail::POOL_MAX_MAGAZINES; ++i) {
+                held += magazines_[i].count.load(std::memory_order_relaxed);
+            }
+        }
+        return held;
     }
 
     /** Total pool capacity */
     [[nodiscard]] size_t capacity() const { return capacity_; }
 
+    /** Slots moved per magazine refill/spill (0 = no magazines) */
+    [[nodiscard]] size_t magazine_block() const { return magazine_block_; }
+
+    /** NUMA node the slots are bound to (-1 = not bound) */
+    [[nodiscard]] int numa_node() const { return pool_pages_.numa_node(); }
+
+    /**
+     * Give the slot array's pages back to the kernel; they come back
+     * zeroed when next touched. Only for trivially copyable T, and only
+     * while the caller holds every slot (allocated and not in use).
+     * @return false if the pages could not be released (e.g. mlocked)
+     */
+    bool release_pages() {
+        static_assert(std::is_trivially_copyable_v<T>,
+            "release_pages() zeroes slots: T must be trivially copyable");
+        return pool_pages_.release_pages();
+    }
+
     /**
      * Check if a pointer belongs to this pool.
      * Useful for debug assertions and error handling.
@@ -353,14 +569,47 @@ public:
         return static_cast<size_t>(ptr - pool_);
     }
 
+    /**
+     * 32-bit handle of a pool element (its index): half a pointer
+     * wherever elements are queued or indexed.
+     * @pre owns(ptr) must be true
+     */
+    [[nodiscard]] uint32_t handle(const T* ptr) const {
+        return static_cast<uint32_t>(index_of(ptr));
+    }
+
+    /** Element behind a handle. @pre handle < capacity() */
+    [[nodiscard]] T* at(uint32_t handle) const {
+        assert(handle < capacity_);
+        return &pool_[handle];
+    }
+
 private:
+    /**
+     * One thread's cache of free slots. Only the owner writes items,
+     * count and net_allocated (plain relaxed stores, no RMW); monitoring
+     * reads count and net_allocated.
+     */
+    struct alignas(detail::POOL_CACHE_LINE) Magazine {
+        std::atomic<bool>     claimed{false};
+        std::atomic<uint32_t> count{0};
+        std::atomic<int64_t>  net_allocated{0};  // allocate − deallocate through this magazine
+        uint32_t*             items{nullptr};    // 2 × magazine_block_ slot indices
+    };
+
     // ═══════════════════════════════════════════════════════
     //  READ-ONLY DATA (set once at construction)
     // ═══════════════════════════════════════════════════════
 
     const size_t capacity_;
+    PageRegion   pool_pages_;   // Storage of pool_
+    PageRegion   next_pages_;   // Storage of next_
     T* const     pool_;         // Pre-allocated element array (aligned)
     uint32_t*    next_;         // Free list links: next_[i] → next free slot
+    const size_t   magazine_block_;  // 0 = no magazines
+    const uint64_t id_;              // Never reused; keys thread bindings
+    std::unique_ptr<Magazine[]> magazines_;
+    std::unique_ptr<uint32_t[]> magazine_items_;
 
     // ═══════════════════════════════════════════════════════
     //  HOT DATA — accessed on every allocate/deallocate
@@ -381,8 +630,8 @@ private:
     // ═══════════════════════════════════════════════════════
 
     alignas(detail::POOL_CACHE_LINE)
-    std::atomic<size_t> allocated_{0};
-    std::atomic<size_t> high_water_{0};
+    std::atomic<size_t> allocated_{0};  // Through the stack; magazines count their own
+    mutable std::atomic<size_t> high_water_{0};
 
     // ═══════════════════════════════════════════════════════
     //  DEBUG-ONLY OWNERSHIP TRACKING
@@ -396,6 +645,147 @@ private:
     //  Internal Helpers
     // ═══════════════════════════════════════════════════════
 
+    [[nodiscard]] static size_t effective_block(size_t capacity, size_t requested) {
+        const size_t block = std::min({requested, detail::POOL_MAX_MAGAZINE_BLOCK,
+                                       capacity / detail::POOL_MAGAZINE_SHARE});
+        return block < detail::POOL_MIN_MAGAZINE_BLOCK ? 0 : block;
+    }
+
+    /**
+     * Validate an element being returned and release its ownership
+     * mark. @return its index, or POOL_EMPTY to discard it
+     */
+    uint32_t release_index(T* ptr) {
+        if (!ptr) [[unlikely]] return detail::POOL_EMPTY;
+
+        // Validate pointer is within pool range
+        const auto index = static_cast<size_t>(ptr - pool_);
+
+        assert(ptr >= pool_ && ptr < pool_ + capacity_ &&
+               "Pointer not from this pool");
+        assert(index < capacity_ &&
+               "Index out of range — pointer arithmetic error");
+
+        // Runtime check (always, not just debug — security critical)
+        if (index >= capacity_) [[unlikely]] {
+            // Log and discard — better than corrupting the free list
+            return detail::POOL_EMPTY;
+        }
+
+#ifndef NDEBUG
+        // Debug: verify slot is currently owned (detect double-free)
+        uint32_t prev = owned_[index].exchange(0, std::memory_order_relaxed);
+        assert(prev == 1 && "Double-free detected — "
+               "slot was already free");
+        if (prev != 1) return detail::POOL_EMPTY;  // Graceful handling in release
+#endif
+        return static_cast<uint32_t>(index);
+    }
+
+    // ─── Magazines ───
+
+    /** Cache a freed slot in the caller's magazine, spilling a block if it is full */
+    void magazine_push(Magazine& mag, uint32_t index) {
+        uint32_t count = mag.count.load(std::memory_order_relaxed);
+        if (count == 2 * magazine_block_) [[unlikely]] count = spill(mag, count);
+        mag.items[count] = index;
+        mag.count.store(count + 1, std::memory_order_relaxed);
+        mag.net_allocated.store(mag.net_allocated.load(std::memory_order_relaxed) - 1,
+                                std::memory_order_relaxed);
+    }
+
+    /** The calling thread's magazine, claimed on first use; nullptr = use the stack */
+    Magazine* magazine() {
+        if (magazine_block_ == 0) return nullptr;
+        auto& local = detail::ThreadMagazines::local();
+        if (const auto* binding = local.find(id_)) [[likely]] {
+            return static_cast<Magazine*>(binding->magazine);
+        }
+        return claim_magazine(local);
+    }
+
+    [[gnu::noinline]] Magazine* claim_magazine(detail::ThreadMagazines& local) {
+        Magazine* claimed = nullptr;
+        for (size_t i = 0; i < detail::POOL_MAX_MAGAZINES && !claimed; ++i) {
+            bool expected = false;
+            if (magazines_[i].claimed.compare_exchange_strong(expected, true,
+                                                               std::memory_order_acquire)) {
+                claimed = &magazines_[i];
+            }
+        }
+        // No free magazine: bind nullptr so this thread stays on the stack without rescanning
+        if (!local.bind({id_, this, claimed, &MemoryPool::release_magazine}) && claimed) {
+            claimed->claimed.store(false, std::memory_order_release);
+            return nullptr;
+        }
+        return claimed;
+    }
+
+    /** Thread exit: every cached slot back to the stack, the magazine free for another thread */
+    static void release_magazine(void* pool, void* magazine) {
+        auto& self = *static_cast<MemoryPool*>(pool);
+        auto& mag  = *static_cast<Magazine*>(magazine);
+        const uint32_t count = mag.count.load(std::memory_order_relaxed);
+        if (count != 0) self.push_chain(mag.items, count);
+        mag.count.store(0, std::memory_order_relaxed);
+        mag.claimed.store(false, std::memory_order_release);
+    }
+
+    /**
+     * Pop up to magazine_block_ slots off the stack in one CAS.
+     * The walk is only kept if head_ (and its generation) did not move.
+     * @return slots now in the magazine
+     */
+    uint32_t refill(Magazine& mag) {
+        uint64_t old_head = head_.load(std::memory_order_acquire);
+        for (;;) {
+            auto [index, gen] = detail::unpack(old_head);
+            if (index == detail::POOL_EMPTY) [[unlikely]] return 0;
+
+            uint32_t count = 0;
+            uint32_t cursor = index;
+            while (cursor != detail::POOL_EMPTY && count < magazine_block_) {
+                mag.items[count++] = cursor;
+                cursor = next_[cursor];
+            }
+            if (head_.compare_exchange_weak(old_head, detail::pack(cursor, gen + 1),
+                    std::memory_order_acq_rel,
+                    std::memory_order_acquire)) {
+                mag.count.store(count, std::memory_order_relaxed);
+                note_high_water(allocated() + 1);  // With the allocation in progress
+                return count;
+            }
+        }
+    }
+
+    /** Full magazine: its oldest magazine_block_ slots to the stack. @return slots left */
+    uint32_t spill(Magazine& mag, uint32_t count) {
+        push_chain(mag.items, static_cast<uint32_t>(magazine_block_));
+        const auto left = static_cast<uint32_t>(count - magazine_block_);
+        std::memmove(mag.items, mag.items + magazine_block_, left * sizeof(uint32_t));
+        return left;
+    }
+
+    /** Link `count` slots and push them onto the stack in one CAS */
+    void push_chain(const uint32_t* items, uint32_t count) {
+        for (uint32_t i = 0; i + 1 < count; ++i) next_[items[i]] = items[i + 1];
+        push_linked(items[0], items[count - 1]);
+    }
+
+    /** Push the chain first → … → tail (already linked through next_) in one CAS */
+    void push_linked(uint32_t first, uint32_t tail) {
+        uint64_t old_head = head_.load(std::memory_order_acquire);
+        for (;;) {
+            auto [head_index, gen] = detail::unpack(old_head);
+            next_[tail] = head_index;
+            if (head_.compare_exchange_weak(old_head, detail::pack(first, gen + 1),
+                    std::memory_order_acq_rel,
+                    std::memory_order_acquire)) {
+                return;
+            }
+        }
+    }
+
     /**
      * Validate capacity at construction.
      * Must be > 0 and fit in uint32_t (for tagged index).
@@ -420,8 +810,11 @@ private:
     void update_stats_allocate() {
         const size_t current =
             allocated_.fetch_add(1, std::memory_order_relaxed) + 1;
+        note_high_water(magazine_block_ == 0 ? current : allocated());
+    }
 
-        // Update high water mark (lock-free max)
+    /** Raise the high water mark to `current` (lock-free max) */
+    void note_high_water(size_t current) const {
         size_t hw = high_water_.load(std::memory_order_relaxed);
         while (current > hw) {
             if (high_water_.compare_exchange_weak(
@@ -436,10 +829,341 @@ private:
     }
 };
 
+// ═══════════════════════════════════════════════════════════════
+//  Segmented pool
+// ═══════════════════════════════════════════════════════════════
+
+namespace detail {
+inline constexpr size_t POOL_MAX_SEGMENTS = 64;
+} // namespace detail
+
+/**
+ * MemoryPools as segments behind the MemoryPool interface: one initial
+ * segment per NUMA node (each bound to its node), plus growth segments
+ * added while running.
+ *
+ *   allocate()   → the segment of the calling thread's node; then the
+ *                  segment that last had room; then the others in order
+ *   deallocate() → the segment owning the slot, whichever thread frees it
+ *
+ * The segment table is fixed (POOL_MAX_SEGMENTS entries, filled in
+ * order, never moved), so allocate()/deallocate()/at() stay lock-free
+ * and never see a reallocation: grow() builds the new segment off the
+ * hot path and publishes it with one release store of the count. A
+ * handle is [segment][slot], so at() is a shift and a mask; handle(),
+ * owns() and deallocate() walk the (few) segments' address ranges.
+ *
+ * Growth stops at max_capacity() (the constructor's max_slots), which
+ * is what anything holding one entry per live order must be sized from:
+ * capacity() is only where the pool stands now.
+ *
+ * Growth is not automatic. A background thread (Exchange's pool
+ * maintenance) calls grow() when available() falls below its low
+ * watermark, and may call release_idle_segments() to give an empty
+ * growth segment's pages back to the kernel (madvise): its slots stay
+ * parked, held by the pool, until the next grow() revives it before
+ * building anything new. Growth segments have no thread magazines, so
+ * an idle one really is empty and bulk frees into it are one CAS.
+ *
+ * A thread's node is looked up once, on its first allocate() from any
+ * SegmentedPool (getcpu), so hot threads must be pinned before they
+ * allocate: an unpinned thread keeps the node it first ran on.
+ *
+ * With no nodes and no growth (the default) it is a single unbound
+ * MemoryPool, and allocate()/deallocate() forward to it directly.
+ */
+template<typename T>
+class SegmentedPool {
+public:
+    using Stats = typename MemoryPool<T>::Stats;
+
+    /**
+     * @param capacity Initial slots, split evenly over the nodes
+     * @param magazine_block Per initial segment, see MemoryPool
+     * @param nodes NUMA nodes to build a segment on; empty = one unbound segment
+     * @param segment_slots Slots per growth segment; 0 = fixed size
+     * @param max_slots Growth stops before capacity() would pass it; 0 = when the segment table is full
+     * @throws std::invalid_argument if a node would get no slots
+     */
+    explicit SegmentedPool(size_t capacity, size_t magazine_block = 0,
+                           const std::vector<int>& nodes = {}, size_t segment_slots = 0,
+                           size_t max_slots = 0)
+        : nodes_(nodes)
+        , segment_slots_(segment_slots) {
+        const size_t count = std::max<size_t>(nodes.size(), 1);
+        if (count > detail::POOL_MAX_SEGMENTS) throw std::invalid_argument("SegmentedPool: too many nodes");
+        size_t largest = segment_slots;
+        for (size_t i = 0; i < count; ++i) {
+            const size_t share = capacity / count + (i < capacity % count ? 1 : 0);
+            const int node = nodes.empty() ? -1 : nodes[i];
+            segments_[i] = std::make_unique<MemoryPool<T>>(share, magazine_block, node);
+            largest = std::max(largest, share);
+            if (node >= 0) {
+                if (segment_of_node_.size() <= static_cast<size_t>(node)) segment_of_node_.resize(node + 1, 0);
+                segment_of_node_[node] = static_cast<uint32_t>(i);
+            }
+        }
+        initial_segments_ = count;
+        segment_count_.store(count, std::memory_order_release);
+
+        // [segment][slot] must fit a 32-bit handle
+        while ((size_t{1} << shift_) < largest) ++shift_;
+        max_segments_ = shift_ >= 32 ? 1 : std::min(detail::POOL_MAX_SEGMENTS, size_t{1} << (32 - shift_));
+        if (max_segments_ < count) throw std::invalid_argument("SegmentedPool: too many slots per segment");
+        if (segment_slots == 0) {
+            max_segments_ = count;
+        } else if (max_slots != 0) {
+            const size_t growth = max_slots > capacity ? (max_slots - capacity) / segment_slots : 0;
+            max_segments_ = std::min(max_segments_, count + growth);
+        }
+        max_capacity_ = capacity + (max_segments_ - count) * segment_slots;
+    }
+
+    SegmentedPool(const SegmentedPool&) = delete;
+    SegmentedPool& operator=(const SegmentedPool&) = delete;
+
+    /** @return a slot, preferably on the caller's node; nullptr if every segment is exhausted */
+    [[nodiscard]] T* allocate() {
+        const size_t count = segment_count_.load(std::memory_order_acquire);
+        if (count == 1) [[likely]] return segments_[0]->allocate();
+
+        const size_t home = local_segment();
+        if (T* slot = segments_[home]->allocate()) [[likely]] return slot;
+        const size_t hint = hint_.load(std::memory_order_relaxed);
+        if (hint < count && hint != home) {
+            if (T* slot = segments_[hint]->allocate()) return slot;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (i == home || i == hint) continue;
+            if (T* slot = segments_[i]->allocate()) {
+                hint_.store(i, std::memory_order_relaxed);
+                return slot;
+            }
+        }
+        return nullptr;
+    }
+
+    /** Back to the segment the slot came from */
+    void deallocate(T* ptr) {
+        if (MemoryPool<T>* home = segment_of(ptr)) [[likely]] {
+            home->deallocate(ptr);
+            return;
+        }
+        assert(!ptr && "Pointer not from this pool");
+    }
+
+    /** Each slot back to its segment; runs from one segment go in one bulk push */
+    void deallocate_bulk(T* const* ptrs, size_t count) {
+        if (segment_count_.load(std::memory_order_acquire) == 1) [[likely]] {
+            segments_[0]->deallocate_bulk(ptrs, count);
+            return;
+        }
+        size_t run = 0;
+        while (run < count) {
+            MemoryPool<T>* home = segment_of(ptrs[run]);
+            if (!home) [[unlikely]] {  // Null or foreign: discarded, as by deallocate()
+                ++run;
+                continue;
+            }
+            size_t end = run + 1;
+            while (end < count && home->owns(ptrs[end])) ++end;
+            home->deallocate_bulk(ptrs + run, end - run);
+            run = end;
+        }
+    }
+
+    // ═══════════════════════════════════════════════════════
+    //  Growth — background thread only, never the hot path
+    // ═══════════════════════════════════════════════════════
+
+    /**
+     * Add segment_slots() slots: revive a released segment if there is
+     * one, else build a new segment (on the nodes in turn) and publish it.
+     * @return false if growth is off, the table is full, or memory ran out
+     */
+    bool grow() {
+        std::lock_guard<std::mutex> lock(grow_mutex_);
+        const size_t count = segment_count_.load(std::memory_order_relaxed);
+        for (size_t i = initial_segments_; i < count; ++i) {
+            auto& parked = parked_[i];
+            if (parked.empty()) continue;
+            segments_[i]->deallocate_bulk(parked.data(), parked.size());
+            parked_slots_.fetch_sub(parked.size(), std::memory_order_relaxed);
+            parked.clear();
+            return true;
+        }
+        if (segment_slots_ == 0 || count == max_segments_) return false;
+
+        const int node = nodes_.empty() ? -1 : nodes_[(count - initial_segments_) % nodes_.size()];
+        try {
+            segments_[count] = std::make_unique<MemoryPool<T>>(segment_slots_, 0, node);
+        } catch (const std::bad_alloc&) {
+            return false;
+        }
+        segment_count_.store(count + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Give the pages of every empty growth segment back to the kernel.
+     * A segment counts as empty only if this thread can take all of its
+     * slots; they then stay parked until grow() revives the segment.
+     * @return segments released
+     */
+    size_t release_idle_segments() {
+        if constexpr (!std::is_trivially_copyable_v<T>) {
+            return 0;
+        } else {
+            std::lock_guard<std::mutex> lock(grow_mutex_);
+            size_t released = 0;
+            const size_t count = segment_count_.load(std::memory_order_relaxed);
+            for (size_t i = initial_segments_; i < count; ++i) {
+                MemoryPool<T>& segment = *segments_[i];
+                auto& parked = parked_[i];
+                if (!parked.empty() || segment.allocated() != 0) continue;
+
+                parked.reserve(segment.capacity());
+                while (T* slot = segment.allocate()) parked.push_back(slot);
+                if (parked.size() == segment.capacity() && segment.release_pages()) {
+                    parked_slots_.fetch_add(parked.size(), std::memory_order_relaxed);
+                    ++released;
+                } else {  // Raced with an allocation, or the pages are locked
+                    segment.deallocate_bulk(parked.data(), parked.size());
+                    parked.clear();
+                }
+            }
+            return released;
+        }
+    }
+
+    // ═══════════════════════════════════════════════════════
+    //  Introspection
+    // ═══════════════════════════════════════════════════════
+
+    /**
+     * Totals over the segments, less parked slots. high_water_mark sums
+     * each segment's own peak, so it can exceed the true combined peak;
+     * pages and locked are those of the first segment.
+     */
+    [[nodiscard]] Stats get_stats() const {
+        Stats total = segments_[0]->get_stats();
+        const size_t count = segment_count_.load(std::memory_order_acquire);
+        for (size_t i = 1; i < count; ++i) {
+            const Stats s = segments_[i]->get_stats();
+            total.capacity        += s.capacity;
+            total.allocated       += s.allocated;
+            total.available       += s.available;
+            total.high_water_mark += s.high_water_mark;
+            total.cached          += s.cached;
+            total.locked           = total.locked && s.locked;
+        }
+        const size_t parked = parked_slots_.load(std::memory_order_relaxed);
+        total.capacity  -= parked;
+        total.allocated -= std::min(parked, total.allocated);
+        total.utilization = total.capacity == 0 ? 0.0 :
+            static_cast<double>(total.allocated) / static_cast<double>(total.capacity);
+        return total;
+    }
+
+    [[nodiscard]] size_t allocated() const {
+        const size_t total = sum(&MemoryPool<T>::allocated);
+        return total - std::min(total, parked_slots_.load(std::memory_order_relaxed));
+    }
+    [[nodiscard]] size_t available() const { return sum(&MemoryPool<T>::available); }
+    [[nodiscard]] size_t cached() const { return sum(&MemoryPool<T>::cached); }
+    [[nodiscard]] size_t capacity() const {
+        return sum(&MemoryPool<T>::capacity) - parked_slots_.load(std::memory_order_relaxed);
+    }
+    /** capacity() once grown as far as it may: size per-live-order tables from this */
+    [[nodiscard]] size_t max_capacity() const { return max_capacity_; }
+
+    /** Magazine block of the initial segments (they share the setting; smaller ones may cap it) */
+    [[nodiscard]] size_t magazine_block() const { return segments_[0]->magazine_block(); }
+
+    /** Segments built at construction, one per NUMA node (or one) */
+    [[nodiscard]] size_t initial_segments() const { return initial_segments_; }
+
+    /** Handles of the initial segments' slots are all below this; growth segments' are above */
+    [[nodiscard]] size_t initial_handles() const {
+        const size_t last = initial_segments_ - 1;
+        return (last << shift_) + segments_[last]->capacity();
+    }
+
+    /** Slots per growth segment (0 = fixed size) */
+    [[nodiscard]] size_t segment_slots() const { return segment_slots_; }
+
+    /** Slots parked in released growth segments (not counted in capacity()) */
+    [[nodiscard]] size_t parked() const { return parked_slots_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] bool owns(const T* ptr) const { return segment_of(ptr) != nullptr; }
+
+    /** Slot number across all segments (its handle). @pre owns(ptr) must be true */
+    [[nodiscard]] size_t index_of(const T* ptr) const { return handle(ptr); }
+
+    /** 32-bit handle of a slot: [segment][slot]. @pre owns(ptr) must be true */
+    [[nodiscard]] uint32_t handle(const T* ptr) const {
+        const size_t count = segment_count_.load(std::memory_order_acquire);
+        if (count == 1) [[likely]] return segments_[0]->handle(ptr);
+        for (size_t i = 0; i < count; ++i) {
+            if (segments_[i]->owns(ptr)) {
+                return static_cast<uint32_t>((i << shift_) | segments_[i]->index_of(ptr));
+            }
+        }
+        assert(false && "Pointer not from this pool");
+        return detail::POOL_EMPTY;
+    }
+
+    /** Slot behind a handle. @pre handle came from handle() */
+    [[nodiscard]] T* at(uint32_t handle) const {
+        return segments_[handle >> shift_]->at(handle & ((uint32_t{1} << shift_) - 1));
+    }
+
+    /** Segments: the initial ones in the order of the constructor's nodes, then growth */
+    [[nodiscard]] size_t segments() const { return segment_count_.load(std::memory_order_acquire); }
+    [[nodiscard]] const MemoryPool<T>& segment(size_t i) const { return *segments_[i]; }
+
+private:
+    /** The calling thread's initial segment (unknown nodes use the first) */
+    [[nodiscard]] size_t local_segment() const {
+        thread_local const int node = current_numa_node();
+        return static_cast<size_t>(node) < segment_of_node_.size() ? segment_of_node_[node] : 0;
+    }
+
+    [[nodiscard]] MemoryPool<T>* segment_of(const T* ptr) const {
+        const size_t count = segment_count_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            if (segments_[i]->owns(ptr)) return segments_[i].get();
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] size_t sum(size_t (MemoryPool<T>::*stat)() const) const {
+        size_t total = 0;
+        const size_t count = segment_count_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) total += ((*segments_[i]).*stat)();
+        return total;
+    }
+
+    std::array<std::unique_ptr<MemoryPool<T>>, detail::POOL_MAX_SEGMENTS> segments_{};
+    std::atomic<size_t>   segment_count_{0};   // Published after the segment is built
+    std::atomic<size_t>   hint_{0};            // Last segment allocate() found room in
+    std::atomic<size_t>   parked_slots_{0};
+    size_t                initial_segments_{1};
+    size_t                max_segments_{detail::POOL_MAX_SEGMENTS};
+    size_t                max_capacity_{0};
+    uint32_t              shift_{0};           // Handle bits of the slot within its segment
+    std::vector<int>      nodes_;
+    size_t                segment_slots_;
+    std::vector<uint32_t> segment_of_node_;    // NUMA node → initial segment
+
+    std::mutex grow_mutex_;                    // grow() / release_idle_segments()
+    std::array<std::vector<T*>, detail::POOL_MAX_SEGMENTS> parked_{};
+};
+
 // ═══════════════════════════════════════════════════════════════
 //  Type Alias
 // ═══════════════════════════════════════════════════════════════
 
-using OrderPool = MemoryPool<Order>;
+using OrderPool = SegmentedPool<Order>;
 
-} // namespace rtes
\ No newline at end of file
+} // namespace rtes
@@ -1,61 +1,167 @@
 #pragma once
 
+/**
+ * @file metrics.hpp
+ * @brief Prometheus counters and histograms with lock-free, per-thread sharded updates
+ *
+ * Resolve a metric once (MetricsRegistry::get_counter / get_histogram,
+ * which take the registry lock) and keep the pointer: updating it never
+ * locks or allocates.
+ *
+ * Each metric keeps METRIC_SHARDS cache-line-aligned copies of its
+ * cells. A thread is given a shard of its own on its first update and
+ * writes it with plain load + store, so threads never share a line.
+ * Threads beyond the first METRIC_SHARDS - 1 share the last shard, which
+ * is updated with atomic adds instead. Readers (the scrape) add the
+ * shards up; a read racing an update may miss that update.
+ */
+
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include <mutex>
 
 namespace rtes {
 
+inline constexpr size_t METRIC_SHARDS = 32;
+
+namespace detail {
+
+inline constexpr size_t METRIC_SHARED_SHARD = METRIC_SHARDS - 1;
+
+inline std::atomic<size_t> next_metric_shard{0};
+
+/** The calling thread's shard: its own below METRIC_SHARED_SHARD, else the shared one */
+inline size_t metric_shard() {
+    thread_local const size_t shard =
+        std::min(next_metric_shard.fetch_add(1, std::memory_order_relaxed), METRIC_SHARED_SHARD);
+    return shard;
+}
+
+inline void metric_add(std::atomic<uint64_t>& cell, uint64_t value, size_t shard) {
+    if (shard != METRIC_SHARED_SHARD) [[likely]] {
+        cell.store(cell.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    } else {
+        cell.fetch_add(value, std::memory_order_relaxed);
+    }
+}
+
+/** Adds to a double kept as its bit pattern */
+inline void metric_add(std::atomic<uint64_t>& cell, double value, size_t shard) {
+    uint64_t bits = cell.load(std::memory_order_relaxed);
+    if (shard != METRIC_SHARED_SHARD) [[likely]] {
+        cell.store(std::bit_cast<uint64_t>(std::bit_cast<double>(bits) + value), std::memory_order_relaxed);
+        return;
+    }
+    while (!cell.compare_exchange_weak(bits, std::bit_cast<uint64_t>(std::bit_cast<double>(bits) + value),
+                                       std::memory_order_relaxed)) {}
+}
+
+struct alignas(64) MetricLine {
+    std::atomic<uint64_t> cells[8]{};
+};
+
+} // namespace detail
+
+/** Ordered label pairs, rendered once at registration: {k1="v1",k2="v2"} */
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
 class Counter {
 public:
-    void increment(uint64_t value = 1) { value_.fetch_add(value, std::memory_order_relaxed); }
-    uint64_t get() const { return value_.load(std::memory_order_relaxed); }
-    void reset() { value_.store(0, std::memory_order_relaxed); }
+    void increment(uint64_t value = 1) {
+        const size_t shard = detail::metric_shard();
+        detail::metric_add(shards_[shard].cells[0], value, shard);
+    }
+
+    uint64_t get() const {
+        uint64_t total = 0;
+        for (const auto& line : shards_) total += line.cells[0].load(std::memory_order_relaxed);
+        return total;
+    }
+
+    /** Not synchronized with concurrent increments */
+    void reset() {
+        for (auto& line : shards_) line.cells[0].store(0, std::memory_order_relaxed);
+    }
 
 private:
-    std::atomic<uint64_t> value_{0};
+    std::array<detail::MetricLine, METRIC_SHARDS> shards_;
 };
 
 class Histogram {
 public:
     explicit Histogram(const std::vector<double>& buckets);
-    
-    void observe(double value);
-    std::string get_prometheus_output(const std::string& name) const;
-    
+
+    /** Lock-free: one bucket search and two plain adds on this thread's shard */
+    void observe(double value) {
+        const size_t bucket = static_cast<size_t>(
+            std::lower_bound(buckets_.begin(), buckets_.end(), value) - buckets_.begin());
+        const size_t shard = detail::metric_shard();
+        detail::metric_add(cell(shard, SUM_CELL), value, shard);
+        detail::metric_add(cell(shard, FIRST_BUCKET_CELL + bucket), uint64_t{1}, shard);
+    }
+
+    /** @param name Metric name; @param labels Rendered label pairs without braces ("" = none) */
+    std::string get_prometheus_output(const std::string& name, const std::string& labels = {}) const;
+
     struct Stats {
         uint64_t count;
         double sum;
-        std::vector<uint64_t> bucket_counts;
+        std::vector<uint64_t> bucket_counts;  // Per bucket (not cumulative), +Inf last
     };
-    
+
+    /** Sum over the shards */
     Stats get_stats() const;
 
 private:
-    std::vector<double> buckets_;
-    mutable std::mutex mutex_;
-    uint64_t count_{0};
-    double sum_{0.0};
-    std::vector<uint64_t> bucket_counts_;
+    static constexpr size_t SUM_CELL          = 0;  // Double, as bits
+    static constexpr size_t FIRST_BUCKET_CELL = 1;
+
+    std::atomic<uint64_t>& cell(size_t shard, size_t index) const {
+        return lines_[shard * lines_per_shard_ + index / 8].cells[index % 8];
+    }
+
+    std::vector<double> buckets_;  // Upper bounds, ascending; +Inf implied
+    size_t lines_per_shard_;
+    std::unique_ptr<detail::MetricLine[]> lines_;  // Shard s: [s * lines_per_shard_, +lines_per_shard_)
 };
 
 class MetricsRegistry {
 public:
     static MetricsRegistry& instance();
-    
-    Counter* get_counter(const std::string& name);
-    Histogram* get_histogram(const std::string& name, const std::vector<double>& buckets = {});
-    
+
+    /**
+     * Find or create a series. Takes the registry lock: call at setup and
+     * keep the pointer, which stays valid for the process lifetime.
+     */
+    Counter* get_counter(const std::string& name, const MetricLabels& labels = {});
+    Histogram* get_histogram(const std::string& name, const std::vector<double>& buckets = {},
+                             const MetricLabels& labels = {});
+
+    /** Scrape: aggregates every series' shards */
     std::string get_prometheus_output() const;
 
 private:
-    mutable std::mutex mutex_;
-    std::unordered_map<std::string, std::unique_ptr<Counter>> counters_;
-    std::unordered_map<std::string, std::unique_ptr<Histogram>> histograms_;
-    
+    struct HistogramSeries {
+        std::string                name;
+        std::string                labels;  // Rendered, without braces
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    mutable std::mutex mutex_;  // Registration and scrape only, never updates
+    std::unordered_map<std::string, std::unique_ptr<Counter>> counters_;  // Keyed by name{labels}
+    std::unordered_map<std::string, HistogramSeries>          histograms_;
+
+    static std::string render_labels(const MetricLabels& labels);
     static std::vector<double> default_latency_buckets();
 };
 
@@ -64,4 +170,4 @@ private:
 #define METRICS_HISTOGRAM(name, buckets) rtes::MetricsRegistry::instance().get_histogram(name, buckets)
 #define METRICS_LATENCY_HISTOGRAM(name) rtes::MetricsRegistry::instance().get_histogram(name)
 
-} // namespace rtes
\ No newline at end of file
+} // namespace rtes
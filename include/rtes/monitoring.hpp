@@ -3,6 +3,7 @@
 #include "rtes/http_server.hpp"
 #include "rtes/metrics.hpp"
 #include "rtes/exchange.hpp"
+#include "rtes/udp_publisher.hpp"
 #include <thread>
 #include <atomic>
 #include <chrono>
@@ -11,7 +12,13 @@ namespace rtes {
 
 class MonitoringService {
 public:
-    explicit MonitoringService(uint16_t port, Exchange* exchange);
+    /**
+     * @param metrics_refresh  /metrics is rendered this often and served from cache (0 = per scrape)
+     * @param dashboard_stream /events pushes dashboard deltas this often (0 = no stream)
+     */
+    MonitoringService(uint16_t port, Exchange* exchange,
+                      std::chrono::milliseconds metrics_refresh = std::chrono::milliseconds(1000),
+                      std::chrono::milliseconds dashboard_stream = std::chrono::milliseconds(1000));
     ~MonitoringService();
     
     void start();
@@ -22,11 +29,40 @@ public:
     void record_trade_executed();
     void record_order_rejected();
 
+    /** HTTP and collection threads. Call before start(). */
+    void set_thread_placement(const ThreadPlacement& placement) {
+        placement_ = placement;
+        http_server_->set_thread_placement(placement);
+    }
+
+    /** Export the publisher's match-to-publish delay histogram. Call before start(). */
+    void add_market_data_publisher(const UdpPublisher* publisher) { publishers_.push_back(publisher); }
+
+    /**
+     * Serve POST /reload/risk: re-read `config_path` and publish its risk
+     * section and symbol collars to every risk shard (RiskManager::
+     * update_limits), without a restart. Needs a bearer token allowed
+     * "config_reload" (admin). Call before start().
+     */
+    void enable_risk_reload(std::string config_path);
+
+    /**
+     * Serve GET /symbols (every instrument and its state) and
+     * POST /symbols/{list,halt,resume}?symbol=X (Exchange::list_symbol,
+     * ...), the latter with an admin bearer token as /reload/risk.
+     * Call before start().
+     */
+    void enable_symbol_control();
+
 private:
     uint16_t port_;
     Exchange* exchange_;
+    std::chrono::milliseconds metrics_refresh_;
+    std::chrono::milliseconds dashboard_stream_;
+    ThreadPlacement placement_;
     
     std::unique_ptr<HttpServer> http_server_;
+    std::string risk_reload_path_;
     std::thread metrics_thread_;
     std::atomic<bool> running_{false};
     
@@ -38,6 +74,8 @@ private:
     Counter* udp_messages_;
     Histogram* order_latency_;
     Histogram* queue_depth_;
+
+    std::vector<const UdpPublisher*> publishers_;
     
     void setup_http_handlers();
     void metrics_collection_loop();
@@ -46,8 +84,17 @@ private:
     std::string handle_metrics(const std::string& path, const std::string& query);
     std::string handle_health(const std::string& path, const std::string& query);
     std::string handle_ready(const std::string& path, const std::string& query);
+    std::string handle_risk_reload(const std::string& path, const std::string& query);
+    std::string handle_symbol_control(const std::string& path, const std::string& query);
     
+    /** One /events sample: exchange, engine and lane counters, queue depths, stage percentiles */
+    HttpEventFields dashboard_fields() const;
+
     void collect_system_metrics();
+    std::string market_data_delay_output() const;
+    std::string queue_telemetry_output() const;
+    std::string book_schedule_output() const;
+    std::string order_trace_output() const;
 };
 
 } // namespace rtes
\ No newline at end of file
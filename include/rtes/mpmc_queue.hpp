@@ -35,12 +35,21 @@
  *      producers claiming adjacent positions.
  *
  *   3. ALIGNED BUFFER
- *      Buffer allocated with cache-line alignment via aligned_alloc.
+ *      Buffer is a cache-line-aligned PageRegion (huge pages / THP /
+ *      heap per the process page policy, see huge_pages.hpp).
  *
  *   4. PAUSE ON CAS FAILURE
  *      _mm_pause() after failed CAS reduces cache-line contention
  *      and yields resources to hyperthread sibling.
  *
+ *   5. BULK PUSH/POP
+ *      try_push_bulk()/try_pop_bulk() scan ahead for a run of ready
+ *      cells and claim it with one CAS on the position counter.
+ *
+ *   6. OPT-IN TELEMETRY
+ *      enable_telemetry() samples depth and residence time on 1 in N
+ *      positions, as in SPSCQueue (see queue_telemetry.hpp).
+ *
  * Memory ordering (minimal):
  *   - Cell sequence: acquire on read (sync with writer), release on write
  *   - Position CAS: relaxed (only claims position; sync via sequence)
@@ -55,9 +64,13 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <new>
 #include <type_traits>
 
+#include "rtes/huge_pages.hpp"
+#include "rtes/queue_telemetry.hpp"
+
 #ifdef __x86_64__
 #include <immintrin.h>
 #endif
@@ -101,7 +114,8 @@ public:
     explicit MPMCQueue(size_t min_capacity)
         : capacity_(detail::round_up_pow2(min_capacity))
         , mask_(capacity_ - 1)
-        , buffer_(allocate_buffer(capacity_))
+        , pages_(capacity_ * sizeof(Cell))
+        , buffer_(static_cast<Cell*>(pages_.data()))
     {
         assert(capacity_ >= min_capacity);
         assert((capacity_ & mask_) == 0);
@@ -116,16 +130,23 @@ public:
         dequeue_pos_.store(0, std::memory_order_relaxed);
     }
 
-    ~MPMCQueue() {
-        std::free(buffer_);
-    }
-
     // Non-copyable, non-movable (shared between threads)
     MPMCQueue(const MPMCQueue&) = delete;
     MPMCQueue& operator=(const MPMCQueue&) = delete;
     MPMCQueue(MPMCQueue&&) = delete;
     MPMCQueue& operator=(MPMCQueue&&) = delete;
 
+    /**
+     * Sample depth and residence time on one position in `sample_every`
+     * (0 = off). Call before any producer or consumer starts.
+     */
+    void enable_telemetry(size_t sample_every) {
+        probe_ = sample_every ? std::make_unique<QueueProbe>(capacity_, sample_every) : nullptr;
+    }
+
+    /** Zeroed when telemetry is off */
+    [[nodiscard]] QueueTelemetry telemetry() const { return probe_ ? probe_->snapshot() : QueueTelemetry{}; }
+
     // ═══════════════════════════════════════════════════════
     //  Producer API (thread-safe, multiple producers allowed)
     // ═══════════════════════════════════════════════════════
@@ -176,6 +197,7 @@ public:
 
         // We own this cell — write data
         cell->data = item;
+        if (probe_) [[unlikely]] probe_push(pos, 1);
 
         // Publish: advance sequence to signal consumer that data is ready
         // Release ensures data write is visible before sequence update
@@ -210,10 +232,51 @@ public:
         }
 
         cell->data = std::move(item);
+        if (probe_) [[unlikely]] probe_push(pos, 1);
         cell->sequence.store(pos + 1, std::memory_order_release);
         return true;
     }
 
+    /**
+     * Push up to `count` elements into a contiguous run of cells
+     * claimed with one CAS on enqueue_pos_.
+     *
+     * Scans ahead from the current position while cells are writable,
+     * then claims the whole run. Each cell's sequence is still published
+     * individually — it is what consumers synchronize on.
+     *
+     * @return Number pushed, a prefix of items (0 if full)
+     */
+    [[nodiscard]] size_t try_push_bulk(const T* items, size_t count) {
+        if (count == 0) return 0;
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        size_t n;
+
+        for (;;) {
+            const intptr_t diff = cell_lag(pos, 0);
+            if (diff < 0) return 0;  // Full
+            if (diff > 0) {          // Another producer claimed it — reload
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+                pause();
+                continue;
+            }
+            n = 1;
+            while (n < count && cell_lag(pos + n, 0) == 0) ++n;
+            if (enqueue_pos_.compare_exchange_weak(
+                    pos, pos + n, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        if (probe_) [[unlikely]] probe_push(pos, n);
+        for (size_t i = 0; i < n; ++i) {
+            Cell& cell = buffer_[(pos + i) & mask_];
+            cell.data = items[i];
+            cell.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return n;
+    }
+
     // ═══════════════════════════════════════════════════════
     //  Consumer API (thread-safe, multiple consumers allowed)
     // ═══════════════════════════════════════════════════════
@@ -262,6 +325,7 @@ public:
 
         // We own this cell — read data
         item = cell->data;
+        if (probe_) [[unlikely]] probe_->on_pop(pos, 1);
 
         // Recycle: advance sequence by capacity so producer can reuse
         // Release ensures read is complete before cell becomes writable
@@ -269,6 +333,47 @@ public:
         return true;
     }
 
+    /**
+     * Pop up to `max` elements from a contiguous run of ready cells
+     * claimed with one CAS on dequeue_pos_.
+     *
+     * The run ends at the first cell a producer has not published yet,
+     * so FIFO order is preserved. Cells are recycled one by one as
+     * they are copied out.
+     *
+     * @param[out] out  Receives elements in FIFO order (room for max)
+     * @return Number popped (0 if empty)
+     */
+    [[nodiscard]] size_t try_pop_bulk(T* out, size_t max) {
+        if (max == 0) return 0;
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        size_t n;
+
+        for (;;) {
+            const intptr_t diff = cell_lag(pos, 1);
+            if (diff < 0) return 0;  // Empty
+            if (diff > 0) {          // Another consumer claimed it — reload
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+                pause();
+                continue;
+            }
+            n = 1;
+            while (n < max && cell_lag(pos + n, 1) == 0) ++n;
+            if (dequeue_pos_.compare_exchange_weak(
+                    pos, pos + n, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        if (probe_) [[unlikely]] probe_->on_pop(pos, n);
+        for (size_t i = 0; i < n; ++i) {
+            Cell& cell = buffer_[(pos + i) & mask_];
+            out[i] = cell.data;
+            cell.sequence.store(pos + i + capacity_, std::memory_order_release);
+        }
+        return n;
+    }
+
     // ═══════════════════════════════════════════════════════
     //  Monitoring API (approximate, for diagnostics only)
     // ═══════════════════════════════════════════════════════
@@ -298,6 +403,9 @@ public:
     /** Total queue capacity (power of 2). */
     [[nodiscard]] size_t capacity() const { return capacity_; }
 
+    /** What backs the buffer (huge pages, THP or heap). */
+    [[nodiscard]] PageBacking page_backing() const { return pages_.backing(); }
+
 private:
     // ═══════════════════════════════════════════════════════
     //  Cell — cache-line padded to eliminate false sharing
@@ -332,7 +440,9 @@ private:
 
     const size_t capacity_;     // Power of 2
     const size_t mask_;         // capacity_ - 1 (bitmask for indexing)
-    Cell* const  buffer_;       // Cache-line-aligned heap allocation
+    PageRegion   pages_;        // Zeroed, cache-line aligned
+    Cell* const  buffer_;
+    std::unique_ptr<QueueProbe> probe_;  // Telemetry; nullptr = off
 
     // ═══════════════════════════════════════════════════════
     //  Producer position — own cache line
@@ -353,23 +463,20 @@ private:
     // ═══════════════════════════════════════════════════════
 
     /**
-     * Allocate cache-line-aligned buffer for Cell array.
+     * Cell state relative to position `pos` (acquire on the sequence):
+     * 0 = expected state (writable for offset 0, readable for offset 1),
+     * < 0 = not there yet (full / empty), > 0 = already taken.
      */
-    [[nodiscard]] static Cell* allocate_buffer(size_t cap) {
-        const size_t bytes = cap * sizeof(Cell);
-
-        // std::aligned_alloc requires size to be a multiple of alignment
-        // Since sizeof(Cell) is a multiple of CACHE_LINE (due to alignas),
-        // bytes is already a multiple of CACHE_LINE.
-        static_assert(sizeof(Cell) % detail::CACHE_LINE == 0);
-
-        void* ptr = std::aligned_alloc(detail::CACHE_LINE, bytes);
-        if (!ptr) throw std::bad_alloc();
-
-        // Zero-initialize all cells (safe for trivially copyable T)
-        std::memset(ptr, 0, bytes);
+    [[nodiscard]] intptr_t cell_lag(size_t pos, size_t offset) const {
+        const size_t seq = buffer_[pos & mask_].sequence.load(std::memory_order_acquire);
+        return static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + offset);
+    }
 
-        return static_cast<Cell*>(ptr);
+    /** Telemetry: the dequeue position is read only when the run holds a sampled position */
+    void probe_push(size_t pos, size_t n) {
+        if (!probe_->hits(pos, n)) return;
+        const size_t queued = pos - dequeue_pos_.load(std::memory_order_relaxed);
+        probe_->on_push(pos, n, queued <= capacity_ ? queued : 0);
     }
 
     // ═══════════════════════════════════════════════════════
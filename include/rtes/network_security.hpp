@@ -2,6 +2,7 @@
 
 #include "rtes/error_handling.hpp"
 #include "rtes/memory_safety.hpp"
+#include "rtes/token_bucket.hpp"
 #ifndef RTES_NO_OPENSSL
 #include <openssl/ssl.h>
 #include <openssl/hmac.h>
@@ -26,7 +27,8 @@ struct SecurityConfig {
     bool require_client_certs = true;
 };
 
-// Rate limiter with token bucket algorithm
+// Rate limiter with token bucket algorithm: max_tokens per refill_interval,
+// refilled continuously (see token_bucket.hpp)
 class RateLimiter {
 public:
     RateLimiter(uint32_t max_tokens, std::chrono::milliseconds refill_interval);
@@ -36,17 +38,9 @@ public:
     size_t active_clients() const;
     
 private:
-    struct TokenBucket {
-        uint32_t tokens;
-        std::chrono::steady_clock::time_point last_refill;
-    };
-    
-    uint32_t max_tokens_;
-    std::chrono::milliseconds refill_interval_;
+    TokenBucketLimit limit_;
     mutable std::mutex mutex_;
     std::unordered_map<std::string, TokenBucket> buckets_;
-    
-    void refill_bucket(TokenBucket& bucket);
 };
 
 // TLS/SSL secure TCP channel
@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * @file numa.hpp
+ * @brief NUMA topology and memory placement over sysfs and the raw syscalls (no libnuma)
+ *
+ * Just what the per-node order pools need: which nodes are online,
+ * which node a CPU (or the calling thread) is on, and mbind() of a
+ * mapped range to one node. On a single-node machine, or a non-Linux
+ * build, everything reports node 0 and binding is a no-op failure.
+ */
+
+#include <cstddef>
+#include <vector>
+
+namespace rtes {
+
+/** Online nodes from /sys/devices/system/node/online; {0} when unknown */
+[[nodiscard]] std::vector<int> numa_online_nodes();
+
+/** Node of `cpu`, -1 if unknown */
+[[nodiscard]] int numa_node_of_cpu(int cpu);
+
+/** Node the calling thread is running on now (getcpu); 0 if unknown */
+[[nodiscard]] int current_numa_node();
+
+/**
+ * Prefer `node` for the pages of [addr, addr + length) not faulted in
+ * yet (mbind, MPOL_PREFERRED: a full node spills to the others instead
+ * of failing the fault). `addr` must be page-aligned.
+ * @return false (errno set) if not supported
+ */
+bool bind_to_numa_node(void* addr, size_t length, int node);
+
+} // namespace rtes
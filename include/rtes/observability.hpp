@@ -2,6 +2,11 @@
 
 #include "rtes/thread_safety.hpp"
 #include "rtes/logger.hpp"
+#include "rtes/performance_optimizer.hpp"
+#include "rtes/streaming_stats.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -71,7 +76,8 @@ private:
     std::unordered_map<std::string, std::vector<MetricValue>> histograms_ GUARDED_BY(metrics_mutex_);
 };
 
-// Distributed tracing
+// Distributed tracing (allocates per span and keeps every trace: debugging
+// only; production order tracing is OrderTracer's sampled span export)
 struct Span {
     std::string trace_id;
     std::string span_id;
@@ -111,20 +117,55 @@ struct AnomalyThreshold {
     size_t window_size{100};
 };
 
+/**
+ * Baseline of one metric: a StreamingStats over threshold.window_size
+ * observations. Until MIN_SAMPLES have been seen, the configured mean and
+ * std_dev stand in. One thread updates a metric; any thread may test.
+ */
+class AnomalyMetric {
+public:
+    static constexpr uint64_t MIN_SAMPLES = 10;
+
+    explicit AnomalyMetric(const AnomalyThreshold& threshold) { configure(threshold); }
+
+    /** Resets the baseline. Setup only. */
+    void configure(const AnomalyThreshold& threshold) {
+        threshold_ = threshold;
+        stats_.set_window(threshold.window_size);
+    }
+
+    void update(double value) { stats_.observe(value); }
+
+    bool is_anomaly(double value) const {
+        const bool learned = stats_.count() >= MIN_SAMPLES;
+        const double mean    = learned ? stats_.mean() : threshold_.mean;
+        const double std_dev = learned ? stats_.std_dev() : threshold_.std_dev;
+        return std::abs(value - mean) / std_dev > threshold_.z_score_threshold;
+    }
+
+    const StreamingStats& baseline() const { return stats_; }
+
+private:
+    AnomalyThreshold threshold_;
+    StreamingStats   stats_;
+};
+
 class AnomalyDetector {
 public:
     static AnomalyDetector& instance();
     
-    void configure_metric(const std::string& metric_name, const AnomalyThreshold& threshold);
+    /** Register (or reset) a metric; the handle stays valid for the process */
+    AnomalyMetric& configure_metric(const std::string& metric_name, const AnomalyThreshold& threshold);
+    /** The metric's handle, registered with default thresholds if new */
+    AnomalyMetric& metric(const std::string& metric_name);
+
     bool is_anomaly(const std::string& metric_name, double value);
-    void update_baseline(const std::string& metric_name, double value);
+    /** Name lookup under a shared lock; keep the handle from metric() on hot paths */
+    void update_baseline(const std::string& metric_name, double value) { metric(metric_name).update(value); }
 
 private:
     mutable std::shared_mutex detector_mutex_;
-    std::unordered_map<std::string, AnomalyThreshold> thresholds_ GUARDED_BY(detector_mutex_);
-    std::unordered_map<std::string, std::vector<double>> history_ GUARDED_BY(detector_mutex_);
-    
-    void calculate_statistics(const std::string& metric_name);
+    std::unordered_map<std::string, std::unique_ptr<AnomalyMetric>> metrics_ GUARDED_BY(detector_mutex_);
 };
 
 // Alerting system
@@ -166,24 +207,55 @@ private:
 };
 
 // Performance counters
+
+/**
+ * Pre-registered counters of one operation: fixed memory, and recording
+ * never locks or allocates. Latency goes into a LatencyTracker (fixed
+ * log-linear buckets, so mean and percentiles come from the same O(1)
+ * update); it has one writer, and a second concurrent writer may lose
+ * samples. The counts take any number of writers.
+ */
+struct OperationCounters {
+    LatencyTracker        latency;
+    std::atomic<uint64_t> throughput{0};
+    std::atomic<uint64_t> errors{0};
+    std::atomic<uint64_t> total{0};
+};
+
 class PerformanceCounters {
 public:
     static PerformanceCounters& instance();
     
+    /** Find or register; the handle stays valid for the process */
+    OperationCounters& operation(const std::string& operation);
+
+    static void record_latency(OperationCounters& op, std::chrono::nanoseconds latency) {
+        op.latency.record_latency(static_cast<uint64_t>(std::max<int64_t>(latency.count(), 0)));
+    }
+    static void record_throughput(OperationCounters& op, uint64_t count = 1) {
+        op.throughput.fetch_add(count, std::memory_order_relaxed);
+        op.total.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    // By name: one shared-lock lookup, then the handle path
     void record_latency(const std::string& operation, std::chrono::nanoseconds latency);
     void record_throughput(const std::string& operation, uint64_t count = 1);
     void record_error(const std::string& operation, const std::string& error_type);
     
     double get_avg_latency(const std::string& operation) const;
+    /** Microseconds, from the operation's fixed buckets; 0 if none recorded */
+    double get_latency_percentile(const std::string& operation, double percentile) const;
     uint64_t get_throughput(const std::string& operation) const;
     double get_error_rate(const std::string& operation) const;
 
+    /** Copy each operation's throughput and latency into MetricsCollector gauges (monitoring loop) */
+    void publish() const;
+
 private:
+    const OperationCounters* find(const std::string& operation) const;
+
     mutable std::shared_mutex counters_mutex_;
-    std::unordered_map<std::string, std::vector<double>> latencies_ GUARDED_BY(counters_mutex_);
-    std::unordered_map<std::string, atomic_wrapper<uint64_t>> throughput_counters_;
-    std::unordered_map<std::string, atomic_wrapper<uint64_t>> error_counters_;
-    std::unordered_map<std::string, atomic_wrapper<uint64_t>> total_counters_;
+    std::unordered_map<std::string, std::unique_ptr<OperationCounters>> operations_ GUARDED_BY(counters_mutex_);
 };
 
 // Business metrics
@@ -11,26 +11,37 @@
  *
  * Memory model:
  *   - All vectors pre-reserved at construction
+ *   - Level queues are chunk chains from a per-side pool (no
+ *     reallocation, no compaction pass)
  *   - No allocations during matching
- *   - Deferred compaction between matching cycles
  *
  * Cache optimization:
  *   - FlatLevel structs are contiguous in memory (sequential sweep)
  *   - Hot data (bids/asks/lookup) grouped first at cache-line boundary
  *   - Cold data (metrics, symbol, callbacks) separated
  *   - Binary search replaces hash map (data already in L1)
+ *   - Optional tick ladder: O(1) level index for liquid symbols
  */
 
 #include "rtes/types.hpp"
 #include "rtes/memory_pool.hpp"
+#include "rtes/order_id_map.hpp"
 #include "rtes/error_handling.hpp"
 #include "rtes/thread_safety.hpp"
+#include "rtes/latency_histogram.hpp"
+#include "rtes/queue_position.hpp"
+#include "rtes/level_search.hpp"
+#include "rtes/level_chunk.hpp"
+#include "rtes/bbo_table.hpp"
 #include <vector>
-#include <unordered_map>
 #include <array>
+#include <atomic>
 #include <algorithm>
+#include <bit>
 #include <cassert>
 #include <cstdint>
+#include <limits>
+#include <memory>
 
 namespace rtes {
 
@@ -45,35 +56,68 @@ class PerformanceOptimizer; // Adjusts matching parameters based on latency/thro
 // ═══════════════════════════════════════════════════════════════
 
 inline constexpr size_t CACHE_LINE        = 64;
-inline constexpr size_t LEVEL_RESERVE     = 64;   // Pre-reserve orders per level
 inline constexpr size_t BOOK_RESERVE      = 128;  // Pre-reserve price levels
-inline constexpr size_t COMPACT_THRESHOLD = 64;   // Dead prefix before compaction
 inline constexpr size_t MAX_DEPTH_LEVELS  = 20;   // Max depth snapshot levels
+inline constexpr size_t LADDER_TICKS      = 1024; // Initial tick ladder window
+inline constexpr size_t LEVEL_CHANGE_RESERVE = 64; // Touched levels between drains
 
 // ═══════════════════════════════════════════════════════════════
 //  FlatLevel — Per-price FIFO queue
 // ═══════════════════════════════════════════════════════════════
 
 /**
- * Cache-line aligned price level with cursor-based O(1) pop.
+ * Cache-line aligned price level with O(1) pop.
  *
- * CRITICAL: pop_front() NEVER compacts during matching.
- * Call compact() explicitly between matching cycles.
+ * Two storage modes, fixed at level construction:
+ *
+ *   CHUNKED (default):
+ *     A LevelChunkQueue: fixed 28-handle chunks chained from the
+ *     side's LevelChunkPool (level_chunk.hpp). pop_front() advances
+ *     within the head chunk and recycles it once drained, so push
+ *     and pop never reallocate and leave nothing to compact.
+ *     Cancel is a linear scan + a shift inside one chunk.
+ *     Entries are 4-byte OrderHandles resolved through the pool, so
+ *     a cache line of the queue covers 16 orders instead of 8.
+ *
+ *   INTRUSIVE:
+ *     Live orders are chained through Order::level_prev/level_next.
+ *     pop_front() advances list_head_, cancel is an O(1) unlink.
+ *     No chunk storage at all.
+ *     Preferred for cancel-heavy symbols with deep levels.
  *
  * Caller is responsible for maintaining total_quantity
  * when orders are partially filled or cancelled.
+ *
+ * QUEUE POSITIONS (opt-in, either mode): with a QueueSlots table the
+ * level also keeps QueueSums over its FIFO, updated by every operation
+ * below, and queue_position() answers "how much is ahead of this
+ * order" without walking the queue. Untracked levels pay one
+ * predictable branch per operation.
  */
 struct alignas(CACHE_LINE) FlatLevel {
     Price    price{0};
     Quantity total_quantity{0};   // Sum of remaining qty across live orders
-    uint32_t head_{0};           // First live order index
-    std::vector<Order*> orders;  // orders[head_..end) are live
+    uint32_t count_{0};          // Live order count (INTRUSIVE mode)
+    bool     intrusive_{false};  // Storage mode (fixed at construction)
+    Order*   list_head_{nullptr}; // Oldest live order (INTRUSIVE mode)
+    Order*   list_tail_{nullptr}; // Newest live order (INTRUSIVE mode)
+    const OrderPool* pool_{nullptr};  // Resolves handles (CHUNKED mode)
+    LevelChunkQueue  orders;          // Live orders, oldest first (CHUNKED mode)
+    QueueSlots* queue_slots_{nullptr};  // Book's position table (nullptr = untracked)
+    QueueSums   queue_;                 // Quantity by FIFO position (if queue_slots_)
 
-    explicit FlatLevel(Price p) : price(p) {
-        orders.reserve(LEVEL_RESERVE);
+    /**
+     * @param pool   Pool of every order queued here
+     * @param chunks Chunk pool of the side (CHUNKED mode; unused when intrusive)
+     * @param queue  Position table shared by the book's levels; nullptr = no queue positions
+     */
+    explicit FlatLevel(Price p, const OrderPool& pool, bool intrusive = false,
+                       LevelChunkPool* chunks = nullptr, QueueSlots* queue = nullptr)
+        : price(p), intrusive_(intrusive), pool_(&pool), orders(chunks), queue_slots_(queue) {
+        assert((intrusive_ || chunks) && "Chunked level needs a chunk pool");
     }
 
-    // ── Move only (vector member prevents trivial copy) ──
+    // ── Move only (the chunk chain has a single owner) ──
     FlatLevel(FlatLevel&&) noexcept = default;
     FlatLevel& operator=(FlatLevel&&) noexcept = default;
     FlatLevel(const FlatLevel&) = delete;
@@ -82,18 +126,41 @@ struct alignas(CACHE_LINE) FlatLevel {
     // ── FIFO operations ──
 
     void push_back(Order* o) {
-        orders.push_back(o);
+        if (queue_slots_) [[unlikely]] {
+            if (empty()) queue_.rewind();
+            if (queue_.full()) renumber_queue();
+            (*queue_slots_)[pool_->handle(o)] = queue_.append(o->remaining_quantity);
+        }
+        if (intrusive_) {
+            o->level_prev = list_tail_;
+            o->level_next = nullptr;
+            if (list_tail_) list_tail_->level_next = o;
+            else            list_head_ = o;
+            list_tail_ = o;
+            ++count_;
+        } else {
+            orders.push_back(pool_->handle(o));
+        }
         total_quantity += o->remaining_quantity;
     }
 
     [[nodiscard]] Order* front() const {
         assert(!empty() && "front() called on empty level");
-        return orders[head_];
+        return intrusive_ ? list_head_ : pool_->at(orders.front());
+    }
+
+    /**
+     * Order queued directly behind front(), or nullptr.
+     * Used by the matching sweep to prefetch the next passive order.
+     */
+    [[nodiscard]] Order* second() const {
+        if (intrusive_) return list_head_ ? list_head_->level_next : nullptr;
+        return (orders.size() > 1) ? pool_->at(orders.second()) : nullptr;
     }
 
     /**
-     * O(1) pop — increments cursor only.
-     * NEVER triggers compaction. Latency is deterministic.
+     * O(1) pop — advances within the head chunk (a drained chunk goes
+     * straight back to the side's pool). Latency is deterministic.
      *
      * @param filled_qty  Quantity consumed from the popped order.
      *                    Caller must pass this to maintain total_quantity.
@@ -101,191 +168,604 @@ struct alignas(CACHE_LINE) FlatLevel {
     void pop_front(Quantity filled_qty) {
         assert(!empty() && "pop_front() called on empty level");
         total_quantity -= filled_qty;
-        ++head_;
+        if (queue_slots_) [[unlikely]] queue_.remove(queue_slots_->at(pool_->handle(front())), filled_qty);
+        if (intrusive_) {
+            Order* next = list_head_->level_next;
+            list_head_->level_next = nullptr;
+            list_head_ = next;
+            if (next) next->level_prev = nullptr;
+            else      list_tail_ = nullptr;
+            --count_;
+        } else {
+            orders.pop_front();
+        }
     }
 
     /**
-     * Remove quantity without popping (partial fill).
+     * Remove quantity of resting order `o` without popping (partial
+     * fill, size-down).
      */
-    void reduce_quantity(Quantity qty) {
+    void reduce_quantity(const Order* o, Quantity qty) {
         total_quantity -= qty;
+        if (queue_slots_) [[unlikely]] queue_.reduce(queue_slots_->at(pool_->handle(o)), qty);
+    }
+
+    /**
+     * Remove a resting order from anywhere in the queue (cancel).
+     * INTRUSIVE: O(1) unlink. CHUNKED: O(n) scan + shift within one chunk.
+     * Deducts the order's remaining quantity from total_quantity.
+     *
+     * @pre o rests on this level
+     * @return false if the order was not found (CHUNKED mode only)
+     */
+    bool remove(Order* o) {
+        if (queue_slots_) [[unlikely]] queue_.remove(queue_slots_->at(pool_->handle(o)), o->remaining_quantity);
+        if (intrusive_) {
+            if (o->level_prev) o->level_prev->level_next = o->level_next;
+            else               list_head_ = o->level_next;
+            if (o->level_next) o->level_next->level_prev = o->level_prev;
+            else               list_tail_ = o->level_prev;
+            o->level_prev = nullptr;
+            o->level_next = nullptr;
+            --count_;
+            total_quantity -= o->remaining_quantity;
+            return true;
+        }
+        if (!orders.remove(pool_->handle(o))) return false;
+        total_quantity -= o->remaining_quantity;
+        return true;
+    }
+
+    [[nodiscard]] bool   empty() const {
+        return intrusive_ ? (list_head_ == nullptr) : orders.empty();
+    }
+    [[nodiscard]] size_t size()  const {
+        return intrusive_ ? count_ : orders.size();
     }
 
-    [[nodiscard]] bool   empty() const { return head_ >= orders.size(); }
-    [[nodiscard]] size_t size()  const { return orders.size() - head_; }
+    /**
+     * Orders and displayed quantity ahead of `o` in this queue, O(log n).
+     * @pre queue_slots_ set and o rests on this level
+     */
+    [[nodiscard]] QueuePosition queue_position(const Order* o) const {
+        return queue_.before(queue_slots_->at(pool_->handle(o)));
+    }
 
-    // ── Deferred maintenance (call OUTSIDE matching hot path) ──
+    /** Visit live orders in time priority. Cold path (auction, snapshots). */
+    template<typename Fn>
+    void for_each_order(Fn&& fn) const {
+        if (intrusive_) {
+            for (const Order* o = list_head_; o; o = o->level_next) fn(*o);
+        } else {
+            orders.for_each([&](OrderHandle handle) { fn(*pool_->at(handle)); });
+        }
+    }
 
-    [[nodiscard]] bool needs_compaction() const {
-        return head_ > COMPACT_THRESHOLD;
+    /**
+     * Re-arm a level for a new price. Used by the tick ladder, which
+     * recycles slots instead of constructing/destroying levels, and by
+     * tombstone reuse. Any chunks still held go back to the pool.
+     */
+    void reset(Price p) {
+        price = p;
+        total_quantity = 0;
+        count_ = 0;
+        list_head_ = nullptr;
+        list_tail_ = nullptr;
+        orders.clear();
+        queue_.rewind();
     }
 
-    void compact() {
-        if (head_ == 0) return;
-        orders.erase(orders.begin(), orders.begin() + head_);
-        head_ = 0;
+private:
+    /** Out of positions: renumber the live orders into a tree twice their count */
+    void renumber_queue() {
+        queue_.reset(std::max(QUEUE_SUMS_MIN, std::bit_ceil(2 * size() + 1)));
+        for_each_order([this](const Order& o) {
+            (*queue_slots_)[pool_->handle(&o)] = queue_.append(o.remaining_quantity);
+        });
     }
 };
 
 // ═══════════════════════════════════════════════════════════════
-//  FlatPriceBook — Sorted contiguous price levels
+//  OrderBookOptions — Structural choices fixed at construction
 // ═══════════════════════════════════════════════════════════════
 
 /**
- * Sorted vector of FlatLevel with binary search lookup.
+ * Per-book structural options. Selected per symbol from
+ * SymbolConfig and fixed for the lifetime of the book.
+ */
+struct OrderBookOptions {
+    /** Chain resting orders intrusively (O(1) cancel). See FlatLevel. */
+    bool intrusive_levels{false};
+
+    /** Index levels by tick instead of binary search. See FlatPriceBook. */
+    bool tick_ladder{false};
+
+    /** Ladder tick in fixed-point price units (used if tick_ladder) */
+    Price tick{price_from_double(0.01)};
+
+    /** Initial ladder window in ticks (rounded to power of 2, grows on demand) */
+    size_t ladder_ticks{LADDER_TICKS};
+
+    /** Self-trade prevention mode, keyed by Order::owner */
+    SelfTradePrevention self_trade{SelfTradePrevention::NONE};
+
+    /** Time 1 in N add/match/trade calls for the latency histograms (1 = every call) */
+    uint32_t latency_sample{64};
+
+    /**
+     * Dynamic price band, in basis points either side of the last trade
+     * (0 = off). A sweep stops at the band and the book enters a
+     * volatility AUCTION instead of trading through it. See OrderBook.
+     */
+    uint32_t price_band_bps{0};
+
+    /** Keep per-level queue sums for queue_position(). See FlatLevel. */
+    bool queue_positions{false};
+};
+
+// ═══════════════════════════════════════════════════════════════
+//  FlatPriceBook — Price levels (sorted vector or tick ladder)
+// ═══════════════════════════════════════════════════════════════
+
+/**
+ * Price-ordered collection of FlatLevel with two index backends,
+ * fixed at construction (OrderBookOptions::tick_ladder):
  *
- * Template parameter:
- *   Descending=true  → Bids  (levels_[0] = highest/best bid)
- *   Descending=false → Asks  (levels_[0] = lowest/best ask)
+ *   SORTED VECTOR (default):
+ *     Sorted vector of FlatLevel with binary search lookup.
+ *     Why binary search instead of hash map:
+ *       - Typical book: 10-100 active levels → 4-7 comparisons
+ *       - Vector data is already in L1 from matching sweep
+ *       - No hash computation, no collision chains
+ *       - ~40% faster measured on books with < 200 levels
+ *     The search runs over keys_, a packed copy of the level prices
+ *     (8 per cache line, not 1), branchless down to 16 keys and then
+ *     SIMD-counted (level_search.hpp): deep books stop paying a cache
+ *     miss and a mispredict per probe.
+ *     Drained levels are left in place as empty TOMBSTONES: a book
+ *     oscillating around one price re-arms the same level instead of
+ *     erase + emplace (each shifting every FlatLevel behind it).
+ *     first_live_ skips the tombstone prefix so best_*() stays O(1);
+ *     prune_empty() removes tombstones in the maintenance window.
+ *
+ *   TICK LADDER:
+ *     Levels live in a ring of slots indexed by (price / tick) & mask.
+ *     The ring is implicitly recentering: any window of N consecutive
+ *     ticks maps 1:1 onto the slots, so only the occupied span
+ *     (worst..best) has to fit — no base offset, no data movement
+ *     as the market drifts. An occupancy bitmap (1 bit per slot)
+ *     finds the next best tick with ctz/clz when a level drains.
+ *     Slots are recycled via FlatLevel::reset(). Prices must be a
+ *     multiple of the tick
+ *     (see on_tick()). If the occupied span outgrows the window the
+ *     ring doubles (allocates — rare, never on the steady state).
  *
- * Why binary search instead of hash map:
- *   - Typical book: 10-100 active levels → 4-7 comparisons
- *   - Vector data is already in L1 from matching sweep
- *   - No hash computation, no collision chains
- *   - Eliminates rebuild_index() entirely
- *   - ~40% faster measured on books with < 200 levels
+ * Chunked levels of either backend draw their queue chunks from one
+ * LevelChunkPool owned by the side, so levels are cheap to move (the
+ * sorted vector's shifts copy three pointers per level, not a queue)
+ * and a drained level holds no memory.
  *
- * Complexity:
- *   best_price()  : O(1)
- *   find(price)   : O(log N) — but fast due to cache locality
- *   insert(price) : O(N) shift — rare (new price tick only)
- *   remove(price) : O(N) shift — rare (level fully drained)
- *   sweep [0..k]  : O(k) sequential — cache-friendly
+ * Template parameter:
+ *   Descending=true  → Bids  (index 0 = highest/best bid)
+ *   Descending=false → Asks  (index 0 = lowest/best ask)
+ *
+ * Complexity:            SORTED VECTOR           TICK LADDER
+ *   best_price()  :      O(1)                    O(1)
+ *   find(price)   :      O(log N)                O(1)
+ *   insert(price) :      O(N) shift (new tick)   O(1)
+ *                        O(log N) (tombstone)
+ *   remove(price) :      O(log N) tombstone      O(1) + bitmap scan to next
+ *   remove_best() :      O(1) + skip tombstones  O(1) + bitmap scan to next
+ *   best_level()  :      O(1)                    O(1)
+ *   sweep [0..k]  :      O(k) sequential         O(k) bitmap walk
  */
 template<bool Descending>
 class FlatPriceBook {
 public:
-    FlatPriceBook() {
-        levels_.reserve(BOOK_RESERVE);
+    /**
+     * @param pool     Pool of the orders resting here (levels queue handles)
+     * @param options  Level storage mode and index backend.
+     *                 Fixed for book lifetime.
+     */
+    explicit FlatPriceBook(const OrderPool& pool, const OrderBookOptions& options = {})
+        : chunks_(options.intrusive_levels ? nullptr : std::make_unique<LevelChunkPool>())
+        , pool_(&pool)
+        , intrusive_levels_(options.intrusive_levels)
+        , ladder_(options.tick_ladder && options.tick > 0) {
+        if (ladder_) {
+            tick_ = options.tick;
+            allocate_ladder(std::bit_ceil(
+                std::max<size_t>(options.ladder_ticks, LADDER_WORD_BITS)));
+        } else {
+            levels_.reserve(BOOK_RESERVE);
+            keys_.reserve(BOOK_RESERVE);
+        }
+    }
+
+    // Levels point into chunks_: the book stays where it was built
+    FlatPriceBook(const FlatPriceBook&) = delete;
+    FlatPriceBook& operator=(const FlatPriceBook&) = delete;
+
+    /** Keep queue positions in every level (see FlatLevel), in `slots`. Before any order rests. */
+    void track_queue_positions(QueueSlots* slots) {
+        queue_slots_ = slots;
+        for (FlatLevel& level : levels_) level.queue_slots_ = slots;
+        for (FlatLevel& level : slots_) level.queue_slots_ = slots;
     }
 
     // ── Best-of-book (O(1)) ──
 
     [[nodiscard]] Price best_price() const {
-        return levels_.empty() ? 0 : levels_[0].price;
+        if (ladder_) return ladder_count_ ? slot(best_tick_).price : 0;
+        return empty() ? 0 : levels_[first_live_].price;
     }
 
     [[nodiscard]] Quantity best_quantity() const {
-        return levels_.empty() ? 0 : levels_[0].total_quantity;
+        if (ladder_) return ladder_count_ ? slot(best_tick_).total_quantity : 0;
+        return empty() ? 0 : levels_[first_live_].total_quantity;
     }
 
-    [[nodiscard]] bool empty() const { return levels_.empty(); }
+    [[nodiscard]] bool empty() const {
+        return ladder_ ? (ladder_count_ == 0) : (first_live_ >= levels_.size());
+    }
 
-    // ── Price lookup — O(log N) binary search ──
+    /**
+     * Best live level — the matching sweep's entry point.
+     * @pre !empty()
+     */
+    [[nodiscard]] FlatLevel& best_level() {
+        assert(!empty() && "best_level() on empty book");
+        return ladder_ ? slot(best_tick_) : levels_[first_live_];
+    }
 
+    /**
+     * Whether a price can be indexed by this book.
+     * Always true for the sorted vector; ladder requires price % tick == 0.
+     */
+    [[nodiscard]] bool on_tick(Price p) const {
+        return !ladder_ || (p % tick_) == 0;
+    }
+
+    // ── Price lookup — O(log N) binary search / O(1) ladder ──
+
+    /** Live level at p, or nullptr (tombstones are not returned). */
     [[nodiscard]] FlatLevel* find(Price p) {
+        if (ladder_) return ladder_find(p);
         auto it = lower_bound_for(p);
-        if (it != levels_.end() && it->price == p) {
+        if (it != levels_.end() && it->price == p && !it->empty()) {
             return &(*it);
         }
         return nullptr;
     }
 
     [[nodiscard]] const FlatLevel* find(Price p) const {
-        auto it = lower_bound_for(p);
-        if (it != levels_.end() && it->price == p) {
-            return &(*it);
-        }
-        return nullptr;
+        return const_cast<FlatPriceBook*>(this)->find(p);
     }
 
-    // ── Level insertion — O(N) but rare ──
+    // ── Level insertion — O(N) but rare / O(1) ladder ──
 
     /**
      * Insert a new price level in sorted position.
-     * @pre Level at price p must NOT already exist.
+     * A tombstone at p is re-armed instead of inserting.
+     * @pre No live level at price p.
+     * @pre on_tick(p)
+     * @post Caller pushes an order before the next best_*() query.
      * @return Reference to newly created level.
      */
     FlatLevel& insert(Price p) {
-        auto it = lower_bound_for(p);
-        assert((it == levels_.end() || it->price != p) &&
-               "Duplicate price level insertion");
-        return *levels_.emplace(it, p);
+        assert(!find(p) && "Duplicate price level insertion");
+        return find_or_insert(p);
     }
 
     /**
      * Find existing level or create new one.
      * Safe for order insertion — avoids separate find+insert.
+     * Tombstones are re-armed in place (FlatLevel::reset).
+     * @pre on_tick(p)
+     * @post Caller pushes an order before the next best_*() query.
      */
     FlatLevel& find_or_insert(Price p) {
+        if (ladder_) {
+            if (FlatLevel* level = ladder_find(p)) return *level;
+            return ladder_insert(p);
+        }
         auto it = lower_bound_for(p);
+        const size_t idx = static_cast<size_t>(it - levels_.begin());
+        if (idx <= first_live_) first_live_ = idx;  // New best (or shifted past)
         if (it != levels_.end() && it->price == p) {
+            if (it->empty()) {
+                assert(tombstones_ > 0 && "Re-armed level was not counted as a tombstone");
+                it->reset(p);
+                --tombstones_;
+            }
             return *it;
         }
-        return *levels_.emplace(it, p);
+        keys_.insert(keys_.begin() + static_cast<std::ptrdiff_t>(idx), p);
+        return *levels_.emplace(it, p, *pool_, intrusive_levels_, chunks_.get(), queue_slots_);
     }
 
-    // ── Level removal — O(N) but rare ──
+    // ── Level removal — lazy tombstone / O(1) ladder ──
 
+    /**
+     * Remove the level at p. An empty (drained) level stays in place
+     * as a tombstone until prune_empty(); a non-empty one is erased.
+     */
     void remove(Price p) {
+        if (ladder_) {
+            if (ladder_find(p)) ladder_erase(p / tick_);
+            return;
+        }
         auto it = lower_bound_for(p);
-        if (it != levels_.end() && it->price == p) {
+        if (it == levels_.end() || it->price != p) return;
+        const size_t idx = static_cast<size_t>(it - levels_.begin());
+        if (!it->empty()) [[unlikely]] {
             levels_.erase(it);
+            keys_.erase(keys_.begin() + static_cast<std::ptrdiff_t>(idx));
+        } else {
+            ++tombstones_;
         }
+        if (idx == first_live_) skip_tombstones();
     }
 
     /**
-     * Remove the best (front) level — optimized path for matching.
-     * Avoids binary search when we know we're draining levels_[0].
+     * Remove the best level — optimized path for matching.
+     * No search: the drained best level becomes a tombstone and
+     * first_live_ advances to the next live level.
      */
     void remove_best() {
-        assert(!levels_.empty() && "remove_best() on empty book");
-        levels_.erase(levels_.begin());
+        assert(!empty() && "remove_best() on empty book");
+        if (ladder_) { ladder_erase(best_tick_); return; }
+        if (!levels_[first_live_].empty()) [[unlikely]] {
+            levels_.erase(levels_.begin() + static_cast<std::ptrdiff_t>(first_live_));
+            keys_.erase(keys_.begin() + static_cast<std::ptrdiff_t>(first_live_));
+        } else {
+            ++tombstones_;
+        }
+        skip_tombstones();
     }
 
     // ── Indexed access for matching sweep ──
 
-    [[nodiscard]] FlatLevel&       operator[](size_t i)       { return levels_[i]; }
-    [[nodiscard]] const FlatLevel& operator[](size_t i) const { return levels_[i]; }
-    [[nodiscard]] size_t           level_count()         const { return levels_.size(); }
-
-    // ── Maintenance ──
+    /**
+     * i-th level from the best. Sorted vector: tombstones past the best
+     * are counted (and returned); ladder walks the bitmap for i > 0.
+     * Prefer best_level() / for_each_level().
+     */
+    [[nodiscard]] FlatLevel&       operator[](size_t i)       { return ladder_ ? ladder_nth(i) : levels_[first_live_ + i]; }
+    [[nodiscard]] const FlatLevel& operator[](size_t i) const { return const_cast<FlatPriceBook*>(this)->operator[](i); }
 
-    void clear() { levels_.clear(); }
+    /** Levels from the best onward (sorted vector: includes tombstones until prune_empty()) */
+    [[nodiscard]] size_t           level_count()         const { return ladder_ ? ladder_count_ : levels_.size() - first_live_; }
+    [[nodiscard]] bool             intrusive_levels()    const { return intrusive_levels_; }
+    [[nodiscard]] bool             tick_ladder()         const { return ladder_; }
+    /** Drained levels prune_empty() would remove (always 0 on the ladder) */
+    [[nodiscard]] size_t           tombstones()          const { return tombstones_; }
 
     /**
-     * Compact all levels that have accumulated dead prefix.
-     * Call between matching cycles, NOT during sweep.
+     * Visit live levels best-first until fn returns false.
+     * Linear in levels visited for both backends (tombstones skipped).
      */
-    void compact_all() {
-        for (auto& level : levels_) {
-            if (level.needs_compaction()) {
-                level.compact();
+    template<typename Fn>
+    void for_each_level(Fn&& fn) const {
+        if (!ladder_) {
+            for (size_t i = first_live_; i < levels_.size(); ++i) {
+                if (levels_[i].empty()) continue;
+                if (!fn(levels_[i])) return;
             }
+            return;
+        }
+        uint64_t t = best_tick_;
+        for (size_t k = 0; k < ladder_count_; ++k) {
+            if (k) t = next_worse(t);
+            if (!fn(slot(t))) return;
+        }
+    }
+
+    // ── Maintenance ──
+
+    void clear() {
+        if (!ladder_) { levels_.clear(); keys_.clear(); first_live_ = 0; tombstones_ = 0; return; }
+        uint64_t t = best_tick_;
+        for (size_t k = 0; k < ladder_count_; ++k) {
+            if (k) t = next_worse(t);
+            slot(t).reset(0);
         }
+        std::fill(occupied_.begin(), occupied_.end(), 0);
+        ladder_count_ = 0;
     }
 
+    /** Queue chunks of this side's levels (nullptr with intrusive levels) */
+    [[nodiscard]] const LevelChunkPool* level_chunks() const { return chunks_.get(); }
+
     /**
-     * Remove all empty levels. Call periodically to reclaim space.
+     * Remove all empty levels (tombstones). Call from the maintenance
+     * window — this is where the deferred vector shifts are paid.
      */
     void prune_empty() {
-        levels_.erase(
-            std::remove_if(levels_.begin(), levels_.end(),
-                           [](const FlatLevel& l) { return l.empty(); }),
-            levels_.end());
+        if (!ladder_) {
+            levels_.erase(
+                std::remove_if(levels_.begin(), levels_.end(),
+                               [](const FlatLevel& l) { return l.empty(); }),
+                levels_.end());
+            keys_.clear();
+            for (const FlatLevel& level : levels_) keys_.push_back(level.price);
+            first_live_ = 0;
+            tombstones_ = 0;
+            return;
+        }
+        while (ladder_count_ && slot(best_tick_).empty()) ladder_erase(best_tick_);
+        if (!ladder_count_) return;
+        uint64_t t = best_tick_;
+        while (t != worst_tick_) {
+            const uint64_t next = next_worse(t);
+            if (slot(next).empty()) ladder_erase(next);
+            else                    t = next;
+        }
     }
 
 private:
-    std::vector<FlatLevel> levels_;  // Contiguous — sequential sweep is cache-friendly
+    static constexpr size_t LADDER_WORD_BITS = 64;
 
-    // ── Unified binary search respecting sort direction ──
+    std::unique_ptr<LevelChunkPool> chunks_;  // Level queues; declared first so it outlives them
+    std::vector<FlatLevel> levels_;  // Contiguous — sequential sweep is cache-friendly
+    std::vector<Price> keys_;        // keys_[i] == levels_[i].price: what lower_bound_for searches
+    size_t first_live_{0};           // levels_[0..first_live_) are tombstones
+    size_t tombstones_{0};           // Empty levels anywhere in levels_
+    const OrderPool* pool_;          // Handed to every level
+    bool intrusive_levels_{false};   // Level storage mode for new levels
+    QueueSlots* queue_slots_{nullptr};  // Handed to every level (queue positions)
+
+    // ── Tick ladder state (ladder_ == true) ──
+    bool                   ladder_{false};
+    Price                  tick_{1};          // Fixed-point price per slot
+    size_t                 ladder_mask_{0};   // slots - 1
+    size_t                 ladder_count_{0};  // Occupied slots
+    uint64_t               best_tick_{0};     // Valid iff ladder_count_ > 0
+    uint64_t               worst_tick_{0};    // Valid iff ladder_count_ > 0
+    std::vector<FlatLevel> slots_;            // Ring: tick & ladder_mask_
+    std::vector<uint64_t>  occupied_;         // 1 bit per slot
+
+    // ── Lower bound respecting sort direction, over the compact keys ──
 
     auto lower_bound_for(Price p) {
-        return std::lower_bound(
-            levels_.begin(), levels_.end(), p,
-            [](const FlatLevel& level, Price target) {
-                if constexpr (Descending) return level.price > target;
-                else                      return level.price < target;
-            });
+        return levels_.begin() +
+               static_cast<std::ptrdiff_t>(level_lower_bound<Descending>(keys_.data(), keys_.size(), p));
     }
 
     auto lower_bound_for(Price p) const {
-        return std::lower_bound(
-            levels_.begin(), levels_.end(), p,
-            [](const FlatLevel& level, Price target) {
-                if constexpr (Descending) return level.price > target;
-                else                      return level.price < target;
-            });
+        return levels_.begin() +
+               static_cast<std::ptrdiff_t>(level_lower_bound<Descending>(keys_.data(), keys_.size(), p));
+    }
+
+    /** Advance first_live_ past drained levels (sorted vector only). */
+    void skip_tombstones() {
+        while (first_live_ < levels_.size() && levels_[first_live_].empty()) ++first_live_;
+    }
+
+    // ── Tick ladder internals ──
+
+    static constexpr bool better(uint64_t a, uint64_t b) {
+        if constexpr (Descending) return a > b;
+        else                      return a < b;
+    }
+
+    [[nodiscard]] FlatLevel&       slot(uint64_t t)       { return slots_[t & ladder_mask_]; }
+    [[nodiscard]] const FlatLevel& slot(uint64_t t) const { return slots_[t & ladder_mask_]; }
+
+    [[nodiscard]] bool test_bit(uint64_t t) const {
+        return (occupied_[(t & ladder_mask_) / LADDER_WORD_BITS] >> (t % LADDER_WORD_BITS)) & 1u;
+    }
+    void set_bit(uint64_t t)   { occupied_[(t & ladder_mask_) / LADDER_WORD_BITS] |=  (uint64_t{1} << (t % LADDER_WORD_BITS)); }
+    void clear_bit(uint64_t t) { occupied_[(t & ladder_mask_) / LADDER_WORD_BITS] &= ~(uint64_t{1} << (t % LADDER_WORD_BITS)); }
+
+    /** Construct the ring. Slots start empty, holding no chunks. */
+    void allocate_ladder(size_t n_slots) {
+        slots_.clear();
+        slots_.reserve(n_slots);
+        for (size_t i = 0; i < n_slots; ++i) {
+            slots_.emplace_back(0, *pool_, intrusive_levels_, chunks_.get(), queue_slots_);
+        }
+        occupied_.assign(n_slots / LADDER_WORD_BITS, 0);
+        ladder_mask_ = n_slots - 1;
+    }
+
+    /** @return Occupied level at p, or nullptr. Bounded by [worst, best]. */
+    [[nodiscard]] FlatLevel* ladder_find(Price p) {
+        if (!ladder_count_ || (p % tick_) != 0) return nullptr;
+        const uint64_t t = p / tick_;
+        if (better(t, best_tick_) || better(worst_tick_, t)) return nullptr;
+        return test_bit(t) ? &slot(t) : nullptr;
+    }
+
+    FlatLevel& ladder_insert(Price p) {
+        assert((p % tick_) == 0 && "Off-tick price on tick ladder");
+        const uint64_t t = p / tick_;
+        if (!ladder_count_) {
+            best_tick_ = worst_tick_ = t;
+        } else {
+            const uint64_t lo = std::min({t, best_tick_, worst_tick_});
+            const uint64_t hi = std::max({t, best_tick_, worst_tick_});
+            if (hi - lo > ladder_mask_) [[unlikely]] grow_ladder(hi - lo + 1);
+            if (better(t, best_tick_))  best_tick_  = t;
+            if (better(worst_tick_, t)) worst_tick_ = t;
+        }
+        FlatLevel& level = slot(t);
+        level.reset(p);
+        set_bit(t);
+        ++ladder_count_;
+        return level;
+    }
+
+    void ladder_erase(uint64_t t) {
+        assert(test_bit(t) && "Erasing unoccupied ladder slot");
+        clear_bit(t);
+        --ladder_count_;
+        if (!ladder_count_) return;
+        if (t == best_tick_)       best_tick_  = next_worse(t);
+        else if (t == worst_tick_) worst_tick_ = next_better(t);
+    }
+
+    [[nodiscard]] FlatLevel& ladder_nth(size_t i) {
+        assert(i < ladder_count_ && "Ladder index out of range");
+        uint64_t t = best_tick_;
+        while (i--) t = next_worse(t);
+        return slot(t);
+    }
+
+    /**
+     * Ring doubling when the occupied span exceeds the window.
+     * Levels are moved (not copied) into the new slots.
+     */
+    void grow_ladder(uint64_t span) {
+        std::vector<FlatLevel> old_slots = std::move(slots_);
+        std::vector<uint64_t>  old_bits  = std::move(occupied_);
+        const size_t old_mask = ladder_mask_;
+
+        allocate_ladder(std::bit_ceil(static_cast<size_t>(span * 2)));
+
+        for (size_t i = 0; i <= old_mask; ++i) {
+            if (!((old_bits[i / LADDER_WORD_BITS] >> (i % LADDER_WORD_BITS)) & 1u)) continue;
+            const uint64_t t = old_slots[i].price / tick_;
+            slot(t) = std::move(old_slots[i]);
+            set_bit(t);
+        }
+    }
+
+    // ── Bitmap scans (caller guarantees a target exists) ──
+
+    /** Highest occupied tick strictly below t */
+    [[nodiscard]] uint64_t next_below(uint64_t t) const {
+        uint64_t cur = t - 1;
+        for (;;) {
+            const uint64_t bit  = cur % LADDER_WORD_BITS;
+            const uint64_t word = occupied_[(cur & ladder_mask_) / LADDER_WORD_BITS]
+                                & (~uint64_t{0} >> (LADDER_WORD_BITS - 1 - bit));
+            if (word) return cur - bit + (LADDER_WORD_BITS - 1 - __builtin_clzll(word));
+            cur -= bit + 1;
+        }
+    }
+
+    /** Lowest occupied tick strictly above t */
+    [[nodiscard]] uint64_t next_above(uint64_t t) const {
+        uint64_t cur = t + 1;
+        for (;;) {
+            const uint64_t bit  = cur % LADDER_WORD_BITS;
+            const uint64_t word = occupied_[(cur & ladder_mask_) / LADDER_WORD_BITS]
+                                & (~uint64_t{0} << bit);
+            if (word) return cur - bit + __builtin_ctzll(word);
+            cur += LADDER_WORD_BITS - bit;
+        }
+    }
+
+    [[nodiscard]] uint64_t next_worse(uint64_t t) const {
+        if constexpr (Descending) return next_below(t);
+        else                      return next_above(t);
+    }
+
+    [[nodiscard]] uint64_t next_better(uint64_t t) const {
+        if constexpr (Descending) return next_above(t);
+        else                      return next_below(t);
     }
 };
 
@@ -311,19 +791,175 @@ struct DepthSnapshot {
     std::array<DepthLevel, MAX_DEPTH_LEVELS> asks{};
     size_t bid_levels{0};
     size_t ask_levels{0};
+    uint64_t  version{0};       // Publish count (set by DepthSnapshotBuffer)
+    uint64_t  update_sequence{0};  // Book updates reflected (owner's count, see publish_depth)
+    Timestamp timestamp_ns{0};  // Owner-thread time of capture
+};
+
+/**
+ * What one book operation changed. Filled in as the operation runs and
+ * closed by a single compare of the new top of book against the BBO
+ * snapshot, so callers need not read the book before and after, and
+ * the snapshot is only rewritten when the top actually changed.
+ */
+struct BookChange {
+    uint32_t fills{0};           // Trades executed
+    uint32_t levels{0};          // Visible level updates (repeats of one level folded)
+    bool     bid_moved{false};   // Best bid price changed
+    bool     ask_moved{false};   // Best ask price changed
+    bool     top_resized{false}; // Same best prices, different quantity at one of them
+
+    /** A best price changed (what a BBO update reports) */
+    [[nodiscard]] bool moved() const { return bid_moved || ask_moved; }
+    /** The BBO was republished */
+    [[nodiscard]] bool top_changed() const { return moved() || top_resized; }
+};
+
+/**
+ * Double-buffered seqlock for cross-thread full-depth snapshots.
+ *
+ * Writer (book owner thread) fills the BACK slot under that slot's
+ * sequence (odd while writing), then flips front_ to it. Readers copy
+ * the FRONT slot and retry if its sequence moved during the copy.
+ *
+ *   - Writer never waits: it only ever touches the slot readers
+ *     were just told to leave.
+ *   - A reader is disturbed only if two publishes land inside one
+ *     ~1KB copy; read() retries a bounded number of times.
+ *   - No allocation, no locks, any number of readers.
+ */
+class DepthSnapshotBuffer {
+public:
+    static constexpr int READ_RETRIES = 8;
+
+    /**
+     * Publish a new snapshot. Owner thread only.
+     * @param fill  Callable filling a DepthSnapshot& in place
+     */
+    template<typename Fill>
+    void publish(Fill&& fill) {
+        const uint32_t back = front_.load(std::memory_order_relaxed) ^ 1u;
+        Slot& slot = slots_[back];
+        const uint64_t seq = slot.sequence.load(std::memory_order_relaxed);
+
+        slot.sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        fill(slot.snapshot);
+        slot.snapshot.version = ++version_;
+
+        slot.sequence.store(seq + 2, std::memory_order_release);
+        front_.store(back, std::memory_order_release);
+    }
+
+    /**
+     * Copy the latest published snapshot. Safe from any thread.
+     * @return false if no snapshot published yet, or the copy raced
+     *         the writer READ_RETRIES times in a row
+     */
+    [[nodiscard]] bool read(DepthSnapshot& out) const {
+        for (int attempt = 0; attempt < READ_RETRIES; ++attempt) {
+            const Slot& slot = slots_[front_.load(std::memory_order_acquire)];
+            const uint64_t seq1 = slot.sequence.load(std::memory_order_acquire);
+            if (seq1 == 0) return false;   // Never published
+            if (seq1 & 1) continue;        // Writer inside this slot
+
+            out = slot.snapshot;
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot.sequence.load(std::memory_order_relaxed) == seq1) return true;
+        }
+        return false;
+    }
+
+private:
+    struct alignas(CACHE_LINE) Slot {
+        std::atomic<uint64_t> sequence{0};  // Odd = writing, even = valid
+        DepthSnapshot         snapshot{};
+    };
+
+    std::array<Slot, 2> slots_{};
+    alignas(CACHE_LINE) std::atomic<uint32_t> front_{0};
+    uint64_t version_{0};  // Writer-only publish counter
+};
+
+// ═══════════════════════════════════════════════════════════════
+//  AuctionResult — Call auction equilibrium
+// ═══════════════════════════════════════════════════════════════
+
+/** Equilibrium of a call auction. volume == 0 means no cross. */
+struct AuctionResult {
+    Price    price{0};
+    Quantity volume{0};
+};
+
+// ═══════════════════════════════════════════════════════════════
+//  BookImage — Restartable copy of a book's state
+// ═══════════════════════════════════════════════════════════════
+
+/** Fixed part of a BookImage, written as is (see book_snapshot.hpp) */
+struct BookImageHeader {
+    char         symbol[16]{};
+    TradeID      next_trade_id{1};
+    Price        last_trade_price{0};
+    uint64_t     order_count{0};
+    TradingPhase phase{TradingPhase::CONTINUOUS};
+    uint8_t      reserved[7]{};
+};
+
+/**
+ * Everything a book needs to carry on where it stopped (OrderBook::
+ * capture() / restore()). `orders` are copies with their level links
+ * cleared, in the order they must be requeued: bids best-first, asks
+ * best-first, then buy and sell stops, FIFO within each level. Capacity
+ * is reused from one capture to the next.
+ */
+struct BookImage {
+    BookImageHeader    header;
+    std::vector<Order> orders;
 };
 
+// ═══════════════════════════════════════════════════════════════
+//  OrderReleaseBatch — Deferred return of retired orders
+// ═══════════════════════════════════════════════════════════════
+
 /**
- * Atomic BBO snapshot for lock-free cross-thread reads.
- * Updated by matching thread after every trade/BBO change.
- * Read by market data publisher without locking.
+ * Orders retired during one matching cycle, returned to the pool
+ * together (OrderPool::deallocate_bulk) instead of one CAS per fill in
+ * the middle of the sweep. The owner flushes at the end of each cycle;
+ * a full batch flushes itself, so a sweep through thousands of orders
+ * costs one bulk push per CAPACITY.
+ *
+ * Retired orders are already out of the book and the lookup, so
+ * holding their slots a little longer is invisible to matching; the
+ * pool just reports them allocated until the flush.
+ *
+ * Single-threaded (the engine thread owning the books).
  */
-struct alignas(CACHE_LINE) BBOSnapshot {
-    Price    bid_price{0};
-    Quantity bid_quantity{0};
-    Price    ask_price{0};
-    Quantity ask_quantity{0};
-    uint64_t sequence{0};  // Odd = writing, even = valid (seqlock)
+class OrderReleaseBatch {
+public:
+    static constexpr size_t CAPACITY = 256;
+
+    explicit OrderReleaseBatch(OrderPool& pool) : pool_(pool) {}
+
+    void add(Order* order) {
+        if (count_ == CAPACITY) [[unlikely]] flush();
+        orders_[count_++] = order;
+    }
+
+    /** Everything collected back to the pool in one bulk push */
+    void flush() {
+        if (count_ == 0) return;
+        pool_.deallocate_bulk(orders_.data(), count_);
+        count_ = 0;
+    }
+
+    [[nodiscard]] size_t size() const { return count_; }
+
+private:
+    OrderPool& pool_;
+    size_t     count_{0};
+    std::array<Order*, CAPACITY> orders_;
 };
 
 // ═══════════════════════════════════════════════════════════════
@@ -338,18 +974,27 @@ struct alignas(CACHE_LINE) BBOSnapshot {
  *     add_order(), cancel_order(), and all matching methods.
  *   - No mutex in hot path.
  *   - Cross-thread reads (monitoring, market data) use:
- *     - get_bbo_snapshot()  → seqlock-protected BBO
- *     - get_depth_snapshot() → called from owner thread, result published
+ *     - read_bbo()          → seqlock-protected BBO (bbo_table.hpp),
+ *                              republished only when the top changes
+ *     - read_depth()        → double-buffered seqlock, filled by
+ *                              publish_depth() on the owner thread
  *
  * MEMORY MODEL:
  *   - Orders come from pre-allocated OrderPool (no hot-path alloc)
- *   - FlatLevel vectors pre-reserved
+ *   - Retired orders go to the pool directly, or to an
+ *     OrderReleaseBatch the engine flushes once per cycle
+ *   - FlatLevel queues are pooled chunks (nothing to compact)
+ *   - Order lookup is a pre-sized OrderIdMap (no node allocation)
  *   - DepthSnapshot is stack-allocated
  *
  * MATCHING:
  *   - Price-time priority (best price first, FIFO within price)
  *   - Market orders: sweep until filled or book empty
  *   - Limit orders: sweep while price crosses, remainder rests in book
+ *   - AUCTION phase: LIMIT / POST_ONLY orders rest without matching
+ *     (the book may be crossed); uncross() executes everything at
+ *     one equilibrium price and returns to CONTINUOUS
+ *   - HALTED phase: cancel-only (see halt())
  */
 class OrderBook {
 public:
@@ -363,19 +1008,63 @@ public:
      */
     using TradeCallback = void(*)(const Trade& trade, void* ctx);
 
+    /**
+     * Order retirement callback: the book is about to return an order it
+     * owned to the pool (filled, cancelled, STP-cancelled, stop remainder).
+     * Shares cb_ctx with the trade callback. Aggressors that never rested
+     * are retired by the caller and are not reported here.
+     */
+    using OrderDoneCallback = void(*)(const Order& order, void* ctx);
+
+    /**
+     * Per-order execution callback: once for each side of every trade,
+     * after its remaining quantity was reduced. Shares cb_ctx.
+     */
+    using OrderFillCallback = void(*)(const Order& order, Quantity quantity,
+                                      Price price, void* ctx);
+
+    /**
+     * Market-by-order callback: every change to a resting order's place
+     * or displayed quantity (see OrderEvent), in book order. Shares
+     * cb_ctx. Stop orders are not visible and not reported; neither is
+     * restore().
+     */
+    using OrderEventCallback = void(*)(const OrderEvent& event, void* ctx);
+
     /**
      * @param symbol    Instrument symbol (e.g., "AAPL")
      * @param pool      Pre-allocated order pool (must outlive OrderBook)
      * @param callback  Trade notification function (may be nullptr)
      * @param cb_ctx    Context pointer passed to callback
+     * @param options   Structural options (level storage mode, ...)
      */
     explicit OrderBook(const std::string& symbol,
                        OrderPool& pool,
                        TradeCallback callback = nullptr,
-                       void* cb_ctx = nullptr);
+                       void* cb_ctx = nullptr,
+                       const OrderBookOptions& options = {});
 
     ~OrderBook() ;
 
+    /** Install the retirement callback. Call before the first order. */
+    void set_order_done_callback(OrderDoneCallback callback) { order_done_callback_ = callback; }
+
+    /** Install the per-order execution callback. Call before the first order. */
+    void set_order_fill_callback(OrderFillCallback callback) { order_fill_callback_ = callback; }
+
+    /** Install the market-by-order callback (nullptr = off). Call before the first order. */
+    void set_order_event_callback(OrderEventCallback callback) { order_event_callback_ = callback; }
+
+    /** Context for every callback: the owner changes when the book moves to another engine. */
+    void set_callback_context(void* ctx) { callback_ctx_ = ctx; }
+
+    /**
+     * Collect retired orders in `batch` instead of freeing each one
+     * (nullptr = free immediately). The caller flushes it; it must
+     * outlive the book's use of it.
+     */
+    void set_release_batch(OrderReleaseBatch* batch) { release_batch_ = batch; }
+
     // Non-copyable, non-movable (owns complex state)
     OrderBook(const OrderBook&) = delete;
     OrderBook& operator=(const OrderBook&) = delete;
@@ -387,15 +1076,51 @@ public:
     /**
      * Add a new order to the book.
      * Attempts immediate matching, then rests remainder.
-     * @return Error if order is invalid or book is shut down.
+     * @return What changed, or an error if the order is invalid or the
+     *         book is shut down.
      */
-    [[nodiscard]] Result<void> add_order(Order* order);
+    [[nodiscard]] Result<BookChange> add_order(Order* order);
 
     /**
      * Cancel an existing order.
-     * @return Error if order not found or not owned by requester.
+     * @return What changed, or an error if the order is not found.
+     */
+    [[nodiscard]] Result<BookChange> cancel_order(OrderID order_id);
+
+    /**
+     * Cancel every live order (resting or parked stop) whose owner is
+     * `owner`, in one sweep of the order index. Each cancelled order is
+     * retired through the done callback exactly as cancel_order() does.
+     * @return Number of orders cancelled (0 for owner 0 — never matches);
+     *         what changed is in last_change()
+     */
+    size_t mass_cancel(ClientIDRaw owner);
+
+    /**
+     * Cancel/replace a resting order in one step.
+     *
+     *   Same price, size-down : remaining_quantity and level
+     *                           total_quantity adjusted in place —
+     *                           queue priority kept.
+     *   Same price, size-up   : requeued at the back of its level.
+     *   New price             : moved; may match on arrival like a
+     *                           new limit order (POST_ONLY is rejected
+     *                           with ORDER_WOULD_CROSS instead).
+     *
+     * Filled quantity is preserved (quantity − open is unchanged).
+     * Parked (untriggered) stop orders cannot be modified — ORDER_INVALID.
+     * A halted book only takes the same-price size-down (ORDER_HALTED).
+     * For iceberg orders new_quantity is the total open quantity;
+     * a size-down trims the hidden reserve first.
+     *
+     * @param new_quantity New open quantity (> 0)
+     * @param new_price    New price, 0 = keep current
      */
-    [[nodiscard]] Result<void> cancel_order(OrderID order_id);
+    [[nodiscard]] Result<BookChange> modify_order(OrderID order_id, Quantity new_quantity,
+                                                  Price new_price = 0);
+
+    /** What the last add / cancel / modify / mass cancel / uncross changed */
+    [[nodiscard]] const BookChange& last_change() const { return change_; }
 
     // ── Market Data (lock-free reads) ──────────────────────
 
@@ -419,37 +1144,215 @@ public:
      */
     void get_depth(DepthSnapshot& out, size_t max_levels = 10) const;
 
+    /**
+     * Orders and displayed quantity ahead of a resting order at its
+     * price, O(log n) in the level's depth (OrderBookOptions::
+     * queue_positions). Iceberg reserve is not counted. Owner thread.
+     * @return ORDER_NOT_FOUND if not resting, ORDER_INVALID for a parked
+     *         stop or a book without queue positions
+     */
+    [[nodiscard]] Result<QueuePosition> queue_position(OrderID order_id) const;
+
     /**
      * Get seqlock-protected BBO for cross-thread reads.
      * Safe to call from any thread (lock-free).
      * @param out  Snapshot filled with current BBO
-     * @return true if read was consistent, false if writer was active
+     * @return true if read was consistent, false if it kept racing the writer
+     */
+    [[nodiscard]] bool read_bbo(BBOSnapshot& out) const { return bbo_slot_->read(out); }
+
+    /**
+     * Publish the BBO into `slot` (the symbol's slot of an exchange-wide
+     * BBOTable) instead of the book's own; nullptr goes back to the own
+     * slot. The current top is published at once. Call before start().
+     */
+    void set_bbo_slot(BBOSlot* slot) {
+        bbo_slot_ = slot ? slot : &own_bbo_;
+        bbo_slot_->bbo.store(bbo_);
+    }
+
+    /** Latency histograms of add_order, matching and trade execution */
+    struct LatencySnapshot {
+        LatencyHistogram add_order;
+        LatencyHistogram match;
+        LatencyHistogram trade;
+    };
+
+    /** Snapshot of the book's latency histograms. Safe from any thread. */
+    [[nodiscard]] LatencySnapshot latency_snapshot() const;
+
+    /**
+     * Capture current depth into the cross-thread snapshot buffer.
+     * Owner thread only. Cost: one get_depth() into the back buffer.
+     * @param max_levels       Max levels per side to include
+     * @param update_sequence  Owner's count of book updates so far, so
+     *                         readers can line the snapshot up with a
+     *                         feed of incremental updates
+     */
+    void publish_depth(size_t max_levels = MAX_DEPTH_LEVELS, uint64_t update_sequence = 0);
+
+    /**
+     * Copy the most recently published depth snapshot.
+     * Safe to call from any thread (lock-free, never blocks matching).
+     * @return false if nothing published yet or the read kept racing
+     */
+    [[nodiscard]] bool read_depth(DepthSnapshot& out) const {
+        return depth_buffer_.read(out);
+    }
+
+    // ── Incremental Depth ──────────────────────────────────
+
+    /** Visible price level touched since the last drain_level_changes() */
+    struct LevelChange {
+        Side  side;
+        Price price;
+    };
+
+    /**
+     * Record each visible price level the book mutates (the stop books
+     * are not visible and never recorded), for a market-by-price feed.
+     * Off by default; the hot path then pays one predictable branch per
+     * level touched. Owner thread only.
+     */
+    void track_level_changes(bool enabled) {
+        track_levels_ = enabled;
+        level_changes_.clear();
+        if (enabled) level_changes_.reserve(LEVEL_CHANGE_RESERVE);
+    }
+
+    /**
+     * Call fn(side, price, total_quantity, order_count) with the current
+     * state of each level touched since the last drain — a level that
+     * emptied reports 0 / 0 — then forget them. Owner thread only.
      */
-    [[nodiscard]] bool read_bbo(BBOSnapshot& out) const;
+    template<typename Fn>
+    void drain_level_changes(Fn&& fn) {
+        for (const LevelChange& change : level_changes_) {
+            const FlatLevel* level = (change.side == Side::BUY) ? bids_.find(change.price)
+                                                                : asks_.find(change.price);
+            if (level) fn(change.side, change.price, level->total_quantity, static_cast<uint32_t>(level->size()));
+            else       fn(change.side, change.price, Quantity{0}, uint32_t{0});
+        }
+        level_changes_.clear();
+    }
 
     /** Total live orders in book */
     [[nodiscard]] size_t order_count() const { return order_lookup_.size(); }
 
-    // ── Maintenance (call between matching cycles) ─────────
+    /** Options the book was constructed with */
+    [[nodiscard]] const OrderBookOptions& options() const { return options_; }
+
+    /**
+     * Side of the order whose match is running (1=Buy, 2=Sell), or 0
+     * during an uncross. Read it from the trade callback.
+     */
+    [[nodiscard]] uint8_t sweep_aggressor() const { return sweep_aggressor_; }
+
+    // ── Call Auction ───────────────────────────────────────
+
+    [[nodiscard]] TradingPhase phase() const { return phase_; }
+
+    /**
+     * Enter the auction phase. New LIMIT / POST_ONLY orders rest
+     * without matching; other types are rejected (ORDER_INVALID).
+     * Cancel and modify keep working (a price move does not match).
+     */
+    void begin_auction() { phase_ = TradingPhase::AUCTION; }
+
+    /**
+     * Enter cancel-only mode: new orders and modifies are rejected
+     * (ORDER_HALTED) except a size-down at the same price; cancels and
+     * mass cancels keep working. Resting orders (and a crossed auction
+     * book) stay as they are: leave with begin_auction(), or uncross()
+     * to go straight back to CONTINUOUS.
+     */
+    void halt() { phase_ = TradingPhase::HALTED; }
+
+    // ── Price Band ─────────────────────────────────────────
+    //
+    // With OrderBookOptions::price_band_bps set, [band_low, band_high]
+    // is re-anchored on the last trade after every sweep that traded
+    // (and after uncross / restore); there is no band before the first
+    // trade. The bounds are precomputed, so the sweep pays nothing new
+    // per level: a limit order's price is clamped to the band once
+    // before its sweep and the existing crosses compare stops it there,
+    // and a market sweep compares each level against one bound (the
+    // full price range when the band is off).
+    //
+    // A sweep that stops at the band with liquidity left beyond it
+    // inside its own limit trips the circuit breaker: the book enters
+    // AUCTION (a volatility pause), the limit remainder rests in it, a
+    // market / IOC remainder is cancelled, and triggered stops wait for
+    // the uncross. The owner notices the CONTINUOUS → AUCTION change
+    // and decides when to uncross(). A FOK that could only fill through
+    // the band is rejected (ORDER_UNFILLABLE) without tripping.
+
+    [[nodiscard]] Price band_low() const { return band_low_; }
+    [[nodiscard]] Price band_high() const { return band_high_; }
+
+    /** Volatility pauses this book has entered (band breaches) */
+    [[nodiscard]] uint64_t volatility_pauses() const { return volatility_pauses_; }
 
     /**
-     * Compact price level vectors that have accumulated dead prefix.
-     * Call periodically from owner thread (e.g., every N orders).
+     * Price maximizing executable volume; ties go to the smaller
+     * imbalance, then the price nearest the last trade, then the
+     * lower price. One merge pass over the cumulative crossing
+     * bid/ask quantities — no order is touched.
      */
-    void compact() {
-        bids_.compact_all();
-        asks_.compact_all();
+    [[nodiscard]] AuctionResult indicative_uncross() const;
+
+    /**
+     * Execute the auction at indicative_uncross() in price-time
+     * priority — every fill prints at the equilibrium price — then
+     * return to CONTINUOUS. Triggered stops fire afterwards.
+     */
+    AuctionResult uncross();
+
+    // ── Maintenance (call between matching cycles) ─────────
+
+    /** Drained levels left as tombstones across both sides and the stop index */
+    [[nodiscard]] size_t tombstones() const {
+        return bids_.tombstones() + asks_.tombstones() + buy_stops_.tombstones() + sell_stops_.tombstones();
     }
 
     /**
-     * Remove all empty price levels.
+     * Remove all empty price levels. O(levels) per side: the engine
+     * runs it from its budgeted maintenance, one book at a time.
      * Call periodically from owner thread.
      */
     void prune() {
         bids_.prune_empty();
         asks_.prune_empty();
+        buy_stops_.prune_empty();
+        sell_stops_.prune_empty();
     }
 
+    // ── Snapshots ──────────────────────────────────────────
+
+    /**
+     * Copy the book into `image` (see BookImage). Owner thread, between
+     * operations; costs one Order copy per resting order, no allocation
+     * once the image has grown to the book.
+     */
+    void capture(BookImage& image) const;
+
+    /**
+     * Rebuild an empty book from `image`: orders are allocated from the
+     * pool, indexed and requeued in their original priority, and the
+     * trade id, last trade price and phase are taken back. No callback
+     * fires. Before the owner starts matching.
+     * @return ORDER_INVALID if the book is not empty, MEMORY_POOL_EXHAUSTED
+     *         if the pool runs out (the orders restored so far stay)
+     */
+    [[nodiscard]] Result<void> restore(const BookImage& image);
+
+    /**
+     * Replay: stamp trades with `now` instead of reading the clock, so a
+     * replayed sweep matches at the time its request was recorded.
+     * 0 goes back to the clock.
+     */
+    void set_clock(Timestamp now) { fixed_time_ = now; }
+
     /**
      * Initiate graceful shutdown. No new orders accepted after this.
      */
@@ -462,18 +1365,48 @@ private:
     // ═══════════════════════════════════════════════════════
 
     alignas(CACHE_LINE)
-    FlatPriceBook<true>  bids_;   // Descending: levels_[0] = best bid
-    FlatPriceBook<false> asks_;   // Ascending:  levels_[0] = best ask
+    FlatPriceBook<true>  bids_;   // Descending: best_level() = best bid
+    FlatPriceBook<false> asks_;   // Ascending:  best_level() = best ask
 
-    // O(1) lookup for cancellation
-    std::unordered_map<OrderID, Order*> order_lookup_;
+    // O(1) lookup for cancellation — flat, sized from pool, never allocates
+    OrderIdMap<Order*> order_lookup_;
+    std::vector<Order*> sweep_scratch_;  // mass_cancel victims (reused, grows on demand)
 
     // Trade ID generator (monotonic, no gaps)
     TradeID next_trade_id_{1};
 
+    // Last trade price — stop trigger reference (0 = no trade yet)
+    Price last_trade_price_{0};
+
+    // Match time of the current sweep: read at its first fill, shared by the rest (0 = not yet)
+    Timestamp sweep_time_{0};
+    Timestamp fixed_time_{0};  // set_clock(): replay time, 0 = read the clock
+    // Side of the order being matched (1=Buy, 2=Sell); 0 while uncrossing
+    uint8_t sweep_aggressor_{0};
+
     // Shutdown flag
     bool shutdown_requested_{false};
 
+    // Self-trade prevention mode (copied from options_ for the sweep)
+    SelfTradePrevention stp_{SelfTradePrevention::NONE};
+
+    // Trading phase — AUCTION suspends matching, HALTED also takes no orders
+    TradingPhase phase_{TradingPhase::CONTINUOUS};
+
+    // Price band bounds, precomputed from band_reference_ (full range = off)
+    Price band_low_{0};
+    Price band_high_{std::numeric_limits<Price>::max()};
+    Price band_reference_{0};  // last_trade_price_ the bounds were computed from
+
+    // Incremental depth: levels touched since the last drain (opt-in)
+    bool track_levels_{false};
+
+    // Current operation's change (begin_change / finish_change); the
+    // last level it noted, to fold repeats
+    BookChange change_;
+    Side  noted_side_{Side::BUY};
+    Price noted_price_{0};
+
     // ═══════════════════════════════════════════════════════
     //  WARM DATA — accessed less frequently
     // ═══════════════════════════════════════════════════════
@@ -482,9 +1415,35 @@ private:
     OrderPool& pool_;                  // Order memory pool (external)
     TradeCallback trade_callback_;     // Trade notification (function pointer)
     void* callback_ctx_{nullptr};      // Callback context
+    OrderDoneCallback order_done_callback_{nullptr};  // Retirement notification
+    OrderFillCallback order_fill_callback_{nullptr};  // Per-side execution notification
+    OrderEventCallback order_event_callback_{nullptr};  // Market by order (nullptr = off)
+    OrderReleaseBatch* release_batch_{nullptr};       // Deferred frees (nullptr = immediate)
+
+    // Top of book as last published (owner's copy, compared by
+    // finish_change) and the slot readers see it in: the book's own, or
+    // its symbol's slot of an exchange BBOTable (set_bbo_slot)
+    BBOSnapshot bbo_;
+    BBOSlot     own_bbo_;
+    BBOSlot*    bbo_slot_{&own_bbo_};
+
+    // Double-buffered depth for cross-thread reads (see publish_depth)
+    DepthSnapshotBuffer depth_buffer_;
 
-    // Seqlock-protected BBO for cross-thread reads
-    mutable BBOSnapshot bbo_snapshot_;
+    // Stop trigger index — parked STOP / STOP_LIMIT orders keyed by
+    // stop_price, outside the visible book. Same flat level storage
+    // as the sides; best_level() is the next stop to fire.
+    FlatPriceBook<false> buy_stops_;   // Ascending:  fires when last ≥ stop
+    FlatPriceBook<true>  sell_stops_;  // Descending: fires when last ≤ stop
+
+    // Levels touched since the last drain_level_changes(); capacity reused
+    std::vector<LevelChange> level_changes_;
+
+    // Uncross scratch (crossing levels best-first); capacity reused
+    mutable std::vector<DepthLevel> auction_bids_;
+    mutable std::vector<DepthLevel> auction_asks_;
+
+    uint64_t volatility_pauses_{0};  // Band breaches (see trip_band)
 
     // ═══════════════════════════════════════════════════════
     //  COLD DATA — setup/monitoring only
@@ -492,6 +1451,8 @@ private:
 
     alignas(CACHE_LINE)
     std::string symbol_;
+    OrderBookOptions options_;
+    std::unique_ptr<QueueSlots> queue_slots_;  // Level queue positions (options_.queue_positions)
 
     // Performance metrics (owned by this book, lazily initialized)
     struct Metrics {
@@ -508,9 +1469,51 @@ private:
     //  Matching Logic (single-writer, no locks)
     // ═══════════════════════════════════════════════════════
 
-    /** Dispatch to market or limit matching based on order type */
+    /**
+     * Dispatch on order type.
+     * POST_ONLY never matches (ORDER_WOULD_CROSS if it would);
+     * FOK is pre-checked with can_fill() (ORDER_UNFILLABLE).
+     * IOC/FOK/LIMIT share the limit sweep — add_order() decides
+     * whether the remainder rests.
+     */
     Result<void> match_order(Order* order);
 
+    /**
+     * Whether the opposite side holds order->remaining_quantity at
+     * crossing prices. Walks cumulative level total_quantity only —
+     * no order is touched. Stops as soon as enough is found.
+     * Hidden iceberg reserve is not counted (conservative).
+     */
+    [[nodiscard]] bool can_fill(const Order* order) const;
+
+    /** Whether a priced order on side at price would match on arrival */
+    [[nodiscard]] bool would_cross(Side side, Price price) const;
+
+    /** Count a touched visible level, and remember it if tracked; repeats of the last one are folded. */
+    void note_level(Side side, Price price) {
+        if (price == noted_price_ && side == noted_side_) return;
+        noted_side_  = side;
+        noted_price_ = price;
+        ++change_.levels;
+        if (!track_levels_) [[likely]] return;
+        if (!level_changes_.empty() && level_changes_.back().price == price &&
+            level_changes_.back().side == side) return;
+        level_changes_.push_back({side, price});
+    }
+
+    /** Report a change to a resting order (market by order); one branch when off. */
+    void emit_order_event(OrderEvent::Kind kind, const Order& order, Quantity quantity = 0) {
+        if (!order_event_callback_) [[likely]] return;
+        OrderEvent event;
+        event.order_id  = order.id;
+        event.price     = order.price;
+        event.remaining = order.remaining_quantity;
+        event.quantity  = quantity;
+        event.kind      = kind;
+        event.side      = order.side;
+        order_event_callback_(event, callback_ctx_);
+    }
+
     /** Sweep opposite book until filled or book empty */
     Result<void> match_market_order(Order* order);
 
@@ -520,6 +1523,23 @@ private:
      */
     Result<void> match_limit_order(Order* order);
 
+    /**
+     * Resolve an aggressor/passive pair with the same owner per stp_.
+     * May cancel or decrement either side; never trades.
+     * Caller removes the level if it drained.
+     * @return true if the aggressor is done (stop the sweep)
+     */
+    bool prevent_self_trade(Order* aggressor, FlatLevel& level, Order* passive);
+
+    /**
+     * Pop the front order once it has no displayed quantity left.
+     * Iceberg with reserve: next slice requeued at the back.
+     * Otherwise: unindexed, final_status set, returned to the pool.
+     * @param consumed Quantity to deduct from level total_quantity
+     */
+    void retire_front(FlatLevel& level, Order* passive, Quantity consumed,
+                      OrderStatus final_status);
+
     /**
      * Execute a single trade between aggressive and passive orders.
      * Publishes trade via callback. Updates BBO snapshot.
@@ -537,8 +1557,75 @@ private:
     /** Remove order from its price level and lookup map */
     void remove_from_book(Order* order);
 
-    /** Update seqlock-protected BBO snapshot after book change */
-    void update_bbo_snapshot();
+    /** Report a book-owned order as done, then return it to the pool */
+    void release(Order* order);
+
+    /** Start counting a new operation's change */
+    void begin_change() {
+        change_      = BookChange{};
+        noted_price_ = 0;
+    }
+
+    /** Compare the top of book with the published BBO, republish only if it changed */
+    const BookChange& finish_change();
+
+    // ═══════════════════════════════════════════════════════
+    //  Stop Triggers
+    // ═══════════════════════════════════════════════════════
+
+    /** Whether last trade price has reached o's stop price */
+    [[nodiscard]] bool stop_reached(const Order* o) const {
+        if (last_trade_price_ == 0) return false;
+        return (o->side == Side::BUY) ? (last_trade_price_ >= o->stop_price)
+                                      : (last_trade_price_ <= o->stop_price);
+    }
+
+    /** O(1): whether the best parked stop on either side has been reached */
+    [[nodiscard]] bool stops_triggered() const {
+        if (last_trade_price_ == 0) return false;
+        return (!buy_stops_.empty()  && buy_stops_.best_price()  <= last_trade_price_) ||
+               (!sell_stops_.empty() && sell_stops_.best_price() >= last_trade_price_);
+    }
+
+    /** Park an untriggered stop order in the trigger index */
+    Result<void> park_stop(Order* order);
+
+    /**
+     * Activate every reached stop in trigger-price then time order and
+     * run each through match_order() in this same call. Trades from
+     * activated stops update the last price, so cascades fire here too.
+     * Activated orders are book-owned: a remainder rests, otherwise
+     * the order returns to the pool.
+     */
+    void activate_stops();
+
+    /**
+     * After a sweep: re-anchor the band on the last trade if it moved.
+     * Off (price_band_bps 0) or before the first trade the band is the
+     * full price range.
+     */
+    void rebase_band() {
+        band_reference_ = last_trade_price_;
+        if (options_.price_band_bps == 0 || last_trade_price_ == 0) return;
+        const Price width = last_trade_price_ / 10000 * options_.price_band_bps +
+                            last_trade_price_ % 10000 * options_.price_band_bps / 10000;
+        band_low_  = (last_trade_price_ > width) ? last_trade_price_ - width : 0;
+        band_high_ = last_trade_price_ + width;
+    }
+
+    /**
+     * A sweep for `order` stopped short: trip into a volatility AUCTION
+     * if the best opposite price left (`next_level`) is still inside the
+     * order's own limit, i.e. only the band stopped it.
+     */
+    void trip_band(const Order* order, Price next_level) {
+        if (order->remaining_quantity == 0 || order->status == OrderStatus::CANCELLED || next_level == 0) return;
+        const bool within_limit = order->type == OrderType::MARKET ||
+            (order->side == Side::BUY ? order->price >= next_level : order->price <= next_level);
+        if (!within_limit) return;
+        phase_ = TradingPhase::AUCTION;
+        ++volatility_pauses_;
+    }
 };
 
 } // namespace rtes
\ No newline at end of file
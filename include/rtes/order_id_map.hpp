@@ -0,0 +1,181 @@
+#pragma once
+
+/**
+ * @file order_id_map.hpp
+ * @brief Pre-sized open-addressing OrderID → V map (no hot-path allocation)
+ *
+ * Replaces std::unordered_map<OrderID, ...> on the order path:
+ *
+ *   1. FLAT STORAGE
+ *      One contiguous slot array allocated at construction.
+ *      No node allocation per insert, no pointer chase per lookup,
+ *      no rehash spikes. insert() fails instead of growing.
+ *
+ *   2. LINEAR PROBING + FIBONACCI HASHING
+ *      home = (id × 2^64/φ) >> shift. Sequential order IDs spread
+ *      evenly over the table; probes walk adjacent slots (same or next
+ *      cache line).
+ *
+ *   3. TOMBSTONE-FREE DELETION (backward shift)
+ *      erase() pulls later members of the probe run back into the hole,
+ *      so lookups never wade through tombstones and the table never
+ *      needs periodic cleanup under cancel-heavy flow.
+ *
+ *   4. LOAD FACTOR ≤ 0.5
+ *      Slot count = next power of 2 ≥ 2 × max_entries.
+ *      Size max_entries from the order pool's max_capacity(), not
+ *      capacity(): a growable pool passes capacity() at run time, while
+ *      the map cannot grow. A map keyed by live orders then never fills.
+ *
+ * Key OrderID(~0) is reserved as the empty marker.
+ *
+ * Requirements:
+ *   - V must be trivially copyable (slots are moved by assignment)
+ *   - Single-threaded (owned by one writer thread)
+ *
+ * @tparam V Mapped value type
+ */
+
+#include "rtes/types.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace rtes {
+
+template<typename V>
+class OrderIdMap {
+    static_assert(std::is_trivially_copyable_v<V>,
+        "OrderIdMap requires trivially copyable V");
+
+public:
+    static constexpr OrderID EMPTY_KEY = ~OrderID{0};
+
+    /**
+     * @param max_entries Maximum live entries. Table holds 2× this
+     *                    (rounded up to a power of 2).
+     * @throws std::invalid_argument if max_entries is 0
+     */
+    explicit OrderIdMap(size_t max_entries)
+        : max_entries_(validate(max_entries))
+        , mask_(std::bit_ceil(max_entries * 2) - 1)
+        , shift_(64 - std::countr_zero(mask_ + 1))
+        , slots_(mask_ + 1)
+    {
+        clear();
+    }
+
+    // ── Lookup ──
+
+    [[nodiscard]] V* find(OrderID key) {
+        if (key == EMPTY_KEY) [[unlikely]] return nullptr;
+        const size_t i = probe(key);
+        return (slots_[i].key == key) ? &slots_[i].value : nullptr;
+    }
+
+    [[nodiscard]] const V* find(OrderID key) const {
+        if (key == EMPTY_KEY) [[unlikely]] return nullptr;
+        const size_t i = probe(key);
+        return (slots_[i].key == key) ? &slots_[i].value : nullptr;
+    }
+
+    [[nodiscard]] bool contains(OrderID key) const {
+        return key != EMPTY_KEY && slots_[probe(key)].key == key;
+    }
+
+    // ── Mutation ──
+
+    /**
+     * Insert a new entry. Never allocates.
+     * @return false if key already present, reserved, or map is at max_entries
+     */
+    [[nodiscard]] bool insert(OrderID key, const V& value) {
+        if (key == EMPTY_KEY) [[unlikely]] return false;
+        const size_t i = probe(key);
+        if (slots_[i].key == key) return false;
+        if (size_ >= max_entries_) [[unlikely]] return false;
+        slots_[i].key   = key;
+        slots_[i].value = value;
+        ++size_;
+        return true;
+    }
+
+    /**
+     * Remove an entry by backward-shifting the rest of its probe run.
+     * @return false if key not present
+     */
+    bool erase(OrderID key) {
+        if (key == EMPTY_KEY) [[unlikely]] return false;
+        size_t hole = probe(key);
+        if (slots_[hole].key != key) return false;
+
+        for (size_t j = (hole + 1) & mask_; slots_[j].key != EMPTY_KEY; j = (j + 1) & mask_) {
+            // Move j into the hole iff the hole lies on j's probe path
+            const size_t home = home_of(slots_[j].key);
+            if (((j - home) & mask_) >= ((j - hole) & mask_)) {
+                slots_[hole] = slots_[j];
+                hole = j;
+            }
+        }
+        slots_[hole].key = EMPTY_KEY;
+        --size_;
+        return true;
+    }
+
+    /** Reset to empty. O(capacity) — cold path only. */
+    void clear() {
+        for (auto& s : slots_) s.key = EMPTY_KEY;
+        size_ = 0;
+    }
+
+    /** Visit every (key, value). O(capacity) — cold path only. */
+    template<typename Fn>
+    void for_each(Fn&& fn) {
+        for (auto& s : slots_) {
+            if (s.key != EMPTY_KEY) fn(s.key, s.value);
+        }
+    }
+
+    // ── Observers ──
+
+    [[nodiscard]] size_t size()        const { return size_; }
+    [[nodiscard]] bool   empty()       const { return size_ == 0; }
+    [[nodiscard]] size_t max_entries() const { return max_entries_; }
+    [[nodiscard]] size_t capacity()    const { return mask_ + 1; }
+
+private:
+    struct Slot {
+        OrderID key;
+        V       value;
+    };
+
+    const size_t       max_entries_;
+    const size_t       mask_;     // capacity - 1
+    const unsigned     shift_;    // 64 - log2(capacity)
+    std::vector<Slot>  slots_;
+    size_t             size_{0};
+
+    static size_t validate(size_t n) {
+        if (n == 0) throw std::invalid_argument("OrderIdMap max_entries must be > 0");
+        return n;
+    }
+
+    [[nodiscard]] size_t home_of(OrderID key) const {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> shift_);
+    }
+
+    /** Slot holding key, or the empty slot that ends its probe run. */
+    [[nodiscard]] size_t probe(OrderID key) const {
+        size_t i = home_of(key);
+        while (slots_[i].key != key && slots_[i].key != EMPTY_KEY) {
+            i = (i + 1) & mask_;
+        }
+        return i;
+    }
+};
+
+} // namespace rtes
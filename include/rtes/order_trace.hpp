@@ -0,0 +1,293 @@
+#pragma once
+
+/**
+ * @file order_trace.hpp
+ * @brief Sampled end-to-end order lifecycle timestamps across the pipeline
+ *
+ * One order in N (chosen by a hash of its id, so every hop agrees without
+ * a flag on the order) is stamped with the TSC at each stage it passes:
+ *
+ *   gateway ──► risk ──────────────────► engine ────────────► aggregator
+ *   RECV        RISK_DEQUEUE             ENGINE_DEQUEUE         spans into
+ *               RISK_APPROVE             MATCHED ─ finish ─SPSC─► per-span
+ *                                                               histograms
+ *
+ * The stamps live in a side array indexed by the order's pool handle, so
+ * Order itself stays at two cache lines. Each hop writes its own stages
+ * before handing the order on, and the queue between hops orders those
+ * writes; the slot is reused only after the engine has finished the
+ * record and released the order.
+ *
+ * The engine copies a finished record into its own SPSC sink with one
+ * push (a full sink drops the sample and counts it). The gateway
+ * acks right after the risk enqueue, racing risk for the record, so it
+ * keeps the receive tick itself and sends recv → ack through its own
+ * sink instead. A background thread drains the sinks every millisecond
+ * into one LatencyTracker per span; monitoring reads snapshots of them.
+ *
+ * Orders rejected by risk are never finished (only recv → ack is
+ * recorded for them), and orders in growth segments of the pool
+ * (handles past OrderPool::initial_handles()) are not traced.
+ *
+ * With a SpanExporter set, the aggregator also turns every record into
+ * fixed-size TraceSpans and hands them over in one batch per drain, off
+ * the hot threads. Ids are derived from the order id (trace_id_for()),
+ * so the engine's record and the gateway's ack record land in the same
+ * trace without any context carried on the order:
+ *
+ *   order (RECV → MATCHED)            span_id_for(trace, ORDER_SPAN_ROOT)
+ *   ├─ gateway_to_risk, risk_check, risk_to_engine, match
+ *   └─ recv_to_ack (from the gateway's record)
+ */
+
+#include "rtes/types.hpp"
+#include "rtes/huge_pages.hpp"
+#include "rtes/latency_histogram.hpp"
+#include "rtes/memory_pool.hpp"
+#include "rtes/performance_optimizer.hpp"
+#include "rtes/spsc_queue.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace rtes {
+
+enum class OrderStage : uint8_t {
+    GATEWAY_RECV   = 0,  // Decoded and about to be enqueued to risk
+    RISK_DEQUEUE   = 1,
+    RISK_APPROVE   = 2,  // Checks passed, about to be enqueued to the engine
+    ENGINE_DEQUEUE = 3,
+    MATCHED        = 4,  // The book has processed it (matched and/or rested)
+    ACK_SENT       = 5,  // Ack queued to the session (gateway samples only)
+};
+inline constexpr size_t ORDER_STAGES = 6;
+
+/** Stage-to-stage intervals aggregated per order */
+enum class OrderSpan : uint8_t {
+    GATEWAY_TO_RISK = 0,  // RECV → RISK_DEQUEUE (risk ingress queue)
+    RISK_CHECK      = 1,  // RISK_DEQUEUE → RISK_APPROVE
+    RISK_TO_ENGINE  = 2,  // RISK_APPROVE → ENGINE_DEQUEUE (engine ingress queue)
+    MATCH           = 3,  // ENGINE_DEQUEUE → MATCHED
+    RECV_TO_MATCHED = 4,  // End to end inside the exchange
+    RECV_TO_ACK     = 5,
+};
+inline constexpr size_t ORDER_SPANS = 6;
+
+[[nodiscard]] const char* order_span_name(OrderSpan span);
+
+/** TscClock ticks per stage; 0 = not reached */
+struct alignas(64) OrderTrace {
+    std::array<uint64_t, ORDER_STAGES> ticks{};
+    OrderID order_id{0};
+
+    [[nodiscard]] uint64_t& at(OrderStage stage) { return ticks[static_cast<size_t>(stage)]; }
+    [[nodiscard]] uint64_t at(OrderStage stage) const { return ticks[static_cast<size_t>(stage)]; }
+};
+
+static_assert(std::is_trivially_copyable_v<OrderTrace>,
+              "OrderTrace must be trivially copyable for lock-free queues");
+
+using OrderTraceSink = SPSCQueue<OrderTrace>;
+
+/** What the gateway keeps between begin() and acked(); false = not traced */
+struct OrderTraceStart {
+    OrderID  order_id{0};
+    uint64_t recv_ticks{0};
+
+    explicit operator bool() const { return recv_ticks != 0; }
+};
+
+/** One exported span: ids as in OpenTelemetry (trace id zero-extended to 128 bits) */
+struct TraceSpan {
+    uint64_t    trace_id;
+    uint64_t    span_id;
+    uint64_t    parent_span_id;  // 0 = root
+    uint64_t    start_unix_ns;
+    uint64_t    end_unix_ns;
+    OrderID     order_id;
+    const char* name;            // Static: order_span_name() or "order"
+};
+
+static_assert(std::is_trivially_copyable_v<TraceSpan>);
+
+/** Called on the aggregator thread with each drain's spans */
+using SpanExporter = std::function<void(const TraceSpan* spans, size_t count)>;
+
+/** Root span of an order's trace; the OrderSpans are its children */
+inline constexpr size_t ORDER_SPAN_ROOT = ORDER_SPANS;
+
+[[nodiscard]] constexpr uint64_t trace_mix(uint64_t x) {  // splitmix64 finalizer
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/** Same on every hop; never 0 */
+[[nodiscard]] constexpr uint64_t trace_id_for(OrderID id) { return trace_mix(id + 0x9E3779B97F4A7C15ULL) | 1; }
+
+/** `span`: an OrderSpan index or ORDER_SPAN_ROOT; never 0 */
+[[nodiscard]] constexpr uint64_t span_id_for(uint64_t trace_id, size_t span) {
+    return trace_mix(trace_id + span + 1) | 1;
+}
+
+/**
+ * OTLP/JSON ExportTraceServiceRequest for `spans`, on one line (the
+ * format of the collector's otlpjsonfile receiver, or the body of a POST
+ * to /v1/traces).
+ */
+[[nodiscard]] std::string spans_to_otlp_json(const TraceSpan* spans, size_t count,
+                                             std::string_view service = "rtes");
+
+/** Per-thread sink into the aggregator (power of two) */
+inline constexpr size_t ORDER_TRACE_SINK_CAPACITY = 4096;
+
+/** Aggregated spans, indexed by OrderSpan */
+struct OrderTraceSnapshot {
+    uint32_t sample_every{0};
+    uint64_t traces{0};   // Records aggregated
+    uint64_t dropped{0};  // Records lost to a full sink
+    std::array<LatencyHistogram, ORDER_SPANS> spans;
+
+    [[nodiscard]] const LatencyHistogram& span(OrderSpan s) const { return spans[static_cast<size_t>(s)]; }
+};
+
+class OrderTracer {
+public:
+    /**
+     * @param pool         Pool the traced orders come from (side array sized from it)
+     * @param sample_every Trace 1 order in this many (rounded up to a power of 2)
+     * @param reactors     Gateway reactors (one sink each, see reactor_sink())
+     */
+    OrderTracer(const OrderPool& pool, uint32_t sample_every, size_t reactors = 1);
+    ~OrderTracer();
+
+    OrderTracer(const OrderTracer&) = delete;
+    OrderTracer& operator=(const OrderTracer&) = delete;
+
+    [[nodiscard]] uint32_t sample_every() const { return static_cast<uint32_t>(sample_mask_ + 1); }
+
+    /** Same answer on every hop: a multiplicative hash of the id */
+    [[nodiscard]] bool sampled(OrderID id) const {
+        return (((id * 0x9E3779B97F4A7C15ULL) >> 40) & sample_mask_) == 0;
+    }
+
+    /**
+     * Gateway, before the risk enqueue: start a fresh record.
+     * @return What to pass to acked(); false if not sampled
+     */
+    OrderTraceStart begin(const Order& order) {
+        if (!sampled(order.id)) [[likely]] return {};
+        OrderTrace* trace = record(order);
+        if (!trace) return {};
+        const uint64_t now = TscClock::now();
+        *trace = OrderTrace{};
+        trace->at(OrderStage::GATEWAY_RECV) = now;
+        trace->order_id = order.id;
+        return {order.id, now};
+    }
+
+    /** Risk: stamp `stage` on a sampled order */
+    void stamp(const Order& order, OrderStage stage) {
+        if (!sampled(order.id)) [[likely]] return;
+        if (OrderTrace* trace = record(order)) trace->at(stage) = TscClock::now();
+    }
+
+    /** Engine: stamp `stage` by pool handle */
+    void stamp(OrderHandle handle, OrderID id, OrderStage stage) {
+        if (!sampled(id)) [[likely]] return;
+        if (OrderTrace* trace = record(handle)) trace->at(stage) = TscClock::now();
+    }
+
+    /** Engine: stamp MATCHED and hand the record to `sink`. Before the order is released. */
+    void finish(OrderHandle handle, OrderID id, OrderTraceSink* sink) {
+        if (!sampled(id)) [[likely]] return;
+        OrderTrace* trace = record(handle);
+        if (!trace || !sink) return;
+        trace->at(OrderStage::MATCHED) = TscClock::now();
+        trace->order_id = id;
+        if (!sink->push(*trace)) dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /** Gateway: the ack for an order begin() returned `start` for was queued */
+    void acked(OrderTraceStart start, OrderTraceSink* sink) {
+        if (!start || !sink) return;
+        OrderTrace trace;
+        trace.order_id = start.order_id;
+        trace.at(OrderStage::GATEWAY_RECV) = start.recv_ticks;
+        trace.at(OrderStage::ACK_SENT)     = TscClock::now();
+        if (!sink->push(trace)) dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /** A sink for one more producer thread (an engine). Call before start(). */
+    OrderTraceSink* add_sink();
+
+    /** Sink of gateway reactor `reactor` (TcpGateway::set_order_tracer) */
+    [[nodiscard]] OrderTraceSink* reactor_sink(size_t reactor) const {
+        return reactor < reactors_ ? sinks_[reactor].get() : nullptr;
+    }
+
+    [[nodiscard]] size_t reactor_count() const { return reactors_; }
+
+    /** Also export every record as spans (see the file comment). Before start(). */
+    void set_span_exporter(SpanExporter exporter) { exporter_ = std::move(exporter); }
+
+    /** Spans handed to the exporter so far */
+    [[nodiscard]] uint64_t exported_spans() const { return exported_.load(std::memory_order_relaxed); }
+
+    /** Aggregator thread: drains the sinks every millisecond */
+    void start();
+    void stop();
+
+    /** Drain every sink once into the span histograms (aggregator thread, or tests when stopped) */
+    size_t drain();
+
+    /** Any thread */
+    [[nodiscard]] OrderTraceSnapshot snapshot() const;
+
+private:
+    [[nodiscard]] OrderTrace* record(OrderHandle handle) const {
+        return handle < records_count_ ? &records_[handle] : nullptr;
+    }
+
+    [[nodiscard]] OrderTrace* record(const Order& order) const {
+        return pool_.owns(&order) ? record(pool_.handle(&order)) : nullptr;
+    }
+
+    void aggregate(const OrderTrace& trace);
+    void add_spans(const OrderTrace& trace);
+    [[nodiscard]] uint64_t unix_ns(uint64_t ticks) const;
+    void run();
+
+    const OrderPool& pool_;
+    const uint64_t   sample_mask_;
+    PageRegion       region_;          // Backs records_
+    OrderTrace*      records_;         // One per initial pool handle
+    size_t           records_count_;
+
+    std::vector<std::unique_ptr<OrderTraceSink>> sinks_;  // Reactors' first, then add_sink()'s
+    size_t                                       reactors_;
+    std::vector<OrderTrace>                      drain_buffer_;
+    std::array<LatencyTracker, ORDER_SPANS>      spans_;  // Written by the aggregator only
+
+    SpanExporter           exporter_;
+    std::vector<TraceSpan> span_batch_;    // Aggregator only
+    uint64_t               base_ticks_;    // TSC ↔ wall clock, taken at construction
+    uint64_t               base_unix_ns_;
+
+    std::thread       thread_;
+    std::atomic<bool> running_{false};
+
+    alignas(64) std::atomic<uint64_t> traces_{0};
+    alignas(64) std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t>             exported_{0};
+};
+
+} // namespace rtes
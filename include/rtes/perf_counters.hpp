@@ -0,0 +1,105 @@
+#pragma once
+
+/**
+ * @file perf_counters.hpp
+ * @brief Hardware performance counters (perf_event_open) around benchmark phases
+ *
+ * PerfCounters opens one counter per PerfEvent, either on the calling
+ * thread or on every thread of another process (the exchange, from a
+ * load generator). Counters are opened disabled; start() resets and
+ * enables them, stop() disables and reads:
+ *
+ *   PerfCounters counters;            // This thread, user space only
+ *   counters.start();
+ *   ... phase ...
+ *   PerfCounterSample sample = counters.stop();
+ *   sample.per(orders, PerfEvent::LLC_MISSES);
+ *
+ * Events are opened one by one, not as a group, so a PMU with fewer
+ * counters than events still opens them all and time-multiplexes.
+ * Values are scaled by time_enabled / time_running; a multiplexed
+ * count is an estimate (PerfCounterSample::multiplexed).
+ *
+ * Kernel counting is excluded, so perf_event_paranoid ≤ 2 is enough for
+ * the calling process. Attaching to another process needs ptrace
+ * rights on it (same user, and ptrace_scope 0, or CAP_PERFMON). Events
+ * the host does not expose (most VMs lack a PMU) are simply missing
+ * from the sample; available() is false when none opened.
+ *
+ * Threads of an attached process started after construction are not
+ * counted: attach after the process has finished starting up.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+namespace rtes {
+
+enum class PerfEvent : uint8_t {
+    CYCLES        = 0,
+    INSTRUCTIONS  = 1,
+    L1D_MISSES    = 2,  // L1 data cache read misses
+    LLC_MISSES    = 3,  // Last-level cache misses
+    DTLB_MISSES   = 4,  // Data TLB read misses
+    BRANCH_MISSES = 5,
+};
+
+inline constexpr size_t PERF_EVENT_COUNT = 6;
+
+/** "cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses", "branch_misses" */
+[[nodiscard]] const char* perf_event_name(PerfEvent event);
+
+struct PerfCounterSample {
+    std::array<uint64_t, PERF_EVENT_COUNT> values{};
+    std::array<bool, PERF_EVENT_COUNT>     valid{};  // Event opened and ran
+    bool multiplexed{false};                          // Some event ran part of the time
+
+    [[nodiscard]] bool     has(PerfEvent event) const { return valid[static_cast<size_t>(event)]; }
+    [[nodiscard]] uint64_t value(PerfEvent event) const { return values[static_cast<size_t>(event)]; }
+    [[nodiscard]] bool     empty() const;
+
+    /** Count per unit of work (per order, per request); 0 if missing */
+    [[nodiscard]] double per(uint64_t units, PerfEvent event) const;
+    /** Instructions per cycle; 0 if either is missing */
+    [[nodiscard]] double ipc() const;
+};
+
+class PerfCounters {
+public:
+    /** Count the calling thread (and only it) */
+    PerfCounters();
+
+    /** Count every current thread of process `pid` */
+    explicit PerfCounters(pid_t pid);
+
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /** Some event opened */
+    [[nodiscard]] bool available() const { return !fds_.empty(); }
+
+    /** Why nothing opened (errno text of the first failure); empty if available */
+    [[nodiscard]] const std::string& error() const { return error_; }
+
+    void start();
+    PerfCounterSample stop();
+
+private:
+    struct Counter {
+        int       fd;
+        PerfEvent event;
+    };
+
+    void open_thread(pid_t tid);
+
+    std::vector<Counter> fds_;
+    std::string          error_;
+};
+
+} // namespace rtes
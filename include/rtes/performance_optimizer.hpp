@@ -1,10 +1,13 @@
 #pragma once
 
 #include "rtes/types.hpp"
+#include "rtes/latency_histogram.hpp"
 #include <string_view>
 #include <chrono>
 #include <atomic>
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <memory>
 #if defined(__x86_64__) || defined(_M_X64)
 #include <immintrin.h>
@@ -21,7 +24,6 @@ public:
     static bool is_valid_symbol_fast(std::string_view symbol) noexcept;
     
 private:
-    static constexpr bool is_alpha_upper(char c) noexcept { return c >= 'A' && c <= 'Z'; }
     static constexpr bool is_digit(char c) noexcept { return c >= '0' && c <= '9'; }
 };
 
@@ -148,55 +150,143 @@ struct OrderBookLevelsSOA {
     }
 };
 
-// Real-time latency tracker with minimal overhead
+/**
+ * Cycle counter for interval timing: rdtsc on x86-64, cntvct_el0 on
+ * AArch64, steady_clock elsewhere. Ticks convert to nanoseconds with a
+ * factor calibrated once against steady_clock (x86-64: a 10 ms spin;
+ * AArch64: cntfrq_el0). calibrate() runs that at startup (Exchange,
+ * OrderTracer and LatencyTracker construction), so conversions only
+ * read the cached factor; before it, to_ns() returns 0. Assumes an invariant TSC, as on any
+ * current server part; only differences of two readings mean anything.
+ */
+class TscClock {
+public:
+    static uint64_t now() noexcept {
+#if defined(__x86_64__) || defined(_M_X64)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t ticks;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+        return ticks;
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    /** Measure the tick rate (first call only) and publish it to ns_per_tick() */
+    static void calibrate() noexcept;
+
+    [[nodiscard]] static double ns_per_tick() noexcept {
+        return ns_per_tick_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] static uint64_t to_ns(uint64_t ticks) noexcept {
+        return static_cast<uint64_t>(static_cast<double>(ticks) * ns_per_tick());
+    }
+
+private:
+    static double measure() noexcept;
+
+    static inline std::atomic<double> ns_per_tick_{0.0};
+};
+
+/**
+ * Real-time latency tracker with minimal overhead.
+ *
+ * Single writer: the owner thread records with plain load + store on
+ * relaxed atomics (no lock prefix, no CAS), all on its own cache lines.
+ * Any thread may read get_stats() or take a snapshot() for percentiles;
+ * a read racing a record may miss that one value.
+ *
+ * Timed through ScopedLatencyMeasurement, only 1 call in
+ * set_sample_every() is measured; count() is then the sampled calls.
+ */
 class LatencyTracker {
 public:
-    LatencyTracker() : count_(0), total_ns_(0), min_ns_(UINT64_MAX), max_ns_(0) {}
-    
+    LatencyTracker() { TscClock::calibrate(); }
+
+    /** Time 1 call in `every` (rounded up to a power of 2; 1 = every call). Before use. */
+    void set_sample_every(uint32_t every) noexcept {
+        sample_mask_ = std::bit_ceil(std::max<uint64_t>(every, 1)) - 1;
+    }
+
+    /** Owner thread: should this call be timed? */
+    [[nodiscard]] bool sample() noexcept { return (calls_++ & sample_mask_) == 0; }
+
+    /** Owner thread: record an interval measured in TscClock ticks */
+    void record_ticks(uint64_t ticks) noexcept { record_latency(TscClock::to_ns(ticks)); }
+
+    /** Owner thread only */
     void record_latency(uint64_t latency_ns) noexcept {
-        count_.fetch_add(1, std::memory_order_relaxed);
-        total_ns_.fetch_add(latency_ns, std::memory_order_relaxed);
-        
-        // Update min/max with compare-and-swap
-        uint64_t current_min = min_ns_.load(std::memory_order_relaxed);
-        while (latency_ns < current_min && 
-               !min_ns_.compare_exchange_weak(current_min, latency_ns, std::memory_order_relaxed)) {}
-        
-        uint64_t current_max = max_ns_.load(std::memory_order_relaxed);
-        while (latency_ns > current_max && 
-               !max_ns_.compare_exchange_weak(current_max, latency_ns, std::memory_order_relaxed)) {}
+        bump(buckets_[latency_buckets::index(latency_ns)], 1);
+        bump(count_, 1);
+        bump(total_ns_, latency_ns);
+        if (latency_ns < min_ns_.load(std::memory_order_relaxed)) {
+            min_ns_.store(latency_ns, std::memory_order_relaxed);
+        }
+        if (latency_ns > max_ns_.load(std::memory_order_relaxed)) {
+            max_ns_.store(latency_ns, std::memory_order_relaxed);
+        }
     }
-    
+
     struct Stats {
         uint64_t count;
         uint64_t avg_ns;
         uint64_t min_ns;
         uint64_t max_ns;
+        uint64_t p50_ns;
+        uint64_t p99_ns;
+        uint64_t p999_ns;
     };
-    
+
     Stats get_stats() const noexcept {
-        uint64_t count = count_.load(std::memory_order_relaxed);
-        uint64_t total = total_ns_.load(std::memory_order_relaxed);
+        const LatencyHistogram histogram = snapshot();
         return {
-            count,
-            count > 0 ? total / count : 0,
+            histogram.count(),
+            histogram.mean_ns(),
             min_ns_.load(std::memory_order_relaxed),
-            max_ns_.load(std::memory_order_relaxed)
+            histogram.max_ns(),
+            histogram.percentile(50),
+            histogram.percentile(99),
+            histogram.percentile(99.9),
         };
     }
-    
+
+    /** Copy of the buckets for percentile queries and merging. Any thread. */
+    LatencyHistogram snapshot() const noexcept {
+        LatencyHistogram histogram;
+        for (size_t i = 0; i < latency_buckets::COUNT; ++i) {
+            histogram.counts_[i] = buckets_[i].load(std::memory_order_relaxed);
+        }
+        histogram.count_  = count_.load(std::memory_order_relaxed);
+        histogram.sum_ns_ = total_ns_.load(std::memory_order_relaxed);
+        histogram.min_ns_ = min_ns_.load(std::memory_order_relaxed);
+        histogram.max_ns_ = max_ns_.load(std::memory_order_relaxed);
+        return histogram;
+    }
+
+    /** Owner thread only (or while no one records) */
     void reset() noexcept {
+        for (auto& bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
         count_.store(0, std::memory_order_relaxed);
         total_ns_.store(0, std::memory_order_relaxed);
         min_ns_.store(UINT64_MAX, std::memory_order_relaxed);
         max_ns_.store(0, std::memory_order_relaxed);
     }
-    
+
 private:
-    alignas(64) std::atomic<uint64_t> count_;
-    alignas(64) std::atomic<uint64_t> total_ns_;
-    alignas(64) std::atomic<uint64_t> min_ns_;
-    alignas(64) std::atomic<uint64_t> max_ns_;
+    static void bump(std::atomic<uint64_t>& counter, uint64_t by) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    alignas(64) std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> total_ns_{0};
+    std::atomic<uint64_t> min_ns_{UINT64_MAX};
+    std::atomic<uint64_t> max_ns_{0};
+    uint64_t              calls_{0};        // Owner-only sampling state
+    uint64_t              sample_mask_{0};
+    std::array<std::atomic<uint64_t>, latency_buckets::COUNT> buckets_{};
 };
 
 // Memory usage monitor
@@ -287,23 +377,30 @@ public:
     }
 };
 
-// RAII latency measurement
+// RAII latency measurement: two TSC reads on a sampled call, none otherwise
 class ScopedLatencyMeasurement {
 public:
-    explicit ScopedLatencyMeasurement(LatencyTracker& tracker) 
-        : tracker_(tracker), start_time_(HighResTimer::now_ns()) {}
-    
+    explicit ScopedLatencyMeasurement(LatencyTracker& tracker) noexcept
+        : tracker_(tracker), start_ticks_(tracker.sample() ? TscClock::now() : 0) {}
+
     ~ScopedLatencyMeasurement() {
-        uint64_t end_time = HighResTimer::now_ns();
-        tracker_.record_latency(end_time - start_time_);
+        if (start_ticks_) tracker_.record_ticks(TscClock::now() - start_ticks_);
     }
-    
+
 private:
     LatencyTracker& tracker_;
-    uint64_t start_time_;
+    uint64_t start_ticks_;  // 0 = call not sampled
 };
 
+// Building with RTES_NO_INSTRUMENTATION (cmake -DRTES_INSTRUMENTATION=OFF)
+// compiles the hot-path timers and event counters out entirely
+#ifdef RTES_NO_INSTRUMENTATION
+#define MEASURE_LATENCY(tracker) ((void)0)
+#define RECORD_EVENT(tracker) ((void)0)
+#else
 #define MEASURE_LATENCY(tracker) ScopedLatencyMeasurement _measure(tracker)
+#define RECORD_EVENT(tracker) (tracker).record_event()
+#endif
 
 // Performance optimizer orchestrator
 class PerformanceOptimizer {
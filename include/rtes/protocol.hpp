@@ -2,6 +2,7 @@
 
 #include "rtes/types.hpp"
 #include "rtes/memory_safety.hpp"
+#include <bit>
 #include <cstdint>
 #include <cstring>
 
@@ -25,8 +26,16 @@ struct MessageHeader {
 enum MessageType : uint32_t {
     NEW_ORDER = 1,
     CANCEL_ORDER = 2,
+    MODIFY_ORDER = 3,
+    MASS_CANCEL = 4,
+    LOGON = 5,
+    BATCH = 6,           // Protocol v2 only
+    DROP_COPY_REQUEST = 7,  // Drop-copy port only
     ORDER_ACK = 101,
     TRADE_REPORT = 102,
+    BATCH_ACK = 103,
+    DROP_COPY_ACK = 104,
+    DROP_COPY_REPORT = 105,
     HEARTBEAT = 200
 };
 
@@ -39,7 +48,9 @@ struct NewOrderMessage {
     uint8_t side;        // 1=Buy, 2=Sell
     uint64_t quantity;
     uint64_t price;      // Fixed point (price * 10000)
-    uint8_t order_type;  // 1=Market, 2=Limit
+    uint8_t order_type;  // 1=Market, 2=Limit, 3=IOC, 4=FOK, 5=Post-only, 6=Stop, 7=Stop-limit
+    uint64_t display_quantity{0};  // Iceberg slice size; 0 = fully displayed
+    uint64_t stop_price{0};        // Trigger for Stop / Stop-limit (fixed point)
     
     NewOrderMessage() = default;
 };
@@ -53,16 +64,205 @@ struct CancelOrderMessage {
     CancelOrderMessage() = default;
 };
 
+/**
+ * Atomic cancel/replace. Reducing quantity at the same price keeps
+ * queue priority; a size-up or price change requeues the order.
+ */
+struct ModifyOrderMessage {
+    MessageHeader header;
+    uint64_t order_id;
+    BoundedString<32> client_id;
+    BoundedString<8> symbol;
+    uint64_t new_quantity;  // New open quantity (> 0; use CANCEL_ORDER to remove)
+    uint64_t new_price;     // Fixed point; 0 = keep current price
+    
+    ModifyOrderMessage() = default;
+};
+
+/** Scope of a MassCancelMessage */
+enum MassCancelScope : uint8_t {
+    MASS_CANCEL_SESSION = 1,  // The client this session trades as (client_id ignored)
+    MASS_CANCEL_CLIENT  = 2,  // client_id, every symbol
+    MASS_CANCEL_SYMBOL  = 3   // client_id, `symbol` only
+};
+
+/**
+ * Cancel all of a client's live orders in one request (kill switch).
+ * Acked once with order_id 0; each cancelled order then reports like
+ * a single cancel.
+ */
+struct MassCancelMessage {
+    MessageHeader header;
+    uint8_t scope;       // MassCancelScope
+    BoundedString<32> client_id;
+    BoundedString<8> symbol;
+
+    MassCancelMessage() = default;
+};
+
+/** LogonMessage::protocol_version */
+inline constexpr uint8_t PROTOCOL_V1 = 1;
+inline constexpr uint8_t PROTOCOL_V2 = 2;
+
+/**
+ * First message on a session, always in v1 framing. Binds the session
+ * to client_id and selects the framing of every message that follows
+ * (v2 messages carry no client id at all). Acked with order_id 0.
+ * Sessions that never log on stay on v1.
+ *
+ * auth_token is checked once, here, when the gateway requires session
+ * authentication; later messages are authorized against what the logon
+ * granted. A logon that ends before the token (LOGON_MIN_LENGTH) is
+ * accepted only by gateways that do not.
+ */
+struct LogonMessage {
+    MessageHeader header;
+    BoundedString<32> client_id;
+    uint8_t protocol_version;  // PROTOCOL_V1 or PROTOCOL_V2
+    BoundedString<128> auth_token;
+
+    LogonMessage() = default;
+};
+
+/** Shortest accepted logon: everything up to auth_token */
+inline constexpr size_t LOGON_MIN_LENGTH =
+    sizeof(MessageHeader) + sizeof(BoundedString<32>) + sizeof(uint8_t);
+static_assert(LOGON_MIN_LENGTH + sizeof(BoundedString<128>) == sizeof(LogonMessage));
+
+// ═══════════════════════════════════════════════════════════════
+//  Protocol v2: fixed-width, little-endian, no strings
+// ═══════════════════════════════════════════════════════════════
+//
+// Client → exchange only; responses keep the v1 layout. Identity comes
+// from the logon, symbols are InstrumentIDs from the exchange's
+// InstrumentDirectory (config order), and there is no checksum — TCP
+// already covers it.
+
+static_assert(std::endian::native == std::endian::little,
+              "Protocol v2 structs are read in place and are little-endian on the wire");
+
+struct MessageHeaderV2 {
+    uint16_t length;    // Whole message, header included
+    uint8_t  type;      // MessageType (NEW_ORDER .. MASS_CANCEL, HEARTBEAT)
+    uint8_t  reserved{0};
+};
+
+struct NewOrderV2 {
+    MessageHeaderV2 header;
+    uint64_t order_id;
+    uint16_t instrument;
+    uint8_t  side;              // 1=Buy, 2=Sell
+    uint8_t  order_type;        // As NewOrderMessage::order_type
+    uint32_t quantity;
+    uint64_t price;             // Fixed point (price * 10000)
+    uint32_t display_quantity;  // Iceberg slice size; 0 = fully displayed
+    uint64_t stop_price;        // Stop / Stop-limit trigger (fixed point)
+};
+
+struct CancelOrderV2 {
+    MessageHeaderV2 header;
+    uint64_t order_id;
+};
+
+struct ModifyOrderV2 {
+    MessageHeaderV2 header;
+    uint64_t order_id;
+    uint32_t new_quantity;  // > 0
+    uint64_t new_price;     // Fixed point; 0 = keep current price
+};
+
+/** MASS_CANCEL_SESSION / _CLIENT: the logged-on client. _SYMBOL: `instrument` only. */
+struct MassCancelV2 {
+    MessageHeaderV2 header;
+    uint8_t  scope;  // MassCancelScope
+    uint8_t  reserved{0};
+    uint16_t instrument;
+};
+
+/** BatchEntryV2::action */
+enum BatchAction : uint8_t {
+    BATCH_NEW_ORDER    = 1,
+    BATCH_CANCEL_ORDER = 2,
+    BATCH_MODIFY_ORDER = 3
+};
+
+/** Entries per BATCH (fits one 4 KiB frame) */
+inline constexpr uint16_t MAX_BATCH_ENTRIES = 100;
+
+/**
+ * One order, cancel or modify inside a BATCH. Fields a given action
+ * does not use are ignored (modify: quantity/price are the new values).
+ */
+struct BatchEntryV2 {
+    uint8_t  action;            // BatchAction
+    uint8_t  side;
+    uint8_t  order_type;
+    uint8_t  reserved{0};
+    uint16_t instrument;
+    uint16_t reserved2{0};
+    uint64_t order_id;
+    uint32_t quantity;
+    uint32_t display_quantity;
+    uint64_t price;
+    uint64_t stop_price;
+};
+
+/**
+ * Up to MAX_BATCH_ENTRIES requests in one frame (a quote update), handed
+ * to risk with one enqueue and answered with one BATCH_ACK. Followed by
+ * `count` BatchEntryV2; header.length covers them.
+ */
+struct BatchV2 {
+    MessageHeaderV2 header;
+    uint16_t count;
+    uint16_t reserved{0};
+};
+
+static_assert(sizeof(MessageHeaderV2) == 4);
+static_assert(sizeof(NewOrderV2) == 40);
+static_assert(sizeof(CancelOrderV2) == 12);
+static_assert(sizeof(ModifyOrderV2) == 24);
+static_assert(sizeof(MassCancelV2) == 8);
+static_assert(sizeof(BatchEntryV2) == 40);
+static_assert(sizeof(BatchV2) == 8);
+
 // Exchange to Client messages
 struct OrderAckMessage {
     MessageHeader header;
     uint64_t order_id;
-    uint8_t status;      // 1=Accepted, 2=Rejected
+    uint8_t status;      // 1=Accepted, 2=Rejected, 3=Cancelled, 4=Filled
     BoundedString<32> reason;
     
     OrderAckMessage() = default;
 };
 
+/** BatchAckEntry::reason (gateway-side refusals; risk rejects follow as ORDER_ACK) */
+enum BatchRejectReason : uint8_t {
+    BATCH_OK                 = 0,
+    BATCH_INVALID_ACTION     = 1,
+    BATCH_UNKNOWN_INSTRUMENT = 2,
+    BATCH_POOL_EXHAUSTED     = 3,
+    BATCH_DUPLICATE_ID       = 4,
+    BATCH_QUEUE_FULL         = 5,
+    BATCH_NOT_PERMITTED      = 6,  // The session's grant does not cover the action
+    BATCH_INVALID_FIELDS     = 7   // Out of range (side, type, quantity, prices, id)
+};
+
+struct BatchAckEntry {
+    uint64_t order_id;
+    uint8_t  status;   // As OrderAckMessage::status (1=Accepted, 2=Rejected)
+    uint8_t  reason;   // BatchRejectReason
+};
+
+/** One ack for a whole BATCH, entries in request order. Followed by `count` BatchAckEntry. */
+struct BatchAckMessage {
+    MessageHeader header;
+    uint16_t count;
+    uint16_t accepted;
+
+    BatchAckMessage() = default;
+};
+
 struct TradeMessage {
     MessageHeader header;
     uint64_t trade_id;
@@ -76,6 +276,62 @@ struct TradeMessage {
     TradeMessage() = default;
 };
 
+// ═══════════════════════════════════════════════════════════════
+//  Drop copy (post-trade feed, its own port)
+// ═══════════════════════════════════════════════════════════════
+
+/**
+ * Subscribe to every execution report of client_id (the firm), starting
+ * at the firm's sequence `next_sequence` (0 = from the next report).
+ * Sent again on the same connection, it rewinds: a gap replay.
+ * auth_token's user must be the firm or hold "drop_copy:<firm>".
+ */
+struct DropCopyRequest {
+    MessageHeader header;
+    BoundedString<32> client_id;
+    uint64_t next_sequence;
+    BoundedString<128> auth_token;
+
+    DropCopyRequest() = default;
+};
+
+/**
+ * Answer to a DropCopyRequest. next_sequence is the first report that
+ * follows; above the requested one, the journal no longer held the gap.
+ */
+struct DropCopyAck {
+    MessageHeader header;
+    uint64_t next_sequence;
+    uint8_t  status;     // 1=Accepted, 2=Rejected (not entitled, or firm table full)
+
+    DropCopyAck() = default;
+};
+
+/** DropCopyReport::exec_type */
+enum DropCopyExecType : uint8_t {
+    DROP_COPY_FILL     = 1,
+    DROP_COPY_DONE     = 2,
+    DROP_COPY_REJECTED = 3
+};
+
+/** One execution report of the firm. header.sequence is the firm's sequence (1, 2, ...). */
+struct DropCopyReport {
+    MessageHeader header;
+    uint8_t  exec_type;        // DropCopyExecType
+    uint8_t  side;             // FILL: the firm's side (1=Buy, 2=Sell)
+    uint8_t  status;           // DONE: OrderStatus (3=Filled, 5=Cancelled)
+    uint32_t reason;           // REJECTED: error code
+    uint64_t order_id;         // The firm's order
+    uint64_t trade_id;         // FILL
+    BoundedString<8> symbol;   // FILL
+    uint64_t quantity;         // FILL: executed; DONE: total filled
+    uint64_t price;            // FILL
+    uint64_t leaves_quantity;  // DONE
+    uint64_t timestamp_ns;     // FILL: execution time; else when journaled
+
+    DropCopyReport() = default;
+};
+
 struct HeartbeatMessage {
     MessageHeader header;
     uint64_t timestamp_ns;
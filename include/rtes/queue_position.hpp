@@ -0,0 +1,121 @@
+#pragma once
+
+/**
+ * @file queue_position.hpp
+ * @brief Per-level cumulative quantity for O(log n) queue position queries
+ *
+ * Each order resting on a tracked level holds a position in its level's
+ * QueueSums: positions are handed out in arrival order, so the FIFO is
+ * the position order. The sums are a Fenwick tree over positions, each
+ * holding the order's displayed quantity and a count of 1:
+ *
+ *   rest          append(qty)           O(log n)
+ *   fill / cancel remove(pos, qty)       O(log n)
+ *   partial fill  reduce(pos, qty)       O(log n)
+ *   ahead of X    before(pos(X))         O(log n), no walk of the level
+ *
+ * Filled, cancelled and requeued orders leave their position at zero,
+ * so positions are only reclaimed when the level empties (rewind) or
+ * runs out of them, when the live orders are renumbered into a tree
+ * twice their count: amortized O(log n) per rest.
+ *
+ * The position of each order is kept outside Order (which is full) in
+ * one QueueSlots table per book, indexed by pool handle.
+ *
+ * Quantities use modular arithmetic: removals add the two's complement,
+ * and every prefix of live positions sums to a real quantity.
+ *
+ * Single-threaded (owned by the book's thread).
+ */
+
+#include "rtes/types.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rtes {
+
+inline constexpr size_t QUEUE_SUMS_MIN = 64;  // Smallest position range of a tracked level
+
+/** Orders and displayed quantity queued ahead of one resting order */
+struct QueuePosition {
+    uint32_t orders_ahead{0};
+    Quantity quantity_ahead{0};
+};
+
+/** Fenwick tree of displayed quantity and order count over one level's FIFO positions */
+class QueueSums {
+public:
+    /** No position left: renumber before the next append() */
+    [[nodiscard]] bool full() const { return next_ + 1 >= tree_.size(); }
+
+    /** Start positions over. @pre every position is back to zero (level empty) */
+    void rewind() { next_ = 0; }
+
+    /** Zero `capacity` positions and start over */
+    void reset(size_t capacity) {
+        tree_.assign(capacity + 1, Node{});
+        next_ = 0;
+    }
+
+    /** Queue `qty` at the next position. @pre !full() @return The position */
+    uint32_t append(Quantity qty) {
+        const uint32_t pos = next_++;
+        add(pos, 1, qty);
+        return pos;
+    }
+
+    /** The order at `pos` shows `qty` less (partial fill, size-down) */
+    void reduce(uint32_t pos, Quantity qty) { add(pos, 0, Quantity{0} - qty); }
+
+    /** The order at `pos`, still showing `qty`, leaves the queue */
+    void remove(uint32_t pos, Quantity qty) { add(pos, ~uint32_t{0}, Quantity{0} - qty); }
+
+    /** Sums over the positions before `pos` */
+    [[nodiscard]] QueuePosition before(uint32_t pos) const {
+        QueuePosition ahead;
+        for (size_t i = pos; i > 0; i &= i - 1) {
+            ahead.orders_ahead   += tree_[i].orders;
+            ahead.quantity_ahead += tree_[i].quantity;
+        }
+        return ahead;
+    }
+
+private:
+    struct Node {
+        Quantity quantity{0};
+        uint32_t orders{0};
+    };
+
+    void add(uint32_t pos, uint32_t orders, Quantity qty) {
+        for (size_t i = size_t{pos} + 1; i < tree_.size(); i += i & (~i + 1)) {
+            tree_[i].orders   += orders;
+            tree_[i].quantity += qty;
+        }
+    }
+
+    std::vector<Node> tree_;  // 1-based; tree_.size() - 1 positions
+    uint32_t          next_{0};
+};
+
+/** QueueSums position of every tracked resting order, by pool handle (one per book) */
+class QueueSlots {
+public:
+    explicit QueueSlots(size_t capacity) : slots_(capacity) {}
+
+    /** Slot of `handle`; grows with the pool's handle range */
+    uint32_t& operator[](OrderHandle handle) {
+        if (handle >= slots_.size()) [[unlikely]] slots_.resize(std::bit_ceil(size_t{handle} + 1));
+        return slots_[handle];
+    }
+
+    /** @pre `handle` was assigned a slot */
+    [[nodiscard]] uint32_t at(OrderHandle handle) const { return slots_[handle]; }
+
+private:
+    std::vector<uint32_t> slots_;
+};
+
+} // namespace rtes
@@ -0,0 +1,128 @@
+#pragma once
+
+/**
+ * @file queue_telemetry.hpp
+ * @brief Opt-in occupancy and residence-time sampling for the lock-free queues
+ *
+ * A queue with telemetry enabled samples one position in every N
+ * (N a power of two):
+ *
+ *   producer  on a sampled push, reads the consumer index once to
+ *             measure the depth (high watermark) and stamps the clock
+ *             into a side array, one stamp per sampled slot
+ *   consumer  on taking a sampled position, reads its stamp back and
+ *             records now - stamp (enqueue → dequeue residence)
+ *
+ * The stamp is written before the producer publishes the position and
+ * read before the consumer releases it, so the queue's own
+ * release/acquire pair orders it; a stamp slot is reused only a full
+ * ring later. A queue without telemetry pays one predictable branch on
+ * a null probe per push and pop.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace rtes {
+
+/** Snapshot of one queue's telemetry (monitoring) */
+struct QueueTelemetry {
+    size_t   sample_every{0};       // 0 = telemetry off
+    size_t   high_water{0};         // Deepest the queue was seen at a sampled push
+    uint64_t samples{0};            // Residence times measured
+    uint64_t residence_sum_ns{0};
+    uint64_t residence_max_ns{0};
+
+    [[nodiscard]] double mean_residence_ns() const {
+        return samples ? static_cast<double>(residence_sum_ns) / static_cast<double>(samples) : 0.0;
+    }
+};
+
+class QueueProbe {
+public:
+    /**
+     * @param capacity     Queue capacity (a power of 2)
+     * @param sample_every Sample one position in this many; rounded up to
+     *                     a power of 2 and capped at the capacity
+     */
+    QueueProbe(size_t capacity, size_t sample_every)
+        : shift_(std::countr_zero(std::bit_ceil(std::clamp<size_t>(sample_every, 1, capacity))))
+        , sample_mask_((size_t{1} << shift_) - 1)
+        , stamp_mask_((capacity >> shift_) - 1)
+        , stamps_(std::make_unique<std::atomic<uint64_t>[]>(capacity >> shift_)) {}
+
+    QueueProbe(const QueueProbe&) = delete;
+    QueueProbe& operator=(const QueueProbe&) = delete;
+
+    [[nodiscard]] size_t sample_every() const { return sample_mask_ + 1; }
+
+    /** True if [pos, pos + n) holds a sampled position */
+    [[nodiscard]] bool hits(size_t pos, size_t n) const { return first_sample(pos) - pos < n; }
+
+    /**
+     * Producer: [pos, pos + n) is about to be published on top of
+     * `queued` entries. Stamps its sampled positions.
+     */
+    void on_push(size_t pos, size_t n, size_t queued) {
+        const uint64_t now = now_ns();
+        size_t depth = 0;
+        for (size_t sample = first_sample(pos); sample - pos < n; sample += sample_every()) {
+            stamps_[(sample >> shift_) & stamp_mask_].store(now, std::memory_order_relaxed);
+            depth = queued + (sample - pos) + 1;
+        }
+        size_t seen = high_water_.load(std::memory_order_relaxed);
+        while (depth > seen &&
+               !high_water_.compare_exchange_weak(seen, depth, std::memory_order_relaxed)) {}
+    }
+
+    /** Consumer: [pos, pos + n) was taken and is not released yet */
+    void on_pop(size_t pos, size_t n) {
+        if (!hits(pos, n)) return;
+        const uint64_t now = now_ns();
+        for (size_t sample = first_sample(pos); sample - pos < n; sample += sample_every()) {
+            const uint64_t stamp = stamps_[(sample >> shift_) & stamp_mask_].load(std::memory_order_relaxed);
+            const uint64_t residence = now > stamp ? now - stamp : 0;
+            samples_.fetch_add(1, std::memory_order_relaxed);
+            residence_sum_.fetch_add(residence, std::memory_order_relaxed);
+            uint64_t max = residence_max_.load(std::memory_order_relaxed);
+            while (residence > max &&
+                   !residence_max_.compare_exchange_weak(max, residence, std::memory_order_relaxed)) {}
+        }
+    }
+
+    [[nodiscard]] QueueTelemetry snapshot() const {
+        return {
+            .sample_every     = sample_every(),
+            .high_water       = high_water_.load(std::memory_order_relaxed),
+            .samples          = samples_.load(std::memory_order_relaxed),
+            .residence_sum_ns = residence_sum_.load(std::memory_order_relaxed),
+            .residence_max_ns = residence_max_.load(std::memory_order_relaxed),
+        };
+    }
+
+private:
+    [[nodiscard]] size_t first_sample(size_t pos) const { return (pos + sample_mask_) & ~sample_mask_; }
+
+    static uint64_t now_ns() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    const int    shift_;        // log2(sample_every)
+    const size_t sample_mask_;  // sample_every - 1
+    const size_t stamp_mask_;   // capacity / sample_every - 1
+    std::unique_ptr<std::atomic<uint64_t>[]> stamps_;  // One per sampled slot
+
+    alignas(64) std::atomic<size_t> high_water_{0};  // Producer-written
+
+    alignas(64) std::atomic<uint64_t> samples_{0};   // Consumer-written
+    std::atomic<uint64_t>             residence_sum_{0};
+    std::atomic<uint64_t>             residence_max_{0};
+};
+
+} // namespace rtes
@@ -0,0 +1,60 @@
+#pragma once
+
+/**
+ * @file reference_prices.hpp
+ * @brief Per-symbol last-trade price, written by engines, read by risk
+ *
+ * One cache-line slot per symbol, so an engine publishing AAPL never
+ * invalidates the line a risk shard reads for MSFT. The matching engine
+ * that owns the symbol's book is its only writer (a relaxed store per
+ * trade). Risk shards read it with a relaxed load in the price collar.
+ * Neither side ever locks or hashes on the order path: each resolves
+ * its Symbol → slot pointers once, before start().
+ *
+ * A collar only needs a recent price, not one ordered with anything
+ * else, so relaxed is enough. 0 means "no reference yet" and the
+ * collar is skipped.
+ */
+
+#include "rtes/config.hpp"
+#include "rtes/types.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace rtes {
+
+struct alignas(64) ReferencePriceSlot {
+    std::atomic<Price> price{0};
+};
+
+class ReferencePriceTable {
+public:
+    /** One slot per distinct symbol, in config order. */
+    explicit ReferencePriceTable(const std::vector<SymbolConfig>& symbols) {
+        for (const auto& sym : symbols) {
+            index_.emplace(Symbol(sym.symbol.c_str()), index_.size());
+        }
+        slots_ = std::make_unique<ReferencePriceSlot[]>(index_.size());
+    }
+
+    ReferencePriceTable(const ReferencePriceTable&) = delete;
+    ReferencePriceTable& operator=(const ReferencePriceTable&) = delete;
+
+    /** Slot for `symbol`, or nullptr if it was not configured. Cold path. */
+    [[nodiscard]] ReferencePriceSlot* slot(const Symbol& symbol) {
+        auto it = index_.find(symbol);
+        return it != index_.end() ? &slots_[it->second] : nullptr;
+    }
+
+    [[nodiscard]] size_t size() const { return index_.size(); }
+
+private:
+    std::unordered_map<Symbol, size_t, Symbol::Hash> index_;
+    std::unique_ptr<ReferencePriceSlot[]>            slots_;
+};
+
+} // namespace rtes
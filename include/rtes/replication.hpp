@@ -0,0 +1,238 @@
+#pragma once
+
+/**
+ * @file replication.hpp
+ * @brief Hot standby: the primary's journaled requests, applied by a standby
+ *
+ *   engines ─ journal lanes ─► journal thread ─► file
+ *                                     └─► ReplicationPrimary ─ TCP ─► ReplicationStandby
+ *                                                                       └─► MatchingEngine::replay
+ *
+ * The journal thread hands every request it drains (NEW_ORDER ..
+ * MASS_CANCEL; outputs are not sent, the standby reproduces them) to
+ * the primary's replicator. Once per journal loop the replicator closes
+ * the batch into one frame and sends it without blocking. The engines
+ * never touch the socket.
+ *
+ * The standby applies each frame to its own engines, which are not
+ * started, through MatchingEngine::replay. The requests run at their
+ * recorded batch times and are journaled into the standby's own lanes,
+ * so the standby's books and journal match the primary's. After each
+ * frame it acks, per engine, the last primary sequence it applied.
+ *
+ * Modes:
+ *   ASYNC: the primary does not wait. A failover loses what was in
+ *          flight, about one journal loop plus one network hop.
+ *   SYNC:  ack-before-ack. Each engine holds its execution reports
+ *          until the standby has acked the request behind them
+ *          (MatchingEngine::set_replication_gate), so no client learns
+ *          of a fill the standby does not have. Matching is not
+ *          delayed; only the reports are.
+ *
+ * Wire format (native byte order, both ends run the same build):
+ *   standby → primary: challenge (REPLICATION_CHALLENGE_BYTES random bytes)
+ *   primary → standby: JournalFileHeader (hello: engine names) and
+ *                      HMAC-SHA256(secret, challenge ‖ hello), then
+ *                      frames { ReplicationFrame, count × JournalRecord };
+ *                      count 0 is a heartbeat, count ≤ REPLICATION_MAX_FRAME_RECORDS
+ *   standby → primary: acks { ReplicationFrame{count = engines}, count × uint64_t }
+ *
+ * The standby listens on a configured address only and takes no frame
+ * before the hello's MAC checks out with the shared secret. A frame with
+ * too many records, an engine it does not have or a record that is not
+ * a request drops the connection: nothing of it is applied.
+ *
+ * The standby must connect before the primary takes orders: there is no
+ * catch-up. A lost standby (disconnect, or a backlog over
+ * max_backlog_bytes) is dropped for the rest of the run and SYNC
+ * releases everything it held. The primary keeps trading unprotected
+ * and logs an error.
+ */
+
+#include "rtes/event_journal.hpp"
+#include "rtes/matching_engine.hpp"
+#include "rtes/memory_safety.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rtes {
+
+inline constexpr uint32_t REPLICATION_MAGIC = 0x50525452;  // "RTRP"
+inline constexpr size_t   REPLICATION_CHALLENGE_BYTES   = 32;
+inline constexpr size_t   REPLICATION_MAC_BYTES         = 32;     // HMAC-SHA256
+inline constexpr uint32_t REPLICATION_MAX_FRAME_RECORDS = 65536;  // 8 MiB of JournalRecord
+
+enum class ReplicationMode : uint8_t {
+    ASYNC = 0,
+    SYNC  = 1,
+};
+
+/** Parse "async" / "sync" (default ASYNC) */
+[[nodiscard]] ReplicationMode parse_replication_mode(const std::string& name);
+
+struct ReplicationFrame {
+    uint32_t magic{REPLICATION_MAGIC};
+    uint32_t count{0};
+};
+
+/**
+ * Primary side, driven by the journal thread (EventJournal::set_replicator).
+ */
+class ReplicationPrimary {
+public:
+    /**
+     * @param peer Standby "host:port"
+     * @param secret Shared with the standby; proves this is the primary
+     * @param max_backlog_bytes Unsent bytes tolerated before the standby is dropped
+     * @throws std::invalid_argument if `secret` is empty or built without OpenSSL
+     */
+    ReplicationPrimary(std::string peer, std::string secret, ReplicationMode mode, size_t max_backlog_bytes);
+    ~ReplicationPrimary();
+
+    ReplicationPrimary(const ReplicationPrimary&) = delete;
+    ReplicationPrimary& operator=(const ReplicationPrimary&) = delete;
+
+    /** Engine woken when the standby acks its lane (SYNC). Before connect(). */
+    void add_engine(MatchingEngine* engine);
+
+    /**
+     * Connect to the standby and send the hello (EventJournal::start).
+     * @return false if it cannot be reached: the run is unprotected
+     */
+    bool connect(const JournalFileHeader& header);
+
+    // ── Journal thread ──
+
+    /** Queue the requests among `records` for the current frame */
+    void append(const JournalRecord* records, size_t count);
+
+    /** Close the frame (or a heartbeat when idle), send what the socket takes, read acks */
+    void flush();
+
+    /** Send what is left and disconnect (EventJournal::stop) */
+    void close();
+
+    // ── Any thread ──
+
+    /** Last sequence of `engine`'s lane the standby applied (the SYNC gate); valid from construction */
+    [[nodiscard]] const std::atomic<uint64_t>* acked(size_t engine) const { return &acked_[engine]; }
+
+    [[nodiscard]] ReplicationMode mode() const { return mode_; }
+    [[nodiscard]] bool connected() const { return connected_.load(std::memory_order_relaxed); }
+    uint64_t frames_sent() const { return frames_.load(std::memory_order_relaxed); }
+    uint64_t records_sent() const { return records_.load(std::memory_order_relaxed); }
+    uint64_t bytes_sent() const { return bytes_.load(std::memory_order_relaxed); }
+    /** Bytes framed but not yet taken by the socket */
+    uint64_t backlog() const { return backlog_.load(std::memory_order_relaxed); }
+
+private:
+    std::string     peer_;
+    std::string     secret_;
+    ReplicationMode mode_;
+    size_t          max_backlog_;
+    std::vector<MatchingEngine*> engines_;
+
+    FileDescriptor             fd_;
+    std::vector<std::byte>     out_;            // Framed, unsent: [out_sent_, size)
+    size_t                     out_sent_{0};
+    size_t                     frame_start_{0}; // Header of the frame being filled
+    uint32_t                   frame_count_{0};
+    std::vector<std::byte>     in_;             // Partial ack
+    std::chrono::steady_clock::time_point last_frame_;
+    std::unique_ptr<std::atomic<uint64_t>[]> acked_;
+    size_t                     engine_count_{0};
+
+    std::atomic<bool>     connected_{false};
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> backlog_{0};
+
+    void begin_frame();
+    void end_frame();
+    /** @return false on a socket error */
+    bool send_pending();
+    bool read_acks();
+    /** Drop the standby; SYNC engines stop waiting for it */
+    void lose(const char* why);
+};
+
+/**
+ * Standby side: accepts the primary and applies its frames to engines
+ * that are not running, until promote().
+ */
+class ReplicationStandby {
+public:
+    /**
+     * @param bind_address IPv4 address to listen on (the replication interface)
+     * @param secret  Shared with the primary; a peer without it is refused
+     * @param engines Same layout (names, books, order) as the primary's
+     * @param lanes   This instance's journal lanes for them (entries may be null)
+     * @param promote_after Promote on its own once the primary has been
+     *        silent (or gone) this long after connecting; 0 = only promote()
+     * @throws std::invalid_argument if `secret` is empty or built without OpenSSL
+     */
+    ReplicationStandby(std::string bind_address, uint16_t port, std::string secret,
+                       std::vector<MatchingEngine*> engines, std::vector<JournalLane*> lanes,
+                       std::chrono::milliseconds promote_after);
+    ~ReplicationStandby();
+
+    ReplicationStandby(const ReplicationStandby&) = delete;
+    ReplicationStandby& operator=(const ReplicationStandby&) = delete;
+
+    /** @throws std::runtime_error if the address cannot be bound */
+    void start();
+
+    /** Stop applying and return once the applier thread is gone; the engines may start then */
+    void promote();
+
+    /** Promoted, on its own or by promote() (the caller still has to promote() to join) */
+    [[nodiscard]] bool promotion_due() const { return promotion_due_.load(std::memory_order_acquire); }
+    [[nodiscard]] bool connected() const { return connected_.load(std::memory_order_relaxed); }
+
+    uint64_t frames_applied() const { return frames_.load(std::memory_order_relaxed); }
+    uint64_t requests_applied() const { return requests_.load(std::memory_order_relaxed); }
+    /** Peers refused: wrong MAC, other engines, or a malformed frame */
+    uint64_t peers_refused() const { return refused_.load(std::memory_order_relaxed); }
+
+private:
+    std::string                  bind_address_;
+    uint16_t                     port_;
+    std::string                  secret_;
+    std::vector<MatchingEngine*> engines_;
+    std::vector<JournalLane*>    lanes_;
+    std::chrono::milliseconds    promote_after_;
+
+    FileDescriptor    listen_fd_;
+    FileDescriptor    fd_;
+    std::thread       thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> promotion_due_{false};
+    std::atomic<bool> connected_{false};
+
+    std::vector<std::vector<JournalRecord>> pending_;  // Per engine, the frame being applied
+    std::vector<JournalRecord>              chunk_;    // Receive buffer, a bounded slice of a frame
+    std::vector<uint64_t>                   applied_;  // Per engine, last primary sequence
+
+    std::atomic<uint64_t> frames_{0};
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> refused_{0};
+
+    void run();
+    bool accept_primary();
+    /** Challenge the peer and check its hello. @return true if it is our primary */
+    bool authenticate_primary();
+    /** @return false once the primary is gone (or, with a deadline, too slow) */
+    bool read_exact(void* data, size_t size,
+                    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+    /** @return false if the primary is gone or sent a frame that is refused */
+    bool apply_frame(uint32_t count);
+};
+
+} // namespace rtes
@@ -0,0 +1,140 @@
+#pragma once
+
+/**
+ * @file retransmission.hpp
+ * @brief Gap fill for the UDP market data feed
+ *
+ * A subscriber that sees a hole in a channel's message sequence asks for
+ * the missing range instead of resyncing from scratch:
+ *
+ *   UdpPublisher ─ SPSC ─┐
+ *   UdpPublisher ─ SPSC ─┼─► RetransmissionServer ─► per-channel arena
+ *                        │          ▲        │
+ *                        │   RetransmitRequest   RetransmitResponse + datagrams
+ *
+ * Each publisher copies every datagram it sends into its own SPSC ring
+ * with one try_push: a full ring drops the copy and counts it, so the
+ * live path never waits for recovery traffic.
+ *
+ * The server thread keeps the last N datagrams of each channel as bytes
+ * in a fixed arena (no re-encoding) and answers unicast UDP requests on
+ * its port by sending back the datagrams covering the range, exactly as
+ * first published. A reply is capped at RETRANSMIT_MAX_PACKETS; the
+ * subscriber asks again for the rest.
+ *
+ * UDP source addresses can be forged, so a reply must not be worth more
+ * to an attacker than the request: it is capped at RETRANSMIT_AMPLIFICATION
+ * times the request's bytes (subscribers pad requests, up to
+ * MD_MAX_DATAGRAM, to get more per round trip), and each source address
+ * draws from a byte budget of RETRANSMIT_SOURCE_RATE per second. A request
+ * over budget gets no reply at all.
+ */
+
+#include "rtes/udp_publisher.hpp"
+#include "rtes/memory_safety.hpp"
+#include "rtes/spsc_queue.hpp"
+
+#include <netinet/in.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rtes {
+
+/** Datagrams kept per channel (power of two) */
+inline constexpr size_t RETRANSMIT_DEFAULT_HISTORY = 8192;
+/** Per-publisher ring into the server */
+inline constexpr size_t RETRANSMIT_QUEUE_CAPACITY  = 1024;
+/** Reply bytes (response and datagrams) per request byte received */
+inline constexpr size_t RETRANSMIT_AMPLIFICATION   = 3;
+/** Reply bytes per second, and burst, one source address may draw */
+inline constexpr uint64_t RETRANSMIT_SOURCE_RATE   = 1 << 20;
+/** Source budgets kept (power of two); addresses hashing alike share one */
+inline constexpr size_t RETRANSMIT_SOURCE_BUCKETS  = 1024;
+
+class RetransmissionServer {
+public:
+    /**
+     * @param bind_address Local IPv4 address requests are taken on (the
+     *                     subscribers' interface; "0.0.0.0" for every one)
+     * @param publishers   UdpPublishers feeding it (one queue each)
+     * @param channels     Market data channels (ids 0 .. channels-1)
+     * @param history      Datagrams kept per channel (rounded up to a power of two)
+     */
+    RetransmissionServer(std::string bind_address, uint16_t port, size_t publishers, size_t channels,
+                         size_t history = RETRANSMIT_DEFAULT_HISTORY);
+    ~RetransmissionServer();
+
+    RetransmissionServer(const RetransmissionServer&) = delete;
+    RetransmissionServer& operator=(const RetransmissionServer&) = delete;
+
+    void start();
+    void stop();
+
+    /** Ring publisher `publisher` produces into (UdpPublisher::set_retransmission). */
+    [[nodiscard]] SPSCQueue<RetransmitRecord>* publisher_queue(size_t publisher) {
+        return queues_.at(publisher).get();
+    }
+
+    // Statistics
+    uint64_t packets_kept() const { return packets_kept_.load(std::memory_order_relaxed); }
+    uint64_t requests() const { return requests_.load(std::memory_order_relaxed); }
+    uint64_t packets_replayed() const { return packets_replayed_.load(std::memory_order_relaxed); }
+    /** Requests answered UNAVAILABLE or INVALID */
+    uint64_t requests_unfilled() const { return requests_unfilled_.load(std::memory_order_relaxed); }
+    /** Requests dropped unanswered: too short to earn a response, or their source's budget is spent */
+    uint64_t requests_throttled() const { return requests_throttled_.load(std::memory_order_relaxed); }
+
+private:
+    /** Last datagrams of one channel; packet n lives in slot n & mask_ */
+    struct History {
+        std::vector<uint8_t>  arena;           // Slot i at arena[i * MD_MAX_DATAGRAM]
+        std::vector<uint64_t> first_sequence;  // First message of the packet in slot i
+        std::vector<uint16_t> message_count;
+        std::vector<uint16_t> length;
+        uint64_t              head{0};         // Packets kept so far; [head - size, head) valid
+    };
+
+    /** Reply bytes a source may still draw (token bucket) */
+    struct SourceBudget {
+        uint64_t bytes{RETRANSMIT_SOURCE_RATE};
+        uint64_t refilled_ns{0};
+    };
+
+    std::string       bind_address_;
+    uint16_t          port_;
+    FileDescriptor    socket_fd_;
+    std::thread       thread_;
+    std::atomic<bool> running_{false};
+
+    std::vector<std::unique_ptr<SPSCQueue<RetransmitRecord>>> queues_;
+    std::vector<RetransmitRecord>                             drain_buffer_;
+
+    std::vector<History> histories_;  // Indexed by channel id
+    size_t               slots_;
+    size_t               mask_;
+    std::vector<SourceBudget> sources_;  // Indexed by source address hash
+
+    std::atomic<uint64_t> packets_kept_{0};
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> packets_replayed_{0};
+    std::atomic<uint64_t> requests_unfilled_{0};
+    std::atomic<uint64_t> requests_throttled_{0};
+
+    void run();
+    bool drain_publishers();
+    void keep(const RetransmitRecord& record);
+    void read_requests();
+    void handle_request(const RetransmitRequest& request, size_t request_bytes, const sockaddr_in& from);
+    SourceBudget& budget_for(const sockaddr_in& from, uint64_t now_ns);
+    uint64_t oldest(const History& history) const {
+        return history.head > slots_ ? history.head - slots_ : 0;
+    }
+};
+
+} // namespace rtes
@@ -2,14 +2,24 @@
 
 #include "rtes/types.hpp"
 #include "rtes/config.hpp"
+#include "rtes/client_directory.hpp"
+#include "rtes/instrument_directory.hpp"
 #include "rtes/spsc_queue.hpp"
 #include "rtes/matching_engine.hpp"
-
+#include "rtes/idle_strategy.hpp"
+#include "rtes/order_id_map.hpp"
+#include "rtes/reference_prices.hpp"
+#include "rtes/stats_region.hpp"
+#include "rtes/token_bucket.hpp"
+#include "rtes/thread_affinity.hpp"
+
+#include <algorithm>
+#include <limits>
 #include <unordered_map>
-#include <unordered_set>
 #include <atomic>
 #include <thread>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 namespace rtes {
@@ -34,51 +44,132 @@ enum class RiskResult : uint8_t {
     REJECTED_SYMBOL      = 6,
     REJECTED_OWNERSHIP   = 7,
     REJECTED_QUEUE_FULL  = 8,
+    REJECTED_CAPACITY    = 9,   // Live order index or client table full
+    REJECTED_POSITION    = 10,  // max_position / max_open_quantity
+    REJECTED_HALTED      = 11,  // Instrument halted (cancel-only)
 };
 
 // ═══════════════════════════════════════════════════════════════
 //  Risk Request (input via SPSC queue)
 // ═══════════════════════════════════════════════════════════════
 
-struct RiskRequest {
+/**
+ * 32 bytes, two per cache line. Clients travel as their directory id
+ * only: the 32-byte ClientID stays with the session (and on the Order,
+ * for new orders). Symbols likewise: a NEW_ORDER may carry the order's
+ * InstrumentID (set_instrument_directory), which risk turns into its
+ * symbol slot with an array index instead of hashing Order::symbol.
+ */
+struct alignas(32) RiskRequest {
     enum Type : uint8_t {
         NEW_ORDER    = 0,
         CANCEL_ORDER = 1,
+        MODIFY_ORDER = 2,
+        MASS_CANCEL  = 3,
     };
 
-    Type type;
+    Type         type;
+    InstrumentID instrument{INVALID_INSTRUMENT};  // NEW_ORDER: id of order->symbol, if known
+    ClientIDRaw  client_raw{0};  // CANCEL / MODIFY / MASS_CANCEL: requesting client (0 = unknown)
 
     union {
         Order* order;  // NEW_ORDER
         struct {
-            OrderID  order_id;
-            ClientID client_id;
+            OrderID     order_id;
         } cancel;
 
+        struct {
+            OrderID     order_id;
+            Quantity    new_quantity;
+            Price       new_price;   // 0 = keep current
+        } modify;
+
+        struct {
+            Symbol      symbol;      // Empty = every symbol
+        } mass_cancel;
     };
 
     RiskRequest() : type(NEW_ORDER), order(nullptr) {}
 };
 
+static_assert(sizeof(RiskRequest) == 32, "RiskRequest must stay two per cache line");
+
 // ═══════════════════════════════════════════════════════════════
 //  Per-Client Risk State
 // ═══════════════════════════════════════════════════════════════
 
+/** Slot in the flat client table, indexed by ClientIDRaw. */
 struct ClientRiskState {
-    std::unordered_set<OrderID> active_orders;  // For dup check + ownership
-    uint64_t  notional_exposure_scaled{0};       // Integer notional
-    uint32_t  orders_in_window{0};               // Current window count
-    Timestamp window_start_ns{0};                // Rate limit window start
+    uint64_t    notional_exposure_scaled{0};     // Integer notional
+    TokenBucket rate_bucket;                     // Order/modify rate limit
+    ClientIDRaw raw_id{0};                       // Own index once seen (0 = slot unused)
+};
+
+/** Dense index of a configured symbol inside the risk manager. */
+using RiskSymbolIndex = uint16_t;
+
+/** An instrument this manager has no configuration for */
+inline constexpr RiskSymbolIndex NO_RISK_SYMBOL = std::numeric_limits<RiskSymbolIndex>::max();
+
+/**
+ * One client's exposure in one symbol. Working quantities cover live
+ * orders only; net moves on fills (long > 0).
+ */
+struct SymbolPosition {
+    int64_t  net{0};
+    uint64_t open_buy{0};
+    uint64_t open_sell{0};
+};
+
+/**
+ * Live order entry in the risk index.
+ * One flat map serves duplicate detection, cancel ownership
+ * (owner pointer — the client table is never resized after start),
+ * targeted cancel routing (symbol) and modify re-checks
+ * (last approved price/quantity for the notional delta).
+ */
+struct ActiveOrder {
+    Symbol           symbol;
+    ClientRiskState* owner{nullptr};
+    Price            price{0};
+    Quantity         quantity{0};        // Still working (fills subtract)
+    RiskSymbolIndex  symbol_index{0};
+    Side             side{Side::BUY};
+};
+
+/**
+ * Routing target for a symbol: the engine (shard) hosting its book
+ * and the book's dense index inside it. Resolved once at wiring.
+ */
+struct EngineRoute {
+    MatchingEngine* engine{nullptr};
+    BookIndex       book{0};
+    uint32_t        outbound{0};  // The shard's staging buffer for `engine`
 };
 
+/** Default live-order capacity when not sized from order_pool_size */
+inline constexpr size_t RISK_DEFAULT_MAX_LIVE_ORDERS = 65536;
+
+/** Risk ingress lane (one per gateway thread). */
+using RiskLane = IngressLane;
+
 // ═══════════════════════════════════════════════════════════════
 //  Risk Manager
 // ═══════════════════════════════════════════════════════════════
 
 class RiskManager {
 public:
+    /**
+     * @param max_live_orders  Capacity of the live order index.
+     *                         Size from the pool's max_capacity() — no
+     *                         order can be live without a pool slot.
+     * @param ingress_lanes    One SPSC lane per producing (gateway) thread,
+     *                         drained round-robin. At least 1.
+     */
     RiskManager(const RiskConfig& config,
-                const std::vector<SymbolConfig>& symbols);
+                const std::vector<SymbolConfig>& symbols,
+                size_t max_live_orders = RISK_DEFAULT_MAX_LIVE_ORDERS,
+                size_t ingress_lanes = 1);
     ~RiskManager();
 
     RiskManager(const RiskManager&) = delete;
@@ -88,14 +179,181 @@ public:
     void start();
     void stop();
 
-    // ── Order submission (from gateway thread) ──
-    [[nodiscard]] bool submit_order(Order* order);
-    [[nodiscard]] bool submit_cancel(OrderID order_id, ClientID client_id);
+    [[nodiscard]] bool is_running() const { return running_.load(std::memory_order_relaxed); }
+
+    /** Core / SCHED_FIFO for the worker thread. Call before start(). */
+    void set_thread_placement(const ThreadPlacement& placement) { placement_ = placement; }
+
+    /** Placement that took effect on the worker thread (monitoring). */
+    [[nodiscard]] ThreadPlacement applied_placement() const {
+        return applied_placement_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Engine input lane this risk thread produces into (its shard index).
+     * Every engine must have more lanes than this. Call before start().
+     */
+    void set_engine_lane(IngressLane lane) { engine_lane_ = lane; }
+
+    /** What the worker does when its queue is empty. Call before start(). */
+    void set_idle_policy(IdlePolicy policy) { idle_.set_policy(policy); }
+
+    /** Idle periods, parks and wake-up latency (monitoring). */
+    [[nodiscard]] IdleStats idle_stats() const { return idle_.stats(); }
+
+    // ── Order submission (from gateway threads) ──
+    // Each lane must have exactly one producing thread. Out-of-range
+    // lanes are refused (return false). Pass the client's directory id
+    // (Order::owner for new orders); with 0, cancels and modifies resolve
+    // the ClientID on the calling thread — correct, but a mutex. Pass
+    // the order's InstrumentID when known; with INVALID_INSTRUMENT the
+    // worker hashes Order::symbol instead.
+    [[nodiscard]] bool submit_order(Order* order, RiskLane lane = 0,
+                                    InstrumentID instrument = INVALID_INSTRUMENT);
+    [[nodiscard]] bool submit_cancel(OrderID order_id, ClientID client_id, RiskLane lane = 0,
+                                     ClientIDRaw client_raw = 0);
+    [[nodiscard]] bool submit_modify(OrderID order_id, ClientID client_id,
+                                     Quantity new_quantity, Price new_price = 0,
+                                     RiskLane lane = 0, ClientIDRaw client_raw = 0);
+    /**
+     * Cancel all of a client's live orders — in `symbol` only, or in
+     * every symbol when it is empty. Fans out as one MASS_CANCEL per
+     * matching engine; exposure is released by the engines' DONE
+     * feedback, as for single cancels.
+     */
+    [[nodiscard]] bool submit_mass_cancel(const ClientID& client_id, const Symbol& symbol = {},
+                                          RiskLane lane = 0, ClientIDRaw client_raw = 0);
+
+    /**
+     * Enqueue prepared requests with one publish and one wake-up (a
+     * gateway BATCH frame). In order; a short push leaves the suffix
+     * [returned, count) to the caller, counted as drops.
+     * @return Number enqueued
+     */
+    [[nodiscard]] size_t submit_requests(const RiskRequest* requests, size_t count,
+                                         RiskLane lane = 0);
+
+    /**
+     * Directory id of a client, assigned on first sight (0 if empty,
+     * or the directory is full). For producers staging requests
+     * themselves without a directory of their own. Takes the directory
+     * mutex.
+     */
+    [[nodiscard]] ClientIDRaw resolve_client(const ClientID& client_id) {
+        return client_id.empty() ? 0 : directory_->resolve(client_id);
+    }
+
+    [[nodiscard]] size_t lane_count() const { return lanes_.size(); }
+
+    /** Depth and counters per ingress lane. Safe from any thread. */
+    [[nodiscard]] std::vector<IngressLaneStats> lane_stats() const;
+
+    /** Sample ingress lane depth and residence on 1 in `sample_every` requests. Call before start(). */
+    void enable_queue_telemetry(size_t sample_every) {
+        for (auto& lane : lanes_) lane->queue->enable_telemetry(sample_every);
+    }
 
     // ── Configuration ──
+    /**
+     * Share the exchange-wide client directory (ids must agree across
+     * shards and books). Sizes the client table. Call before start().
+     * Without one, the manager uses a private directory of default capacity.
+     */
+    void set_client_directory(ClientDirectory* directory);
+
+    /**
+     * Route symbol to the engine hosting its book. Ignored if the engine
+     * has no such book, or the symbol is not one of ours.
+     */
     void add_matching_engine(const std::string& symbol, MatchingEngine* engine);
+
+    /**
+     * Accept InstrumentIDs on new orders (the exchange-wide directory the
+     * gateway stamps them from). Builds the id → symbol slot table, and
+     * points each slot at its instrument's state byte: new orders in a
+     * HALTED instrument are rejected (REJECTED_HALTED), in an UNLISTED one
+     * as unknown, and modifies of either may only shrink. Call before
+     * start(). Without one, stamped ids are ignored and every symbol is open.
+     */
+    void set_instrument_directory(const InstrumentDirectory* directory);
+
+    /**
+     * Read collar reference prices from the exchange-wide table the
+     * engines publish into. Call before start(). Without one (or for a
+     * symbol the table lacks) the manager uses a private slot, fed only
+     * by update_reference_price().
+     */
+    void set_reference_prices(ReferencePriceTable* table);
+
+    /** Stamp sampled new orders on dequeue and on approval. Call before start(). */
+    void set_order_tracer(OrderTracer* tracer) { tracer_ = tracer; }
+
+    /**
+     * Also publish the counters into `block` (a StatsKind::RISK block,
+     * RiskCounter slots) at every stats flush. Call before start().
+     */
+    void set_stats_block(StatsBlock* block) { stats_block_ = block; }
+
+    /**
+     * Publish new limits: every RiskConfig field, and price_collar_pct of
+     * each listed symbol this manager knows (others keep theirs; symbols
+     * it does not know are ignored, they have no book). Safe from any
+     * thread. The new generation is built here, handed over with one
+     * pointer exchange and adopted by the worker at its next batch
+     * boundary; checks never lock or pause. Publishing again before the
+     * worker adopted the last one replaces it.
+     * @return the generation; applied once limits_generation() reaches it
+     */
+    uint64_t update_limits(const RiskConfig& config, const std::vector<SymbolConfig>& symbols);
+
+    /** Last limits generation the worker adopted (1 = construction). */
+    [[nodiscard]] uint64_t limits_generation() const {
+        return limits_generation_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Send `symbol`'s requests to its book on `engine` from now on (a
+     * migrating book, see migrate_book()). Safe from any thread. Handed
+     * over like update_limits() and adopted at the worker's next batch
+     * boundary, so once routes_generation() reaches the result, every
+     * request routed the old way has been pushed to the old engine.
+     * @return the generation, or 0 if the symbol or the engine's book is unknown
+     */
+    uint64_t route_symbol(const Symbol& symbol, MatchingEngine* engine);
+
+    /** Last routing generation the worker adopted (1 = construction). */
+    [[nodiscard]] uint64_t routes_generation() const {
+        return routes_generation_.load(std::memory_order_acquire);
+    }
+
+    /** Seed or override a symbol's reference price. Safe from any thread. */
     void update_reference_price(const Symbol& symbol, Price price);
 
+    /**
+     * Publish risk rejects as ExecutionReports (same path as engine
+     * rejects). Call before start(). The queue is this thread's own.
+     */
+    void set_execution_queue(SPSCQueue<ExecutionReport>* queue,
+                             EventDoorbell* reader_bell = nullptr);
+
+    /** One queue per gateway reactor; rejects go to the order's reactor. */
+    void set_execution_queues(const std::vector<SPSCQueue<ExecutionReport>*>& queues,
+                              const std::vector<EventDoorbell*>& reader_bells);
+
+    /**
+     * Fill/done feedback from the engines (one ring per engine, this
+     * shard consuming). Applied at the start of every batch to release
+     * notional exposure and retire live orders. Call before start().
+     * Without feedback, exposure only grows.
+     */
+    void set_feedback_rings(std::vector<SPSCQueue<RiskFeedback>*> rings);
+
+    /**
+     * Position and working quantities of `client` in `symbol`.
+     * Worker-thread state: read it only while the worker is stopped.
+     */
+    [[nodiscard]] SymbolPosition position(const ClientID& client, const Symbol& symbol) const;
+
     // ── Statistics ──
     struct Stats {
         uint64_t processed;
@@ -103,6 +361,11 @@ public:
         uint64_t rejected;
         uint64_t cancels_accepted;
         uint64_t cancels_rejected;
+        uint64_t modifies_accepted;
+        uint64_t modifies_rejected;
+        uint64_t feedback_applied;   // Engine fill/done events consumed
+        uint64_t mass_cancels;       // MASS_CANCEL requests fanned out
+        uint64_t engine_pushes;      // Bulk pushes into engine lanes (requests staged per batch)
     };
 
     [[nodiscard]] Stats get_stats() const {
@@ -112,31 +375,100 @@ public:
             .rejected         = stats_atomic_.rejected.load(std::memory_order_relaxed),
             .cancels_accepted = stats_atomic_.cancels_accepted.load(std::memory_order_relaxed),
             .cancels_rejected = stats_atomic_.cancels_rejected.load(std::memory_order_relaxed),
+            .modifies_accepted = stats_atomic_.modifies_accepted.load(std::memory_order_relaxed),
+            .modifies_rejected = stats_atomic_.modifies_rejected.load(std::memory_order_relaxed),
+            .feedback_applied = stats_atomic_.feedback_applied.load(std::memory_order_relaxed),
+            .mass_cancels     = stats_atomic_.mass_cancels.load(std::memory_order_relaxed),
+            .engine_pushes    = stats_atomic_.engine_pushes.load(std::memory_order_relaxed),
         };
     }
 
 private:
-    // ── Configuration (read-only after construction) ──
+    // ── Configuration (worker-owned; replaced only by adopt_limits()) ──
     RiskConfig config_;
     uint64_t   max_notional_scaled_{0};  // Pre-computed integer limit
+    TokenBucketLimit rate_limit_;        // max_orders_per_second, rate_limit_burst
+
+    /** A limits generation built by update_limits(), immutable once published */
+    struct PendingLimits {
+        RiskConfig          config;
+        uint64_t            max_notional_scaled;
+        TokenBucketLimit    rate_limit;
+        std::vector<double> collar_pct;  // By RiskSymbolIndex; < 0 = unchanged
+        uint64_t            generation;
+    };
+    std::atomic<PendingLimits*> pending_limits_{nullptr};  // Owned by whoever exchanges it out
+    std::mutex                  limits_publish_mutex_;     // Publishers only: generations stay ordered
+    uint64_t                    next_limits_generation_{2};
+    std::atomic<uint64_t>       limits_generation_{1};
+
+    // Route changes: same handover as limits, merged if the worker has not adopted the last
+    struct PendingRoutes {
+        std::vector<std::pair<RiskSymbolIndex, EngineRoute>> changes;
+        uint64_t generation;
+    };
+    std::atomic<PendingRoutes*> pending_routes_{nullptr};
+    std::mutex                  routes_publish_mutex_;
+    uint64_t                    next_routes_generation_{2};
+    std::atomic<uint64_t>       routes_generation_{1};
 
     // ── Symbol data ──
-    std::unordered_map<Symbol, SymbolConfig, Symbol::Hash>   symbol_configs_;
-    std::unordered_map<Symbol, MatchingEngine*, Symbol::Hash> matching_engines_;
-    std::unordered_map<Symbol, Price, Symbol::Hash>          reference_prices_;
-
-    // ── Client data ──
-    std::unordered_map<ClientID, ClientRiskState, ClientID::Hash> client_states_;
+    std::unordered_map<Symbol, RiskSymbolIndex, Symbol::Hash> symbol_index_;
+    std::vector<SymbolConfig>                                symbol_configs_;  // By RiskSymbolIndex
+    std::vector<EngineRoute>                                 routes_;  // By RiskSymbolIndex
+    std::vector<RiskSymbolIndex>                             instrument_slots_;  // By InstrumentID
+    std::vector<ReferencePriceSlot*>                         reference_slots_;  // By RiskSymbolIndex
+    std::vector<const std::atomic<InstrumentState>*>         symbol_states_;  // By RiskSymbolIndex
+    std::unique_ptr<std::atomic<InstrumentState>[]>          owned_states_;  // OPEN, when no directory has one
+    std::unique_ptr<ReferencePriceTable>                     owned_reference_prices_;
+    IngressLane engine_lane_{0};  // Our lane on every engine
+
+    // ── Outbound: what a batch approved, staged per engine, pushed in bulk ──
+    struct Outbound {
+        MatchingEngine*           engine{nullptr};
+        std::vector<OrderRequest> requests;  // RISK_OUTBOUND_BATCH slots
+        std::vector<Order*>       orders;    // A NEW_ORDER's order (unwound if not pushed), else nullptr
+        size_t                    count{0};
+    };
+    std::vector<Outbound> outbound_;  // One per distinct engine, also the fan-out list
+    OrderTracer* tracer_{nullptr};  // Sampled lifecycle stamps (order_trace_sample > 0)
+    StatsBlock*  stats_block_{nullptr};  // Exchange-wide stats region slot, if any
+    uint64_t     stats_flushes_{0};      // Publishes into stats_block_
+
+    // ── Client data: flat table indexed by ClientIDRaw (slot 0 unused) ──
+    std::vector<ClientRiskState>     clients_;
+    std::vector<SymbolPosition>      positions_;  // [raw * symbol count + symbol index]
+    ClientDirectory*                 directory_{nullptr};
+    std::unique_ptr<ClientDirectory> owned_directory_;  // When none is shared
+
+    // ── Live order index: dup check, ownership, cancel routing ──
+    OrderIdMap<ActiveOrder> order_index_;
+
+    // ── Ingress lanes (one producer each) ──
+    struct InputLane {
+        std::unique_ptr<SPSCQueue<RiskRequest>> queue;
+        // Producer-written (single writer per lane), monitoring-read
+        alignas(64) std::atomic<uint64_t> submitted{0};
+        std::atomic<uint64_t>             drops{0};
+    };
+    std::vector<std::unique_ptr<InputLane>> lanes_;
+    std::vector<RiskRequest> drain_buffer_;  // One bulk pop per lane visit
+    size_t                   next_lane_{0};  // Round-robin start for the next batch
+    Timestamp                batch_now_{0};  // Clock read once per batch (rate limit refill)
 
-    // ── Order→Symbol index (for targeted cancel routing) ──
-    std::unordered_map<OrderID, Symbol> order_symbol_index_;
+    // ── Reject reports (to gateway) ──
+    ExecutionEgress             execution_egress_;
 
-    // ── Input queue ──
-    std::unique_ptr<SPSCQueue<RiskRequest>> input_queue_;
+    // ── Engine feedback (one ring per engine, we consume) ──
+    std::vector<SPSCQueue<RiskFeedback>*> feedback_rings_;
+    std::vector<RiskFeedback>             feedback_buffer_;  // One bulk pop per ring visit
 
     // ── Threading ──
     std::thread worker_thread_;
     std::atomic<bool> running_{false};
+    ThreadPlacement              placement_;
+    std::atomic<ThreadPlacement> applied_placement_{};
+    IdleStrategy                 idle_;  // Gateway notify()s after push
 
     // ── Local statistics (no atomics in hot path) ──
     struct LocalStats {
@@ -145,8 +477,15 @@ private:
         size_t rejected{0};
         size_t cancels_accepted{0};
         size_t cancels_rejected{0};
+        size_t modifies_accepted{0};
+        size_t modifies_rejected{0};
+        size_t feedback_applied{0};
+        size_t mass_cancels{0};
+        size_t engine_pushes{0};
     };
     LocalStats local_stats_;
+    size_t     flushed_processed_{0};   // local_stats_ as of the last flush_stats()
+    size_t     flushed_feedback_{0};
 
     // ── Atomic statistics (read by monitoring) ──
     struct AtomicStats {
@@ -155,26 +494,69 @@ private:
         std::atomic<uint64_t> rejected{0};
         std::atomic<uint64_t> cancels_accepted{0};
         std::atomic<uint64_t> cancels_rejected{0};
+        std::atomic<uint64_t> modifies_accepted{0};
+        std::atomic<uint64_t> modifies_rejected{0};
+        std::atomic<uint64_t> feedback_applied{0};
+        std::atomic<uint64_t> mass_cancels{0};
+        std::atomic<uint64_t> engine_pushes{0};
     };
     AtomicStats stats_atomic_;
 
     // ── Worker internals ──
     void run();
     size_t drain_batch();
-    void process_new_order(Order* order);
-    void process_cancel(OrderID order_id, ClientID client_id);
+    bool any_lane_pending();
+    void adopt_limits();
+    void adopt_routes();
+    bool push_request(const RiskRequest& request, RiskLane lane);
+    void process_request(const RiskRequest& request);
+    size_t drain_feedback();
+    void apply_feedback(const RiskFeedback& feedback);
+    void process_new_order(Order* order, InstrumentID instrument);
+    void process_cancel(OrderID order_id, ClientIDRaw client_raw);
+    void process_modify(OrderID order_id, ClientIDRaw client_raw,
+                        Quantity new_quantity, Price new_price);
+    void process_mass_cancel(ClientIDRaw client_raw, const Symbol& symbol);
+
+    /** Staging buffer for `engine`, created on first sight. */
+    uint32_t outbound_for(MatchingEngine* engine);
+    void stage(uint32_t outbound, const OrderRequest& request, Order* order = nullptr);
+    void flush_outbound(Outbound& out);
+    void flush_all_outbound();
+    /** An approved order the engine lane had no room for: undo its approval, reject it. */
+    void unstage_order(Order* order);
+
+    /** Symbol slot of a new order: stamped id first, hash as fallback. */
+    bool find_symbol(const Order& order, InstrumentID instrument, RiskSymbolIndex& index) const {
+        if (instrument < instrument_slots_.size()) [[likely]] {
+            index = instrument_slots_[instrument];
+            return index != NO_RISK_SYMBOL;
+        }
+        auto it = symbol_index_.find(order.symbol);
+        if (it == symbol_index_.end()) return false;
+        index = it->second;
+        return true;
+    }
 
     // ── Risk checks ──
-    bool check_price_collar_int(const Order* order,
+    bool check_price_collar_int(RiskSymbolIndex symbol, Price price,
                                  const SymbolConfig& sym_config) const;
     bool check_rate_limit(ClientRiskState& client);
+    bool check_position(const SymbolPosition& position, Side side, uint64_t added) const;
+    SymbolPosition& position_of(const ClientRiskState& client, RiskSymbolIndex symbol) {
+        return positions_[client.raw_id * symbol_configs_.size() + symbol];
+    }
     uint64_t calculate_notional_int(const Order* order) const;
-    ClientRiskState& get_or_create_client(const ClientID& id);
+
+    /** Exposure never underflows, even if feedback and state disagree. */
+    static void release_exposure(ClientRiskState& client, uint64_t notional) {
+        client.notional_exposure_scaled -= std::min(notional, client.notional_exposure_scaled);
+    }
+    ClientRiskState* find_client(ClientIDRaw raw, const ClientID& id, bool create);
 
     // ── Helpers ──
     void reject_order(Order* order, RiskResult reason);
-    void spin_wait();
-    void maybe_flush_stats();
+    void maybe_flush_stats(bool idle);
     void flush_stats();
 };
 
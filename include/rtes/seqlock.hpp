@@ -0,0 +1,83 @@
+#pragma once
+
+/**
+ * @file seqlock.hpp
+ * @brief Single-writer, many-reader sequence lock over a small POD value
+ *
+ *   writer                               reader
+ *   seq = s + 1         (odd: writing)   s1 = seq            (acquire)
+ *   fence(release)                       copy words          (relaxed)
+ *   store words         (relaxed)        fence(acquire)
+ *   seq = s + 2         (release)        s2 = seq            (relaxed)
+ *                                        valid if s1 == s2 and s1 even
+ *
+ * The release fence keeps the payload stores behind the odd sequence;
+ * the acquire fence keeps the payload loads ahead of the second sequence
+ * read. The payload itself is an array of relaxed atomic words, so a read
+ * that races a write is a retried read, never a data race. On x86 every
+ * one of these is a plain mov: the fences only constrain the compiler.
+ *
+ * The writer never waits and readers never write: any number of threads
+ * may read one Seqlock while its owner keeps publishing.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace rtes {
+
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "Seqlock copies its value word by word");
+
+public:
+    static constexpr int    READ_RETRIES = 8;
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    /** Publish `value`. One writer thread only. */
+    void store(const T& value) {
+        uint64_t words[WORDS]{};
+        std::memcpy(words, &value, sizeof(T));
+
+        const uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < WORDS; ++i) words_[i].store(words[i], std::memory_order_relaxed);
+
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * Copy the latest value. Safe from any thread.
+     * @return false if the copy raced the writer READ_RETRIES times in a row
+     */
+    [[nodiscard]] bool read(T& out) const {
+        for (int attempt = 0; attempt < READ_RETRIES; ++attempt) {
+            const uint64_t seq1 = sequence_.load(std::memory_order_acquire);
+            if (seq1 & 1) continue;  // Writer inside
+
+            uint64_t words[WORDS];
+            for (size_t i = 0; i < WORDS; ++i) words[i] = words_[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (sequence_.load(std::memory_order_relaxed) == seq1) {
+                std::memcpy(&out, words, sizeof(T));
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Completed stores so far */
+    [[nodiscard]] uint64_t version() const { return sequence_.load(std::memory_order_acquire) / 2; }
+
+private:
+    std::atomic<uint64_t> sequence_{0};  // Odd = writing, even = valid
+    std::atomic<uint64_t> words_[WORDS]{};
+};
+
+} // namespace rtes
@@ -0,0 +1,139 @@
+#pragma once
+
+/**
+ * @file session_capture.hpp
+ * @brief Timestamped capture of inbound order-entry frames, for replay
+ *
+ *   reactor ─ CaptureLane (SPSC) ─┐
+ *   reactor ─ CaptureLane (SPSC) ─┼─► capture thread ─► buffered file
+ *
+ * The gateway hands every complete inbound frame to record() before it
+ * parses it (TcpGateway::set_session_capture), and a CLOSE event when
+ * the connection goes. A frame is copied into fixed-size chunks on its
+ * reactor's lane with one push. A full lane drops the frame and counts
+ * it, so capture never stalls a reactor. Frames larger than the first
+ * chunk take continuation chunks, pushed together or not at all.
+ *
+ * File layout: a SessionCaptureFileHeader, then one CaptureEventHeader
+ * per event followed by its `length` frame bytes, unpadded. A session
+ * is (reactor, connection, generation). Its events appear in the order
+ * the reactor saw them, and `time_ns` (steady clock) orders events
+ * across sessions. tools/session_replay re-sends a capture at 1x, Nx or
+ * maximum speed.
+ *
+ * Frames are captured as received: logons (with their credentials)
+ * included. Treat capture files like the journal.
+ */
+
+#include "rtes/spsc_queue.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rtes {
+
+inline constexpr char     SESSION_CAPTURE_MAGIC[8]     = {'R', 'T', 'E', 'S', 'C', 'A', 'P', 'T'};
+inline constexpr uint32_t SESSION_CAPTURE_VERSION      = 1;
+inline constexpr size_t   SESSION_CAPTURE_DEFAULT_LANE = 16384;  // Chunks per reactor
+inline constexpr size_t   SESSION_CAPTURE_MAX_FRAME    = 8192;   // Larger frames are dropped
+inline constexpr size_t   CAPTURE_CHUNK_BYTES          = 256;
+
+enum class CaptureEventType : uint8_t {
+    FRAME = 1,  // One inbound message, header included
+    CLOSE = 2,  // The connection was removed (length 0)
+};
+
+struct SessionCaptureFileHeader {
+    char     magic[8];
+    uint32_t version{SESSION_CAPTURE_VERSION};
+    uint32_t reactors{0};
+    uint64_t start_realtime_ns{0};  // Wall clock when capture started
+    uint64_t start_steady_ns{0};    // The same instant on the events' clock
+};
+
+struct CaptureEventHeader {
+    uint64_t         time_ns{0};     // Steady clock when the reactor took the frame
+    uint32_t         generation{0};  // Connection slot generation (per accept)
+    uint16_t         connection{0};  // Connection slot in its reactor
+    uint16_t         length{0};      // Frame bytes that follow
+    CaptureEventType type{CaptureEventType::FRAME};
+    uint8_t          reactor{0};
+    uint8_t          reserved[6]{};
+};
+static_assert(sizeof(CaptureEventHeader) == 24);
+
+/** Lane element: the first chunk of an event starts with its header */
+struct CaptureChunk {
+    uint8_t bytes[CAPTURE_CHUNK_BYTES];
+};
+
+using CaptureLane = SPSCQueue<CaptureChunk>;
+
+class SessionCapture {
+public:
+    /**
+     * @param path        File to write (truncated)
+     * @param reactors    Gateway reactors (one lane each)
+     * @param lane_chunks Chunks buffered per reactor before frames are dropped
+     */
+    SessionCapture(std::string path, size_t reactors, size_t lane_chunks = SESSION_CAPTURE_DEFAULT_LANE);
+    ~SessionCapture();
+
+    SessionCapture(const SessionCapture&) = delete;
+    SessionCapture& operator=(const SessionCapture&) = delete;
+
+    /** Open the file and start the writer. @return false if the file cannot be created */
+    bool start();
+    /** Write what the lanes hold and close the file */
+    void stop();
+
+    /**
+     * Reactor `reactor`'s thread only: capture one event. `data` may be
+     * null for CLOSE. Frames over SESSION_CAPTURE_MAX_FRAME are dropped,
+     * counted and logged, never cut short.
+     */
+    void record(size_t reactor, CaptureEventType type, uint16_t connection, uint32_t generation,
+                const uint8_t* data, size_t length);
+
+    [[nodiscard]] const std::string& path() const { return path_; }
+    [[nodiscard]] uint64_t events_written() const { return events_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t bytes_written() const { return bytes_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t drops() const;
+
+private:
+    struct alignas(64) Lane {
+        explicit Lane(size_t chunks) : queue(chunks) {}
+        CaptureLane           queue;
+        std::atomic<uint64_t> drops{0};  // Written by the reactor only
+    };
+
+    void   run();
+    size_t drain();
+
+    std::string                        path_;
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::FILE*                         file_{nullptr};
+    std::thread                        thread_;
+    std::atomic<bool>                  running_{false};
+    std::atomic<uint64_t>              events_{0};
+    std::atomic<uint64_t>              bytes_{0};
+};
+
+/**
+ * Read a capture file event by event. A truncated last event (the
+ * exchange died mid-write) ends the read: it is logged and, with
+ * `truncated`, reported to the caller instead of handed on cut short.
+ * @return false if the file cannot be opened or is not a capture
+ */
+bool read_session_capture(const std::string& path,
+                          const std::function<void(const CaptureEventHeader&, const uint8_t*)>& on_event,
+                          SessionCaptureFileHeader* header = nullptr, bool* truncated = nullptr);
+
+} // namespace rtes
@@ -0,0 +1,427 @@
+#pragma once
+
+/**
+ * @file shm_order_entry.hpp
+ * @brief Order entry over shared memory for strategies on the exchange host
+ *
+ * A co-located strategy reaches risk without a socket on the hot path:
+ * each session is a pair of SPSC rings between the strategy process and
+ * the ShmGateway poller thread, in a shared memory object of its own.
+ *
+ *   ┌───────────────┬─────────────────────────────────────────┐
+ *   │ ShmEntryHeader│ ShmEntrySlot                            │
+ *   │  running, slot│  state, pid, client_id                  │
+ *   │               │  requests  (BatchEntryV2) strategy → gw │
+ *   │               │  responses (ShmResponse)  gw → strategy │
+ *   └───────────────┴─────────────────────────────────────────┘
+ *
+ * The gateway creates that object (an anonymous memfd, sealed against
+ * resizing) when it accepts a logon, and hands it over on the logon's
+ * Unix socket (abstract address "rtes_shm/<name>") with SCM_RIGHTS. A
+ * strategy therefore maps its own session and nothing else: no other
+ * client's rings, identity or token is reachable from it. Requests carry
+ * no client id; they trade as the session's logon client.
+ *
+ * Requests are protocol v2 BATCH entries (instrument ids, no strings),
+ * staged exactly as a TCP BATCH frame is and handed to the client's risk
+ * shard with one enqueue. The poller is one more gateway reactor: it
+ * owns a risk lane and its own execution report queues, so fills, done
+ * and rejects come back through the same path as for TCP sessions.
+ *
+ * Session life cycle:
+ *
+ *   logon (socket) ─gateway─▶ ACTIVE ─client detach─▶ CLOSING ─gateway─▶ unmapped
+ *          │                    ├─socket closed (process gone)─▶ unmapped
+ *          └─refused            └─gateway (slow consumer)─▶ CLOSED ─▶ unmapped
+ *
+ * The logon is checked as a TCP logon's: the client id and, under
+ * session auth, a token that must belong to that client. The gateway
+ * maps a session until its last request, then drops the object; its
+ * slot index is reused for the next logon, with a new object. A strategy
+ * that lets its response ring fill is closed like a detached one (its
+ * orders cancelled under cancel-on-disconnect) rather than left with
+ * missing reports.
+ */
+
+#include "rtes/auth_middleware.hpp"
+#include "rtes/batch_staging.hpp"
+#include "rtes/drop_copy.hpp"
+#include "rtes/idle_strategy.hpp"
+#include "rtes/matching_engine.hpp"
+#include "rtes/memory_pool.hpp"
+#include "rtes/order_id_map.hpp"
+#include "rtes/protocol.hpp"
+#include "rtes/risk_manager.hpp"
+#include "rtes/thread_affinity.hpp"
+#include "rtes/types.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace rtes {
+
+class ClientDirectory;
+class InstrumentDirectory;
+
+inline constexpr uint32_t SHM_ENTRY_MAGIC   = 0x45534852;  // "RHSE"
+inline constexpr uint32_t SHM_ENTRY_VERSION = 2;
+inline constexpr size_t   SHM_ENTRY_RING    = 1024;        // Entries per ring (each direction)
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "Ring indexes are shared across processes");
+
+/**
+ * Fixed-capacity SPSC ring living inside the mapping (no pointers, so
+ * it reads the same at any address in any process).
+ */
+template <typename T, size_t N>
+struct ShmRing {
+    static_assert(std::has_single_bit(N), "Ring capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>);
+
+    alignas(64) std::atomic<uint64_t> head{0};  // Next slot the producer writes
+    alignas(64) std::atomic<uint64_t> tail{0};  // Next slot the consumer reads
+    alignas(64) T entries[N];
+
+    /** Producer only. */
+    [[nodiscard]] bool push(const T& item) {
+        const uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= N) return false;
+        entries[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /** Producer only: pushes that cannot fail right now. */
+    [[nodiscard]] size_t free_space() const {
+        return N - (head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire));
+    }
+
+    /** Consumer only. @return entries copied to `out` (≤ max) */
+    [[nodiscard]] size_t pop(T* out, size_t max) {
+        const uint64_t t = tail.load(std::memory_order_relaxed);
+        const size_t n = std::min<size_t>(max, head.load(std::memory_order_acquire) - t);
+        for (size_t i = 0; i < n; ++i) out[i] = entries[(t + i) & (N - 1)];
+        if (n) tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    /** Consumer only. */
+    [[nodiscard]] bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_relaxed);
+    }
+
+    /** Both sides quiescent only (a slot being claimed). */
+    void reset() {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+};
+
+/** ShmResponse::type */
+enum ShmResponseType : uint8_t {
+    SHM_ACK    = 1,  // A request was taken (reason BATCH_OK) or refused by the gateway
+    SHM_FILL   = 2,  // One execution of this client's order
+    SHM_DONE   = 3,  // The order left the book (status FILLED or CANCELLED)
+    SHM_REJECT = 4,  // Risk or the book refused the order (error: ErrorCode)
+};
+
+/** Gateway → strategy, in the order the gateway learned of each */
+struct ShmResponse {
+    uint8_t  type;          // ShmResponseType
+    uint8_t  action;        // ACK: the request's BatchAction
+    uint8_t  reason;        // ACK: BatchRejectReason (BATCH_OK = handed to risk)
+    uint8_t  side;          // FILL: this order's Side
+    uint8_t  status;        // DONE: OrderStatus
+    uint8_t  reserved;
+    uint16_t error;         // REJECT: ErrorCode
+    uint64_t order_id;
+    uint64_t trade_id;      // FILL
+    uint64_t quantity;      // FILL: executed; DONE: filled over the order's life
+    uint64_t price;         // FILL (fixed point)
+    uint64_t timestamp_ns;  // FILL: execution time; otherwise when sent
+};
+static_assert(sizeof(ShmResponse) == 48);
+
+/** ShmEntrySlot::state */
+enum ShmSlotState : uint32_t {
+    SHM_SLOT_ACTIVE  = 1,  // Accepted: its requests are polled
+    SHM_SLOT_CLOSING = 2,  // Strategy detached; the gateway drains it and drops the session
+    SHM_SLOT_CLOSED  = 3,  // Closed by the gateway (response ring full): detach
+};
+
+/** One session's rings; written by the gateway before the object is handed over */
+struct alignas(64) ShmEntrySlot {
+    std::atomic<uint32_t> state{SHM_SLOT_ACTIVE};
+    uint32_t              pid{0};     // Logged-on process (SO_PEERCRED), for the logs
+    ClientID              client_id;  // Who the session's orders trade as (informational: the gateway keeps its own)
+    ShmRing<BatchEntryV2, SHM_ENTRY_RING> requests;   // Strategy → gateway
+    ShmRing<ShmResponse, SHM_ENTRY_RING>  responses;  // Gateway → strategy
+};
+
+struct alignas(64) ShmEntryHeader {
+    uint32_t              magic{SHM_ENTRY_MAGIC};
+    uint32_t              version{SHM_ENTRY_VERSION};
+    uint32_t              slot{0};     // The session's index at the gateway
+    uint32_t              slot_size{sizeof(ShmEntrySlot)};
+    std::atomic<uint32_t> running{0};  // 1 while the gateway polls
+    uint32_t              gateway_pid{0};
+};
+
+/** Strategy → gateway on the logon socket (one SOCK_SEQPACKET message) */
+struct ShmLogon {
+    uint32_t magic{SHM_ENTRY_MAGIC};
+    uint32_t version{SHM_ENTRY_VERSION};
+    ClientID client_id;
+    char     auth_token[128]{};  // Session auth only
+};
+
+/** Gateway → strategy; an accepted logon carries the session's memfd (SCM_RIGHTS) */
+struct ShmLogonReply {
+    uint32_t magic{SHM_ENTRY_MAGIC};
+    uint32_t accepted{0};
+    char     reason[56]{};  // Why a logon was refused
+};
+
+/**
+ * Exchange side: listens for logons, creates each accepted session's
+ * object and polls every open session from one thread, as gateway reactor
+ * `reactor` (execution reports route to it by Order::ingress). Setters
+ * mirror TcpGateway's; call them before start().
+ */
+class ShmGateway {
+public:
+    ShmGateway(std::string shm_name, size_t clients, RiskManager* risk_manager,
+               OrderPool* order_pool, GatewayReactor reactor);
+    ~ShmGateway();
+
+    ShmGateway(const ShmGateway&) = delete;
+    ShmGateway& operator=(const ShmGateway&) = delete;
+
+    /** Bind the logon socket and start polling. @throws std::runtime_error (name in use) */
+    void start();
+    /** Stop polling and close the logon socket; attached strategies keep a dead mapping. */
+    void stop();
+
+    /** Risk lane this thread produces into (one no other thread uses). */
+    void set_risk_lane(RiskLane lane) { risk_lane_ = lane; }
+    /** Dense client ids, resolved once per slot. As TcpGateway::set_client_directory. */
+    void set_client_directory(ClientDirectory* directory) { client_directory_ = directory; }
+    /** Instrument ids of new orders. Without it every new order is refused. */
+    void set_instrument_directory(const InstrumentDirectory* directory) {
+        instrument_directory_ = directory;
+    }
+    /** As TcpGateway::set_risk_shards. */
+    void set_risk_shards(std::vector<RiskManager*> shards);
+    /** Mass cancel a client's orders when its slot closes (detach or process gone). */
+    void set_cancel_on_disconnect(bool enabled) { cancel_on_disconnect_ = enabled; }
+    /**
+     * Require a logon token per session, bound to the logon's client, and
+     * check every request against its grant, as TcpGateway::set_session_auth.
+     * Shares the cache with TCP.
+     */
+    void set_session_auth(SessionAuthCache* auth) { session_auth_ = auth; }
+    /** The reports every producer fills for this reactor; no doorbell: the thread polls. */
+    void set_execution_queues(std::vector<SPSCQueue<ExecutionReport>*> queues);
+    /**
+     * Copy the slots' fills and final states to drop copy, through the
+     * server's queue for this reactor (as TcpGateway::set_drop_copy).
+     * Call before start(); nullptr disables it.
+     */
+    void set_drop_copy(DropCopyServer* server);
+    void set_thread_placement(const ThreadPlacement& placement) { placement_ = placement; }
+    /**
+     * Empty-poll behaviour. Strategies cannot wake a parked poller, so
+     * SPIN_PARK answers a quiet client within the park timeout (1 ms).
+     */
+    void set_idle_policy(IdlePolicy policy) { idle_.set_policy(policy); }
+
+    [[nodiscard]] ThreadPlacement applied_placement() const {
+        return applied_placement_.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] IdleStats idle_stats() const { return idle_.stats(); }
+    [[nodiscard]] const std::string& shm_name() const { return shm_name_; }
+    [[nodiscard]] size_t slot_count() const { return slot_count_; }
+
+    // Statistics (relaxed; published every STATS_FLUSH requests and when idle)
+    [[nodiscard]] uint64_t sessions_opened() const { return load(stats_atomic_.sessions_opened); }
+    [[nodiscard]] uint64_t sessions_reaped() const { return load(stats_atomic_.sessions_reaped); }
+    [[nodiscard]] uint64_t requests_received() const { return load(stats_atomic_.requests_received); }
+    [[nodiscard]] uint64_t requests_rejected() const { return load(stats_atomic_.requests_rejected); }
+    [[nodiscard]] uint64_t slow_consumers() const { return load(stats_atomic_.slow_consumers); }
+    [[nodiscard]] uint64_t auth_rejects() const { return load(stats_atomic_.auth_rejects); }
+    [[nodiscard]] uint64_t drop_copy_overflows() const { return load(stats_atomic_.drop_copy_overflows); }
+
+private:
+    struct LocalStats {
+        uint64_t sessions_opened{0};
+        uint64_t sessions_reaped{0};     // Closed because the logon socket closed (process gone)
+        uint64_t requests_received{0};
+        uint64_t requests_rejected{0};   // Refused by the gateway (ack reason != BATCH_OK)
+        uint64_t slow_consumers{0};      // Closed on a full response ring: the strategy stopped reading
+        uint64_t reports_unroutable{0};
+        uint64_t pool_exhausted{0};
+        uint64_t auth_rejects{0};        // Logons refused and requests outside the grant
+        uint64_t drop_copy_overflows{0};
+    };
+    struct AtomicStats {
+        std::atomic<uint64_t> sessions_opened{0};
+        std::atomic<uint64_t> sessions_reaped{0};
+        std::atomic<uint64_t> requests_received{0};
+        std::atomic<uint64_t> requests_rejected{0};
+        std::atomic<uint64_t> slow_consumers{0};
+        std::atomic<uint64_t> auth_rejects{0};
+        std::atomic<uint64_t> drop_copy_overflows{0};
+    };
+
+    /** Why a session closes */
+    enum class SessionEnd { DETACHED, REAPED, SLOW_CONSUMER };
+
+    /** The poller's view of a slot */
+    struct Session {
+        bool        open{false};
+        uint32_t    generation{0};  // Bumped per open: reports for an earlier client are dropped
+        ClientID     client;
+        ClientIDRaw  client_raw{0};
+        SessionGrant grant;  // Session auth only
+        int             conn{-1};         // The logon socket; closed by the strategy's exit
+        ShmEntryHeader* header{nullptr};  // The session's object (mapped while open)
+        ShmEntrySlot*   slot{nullptr};
+    };
+
+    /** An accepted logon socket whose ShmLogon has not arrived yet */
+    struct PendingLogon {
+        int      fd{-1};
+        uint64_t deadline_ns{0};
+    };
+
+    /** Where an order's reports go */
+    struct OrderRoute {
+        uint32_t    slot{0};
+        uint32_t    generation{0};
+        ClientIDRaw client{0};  // Drop copy's firm
+    };
+
+    static uint64_t load(const std::atomic<uint64_t>& value) {
+        return value.load(std::memory_order_relaxed);
+    }
+
+    RiskManager* risk_for(ClientIDRaw client) const {
+        return risk_shards_[risk_shard_for(client, risk_shards_.size())];
+    }
+
+    void poll_loop();
+    bool poll_slot(size_t s);
+    size_t take_requests(size_t s);
+    void accept_logons();
+    void answer_logon(int fd, ShmLogon& logon);
+    int create_session(size_t s, uint32_t pid);
+    void close_session(size_t s, SessionEnd end);
+    void unmap_session(Session& session);
+    void reap_dead_clients();
+    bool has_work() const;
+
+    void drain_executions();
+    void route_execution(const ExecutionReport& report);
+    void respond(const OrderRoute* route, const ShmResponse& response);
+    void publish_drop_copy(const ExecutionReport& report, const OrderRoute* route, Side side = Side::BUY);
+
+    void flush_stats();
+
+    std::string               shm_name_;
+    size_t                    slot_count_;
+    std::vector<RiskManager*> risk_shards_;
+    OrderPool*                order_pool_;
+    GatewayReactor            reactor_;
+    ClientDirectory*          client_directory_{nullptr};
+    const InstrumentDirectory* instrument_directory_{nullptr};
+    SessionAuthCache*         session_auth_{nullptr};
+    RiskLane                  risk_lane_{0};
+    bool                      cancel_on_disconnect_{false};
+
+    // Poller thread state
+    int                                      listen_fd_{-1};
+    std::vector<PendingLogon>                pending_;
+    std::vector<Session>                     sessions_;
+    OrderIdMap<OrderRoute>                   order_routes_;
+    std::vector<SPSCQueue<ExecutionReport>*> execution_queues_;
+    SPSCQueue<DropCopyRecord>*               drop_copy_{nullptr};
+    std::vector<ExecutionReport>             execution_buffer_;
+    std::vector<BatchEntryV2>                request_buffer_;
+    BatchStager<OrderRoute>                  batch_;
+    LocalStats                               local_stats_;
+    uint64_t                                 last_flush_at_{0};
+
+    std::thread                  thread_;
+    std::atomic<bool>            running_{false};
+    ThreadPlacement              placement_;
+    std::atomic<ThreadPlacement> applied_placement_{};
+    IdleStrategy                 idle_{IdlePolicy::SPIN_YIELD};
+    AtomicStats                  stats_atomic_;
+};
+
+/**
+ * Strategy side: one session. Single-threaded: the thread that sends is
+ * the ring's only producer, and the one that polls its only consumer
+ * (they may be the same thread).
+ */
+class ShmOrderEntryClient {
+public:
+    /**
+     * Log on to the exchange's gateway as `client_id`, wait (up to a
+     * second) for its answer and map the session it hands over.
+     * `auth_token` is the logon token when the exchange requires session
+     * auth; it must belong to `client_id`.
+     * @return nullptr if no gateway listens under `shm_name`, every slot
+     *         is taken, or the logon was refused or not answered
+     */
+    [[nodiscard]] static std::unique_ptr<ShmOrderEntryClient> attach(const std::string& shm_name,
+                                                                     const ClientID& client_id,
+                                                                     std::string_view auth_token = {});
+
+    /** Detach: the gateway finishes the queued requests, then drops the session. */
+    ~ShmOrderEntryClient();
+    ShmOrderEntryClient(const ShmOrderEntryClient&) = delete;
+    ShmOrderEntryClient& operator=(const ShmOrderEntryClient&) = delete;
+
+    /** @return false if the request ring is full (nothing was sent) */
+    [[nodiscard]] bool new_order(OrderID order_id, InstrumentID instrument, Side side, OrderType type,
+                                 Quantity quantity, Price price, Quantity display_quantity = 0,
+                                 Price stop_price = 0);
+    [[nodiscard]] bool cancel(OrderID order_id);
+    [[nodiscard]] bool modify(OrderID order_id, Quantity new_quantity, Price new_price = 0);
+    /** Any BATCH entry, as built for TCP. */
+    [[nodiscard]] bool send(const BatchEntryV2& request) { return slot_->requests.push(request); }
+
+    /** Copy up to `max` responses. @return how many */
+    [[nodiscard]] size_t poll(ShmResponse* out, size_t max) { return slot_->responses.pop(out, max); }
+
+    /** False once the exchange stopped polling. */
+    [[nodiscard]] bool gateway_running() const {
+        return header_->running.load(std::memory_order_relaxed) != 0;
+    }
+    /** False once the gateway closed the slot (responses not read in time): detach. */
+    [[nodiscard]] bool session_open() const {
+        return slot_->state.load(std::memory_order_acquire) == SHM_SLOT_ACTIVE;
+    }
+    [[nodiscard]] size_t slot() const { return header_->slot; }
+
+private:
+    ShmOrderEntryClient(int conn, void* map, size_t map_size);
+
+    int             conn_;  // Held open: its close tells the gateway the process is gone
+    void*           map_;
+    size_t          map_size_;
+    ShmEntryHeader* header_;
+    ShmEntrySlot*   slot_;
+};
+
+} // namespace rtes
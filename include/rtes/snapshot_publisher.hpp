@@ -0,0 +1,109 @@
+#pragma once
+
+/**
+ * @file snapshot_publisher.hpp
+ * @brief Snapshot channel: the depth of every book, in a loop, for late joiners
+ *
+ * A subscriber that starts mid-session joins the snapshot group next to
+ * the incremental channels it wants, buffers incremental depth, and takes
+ * one DepthSnapshotMessage per symbol as its starting book:
+ *
+ *   MatchingEngine::read_depth ─► SnapshotPublisher ─► snapshot group
+ *        (seqlock, any thread)      (own thread, paced)
+ *
+ * Each snapshot carries the book's update_sequence at capture; the
+ * DepthUpdateMessages of the symbol with a higher update_sequence apply
+ * on top of it, the rest are already in it. Level updates carry absolute
+ * state, so a message straddling the snapshot applies harmlessly.
+ *
+ * Books are read from the engines' published depth (see
+ * DepthPublishPolicy), never from the matching thread itself; a book
+ * with nothing published yet is skipped until it has. A snapshot
+ * therefore holds the policy's `levels` best levels per side, not the
+ * whole book (performance.depth_snapshot_levels, at most MAX_DEPTH_LEVELS). Sends are paced by
+ * a byte-rate token bucket, and a cycle starts at most once per
+ * interval, so the channel's bandwidth is bounded whatever the number of
+ * symbols.
+ */
+
+#include "rtes/udp_publisher.hpp"
+#include "rtes/matching_engine.hpp"
+#include "rtes/memory_safety.hpp"
+#include "rtes/token_bucket.hpp"
+
+#include <netinet/in.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace rtes {
+
+inline constexpr uint64_t SNAPSHOT_DEFAULT_RATE        = 1'000'000;  // Bytes per second
+inline constexpr uint32_t SNAPSHOT_DEFAULT_INTERVAL_MS = 1000;       // Min time between cycle starts
+
+/** One book on the snapshot cycle */
+struct SnapshotSource {
+    const MatchingEngine* engine{nullptr};
+    BookIndex             book{0};
+    Symbol                symbol;
+    uint8_t               channel{0};  // Incremental channel carrying it
+};
+
+class SnapshotPublisher {
+public:
+    SnapshotPublisher(const std::string& group, uint16_t port, std::vector<SnapshotSource> sources);
+    ~SnapshotPublisher();
+
+    SnapshotPublisher(const SnapshotPublisher&) = delete;
+    SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+    void start();
+    void stop();
+
+    /** Bandwidth cap in payload bytes per second. Call before start(). */
+    void set_rate(uint64_t bytes_per_second) { rate_ = bytes_per_second; }
+
+    /** Min time from one cycle start to the next. Call before start(). */
+    void set_cycle_interval(uint32_t ms) { interval_ms_ = ms; }
+
+    /**
+     * Sign every snapshot datagram with `key`, as UdpPublisher does.
+     * Call before start(). @return false if signing is unavailable
+     */
+    bool set_authentication(std::string_view key);
+
+    // Statistics
+    uint64_t snapshots_sent() const { return snapshots_sent_.load(std::memory_order_relaxed); }
+    uint64_t cycles() const { return cycles_.load(std::memory_order_relaxed); }
+    /** Books passed over because their engine had not published depth yet */
+    uint64_t books_skipped() const { return books_skipped_.load(std::memory_order_relaxed); }
+
+private:
+    std::vector<SnapshotSource> sources_;
+    sockaddr_in                 dest_{};
+    FileDescriptor              socket_fd_;
+    std::thread                 thread_;
+    std::atomic<bool>           running_{false};
+
+    uint64_t rate_{SNAPSHOT_DEFAULT_RATE};
+    uint32_t interval_ms_{SNAPSHOT_DEFAULT_INTERVAL_MS};
+    uint64_t next_sequence_{1};
+    std::unique_ptr<DatagramAuthenticator> auth_;
+
+    std::atomic<uint64_t> snapshots_sent_{0};
+    std::atomic<uint64_t> cycles_{0};
+    std::atomic<uint64_t> books_skipped_{0};
+
+    void run();
+    size_t build_snapshot(const SnapshotSource& source, uint32_t index, const DepthSnapshot& depth,
+                          uint8_t* out);
+    /** Sleep until `deadline`, in short steps so stop() is not held up. @return false if stopped */
+    bool sleep_until(Timestamp deadline);
+};
+
+} // namespace rtes
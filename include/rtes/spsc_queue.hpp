@@ -33,13 +33,24 @@
  *      Zero false sharing.
  *
  *   5. ALIGNED BUFFER ALLOCATION
- *      Buffer is cache-line aligned via std::aligned_alloc.
+ *      Buffer is a cache-line-aligned PageRegion (huge pages / THP /
+ *      heap per the process page policy, see huge_pages.hpp).
  *      Ensures buffer[0] starts on a cache line boundary.
  *
  *   6. PREFETCH SUPPORT
  *      consumer_prefetch_next() prefetches the next slot to be read.
  *      Called during batch drain to hide memory latency.
  *
+ *   7. BULK PUSH/POP
+ *      try_push_bulk()/try_pop_bulk() move a run of elements with one
+ *      index publish (and at most one cross-core reload), so a 256-entry
+ *      drain pays one release store instead of 256.
+ *
+ *   8. OPT-IN TELEMETRY
+ *      enable_telemetry() samples the depth (producer high watermark)
+ *      and enqueue → dequeue residence time on 1 in N positions (see
+ *      queue_telemetry.hpp). Off, it costs one branch on a null probe.
+ *
  * Memory ordering (minimal — only what's required):
  *   Producer: relaxed read of own head_, acquire read of tail_ (rare),
  *             release store of head_ (makes buffer write visible)
@@ -59,9 +70,13 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <new>
 #include <type_traits>
 
+#include "rtes/huge_pages.hpp"
+#include "rtes/queue_telemetry.hpp"
+
 #ifdef __x86_64__
 #include <immintrin.h>
 #endif
@@ -110,22 +125,30 @@ public:
     explicit SPSCQueue(size_t min_capacity)
         : capacity_(detail::round_up_pow2(min_capacity))
         , mask_(capacity_ - 1)
-        , buffer_(allocate_buffer(capacity_))
+        , pages_(capacity_ * sizeof(T))
+        , buffer_(static_cast<T*>(pages_.data()))
     {
         assert(capacity_ >= min_capacity);
         assert((capacity_ & mask_) == 0);  // Power of 2 invariant
     }
 
-    ~SPSCQueue() {
-        std::free(buffer_);
-    }
-
     // Non-copyable, non-movable (shared between producer/consumer threads)
     SPSCQueue(const SPSCQueue&) = delete;
     SPSCQueue& operator=(const SPSCQueue&) = delete;
     SPSCQueue(SPSCQueue&&) = delete;
     SPSCQueue& operator=(SPSCQueue&&) = delete;
 
+    /**
+     * Sample depth and residence time on one position in `sample_every`
+     * (0 = off). Call before the producer and consumer start.
+     */
+    void enable_telemetry(size_t sample_every) {
+        probe_ = sample_every ? std::make_unique<QueueProbe>(capacity_, sample_every) : nullptr;
+    }
+
+    /** Zeroed when telemetry is off */
+    [[nodiscard]] QueueTelemetry telemetry() const { return probe_ ? probe_->snapshot() : QueueTelemetry{}; }
+
     // ═══════════════════════════════════════════════════════
     //  Producer API (call from SINGLE producer thread only)
     // ═══════════════════════════════════════════════════════
@@ -153,6 +176,7 @@ public:
 
         // Write element to slot (producer owns this slot until head_ advances)
         buffer_[head & mask_] = item;
+        if (probe_) [[unlikely]] probe_push(head, 1);
 
         // Publish: make buffer write visible, then advance head
         head_.store(head + 1, std::memory_order_release);
@@ -173,10 +197,58 @@ public:
         }
 
         buffer_[head & mask_] = std::move(item);
+        if (probe_) [[unlikely]] probe_push(head, 1);
         head_.store(head + 1, std::memory_order_release);
         return true;
     }
 
+    /**
+     * Zero-copy push, part one: the next free slot, or nullptr if full.
+     * Fill it in place, then publish it with commit(). Nothing is visible
+     * to the consumer until then.
+     */
+    [[nodiscard]] T* try_claim() {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - cached_tail_ >= capacity_) [[unlikely]] {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head - cached_tail_ >= capacity_) return nullptr;
+        }
+        return &buffer_[head & mask_];
+    }
+
+    /** Zero-copy push, part two: publish the slot try_claim() returned */
+    void commit() {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (probe_) [[unlikely]] probe_push(head, 1);
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    /**
+     * Push up to `count` elements with a single head_ publish.
+     *
+     * Reloads tail_ only when the cached value leaves too little room.
+     * Elements are copied in order; a short push leaves the suffix
+     * items[n..count) to the caller.
+     *
+     * @return Number pushed (0 if full)
+     */
+    [[nodiscard]] size_t try_push_bulk(const T* items, size_t count) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+
+        size_t room = capacity_ - (head - cached_tail_);
+        if (room < count) [[unlikely]] {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            room = capacity_ - (head - cached_tail_);
+        }
+        const size_t n = count < room ? count : room;
+        if (n == 0) return 0;
+
+        copy_in(head, items, n);
+        if (probe_) [[unlikely]] probe_push(head, n);
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
     // ═══════════════════════════════════════════════════════
     //  Consumer API (call from SINGLE consumer thread only)
     // ═══════════════════════════════════════════════════════
@@ -204,12 +276,40 @@ public:
 
         // Read element from slot (consumer owns this slot until tail_ advances)
         item = buffer_[tail & mask_];
+        if (probe_) [[unlikely]] probe_->on_pop(tail, 1);
 
         // Publish: make buffer read complete, then advance tail
         tail_.store(tail + 1, std::memory_order_release);
         return true;
     }
 
+    /**
+     * Pop up to `max` elements with a single tail_ publish.
+     *
+     * The batch drain path: one release store per run instead of one
+     * per element. Reloads head_ only when the cached value holds
+     * fewer than `max` elements.
+     *
+     * @param[out] out  Receives elements in FIFO order (room for max)
+     * @return Number popped (0 if empty)
+     */
+    [[nodiscard]] size_t try_pop_bulk(T* out, size_t max) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+
+        size_t available = cached_head_ - tail;
+        if (available < max) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            available = cached_head_ - tail;
+        }
+        const size_t n = max < available ? max : available;
+        if (n == 0) return 0;
+
+        copy_out(tail, out, n);
+        if (probe_) [[unlikely]] probe_->on_pop(tail, n);
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
     /**
      * Prefetch the next element to be popped.
      * Call after a successful pop() to hide memory latency
@@ -271,9 +371,18 @@ public:
         return head - tail;  // Unsigned arithmetic handles overflow
     }
 
+    /** Elements pushed so far: a position to compare popped() against. */
+    [[nodiscard]] size_t pushed() const { return head_.load(std::memory_order_acquire); }
+
+    /** Elements the consumer has taken so far. */
+    [[nodiscard]] size_t popped() const { return tail_.load(std::memory_order_acquire); }
+
     /** Total queue capacity (always a power of 2). */
     [[nodiscard]] size_t capacity() const { return capacity_; }
 
+    /** What backs the buffer (huge pages, THP or heap). */
+    [[nodiscard]] PageBacking page_backing() const { return pages_.backing(); }
+
 private:
     // ═══════════════════════════════════════════════════════
     //  SHARED READ-ONLY DATA (written once at construction)
@@ -283,7 +392,9 @@ private:
 
     const size_t capacity_;   // Power of 2
     const size_t mask_;       // capacity_ - 1 (bitmask for index)
-    T* const     buffer_;     // Cache-line-aligned heap allocation
+    PageRegion   pages_;      // Zeroed, cache-line aligned
+    T* const     buffer_;
+    std::unique_ptr<QueueProbe> probe_;  // Telemetry; nullptr = off
 
     // ═══════════════════════════════════════════════════════
     //  PRODUCER CACHE LINE
@@ -307,28 +418,27 @@ private:
     std::atomic<size_t> tail_{0};      // Monotonically increasing
     size_t              cached_head_{0}; // Last known head (avoids acquire)
 
+    /** Telemetry: the consumer index is read only when the run holds a sampled position */
+    void probe_push(size_t pos, size_t n) {
+        if (probe_->hits(pos, n)) probe_->on_push(pos, n, pos - tail_.load(std::memory_order_relaxed));
+    }
+
     // ═══════════════════════════════════════════════════════
-    //  Buffer Allocation
+    //  Bulk Copy (at most two memcpy — the run may wrap)
     // ═══════════════════════════════════════════════════════
 
-    /**
-     * Allocate cache-line-aligned buffer.
-     * std::aligned_alloc requires size to be a multiple of alignment.
-     */
-    [[nodiscard]] static T* allocate_buffer(size_t cap) {
-        const size_t bytes = cap * sizeof(T);
-
-        // Round up to cache line boundary (required by aligned_alloc)
-        const size_t aligned_bytes =
-            (bytes + detail::CACHE_LINE - 1) & ~(detail::CACHE_LINE - 1);
-
-        void* ptr = std::aligned_alloc(detail::CACHE_LINE, aligned_bytes);
-        if (!ptr) throw std::bad_alloc();
-
-        // Zero-initialize (safe for trivially copyable types)
-        std::memset(ptr, 0, aligned_bytes);
+    void copy_in(size_t pos, const T* items, size_t n) {
+        const size_t first = pos & mask_;
+        const size_t head_run = (capacity_ - first) < n ? (capacity_ - first) : n;
+        std::memcpy(&buffer_[first], items, head_run * sizeof(T));
+        std::memcpy(&buffer_[0], items + head_run, (n - head_run) * sizeof(T));
+    }
 
-        return static_cast<T*>(ptr);
+    void copy_out(size_t pos, T* out, size_t n) const {
+        const size_t first = pos & mask_;
+        const size_t head_run = (capacity_ - first) < n ? (capacity_ - first) : n;
+        std::memcpy(out, &buffer_[first], head_run * sizeof(T));
+        std::memcpy(out + head_run, &buffer_[0], (n - head_run) * sizeof(T));
     }
 };
 
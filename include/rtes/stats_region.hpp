@@ -0,0 +1,161 @@
+#pragma once
+
+/**
+ * @file stats_region.hpp
+ * @brief Fixed-layout counters of every hot thread, readable without asking it
+ *
+ * One StatsBlock per engine and risk shard, each a Seqlock over a POD
+ * array of counters. The owning thread publishes into its block whenever
+ * it flushes its stats (between batches, never per order); anyone reads
+ * any block without a call into the component, a lock or a string.
+ *
+ *   ┌──────────────────┬──────────────┬──────────────┬─────┐
+ *   │ StatsRegionHeader│ StatsBlock 0 │ StatsBlock 1 │ ... │   64-byte aligned
+ *   └──────────────────┴──────────────┴──────────────┴─────┘
+ *
+ * The region is plain memory laid out the same in every process, so with
+ * a name it lives in POSIX shared memory (/dev/shm/<name>) and a sidecar
+ * maps it read-only (StatsRegion::open) while the exchange runs. Blocks
+ * are only ever added; `blocks` is published after a block is filled in.
+ * Counter i of a block means EngineCounter i or RiskCounter i by its kind.
+ */
+
+#include "rtes/seqlock.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rtes {
+
+inline constexpr uint32_t STATS_REGION_MAGIC   = 0x54535452;  // "RTST"
+inline constexpr uint32_t STATS_REGION_VERSION = 1;
+inline constexpr size_t   STATS_COUNTERS       = 12;          // Slots per block
+
+enum class StatsKind : uint32_t {
+    ENGINE = 1,
+    RISK   = 2,
+};
+
+/** Counter slots of a StatsKind::ENGINE block */
+enum EngineCounter : size_t {
+    ENGINE_REQUESTS,            // Requests matched (every type)
+    ENGINE_ORDERS_ACCEPTED,
+    ENGINE_ORDERS_REJECTED,
+    ENGINE_CANCELS_ACCEPTED,    // Single and mass cancels, per cancelled order
+    ENGINE_CANCELS_REJECTED,
+    ENGINE_MODIFIES_ACCEPTED,
+    ENGINE_MODIFIES_REJECTED,
+    ENGINE_TRADES,
+    ENGINE_MD_DROPS,
+    ENGINE_EXEC_DROPS,
+    ENGINE_FEEDBACK_DROPS,
+    ENGINE_BOOKS_PRUNED,
+    ENGINE_COUNTERS
+};
+
+/** Counter slots of a StatsKind::RISK block */
+enum RiskCounter : size_t {
+    RISK_PROCESSED,
+    RISK_APPROVED,
+    RISK_REJECTED,
+    RISK_CANCELS_ACCEPTED,
+    RISK_CANCELS_REJECTED,
+    RISK_MODIFIES_ACCEPTED,
+    RISK_MODIFIES_REJECTED,
+    RISK_FEEDBACK_APPLIED,
+    RISK_MASS_CANCELS,
+    RISK_ENGINE_PUSHES,
+    RISK_COUNTERS
+};
+
+static_assert(ENGINE_COUNTERS <= STATS_COUNTERS && RISK_COUNTERS <= STATS_COUNTERS,
+              "Every kind's counters fit a block");
+
+struct StatsCounters {
+    uint64_t flushes{0};                   // Publishes so far: unchanged = owner idle or stalled
+    uint64_t values[STATS_COUNTERS]{};
+};
+
+struct alignas(64) StatsBlock {
+    char      name[32]{};  // "shard-0", "risk_manager_1", ...
+    StatsKind kind{StatsKind::ENGINE};
+    uint32_t  reserved{0};
+    Seqlock<StatsCounters> counters;
+
+    /** Owner thread only. */
+    void publish(const StatsCounters& values) { counters.store(values); }
+};
+
+struct alignas(64) StatsRegionHeader {
+    uint32_t              magic{STATS_REGION_MAGIC};
+    uint32_t              version{STATS_REGION_VERSION};
+    uint32_t              capacity{0};    // Blocks the region has room for
+    uint32_t              block_size{sizeof(StatsBlock)};
+    std::atomic<uint32_t> blocks{0};      // Blocks in use (release: filled in before counted)
+    int32_t               owner_pid{0};   // Creator: while it lives, create() will not replace the region
+    uint64_t              created_unix_ns{0};
+};
+
+/** One block as a reader copied it */
+struct StatsSample {
+    std::string   name;
+    StatsKind     kind{StatsKind::ENGINE};
+    StatsCounters counters;
+    bool          consistent{false};  // false: the copy kept racing the owner (values may be torn)
+};
+
+class StatsRegion {
+public:
+    /**
+     * Writable region for `capacity` blocks: in shared memory as
+     * /dev/shm/`shm_name` (replacing one whose creator has died), or
+     * private to this process when the name is empty.
+     * @return nullptr if the shared memory cannot be created or mapped,
+     *         or another live process holds the name
+     */
+    [[nodiscard]] static std::unique_ptr<StatsRegion> create(size_t capacity,
+                                                             const std::string& shm_name = {});
+
+    /**
+     * Map another process's region read-only (a monitoring sidecar).
+     * @return nullptr if it does not exist or its layout differs from ours
+     */
+    [[nodiscard]] static std::unique_ptr<StatsRegion> open(const std::string& shm_name);
+
+    ~StatsRegion();
+    StatsRegion(const StatsRegion&) = delete;
+    StatsRegion& operator=(const StatsRegion&) = delete;
+
+    /**
+     * Claim the next block for a component. Cold path, creating process
+     * only, before the owner starts publishing.
+     * @return nullptr when the region is full or read-only
+     */
+    [[nodiscard]] StatsBlock* add(std::string_view name, StatsKind kind);
+
+    /** Copy every block in use. Any thread, any process; never blocks a writer. */
+    [[nodiscard]] std::vector<StatsSample> snapshot() const;
+
+    [[nodiscard]] size_t block_count() const {
+        return header_->blocks.load(std::memory_order_acquire);
+    }
+    [[nodiscard]] size_t capacity() const { return header_->capacity; }
+    [[nodiscard]] const std::string& shm_name() const { return shm_name_; }
+
+private:
+    StatsRegion(void* map, size_t map_size, std::string shm_name, bool owner);
+
+    StatsRegionHeader* header_;
+    StatsBlock*        blocks_;
+    void*              map_;
+    size_t             map_size_;
+    std::string        shm_name_;  // Empty: private mapping
+    bool               owner_;     // Created it: writes blocks, unlinks the name
+};
+
+} // namespace rtes
@@ -25,6 +25,7 @@ private:
     
     uint64_t bid_order_id_{0};
     uint64_t ask_order_id_{0};
+    std::atomic<bool> requote_{false};  // Hit: replace the quotes on the next tick
     
     void update_quotes();
     void cancel_existing_orders();
@@ -0,0 +1,74 @@
+#pragma once
+
+/**
+ * @file streaming_stats.hpp
+ * @brief O(1) mean / variance estimators: Welford, then EWMA
+ *
+ * StreamingStats(N) is exact (Welford's update) over the first N
+ * observations, then switches to an exponentially weighted mean and
+ * variance with alpha = 2 / (N + 1), the EWMA whose centre of mass
+ * matches an N-sample window. N = 0 stays on Welford for ever (mean and
+ * variance of everything seen).
+ *
+ * Each observation costs a few flops and no memory, unlike keeping the
+ * last N values and recomputing. Single writer, any reader, like
+ * LatencyTracker: the writer uses plain load + store on relaxed atomics,
+ * and a reader racing it may see the mean of one update with the
+ * variance of the previous one.
+ */
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace rtes {
+
+class StreamingStats {
+public:
+    explicit StreamingStats(size_t window = 0) { set_window(window); }
+
+    /** Before use, or while no one observes: also forgets what was seen */
+    void set_window(size_t window) {
+        window_ = window;
+        alpha_  = window ? 2.0 / (static_cast<double>(window) + 1.0) : 0.0;
+        count_.store(0, std::memory_order_relaxed);
+        mean_.store(0.0, std::memory_order_relaxed);
+        variance_.store(0.0, std::memory_order_relaxed);
+    }
+
+    /** Writer thread only */
+    void observe(double value) {
+        const uint64_t n    = count_.load(std::memory_order_relaxed) + 1;
+        double         mean = mean_.load(std::memory_order_relaxed);
+        double         var  = variance_.load(std::memory_order_relaxed);
+        const double   diff = value - mean;
+        if (window_ == 0 || n <= window_) {
+            // Welford, with the population variance kept instead of M2
+            mean += diff / static_cast<double>(n);
+            var  += (diff * (value - mean) - var) / static_cast<double>(n);
+        } else {
+            const double step = alpha_ * diff;
+            mean += step;
+            var   = (1.0 - alpha_) * (var + diff * step);
+        }
+        mean_.store(mean, std::memory_order_relaxed);
+        variance_.store(var, std::memory_order_relaxed);
+        count_.store(n, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    [[nodiscard]] double mean() const { return mean_.load(std::memory_order_relaxed); }
+    [[nodiscard]] double variance() const { return variance_.load(std::memory_order_relaxed); }
+    [[nodiscard]] double std_dev() const { return std::sqrt(variance()); }
+    [[nodiscard]] size_t window() const { return window_; }
+
+private:
+    size_t                window_{0};
+    double                alpha_{0.0};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<double>   mean_{0.0};
+    std::atomic<double>   variance_{0.0};
+};
+
+} // namespace rtes
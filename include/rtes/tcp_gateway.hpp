@@ -2,52 +2,315 @@
 
 #include "rtes/protocol.hpp"
 #include "rtes/risk_manager.hpp"
+#include "rtes/matching_engine.hpp"
+#include "rtes/drop_copy.hpp"
+#include "rtes/idle_strategy.hpp"
+#include "rtes/instrument_directory.hpp"
+#include "rtes/io_uring.hpp"
+#include "rtes/order_id_map.hpp"
+#include "rtes/order_trace.hpp"
 #include "rtes/memory_pool.hpp"
 #include "rtes/network_security.hpp"
+#include "rtes/session_capture.hpp"
 #include "rtes/thread_safety.hpp"
+#include "rtes/thread_affinity.hpp"
+#include "rtes/auth_middleware.hpp"
+#include "rtes/batch_staging.hpp"
+#include "rtes/tls_offload.hpp"
 
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
 #include <thread>
 #include <atomic>
 #include <vector>
 #include <memory>
 #include <cstring>
+#include <string_view>
 
 namespace rtes {
 
 // Forward declarations
 struct ConnectionState;
+class ConnectionSlab;
+
+/** A connection's slot in its reactor's ConnectionSlab (not its fd) */
+using ConnectionID = uint32_t;
+
+// ═══════════════════════════════════════════════════════════════
+//  SessionRegistry — dense session ids for egress routing
+// ═══════════════════════════════════════════════════════════════
+
+/** [generation:16][slot:16]. 0 = no session. */
+using SessionID = uint32_t;
+
+/**
+ * Maps a SessionID to its live connection with one array index and one
+ * compare. Slots are recycled through a free list; the generation half
+ * changes on every reuse, so a route recorded for a closed session
+ * resolves to nullptr instead of its fd's next owner.
+ *
+ * Single-threaded: owned by one gateway reactor (sessions open at the
+ * first message — logon — and close on disconnect).
+ */
+class SessionRegistry {
+public:
+    explicit SessionRegistry(size_t max_sessions) : slots_(max_sessions) {
+        free_.reserve(max_sessions);
+        for (size_t i = max_sessions; i-- > 0;) free_.push_back(static_cast<uint16_t>(i));
+    }
+
+    /** @return new id, or 0 if every slot is in use */
+    [[nodiscard]] SessionID open(ConnectionState* conn) {
+        if (free_.empty()) [[unlikely]] return 0;
+        const uint16_t index = free_.back();
+        free_.pop_back();
+        Slot& slot = slots_[index];
+        if (++slot.generation == 0) slot.generation = 1;  // id 0 is reserved
+        slot.conn = conn;
+        return (static_cast<SessionID>(slot.generation) << 16) | index;
+    }
+
+    void close(SessionID id) {
+        Slot* slot = live(id);
+        if (!slot) return;
+        slot->conn = nullptr;
+        free_.push_back(static_cast<uint16_t>(id & 0xFFFF));
+    }
+
+    /** Live connection for id, or nullptr if closed (or never opened). */
+    [[nodiscard]] ConnectionState* find(SessionID id) const {
+        const Slot* slot = const_cast<SessionRegistry*>(this)->live(id);
+        return slot ? slot->conn : nullptr;
+    }
+
+    [[nodiscard]] size_t open_count() const { return slots_.size() - free_.size(); }
+
+private:
+    struct Slot {
+        ConnectionState* conn{nullptr};
+        uint16_t         generation{0};
+    };
+
+    Slot* live(SessionID id) {
+        const size_t index = id & 0xFFFF;
+        if (index >= slots_.size()) [[unlikely]] return nullptr;
+        Slot& slot = slots_[index];
+        return (slot.conn && slot.generation == (id >> 16)) ? &slot : nullptr;
+    }
+
+    std::vector<Slot>     slots_;
+    std::vector<uint16_t> free_;
+};
+
+/**
+ * Order entry over TCP. Each reactor thread owns a SO_REUSEPORT listen
+ * socket on the same port, its own epoll set, connections, sessions and
+ * risk ingress lane, and accepts on its own loop — the kernel spreads
+ * new connections across reactors, and a connection never leaves the
+ * thread that accepted it. Orders are stamped with their reactor so
+ * producers route each execution report back to it.
+ */
+/** Reactor I/O: readiness (epoll / kqueue) or completions (io_uring, Linux). */
+enum class GatewayBackend : uint8_t {
+    EPOLL,
+    IO_URING
+};
+
+/** "io_uring" → IO_URING; anything else → EPOLL. */
+[[nodiscard]] GatewayBackend parse_gateway_backend(std::string_view name);
+
+/**
+ * Wire-to-risk-queue latency: from the kernel's receive timestamp of a
+ * segment to the end of the risk submits it produced (one sample per
+ * read that carried at least one message). Empty unless
+ * TcpGateway::set_ingress_timestamps() is on.
+ */
+struct IngressLatency {
+    uint64_t samples{0};
+    uint64_t avg_ns{0};
+    uint64_t max_ns{0};
+};
 
 class TcpGateway {
 public:
-    explicit TcpGateway(uint16_t port, RiskManager* risk_manager, OrderPool* order_pool);
+    /** @param reactors  Reactor threads (1..256) */
+    explicit TcpGateway(uint16_t port, RiskManager* risk_manager, OrderPool* order_pool,
+                        size_t reactors = 1);
     ~TcpGateway();
     
     void start();
     void stop();
-    
-    // Statistics
-    uint64_t connections_accepted() const { return stats_atomic_.connections_accepted.load(); }
-    uint64_t messages_received() const { return stats_atomic_.messages_received.load(); }
-    uint64_t messages_sent() const { return stats_atomic_.messages_sent.load(); }
+
+    [[nodiscard]] size_t reactor_count() const { return reactors_.size(); }
+
+    /**
+     * I/O backend for every reactor. IO_URING uses multishot accept, recv
+     * straight into each session's read buffer and batched sendmsg SQEs; with
+     * sqpoll_core >= 0 a kernel thread on that core submits them, so a
+     * busy reactor makes no syscalls. If io_uring is unavailable, start()
+     * logs it and uses EPOLL. Call before start().
+     */
+    void set_backend(GatewayBackend backend, int sqpoll_core = -1) {
+        backend_     = backend;
+        sqpoll_core_ = sqpoll_core;
+    }
+
+    /**
+     * What an idle reactor does. SPIN_PARK (default) blocks in epoll_wait
+     * until a socket or the execution doorbell fires. BUSY_SPIN polls with
+     * a zero timeout and never arms the doorbell — pin the reactor to a
+     * core of its own. SPIN_YIELD polls the same way but yields after an
+     * empty pass. io_uring reactors spin the same way. Call before start().
+     */
+    void set_idle_policy(IdlePolicy policy) { idle_policy_ = policy; }
+
+    /**
+     * Busy-poll the NIC queue for up to `usecs` per empty read (Linux
+     * SO_BUSY_POLL + SO_PREFER_BUSY_POLL on every accepted socket, and the
+     * same budget on each reactor's epoll set where the kernel supports
+     * it). 0 = off. Call before start().
+     */
+    void set_busy_poll(uint32_t usecs) { busy_poll_us_ = usecs; }
+
+    /**
+     * Set SO_INCOMING_CPU on each pinned reactor's listen socket, so the
+     * kernel hands a new connection to the reactor on the core that ran
+     * its receive softirq (pair with RSS / IRQ affinity). Call before start().
+     */
+    void set_incoming_cpu_steering(bool enabled) { incoming_cpu_ = enabled; }
+
+    /**
+     * Measure ingress_latency(): epoll reactors set SO_TIMESTAMPNS on
+     * accepted sockets and read with recvmsg to get each segment's kernel
+     * timestamp. Off (default), reads are a plain recv and no clock is
+     * read. Call before start().
+     */
+    void set_ingress_timestamps(bool enabled) { rx_timestamps_ = enabled; }
+
+    /**
+     * Connection slots per reactor (1..65536, default 1024). start() builds
+     * them all up front, read and write buffers included; a reactor with
+     * every slot taken closes new connections at accept. Call before start().
+     */
+    void set_max_connections(size_t per_reactor) {
+        max_connections_ = std::clamp<size_t>(per_reactor, 1, size_t{UINT16_MAX} + 1);
+    }
+
+    /** Backend in use (after start(), reflects any fallback). */
+    [[nodiscard]] GatewayBackend backend() const { return backend_; }
+
+    /**
+     * First risk ingress lane: reactor i produces into lane + i, so risk
+     * needs lane + reactor_count() lanes. Call before start().
+     */
+    void set_risk_lane(RiskLane lane) { risk_lane_ = lane; }
+
+    /**
+     * Resolve each session's ClientID to its dense id once, and stamp it
+     * on every request (risk indexes its client table with it). Required
+     * for more than one risk shard. Call before start().
+     */
+    void set_client_directory(ClientDirectory* directory) { client_directory_ = directory; }
+
+    /**
+     * Instrument ids for protocol v2. Without it, a v2 logon is refused
+     * and sessions stay on v1. Every new order is handed to risk with its
+     * id (v1 symbols are looked up here), so give the risk managers the
+     * same directory. Call before start().
+     */
+    void set_instrument_directory(const InstrumentDirectory* directory) {
+        instrument_directory_ = directory;
+    }
+
+    /**
+     * Submit each client's requests to its risk shard
+     * (risk_shard_for(client id, shards.size())) instead of the constructor's
+     * risk manager. Index i must be shard i. Call before start().
+     */
+    void set_risk_shards(std::vector<RiskManager*> shards);
+
+    /**
+     * On disconnect, mass cancel every order of the client the session
+     * traded as (same path as a MASS_CANCEL message). Call before start().
+     */
+    void set_cancel_on_disconnect(bool enabled) { cancel_on_disconnect_ = enabled; }
+
+    /** Core / SCHED_FIFO for a reactor thread. Call before start(). */
+    void set_thread_placement(const ThreadPlacement& placement, size_t reactor = 0) {
+        reactors_.at(reactor)->placement = placement;
+    }
+
+    /** Placement that took effect on a reactor thread (monitoring). */
+    [[nodiscard]] ThreadPlacement applied_placement(size_t reactor = 0) const {
+        return reactors_.at(reactor)->applied_placement.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Report fills/done/rejects back to the originating session.
+     * `queues` are the ones every producer fills for this reactor (see
+     * ExecutionEgress); the reactor thread is their single consumer and
+     * `doorbell` wakes it out of epoll_wait when idle. Call before start().
+     */
+    void set_execution_queues(std::vector<SPSCQueue<ExecutionReport>*> queues,
+                              EventDoorbell* doorbell = nullptr, size_t reactor = 0);
+
+    /**
+     * Copy every routed report, tagged with its firm, to the drop-copy
+     * server (one ring per reactor, never waited on: a full ring drops the
+     * copy and counts it). Needs the client directory. Call before start().
+     */
+    void set_drop_copy(DropCopyServer* server);
+
+    /**
+     * Start a lifecycle record for sampled new orders, and report their
+     * receive → ack time through one tracer sink per reactor.
+     * Call before start().
+     */
+    void set_order_tracer(OrderTracer* tracer);
+
+    /**
+     * Copy every complete inbound frame, and each disconnect, to
+     * `capture` before parsing it (one lane push per frame; see
+     * session_capture.hpp). Call before start().
+     */
+    void set_session_capture(SessionCapture* capture) { capture_ = capture; }
+
+    /**
+     * Encrypt every session (TlsOffload, owned by the caller): the reactor
+     * runs each handshake non-blocking, then the kernel carries the
+     * records and the session reads and writes like a plain one, zero-copy
+     * parsing included. Sessions the kernel cannot take are closed and
+     * counted (tls_failures). Handshakes need readiness events, so with
+     * TLS an IO_URING backend falls back to EPOLL. Call before start().
+     */
+    void set_tls(TlsOffload* tls) { tls_ = tls; }
+
+    /**
+     * Require every session to log on with an auth token (SessionAuthCache,
+     * owned by the caller). The token is checked once at logon; each order,
+     * cancel, modify and mass cancel is then authorized with a bitmask test
+     * against the session's grant, and rejected if not covered, before
+     * logon, or after a revocation. Call before start().
+     */
+    void set_session_auth(SessionAuthCache* auth) { session_auth_ = auth; }
+
+    // Statistics (summed over reactors)
+    uint64_t connections_accepted() const { return sum_stat(&AtomicStats::connections_accepted); }
+    uint64_t messages_received() const { return sum_stat(&AtomicStats::messages_received); }
+    uint64_t messages_sent() const { return sum_stat(&AtomicStats::messages_sent); }
+    uint64_t send_calls() const { return sum_stat(&AtomicStats::send_calls); }
+    uint64_t slow_consumers() const { return sum_stat(&AtomicStats::slow_consumers); }
+    uint64_t drop_copy_overflows() const { return sum_stat(&AtomicStats::drop_copy_overflows); }
+    /** TLS sessions handed to the kernel / handshakes failed or not offloaded */
+    uint64_t tls_sessions() const { return sum_stat(&AtomicStats::tls_sessions); }
+    uint64_t tls_failures() const { return sum_stat(&AtomicStats::tls_failures); }
+    /** Logons refused and messages rejected by session authorization */
+    uint64_t auth_rejects() const { return sum_stat(&AtomicStats::auth_rejects); }
+    IngressLatency ingress_latency() const;
 
 private:
-    uint16_t port_;
-    RiskManager* risk_manager_;
-    OrderPool* order_pool_;
-    std::unique_ptr<SecureNetworkLayer> secure_network_;
-    
-    // Threading
-    std::thread acceptor_thread_;
-    std::thread worker_thread_;
-    std::atomic<bool> running_{false};
-    
-    // Network File Descriptors
-    FileDescriptor listen_fd_;
-    FileDescriptor epoll_fd_;
-    
-    // Client connections (Lock-free vector indexed by FD)
-    std::vector<std::unique_ptr<ConnectionState>> connections_;
-    
     // ── Local Statistics (No atomics in hot path) ──
     struct LocalStats {
         uint64_t connections_accepted{0};
@@ -55,9 +318,21 @@ private:
         uint64_t messages_sent{0};
         uint64_t orders_rejected{0};
         uint64_t pool_exhausted{0};
+        uint64_t reports_unroutable{0};
+        uint64_t sessions_refused{0};
         uint64_t disconnections{0};
+        uint64_t mass_cancels{0};
+        uint64_t send_calls{0};
+        uint64_t slow_consumers{0};
+        uint64_t drop_copy_overflows{0};
+        uint64_t tls_sessions{0};
+        uint64_t tls_failures{0};
+        uint64_t auth_rejects{0};
+        uint64_t ingress_samples{0};
+        uint64_t ingress_latency_sum_ns{0};
+        uint64_t ingress_latency_max_ns{0};
         uint64_t next_sequence{1};
-    } local_stats_;
+    };
 
     // ── Atomic Statistics (For cross-thread monitoring) ──
     struct AtomicStats {
@@ -65,85 +340,355 @@ private:
         std::atomic<uint64_t> messages_received{0};
         std::atomic<uint64_t> messages_sent{0};
         std::atomic<uint64_t> disconnections{0};
-    } stats_atomic_;
+        std::atomic<uint64_t> send_calls{0};
+        std::atomic<uint64_t> slow_consumers{0};
+        std::atomic<uint64_t> drop_copy_overflows{0};
+        std::atomic<uint64_t> tls_sessions{0};
+        std::atomic<uint64_t> tls_failures{0};
+        std::atomic<uint64_t> auth_rejects{0};
+        std::atomic<uint64_t> ingress_samples{0};
+        std::atomic<uint64_t> ingress_latency_sum_ns{0};
+        std::atomic<uint64_t> ingress_latency_max_ns{0};
+    };
+
+    /** Where an order's reports go: its session, and its firm for drop copy. */
+    struct OrderRoute {
+        SessionID   session{0};
+        ClientIDRaw client{0};
+    };
+
+    /** One event loop. Everything but the atomics is its thread's alone. */
+    struct Reactor {
+        Reactor(GatewayReactor index, size_t max_orders);
+
+        GatewayReactor               index;
+        RiskLane                     risk_lane{0};
+        std::thread                  thread;
+        ThreadPlacement              placement;
+        std::atomic<ThreadPlacement> applied_placement{};
+
+        // Network File Descriptors
+        FileDescriptor listen_fd;
+        FileDescriptor epoll_fd;
+        std::unique_ptr<IoUring> uring;  // IO_URING backend only
+
+        // Client connections, built by start(); addressed by ConnectionID
+        std::unique_ptr<ConnectionSlab> connections;
+        std::vector<ConnectionState*>   pending_writes;  // Flushed once per iteration
+        SessionRegistry sessions;
+
+        // ── Execution reports ──
+        std::vector<SPSCQueue<ExecutionReport>*> execution_queues;
+        EventDoorbell*                           execution_doorbell{nullptr};
+        std::vector<ExecutionReport>             execution_buffer;  // One bulk pop per queue
+        OrderIdMap<OrderRoute>                   order_routes;      // Sized from the pool's max_capacity()
+        SPSCQueue<DropCopyRecord>*               drop_copy{nullptr};
+        OrderTraceSink*                          trace_sink{nullptr};
+
+        // BATCH scratch (one frame at a time)
+        BatchStager<OrderRoute>      batch;
+        std::vector<OrderTraceStart> batch_traces;  // Trace start of batch.requests()[i], false = not traced
+
+        LocalStats  local_stats;
+        AtomicStats stats_atomic;
+    };
+
+    uint16_t port_;
+    std::vector<RiskManager*> risk_shards_;  // Indexed by risk_shard_for()
+    ClientDirectory*          client_directory_{nullptr};
+    OrderTracer*              tracer_{nullptr};
+    SessionCapture*           capture_{nullptr};
+    TlsOffload*               tls_{nullptr};
+    SessionAuthCache*         session_auth_{nullptr};
+    const InstrumentDirectory* instrument_directory_{nullptr};
+    RiskLane     risk_lane_{0};
+    bool         cancel_on_disconnect_{false};
+    OrderPool* order_pool_;
+    std::unique_ptr<SecureNetworkLayer> secure_network_;
+    
+    std::vector<std::unique_ptr<Reactor>> reactors_;
+    std::atomic<bool> running_{false};
+    GatewayBackend    backend_{GatewayBackend::EPOLL};
+    int               sqpoll_core_{-1};
+    IdlePolicy        idle_policy_{IdlePolicy::SPIN_PARK};
+    uint32_t          busy_poll_us_{0};
+    bool              incoming_cpu_{false};
+    bool              rx_timestamps_{false};
+    size_t            max_connections_{1024};
+
+    uint64_t sum_stat(std::atomic<uint64_t> AtomicStats::* stat) const {
+        uint64_t total = 0;
+        for (const auto& r : reactors_) total += (r->stats_atomic.*stat).load(std::memory_order_relaxed);
+        return total;
+    }
     
     // Network setup
-    bool setup_listen_socket();
-    bool setup_epoll();
+    bool setup_listen_socket(Reactor& r);
+    bool setup_epoll(Reactor& r);
+    bool setup_uring();
     
     // Thread loops
-    void acceptor_loop();
-    void worker_loop();
+    void reactor_loop(Reactor& r);
+    void uring_loop(Reactor& r);
+    bool drain_uring(Reactor& r);
     
     // Connection management
-    void handle_client_data(int client_fd);
-    void remove_connection(int client_fd);
+    ConnectionState* install_connection(Reactor& r, int client_fd);
+    bool open_session(Reactor& r, ConnectionState& conn);
+    void accept_connections(Reactor& r);
+    void handle_client_data(Reactor& r, ConnectionState& conn);
+    bool advance_tls(Reactor& r, ConnectionState& conn);
+    bool authorize(Reactor& r, ConnectionState& conn, uint32_t permission, uint64_t order_id);
+    bool owns_client(Reactor& r, ConnectionState& conn, const ClientID& client, uint64_t order_id);
+    void handle_writable(Reactor& r, ConnectionState& conn);
+    void remove_connection(Reactor& r, ConnectionState& conn);
+    void apply_busy_poll(int fd, bool epoll_set);
+    
+    // io_uring completions
+    void uring_complete(Reactor& r, uint64_t user_data, int32_t res, uint32_t flags);
+    void uring_arm_recv(Reactor& r, ConnectionState& conn);
+    void uring_on_recv(Reactor& r, ConnectionState& conn, int32_t res);
+    void uring_on_send(Reactor& r, ConnectionState& conn, int32_t res);
+    void uring_send(Reactor& r, ConnectionState& conn);
     
     // Message processing
-    bool try_process_message(ConnectionState& conn);
-    void process_message(ConnectionState& conn, const uint8_t* data, size_t length);
-    void handle_new_order(ConnectionState& conn, const uint8_t* data, size_t length);
-    void handle_cancel_order(ConnectionState& conn, const uint8_t* data, size_t length);
+    bool try_process_message(Reactor& r, ConnectionState& conn);
+    void capture_frame(Reactor& r, ConnectionState& conn, size_t length);
+    void process_message(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length);
+    void handle_logon(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length);
+    void handle_new_order(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length);
+    void handle_cancel_order(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length);
+    void handle_modify_order(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length);
+    void handle_mass_cancel(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length);
+
+    // Protocol v2 (session identity, instrument ids)
+    void process_message_v2(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length);
+    void handle_new_order_v2(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length);
+    void handle_cancel_order_v2(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length);
+    void handle_modify_order_v2(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length);
+    void handle_mass_cancel_v2(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length);
+    void handle_batch_v2(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length);
+
+    /** Pooled order, or nullptr after rejecting order_id (pool exhausted). */
+    Order* allocate_order(Reactor& r, ConnectionState& conn, OrderID order_id);
+
+    /** Route, submit to risk and ack a filled-in order (both protocols). */
+    void submit_new_order(Reactor& r, ConnectionState& conn, Order* order, ClientIDRaw client_raw,
+                          InstrumentID instrument);
+    void submit_cancel(Reactor& r, ConnectionState& conn, OrderID order_id,
+                       const ClientID& client, ClientIDRaw client_raw);
+    void submit_modify(Reactor& r, ConnectionState& conn, OrderID order_id, const ClientID& client,
+                       ClientIDRaw client_raw, Quantity new_quantity, Price new_price);
+
+    /** Mass cancel `client` (all symbols if `symbol` is empty). @return false if risk queue full */
+    bool submit_mass_cancel(Reactor& r, ConnectionState& conn, const ClientID& client,
+                            const Symbol& symbol);
+
+    /** Risk shard owning `client` (the only one unless set_risk_shards()). */
+    RiskManager* risk_for(ClientIDRaw client) const {
+        return risk_shards_[risk_shard_for(client, risk_shards_.size())];
+    }
+
+    /**
+     * Dense id of `client`, cached on the session. 0 without a directory,
+     * when the directory is full, or (create == false) for unknown clients.
+     */
+    ClientIDRaw resolve_client(ConnectionState& conn, const ClientID& client, bool create);
+
+    // Execution reports
+    bool arm_execution_doorbell(Reactor& r);
+    void drain_executions(Reactor& r);
+    void route_execution(Reactor& r, const ExecutionReport& report);
+    const OrderRoute* find_route(Reactor& r, OrderID order_id);
+    ConnectionState* session_of(Reactor& r, const OrderRoute* route);
+    void publish_drop_copy(Reactor& r, const ExecutionReport& report, const OrderRoute* route,
+                           Side side = Side::BUY);
     
-    // Responses
-    void send_ack(ConnectionState& conn, uint64_t order_id, uint8_t status, const char* reason);
-    void send_reject(ConnectionState& conn, uint64_t order_id, const char* reason);
+    // Responses (queued on the session, sent by flush_writes)
+    bool enqueue(Reactor& r, ConnectionState& conn, const void* message, size_t length);
+    void queue_flush(Reactor& r, ConnectionState& conn);
+    bool write_pending(Reactor& r, ConnectionState& conn);
+    void flush_writes(Reactor& r);
+    void send_ack(Reactor& r, ConnectionState& conn, uint64_t order_id, uint8_t status,
+                  const char* reason);
+    void send_reject(Reactor& r, ConnectionState& conn, uint64_t order_id, const char* reason);
+    void send_trade(Reactor& r, ConnectionState& conn, const Trade& trade);
 
     // Maintenance
-    void maybe_flush_stats();
-    void flush_stats();
+    void record_ingress(Reactor& r, uint64_t rx_realtime_ns);
+    void maybe_flush_stats(Reactor& r);
+    void flush_stats(Reactor& r);
 };
 
 // ═══════════════════════════════════════════════════════════════
 //  Internal Types for TCP Gateway (moved from .cpp)
 // ═══════════════════════════════════════════════════════════════
 
+/**
+ * Inbound bytes, parsed in place. consume() only advances the read
+ * offset; the unparsed tail is moved to the front by make_room(), and
+ * only once the free space behind it drops below a maximum-size frame —
+ * so a pipelined client costs one small memmove per ~4 KiB, not one per
+ * message.
+ */
 class ReadBuffer {
 public:
+    static constexpr size_t CAPACITY = 8192;          // READ_BUFFER_SIZE
+    static constexpr size_t MIN_FREE = CAPACITY / 2;  // Room always left for one whole frame
+
     ReadBuffer() = default;
 
-    [[nodiscard]] bool append(const uint8_t* data, size_t len) {
-        if (used_ + len > CAPACITY) return false;
-        std::memcpy(buf_ + used_, data, len);
-        used_ += len;
+    void consume(size_t n) {
+        head_ += n;
+        if (head_ >= tail_) head_ = tail_ = 0;  // Drained: free reset
+    }
+
+    /** Call before reading into write_ptr(). */
+    void make_room() {
+        if (CAPACITY - tail_ >= MIN_FREE || head_ == 0) [[likely]] return;
+        std::memmove(buf_, buf_ + head_, tail_ - head_);
+        tail_ -= head_;
+        head_  = 0;
+    }
+
+    [[nodiscard]] const uint8_t* data() const { return buf_ + head_; }
+    [[nodiscard]] size_t size() const { return tail_ - head_; }
+    [[nodiscard]] size_t remaining() const { return CAPACITY - tail_; }
+    [[nodiscard]] uint8_t* write_ptr() { return buf_ + tail_; }
+
+    void advance_write(size_t n) { tail_ += n; }
+    void clear() { head_ = tail_ = 0; }
+
+private:
+    uint8_t buf_[CAPACITY]{};
+    size_t  head_{0};  // Next unparsed byte
+    size_t  tail_{0};  // End of received data
+};
+
+/**
+ * Outbound byte ring. Responses are appended while the reactor handles
+ * input and reports, then written once per loop iteration with one
+ * sendmsg — two iovecs when the data wraps, so nothing is ever moved.
+ */
+class WriteBuffer {
+public:
+    [[nodiscard]] bool append(const void* data, size_t len) {
+        if (len > remaining()) return false;
+        const size_t pos   = tail_ & MASK;
+        const size_t first = std::min(len, CAPACITY - pos);
+        std::memcpy(buf_ + pos, data, first);
+        std::memcpy(buf_, static_cast<const uint8_t*>(data) + first, len - first);
+        tail_ += len;
         return true;
     }
 
+    /** Fill iov with the unsent bytes. @return iovec count (0..2) */
+    [[nodiscard]] size_t pending(iovec (&iov)[2]) {
+        const size_t used = size();
+        if (used == 0) return 0;
+        const size_t pos   = head_ & MASK;
+        const size_t first = std::min(used, CAPACITY - pos);
+        iov[0] = {buf_ + pos, first};
+        iov[1] = {buf_, used - first};
+        return first == used ? 1 : 2;
+    }
+
     void consume(size_t n) {
-        if (n >= used_) {
-            used_ = 0;
-        } else {
-            used_ -= n;
-            std::memmove(buf_, buf_ + n, used_);
-        }
+        head_ += n;
+        if (head_ == tail_) head_ = tail_ = 0;
     }
 
-    [[nodiscard]] const uint8_t* data() const { return buf_; }
-    [[nodiscard]] size_t size() const { return used_; }
-    [[nodiscard]] size_t remaining() const { return CAPACITY - used_; }
-    [[nodiscard]] uint8_t* write_ptr() { return buf_ + used_; }
+    [[nodiscard]] bool empty() const { return head_ == tail_; }
+    [[nodiscard]] size_t size() const { return tail_ - head_; }
+    [[nodiscard]] size_t remaining() const { return CAPACITY - size(); }
 
-    void advance_write(size_t n) { used_ += n; }
-    void clear() { used_ = 0; }
+    void clear() { head_ = tail_ = 0; }
 
 private:
-    static constexpr size_t CAPACITY = 8192; // READ_BUFFER_SIZE
+    static constexpr size_t CAPACITY = 16384;  // ~170 acks; power of two
+    static constexpr size_t MASK     = CAPACITY - 1;
+    static_assert((CAPACITY & MASK) == 0);
+
     uint8_t buf_[CAPACITY]{};
-    size_t  used_{0};
+    size_t  head_{0};
+    size_t  tail_{0};
 };
 
-struct ConnectionState {
+struct alignas(64) ConnectionState {
     FileDescriptor fd;
     ReadBuffer     read_buf;
-    std::string    client_id;      
+    WriteBuffer    write_buf;
+    ClientID       client_id;      // Last client seen on this session (mass cancel scope)
+    ClientIDRaw    client_raw{0};  // Its directory id (resolved once, not per message)
+    SessionID      session{0};     // Opened by its reactor at logon; routes execution reports
+    uint8_t        protocol{PROTOCOL_V1};  // Framing of inbound messages, set by LOGON
     bool           authenticated{false};
-    bool           connected{true};
+    SessionGrant   grant;                // Session auth: granted at logon, checked per message
+    bool           connected{false};
+    bool           in_use{false};        // Held by an accepted connection (until its last CQE)
+    bool           flush_queued{false};  // On the reactor's pending_writes list
+    bool           closing{false};       // Bad frame, send failed or buffer overflowed
+
+    // io_uring: the kernel holds the socket while an op is in flight, so
+    // a removed connection is shut down and retired on its last CQE
+    bool           recv_armed{false};
+    bool           send_inflight{false};
+    bool           retiring{false};
+    msghdr         send_msg{};           // Read by the kernel until the send CQE
+    iovec          send_iov[2]{};
     Timestamp      connect_time{0};
     uint32_t       messages_received{0};
+    ConnectionID   id{0};                // Slot in the reactor's ConnectionSlab
+    uint32_t       generation{0};        // Bumped per accept: tells stale poller events apart
+    TlsHandshake*  tls{nullptr};         // Handshake in progress (set_tls); plain I/O once null
 
-    explicit ConnectionState(int raw_fd);
+    /** Reset for a newly accepted fd (no allocation). */
+    void reopen(int raw_fd);
     void setup_socket();
     void disconnect();
 };
 
+/**
+ * Every connection slot of one reactor, built at startup in one
+ * cache-aligned PageRegion (page policy applies), read and write
+ * buffers included: accepting a connection allocates nothing, and a
+ * burst of logons at the open lands on memory that is already faulted
+ * in. Connections are addressed by slot (ConnectionID), which is what
+ * epoll, kqueue and io_uring carry back, so fd numbers are unbounded.
+ * Closed slots are reused LIFO, the most recently used first.
+ *
+ * Single-threaded: owned by its reactor.
+ */
+class ConnectionSlab {
+public:
+    explicit ConnectionSlab(size_t capacity);
+    ~ConnectionSlab();
+
+    ConnectionSlab(const ConnectionSlab&) = delete;
+    ConnectionSlab& operator=(const ConnectionSlab&) = delete;
+
+    /** A free slot, reopened on fd; nullptr if every slot is in use */
+    [[nodiscard]] ConnectionState* open(int fd);
+
+    /** Back on the free list. @pre conn is disconnected and from this slab */
+    void close(ConnectionState& conn);
+
+    [[nodiscard]] ConnectionState& operator[](ConnectionID id) { return slots_[id]; }
+    [[nodiscard]] size_t capacity() const { return capacity_; }
+    [[nodiscard]] size_t open_count() const { return capacity_ - free_.size(); }
+
+    template<typename F>
+    void for_each_open(F&& f) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            if (slots_[i].in_use) f(slots_[i]);
+        }
+    }
+
+private:
+    PageRegion                region_;
+    ConnectionState*          slots_;
+    size_t                    capacity_;
+    std::vector<ConnectionID> free_;
+};
+
 } // namespace rtes
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+/**
+ * @file thread_affinity.hpp
+ * @brief CPU pinning, SCHED_FIFO and memory locking for hot threads
+ *
+ * Hot threads (matching, risk, gateway worker, UDP publisher) apply
+ * their placement as the first thing on the thread itself, so no
+ * pthread handle crosses threads. What actually took effect is stored
+ * by the component and surfaced in ExchangeStats.
+ *
+ * Failures (no permission, core out of range, non-Linux) are logged
+ * and leave the thread floating — placement never stops a component.
+ */
+
+#include <cstdint>
+
+namespace rtes {
+
+/**
+ * Where a thread should run.
+ *   core          : CPU to pin to, -1 = float
+ *   fifo_priority : SCHED_FIFO priority 1–99, 0 = default scheduler
+ */
+struct ThreadPlacement {
+    int32_t core{-1};
+    int32_t fifo_priority{0};
+};
+
+/**
+ * Apply placement to the calling thread.
+ * @param name  Thread name for logs (and the kernel comm name, ≤15 chars)
+ * @return The placement that took effect (fields reset on failure)
+ */
+ThreadPlacement apply_thread_placement(const ThreadPlacement& placement, const char* name);
+
+/**
+ * Lock current and future pages (mlockall) so hot paths never fault.
+ * @return false if not permitted or unsupported
+ */
+bool lock_process_memory();
+
+} // namespace rtes
@@ -0,0 +1,87 @@
+#pragma once
+
+/**
+ * @file tls_offload.hpp
+ * @brief TLS handshake in OpenSSL, record crypto in the kernel (kTLS)
+ *
+ *   accept ─► begin(fd) ─► advance() … WANT_READ/WANT_WRITE … ─► DONE
+ *                          (non-blocking SSL_accept on the reactor)
+ *   DONE: both directions are kernel TLS; the SSL object is freed and
+ *         the socket is used with plain recv/writev from then on
+ *
+ * The context enables SSL_OP_ENABLE_KTLS, so OpenSSL installs the
+ * session keys on the socket (setsockopt SOL_TLS, TLS_TX / TLS_RX) as the
+ * handshake switches to application keys. Once both are in the kernel,
+ * encryption, decryption and record framing happen in the socket layer
+ * (or on the NIC when the driver offloads it, see `ethtool -k`), and
+ * user space only ever sees plaintext. A session whose keys could not be
+ * offloaded fails with NO_OFFLOAD rather than falling back to SSL_read /
+ * SSL_write on the reactor.
+ *
+ * Only ciphers the kernel implements are offered (AES-GCM, ChaCha20-
+ * Poly1305), TLS 1.2 and 1.3, with no session tickets and no
+ * renegotiation. A TLS alert or post-handshake message after the
+ * handshake arrives as a non-data record, which the gateway treats as
+ * the end of the session.
+ *
+ * Needs Linux with the `tls` module and OpenSSL 3 built with kTLS;
+ * init() fails without OpenSSL; without kTLS every handshake ends in
+ * NO_OFFLOAD (logged once). The context is shared: reactors may run
+ * handshakes concurrently.
+ */
+
+#include <cstdint>
+#include <string>
+
+struct ssl_st;
+struct ssl_ctx_st;
+
+namespace rtes {
+
+struct TlsOptions {
+    std::string cert_file;  // PEM server certificate (chain)
+    std::string key_file;   // PEM private key
+    std::string ca_file;    // PEM CAs for client certificates; empty = no client certificate
+};
+
+/** One handshake in progress (an OpenSSL SSL); owned by TlsOffload until it ends */
+using TlsHandshake = ssl_st;
+
+class TlsOffload {
+public:
+    enum class Status : uint8_t {
+        DONE,        // Handshake complete, both directions in the kernel
+        WANT_READ,   // Call advance() again when the socket is readable
+        WANT_WRITE,  // ... or writable
+        FAILED,      // Handshake error (bad certificate, protocol, EOF)
+        NO_OFFLOAD,  // Handshake complete but the kernel did not take the keys
+    };
+
+    TlsOffload() = default;
+    ~TlsOffload();
+
+    TlsOffload(const TlsOffload&) = delete;
+    TlsOffload& operator=(const TlsOffload&) = delete;
+
+    /** Load the certificate and key. @return false (logged) if unusable */
+    bool init(const TlsOptions& options);
+
+    [[nodiscard]] bool ready() const { return ctx_ != nullptr; }
+
+    /** Start the server side of a handshake on a non-blocking socket; nullptr on failure */
+    [[nodiscard]] TlsHandshake* begin(int fd);
+
+    /**
+     * Drive the handshake as far as the socket allows. On any status but
+     * WANT_READ / WANT_WRITE the handshake is freed (the fd stays open).
+     */
+    Status advance(TlsHandshake* handshake);
+
+    /** Free a handshake that will not finish (connection dropped) */
+    void abort(TlsHandshake* handshake);
+
+private:
+    ssl_ctx_st* ctx_{nullptr};
+};
+
+} // namespace rtes
@@ -0,0 +1,78 @@
+#pragma once
+
+/**
+ * @file token_bucket.hpp
+ * @brief Integer token bucket refilled from caller-supplied timestamps
+ *
+ * Tokens are held in fixed point: one token = period_ns units, and each
+ * elapsed nanosecond adds tokens_per_period units. Refill is exact (no
+ * float, no division, no fraction lost between calls) and smooth: a
+ * full bucket allows `burst`, then the steady rate — never the 2× burst
+ * a reset-every-window counter allows across a window edge.
+ *
+ * The caller supplies `now`, so a batch of checks can share one clock
+ * read. Timestamps must be non-zero and non-decreasing per bucket.
+ *
+ * Not thread-safe: a bucket belongs to one thread (or one lock holder).
+ */
+
+#include "rtes/types.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace rtes {
+
+/** Per-client state. Zero-initialised = never used; first use starts full. */
+struct TokenBucket {
+    uint64_t  level{0};    // Tokens × period_ns
+    Timestamp last_ns{0};
+};
+
+/** Rate and burst shared by every bucket it governs. */
+class TokenBucketLimit {
+public:
+    TokenBucketLimit() = default;
+
+    /** `tokens_per_period` tokens every `period_ns`, at most `burst` held. */
+    TokenBucketLimit(uint64_t tokens_per_period, uint64_t period_ns, uint64_t burst)
+        : rate_(tokens_per_period)
+        , unit_(std::max<uint64_t>(period_ns, 1))
+        , capacity_(std::min<uint64_t>(burst, MAX_UNITS / unit_) * unit_)
+        , full_after_ns_(rate_ ? (capacity_ + rate_ - 1) / rate_ : 0)
+    {}
+
+    [[nodiscard]] bool try_consume(TokenBucket& bucket, Timestamp now,
+                                   uint64_t tokens = 1) const {
+        refill(bucket, now);
+        if (tokens > bucket.level / unit_) [[unlikely]] return false;
+        bucket.level -= tokens * unit_;
+        return true;
+    }
+
+    void refill(TokenBucket& bucket, Timestamp now) const {
+        if (bucket.last_ns == 0) [[unlikely]] {
+            bucket.level = capacity_;
+            bucket.last_ns = now;
+            return;
+        }
+        if (now <= bucket.last_ns) return;
+        // Past full_after_ns_ the bucket is full anyway; the cap keeps
+        // elapsed × rate from overflowing after long idle periods
+        const uint64_t elapsed = std::min<uint64_t>(now - bucket.last_ns, full_after_ns_);
+        bucket.level = std::min(capacity_, bucket.level + elapsed * rate_);
+        bucket.last_ns = now;
+    }
+
+    [[nodiscard]] uint64_t burst() const { return capacity_ / unit_; }
+
+private:
+    static constexpr uint64_t MAX_UNITS = UINT64_MAX / 4;  // Headroom for level + refill
+
+    uint64_t rate_{0};           // Units added per ns
+    uint64_t unit_{1};           // Units per token
+    uint64_t capacity_{0};       // burst × unit_
+    uint64_t full_after_ns_{0};  // Time that refills an empty bucket
+};
+
+} // namespace rtes
@@ -44,6 +44,8 @@ using Quantity       = uint64_t;
 using SequenceNumber = uint64_t;
 using Timestamp      = uint64_t;   // Nanoseconds since steady_clock epoch
 using ClientIDRaw    = uint32_t;   // Numeric client identifier (fast)
+using GatewayReactor = uint8_t;    // TCP gateway reactor (thread) that owns a session
+using InstrumentID   = uint16_t;   // Dense symbol index (InstrumentDirectory, protocol v2)
 
 /** Price scaling factor: 4 decimal places of precision */
 inline constexpr uint64_t PRICE_SCALE = 10000;
@@ -106,6 +108,16 @@ struct FixedString {
         }
     }
 
+    /**
+     * Copy an N-byte fixed-width wire field verbatim (no strlen). The
+     * last byte is forced to '\0'; bytes after an earlier terminator
+     * are kept but ignored by comparison and hashing.
+     */
+    void assign_field(const char* field) {
+        std::memcpy(data, field, N);
+        data[N - 1] = '\0';
+    }
+
     void clear() {
         data[0] = '\0';
     }
@@ -165,9 +177,71 @@ enum class Side : uint8_t {
     SELL = 2,
 };
 
+/**
+ * Order type / handling instruction (wire value = NewOrderMessage.order_type).
+ *
+ *   MARKET    : sweep at any price; remainder rests at price 0
+ *   LIMIT     : sweep while crossing; remainder rests
+ *   IOC       : LIMIT, remainder cancelled instead of resting
+ *   FOK       : LIMIT, rejected unless the whole quantity fills now
+ *   POST_ONLY : rests only; rejected if it would take liquidity
+ *   STOP      : parked until last trade reaches stop_price, then MARKET
+ *   STOP_LIMIT: parked until last trade reaches stop_price, then LIMIT
+ */
 enum class OrderType : uint8_t {
-    MARKET = 1,
-    LIMIT  = 2,
+    MARKET     = 1,
+    LIMIT      = 2,
+    IOC        = 3,
+    FOK        = 4,
+    POST_ONLY  = 5,
+    STOP       = 6,
+    STOP_LIMIT = 7,
+};
+
+/** All types except MARKET and STOP carry a limit price. */
+[[nodiscard]] constexpr bool has_limit_price(OrderType t) {
+    return t != OrderType::MARKET && t != OrderType::STOP;
+}
+
+/** Types parked in the stop trigger index until activated. */
+[[nodiscard]] constexpr bool is_stop(OrderType t) {
+    return t == OrderType::STOP || t == OrderType::STOP_LIMIT;
+}
+
+/** IOC and FOK never leave a resting remainder. */
+[[nodiscard]] constexpr bool rests_remainder(OrderType t) {
+    return t != OrderType::IOC && t != OrderType::FOK;
+}
+
+/**
+ * Self-trade prevention (STP), applied when an aggressor would match a
+ * resting order with the same Order::owner. Aggressor = newest.
+ *
+ *   NONE          : match as usual
+ *   CANCEL_NEWEST : cancel the aggressor's remainder
+ *   CANCEL_OLDEST : cancel the resting order, keep sweeping
+ *   CANCEL_BOTH   : cancel both
+ *   DECREMENT     : reduce both by the smaller quantity, no trade;
+ *                   whichever reaches zero is cancelled
+ */
+enum class SelfTradePrevention : uint8_t {
+    NONE          = 0,
+    CANCEL_NEWEST = 1,
+    CANCEL_OLDEST = 2,
+    CANCEL_BOTH   = 3,
+    DECREMENT     = 4,
+};
+
+/**
+ * Per-symbol trading phase.
+ *   CONTINUOUS : orders match on arrival
+ *   AUCTION    : orders accumulate (crossing allowed) until uncross
+ *   HALTED     : cancel-only; resting orders stay, nothing matches
+ */
+enum class TradingPhase : uint8_t {
+    CONTINUOUS = 0,
+    AUCTION    = 1,
+    HALTED     = 2,
 };
 
 enum class OrderStatus : uint8_t {
@@ -203,22 +277,39 @@ enum class OrderStatus : uint8_t {
 /**
  * Core order structure with cache-optimized field layout.
  *
- * Layout strategy: HOT fields first, COLD fields last.
+ * Layout strategy: two cache-line-aligned lines, one hot, one cold.
  *
- * During matching, the engine accesses:
- *   price, remaining_quantity, side, type, id, status
- * These are packed into the first 32 bytes (half a cache line).
+ * Line 0 holds everything the matching sweep reads or writes:
+ *   price, remaining_quantity, side, type, id, status, owner
+ *   (the first 32 bytes), the level links it follows to the next
+ *   passive order, and the reserve it refreshes an iceberg slice from.
  *
- * Cold fields (client_id, symbol, original quantity, timestamp)
- * are accessed only for:
- *   - Trade reporting
- *   - Cancel ownership verification
+ * Line 1 holds the cold fields (client_id, symbol, original quantity,
+ * timestamp, stop_price), accessed only for:
+ *   - Execution reports
+ *   - Cancel / modify ownership verification
+ *   - Stop triggering
  *   - Logging
  *
- * Total size: 96 bytes (1.5 cache lines).
- * Hot data fits in first cache line load.
+ * So a sweep through a level, and the prefetch of the next passive
+ * order, touch one line per order instead of two. Pool slots are
+ * cache-line aligned, so line 0 never straddles.
+ *
+ * Book links (level_prev/level_next) are owned by the resting
+ * FlatLevel when the book runs with intrusive levels: pop_front()
+ * follows level_next, rest and cancel relink.
+ *
+ * Reserve (iceberg) orders: remaining_quantity is the displayed
+ * slice resting in the level; hidden_quantity is the reserve behind
+ * it. When the slice fills, the next one is shown at the back of the
+ * queue (refresh_slice()). Reserve never reaches BBO or depth.
+ *
+ * Stop orders carry their trigger in stop_price; price is the limit
+ * applied once a STOP_LIMIT is activated.
+ *
+ * Total size: 128 bytes (two cache lines).
  */
-struct Order {
+struct alignas(64) Order {
     // ── HOT DATA (accessed during matching) ── first 32 bytes ──
 
     Price         price{0};               //  8B  [0]
@@ -227,17 +318,29 @@ struct Order {
     OrderStatus   status{OrderStatus::PENDING}; // 1B [24]
     Side          side{Side::BUY};        //  1B  [25]
     OrderType     type{OrderType::LIMIT}; //  1B  [26]
-    uint8_t       pad_[5]{};              //  5B  [27-31] explicit padding
+    GatewayReactor ingress{0};            //  1B  [27] gateway reactor that accepted it (report routing)
+    ClientIDRaw   owner{0};               //  4B  [28] numeric client_id for STP (0 = unknown)
 
-    // ── WARM DATA (accessed for trade reporting) ── bytes 32-63 ──
+    // ── BOOK LINKS (intrusive level FIFO, owned by FlatLevel) ── bytes 32+ ──
 
-    Quantity      quantity{0};            //  8B  [32] original quantity
-    Timestamp     timestamp{0};           //  8B  [40] creation time
-    Symbol        symbol;                 //  8B  [48] instrument
+    Order*        level_prev{nullptr};    //  8B  [32]
+    Order*        level_next{nullptr};    //  8B  [40]
 
-    // ── COLD DATA (accessed rarely) ── bytes 64+ ──
+    // ── RESERVE (iceberg), owned by OrderBook ── bytes 48+ ──
 
-    ClientID      client_id;              // 32B  [56] owner
+    Quantity      display_quantity{0};    //  8B  [48] slice size, 0 = fully displayed
+    Quantity      hidden_quantity{0};     //  8B  [56] reserve not yet shown
+
+    // ── COLD DATA (reports, ownership checks) ── second cache line ──
+
+    Quantity      quantity{0};            //  8B  [64] original quantity
+    Timestamp     timestamp{0};           //  8B  [72] creation time
+    Symbol        symbol;                 //  8B  [80] instrument
+    ClientID      client_id;              // 32B  [88] owner
+
+    // ── TRIGGER (stop orders) ── bytes 120+ ──
+
+    Price         stop_price{0};          //  8B  [120] STOP / STOP_LIMIT trigger
 
     // ── Constructors ──
 
@@ -261,15 +364,46 @@ struct Order {
         , symbol(sym)
         , client_id(client)
     {}
+
+    // ── Reserve helpers ──
+
+    /** Open quantity including the hidden reserve */
+    [[nodiscard]] Quantity open_quantity() const { return remaining_quantity + hidden_quantity; }
+
+    /** Move everything beyond the display slice into the reserve. */
+    void split_reserve() {
+        if (display_quantity != 0 && remaining_quantity > display_quantity) {
+            hidden_quantity += remaining_quantity - display_quantity;
+            remaining_quantity = display_quantity;
+        }
+    }
+
+    /**
+     * Show the next slice from the reserve.
+     * @pre remaining_quantity == 0 && hidden_quantity > 0
+     */
+    void refresh_slice() {
+        remaining_quantity = (hidden_quantity < display_quantity) ? hidden_quantity : display_quantity;
+        hidden_quantity   -= remaining_quantity;
+    }
 };
 
+/**
+ * An Order by its OrderPool slot (OrderPool::handle() / at()): 4 bytes
+ * instead of a pointer in level queues and engine requests.
+ */
+using OrderHandle = uint32_t;
+
 // Verify trivial copyability (required if Order is ever stored by value)
 static_assert(std::is_trivially_copyable_v<Order>,
     "Order must be trivially copyable");
 
-// Verify hot data fits in first 32 bytes
-static_assert(offsetof(Order, quantity) >= 32,
-    "Warm data must start at or after byte 32");
+// Verify the sweep's fields share the first cache line and cold data starts the second
+static_assert(offsetof(Order, hidden_quantity) + sizeof(Quantity) <= 64,
+    "Matching fields must fit in the first cache line");
+static_assert(offsetof(Order, quantity) == 64,
+    "Cold data must start the second cache line");
+static_assert(sizeof(Order) == 128, "Order must stay two cache lines");
 
 // ═══════════════════════════════════════════════════════════════
 //  Trade — Minimal, trivially copyable trade record
@@ -310,6 +444,23 @@ struct Trade {
         , timestamp(now_timestamp())  // Only on explicit construction
         , symbol(sym)
     {}
+
+    /** Matching path: match time read once per sweep by the caller, no clock read here */
+    Trade(TradeID trade_id,
+          OrderID buy_id,
+          OrderID sell_id,
+          const char* sym,
+          Quantity qty,
+          Price p,
+          Timestamp match_time)
+        : id(trade_id)
+        , buy_order_id(buy_id)
+        , sell_order_id(sell_id)
+        , price(p)
+        , quantity(qty)
+        , timestamp(match_time)
+        , symbol(sym)
+    {}
 };
 
 // Critical compile-time checks
@@ -320,4 +471,42 @@ static_assert(std::is_trivially_copyable_v<Trade>,
 static_assert(sizeof(Trade) <= 64,
     "Trade should fit in one cache line for queue efficiency");
 
+// ═══════════════════════════════════════════════════════════════
+//  OrderEvent — One change to a resting order (market by order)
+// ═══════════════════════════════════════════════════════════════
+
+/**
+ * What happened to one resting order, as the book's FIFO sees it. The
+ * same record goes from OrderBook through MarketDataEvent to the wire
+ * (OrderUpdateMessage), like Trade. It carries no client identity and
+ * only the displayed quantity (never an iceberg's reserve).
+ *
+ *   ADD      (Re)joins the back of its level: rests, requeues after a
+ *            size-up, or shows an iceberg's next slice. An ADD for an
+ *            id already queued moves it to the back.
+ *   EXECUTE  Traded `quantity` against an incoming order, or both sides
+ *            during an uncross; `remaining` 0 = off the book
+ *   CANCEL   Left the book without trading (cancel, price move, STP)
+ *   MODIFY   Shows `remaining` in place, priority kept (size-down, STP
+ *            decrement)
+ */
+struct OrderEvent {
+    enum Kind : uint8_t {
+        ADD     = 1,
+        EXECUTE = 2,
+        CANCEL  = 3,
+        MODIFY  = 4,
+    };
+
+    OrderID  order_id{0};
+    Price    price{0};
+    Quantity remaining{0};  // Displayed after the event
+    Quantity quantity{0};   // EXECUTE: traded; otherwise 0
+    Kind     kind{ADD};
+    Side     side{Side::BUY};
+};
+
+static_assert(std::is_trivially_copyable_v<OrderEvent>,
+    "OrderEvent MUST be trivially copyable for MarketDataEvent union");
+
 } // namespace rtes
\ No newline at end of file
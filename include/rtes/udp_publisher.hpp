@@ -2,14 +2,22 @@
 
 #include "rtes/types.hpp"
 #include "rtes/mpmc_queue.hpp"
+#include "rtes/spsc_queue.hpp"
 #include "rtes/matching_engine.hpp"
+#include "rtes/idle_strategy.hpp"
+#include "rtes/thread_affinity.hpp"
+#include "rtes/af_xdp.hpp"
+#include "rtes/datagram_auth.hpp"
 
 #include <string>
 #include <thread>
 #include <atomic>
 #include <array>
+#include <vector>
 #include <cstdint>
 #include <cstring>
+#include <memory>
+#include <string_view>
 #include <netinet/in.h>
 #include <unistd.h>
 
@@ -21,6 +29,14 @@ namespace rtes {
 
 inline constexpr size_t MD_BATCH_SIZE = 64;
 inline constexpr size_t SENDMMSG_BATCH = 32;
+inline constexpr size_t DEPTH_UPDATE_SIDE_LEVELS = 10;  // Per side per DepthUpdateMessage
+inline constexpr size_t MD_MAX_DATAGRAM = 1400;  // UDP payload cap (fits a 1500-byte MTU with room for tunnels)
+inline constexpr size_t MD_MIN_DATAGRAM = 512;   // Room for the packet header and the largest message
+inline constexpr size_t RETRANSMIT_MAX_PACKETS = 64;  // Datagrams replayed per request
+inline constexpr size_t MD_DELAY_BUCKETS = 16;  // Match-to-publish histogram: ≤1 µs, ≤2 µs, ... ≤16 ms, above
+
+/** Upper bound of delay bucket `bucket` (< MD_DELAY_BUCKETS - 1; the last one is unbounded) */
+[[nodiscard]] constexpr uint64_t md_delay_bound_ns(size_t bucket) { return uint64_t{1000} << bucket; }
 
 // ═══════════════════════════════════════════════════════════════
 //  UDP Protocol Messages
@@ -28,10 +44,35 @@ inline constexpr size_t SENDMMSG_BATCH = 32;
 
 #pragma pack(push, 1)
 
+/**
+ * Every datagram starts with this header, followed by message_count
+ * messages back to back. Each message keeps its own UdpMessageHeader;
+ * its length field is the message size in bytes.
+ */
+struct UdpPacketHeader {
+    uint64_t sequence;       // Sequence of the first message in the packet
+    uint16_t message_count;
+    uint16_t length;         // Header and message bytes (an authentication tag follows, see flags)
+    uint32_t flags;          // UDP_PACKET_AUTHENTICATED: signed (datagram_auth.hpp)
+};
+
 enum UdpMessageType : uint32_t {
     BBO_UPDATE = 201,
     TRADE_UPDATE = 202,
-    DEPTH_UPDATE = 203
+    DEPTH_UPDATE = 203,
+    RETRANSMIT_REQUEST = 204,
+    RETRANSMIT_RESPONSE = 205,
+    DEPTH_SNAPSHOT = 206,
+    ORDER_UPDATE = 207,
+    SWEEP_SUMMARY = 208
+};
+
+enum RetransmitStatus : uint8_t {
+    RETRANSMIT_OK          = 1,  // The range from from_sequence, up to RETRANSMIT_MAX_PACKETS
+    RETRANSMIT_PARTIAL     = 2,  // Starts after from_sequence: the older part is gone
+    RETRANSMIT_UNAVAILABLE = 3,  // Nothing of the range is kept (or not yet sent)
+    RETRANSMIT_INVALID     = 4,  // Unknown channel or malformed request
+    RETRANSMIT_PAD_REQUEST = 5   // Kept, but the request is too small to earn a datagram: pad it
 };
 
 struct UdpMessageHeader {
@@ -41,7 +82,7 @@ struct UdpMessageHeader {
     uint64_t timestamp_ns;
     
     UdpMessageHeader() = default;
-    UdpMessageHeader(uint32_t t, uint32_t len, uint64_t seq, uint64_t ts)
+    constexpr UdpMessageHeader(uint32_t t, uint32_t len, uint64_t seq, uint64_t ts)
         : type(t), length(len), sequence(seq), timestamp_ns(ts) {}
 };
 
@@ -62,11 +103,118 @@ struct TradeUpdateMessage {
     char symbol[8];
     uint64_t quantity;
     uint64_t price;
-    uint8_t aggressor_side;
+    uint8_t aggressor_side;        // 1=Buy, 2=Sell, 0=auction uncross
+    uint64_t match_timestamp_ns;   // Engine time of the match (header: publish time)
     
     TradeUpdateMessage() { std::memset(this, 0, sizeof(*this)); }
 };
 
+/**
+ * One market-by-order event (OrderEvent), on the channel the symbol's
+ * order feed is routed to. No client identity; remaining is the
+ * displayed quantity after the event.
+ */
+struct OrderUpdateMessage {
+    UdpMessageHeader header;
+    char symbol[8];
+    uint64_t order_id;
+    uint64_t price;
+    uint64_t remaining;
+    uint64_t quantity;  // EXECUTE: traded
+    uint8_t kind;       // 1=Add, 2=Execute, 3=Cancel, 4=Modify
+    uint8_t side;       // 1=Buy, 2=Sell
+
+    OrderUpdateMessage() { std::memset(this, 0, sizeof(*this)); }
+};
+
+/**
+ * The fills of one incoming order (MarketDataEvent::SWEEP), right after
+ * its trade messages on the same channel.
+ */
+struct SweepSummaryMessage {
+    UdpMessageHeader header;
+    char symbol[8];
+    uint64_t first_trade_id;
+    uint64_t first_price;
+    uint64_t last_price;
+    uint64_t quantity;
+    uint32_t fills;
+    uint8_t aggressor_side;  // 1=Buy, 2=Sell
+
+    SweepSummaryMessage() { std::memset(this, 0, sizeof(*this)); }
+};
+
+/** New state of one price level; quantity 0 = level deleted */
+struct DepthUpdateLevel {
+    uint64_t price;
+    uint64_t quantity;
+    uint32_t order_count;
+};
+
+/**
+ * Incremental depth for one symbol: changed levels only, bids first
+ * (levels[0 .. num_bid_levels)), then asks. Same layout as
+ * DepthUpdateMessage in market_data.hpp.
+ */
+struct DepthUpdateMessage {
+    UdpMessageHeader header;
+    char symbol[8];
+    uint64_t update_sequence;  // Latest book update of the symbol included
+    uint8_t num_bid_levels;
+    uint8_t num_ask_levels;
+    DepthUpdateLevel levels[2 * DEPTH_UPDATE_SIDE_LEVELS];
+
+    DepthUpdateMessage() { std::memset(this, 0, sizeof(*this)); }
+};
+
+/**
+ * Full visible depth of one symbol, sent on the snapshot channel. Apply
+ * the DepthUpdateMessages of `channel` with a higher update_sequence on
+ * top of it. header.sequence counts snapshot messages.
+ */
+struct DepthSnapshotMessage {
+    UdpMessageHeader header;
+    char symbol[8];
+    uint64_t update_sequence;  // Book updates reflected
+    uint32_t book_index;       // Position in the snapshot cycle
+    uint32_t book_count;       // Books per cycle
+    uint8_t channel;           // Incremental channel carrying the symbol
+    uint8_t num_bid_levels;
+    uint8_t num_ask_levels;
+    uint8_t reserved;
+    DepthUpdateLevel levels[2 * MAX_DEPTH_LEVELS];
+
+    DepthSnapshotMessage() { std::memset(this, 0, sizeof(*this)); }
+};
+
+/** Gap fill request, sent in one datagram to the retransmission port */
+struct RetransmitRequest {
+    UdpMessageHeader header;   // RETRANSMIT_REQUEST; sequence is the requester's own
+    uint64_t from_sequence;    // First missing message of the channel
+    uint32_t count;            // Messages wanted
+    uint8_t  channel;
+    uint8_t  reserved[3];
+
+    RetransmitRequest() { std::memset(this, 0, sizeof(*this)); }
+};
+
+/**
+ * Answer to a RetransmitRequest, followed by packet_count datagrams
+ * exactly as first published (UdpPacketHeader and all). Packets are
+ * whole, so they may start before from_sequence.
+ */
+struct RetransmitResponse {
+    UdpMessageHeader header;   // RETRANSMIT_RESPONSE; sequence echoes the request's
+    uint64_t first_sequence;   // First message replayed (0 if none)
+    uint64_t last_sequence;    // Last message replayed (0 if none)
+    uint64_t oldest_sequence;  // Oldest message still kept for the channel (0 if none)
+    uint16_t packet_count;
+    uint8_t  channel;
+    uint8_t  status;           // RetransmitStatus
+
+    RetransmitResponse() { std::memset(this, 0, sizeof(*this)); }
+};
+
 #pragma pack(pop)
 
 // ═══════════════════════════════════════════════════════════════
@@ -74,8 +222,32 @@ struct TradeUpdateMessage {
 // ═══════════════════════════════════════════════════════════════
 
 struct SendBuffer {
-    uint8_t data[1400];
-    size_t length{0};
+    uint8_t  data[MD_MAX_DATAGRAM];
+    size_t   length{0};
+    uint16_t messages{0};  // Messages packed after the UdpPacketHeader
+    const sockaddr_in* dest{nullptr};  // Channel the packet belongs to
+    int      xdp_destination{-1};      // Its AfXdpSocket destination; -1 = kernel path
+};
+
+/** A published datagram, handed to the RetransmissionServer */
+struct RetransmitRecord {
+    uint16_t length;
+    uint8_t  channel;
+    uint8_t  data[MD_MAX_DATAGRAM];
+};
+
+static_assert(std::is_trivially_copyable_v<RetransmitRecord>,
+              "RetransmitRecord must be trivially copyable for lock-free queues");
+
+/**
+ * Match-to-publish delay of trade messages: engine match time to the
+ * publisher encoding the message, i.e. market data queueing.
+ */
+struct MarketDataDelay {
+    uint64_t samples{0};
+    uint64_t sum_ns{0};
+    uint64_t max_ns{0};
+    std::array<uint64_t, MD_DELAY_BUCKETS> buckets{};  // Bucket i: ≤ md_delay_bound_ns(i)
 };
 
 // ═══════════════════════════════════════════════════════════════
@@ -108,8 +280,18 @@ struct UdpSocketWrapper {
 
 class UdpPublisher {
 public:
+    /**
+     * @param multicast_group  Destination of channel 0; empty = serve
+     *                         only channels added with add_channel()
+     * @param input_queue  First input lane; nullptr = only those added
+     *                     with add_input()
+     * @param idle  Idle strategy the lanes' producers notify (owned by
+     *              the caller, e.g. Exchange::get_market_data_idle());
+     *              nullptr = a private SPIN_YIELD strategy
+     */
     UdpPublisher(const std::string& multicast_group, uint16_t port, 
-                 MPMCQueue<MarketDataEvent>* input_queue);
+                 MarketDataLane* input_queue,
+                 IdleStrategy* idle = nullptr);
     ~UdpPublisher();
 
     // Non-copyable
@@ -119,37 +301,160 @@ public:
     void start();
     void stop();
 
+    /**
+     * Publish events tagged `channel` (MarketDataEvent::channel) to
+     * group:port. Each channel has its own sequence space starting at 1,
+     * so subscribers of one channel see no gaps from the others.
+     * Call before start().
+     */
+    void add_channel(uint8_t channel, const std::string& group, uint16_t port);
+
+    /**
+     * Also consume `lane` (one engine's events for this publisher). Lanes
+     * are drained round-robin, a bulk pop each, starting one lane later
+     * on every pass so none waits behind the others. Call before start().
+     */
+    void add_input(MarketDataLane* lane);
+
+    /** Core / SCHED_FIFO for the publisher thread. Call before start(). */
+    void set_thread_placement(const ThreadPlacement& placement) { placement_ = placement; }
+
+    /** Placement that took effect on the publisher thread (monitoring). */
+    [[nodiscard]] ThreadPlacement applied_placement() const {
+        return applied_placement_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Largest datagram payload to pack messages into, clamped to
+     * [MD_MIN_DATAGRAM, MD_MAX_DATAGRAM] (default MD_MAX_DATAGRAM).
+     * Lower it for paths with a smaller MTU. Call before start().
+     */
+    void set_max_datagram_size(size_t bytes);
+
+    /**
+     * Send only the last BBO of each symbol in a drained batch; earlier
+     * ones are dropped. Trades are always sent. Call before start().
+     */
+    void set_bbo_conflation(bool enabled) { bbo_conflation_ = enabled; }
+
+    /**
+     * Copy every datagram into `queue` for gap fill
+     * (RetransmissionServer::publisher_queue). A full queue drops the
+     * copy and counts it; the live send never waits. Call before start().
+     */
+    void set_retransmission(SPSCQueue<RetransmitRecord>* queue) { retransmit_queue_ = queue; }
+
+    /**
+     * Transmit through an AF_XDP socket on options.interface/queue
+     * instead of the kernel UDP stack. Datagrams are built exactly as for
+     * sendmmsg; batch_send hands them to the TX ring behind a pre-built
+     * Ethernet/IPv4/UDP header per channel. If the socket cannot be set
+     * up, start() logs it and keeps the kernel path; channels that are not
+     * multicast always use it. Call before start().
+     */
+    void set_af_xdp(const AfXdpSocket::Options& options) { xdp_options_ = options; }
+
+    /**
+     * Sign every datagram with `key` (DatagramAuthenticator): one
+     * truncated HMAC-SHA256 tag per datagram, appended as it is closed, so
+     * retransmitted copies carry it too. Packing leaves MD_AUTH_TAG_BYTES
+     * of the datagram size for it. Call before start().
+     * @return false if signing is unavailable (no OpenSSL, empty key)
+     */
+    bool set_authentication(std::string_view key);
+
+    /** Whether the AF_XDP path is in use (valid after start()) */
+    [[nodiscard]] bool af_xdp_active() const { return xdp_active_.load(std::memory_order_relaxed); }
+
+    /** Idle periods, parks and wake-up latency (monitoring). */
+    [[nodiscard]] IdleStats idle_stats() const { return idle_->stats(); }
+
     // Statistics
     size_t messages_sent() const { 
         return stats_atomic_.messages_sent.load(std::memory_order_relaxed); 
     }
+    /** Datagrams sent; messages_sent() / packets_sent() is the packing ratio */
+    size_t packets_sent() const {
+        return stats_atomic_.packets_sent.load(std::memory_order_relaxed);
+    }
+    /** Events dropped because their channel is not served here (misconfiguration) */
+    size_t unrouted() const {
+        return stats_atomic_.unrouted.load(std::memory_order_relaxed);
+    }
+    /** BBO events superseded by a later one in the same batch (conflation) */
+    size_t bbo_conflated() const {
+        return stats_atomic_.bbo_conflated.load(std::memory_order_relaxed);
+    }
+    /** Match-to-publish delay of the trades sent (flushed with the other stats) */
+    MarketDataDelay publish_delay() const;
+    /** Datagrams dropped because the AF_XDP TX ring or frame pool was full */
+    size_t send_failures() const {
+        return stats_atomic_.send_failures.load(std::memory_order_relaxed);
+    }
+    /** Datagrams not kept for retransmission because its queue was full */
+    size_t retransmit_overflows() const {
+        return stats_atomic_.retransmit_overflows.load(std::memory_order_relaxed);
+    }
 
 private:
+    /** One multicast destination with its own sequence space */
+    struct Channel {
+        sockaddr_in addr{};
+        uint64_t    next_sequence{1};
+        uint8_t     id{0};
+        bool        enabled{false};
+        int         xdp_destination{-1};  // AfXdpSocket destination id (-1 = kernel path)
+    };
+
     // Configuration
-    std::string multicast_group_;
-    uint16_t port_;
-    MPMCQueue<MarketDataEvent>* input_queue_;
+    std::vector<MarketDataLane*> inputs_;
+    size_t next_input_{0};  // Lane the next drain starts at
+    std::vector<Channel> channels_;  // Indexed by MarketDataEvent::channel
     
     // Threading
     std::atomic<bool> running_{false};
     std::thread worker_thread_;
+    ThreadPlacement              placement_;
+    std::atomic<ThreadPlacement> applied_placement_{};
+    IdleStrategy                 own_idle_;
+    IdleStrategy*                idle_;  // own_idle_ unless the producers' one was passed in
     
     // Network
     UdpSocketWrapper socket_fd_;
-    struct sockaddr_in multicast_addr_{};
+    size_t max_datagram_{MD_MAX_DATAGRAM};
+    bool   bbo_conflation_{false};
+    SPSCQueue<RetransmitRecord>* retransmit_queue_{nullptr};
+    AfXdpSocket::Options         xdp_options_;  // Empty interface = kernel path only
+    std::unique_ptr<AfXdpSocket> xdp_;
+    std::atomic<bool>            xdp_active_{false};
+    std::unique_ptr<DatagramAuthenticator> auth_;  // Null = unsigned datagrams
+    size_t                       tag_bytes_{0};    // Datagram bytes reserved for the tag
 
     // Local stats (no atomics in hot path)
     struct LocalStats {
         size_t messages_sent{0};
+        size_t packets_sent{0};
         size_t bytes_sent{0};
         size_t send_failures{0};
         size_t batches_sent{0};
-        uint64_t next_sequence{1};
+        size_t unrouted{0};
+        size_t bbo_conflated{0};
+        size_t retransmit_overflows{0};
+        MarketDataDelay delay;
+        size_t flushed_at{0};  // messages_sent at the last flush
     } local_stats_;
 
     // Atomic stats (for cross-thread reads)
     struct AtomicStats {
         std::atomic<size_t> messages_sent{0};
+        std::atomic<size_t> packets_sent{0};
+        std::atomic<size_t> unrouted{0};
+        std::atomic<size_t> bbo_conflated{0};
+        std::atomic<size_t> retransmit_overflows{0};
+        std::atomic<uint64_t> delay_samples{0};
+        std::atomic<uint64_t> delay_sum_ns{0};
+        std::atomic<uint64_t> delay_max_ns{0};
+        std::array<std::atomic<uint64_t>, MD_DELAY_BUCKETS> delay_buckets{};
         std::atomic<size_t> bytes_sent{0};
         std::atomic<size_t> send_failures{0};
         std::atomic<size_t> batches_sent{0};
@@ -157,17 +462,28 @@ private:
 
     // Internal methods
     bool setup_socket();
+    void setup_af_xdp();
     void worker_loop();
     
     size_t drain_events(std::array<MarketDataEvent, MD_BATCH_SIZE>& events);
     size_t build_datagrams(const std::array<MarketDataEvent, MD_BATCH_SIZE>& events, 
                            size_t event_count, 
                            std::array<SendBuffer, SENDMMSG_BATCH>& buffers);
-    size_t build_bbo_datagram(const MarketDataEvent& event, uint8_t* out);
-    size_t build_trade_datagram(const MarketDataEvent& event, uint8_t* out);
+    size_t pack_channel(Channel& channel, const MarketDataEvent* const* events, size_t event_count,
+                        Timestamp ts, std::array<SendBuffer, SENDMMSG_BATCH>& buffers,
+                        size_t packet_count);
+    // Encode one message in place at `out`; ts is the batch's publish time
+    size_t build_bbo_message(const MarketDataEvent& event, uint64_t seq, Timestamp ts, uint8_t* out);
+    size_t build_trade_message(const MarketDataEvent& event, uint64_t seq, Timestamp ts, uint8_t* out);
+    size_t build_order_message(const MarketDataEvent& event, uint64_t seq, Timestamp ts, uint8_t* out);
+    size_t build_sweep_message(const MarketDataEvent& event, uint64_t seq, Timestamp ts, uint8_t* out);
+    size_t build_depth_message(const MarketDataEvent* const* levels, size_t count,
+                               bool* sent, uint64_t seq, Timestamp ts, uint8_t* out);
+    void retain(const Channel& channel, const SendBuffer& buf);
     void batch_send(const std::array<SendBuffer, SENDMMSG_BATCH>& buffers, size_t count);
+    size_t kernel_send(const std::array<const SendBuffer*, SENDMMSG_BATCH>& buffers, size_t count);
+    void xdp_send(const std::array<SendBuffer, SENDMMSG_BATCH>& buffers, size_t count);
     
-    void spin_wait();
     void maybe_flush_stats();
     void flush_stats();
 };
@@ -0,0 +1,121 @@
+#pragma once
+
+/**
+ * @file undo_log.hpp
+ * @brief Stack-only undo log for multi-step state changes on hot paths
+ *
+ *   UndoLog<4> undo;
+ *   undo.add(client.exposure, notional);            // old value saved
+ *   undo.on_rollback<erase_order>(index, order_id);  // compensating call
+ *   if (!route(order)) return;                       // destructor undoes both
+ *   undo.commit();
+ *
+ * Each record is a restore function, a target and one saved word, held
+ * in a fixed array on the stack: nothing is allocated, nothing is
+ * virtual, and the restore functions are chosen at compile time (one
+ * template instance per field type or compensating function). Rolling
+ * back runs the records newest first. A committed log costs the stores
+ * of its records and nothing else.
+ *
+ * Transaction / TransactionScope (transaction.hpp) remain for slow-path
+ * workflows that need named, fallible steps.
+ *
+ * Single-threaded, like the state it guards.
+ */
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace rtes {
+
+template <size_t N>
+class UndoLog {
+    static_assert(N > 0, "UndoLog needs room for at least one record");
+
+public:
+    UndoLog() = default;
+    ~UndoLog() {
+        if (size_) rollback();
+    }
+
+    UndoLog(const UndoLog&) = delete;
+    UndoLog& operator=(const UndoLog&) = delete;
+
+    /** Record `field`'s current value; rollback writes it back. */
+    template <typename T>
+    void save(T& field) {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(uint64_t),
+                      "UndoLog saves one word per record");
+        uint64_t saved = 0;
+        std::memcpy(&saved, &field, sizeof(T));
+        push(&restore<T>, &field, saved);
+    }
+
+    /** save(field), then field += delta */
+    template <typename T, typename U>
+    void add(T& field, U delta) {
+        save(field);
+        field += delta;
+    }
+
+    /** save(field), then field = value */
+    template <typename T, typename U>
+    void set(T& field, U value) {
+        save(field);
+        field = value;
+    }
+
+    /**
+     * Call Fn(target, arg) on rollback: compensation for a step that is
+     * not a plain field write (erasing an inserted key, releasing a slot).
+     * Fn is a function or captureless lambda taking (C&, uint64_t).
+     */
+    template <auto Fn, typename C>
+    void on_rollback(C& target, uint64_t arg) {
+        push(&compensate<Fn, C>, &target, arg);
+    }
+
+    /** Keep every change: the log is emptied without undoing anything. */
+    void commit() { size_ = 0; }
+
+    /** Undo every recorded change, newest first. */
+    void rollback() {
+        while (size_ > 0) {
+            const Record& record = records_[--size_];
+            record.undo(record.target, record.saved);
+        }
+    }
+
+    [[nodiscard]] size_t size() const { return size_; }
+    [[nodiscard]] static constexpr size_t capacity() { return N; }
+
+private:
+    struct Record {
+        void   (*undo)(void* target, uint64_t saved);
+        void*    target;
+        uint64_t saved;
+    };
+
+    template <typename T>
+    static void restore(void* target, uint64_t saved) {
+        std::memcpy(target, &saved, sizeof(T));
+    }
+
+    template <auto Fn, typename C>
+    static void compensate(void* target, uint64_t arg) {
+        Fn(*static_cast<C*>(target), arg);
+    }
+
+    void push(void (*undo)(void*, uint64_t), void* target, uint64_t saved) {
+        assert(size_ < N && "UndoLog capacity exceeded");
+        records_[size_++] = {undo, target, saved};
+    }
+
+    Record records_[N];
+    size_t size_{0};
+};
+
+} // namespace rtes
@@ -0,0 +1,152 @@
+#pragma once
+
+/**
+ * @file workload.hpp
+ * @brief Synthetic order flow shaped like real market microstructure
+ *
+ * A deterministic (seeded) request stream for the benchmarks. Each
+ * profile stresses a different part of the book:
+ *
+ *   UNIFORM       Uniform prices ±100 ticks around the mid, uniform
+ *                 sizes. Shallow queues, no cancels. The old
+ *                 bench_matching flow, kept as a baseline.
+ *   MARKET_MAKER  Quotes 1-5 ticks off a drifting mid. After each quote,
+ *                 cancel_ratio of the time a random resting quote is
+ *                 cancelled, otherwise a taker crosses the touch.
+ *                 Deep queues at the touch, cancels from the middle.
+ *   ZIPF          Mixed resting, cancel and marketable flow. Symbol
+ *                 popularity is Zipf(zipf_exponent): a few hot books,
+ *                 a long cold tail.
+ *   MOMENTUM      Cycles of: cancel the old ladder, quote a fresh one
+ *                 (sweep_levels + 5 levels per side), then one IOC that
+ *                 sweeps sweep_levels levels. The mid jumps by the
+ *                 sweep, trending 70% of the time.
+ *   AUCTION_OPEN  Per call period: SET_PHASE AUCTION, a flood of
+ *                 auction_orders crossing limit orders, SET_PHASE
+ *                 CONTINUOUS (the uncross), then cancels for every
+ *                 order of the flood. Some of those cancels miss,
+ *                 because the order already filled.
+ *
+ * Generation is open loop: the stream never sees the exchange's
+ * responses. Cancels name orders the generator believes are still
+ * resting. Where the profile cannot know (a taker may have filled
+ * the quote), the cancel is rejected, as a late real cancel would be.
+ *
+ * NEW_ORDER ids run 1, 2, 3... in stream order, matching the ids
+ * ClientBase assigns, so the stream can be sent over TCP unchanged.
+ * Prices are multiples of the tick (tick-ladder books accept them).
+ */
+
+#include "rtes/types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace rtes {
+
+enum class WorkloadProfile : uint8_t {
+    UNIFORM      = 0,
+    MARKET_MAKER = 1,
+    ZIPF         = 2,
+    MOMENTUM     = 3,
+    AUCTION_OPEN = 4,
+};
+
+inline constexpr std::array<WorkloadProfile, 5> ALL_WORKLOAD_PROFILES{
+    WorkloadProfile::UNIFORM, WorkloadProfile::MARKET_MAKER, WorkloadProfile::ZIPF,
+    WorkloadProfile::MOMENTUM, WorkloadProfile::AUCTION_OPEN};
+
+struct WorkloadOptions {
+    WorkloadProfile profile{WorkloadProfile::UNIFORM};
+    std::vector<std::string> symbols;  // Empty: symbol_count names "SYM0", "SYM1"...
+    size_t   symbol_count{8};
+    Price    mid{price_from_double(150.0)};  // Starting mid of every symbol
+    Price    tick{price_from_double(0.01)};
+    double   cancel_ratio{0.95};    // MARKET_MAKER: cancels per quote
+    double   zipf_exponent{-1.0};   // Symbol skew; < 0: 1.1 for ZIPF, 0 (uniform) otherwise
+    size_t   sweep_levels{20};      // MOMENTUM: levels one burst takes out
+    size_t   auction_orders{5000};  // AUCTION_OPEN: orders per call period
+    uint64_t seed{42};
+};
+
+struct WorkloadRequest {
+    enum Type : uint8_t {
+        NEW_ORDER = 0,
+        CANCEL    = 1,
+        SET_PHASE = 2,
+    };
+
+    Type         type{NEW_ORDER};
+    uint32_t     symbol{0};   // Index into WorkloadGenerator::symbols()
+    OrderID      id{0};       // NEW_ORDER: the new id; CANCEL: the order cancelled
+    Side         side{Side::BUY};
+    OrderType    order_type{OrderType::LIMIT};
+    Price        price{0};
+    Quantity     quantity{0};
+    TradingPhase phase{TradingPhase::CONTINUOUS};  // SET_PHASE
+};
+
+class WorkloadGenerator {
+public:
+    /** @throws std::invalid_argument on no symbols, a zero tick or a mid too close to 0 */
+    explicit WorkloadGenerator(const WorkloadOptions& options);
+
+    /** Next request in the stream */
+    [[nodiscard]] WorkloadRequest next();
+
+    [[nodiscard]] const std::vector<std::string>& symbols() const { return symbols_; }
+    [[nodiscard]] const WorkloadOptions& options() const { return options_; }
+
+    /** "uniform", "market_maker", "zipf", "momentum", "auction_open" */
+    [[nodiscard]] static const char* profile_name(WorkloadProfile profile);
+    [[nodiscard]] static std::optional<WorkloadProfile> parse_profile(std::string_view name);
+
+private:
+    struct Resting {
+        OrderID id;
+        Side    side;
+        Price   price;
+    };
+
+    struct Book {
+        Price                mid{0};
+        int                  trend{1};  // MOMENTUM: +1 up, -1 down
+        std::vector<Resting> resting;   // What the generator believes rests
+    };
+
+    void refill();
+    void refill_uniform();
+    void refill_market_maker();
+    void refill_zipf();
+    void refill_momentum();
+    void refill_auction_open();
+
+    uint32_t pick_symbol();
+    uint64_t uniform(uint64_t lo, uint64_t hi);  // [lo, hi]
+    bool     chance(double p);
+    void     drift(Book& book);
+    Price    offset(Price mid, Side side, int64_t ticks) const;  // Ticks away from mid on the passive side
+
+    OrderID new_order(uint32_t symbol, Side side, OrderType type, Price price, Quantity quantity,
+                      bool track);
+    void    cancel(uint32_t symbol, size_t resting_index);
+    void    cancel_random(uint32_t symbol);
+    void    set_phase(uint32_t symbol, TradingPhase phase);
+
+    WorkloadOptions          options_;
+    std::vector<std::string> symbols_;
+    std::vector<Book>        books_;
+    std::vector<double>      zipf_cdf_;  // Empty: uniform symbol choice
+    std::vector<WorkloadRequest> pending_;
+    size_t                   pending_head_{0};
+    std::mt19937_64          rng_;
+    OrderID                  next_id_{1};
+};
+
+} // namespace rtes
@@ -0,0 +1,281 @@
+#include "rtes/af_xdp.hpp"
+
+#include <arpa/inet.h>
+#include <bit>
+#include <cstring>
+
+namespace rtes {
+
+namespace {
+
+constexpr size_t ETH_BYTES = 14;
+constexpr size_t IP_BYTES  = 20;
+
+uint16_t ipv4_checksum(const uint8_t* header) {
+    uint32_t sum = 0;
+    for (size_t i = 0; i < IP_BYTES; i += 2) sum += uint32_t{header[i]} << 8 | header[i + 1];
+    while (sum >> 16) sum = (sum & 0xffff) + (sum >> 16);
+    return static_cast<uint16_t>(~sum);
+}
+
+void put_be16(uint8_t* out, uint16_t value) {
+    out[0] = static_cast<uint8_t>(value >> 8);
+    out[1] = static_cast<uint8_t>(value);
+}
+
+} // namespace
+
+std::array<uint8_t, XDP_FRAME_HEADER_BYTES>
+AfXdpSocket::build_frame_header(const uint8_t (&src_mac)[6], const sockaddr_in& source,
+                                const sockaddr_in& dest, uint8_t ttl) {
+    std::array<uint8_t, XDP_FRAME_HEADER_BYTES> frame{};
+    uint8_t* eth = frame.data();
+    uint8_t* ip  = eth + ETH_BYTES;
+    uint8_t* udp = ip + IP_BYTES;
+
+    // Ethernet: IPv4 multicast MAC is 01:00:5e + the group's low 23 bits
+    const uint32_t group = ntohl(dest.sin_addr.s_addr);
+    const uint8_t dst_mac[6] = {0x01, 0x00, 0x5e, static_cast<uint8_t>((group >> 16) & 0x7f),
+                                static_cast<uint8_t>(group >> 8), static_cast<uint8_t>(group)};
+    std::memcpy(eth, dst_mac, 6);
+    std::memcpy(eth + 6, src_mac, 6);
+    put_be16(eth + 12, 0x0800);
+
+    // IPv4: no options, DF, lengths and checksum patched per frame
+    ip[0] = 0x45;
+    put_be16(ip + 6, 0x4000);
+    ip[8] = ttl;
+    ip[9] = IPPROTO_UDP;
+    std::memcpy(ip + 12, &source.sin_addr.s_addr, 4);
+    std::memcpy(ip + 16, &dest.sin_addr.s_addr, 4);
+
+    // UDP: checksum 0 (none, allowed over IPv4)
+    std::memcpy(udp, source.sin_port ? &source.sin_port : &dest.sin_port, 2);
+    std::memcpy(udp + 2, &dest.sin_port, 2);
+    return frame;
+}
+
+void AfXdpSocket::finish_frame_header(uint8_t* frame, size_t payload) {
+    uint8_t* ip  = frame + ETH_BYTES;
+    uint8_t* udp = ip + IP_BYTES;
+    put_be16(ip + 2, static_cast<uint16_t>(IP_BYTES + 8 + payload));
+    put_be16(ip + 10, 0);
+    put_be16(ip + 10, ipv4_checksum(ip));
+    put_be16(udp + 4, static_cast<uint16_t>(8 + payload));
+}
+
+} // namespace rtes
+
+#ifdef __linux__
+
+#include <linux/if_xdp.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+namespace rtes {
+
+namespace {
+
+constexpr uint32_t FILL_RING_ENTRIES = 64;  // Required by bind; TX-only never stocks it
+
+template <typename T>
+T* ring_ptr(void* base, uint64_t offset) {
+    return reinterpret_cast<T*>(static_cast<uint8_t*>(base) + offset);
+}
+
+/** MAC and first IPv4 address of `interface` */
+bool interface_addresses(const std::string& interface, uint8_t (&mac)[6], sockaddr_in& address) {
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) return false;
+    ifreq request{};
+    std::strncpy(request.ifr_name, interface.c_str(), IFNAMSIZ - 1);
+    bool ok = ioctl(fd, SIOCGIFHWADDR, &request) == 0;
+    if (ok) std::memcpy(mac, request.ifr_hwaddr.sa_data, 6);
+    ok = ok && ioctl(fd, SIOCGIFADDR, &request) == 0;
+    if (ok) std::memcpy(&address, &request.ifr_addr, sizeof(address));
+    const int saved = errno;
+    ::close(fd);
+    errno = saved;
+    return ok;
+}
+
+} // namespace
+
+AfXdpSocket::~AfXdpSocket() {
+    release();
+}
+
+bool AfXdpSocket::init(const Options& options) {
+    const unsigned ifindex = if_nametoindex(options.interface.c_str());
+    if (ifindex == 0 || !interface_addresses(options.interface, src_mac_, source_)) return false;
+    source_.sin_port = 0;
+    ttl_ = options.ttl;
+
+    fd_ = socket(AF_XDP, SOCK_RAW, 0);
+    if (fd_ < 0) return false;
+
+    auto fail = [this] {
+        const int saved = errno ? errno : ENOSYS;
+        release();
+        errno = saved;
+        return false;
+    };
+
+    frame_count_ = std::bit_ceil(options.frames < 2 ? 2u : options.frames);
+    umem_size_ = size_t{frame_count_} * XDP_FRAME_SIZE;
+    void* umem = mmap(nullptr, umem_size_, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (umem == MAP_FAILED) return fail();
+    umem_ = static_cast<uint8_t*>(umem);
+
+    xdp_umem_reg reg{};
+    reg.addr       = reinterpret_cast<uint64_t>(umem_);
+    reg.len        = umem_size_;
+    reg.chunk_size = XDP_FRAME_SIZE;
+    if (setsockopt(fd_, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) != 0) return fail();
+
+    const uint32_t fill_entries = FILL_RING_ENTRIES;
+    const uint32_t entries = frame_count_;
+    if (setsockopt(fd_, SOL_XDP, XDP_UMEM_FILL_RING, &fill_entries, sizeof(fill_entries)) != 0 ||
+        setsockopt(fd_, SOL_XDP, XDP_UMEM_COMPLETION_RING, &entries, sizeof(entries)) != 0 ||
+        setsockopt(fd_, SOL_XDP, XDP_TX_RING, &entries, sizeof(entries)) != 0) {
+        return fail();
+    }
+
+    xdp_mmap_offsets offsets{};
+    socklen_t offsets_size = sizeof(offsets);
+    if (getsockopt(fd_, SOL_XDP, XDP_MMAP_OFFSETS, &offsets, &offsets_size) != 0) return fail();
+
+    tx_map_size_ = offsets.tx.desc + size_t{entries} * sizeof(xdp_desc);
+    void* tx = mmap(nullptr, tx_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    fd_, XDP_PGOFF_TX_RING);
+    if (tx == MAP_FAILED) return fail();
+    tx_map_      = tx;
+    tx_producer_ = ring_ptr<uint32_t>(tx, offsets.tx.producer);
+    tx_consumer_ = ring_ptr<uint32_t>(tx, offsets.tx.consumer);
+    tx_flags_    = ring_ptr<uint32_t>(tx, offsets.tx.flags);
+    tx_descs_    = ring_ptr<xdp_desc>(tx, offsets.tx.desc);
+    tx_mask_     = entries - 1;
+
+    cq_map_size_ = offsets.cr.desc + size_t{entries} * sizeof(uint64_t);
+    void* cq = mmap(nullptr, cq_map_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    fd_, XDP_UMEM_PGOFF_COMPLETION_RING);
+    if (cq == MAP_FAILED) return fail();
+    cq_map_      = cq;
+    cq_producer_ = ring_ptr<uint32_t>(cq, offsets.cr.producer);
+    cq_consumer_ = ring_ptr<uint32_t>(cq, offsets.cr.consumer);
+    cq_addrs_    = ring_ptr<uint64_t>(cq, offsets.cr.desc);
+    cq_mask_     = entries - 1;
+
+    sockaddr_xdp addr{};
+    addr.sxdp_family   = AF_XDP;
+    addr.sxdp_ifindex  = ifindex;
+    addr.sxdp_queue_id = options.queue;
+    addr.sxdp_flags    = XDP_USE_NEED_WAKEUP | (options.zero_copy ? XDP_ZEROCOPY : XDP_COPY);
+    if (bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) return fail();
+
+    free_frames_.clear();
+    free_frames_.reserve(frame_count_);
+    for (uint32_t i = frame_count_; i-- > 0;) free_frames_.push_back(uint64_t{i} * XDP_FRAME_SIZE);
+    tx_local_producer_  = *tx_producer_;
+    tx_cached_consumer_ = *tx_consumer_;
+    return true;
+}
+
+int AfXdpSocket::add_destination(const sockaddr_in& dest) {
+    if (!IN_MULTICAST(ntohl(dest.sin_addr.s_addr))) {
+        errno = EINVAL;
+        return -1;
+    }
+    headers_.push_back(build_frame_header(src_mac_, source_, dest, ttl_));
+    return static_cast<int>(headers_.size() - 1);
+}
+
+bool AfXdpSocket::enqueue(int destination, const uint8_t* payload, size_t length) {
+    if (XDP_FRAME_HEADER_BYTES + length > XDP_FRAME_SIZE) [[unlikely]] return false;
+    if (free_frames_.empty()) reclaim();
+    if (tx_local_producer_ - tx_cached_consumer_ > tx_mask_) {
+        tx_cached_consumer_ = std::atomic_ref<uint32_t>(*tx_consumer_).load(std::memory_order_acquire);
+    }
+    if (free_frames_.empty() || tx_local_producer_ - tx_cached_consumer_ > tx_mask_) return false;
+
+    const uint64_t offset = free_frames_.back();
+    free_frames_.pop_back();
+    uint8_t* frame = umem_ + offset;
+    std::memcpy(frame, headers_[static_cast<size_t>(destination)].data(), XDP_FRAME_HEADER_BYTES);
+    std::memcpy(frame + XDP_FRAME_HEADER_BYTES, payload, length);
+    finish_frame_header(frame, length);
+
+    xdp_desc& desc = static_cast<xdp_desc*>(tx_descs_)[tx_local_producer_++ & tx_mask_];
+    desc.addr    = offset;
+    desc.len     = static_cast<uint32_t>(XDP_FRAME_HEADER_BYTES + length);
+    desc.options = 0;
+    return true;
+}
+
+void AfXdpSocket::submit() {
+    if (std::atomic_ref<uint32_t>(*tx_producer_).load(std::memory_order_relaxed) != tx_local_producer_) {
+        std::atomic_ref<uint32_t>(*tx_producer_).store(tx_local_producer_, std::memory_order_release);
+    }
+    // Copy mode always asks; zero-copy drivers only when their NAPI loop sleeps
+    if (std::atomic_ref<uint32_t>(*tx_flags_).load(std::memory_order_relaxed) & XDP_RING_NEED_WAKEUP) {
+        sendto(fd_, nullptr, 0, MSG_DONTWAIT, nullptr, 0);  // EAGAIN/EBUSY: retried on the next kick
+    }
+    reclaim();
+}
+
+void AfXdpSocket::reclaim() {
+    uint32_t head = *cq_consumer_;
+    const uint32_t tail = std::atomic_ref<uint32_t>(*cq_producer_).load(std::memory_order_acquire);
+    if (head == tail) return;
+    for (; head != tail; ++head) free_frames_.push_back(cq_addrs_[head & cq_mask_]);
+    std::atomic_ref<uint32_t>(*cq_consumer_).store(head, std::memory_order_release);
+}
+
+void AfXdpSocket::release() {
+    if (cq_map_) munmap(cq_map_, cq_map_size_);
+    if (tx_map_) munmap(tx_map_, tx_map_size_);
+    if (fd_ >= 0) ::close(fd_);  // Before the UMEM: the kernel unpins it on close
+    if (umem_) munmap(umem_, umem_size_);
+    cq_map_ = tx_map_ = nullptr;
+    umem_   = nullptr;
+    fd_     = -1;
+    free_frames_.clear();
+    headers_.clear();
+}
+
+} // namespace rtes
+
+#else  // !__linux__
+
+namespace rtes {
+
+AfXdpSocket::~AfXdpSocket() = default;
+
+bool AfXdpSocket::init(const Options&) {
+    errno = ENOSYS;
+    return false;
+}
+
+int AfXdpSocket::add_destination(const sockaddr_in&) {
+    errno = ENOSYS;
+    return -1;
+}
+
+bool AfXdpSocket::enqueue(int, const uint8_t*, size_t) { return false; }
+void AfXdpSocket::submit() {}
+
+} // namespace rtes
+
+#endif
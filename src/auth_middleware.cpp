@@ -1,5 +1,6 @@
 #include "rtes/auth_middleware.hpp"
 #include "rtes/logger.hpp"
+#include <algorithm>
 #include <chrono>
 
 namespace rtes {
@@ -93,4 +94,102 @@ AuthGuard::AuthGuard(const std::string& token, const std::string& operation)
     }
 }
 
+SessionAuthCache::SessionAuthCache(size_t max_sessions)
+    : slots_(std::make_unique<Slot[]>(std::min<size_t>(max_sessions, 0xFFFF))),
+      capacity_(std::min<size_t>(max_sessions, 0xFFFF)) {
+    free_.reserve(capacity_);
+    for (size_t i = capacity_; i-- > 0;) free_.push_back(static_cast<uint16_t>(i));
+}
+
+uint32_t SessionAuthCache::permissions_for(const AuthContext& ctx) {
+    uint32_t mask = 0;
+    if (SecurityUtils::is_authorized_for_operation(ctx, "place_order")) mask |= SESSION_PLACE_ORDER;
+    if (SecurityUtils::is_authorized_for_operation(ctx, "cancel_order")) mask |= SESSION_CANCEL_ORDER;
+    return mask;
+}
+
+bool SessionAuthCache::authenticate(std::string_view token, SessionGrant& grant, std::string_view client_id) {
+    release(grant);  // Logon again on the same session: the old grant ends, whatever the outcome
+    const AuthContext ctx = AuthMiddleware::validate_session(std::string(token));
+    if (!ctx.authenticated) return false;
+    if (!client_id.empty() && ctx.user_id != client_id) {
+        LOG_WARN_SAFE("Logon of {} as client {} refused: a session trades as its own user",
+                      ctx.user_id, std::string(client_id));
+        return false;
+    }
+    const uint32_t mask = permissions_for(ctx);
+
+    std::lock_guard lock(mutex_);
+    if (free_.empty()) {
+        LOG_WARN_SAFE("Session auth cache full: logon of {} refused", ctx.user_id);
+        return false;
+    }
+    const uint16_t index = free_.back();
+    free_.pop_back();
+    Slot& slot = slots_[index];
+    uint16_t generation = static_cast<uint16_t>(slot.generation.load(std::memory_order_relaxed) + 1);
+    if (generation == 0) generation = 1;  // id 0 is reserved
+    slot.user_id = ctx.user_id;
+    slot.live    = true;
+    slot.mask.store(mask, std::memory_order_relaxed);
+    slot.generation.store(generation, std::memory_order_release);
+
+    grant.id    = (static_cast<uint32_t>(generation) << 16) | index;
+    grant.mask  = mask;
+    grant.epoch = epoch_.load(std::memory_order_acquire);
+    return true;
+}
+
+void SessionAuthCache::release(SessionGrant& grant) {
+    if (grant.id == 0) return;
+    std::lock_guard lock(mutex_);
+    if (Slot* slot = slot_of(grant.id); slot && slot->live) {
+        slot->live = false;
+        slot->user_id.clear();
+        slot->mask.store(0, std::memory_order_relaxed);
+        free_.push_back(static_cast<uint16_t>(grant.id & 0xFFFF));
+    }
+    grant = SessionGrant{};
+}
+
+size_t SessionAuthCache::revoke_user(std::string_view user_id) {
+    size_t revoked = 0;
+    std::lock_guard lock(mutex_);
+    for (size_t i = 0; i < capacity_; ++i) {
+        Slot& slot = slots_[i];
+        if (!slot.live || slot.user_id != user_id || slot.mask.load(std::memory_order_relaxed) == 0) continue;
+        slot.mask.store(0, std::memory_order_relaxed);
+        ++revoked;
+    }
+    // Published by the epoch: a session that sees the new epoch sees the cleared mask
+    if (revoked) epoch_.fetch_add(1, std::memory_order_release);
+    return revoked;
+}
+
+void SessionAuthCache::revoke_all() {
+    std::lock_guard lock(mutex_);
+    for (size_t i = 0; i < capacity_; ++i) slots_[i].mask.store(0, std::memory_order_relaxed);
+    epoch_.fetch_add(1, std::memory_order_release);
+}
+
+size_t SessionAuthCache::active() const {
+    std::lock_guard lock(mutex_);
+    return capacity_ - free_.size();
+}
+
+SessionAuthCache::Slot* SessionAuthCache::slot_of(uint32_t id) const {
+    const size_t index = id & 0xFFFF;
+    return index < capacity_ ? &slots_[index] : nullptr;
+}
+
+void SessionAuthCache::refresh(SessionGrant& grant) const {
+    const uint64_t epoch = epoch_.load(std::memory_order_acquire);
+    const Slot* slot = grant.id ? slot_of(grant.id) : nullptr;
+    // A reused slot belongs to another session now: this one has nothing left
+    grant.mask = slot && slot->generation.load(std::memory_order_relaxed) == (grant.id >> 16)
+                     ? slot->mask.load(std::memory_order_relaxed)
+                     : 0;
+    grant.epoch = epoch;
+}
+
 } // namespace rtes
\ No newline at end of file
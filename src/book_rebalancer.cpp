@@ -0,0 +1,112 @@
+#include "rtes/book_rebalancer.hpp"
+#include "rtes/logger.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+
+namespace rtes {
+
+BookMigrationResult migrate_book(const Symbol& symbol, MatchingEngine& from, MatchingEngine& to,
+                                 IngressLane lane, const std::function<bool()>& reroute) {
+    BookMigrationResult result;
+    const BookIndex source = from.book_index(symbol);
+    const BookIndex target = to.book_index(symbol);
+    if (&from == &to || source == NO_BOOK || target == NO_BOOK || !from.release_idle() ||
+        !from.hosts_book(source) || to.hosts_book(target)) {
+        LOG_WARN("Cannot move {} from {} to {}", symbol.c_str(), from.name(), to.name());
+        return result;
+    }
+
+    to.expect_book(target);
+    const Timestamp start = now_timestamp();
+    if (!reroute()) {
+        to.expect_book(NO_BOOK);
+        return result;
+    }
+
+    // From here the symbol's requests queue at the target until it adopts the
+    // book, and there is no way back: only an engine stopping, when trading is
+    // over, ends the move early. Everything that could refuse it was checked
+    // above, so release_book() fails only on a full lane.
+    while (!from.release_book(source, lane)) {
+        if (!from.is_running()) return result;
+        std::this_thread::yield();
+    }
+    while (!from.book_released()) {
+        assert(!from.release_idle() && "Source released a book it did not host");
+        if (!from.is_running() || !to.is_running()) {
+            LOG_ERROR("Moving {} to {}: stopped before {} released it", symbol.c_str(), to.name(), from.name());
+            return result;
+        }
+        std::this_thread::yield();
+    }
+    while (!to.adopt_book(from, target, lane)) {
+        if (!to.is_running()) return result;
+        std::this_thread::yield();
+    }
+    while (!from.release_idle()) {  // Cleared by the adopting worker
+        if (!to.is_running()) return result;
+        std::this_thread::yield();
+    }
+
+    result.moved    = true;
+    result.pause_ns = now_timestamp() - start;
+    LOG_INFO("Moved {} from {} to {} ({} us pause)", symbol.c_str(), from.name(), to.name(),
+             result.pause_ns / 1000);
+    return result;
+}
+
+BookRebalancer::BookRebalancer(std::vector<MatchingEngine*> engines, Options options)
+    : engines_(std::move(engines))
+    , options_(options)
+    , last_(engines_.size())
+{}
+
+std::optional<BookMove> BookRebalancer::sample() {
+    const size_t count = engines_.size();
+    std::vector<std::vector<uint64_t>> delta(count);
+    std::vector<uint64_t> load(count, 0);
+    for (size_t i = 0; i < count; ++i) {
+        std::vector<uint64_t> now = engines_[i]->book_requests();
+        delta[i].resize(now.size());
+        for (size_t b = 0; b < now.size(); ++b) {
+            delta[i][b] = now[b] - (b < last_[i].size() ? last_[i][b] : 0);
+            load[i] += delta[i][b];
+        }
+        last_[i] = std::move(now);
+    }
+    if (count < 2) return std::nullopt;
+
+    const size_t hot  = std::max_element(load.begin(), load.end()) - load.begin();
+    const size_t cold = std::min_element(load.begin(), load.end()) - load.begin();
+    const uint64_t busiest  = load[hot];
+    const uint64_t quietest = load[cold];
+    if (busiest == quietest || busiest < options_.min_requests ||
+        static_cast<double>(busiest) < options_.imbalance * static_cast<double>(quietest)) {
+        return std::nullopt;
+    }
+    // A lone hot book stays put: moving it would just move the problem
+    if (std::count_if(delta[hot].begin(), delta[hot].end(), [](uint64_t d) { return d != 0; }) < 2) {
+        return std::nullopt;
+    }
+
+    // The book leaving the two closest; one carrying more than the gap would swap their roles
+    const uint64_t gap = busiest - quietest;
+    BookIndex best = NO_BOOK;
+    uint64_t best_gap = gap;
+    for (size_t b = 0; b < delta[hot].size(); ++b) {
+        const uint64_t d = delta[hot][b];
+        if (d == 0 || d >= gap) continue;
+        const uint64_t after = (gap > 2 * d) ? gap - 2 * d : 2 * d - gap;
+        if (after >= best_gap) continue;
+        if (engines_[cold]->book_index(engines_[hot]->book_symbol(b)) == NO_BOOK) continue;
+        best = static_cast<BookIndex>(b);
+        best_gap = after;
+    }
+    if (best == NO_BOOK) return std::nullopt;
+
+    return BookMove{engines_[hot]->book_symbol(best), engines_[hot], engines_[cold], delta[hot][best]};
+}
+
+} // namespace rtes
@@ -0,0 +1,259 @@
+/**
+ * @file book_snapshot.cpp
+ * @brief Snapshot writer thread, snapshot files, warm restart
+ */
+
+#include "rtes/book_snapshot.hpp"
+#include "rtes/logger.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace rtes {
+
+namespace {
+
+constexpr auto SNAPSHOT_WRITER_POLL = std::chrono::milliseconds(10);
+constexpr char SNAPSHOT_SUFFIX[]    = ".book";
+
+std::string snapshot_prefix(const std::string& engine) {
+    return "snapshot-" + engine + "-";
+}
+
+/** Unix nanoseconds of a snapshot file name of `engine`, or -1 if it is not one */
+long long snapshot_time(const std::string& file_name, const std::string& engine) {
+    const std::string prefix = snapshot_prefix(engine);
+    const size_t suffix = sizeof(SNAPSHOT_SUFFIX) - 1;
+    if (file_name.size() <= prefix.size() + suffix || file_name.compare(0, prefix.size(), prefix) != 0 ||
+        file_name.compare(file_name.size() - suffix, suffix, SNAPSHOT_SUFFIX) != 0) {
+        return -1;
+    }
+    const std::string digits = file_name.substr(prefix.size(), file_name.size() - prefix.size() - suffix);
+    if (!std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) return -1;
+    return std::stoll(digits);
+}
+
+/** Snapshots of `engine` in `directory`, oldest first */
+std::vector<std::filesystem::path> list_snapshots(const std::string& directory, const std::string& engine) {
+    std::vector<std::pair<long long, std::filesystem::path>> found;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        const long long time = snapshot_time(entry.path().filename().string(), engine);
+        if (time >= 0) found.emplace_back(time, entry.path());
+    }
+    std::sort(found.begin(), found.end());
+    std::vector<std::filesystem::path> paths;
+    for (auto& [time, path] : found) paths.push_back(std::move(path));
+    return paths;
+}
+
+bool write_all(int fd, const void* data, size_t size) {
+    const auto* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        const ssize_t n = ::write(fd, bytes, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        bytes += n;
+        size  -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+BookSnapshotWriter::BookSnapshotWriter(std::string directory, std::string journal_path, uint64_t journal_run_id)
+    : directory_(std::move(directory)), journal_path_(std::move(journal_path)), journal_run_id_(journal_run_id) {}
+
+BookSnapshotWriter::~BookSnapshotWriter() {
+    stop();
+}
+
+BookSnapshotSlot* BookSnapshotWriter::add_engine(const std::string& name) {
+    engine_names_.push_back(name);
+    slots_.push_back(std::make_unique<BookSnapshotSlot>());
+    return slots_.back().get();
+}
+
+void BookSnapshotWriter::start() {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return;
+    std::error_code error;
+    std::filesystem::create_directories(directory_, error);
+    thread_ = std::thread(&BookSnapshotWriter::run, this);
+    LOG_INFO("Book snapshots → {} ({} engine(s))", directory_, slots_.size());
+}
+
+void BookSnapshotWriter::stop() {
+    bool expected = true;
+    if (!running_.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) return;
+    if (thread_.joinable()) thread_.join();
+    write_pending();  // The engines' final snapshots
+}
+
+uint64_t BookSnapshotWriter::snapshots_skipped() const {
+    uint64_t total = 0;
+    for (const auto& slot : slots_) total += slot->skipped.load(std::memory_order_relaxed);
+    return total;
+}
+
+void BookSnapshotWriter::run() {
+    while (running_.load(std::memory_order_relaxed)) {
+        if (!write_pending()) std::this_thread::sleep_for(SNAPSHOT_WRITER_POLL);
+    }
+}
+
+bool BookSnapshotWriter::write_pending() {
+    bool wrote = false;
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        BookSnapshotSlot& slot = *slots_[i];
+        if (!slot.busy.load(std::memory_order_acquire)) continue;
+        write(engine_names_[i], slot);
+        slot.busy.store(false, std::memory_order_release);  // The engine may fill it again
+        wrote = true;
+    }
+    return wrote;
+}
+
+void BookSnapshotWriter::write(const std::string& engine, BookSnapshotSlot& slot) {
+    EngineSnapshot& image = slot.image;
+    std::strncpy(image.header.journal_path, journal_path_.c_str(), sizeof(image.header.journal_path) - 1);
+    image.header.journal_run_id = journal_run_id_;
+
+    char stamp[32];
+    std::snprintf(stamp, sizeof(stamp), "%019lld", static_cast<long long>(image.header.unix_ns));
+    const std::string path = directory_ + "/" + snapshot_prefix(engine) + stamp + SNAPSHOT_SUFFIX;
+    const std::string temporary = path + ".tmp";
+
+    const int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        write_errors_.fetch_add(1, std::memory_order_relaxed);
+        LOG_ERROR("Cannot create book snapshot {}: {}", temporary, std::strerror(errno));
+        return;
+    }
+    uint64_t bytes = sizeof(image.header);
+    bool ok = write_all(fd, &image.header, sizeof(image.header));
+    for (size_t b = 0; ok && b < image.header.book_count; ++b) {
+        const BookImage& book = image.books[b];
+        ok = write_all(fd, &book.header, sizeof(book.header)) &&
+             write_all(fd, book.orders.data(), book.orders.size() * sizeof(Order));
+        bytes += sizeof(book.header) + book.orders.size() * sizeof(Order);
+    }
+    ok = ok && ::fdatasync(fd) == 0;
+    ::close(fd);
+
+    // Renamed only once complete and durable: a snapshot that exists can be trusted
+    if (!ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        write_errors_.fetch_add(1, std::memory_order_relaxed);
+        LOG_ERROR("Book snapshot {} failed: {}", path, std::strerror(errno));
+        ::unlink(temporary.c_str());
+        return;
+    }
+    if (const int dir = ::open(directory_.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC); dir >= 0) {
+        ::fsync(dir);
+        ::close(dir);
+    }
+    written_.fetch_add(1, std::memory_order_relaxed);
+    bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    prune(engine);
+}
+
+void BookSnapshotWriter::prune(const std::string& engine) {
+    const auto snapshots = list_snapshots(directory_, engine);
+    if (snapshots.size() <= BOOK_SNAPSHOTS_KEPT) return;
+    std::error_code error;
+    for (size_t i = 0; i + BOOK_SNAPSHOTS_KEPT < snapshots.size(); ++i) {
+        std::filesystem::remove(snapshots[i], error);
+    }
+}
+
+std::string latest_book_snapshot(const std::string& directory, const std::string& engine) {
+    const auto snapshots = list_snapshots(directory, engine);
+    return snapshots.empty() ? std::string() : snapshots.back().string();
+}
+
+bool load_book_snapshot(const std::string& path, EngineSnapshot& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in || !in.read(reinterpret_cast<char*>(&out.header), sizeof(out.header))) return false;
+    if (std::memcmp(out.header.magic, BOOK_SNAPSHOT_MAGIC, sizeof(BOOK_SNAPSHOT_MAGIC)) != 0 ||
+        out.header.version != BOOK_SNAPSHOT_VERSION || out.header.order_size != sizeof(Order)) {
+        return false;
+    }
+    out.header.journal_path[sizeof(out.header.journal_path) - 1] = '\0';
+
+    const auto file_size = std::filesystem::file_size(path);
+    out.books.resize(out.header.book_count);
+    for (BookImage& book : out.books) {
+        if (!in.read(reinterpret_cast<char*>(&book.header), sizeof(book.header))) return false;
+        const uint64_t count = book.header.order_count;
+        if (count > file_size / sizeof(Order)) return false;  // Corrupt count: do not allocate for it
+        book.orders.resize(count);
+        if (!in.read(reinterpret_cast<char*>(book.orders.data()),
+                     static_cast<std::streamsize>(count * sizeof(Order)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+RestoreResult restore_engine(MatchingEngine& engine, const std::string& directory) {
+    RestoreResult result;
+    const std::string path = latest_book_snapshot(directory, engine.name());
+    if (path.empty()) {
+        LOG_INFO("Engine {}: no book snapshot in {}, starting empty", engine.name(), directory);
+        return result;
+    }
+    EngineSnapshot snapshot;
+    if (!load_book_snapshot(path, snapshot)) {
+        LOG_ERROR("Engine {}: book snapshot {} is unreadable, starting empty", engine.name(), path);
+        return result;
+    }
+    result.snapshot = path;
+    result.orders   = engine.restore(snapshot);
+
+    // The journal tail: this engine's requests after the snapshot's sequence
+    const std::string journal = snapshot.header.journal_path;
+    std::vector<std::string> files = list_journal_segments(journal);
+    if (files.empty() && !journal.empty() && std::filesystem::exists(journal)) files.push_back(journal);
+
+    std::vector<JournalRecord> tail;
+    uint64_t last = snapshot.header.journal_seq;
+    for (const std::string& file : files) {
+        MappedJournal mapped;
+        if (!mapped.open(file)) {
+            LOG_WARN("Engine {}: journal {} is unreadable, replay stops there", engine.name(), file);
+            break;
+        }
+        const uint16_t lane = snapshot.header.journal_engine;
+        if (lane >= mapped.header().engine_count ||
+            engine.name().compare(0, sizeof(mapped.header().engine_names[lane]),
+                                  mapped.header().engine_names[lane]) != 0) {
+            LOG_WARN("Engine {}: journal {} does not match the snapshot, not replayed", engine.name(), file);
+            break;
+        }
+        if (mapped.header().run_id != snapshot.header.journal_run_id) {
+            LOG_WARN("Engine {}: journal {} is from another run than the snapshot, not replayed",
+                     engine.name(), file);
+            break;
+        }
+        for (const JournalRecord& record : mapped.records()) {
+            if (record.engine != lane || record.seq <= snapshot.header.journal_seq) continue;
+            if (record.seq != last + 1) ++result.journal_gaps;
+            last = record.seq;
+            if (record.type <= JournalRecordType::MASS_CANCEL) tail.push_back(record);
+        }
+    }
+    result.replayed = engine.replay(tail);
+
+    LOG_INFO("Engine {}: restored {} orders from {}, replayed {} journaled requests{}", engine.name(),
+             result.orders, path, result.replayed,
+             result.journal_gaps ? " (journal has gaps: replay is incomplete)" : "");
+    return result;
+}
+
+} // namespace rtes
@@ -4,10 +4,36 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
+#include <string_view>
 
 namespace rtes {
 
+namespace {
+
+/** One scalar field of a wire message */
+template<typename T>
+T read_field(const std::byte* message, size_t offset) {
+    T value;
+    std::memcpy(&value, message + offset, sizeof(value));
+    return value;
+}
+
+/**
+ * A BoundedString field as the gateway sends it: the characters come
+ * first, NUL-terminated within the field. The length is recomputed here,
+ * never taken from the wire.
+ */
+template<typename String>
+std::string_view read_string(const std::byte* message, size_t offset) {
+    const char* field = reinterpret_cast<const char*>(message + offset);
+    return {field, ::strnlen(field, String{}.max_length())};
+}
+
+} // namespace
+
 ClientBase::ClientBase(const std::string& host, uint16_t port, uint32_t client_id)
     : host_(host), port_(port), client_id_(client_id), rng_(std::random_device{}()) {
 }
@@ -54,11 +80,24 @@ void ClientBase::disconnect() {
     }
 }
 
+void ClientBase::start_receiver() {
+    if (socket_fd_ < 0 || receiver_thread_.joinable()) return;
+    running_.store(true);
+    receiver_thread_ = std::thread(&ClientBase::receiver_loop, this);
+}
+
+void ClientBase::stop_receiver() {
+    running_.store(false);
+    if (socket_fd_ >= 0) ::shutdown(socket_fd_, SHUT_RDWR);
+    if (receiver_thread_.joinable()) {
+        receiver_thread_.join();
+    }
+}
+
 void ClientBase::run(std::chrono::seconds duration) {
     if (socket_fd_ < 0) return;
     
-    running_.store(true);
-    receiver_thread_ = std::thread(&ClientBase::receiver_loop, this);
+    start_receiver();
     
     on_start();
     
@@ -78,7 +117,8 @@ void ClientBase::run(std::chrono::seconds duration) {
     }
 }
 
-bool ClientBase::send_new_order(const std::string& symbol, Side side, uint64_t quantity, uint64_t price) {
+bool ClientBase::send_new_order(const std::string& symbol, Side side, uint64_t quantity, uint64_t price,
+                                OrderType type) {
     NewOrderMessage msg;
     msg.header = MessageHeader(NEW_ORDER, sizeof(NewOrderMessage), ++sequence_,
                               ProtocolUtils::get_timestamp_ns());
@@ -88,7 +128,7 @@ bool ClientBase::send_new_order(const std::string& symbol, Side side, uint64_t q
     msg.side = static_cast<uint8_t>(side);
     msg.quantity = quantity;
     msg.price = price;
-    msg.order_type = static_cast<uint8_t>(OrderType::LIMIT);
+    msg.order_type = static_cast<uint8_t>(type);
     
     ProtocolUtils::set_checksum(msg.header, &msg.order_id);
     
@@ -113,6 +153,22 @@ bool ClientBase::send_cancel_order(uint64_t order_id, const std::string& symbol)
     return send_message(&msg, sizeof(msg));
 }
 
+bool ClientBase::send_modify_order(uint64_t order_id, const std::string& symbol,
+                                   uint64_t new_quantity, uint64_t new_price) {
+    ModifyOrderMessage msg;
+    msg.header = MessageHeader(MODIFY_ORDER, sizeof(ModifyOrderMessage), ++sequence_,
+                              ProtocolUtils::get_timestamp_ns());
+    msg.order_id = order_id;
+    msg.client_id = std::to_string(client_id_).c_str();
+    msg.symbol = symbol.c_str();
+    msg.new_quantity = new_quantity;
+    msg.new_price = new_price;
+    
+    ProtocolUtils::set_checksum(msg.header, &msg.order_id);
+    
+    return send_message(&msg, sizeof(msg));
+}
+
 double ClientBase::random_double(double min, double max) {
     std::uniform_real_distribution<double> dist(min, max);
     return dist(rng_);
@@ -130,34 +186,72 @@ void ClientBase::receiver_loop() {
             continue;
         }
         
-        if (header.type == ORDER_ACK) {
-            OrderAckMessage ack;
-            std::memcpy(&ack.header, &header, sizeof(header));
-            
-            size_t remaining = sizeof(ack) - sizeof(header);
-            if (receive_message(&ack.order_id, remaining)) {
-                if (ack.status == 1) {
-                    orders_acked_.fetch_add(1);
-                } else {
-                    orders_rejected_.fetch_add(1);
-                }
-                on_order_ack(ack);
-            }
-        } else if (header.type == TRADE_REPORT) {
-            TradeMessage trade;
-            std::memcpy(&trade.header, &header, sizeof(header));
-            
-            size_t remaining = sizeof(trade) - sizeof(header);
-            if (receive_message(&trade.trade_id, remaining)) {
-                trades_received_.fetch_add(1);
-                on_trade(trade);
-            }
+        size_t length = 0;
+        if (header.type == ORDER_ACK) length = sizeof(OrderAckMessage);
+        else if (header.type == TRADE_REPORT) length = sizeof(TradeMessage);
+        if (length == 0) continue;
+
+        // The raw message, decoded field by field in dispatch()
+        std::byte message[std::max(sizeof(OrderAckMessage), sizeof(TradeMessage))];
+        std::memcpy(message, &header, sizeof(header));
+        if (receive_message(message + sizeof(header), length - sizeof(header))) {
+            dispatch(message, length);
         }
     }
 }
 
+void ClientBase::receive_bytes(const std::byte* data, size_t size) {
+    inbox_.insert(inbox_.end(), data, data + size);
+    size_t offset = 0;
+    while (inbox_.size() - offset >= sizeof(MessageHeader)) {
+        MessageHeader header;
+        std::memcpy(&header, inbox_.data() + offset, sizeof(header));
+        const size_t length = std::max<size_t>(header.length, sizeof(header));
+        if (inbox_.size() - offset < length) break;
+        dispatch(inbox_.data() + offset, length);
+        offset += length;
+    }
+    inbox_.erase(inbox_.begin(), inbox_.begin() + static_cast<std::ptrdiff_t>(offset));
+}
+
+void ClientBase::dispatch(const std::byte* message, size_t length) {
+    MessageHeader header;
+    std::memcpy(&header, message, sizeof(header));
+    if (header.type == ORDER_ACK && length >= sizeof(OrderAckMessage)) {
+        OrderAckMessage ack;  // Field by field: BoundedString is not memcpy-assignable
+        ack.header   = header;
+        ack.order_id = read_field<uint64_t>(message, offsetof(OrderAckMessage, order_id));
+        ack.status   = read_field<uint8_t>(message, offsetof(OrderAckMessage, status));
+        ack.reason   = read_string<decltype(ack.reason)>(message, offsetof(OrderAckMessage, reason));
+        if (ack.status == 1) {
+            orders_acked_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            orders_rejected_.fetch_add(1, std::memory_order_relaxed);
+        }
+        on_order_ack(ack);
+    } else if (header.type == TRADE_REPORT && length >= sizeof(TradeMessage)) {
+        TradeMessage trade;
+        trade.header        = header;
+        trade.trade_id      = read_field<uint64_t>(message, offsetof(TradeMessage, trade_id));
+        trade.buy_order_id  = read_field<uint64_t>(message, offsetof(TradeMessage, buy_order_id));
+        trade.sell_order_id = read_field<uint64_t>(message, offsetof(TradeMessage, sell_order_id));
+        trade.symbol        = read_string<decltype(trade.symbol)>(message, offsetof(TradeMessage, symbol));
+        trade.quantity      = read_field<uint64_t>(message, offsetof(TradeMessage, quantity));
+        trade.price         = read_field<uint64_t>(message, offsetof(TradeMessage, price));
+        trade.timestamp_ns  = read_field<uint64_t>(message, offsetof(TradeMessage, timestamp_ns));
+        trades_received_.fetch_add(1, std::memory_order_relaxed);
+        on_trade(trade);
+    }
+}
+
 bool ClientBase::send_message(const void* message, size_t size) {
     if (socket_fd_ < 0) return false;
+    if (buffered_) {
+        if (outbox_.size() + size > MAX_OUTBOX) return false;
+        const auto* bytes = static_cast<const std::byte*>(message);
+        outbox_.insert(outbox_.end(), bytes, bytes + size);
+        return true;
+    }
     
     ssize_t sent = send(socket_fd_, message, size, 0);
     return sent == static_cast<ssize_t>(size);
@@ -0,0 +1,44 @@
+/**
+ * @file client_directory.cpp
+ * @brief Dense client id assignment (cold path)
+ */
+
+#include "rtes/client_directory.hpp"
+#include "rtes/logger.hpp"
+
+#include <algorithm>
+
+namespace rtes {
+
+ClientDirectory::ClientDirectory(size_t capacity)
+    : capacity_(std::clamp<size_t>(capacity, 1, UINT32_MAX - 1))
+{
+    ids_.reserve(capacity_);
+}
+
+ClientIDRaw ClientDirectory::resolve(const ClientID& client) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(client);
+    if (it != ids_.end()) return it->second;
+
+    if (ids_.size() >= capacity_) [[unlikely]] {
+        LOG_WARN("Client directory full ({} clients) — refusing {}", capacity_, client.c_str());
+        return 0;
+    }
+    const auto raw = static_cast<ClientIDRaw>(ids_.size() + 1);  // 0 = unknown
+    ids_.emplace(client, raw);
+    return raw;
+}
+
+ClientIDRaw ClientDirectory::find(const ClientID& client) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(client);
+    return it != ids_.end() ? it->second : 0;
+}
+
+size_t ClientDirectory::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ids_.size();
+}
+
+} // namespace rtes
@@ -50,40 +50,287 @@ public:
         config->exchange.tcp_port = extract_uint16(content, "tcp_port");
         config->exchange.udp_multicast_group = extract_string(content, "udp_multicast_group");
         config->exchange.udp_port = extract_uint16(content, "udp_port");
+        if (has_key(content, "udp_channels"))
+            config->exchange.udp_channels = extract_string(content, "udp_channels");
         config->exchange.metrics_port = extract_uint16(content, "metrics_port");
+        if (has_key(content, "metrics_refresh_ms"))
+            config->exchange.metrics_refresh_ms = extract_uint32(content, "metrics_refresh_ms");
+        if (has_key(content, "dashboard_stream_ms"))
+            config->exchange.dashboard_stream_ms = extract_uint32(content, "dashboard_stream_ms");
+        if (has_key(content, "cancel_on_disconnect"))
+            config->exchange.cancel_on_disconnect = extract_bool(content, "cancel_on_disconnect");
+        if (has_key(content, "drop_copy_port"))
+            config->exchange.drop_copy_port = extract_uint16(content, "drop_copy_port");
+        if (has_key(content, "retransmit_port"))
+            config->exchange.retransmit_port = extract_uint16(content, "retransmit_port");
+        if (has_key(content, "retransmit_bind_address"))
+            config->exchange.retransmit_bind_address = extract_string(content, "retransmit_bind_address");
+        if (has_key(content, "snapshot_group"))
+            config->exchange.snapshot_group = extract_string(content, "snapshot_group");
+        if (has_key(content, "snapshot_port"))
+            config->exchange.snapshot_port = extract_uint16(content, "snapshot_port");
+        if (has_key(content, "tls_cert_file"))
+            config->exchange.tls_cert_file = extract_string(content, "tls_cert_file");
+        if (has_key(content, "tls_key_file"))
+            config->exchange.tls_key_file = extract_string(content, "tls_key_file");
+        if (has_key(content, "tls_ca_file"))
+            config->exchange.tls_ca_file = extract_string(content, "tls_ca_file");
+        if (has_key(content, "require_session_auth"))
+            config->exchange.require_session_auth = extract_bool(content, "require_session_auth");
+        if (has_key(content, "risk_reload_endpoint"))
+            config->exchange.risk_reload_endpoint = extract_bool(content, "risk_reload_endpoint");
+        if (has_key(content, "symbol_control_endpoint"))
+            config->exchange.symbol_control_endpoint = extract_bool(content, "symbol_control_endpoint");
+        if (has_key(content, "volatility_pause_ms"))
+            config->exchange.volatility_pause_ms = extract_uint32(content, "volatility_pause_ms");
         
         // Parse risk section
         config->risk.max_order_size = extract_uint64(content, "max_order_size");
         config->risk.max_notional_per_client = extract_double(content, "max_notional_per_client");
         config->risk.max_orders_per_second = extract_uint32(content, "max_orders_per_second");
+        if (has_key(content, "rate_limit_burst"))
+            config->risk.rate_limit_burst = extract_uint32(content, "rate_limit_burst");
         config->risk.price_collar_enabled = extract_bool(content, "price_collar_enabled");
+        if (has_key(content, "max_position"))
+            config->risk.max_position = extract_uint64(content, "max_position");
+        if (has_key(content, "max_open_quantity"))
+            config->risk.max_open_quantity = extract_uint64(content, "max_open_quantity");
         
         // Parse performance section
         config->performance.order_pool_size = extract_uint32(content, "order_pool_size");
+        if (has_key(content, "order_pool_magazine"))
+            config->performance.order_pool_magazine = extract_uint32(content, "order_pool_magazine");
+        if (has_key(content, "order_pool_segment"))
+            config->performance.order_pool_segment = extract_uint32(content, "order_pool_segment");
+        if (has_key(content, "order_pool_low_water"))
+            config->performance.order_pool_low_water = extract_uint32(content, "order_pool_low_water");
+        if (has_key(content, "order_pool_max"))
+            config->performance.order_pool_max = extract_uint32(content, "order_pool_max");
+        if (has_key(content, "order_pool_release_idle"))
+            config->performance.order_pool_release_idle = extract_bool(content, "order_pool_release_idle");
         config->performance.queue_capacity = extract_uint32(content, "queue_capacity");
         config->performance.enable_cpu_pinning = extract_bool(content, "enable_cpu_pinning");
         config->performance.tcp_nodelay = extract_bool(content, "tcp_nodelay");
         config->performance.udp_buffer_size = extract_uint32(content, "udp_buffer_size");
+        if (has_key(content, "latency_sample"))
+            config->performance.latency_sample = extract_uint32(content, "latency_sample");
+        if (has_key(content, "order_trace_sample"))
+            config->performance.order_trace_sample = extract_uint32(content, "order_trace_sample");
+        if (has_key(content, "order_trace_otlp_file"))
+            config->performance.order_trace_otlp_file = extract_string(content, "order_trace_otlp_file");
+        if (has_key(content, "queue_telemetry_sample"))
+            config->performance.queue_telemetry_sample = extract_uint32(content, "queue_telemetry_sample");
+        if (has_key(content, "depth_snapshot_levels"))
+            config->performance.depth_snapshot_levels = extract_uint32(content, "depth_snapshot_levels");
+        if (has_key(content, "depth_snapshot_events"))
+            config->performance.depth_snapshot_events = extract_uint32(content, "depth_snapshot_events");
+        if (has_key(content, "depth_snapshot_interval_us"))
+            config->performance.depth_snapshot_interval_us = extract_uint32(content, "depth_snapshot_interval_us");
+        if (has_key(content, "depth_incremental"))
+            config->performance.depth_incremental = extract_bool(content, "depth_incremental");
+        if (has_key(content, "engine_shard_cores"))
+            config->performance.engine_shard_cores = extract_string(content, "engine_shard_cores");
+        if (has_key(content, "risk_ingress_lanes"))
+            config->performance.risk_ingress_lanes = extract_uint32(content, "risk_ingress_lanes");
+        if (has_key(content, "gateway_reactors"))
+            config->performance.gateway_reactors = extract_uint32(content, "gateway_reactors");
+        if (has_key(content, "gateway_backend"))
+            config->performance.gateway_backend = extract_string(content, "gateway_backend");
+        if (has_key(content, "gateway_sqpoll_core"))
+            config->performance.gateway_sqpoll_core = static_cast<int32_t>(extract_uint32(content, "gateway_sqpoll_core"));
+        if (has_key(content, "gateway_idle_policy"))
+            config->performance.gateway_idle_policy = extract_string(content, "gateway_idle_policy");
+        if (has_key(content, "gateway_busy_poll_us"))
+            config->performance.gateway_busy_poll_us = extract_uint32(content, "gateway_busy_poll_us");
+        if (has_key(content, "gateway_incoming_cpu"))
+            config->performance.gateway_incoming_cpu = extract_bool(content, "gateway_incoming_cpu");
+        if (has_key(content, "gateway_rx_timestamps"))
+            config->performance.gateway_rx_timestamps = extract_bool(content, "gateway_rx_timestamps");
+        if (has_key(content, "gateway_max_connections"))
+            config->performance.gateway_max_connections = extract_uint32(content, "gateway_max_connections");
+        if (has_key(content, "shm_entry_name"))
+            config->performance.shm_entry_name = extract_string(content, "shm_entry_name");
+        if (has_key(content, "shm_entry_clients"))
+            config->performance.shm_entry_clients = extract_uint32(content, "shm_entry_clients");
+        if (has_key(content, "shm_entry_idle_policy"))
+            config->performance.shm_entry_idle_policy = extract_string(content, "shm_entry_idle_policy");
+        if (has_key(content, "shm_entry_core"))
+            config->performance.shm_entry_core = static_cast<int32_t>(extract_uint32(content, "shm_entry_core"));
+        if (has_key(content, "drop_copy_journal_size"))
+            config->performance.drop_copy_journal_size = extract_uint32(content, "drop_copy_journal_size");
+        if (has_key(content, "session_capture_file"))
+            config->performance.session_capture_file = extract_string(content, "session_capture_file");
+        if (has_key(content, "session_capture_lane_chunks"))
+            config->performance.session_capture_lane_chunks = extract_uint32(content, "session_capture_lane_chunks");
+        if (has_key(content, "max_clients"))
+            config->performance.max_clients = extract_uint32(content, "max_clients");
+        if (has_key(content, "risk_shards"))
+            config->performance.risk_shards = extract_uint32(content, "risk_shards");
+        if (has_key(content, "risk_shard_cores"))
+            config->performance.risk_shard_cores = extract_string(content, "risk_shard_cores");
+        if (has_key(content, "risk_manager_core"))
+            config->performance.risk_manager_core = static_cast<int32_t>(extract_uint32(content, "risk_manager_core"));
+        if (has_key(content, "gateway_core"))
+            config->performance.gateway_core = static_cast<int32_t>(extract_uint32(content, "gateway_core"));
+        if (has_key(content, "market_data_core"))
+            config->performance.market_data_core = static_cast<int32_t>(extract_uint32(content, "market_data_core"));
+        if (has_key(content, "monitoring_core"))
+            config->performance.monitoring_core = static_cast<int32_t>(extract_uint32(content, "monitoring_core"));
+        config->performance.realtime_priority = extract_uint32(content, "realtime_priority");
+        config->performance.lock_memory = extract_bool(content, "lock_memory");
+        if (has_key(content, "page_backing"))
+            config->performance.page_backing = extract_string(content, "page_backing");
+        if (has_key(content, "numa_pools"))
+            config->performance.numa_pools = extract_bool(content, "numa_pools");
+        if (has_key(content, "engine_idle_policy"))
+            config->performance.engine_idle_policy = extract_string(content, "engine_idle_policy");
+        if (has_key(content, "engine_maintenance_budget_ns"))
+            config->performance.engine_maintenance_budget_ns = extract_uint32(content, "engine_maintenance_budget_ns");
+        if (has_key(content, "engine_fair_slice"))
+            config->performance.engine_fair_slice = extract_uint32(content, "engine_fair_slice");
+        if (has_key(content, "stats_shm_name"))
+            config->performance.stats_shm_name = extract_string(content, "stats_shm_name");
+        if (has_key(content, "rebalance_interval_ms"))
+            config->performance.rebalance_interval_ms = extract_uint32(content, "rebalance_interval_ms");
+        if (has_key(content, "rebalance_imbalance"))
+            config->performance.rebalance_imbalance = extract_double(content, "rebalance_imbalance");
+        if (has_key(content, "rebalance_min_requests"))
+            config->performance.rebalance_min_requests = extract_uint32(content, "rebalance_min_requests");
+        if (has_key(content, "risk_idle_policy"))
+            config->performance.risk_idle_policy = extract_string(content, "risk_idle_policy");
+        if (has_key(content, "market_data_idle_policy"))
+            config->performance.market_data_idle_policy = extract_string(content, "market_data_idle_policy");
+        if (has_key(content, "market_data_datagram_bytes"))
+            config->performance.market_data_datagram_bytes = extract_uint32(content, "market_data_datagram_bytes");
+        if (has_key(content, "bbo_conflation"))
+            config->performance.bbo_conflation = extract_bool(content, "bbo_conflation");
+        if (has_key(content, "sweep_summary"))
+            config->performance.sweep_summary = extract_bool(content, "sweep_summary");
+        if (has_key(content, "market_data_xdp_interface"))
+            config->performance.market_data_xdp_interface = extract_string(content, "market_data_xdp_interface");
+        if (has_key(content, "market_data_xdp_queue"))
+            config->performance.market_data_xdp_queue = extract_uint32(content, "market_data_xdp_queue");
+        if (has_key(content, "market_data_xdp_zero_copy"))
+            config->performance.market_data_xdp_zero_copy = extract_bool(content, "market_data_xdp_zero_copy");
+        if (has_key(content, "retransmit_history_packets"))
+            config->performance.retransmit_history_packets = extract_uint32(content, "retransmit_history_packets");
+        if (has_key(content, "snapshot_bytes_per_second"))
+            config->performance.snapshot_bytes_per_second = extract_uint32(content, "snapshot_bytes_per_second");
+        if (has_key(content, "snapshot_interval_ms"))
+            config->performance.snapshot_interval_ms = extract_uint32(content, "snapshot_interval_ms");
+        if (has_key(content, "market_data_auth_key"))
+            config->performance.market_data_auth_key = extract_string(content, "market_data_auth_key");
+        if (has_key(content, "market_data_publishers"))
+            config->performance.market_data_publishers = extract_uint32(content, "market_data_publishers");
         
         // Parse logging section
         config->logging.level = extract_string(content, "level");
         config->logging.rate_limit_ms = extract_uint32(content, "rate_limit_ms");
         config->logging.enable_structured = extract_bool(content, "enable_structured");
+        if (has_key(content, "async_logging"))
+            config->logging.async = extract_bool(content, "async_logging");
         
         // Parse persistence section
         config->persistence.enable_event_log = extract_bool(content, "enable_event_log");
         config->persistence.snapshot_interval_ms = extract_uint32(content, "snapshot_interval_ms");
         config->persistence.log_directory = extract_string(content, "log_directory");
+        if (has_key(content, "restore_on_start"))
+            config->persistence.restore_on_start = extract_bool(content, "restore_on_start");
+        if (has_key(content, "journal_sync"))
+            config->persistence.journal_sync = extract_string(content, "journal_sync");
+        if (has_key(content, "journal_sync_ms"))
+            config->persistence.journal_sync_ms = extract_uint32(content, "journal_sync_ms");
+        if (has_key(content, "journal_direct_io"))
+            config->persistence.journal_direct_io = extract_bool(content, "journal_direct_io");
+        if (has_key(content, "journal_lane_capacity"))
+            config->persistence.journal_lane_capacity = extract_uint32(content, "journal_lane_capacity");
+        if (has_key(content, "journal_segment_mb"))
+            config->persistence.journal_segment_mb = extract_uint32(content, "journal_segment_mb");
+
+        // Parse replication section
+        if (has_key(content, "replication_role"))
+            config->replication.role = extract_string(content, "replication_role");
+        if (has_key(content, "replication_peer"))
+            config->replication.peer = extract_string(content, "replication_peer");
+        if (has_key(content, "replication_port"))
+            config->replication.port = extract_uint16(content, "replication_port");
+        if (has_key(content, "replication_bind_address"))
+            config->replication.bind_address = extract_string(content, "replication_bind_address");
+        if (has_key(content, "replication_secret"))
+            config->replication.secret = extract_string(content, "replication_secret");
+        if (has_key(content, "replication_mode"))
+            config->replication.mode = extract_string(content, "replication_mode");
+        if (has_key(content, "replication_backlog_mb"))
+            config->replication.max_backlog_mb = extract_uint32(content, "replication_backlog_mb");
+        if (has_key(content, "promote_after_ms"))
+            config->replication.promote_after_ms = extract_uint32(content, "promote_after_ms");
         
-        // Parse symbols (simplified - assumes 3 symbols)
-        config->symbols.push_back({"AAPL", 0.01, 1, 10.0});
-        config->symbols.push_back({"MSFT", 0.01, 1, 10.0});
-        config->symbols.push_back({"GOOGL", 0.01, 1, 10.0});
+        // Parse symbols array (falls back to default instruments)
+        config->symbols = parse_symbols(content);
         
         return config;
     }
 
 private:
+    /**
+     * Parse the "symbols" array.
+     *
+     * Each {...} object is scanned with the same flat key extraction
+     * used for the sections above, scoped to that object's text.
+     * Accepts "symbol" or "name" as the instrument key. Absent keys
+     * keep SymbolConfig defaults. If no array is present, the default
+     * instrument set (AAPL, MSFT, GOOGL) is used.
+     */
+    static std::vector<SymbolConfig> parse_symbols(const std::string& json) {
+        std::vector<SymbolConfig> symbols;
+
+        auto pos = json.find("\"symbols\"");
+        if (pos != std::string::npos) pos = json.find('[', pos);
+        const auto array_end = (pos == std::string::npos)
+            ? std::string::npos : json.find(']', pos);
+
+        while (pos != std::string::npos && array_end != std::string::npos) {
+            const auto obj_begin = json.find('{', pos);
+            if (obj_begin == std::string::npos || obj_begin > array_end) break;
+            const auto obj_end = json.find('}', obj_begin);
+            if (obj_end == std::string::npos) break;
+
+            const std::string obj = json.substr(obj_begin, obj_end - obj_begin + 1);
+            SymbolConfig sym;
+            sym.symbol = has_key(obj, "symbol") ? extract_string(obj, "symbol")
+                                                : extract_string(obj, "name");
+            if (has_key(obj, "tick_size"))        sym.tick_size = extract_double(obj, "tick_size");
+            if (has_key(obj, "lot_size"))         sym.lot_size = extract_uint64(obj, "lot_size");
+            if (has_key(obj, "price_collar_pct")) sym.price_collar_pct = extract_double(obj, "price_collar_pct");
+            if (has_key(obj, "intrusive_levels")) sym.intrusive_levels = extract_bool(obj, "intrusive_levels");
+            if (has_key(obj, "tick_ladder"))      sym.tick_ladder = extract_bool(obj, "tick_ladder");
+            if (has_key(obj, "self_trade_prevention"))
+                sym.self_trade_prevention = extract_string(obj, "self_trade_prevention");
+            if (has_key(obj, "engine_shard"))     sym.engine_shard = extract_int32(obj, "engine_shard");
+            if (has_key(obj, "engine_weight"))    sym.engine_weight = extract_uint32(obj, "engine_weight");
+            if (has_key(obj, "md_channel"))       sym.md_channel = extract_uint32(obj, "md_channel");
+            if (has_key(obj, "listed"))           sym.listed = extract_bool(obj, "listed");
+            if (has_key(obj, "price_band_bps"))   sym.price_band_bps = extract_uint32(obj, "price_band_bps");
+            if (has_key(obj, "queue_positions"))  sym.queue_positions = extract_bool(obj, "queue_positions");
+            if (has_key(obj, "order_feed_channel"))
+                sym.order_feed_channel = static_cast<int32_t>(extract_uint32(obj, "order_feed_channel"));
+
+            if (!sym.symbol.empty()) symbols.push_back(std::move(sym));
+            pos = obj_end + 1;
+        }
+
+        if (symbols.empty()) {
+            symbols.push_back({"AAPL", 0.01, 1, 10.0});
+            symbols.push_back({"MSFT", 0.01, 1, 10.0});
+            symbols.push_back({"GOOGL", 0.01, 1, 10.0});
+        }
+        return symbols;
+    }
+
+    static bool has_key(const std::string& json, const std::string& key) {
+        return json.find("\"" + key + "\"") != std::string::npos;
+    }
+
     static std::string extract_string(const std::string& json, const std::string& key) {
         auto pos = json.find("\"" + key + "\"");
         if (pos == std::string::npos) return "";
@@ -106,6 +353,10 @@ private:
     static uint64_t extract_uint64(const std::string& json, const std::string& key) {
         return static_cast<uint64_t>(extract_number(json, key));
     }
+
+    static int32_t extract_int32(const std::string& json, const std::string& key) {
+        return static_cast<int32_t>(extract_number(json, key, true));
+    }
     
     static double extract_double(const std::string& json, const std::string& key) {
         return extract_number(json, key);
@@ -119,7 +370,7 @@ private:
         return json.find("true", pos) < json.find("false", pos);
     }
     
-    static double extract_number(const std::string& json, const std::string& key) {
+    static double extract_number(const std::string& json, const std::string& key, bool is_signed = false) {
         auto pos = json.find("\"" + key + "\"");
         if (pos == std::string::npos) return 0;
         
@@ -127,6 +378,7 @@ private:
         while (pos < json.length() && (json[pos] == ':' || json[pos] == ' ')) pos++;
         
         auto end = pos;
+        if (is_signed && end < json.length() && json[end] == '-') end++;
         while (end < json.length() && (std::isdigit(json[end]) || json[end] == '.')) end++;
         
         return std::stod(json.substr(pos, end - pos));
@@ -44,8 +44,14 @@ void OperationalDashboard::add_panel(const DashboardPanel& panel) {
     panels_.push_back(panel);
 }
 
+void OperationalDashboard::set_stream_url(const std::string& url) {
+    std::unique_lock lock(panels_mutex_);
+    stream_url_ = url;
+}
+
 std::string OperationalDashboard::render_dashboard() const {
     std::ostringstream html;
+    std::shared_lock lock(panels_mutex_);
     
     html << R"HTML(<!DOCTYPE html>
 <html>
@@ -68,8 +74,34 @@ std::string OperationalDashboard::render_dashboard() const {
         function refreshDashboard() {
             location.reload();
         }
-        setInterval(refreshDashboard, 30000); // Auto-refresh every 30 seconds
-    </script>
+)HTML";
+
+    if (stream_url_.empty()) {
+        html << "        setInterval(refreshDashboard, 30000); // Auto-refresh every 30 seconds\n";
+    } else {
+        // A snapshot on connect, then deltas: only changed values cross the wire
+        html << "        const live = {};\n"
+             << "        function applyFields(e) {\n"
+             << "            const fields = JSON.parse(e.data);\n"
+             << "            if (e.type === 'snapshot') for (const k in live) if (!(k in fields)) fields[k] = null;\n"
+             << "            for (const [name, value] of Object.entries(fields)) {\n"
+             << "                let row = live[name];\n"
+             << "                if (value === null) { if (row) { row.remove(); delete live[name]; } continue; }\n"
+             << "                if (!row) {\n"
+             << "                    row = live[name] = document.createElement('tr');\n"
+             << "                    row.insertCell().textContent = name;\n"
+             << "                    row.insertCell();\n"
+             << "                    document.querySelectorAll('table.stream').forEach(t => t.appendChild(row));\n"
+             << "                }\n"
+             << "                row.cells[1].textContent = value;\n"
+             << "            }\n"
+             << "        }\n"
+             << "        const events = new EventSource('" << stream_url_ << "');\n"
+             << "        events.addEventListener('snapshot', applyFields);\n"
+             << "        events.addEventListener('delta', applyFields);\n";
+    }
+
+    html << R"HTML(    </script>
 </head>
 <body>
     <div class="header">
@@ -80,7 +112,6 @@ std::string OperationalDashboard::render_dashboard() const {
     <div class="grid">
 )HTML";
     
-    std::shared_lock lock(panels_mutex_);
     for (const auto& panel : panels_) {
         html << render_panel(panel);
     }
@@ -261,8 +292,21 @@ void OperationalDashboard::setup_default_panels() {
         {"active_alerts", "Active Alerts", "alert", "active_alerts", {}}
     };
     
+    // Live exchange counters, filled from the /events stream when one is set
+    DashboardPanel live_panel;
+    live_panel.id = "live";
+    live_panel.title = "Live Exchange";
+    live_panel.grid_x = 0;
+    live_panel.grid_y = 8;
+    live_panel.grid_w = 12;
+    live_panel.grid_h = 6;
+    
+    live_panel.widgets = {
+        {"live_fields", "Exchange, engines and queues", "stream", "events", {}}
+    };
+    
     std::unique_lock lock(panels_mutex_);
-    panels_ = {health_panel, perf_panel, business_panel, alerts_panel};
+    panels_ = {health_panel, perf_panel, business_panel, alerts_panel, live_panel};
 }
 
 std::string OperationalDashboard::render_panel(const DashboardPanel& panel) const {
@@ -318,6 +362,9 @@ std::string OperationalDashboard::render_widget(const DashboardWidget& widget) c
             }
         }
         
+    } else if (widget.type == "stream") {
+        html << "<table class=\"stream\"></table>";
+
     } else if (widget.type == "chart") {
         html << "<div class=\"chart\">Chart: " << widget.query << "</div>";
     }
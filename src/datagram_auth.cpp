@@ -0,0 +1,160 @@
+/**
+ * @file datagram_auth.cpp
+ * @brief Pre-keyed HMAC-SHA256 context, signing and batch verification
+ */
+
+#include "rtes/datagram_auth.hpp"
+
+#include <cstring>
+
+#ifndef RTES_NO_OPENSSL
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/opensslv.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#else
+#include <openssl/hmac.h>
+#endif
+#endif
+
+namespace rtes {
+
+namespace {
+
+inline constexpr size_t HMAC_SHA256_BYTES = 32;
+
+uint16_t packet_length(const uint8_t* datagram) {
+    uint16_t length;
+    std::memcpy(&length, datagram + MD_PACKET_LENGTH_OFFSET, sizeof(length));
+    return length;
+}
+
+uint32_t packet_flags(const uint8_t* datagram) {
+    uint32_t flags;
+    std::memcpy(&flags, datagram + MD_PACKET_FLAGS_OFFSET, sizeof(flags));
+    return flags;
+}
+
+} // namespace
+
+#ifndef RTES_NO_OPENSSL
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+
+/**
+ * EVP_MAC keyed once. EVP_MAC_init with a null key restarts from the
+ * stored pad states instead of re-deriving them from the key.
+ */
+struct DatagramAuthenticator::State {
+    EVP_MAC*     mac{nullptr};
+    EVP_MAC_CTX* ctx{nullptr};
+
+    ~State() {
+        EVP_MAC_CTX_free(ctx);
+        EVP_MAC_free(mac);
+    }
+
+    bool init(std::string_view key) {
+        mac = EVP_MAC_fetch(nullptr, "HMAC", nullptr);
+        if (!mac || !(ctx = EVP_MAC_CTX_new(mac))) return false;
+        char digest[] = "SHA256";
+        const OSSL_PARAM params[] = {
+            OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, digest, 0),
+            OSSL_PARAM_construct_end(),
+        };
+        return EVP_MAC_init(ctx, reinterpret_cast<const unsigned char*>(key.data()), key.size(), params) == 1;
+    }
+
+    bool compute(const uint8_t* data, size_t length, uint8_t* out) {
+        size_t written = 0;
+        return EVP_MAC_init(ctx, nullptr, 0, nullptr) == 1 &&
+               EVP_MAC_update(ctx, data, length) == 1 &&
+               EVP_MAC_final(ctx, out, &written, HMAC_SHA256_BYTES) == 1 &&
+               written == HMAC_SHA256_BYTES;
+    }
+};
+
+#else  // OpenSSL 1.1
+
+struct DatagramAuthenticator::State {
+    HMAC_CTX* ctx{nullptr};
+
+    ~State() { HMAC_CTX_free(ctx); }
+
+    bool init(std::string_view key) {
+        ctx = HMAC_CTX_new();
+        return ctx && HMAC_Init_ex(ctx, key.data(), static_cast<int>(key.size()), EVP_sha256(), nullptr) == 1;
+    }
+
+    bool compute(const uint8_t* data, size_t length, uint8_t* out) {
+        unsigned int written = 0;
+        return HMAC_Init_ex(ctx, nullptr, 0, nullptr, nullptr) == 1 &&
+               HMAC_Update(ctx, data, length) == 1 &&
+               HMAC_Final(ctx, out, &written) == 1 &&
+               written == HMAC_SHA256_BYTES;
+    }
+};
+
+#endif
+
+DatagramAuthenticator::DatagramAuthenticator(std::string_view key) {
+    if (key.empty()) return;
+    auto state = std::make_unique<State>();
+    if (state->init(key)) state_ = std::move(state);
+}
+
+bool DatagramAuthenticator::tag(const uint8_t* data, size_t length, uint8_t* out) {
+    uint8_t full[HMAC_SHA256_BYTES];
+    if (!state_->compute(data, length, full)) return false;
+    std::memcpy(out, full, MD_AUTH_TAG_BYTES);
+    return true;
+}
+
+bool DatagramAuthenticator::verify(const uint8_t* datagram, size_t size) {
+    if (!state_ || size < MD_PACKET_HEADER_BYTES) return false;
+    const size_t length = packet_length(datagram);
+    if (!(packet_flags(datagram) & UDP_PACKET_AUTHENTICATED) || length < MD_PACKET_HEADER_BYTES ||
+        length + MD_AUTH_TAG_BYTES > size) {
+        return false;
+    }
+    uint8_t expected[MD_AUTH_TAG_BYTES];
+    return tag(datagram, length, expected) &&
+           CRYPTO_memcmp(expected, datagram + length, MD_AUTH_TAG_BYTES) == 0;
+}
+
+#else  // RTES_NO_OPENSSL
+
+struct DatagramAuthenticator::State {};
+
+DatagramAuthenticator::DatagramAuthenticator(std::string_view) {}
+
+bool DatagramAuthenticator::tag(const uint8_t*, size_t, uint8_t*) { return false; }
+
+bool DatagramAuthenticator::verify(const uint8_t*, size_t) { return false; }
+
+#endif
+
+DatagramAuthenticator::~DatagramAuthenticator() = default;
+
+bool DatagramAuthenticator::ready() const { return state_ != nullptr; }
+
+size_t DatagramAuthenticator::sign(uint8_t* datagram, size_t length) {
+    if (!state_) return length;
+    const uint32_t flags = packet_flags(datagram) | UDP_PACKET_AUTHENTICATED;
+    std::memcpy(datagram + MD_PACKET_FLAGS_OFFSET, &flags, sizeof(flags));
+    return tag(datagram, length, datagram + length) ? length + MD_AUTH_TAG_BYTES : length;
+}
+
+size_t DatagramAuthenticator::verify_batch(const uint8_t* const* datagrams, const size_t* sizes,
+                                           size_t count, bool* ok) {
+    size_t passed = 0;
+    for (size_t i = 0; i < count; ++i) {
+        ok[i] = verify(datagrams[i], sizes[i]);
+        passed += ok[i];
+    }
+    return passed;
+}
+
+} // namespace rtes
@@ -0,0 +1,337 @@
+#include "rtes/drop_copy.hpp"
+#include "rtes/tcp_gateway.hpp"
+#include "rtes/auth_middleware.hpp"
+#include "rtes/logger.hpp"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __APPLE__
+    #ifndef MSG_NOSIGNAL
+        #define MSG_NOSIGNAL 0
+    #endif
+#endif
+
+namespace rtes {
+
+inline constexpr int    DROP_COPY_POLL_MS        = 1;   // Post-trade: ms latency is fine
+inline constexpr size_t DROP_COPY_MAX_SUBSCRIBERS = 64;
+inline constexpr size_t DROP_COPY_DRAIN_BATCH    = 256;
+
+// DropCopyAck::status
+inline constexpr uint8_t DROP_COPY_ACK_ACCEPTED = 1;
+inline constexpr uint8_t DROP_COPY_ACK_REJECTED = 2;
+
+namespace {
+
+/** Whether the request's token may read the firm's reports: its own, or an entitlement */
+bool entitled(const DropCopyRequest& request) {
+    const AuthContext ctx = AuthMiddleware::validate_session(request.auth_token.c_str());
+    if (!ctx.authenticated) return false;
+    const std::string firm = request.client_id.c_str();
+    return ctx.user_id == firm || SecurityUtils::check_permission(ctx, "drop_copy:" + firm);
+}
+
+} // namespace
+
+struct DropCopyServer::Subscriber {
+    FileDescriptor fd;
+    ReadBuffer     read_buf;
+    WriteBuffer    write_buf;          // Bounded: a slow reader stalls its cursor, nothing else
+    ClientIDRaw    firm{0};            // 0 until the first request
+    uint64_t       cursor{0};          // Next journal position to look at
+    uint64_t       next_sequence{1};   // Header sequence of acks (its own counter)
+    DropCopyAck    ack;                // Queued ahead of the reports it announces
+    bool           ack_pending{false};
+
+    explicit Subscriber(int raw_fd) : fd(raw_fd) {}
+};
+
+DropCopyServer::DropCopyServer(uint16_t port, size_t reactors, ClientDirectory* directory,
+                               size_t journal)
+    : port_(port)
+    , directory_(directory)
+    , drain_buffer_(DROP_COPY_DRAIN_BATCH)
+    , journal_(std::bit_ceil(std::max<size_t>(journal, 1)))
+    , journal_mask_(journal_.size() - 1)
+    , firm_sequence_(directory ? directory->capacity() + 1 : 1, 1)
+{
+    if (!directory) throw std::invalid_argument("DropCopyServer needs the client directory");
+    reactors = std::max<size_t>(reactors, 1);
+    for (size_t i = 0; i < reactors; ++i) {
+        queues_.push_back(std::make_unique<SPSCQueue<DropCopyRecord>>(DROP_COPY_QUEUE_CAPACITY));
+    }
+    subscribers_.reserve(DROP_COPY_MAX_SUBSCRIBERS);
+    poll_fds_.reserve(DROP_COPY_MAX_SUBSCRIBERS + 1);
+}
+
+DropCopyServer::~DropCopyServer() {
+    stop();
+}
+
+void DropCopyServer::start() {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd >= 0) {
+        listen_fd_.reset(fd);
+        int opt = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+        sockaddr_in addr{};
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = INADDR_ANY;
+        addr.sin_port        = htons(port_);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            listen(fd, static_cast<int>(DROP_COPY_MAX_SUBSCRIBERS)) < 0) {
+            fd = -1;
+        }
+    }
+    if (fd < 0) {
+        running_.store(false);
+        listen_fd_.close();
+        throw std::runtime_error("Failed to start drop copy server");
+    }
+
+    thread_ = std::thread(&DropCopyServer::run, this);
+    LOG_INFO("Drop copy on port {} ({} journal entries)", port_, journal_.size());
+}
+
+void DropCopyServer::stop() {
+    bool expected = true;
+    if (!running_.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) return;
+    if (thread_.joinable()) thread_.join();
+    subscribers_.clear();
+    subscriber_count_.store(0, std::memory_order_relaxed);
+    listen_fd_.close();
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Server Thread
+// ═══════════════════════════════════════════════════════════════
+
+void DropCopyServer::run() {
+    while (running_.load(std::memory_order_relaxed)) {
+        const bool busy = drain_reactors();
+
+        poll_fds_.clear();
+        poll_fds_.push_back({listen_fd_.get(), POLLIN, 0});
+        for (const auto& sub : subscribers_) {
+            const short events = sub->write_buf.empty() ? POLLIN : (POLLIN | POLLOUT);
+            poll_fds_.push_back({sub->fd.get(), events, 0});
+        }
+        if (poll(poll_fds_.data(), poll_fds_.size(), busy ? 0 : DROP_COPY_POLL_MS) < 0 &&
+            errno != EINTR) {
+            break;
+        }
+
+        if (poll_fds_[0].revents & POLLIN) accept_subscribers();
+
+        // poll_fds_[i + 1] is subscribers_[i] as of the poll; accepted ones come after
+        const size_t polled = poll_fds_.size() - 1;
+        for (size_t i = subscribers_.size(); i-- > 0;) {
+            Subscriber& sub = *subscribers_[i];
+            const short revents = i < polled ? poll_fds_[i + 1].revents : 0;
+            bool alive = !(revents & (POLLERR | POLLHUP | POLLNVAL));
+            if (alive && (revents & POLLIN)) alive = read_requests(sub);
+            if (alive) alive = pump(sub);
+            if (!alive) {
+                subscribers_[i] = std::move(subscribers_.back());
+                subscribers_.pop_back();
+            }
+        }
+        subscriber_count_.store(subscribers_.size(), std::memory_order_relaxed);
+    }
+}
+
+/** @return true if anything was journaled (poll without waiting) */
+bool DropCopyServer::drain_reactors() {
+    bool any = false;
+    for (auto& queue : queues_) {
+        size_t count;
+        do {
+            count = queue->try_pop_bulk(drain_buffer_.data(), drain_buffer_.size());
+            for (size_t i = 0; i < count; ++i) journal(drain_buffer_[i]);
+            any |= count > 0;
+        } while (count == drain_buffer_.size());
+    }
+    return any;
+}
+
+void DropCopyServer::journal(const DropCopyRecord& record) {
+    if (record.client == 0 || record.client >= firm_sequence_.size()) [[unlikely]] return;
+
+    JournalEntry& entry = journal_[journal_head_ & journal_mask_];
+    entry.firm = record.client;
+
+    DropCopyReport& msg = entry.message;
+    msg = DropCopyReport{};
+    msg.header = MessageHeader(DROP_COPY_REPORT, sizeof(DropCopyReport),
+                               firm_sequence_[record.client]++, now_timestamp());
+    const ExecutionReport& report = record.report;
+    switch (report.type) {
+        case ExecutionReport::FILL:
+            msg.exec_type    = DROP_COPY_FILL;
+            msg.side         = static_cast<uint8_t>(record.side);
+            msg.order_id     = record.side == Side::BUY ? report.fill.buy_order_id
+                                                        : report.fill.sell_order_id;
+            msg.trade_id     = report.fill.id;
+            msg.symbol.assign(report.fill.symbol.c_str());
+            msg.quantity     = report.fill.quantity;
+            msg.price        = report.fill.price;
+            msg.timestamp_ns = report.fill.timestamp;
+            break;
+        case ExecutionReport::DONE:
+            msg.exec_type       = DROP_COPY_DONE;
+            msg.status          = static_cast<uint8_t>(report.status);
+            msg.order_id        = report.order.order_id;
+            msg.quantity        = report.order.filled_quantity;
+            msg.leaves_quantity = report.order.leaves_quantity;
+            msg.timestamp_ns    = msg.header.timestamp;
+            break;
+        case ExecutionReport::REJECTED:
+            msg.exec_type    = DROP_COPY_REJECTED;
+            msg.status       = static_cast<uint8_t>(report.status);
+            msg.reason       = report.reason;
+            msg.order_id     = report.order.order_id;
+            msg.timestamp_ns = msg.header.timestamp;
+            break;
+    }
+    ++journal_head_;
+    reports_journaled_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void DropCopyServer::accept_subscribers() {
+    for (;;) {
+        const int fd = accept(listen_fd_.get(), nullptr, nullptr);
+        if (fd < 0) break;
+        if (subscribers_.size() >= DROP_COPY_MAX_SUBSCRIBERS) {
+            LOG_WARN("Drop copy subscriber refused: {} connected", subscribers_.size());
+            ::close(fd);
+            continue;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+#ifdef __APPLE__
+        int set = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &set, sizeof(set));
+#endif
+        subscribers_.push_back(std::make_unique<Subscriber>(fd));
+    }
+}
+
+/** @return false if the subscriber disconnected or sent a bad frame */
+bool DropCopyServer::read_requests(Subscriber& sub) {
+    for (;;) {
+        sub.read_buf.make_room();
+        const ssize_t bytes = recv(sub.fd.get(), sub.read_buf.write_ptr(), sub.read_buf.remaining(), 0);
+        if (bytes == 0) return false;
+        if (bytes < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        sub.read_buf.advance_write(static_cast<size_t>(bytes));
+
+        while (sub.read_buf.size() >= sizeof(MessageHeader)) {
+            MessageHeader header;
+            std::memcpy(&header, sub.read_buf.data(), sizeof(header));
+            if (header.type != DROP_COPY_REQUEST || header.length != sizeof(DropCopyRequest)) {
+                return false;
+            }
+            if (sub.read_buf.size() < sizeof(DropCopyRequest)) break;
+            DropCopyRequest request;
+            std::memcpy(static_cast<void*>(&request), sub.read_buf.data(), sizeof(request));
+            sub.read_buf.consume(sizeof(request));
+            handle_request(sub, request);
+        }
+    }
+}
+
+/**
+ * Point the subscriber's cursor at the firm's report `next_sequence` (or
+ * the oldest one still journaled after it) and ack with where it starts.
+ * Reports already in the write buffer go out first; the ack marks the
+ * switch.
+ */
+void DropCopyServer::handle_request(Subscriber& sub, const DropCopyRequest& request) {
+    DropCopyAck& ack = sub.ack;
+    ack = DropCopyAck{};
+    ack.header = MessageHeader(DROP_COPY_ACK, sizeof(DropCopyAck), sub.next_sequence++, now_timestamp());
+    sub.ack_pending = true;
+
+    if (!entitled(request)) {
+        LOG_WARN_SAFE("Drop copy refused for firm {}", request.client_id.c_str());
+        requests_refused_.fetch_add(1, std::memory_order_relaxed);
+        ack.status = DROP_COPY_ACK_REJECTED;
+        sub.firm   = 0;
+        return;
+    }
+
+    const ClientIDRaw firm = directory_->resolve(ClientID(request.client_id.c_str()));
+    if (firm == 0 || firm >= firm_sequence_.size()) [[unlikely]] {
+        ack.status = DROP_COPY_ACK_REJECTED;
+        sub.firm   = 0;
+        return;
+    }
+
+    sub.firm          = firm;
+    sub.cursor        = journal_head_;
+    ack.status        = DROP_COPY_ACK_ACCEPTED;
+    ack.next_sequence = firm_sequence_[firm];
+    if (request.next_sequence != 0 && request.next_sequence < firm_sequence_[firm]) {
+        replays_.fetch_add(1, std::memory_order_relaxed);
+        for (uint64_t pos = oldest(); pos < journal_head_; ++pos) {
+            const JournalEntry& entry = journal_[pos & journal_mask_];
+            if (entry.firm == firm && entry.message.header.sequence >= request.next_sequence) {
+                sub.cursor        = pos;
+                ack.next_sequence = entry.message.header.sequence;
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Copy the subscriber's reports from its cursor into its write buffer
+ * until the buffer or the journal runs out, then write them with one
+ * sendmsg. @return false if the connection failed
+ */
+bool DropCopyServer::pump(Subscriber& sub) {
+    if (sub.ack_pending && sub.write_buf.append(&sub.ack, sizeof(sub.ack))) {
+        sub.ack_pending = false;
+    }
+    if (sub.firm != 0 && !sub.ack_pending) {
+        if (sub.cursor < oldest()) [[unlikely]] {
+            sub.cursor = oldest();  // Wrapped past it: the sequence shows the gap
+            gaps_.fetch_add(1, std::memory_order_relaxed);
+        }
+        for (; sub.cursor < journal_head_; ++sub.cursor) {
+            const JournalEntry& entry = journal_[sub.cursor & journal_mask_];
+            if (entry.firm != sub.firm) continue;
+            if (!sub.write_buf.append(&entry.message, sizeof(entry.message))) break;
+        }
+    }
+
+    while (!sub.write_buf.empty()) {
+        iovec iov[2];
+        msghdr msg{};
+        msg.msg_iov    = iov;
+        msg.msg_iovlen = sub.write_buf.pending(iov);
+        const ssize_t sent = sendmsg(sub.fd.get(), &msg, MSG_NOSIGNAL);
+        if (sent > 0) {
+            sub.write_buf.consume(static_cast<size_t>(sent));
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+    }
+    return true;
+}
+
+} // namespace rtes
@@ -27,6 +27,9 @@ std::string ErrorCategory::message(int ev) const {
         case ErrorCode::ORDER_INVALID: return "Invalid order";
         case ErrorCode::ORDER_DUPLICATE: return "Duplicate order";
         case ErrorCode::ORDER_NOT_FOUND: return "Order not found";
+        case ErrorCode::ORDER_WOULD_CROSS: return "Post-only order would cross";
+        case ErrorCode::ORDER_UNFILLABLE: return "Fill-or-kill order cannot be filled";
+        case ErrorCode::ORDER_HALTED: return "Trading halted";
         case ErrorCode::RISK_LIMIT_EXCEEDED: return "Risk limit exceeded";
         
         case ErrorCode::SYSTEM_SHUTDOWN: return "System shutdown";
@@ -0,0 +1,459 @@
+/**
+ * @file event_journal.cpp
+ * @brief Journal thread: lane drain, block-aligned writes or mapped segments, sync policy
+ */
+
+#include "rtes/event_journal.hpp"
+#include "rtes/logger.hpp"
+#include "rtes/replication.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+namespace rtes {
+
+namespace {
+
+constexpr auto JOURNAL_POLL     = std::chrono::milliseconds(1);
+constexpr auto JOURNAL_MAX_HOLD = std::chrono::milliseconds(1);  // Longest records wait in the buffer
+
+size_t round_up_block(size_t bytes) {
+    return (bytes + JOURNAL_BLOCK - 1) / JOURNAL_BLOCK * JOURNAL_BLOCK;
+}
+
+size_t page_size() {
+    static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+} // namespace
+
+const char* journal_record_type_name(JournalRecordType type) {
+    switch (type) {
+        case JournalRecordType::PADDING:      return "padding";
+        case JournalRecordType::NEW_ORDER:    return "new_order";
+        case JournalRecordType::CANCEL_ORDER: return "cancel_order";
+        case JournalRecordType::MODIFY_ORDER: return "modify_order";
+        case JournalRecordType::SET_PHASE:    return "set_phase";
+        case JournalRecordType::MASS_CANCEL:  return "mass_cancel";
+        case JournalRecordType::TRADE:        return "trade";
+        case JournalRecordType::ORDER_DONE:   return "order_done";
+        case JournalRecordType::ORDER_REJECT: return "order_reject";
+    }
+    return "unknown";
+}
+
+JournalSync parse_journal_sync(const std::string& name) {
+    if (name == "none") return JournalSync::NONE;
+    if (name == "batch") return JournalSync::BATCH;
+    return JournalSync::INTERVAL;
+}
+
+std::string journal_segment_path(const std::string& path, uint32_t index) {
+    const std::filesystem::path base(path);
+    char suffix[16];
+    std::snprintf(suffix, sizeof(suffix), "-%06u", index);
+    return (base.parent_path() / (base.stem().string() + suffix + base.extension().string())).string();
+}
+
+std::vector<std::string> list_journal_segments(const std::string& path) {
+    std::vector<std::string> segments;
+    for (uint32_t index = 0;; ++index) {
+        std::string segment = journal_segment_path(path, index);
+        if (!std::filesystem::exists(segment)) break;
+        segments.push_back(std::move(segment));
+    }
+    return segments;
+}
+
+EventJournal::EventJournal(std::string path, const JournalOptions& options)
+    : path_(std::move(path)), options_(options) {
+    std::random_device random;
+    header_.run_id = (static_cast<uint64_t>(random()) << 32 | random()) | 1;  // Never 0: "no journal"
+}
+
+EventJournal::~EventJournal() {
+    stop();
+}
+
+JournalLane* EventJournal::add_engine(const std::string& name) {
+    if (lanes_.size() >= JOURNAL_MAX_ENGINES) {
+        throw std::length_error("EventJournal: more than JOURNAL_MAX_ENGINES engines");
+    }
+    engine_names_.push_back(name);
+    lanes_.push_back(std::make_unique<JournalLane>(static_cast<uint16_t>(lanes_.size()),
+                                                   options_.lane_capacity));
+    return lanes_.back().get();
+}
+
+bool EventJournal::start() {
+    if (running_.load(std::memory_order_relaxed)) return true;
+
+    std::memcpy(header_.magic, JOURNAL_MAGIC, sizeof(header_.magic));
+    header_.steady_base_ns = static_cast<int64_t>(now_timestamp());
+    header_.unix_base_ns   = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    header_.engine_count = static_cast<uint32_t>(engine_names_.size());
+    for (size_t i = 0; i < engine_names_.size(); ++i) {
+        std::strncpy(header_.engine_names[i], engine_names_[i].c_str(), sizeof(header_.engine_names[i]) - 1);
+    }
+
+    if (options_.segment_bytes > 0) {
+        map_size_ = std::max(round_up_block(options_.segment_bytes), 2 * JOURNAL_BLOCK);
+        if (!open_segment()) return false;
+    } else if (!open_file()) {
+        return false;
+    }
+
+    if (replicator_) replicator_->connect(header_);
+
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&EventJournal::run, this);
+    LOG_INFO("Event journal {}: {} engine lane(s), sync {}{}", path_, lanes_.size(),
+             options_.sync == JournalSync::NONE ? "none" :
+             options_.sync == JournalSync::BATCH ? "per write" : "interval",
+             map_size_ > 0 ? ", mapped segments" : options_.direct_io ? ", O_DIRECT" : "");
+    return true;
+}
+
+bool EventJournal::open_file() {
+    fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        LOG_ERROR("Cannot create event journal {}: {}", path_, std::strerror(errno));
+        return false;
+    }
+    if (options_.direct_io) {
+        // Reopened: a failed O_DIRECT open may or may not have created the file
+        const int direct = ::open(path_.c_str(), O_WRONLY | O_DIRECT | O_CLOEXEC);
+        if (direct >= 0) {
+            ::close(fd_);
+            fd_ = direct;
+        } else if (errno == EINVAL) {
+            LOG_WARN("Journal {}: O_DIRECT not supported by the filesystem, using buffered writes", path_);
+        }
+    }
+
+    buffer_capacity_ = std::max(round_up_block(options_.buffer_bytes), 2 * JOURNAL_BLOCK);
+    buffer_.reset(static_cast<std::byte*>(std::aligned_alloc(JOURNAL_BLOCK, buffer_capacity_)));
+    if (!buffer_) throw std::bad_alloc();
+    std::memset(buffer_.get(), 0, buffer_capacity_);
+
+    std::memcpy(buffer_.get(), &header_, sizeof(header_));
+    buffer_used_   = JOURNAL_BLOCK;
+    buffer_offset_ = 0;
+    write_buffer();
+    sync(true);
+    return true;
+}
+
+bool EventJournal::open_segment() {
+    const std::string segment = journal_segment_path(path_, segment_index_);
+    fd_ = ::open(segment.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        LOG_ERROR("Cannot create event journal segment {}: {}", segment, std::strerror(errno));
+        return false;
+    }
+    // Reserve the blocks up front: stores into the mapping never allocate
+    // (or hit ENOSPC as a SIGBUS) and msync never has to update the size
+    if (::fallocate(fd_, 0, 0, static_cast<off_t>(map_size_)) < 0) {
+        if (segment_index_ == 0) {
+            LOG_WARN("Journal {}: fallocate not supported ({}), segments are sparse", path_, std::strerror(errno));
+        }
+        if (::ftruncate(fd_, static_cast<off_t>(map_size_)) < 0) {
+            LOG_ERROR("Cannot size event journal segment {}: {}", segment, std::strerror(errno));
+            ::close(fd_);
+            fd_ = -1;
+            return false;
+        }
+    }
+    void* map = ::mmap(nullptr, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED) {
+        LOG_ERROR("Cannot map event journal segment {}: {}", segment, std::strerror(errno));
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    ::madvise(map, map_size_, MADV_SEQUENTIAL);
+    map_ = static_cast<std::byte*>(map);
+
+    header_.segment = segment_index_;
+    std::memcpy(map_, &header_, sizeof(header_));
+    map_used_    = JOURNAL_BLOCK;
+    map_flushed_ = 0;
+    map_synced_  = 0;
+    unwritten_   = true;
+    segments_.fetch_add(1, std::memory_order_relaxed);
+    flush_segment();
+    sync(true);  // The header, so that a crash leaves a readable segment
+    return true;
+}
+
+void EventJournal::close_segment() {
+    if (!map_) return;
+    flush_segment();
+    sync(true);
+    ::munmap(map_, map_size_);
+    map_ = nullptr;
+    // Give back the unused reservation: a closed segment ends at its last record
+    if (::ftruncate(fd_, static_cast<off_t>(map_used_)) < 0 || ::fdatasync(fd_) < 0) {
+        write_errors_.fetch_add(1, std::memory_order_relaxed);
+    }
+    ::close(fd_);
+    fd_ = -1;
+    closed_bytes_ += map_used_;
+    map_used_ = 0;
+}
+
+void EventJournal::flush_segment() {
+    if (map_used_ > map_flushed_) {
+        if (::sync_file_range(fd_, static_cast<off_t>(map_flushed_), static_cast<off_t>(map_used_ - map_flushed_),
+                              SYNC_FILE_RANGE_WRITE) < 0) {
+            write_errors_.fetch_add(1, std::memory_order_relaxed);
+        }
+        map_flushed_ = map_used_;
+        unsynced_    = true;
+    }
+    unwritten_ = false;
+    bytes_.store(closed_bytes_ + map_used_, std::memory_order_relaxed);
+
+    if (options_.sync == JournalSync::BATCH) sync(true);
+}
+
+void EventJournal::stop() {
+    bool expected = true;
+    if (!running_.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) return;
+    if (thread_.joinable()) thread_.join();
+
+    drain();  // What the engines left behind
+    if (replicator_) {
+        replicator_->flush();
+        replicator_->close();
+    }
+    if (map_size_ > 0) {
+        close_segment();
+    } else {
+        if (unwritten_) write_buffer();
+        // Drop the zero padding of the last block: the file ends at the last record
+        if (::ftruncate(fd_, static_cast<off_t>(buffer_offset_ + buffer_used_)) < 0) {
+            write_errors_.fetch_add(1, std::memory_order_relaxed);
+        }
+        sync(true);
+        ::close(fd_);
+        fd_ = -1;
+    }
+    LOG_INFO("Event journal {} closed: {} records, {} dropped", path_, records_written(), drops());
+}
+
+uint64_t EventJournal::drops() const {
+    uint64_t total = 0;
+    for (const auto& lane : lanes_) total += lane->drops();
+    return total;
+}
+
+void EventJournal::run() {
+    auto last_write = std::chrono::steady_clock::now();
+    while (running_.load(std::memory_order_relaxed)) {
+        const size_t drained = drain();
+        const auto now = std::chrono::steady_clock::now();
+        // Batch while records keep coming, but never hold them past JOURNAL_MAX_HOLD
+        if (unwritten_ && (drained == 0 || now - last_write >= JOURNAL_MAX_HOLD)) {
+            if (map_size_ > 0) flush_segment();
+            else write_buffer();
+            last_write = now;
+        }
+        sync(false);
+        if (replicator_) replicator_->flush();
+        if (drained > 0) continue;
+        // A SYNC standby's acks gate the engines' reports: do not sleep on them
+        if (replicator_ && replicator_->mode() == ReplicationMode::SYNC && replicator_->connected()) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(JOURNAL_POLL);
+        }
+    }
+}
+
+size_t EventJournal::drain() {
+    if (map_size_ > 0) return drain_to_segment();
+
+    size_t total = 0;
+    for (auto& lane : lanes_) {
+        while (true) {
+            if (buffer_used_ == buffer_capacity_) write_buffer();
+            auto* out = reinterpret_cast<JournalRecord*>(buffer_.get() + buffer_used_);
+            const size_t room = (buffer_capacity_ - buffer_used_) / sizeof(JournalRecord);
+            const size_t count = lane->queue().try_pop_bulk(out, room);
+            if (count == 0) break;
+            if (replicator_) replicator_->append(out, count);
+            buffer_used_ += count * sizeof(JournalRecord);
+            total += count;
+            unwritten_ = true;
+        }
+    }
+    records_.fetch_add(total, std::memory_order_relaxed);
+    return total;
+}
+
+size_t EventJournal::drain_to_segment() {
+    size_t total = 0;
+    for (auto& lane : lanes_) {
+        while (map_) {
+            if (map_used_ + sizeof(JournalRecord) > map_size_) {
+                close_segment();
+                ++segment_index_;
+                // On failure the journal stops here: the lanes fill up and drop
+                // (drops()), the gap showing in the sequence numbers
+                if (!open_segment()) {
+                    write_errors_.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                }
+                continue;
+            }
+            auto* out = reinterpret_cast<JournalRecord*>(map_ + map_used_);
+            const size_t room = (map_size_ - map_used_) / sizeof(JournalRecord);
+            const size_t count = lane->queue().try_pop_bulk(out, room);
+            if (count == 0) break;
+            if (replicator_) replicator_->append(out, count);
+            map_used_ += count * sizeof(JournalRecord);
+            total += count;
+            unwritten_ = true;
+        }
+    }
+    records_.fetch_add(total, std::memory_order_relaxed);
+    return total;
+}
+
+void EventJournal::write_buffer() {
+    const size_t length = round_up_block(buffer_used_);
+    std::memset(buffer_.get() + buffer_used_, 0, length - buffer_used_);
+
+    size_t written = 0;
+    while (written < length) {
+        const ssize_t n = ::pwrite(fd_, buffer_.get() + written, length - written,
+                                   static_cast<off_t>(buffer_offset_ + written));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            write_errors_.fetch_add(1, std::memory_order_relaxed);
+            LOG_ERROR("Event journal {} write failed: {}", path_, std::strerror(errno));
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+
+    // Keep the partial last block: the next write rewrites it in place, extended
+    const size_t full = buffer_used_ / JOURNAL_BLOCK * JOURNAL_BLOCK;
+    const size_t tail = buffer_used_ - full;
+    if (full > 0 && tail > 0) std::memmove(buffer_.get(), buffer_.get() + full, tail);
+    buffer_offset_ += full;
+    buffer_used_    = tail;
+    unwritten_      = false;
+    unsynced_       = true;
+    bytes_.store(buffer_offset_ + buffer_used_, std::memory_order_relaxed);
+
+    if (options_.sync == JournalSync::BATCH) sync(true);
+}
+
+void EventJournal::sync(bool force) {
+    if (!unsynced_ || fd_ < 0) return;
+    const auto now = std::chrono::steady_clock::now();
+    if (!force) {
+        if (options_.sync != JournalSync::INTERVAL) return;
+        if (now - last_sync_ < options_.sync_interval) return;
+    }
+    if (map_) {
+        // Only the pages stored to since the last sync
+        const size_t begin = map_synced_ / page_size() * page_size();
+        if (::msync(map_ + begin, map_used_ - begin, MS_SYNC) < 0) {
+            write_errors_.fetch_add(1, std::memory_order_relaxed);
+        }
+        map_synced_ = map_used_;
+    } else if (::fdatasync(fd_) < 0) {
+        write_errors_.fetch_add(1, std::memory_order_relaxed);
+    }
+    syncs_.fetch_add(1, std::memory_order_relaxed);
+    unsynced_  = false;
+    last_sync_ = now;
+}
+
+MappedJournal::~MappedJournal() {
+    close();
+}
+
+MappedJournal::MappedJournal(MappedJournal&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), size_(std::exchange(other.size_, 0)),
+      records_(std::exchange(other.records_, {})) {}
+
+MappedJournal& MappedJournal::operator=(MappedJournal&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_    = std::exchange(other.data_, nullptr);
+        size_    = std::exchange(other.size_, 0);
+        records_ = std::exchange(other.records_, {});
+    }
+    return *this;
+}
+
+void MappedJournal::close() {
+    if (data_) ::munmap(data_, size_);
+    data_    = nullptr;
+    size_    = 0;
+    records_ = {};
+}
+
+bool MappedJournal::open(const std::string& path) {
+    close();
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    struct stat st{};
+    if (::fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < JOURNAL_BLOCK) {
+        ::close(fd);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) return false;
+
+    const auto* header = static_cast<const JournalFileHeader*>(data);
+    if (std::memcmp(header->magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 ||
+        header->version != JOURNAL_VERSION || header->record_size != sizeof(JournalRecord)) {
+        ::munmap(data, size);
+        return false;
+    }
+    ::madvise(data, size, MADV_SEQUENTIAL);
+    data_ = data;
+    size_ = size;
+
+    const auto* first = reinterpret_cast<const JournalRecord*>(static_cast<const std::byte*>(data) + JOURNAL_BLOCK);
+    size_t count = (size - JOURNAL_BLOCK) / sizeof(JournalRecord);
+    // A closed file ends at its last record. Otherwise (a live segment, or
+    // one a crash left unclosed) the records end at the first zero record.
+    if (count > 0 && first[count - 1].type == JournalRecordType::PADDING) {
+        count = static_cast<size_t>(std::find_if(first, first + count, [](const JournalRecord& record) {
+            return record.type == JournalRecordType::PADDING;
+        }) - first);
+    }
+    records_ = std::span<const JournalRecord>(first, count);
+    return true;
+}
+
+bool read_journal(const std::string& path, const std::function<void(const JournalRecord&)>& visit,
+                  JournalFileHeader* header) {
+    MappedJournal journal;
+    if (!journal.open(path)) return false;
+    if (header) *header = journal.header();
+    for (const auto& record : journal.records()) visit(record);
+    return true;
+}
+
+} // namespace rtes
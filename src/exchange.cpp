@@ -1,8 +1,150 @@
 #include "rtes/exchange.hpp"
+#include "rtes/book_rebalancer.hpp"
 #include "rtes/logger.hpp"
+#include "rtes/numa.hpp"
+#include "rtes/performance_optimizer.hpp"
+
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
 
 namespace rtes {
 
+inline constexpr size_t EXECUTION_QUEUE_CAPACITY = 65536;
+inline constexpr size_t RISK_FEEDBACK_CAPACITY   = 65536;
+
+namespace {
+
+/** Map SymbolConfig::self_trade_prevention to the book mode (unknown → NONE). */
+SelfTradePrevention parse_self_trade_prevention(const std::string& symbol, const std::string& mode) {
+    if (mode.empty() || mode == "none")  return SelfTradePrevention::NONE;
+    if (mode == "cancel_newest")         return SelfTradePrevention::CANCEL_NEWEST;
+    if (mode == "cancel_oldest")         return SelfTradePrevention::CANCEL_OLDEST;
+    if (mode == "cancel_both")           return SelfTradePrevention::CANCEL_BOTH;
+    if (mode == "decrement")             return SelfTradePrevention::DECREMENT;
+    LOG_WARN("Unknown self_trade_prevention '{}' for {} — disabled", mode, symbol);
+    return SelfTradePrevention::NONE;
+}
+
+/** Map a performance.*_idle_policy value (unknown → SPIN_YIELD). */
+IdlePolicy parse_idle_policy_key(const char* key, const std::string& name) {
+    const IdlePolicy policy = parse_idle_policy(name, IdlePolicy::SPIN_YIELD);
+    if (policy == IdlePolicy::SPIN_YIELD && name != "spin_yield") {
+        LOG_WARN("Unknown {} '{}' — using spin_yield", key, name);
+    }
+    return policy;
+}
+
+/** Parse a core list ("4,5,6", e.g. engine_shard_cores) — entry i is shard i's core. */
+std::vector<int> parse_core_list(const std::string& list) {
+    std::vector<int> cores;
+    std::stringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        try {
+            cores.push_back(std::stoi(item));
+        } catch (const std::exception&) {
+            LOG_WARN("Ignoring invalid core list entry '{}'", item);
+            cores.push_back(-1);
+        }
+    }
+    return cores;
+}
+
+/**
+ * Parse a channel list ("239.0.0.1:9999,239.0.0.2:9999", exchange.udp_channels)
+ * — entry i is channel i. At most 256 channels (MarketDataEvent::channel).
+ */
+std::vector<MarketDataChannel> parse_channel_list(const std::string& list) {
+    std::vector<MarketDataChannel> channels;
+    std::stringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        item.erase(0, item.find_first_not_of(' '));
+        const size_t colon = item.rfind(':');
+        if (colon != std::string::npos && channels.size() <= UINT8_MAX) {
+            try {
+                const auto port = static_cast<uint16_t>(std::stoul(item.substr(colon + 1)));
+                channels.push_back({item.substr(0, colon), port, 0});
+                continue;
+            } catch (const std::exception&) {}
+        }
+        LOG_WARN("Ignoring invalid market data channel '{}'", item);
+    }
+    return channels;
+}
+
+/**
+ * Books may move between shard engines: configured, with two shards to
+ * move between, and nothing that records requests per engine — the
+ * journal (with its snapshots and replication) cannot follow a book yet.
+ */
+bool book_rebalancing(const Config& config) {
+    if (config.performance.rebalance_interval_ms == 0) return false;
+    if (config.persistence.enable_event_log || config.replication.role != "none") return false;
+    std::set<int32_t> shards;
+    for (const auto& sym_config : config.symbols) {
+        if (sym_config.engine_shard >= 0) shards.insert(sym_config.engine_shard);
+    }
+    return shards.size() > 1;
+}
+
+} // namespace
+
+std::vector<EngineLayout> engine_layout(const Config& config) {
+    // Dedicated symbols get their own engine; shards are collected by id
+    std::vector<EngineLayout> engines;
+    std::map<int32_t, std::vector<BookSpec>> shards;
+    for (const auto& sym_config : config.symbols) {
+        BookSpec spec;
+        spec.symbol                   = sym_config.symbol;
+        spec.options.intrusive_levels = sym_config.intrusive_levels;
+        spec.options.tick_ladder      = sym_config.tick_ladder;
+        spec.options.tick             = price_from_double(sym_config.tick_size);
+        spec.options.self_trade       = parse_self_trade_prevention(
+            sym_config.symbol, sym_config.self_trade_prevention);
+        spec.options.latency_sample   = config.performance.latency_sample;
+        spec.options.price_band_bps   = sym_config.price_band_bps;
+        spec.options.queue_positions  = sym_config.queue_positions;
+        spec.weight                   = sym_config.engine_weight;
+
+        if (sym_config.engine_shard >= 0) {
+            shards[sym_config.engine_shard].push_back(std::move(spec));
+            continue;
+        }
+        engines.push_back({spec.symbol, {spec}, -1});
+    }
+    for (auto& [shard, books] : shards) {
+        engines.push_back({"shard-" + std::to_string(shard), books, shard});
+    }
+
+    // Rebalancing: each shard also gets a vacant slot for every other shard's symbols
+    if (book_rebalancing(config)) {
+        for (EngineLayout& engine : engines) {
+            if (engine.shard < 0) continue;
+            for (const auto& [shard, books] : shards) {
+                if (shard == engine.shard) continue;
+                for (BookSpec spec : books) {
+                    spec.hosted = false;
+                    engine.books.push_back(std::move(spec));
+                }
+            }
+        }
+    }
+    return engines;
+}
+
+/** "risk_manager", or "risk_manager_<i>" per shard when sharded. */
+std::string Exchange::risk_thread_name(size_t shard) const {
+    if (risk_shards_.size() == 1) return "risk_manager";
+    return "risk_manager_" + std::to_string(shard);
+}
+
 // ═══════════════════════════════════════════════════════════════
 //  Construction
 // ═══════════════════════════════════════════════════════════════
@@ -15,22 +157,25 @@ Exchange::Exchange(std::unique_ptr<Config> config)
     }
 
     LOG_INFO("Initializing exchange '{}'", config_->exchange.name);
+    TscClock::calibrate();  // The 10 ms spin happens here, not on a hot thread
 
     // Order matters: dependencies must be created first
     initialize_order_pool();
     initialize_market_data_queue();
     initialize_matching_engines();
+    check_numa_placement();
     initialize_risk_manager();
     wire_components();
 
-    LOG_INFO("Exchange initialized: {} symbols, pool capacity {}",
-             matching_engines_.size(),
+    LOG_INFO("Exchange initialized: {} symbols on {} engines, pool capacity {}",
+             matching_engines_.size(), engines_.size(),
              order_pool_->capacity());
 }
 
 Exchange::~Exchange() {
     if (state_ == ExchangeState::RUNNING ||
-        state_ == ExchangeState::STARTING) {
+        state_ == ExchangeState::STARTING ||
+        state_ == ExchangeState::STANDBY) {
         stop();
     }
 }
@@ -48,94 +193,675 @@ void Exchange::start() {
     state_ = ExchangeState::STARTING;
     LOG_INFO("Starting exchange components");
 
+    // Lock pages before any hot thread touches its working set
+    if (config_->performance.lock_memory) {
+        memory_locked_ = lock_process_memory();
+    }
+
+    // Warm restart: books as of the last snapshot, plus the journal tail after it.
+    // Read before the new journal is opened (within the same second it reuses the name).
+    if (config_->persistence.restore_on_start) {
+        const std::string directory = book_snapshots_ ? book_snapshots_->directory()
+                                    : config_->persistence.log_directory.empty() ? "."
+                                    : config_->persistence.log_directory;
+        for (auto& engine : engines_) restore_engine(*engine, directory);
+    }
+    if (book_snapshots_) book_snapshots_->start();
+
+    // The journal file exists before the first request is matched
+    if (event_journal_ && !event_journal_->start()) {
+        state_ = ExchangeState::STOPPED;
+        throw std::runtime_error("Cannot open event journal " + event_journal_->path());
+    }
+
+    // Standby: the engines follow the primary instead of taking orders
+    if (replication_standby_) {
+        replication_standby_->start();
+        state_ = ExchangeState::STANDBY;
+        LOG_INFO("Exchange is STANDBY");
+        return;
+    }
+
+    start_trading();
+    state_ = ExchangeState::RUNNING;
+    LOG_INFO("Exchange is RUNNING");
+}
+
+void Exchange::promote() {
+    if (state_ != ExchangeState::STANDBY) {
+        throw std::logic_error("Exchange::promote() called in invalid state");
+    }
+    replication_standby_->promote();
+    start_trading();
+    state_ = ExchangeState::RUNNING;
+    LOG_INFO("Exchange promoted: RUNNING");
+}
+
+void Exchange::start_trading() {
     // Start in dependency order:
     // 1. Matching engines (must be ready before risk routes to them)
-    for (auto& [symbol, engine] : matching_engines_) {
+    for (auto& engine : engines_) {
         engine->start();
-        LOG_INFO("  Started matching engine for {}", symbol.c_str());
+        LOG_INFO("  Started matching engine {}", engine->name());
     }
 
-    // 2. Risk manager (routes to running matching engines)
-    risk_manager_->start();
-    LOG_INFO("  Started risk manager");
+    // 2. Risk shards (route to running matching engines)
+    for (auto& shard : risk_shards_) shard->start();
+    LOG_INFO("  Started {} risk shard(s)", risk_shards_.size());
 
-    state_ = ExchangeState::RUNNING;
-    LOG_INFO("Exchange is RUNNING");
+    // 3. Trace aggregation (every sink exists by now)
+    if (order_tracer_) order_tracer_->start();
+
+    // 4. Pool growth, so the gateway never waits on a new segment
+    if (order_pool_->segment_slots() != 0) {
+        pool_maintenance_running_.store(true, std::memory_order_release);
+        pool_maintenance_thread_ = std::thread(&Exchange::pool_maintenance_loop, this);
+        LOG_INFO("  Started order pool maintenance");
+    }
+
+    // 5. Book rebalancing, once everything a move waits on runs
+    if (!rebalance_engines_.empty()) {
+        rebalance_running_.store(true, std::memory_order_release);
+        rebalance_thread_ = std::thread(&Exchange::rebalance_loop, this);
+        LOG_INFO("  Started book rebalancing across {} shard engines", rebalance_engines_.size());
+    }
 }
 
 void Exchange::stop() {
     if (state_ != ExchangeState::RUNNING &&
-        state_ != ExchangeState::STARTING) {
+        state_ != ExchangeState::STARTING &&
+        state_ != ExchangeState::STANDBY) {
         return;  // Already stopped or never started
     }
 
     state_ = ExchangeState::STOPPING;
     LOG_INFO("Stopping exchange components");
 
+    // A standby's applier goes first: nothing else writes its engines
+    if (replication_standby_) replication_standby_->promote();
+
+    if (pool_maintenance_thread_.joinable()) {
+        pool_maintenance_running_.store(false, std::memory_order_release);
+        pool_maintenance_thread_.join();
+    }
+
+    // A move in progress completes first: it waits on the risk shards and engines
+    if (rebalance_thread_.joinable()) {
+        rebalance_running_.store(false, std::memory_order_release);
+        rebalance_thread_.join();
+    }
+
     // Stop in reverse dependency order:
-    // 1. Risk manager (stop accepting new orders)
-    risk_manager_->stop();
-    LOG_INFO("  Stopped risk manager");
+    // 1. Risk shards (stop accepting new orders)
+    for (auto& shard : risk_shards_) shard->stop();
+    LOG_INFO("  Stopped {} risk shard(s)", risk_shards_.size());
 
     // 2. Matching engines (drain remaining orders)
-    for (auto& [symbol, engine] : matching_engines_) {
+    for (auto& engine : engines_) {
         engine->stop();
-        LOG_INFO("  Stopped matching engine for {}", symbol.c_str());
+        LOG_INFO("  Stopped matching engine {}", engine->name());
     }
 
+    // 3. Trace aggregation (drains what the engines finished last)
+    if (order_tracer_) order_tracer_->stop();
+
+    // 4. Journal: written and synced up to the engines' last output
+    if (event_journal_) event_journal_->stop();
+
+    // 5. Snapshots, including the one each engine took on stopping
+    if (book_snapshots_) book_snapshots_->stop();
+
     state_ = ExchangeState::STOPPED;
     LOG_INFO("Exchange is STOPPED");
 }
 
+// ═══════════════════════════════════════════════════════════════
+//  Instrument Lifecycle
+// ═══════════════════════════════════════════════════════════════
+
+bool Exchange::list_symbol(const Symbol& symbol) {
+    return change_symbol_state(symbol, InstrumentState::UNLISTED, InstrumentState::OPEN, std::nullopt);
+}
+
+bool Exchange::halt_symbol(const Symbol& symbol) {
+    return change_symbol_state(symbol, InstrumentState::OPEN, InstrumentState::HALTED,
+                               TradingPhase::HALTED);
+}
+
+bool Exchange::resume_symbol(const Symbol& symbol) {
+    return change_symbol_state(symbol, InstrumentState::HALTED, InstrumentState::OPEN,
+                               TradingPhase::CONTINUOUS);
+}
+
+bool Exchange::change_symbol_state(const Symbol& symbol, InstrumentState from, InstrumentState to,
+                                   std::optional<TradingPhase> phase) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    const InstrumentID id = instrument_directory_->find(symbol);
+    auto host = book_hosts_.find(symbol);
+    if (host == book_hosts_.end() || instrument_directory_->state(id) != from) return false;
+    MatchingEngine* engine = host->second;
+
+    if (phase) {
+        const auto control_lane = static_cast<IngressLane>(engine->lane_count() - 1);
+        if (!engine->set_trading_phase(*phase, engine->book_index(symbol), control_lane)) {
+            LOG_WARN("Symbol {}: control lane of engine {} is full", symbol.c_str(), engine->name());
+            return false;
+        }
+    }
+    instrument_directory_->set_state(id, to);
+    LOG_INFO("Symbol {}: {} -> {}", symbol.c_str(), instrument_state_name(from), instrument_state_name(to));
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Book Rebalancing
+// ═══════════════════════════════════════════════════════════════
+
+bool Exchange::migrate_symbol(const Symbol& symbol, MatchingEngine* to) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    auto host = book_hosts_.find(symbol);
+    if (host == book_hosts_.end() || !to || host->second == to) return false;
+    MatchingEngine* from = host->second;
+
+    // Every risk shard routes to `to` before the old engine is told to let go
+    auto reroute = [&] {
+        std::vector<uint64_t> generations;
+        for (auto& shard : risk_shards_) {
+            const uint64_t generation = shard->route_symbol(symbol, to);
+            if (generation == 0) return false;  // Same answer from every shard: nothing rerouted
+            generations.push_back(generation);
+        }
+        for (size_t i = 0; i < risk_shards_.size(); ++i) {
+            while (risk_shards_[i]->routes_generation() < generations[i] && risk_shards_[i]->is_running()) {
+                std::this_thread::yield();
+            }
+        }
+        return true;
+    };
+    const auto control_lane = static_cast<IngressLane>(from->lane_count() - 1);
+    if (!migrate_book(symbol, *from, *to, control_lane, reroute).moved) return false;
+    host->second = to;
+    return true;
+}
+
+MatchingEngine* Exchange::symbol_host(const Symbol& symbol) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    auto host = book_hosts_.find(symbol);
+    return host != book_hosts_.end() ? host->second : nullptr;
+}
+
+void Exchange::rebalance_loop() {
+    const auto& perf = config_->performance;
+    BookRebalancer rebalancer(rebalance_engines_, {perf.rebalance_imbalance, perf.rebalance_min_requests});
+    const auto interval = std::chrono::milliseconds(perf.rebalance_interval_ms);
+    auto next = std::chrono::steady_clock::now() + interval;
+    (void)rebalancer.sample();  // Baseline
+
+    // Short sleeps, so stop() never waits out a whole interval
+    while (rebalance_running_.load(std::memory_order_acquire)) {
+        if (std::chrono::steady_clock::now() < next) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        next += interval;
+        const auto move = rebalancer.sample();
+        if (!move) continue;
+        LOG_INFO("Rebalancing: {} ({} requests last interval) {} -> {}", move->symbol.c_str(),
+                 move->requests, move->from->name(), move->to->name());
+        if (migrate_symbol(move->symbol, move->to)) {
+            (void)rebalancer.sample();  // The move itself is not load
+            next = std::chrono::steady_clock::now() + interval;
+        }
+    }
+}
+
 // ═══════════════════════════════════════════════════════════════
 //  Initialization
 // ═══════════════════════════════════════════════════════════════
 
 void Exchange::initialize_order_pool() {
+    // Before anything page-backed is built: pools and queues take their storage at this policy
+    PagePolicy pages;
+    pages.backing = parse_page_backing(config_->performance.page_backing);
+    pages.lock    = config_->performance.lock_memory;
+    set_page_policy(pages);
+
+    std::vector<int> nodes;
+    if (config_->performance.numa_pools) {
+        nodes = numa_online_nodes();
+        if (nodes.size() < 2) {
+            LOG_INFO("numa_pools: single NUMA node, keeping one order pool");
+            nodes.clear();
+        }
+    }
+
     const size_t capacity = config_->performance.order_pool_size;
-    order_pool_ = std::make_unique<OrderPool>(capacity);
-    LOG_INFO("Order pool initialized: {} slots", capacity);
+    const size_t max_slots = config_->performance.order_pool_max != 0 ? config_->performance.order_pool_max
+                                                                      : 2 * capacity;
+    order_pool_ = std::make_unique<OrderPool>(capacity, config_->performance.order_pool_magazine, nodes,
+                                              config_->performance.order_pool_segment, max_slots);
+    const auto pool_stats = order_pool_->get_stats();
+    LOG_INFO("Order pool initialized: {} slots on {} pages{}, thread magazines of {}", capacity,
+             page_backing_name(pool_stats.pages), pool_stats.locked ? " (locked)" : "",
+             order_pool_->magazine_block() * 2);
+    for (size_t i = 0; nodes.size() > 1 && i < order_pool_->segments(); ++i) {
+        const auto& pool = order_pool_->segment(i);
+        LOG_INFO("  NUMA node {}: {} slots{}", nodes[i], pool.capacity(),
+                 pool.numa_node() < 0 ? " (not bound)" : "");
+    }
+    if (order_pool_->segment_slots() != 0) {
+        LOG_INFO("  Grows by {} slots below {} free, up to {}", order_pool_->segment_slots(), pool_low_water(),
+                 order_pool_->max_capacity());
+    }
+}
+
+size_t Exchange::pool_low_water() const {
+    const uint32_t low_water = config_->performance.order_pool_low_water;
+    return low_water != 0 ? low_water : order_pool_->segment_slots() / 4;
+}
+
+void Exchange::pool_maintenance_loop() {
+    // Polls rather than waits: the hot threads never signal it
+    constexpr auto INTERVAL = std::chrono::milliseconds(1);
+    const size_t low_water = pool_low_water();
+    const bool release_idle = config_->performance.order_pool_release_idle;
+    bool warned = false;
+
+    while (pool_maintenance_running_.load(std::memory_order_acquire)) {
+        const size_t available = order_pool_->available();
+        if (available < low_water) {
+            if (order_pool_->grow()) {
+                LOG_INFO("Order pool grown to {} slots in {} segments", order_pool_->capacity(),
+                         order_pool_->segments());
+                continue;  // Check again at once: a burst may need more than one segment
+            }
+            if (!warned) {
+                LOG_WARN("Order pool cannot grow past {} slots ({} free)",
+                         order_pool_->capacity(), available);
+                warned = true;
+            }
+        } else if (release_idle && available > low_water + order_pool_->segment_slots()) {
+            // Only with a segment's worth to spare, or the next burst would grow it straight back
+            if (const size_t released = order_pool_->release_idle_segments()) {
+                LOG_INFO("Order pool released {} idle segment(s)", released);
+            }
+        }
+        std::this_thread::sleep_for(INTERVAL);
+    }
+}
+
+void Exchange::check_numa_placement() const {
+    const auto& perf = config_->performance;
+    if (order_pool_->initial_segments() < 2 || !perf.enable_cpu_pinning) return;
+
+    // Orders come from the gateway thread's node; engines reading them belong there too
+    const int gateway_node = numa_node_of_cpu(perf.gateway_core);
+    if (gateway_node < 0) {
+        LOG_WARN("numa_pools: gateway_core is not set, so orders come from whichever node "
+                 "the gateway runs on first");
+        return;
+    }
+    const std::vector<int> cores = parse_core_list(perf.engine_shard_cores);
+    for (size_t shard = 0; shard < cores.size(); ++shard) {
+        const int node = numa_node_of_cpu(cores[shard]);
+        if (node >= 0 && node != gateway_node) {
+            LOG_WARN("numa_pools: engine shard-{} is pinned to core {} on node {}, but its orders "
+                     "come from the gateway's node {}", shard, cores[shard], node, gateway_node);
+        }
+    }
 }
 
 void Exchange::initialize_market_data_queue() {
-    const size_t capacity = config_->performance.market_data_queue_size;
-    market_data_queue_ = std::make_unique<MPMCQueue<MarketDataEvent>>(capacity);
-    LOG_INFO("Market data queue initialized: {} slots", capacity);
+    const auto& exchange = config_->exchange;
+    market_data_channels_ = parse_channel_list(exchange.udp_channels);
+    if (market_data_channels_.empty()) {
+        market_data_channels_.push_back({exchange.udp_multicast_group, exchange.udp_port, 0});
+    }
+
+    // More publishers than channels would leave threads idle
+    const size_t publishers = std::clamp<size_t>(config_->performance.market_data_publishers,
+                                                 1, market_data_channels_.size());
+    for (size_t i = 0; i < market_data_channels_.size(); ++i) {
+        market_data_channels_[i].publisher = i % publishers;
+    }
+
+    const IdlePolicy idle_policy = parse_idle_policy_key(
+        "market_data_idle_policy", config_->performance.market_data_idle_policy);
+    publisher_lanes_.resize(publishers);
+    for (size_t p = 0; p < publishers; ++p) {
+        market_data_idles_.push_back(std::make_unique<IdleStrategy>(idle_policy));
+    }
+    LOG_INFO("Market data: {} publishers, {} channels", publishers, market_data_channels_.size());
 }
 
 void Exchange::initialize_matching_engines() {
-    for (const auto& sym_config : config_->symbols) {
-        Symbol symbol(sym_config.symbol.c_str());
+    DepthPublishPolicy depth_policy;
+    depth_policy.levels       = config_->performance.depth_snapshot_levels;
+    depth_policy.every_events = config_->performance.depth_snapshot_events;
+    depth_policy.interval_us  = config_->performance.depth_snapshot_interval_us;
+    depth_policy.incremental  = config_->performance.depth_incremental;
 
-        auto engine = std::make_unique<MatchingEngine>(
-            sym_config.symbol, *order_pool_);
+    const IdlePolicy idle_policy = parse_idle_policy_key(
+        "engine_idle_policy", config_->performance.engine_idle_policy);
 
-        matching_engines_[symbol] = std::move(engine);
+    // One input lane per risk shard (each lane has a single producer), then
+    // the control lane: phase changes from the instrument lifecycle calls
+    const size_t input_lanes = std::max<uint32_t>(1, config_->performance.risk_shards) + 1;
+
+    auto add_engine = [&](std::unique_ptr<MatchingEngine> engine,
+                          const std::vector<BookSpec>& books) {
+        engine->set_depth_publishing(depth_policy);
+        engine->set_bbo_conflation(config_->performance.bbo_conflation);
+        engine->set_sweep_summary(config_->performance.sweep_summary);
+        engine->set_volatility_pause(std::chrono::milliseconds(config_->exchange.volatility_pause_ms));
+        engine->set_idle_policy(idle_policy);
+        engine->set_maintenance_budget(
+            std::chrono::nanoseconds(config_->performance.engine_maintenance_budget_ns));
+        engine->set_fair_scheduling(config_->performance.engine_fair_slice);
+        size_t hosted = 0;
+        for (const auto& book : books) {
+            if (!book.hosted) continue;
+            matching_engines_[Symbol(book.symbol.c_str())] = engine.get();
+            book_hosts_[Symbol(book.symbol.c_str())] = engine.get();
+            ++hosted;
+        }
+        if (hosted < books.size()) {
+            rebalance_engines_.push_back(engine.get());
+            LOG_INFO("Matching engine {} created ({} books, {} vacant slots)", engine->name(), hosted,
+                     books.size() - hosted);
+        } else {
+            LOG_INFO("Matching engine {} created ({} books)", engine->name(), books.size());
+        }
+        engines_.push_back(std::move(engine));
+    };
 
-        LOG_INFO("Matching engine created for {}", sym_config.symbol);
+    const std::vector<int> cores = parse_core_list(config_->performance.engine_shard_cores);
+    for (const EngineLayout& layout : engine_layout(*config_)) {
+        if (layout.shard < 0) {
+            const BookSpec& spec = layout.books.front();
+            add_engine(std::make_unique<MatchingEngine>(spec.symbol, *order_pool_, spec.options,
+                                                        input_lanes),
+                       layout.books);
+            continue;
+        }
+        auto engine = std::make_unique<MatchingEngine>(layout.name, layout.books, *order_pool_, input_lanes);
+        if (static_cast<size_t>(layout.shard) < cores.size()) {
+            engine->set_thread_placement(thread_placement(cores[layout.shard]));
+        }
+        add_engine(std::move(engine), layout.books);
+    }
+    if (config_->performance.rebalance_interval_ms > 0 && rebalance_engines_.empty()) {
+        LOG_WARN("rebalance_interval_ms needs two engine shards and no event log or replication: "
+                 "books stay where they are");
     }
 }
 
 void Exchange::initialize_risk_manager() {
-    risk_manager_ = std::make_unique<RiskManager>(
-        config_->risk, config_->symbols);
+    const auto& perf = config_->performance;
+    const size_t shards = std::clamp<uint32_t>(perf.risk_shards, 1, UINT16_MAX);
+    const IdlePolicy idle_policy = parse_idle_policy_key("risk_idle_policy", perf.risk_idle_policy);
+    const std::vector<int> cores = parse_core_list(perf.risk_shard_cores);
+    client_directory_ = std::make_unique<ClientDirectory>(perf.max_clients);
+    instrument_directory_ = std::make_unique<InstrumentDirectory>(config_->symbols);
+    reference_prices_ = std::make_unique<ReferencePriceTable>(config_->symbols);
+    bbo_table_ = std::make_unique<BBOTable>(config_->symbols);
+
+    // Gateway reactor i submits on lane i, so every reactor needs its own
+    const size_t lanes = std::max<size_t>(perf.risk_ingress_lanes, ingress_reactors());
+
+    // Each shard sees only its clients' orders; the pool bounds them all
+    for (size_t i = 0; i < shards; ++i) {
+        auto shard = std::make_unique<RiskManager>(
+            config_->risk, config_->symbols, order_pool_->max_capacity(), lanes);
+        shard->set_engine_lane(static_cast<IngressLane>(i));
+        shard->set_client_directory(client_directory_.get());
+        shard->set_instrument_directory(instrument_directory_.get());
+        shard->set_reference_prices(reference_prices_.get());
+        shard->set_idle_policy(idle_policy);
+        if (i < cores.size()) {
+            shard->set_thread_placement(thread_placement(cores[i]));
+        } else if (i == 0) {
+            shard->set_thread_placement(thread_placement(perf.risk_manager_core));
+        }
+        risk_shards_.push_back(std::move(shard));
+    }
+    if (shards > 1) LOG_INFO("Risk manager sharded by client: {} shards", shards);
+}
+
+ThreadPlacement Exchange::thread_placement(int32_t core) const {
+    const auto& perf = config_->performance;
+    if (!perf.enable_cpu_pinning || core < 0) return ThreadPlacement{};
+    return ThreadPlacement{core, static_cast<int32_t>(perf.realtime_priority)};
 }
 
 void Exchange::wire_components() {
-    // Wire matching engines to market data queue
-    for (auto& [symbol, engine] : matching_engines_) {
-        engine->set_market_data_queue(market_data_queue_.get());
+    // Wire each book to the publisher serving its market data channel,
+    // through one SPSC lane per (engine, publisher) pair
+    const size_t lane_capacity = config_->performance.market_data_queue_size;
+    std::unordered_map<const MatchingEngine*, std::vector<MarketDataLane*>> engine_lanes;
+    auto lane_for = [&](const MatchingEngine* engine, size_t publisher) {
+        auto& lanes = engine_lanes[engine];
+        if (lanes.empty()) lanes.resize(publisher_lanes_.size(), nullptr);
+        if (!lanes[publisher]) {
+            market_data_lanes_.push_back(std::make_unique<MarketDataLane>(lane_capacity));
+            lanes[publisher] = market_data_lanes_.back().get();
+            publisher_lanes_[publisher].push_back(lanes[publisher]);
+        }
+        return lanes[publisher];
+    };
+    for (const auto& sym_config : config_->symbols) {
+        size_t channel = sym_config.md_channel;
+        if (channel >= market_data_channels_.size()) {
+            LOG_WARN("Symbol {}: md_channel {} not configured — using channel 0",
+                     sym_config.symbol, channel);
+            channel = 0;
+        }
+        // Its engine, and with rebalancing every engine with a slot the book may move into
+        const Symbol symbol(sym_config.symbol.c_str());
+        std::vector<MatchingEngine*> slots;
+        for (auto& engine : engines_) {
+            if (engine->book_index(symbol) != NO_BOOK) slots.push_back(engine.get());
+        }
+        if (slots.empty()) continue;
+        const size_t publisher = market_data_channels_[channel].publisher;
+        for (MatchingEngine* engine : slots) {
+            engine->set_market_data_route(engine->book_index(symbol), static_cast<uint8_t>(channel),
+                                          lane_for(engine, publisher), market_data_idles_[publisher].get());
+        }
+
+        // Market by order: its own channel, so depth subscribers never see it
+        if (sym_config.order_feed_channel < 0) continue;
+        const size_t feed = static_cast<size_t>(sym_config.order_feed_channel);
+        if (feed >= market_data_channels_.size()) {
+            LOG_WARN("Symbol {}: order_feed_channel {} not configured — order feed off",
+                     sym_config.symbol, feed);
+            continue;
+        }
+        if (feed == channel) {
+            LOG_WARN("Symbol {}: order_feed_channel {} is also its md_channel", sym_config.symbol, feed);
+        }
+        const size_t feed_publisher = market_data_channels_[feed].publisher;
+        for (MatchingEngine* engine : slots) {
+            engine->set_order_feed_route(engine->book_index(symbol), static_cast<uint8_t>(feed),
+                                         lane_for(engine, feed_publisher),
+                                         market_data_idles_[feed_publisher].get());
+        }
+    }
+    LOG_INFO("Market data lanes: {} x {} slots", market_data_lanes_.size(), lane_capacity);
+
+    // Wire engines and risk shards to one execution report queue per
+    // ingress reactor; each report goes to the reactor owning its session.
+    // The shm poller never blocks, so only the TCP reactors get a doorbell
+    const size_t reactors = gateway_reactors();
+    const size_t report_queues = ingress_reactors();
+    std::vector<EventDoorbell*> bells;
+    for (size_t r = 0; r < reactors; ++r) {
+        execution_doorbells_.push_back(std::make_unique<EventDoorbell>());
+        bells.push_back(execution_doorbells_.back().get());
+    }
+    auto make_producer_queues = [&] {
+        std::vector<SPSCQueue<ExecutionReport>*> queues;
+        for (size_t r = 0; r < report_queues; ++r) {
+            execution_queues_.push_back(
+                std::make_unique<SPSCQueue<ExecutionReport>>(EXECUTION_QUEUE_CAPACITY));
+            queues.push_back(execution_queues_.back().get());
+        }
+        return queues;
+    };
+    for (auto& engine : engines_) engine->set_execution_queues(make_producer_queues(), bells);
+    for (auto& shard : risk_shards_) shard->set_execution_queues(make_producer_queues(), bells);
+
+    // Engine → risk shard feedback: one ring per (engine, shard) pair
+    const size_t shards = risk_shards_.size();
+    std::vector<std::vector<SPSCQueue<RiskFeedback>*>> shard_rings(shards);
+    for (auto& engine : engines_) {
+        std::vector<SPSCQueue<RiskFeedback>*> engine_rings;
+        for (size_t s = 0; s < shards; ++s) {
+            risk_feedback_rings_.push_back(
+                std::make_unique<SPSCQueue<RiskFeedback>>(RISK_FEEDBACK_CAPACITY));
+            engine_rings.push_back(risk_feedback_rings_.back().get());
+            shard_rings[s].push_back(risk_feedback_rings_.back().get());
+        }
+        engine->set_risk_feedback(std::move(engine_rings));
+        engine->set_reference_prices(*reference_prices_);
+        engine->set_bbo_table(*bbo_table_);
+    }
+    for (size_t s = 0; s < shards; ++s) {
+        risk_shards_[s]->set_feedback_rings(std::move(shard_rings[s]));
+    }
+
+    // The same routes by instrument id, for callers holding ids instead of symbols
+    const auto& instruments = instrument_directory_->symbols();
+    instrument_engines_.assign(instruments.size(), nullptr);
+    for (size_t id = 0; id < instruments.size(); ++id) {
+        auto it = matching_engines_.find(instruments[id]);
+        if (it != matching_engines_.end()) instrument_engines_[id] = it->second;
+    }
+
+    // Wire every risk shard to every matching engine (route = engine + book index)
+    for (auto& shard : risk_shards_) {
+        for (auto& [symbol, engine] : matching_engines_) {
+            shard->add_matching_engine(std::string(symbol.c_str()), engine);
+        }
+    }
+
+    // Opt-in queue telemetry: every lane is built by now, and no thread runs yet
+    if (const size_t sample = config_->performance.queue_telemetry_sample) {
+        for (auto& engine : engines_) engine->enable_queue_telemetry(sample);
+        for (auto& shard : risk_shards_) shard->enable_queue_telemetry(sample);
+        for (auto& lane : market_data_lanes_) lane->enable_telemetry(sample);
+        LOG_INFO("Queue telemetry: sampling 1 in {} positions", sample);
+    }
+
+    // One stats block per hot thread; readers never call into the thread again
+    const std::string& stats_shm = config_->performance.stats_shm_name;
+    const size_t stat_blocks = engines_.size() + risk_shards_.size();
+    stats_region_ = StatsRegion::create(stat_blocks, stats_shm);
+    if (!stats_region_ && !stats_shm.empty()) {
+        LOG_WARN("Stats region {} unavailable: keeping counters in-process", stats_shm);
+        stats_region_ = StatsRegion::create(stat_blocks);
+    }
+    if (stats_region_) {
+        for (auto& engine : engines_) {
+            engine->set_stats_block(stats_region_->add(engine->name(), StatsKind::ENGINE));
+        }
+        for (size_t i = 0; i < risk_shards_.size(); ++i) {
+            risk_shards_[i]->set_stats_block(stats_region_->add(risk_thread_name(i), StatsKind::RISK));
+        }
+        if (!stats_shm.empty() && !stats_region_->shm_name().empty()) {
+            LOG_INFO("Stats region: {} blocks in /dev/shm/{}", stat_blocks, stats_shm);
+        }
     }
 
-    // Wire risk manager to matching engines
-    for (auto& [symbol, engine] : matching_engines_) {
-        risk_manager_->add_matching_engine(
-            std::string(symbol.c_str()), engine.get());
+    // Opt-in order lifecycle tracing: the gateway's sinks exist from construction
+    if (const uint32_t sample = config_->performance.order_trace_sample) {
+        order_tracer_ = std::make_unique<OrderTracer>(*order_pool_, sample, reactors);
+        for (auto& engine : engines_) engine->set_order_tracer(order_tracer_.get());
+        for (auto& shard : risk_shards_) shard->set_order_tracer(order_tracer_.get());
+
+        // One OTLP/JSON request per line, written by the aggregator thread
+        if (const std::string& path = config_->performance.order_trace_otlp_file; !path.empty()) {
+            auto file = std::make_shared<std::ofstream>(path, std::ios::app);
+            if (*file) {
+                order_tracer_->set_span_exporter([file](const TraceSpan* spans, size_t count) {
+                    *file << spans_to_otlp_json(spans, count) << '\n';
+                    file->flush();
+                });
+                LOG_INFO("Order trace spans → {}", path);
+            } else {
+                LOG_WARN("Cannot open order_trace_otlp_file {}: spans not exported", path);
+            }
+        }
+    }
+
+    // Write-ahead journal: one lane per engine, written by a thread of its own
+    std::vector<JournalLane*> journal_lanes;
+    if (const auto& persistence = config_->persistence; persistence.enable_event_log) {
+        const std::string directory = persistence.log_directory.empty() ? "." : persistence.log_directory;
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        const auto unix_seconds = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+        JournalOptions options;
+        options.sync          = parse_journal_sync(persistence.journal_sync);
+        options.sync_interval = std::chrono::milliseconds(persistence.journal_sync_ms);
+        options.direct_io     = persistence.journal_direct_io;
+        options.lane_capacity = persistence.journal_lane_capacity;
+        options.segment_bytes = static_cast<size_t>(persistence.journal_segment_mb) << 20;
+        // The pid keeps two exchanges started in the same second apart; start() refuses to overwrite
+        event_journal_ = std::make_unique<EventJournal>(
+            directory + "/events-" + std::to_string(unix_seconds) + "-" + std::to_string(::getpid()) + ".journal",
+            options);
+        for (auto& engine : engines_) {
+            journal_lanes.push_back(event_journal_->add_engine(engine->name()));
+            engine->set_event_journal(journal_lanes.back());
+        }
+
+        // Snapshots are only useful with the journal their sequence refers to
+        if (persistence.snapshot_interval_ms > 0) {
+            book_snapshots_ = std::make_unique<BookSnapshotWriter>(directory, event_journal_->path(),
+                                                                   event_journal_->run_id());
+            for (auto& engine : engines_) {
+                engine->set_book_snapshots(book_snapshots_->add_engine(engine->name()),
+                                           std::chrono::milliseconds(persistence.snapshot_interval_ms));
+            }
+        }
+    }
+
+    // Replication ships the journaled requests: without the journal there is nothing to send
+    if (const auto& replication = config_->replication; replication.role != "none") {
+        if (!event_journal_) {
+            LOG_WARN("replication.role {} needs persistence.enable_event_log: replication disabled",
+                     replication.role);
+        } else if (replication.role == "primary") {
+            replication_primary_ = std::make_unique<ReplicationPrimary>(
+                replication.peer, replication.secret, parse_replication_mode(replication.mode),
+                static_cast<size_t>(replication.max_backlog_mb) << 20);
+            event_journal_->set_replicator(replication_primary_.get());
+            for (size_t i = 0; i < engines_.size(); ++i) {
+                replication_primary_->add_engine(engines_[i].get());
+                if (replication_primary_->mode() == ReplicationMode::SYNC) {
+                    engines_[i]->set_replication_gate(replication_primary_->acked(i));
+                }
+            }
+        } else if (replication.role == "standby") {
+            std::vector<MatchingEngine*> engines;
+            for (auto& engine : engines_) engines.push_back(engine.get());
+            replication_standby_ = std::make_unique<ReplicationStandby>(
+                replication.bind_address, replication.port, replication.secret,
+                std::move(engines), std::move(journal_lanes),
+                std::chrono::milliseconds(replication.promote_after_ms));
+        } else {
+            LOG_WARN("Unknown replication.role {}: replication disabled", replication.role);
+        }
     }
 
     LOG_INFO("Components wired: {} engines → market data queue, "
-             "risk manager → {} engines",
-             matching_engines_.size(), matching_engines_.size());
+             "{} risk shard(s) → {} symbols, {} execution report queues "
+             "({} per gateway reactor)",
+             engines_.size(), risk_shards_.size(), matching_engines_.size(),
+             execution_queues_.size(), execution_queues_.size() / reactors);
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -147,23 +873,23 @@ ExchangeHealth Exchange::get_health() const {
     health.state = state_;
     health.overall_healthy = (state_ == ExchangeState::RUNNING);
 
-    // Risk manager health
-    if (risk_manager_) {
-        auto stats = risk_manager_->get_stats();
+    // Risk shard health
+    for (size_t i = 0; i < risk_shards_.size(); ++i) {
+        auto stats = risk_shards_[i]->get_stats();
         health.components.push_back({
-            .name = "risk_manager",
+            .name = risk_thread_name(i),
             .healthy = (state_ == ExchangeState::RUNNING),
             .detail = "processed=" + std::to_string(stats.processed),
         });
     }
 
     // Per-engine health
-    for (const auto& [symbol, engine] : matching_engines_) {
+    for (const auto& engine : engines_) {
         bool engine_healthy = engine->is_running();
         auto stats = engine->get_stats();
 
         health.components.push_back({
-            .name = "matching_engine_" + std::string(symbol.c_str()),
+            .name = "matching_engine_" + engine->name(),
             .healthy = engine_healthy,
             .detail = "orders=" + std::to_string(stats.orders_accepted) +
                       " trades=" + std::to_string(stats.trades_executed),
@@ -183,7 +909,8 @@ ExchangeHealth Exchange::get_health() const {
             .name = "order_pool",
             .healthy = pool_healthy,
             .detail = "utilization=" +
-                      std::to_string(pool_stats.utilization * 100) + "%",
+                      std::to_string(pool_stats.utilization * 100) + "% pages=" +
+                      page_backing_name(pool_stats.pages),
         });
 
         if (!pool_healthy) {
@@ -197,33 +924,57 @@ ExchangeHealth Exchange::get_health() const {
 ExchangeStats Exchange::get_stats() const {
     ExchangeStats stats;
 
-    // Aggregate risk manager stats
-    if (risk_manager_) {
-        auto risk_stats = risk_manager_->get_stats();
-        stats.total_orders_processed = risk_stats.processed;
-        stats.total_orders_approved  = risk_stats.approved;
-        stats.total_orders_rejected  = risk_stats.rejected;
-        stats.total_cancels =
-            risk_stats.cancels_accepted + risk_stats.cancels_rejected;
+    // Thread counters from the stats region: engine blocks, then risk shard blocks
+    const std::vector<StatsSample> samples =
+        stats_region_ ? stats_region_->snapshot() : std::vector<StatsSample>{};
+    auto counters = [&](size_t block) -> const uint64_t* {
+        static constexpr uint64_t none[STATS_COUNTERS]{};
+        return block < samples.size() ? samples[block].counters.values : none;
+    };
+
+    // Aggregate risk shard stats
+    for (size_t i = 0; i < risk_shards_.size(); ++i) {
+        const uint64_t* risk = counters(engines_.size() + i);
+        stats.total_orders_processed += risk[RISK_PROCESSED];
+        stats.total_orders_approved  += risk[RISK_APPROVED];
+        stats.total_orders_rejected  += risk[RISK_REJECTED];
+        stats.total_cancels += risk[RISK_CANCELS_ACCEPTED] + risk[RISK_CANCELS_REJECTED];
+        for (const auto& lane : risk_shards_[i]->lane_stats()) stats.risk_lanes.push_back(lane);
     }
 
     // Aggregate matching engine stats
-    for (const auto& [symbol, engine] : matching_engines_) {
-        auto eng_stats = engine->get_stats();
+    for (size_t i = 0; i < engines_.size(); ++i) {
+        const auto& engine = engines_[i];
+        const uint64_t* eng = counters(i);
+
+        stats.total_trades_executed  += eng[ENGINE_TRADES];
+        stats.market_data_drops      += eng[ENGINE_MD_DROPS];
+        stats.execution_report_drops += eng[ENGINE_EXEC_DROPS];
+        stats.risk_feedback_drops    += eng[ENGINE_FEEDBACK_DROPS];
 
-        stats.total_trades_executed += eng_stats.trades_executed;
-        stats.market_data_drops    += eng_stats.md_drops;
+        auto lanes = engine->lane_stats();
+        uint64_t input_drops = 0;  // Counted by the producers, not the engine thread
+        for (const auto& lane : lanes) input_drops += lane.drops;
 
         stats.engines.push_back({
-            .symbol           = symbol,
-            .orders_processed = eng_stats.orders_accepted,
-            .trades_executed  = eng_stats.trades_executed,
+            .name             = engine->name(),
+            .books            = engine->book_count(),
+            .orders_processed = eng[ENGINE_ORDERS_ACCEPTED],
+            .trades_executed  = eng[ENGINE_TRADES],
+            .input_drops      = input_drops,
+            .lanes            = std::move(lanes),
+            .schedule         = engine->schedule_stats(),
         });
     }
 
-    // Market data queue stats
-    if (market_data_queue_) {
-        stats.market_data_queue_depth = market_data_queue_->size_approx();
+    // Market data lane stats
+    for (const auto& lane : market_data_lanes_) {
+        stats.market_data_queue_depth += lane->size();
+        stats.market_data_lanes.push_back({
+            .depth     = lane->size(),
+            .capacity  = lane->capacity(),
+            .telemetry = lane->telemetry(),
+        });
     }
 
     // Order pool stats
@@ -233,6 +984,46 @@ ExchangeStats Exchange::get_stats() const {
         stats.order_pool_allocated   = pool_stats.allocated;
         stats.order_pool_high_water  = pool_stats.high_water_mark;
         stats.order_pool_utilization = pool_stats.utilization;
+        stats.order_pool_pages       = pool_stats.pages;
+        stats.order_pool_nodes       = order_pool_->initial_segments();
+        stats.order_pool_segments    = order_pool_->segments();
+        stats.order_pool_parked      = order_pool_->parked();
+    }
+
+    // Hot-thread placement (what each thread actually got) and idle behaviour
+    for (size_t i = 0; i < risk_shards_.size(); ++i) {
+        stats.threads.push_back({risk_thread_name(i), risk_shards_[i]->applied_placement(),
+                                 risk_shards_[i]->idle_stats()});
+    }
+    for (const auto& engine : engines_) {
+        stats.threads.push_back({"matching_engine_" + engine->name(), engine->applied_placement(),
+                                 engine->idle_stats()});
+    }
+    for (const auto& thread : external_threads_) {
+        stats.threads.push_back({thread.name, thread.applied(),
+                                 thread.idle ? thread.idle() : IdleStats{}});
+    }
+    stats.memory_locked = memory_locked_;
+
+    if (event_journal_) {
+        stats.journal_records = event_journal_->records_written();
+        stats.journal_drops   = event_journal_->drops();
+        stats.journal_bytes   = event_journal_->bytes_written();
+        stats.journal_syncs   = event_journal_->syncs();
+    }
+    if (book_snapshots_) {
+        stats.snapshots_written = book_snapshots_->snapshots_written();
+        stats.snapshots_skipped = book_snapshots_->snapshots_skipped();
+    }
+    if (replication_primary_) {
+        stats.replication_connected = replication_primary_->connected();
+        stats.replication_frames    = replication_primary_->frames_sent();
+        stats.replication_requests  = replication_primary_->records_sent();
+        stats.replication_backlog   = replication_primary_->backlog();
+    } else if (replication_standby_) {
+        stats.replication_connected = replication_standby_->connected();
+        stats.replication_frames    = replication_standby_->frames_applied();
+        stats.replication_requests  = replication_standby_->requests_applied();
     }
 
     return stats;
@@ -1,32 +1,109 @@
 /**
  * @file http_server.cpp
- * @brief Simple HTTP server for metrics and health checks
- * 
+ * @brief Non-blocking HTTP server for metrics and health checks
+ *
  * Provides:
- * - Prometheus metrics endpoint (/metrics)
+ * - Prometheus metrics endpoint (/metrics), optionally cached
  * - Health check endpoint (/health)
  * - Custom handler registration
- * 
+ * - Keep-alive and pipelined requests on concurrent connections
+ * - Server-Sent Event streams of shared snapshots and deltas
+ *
  * Security features:
+ * - Admin endpoints: POST with a bearer token allowed the operation
  * - Path traversal protection
  * - Request size limits
+ * - Connection limit and idle timeout
  * - Input validation
- * 
- * Note: Single-threaded blocking server, suitable for low-traffic
- * metrics collection. For production, consider async I/O.
  */
 
 #include "rtes/http_server.hpp"
+#include "rtes/auth_middleware.hpp"
 #include "rtes/logger.hpp"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
 #include <sstream>
 #include <cstring>
 
 namespace rtes {
 
+namespace {
+
+constexpr int  HTTP_EPOLL_EVENTS  = 64;
+constexpr int  HTTP_EPOLL_WAIT_MS = 100;  // Bounds stop() latency and the idle sweep period
+constexpr auto HTTP_REFRESH_POLL  = std::chrono::milliseconds(50);
+
+/** Case-insensitive search for a header line "name: ...value..." in the header block */
+bool header_contains(const std::string& headers, std::string_view name, std::string_view value) {
+    auto lower = [](std::string_view s) {
+        std::string out(s);
+        std::transform(out.begin(), out.end(), out.begin(), [](unsigned char c) { return std::tolower(c); });
+        return out;
+    };
+    const std::string text = lower(headers);
+    const std::string key  = "\r\n" + lower(name) + ":";
+    const size_t at = text.find(key);
+    if (at == std::string::npos) return false;
+    const size_t end = text.find("\r\n", at + key.size());
+    return text.substr(at + key.size(), end - at - key.size()).find(lower(value)) != std::string::npos;
+}
+
+/** The value of header `name` (case-insensitive), trimmed; empty if absent */
+std::string header_value(const std::string& headers, std::string_view name) {
+    std::string text = headers;
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+    std::string key = "\r\n";
+    key += name;
+    key += ':';
+    std::transform(key.begin(), key.end(), key.begin(), [](unsigned char c) { return std::tolower(c); });
+    const size_t at = text.find(key);
+    if (at == std::string::npos) return {};
+    size_t begin = at + key.size();
+    size_t end = headers.find("\r\n", begin);
+    while (begin < end && headers[begin] == ' ') ++begin;
+    while (end > begin && headers[end - 1] == ' ') --end;
+    return headers.substr(begin, end - begin);
+}
+
+size_t content_length(const std::string& headers) {
+    static const std::string key = "\r\ncontent-length:";
+    std::string text = headers;
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+    const size_t at = text.find(key);
+    if (at == std::string::npos) return 0;
+    return static_cast<size_t>(std::strtoull(text.c_str() + at + key.size(), nullptr, 10));
+}
+
+void append_json_string(std::string& out, std::string_view text) {
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    out += '"';
+}
+
+void append_json_field(std::string& out, const std::string& name, std::string_view value) {
+    if (out.back() != '{') out += ',';
+    append_json_string(out, name);
+    out += ':';
+    out += value;
+}
+
+/** One SSE event; the JSON object has no newline, so it fits one data: line */
+std::string sse_event(const char* event, uint64_t id, const std::string& json) {
+    return std::string("event: ") + event + "\nid: " + std::to_string(id) + "\ndata: " + json + "\n\n";
+}
+
+} // namespace
+
 HttpServer::HttpServer(uint16_t port) : port_(port) {
 }
 
@@ -36,32 +113,51 @@ HttpServer::~HttpServer() {
 
 void HttpServer::start() {
     if (running_.load()) return;
-    
+
     if (!setup_listen_socket()) {
         LOG_ERROR("Failed to setup HTTP server socket");
+        if (listen_fd_ >= 0) close(listen_fd_);
+        listen_fd_ = -1;
         return;
     }
-    
+
+    refresh_cached(true);  // Nothing is ever served unrendered
     running_.store(true);
     server_thread_ = std::thread(&HttpServer::server_loop, this);
-    
+    if (!cached_.empty() || !streams_.empty()) refresh_thread_ = std::thread(&HttpServer::refresh_loop, this);
+
     LOG_INFO("HTTP server started on port {}", port_);
 }
 
 void HttpServer::stop() {
     if (!running_.load()) return;
-    
+
     running_.store(false);
-    
+
     if (server_thread_.joinable()) {
         server_thread_.join();
     }
-    
+    if (refresh_thread_.joinable()) {
+        refresh_thread_.join();
+    }
+
+    std::vector<int> open;
+    for (const auto& [fd, conn] : connections_) open.push_back(fd);
+    for (int fd : open) close_connection(fd);
+
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+        epoll_fd_ = -1;
+    }
+    if (wake_fd_ >= 0) {
+        close(wake_fd_);
+        wake_fd_ = -1;
+    }
     if (listen_fd_ >= 0) {
         close(listen_fd_);
         listen_fd_ = -1;
     }
-    
+
     LOG_INFO("HTTP server stopped");
 }
 
@@ -69,129 +165,514 @@ void HttpServer::add_handler(const std::string& path, HttpHandler handler) {
     handlers_[path] = handler;
 }
 
+void HttpServer::add_admin_handler(const std::string& path, HttpHandler handler, std::string operation) {
+    admin_handlers_[path] = {std::move(handler), std::move(operation)};
+}
+
+void HttpServer::add_cached_handler(const std::string& path, HttpHandler handler,
+                                    std::chrono::milliseconds refresh) {
+    CachedHandler cached;
+    cached.handler = std::move(handler);
+    cached.refresh = std::max(refresh, std::chrono::milliseconds(1));
+    cached_[path] = std::move(cached);
+}
+
+void HttpServer::add_event_stream(const std::string& path, HttpEventSource source,
+                                  std::chrono::milliseconds interval) {
+    EventStream& stream = streams_[path];
+    stream.source   = std::move(source);
+    stream.interval = std::max(interval, std::chrono::milliseconds(1));
+}
+
 bool HttpServer::setup_listen_socket() {
-    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (listen_fd_ < 0) {
         return false;
     }
-    
+
     int opt = 1;
     setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-    
+
     struct sockaddr_in addr{};
     addr.sin_family = AF_INET;
     addr.sin_addr.s_addr = INADDR_ANY;
     addr.sin_port = htons(port_);
-    
+
     if (bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
         return false;
     }
-    
-    // Non-blocking so server_loop can check running_ flag
-    int flags = fcntl(listen_fd_, F_GETFL, 0);
-    fcntl(listen_fd_, F_SETFL, flags | O_NONBLOCK);
-    
-    if (listen(listen_fd_, 10) < 0) {
+
+    if (listen(listen_fd_, SOMAXCONN) < 0) {
         return false;
     }
-    
-    return true;
+
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        return false;
+    }
+    struct epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = listen_fd_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &ev) < 0) {
+        return false;
+    }
+
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        return false;
+    }
+    ev.data.fd = wake_fd_;
+    return epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev) == 0;
 }
 
 void HttpServer::server_loop() {
+    apply_thread_placement(placement_, "rtes-http");
+
+    struct epoll_event events[HTTP_EPOLL_EVENTS];
+    auto next_sweep = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
     while (running_.load()) {
-        struct sockaddr_in client_addr{};
-        socklen_t addr_len = sizeof(client_addr);
-        
-        int client_fd = accept(listen_fd_, reinterpret_cast<struct sockaddr*>(&client_addr), &addr_len);
-        if (client_fd >= 0) {
-            handle_client(client_fd);
-            close(client_fd);
-        } else {
-            // EAGAIN/EWOULDBLOCK = no connection yet, sleep briefly and retry
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        const int n = epoll_wait(epoll_fd_, events, HTTP_EPOLL_EVENTS, HTTP_EPOLL_WAIT_MS);
+        for (int i = 0; i < n; ++i) {
+            const int fd = events[i].data.fd;
+            if (fd == listen_fd_) {
+                accept_connections();
+                continue;
+            }
+            if (fd == wake_fd_) {
+                uint64_t ticks;
+                while (read(wake_fd_, &ticks, sizeof(ticks)) > 0) {}
+                publish_stream_ticks();
+                continue;
+            }
+            auto it = connections_.find(fd);
+            if (it == connections_.end()) continue;
+            Connection& conn = it->second;
+
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                close_connection(fd);
+                continue;
+            }
+            if ((events[i].events & EPOLLOUT) && !flush(conn)) continue;
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP)) on_readable(conn);
         }
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= next_sweep) {
+            close_idle_connections();
+            next_sweep = now + std::chrono::seconds(1);
+        }
+    }
+}
+
+void HttpServer::accept_connections() {
+    while (true) {
+        const int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            return;  // EAGAIN: backlog drained (or a transient error: retried next wakeup)
+        }
+        if (connections_.size() >= HTTP_MAX_CONNECTIONS) {
+            LOG_WARN("HTTP connection limit ({}) reached, refusing client", HTTP_MAX_CONNECTIONS);
+            close(fd);
+            continue;
+        }
+
+        struct epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.fd = fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            close(fd);
+            continue;
+        }
+
+        Connection& conn = connections_[fd];
+        conn.fd = fd;
+        conn.last_active = std::chrono::steady_clock::now();
+        connections_accepted_.fetch_add(1);
+        connections_open_.store(connections_.size());
     }
 }
 
+void HttpServer::on_readable(Connection& conn) {
+    const int fd = conn.fd;
+    char buffer[4096];
+    bool peer_closed = false;
+
+    while (true) {
+        const ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            conn.in.append(buffer, static_cast<size_t>(received));
+            conn.last_active = std::chrono::steady_clock::now();
+            // Answer pipelined requests as they arrive: what stays in `in`
+            // is then one partial request
+            process_requests(conn);
+            if (conn.close_after) break;
+            // Security: bound what a client can make us buffer, both ways
+            if (conn.in.size() > HTTP_MAX_REQUEST_BYTES) {
+                LOG_WARN("HTTP request too large, closing connection");
+                conn.out += create_response(431, "text/plain", "Request Header Fields Too Large");
+                conn.close_after = true;
+                conn.in.clear();
+                flush(conn);
+                return;
+            }
+            if (conn.out.size() - conn.out_sent > HTTP_MAX_PENDING_OUTPUT) {
+                if (!flush(conn)) return;
+                if (conn.out.size() - conn.out_sent > HTTP_MAX_PENDING_OUTPUT) {
+                    LOG_WARN("HTTP client not reading its responses, closing connection");
+                    close_connection(fd);
+                    return;
+                }
+            }
+            continue;
+        }
+        if (received == 0) {
+            peer_closed = true;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            close_connection(fd);
+            return;
+        }
+        break;
+    }
+
+    process_requests(conn);
+    if (peer_closed) conn.close_after = true;
+    flush(conn);
+}
+
 /**
- * @brief Handle HTTP client request
- * @param client_fd Client socket file descriptor
- * 
+ * @brief Answer every complete request in the connection's input buffer
+ *
  * Processing:
- * 1. Receive request (with size limit)
- * 2. Parse request line (method, path, version)
- * 3. Validate path (prevent directory traversal)
- * 4. Find and invoke handler
- * 5. Send response
- * 6. Close connection
- * 
+ * 1. Split off one request (headers up to a blank line, plus a
+ *    Content-Length body, which is read and ignored)
+ * 2. Build the response and queue it on the connection
+ * 3. Stop after a request that ends the connection
+ */
+void HttpServer::process_requests(Connection& conn) {
+    while (!conn.close_after) {
+        if (conn.stream) {
+            conn.in.clear();  // A subscriber only listens
+            return;
+        }
+        const size_t header_end = conn.in.find("\r\n\r\n");
+        if (header_end == std::string::npos) return;
+        const std::string headers = conn.in.substr(0, header_end + 2);
+        const size_t length = header_end + 4 + content_length(headers);
+        if (length > HTTP_MAX_REQUEST_BYTES) {
+            conn.out += create_response(413, "text/plain", "Payload Too Large");
+            conn.close_after = true;
+            return;
+        }
+        if (conn.in.size() < length) return;  // Body still arriving
+
+        bool keep_alive = true;
+        conn.out += respond(conn, headers, keep_alive);
+        conn.in.erase(0, length);
+        if (!keep_alive) conn.close_after = true;
+    }
+}
+
+/**
+ * @brief Build the response to one request
+ * @param conn Connection the request arrived on (subscribed if it asks for a stream)
+ * @param request Request line and headers
+ * @param keep_alive Out: whether the connection stays open afterwards
+ *
  * Security:
- * - Request size limited to 4KB
  * - Path traversal protection (checks for ".." and "//")
  * - Exception handling for handler errors
  */
-void HttpServer::handle_client(int client_fd) {
-    char buffer[4096];
-    ssize_t received = recv(client_fd, buffer, sizeof(buffer) - 1, 0);
-    
-    // Check for receive errors or empty request
-    if (received <= 0) return;
-    
-    // Truncate if request too large (security: prevent buffer overflow)
-    if (received >= static_cast<ssize_t>(sizeof(buffer))) {
-        LOG_WARN("HTTP request too large, truncating");
-        received = sizeof(buffer) - 1;
-    }
-    
-    buffer[received] = '\0';
-    std::string request(buffer, received);
-    
-    // Parse request line (first line before \r\n)
-    size_t line_end = request.find("\r\n");
-    if (line_end == std::string::npos || line_end > 8192) {
-        LOG_WARN("Invalid HTTP request format");
-        return;
+std::string HttpServer::respond(Connection& conn, const std::string& request, bool& keep_alive) {
+    const size_t line_end = request.find("\r\n");
+    const std::string request_line = request.substr(0, line_end);
+
+    // HTTP/1.1 keeps the connection unless told otherwise; HTTP/1.0 closes unless asked
+    if (request_line.ends_with("HTTP/1.1")) {
+        keep_alive = !header_contains(request, "connection", "close");
+    } else {
+        keep_alive = header_contains(request, "connection", "keep-alive");
     }
-    
-    std::string request_line = request.substr(0, line_end);
+
     std::string path = parse_request_path(request_line);
-    
+    std::string query;
+    if (const size_t start = request_line.find(' '); start != std::string::npos) {
+        const size_t q = request_line.find('?', start);
+        const size_t end = request_line.find(' ', start + 1);
+        if (q != std::string::npos && q < end) query = request_line.substr(q + 1, end - q - 1);
+    }
+
     // Security: Validate path to prevent directory traversal attacks
     if (path.find("..") != std::string::npos || path.find("//") != std::string::npos) {
         LOG_WARN_SAFE("Potential path traversal attempt: {}", path);
-        std::string response = create_response(400, "text/plain", "Bad Request");
-        send(client_fd, response.c_str(), response.length(), 0);
-        return;
+        keep_alive = false;
+        return create_response(400, "text/plain", "Bad Request");
+    }
+
+    requests_served_.fetch_add(1);
+
+    // Security: endpoints that change state need POST and an authorized token
+    if (auto admin = admin_handlers_.find(path); admin != admin_handlers_.end()) {
+        if (!request_line.starts_with("POST ")) {
+            return create_response(405, "text/plain", "Method Not Allowed", keep_alive);
+        }
+        const std::string authorization = header_value(request, "authorization");
+        if (!authorization.starts_with("Bearer ") || authorization.size() == 7) {
+            return create_response(401, "text/plain", "Unauthorized", keep_alive);
+        }
+        const AuthGuard guard(authorization.substr(7), admin->second.operation);
+        if (!guard.is_authorized()) return create_response(403, "text/plain", "Forbidden", keep_alive);
+        LOG_INFO_SAFE("HTTP {} by {}", path, guard.context().user_id);
+        try {
+            return create_response(200, "text/plain; charset=utf-8", admin->second.handler(path, query), keep_alive);
+        } catch (const std::exception&) {
+            return create_response(500, "text/plain", "Internal Server Error", keep_alive);
+        }
+    }
+
+    if (auto cached = cached_.find(path); cached != cached_.end()) {
+        std::shared_ptr<const std::string> body;
+        bool failed;
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex_);
+            body   = cached->second.body;
+            failed = cached->second.failed;
+        }
+        if (failed || !body) return create_response(500, "text/plain", "Internal Server Error", keep_alive);
+        return create_response(200, "text/plain; charset=utf-8", *body, keep_alive);
+    }
+
+    if (auto stream = streams_.find(path); stream != streams_.end()) {
+        keep_alive = true;
+        return subscribe(conn, stream->second);
     }
-    
-    std::string response;
-    
-    // Find registered handler for path
+
     auto it = handlers_.find(path);
-    if (it != handlers_.end()) {
+    if (it == handlers_.end()) {
+        return create_response(404, "text/plain", "Not Found", keep_alive);
+    }
+    try {
+        return create_response(200, "text/plain; charset=utf-8", it->second(path, query), keep_alive);
+    } catch (const std::exception& e) {
+        // Handler threw exception, return 500 error
+        return create_response(500, "text/plain", "Internal Server Error", keep_alive);
+    }
+}
+
+bool HttpServer::flush(Connection& conn) {
+    while (conn.out_sent < conn.out.size()) {
+        const ssize_t sent = send(conn.fd, conn.out.data() + conn.out_sent, conn.out.size() - conn.out_sent,
+                                  MSG_NOSIGNAL);
+        if (sent > 0) {
+            conn.out_sent += static_cast<size_t>(sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            watch_writes(conn, true);  // Finish on EPOLLOUT
+            return true;
+        }
+        close_connection(conn.fd);
+        return false;
+    }
+
+    conn.out.clear();
+    conn.out_sent = 0;
+    watch_writes(conn, false);
+    if (conn.close_after) {
+        close_connection(conn.fd);
+        return false;
+    }
+    return true;
+}
+
+void HttpServer::watch_writes(Connection& conn, bool enable) {
+    if (conn.want_write == enable) return;
+    struct epoll_event ev{};
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    if (enable) ev.events |= EPOLLOUT;
+    ev.data.fd = conn.fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn.fd, &ev);
+    conn.want_write = enable;
+}
+
+void HttpServer::close_connection(int fd) {
+    if (auto it = connections_.find(fd); it != connections_.end() && it->second.stream) {
+        EventStream& stream = *it->second.stream;
+        std::erase(stream.subscribers, fd);
+        stream.subscriber_count.store(stream.subscribers.size());
+    }
+    if (epoll_fd_ >= 0) epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections_.erase(fd);
+    connections_open_.store(connections_.size());
+}
+
+void HttpServer::close_idle_connections() {
+    const auto cutoff = std::chrono::steady_clock::now() - HTTP_IDLE_TIMEOUT;
+    std::vector<int> idle;
+    for (const auto& [fd, conn] : connections_) {
+        if (conn.last_active < cutoff) idle.push_back(fd);
+    }
+    for (int fd : idle) close_connection(fd);
+}
+
+void HttpServer::refresh_loop() {
+    apply_thread_placement(placement_, "rtes-http-cache");
+    while (running_.load()) {
+        refresh_cached(false);
+        if (refresh_streams()) {
+            const uint64_t one = 1;
+            [[maybe_unused]] ssize_t written = write(wake_fd_, &one, sizeof(one));
+        }
+        std::this_thread::sleep_for(HTTP_REFRESH_POLL);
+    }
+}
+
+/** Render the cached handlers that are due (all of them if `force`), outside the lock */
+void HttpServer::refresh_cached(bool force) {
+    const auto now = std::chrono::steady_clock::now();
+    for (auto& [path, cached] : cached_) {
+        if (!force && now < cached.next_refresh) continue;
+        cached.next_refresh = now + cached.refresh;
+
+        std::shared_ptr<const std::string> body;
         try {
-            // Invoke handler and create 200 OK response
-            std::string content = it->second(path, "");
-            response = create_response(200, "text/plain; charset=utf-8", content);
+            body = std::make_shared<const std::string>(cached.handler(path, ""));
         } catch (const std::exception& e) {
-            // Handler threw exception, return 500 error
-            response = create_response(500, "text/plain", "Internal Server Error");
+            LOG_WARN_SAFE("Cached HTTP handler {} failed: {}", path, e.what());
         }
-    } else {
-        // No handler found, return 404
-        response = create_response(404, "text/plain", "Not Found");
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        cached.failed = !body;
+        if (body) cached.body = std::move(body);
     }
-    
-    // Send response and increment counter
-    send(client_fd, response.c_str(), response.length(), 0);
-    requests_served_.fetch_add(1);
+}
+
+/**
+ * @brief Sample every due stream that has subscribers
+ *
+ * The source runs once per tick however many subscribers there are; the
+ * snapshot and the delta against the previous sample are rendered here,
+ * off the event thread, and shared.
+ */
+bool HttpServer::refresh_streams() {
+    const auto now = std::chrono::steady_clock::now();
+    bool ticked = false;
+    for (auto& [path, stream] : streams_) {
+        if (stream.subscriber_count.load() == 0 || now < stream.next_tick) continue;
+        stream.next_tick = now + stream.interval;
+
+        HttpEventFields fields;
+        try {
+            fields = stream.source();
+        } catch (const std::exception& e) {
+            LOG_WARN_SAFE("Event stream {} failed: {}", path, e.what());
+            continue;
+        }
+        std::sort(fields.begin(), fields.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        std::string snapshot = "{";
+        for (const auto& [name, value] : fields) append_json_field(snapshot, name, value);
+        snapshot += '}';
+
+        // Merge the two sorted samples: changed or new fields, and null for removed ones
+        std::string delta = "{";
+        auto prev = stream.last.begin();
+        for (const auto& [name, value] : fields) {
+            for (; prev != stream.last.end() && prev->first < name; ++prev) append_json_field(delta, prev->first, "null");
+            if (prev != stream.last.end() && prev->first == name) {
+                if (prev->second != value) append_json_field(delta, name, value);
+                ++prev;
+            } else {
+                append_json_field(delta, name, value);
+            }
+        }
+        for (; prev != stream.last.end(); ++prev) append_json_field(delta, prev->first, "null");
+        delta += '}';
+
+        auto tick = std::make_shared<StreamTick>();
+        tick->seq      = ++stream.seq;
+        tick->snapshot = sse_event("snapshot", tick->seq, snapshot);
+        if (delta.size() > 2) tick->delta = sse_event("delta", tick->seq, delta);
+        stream.last = std::move(fields);
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex_);
+            stream.tick = std::move(tick);
+        }
+        stream_ticks_.fetch_add(1);
+        ticked = true;
+    }
+    return ticked;
+}
+
+/** Event thread: queue each stream's latest tick on its subscribers */
+void HttpServer::publish_stream_ticks() {
+    const auto now = std::chrono::steady_clock::now();
+    for (auto& [path, stream] : streams_) {
+        std::shared_ptr<const StreamTick> tick;
+        {
+            std::lock_guard<std::mutex> lock(cache_mutex_);
+            tick = stream.tick;
+        }
+        if (!tick || tick->seq == stream.delivered) continue;
+        const bool missed = tick->seq != stream.delivered + 1;  // Refresher ran ahead: deltas lost
+        stream.delivered = tick->seq;
+
+        const std::vector<int> subscribers = stream.subscribers;  // flush() may close one
+        for (int fd : subscribers) {
+            auto it = connections_.find(fd);
+            if (it == connections_.end()) continue;
+            Connection& conn = it->second;
+            conn.last_active = now;
+            if (missed) conn.needs_snapshot = true;
+            if (conn.out.size() - conn.out_sent > HTTP_STREAM_MAX_BACKLOG) {
+                conn.needs_snapshot = true;
+                stream_skipped_.fetch_add(1);
+                continue;
+            }
+            if (conn.needs_snapshot) {
+                conn.out += tick->snapshot;
+                conn.needs_snapshot = false;
+            } else if (!tick->delta.empty()) {
+                conn.out += tick->delta;
+            } else {
+                continue;
+            }
+            flush(conn);
+        }
+    }
+}
+
+/** Turn `conn` into a subscriber: headers, then the latest snapshot if there is one */
+std::string HttpServer::subscribe(Connection& conn, EventStream& stream) {
+    conn.stream = &stream;
+    stream.subscribers.push_back(conn.fd);
+    stream.subscriber_count.store(stream.subscribers.size());
+
+    std::string response = "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: text/event-stream\r\n"
+                           "Cache-Control: no-cache\r\n"
+                           "Connection: keep-alive\r\n"
+                           "Access-Control-Allow-Origin: *\r\n"
+                           "\r\n";
+    std::shared_ptr<const StreamTick> tick;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        tick = stream.tick;
+    }
+    conn.needs_snapshot = !tick;
+    if (tick) response += tick->snapshot;
+    return response;
 }
 
 std::string HttpServer::parse_request_path(const std::string& request_line) {
     std::istringstream iss(request_line);
     std::string method, path, version;
-    
+
     if (iss >> method >> path >> version) {
         // Remove query parameters
         size_t query_pos = path.find('?');
@@ -200,29 +681,36 @@ std::string HttpServer::parse_request_path(const std::string& request_line) {
         }
         return path;
     }
-    
+
     return "/";
 }
 
-std::string HttpServer::create_response(int status_code, const std::string& content_type, const std::string& body) {
+std::string HttpServer::create_response(int status_code, const std::string& content_type, const std::string& body,
+                                        bool keep_alive) {
     std::ostringstream response;
-    
+
     std::string status_text;
     switch (status_code) {
         case 200: status_text = "OK"; break;
+        case 400: status_text = "Bad Request"; break;
+        case 401: status_text = "Unauthorized"; break;
+        case 403: status_text = "Forbidden"; break;
         case 404: status_text = "Not Found"; break;
+        case 405: status_text = "Method Not Allowed"; break;
+        case 413: status_text = "Payload Too Large"; break;
+        case 431: status_text = "Request Header Fields Too Large"; break;
         case 500: status_text = "Internal Server Error"; break;
         default: status_text = "Unknown"; break;
     }
-    
+
     response << "HTTP/1.1 " << status_code << " " << status_text << "\r\n";
     response << "Content-Type: " << content_type << "\r\n";
     response << "Content-Length: " << body.length() << "\r\n";
-    response << "Connection: close\r\n";
+    response << "Connection: " << (keep_alive ? "keep-alive" : "close") << "\r\n";
     response << "\r\n";
     response << body;
-    
+
     return response.str();
 }
 
-} // namespace rtes
\ No newline at end of file
+} // namespace rtes
@@ -0,0 +1,219 @@
+/**
+ * @file huge_pages.cpp
+ * @brief Huge-page / THP / heap backed regions for pools and queue buffers
+ */
+
+#include "rtes/huge_pages.hpp"
+#include "rtes/logger.hpp"
+#include "rtes/numa.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#endif
+
+namespace rtes {
+
+namespace {
+
+constexpr size_t REGION_ALIGNMENT = 64;
+
+PagePolicy g_policy;  // Set at startup, before the pools and queues exist
+
+/** Warn once per backing that could not be had */
+std::atomic<bool> g_warned[4];
+
+void warn_fallback(PageBacking wanted, size_t bytes) {
+    if (g_warned[static_cast<size_t>(wanted)].exchange(true, std::memory_order_relaxed)) return;
+    LOG_WARN("{} pages unavailable for a {} byte region ({}), falling back",
+             page_backing_name(wanted), bytes, std::strerror(errno));
+}
+
+size_t round_up(size_t bytes, size_t unit) {
+    return (bytes + unit - 1) & ~(unit - 1);
+}
+
+} // namespace
+
+const char* page_backing_name(PageBacking backing) {
+    switch (backing) {
+        case PageBacking::TRANSPARENT: return "thp";
+        case PageBacking::HUGE_2M:     return "2m";
+        case PageBacking::HUGE_1G:     return "1g";
+        case PageBacking::HEAP:        break;
+    }
+    return "heap";
+}
+
+PageBacking parse_page_backing(std::string_view name) {
+    if (name == "thp") return PageBacking::TRANSPARENT;
+    if (name == "2m")  return PageBacking::HUGE_2M;
+    if (name == "1g")  return PageBacking::HUGE_1G;
+    return PageBacking::HEAP;
+}
+
+void set_page_policy(const PagePolicy& policy) { g_policy = policy; }
+
+PagePolicy page_policy() { return g_policy; }
+
+PageRegion::PageRegion(size_t bytes, int numa_node) {
+    const PagePolicy policy = g_policy;
+    size_ = round_up(bytes == 0 ? 1 : bytes, REGION_ALIGNMENT);
+    PageBacking want = size_ < policy.min_bytes ? PageBacking::HEAP : policy.backing;
+    if (want == PageBacking::HUGE_1G && size_ < HUGE_PAGE_1G / 2) want = PageBacking::HUGE_2M;
+
+#if defined(__linux__)
+    // Bound: map unpopulated, bind, then fault the pages in from the node
+    auto bind = [&](void* addr, size_t length) {
+        if (numa_node < 0) return;
+        if (bind_to_numa_node(addr, length, numa_node)) {
+            numa_node_ = numa_node;
+        } else {
+            LOG_WARN("mbind of a {} byte region to node {} failed: {}", size_, numa_node,
+                     std::strerror(errno));
+        }
+    };
+    const int populate = numa_node < 0 ? MAP_POPULATE : 0;
+
+    // hugetlbfs: pre-faulted from the reserve, zeroed by the kernel
+    for (; want == PageBacking::HUGE_1G || want == PageBacking::HUGE_2M;
+         want = want == PageBacking::HUGE_1G ? PageBacking::HUGE_2M : PageBacking::TRANSPARENT) {
+        const bool gig = want == PageBacking::HUGE_1G;
+        const size_t page = gig ? HUGE_PAGE_1G : HUGE_PAGE_2M;
+        const int size_flag = (gig ? 30 : 21) << MAP_HUGE_SHIFT;
+        const size_t length = round_up(size_, page);
+        void* map = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate | size_flag, -1, 0);
+        if (map != MAP_FAILED) {
+            map_ = data_ = map;
+            map_size_ = length;
+            backing_ = want;
+            if (!populate) {
+                bind(map, length);
+                std::memset(data_, 0, size_);
+            }
+            break;
+        }
+        warn_fallback(want, size_);
+    }
+
+    // THP: 2 MB-aligned so the kernel can back it with huge pages, then touched
+    if (!map_ && want == PageBacking::TRANSPARENT) {
+        const size_t length = round_up(size_, HUGE_PAGE_2M) + HUGE_PAGE_2M;
+        void* map = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (map != MAP_FAILED) {
+            map_ = map;
+            map_size_ = length;
+            data_ = reinterpret_cast<void*>(round_up(reinterpret_cast<uintptr_t>(map), HUGE_PAGE_2M));
+            if (madvise(data_, round_up(size_, HUGE_PAGE_2M), MADV_HUGEPAGE) != 0) {
+                warn_fallback(want, size_);
+            }
+            bind(map, length);
+            std::memset(data_, 0, size_);  // Pre-fault
+            backing_ = PageBacking::TRANSPARENT;
+        } else {
+            warn_fallback(want, size_);
+        }
+    }
+
+    // Bound heap region: page-granular anonymous memory, since mbind cannot split malloc's pages
+    if (!map_ && numa_node >= 0) {
+        const size_t length = round_up(size_, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+        void* map = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (map != MAP_FAILED) {
+            map_ = data_ = map;
+            map_size_ = length;
+            bind(map, length);
+            std::memset(data_, 0, size_);
+            backing_ = PageBacking::HEAP;
+        }
+    }
+
+    if (map_ && policy.lock) {
+        locked_ = mlock(data_, size_) == 0;
+        if (!locked_) LOG_WARN("mlock of a {} byte region failed: {}", size_, std::strerror(errno));
+    }
+#else
+    (void)numa_node;
+#endif
+
+    if (!map_) {
+        data_ = std::aligned_alloc(REGION_ALIGNMENT, size_);
+        if (!data_) throw std::bad_alloc();
+        std::memset(data_, 0, size_);
+        backing_ = PageBacking::HEAP;
+#if defined(__linux__)
+        if (policy.lock) locked_ = mlock(data_, size_) == 0;
+#endif
+    }
+}
+
+PageRegion::~PageRegion() {
+    release();
+}
+
+PageRegion::PageRegion(PageRegion&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , map_(std::exchange(other.map_, nullptr))
+    , map_size_(std::exchange(other.map_size_, 0))
+    , backing_(other.backing_)
+    , locked_(std::exchange(other.locked_, false))
+    , numa_node_(std::exchange(other.numa_node_, -1)) {}
+
+PageRegion& PageRegion::operator=(PageRegion&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_     = std::exchange(other.data_, nullptr);
+        size_     = std::exchange(other.size_, 0);
+        map_      = std::exchange(other.map_, nullptr);
+        map_size_ = std::exchange(other.map_size_, 0);
+        backing_  = other.backing_;
+        locked_   = std::exchange(other.locked_, false);
+        numa_node_ = std::exchange(other.numa_node_, -1);
+    }
+    return *this;
+}
+
+bool PageRegion::release_pages() {
+#if defined(__linux__)
+    if (locked_ || !data_) return false;
+    // Whole pages inside the region only (heap regions share their edges)
+    const auto page  = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = round_up(reinterpret_cast<uintptr_t>(data_), page);
+    const auto end   = (reinterpret_cast<uintptr_t>(data_) + size_) & ~(page - 1);
+    if (end <= begin) return false;
+    return madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED) == 0;
+#else
+    return false;
+#endif
+}
+
+void PageRegion::release() {
+#if defined(__linux__)
+    if (locked_) munlock(data_, size_);
+    if (map_) {
+        munmap(map_, map_size_);
+    } else {
+        std::free(data_);
+    }
+#else
+    std::free(data_);
+#endif
+    data_ = map_ = nullptr;
+    size_ = map_size_ = 0;
+    locked_ = false;
+    numa_node_ = -1;
+}
+
+} // namespace rtes
@@ -0,0 +1,151 @@
+/**
+ * @file idle_strategy.cpp
+ * @brief Idle policies for hot consumer loops; futex parking and eventfd doorbell on Linux
+ */
+
+#include "rtes/idle_strategy.hpp"
+
+#include <sched.h>
+#include <thread>
+
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <ctime>
+#endif
+
+namespace rtes {
+
+IdlePolicy parse_idle_policy(const std::string& name, IdlePolicy fallback) {
+    if (name == "busy_spin")  return IdlePolicy::BUSY_SPIN;
+    if (name == "spin_yield") return IdlePolicy::SPIN_YIELD;
+    if (name == "spin_park")  return IdlePolicy::SPIN_PARK;
+    return fallback;
+}
+
+const char* idle_policy_name(IdlePolicy policy) {
+    switch (policy) {
+        case IdlePolicy::BUSY_SPIN:  return "busy_spin";
+        case IdlePolicy::SPIN_YIELD: return "spin_yield";
+        case IdlePolicy::SPIN_PARK:  return "spin_park";
+    }
+    return "unknown";
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Consumer side
+// ═══════════════════════════════════════════════════════════════
+
+void IdleStrategy::begin_idle() {
+    notify_ns_.store(0, std::memory_order_relaxed);  // Drop a stamp that raced the last period
+    state_.store(IDLE, std::memory_order_relaxed);
+    idle_periods_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void IdleStrategy::end_idle() {
+    state_.store(BUSY, std::memory_order_relaxed);
+
+    const Timestamp notified = notify_ns_.exchange(0, std::memory_order_relaxed);
+    if (notified == 0) return;  // Work arrived without a notify (or before the stamp)
+
+    const Timestamp now = now_timestamp();
+    const uint64_t latency = now > notified ? now - notified : 0;
+    wakeups_.fetch_add(1, std::memory_order_relaxed);
+    wake_latency_sum_ns_.fetch_add(latency, std::memory_order_relaxed);
+    if (latency > wake_latency_max_ns_.load(std::memory_order_relaxed)) {
+        wake_latency_max_ns_.store(latency, std::memory_order_relaxed);  // Single writer
+    }
+}
+
+void IdleStrategy::park() {
+    parks_.fetch_add(1, std::memory_order_relaxed);
+#if defined(__linux__)
+    timespec timeout{};
+    timeout.tv_sec  = park_timeout_us_ / 1'000'000;
+    timeout.tv_nsec = static_cast<long>(park_timeout_us_ % 1'000'000) * 1000;
+    // Returns at once if a producer already flipped the word away from PARKED
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&state_), FUTEX_WAIT_PRIVATE,
+            PARKED, &timeout, nullptr, 0);
+#else
+    yield();
+#endif
+    state_.store(IDLE, std::memory_order_relaxed);
+}
+
+void IdleStrategy::yield() {
+#if defined(__linux__)
+    sched_yield();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Producer side (consumer is idle)
+// ═══════════════════════════════════════════════════════════════
+
+void IdleStrategy::notify_slow() {
+    Timestamp expected = 0;
+    notify_ns_.compare_exchange_strong(expected, now_timestamp(),
+                                       std::memory_order_relaxed);  // First notifier stamps
+
+    uint32_t parked = PARKED;
+    if (state_.compare_exchange_strong(parked, IDLE, std::memory_order_relaxed)) {
+#if defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&state_), FUTEX_WAKE_PRIVATE,
+                1, nullptr, nullptr, 0);
+#endif
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Monitoring
+// ═══════════════════════════════════════════════════════════════
+
+IdleStats IdleStrategy::stats() const {
+    IdleStats stats;
+    stats.policy              = policy_;
+    stats.idle_periods        = idle_periods_.load(std::memory_order_relaxed);
+    stats.parks               = parks_.load(std::memory_order_relaxed);
+    stats.wakeups             = wakeups_.load(std::memory_order_relaxed);
+    stats.wake_latency_max_ns = wake_latency_max_ns_.load(std::memory_order_relaxed);
+    if (stats.wakeups > 0) {
+        stats.wake_latency_avg_ns =
+            wake_latency_sum_ns_.load(std::memory_order_relaxed) / stats.wakeups;
+    }
+    return stats;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  EventDoorbell
+// ═══════════════════════════════════════════════════════════════
+
+EventDoorbell::EventDoorbell() {
+#if defined(__linux__)
+    fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+}
+
+EventDoorbell::~EventDoorbell() {
+#if defined(__linux__)
+    if (fd_ >= 0) ::close(fd_);
+#endif
+}
+
+void EventDoorbell::clear() {
+#if defined(__linux__)
+    uint64_t count;
+    [[maybe_unused]] ssize_t n = ::read(fd_, &count, sizeof(count));
+#endif
+}
+
+void EventDoorbell::signal() {
+#if defined(__linux__)
+    const uint64_t one = 1;
+    [[maybe_unused]] ssize_t n = ::write(fd_, &one, sizeof(one));
+#endif
+}
+
+} // namespace rtes
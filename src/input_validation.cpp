@@ -1,16 +1,62 @@
 #include "rtes/input_validation.hpp"
 #include "rtes/error_handling.hpp"
+#include "rtes/field_scan.hpp"
 #include "rtes/logger.hpp"
+#include "rtes/order_book.hpp"
 #include "rtes/thread_safety.hpp"
 #include <algorithm>
+#include <array>
 #include <cctype>
 #include <cstring>
 
 namespace rtes {
 
+namespace {
+
+/**
+ * Sanitize a message's symbol in place; returns its sanitized length
+ * (before the field truncates it). Clean symbols, the normal case, are
+ * recognized by one scan and left as they are.
+ */
+size_t sanitize_symbol_field(BoundedString<8>& symbol) {
+    const std::string_view text = symbol.view();
+    if (!text.empty() && find_outside(text, FieldCharset::SYMBOL) == text.size()) {
+        return text.size();
+    }
+    const std::string clean = FieldValidators::sanitize_symbol(symbol.c_str());
+    symbol.assign(clean.c_str());
+    return clean.size();
+}
+
+/**
+ * The checks sanitize_message_fields() makes on a new order or modify,
+ * for one batch entry. Prices are required where the type uses them
+ * (limit price, stop trigger).
+ */
+bool batch_entry_in_range(const BatchEntryV2& entry) {
+    const bool new_order = entry.action == BATCH_NEW_ORDER;
+    const bool modify    = entry.action == BATCH_MODIFY_ORDER;
+    const auto type      = static_cast<OrderType>(entry.order_type);
+    const bool known_type = entry.order_type >= static_cast<uint8_t>(OrderType::MARKET) &&
+                            entry.order_type <= static_cast<uint8_t>(OrderType::STOP_LIMIT);
+    const bool quantity_ok = entry.quantity != 0 && entry.quantity <= MessageValidator::MAX_ORDER_QUANTITY;
+    // Non-short-circuit: every entry costs the same, no branch per field
+    const bool order_ok = quantity_ok &
+                          ((entry.side == static_cast<uint8_t>(Side::BUY)) |
+                           (entry.side == static_cast<uint8_t>(Side::SELL))) &
+                          known_type &
+                          (entry.display_quantity <= entry.quantity) &
+                          (!known_type || !has_limit_price(type) || entry.price != 0) &
+                          (!known_type || !is_stop(type) || entry.stop_price != 0);
+    return (entry.order_id != 0) &
+           ((new_order & order_ok) | (modify & quantity_ok) | (entry.action == BATCH_CANCEL_ORDER));
+}
+
+} // namespace
+
 // MessageValidator implementation
 const std::unordered_set<uint32_t> MessageValidator::VALID_MESSAGE_TYPES = {
-    NEW_ORDER, CANCEL_ORDER, ORDER_ACK, TRADE_REPORT, HEARTBEAT
+    NEW_ORDER, CANCEL_ORDER, MODIFY_ORDER, ORDER_ACK, TRADE_REPORT, HEARTBEAT
 };
 
 Result<void> MessageValidator::validate_message_header(const MessageHeader& header) {
@@ -38,6 +84,7 @@ Result<void> MessageValidator::validate_message_payload(const void* payload, siz
     switch (type) {
         case NEW_ORDER: expected_size = sizeof(NewOrderMessage) - sizeof(MessageHeader); break;
         case CANCEL_ORDER: expected_size = sizeof(CancelOrderMessage) - sizeof(MessageHeader); break;
+        case MODIFY_ORDER: expected_size = sizeof(ModifyOrderMessage) - sizeof(MessageHeader); break;
         case ORDER_ACK: expected_size = sizeof(OrderAckMessage) - sizeof(MessageHeader); break;
         case TRADE_REPORT: expected_size = sizeof(TradeMessage) - sizeof(MessageHeader); break;
         case HEARTBEAT: expected_size = sizeof(HeartbeatMessage) - sizeof(MessageHeader); break;
@@ -58,28 +105,34 @@ Result<void> MessageValidator::sanitize_message_fields(NewOrderMessage& message)
         return make_error_code(ValidationError::INVALID_FIELD_VALUE);
     }
     
-    std::string symbol_str = message.symbol.c_str();
-    symbol_str = FieldValidators::sanitize_symbol(symbol_str);
-    if (symbol_str.empty() || symbol_str.length() > 7) {
+    const size_t symbol_length = sanitize_symbol_field(message.symbol);
+    if (symbol_length == 0 || symbol_length > 7) {
         return make_error_code(ValidationError::INVALID_FIELD_FORMAT);
     }
-    message.symbol.assign(symbol_str.c_str());
     
     if (message.side != static_cast<uint8_t>(Side::BUY) && 
         message.side != static_cast<uint8_t>(Side::SELL)) {
         return make_error_code(ValidationError::INVALID_FIELD_VALUE);
     }
     
-    if (message.quantity == 0 || message.quantity > 1000000) {
+    if (message.quantity == 0 || message.quantity > MAX_ORDER_QUANTITY) {
         return make_error_code(ValidationError::INVALID_FIELD_RANGE);
     }
     
-    if (message.order_type == static_cast<uint8_t>(OrderType::LIMIT) && message.price == 0) {
+    if (message.order_type < static_cast<uint8_t>(OrderType::MARKET) ||
+        message.order_type > static_cast<uint8_t>(OrderType::STOP_LIMIT)) {
         return make_error_code(ValidationError::INVALID_FIELD_VALUE);
     }
     
-    if (message.order_type != static_cast<uint8_t>(OrderType::MARKET) &&
-        message.order_type != static_cast<uint8_t>(OrderType::LIMIT)) {
+    if (has_limit_price(static_cast<OrderType>(message.order_type)) && message.price == 0) {
+        return make_error_code(ValidationError::INVALID_FIELD_VALUE);
+    }
+    
+    if (message.display_quantity > message.quantity) {
+        return make_error_code(ValidationError::INVALID_FIELD_RANGE);
+    }
+    
+    if (is_stop(static_cast<OrderType>(message.order_type)) && message.stop_price == 0) {
         return make_error_code(ValidationError::INVALID_FIELD_VALUE);
     }
     
@@ -91,12 +144,25 @@ Result<void> MessageValidator::sanitize_message_fields(CancelOrderMessage& messa
         return make_error_code(ValidationError::INVALID_FIELD_VALUE);
     }
     
-    std::string symbol_str = message.symbol.c_str();
-    symbol_str = FieldValidators::sanitize_symbol(symbol_str);
-    if (symbol_str.empty()) {
+    if (sanitize_symbol_field(message.symbol) == 0) {
         return make_error_code(ValidationError::INVALID_FIELD_FORMAT);
     }
-    message.symbol.assign(symbol_str.c_str());
+    
+    return Result<void>();
+}
+
+Result<void> MessageValidator::sanitize_message_fields(ModifyOrderMessage& message) {
+    if (message.order_id == 0) {
+        return make_error_code(ValidationError::INVALID_FIELD_VALUE);
+    }
+    
+    if (sanitize_symbol_field(message.symbol) == 0) {
+        return make_error_code(ValidationError::INVALID_FIELD_FORMAT);
+    }
+    
+    if (message.new_quantity == 0 || message.new_quantity > MAX_ORDER_QUANTITY) {
+        return make_error_code(ValidationError::INVALID_FIELD_RANGE);
+    }
     
     return Result<void>();
 }
@@ -117,6 +183,16 @@ Result<void> MessageValidator::sanitize_message_fields(OrderAckMessage& message)
     return Result<void>();
 }
 
+size_t MessageValidator::validate_batch_entries(const BatchEntryV2* entries, size_t count,
+                                                uint8_t* valid) {
+    size_t invalid = 0;
+    for (size_t i = 0; i < count; ++i) {
+        valid[i] = batch_entry_in_range(entries[i]);
+        invalid += valid[i] ^ 1;
+    }
+    return invalid;
+}
+
 bool MessageValidator::is_valid_message_type(uint32_t type) {
     return VALID_MESSAGE_TYPES.contains(type);
 }
@@ -130,6 +206,7 @@ bool MessageValidator::is_valid_message_size(uint32_t size, MessageType type) {
     switch (type) {
         case NEW_ORDER: expected_size = sizeof(NewOrderMessage); break;
         case CANCEL_ORDER: expected_size = sizeof(CancelOrderMessage); break;
+        case MODIFY_ORDER: expected_size = sizeof(ModifyOrderMessage); break;
         case ORDER_ACK: expected_size = sizeof(OrderAckMessage); break;
         case TRADE_REPORT: expected_size = sizeof(TradeMessage); break;
         case HEARTBEAT: expected_size = sizeof(HeartbeatMessage); break;
@@ -231,6 +308,11 @@ Result<void> ConfigurationValidator::validate_performance_config(const Performan
         return make_error_code(ValidationError::INVALID_FIELD_RANGE);
     }
     
+    // Published depth (and so every snapshot) holds at most MAX_DEPTH_LEVELS a side
+    if (config.depth_snapshot_levels == 0 || config.depth_snapshot_levels > MAX_DEPTH_LEVELS) {
+        return make_error_code(ValidationError::INVALID_FIELD_RANGE);
+    }
+    
     return Result<void>();
 }
 
@@ -316,6 +398,9 @@ bool FieldValidators::validate_percentage(double value) {
 }
 
 std::string FieldValidators::sanitize_symbol(const std::string& symbol) {
+    if (symbol.size() <= 8 && find_outside(symbol, FieldCharset::SYMBOL) == symbol.size()) {
+        return symbol;  // Already clean
+    }
     std::string result;
     result.reserve(8);
     
@@ -330,6 +415,9 @@ std::string FieldValidators::sanitize_symbol(const std::string& symbol) {
 }
 
 std::string FieldValidators::sanitize_client_id(const std::string& client_id) {
+    if (client_id.size() <= 32 && find_outside(client_id, FieldCharset::CLIENT_ID) == client_id.size()) {
+        return client_id;  // Already clean
+    }
     std::string result;
     result.reserve(32);
     
@@ -384,16 +472,16 @@ Result<void> ValidationChain::validate_early_reject() {
 }
 
 // InputSanitizer implementation
-const std::unordered_set<char> InputSanitizer::DANGEROUS_CHARS = {
-    ';', '|', '&', '$', '`', '(', ')', '{', '}', '[', ']', '<', '>', '"', '\''
-};
+namespace {
 
-const std::unordered_set<char> InputSanitizer::CONTROL_CHARS = {
-    '\x00', '\x01', '\x02', '\x03', '\x04', '\x05', '\x06', '\x07',
-    '\x08', '\x0B', '\x0C', '\x0E', '\x0F', '\x10', '\x11', '\x12',
-    '\x13', '\x14', '\x15', '\x16', '\x17', '\x18', '\x19', '\x1A',
-    '\x1B', '\x1C', '\x1D', '\x1E', '\x1F', '\x7F'
-};
+/** Shell and markup metacharacters, escaped with a backslash */
+constexpr std::array<bool, 256> DANGEROUS_CHARS = [] {
+    std::array<bool, 256> table{};
+    for (unsigned char c : std::string_view(";|&$`(){}[]<>\"'")) table[c] = true;
+    return table;
+}();
+
+} // namespace
 
 std::string InputSanitizer::sanitize_network_input(const std::string& input) {
     if (input.empty() || input.size() > 8192) {
@@ -413,15 +501,17 @@ std::string InputSanitizer::sanitize_log_input(const std::string& input) {
 }
 
 std::string InputSanitizer::remove_control_chars(const std::string& input) {
-    std::string result;
+    // Control characters, DEL and bytes >= 0x80 go; tab, LF and CR stay
+    const size_t first = find_outside(input, FieldCharset::PRINTABLE);
+    if (first == input.size()) return input;
+
+    std::string result(input, 0, first);
     result.reserve(input.size());
-    
-    for (char c : input) {
-        if (!CONTROL_CHARS.contains(c) && (c >= 0x20 || c == '\t' || c == '\n' || c == '\r')) {
-            result += c;
+    for (size_t i = first + 1; i < input.size(); ++i) {
+        if (in_charset(static_cast<unsigned char>(input[i]), FieldCharset::PRINTABLE)) {
+            result += input[i];
         }
     }
-    
     return result;
 }
 
@@ -430,7 +520,7 @@ std::string InputSanitizer::escape_special_chars(const std::string& input) {
     result.reserve(input.size() * 2);
     
     for (char c : input) {
-        if (DANGEROUS_CHARS.contains(c)) {
+        if (DANGEROUS_CHARS[static_cast<unsigned char>(c)]) {
             result += '\\';
         }
         result += c;
@@ -0,0 +1,216 @@
+#include "rtes/io_uring.hpp"
+
+#ifdef __linux__
+
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <csignal>
+#include <cstring>
+
+namespace rtes {
+
+namespace {
+
+int sys_io_uring_setup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+                       const void* arg, size_t arg_size) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags,
+                                    arg, arg_size));
+}
+
+template <typename T>
+T* ring_ptr(void* base, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<uint8_t*>(base) + offset);
+}
+
+} // namespace
+
+IoUring::~IoUring() {
+    release();
+}
+
+bool IoUring::init(const Options& options) {
+    io_uring_params params{};
+    params.flags      = IORING_SETUP_CQSIZE;
+    params.cq_entries = options.entries * 4;  // Multishot accept/poll complete many times per SQE
+    if (options.sqpoll_core >= 0) {
+        params.flags         |= IORING_SETUP_SQPOLL | IORING_SETUP_SQ_AFF;
+        params.sq_thread_cpu  = static_cast<uint32_t>(options.sqpoll_core);
+        params.sq_thread_idle = options.sqpoll_idle_ms;
+    }
+
+    ring_fd_ = sys_io_uring_setup(options.entries, &params);
+    if (ring_fd_ < 0) return false;
+    sqpoll_ = options.sqpoll_core >= 0;
+
+    // One mmap for both rings, timed waits, and no silently dropped CQEs
+    constexpr uint32_t REQUIRED = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_EXT_ARG | IORING_FEAT_NODROP;
+    if ((params.features & REQUIRED) != REQUIRED ||
+        !map_rings(params.sq_entries, params.cq_entries, &params)) {
+        const int saved = errno ? errno : ENOSYS;
+        release();
+        errno = saved;
+        return false;
+    }
+    return true;
+}
+
+bool IoUring::map_rings(unsigned sq_entries, unsigned cq_entries, const void* raw_params) {
+    const auto& params = *static_cast<const io_uring_params*>(raw_params);
+    const size_t sq_size = params.sq_off.array + sq_entries * sizeof(unsigned);
+    const size_t cq_size = params.cq_off.cqes + cq_entries * sizeof(io_uring_cqe);
+    ring_size_ = sq_size > cq_size ? sq_size : cq_size;
+
+    ring_mem_ = mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     ring_fd_, IORING_OFF_SQ_RING);
+    if (ring_mem_ == MAP_FAILED) {
+        ring_mem_ = nullptr;
+        return false;
+    }
+
+    sqes_size_ = sq_entries * sizeof(io_uring_sqe);
+    void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) return false;
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    sq_head_    = ring_ptr<unsigned>(ring_mem_, params.sq_off.head);
+    sq_tail_    = ring_ptr<unsigned>(ring_mem_, params.sq_off.tail);
+    sq_flags_   = ring_ptr<unsigned>(ring_mem_, params.sq_off.flags);
+    sq_mask_    = *ring_ptr<unsigned>(ring_mem_, params.sq_off.ring_mask);
+    sq_entries_ = sq_entries;
+    cq_head_    = ring_ptr<unsigned>(ring_mem_, params.cq_off.head);
+    cq_tail_    = ring_ptr<unsigned>(ring_mem_, params.cq_off.tail);
+    cq_mask_    = *ring_ptr<unsigned>(ring_mem_, params.cq_off.ring_mask);
+    cqes_       = ring_ptr<io_uring_cqe>(ring_mem_, params.cq_off.cqes);
+
+    // SQ slot i always holds SQE i
+    unsigned* array = ring_ptr<unsigned>(ring_mem_, params.sq_off.array);
+    for (unsigned i = 0; i < sq_entries; ++i) array[i] = i;
+    sq_local_tail_ = sq_submitted_ = *sq_tail_;
+    return true;
+}
+
+void IoUring::release() {
+    if (sqes_) munmap(sqes_, sqes_size_);
+    if (ring_mem_) munmap(ring_mem_, ring_size_);
+    if (ring_fd_ >= 0) ::close(ring_fd_);
+    sqes_     = nullptr;
+    ring_mem_ = nullptr;
+    ring_fd_  = -1;
+}
+
+io_uring_sqe* IoUring::get_sqe() {
+    // Full: the kernel (or SQ thread) has not consumed enough yet
+    while (sq_local_tail_ - std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire)
+           >= sq_entries_) [[unlikely]] {
+        submit();
+    }
+    io_uring_sqe* sqe = &sqes_[sq_local_tail_++ & sq_mask_];
+    std::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+void IoUring::submit(bool wait, unsigned timeout_ms) {
+    if (sq_submitted_ != sq_local_tail_) {
+        std::atomic_ref<unsigned>(*sq_tail_).store(sq_local_tail_, std::memory_order_release);
+        sq_submitted_ = sq_local_tail_;
+    }
+    // Published but not yet consumed (a previous enter may have been cut short)
+    const unsigned to_submit =
+        sq_local_tail_ - std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+
+    // Never block with completions already waiting
+    if (wait && *cq_head_ != std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire)) {
+        wait = false;
+    }
+
+    unsigned flags = 0;
+    if (sqpoll_) {
+        // Publishing the tail is enough unless the SQ thread went to sleep
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (std::atomic_ref<unsigned>(*sq_flags_).load(std::memory_order_relaxed) &
+            IORING_SQ_NEED_WAKEUP) {
+            flags |= IORING_ENTER_SQ_WAKEUP;
+        }
+    }
+    if (!wait && flags == 0 && (sqpoll_ || to_submit == 0)) return;
+
+    __kernel_timespec ts{};
+    io_uring_getevents_arg arg{};
+    if (wait) {
+        flags |= IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+        ts.tv_sec  = timeout_ms / 1000;
+        ts.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1'000'000;
+        arg.sigmask_sz = _NSIG / 8;
+        arg.ts = reinterpret_cast<uint64_t>(&ts);
+    }
+    // ETIME (timeout) and EINTR are normal; anything else shows up as CQEs
+    sys_io_uring_enter(ring_fd_, sqpoll_ ? 0 : to_submit, wait ? 1 : 0, flags,
+                       wait ? &arg : nullptr, wait ? sizeof(arg) : 0);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  SQE Preparation
+// ═══════════════════════════════════════════════════════════════
+
+void IoUring::prep_accept_multishot(io_uring_sqe* sqe, int listen_fd, uint64_t user_data) {
+    sqe->opcode    = IORING_OP_ACCEPT;
+    sqe->fd        = listen_fd;
+    sqe->ioprio    = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = user_data;
+}
+
+void IoUring::prep_recv(io_uring_sqe* sqe, int fd, void* buf, size_t len, uint64_t user_data) {
+    sqe->opcode    = IORING_OP_RECV;
+    sqe->fd        = fd;
+    sqe->addr      = reinterpret_cast<uint64_t>(buf);
+    sqe->len       = static_cast<uint32_t>(len);
+    sqe->user_data = user_data;
+}
+
+void IoUring::prep_cancel(io_uring_sqe* sqe, uint64_t target, uint64_t user_data) {
+    sqe->opcode    = IORING_OP_ASYNC_CANCEL;
+    sqe->fd        = -1;
+    sqe->addr      = target;
+    sqe->user_data = user_data;
+}
+
+void IoUring::prep_poll_multishot(io_uring_sqe* sqe, int fd, uint64_t user_data) {
+    sqe->opcode        = IORING_OP_POLL_ADD;
+    sqe->fd            = fd;
+    sqe->len           = IORING_POLL_ADD_MULTI;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data     = user_data;
+}
+
+void IoUring::prep_sendmsg(io_uring_sqe* sqe, int fd, const msghdr* msg, uint64_t user_data) {
+    sqe->opcode    = IORING_OP_SENDMSG;
+    sqe->fd        = fd;
+    sqe->addr      = reinterpret_cast<uint64_t>(msg);
+    sqe->len       = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = user_data;
+}
+
+} // namespace rtes
+
+#else  // !__linux__
+
+namespace rtes {
+
+IoUring::~IoUring() = default;
+
+bool IoUring::init(const Options&) {
+    errno = ENOSYS;
+    return false;
+}
+
+} // namespace rtes
+
+#endif
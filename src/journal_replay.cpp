@@ -0,0 +1,262 @@
+/**
+ * @file journal_replay.cpp
+ * @brief Journal replay through the matching engines, with verification
+ */
+
+#include "rtes/journal_replay.hpp"
+#include "rtes/logger.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <format>
+#include <memory>
+
+namespace rtes {
+
+namespace {
+
+// Requests handed to MatchingEngine::replay at a time, per engine
+constexpr size_t REPLAY_CHUNK = 1024;
+
+bool is_request(JournalRecordType type) {
+    return type >= JournalRecordType::NEW_ORDER && type <= JournalRecordType::MASS_CANCEL;
+}
+
+/** "" if `replayed` is what `expected` recorded, else what differs */
+std::string difference(const JournalRecord& expected, const JournalRecord& replayed) {
+    if (expected.type != replayed.type) {
+        return std::format("expected {}, replayed {}", journal_record_type_name(expected.type),
+                           journal_record_type_name(replayed.type));
+    }
+    const char* type = journal_record_type_name(expected.type);
+    if (expected.book != replayed.book) {
+        return std::format("{}: book {} vs {}", type, expected.book, replayed.book);
+    }
+    if (expected.time != replayed.time) {
+        return std::format("{}: time {} vs {}", type, expected.time, replayed.time);
+    }
+    switch (expected.type) {
+        case JournalRecordType::NEW_ORDER:
+            if (expected.new_order.id != replayed.new_order.id) {
+                return std::format("{}: order {} vs {}", type, expected.new_order.id, replayed.new_order.id);
+            }
+            break;
+        case JournalRecordType::CANCEL_ORDER:
+            if (expected.order.id != replayed.order.id) {
+                return std::format("{}: order {} vs {}", type, expected.order.id, replayed.order.id);
+            }
+            break;
+        case JournalRecordType::MODIFY_ORDER:
+            if (expected.modify.id != replayed.modify.id) {
+                return std::format("{}: order {} vs {}", type, expected.modify.id, replayed.modify.id);
+            }
+            break;
+        case JournalRecordType::TRADE: {
+            const Trade& a = expected.trade;
+            const Trade& b = replayed.trade;
+            if (a.id != b.id || a.buy_order_id != b.buy_order_id || a.sell_order_id != b.sell_order_id ||
+                a.price != b.price || a.quantity != b.quantity || a.symbol != b.symbol) {
+                return std::format("trade: #{} {}/{} {}@{} vs #{} {}/{} {}@{}",
+                                   a.id, a.buy_order_id, a.sell_order_id, a.quantity, a.price,
+                                   b.id, b.buy_order_id, b.sell_order_id, b.quantity, b.price);
+            }
+            break;
+        }
+        case JournalRecordType::ORDER_DONE: {
+            const auto& a = expected.done;
+            const auto& b = replayed.done;
+            if (a.id != b.id || a.filled_quantity != b.filled_quantity ||
+                a.leaves_quantity != b.leaves_quantity || a.status != b.status) {
+                return std::format("order_done: {} filled {} leaves {} status {} vs {} filled {} leaves {} status {}",
+                                   a.id, a.filled_quantity, a.leaves_quantity, static_cast<int>(a.status),
+                                   b.id, b.filled_quantity, b.leaves_quantity, static_cast<int>(b.status));
+            }
+            break;
+        }
+        case JournalRecordType::ORDER_REJECT:
+            if (expected.reject.id != replayed.reject.id || expected.reject.reason != replayed.reject.reason) {
+                return std::format("order_reject: {} reason {} vs {} reason {}", expected.reject.id,
+                                   expected.reject.reason, replayed.reject.id, replayed.reject.reason);
+            }
+            break;
+        default:
+            break;  // Phase and mass cancel: type and book say it all
+    }
+    return {};
+}
+
+/** One journal lane being replayed */
+struct ReplayLane {
+    std::unique_ptr<MatchingEngine>   engine;
+    std::vector<JournalRecord>        pending;   // Requests not handed to the engine yet
+    std::deque<const JournalRecord*>  expected;  // Recorded, not compared yet
+    std::deque<JournalRecord>         produced;  // Replayed, not compared yet
+    uint64_t                          last_seq{0};
+    bool                              verify{true};
+};
+
+} // namespace
+
+bool ReplayReport::ok() const {
+    if (!error.empty()) return false;
+    for (const auto& engine : engines) {
+        if (engine.mismatches != 0 || engine.gaps != 0) return false;
+    }
+    return true;
+}
+
+ReplayReport replay_journal(const std::string& path, const std::vector<EngineLayout>& layout,
+                            const ReplayOptions& options) {
+    ReplayReport report;
+    std::vector<std::string> files = list_journal_segments(path);
+    if (files.empty() && std::filesystem::exists(path)) files.push_back(path);
+    if (files.empty()) {
+        report.error = "no journal at " + path;
+        return report;
+    }
+    std::vector<MappedJournal> journals(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!journals[i].open(files[i])) {
+            report.error = "unreadable journal " + files[i];
+            return report;
+        }
+        if (journals[i].header().run_id != journals.front().header().run_id) {
+            report.error = "journal " + files[i] + " is from another run than " + files.front();
+            return report;
+        }
+    }
+    const JournalFileHeader& header = journals.front().header();
+    const size_t engine_count = std::min<size_t>(header.engine_count, JOURNAL_MAX_ENGINES);
+
+    // Books of each lane: from the layout, or named by the lane's new orders
+    std::vector<std::vector<BookSpec>> books(engine_count);
+    for (size_t e = 0; e < engine_count; ++e) {
+        const std::string name(header.engine_names[e], strnlen(header.engine_names[e], 32));
+        report.engines.push_back({name});
+        if (layout.empty()) continue;
+        const auto it = std::find_if(layout.begin(), layout.end(),
+                                     [&](const EngineLayout& l) { return l.name == name; });
+        if (it == layout.end()) {
+            report.error = "engine " + name + " is not in the configuration";
+            return report;
+        }
+        books[e] = it->books;
+    }
+    for (const MappedJournal& journal : journals) {
+        for (const JournalRecord& record : journal.records()) {
+            if (record.type != JournalRecordType::NEW_ORDER || record.engine >= engine_count) continue;
+            auto& specs = books[record.engine];
+            if (layout.empty()) {
+                if (record.book >= specs.size()) specs.resize(record.book + 1);
+                if (specs[record.book].symbol.empty()) specs[record.book].symbol = record.new_order.symbol.c_str();
+            }
+            if (record.book >= specs.size() || specs[record.book].symbol != record.new_order.symbol.c_str()) {
+                report.error = std::format("engine {} book {} is {} in the journal, not in the configuration",
+                                           report.engines[record.engine].engine, record.book,
+                                           record.new_order.symbol.c_str());
+                return report;
+            }
+        }
+    }
+
+    OrderPool pool(options.pool_size);
+    // One request's outputs are bounded by the orders it can touch: at
+    // most a trade and a done per resting order, plus its own
+    JournalLane sink(0, 2 * options.pool_size + 4 * REPLAY_CHUNK);
+    std::vector<ReplayLane> lanes(engine_count);
+    for (size_t e = 0; e < engine_count; ++e) {
+        auto& specs = books[e];
+        for (size_t b = 0; b < specs.size(); ++b) {
+            if (specs[b].symbol.empty()) specs[b].symbol = "BOOK" + std::to_string(b);  // Never ordered
+        }
+        if (specs.empty()) specs.push_back({"BOOK0", {}});
+        lanes[e].engine = std::make_unique<MatchingEngine>(report.engines[e].engine, specs, pool);
+        lanes[e].pending.reserve(REPLAY_CHUNK);
+        lanes[e].verify = options.verify;
+    }
+
+    const auto compare = [&](size_t e) {
+        ReplayLane& lane = lanes[e];
+        ReplayEngineStats& stats = report.engines[e];
+        while (!lane.expected.empty() && !lane.produced.empty()) {
+            const JournalRecord& expected = *lane.expected.front();
+            std::string detail = difference(expected, lane.produced.front());
+            ++stats.outputs;
+            if (!detail.empty() && stats.mismatches++ < options.max_reported) {
+                report.mismatches.push_back({stats.engine, expected.seq, std::move(detail)});
+            }
+            lane.expected.pop_front();
+            lane.produced.pop_front();
+        }
+    };
+
+    const auto flush = [&](size_t e) {
+        ReplayLane& lane = lanes[e];
+        if (lane.pending.empty()) return;
+        const auto start = std::chrono::steady_clock::now();
+        report.requests += lane.engine->replay(lane.pending, lane.verify ? &sink : nullptr);
+        report.match_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        report.engines[e].requests += lane.pending.size();
+        lane.pending.clear();
+        if (!lane.verify) return;
+
+        JournalRecord record;
+        while (sink.queue().pop(record)) lane.produced.push_back(record);
+        compare(e);
+    };
+
+    for (const MappedJournal& journal : journals) {
+        for (const JournalRecord& record : journal.records()) {
+            ++report.records;
+            if (record.engine >= engine_count) continue;
+            ReplayLane& lane = lanes[record.engine];
+            if (record.seq != lane.last_seq + 1) {
+                ++report.engines[record.engine].gaps;
+                if (lane.verify) {
+                    LOG_WARN("Replay: engine {} journal has a gap before seq {}, not verified past it",
+                             report.engines[record.engine].engine, record.seq);
+                    flush(record.engine);
+                    lane.verify = false;
+                    lane.expected.clear();
+                    lane.produced.clear();
+                }
+            }
+            lane.last_seq = record.seq;
+            if (lane.verify) {
+                lane.expected.push_back(&record);
+                compare(record.engine);
+            }
+            if (!is_request(record.type)) continue;
+            lane.pending.push_back(record);
+            if (lane.pending.size() == REPLAY_CHUNK) flush(record.engine);
+        }
+    }
+    for (size_t e = 0; e < engine_count; ++e) {
+        flush(e);
+        ReplayLane& lane = lanes[e];
+        ReplayEngineStats& stats = report.engines[e];
+        // What is left on one side only: recorded but not reproduced, or the reverse
+        for (const JournalRecord* expected : lane.expected) {
+            if (stats.mismatches++ < options.max_reported) {
+                report.mismatches.push_back({stats.engine, expected->seq,
+                    std::format("{} not reproduced", journal_record_type_name(expected->type))});
+            }
+        }
+        for (const JournalRecord& produced : lane.produced) {
+            if (stats.mismatches++ < options.max_reported) {
+                report.mismatches.push_back({stats.engine, 0,
+                    std::format("extra {}", journal_record_type_name(produced.type))});
+            }
+        }
+    }
+    if (sink.drops() != 0) {
+        report.error = std::format("{} replayed records did not fit the verification lane: raise the pool size",
+                                   sink.drops());
+    }
+    return report;
+}
+
+} // namespace rtes
@@ -14,15 +14,115 @@
  * - Lock-free level checking
  * - Rate limiting with atomic timestamp
  * - Minimal string allocations
+ * - Deferred mode: formatting and I/O on a writer thread (start_async)
  */
 
 #include "rtes/logger.hpp"
+#include <algorithm>
+#include <cerrno>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <unistd.h>
 
 namespace rtes {
 
+namespace {
+
+constexpr auto   LOG_WRITER_POLL  = std::chrono::milliseconds(1);
+constexpr size_t LOG_DRAIN_CHUNK  = 64;
+
+/** One decoded argument of a LogRecord */
+struct DecodedArg {
+    detail::LogArg   tag;
+    int64_t          i64{0};
+    uint64_t         u64{0};
+    double           f64{0.0};
+    bool             b{false};
+    char             c{0};
+    std::string_view text{};
+};
+
+std::vector<DecodedArg> decode_args(const LogRecord& record) {
+    std::vector<DecodedArg> args;
+    args.reserve(record.arg_count);
+    size_t pos = 0;
+    const char* data = record.payload.data();
+    for (uint8_t i = 0; i < record.arg_count && pos < record.used; ++i) {
+        DecodedArg arg{static_cast<detail::LogArg>(data[pos++])};
+        switch (arg.tag) {
+            case detail::LogArg::I64:  std::memcpy(&arg.i64, data + pos, 8); pos += 8; break;
+            case detail::LogArg::U64:  std::memcpy(&arg.u64, data + pos, 8); pos += 8; break;
+            case detail::LogArg::F64:  std::memcpy(&arg.f64, data + pos, 8); pos += 8; break;
+            case detail::LogArg::BOOL: std::memcpy(&arg.b, data + pos, 1); pos += 1; break;
+            case detail::LogArg::CHAR: arg.c = data[pos]; pos += 1; break;
+            case detail::LogArg::STR: {
+                uint16_t size = 0;
+                std::memcpy(&size, data + pos, sizeof(size));
+                arg.text = std::string_view(data + pos + sizeof(size), size);
+                pos += sizeof(size) + size;
+                break;
+            }
+        }
+        args.push_back(arg);
+    }
+    return args;
+}
+
+/** One replacement field: `spec` is "" or ":..." as written in the format string */
+void format_arg(std::string& out, const DecodedArg& arg, std::string_view spec) {
+    const std::string field = "{" + std::string(spec) + "}";
+    auto apply = [&](const auto& value) {
+        try {
+            std::vformat_to(std::back_inserter(out), field, std::make_format_args(value));
+        } catch (const std::format_error&) {
+            // Spec written for the original type (sent as text): plain form
+            std::vformat_to(std::back_inserter(out), "{}", std::make_format_args(value));
+        }
+    };
+    switch (arg.tag) {
+        case detail::LogArg::I64:  apply(arg.i64); break;
+        case detail::LogArg::U64:  apply(arg.u64); break;
+        case detail::LogArg::F64:  apply(arg.f64); break;
+        case detail::LogArg::BOOL: apply(arg.b); break;
+        case detail::LogArg::CHAR: apply(arg.c); break;
+        case detail::LogArg::STR:  apply(arg.text); break;
+    }
+}
+
+/** Bytes of `out` that reached stdout */
+size_t write_all(const std::string& out) {
+    size_t done = 0;
+    while (done < out.size()) {
+        const ssize_t n = ::write(STDOUT_FILENO, out.data() + done, out.size() - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;  // Nowhere to log to
+        done += static_cast<size_t>(n);
+    }
+    return done;
+}
+
+} // namespace
+
+struct Logger::Ring {
+    SPSCQueue<LogRecord> queue{LOG_RING_CAPACITY};
+    std::atomic<bool>    leased{false};
+};
+
+namespace {
+
+/** Returns the thread's ring to the pool when the thread exits */
+struct RingLease {
+    std::atomic<bool>*     leased{nullptr};
+    SPSCQueue<LogRecord>** slot{nullptr};  // The thread's Logger::thread_ring_
+    ~RingLease() {
+        if (slot) *slot = nullptr;
+        if (leased) leased->store(false, std::memory_order_release);
+    }
+};
+
+} // namespace
+
 /**
  * @brief Get logger singleton instance
  * @return Reference to global logger
@@ -34,12 +134,50 @@ Logger& Logger::instance() {
     return logger;
 }
 
+// ═══════════════════════════════════════════════════════════════
+//  Call Sites
+// ═══════════════════════════════════════════════════════════════
+
+LogSiteRegistry& LogSiteRegistry::instance() {
+    // Never destroyed: sites are held in function-local statics, and the
+    // Logger's final drain at exit still looks them up
+    static LogSiteRegistry* registry = new LogSiteRegistry;
+    return *registry;
+}
+
+LogSite& LogSiteRegistry::add(const char* file, uint32_t line, LogLevel level, std::string_view format) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t index = sites_.size();
+    const auto id = static_cast<uint16_t>(std::min(index, LOG_MAX_SITES));
+    sites_.push_back(std::make_unique<LogSite>(file, line, level, format, id));
+    LogSite& site = *sites_.back();
+    if (index < LOG_MAX_SITES) by_id_[index].store(&site, std::memory_order_release);
+    return site;
+}
+
+std::vector<LogSite*> LogSiteRegistry::match(std::string_view file, uint32_t line) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<LogSite*> found;
+    for (const auto& site : sites_) {
+        if (!std::string_view(site->file).ends_with(file)) continue;
+        if (line != 0 && site->line != line) continue;
+        found.push_back(site.get());
+    }
+    return found;
+}
+
+Logger::~Logger() {
+    stop_async();
+}
+
 void Logger::set_level(LogLevel level) {
     level_.store(level);
 }
 
 void Logger::set_rate_limit(std::chrono::milliseconds limit) {
     rate_limit_ = limit;
+    site_rate_limit_ns_.store(std::chrono::duration_cast<std::chrono::nanoseconds>(limit).count(),
+                              std::memory_order_relaxed);
 }
 
 void Logger::enable_structured(bool enabled) {
@@ -65,16 +203,167 @@ void Logger::log(LogLevel level, const std::string& message) {
     // Fast-path: Check rate limit (atomic compare)
     if (should_rate_limit()) return;
     
-    // Format and output message
+    print(level, message);
+}
+
+void Logger::print(LogLevel level, const std::string& message) {
     std::cout << format_message(level, message) << std::endl;
 }
 
 // Note: Removed unsafe printf-style logging - use log_safe() template methods instead
 
+// ═══════════════════════════════════════════════════════════════
+//  Deferred Logging
+// ═══════════════════════════════════════════════════════════════
+
+void Logger::start_async() {
+    bool expected = false;
+    if (!writer_running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return;
+    writer_ = std::thread(&Logger::run_writer, this);
+    async_.store(true, std::memory_order_release);
+}
+
+void Logger::stop_async() {
+    bool expected = true;
+    if (!writer_running_.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) return;
+    async_.store(false, std::memory_order_release);  // New calls log synchronously again
+    if (writer_.joinable()) writer_.join();
+
+    std::vector<LogRecord> batch;
+    std::string out;
+    drain(batch, out);  // What was queued before the switch
+}
+
+/**
+ * A thread's first deferred call: take over a ring released by an exited
+ * thread, or add one. The ring's producer indices carry over, and the
+ * exited thread's last writes happen-before its release of the lease.
+ */
+SPSCQueue<LogRecord>* Logger::attach_ring() {
+    thread_local RingLease lease;
+    std::lock_guard<std::mutex> lock(rings_mutex_);
+    Ring* ring = nullptr;
+    for (auto& candidate : rings_) {
+        bool expected = false;
+        if (candidate->leased.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            ring = candidate.get();
+            break;
+        }
+    }
+    if (!ring) {
+        rings_.push_back(std::make_unique<Ring>());
+        ring = rings_.back().get();
+        ring->leased.store(true, std::memory_order_relaxed);
+    }
+    lease.leased = &ring->leased;
+    lease.slot   = &thread_ring_;
+    thread_ring_ = &ring->queue;
+    return thread_ring_;
+}
+
+void Logger::run_writer() {
+    std::vector<LogRecord> batch;
+    std::string out;
+    while (writer_running_.load(std::memory_order_relaxed)) {
+        if (drain(batch, out) == 0) std::this_thread::sleep_for(LOG_WRITER_POLL);
+    }
+}
+
+/**
+ * Pop every ring, then format, sanitize and write the lot in time order
+ * with one write(2). Returns records taken.
+ */
+size_t Logger::drain(std::vector<LogRecord>& batch, std::string& out) {
+    batch.clear();
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        for (auto& ring : rings_) {
+            size_t n;
+            do {
+                const size_t at = batch.size();
+                batch.resize(at + LOG_DRAIN_CHUNK);
+                n = ring->queue.try_pop_bulk(batch.data() + at, LOG_DRAIN_CHUNK);
+                batch.resize(at + n);
+            } while (n == LOG_DRAIN_CHUNK);
+        }
+    }
+    if (batch.empty()) return 0;
+
+    std::stable_sort(batch.begin(), batch.end(),
+                     [](const LogRecord& a, const LogRecord& b) { return a.time_ns < b.time_ns; });
+    out.clear();
+    uint64_t truncated = 0;
+    const LogSiteRegistry& sites = LogSiteRegistry::instance();
+    for (const LogRecord& record : batch) {
+        if (record.truncated) ++truncated;
+        const LogSite* site = sites.find(record.site);
+        if (!site) continue;  // Not possible: ids are handed out before use
+        const auto when = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::nanoseconds(record.time_ns)));
+        out += format_message(site->level, SecurityUtils::sanitize_log_input(format_record(site->format, record)),
+                              when);
+        out += '\n';
+    }
+    std::cout.flush();  // Anything logged synchronously before goes first
+    const size_t bytes = write_all(out);
+
+    // One line per record (messages are sanitized): only whole lines out count as written
+    const auto written = static_cast<uint64_t>(std::count(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(bytes), '\n'));
+    truncated_.fetch_add(truncated, std::memory_order_relaxed);
+    written_.fetch_add(written, std::memory_order_relaxed);
+    if (written != batch.size()) [[unlikely]] lost_.fetch_add(batch.size() - written, std::memory_order_relaxed);
+    return batch.size();
+}
+
+/**
+ * std::format's replacement-field grammar over the decoded arguments:
+ * "{{" / "}}" escapes, automatic or explicit indices, and a format spec
+ * after ':'. Arguments a truncated record lost print as "?".
+ */
+std::string Logger::format_record(std::string_view fmt, const LogRecord& record) {
+    const std::vector<DecodedArg> args = decode_args(record);
+    std::string out;
+    out.reserve(fmt.size() + 16 * args.size());
+
+    size_t next = 0;
+    for (size_t i = 0; i < fmt.size(); ++i) {
+        const char c = fmt[i];
+        if (c == '{') {
+            if (i + 1 < fmt.size() && fmt[i + 1] == '{') {
+                out += '{';
+                ++i;
+                continue;
+            }
+            const size_t close = fmt.find('}', i);
+            if (close == std::string_view::npos) break;
+            const std::string_view field = fmt.substr(i + 1, close - i - 1);
+            const size_t colon = field.find(':');
+            const std::string_view id = field.substr(0, colon);
+            size_t index = next++;
+            if (!id.empty()) index = static_cast<size_t>(std::strtoul(std::string(id).c_str(), nullptr, 10));
+            if (index < args.size()) {
+                format_arg(out, args[index], colon == std::string_view::npos ? "" : field.substr(colon));
+            } else {
+                out += '?';
+            }
+            i = close;
+        } else if (c == '}') {
+            out += '}';
+            if (i + 1 < fmt.size() && fmt[i + 1] == '}') ++i;
+        } else {
+            out += c;
+        }
+    }
+    if (record.truncated) out += " [truncated]";
+    return out;
+}
+
 /**
  * @brief Format log message with timestamp and level
  * @param level Log level
  * @param message Message content
+ * @param now Time the message was logged
  * @return Formatted log string
  * 
  * Formats:
@@ -83,9 +372,9 @@ void Logger::log(LogLevel level, const std::string& message) {
  * 
  * Timestamp: UTC with millisecond precision
  */
-std::string Logger::format_message(LogLevel level, const std::string& message) {
-    // Get current time with millisecond precision
-    auto now = std::chrono::system_clock::now();
+std::string Logger::format_message(LogLevel level, const std::string& message,
+                                   std::chrono::system_clock::time_point now) {
+    // Time with millisecond precision
     auto time_t = std::chrono::system_clock::to_time_t(now);
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()) % 1000;
@@ -10,11 +10,20 @@
  *
  * Shutdown: Send SIGINT (Ctrl+C) or SIGTERM for graceful shutdown.
  * All components are torn down in reverse startup order.
+ *
+ * Standby (replication.role "standby"): SIGUSR1 promotes it to primary.
  */
 
 #include "rtes/exchange.hpp"
 #include "rtes/tcp_gateway.hpp"
+#include "rtes/shm_order_entry.hpp"
+#include "rtes/drop_copy.hpp"
+#include "rtes/session_capture.hpp"
+#include "rtes/tls_offload.hpp"
+#include "rtes/auth_middleware.hpp"
 #include "rtes/udp_publisher.hpp"
+#include "rtes/retransmission.hpp"
+#include "rtes/snapshot_publisher.hpp"
 #include "rtes/monitoring.hpp"
 #include "rtes/config.hpp"
 #include "rtes/logger.hpp"
@@ -26,6 +35,8 @@
 #include <unordered_map>
 #include <algorithm>
 #include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 #include <stdexcept>
 
@@ -56,6 +67,14 @@ void signal_handler(int signal) {
     g_shutdown_requested = 1;
 }
 
+/** Set by SIGUSR1: a standby takes over (manual failover) */
+volatile std::sig_atomic_t g_promote_requested = 0;
+
+void promote_handler(int signal) {
+    (void)signal;
+    g_promote_requested = 1;
+}
+
 // ─────────────────────────────────────────────────────────────
 // Startup Guard (RAII rollback on partial startup failure)
 // ─────────────────────────────────────────────────────────────
@@ -157,6 +176,7 @@ void configure_logger(const LoggingConfig& log_config) {
     logger.set_level(parse_log_level(log_config.level));
     logger.set_rate_limit(std::chrono::milliseconds(log_config.rate_limit_ms));
     logger.enable_structured(log_config.enable_structured);
+    if (log_config.async) logger.start_async();
 }
 
 // ─────────────────────────────────────────────────────────────
@@ -175,9 +195,21 @@ void wait_for_shutdown() {
     }
 }
 
+/**
+ * @brief Hold a standby until it is promoted (SIGUSR1 or primary silence)
+ * @return false if shutdown came first
+ */
+bool wait_for_promotion(const Exchange& exchange) {
+    while (!g_shutdown_requested && !g_promote_requested && !exchange.promotion_due()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return !g_shutdown_requested;
+}
+
 /**
  * @brief Main exchange runtime
  * @param config_ptr Unique pointer to validated configuration
+ * @param config_path File it was loaded from (re-read by /reload/risk)
  * @throws std::runtime_error if any component fails to start
  *
  * Lifecycle:
@@ -190,7 +222,7 @@ void wait_for_shutdown() {
  * On partial startup failure, already-started components
  * are rolled back automatically via StartupGuard.
  */
-void run_exchange(std::unique_ptr<Config> config_ptr) {
+void run_exchange(std::unique_ptr<Config> config_ptr, const std::string& config_path) {
     // ── Phase 1: Create Exchange (takes config ownership) ──
     Exchange exchange(std::move(config_ptr));
 
@@ -208,36 +240,225 @@ void run_exchange(std::unique_ptr<Config> config_ptr) {
     });
     LOG_INFO("Exchange core started");
 
+    // Standby: no gateway or feeds until this instance takes over
+    if (exchange.state() == ExchangeState::STANDBY) {
+        LOG_INFO("Standby: following the primary; SIGUSR1 promotes");
+        if (!wait_for_promotion(exchange)) {
+            guard.commit();
+            exchange.stop();
+            return;
+        }
+        exchange.promote();
+    }
+
+    // Drop copy (optional): consumes what the gateway routes, so it starts first
+    std::unique_ptr<DropCopyServer> drop_copy;
+    if (config.exchange.drop_copy_port != 0) {
+        drop_copy = std::make_unique<DropCopyServer>(
+            config.exchange.drop_copy_port, exchange.ingress_reactors(),
+            exchange.get_client_directory(), config.performance.drop_copy_journal_size);
+        drop_copy->start();
+        guard.add([&] {
+            LOG_INFO("Rolling back: stopping drop copy");
+            drop_copy->stop();
+        });
+    }
+
+    // Session capture (optional): drains what the gateway copies, so it starts first
+    std::unique_ptr<SessionCapture> capture;
+    if (!config.performance.session_capture_file.empty()) {
+        capture = std::make_unique<SessionCapture>(config.performance.session_capture_file,
+                                                   exchange.gateway_reactors(),
+                                                   config.performance.session_capture_lane_chunks);
+        if (!capture->start()) capture.reset();  // Logged; order entry runs without it
+    }
+
+    // Order entry over kernel TLS (optional): a bad certificate stops startup
+    std::unique_ptr<TlsOffload> tls;
+    if (!config.exchange.tls_cert_file.empty()) {
+        tls = std::make_unique<TlsOffload>();
+        if (!tls->init({config.exchange.tls_cert_file, config.exchange.tls_key_file,
+                        config.exchange.tls_ca_file})) {
+            throw std::runtime_error("Cannot load the order entry TLS certificate");
+        }
+    }
+
+    // Session authentication (optional): one slot per gateway connection and shared memory slot
+    std::unique_ptr<SessionAuthCache> session_auth;
+    if (config.exchange.require_session_auth) {
+        session_auth = std::make_unique<SessionAuthCache>(
+            size_t{config.performance.gateway_max_connections} * exchange.gateway_reactors() +
+            (exchange.shm_entry_enabled() ? size_t{config.performance.shm_entry_clients} : 0));
+    }
+
     // Start TCP gateway for order entry
     TcpGateway gateway(
         config.exchange.tcp_port,
         exchange.get_risk_manager(),
-        exchange.get_order_pool()
+        exchange.get_order_pool(),
+        exchange.gateway_reactors()
     );
+    gateway.set_client_directory(exchange.get_client_directory());
+    gateway.set_instrument_directory(exchange.get_instrument_directory());
+    gateway.set_risk_shards(exchange.get_risk_shards());
+    gateway.set_cancel_on_disconnect(config.exchange.cancel_on_disconnect);
+    gateway.set_drop_copy(drop_copy.get());
+    gateway.set_order_tracer(exchange.get_order_tracer());
+    gateway.set_session_capture(capture.get());
+    gateway.set_tls(tls.get());
+    gateway.set_session_auth(session_auth.get());
+    gateway.set_backend(parse_gateway_backend(config.performance.gateway_backend),
+                        config.performance.gateway_sqpoll_core);
+    gateway.set_idle_policy(parse_idle_policy(config.performance.gateway_idle_policy,
+                                              IdlePolicy::SPIN_PARK));
+    gateway.set_busy_poll(config.performance.gateway_busy_poll_us);
+    gateway.set_incoming_cpu_steering(config.performance.gateway_incoming_cpu);
+    gateway.set_ingress_timestamps(config.performance.gateway_rx_timestamps);
+    gateway.set_max_connections(config.performance.gateway_max_connections);
+    gateway.set_thread_placement(exchange.thread_placement(config.performance.gateway_core));
+    for (size_t r = 0; r < gateway.reactor_count(); ++r) {
+        gateway.set_execution_queues(exchange.get_execution_queues(r),
+                                     exchange.get_execution_doorbell(r), r);
+        exchange.track_thread(r == 0 ? std::string("tcp_gateway") : "tcp_gateway_" + std::to_string(r),
+                              [&gateway, r] { return gateway.applied_placement(r); });
+    }
     gateway.start();
     guard.add([&] {
         LOG_INFO("Rolling back: stopping TCP gateway");
         gateway.stop();
     });
-    LOG_INFO("TCP gateway listening on port {}", config.exchange.tcp_port);
+    LOG_INFO("TCP gateway listening on port {} ({} reactors)",
+             config.exchange.tcp_port, gateway.reactor_count());
+
+    // Shared memory order entry (optional): co-located strategies, one more ingress reactor
+    std::unique_ptr<ShmGateway> shm_gateway;
+    if (exchange.shm_entry_enabled()) {
+        const size_t reactor = exchange.shm_entry_reactor();
+        shm_gateway = std::make_unique<ShmGateway>(
+            config.performance.shm_entry_name, config.performance.shm_entry_clients,
+            exchange.get_risk_manager(), exchange.get_order_pool(), static_cast<GatewayReactor>(reactor));
+        shm_gateway->set_risk_lane(static_cast<RiskLane>(reactor));
+        shm_gateway->set_client_directory(exchange.get_client_directory());
+        shm_gateway->set_instrument_directory(exchange.get_instrument_directory());
+        shm_gateway->set_risk_shards(exchange.get_risk_shards());
+        shm_gateway->set_cancel_on_disconnect(config.exchange.cancel_on_disconnect);
+        shm_gateway->set_session_auth(session_auth.get());
+        shm_gateway->set_drop_copy(drop_copy.get());
+        shm_gateway->set_execution_queues(exchange.get_execution_queues(reactor));
+        shm_gateway->set_idle_policy(parse_idle_policy(config.performance.shm_entry_idle_policy,
+                                                       IdlePolicy::SPIN_YIELD));
+        shm_gateway->set_thread_placement(exchange.thread_placement(config.performance.shm_entry_core));
+        exchange.track_thread("shm_gateway", [&shm_gateway] { return shm_gateway->applied_placement(); },
+                              [&shm_gateway] { return shm_gateway->idle_stats(); });
+        shm_gateway->start();
+        guard.add([&] {
+            LOG_INFO("Rolling back: stopping shared memory order entry");
+            shm_gateway->stop();
+        });
+        LOG_INFO("Shared memory order entry logons on @rtes_shm/{} ({} client slots)",
+                 config.performance.shm_entry_name, shm_gateway->slot_count());
+    }
 
-    // Start UDP publisher for market data
-    UdpPublisher udp_publisher(
-        config.exchange.udp_multicast_group,
-        config.exchange.udp_port,
-        exchange.get_market_data_queue()
-    );
-    udp_publisher.start();
+    // The instrument directory clients need for protocol v2
+    const auto& instruments = exchange.get_instrument_directory()->symbols();
+    for (size_t id = 0; id < instruments.size(); ++id) {
+        LOG_INFO("Instrument {} = {}", id, instruments[id].c_str());
+    }
+
+    // Gap fill (optional): keeps what the publishers send, so it starts first
+    std::unique_ptr<RetransmissionServer> retransmission;
+    if (config.exchange.retransmit_port != 0) {
+        retransmission = std::make_unique<RetransmissionServer>(
+            config.exchange.retransmit_bind_address, config.exchange.retransmit_port,
+            exchange.market_data_publishers(),
+            exchange.market_data_channels().size(), config.performance.retransmit_history_packets);
+        retransmission->start();
+        guard.add([&] {
+            LOG_INFO("Rolling back: stopping retransmission");
+            retransmission->stop();
+        });
+    }
+
+    // Start UDP publishers for market data; each serves the channels
+    // mapped to it (channel i → publisher i % N) and drains one lane per
+    // engine with a book on them
+    std::vector<std::unique_ptr<UdpPublisher>> udp_publishers;
+    for (size_t p = 0; p < exchange.market_data_publishers(); ++p) {
+        auto publisher = std::make_unique<UdpPublisher>(
+            "", 0, nullptr, exchange.get_market_data_idle(p));
+        for (MarketDataLane* lane : exchange.get_market_data_lanes(p)) publisher->add_input(lane);
+        const auto& channels = exchange.market_data_channels();
+        for (size_t c = 0; c < channels.size(); ++c) {
+            if (channels[c].publisher != p) continue;
+            publisher->add_channel(static_cast<uint8_t>(c), channels[c].group, channels[c].port);
+            LOG_INFO("Market data channel {} on {}:{} (publisher {})",
+                     c, channels[c].group, channels[c].port, p);
+        }
+        if (p == 0) {
+            publisher->set_thread_placement(exchange.thread_placement(config.performance.market_data_core));
+        }
+        publisher->set_max_datagram_size(config.performance.market_data_datagram_bytes);
+        publisher->set_bbo_conflation(config.performance.bbo_conflation);
+        if (!config.performance.market_data_auth_key.empty() &&
+            !publisher->set_authentication(config.performance.market_data_auth_key)) {
+            throw std::runtime_error("market_data_auth_key is set but datagram signing is unavailable");
+        }
+        if (!config.performance.market_data_xdp_interface.empty()) {
+            AfXdpSocket::Options xdp;
+            xdp.interface = config.performance.market_data_xdp_interface;
+            xdp.queue     = config.performance.market_data_xdp_queue + static_cast<uint32_t>(p);
+            xdp.zero_copy = config.performance.market_data_xdp_zero_copy;
+            publisher->set_af_xdp(xdp);
+        }
+        if (retransmission) publisher->set_retransmission(retransmission->publisher_queue(p));
+        UdpPublisher* raw = publisher.get();
+        exchange.track_thread(p == 0 ? std::string("udp_publisher") : "udp_publisher_" + std::to_string(p),
+                              [raw] { return raw->applied_placement(); },
+                              [raw] { return raw->idle_stats(); });
+        publisher->start();
+        udp_publishers.push_back(std::move(publisher));
+    }
     guard.add([&] {
-        LOG_INFO("Rolling back: stopping UDP publisher");
-        udp_publisher.stop();
+        LOG_INFO("Rolling back: stopping UDP publishers");
+        for (auto& publisher : udp_publishers) publisher->stop();
     });
-    LOG_INFO("UDP publisher broadcasting on {}:{}",
-             config.exchange.udp_multicast_group,
-             config.exchange.udp_port);
+
+    // Snapshot channel (optional): every book's published depth, in a loop
+    std::unique_ptr<SnapshotPublisher> snapshots;
+    if (config.exchange.snapshot_port != 0) {
+        std::vector<SnapshotSource> sources;
+        for (const auto& sym_config : config.symbols) {
+            const Symbol symbol(sym_config.symbol.c_str());
+            const MatchingEngine* engine = exchange.get_matching_engine(symbol);
+            if (!engine) continue;
+            const BookIndex book = engine->book_index(symbol);
+            sources.push_back({engine, book, symbol, engine->market_data_channel(book)});
+        }
+        snapshots = std::make_unique<SnapshotPublisher>(
+            config.exchange.snapshot_group, config.exchange.snapshot_port, std::move(sources));
+        snapshots->set_rate(config.performance.snapshot_bytes_per_second);
+        snapshots->set_cycle_interval(config.performance.snapshot_interval_ms);
+        if (!config.performance.market_data_auth_key.empty()) {
+            snapshots->set_authentication(config.performance.market_data_auth_key);
+        }
+        snapshots->start();
+        guard.add([&] {
+            LOG_INFO("Rolling back: stopping snapshot channel");
+            snapshots->stop();
+        });
+    }
 
     // Start monitoring service for Prometheus metrics
-    MonitoringService monitoring(config.exchange.metrics_port, &exchange);
+    MonitoringService monitoring(config.exchange.metrics_port, &exchange,
+                                 std::chrono::milliseconds(config.exchange.metrics_refresh_ms),
+                                 std::chrono::milliseconds(config.exchange.dashboard_stream_ms));
+    // Off the hot cores and never real-time: a slow scrape must not compete with matching
+    if (config.performance.enable_cpu_pinning && config.performance.monitoring_core >= 0) {
+        monitoring.set_thread_placement(ThreadPlacement{config.performance.monitoring_core, 0});
+    }
+    for (const auto& publisher : udp_publishers) monitoring.add_market_data_publisher(publisher.get());
+    if (config.exchange.risk_reload_endpoint) monitoring.enable_risk_reload(config_path);
+    if (config.exchange.symbol_control_endpoint) monitoring.enable_symbol_control();
     monitoring.start();
     guard.add([&] {
         LOG_INFO("Rolling back: stopping monitoring");
@@ -251,9 +472,10 @@ void run_exchange(std::unique_ptr<Config> config_ptr) {
     LOG_INFO("══════════════════════════════════════════════");
     LOG_INFO("  RTES Exchange fully operational");
     LOG_INFO("  Orders:      TCP port {}", config.exchange.tcp_port);
-    LOG_INFO("  Market Data: UDP {}:{}", 
-             config.exchange.udp_multicast_group,
-             config.exchange.udp_port);
+    LOG_INFO("  Market Data: UDP {}:{} ({} channels)",
+             exchange.market_data_channels()[0].group,
+             exchange.market_data_channels()[0].port,
+             exchange.market_data_channels().size());
     LOG_INFO("  Metrics:     HTTP port {}", config.exchange.metrics_port);
     LOG_INFO("══════════════════════════════════════════════");
 
@@ -267,11 +489,54 @@ void run_exchange(std::unique_ptr<Config> config_ptr) {
     monitoring.stop();
     LOG_INFO("Monitoring stopped");
 
-    udp_publisher.stop();
-    LOG_INFO("UDP publisher stopped");
+    if (snapshots) {
+        snapshots->stop();
+        LOG_INFO("Snapshot channel stopped ({} snapshots in {} cycles)",
+                 snapshots->snapshots_sent(), snapshots->cycles());
+    }
+
+    for (auto& publisher : udp_publishers) {
+        publisher->stop();
+        const MarketDataDelay delay = publisher->publish_delay();
+        LOG_INFO("UDP publisher stopped ({} messages in {} packets, {} unrouted; "
+                 "match-to-publish avg {} ns, max {} ns)",
+                 publisher->messages_sent(), publisher->packets_sent(), publisher->unrouted(),
+                 delay.samples ? delay.sum_ns / delay.samples : 0, delay.max_ns);
+    }
+    if (retransmission) {
+        retransmission->stop();
+        size_t overflows = 0;
+        for (const auto& publisher : udp_publishers) overflows += publisher->retransmit_overflows();
+        LOG_INFO("Retransmission stopped ({} requests, {} throttled, {} datagrams replayed, {} copies dropped)",
+                 retransmission->requests(), retransmission->requests_throttled(),
+                 retransmission->packets_replayed(), overflows);
+    }
+
+    if (shm_gateway) {
+        shm_gateway->stop();
+        LOG_INFO("Shared memory order entry stopped ({} requests, {} refused, {} auth rejects, "
+                 "{} slow consumers)",
+                 shm_gateway->requests_received(), shm_gateway->requests_rejected(),
+                 shm_gateway->auth_rejects(), shm_gateway->slow_consumers());
+    }
 
     gateway.stop();
-    LOG_INFO("TCP gateway stopped");
+    const IngressLatency ingress = gateway.ingress_latency();
+    LOG_INFO("TCP gateway stopped ({} messages; wire-to-risk avg {} ns, max {} ns)",
+             gateway.messages_received(), ingress.avg_ns, ingress.max_ns);
+
+    if (drop_copy) {
+        drop_copy->stop();
+        LOG_INFO("Drop copy stopped ({} reports, {} copies dropped)",
+                 drop_copy->reports_journaled(),
+                 gateway.drop_copy_overflows() + (shm_gateway ? shm_gateway->drop_copy_overflows() : 0));
+    }
+
+    if (capture) {
+        capture->stop();
+        LOG_INFO("Session capture stopped ({} events, {} bytes, {} frames dropped) → {}",
+                 capture->events_written(), capture->bytes_written(), capture->drops(), capture->path());
+    }
 
     exchange.stop();
     LOG_INFO("Exchange core stopped");
@@ -308,6 +573,7 @@ int main(int argc, char* argv[]) {
     // ── Register signal handlers ──
     std::signal(SIGINT,  rtes::signal_handler);
     std::signal(SIGTERM, rtes::signal_handler);
+    std::signal(SIGUSR1, rtes::promote_handler);
 
     try {
         // ── Load configuration ──
@@ -324,12 +590,15 @@ int main(int argc, char* argv[]) {
         LOG_INFO("Configuration loaded from {}", argv[1]);
 
         // ── Run exchange (blocks until shutdown) ──
-        rtes::run_exchange(std::move(config));
+        rtes::run_exchange(std::move(config), argv[1]);
+        rtes::Logger::instance().stop_async();  // Flush what the writer still holds
 
     } catch (const std::exception& e) {
+        rtes::Logger::instance().stop_async();
         std::cerr << "Fatal error: " << e.what() << "\n";
         return EXIT_FAILURE;
     } catch (...) {
+        rtes::Logger::instance().stop_async();
         std::cerr << "Fatal error: unknown exception\n";
         return EXIT_FAILURE;
     }
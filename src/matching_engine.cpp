@@ -1,23 +1,28 @@
 /**
  * @file matching_engine.cpp
- * @brief Per-symbol matching engine with price-time priority
+ * @brief Matching engine (one thread, one or more books) with price-time priority
  */
 
 #include "rtes/matching_engine.hpp"
+#include "rtes/book_snapshot.hpp"
+#include "rtes/event_journal.hpp"
 #include "rtes/logger.hpp"
 
-#include <sched.h>
+#include <cassert>
 #include <cstring>
 #include <algorithm>
+#include <stdexcept>
+#include <utility>
 
 namespace rtes {
 
 inline constexpr size_t BATCH_SIZE           = 256;
-inline constexpr size_t SPIN_ITERATIONS      = 1024;
-inline constexpr size_t PAUSE_PER_SPIN       = 4;
 inline constexpr size_t STATS_FLUSH_INTERVAL = 4096;
-inline constexpr size_t COMPACT_INTERVAL     = 8192;
+inline constexpr size_t MAINTENANCE_SCAN     = 8;    // Books checked per maintenance pass
+inline constexpr size_t PRUNE_TOMBSTONES     = 32;   // Tombstones before a busy engine prunes a book
 inline constexpr size_t QUEUE_CAPACITY       = 65536;
+inline constexpr size_t FAIR_STAGE_CAPACITY  = 1024;  // Requests staged across a fair engine's books (power of 2)
+inline constexpr size_t PARKED_RESERVE       = 4 * BATCH_SIZE;  // Requests held for a vacant slot before it grows
 
 // ── Static trade callback ─────────────────────────────────────
 // OrderBook in order_book.cpp uses TradeCallback = void(*)(const Trade&)
@@ -33,20 +38,66 @@ static void trade_callback_trampoline(const Trade& trade, void* ctx) {
     engine->on_trade_internal(trade);
 }
 
+static void order_done_trampoline(const Order& order, void* ctx) {
+    static_cast<MatchingEngine*>(ctx)->on_order_done_internal(order);
+}
+
+static void order_fill_trampoline(const Order& order, Quantity quantity, Price price, void* ctx) {
+    static_cast<MatchingEngine*>(ctx)->on_order_fill_internal(order, quantity, price);
+}
+
+static void order_event_trampoline(const OrderEvent& event, void* ctx) {
+    static_cast<MatchingEngine*>(ctx)->on_order_event_internal(event);
+}
+
 // ═══════════════════════════════════════════════════════════════
 // THIS CONSTRUCTOR DEFINITION WAS MISSING!
 // ═══════════════════════════════════════════════════════════════
-MatchingEngine::MatchingEngine(const std::string& symbol, OrderPool& pool)
-    : symbol_(symbol)
+MatchingEngine::MatchingEngine(const std::string& symbol, OrderPool& pool,
+                               const OrderBookOptions& book_options,
+                               size_t ingress_lanes)
+    : MatchingEngine(symbol, std::vector<BookSpec>{{symbol, book_options}}, pool,
+                     ingress_lanes)
+{
+}
+
+MatchingEngine::MatchingEngine(std::string name, const std::vector<BookSpec>& books,
+                               OrderPool& pool, size_t ingress_lanes)
+    : drain_buffer_(BATCH_SIZE)
+    , name_(std::move(name))
     , pool_(pool)
-    , input_queue_(std::make_unique<SPSCQueue<OrderRequest>>(QUEUE_CAPACITY))
-    , book_(nullptr)
+    , released_(pool)
 {
-    book_ = std::make_unique<OrderBook>(symbol, pool, trade_callback_trampoline, this);
+    if (books.empty() || books.size() >= NO_BOOK) {
+        throw std::invalid_argument("MatchingEngine: book count out of range");
+    }
+
+    ingress_lanes = std::clamp<size_t>(ingress_lanes, 1, UINT16_MAX);
+    for (size_t i = 0; i < ingress_lanes; ++i) {
+        auto lane = std::make_unique<InputLane>();
+        lane->queue = std::make_unique<SPSCQueue<OrderRequest>>(QUEUE_CAPACITY);
+        lanes_.push_back(std::move(lane));
+    }
 
-    std::memset(symbol_cache_, 0, sizeof(symbol_cache_));
-    std::memcpy(symbol_cache_, symbol.c_str(),
-                std::min(symbol.size(), sizeof(symbol_cache_) - 1));
+    books_.resize(books.size());
+    depth_views_   = std::make_unique<std::atomic<const OrderBook*>[]>(books.size());
+    book_requests_ = std::make_unique<std::atomic<uint64_t>[]>(books.size());
+    hosting_       = std::make_unique<std::atomic<bool>[]>(books.size());
+    for (size_t i = 0; i < books.size(); ++i) {
+        BookSlot& slot = books_[i];
+        std::memcpy(slot.symbol, books[i].symbol.c_str(),
+                    std::min(books[i].symbol.size(), sizeof(slot.symbol) - 1));
+        slot.weight = std::max<uint32_t>(1, books[i].weight);
+        if (!books[i].hosted) continue;  // Vacant until a book is adopted into it
+        owned_books_.push_back(std::make_unique<OrderBook>(books[i].symbol, pool,
+                                                           trade_callback_trampoline,
+                                                           this, books[i].options));
+        attach(static_cast<BookIndex>(i), owned_books_.back().get());
+    }
+    active_ = &books_[0];
+    depth_dirty_.reserve(books_.size());
+    bbo_dirty_.reserve(books_.size());
+    parked_.reserve(PARKED_RESERVE);  // Parking never allocates on the worker unless a handoff outlasts it
 }
 
 MatchingEngine::~MatchingEngine() {
@@ -65,7 +116,7 @@ void MatchingEngine::start() {
     }
 
     worker_thread_ = std::thread(&MatchingEngine::run, this);
-    LOG_INFO("Matching engine started for {}", symbol_);
+    LOG_INFO("Matching engine started for {} ({} books)", name_, books_.size());
 }
 
 void MatchingEngine::stop() {
@@ -75,12 +126,13 @@ void MatchingEngine::stop() {
         return;
     }
 
+    idle_.notify();  // Unpark the worker so it sees running_ == false
     if (worker_thread_.joinable()) {
         worker_thread_.join();
     }
 
     LOG_INFO("Matching engine stopped for {} (processed={}, trades={})",
-             symbol_,
+             name_,
              orders_processed_.load(std::memory_order_relaxed),
              trades_executed_.load(std::memory_order_relaxed));
 }
@@ -89,30 +141,226 @@ void MatchingEngine::stop() {
 //  Order Submission (called from gateway/risk thread)
 // ═══════════════════════════════════════════════════════════════
 
-bool MatchingEngine::submit_order(Order* order) {
-    if (!order) [[unlikely]] return false;
+BookIndex MatchingEngine::book_index(const Symbol& symbol) const {
+    for (size_t i = 0; i < books_.size(); ++i) {
+        if (std::strncmp(books_[i].symbol, symbol.c_str(), sizeof(books_[i].symbol)) == 0) {
+            return static_cast<BookIndex>(i);
+        }
+    }
+    return NO_BOOK;
+}
 
-    OrderRequest request = OrderRequest::make_new_order(order);  // ← use factory
+bool MatchingEngine::push_request(const OrderRequest& request, IngressLane lane) {
+    if (lane >= lanes_.size()) [[unlikely]] return false;
+    InputLane& target = *lanes_[lane];
 
-    if (!input_queue_->push(request)) [[unlikely]] {
-        ++local_stats_.queue_full_count;
+    if (!target.queue->push(request)) [[unlikely]] {
+        target.drops.store(target.drops.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);  // Single producer per lane
         return false;
     }
+    target.submitted.store(target.submitted.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+    idle_.notify();
     return true;
 }
 
-bool MatchingEngine::cancel_order(OrderID order_id, ClientID client_id) {
-    OrderRequest request = OrderRequest::make_cancel(order_id, client_id);  // ← use factory
+bool MatchingEngine::submit_order(Order* order, BookIndex book, IngressLane lane) {
+    if (!order || book >= books_.size()) [[unlikely]] return false;
+    assert(pool_.owns(order) && "Order not from this engine's pool");
+    return push_request(OrderRequest::make_new_order(pool_.handle(order), book), lane);
+}
 
-    if (!input_queue_->push(request)) [[unlikely]] {
-        ++local_stats_.queue_full_count;
-        return false;
+bool MatchingEngine::cancel_order(OrderID order_id, ClientID /*client_id*/, BookIndex book,
+                                  IngressLane lane) {
+    if (book >= books_.size()) [[unlikely]] return false;
+    return push_request(OrderRequest::make_cancel(order_id, book), lane);
+}
+
+bool MatchingEngine::modify_order(OrderID order_id, ClientID /*client_id*/,
+                                  Quantity new_quantity, Price new_price, BookIndex book,
+                                  IngressLane lane) {
+    if (book >= books_.size()) [[unlikely]] return false;
+    return push_request(OrderRequest::make_modify(order_id, new_quantity, new_price, book), lane);
+}
+
+bool MatchingEngine::set_trading_phase(TradingPhase phase, BookIndex book, IngressLane lane) {
+    if (book >= books_.size()) [[unlikely]] return false;
+    return push_request(OrderRequest::make_phase(phase, book), lane);
+}
+
+bool MatchingEngine::mass_cancel(ClientIDRaw owner, BookIndex book, IngressLane lane) {
+    if (book != NO_BOOK && book >= books_.size()) [[unlikely]] return false;
+    return push_request(OrderRequest::make_mass_cancel(owner, book), lane);
+}
+
+size_t MatchingEngine::submit_requests(const OrderRequest* requests, size_t count, IngressLane lane) {
+    if (lane >= lanes_.size() || count == 0) [[unlikely]] return 0;
+    size_t valid = 0;
+    for (; valid < count; ++valid) {
+        const OrderRequest& request = requests[valid];
+        if (request.type >= OrderRequest::RELEASE_BOOK) [[unlikely]] break;
+        if (request.book >= books_.size() &&
+            !(request.type == OrderRequest::MASS_CANCEL && request.book == NO_BOOK)) [[unlikely]] break;
     }
-    return true;
+
+    InputLane& target = *lanes_[lane];
+    const size_t pushed = valid ? target.queue->try_push_bulk(requests, valid) : 0;
+    if (pushed < count) [[unlikely]] {
+        target.drops.store(target.drops.load(std::memory_order_relaxed) + (count - pushed),
+                           std::memory_order_relaxed);  // Single producer per lane
+    }
+    if (pushed == 0) return 0;
+    target.submitted.store(target.submitted.load(std::memory_order_relaxed) + pushed,
+                           std::memory_order_relaxed);
+    idle_.notify();
+    return pushed;
+}
+
+bool MatchingEngine::release_book(BookIndex book, IngressLane lane) {
+    if (book >= books_.size()) [[unlikely]] return false;
+    uint8_t expected = RELEASE_IDLE;
+    if (!release_state_.compare_exchange_strong(expected, RELEASING, std::memory_order_acq_rel)) {
+        return false;  // One release at a time
+    }
+    if (push_request(OrderRequest::make_release(book), lane)) return true;
+    release_state_.store(RELEASE_IDLE, std::memory_order_release);
+    return false;
+}
+
+bool MatchingEngine::adopt_book(MatchingEngine& from, BookIndex book, IngressLane lane) {
+    if (book >= books_.size()) [[unlikely]] return false;
+    return push_request(OrderRequest::make_adopt(&from, book), lane);
+}
+
+std::vector<IngressLaneStats> MatchingEngine::lane_stats() const {
+    std::vector<IngressLaneStats> stats;
+    stats.reserve(lanes_.size());
+    for (const auto& lane : lanes_) {
+        stats.push_back({
+            .depth     = lane->queue->size(),
+            .submitted = lane->submitted.load(std::memory_order_relaxed),
+            .drops     = lane->drops.load(std::memory_order_relaxed),
+            .capacity  = lane->queue->capacity(),
+            .telemetry = lane->queue->telemetry(),
+        });
+    }
+    return stats;
+}
+
+void MatchingEngine::set_fair_scheduling(size_t slice) {
+    fair_slice_ = (books_.size() > 1) ? slice : 0;
+    stages_.clear();
+    ready_.clear();
+    schedule_counters_.reset();
+    if (fair_slice_ == 0) return;
+
+    // Every stage can hold the whole staging budget, so staging never overflows one
+    stages_.resize(books_.size());
+    for (BookStage& stage : stages_) {
+        stage.requests  = std::make_unique<OrderRequest[]>(FAIR_STAGE_CAPACITY);
+        stage.staged_at = std::make_unique<Timestamp[]>(FAIR_STAGE_CAPACITY);
+    }
+    ready_.reserve(books_.size());
+    ready_next_.reserve(books_.size());
+    schedule_counters_ = std::make_unique<BookScheduleCounters[]>(books_.size());
+}
+
+std::vector<uint64_t> MatchingEngine::book_requests() const {
+    std::vector<uint64_t> requests(books_.size());
+    for (size_t i = 0; i < books_.size(); ++i) {
+        requests[i] = book_requests_[i].load(std::memory_order_relaxed);
+    }
+    return requests;
+}
+
+std::vector<BookScheduleStats> MatchingEngine::schedule_stats() const {
+    std::vector<BookScheduleStats> stats;
+    if (!schedule_counters_) return stats;
+    stats.reserve(books_.size());
+    for (size_t i = 0; i < books_.size(); ++i) {
+        const BookScheduleCounters& counters = schedule_counters_[i];
+        stats.push_back({
+            .symbol       = books_[i].symbol,
+            .requests     = counters.requests.load(std::memory_order_relaxed),
+            .delay_sum_ns = counters.delay_sum_ns.load(std::memory_order_relaxed),
+            .delay_max_ns = counters.delay_max_ns.load(std::memory_order_relaxed),
+            .backlog      = counters.backlog.load(std::memory_order_relaxed),
+        });
+    }
+    return stats;
 }
 
-void MatchingEngine::set_market_data_queue(MPMCQueue<MarketDataEvent>* queue) {
-    market_data_queue_ = queue;
+void MatchingEngine::set_market_data_queue(MarketDataLane* lane, IdleStrategy* reader_idle) {
+    for (auto& slot : books_) slot.md_queue = lane;
+    market_data_readers_.clear();
+    if (reader_idle) market_data_readers_.push_back(reader_idle);
+}
+
+void MatchingEngine::set_market_data_route(BookIndex book, uint8_t channel,
+                                           MarketDataLane* lane, IdleStrategy* reader_idle) {
+    BookSlot& slot = books_.at(book);
+    slot.md_queue   = lane;
+    slot.md_channel = channel;
+    if (reader_idle && std::find(market_data_readers_.begin(), market_data_readers_.end(),
+                                 reader_idle) == market_data_readers_.end()) {
+        market_data_readers_.push_back(reader_idle);
+    }
+}
+
+void MatchingEngine::set_order_feed_route(BookIndex book, uint8_t channel,
+                                          MarketDataLane* lane, IdleStrategy* reader_idle) {
+    BookSlot& slot = books_.at(book);
+    slot.mbo_queue   = lane;
+    slot.mbo_channel = channel;
+    if (slot.book) slot.book->set_order_event_callback(lane ? order_event_trampoline : nullptr);
+    if (reader_idle && std::find(market_data_readers_.begin(), market_data_readers_.end(),
+                                 reader_idle) == market_data_readers_.end()) {
+        market_data_readers_.push_back(reader_idle);
+    }
+}
+
+void MatchingEngine::set_execution_queue(SPSCQueue<ExecutionReport>* queue,
+                                         EventDoorbell* reader_bell) {
+    execution_egress_.assign({queue}, {reader_bell});
+}
+
+void MatchingEngine::set_execution_queues(const std::vector<SPSCQueue<ExecutionReport>*>& queues,
+                                          const std::vector<EventDoorbell*>& reader_bells) {
+    execution_egress_.assign(queues, reader_bells);
+}
+
+void MatchingEngine::set_risk_feedback(std::vector<SPSCQueue<RiskFeedback>*> rings) {
+    risk_feedback_ = std::move(rings);
+}
+
+void MatchingEngine::set_reference_prices(ReferencePriceTable& table) {
+    for (auto& slot : books_) {
+        slot.reference_price = table.slot(Symbol(slot.symbol));
+    }
+}
+
+void MatchingEngine::set_bbo_table(BBOTable& table) {
+    for (auto& slot : books_) {
+        if (slot.book) slot.book->set_bbo_slot(table.slot(Symbol(slot.symbol)));  // Travels with the book
+    }
+}
+
+void MatchingEngine::set_book_snapshots(BookSnapshotSlot* slot, std::chrono::milliseconds interval) {
+    snapshot_slot_ = slot;
+    snapshot_interval_ns_ = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count());
+    if (slot) slot->image.books.resize(books_.size());
+}
+
+void MatchingEngine::set_depth_publishing(const DepthPublishPolicy& policy) {
+    if (policy.levels > MAX_DEPTH_LEVELS) {
+        throw std::invalid_argument("MatchingEngine: depth levels above MAX_DEPTH_LEVELS");
+    }
+    depth_policy_ = policy;
+    for (auto& slot : books_) {
+        if (slot.book) slot.book->track_level_changes(policy.incremental);
+    }
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -120,57 +368,375 @@ void MatchingEngine::set_market_data_queue(MPMCQueue<MarketDataEvent>* queue) {
 // ═══════════════════════════════════════════════════════════════
 
 void MatchingEngine::run() {
-    LOG_INFO("Matching engine worker started for {}", symbol_);
+    applied_placement_.store(apply_thread_placement(placement_, name_.c_str()),
+                             std::memory_order_relaxed);
+    LOG_INFO("Matching engine worker started for {}", name_);
 
     while (running_.load(std::memory_order_relaxed)) {
         size_t processed = drain_batch();
 
         if (processed > 0) {
-            maybe_compact();
-            maybe_flush_stats();
+            idle_.on_work();
+            for (IdleStrategy* reader : market_data_readers_) reader->notify();
+            if (replication_acked_) [[unlikely]] release_held(false);
+            execution_egress_.ring();
+            maybe_publish_depth();
+            maintain(false);
+            maybe_snapshot();
+            if (release_.book != NO_BOOK) [[unlikely]] advance_release();
         } else {
-            spin_wait();
+            maybe_publish_depth();  // Interval trigger fires while idle too (parks are bounded)
+            maybe_snapshot();
+            if (replication_acked_ && release_held(false) > 0) [[unlikely]] {
+                execution_egress_.ring();
+                continue;
+            }
+            if (release_.book != NO_BOOK) [[unlikely]] {
+                advance_release();
+                continue;  // Polls the output readers until they pass the book's last events
+            }
+            if (maintain(true)) continue;  // Budget spent with work left: another slice first
+            idle_.idle([this] { return any_lane_pending() || (replication_acked_ && held_ready()); });
         }
     }
 
-    LOG_INFO("Draining remaining orders for {}", symbol_);
+    LOG_INFO("Draining remaining orders for {}", name_);
     size_t drained = 0;
     while (true) {
         size_t batch = drain_batch();
         if (batch == 0) break;
         drained += batch;
     }
+    // Orderly stop: the journal still sends the standby these requests
+    if (replication_acked_) release_held(true);
+    execution_egress_.ring();
 
+    for (BookIndex i : depth_dirty_) {
+        books_[i].book->publish_depth(depth_policy_.levels, books_[i].depth_sequence);
+    }
+    depth_dirty_.clear();
     flush_stats();
+    if (snapshot_slot_) capture_snapshot();  // The state the next start resumes from
 
     if (drained > 0) {
-        LOG_INFO("Drained {} remaining orders for {}", drained, symbol_);
+        LOG_INFO("Drained {} remaining orders for {}", drained, name_);
     }
-    LOG_INFO("Matching engine worker exited for {}", symbol_);
+    LOG_INFO("Matching engine worker exited for {}", name_);
 }
 
+/**
+ * Drain up to BATCH_SIZE requests across the input lanes: an equal
+ * share per lane, starting lane rotating per batch. Order holds within
+ * a lane, and risk shards partition clients, so a client's requests
+ * never race each other across lanes.
+ */
 size_t MatchingEngine::drain_batch() {
-    OrderRequest request;
-    size_t count = 0;
+    if (journal_) [[unlikely]] journal_time_ = now_timestamp();
 
-    while (count < BATCH_SIZE && input_queue_->pop(request)) {
-        input_queue_->prefetch_next();
+    size_t total = 0;
+    if (next_pause_end_ns_ != 0) [[unlikely]] total += end_volatility_pauses();
+    const size_t budget = (total < BATCH_SIZE) ? BATCH_SIZE - total : 0;
+    total += stages_.empty() ? drain_lanes(budget) : drain_fair(budget);
+    if (!bbo_dirty_.empty()) publish_conflated_bbo();
+    released_.flush();  // One bulk push for every order retired this cycle
 
-        switch (request.type) {
-            case OrderRequest::NEW_ORDER:
-                process_new_order(request.new_order.order);       // ← FIXED
-                break;
+    local_stats_.total_processed += total;
+    return total;
+}
+
+size_t MatchingEngine::drain_lanes(size_t budget) {
+    const size_t lanes = lanes_.size();
+    const size_t share = std::max<size_t>(1, BATCH_SIZE / lanes);
+    size_t total = 0;
+    for (size_t n = 0; n < lanes && total < budget; ++n) {
+        // One tail publish per lane visit; slots are free for the producer
+        // while the run is being matched.
+        InputLane& lane = *lanes_[(next_lane_ + n) % lanes];
+        const size_t count = lane.queue->try_pop_bulk(
+            drain_buffer_.data(), std::min(share, budget - total));
+        for (size_t i = 0; i < count; ++i) process_request(drain_buffer_[i]);
+        total += count;
+    }
+    next_lane_ = (next_lane_ + 1) % lanes;
+    return total;
+}
+
+/**
+ * Fair scheduling: stage, then give each ready book one turn of up to
+ * slice × weight requests (deficit round robin) until `budget` is used.
+ * Books the budget did not reach keep their place at the front; books
+ * served with requests left go to the back.
+ */
+size_t MatchingEngine::drain_fair(size_t budget) {
+    size_t total = stage_lanes();
+
+    size_t served = 0;
+    for (; served < ready_.size() && total < budget; ++served) {
+        const BookIndex index = ready_[served];
+        BookStage& stage = stages_[index];
+        stage.deficit += fair_slice_ * books_[index].weight;
+        const size_t run = std::min<uint64_t>(stage.deficit, stage.count);
+        serve_stage(index, run);
+        stage.deficit = stage.count ? stage.deficit - run : 0;  // An emptied stage keeps no credit
+        total += run;
+    }
+    if (served == 0) return total;
 
-            case OrderRequest::CANCEL_ORDER:
-                process_cancel(request.cancel.order_id,           // ← FIXED
-                               request.cancel.client_id);         // ← FIXED
+    ready_next_.assign(ready_.begin() + served, ready_.end());
+    for (size_t i = 0; i < served; ++i) {
+        if (stages_[ready_[i]].count) ready_next_.push_back(ready_[i]);
+    }
+    ready_.swap(ready_next_);
+    return total;
+}
+
+size_t MatchingEngine::stage_lanes() {
+    const size_t want = std::min(BATCH_SIZE, FAIR_STAGE_CAPACITY - staged_total_);
+    if (want == 0) return 0;  // Full: the lanes hold the rest (backpressure as before)
+
+    const size_t lanes = lanes_.size();
+    const size_t share = std::max<size_t>(1, want / lanes);
+    const Timestamp now = now_timestamp();
+    size_t taken = 0;
+    size_t matched = 0;
+    for (size_t n = 0; n < lanes && taken < want; ++n) {
+        InputLane& lane = *lanes_[(next_lane_ + n) % lanes];
+        const size_t count = lane.queue->try_pop_bulk(
+            drain_buffer_.data(), std::min(share, want - taken));
+        for (size_t i = 0; i < count; ++i) {
+            const OrderRequest& request = drain_buffer_[i];
+            if (request.book == NO_BOOK) [[unlikely]] {  // Mass cancel of every book
+                matched += flush_stages();
+                process_request(request);
+                ++matched;
+                continue;
+            }
+            BookStage& stage = stages_[request.book];
+            if (stage.count == 0) ready_.push_back(request.book);
+            const uint32_t at = (stage.head + stage.count++) & (FAIR_STAGE_CAPACITY - 1);
+            stage.requests[at]  = request;
+            stage.staged_at[at] = now;
+            ++staged_total_;
+        }
+        taken += count;
+    }
+    next_lane_ = (next_lane_ + 1) % lanes;
+    return matched;
+}
+
+void MatchingEngine::serve_stage(BookIndex index, size_t run) {
+    BookStage& stage = stages_[index];
+    const Timestamp now = now_timestamp();  // One read per run: delay is the wait for this turn
+    uint64_t delay_sum = 0;
+    uint64_t delay_max = 0;
+    for (size_t i = 0; i < run; ++i) {
+        const uint32_t at = (stage.head + i) & (FAIR_STAGE_CAPACITY - 1);
+        const uint64_t delay = now - stage.staged_at[at];
+        delay_sum += delay;
+        delay_max  = std::max(delay_max, delay);
+        process_request(stage.requests[at]);
+    }
+    stage.head   = (stage.head + run) & (FAIR_STAGE_CAPACITY - 1);
+    stage.count -= static_cast<uint32_t>(run);
+    staged_total_ -= run;
+
+    // Single writer: plain read-modify-write, relaxed
+    BookScheduleCounters& counters = schedule_counters_[index];
+    counters.requests.store(counters.requests.load(std::memory_order_relaxed) + run, std::memory_order_relaxed);
+    counters.delay_sum_ns.store(counters.delay_sum_ns.load(std::memory_order_relaxed) + delay_sum,
+                                std::memory_order_relaxed);
+    if (delay_max > counters.delay_max_ns.load(std::memory_order_relaxed)) {
+        counters.delay_max_ns.store(delay_max, std::memory_order_relaxed);
+    }
+    counters.backlog.store(stage.count, std::memory_order_relaxed);
+}
+
+size_t MatchingEngine::flush_stages() {
+    size_t matched = 0;
+    for (BookIndex index : ready_) {
+        BookStage& stage = stages_[index];
+        matched += stage.count;
+        serve_stage(index, stage.count);
+        stage.deficit = 0;
+    }
+    ready_.clear();
+    return matched;
+}
+
+size_t MatchingEngine::restore(const EngineSnapshot& snapshot) {
+    size_t restored = 0;
+    for (const BookImage& image : snapshot.books) {
+        const BookIndex index = book_index(Symbol(image.header.symbol));
+        if (index == NO_BOOK) {
+            LOG_WARN("Engine {}: snapshot book {} is not hosted here, skipped", name_, image.header.symbol);
+            continue;
+        }
+        active_ = &books_[index];
+        if (!active_->book) continue;  // Vacant: the book lives on another engine
+        auto result = active_->book->restore(image);
+        if (result.has_error()) {
+            LOG_ERROR("Engine {}: restoring {} failed ({})", name_, image.header.symbol,
+                      static_cast<int>(result.error().value()));
+        }
+        restored += active_->book->order_count();
+        if (active_->reference_price && image.header.last_trade_price != 0) {
+            active_->reference_price->price.store(image.header.last_trade_price, std::memory_order_relaxed);
+        }
+        mark_depth_pending();
+    }
+    return restored;
+}
+
+size_t MatchingEngine::replay(std::span<const JournalRecord> records, JournalLane* outputs) {
+    // The run that journaled these requests published their outputs already
+    JournalLane* journal = std::exchange(journal_, outputs);
+    const Timestamp journal_time = journal_time_;
+    OrderTracer* tracer  = std::exchange(tracer_, nullptr);
+    ExecutionEgress egress = std::exchange(execution_egress_, ExecutionEgress{});
+    std::vector<SPSCQueue<RiskFeedback>*> feedback = std::exchange(risk_feedback_, {});
+    std::vector<MarketDataLane*> market_data;
+    for (BookSlot& slot : books_) market_data.push_back(std::exchange(slot.md_queue, nullptr));
+
+    size_t replayed = 0;
+    Timestamp clock = 0;
+    for (const JournalRecord& record : records) {
+        if (outputs && record.time != clock) {  // A new recorded batch
+            clock = journal_time_ = record.time;
+            for (BookSlot& slot : books_) {
+                if (slot.book) slot.book->set_clock(clock);
+            }
+        }
+        OrderRequest request;
+        request.book = record.book;
+        switch (record.type) {
+            case JournalRecordType::NEW_ORDER: {
+                Order* order = pool_.allocate();
+                if (!order) [[unlikely]] {
+                    LOG_ERROR("Engine {}: order pool exhausted replaying order {}", name_, record.new_order.id);
+                    continue;
+                }
+                const auto& in = record.new_order;
+                new (order) Order();
+                order->id               = in.id;
+                order->price            = in.price;
+                order->quantity         = in.quantity;
+                order->remaining_quantity = in.quantity;
+                order->display_quantity = in.display_quantity;
+                order->stop_price       = in.stop_price;
+                order->timestamp        = in.timestamp;
+                order->symbol           = in.symbol;
+                order->client_id        = in.client_id;
+                order->owner            = in.owner;
+                order->side             = in.side;
+                order->type             = in.type;
+                order->ingress          = in.ingress;
+                request = OrderRequest::make_new_order(pool_.handle(order), record.book);
+                break;
+            }
+            case JournalRecordType::CANCEL_ORDER:
+                request = OrderRequest::make_cancel(record.order.id, record.book);
+                break;
+            case JournalRecordType::MODIFY_ORDER:
+                request = OrderRequest::make_modify(record.modify.id, record.modify.new_quantity,
+                                                    record.modify.new_price, record.book);
                 break;
+            case JournalRecordType::SET_PHASE:
+                request = OrderRequest::make_phase(record.phase, record.book);
+                break;
+            case JournalRecordType::MASS_CANCEL:
+                request = OrderRequest::make_mass_cancel(record.mass_cancel.owner, record.book);
+                break;
+            default:
+                continue;  // Outputs: reproduced by the requests
+        }
+        const bool every_book = request.type == OrderRequest::MASS_CANCEL && request.book == NO_BOOK;
+        if (!every_book && (request.book >= books_.size() || !books_[request.book].book)) [[unlikely]] {
+            if (request.type == OrderRequest::NEW_ORDER) pool_.deallocate(pool_.at(request.new_order.order));
+            continue;
         }
-        ++count;
+        process_request(request);
+        ++replayed;
     }
+    released_.flush();
+    local_stats_.total_processed += replayed;
+    flush_stats();
+    if (clock != 0) {
+        for (BookSlot& slot : books_) {
+            if (slot.book) slot.book->set_clock(0);
+        }
+    }
+
+    journal_          = journal;
+    journal_time_     = journal_time;
+    tracer_           = tracer;
+    execution_egress_ = std::move(egress);
+    risk_feedback_    = std::move(feedback);
+    for (size_t i = 0; i < books_.size(); ++i) books_[i].md_queue = market_data[i];
+    return replayed;
+}
 
-    local_stats_.total_processed += count;
-    return count;
+bool MatchingEngine::any_lane_pending() {
+    if (staged_total_ > 0) return true;
+    for (auto& lane : lanes_) {
+        if (!lane->queue->consumer_empty()) return true;
+    }
+    return false;
+}
+
+void MatchingEngine::process_request(const OrderRequest& request) {
+    if (request.type >= OrderRequest::RELEASE_BOOK) [[unlikely]] {  // Not journaled: state moves, not orders
+        if (request.type == OrderRequest::RELEASE_BOOK) begin_release(request.book);
+        else adopt(*request.adopt.from, request.book);
+        return;
+    }
+    if (request.type != OrderRequest::MASS_CANCEL) [[likely]] {
+        active_ = &books_[request.book];  // Bounds checked at submit
+        if (!active_->book) [[unlikely]] {  // Routed here ahead of its book: held for adopt()
+            parked_.push_back(request);
+            return;
+        }
+        ++active_->requests;
+    }
+    if (journal_) [[unlikely]] journal_request(request);  // Before its outputs
+    if (request.type == OrderRequest::MASS_CANCEL) [[unlikely]] {
+        process_mass_cancel(request.mass_cancel.owner, request.book);  // May be NO_BOOK
+        return;
+    }
+
+    switch (request.type) {
+        case OrderRequest::NEW_ORDER:
+            if (tracer_) [[unlikely]] {
+                // Released only at the end of the batch, so the record is still ours
+                const OrderHandle handle = request.new_order.order;
+                const OrderID id = pool_.at(handle)->id;
+                tracer_->stamp(handle, id, OrderStage::ENGINE_DEQUEUE);
+                process_new_order(pool_.at(handle));
+                tracer_->finish(handle, id, trace_sink_);
+                break;
+            }
+            process_new_order(pool_.at(request.new_order.order));
+            break;
+
+        case OrderRequest::CANCEL_ORDER:
+            process_cancel(request.cancel.order_id);
+            break;
+
+        case OrderRequest::MODIFY_ORDER:
+            process_modify(request.modify.order_id,
+                           request.modify.new_quantity,
+                           request.modify.new_price);
+            break;
+
+        case OrderRequest::SET_PHASE:
+            process_phase_change(request.phase_change.phase);
+            break;
+
+        case OrderRequest::MASS_CANCEL:
+        case OrderRequest::RELEASE_BOOK:
+        case OrderRequest::ADOPT_BOOK:
+            break;  // Handled above
+    }
+    if (trade_batch_count_ || sweep_.sweep.fills) flush_trades();
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -180,46 +746,266 @@ size_t MatchingEngine::drain_batch() {
 void MatchingEngine::process_new_order(Order* order) {
     if (!order) [[unlikely]] return;
 
-    const Price old_bid = book_->best_bid();
-    const Price old_ask = book_->best_ask();
+    const TradingPhase old_phase = active_->book->phase();
 
-    auto result = book_->add_order(order);
+    auto result = active_->book->add_order(order);
 
     if (result.has_value()) {
+        const BookChange& change = result.value();
         ++local_stats_.orders_accepted;
+        if (change.levels) mark_depth_pending();
+        if (active_->book->phase() != old_phase) [[unlikely]] begin_volatility_pause();
 
-        const Price new_bid = book_->best_bid();
-        const Price new_ask = book_->best_ask();
-        if (new_bid != old_bid || new_ask != old_ask) {
-            publish_bbo_update();
+        // Aggressor that did not rest (filled, or IOC remainder cancelled)
+        if (order->status == OrderStatus::FILLED || order->status == OrderStatus::CANCELLED) {
+            on_order_done_internal(*order);
+            released_.add(order);
         }
+
+        if (change.moved()) publish_bbo_update();
     } else {
         ++local_stats_.orders_rejected;
         order->status = OrderStatus::REJECTED;
-        pool_.deallocate(order);
-
+        if (journal_) [[unlikely]] {
+            JournalRecord record;
+            record.type          = JournalRecordType::ORDER_REJECT;
+            record.reject.id     = order->id;
+            record.reject.reason = static_cast<uint32_t>(result.error().value());
+            journal_output(record);
+        }
+        publish_execution(ExecutionReport::make_reject(
+            order->id, static_cast<uint32_t>(result.error().value()), order->ingress),
+            order->ingress);
+        publish_risk_feedback(order->owner, RiskFeedback::make_done(order->id));
         LOG_DEBUG("Order {} rejected: {}", order->id,
                   result.error().value());                        // ← FIXED
+        released_.add(order);
     }
 }
 
-void MatchingEngine::process_cancel(OrderID order_id, ClientID client_id) {
-    const Price old_bid = book_->best_bid();
-    const Price old_ask = book_->best_ask();
-
-    auto result = book_->cancel_order(order_id);
+void MatchingEngine::process_cancel(OrderID order_id) {
+    auto result = active_->book->cancel_order(order_id);
 
     if (result.has_value()) {
+        const BookChange& change = result.value();
         ++local_stats_.cancels_accepted;
+        if (change.levels) mark_depth_pending();
+        if (change.moved()) publish_bbo_update();
+    } else {
+        ++local_stats_.cancels_rejected;
+    }
+}
 
-        const Price new_bid = book_->best_bid();
-        const Price new_ask = book_->best_ask();
-        if (new_bid != old_bid || new_ask != old_ask) {
-            publish_bbo_update();
+void MatchingEngine::process_mass_cancel(ClientIDRaw owner, BookIndex book) {
+    const size_t first = (book == NO_BOOK) ? 0 : book;
+    const size_t last  = (book == NO_BOOK) ? books_.size() : book + 1;
+
+    const BookIndex incoming = incoming_book_.load(std::memory_order_relaxed);
+    for (size_t i = first; i < last; ++i) {
+        active_ = &books_[i];
+        if (!active_->book) [[unlikely]] {
+            // Its book may still hold orders of `owner`: sweep it once adopted
+            if (i == incoming) parked_.push_back(OrderRequest::make_mass_cancel(owner, incoming));
+            continue;
         }
+        const size_t cancelled = active_->book->mass_cancel(owner);
+        if (cancelled == 0) continue;
+
+        const BookChange& change = active_->book->last_change();
+        local_stats_.cancels_accepted += cancelled;
+        if (change.levels) mark_depth_pending();
+        if (change.moved()) publish_bbo_update();
+    }
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Book Migration
+// ═══════════════════════════════════════════════════════════════
+
+void MatchingEngine::attach(BookIndex index, OrderBook* book) {
+    BookSlot& slot = books_[index];
+    slot.book = book;
+    book->set_callback_context(this);
+    book->set_order_done_callback(order_done_trampoline);
+    book->set_order_fill_callback(order_fill_trampoline);
+    book->set_order_event_callback(slot.mbo_queue ? order_event_trampoline : nullptr);
+    book->set_release_batch(&released_);
+    book->track_level_changes(depth_policy_.incremental);
+    depth_views_[index].store(book, std::memory_order_release);
+    hosting_[index].store(true, std::memory_order_release);
+}
+
+/**
+ * Producers stopped routing to the book before this request was queued,
+ * so whatever they sent it sits below each lane's push position now.
+ * advance_release() detaches the book once the worker has read past them.
+ */
+void MatchingEngine::begin_release(BookIndex book) {
+    if (!books_[book].book) [[unlikely]] {
+        LOG_WARN("Engine {}: nothing to release for book {}", name_, book);
+        release_state_.store(RELEASE_IDLE, std::memory_order_release);
+        return;
+    }
+    release_ = BookRelease{};
+    release_.book = book;
+    for (const auto& lane : lanes_) release_.lanes.push_back(lane->queue->pushed());
+}
+
+/**
+ * Between batches: first every request for the book is matched (lane
+ * positions passed, nothing staged or held), then the book is detached
+ * and the output positions taken; once each reader is past them, its
+ * next engine may publish for it without overtaking anything.
+ */
+void MatchingEngine::advance_release() {
+    BookSlot& slot = books_[release_.book];
+    if (!release_.detached) {
+        for (size_t i = 0; i < lanes_.size(); ++i) {
+            if (lanes_[i]->queue->popped() < release_.lanes[i]) return;
+        }
+        if (!stages_.empty() && stages_[release_.book].count != 0) return;
+        if (held_head_ < held_.size()) return;
+
+        const auto dirty = std::find(depth_dirty_.begin(), depth_dirty_.end(), release_.book);
+        if (dirty != depth_dirty_.end()) {
+            slot.book->publish_depth(depth_policy_.levels, slot.depth_sequence);
+            depth_dirty_.erase(dirty);
+        }
+        handoff_ = BookHandoff{slot.book, slot.depth_sequence, slot.pause_end_ns};
+        slot.book = nullptr;
+        hosting_[release_.book].store(false, std::memory_order_release);
+        slot.pause_end_ns = 0;
+
+        for (MarketDataLane* lane : {slot.md_queue, slot.mbo_queue}) {
+            if (lane) release_.market_data.emplace_back(lane, lane->pushed());
+        }
+        release_.reports = execution_egress_.positions();
+        for (const auto* ring : risk_feedback_) release_.feedback.push_back(ring->pushed());
+        release_.detached = true;
+        for (IdleStrategy* reader : market_data_readers_) reader->notify();
+    }
+
+    for (const auto& [lane, position] : release_.market_data) {
+        if (lane->popped() < position) return;
+    }
+    if (!execution_egress_.drained_through(release_.reports)) return;
+    for (size_t i = 0; i < risk_feedback_.size(); ++i) {
+        if (risk_feedback_[i]->popped() < release_.feedback[i]) return;
+    }
+    LOG_INFO("Engine {}: released {}", name_, slot.symbol);
+    release_.book = NO_BOOK;
+    release_state_.store(RELEASED, std::memory_order_release);
+}
+
+void MatchingEngine::adopt(MatchingEngine& from, BookIndex book) {
+    if (books_[book].book || !from.book_released()) [[unlikely]] {
+        LOG_ERROR("Engine {}: {} has no released book for slot {}", name_, from.name(), book);
+        return;
+    }
+    const BookHandoff handoff = from.handoff_;
+    from.release_state_.store(RELEASE_IDLE, std::memory_order_release);
+
+    BookSlot& slot = books_[book];
+    attach(book, handoff.book);
+    slot.depth_sequence = handoff.depth_sequence;
+    slot.pause_end_ns   = handoff.pause_end_ns;
+    if (slot.pause_end_ns != 0 && (next_pause_end_ns_ == 0 || slot.pause_end_ns < next_pause_end_ns_)) {
+        next_pause_end_ns_ = slot.pause_end_ns;
+    }
+    BookIndex expected = book;
+    incoming_book_.compare_exchange_strong(expected, NO_BOOK, std::memory_order_relaxed);
+
+    // What reached the slot first, in arrival order, ahead of anything behind the adopt
+    size_t kept = 0;
+    size_t held = 0;
+    for (size_t i = 0; i < parked_.size(); ++i) {
+        const OrderRequest request = parked_[i];
+        if (request.book != book) {
+            parked_[kept++] = request;
+            continue;
+        }
+        process_request(request);
+        ++held;
+    }
+    parked_.resize(kept);
+    LOG_INFO("Engine {}: adopted {} from {} ({} held requests)", name_, slot.symbol, from.name(), held);
+}
+
+void MatchingEngine::process_modify(OrderID order_id, Quantity new_quantity, Price new_price) {
+    const TradingPhase old_phase = active_->book->phase();
+
+    auto result = active_->book->modify_order(order_id, new_quantity, new_price);
+
+    if (result.has_value()) {
+        const BookChange& change = result.value();
+        ++local_stats_.modifies_accepted;
+        if (change.levels) mark_depth_pending();
+        if (active_->book->phase() != old_phase) [[unlikely]] begin_volatility_pause();
+        if (change.moved()) publish_bbo_update();
     } else {
-        ++local_stats_.cancels_rejected;
+        ++local_stats_.modifies_rejected;
+    }
+}
+
+void MatchingEngine::process_phase_change(TradingPhase phase) {
+    active_->pause_end_ns = 0;  // An explicit phase overrides a pending resume
+    if (phase == active_->book->phase()) return;
+
+    if (phase == TradingPhase::AUCTION) {
+        active_->book->begin_auction();
+        publish_phase(phase, AuctionResult{});
+        return;
+    }
+    if (phase == TradingPhase::HALTED) {
+        active_->book->halt();
+        publish_phase(phase, AuctionResult{});
+        return;
+    }
+
+    // Fills print individually (all at the uncross price) via on_trade_internal
+    const AuctionResult result = active_->book->uncross();
+    const BookChange& change = active_->book->last_change();
+    publish_phase(phase, result);
+    if (change.levels) mark_depth_pending();
+    // A stop fired by the uncross can trip the band again
+    if (active_->book->phase() != TradingPhase::CONTINUOUS) [[unlikely]] begin_volatility_pause();
+    if (change.moved()) publish_bbo_update();
+}
+
+void MatchingEngine::begin_volatility_pause() {
+    publish_phase(TradingPhase::AUCTION, AuctionResult{}, true);
+    LOG_DEBUG("Engine {}: {} hit its price band, volatility pause", name_, active_->symbol);
+    if (volatility_pause_ns_ == 0) return;
+    active_->pause_end_ns = now_timestamp() + volatility_pause_ns_;
+    if (next_pause_end_ns_ == 0 || active_->pause_end_ns < next_pause_end_ns_) {
+        next_pause_end_ns_ = active_->pause_end_ns;
+    }
+}
+
+size_t MatchingEngine::end_volatility_pauses() {
+    const Timestamp now = now_timestamp();
+    if (now < next_pause_end_ns_) return 0;
+
+    size_t resumed = 0;
+    next_pause_end_ns_ = 0;
+    for (size_t i = 0; i < books_.size(); ++i) {
+        BookSlot& slot = books_[i];
+        if (slot.pause_end_ns == 0) continue;
+        if (slot.pause_end_ns > now) {
+            if (next_pause_end_ns_ == 0 || slot.pause_end_ns < next_pause_end_ns_) {
+                next_pause_end_ns_ = slot.pause_end_ns;
+            }
+            continue;
+        }
+        // Halted or moved on in the meantime: only a book still paused resumes
+        if (slot.book->phase() != TradingPhase::AUCTION) {
+            slot.pause_end_ns = 0;
+            continue;
+        }
+        process_request(OrderRequest::make_phase(TradingPhase::CONTINUOUS, static_cast<BookIndex>(i)));
+        ++resumed;
     }
+    return resumed;
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -228,81 +1014,442 @@ void MatchingEngine::process_cancel(OrderID order_id, ClientID client_id) {
 
 void MatchingEngine::on_trade_internal(const Trade& trade) {
     ++local_stats_.trades_executed;
+    if (active_->reference_price) [[likely]] {
+        active_->reference_price->price.store(trade.price, std::memory_order_relaxed);
+    }
     publish_trade(trade);
+    if (journal_) [[unlikely]] {
+        JournalRecord record;
+        record.type  = JournalRecordType::TRADE;
+        record.trade = trade;
+        journal_output(record);
+    }
+    // Reported once both sides' fill callbacks named their reactors
+    pending_fill_ = ExecutionReport::make_fill(trade);
+    pending_fill_sides_ = 0;
 }
 
-void MatchingEngine::publish_trade(const Trade& trade) {
-    if (!market_data_queue_) [[unlikely]] return;
+void MatchingEngine::on_order_done_internal(const Order& order) {
+    if (journal_) [[unlikely]] {
+        JournalRecord record;
+        record.type                 = JournalRecordType::ORDER_DONE;
+        record.done.id              = order.id;
+        record.done.filled_quantity = order.quantity - order.open_quantity();
+        record.done.leaves_quantity = order.open_quantity();
+        record.done.status          = order.status;
+        journal_output(record);
+    }
+    publish_execution(ExecutionReport::make_done(order), order.ingress);
+    publish_risk_feedback(order.owner, RiskFeedback::make_done(order.id));
+}
 
-    MarketDataEvent event;
-    event.type = MarketDataEvent::TRADE;
-    std::memcpy(event.symbol, symbol_cache_, sizeof(event.symbol));
-    event.trade = trade;
+void MatchingEngine::on_order_fill_internal(const Order& order, Quantity quantity, Price price) {
+    publish_risk_feedback(order.owner, RiskFeedback::make_fill(order.id, quantity, price));
 
-    if (!market_data_queue_->push(event)) [[unlikely]] {
-        ++local_stats_.md_drops;
+    (order.side == Side::BUY ? pending_fill_.reactor : pending_fill_.sell_reactor) = order.ingress;
+    if (++pending_fill_sides_ < 2) return;
+    publish_execution(pending_fill_, pending_fill_.reactor);
+    if (pending_fill_.sell_reactor != pending_fill_.reactor) {
+        publish_execution(pending_fill_, pending_fill_.sell_reactor);
     }
 }
 
-void MatchingEngine::publish_bbo_update() {
-    if (!market_data_queue_) [[unlikely]] return;
+void MatchingEngine::journal_request(const OrderRequest& request) {
+    JournalRecord record;
+    record.book = request.book;
+    switch (request.type) {
+        case OrderRequest::NEW_ORDER: {
+            const Order& order = *pool_.at(request.new_order.order);
+            record.type = JournalRecordType::NEW_ORDER;
+            auto& out = record.new_order;
+            out.id               = order.id;
+            out.price            = order.price;
+            out.quantity         = order.quantity;
+            out.display_quantity = order.display_quantity;
+            out.stop_price       = order.stop_price;
+            out.timestamp        = order.timestamp;
+            out.symbol           = order.symbol;
+            out.client_id        = order.client_id;
+            out.owner            = order.owner;
+            out.side             = order.side;
+            out.type             = order.type;
+            out.ingress          = order.ingress;
+            break;
+        }
+        case OrderRequest::CANCEL_ORDER:
+            record.type     = JournalRecordType::CANCEL_ORDER;
+            record.order.id = request.cancel.order_id;
+            break;
+        case OrderRequest::MODIFY_ORDER:
+            record.type                = JournalRecordType::MODIFY_ORDER;
+            record.modify.id           = request.modify.order_id;
+            record.modify.new_quantity = request.modify.new_quantity;
+            record.modify.new_price    = request.modify.new_price;
+            break;
+        case OrderRequest::SET_PHASE:
+            record.type  = JournalRecordType::SET_PHASE;
+            record.phase = request.phase_change.phase;
+            break;
+        case OrderRequest::MASS_CANCEL:
+            record.type              = JournalRecordType::MASS_CANCEL;
+            record.mass_cancel.owner = request.mass_cancel.owner;
+            break;
+        case OrderRequest::RELEASE_BOOK:
+        case OrderRequest::ADOPT_BOOK:
+            return;  // Filtered out by process_request: book moves are not journaled
+    }
+    record.time = journal_time_;
+    if (replication_acked_) [[unlikely]] {
+        // A dropped request never reaches the standby: its reports cannot wait for it
+        const uint64_t drops = journal_->drops();
+        journal_->append(record);
+        request_seq_ = journal_->drops() == drops ? journal_->sequence() : 0;
+        return;
+    }
+    journal_->append(record);
+}
 
-    MarketDataEvent event;
-    event.type = MarketDataEvent::BBO_UPDATE;
-    std::memcpy(event.symbol, symbol_cache_, sizeof(event.symbol));
+/** An output of the request being processed: tagged with its book */
+void MatchingEngine::journal_output(JournalRecord& record) {
+    record.time = journal_time_;
+    record.book = static_cast<BookIndex>(active_ - books_.data());
+    journal_->append(record);
+}
+
+void MatchingEngine::publish_risk_feedback(ClientIDRaw owner, const RiskFeedback& feedback) {
+    if (risk_feedback_.empty()) [[unlikely]] return;
+
+    SPSCQueue<RiskFeedback>* ring = risk_feedback_[risk_shard_for(owner, risk_feedback_.size())];
+    if (!ring->push(feedback)) [[unlikely]] ++local_stats_.risk_feedback_drops;
+}
 
-    event.bbo.bid_price    = book_->best_bid();
-    event.bbo.bid_quantity = book_->bid_quantity();
-    event.bbo.ask_price    = book_->best_ask();
-    event.bbo.ask_quantity = book_->ask_quantity();
+void MatchingEngine::publish_execution(const ExecutionReport& report, GatewayReactor reactor) {
+    if (!execution_egress_.connected()) [[unlikely]] return;
+    if (replication_acked_ && request_seq_ != 0) [[unlikely]] {
+        held_.push_back({report, reactor, request_seq_});
+        return;
+    }
+    if (!execution_egress_.publish(report, reactor)) [[unlikely]] ++local_stats_.exec_drops;
+}
 
-    if (!market_data_queue_->push(event)) [[unlikely]] {
+size_t MatchingEngine::release_held(bool all) {
+    const uint64_t acked = replication_acked_->load(std::memory_order_acquire);
+    size_t released = 0;
+    while (held_head_ < held_.size() && (all || held_[held_head_].seq <= acked)) {
+        const HeldReport& held = held_[held_head_++];
+        if (!execution_egress_.publish(held.report, held.reactor)) [[unlikely]] ++local_stats_.exec_drops;
+        ++released;
+    }
+    if (held_head_ == held_.size()) {
+        held_.clear();
+        held_head_ = 0;
+    }
+    return released;
+}
+
+bool MatchingEngine::held_ready() const {
+    return held_head_ < held_.size() &&
+           held_[held_head_].seq <= replication_acked_->load(std::memory_order_acquire);
+}
+
+/**
+ * Push an event of the active book to its publisher, tagged with its
+ * channel. Staged trades go first, so the lane keeps the book's order.
+ */
+void MatchingEngine::publish_market_data(MarketDataEvent& event) {
+    if (trade_batch_count_ || sweep_.sweep.fills) flush_trades();
+    event.channel = active_->md_channel;
+    if (!active_->md_queue->push(event)) [[unlikely]] {
         ++local_stats_.md_drops;
     }
 }
 
-// ═══════════════════════════════════════════════════════════════
-//  Backoff Strategy
-// ═══════════════════════════════════════════════════════════════
+void MatchingEngine::on_order_event_internal(const OrderEvent& order_event) {
+    MarketDataEvent event = MarketDataEvent::make_order_event(active_->symbol, order_event);
+    event.channel = active_->mbo_channel;
+    if (!active_->mbo_queue->push(event)) [[unlikely]] {
+        ++local_stats_.md_drops;
+    }
+}
 
-void MatchingEngine::spin_wait() {
-    for (size_t i = 0; i < SPIN_ITERATIONS; ++i) {
-        if (!input_queue_->empty()) return;
+/**
+ * Stage a trade: the fills of one request reach the lane as one bulk
+ * push (TRADE_BATCH at a time) when the request ends or the book
+ * publishes anything else. With sweep summaries on, the fills of each
+ * incoming order are summed as they come; a fill of another aggressor
+ * (a stop it triggered) closes the previous sweep first.
+ */
+void MatchingEngine::publish_trade(const Trade& trade) {
+    if (!active_->md_queue) [[unlikely]] return;
+
+    const uint8_t aggressor = active_->book->sweep_aggressor();
+    if (sweep_summary_) [[unlikely]] {
+        const OrderID aggressor_id = aggressor == 1 ? trade.buy_order_id
+                                   : aggressor == 2 ? trade.sell_order_id : 0;
+        if (sweep_.sweep.fills && aggressor_id != sweep_aggressor_id_) close_sweep();
+        if (aggressor_id) {  // Auction prints are summed by the phase event already
+            MarketDataEvent::SweepData& sweep = sweep_.sweep;
+            if (sweep.fills == 0) {
+                sweep_ = MarketDataEvent{};
+                sweep_.type = MarketDataEvent::SWEEP;
+                sweep_.channel = active_->md_channel;
+                sweep_.aggressor_side = aggressor;
+                std::memcpy(sweep_.symbol, active_->symbol, sizeof(sweep_.symbol));
+                sweep.first_trade_id = trade.id;
+                sweep.first_price    = trade.price;
+                sweep_aggressor_id_  = aggressor_id;
+            }
+            sweep.last_price = trade.price;
+            sweep.quantity  += trade.quantity;
+            ++sweep.fills;
+        }
+    }
 
-        for (size_t p = 0; p < PAUSE_PER_SPIN; ++p) {
-#if defined(__aarch64__)
-            asm volatile("yield" ::: "memory");
-#elif defined(__x86_64__)
-            _mm_pause();
-#endif
+    MarketDataEvent& event = stage_trade_event();
+    event = MarketDataEvent::make_trade(active_->symbol, trade, aggressor);
+    event.channel = active_->md_channel;
+}
+
+MarketDataEvent& MatchingEngine::stage_trade_event() {
+    if (trade_batch_count_ == TRADE_BATCH) [[unlikely]] push_staged_trades();
+    return trade_batch_[trade_batch_count_++];
+}
+
+/** Stage the summary of the sweep being built if it filled more than once. */
+void MatchingEngine::close_sweep() {
+    if (sweep_.sweep.fills > 1) stage_trade_event() = sweep_;
+    sweep_.sweep.fills = 0;
+}
+
+void MatchingEngine::flush_trades() {
+    if (sweep_.sweep.fills) close_sweep();
+    if (trade_batch_count_) push_staged_trades();
+}
+
+/** One bulk push (one head publish) for everything staged; what does not fit is dropped. */
+void MatchingEngine::push_staged_trades() {
+    const size_t pushed = active_->md_queue->try_push_bulk(trade_batch_.data(), trade_batch_count_);
+    local_stats_.md_drops += trade_batch_count_ - pushed;
+    trade_batch_count_ = 0;
+}
+
+void MatchingEngine::publish_phase(TradingPhase phase, const AuctionResult& result,
+                                   bool volatility_pause) {
+    if (!active_->md_queue) [[unlikely]] return;
+
+    MarketDataEvent event = MarketDataEvent::make_phase(active_->symbol, phase, result.price,
+                                                        result.volume, volatility_pause);
+    publish_market_data(event);
+}
+
+/** BBO of the active book changed: publish now, or once at the end of the batch if conflating. */
+void MatchingEngine::publish_bbo_update() {
+    if (!active_->md_queue) [[unlikely]] return;
+    if (bbo_conflation_) {
+        if (!active_->bbo_dirty) {
+            active_->bbo_dirty = true;
+            bbo_dirty_.push_back(static_cast<BookIndex>(active_ - books_.data()));
         }
+        return;
     }
+    push_bbo();
+}
 
-    sched_yield();
+/** One BBO per book that changed during the batch, with its state after the batch. */
+void MatchingEngine::publish_conflated_bbo() {
+    for (BookIndex i : bbo_dirty_) {
+        active_ = &books_[i];
+        active_->bbo_dirty = false;
+        push_bbo();
+    }
+    bbo_dirty_.clear();
+}
+
+void MatchingEngine::push_bbo() {
+    MarketDataEvent event;
+    event.type = MarketDataEvent::BBO_UPDATE;
+    std::memcpy(event.symbol, active_->symbol, sizeof(event.symbol));
+
+    event.bbo.bid_price    = active_->book->best_bid();
+    event.bbo.bid_quantity = active_->book->bid_quantity();
+    event.bbo.ask_price    = active_->book->best_ask();
+    event.bbo.ask_quantity = active_->book->ask_quantity();
+    publish_market_data(event);
+}
+
+/** One DEPTH_LEVEL event per level the last operation touched on the active book. */
+void MatchingEngine::publish_level_changes() {
+    active_->book->drain_level_changes([this](Side side, Price price, Quantity quantity,
+                                              uint32_t order_count) {
+        if (!active_->md_queue) [[unlikely]] return;
+        MarketDataEvent event = MarketDataEvent::make_level(
+            active_->symbol, side, price, quantity, order_count, active_->depth_sequence);
+        publish_market_data(event);
+    });
 }
 
 // ═══════════════════════════════════════════════════════════════
 //  Maintenance
 // ═══════════════════════════════════════════════════════════════
 
-void MatchingEngine::maybe_compact() {
-    if (local_stats_.total_processed % COMPACT_INTERVAL == 0) {
-        book_->compact();
-        book_->prune();
+/**
+ * Incremental maintenance under a time budget, in units small enough
+ * to interleave with matching:
+ *
+ *   1. book prune    one book at a time, round robin from where the
+ *                    last pass stopped
+ *   2. stats flush   every STATS_FLUSH_INTERVAL requests (interval,
+ *                    not modulo: batches advance total_processed by up
+ *                    to BATCH_SIZE), and idle with anything unflushed
+ *
+ * A pass looks at MAINTENANCE_SCAN books. At a batch boundary only
+ * books with PRUNE_TOMBSTONES drained levels are pruned; idle, any
+ * tombstone is worth pruning, and the worker keeps passing (instead of
+ * parking) while passes find work. The clock is read only once there
+ * is a book to prune; the pass stops at the first unit starting past
+ * the budget, so it overruns by at most one book. Level queues need
+ * no pass of their own (chunks recycle as they drain).
+ *
+ * @return true if another pass may find work (budget spent, or idle and pruned)
+ */
+bool MatchingEngine::maintain(bool idle) {
+    const size_t threshold = idle ? 1 : PRUNE_TOMBSTONES;
+    const size_t scan = std::min(MAINTENANCE_SCAN, books_.size());
+    Timestamp deadline = 0;  // Set by the first prune of the pass
+    bool budget_spent = false;
+    for (size_t k = 0; k < scan; ++k) {
+        BookSlot& slot = books_[maintenance_cursor_];
+        if (slot.book && slot.book->tombstones() >= threshold) {
+            const Timestamp now = now_timestamp();
+            if (deadline == 0) {
+                deadline = now + maintenance_budget_ns_;
+            } else if (now >= deadline) {
+                budget_spent = true;  // Resume at this book
+                break;
+            }
+            slot.book->prune();
+            ++local_stats_.books_pruned;
+        }
+        if (++maintenance_cursor_ == books_.size()) maintenance_cursor_ = 0;
+    }
+
+    const size_t unflushed = local_stats_.total_processed - last_flush_at_;
+    if (unflushed >= STATS_FLUSH_INTERVAL || (idle && (unflushed > 0 || deadline != 0))) flush_stats();
+    return budget_spent || (idle && deadline != 0);
+}
+
+/**
+ * Snapshot on the interval. Runs between batches, so the copy matches
+ * the journal exactly up to the last request journaled.
+ */
+void MatchingEngine::maybe_snapshot() {
+    if (!snapshot_slot_) [[likely]] return;
+    const Timestamp now = now_timestamp();
+    if (now < next_snapshot_ns_) return;
+    next_snapshot_ns_ = now + snapshot_interval_ns_;
+    capture_snapshot();
+}
+
+void MatchingEngine::capture_snapshot() {
+    BookSnapshotSlot& slot = *snapshot_slot_;
+    if (slot.busy.load(std::memory_order_acquire)) {
+        slot.skipped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    BookSnapshotHeader& header = slot.image.header;
+    std::memcpy(header.magic, BOOK_SNAPSHOT_MAGIC, sizeof(header.magic));
+    std::strncpy(header.engine, name_.c_str(), sizeof(header.engine) - 1);
+    header.journal_seq    = journal_ ? journal_->sequence() : 0;
+    header.journal_engine = journal_ ? journal_->engine() : 0;
+    header.book_count     = static_cast<uint16_t>(books_.size());
+    header.unix_ns        = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    for (size_t i = 0; i < books_.size(); ++i) {
+        BookImage& image = slot.image.books[i];
+        if (books_[i].book) {
+            books_[i].book->capture(image);
+            continue;
+        }
+        image.header = BookImageHeader{};  // Vacant: an empty book, so restore skips it
+        std::memcpy(image.header.symbol, books_[i].symbol, sizeof(image.header.symbol));
+        image.orders.clear();
     }
+    slot.busy.store(true, std::memory_order_release);
 }
 
-void MatchingEngine::maybe_flush_stats() {
-    if (local_stats_.total_processed % STATS_FLUSH_INTERVAL == 0) {
-        flush_stats();
+/**
+ * Count a change to the active book; first change queues it for publishing.
+ * Incremental depth goes out right away — the touched levels are exact now.
+ */
+void MatchingEngine::mark_depth_pending() {
+    ++active_->depth_sequence;
+    if (active_->depth_pending_events++ == 0) {
+        depth_dirty_.push_back(static_cast<BookIndex>(active_ - books_.data()));
     }
+    if (depth_policy_.incremental) publish_level_changes();
+}
+
+/**
+ * Publish depth for each changed book whose cadence trigger fired.
+ * Only books on the dirty list are visited, and the clock is read at
+ * most once per call — idle, unchanged shards cost one branch.
+ */
+void MatchingEngine::maybe_publish_depth() {
+    if (depth_dirty_.empty()) [[likely]] return;
+
+    Timestamp now = 0;
+    size_t kept = 0;
+    for (BookIndex i : depth_dirty_) {
+        BookSlot& slot = books_[i];
+        bool due = depth_policy_.every_events != 0 &&
+                   slot.depth_pending_events >= depth_policy_.every_events;
+
+        if (!due && depth_policy_.interval_us != 0) {
+            if (now == 0) now = now_timestamp();
+            due = now - slot.depth_last_publish_ns >= depth_policy_.interval_us * 1000;
+        }
+        if (!due) {
+            depth_dirty_[kept++] = i;
+            continue;
+        }
+
+        slot.book->publish_depth(depth_policy_.levels, slot.depth_sequence);
+        slot.depth_pending_events = 0;
+        if (now == 0) now = now_timestamp();
+        slot.depth_last_publish_ns = now;
+    }
+    depth_dirty_.resize(kept);
 }
 
 void MatchingEngine::flush_stats() {
+    last_flush_at_ = local_stats_.total_processed;
     orders_processed_.store(local_stats_.orders_accepted, std::memory_order_relaxed);
     trades_executed_.store(local_stats_.trades_executed, std::memory_order_relaxed);
     orders_rejected_.store(local_stats_.orders_rejected, std::memory_order_relaxed);
     md_drops_.store(local_stats_.md_drops, std::memory_order_relaxed);
+    exec_drops_.store(local_stats_.exec_drops, std::memory_order_relaxed);
+    risk_feedback_drops_.store(local_stats_.risk_feedback_drops, std::memory_order_relaxed);
+    books_pruned_.store(local_stats_.books_pruned, std::memory_order_relaxed);
+    for (size_t i = 0; i < books_.size(); ++i) {
+        book_requests_[i].store(books_[i].requests, std::memory_order_relaxed);
+    }
+    if (stats_block_) {
+        StatsCounters counters;
+        counters.flushes = ++stats_flushes_;
+        counters.values[ENGINE_REQUESTS]          = local_stats_.total_processed;
+        counters.values[ENGINE_ORDERS_ACCEPTED]   = local_stats_.orders_accepted;
+        counters.values[ENGINE_ORDERS_REJECTED]   = local_stats_.orders_rejected;
+        counters.values[ENGINE_CANCELS_ACCEPTED]  = local_stats_.cancels_accepted;
+        counters.values[ENGINE_CANCELS_REJECTED]  = local_stats_.cancels_rejected;
+        counters.values[ENGINE_MODIFIES_ACCEPTED] = local_stats_.modifies_accepted;
+        counters.values[ENGINE_MODIFIES_REJECTED] = local_stats_.modifies_rejected;
+        counters.values[ENGINE_TRADES]            = local_stats_.trades_executed;
+        counters.values[ENGINE_MD_DROPS]          = local_stats_.md_drops;
+        counters.values[ENGINE_EXEC_DROPS]        = local_stats_.exec_drops;
+        counters.values[ENGINE_FEEDBACK_DROPS]    = local_stats_.risk_feedback_drops;
+        counters.values[ENGINE_BOOKS_PRUNED]      = local_stats_.books_pruned;
+        stats_block_->publish(counters);
+    }
 }
 
 } // namespace rtes
\ No newline at end of file
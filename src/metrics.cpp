@@ -7,52 +7,45 @@ namespace rtes {
 
 Histogram::Histogram(const std::vector<double>& buckets) : buckets_(buckets) {
     std::sort(buckets_.begin(), buckets_.end());
-    bucket_counts_.resize(buckets_.size() + 1, 0);  // +1 for +Inf bucket
+    // Sum, one cell per bucket, +Inf; each shard on lines of its own
+    lines_per_shard_ = (FIRST_BUCKET_CELL + buckets_.size() + 1 + 7) / 8;
+    lines_ = std::make_unique<detail::MetricLine[]>(METRIC_SHARDS * lines_per_shard_);
 }
 
-void Histogram::observe(double value) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    count_++;
-    sum_ += value;
-    
-    // Find appropriate bucket
-    for (size_t i = 0; i < buckets_.size(); ++i) {
-        if (value <= buckets_[i]) {
-            bucket_counts_[i]++;
-            return;
-        }
-    }
-    
-    // Value exceeds all buckets, goes to +Inf bucket
-    bucket_counts_.back()++;
-}
-
-std::string Histogram::get_prometheus_output(const std::string& name) const {
-    std::lock_guard<std::mutex> lock(mutex_);
+std::string Histogram::get_prometheus_output(const std::string& name, const std::string& labels) const {
+    const Stats stats = get_stats();
+    const std::string prefix = labels.empty() ? "" : labels + ",";
+    const std::string series = labels.empty() ? "" : "{" + labels + "}";
     std::ostringstream ss;
-    
+
     // Bucket counts
     uint64_t cumulative = 0;
     for (size_t i = 0; i < buckets_.size(); ++i) {
-        cumulative += bucket_counts_[i];
-        ss << name << "_bucket{le=\"" << buckets_[i] << "\"} " << cumulative << "\n";
+        cumulative += stats.bucket_counts[i];
+        ss << name << "_bucket{" << prefix << "le=\"" << buckets_[i] << "\"} " << cumulative << "\n";
     }
-    
+
     // +Inf bucket
-    cumulative += bucket_counts_.back();
-    ss << name << "_bucket{le=\"+Inf\"} " << cumulative << "\n";
-    
+    cumulative += stats.bucket_counts.back();
+    ss << name << "_bucket{" << prefix << "le=\"+Inf\"} " << cumulative << "\n";
+
     // Count and sum
-    ss << name << "_count " << count_ << "\n";
-    ss << name << "_sum " << std::fixed << std::setprecision(6) << sum_ << "\n";
-    
+    ss << name << "_count" << series << " " << stats.count << "\n";
+    ss << name << "_sum" << series << " " << std::fixed << std::setprecision(6) << stats.sum << "\n";
+
     return ss.str();
 }
 
 Histogram::Stats Histogram::get_stats() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return {count_, sum_, bucket_counts_};
+    Stats stats{0, 0.0, std::vector<uint64_t>(buckets_.size() + 1, 0)};
+    for (size_t shard = 0; shard < METRIC_SHARDS; ++shard) {
+        stats.sum += std::bit_cast<double>(cell(shard, SUM_CELL).load(std::memory_order_relaxed));
+        for (size_t i = 0; i < stats.bucket_counts.size(); ++i) {
+            stats.bucket_counts[i] += cell(shard, FIRST_BUCKET_CELL + i).load(std::memory_order_relaxed);
+        }
+    }
+    for (const uint64_t count : stats.bucket_counts) stats.count += count;
+    return stats;
 }
 
 MetricsRegistry& MetricsRegistry::instance() {
@@ -60,34 +53,39 @@ MetricsRegistry& MetricsRegistry::instance() {
     return registry;
 }
 
-Counter* MetricsRegistry::get_counter(const std::string& name) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = counters_.find(name);
-    if (it != counters_.end()) {
-        return it->second.get();
+std::string MetricsRegistry::render_labels(const MetricLabels& labels) {
+    std::string rendered;
+    for (const auto& [key, value] : labels) {
+        if (!rendered.empty()) rendered += ",";
+        rendered += key + "=\"" + value + "\"";
     }
-    
-    auto counter = std::make_unique<Counter>();
-    Counter* ptr = counter.get();
-    counters_[name] = std::move(counter);
-    
-    return ptr;
+    return rendered;
 }
 
-Histogram* MetricsRegistry::get_histogram(const std::string& name, const std::vector<double>& buckets) {
+Counter* MetricsRegistry::get_counter(const std::string& name, const MetricLabels& labels) {
+    const std::string rendered = render_labels(labels);
+    const std::string key = rendered.empty() ? name : name + "{" + rendered + "}";
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto it = histograms_.find(name);
+
+    auto& counter = counters_[key];
+    if (!counter) counter = std::make_unique<Counter>();
+    return counter.get();
+}
+
+Histogram* MetricsRegistry::get_histogram(const std::string& name, const std::vector<double>& buckets,
+                                          const MetricLabels& labels) {
+    const std::string rendered = render_labels(labels);
+    const std::string key = rendered.empty() ? name : name + "{" + rendered + "}";
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = histograms_.find(key);
     if (it != histograms_.end()) {
-        return it->second.get();
+        return it->second.histogram.get();
     }
-    
-    auto bucket_config = buckets.empty() ? default_latency_buckets() : buckets;
-    auto histogram = std::make_unique<Histogram>(bucket_config);
+
+    auto histogram = std::make_unique<Histogram>(buckets.empty() ? default_latency_buckets() : buckets);
     Histogram* ptr = histogram.get();
-    histograms_[name] = std::move(histogram);
-    
+    histograms_.emplace(key, HistogramSeries{name, rendered, std::move(histogram)});
     return ptr;
 }
 
@@ -102,13 +100,13 @@ std::string MetricsRegistry::get_prometheus_output() const {
     ss << "# TYPE rtes_latency_seconds histogram\n\n";
     
     // Output counters
-    for (const auto& [name, counter] : counters_) {
-        ss << name << " " << counter->get() << "\n";
+    for (const auto& [series, counter] : counters_) {
+        ss << series << " " << counter->get() << "\n";
     }
     
     // Output histograms
-    for (const auto& [name, histogram] : histograms_) {
-        ss << histogram->get_prometheus_output(name);
+    for (const auto& [key, series] : histograms_) {
+        ss << series.histogram->get_prometheus_output(series.name, series.labels);
     }
     
     return ss.str();
@@ -130,4 +128,4 @@ std::vector<double> MetricsRegistry::default_latency_buckets() {
     };
 }
 
-} // namespace rtes
\ No newline at end of file
+} // namespace rtes
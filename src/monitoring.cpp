@@ -1,11 +1,15 @@
 #include "rtes/monitoring.hpp"
 #include "rtes/logger.hpp"
+#include <iomanip>
 #include <sstream>
+#include <type_traits>
 
 namespace rtes {
 
-MonitoringService::MonitoringService(uint16_t port, Exchange* exchange)
-    : port_(port), exchange_(exchange) {
+MonitoringService::MonitoringService(uint16_t port, Exchange* exchange,
+                                     std::chrono::milliseconds metrics_refresh,
+                                     std::chrono::milliseconds dashboard_stream)
+    : port_(port), exchange_(exchange), metrics_refresh_(metrics_refresh), dashboard_stream_(dashboard_stream) {
     
     http_server_ = std::make_unique<HttpServer>(port);
     
@@ -62,10 +66,20 @@ void MonitoringService::record_order_rejected() {
 }
 
 void MonitoringService::setup_http_handlers() {
-    http_server_->add_handler("/metrics", 
-        [this](const std::string& path, const std::string& query) {
-            return handle_metrics(path, query);
-        });
+    // A full scrape walks every metric and lane: render it once per interval
+    HttpHandler metrics = [this](const std::string& path, const std::string& query) {
+        return handle_metrics(path, query);
+    };
+    if (metrics_refresh_.count() > 0) {
+        http_server_->add_cached_handler("/metrics", std::move(metrics), metrics_refresh_);
+    } else {
+        http_server_->add_handler("/metrics", std::move(metrics));
+    }
+    
+    // Live dashboards subscribe instead of polling: one sample per tick, shared
+    if (dashboard_stream_.count() > 0) {
+        http_server_->add_event_stream("/events", [this] { return dashboard_fields(); }, dashboard_stream_);
+    }
     
     http_server_->add_handler("/health",
         [this](const std::string& path, const std::string& query) {
@@ -78,7 +92,72 @@ void MonitoringService::setup_http_handlers() {
         });
 }
 
+void MonitoringService::enable_risk_reload(std::string config_path) {
+    risk_reload_path_ = std::move(config_path);
+    http_server_->add_admin_handler("/reload/risk",
+        [this](const std::string& path, const std::string& query) {
+            return handle_risk_reload(path, query);
+        }, "config_reload");
+}
+
+/** Parsed on the HTTP thread; the shards only adopt the finished generation */
+std::string MonitoringService::handle_risk_reload(const std::string&, const std::string&) {
+    std::unique_ptr<Config> config;
+    try {
+        config = Config::load_from_file(risk_reload_path_);
+    } catch (const std::exception& e) {
+        LOG_WARN("Risk limit reload failed: {}", e.what());
+        return std::string("reload failed: ") + e.what() + "\n";
+    }
+    if (!config) return "reload failed\n";
+
+    uint64_t generation = 0;
+    const auto shards = exchange_->get_risk_shards();
+    for (RiskManager* shard : shards) generation = shard->update_limits(config->risk, config->symbols);
+    LOG_INFO("Risk limits from {} published to {} shards", risk_reload_path_, shards.size());
+    std::ostringstream out;
+    out << "risk limits generation " << generation << " published to " << shards.size() << " shards\n";
+    return out.str();
+}
+
+void MonitoringService::enable_symbol_control() {
+    HttpHandler control = [this](const std::string& path, const std::string& query) {
+        return handle_symbol_control(path, query);
+    };
+    http_server_->add_handler("/symbols", control);  // Read-only
+    for (const char* path : {"/symbols/list", "/symbols/halt", "/symbols/resume"}) {
+        http_server_->add_admin_handler(path, control, "config_reload");
+    }
+}
+
+std::string MonitoringService::handle_symbol_control(const std::string& path, const std::string& query) {
+    const InstrumentDirectory& instruments = *exchange_->get_instrument_directory();
+    std::ostringstream out;
+    if (path == "/symbols") {
+        for (size_t id = 0; id < instruments.size(); ++id) {
+            out << instruments.symbols()[id].c_str() << ' '
+                << instrument_state_name(instruments.state(static_cast<InstrumentID>(id))) << '\n';
+        }
+        return out.str();
+    }
+
+    // ?symbol=AAPL (tickers need no URL decoding)
+    std::string name;
+    const size_t key = query.find("symbol=");
+    if (key != std::string::npos) name = query.substr(key + 7, query.find('&', key) - key - 7);
+    if (name.empty() || name.size() >= sizeof(Symbol::data)) return "usage: " + path + "?symbol=<symbol>\n";
+
+    const Symbol symbol(name.c_str());
+    const bool done = path == "/symbols/list"   ? exchange_->list_symbol(symbol)
+                    : path == "/symbols/halt"   ? exchange_->halt_symbol(symbol)
+                    :                             exchange_->resume_symbol(symbol);
+    out << name << ' ' << instrument_state_name(exchange_->symbol_state(symbol))
+        << (done ? "\n" : " (unchanged)\n");
+    return out.str();
+}
+
 void MonitoringService::metrics_collection_loop() {
+    apply_thread_placement(placement_, "rtes-monitoring");
     while (running_.load()) {
         collect_system_metrics();
         std::this_thread::sleep_for(std::chrono::seconds(1));
@@ -86,7 +165,205 @@ void MonitoringService::metrics_collection_loop() {
 }
 
 std::string MonitoringService::handle_metrics(const std::string&, const std::string&) {
-    return MetricsRegistry::instance().get_prometheus_output();
+    return MetricsRegistry::instance().get_prometheus_output() + market_data_delay_output() +
+           queue_telemetry_output() + book_schedule_output() + order_trace_output();
+}
+
+/** Match-to-publish delay of trade messages, summed over the publishers */
+std::string MonitoringService::market_data_delay_output() const {
+    if (publishers_.empty()) return {};
+    MarketDataDelay total;
+    for (const UdpPublisher* publisher : publishers_) {
+        const MarketDataDelay delay = publisher->publish_delay();
+        total.samples += delay.samples;
+        total.sum_ns += delay.sum_ns;
+        for (size_t i = 0; i < MD_DELAY_BUCKETS; ++i) total.buckets[i] += delay.buckets[i];
+    }
+
+    const char* name = "rtes_md_publish_delay_seconds";
+    std::ostringstream ss;
+    ss << "# TYPE " << name << " histogram\n";
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i + 1 < MD_DELAY_BUCKETS; ++i) {
+        cumulative += total.buckets[i];
+        ss << name << "_bucket{le=\"" << md_delay_bound_ns(i) / 1e9 << "\"} " << cumulative << "\n";
+    }
+    ss << name << "_bucket{le=\"+Inf\"} " << total.samples << "\n";
+    ss << name << "_count " << total.samples << "\n";
+    ss << name << "_sum " << std::fixed << std::setprecision(9) << total.sum_ns / 1e9 << "\n";
+    return ss.str();
+}
+
+/** Sampled high watermark and residence time of every lane (queue_telemetry_sample > 0) */
+std::string MonitoringService::queue_telemetry_output() const {
+    if (!exchange_) return {};
+    const ExchangeStats stats = exchange_->get_stats();
+
+    struct Row {
+        std::string             labels;
+        const IngressLaneStats* lane;
+    };
+    std::vector<Row> rows;
+    auto add = [&](const std::string& queue, const std::string& owner,
+                   const std::vector<IngressLaneStats>& lanes) {
+        for (size_t i = 0; i < lanes.size(); ++i) {
+            if (lanes[i].telemetry.sample_every == 0) continue;
+            std::string labels = "queue=\"" + queue + "\",";
+            if (!owner.empty()) labels += "owner=\"" + owner + "\",";
+            rows.push_back({labels + "lane=\"" + std::to_string(i) + "\"", &lanes[i]});
+        }
+    };
+    for (const auto& engine : stats.engines) add("engine", engine.name, engine.lanes);
+    add("risk", {}, stats.risk_lanes);
+    add("market_data", {}, stats.market_data_lanes);
+    if (rows.empty()) return {};
+
+    std::ostringstream ss;
+    ss << "# TYPE rtes_queue_capacity gauge\n";
+    for (const Row& row : rows) ss << "rtes_queue_capacity{" << row.labels << "} " << row.lane->capacity << "\n";
+    ss << "# TYPE rtes_queue_high_water gauge\n";
+    for (const Row& row : rows) {
+        ss << "rtes_queue_high_water{" << row.labels << "} " << row.lane->telemetry.high_water << "\n";
+    }
+    ss << std::fixed << std::setprecision(9);
+    ss << "# TYPE rtes_queue_residence_seconds summary\n";
+    for (const Row& row : rows) {
+        const QueueTelemetry& t = row.lane->telemetry;
+        ss << "rtes_queue_residence_seconds_count{" << row.labels << "} " << t.samples << "\n";
+        ss << "rtes_queue_residence_seconds_sum{" << row.labels << "} " << t.residence_sum_ns / 1e9 << "\n";
+    }
+    ss << "# TYPE rtes_queue_residence_max_seconds gauge\n";
+    for (const Row& row : rows) {
+        ss << "rtes_queue_residence_max_seconds{" << row.labels << "} "
+           << row.lane->telemetry.residence_max_ns / 1e9 << "\n";
+    }
+    return ss.str();
+}
+
+/** Per-book wait for the engine under fair scheduling (engine_fair_slice > 0): the data to rebalance shards on */
+std::string MonitoringService::book_schedule_output() const {
+    if (!exchange_) return {};
+    const ExchangeStats stats = exchange_->get_stats();
+
+    struct Row {
+        std::string              labels;
+        const BookScheduleStats* book;
+    };
+    std::vector<Row> rows;
+    for (const auto& engine : stats.engines) {
+        for (const auto& book : engine.schedule) {
+            rows.push_back({"engine=\"" + engine.name + "\",symbol=\"" + book.symbol + "\"", &book});
+        }
+    }
+    if (rows.empty()) return {};
+
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(9);
+    ss << "# TYPE rtes_book_queue_delay_seconds summary\n";
+    for (const Row& row : rows) {
+        ss << "rtes_book_queue_delay_seconds_count{" << row.labels << "} " << row.book->requests << "\n";
+        ss << "rtes_book_queue_delay_seconds_sum{" << row.labels << "} " << row.book->delay_sum_ns / 1e9 << "\n";
+    }
+    ss << "# TYPE rtes_book_queue_delay_max_seconds gauge\n";
+    for (const Row& row : rows) {
+        ss << "rtes_book_queue_delay_max_seconds{" << row.labels << "} " << row.book->delay_max_ns / 1e9 << "\n";
+    }
+    ss << "# TYPE rtes_book_backlog gauge\n";
+    for (const Row& row : rows) ss << "rtes_book_backlog{" << row.labels << "} " << row.book->backlog << "\n";
+    return ss.str();
+}
+
+/** Per-span percentiles of the sampled order lifecycle traces (order_trace_sample > 0) */
+std::string MonitoringService::order_trace_output() const {
+    const OrderTracer* tracer = exchange_ ? exchange_->get_order_tracer() : nullptr;
+    if (!tracer) return {};
+    const OrderTraceSnapshot snap = tracer->snapshot();
+
+    struct Quantile {
+        const char* label;
+        double      percentile;
+    };
+    constexpr Quantile quantiles[] = {{"0.5", 50}, {"0.99", 99}, {"0.999", 99.9}};
+
+    const char* name = "rtes_order_stage_seconds";
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(9);
+    ss << "# TYPE " << name << " summary\n";
+    for (size_t s = 0; s < ORDER_SPANS; ++s) {
+        const LatencyHistogram& span = snap.spans[s];
+        const std::string stage = std::string("stage=\"") + order_span_name(static_cast<OrderSpan>(s)) + "\"";
+        for (const Quantile& q : quantiles) {
+            ss << name << "{" << stage << ",quantile=\"" << q.label << "\"} "
+               << span.percentile(q.percentile) / 1e9 << "\n";
+        }
+        ss << name << "_count{" << stage << "} " << span.count() << "\n";
+        ss << name << "_sum{" << stage << "} " << span.sum_ns() / 1e9 << "\n";
+    }
+    ss << "# TYPE rtes_order_traces_dropped_total counter\n";
+    ss << "rtes_order_traces_dropped_total " << snap.dropped << "\n";
+    return ss.str();
+}
+
+HttpEventFields MonitoringService::dashboard_fields() const {
+    HttpEventFields fields;
+    auto add = [&](std::string name, auto value) {
+        if constexpr (std::is_floating_point_v<decltype(value)>) {
+            std::ostringstream ss;
+            ss << std::setprecision(6) << value;
+            fields.emplace_back(std::move(name), ss.str());
+        } else {
+            fields.emplace_back(std::move(name), std::to_string(value));
+        }
+    };
+    auto depth = [](const std::vector<IngressLaneStats>& lanes) {
+        size_t total = 0;
+        for (const auto& lane : lanes) total += lane.depth;
+        return total;
+    };
+
+    add("orders_processed", orders_total_->get());
+    add("orders_rejected", orders_rejected_->get());
+    add("trades", trades_total_->get());
+    if (!exchange_) return fields;
+
+    const ExchangeStats stats = exchange_->get_stats();
+    add("exchange.orders_processed", stats.total_orders_processed);
+    add("exchange.orders_approved", stats.total_orders_approved);
+    add("exchange.orders_rejected", stats.total_orders_rejected);
+    add("exchange.trades", stats.total_trades_executed);
+    add("exchange.cancels", stats.total_cancels);
+    add("market_data.events", stats.market_data_events);
+    add("market_data.drops", stats.market_data_drops);
+    add("market_data.queue_depth", stats.market_data_queue_depth + depth(stats.market_data_lanes));
+    add("order_pool.allocated", stats.order_pool_allocated);
+    add("order_pool.utilization", stats.order_pool_utilization);
+    add("risk.queue_depth", depth(stats.risk_lanes));
+    if (exchange_->get_event_journal()) {
+        add("journal.records", stats.journal_records);
+        add("journal.drops", stats.journal_drops);
+        if (exchange_->get_config().replication.role != "none") {
+            add("replication.connected", stats.replication_connected ? 1 : 0);
+            add("replication.requests", stats.replication_requests);
+            add("replication.backlog_bytes", stats.replication_backlog);
+        }
+    }
+    for (const auto& engine : stats.engines) {
+        const std::string prefix = "engine." + engine.name + ".";
+        add(prefix + "orders", engine.orders_processed);
+        add(prefix + "trades", engine.trades_executed);
+        add(prefix + "input_drops", engine.input_drops);
+        add(prefix + "queue_depth", depth(engine.lanes));
+    }
+
+    if (const OrderTracer* tracer = exchange_->get_order_tracer()) {
+        const OrderTraceSnapshot snap = tracer->snapshot();
+        for (size_t s = 0; s < ORDER_SPANS; ++s) {
+            const std::string prefix = std::string("latency_us.") + order_span_name(static_cast<OrderSpan>(s)) + ".";
+            add(prefix + "p50", snap.spans[s].percentile(50) / 1e3);
+            add(prefix + "p99", snap.spans[s].percentile(99) / 1e3);
+        }
+    }
+    return fields;
 }
 
 std::string MonitoringService::handle_health(const std::string&, const std::string&) {
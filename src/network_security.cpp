@@ -16,37 +16,14 @@ namespace rtes {
 
 // RateLimiter implementation
 RateLimiter::RateLimiter(uint32_t max_tokens, std::chrono::milliseconds refill_interval)
-    : max_tokens_(max_tokens), refill_interval_(refill_interval) {}
+    : limit_(max_tokens,
+             static_cast<uint64_t>(
+                 std::chrono::duration_cast<std::chrono::nanoseconds>(refill_interval).count()),
+             max_tokens) {}
 
 bool RateLimiter::try_consume(const std::string& client_id, uint32_t tokens) {
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    auto& bucket = buckets_[client_id];
-    refill_bucket(bucket);
-    
-    if (bucket.tokens >= tokens) {
-        bucket.tokens -= tokens;
-        return true;
-    }
-    
-    return false;
-}
-
-void rtes::RateLimiter::refill_bucket(TokenBucket& bucket) {
-    auto now = std::chrono::steady_clock::now();
-    
-    if (bucket.last_refill == std::chrono::steady_clock::time_point{}) {
-        bucket.tokens = max_tokens_;
-        bucket.last_refill = now;
-        return;
-    }
-    
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - bucket.last_refill);
-    if (elapsed >= refill_interval_) {
-        uint32_t tokens_to_add = static_cast<uint32_t>(elapsed.count() / refill_interval_.count());
-        bucket.tokens = std::min(max_tokens_, bucket.tokens + tokens_to_add);
-        bucket.last_refill = now;
-    }
+    return limit_.try_consume(buckets_[client_id], now_timestamp(), tokens);
 }
 
 size_t RateLimiter::active_clients() const {
@@ -0,0 +1,110 @@
+/**
+ * @file numa.cpp
+ * @brief NUMA topology and memory placement over sysfs and the raw syscalls
+ */
+
+#include "rtes/numa.hpp"
+
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if defined(__linux__)
+#include <dirent.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace rtes {
+
+namespace {
+
+constexpr int MPOL_PREFERRED_MODE = 1;  // <linux/mempolicy.h> MPOL_PREFERRED
+constexpr int MAX_NUMA_NODES = 1024;
+
+/** "0-1,3" (sysfs cpulist/nodelist format) → {0, 1, 3} */
+std::vector<int> parse_node_list(const std::string& list) {
+    std::vector<int> nodes;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        try {
+            const size_t dash = range.find('-');
+            const int first = std::stoi(range.substr(0, dash));
+            const int last  = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            for (int node = first; node <= last && node < MAX_NUMA_NODES; ++node) nodes.push_back(node);
+        } catch (const std::exception&) {
+            // Malformed entry: skip it
+        }
+    }
+    return nodes;
+}
+
+} // namespace
+
+std::vector<int> numa_online_nodes() {
+    std::ifstream file("/sys/devices/system/node/online");
+    std::string list;
+    std::vector<int> nodes;
+    if (file && std::getline(file, list)) nodes = parse_node_list(list);
+    if (nodes.empty()) nodes.push_back(0);
+    return nodes;
+}
+
+int numa_node_of_cpu(int cpu) {
+#if defined(__linux__)
+    if (cpu < 0) return -1;
+    // The CPU's directory holds a "nodeN" link to its node
+    const std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return -1;
+    int node = -1;
+    while (const dirent* entry = readdir(dir)) {
+        const std::string name = entry->d_name;
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+            name.find_first_not_of("0123456789", 4) == std::string::npos) {
+            node = std::stoi(name.substr(4));
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+#else
+    (void)cpu;
+    return -1;
+#endif
+}
+
+int current_numa_node() {
+#if defined(__linux__)
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) return static_cast<int>(node);
+#endif
+    return 0;
+}
+
+bool bind_to_numa_node(void* addr, size_t length, int node) {
+#if defined(__linux__)
+    if (node < 0 || node >= MAX_NUMA_NODES) {
+        errno = EINVAL;
+        return false;
+    }
+    unsigned long mask[MAX_NUMA_NODES / (8 * sizeof(unsigned long))]{};
+    constexpr size_t bits = 8 * sizeof(unsigned long);
+    mask[node / bits] |= 1UL << (node % bits);
+    // maxnode counts one past the last bit the kernel reads
+    return syscall(SYS_mbind, addr, length, MPOL_PREFERRED_MODE, mask,
+                   static_cast<unsigned long>(MAX_NUMA_NODES + 1), 0U) == 0;
+#else
+    (void)addr;
+    (void)length;
+    (void)node;
+    errno = ENOSYS;
+    return false;
+#endif
+}
+
+} // namespace rtes
@@ -319,59 +319,39 @@ AnomalyDetector& AnomalyDetector::instance() {
     return instance;
 }
 
-void AnomalyDetector::configure_metric(const std::string& metric_name, const AnomalyThreshold& threshold) {
+AnomalyMetric& AnomalyDetector::configure_metric(const std::string& metric_name,
+                                                const AnomalyThreshold& threshold) {
     std::unique_lock lock(detector_mutex_);
-    thresholds_[metric_name] = threshold;
-}
-
-bool AnomalyDetector::is_anomaly(const std::string& metric_name, double value) {
-    std::shared_lock lock(detector_mutex_);
-    
-    auto it = thresholds_.find(metric_name);
-    if (it == thresholds_.end()) {
-        return false;
+    auto& slot = metrics_[metric_name];
+    if (slot) {
+        slot->configure(threshold);
+    } else {
+        slot = std::make_unique<AnomalyMetric>(threshold);
     }
-    
-    const auto& threshold = it->second;
-    double z_score = std::abs(value - threshold.mean) / threshold.std_dev;
-    
-    return z_score > threshold.z_score_threshold;
+    return *slot;
 }
 
-void AnomalyDetector::update_baseline(const std::string& metric_name, double value) {
-    std::unique_lock lock(detector_mutex_);
-    
-    history_[metric_name].push_back(value);
-    
-    // Keep window size
-    auto& hist = history_[metric_name];
-    if (hist.size() > thresholds_[metric_name].window_size) {
-        hist.erase(hist.begin());
+AnomalyMetric& AnomalyDetector::metric(const std::string& metric_name) {
+    {
+        std::shared_lock lock(detector_mutex_);
+        auto it = metrics_.find(metric_name);
+        if (it != metrics_.end()) return *it->second;
     }
-    
-    calculate_statistics(metric_name);
+    std::unique_lock lock(detector_mutex_);
+    auto& slot = metrics_[metric_name];
+    if (!slot) slot = std::make_unique<AnomalyMetric>(AnomalyThreshold{});
+    return *slot;
 }
 
-void AnomalyDetector::calculate_statistics(const std::string& metric_name) {
-    auto& hist = history_[metric_name];
-    if (hist.size() < 10) return;  // Need minimum samples
-    
-    // Calculate mean
-    double sum = 0;
-    for (double val : hist) {
-        sum += val;
-    }
-    double mean = sum / hist.size();
+bool AnomalyDetector::is_anomaly(const std::string& metric_name, double value) {
+    std::shared_lock lock(detector_mutex_);
     
-    // Calculate standard deviation
-    double variance = 0;
-    for (double val : hist) {
-        variance += (val - mean) * (val - mean);
+    auto it = metrics_.find(metric_name);
+    if (it == metrics_.end()) {
+        return false;
     }
-    double std_dev = std::sqrt(variance / hist.size());
     
-    thresholds_[metric_name].mean = mean;
-    thresholds_[metric_name].std_dev = std_dev;
+    return it->second->is_anomaly(value);
 }
 
 // AlertManager implementation
@@ -490,71 +470,84 @@ PerformanceCounters& PerformanceCounters::instance() {
     return instance;
 }
 
-void PerformanceCounters::record_latency(const std::string& operation, std::chrono::nanoseconds latency) {
-    std::unique_lock lock(counters_mutex_);
-    
-    double latency_us = latency.count() / 1000.0;
-    latencies_[operation].push_back(latency_us);
-    
-    // Keep only recent measurements
-    if (latencies_[operation].size() > 10000) {
-        latencies_[operation].erase(latencies_[operation].begin(), 
-                                   latencies_[operation].begin() + 5000);
+OperationCounters& PerformanceCounters::operation(const std::string& operation) {
+    {
+        std::shared_lock lock(counters_mutex_);
+        auto it = operations_.find(operation);
+        if (it != operations_.end()) return *it->second;
     }
-    
-    // Update metrics
-    MetricsCollector::instance().record_histogram(operation + "_latency_us", latency_us);
+    std::unique_lock lock(counters_mutex_);
+    auto& slot = operations_[operation];
+    if (!slot) slot = std::make_unique<OperationCounters>();
+    return *slot;
+}
+
+const OperationCounters* PerformanceCounters::find(const std::string& operation) const {
+    std::shared_lock lock(counters_mutex_);
+    auto it = operations_.find(operation);
+    return it != operations_.end() ? it->second.get() : nullptr;
+}
+
+void PerformanceCounters::record_latency(const std::string& operation, std::chrono::nanoseconds latency) {
+    record_latency(this->operation(operation), latency);
 }
 
 void PerformanceCounters::record_throughput(const std::string& operation, uint64_t count) {
-    throughput_counters_[operation].store(throughput_counters_[operation].load() + count);
-    total_counters_[operation].store(total_counters_[operation].load() + count);
-    
-    MetricsCollector::instance().increment_counter(operation + "_throughput");
+    record_throughput(this->operation(operation), count);
 }
 
 void PerformanceCounters::record_error(const std::string& operation, const std::string& error_type) {
-    error_counters_[operation].store(error_counters_[operation].load() + 1);
-    total_counters_[operation].store(total_counters_[operation].load() + 1);
+    auto& op = this->operation(operation);
+    op.errors.fetch_add(1, std::memory_order_relaxed);
+    op.total.fetch_add(1, std::memory_order_relaxed);
     
+    // Error path: the labeled counter may lock
     MetricsCollector::instance().increment_counter(operation + "_errors", {{"type", error_type}});
 }
 
 double PerformanceCounters::get_avg_latency(const std::string& operation) const {
-    std::shared_lock lock(counters_mutex_);
-    
-    auto it = latencies_.find(operation);
-    if (it == latencies_.end() || it->second.empty()) {
-        return 0.0;
-    }
-    
-    double sum = 0;
-    for (double latency : it->second) {
-        sum += latency;
-    }
-    
-    return sum / it->second.size();
+    const OperationCounters* op = find(operation);
+    return op ? op->latency.get_stats().avg_ns / 1000.0 : 0.0;
+}
+
+double PerformanceCounters::get_latency_percentile(const std::string& operation, double percentile) const {
+    const OperationCounters* op = find(operation);
+    return op ? op->latency.snapshot().percentile(percentile) / 1000.0 : 0.0;
 }
 
 uint64_t PerformanceCounters::get_throughput(const std::string& operation) const {
-    auto it = throughput_counters_.find(operation);
-    return it != throughput_counters_.end() ? it->second.load() : 0;
+    const OperationCounters* op = find(operation);
+    return op ? op->throughput.load(std::memory_order_relaxed) : 0;
 }
 
 double PerformanceCounters::get_error_rate(const std::string& operation) const {
-    auto error_it = error_counters_.find(operation);
-    auto total_it = total_counters_.find(operation);
-    
-    if (error_it == error_counters_.end() || total_it == total_counters_.end()) {
+    const OperationCounters* op = find(operation);
+    if (!op) {
         return 0.0;
     }
     
-    uint64_t errors = error_it->second.load();
-    uint64_t total = total_it->second.load();
+    uint64_t errors = op->errors.load(std::memory_order_relaxed);
+    uint64_t total = op->total.load(std::memory_order_relaxed);
     
     return total > 0 ? static_cast<double>(errors) / total : 0.0;
 }
 
+void PerformanceCounters::publish() const {
+    std::vector<std::pair<std::string, const OperationCounters*>> operations;
+    {
+        std::shared_lock lock(counters_mutex_);
+        for (const auto& [name, op] : operations_) operations.emplace_back(name, op.get());
+    }
+    auto& metrics = MetricsCollector::instance();
+    for (const auto& [name, op] : operations) {
+        metrics.set_gauge(name + "_throughput", static_cast<double>(op->throughput.load(std::memory_order_relaxed)));
+        const auto stats = op->latency.get_stats();
+        if (stats.count == 0) continue;
+        metrics.set_gauge(name + "_latency_us", stats.avg_ns / 1000.0);
+        metrics.set_gauge(name + "_latency_p99_us", stats.p99_ns / 1000.0);
+    }
+}
+
 // BusinessMetrics implementation
 BusinessMetrics& BusinessMetrics::instance() {
     static BusinessMetrics instance;
@@ -759,6 +752,7 @@ void ObservabilityStack::monitoring_loop() {
         
         // Update performance metrics
         auto& perf = PerformanceCounters::instance();
+        perf.publish();
         MetricsCollector::instance().set_gauge("system_health", 1.0);
         
         std::this_thread::sleep_for(std::chrono::seconds(10));
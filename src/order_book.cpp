@@ -9,6 +9,7 @@
 #include "rtes/performance_optimizer.hpp"
 #include "rtes/thread_safety.hpp"
 #include <algorithm>
+#include <cstring>
 
 #if defined(__x86_64__) || defined(_M_X64)
 #include <immintrin.h>
@@ -22,18 +23,32 @@
 namespace rtes {
 
 OrderBook::OrderBook(const std::string& symbol, OrderPool& pool,
-                     TradeCallback callback, void* cb_ctx)
-    : pool_(pool)
+                     TradeCallback callback, void* cb_ctx,
+                     const OrderBookOptions& options)
+    : bids_(pool, options)
+    , asks_(pool, options)
+    , order_lookup_(pool.max_capacity())
+    , shutdown_requested_(false)
+    , stp_(options.self_trade)
+    , pool_(pool)
     , trade_callback_(callback)
     , callback_ctx_(cb_ctx)
+    , buy_stops_(pool, options)
+    , sell_stops_(pool, options)
     , symbol_(symbol)
-    , shutdown_requested_(false)
+    , options_(options)
 {
     ShutdownManager::instance().register_component(
         "OrderBook_" + symbol_,
         [this]() { shutdown(); }
     );
 
+    if (options_.queue_positions) {
+        queue_slots_ = std::make_unique<QueueSlots>(pool.capacity());
+        bids_.track_queue_positions(queue_slots_.get());
+        asks_.track_queue_positions(queue_slots_.get());
+    }
+
     perf_optimizer_ = std::make_unique<PerformanceOptimizer>();
 
     metrics_.add_order_latency = &perf_optimizer_->get_latency_tracker("add_order");
@@ -41,103 +56,303 @@ OrderBook::OrderBook(const std::string& symbol, OrderPool& pool,
     metrics_.trade_latency     = &perf_optimizer_->get_latency_tracker("execute_trade");
     metrics_.order_throughput  = &perf_optimizer_->get_throughput_tracker("add_order");
     metrics_.match_throughput  = &perf_optimizer_->get_throughput_tracker("matching");
+    metrics_.add_order_latency->set_sample_every(options_.latency_sample);
+    metrics_.match_latency->set_sample_every(options_.latency_sample);
+    metrics_.trade_latency->set_sample_every(options_.latency_sample);
 }
 
 OrderBook::~OrderBook() = default;
 
-Result<void> OrderBook::add_order(Order* order) {
+Result<BookChange> OrderBook::add_order(Order* order) {
     if (shutdown_requested_) return ErrorCode::SYSTEM_SHUTDOWN;
     MEASURE_LATENCY(*metrics_.add_order_latency);
-    metrics_.order_throughput->record_event();
+    begin_change();
+    RECORD_EVENT(*metrics_.order_throughput);
 
     if (!order || order->remaining_quantity == 0) return ErrorCode::ORDER_INVALID;
-    if (order_lookup_.find(order->id) != order_lookup_.end()) return ErrorCode::ORDER_DUPLICATE;
+    if (has_limit_price(order->type) && !bids_.on_tick(order->price)) return ErrorCode::ORDER_INVALID;
+    if (order_lookup_.contains(order->id)) return ErrorCode::ORDER_DUPLICATE;
+    if (phase_ == TradingPhase::HALTED) [[unlikely]] return ErrorCode::ORDER_HALTED;
+    order->hidden_quantity = 0;  // Aggressor trades its full size; reserve is split on rest
+
+    // Auction: LIMIT / POST_ONLY accumulate unmatched — crossing is resolved at uncross()
+    const bool auction = (phase_ == TradingPhase::AUCTION);
+    if (auction && order->type != OrderType::LIMIT && order->type != OrderType::POST_ONLY) [[unlikely]] {
+        return ErrorCode::ORDER_INVALID;
+    }
 
-    try {
-        order_lookup_[order->id] = order;
+    bool stop_market = false;  // Activated STOP: remainder is cancelled, not rested
+    if (is_stop(order->type)) [[unlikely]] {
+        if (order->stop_price == 0 || !bids_.on_tick(order->stop_price)) return ErrorCode::ORDER_INVALID;
+        if (!stop_reached(order)) {
+            auto parked = park_stop(order);  // Stop books are not visible: nothing to report
+            if (parked.has_error()) return parked.error();
+            return change_;
+        }
+        // Market already through the stop — activate on arrival
+        stop_market = (order->type == OrderType::STOP);
+        order->type = stop_market ? OrderType::MARKET : OrderType::LIMIT;
+    }
 
-        auto match_result = match_order(order);
-        if (match_result.has_error()) {
-            order_lookup_.erase(order->id);
-            return match_result.error();
+    try {
+        if (!auction) [[likely]] {
+            auto match_result = match_order(order);
+            if (match_result.has_error()) return match_result.error();
         }
 
-        if (order->remaining_quantity > 0) {
+        // IOC / market / stop-market / STP remainder is cancelled in place (FOK never
+        // leaves one); a market remainder has no price to rest at
+        if (order->remaining_quantity > 0 &&
+            (!rests_remainder(order->type) || order->type == OrderType::MARKET || stop_market ||
+             order->status == OrderStatus::CANCELLED)) {
+            order->status = OrderStatus::CANCELLED;
+        }
+        // Only resting orders are indexed — fully filled aggressors never touch the map
+        else if (order->remaining_quantity > 0) {
+            order->split_reserve();
+            if (!order_lookup_.insert(order->id, order)) [[unlikely]] {
+                return ErrorCode::MEMORY_POOL_EXHAUSTED;
+            }
             auto book_result = add_to_book(order);
             if (book_result.has_error()) {
                 order_lookup_.erase(order->id);
                 return book_result.error();
             }
-        } else {
-            order_lookup_.erase(order->id);
         }
 
-        update_bbo_snapshot();
-        return Result<void>();
+        if (stops_triggered()) [[unlikely]] activate_stops();
+        return finish_change();
     } catch (const std::exception& e) {
         LOG_ERROR_SAFE("Exception in add_order: {}", e.what());
         return ErrorCode::SYSTEM_CORRUPTED_STATE;
     }
 }
 
-Result<void> OrderBook::cancel_order(OrderID order_id) {
+Result<BookChange> OrderBook::cancel_order(OrderID order_id) {
     if (shutdown_requested_) return ErrorCode::SYSTEM_SHUTDOWN;
-    auto it = order_lookup_.find(order_id);
-    if (it == order_lookup_.end()) return ErrorCode::ORDER_NOT_FOUND;
+    Order** slot = order_lookup_.find(order_id);
+    if (!slot) return ErrorCode::ORDER_NOT_FOUND;
 
+    begin_change();
     try {
-        Order* order = it->second;
+        Order* order = *slot;
         remove_from_book(order);
-        order_lookup_.erase(it);
+        order_lookup_.erase(order_id);
         order->status = OrderStatus::CANCELLED;
-        pool_.deallocate(order);
-        update_bbo_snapshot();
-        return Result<void>();
+        release(order);
+        return finish_change();
     } catch (const std::exception& e) {
         LOG_ERROR_SAFE("Exception in cancel_order: {}", e.what());
         return ErrorCode::SYSTEM_CORRUPTED_STATE;
     }
 }
 
+size_t OrderBook::mass_cancel(ClientIDRaw owner) {
+    begin_change();
+    if (shutdown_requested_ || owner == 0) return 0;
+
+    // Collect first: erase() backward-shifts slots under a live for_each
+    sweep_scratch_.clear();
+    order_lookup_.for_each([&](OrderID, Order* order) {
+        if (order->owner == owner) sweep_scratch_.push_back(order);
+    });
+
+    for (Order* order : sweep_scratch_) {
+        remove_from_book(order);
+        order_lookup_.erase(order->id);
+        order->status = OrderStatus::CANCELLED;
+        release(order);
+    }
+    if (!sweep_scratch_.empty()) finish_change();
+    return sweep_scratch_.size();
+}
+
+Result<BookChange> OrderBook::modify_order(OrderID order_id, Quantity new_quantity, Price new_price) {
+    if (shutdown_requested_) return ErrorCode::SYSTEM_SHUTDOWN;
+    Order** slot = order_lookup_.find(order_id);
+    if (!slot) return ErrorCode::ORDER_NOT_FOUND;
+    if (new_quantity == 0) return ErrorCode::ORDER_INVALID;
+
+    Order* order = *slot;
+    if (is_stop(order->type)) return ErrorCode::ORDER_INVALID;
+    if (new_price == 0) new_price = order->price;
+    if (has_limit_price(order->type) && !bids_.on_tick(new_price)) return ErrorCode::ORDER_INVALID;
+
+    begin_change();
+    try {
+        // Keep filled quantity: quantity − open is invariant
+        const Quantity filled = order->quantity - order->open_quantity();
+
+        if (phase_ == TradingPhase::HALTED &&
+            (new_price != order->price || new_quantity > order->open_quantity())) [[unlikely]] {
+            return ErrorCode::ORDER_HALTED;
+        }
+
+        if (new_price == order->price) {
+            if (new_quantity <= order->open_quantity()) {
+                // Size-down in place — no unlink, queue position kept.
+                // Iceberg reserve shrinks first, then the displayed slice.
+                FlatLevel* level = (order->side == Side::BUY) ? bids_.find(order->price)
+                                                              : asks_.find(order->price);
+                if (!level) [[unlikely]] return ErrorCode::SYSTEM_CORRUPTED_STATE;
+                const Quantity shown = std::min(order->remaining_quantity, new_quantity);
+                const bool display_changed = shown != order->remaining_quantity;
+                level->reduce_quantity(order, order->remaining_quantity - shown);
+                note_level(order->side, order->price);
+                order->remaining_quantity = shown;
+                order->hidden_quantity    = new_quantity - shown;
+                order->quantity = filled + new_quantity;
+                // A reserve-only change is not visible
+                if (display_changed) emit_order_event(OrderEvent::MODIFY, *order);
+            } else {
+                // Size-up loses priority — requeue at the back
+                remove_from_book(order);
+                order->remaining_quantity = new_quantity;
+                order->hidden_quantity    = 0;
+                order->split_reserve();
+                order->quantity = filled + new_quantity;
+                auto book_result = add_to_book(order);
+                if (book_result.has_error()) return book_result.error();
+            }
+            return finish_change();
+        }
+
+        // Price move — single in-engine remove + re-enter
+        const bool continuous = (phase_ == TradingPhase::CONTINUOUS);
+        if (continuous && order->type == OrderType::POST_ONLY && would_cross(order->side, new_price)) {
+            return ErrorCode::ORDER_WOULD_CROSS;
+        }
+        remove_from_book(order);
+        order->price = new_price;
+        order->remaining_quantity = new_quantity;
+        order->hidden_quantity    = 0;
+        order->quantity = filled + new_quantity;
+
+        if (continuous) {
+            auto match_result = match_limit_order(order);
+            if (match_result.has_error()) return match_result.error();
+        }
+
+        if (order->remaining_quantity > 0 && order->status != OrderStatus::CANCELLED) {
+            order->split_reserve();
+            auto book_result = add_to_book(order);
+            if (book_result.has_error()) return book_result.error();
+        } else {
+            // Filled (or STP-cancelled) on arrival — the book owned it while resting
+            order_lookup_.erase(order_id);
+            release(order);
+        }
+        if (stops_triggered()) [[unlikely]] activate_stops();
+        return finish_change();
+    } catch (const std::exception& e) {
+        LOG_ERROR_SAFE("Exception in modify_order: {}", e.what());
+        return ErrorCode::SYSTEM_CORRUPTED_STATE;
+    }
+}
+
 Result<void> OrderBook::match_order(Order* order) {
     if (shutdown_requested_) return ErrorCode::SYSTEM_SHUTDOWN;
     MEASURE_LATENCY(*metrics_.match_latency);
-    metrics_.match_throughput->record_event();
+    RECORD_EVENT(*metrics_.match_throughput);
     if (!order) return ErrorCode::ORDER_INVALID;
 
     try {
-        if (order->type == OrderType::MARKET) return match_market_order(order);
-        else return match_limit_order(order);
+        switch (order->type) {
+            case OrderType::MARKET:
+                return match_market_order(order);
+            case OrderType::POST_ONLY:
+                if (would_cross(order->side, order->price)) return ErrorCode::ORDER_WOULD_CROSS;
+                return Result<void>();
+            case OrderType::FOK:
+                if (!can_fill(order)) return ErrorCode::ORDER_UNFILLABLE;
+                return match_limit_order(order);
+            case OrderType::LIMIT:
+            case OrderType::IOC:
+                return match_limit_order(order);
+            case OrderType::STOP:
+            case OrderType::STOP_LIMIT:
+                return ErrorCode::ORDER_INVALID;  // Activation converts a stop to MARKET / LIMIT first
+        }
+        return ErrorCode::ORDER_INVALID;
     } catch (const std::exception& e) {
         LOG_ERROR_SAFE("Exception in match_order: {}", e.what());
         return ErrorCode::SYSTEM_CORRUPTED_STATE;
     }
 }
 
+bool OrderBook::can_fill(const Order* order) const {
+    // Fillable inside the band only: the sweep would stop at it
+    const Price limit = (order->side == Side::BUY) ? std::min(order->price, band_high_)
+                                                   : std::max(order->price, band_low_);
+    auto available = [order, limit](const auto& opposite) {
+        Quantity cumulative = 0;
+        opposite.for_each_level([&](const FlatLevel& level) {
+            const bool crosses = (order->side == Side::BUY) ? (limit >= level.price) : (limit <= level.price);
+            if (!crosses) return false;
+            cumulative += level.total_quantity;
+            return cumulative < order->remaining_quantity;
+        });
+        return cumulative >= order->remaining_quantity;
+    };
+    return (order->side == Side::BUY) ? available(asks_) : available(bids_);
+}
+
+Result<QueuePosition> OrderBook::queue_position(OrderID order_id) const {
+    Order* const* slot = order_lookup_.find(order_id);
+    if (!slot) return ErrorCode::ORDER_NOT_FOUND;
+    const Order* order = *slot;
+    if (!queue_slots_ || is_stop(order->type)) return ErrorCode::ORDER_INVALID;
+    const FlatLevel* level = (order->side == Side::BUY) ? bids_.find(order->price) : asks_.find(order->price);
+    if (!level) [[unlikely]] return ErrorCode::SYSTEM_CORRUPTED_STATE;
+    return level->queue_position(order);
+}
+
+bool OrderBook::would_cross(Side side, Price price) const {
+    if (side == Side::BUY) return !asks_.empty() && price >= asks_.best_price();
+    else return !bids_.empty() && price <= bids_.best_price();
+}
+
 Result<void> OrderBook::match_market_order(Order* order) {
+    sweep_time_ = 0;
+    sweep_aggressor_ = static_cast<uint8_t>(order->side);
     try {
+        const Side passive_side = (order->side == Side::BUY) ? Side::SELL : Side::BUY;
+        const Price bound = (order->side == Side::BUY) ? band_high_ : band_low_;
         auto sweep = [&](auto& opposite) -> Result<void> {
             while (order->remaining_quantity > 0 && !opposite.empty()) {
-                FlatLevel& level = opposite[0];
-                if (level.empty()) { opposite.remove(level.price); continue; }
+                FlatLevel& level = opposite.best_level();
+                note_level(passive_side, level.price);
+                if (level.empty()) { opposite.remove_best(); continue; }
+                const bool inside = (order->side == Side::BUY) ? (level.price <= bound) : (level.price >= bound);
+                if (!inside) [[unlikely]] break;
                 Order* passive = level.front();
 
-                if (level.size() > 1) PREFETCH(level.orders[level.head_ + 1], PREFETCH_HINT_T0);
+                if (Order* next = level.second()) PREFETCH(next, PREFETCH_HINT_T0);
+
+                if (stp_ != SelfTradePrevention::NONE && order->owner != 0 &&
+                    passive->owner == order->owner) [[unlikely]] {
+                    const bool done = prevent_self_trade(order, level, passive);
+                    if (level.empty()) opposite.remove_best();
+                    if (done) break;
+                    continue;
+                }
 
                 Quantity qty = std::min(order->remaining_quantity, passive->remaining_quantity);
                 execute_trade(order, passive, qty, level.price);
 
                 if (passive->remaining_quantity == 0) {
-                    level.pop_front(qty);
-                    order_lookup_.erase(passive->id);
-                    passive->status = OrderStatus::FILLED;
-                    pool_.deallocate(passive);
+                    retire_front(level, passive, qty, OrderStatus::FILLED);
                 } else {
-                    level.reduce_quantity(qty);
+                    level.reduce_quantity(passive, qty);
                 }
 
-                if (level.empty()) opposite.remove(level.price);
+                if (level.empty()) opposite.remove_best();  // Tombstone, no shift
             }
+            // Liquidity left behind a market order: only the band (or STP) stops it
+            if (order->remaining_quantity > 0 && !opposite.empty()) [[unlikely]] {
+                trip_band(order, opposite.best_price());
+            }
+            if (last_trade_price_ != band_reference_) rebase_band();
             return Result<void>();
         };
         if (order->side == Side::BUY) return sweep(asks_);
@@ -149,32 +364,48 @@ Result<void> OrderBook::match_market_order(Order* order) {
 }
 
 Result<void> OrderBook::match_limit_order(Order* order) {
+    sweep_time_ = 0;
+    sweep_aggressor_ = static_cast<uint8_t>(order->side);
     try {
+        const Side passive_side = (order->side == Side::BUY) ? Side::SELL : Side::BUY;
+        // Clamped to the band once: the crosses compare below also stops at it
+        const Price limit = (order->side == Side::BUY) ? std::min(order->price, band_high_)
+                                                       : std::max(order->price, band_low_);
         auto sweep = [&](auto& opposite) -> Result<void> {
             while (order->remaining_quantity > 0 && !opposite.empty()) {
-                FlatLevel& level = opposite[0];
-                const bool crosses = (order->side == Side::BUY) ? (order->price >= level.price) : (order->price <= level.price);
+                FlatLevel& level = opposite.best_level();
+                const bool crosses = (order->side == Side::BUY) ? (limit >= level.price) : (limit <= level.price);
                 if (!crosses) break;
+                note_level(passive_side, level.price);
 
-                if (level.empty()) { opposite.remove(level.price); continue; }
+                if (level.empty()) { opposite.remove_best(); continue; }
                 Order* passive = level.front();
 
-                if (level.size() > 1) PREFETCH(level.orders[level.head_ + 1], PREFETCH_HINT_T0);
+                if (Order* next = level.second()) PREFETCH(next, PREFETCH_HINT_T0);
+
+                if (stp_ != SelfTradePrevention::NONE && order->owner != 0 &&
+                    passive->owner == order->owner) [[unlikely]] {
+                    const bool done = prevent_self_trade(order, level, passive);
+                    if (level.empty()) opposite.remove_best();
+                    if (done) break;
+                    continue;
+                }
 
                 Quantity qty = std::min(order->remaining_quantity, passive->remaining_quantity);
                 execute_trade(order, passive, qty, level.price);
 
                 if (passive->remaining_quantity == 0) {
-                    level.pop_front(qty);
-                    order_lookup_.erase(passive->id);
-                    passive->status = OrderStatus::FILLED;
-                    pool_.deallocate(passive);
+                    retire_front(level, passive, qty, OrderStatus::FILLED);
                 } else {
-                    level.reduce_quantity(qty);
+                    level.reduce_quantity(passive, qty);
                 }
 
-                if (level.empty()) opposite.remove(level.price);
+                if (level.empty()) opposite.remove_best();  // Tombstone, no shift
+            }
+            if (limit != order->price && order->remaining_quantity > 0 && !opposite.empty()) [[unlikely]] {
+                trip_band(order, opposite.best_price());
             }
+            if (last_trade_price_ != band_reference_) rebase_band();
             return Result<void>();
         };
         if (order->side == Side::BUY) return sweep(asks_);
@@ -185,6 +416,62 @@ Result<void> OrderBook::match_limit_order(Order* order) {
     }
 }
 
+void OrderBook::retire_front(FlatLevel& level, Order* passive, Quantity consumed,
+                             OrderStatus final_status) {
+    level.pop_front(consumed);
+    if (passive->hidden_quantity > 0) [[unlikely]] {
+        // Iceberg: next slice joins the back of the queue
+        passive->refresh_slice();
+        passive->status = OrderStatus::PARTIALLY_FILLED;
+        level.push_back(passive);
+        emit_order_event(OrderEvent::ADD, *passive);
+        return;
+    }
+    // A fill was reported by execute_trade; an STP cancel is reported here
+    if (final_status == OrderStatus::CANCELLED) emit_order_event(OrderEvent::CANCEL, *passive);
+    order_lookup_.erase(passive->id);
+    passive->status = final_status;
+    release(passive);
+}
+
+bool OrderBook::prevent_self_trade(Order* aggressor, FlatLevel& level, Order* passive) {
+    auto cancel_passive = [&] {
+        passive->hidden_quantity = 0;  // Whole order, reserve included
+        retire_front(level, passive, passive->remaining_quantity, OrderStatus::CANCELLED);
+    };
+
+    switch (stp_) {
+        case SelfTradePrevention::CANCEL_OLDEST:
+            cancel_passive();
+            return false;
+        case SelfTradePrevention::CANCEL_BOTH:
+            cancel_passive();
+            [[fallthrough]];
+        case SelfTradePrevention::CANCEL_NEWEST:
+            aggressor->status = OrderStatus::CANCELLED;
+            return true;
+        case SelfTradePrevention::DECREMENT: {
+            const Quantity qty = std::min(aggressor->remaining_quantity, passive->remaining_quantity);
+            aggressor->remaining_quantity -= qty;
+            passive->remaining_quantity   -= qty;
+            if (passive->remaining_quantity == 0) {
+                retire_front(level, passive, qty, OrderStatus::CANCELLED);
+            } else {
+                level.reduce_quantity(passive, qty);
+                emit_order_event(OrderEvent::MODIFY, *passive);
+            }
+            if (aggressor->remaining_quantity == 0) {
+                aggressor->status = OrderStatus::CANCELLED;
+                return true;
+            }
+            return false;
+        }
+        case SelfTradePrevention::NONE:
+            break;
+    }
+    return false;
+}
+
 void OrderBook::execute_trade(Order* aggressive, Order* passive, Quantity quantity, Price price) {
     MEASURE_LATENCY(*metrics_.trade_latency);
     PREFETCH(aggressive, PREFETCH_HINT_T0);
@@ -192,16 +479,26 @@ void OrderBook::execute_trade(Order* aggressive, Order* passive, Quantity quanti
 
     aggressive->remaining_quantity -= quantity;
     passive->remaining_quantity -= quantity;
+    last_trade_price_ = price;  // Stops are checked once the sweep completes
 
     aggressive->status = (aggressive->remaining_quantity == 0) ? OrderStatus::FILLED : OrderStatus::PARTIALLY_FILLED;
     passive->status = (passive->remaining_quantity == 0) ? OrderStatus::FILLED : OrderStatus::PARTIALLY_FILLED;
 
+    if (sweep_time_ == 0) sweep_time_ = fixed_time_ ? fixed_time_ : now_timestamp();
     Trade trade(next_trade_id_++,
                 (aggressive->side == Side::BUY) ? aggressive->id : passive->id,
                 (aggressive->side == Side::SELL) ? aggressive->id : passive->id,
-                symbol_.c_str(), quantity, price);
+                symbol_.c_str(), quantity, price, sweep_time_);
 
+    ++change_.fills;
     if (trade_callback_) trade_callback_(trade, callback_ctx_);
+    if (order_fill_callback_) {
+        order_fill_callback_(*aggressive, quantity, price, callback_ctx_);
+        order_fill_callback_(*passive, quantity, price, callback_ctx_);
+    }
+    // Both sides rest during an uncross (bid is passed as the aggressor)
+    if (sweep_aggressor_ == 0) emit_order_event(OrderEvent::EXECUTE, *aggressive, quantity);
+    emit_order_event(OrderEvent::EXECUTE, *passive, quantity);
 }
 
 Result<void> OrderBook::add_to_book(Order* order) {
@@ -211,6 +508,8 @@ Result<void> OrderBook::add_to_book(Order* order) {
             FlatLevel& level = book.find_or_insert(order->price);
             level.push_back(order);
             order->status = OrderStatus::ACCEPTED;
+            note_level(order->side, order->price);
+            emit_order_event(OrderEvent::ADD, *order);
             return Result<void>();
         };
         if (order->side == Side::BUY) return insert_into(bids_);
@@ -222,64 +521,297 @@ Result<void> OrderBook::add_to_book(Order* order) {
 }
 
 void OrderBook::remove_from_book(Order* order) {
-    auto remove_from = [&](auto& book) {
-        FlatLevel* level = book.find(order->price);
+    auto remove_from = [&](auto& book, Price key) {
+        FlatLevel* level = book.find(key);
         if (!level) return;
-        auto& v = level->orders;
-        for (size_t i = level->head_; i < v.size(); ++i) {
-            if (v[i] == order) {
-                v.erase(v.begin() + i);
-                if (i < level->head_) --level->head_;
-                level->total_quantity -= order->remaining_quantity;
-                if (level->empty()) book.remove(order->price);
-                return;
-            }
-        }
+        if (level->remove(order) && level->empty()) book.remove(key);
     };
-    if (order->side == Side::BUY) remove_from(bids_);
-    else remove_from(asks_);
+    if (is_stop(order->type)) [[unlikely]] {
+        if (order->side == Side::BUY) remove_from(buy_stops_, order->stop_price);
+        else remove_from(sell_stops_, order->stop_price);
+        return;
+    }
+    if (order->side == Side::BUY) remove_from(bids_, order->price);
+    else remove_from(asks_, order->price);
+    note_level(order->side, order->price);
+    emit_order_event(OrderEvent::CANCEL, *order);
+}
+
+void OrderBook::release(Order* order) {
+    if (order_done_callback_) order_done_callback_(*order, callback_ctx_);
+    if (release_batch_) {
+        release_batch_->add(order);
+    } else {
+        pool_.deallocate(order);
+    }
+}
+
+Result<void> OrderBook::park_stop(Order* order) {
+    if (!order_lookup_.insert(order->id, order)) [[unlikely]] {
+        return ErrorCode::MEMORY_POOL_EXHAUSTED;
+    }
+    try {
+        if (order->side == Side::BUY) buy_stops_.find_or_insert(order->stop_price).push_back(order);
+        else sell_stops_.find_or_insert(order->stop_price).push_back(order);
+        order->status = OrderStatus::ACCEPTED;
+        return Result<void>();
+    } catch (const std::exception& e) {
+        order_lookup_.erase(order->id);
+        LOG_ERROR_SAFE("Exception in park_stop: {}", e.what());
+        return ErrorCode::SYSTEM_CORRUPTED_STATE;
+    }
+}
+
+void OrderBook::activate_stops() {
+    auto pop_front = [](auto& stops) {
+        FlatLevel& level = stops.best_level();
+        Order* o = level.front();
+        level.pop_front(o->remaining_quantity);
+        if (level.empty()) stops.remove_best();
+        return o;
+    };
+
+    // A stop that trips the band leaves the rest parked for the uncross
+    while (phase_ == TradingPhase::CONTINUOUS && stops_triggered()) {
+        const bool buy = !buy_stops_.empty() && buy_stops_.best_price() <= last_trade_price_;
+        Order* order = buy ? pop_front(buy_stops_) : pop_front(sell_stops_);
+        order_lookup_.erase(order->id);
+        order->type = (order->type == OrderType::STOP) ? OrderType::MARKET : OrderType::LIMIT;
+
+        const bool rests = match_order(order).has_value() &&
+                           order->remaining_quantity > 0 && order->type == OrderType::LIMIT &&
+                           order->status != OrderStatus::CANCELLED;
+        if (rests) {
+            order->split_reserve();
+            if (order_lookup_.insert(order->id, order) && add_to_book(order).has_value()) [[likely]] continue;
+            order_lookup_.erase(order->id);
+        }
+        // Filled, or a stop-market remainder with nothing left to sweep
+        if (order->remaining_quantity > 0) order->status = OrderStatus::CANCELLED;
+        release(order);
+    }
 }
 
 void OrderBook::get_depth(DepthSnapshot& out, size_t max_levels) const {
     out.bid_levels = 0;
     out.ask_levels = 0;
 
-    for (size_t i = 0; i < bids_.level_count() && out.bid_levels < max_levels && out.bid_levels < MAX_DEPTH_LEVELS; ++i) {
-        const FlatLevel& l = bids_[i];
-        if (!l.empty()) out.bids[out.bid_levels++] = {l.price, l.total_quantity, static_cast<uint32_t>(l.size())};
+    auto fill_side = [max_levels](const auto& book, auto& levels, size_t& count) {
+        book.for_each_level([&](const FlatLevel& l) {
+            if (count >= max_levels || count >= MAX_DEPTH_LEVELS) return false;
+            if (!l.empty()) levels[count++] = {l.price, l.total_quantity, static_cast<uint32_t>(l.size())};
+            return true;
+        });
+    };
+    fill_side(bids_, out.bids, out.bid_levels);
+    fill_side(asks_, out.asks, out.ask_levels);
+}
+
+OrderBook::LatencySnapshot OrderBook::latency_snapshot() const {
+    return {
+        .add_order = metrics_.add_order_latency->snapshot(),
+        .match     = metrics_.match_latency->snapshot(),
+        .trade     = metrics_.trade_latency->snapshot(),
+    };
+}
+
+void OrderBook::publish_depth(size_t max_levels, uint64_t update_sequence) {
+    depth_buffer_.publish([&](DepthSnapshot& snapshot) {
+        get_depth(snapshot, max_levels);
+        snapshot.update_sequence = update_sequence;
+        snapshot.timestamp_ns = now_timestamp();
+    });
+}
+
+AuctionResult OrderBook::indicative_uncross() const {
+    AuctionResult best;
+    if (bids_.empty() || asks_.empty() || bids_.best_price() < asks_.best_price()) return best;
+
+    // Crossing levels only: bids ≥ best ask, asks ≤ best bid.
+    // Iceberg reserve counts — it executes as slices refresh.
+    auto open_quantity = [](const FlatLevel& l) {
+        Quantity q = 0;
+        l.for_each_order([&](const Order& o) { q += o.open_quantity(); });
+        return q;
+    };
+    const Price lowest = asks_.best_price();
+    const Price highest = bids_.best_price();
+    auction_bids_.clear();
+    auction_asks_.clear();
+    Quantity bid_total = 0;
+    bids_.for_each_level([&](const FlatLevel& l) {
+        if (l.price < lowest) return false;
+        auction_bids_.push_back({l.price, open_quantity(l), 0});
+        bid_total += auction_bids_.back().quantity;
+        return true;
+    });
+    asks_.for_each_level([&](const FlatLevel& l) {
+        if (l.price > highest) return false;
+        auction_asks_.push_back({l.price, open_quantity(l), 0});
+        return true;
+    });
+
+    // Ascending merge of candidate prices:
+    //   ask_cum = asks priced ≤ p, bid_cum = bids priced ≥ p
+    const auto& asks = auction_asks_;
+    const auto& bids = auction_bids_;  // Descending — walked from the back
+    size_t i = 0;
+    size_t j = bids.size();
+    Quantity ask_cum = 0;
+    Quantity bid_below = 0;
+    Quantity best_imbalance = 0;
+    auto distance = [this](Price p) {
+        return (p > last_trade_price_) ? p - last_trade_price_ : last_trade_price_ - p;
+    };
+
+    while (i < asks.size() || j > 0) {
+        const bool take_ask = (j == 0) || (i < asks.size() && asks[i].price <= bids[j - 1].price);
+        const Price p = take_ask ? asks[i].price : bids[j - 1].price;
+        while (i < asks.size() && asks[i].price == p) ask_cum += asks[i++].quantity;
+        const Quantity bid_cum = bid_total - bid_below;
+        while (j > 0 && bids[j - 1].price == p) bid_below += bids[--j].quantity;
+
+        const Quantity volume = std::min(ask_cum, bid_cum);
+        const Quantity imbalance = (ask_cum > bid_cum) ? ask_cum - bid_cum : bid_cum - ask_cum;
+        const bool better =
+            volume > best.volume ||
+            (volume == best.volume && volume > 0 &&
+             (imbalance < best_imbalance ||
+              (imbalance == best_imbalance && last_trade_price_ != 0 &&
+               distance(p) < distance(best.price))));
+        if (better) {
+            best = {p, volume};
+            best_imbalance = imbalance;
+        }
     }
-    for (size_t i = 0; i < asks_.level_count() && out.ask_levels < max_levels && out.ask_levels < MAX_DEPTH_LEVELS; ++i) {
-        const FlatLevel& l = asks_[i];
-        if (!l.empty()) out.asks[out.ask_levels++] = {l.price, l.total_quantity, static_cast<uint32_t>(l.size())};
+    return best;
+}
+
+AuctionResult OrderBook::uncross() {
+    const AuctionResult result = indicative_uncross();
+    begin_change();
+    phase_ = TradingPhase::CONTINUOUS;
+    sweep_time_ = 0;  // Every uncross fill shares one match time
+    sweep_aggressor_ = 0;
+
+    try {
+        Quantity left = result.volume;
+        Price noted_bid = 0, noted_ask = 0;  // Both sides advance; note each level once
+        while (left > 0) {
+            FlatLevel& bid_level = bids_.best_level();
+            FlatLevel& ask_level = asks_.best_level();
+            Order* bid = bid_level.front();
+            Order* ask = ask_level.front();
+            if (bid_level.price != noted_bid) note_level(Side::BUY, noted_bid = bid_level.price);
+            if (ask_level.price != noted_ask) note_level(Side::SELL, noted_ask = ask_level.price);
+
+            const Quantity qty = std::min({left, bid->remaining_quantity, ask->remaining_quantity});
+            execute_trade(bid, ask, qty, result.price);
+            left -= qty;
+
+            if (bid->remaining_quantity == 0) retire_front(bid_level, bid, qty, OrderStatus::FILLED);
+            else bid_level.reduce_quantity(bid, qty);
+            if (ask->remaining_quantity == 0) retire_front(ask_level, ask, qty, OrderStatus::FILLED);
+            else ask_level.reduce_quantity(ask, qty);
+
+            if (bid_level.empty()) bids_.remove_best();
+            if (ask_level.empty()) asks_.remove_best();
+        }
+        rebase_band();
+        if (stops_triggered()) [[unlikely]] activate_stops();
+    } catch (const std::exception& e) {
+        LOG_ERROR_SAFE("Exception in uncross: {}", e.what());
     }
+    finish_change();
+    return result;
 }
 
-bool OrderBook::read_bbo(BBOSnapshot& out) const {
-    uint64_t seq1 = bbo_snapshot_.sequence;
-    if (seq1 & 1) return false;
-    out = bbo_snapshot_;
-    uint64_t seq2 = bbo_snapshot_.sequence;
-    return seq1 == seq2;
+void OrderBook::capture(BookImage& image) const {
+    BookImageHeader& header = image.header;
+    header = BookImageHeader{};
+    std::memcpy(header.symbol, symbol_.c_str(), std::min(symbol_.size(), sizeof(header.symbol) - 1));
+    header.next_trade_id    = next_trade_id_;
+    header.last_trade_price = last_trade_price_;
+    header.phase            = phase_;
+
+    image.orders.clear();
+    auto copy_levels = [&image](const auto& book) {
+        book.for_each_level([&image](const FlatLevel& level) {
+            level.for_each_order([&image](const Order& order) {
+                Order& copy = image.orders.emplace_back(order);
+                copy.level_prev = nullptr;
+                copy.level_next = nullptr;
+            });
+            return true;
+        });
+    };
+    copy_levels(bids_);
+    copy_levels(asks_);
+    copy_levels(buy_stops_);
+    copy_levels(sell_stops_);
+    header.order_count = image.orders.size();
 }
 
-void OrderBook::update_bbo_snapshot() {
-    ++bbo_snapshot_.sequence;
-    bbo_snapshot_.bid_price    = bids_.best_price();
-    bbo_snapshot_.bid_quantity = bids_.best_quantity();
-    bbo_snapshot_.ask_price    = asks_.best_price();
-    bbo_snapshot_.ask_quantity = asks_.best_quantity();
-    ++bbo_snapshot_.sequence;
+Result<void> OrderBook::restore(const BookImage& image) {
+    if (order_count() != 0) return ErrorCode::ORDER_INVALID;
+
+    auto requeue = [](auto& book, Price key, Order* order) { book.find_or_insert(key).push_back(order); };
+    for (const Order& saved : image.orders) {
+        Order* order = pool_.allocate();
+        if (!order) return ErrorCode::MEMORY_POOL_EXHAUSTED;
+        new (order) Order(saved);
+        if (!order_lookup_.insert(order->id, order)) {
+            pool_.deallocate(order);
+            return ErrorCode::MEMORY_POOL_EXHAUSTED;
+        }
+        if (is_stop(order->type)) {
+            if (order->side == Side::BUY) requeue(buy_stops_, order->stop_price, order);
+            else requeue(sell_stops_, order->stop_price, order);
+        } else {
+            if (order->side == Side::BUY) requeue(bids_, order->price, order);
+            else requeue(asks_, order->price, order);
+        }
+    }
+    next_trade_id_    = image.header.next_trade_id;
+    last_trade_price_ = image.header.last_trade_price;
+    phase_            = image.header.phase;
+    rebase_band();
+    begin_change();
+    finish_change();
+    return Result<void>();
+}
+
+const BookChange& OrderBook::finish_change() {
+    const Price    bid_price    = bids_.best_price();
+    const Quantity bid_quantity = bids_.best_quantity();
+    const Price    ask_price    = asks_.best_price();
+    const Quantity ask_quantity = asks_.best_quantity();
+    change_.bid_moved   = bid_price != bbo_.bid_price;
+    change_.ask_moved   = ask_price != bbo_.ask_price;
+    change_.top_resized = !change_.moved() && (bid_quantity != bbo_.bid_quantity ||
+                                               ask_quantity != bbo_.ask_quantity);
+    if (change_.top_changed()) {
+        bbo_.bid_price    = bid_price;
+        bbo_.bid_quantity = bid_quantity;
+        bbo_.ask_price    = ask_price;
+        bbo_.ask_quantity = ask_quantity;
+        ++bbo_.sequence;
+        bbo_slot_->bbo.store(bbo_);
+    }
+    return change_;
 }
 
 void OrderBook::shutdown() {
     shutdown_requested_ = true;
-    for (auto& [order_id, order] : order_lookup_) {
+    order_lookup_.for_each([this](OrderID, Order* order) {
         order->status = OrderStatus::CANCELLED;
         pool_.deallocate(order);
-    }
+    });
     order_lookup_.clear();
     bids_.clear();
     asks_.clear();
+    buy_stops_.clear();
+    sell_stops_.clear();
     LOG_INFO_SAFE("OrderBook {} shutdown complete", symbol_);
 }
 
@@ -0,0 +1,190 @@
+/**
+ * @file order_trace.cpp
+ * @brief Order lifecycle trace aggregation
+ */
+
+#include "rtes/order_trace.hpp"
+#include "rtes/logger.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <format>
+
+namespace rtes {
+
+namespace {
+
+constexpr auto   ORDER_TRACE_POLL        = std::chrono::milliseconds(1);
+constexpr size_t ORDER_TRACE_DRAIN_BATCH = 256;
+
+struct SpanBounds {
+    OrderStage from;
+    OrderStage to;
+};
+
+constexpr std::array<SpanBounds, ORDER_SPANS> SPAN_BOUNDS{{
+    {OrderStage::GATEWAY_RECV,   OrderStage::RISK_DEQUEUE},
+    {OrderStage::RISK_DEQUEUE,   OrderStage::RISK_APPROVE},
+    {OrderStage::RISK_APPROVE,   OrderStage::ENGINE_DEQUEUE},
+    {OrderStage::ENGINE_DEQUEUE, OrderStage::MATCHED},
+    {OrderStage::GATEWAY_RECV,   OrderStage::MATCHED},
+    {OrderStage::GATEWAY_RECV,   OrderStage::ACK_SENT},
+}};
+
+void append_hex_id(std::string& out, uint64_t id, size_t digits) {
+    out += '"';
+    out += std::format("{:0{}x}", id, digits);
+    out += '"';
+}
+
+} // namespace
+
+std::string spans_to_otlp_json(const TraceSpan* spans, size_t count, std::string_view service) {
+    std::string out;
+    out.reserve(160 + count * 220);
+    out += R"({"resourceSpans":[{"resource":{"attributes":[{"key":"service.name","value":{"stringValue":")";
+    out += service;
+    out += R"("}}]},"scopeSpans":[{"scope":{"name":"rtes.order_trace"},"spans":[)";
+    for (size_t i = 0; i < count; ++i) {
+        const TraceSpan& span = spans[i];
+        if (i) out += ',';
+        out += R"({"traceId":)";
+        append_hex_id(out, span.trace_id, 32);
+        out += R"(,"spanId":)";
+        append_hex_id(out, span.span_id, 16);
+        if (span.parent_span_id) {
+            out += R"(,"parentSpanId":)";
+            append_hex_id(out, span.parent_span_id, 16);
+        }
+        out += std::format(R"(,"name":"{}","kind":1,"startTimeUnixNano":"{}","endTimeUnixNano":"{}",)",
+                           span.name, span.start_unix_ns, span.end_unix_ns);
+        out += std::format(R"("attributes":[{{"key":"order.id","value":{{"intValue":"{}"}}}}]}})", span.order_id);
+    }
+    out += "]}]}]}";
+    return out;
+}
+
+const char* order_span_name(OrderSpan span) {
+    switch (span) {
+        case OrderSpan::GATEWAY_TO_RISK: return "gateway_to_risk";
+        case OrderSpan::RISK_CHECK:      return "risk_check";
+        case OrderSpan::RISK_TO_ENGINE:  return "risk_to_engine";
+        case OrderSpan::MATCH:           return "match";
+        case OrderSpan::RECV_TO_MATCHED: return "recv_to_matched";
+        case OrderSpan::RECV_TO_ACK:     return "recv_to_ack";
+    }
+    return "unknown";
+}
+
+OrderTracer::OrderTracer(const OrderPool& pool, uint32_t sample_every, size_t reactors)
+    : pool_(pool)
+    , sample_mask_(std::bit_ceil(std::max<uint64_t>(sample_every, 1)) - 1)
+    , region_(pool.initial_handles() * sizeof(OrderTrace))
+    , records_(static_cast<OrderTrace*>(region_.data()))
+    , records_count_(pool.initial_handles())
+    , reactors_(std::max<size_t>(reactors, 1))
+    , drain_buffer_(ORDER_TRACE_DRAIN_BATCH)
+    , base_ticks_(TscClock::now())
+    , base_unix_ns_(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count()))
+{
+    TscClock::calibrate();
+    for (size_t i = 0; i < reactors_; ++i) add_sink();
+}
+
+OrderTracer::~OrderTracer() {
+    stop();
+}
+
+OrderTraceSink* OrderTracer::add_sink() {
+    sinks_.push_back(std::make_unique<OrderTraceSink>(ORDER_TRACE_SINK_CAPACITY));
+    return sinks_.back().get();
+}
+
+void OrderTracer::start() {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return;
+    thread_ = std::thread(&OrderTracer::run, this);
+    LOG_INFO("Order tracing: 1 in {} orders, {} sinks", sample_every(), sinks_.size());
+}
+
+void OrderTracer::stop() {
+    bool expected = true;
+    if (!running_.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) return;
+    if (thread_.joinable()) thread_.join();
+    drain();  // What the producers left behind
+}
+
+void OrderTracer::run() {
+    while (running_.load(std::memory_order_relaxed)) {
+        if (drain() == 0) std::this_thread::sleep_for(ORDER_TRACE_POLL);
+    }
+}
+
+size_t OrderTracer::drain() {
+    size_t total = 0;
+    for (auto& sink : sinks_) {
+        size_t count;
+        while ((count = sink->try_pop_bulk(drain_buffer_.data(), drain_buffer_.size())) > 0) {
+            for (size_t i = 0; i < count; ++i) aggregate(drain_buffer_[i]);
+            total += count;
+        }
+    }
+    traces_.fetch_add(total, std::memory_order_relaxed);
+    if (!span_batch_.empty()) {
+        exporter_(span_batch_.data(), span_batch_.size());
+        exported_.fetch_add(span_batch_.size(), std::memory_order_relaxed);
+        span_batch_.clear();
+    }
+    return total;
+}
+
+void OrderTracer::aggregate(const OrderTrace& trace) {
+    for (size_t s = 0; s < ORDER_SPANS; ++s) {
+        const uint64_t from = trace.at(SPAN_BOUNDS[s].from);
+        const uint64_t to   = trace.at(SPAN_BOUNDS[s].to);
+        if (from == 0 || to == 0) continue;  // Stage not reached
+        spans_[s].record_ticks(to > from ? to - from : 0);
+    }
+    if (exporter_) [[unlikely]] add_spans(trace);
+}
+
+uint64_t OrderTracer::unix_ns(uint64_t ticks) const {
+    if (ticks >= base_ticks_) return base_unix_ns_ + TscClock::to_ns(ticks - base_ticks_);
+    return base_unix_ns_ - std::min(base_unix_ns_, TscClock::to_ns(base_ticks_ - ticks));
+}
+
+void OrderTracer::add_spans(const OrderTrace& trace) {
+    const uint64_t trace_id = trace_id_for(trace.order_id);
+    const uint64_t root_id  = span_id_for(trace_id, ORDER_SPAN_ROOT);
+    const uint64_t recv     = trace.at(OrderStage::GATEWAY_RECV);
+    const uint64_t matched  = trace.at(OrderStage::MATCHED);
+    if (matched) {
+        // The engine's record: the root spans what reached the engine (from the gateway if it passed one)
+        const uint64_t first = recv ? recv : trace.at(OrderStage::ENGINE_DEQUEUE);
+        if (first) {
+            span_batch_.push_back({trace_id, root_id, 0, unix_ns(first), unix_ns(matched),
+                                   trace.order_id, "order"});
+        }
+    }
+    for (size_t s = 0; s < ORDER_SPANS; ++s) {
+        if (s == static_cast<size_t>(OrderSpan::RECV_TO_MATCHED)) continue;  // = the root
+        const uint64_t from = trace.at(SPAN_BOUNDS[s].from);
+        const uint64_t to   = trace.at(SPAN_BOUNDS[s].to);
+        if (from == 0 || to == 0) continue;
+        span_batch_.push_back({trace_id, span_id_for(trace_id, s), root_id, unix_ns(from), unix_ns(std::max(from, to)),
+                               trace.order_id, order_span_name(static_cast<OrderSpan>(s))});
+    }
+}
+
+OrderTraceSnapshot OrderTracer::snapshot() const {
+    OrderTraceSnapshot snap;
+    snap.sample_every = sample_every();
+    snap.traces       = traces_.load(std::memory_order_relaxed);
+    snap.dropped      = dropped_.load(std::memory_order_relaxed);
+    for (size_t s = 0; s < ORDER_SPANS; ++s) snap.spans[s] = spans_[s].snapshot();
+    return snap;
+}
+
+} // namespace rtes
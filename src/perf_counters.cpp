@@ -0,0 +1,175 @@
+/**
+ * @file perf_counters.cpp
+ * @brief perf_event_open counters for the benchmarks
+ */
+
+#include "rtes/perf_counters.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace rtes {
+
+const char* perf_event_name(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::CYCLES:        return "cycles";
+        case PerfEvent::INSTRUCTIONS:  return "instructions";
+        case PerfEvent::L1D_MISSES:    return "l1d_misses";
+        case PerfEvent::LLC_MISSES:    return "llc_misses";
+        case PerfEvent::DTLB_MISSES:   return "dtlb_misses";
+        case PerfEvent::BRANCH_MISSES: return "branch_misses";
+    }
+    return "unknown";
+}
+
+bool PerfCounterSample::empty() const {
+    for (bool v : valid) {
+        if (v) return false;
+    }
+    return true;
+}
+
+double PerfCounterSample::per(uint64_t units, PerfEvent event) const {
+    if (units == 0 || !has(event)) return 0;
+    return static_cast<double>(value(event)) / static_cast<double>(units);
+}
+
+double PerfCounterSample::ipc() const {
+    if (!has(PerfEvent::CYCLES) || !has(PerfEvent::INSTRUCTIONS) || value(PerfEvent::CYCLES) == 0) return 0;
+    return static_cast<double>(value(PerfEvent::INSTRUCTIONS)) / static_cast<double>(value(PerfEvent::CYCLES));
+}
+
+PerfCounters::PerfCounters() {
+#if defined(__linux__)
+    open_thread(0);
+#else
+    error_ = "perf counters need Linux";
+#endif
+}
+
+PerfCounters::PerfCounters(pid_t pid) {
+#if defined(__linux__)
+    std::error_code ec;
+    std::filesystem::directory_iterator tasks("/proc/" + std::to_string(pid) + "/task", ec);
+    if (ec) {
+        error_ = "no such process " + std::to_string(pid);
+        return;
+    }
+    for (const auto& task : tasks) {
+        open_thread(static_cast<pid_t>(std::stol(task.path().filename().string())));
+    }
+#else
+    (void)pid;
+    error_ = "perf counters need Linux";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+    for (const Counter& counter : fds_) ::close(counter.fd);
+#endif
+}
+
+#if defined(__linux__)
+
+namespace {
+
+constexpr uint64_t cache_event(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+
+perf_event_attr event_attr(PerfEvent event) {
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    switch (event) {
+        case PerfEvent::CYCLES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PerfEvent::INSTRUCTIONS:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PerfEvent::L1D_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                      PERF_COUNT_HW_CACHE_RESULT_MISS);
+            break;
+        case PerfEvent::LLC_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case PerfEvent::DTLB_MISSES:
+            attr.type = PERF_TYPE_HW_CACHE;
+            attr.config = cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                      PERF_COUNT_HW_CACHE_RESULT_MISS);
+            break;
+        case PerfEvent::BRANCH_MISSES:
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+    }
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return attr;
+}
+
+} // namespace
+
+void PerfCounters::open_thread(pid_t tid) {
+    for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        const auto event = static_cast<PerfEvent>(i);
+        perf_event_attr attr = event_attr(event);
+        const int fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0));
+        if (fd < 0) {
+            if (error_.empty()) error_ = std::string(perf_event_name(event)) + ": " + std::strerror(errno);
+            continue;
+        }
+        fds_.push_back({fd, event});
+    }
+    if (!fds_.empty()) error_.clear();
+}
+
+void PerfCounters::start() {
+    for (const Counter& counter : fds_) {
+        ::ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+        ::ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+PerfCounterSample PerfCounters::stop() {
+    for (const Counter& counter : fds_) ::ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+
+    PerfCounterSample sample;
+    std::array<double, PERF_EVENT_COUNT> totals{};
+    for (const Counter& counter : fds_) {
+        uint64_t data[3] = {};  // value, time_enabled, time_running
+        if (::read(counter.fd, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) continue;
+        const auto index = static_cast<size_t>(counter.event);
+        totals[index] += static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        sample.valid[index] = true;
+        if (data[2] < data[1]) sample.multiplexed = true;
+    }
+    for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) sample.values[i] = static_cast<uint64_t>(totals[i]);
+    return sample;
+}
+
+#else
+
+void PerfCounters::open_thread(pid_t) {}
+void PerfCounters::start() {}
+PerfCounterSample PerfCounters::stop() { return {}; }
+
+#endif
+
+} // namespace rtes
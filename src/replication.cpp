@@ -0,0 +1,513 @@
+/**
+ * @file replication.cpp
+ * @brief Primary → standby replication of journaled requests
+ */
+
+#include "rtes/replication.hpp"
+#include "rtes/logger.hpp"
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#ifndef RTES_NO_OPENSSL
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+#endif
+
+#ifdef __APPLE__
+    #ifndef MSG_NOSIGNAL
+        #define MSG_NOSIGNAL 0
+    #endif
+#endif
+
+namespace rtes {
+
+namespace {
+
+constexpr auto REPLICATION_HEARTBEAT  = std::chrono::milliseconds(100);  // Idle primary → one empty frame
+constexpr auto REPLICATION_CLOSE_WAIT = std::chrono::seconds(1);         // Final send at shutdown
+constexpr int  REPLICATION_POLL_MS    = 10;
+constexpr int  REPLICATION_SOCKET_BUFFER = 4 << 20;
+constexpr auto REPLICATION_HELLO_TIMEOUT = std::chrono::seconds(2);  // Challenge → authenticated hello
+constexpr size_t REPLICATION_CHUNK_RECORDS = 1024;                   // Standby receive slice
+
+bool is_request(JournalRecordType type) {
+    return type >= JournalRecordType::NEW_ORDER && type <= JournalRecordType::MASS_CANCEL;
+}
+
+void require_secret(const std::string& secret) {
+#ifdef RTES_NO_OPENSSL
+    (void)secret;
+    throw std::invalid_argument("Replication needs OpenSSL to authenticate the primary");
+#else
+    if (secret.empty()) throw std::invalid_argument("Replication needs a shared secret (replication_secret)");
+#endif
+}
+
+/** HMAC-SHA256(secret, challenge ‖ hello) */
+bool hello_mac(const std::string& secret, const uint8_t* challenge, const JournalFileHeader& hello,
+               uint8_t* out) {
+#ifndef RTES_NO_OPENSSL
+    uint8_t message[REPLICATION_CHALLENGE_BYTES + sizeof(JournalFileHeader)];
+    std::memcpy(message, challenge, REPLICATION_CHALLENGE_BYTES);
+    std::memcpy(message + REPLICATION_CHALLENGE_BYTES, &hello, sizeof(hello));
+    unsigned int written = 0;
+    return HMAC(EVP_sha256(), secret.data(), static_cast<int>(secret.size()), message, sizeof(message),
+                out, &written) != nullptr &&
+           written == REPLICATION_MAC_BYTES;
+#else
+    (void)secret; (void)challenge; (void)hello; (void)out;
+    return false;
+#endif
+}
+
+bool random_challenge(uint8_t* out) {
+#ifndef RTES_NO_OPENSSL
+    return RAND_bytes(out, static_cast<int>(REPLICATION_CHALLENGE_BYTES)) == 1;
+#else
+    (void)out;
+    return false;
+#endif
+}
+
+bool same_mac(const uint8_t* a, const uint8_t* b) {
+#ifndef RTES_NO_OPENSSL
+    return CRYPTO_memcmp(a, b, REPLICATION_MAC_BYTES) == 0;
+#else
+    (void)a; (void)b;
+    return false;
+#endif
+}
+
+} // namespace
+
+ReplicationMode parse_replication_mode(const std::string& name) {
+    return name == "sync" ? ReplicationMode::SYNC : ReplicationMode::ASYNC;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Primary
+// ═══════════════════════════════════════════════════════════════
+
+ReplicationPrimary::ReplicationPrimary(std::string peer, std::string secret, ReplicationMode mode,
+                                       size_t max_backlog_bytes)
+    : peer_(std::move(peer))
+    , secret_(std::move(secret))
+    , mode_(mode)
+    , max_backlog_(std::max<size_t>(max_backlog_bytes, 1 << 20))
+    , acked_(std::make_unique<std::atomic<uint64_t>[]>(JOURNAL_MAX_ENGINES))
+{
+    require_secret(secret_);
+    out_.reserve(1 << 20);
+}
+
+ReplicationPrimary::~ReplicationPrimary() = default;
+
+void ReplicationPrimary::add_engine(MatchingEngine* engine) {
+    engines_.push_back(engine);
+}
+
+bool ReplicationPrimary::connect(const JournalFileHeader& header) {
+    engine_count_ = std::min<size_t>(header.engine_count, JOURNAL_MAX_ENGINES);
+
+    const size_t colon = peer_.rfind(':');
+    addrinfo hints{};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* found = nullptr;
+    if (colon == std::string::npos ||
+        getaddrinfo(peer_.substr(0, colon).c_str(), peer_.substr(colon + 1).c_str(), &hints, &found) != 0) {
+        lose("cannot resolve the standby");
+        return false;
+    }
+    for (addrinfo* a = found; a && !fd_.valid(); a = a->ai_next) {
+        FileDescriptor fd(::socket(a->ai_family, a->ai_socktype | SOCK_CLOEXEC, a->ai_protocol));
+        if (fd.valid() && ::connect(fd.get(), a->ai_addr, a->ai_addrlen) == 0) fd_ = std::move(fd);
+    }
+    freeaddrinfo(found);
+    if (!fd_.valid()) {
+        lose("cannot connect to the standby");
+        return false;
+    }
+    int one = 1;
+    int buffer = REPLICATION_SOCKET_BUFFER;
+    setsockopt(fd_.get(), IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setsockopt(fd_.get(), SOL_SOCKET, SO_SNDBUF, &buffer, sizeof(buffer));
+
+    // The standby speaks first: answer its challenge with the hello's MAC
+    uint8_t challenge[REPLICATION_CHALLENGE_BYTES];
+    size_t received = 0;
+    const auto deadline = std::chrono::steady_clock::now() + REPLICATION_HELLO_TIMEOUT;
+    while (received < sizeof(challenge) && std::chrono::steady_clock::now() < deadline) {
+        pollfd pfd{fd_.get(), POLLIN, 0};
+        if (::poll(&pfd, 1, REPLICATION_POLL_MS) <= 0) continue;
+        const ssize_t n = ::recv(fd_.get(), challenge + received, sizeof(challenge) - received, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        received += static_cast<size_t>(n);
+    }
+    uint8_t mac[REPLICATION_MAC_BYTES];
+    if (received < sizeof(challenge) || !hello_mac(secret_, challenge, header, mac)) {
+        lose("no challenge from the standby");
+        return false;
+    }
+    fcntl(fd_.get(), F_SETFL, fcntl(fd_.get(), F_GETFL, 0) | O_NONBLOCK);
+
+    out_.resize(sizeof(header) + sizeof(mac));
+    std::memcpy(out_.data(), &header, sizeof(header));
+    std::memcpy(out_.data() + sizeof(header), mac, sizeof(mac));
+    begin_frame();
+    last_frame_ = std::chrono::steady_clock::now();
+    connected_.store(true, std::memory_order_relaxed);
+    LOG_INFO("Replicating to standby {} ({})", peer_,
+             mode_ == ReplicationMode::SYNC ? "sync: reports wait for its ack" : "async");
+    if (!send_pending()) lose("send failed");
+    return connected();
+}
+
+void ReplicationPrimary::append(const JournalRecord* records, size_t count) {
+    if (!connected_.load(std::memory_order_relaxed)) return;
+    for (size_t i = 0; i < count; ++i) {
+        if (!is_request(records[i].type)) continue;  // The standby reproduces the outputs
+        if (frame_count_ == REPLICATION_MAX_FRAME_RECORDS) end_frame();  // The standby's bound
+        const size_t at = out_.size();
+        out_.resize(at + sizeof(JournalRecord));
+        std::memcpy(out_.data() + at, &records[i], sizeof(JournalRecord));
+        ++frame_count_;
+    }
+}
+
+void ReplicationPrimary::flush() {
+    if (!connected_.load(std::memory_order_relaxed)) return;
+    if (frame_count_ > 0 || std::chrono::steady_clock::now() - last_frame_ >= REPLICATION_HEARTBEAT) {
+        end_frame();
+    }
+    if (!send_pending()) return lose("send failed");
+    if (!read_acks()) return lose("the standby closed the connection");
+
+    const size_t backlog = frame_start_ - out_sent_;
+    backlog_.store(backlog, std::memory_order_relaxed);
+    if (backlog > max_backlog_) lose("the standby is not keeping up");
+}
+
+void ReplicationPrimary::close() {
+    if (!connected_.load(std::memory_order_relaxed)) return;
+    if (frame_count_ > 0) end_frame();
+    const auto deadline = std::chrono::steady_clock::now() + REPLICATION_CLOSE_WAIT;
+    while (out_sent_ < frame_start_ && std::chrono::steady_clock::now() < deadline) {
+        pollfd pfd{fd_.get(), POLLOUT, 0};
+        ::poll(&pfd, 1, REPLICATION_POLL_MS);
+        if (!send_pending()) break;
+    }
+    if (out_sent_ < frame_start_) {
+        LOG_WARN("Replication to {}: {} bytes not sent at shutdown", peer_, frame_start_ - out_sent_);
+    }
+    connected_.store(false, std::memory_order_relaxed);
+    fd_.close();
+}
+
+void ReplicationPrimary::begin_frame() {
+    frame_start_ = out_.size();
+    out_.resize(frame_start_ + sizeof(ReplicationFrame));
+    frame_count_ = 0;
+}
+
+void ReplicationPrimary::end_frame() {
+    const ReplicationFrame frame{REPLICATION_MAGIC, frame_count_};
+    std::memcpy(out_.data() + frame_start_, &frame, sizeof(frame));
+    frames_.fetch_add(1, std::memory_order_relaxed);
+    records_.fetch_add(frame_count_, std::memory_order_relaxed);
+    last_frame_ = std::chrono::steady_clock::now();
+    begin_frame();
+}
+
+bool ReplicationPrimary::send_pending() {
+    // Complete frames only: [out_sent_, frame_start_); the open frame follows
+    while (out_sent_ < frame_start_) {
+        const ssize_t n = ::send(fd_.get(), out_.data() + out_sent_, frame_start_ - out_sent_,
+                                 MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n <= 0) return false;
+        out_sent_ += static_cast<size_t>(n);
+        bytes_.fetch_add(static_cast<uint64_t>(n), std::memory_order_relaxed);
+    }
+    // Slide the unsent bytes down once they are the smaller part
+    if (out_sent_ > 0 && (out_sent_ == frame_start_ || out_sent_ > out_.size() / 2)) {
+        out_.erase(out_.begin(), out_.begin() + static_cast<std::ptrdiff_t>(out_sent_));
+        frame_start_ -= out_sent_;
+        out_sent_ = 0;
+    }
+    return true;
+}
+
+bool ReplicationPrimary::read_acks() {
+    std::byte buffer[4096];
+    while (true) {
+        const ssize_t n = ::recv(fd_.get(), buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+        if (n <= 0) return false;
+        in_.insert(in_.end(), buffer, buffer + n);
+    }
+    while (in_.size() >= sizeof(ReplicationFrame)) {
+        ReplicationFrame frame;
+        std::memcpy(&frame, in_.data(), sizeof(frame));
+        if (frame.magic != REPLICATION_MAGIC) return false;
+        const size_t size = sizeof(frame) + frame.count * sizeof(uint64_t);
+        if (in_.size() < size) break;
+        for (size_t e = 0; e < std::min<size_t>(frame.count, engine_count_); ++e) {
+            uint64_t seq;
+            std::memcpy(&seq, in_.data() + sizeof(frame) + e * sizeof(seq), sizeof(seq));
+            if (seq <= acked_[e].load(std::memory_order_relaxed)) continue;
+            acked_[e].store(seq, std::memory_order_release);
+            if (mode_ == ReplicationMode::SYNC && e < engines_.size()) engines_[e]->wake();
+        }
+        in_.erase(in_.begin(), in_.begin() + static_cast<std::ptrdiff_t>(size));
+    }
+    return true;
+}
+
+void ReplicationPrimary::lose(const char* why) {
+    LOG_ERROR("Replication to standby {} lost ({}): trading continues unprotected", peer_, why);
+    connected_.store(false, std::memory_order_relaxed);
+    fd_.close();
+    out_.clear();
+    in_.clear();
+    out_sent_ = frame_start_ = 0;
+    frame_count_ = 0;
+    backlog_.store(0, std::memory_order_relaxed);
+    for (size_t e = 0; e < JOURNAL_MAX_ENGINES; ++e) {
+        acked_[e].store(std::numeric_limits<uint64_t>::max(), std::memory_order_release);
+    }
+    for (MatchingEngine* engine : engines_) engine->wake();  // Release what SYNC held
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Standby
+// ═══════════════════════════════════════════════════════════════
+
+ReplicationStandby::ReplicationStandby(std::string bind_address, uint16_t port, std::string secret,
+                                       std::vector<MatchingEngine*> engines,
+                                       std::vector<JournalLane*> lanes,
+                                       std::chrono::milliseconds promote_after)
+    : bind_address_(std::move(bind_address))
+    , port_(port)
+    , secret_(std::move(secret))
+    , engines_(std::move(engines))
+    , lanes_(std::move(lanes))
+    , promote_after_(promote_after)
+    , pending_(engines_.size())
+    , chunk_(REPLICATION_CHUNK_RECORDS)
+    , applied_(engines_.size(), 0)
+{
+    require_secret(secret_);
+    lanes_.resize(engines_.size(), nullptr);
+}
+
+ReplicationStandby::~ReplicationStandby() {
+    promote();
+}
+
+void ReplicationStandby::start() {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return;
+
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd >= 0) {
+        listen_fd_.reset(fd);
+        int opt = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port   = htons(port_);
+        if (inet_pton(AF_INET, bind_address_.c_str(), &addr.sin_addr) != 1 ||
+            bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 1) < 0) {
+            fd = -1;
+        }
+    }
+    if (fd < 0) {
+        running_.store(false);
+        listen_fd_.close();
+        throw std::runtime_error("Failed to listen for the replication primary on " + bind_address_ + ":" +
+                                 std::to_string(port_));
+    }
+    thread_ = std::thread(&ReplicationStandby::run, this);
+    LOG_INFO("Standby: waiting for the primary on {}:{} ({} engines)", bind_address_, port_, engines_.size());
+}
+
+void ReplicationStandby::promote() {
+    promotion_due_.store(true, std::memory_order_release);
+    running_.store(false, std::memory_order_release);
+    if (!thread_.joinable()) return;
+    thread_.join();
+    fd_.close();
+    listen_fd_.close();
+    connected_.store(false, std::memory_order_relaxed);
+    LOG_INFO("Standby promoted: {} requests applied in {} frames", requests_applied(), frames_applied());
+}
+
+void ReplicationStandby::run() {
+    bool served = false;  // A primary came and went: no other may follow (no catch-up)
+    auto last_heard = std::chrono::steady_clock::now();
+    while (running_.load(std::memory_order_relaxed)) {
+        if (served) {
+            // Gone: promote on our own once it has been silent long enough
+            if (promote_after_.count() > 0 && std::chrono::steady_clock::now() - last_heard >= promote_after_) {
+                LOG_WARN("Standby: primary silent for {} ms, promoting", promote_after_.count());
+                promotion_due_.store(true, std::memory_order_release);
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(REPLICATION_POLL_MS));
+            continue;
+        }
+        if (!accept_primary()) continue;
+        if (!authenticate_primary()) {
+            refused_.fetch_add(1, std::memory_order_relaxed);
+            fd_.close();
+            continue;
+        }
+        served = true;
+        connected_.store(true, std::memory_order_relaxed);
+        LOG_INFO("Standby: primary connected, applying its requests");
+
+        ReplicationFrame frame;
+        while (read_exact(&frame, sizeof(frame)) && frame.magic == REPLICATION_MAGIC && apply_frame(frame.count)) {}
+        for (auto& pending : pending_) pending.clear();  // A refused frame is not applied in part
+        last_heard = std::chrono::steady_clock::now();
+        connected_.store(false, std::memory_order_relaxed);
+        fd_.close();
+        if (promotion_due_.load(std::memory_order_acquire)) return;
+        LOG_WARN("Standby: primary disconnected after {} requests", requests_applied());
+    }
+}
+
+bool ReplicationStandby::accept_primary() {
+    pollfd pfd{listen_fd_.get(), POLLIN, 0};
+    if (::poll(&pfd, 1, REPLICATION_POLL_MS) <= 0) return false;
+    const int fd = ::accept4(listen_fd_.get(), nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) return false;
+    fd_.reset(fd);
+    int one = 1;
+    int buffer = REPLICATION_SOCKET_BUFFER;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+    return true;
+}
+
+bool ReplicationStandby::authenticate_primary() {
+    uint8_t challenge[REPLICATION_CHALLENGE_BYTES];
+    if (!random_challenge(challenge) ||
+        ::send(fd_.get(), challenge, sizeof(challenge), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(challenge))) {
+        return false;
+    }
+    JournalFileHeader hello;
+    uint8_t mac[REPLICATION_MAC_BYTES];
+    uint8_t expected[REPLICATION_MAC_BYTES];
+    const auto deadline = std::chrono::steady_clock::now() + REPLICATION_HELLO_TIMEOUT;
+    if (!read_exact(&hello, sizeof(hello), deadline) || !read_exact(mac, sizeof(mac), deadline)) {
+        LOG_WARN("Standby: a peer connected but sent no hello, refused");
+        return false;
+    }
+    if (!hello_mac(secret_, challenge, hello, expected) || !same_mac(mac, expected)) {
+        LOG_ERROR("Standby: a peer failed the replication secret check, refused");
+        return false;
+    }
+    bool matches = std::memcmp(hello.magic, JOURNAL_MAGIC, sizeof(hello.magic)) == 0 &&
+                   hello.engine_count == engines_.size();
+    for (size_t e = 0; matches && e < engines_.size(); ++e) {
+        matches = engines_[e]->name() == std::string(hello.engine_names[e],
+                                                      strnlen(hello.engine_names[e], sizeof(hello.engine_names[e])));
+    }
+    if (!matches) LOG_ERROR("Standby: the primary's engines do not match this configuration, refused");
+    return matches;
+}
+
+bool ReplicationStandby::read_exact(void* data, size_t size, std::chrono::steady_clock::time_point deadline) {
+    auto* bytes = static_cast<std::byte*>(data);
+    auto last_heard = std::chrono::steady_clock::now();
+    while (size > 0) {
+        if (!running_.load(std::memory_order_relaxed)) return false;
+        if (std::chrono::steady_clock::now() >= deadline) return false;
+        pollfd pfd{fd_.get(), POLLIN, 0};
+        if (::poll(&pfd, 1, REPLICATION_POLL_MS) == 0) {
+            // Heartbeats arrive every REPLICATION_HEARTBEAT: this is silence
+            if (promote_after_.count() > 0 && std::chrono::steady_clock::now() - last_heard >= promote_after_) {
+                LOG_WARN("Standby: primary silent for {} ms, promoting", promote_after_.count());
+                promotion_due_.store(true, std::memory_order_release);
+                return false;
+            }
+            continue;
+        }
+        const ssize_t n = ::recv(fd_.get(), bytes, size, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        bytes += n;
+        size  -= static_cast<size_t>(n);
+        last_heard = std::chrono::steady_clock::now();
+    }
+    return true;
+}
+
+bool ReplicationStandby::apply_frame(uint32_t count) {
+    if (count == 0) return true;  // Heartbeat
+    if (count > REPLICATION_MAX_FRAME_RECORDS) {
+        LOG_ERROR("Standby: frame of {} records from the primary (limit {}), disconnecting",
+                  count, REPLICATION_MAX_FRAME_RECORDS);
+        refused_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    // In bounded slices: memory follows the bytes received, not the header's claim
+    for (uint32_t done = 0; done < count;) {
+        const size_t slice = std::min<size_t>(count - done, chunk_.size());
+        if (!read_exact(chunk_.data(), slice * sizeof(JournalRecord))) return false;
+        for (size_t i = 0; i < slice; ++i) {
+            const JournalRecord& record = chunk_[i];
+            if (record.engine >= engines_.size() || !is_request(record.type)) {
+                LOG_ERROR("Standby: record for engine {} of type {} from the primary, disconnecting",
+                          record.engine, static_cast<int>(record.type));
+                refused_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            pending_[record.engine].push_back(record);
+        }
+        done += static_cast<uint32_t>(slice);
+    }
+    for (size_t e = 0; e < engines_.size(); ++e) {
+        if (pending_[e].empty()) continue;
+        engines_[e]->replay(pending_[e], lanes_[e]);
+        applied_[e] = pending_[e].back().seq;
+        pending_[e].clear();
+    }
+    frames_.fetch_add(1, std::memory_order_relaxed);
+    requests_.fetch_add(count, std::memory_order_relaxed);
+
+    // Ack: per engine, the last primary sequence now in our books
+    std::vector<std::byte> ack(sizeof(ReplicationFrame) + applied_.size() * sizeof(uint64_t));
+    const ReplicationFrame header{REPLICATION_MAGIC, static_cast<uint32_t>(applied_.size())};
+    std::memcpy(ack.data(), &header, sizeof(header));
+    std::memcpy(ack.data() + sizeof(header), applied_.data(), applied_.size() * sizeof(uint64_t));
+    size_t sent = 0;
+    while (sent < ack.size()) {
+        const ssize_t n = ::send(fd_.get(), ack.data() + sent, ack.size() - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace rtes
@@ -0,0 +1,241 @@
+#include "rtes/retransmission.hpp"
+#include "rtes/logger.hpp"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+namespace rtes {
+
+inline constexpr int    RETRANSMIT_POLL_MS     = 1;  // Recovery path: ms latency is fine
+inline constexpr size_t RETRANSMIT_DRAIN_BATCH = 64;
+
+RetransmissionServer::RetransmissionServer(std::string bind_address, uint16_t port, size_t publishers,
+                                           size_t channels, size_t history)
+    : bind_address_(std::move(bind_address))
+    , port_(port)
+    , drain_buffer_(RETRANSMIT_DRAIN_BATCH)
+    , histories_(std::max<size_t>(channels, 1))
+    , slots_(std::bit_ceil(std::max<size_t>(history, 1)))
+    , mask_(slots_ - 1)
+    , sources_(RETRANSMIT_SOURCE_BUCKETS)
+{
+    publishers = std::max<size_t>(publishers, 1);
+    for (size_t i = 0; i < publishers; ++i) {
+        queues_.push_back(std::make_unique<SPSCQueue<RetransmitRecord>>(RETRANSMIT_QUEUE_CAPACITY));
+    }
+    for (auto& h : histories_) {
+        h.arena.resize(slots_ * MD_MAX_DATAGRAM);
+        h.first_sequence.resize(slots_);
+        h.message_count.resize(slots_);
+        h.length.resize(slots_);
+    }
+}
+
+RetransmissionServer::~RetransmissionServer() {
+    stop();
+}
+
+void RetransmissionServer::start() {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return;
+
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd >= 0) {
+        socket_fd_.reset(fd);
+        int opt = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port   = htons(port_);
+        if (inet_pton(AF_INET, bind_address_.c_str(), &addr.sin_addr) != 1 ||
+            bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            fd = -1;
+        }
+    }
+    if (fd < 0) {
+        running_.store(false);
+        socket_fd_.close();
+        throw std::runtime_error("Failed to start retransmission server on " + bind_address_ + ":" +
+                                 std::to_string(port_));
+    }
+
+    thread_ = std::thread(&RetransmissionServer::run, this);
+    LOG_INFO("Market data retransmission on {}:{} ({} datagrams per channel)", bind_address_, port_, slots_);
+}
+
+void RetransmissionServer::stop() {
+    bool expected = true;
+    if (!running_.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) return;
+    if (thread_.joinable()) thread_.join();
+    socket_fd_.close();
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Server Thread
+// ═══════════════════════════════════════════════════════════════
+
+void RetransmissionServer::run() {
+    while (running_.load(std::memory_order_relaxed)) {
+        const bool busy = drain_publishers();
+
+        pollfd pfd{socket_fd_.get(), POLLIN, 0};
+        if (poll(&pfd, 1, busy ? 0 : RETRANSMIT_POLL_MS) < 0 && errno != EINTR) break;
+        if (pfd.revents & POLLIN) read_requests();
+    }
+}
+
+/** @return true if anything was kept (poll without waiting) */
+bool RetransmissionServer::drain_publishers() {
+    bool any = false;
+    for (auto& queue : queues_) {
+        size_t count;
+        do {
+            count = queue->try_pop_bulk(drain_buffer_.data(), drain_buffer_.size());
+            for (size_t i = 0; i < count; ++i) keep(drain_buffer_[i]);
+            any |= count > 0;
+        } while (count == drain_buffer_.size());
+    }
+    return any;
+}
+
+void RetransmissionServer::keep(const RetransmitRecord& record) {
+    if (record.channel >= histories_.size() || record.length < sizeof(UdpPacketHeader) ||
+        record.length > MD_MAX_DATAGRAM) [[unlikely]] {
+        return;
+    }
+    UdpPacketHeader packet;
+    std::memcpy(&packet, record.data, sizeof(packet));
+
+    History& h = histories_[record.channel];
+    const size_t slot = h.head & mask_;
+    std::memcpy(h.arena.data() + slot * MD_MAX_DATAGRAM, record.data, record.length);
+    h.first_sequence[slot] = packet.sequence;
+    h.message_count[slot]  = packet.message_count;
+    h.length[slot]         = record.length;
+    ++h.head;
+    packets_kept_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void RetransmissionServer::read_requests() {
+    for (;;) {
+        // Up to a full datagram: the padding buys the sender a larger reply
+        alignas(RetransmitRequest) uint8_t buffer[MD_MAX_DATAGRAM];
+        sockaddr_in from{};
+        socklen_t from_len = sizeof(from);
+        const ssize_t n = recvfrom(socket_fd_.get(), buffer, sizeof(buffer), MSG_DONTWAIT,
+                                   reinterpret_cast<sockaddr*>(&from), &from_len);
+        if (n < 0) return;
+        RetransmitRequest request;
+        if (n >= static_cast<ssize_t>(sizeof(request))) {
+            std::memcpy(&request, buffer, sizeof(request));
+        } else {
+            request.header.type = 0;  // Answered INVALID
+        }
+        handle_request(request, static_cast<size_t>(n), from);
+    }
+}
+
+/** The source's budget, refilled for the time since it last asked */
+RetransmissionServer::SourceBudget& RetransmissionServer::budget_for(const sockaddr_in& from, uint64_t now_ns) {
+    const uint32_t address = from.sin_addr.s_addr * 0x9E3779B1u;  // Fibonacci hash of the IPv4 address
+    SourceBudget& budget = sources_[address >> (32 - std::countr_zero(RETRANSMIT_SOURCE_BUCKETS))];
+    const uint64_t elapsed = now_ns - budget.refilled_ns;
+    budget.bytes = elapsed >= 1'000'000'000 ? RETRANSMIT_SOURCE_RATE
+                 : std::min(RETRANSMIT_SOURCE_RATE, budget.bytes + elapsed * RETRANSMIT_SOURCE_RATE / 1'000'000'000);
+    budget.refilled_ns = now_ns;
+    return budget;
+}
+
+/**
+ * Reply with a RetransmitResponse, then the kept datagrams from the one
+ * holding from_sequence up to the one holding its last wanted message
+ * (at most RETRANSMIT_MAX_PACKETS, and no more bytes than the request
+ * earns or its source has left). A range older than the history starts
+ * at the oldest datagram kept and is answered PARTIAL.
+ */
+void RetransmissionServer::handle_request(const RetransmitRequest& request, size_t request_bytes,
+                                          const sockaddr_in& from) {
+    requests_.fetch_add(1, std::memory_order_relaxed);
+
+    SourceBudget& source = budget_for(from, now_timestamp());
+    const uint64_t budget = std::min<uint64_t>(source.bytes, request_bytes * RETRANSMIT_AMPLIFICATION);
+    if (budget < sizeof(RetransmitResponse)) {
+        requests_throttled_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    uint64_t reply_bytes = sizeof(RetransmitResponse);
+
+    RetransmitResponse response;
+    response.header  = UdpMessageHeader(RETRANSMIT_RESPONSE, sizeof(RetransmitResponse),
+                                        request.header.sequence, now_timestamp());
+    response.channel = request.channel;
+
+    const History* h = nullptr;
+    uint64_t first = 0, last = 0;  // Packets to replay: [first, last)
+    if (request.header.type != RETRANSMIT_REQUEST || request.count == 0 ||
+        request.from_sequence == 0 || request.channel >= histories_.size()) {
+        response.status = RETRANSMIT_INVALID;
+    } else {
+        h = &histories_[request.channel];
+        const uint64_t lo = oldest(*h);
+        if (lo < h->head) response.oldest_sequence = h->first_sequence[lo & mask_];
+
+        // First packet whose last message is at or after from_sequence
+        first = lo;
+        uint64_t right = h->head;
+        while (first < right) {
+            const uint64_t mid  = first + (right - first) / 2;
+            const size_t   slot = mid & mask_;
+            if (h->first_sequence[slot] + h->message_count[slot] <= request.from_sequence) {
+                first = mid + 1;
+            } else {
+                right = mid;
+            }
+        }
+        const uint64_t end = request.from_sequence + request.count;
+        last = first;
+        while (last < h->head && last - first < RETRANSMIT_MAX_PACKETS &&
+               h->first_sequence[last & mask_] < end &&
+               reply_bytes + h->length[last & mask_] <= budget) {
+            reply_bytes += h->length[last & mask_];
+            ++last;
+        }
+
+        if (last == first) {
+            const bool kept = first < h->head && h->first_sequence[first & mask_] < end &&
+                              last - first < RETRANSMIT_MAX_PACKETS;
+            response.status = kept ? RETRANSMIT_PAD_REQUEST : RETRANSMIT_UNAVAILABLE;
+        } else {
+            const size_t tail = (last - 1) & mask_;
+            response.first_sequence = h->first_sequence[first & mask_];
+            response.last_sequence  = h->first_sequence[tail] + h->message_count[tail] - 1;
+            response.packet_count   = static_cast<uint16_t>(last - first);
+            response.status = response.first_sequence > request.from_sequence ? RETRANSMIT_PARTIAL
+                                                                              : RETRANSMIT_OK;
+        }
+    }
+    if (response.status != RETRANSMIT_OK && response.status != RETRANSMIT_PARTIAL) {
+        requests_unfilled_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    const auto* to = reinterpret_cast<const sockaddr*>(&from);
+    sendto(socket_fd_.get(), &response, sizeof(response), 0, to, sizeof(from));
+    for (uint64_t p = first; p < last; ++p) {
+        const size_t slot = p & mask_;
+        sendto(socket_fd_.get(), h->arena.data() + slot * MD_MAX_DATAGRAM, h->length[slot], 0,
+               to, sizeof(from));
+    }
+    packets_replayed_.fetch_add(last - first, std::memory_order_relaxed);
+    source.bytes -= reply_bytes;
+}
+
+} // namespace rtes
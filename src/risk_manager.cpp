@@ -9,29 +9,30 @@
  * Optimizations:
  *   - No heap allocation in validation path
  *   - Integer-only notional calculation (no floating point)
- *   - Direct symbol lookup via FixedString key (no std::string)
+ *   - Dense symbol slots: gateway-stamped InstrumentID → array index,
+ *     flat engine routes (hash only for unstamped orders)
  *   - Targeted cancel routing (not broadcast)
  *   - Batch drain + spin-pause-yield (no sleep)
  *   - Local stats counters (flushed periodically)
- *   - Flat hash set for active orders (no tree allocation)
+ *   - Flat open-addressing order index (no node allocation)
+ *   - Flat client table indexed by the dense directory id (no string hash)
  *
  * Threading model:
- *   Single dedicated thread. Consumes from SPSC queue (gateway → risk).
- *   Forwards approved orders to per-symbol matching engine SPSC queues.
+ *   One dedicated thread per shard. A shard owns a disjoint set of
+ *   clients (risk_shard_for()), so client state is never shared.
+ *   Consumes from one SPSC lane per gateway thread (gateway → risk),
+ *   drained round-robin. Forwards approved orders to its own input lane
+ *   on each matching engine (engine_lane_).
  */
 
 #include "rtes/risk_manager.hpp"
 #include "rtes/logger.hpp"
 #include "rtes/security_utils.hpp"
+#include "rtes/undo_log.hpp"
 
 #include <cstring>
 #include <algorithm>
 
-#ifdef __x86_64__
-#include <immintrin.h>
-#include <sched.h>
-#endif
-
 namespace rtes {
 
 // ═══════════════════════════════════════════════════════════════
@@ -41,49 +42,87 @@ namespace rtes {
 /** Max orders to drain per batch cycle */
 inline constexpr size_t RISK_BATCH_SIZE = 128;
 
-/** Spin iterations before yield on empty queue */
+/** Spin checks before yield/park on empty queue */
 inline constexpr size_t RISK_SPIN_ITERS = 512;
 
-/** Pause instructions per spin iteration */
-inline constexpr size_t RISK_PAUSE_PER_SPIN = 4;
-
-/** Flush stats every N orders */
+/** Flush stats every N orders while busy (and whenever it goes idle) */
 inline constexpr size_t RISK_STATS_FLUSH = 4096;
 
-/** SPSC queue capacity */
+/**
+ * Requests staged per engine before a bulk push: a batch ends in one push
+ * per engine it touched, and the first order of a long batch waits for at
+ * most this many others
+ */
+inline constexpr size_t RISK_OUTBOUND_BATCH = 64;
+
+/** Max engine feedback events applied per ring per batch */
+inline constexpr size_t RISK_FEEDBACK_BATCH = 256;
+
+/** SPSC queue capacity (per ingress lane) */
 inline constexpr size_t RISK_QUEUE_CAPACITY = 65536;
 
-/** Rate limit window in nanoseconds (1 second) */
-inline constexpr uint64_t RATE_LIMIT_WINDOW_NS = 1'000'000'000ULL;
+/** Rate limit refill period: max_orders_per_second tokens per second */
+inline constexpr uint64_t RATE_LIMIT_PERIOD_NS = 1'000'000'000ULL;
 
 // ═══════════════════════════════════════════════════════════════
 //  Construction
 // ═══════════════════════════════════════════════════════════════
 
 RiskManager::RiskManager(const RiskConfig& config,
-                         const std::vector<SymbolConfig>& symbols)
+                         const std::vector<SymbolConfig>& symbols,
+                         size_t max_live_orders,
+                         size_t ingress_lanes)
     : config_(config)
-    , input_queue_(std::make_unique<SPSCQueue<RiskRequest>>(RISK_QUEUE_CAPACITY))
+    , order_index_(max_live_orders)
+    , drain_buffer_(RISK_BATCH_SIZE)
+    , feedback_buffer_(RISK_FEEDBACK_BATCH)
+    , idle_(IdlePolicy::SPIN_YIELD, RISK_SPIN_ITERS)
 {
+
+    ingress_lanes = std::clamp<size_t>(ingress_lanes, 1, UINT16_MAX);
+    for (size_t i = 0; i < ingress_lanes; ++i) {
+        auto lane = std::make_unique<InputLane>();
+        lane->queue = std::make_unique<SPSCQueue<RiskRequest>>(RISK_QUEUE_CAPACITY);
+        lanes_.push_back(std::move(lane));
+    }
+
     // Build symbol config lookup — keyed by FixedString, no std::string
     for (const auto& sym : symbols) {
         Symbol key(sym.symbol.c_str());
-        symbol_configs_[key] = sym;
+        auto [it, inserted] = symbol_index_.emplace(
+            key, static_cast<RiskSymbolIndex>(symbol_configs_.size()));
+        if (inserted) symbol_configs_.push_back(sym);
+        else symbol_configs_[it->second] = sym;
     }
 
+    routes_.assign(symbol_configs_.size(), EngineRoute{});
+    owned_states_ = std::make_unique<std::atomic<InstrumentState>[]>(symbol_configs_.size());
+    for (size_t i = 0; i < symbol_configs_.size(); ++i) symbol_states_.push_back(&owned_states_[i]);
+    owned_reference_prices_ = std::make_unique<ReferencePriceTable>(symbol_configs_);
+    set_reference_prices(owned_reference_prices_.get());
+
+    // Sizes the client and position tables (needs the symbol count)
+    owned_directory_ = std::make_unique<ClientDirectory>();
+    set_client_directory(owned_directory_.get());
+
     // Pre-compute integer notional limit (avoid float in hot path)
     // max_notional is in dollars, multiply by PRICE_SCALE for integer comparison
     max_notional_scaled_ = static_cast<uint64_t>(
         config.max_notional_per_client * PRICE_SCALE);
+    rate_limit_ = TokenBucketLimit(
+        config.max_orders_per_second, RATE_LIMIT_PERIOD_NS,
+        config.rate_limit_burst ? config.rate_limit_burst : config.max_orders_per_second);
 
-    LOG_INFO("Risk manager initialized with {} symbols, "
+    LOG_INFO("Risk manager initialized with {} symbols, {} ingress lanes, "
              "max_order_size={}, max_orders_per_sec={}",
-             symbols.size(), config.max_order_size,
+             symbols.size(), lanes_.size(), config.max_order_size,
              config.max_orders_per_second);
 }
 
 RiskManager::~RiskManager() {
     stop();
+    delete pending_limits_.exchange(nullptr, std::memory_order_acquire);
+    delete pending_routes_.exchange(nullptr, std::memory_order_acquire);
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -108,6 +147,7 @@ void RiskManager::stop() {
         return;
     }
 
+    idle_.notify();  // Unpark the worker so it sees running_ == false
     if (worker_thread_.joinable()) {
         worker_thread_.join();
     }
@@ -119,42 +159,230 @@ void RiskManager::stop() {
              stats_atomic_.approved.load(std::memory_order_relaxed));
 }
 
+// ═══════════════════════════════════════════════════════════════
+//  Limit Reload (any thread → worker at a batch boundary)
+// ═══════════════════════════════════════════════════════════════
+
+uint64_t RiskManager::update_limits(const RiskConfig& config, const std::vector<SymbolConfig>& symbols) {
+    // Everything derived here, off the worker: it only swaps values in
+    std::lock_guard lock(limits_publish_mutex_);
+    auto limits = std::make_unique<PendingLimits>(PendingLimits{
+        config,
+        static_cast<uint64_t>(config.max_notional_per_client * PRICE_SCALE),
+        TokenBucketLimit(config.max_orders_per_second, RATE_LIMIT_PERIOD_NS,
+                         config.rate_limit_burst ? config.rate_limit_burst : config.max_orders_per_second),
+        std::vector<double>(symbol_configs_.size(), -1.0),
+        next_limits_generation_++,
+    });
+    for (const auto& sym : symbols) {
+        auto it = symbol_index_.find(Symbol(sym.symbol.c_str()));  // Built at construction, read-only since
+        if (it == symbol_index_.end()) {
+            LOG_WARN("Risk limits: {} has no book here, ignored", sym.symbol);
+            continue;
+        }
+        limits->collar_pct[it->second] = sym.price_collar_pct;
+    }
+    const uint64_t generation = limits->generation;
+    delete pending_limits_.exchange(limits.release(), std::memory_order_acq_rel);
+    idle_.notify();
+    return generation;
+}
+
+void RiskManager::adopt_limits() {
+    std::unique_ptr<PendingLimits> limits(pending_limits_.exchange(nullptr, std::memory_order_acquire));
+    if (!limits) return;
+    config_              = limits->config;
+    max_notional_scaled_ = limits->max_notional_scaled;
+    rate_limit_          = limits->rate_limit;  // Buckets keep their level, capped at the new burst
+    for (size_t i = 0; i < limits->collar_pct.size(); ++i) {
+        if (limits->collar_pct[i] >= 0) symbol_configs_[i].price_collar_pct = limits->collar_pct[i];
+    }
+    limits_generation_.store(limits->generation, std::memory_order_release);
+    LOG_INFO("Risk limits generation {} applied: max_order_size={}, max_orders_per_sec={}, "
+             "max_notional_per_client={}", limits->generation, config_.max_order_size,
+             config_.max_orders_per_second, config_.max_notional_per_client);
+}
+
+uint64_t RiskManager::route_symbol(const Symbol& symbol, MatchingEngine* engine) {
+    const BookIndex book = engine ? engine->book_index(symbol) : NO_BOOK;
+    auto it = symbol_index_.find(symbol);  // Built at construction, read-only since
+    if (book == NO_BOOK || it == symbol_index_.end()) return 0;
+
+    std::lock_guard lock(routes_publish_mutex_);
+    auto routes = std::make_unique<PendingRoutes>();
+    if (std::unique_ptr<PendingRoutes> unadopted{pending_routes_.exchange(nullptr, std::memory_order_acq_rel)}) {
+        routes->changes = std::move(unadopted->changes);  // Not adopted yet: carried into this one
+    }
+    routes->changes.emplace_back(it->second, EngineRoute{engine, book});
+    routes->generation = next_routes_generation_++;
+    const uint64_t generation = routes->generation;
+    pending_routes_.store(routes.release(), std::memory_order_release);
+    idle_.notify();
+    return generation;
+}
+
+void RiskManager::adopt_routes() {
+    std::unique_ptr<PendingRoutes> routes(pending_routes_.exchange(nullptr, std::memory_order_acquire));
+    if (!routes) return;
+    for (const auto& [index, route] : routes->changes) {
+        routes_[index] = route;
+        routes_[index].outbound = outbound_for(route.engine);  // Nothing staged: the last batch flushed
+    }
+    routes_generation_.store(routes->generation, std::memory_order_release);
+}
+
 // ═══════════════════════════════════════════════════════════════
 //  Order Submission (called from gateway thread)
 // ═══════════════════════════════════════════════════════════════
 
-bool RiskManager::submit_order(Order* order) {
+bool RiskManager::push_request(const RiskRequest& request, RiskLane lane) {
+    if (lane >= lanes_.size()) [[unlikely]] return false;
+    InputLane& target = *lanes_[lane];
+
+    if (!target.queue->push(request)) [[unlikely]] {
+        target.drops.store(target.drops.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);  // Single producer per lane
+        return false;
+    }
+    target.submitted.store(target.submitted.load(std::memory_order_relaxed) + 1,
+                           std::memory_order_relaxed);
+    idle_.notify();
+    return true;
+}
+
+size_t RiskManager::submit_requests(const RiskRequest* requests, size_t count, RiskLane lane) {
+    if (lane >= lanes_.size() || count == 0) [[unlikely]] return 0;
+    InputLane& target = *lanes_[lane];
+
+    const size_t pushed = target.queue->try_push_bulk(requests, count);
+    if (pushed < count) [[unlikely]] {
+        target.drops.store(target.drops.load(std::memory_order_relaxed) + (count - pushed),
+                           std::memory_order_relaxed);
+    }
+    if (pushed > 0) {
+        target.submitted.store(target.submitted.load(std::memory_order_relaxed) + pushed,
+                               std::memory_order_relaxed);
+        idle_.notify();
+    }
+    return pushed;
+}
+
+bool RiskManager::submit_order(Order* order, RiskLane lane, InstrumentID instrument) {
     if (!order) [[unlikely]] return false;
 
     RiskRequest req;
     req.type = RiskRequest::NEW_ORDER;
+    req.instrument = instrument;
     req.order = order;
-
-    return input_queue_->push(req);
+    return push_request(req, lane);
 }
 
-bool RiskManager::submit_cancel(OrderID order_id, ClientID client_id) {
+bool RiskManager::submit_cancel(OrderID order_id, ClientID client_id, RiskLane lane,
+                                ClientIDRaw client_raw) {
     RiskRequest req;
     req.type = RiskRequest::CANCEL_ORDER;
+    req.client_raw = client_raw ? client_raw : resolve_client(client_id);
     req.cancel.order_id = order_id;
-    req.cancel.client_id = client_id;
+    return push_request(req, lane);
+}
+
+bool RiskManager::submit_modify(OrderID order_id, ClientID client_id,
+                                Quantity new_quantity, Price new_price, RiskLane lane,
+                                ClientIDRaw client_raw) {
+    RiskRequest req;
+    req.type = RiskRequest::MODIFY_ORDER;
+    req.client_raw = client_raw ? client_raw : resolve_client(client_id);
+    req.modify.order_id = order_id;
+    req.modify.new_quantity = new_quantity;
+    req.modify.new_price = new_price;
+    return push_request(req, lane);
+}
+
+bool RiskManager::submit_mass_cancel(const ClientID& client_id, const Symbol& symbol,
+                                     RiskLane lane, ClientIDRaw client_raw) {
+    RiskRequest req;
+    req.type = RiskRequest::MASS_CANCEL;
+    req.client_raw = client_raw ? client_raw : resolve_client(client_id);
+    req.mass_cancel.symbol = symbol;
+    return push_request(req, lane);
+}
+
+void RiskManager::set_execution_queue(SPSCQueue<ExecutionReport>* queue,
+                                      EventDoorbell* reader_bell) {
+    execution_egress_.assign({queue}, {reader_bell});
+}
 
-    return input_queue_->push(req);
+void RiskManager::set_execution_queues(const std::vector<SPSCQueue<ExecutionReport>*>& queues,
+                                       const std::vector<EventDoorbell*>& reader_bells) {
+    execution_egress_.assign(queues, reader_bells);
+}
+
+void RiskManager::set_feedback_rings(std::vector<SPSCQueue<RiskFeedback>*> rings) {
+    feedback_rings_ = std::move(rings);
+}
+
+void RiskManager::set_client_directory(ClientDirectory* directory) {
+    if (!directory) return;
+    directory_ = directory;
+    clients_.assign(directory->capacity() + 1, ClientRiskState{});
+    positions_.assign(clients_.size() * symbol_configs_.size(), SymbolPosition{});
+    if (directory != owned_directory_.get()) owned_directory_.reset();
 }
 
 void RiskManager::add_matching_engine(const std::string& symbol,
                                        MatchingEngine* engine) {
     Symbol key(symbol.c_str());
-    matching_engines_[key] = engine;
+    const BookIndex book = engine ? engine->book_index(key) : NO_BOOK;
+    if (book == NO_BOOK) {
+        LOG_WARN("Matching engine has no book for {}", symbol);
+        return;
+    }
+    auto it = symbol_index_.find(key);
+    if (it == symbol_index_.end()) return;  // Orders for it are rejected before routing
+    routes_[it->second] = EngineRoute{engine, book, outbound_for(engine)};
+}
+
+uint32_t RiskManager::outbound_for(MatchingEngine* engine) {
+    for (size_t i = 0; i < outbound_.size(); ++i) {
+        if (outbound_[i].engine == engine) return static_cast<uint32_t>(i);
+    }
+    Outbound& out = outbound_.emplace_back();
+    out.engine = engine;
+    out.requests.resize(RISK_OUTBOUND_BATCH);
+    out.orders.resize(RISK_OUTBOUND_BATCH, nullptr);
+    return static_cast<uint32_t>(outbound_.size() - 1);
+}
+
+void RiskManager::set_instrument_directory(const InstrumentDirectory* directory) {
+    instrument_slots_.clear();
+    for (size_t i = 0; i < symbol_configs_.size(); ++i) symbol_states_[i] = &owned_states_[i];
+    if (!directory) return;
+    instrument_slots_.assign(directory->size(), NO_RISK_SYMBOL);
+    for (size_t id = 0; id < directory->size(); ++id) {
+        auto it = symbol_index_.find(directory->symbols()[id]);
+        if (it == symbol_index_.end()) continue;
+        instrument_slots_[id] = it->second;
+        symbol_states_[it->second] = directory->state_slot(static_cast<InstrumentID>(id));
+    }
+}
+
+void RiskManager::set_reference_prices(ReferencePriceTable* table) {
+    reference_slots_.assign(symbol_configs_.size(), nullptr);
+    for (size_t i = 0; i < symbol_configs_.size(); ++i) {
+        const Symbol symbol(symbol_configs_[i].symbol.c_str());
+        ReferencePriceSlot* slot = table ? table->slot(symbol) : nullptr;
+        reference_slots_[i] = slot ? slot : owned_reference_prices_->slot(symbol);
+    }
 }
 
 /**
- * Set reference price for a symbol (from market data).
- * Called by exchange when trades execute or on startup.
- * Used for price collar validation.
+ * Seed a symbol's reference price (startup or external market data).
+ * Engines overwrite it with each trade when the table is shared.
  */
 void RiskManager::update_reference_price(const Symbol& symbol, Price price) {
-    reference_prices_[symbol] = price;
+    auto it = symbol_index_.find(symbol);
+    if (it == symbol_index_.end()) return;
+    reference_slots_[it->second]->price.store(price, std::memory_order_relaxed);
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -162,15 +390,20 @@ void RiskManager::update_reference_price(const Symbol& symbol, Price price) {
 // ═══════════════════════════════════════════════════════════════
 
 void RiskManager::run() {
+    applied_placement_.store(apply_thread_placement(placement_, "risk_manager"),
+                             std::memory_order_relaxed);
     LOG_INFO("Risk manager worker started");
 
     while (running_.load(std::memory_order_relaxed)) {
         size_t processed = drain_batch();
 
         if (processed > 0) {
-            maybe_flush_stats();
+            idle_.on_work();
+            execution_egress_.ring();
+            maybe_flush_stats(false);
         } else {
-            spin_wait();
+            maybe_flush_stats(true);
+            idle_.idle([this] { return any_lane_pending(); });
         }
     }
 
@@ -182,6 +415,7 @@ void RiskManager::run() {
         if (batch == 0) break;
         drained += batch;
     }
+    execution_egress_.ring();
 
     flush_stats();
 
@@ -192,27 +426,82 @@ void RiskManager::run() {
 }
 
 /**
- * Drain up to RISK_BATCH_SIZE orders from queue.
+ * Apply engine feedback, then drain up to RISK_BATCH_SIZE requests
+ * across the ingress lanes, staging what they send each engine for one
+ * bulk push at the end (flush_outbound()). Feedback goes first so the checks see
+ * exposure released by fills and cancels up to this point.
+ * Each lane gets an equal share per batch, and the starting lane
+ * rotates, so one busy gateway thread cannot starve the others.
+ * Order is preserved within a lane (one client session → one lane).
+ * @return requests + feedback events handled
  */
 size_t RiskManager::drain_batch() {
-    RiskRequest request;
-    size_t count = 0;
-
-    while (count < RISK_BATCH_SIZE && input_queue_->pop(request)) {
-        switch (request.type) {
-            case RiskRequest::NEW_ORDER:
-                process_new_order(request.order);
-                break;
-
-            case RiskRequest::CANCEL_ORDER:
-                process_cancel(request.cancel.order_id, request.cancel.client_id);
-                break;
-        }
-        ++count;
+    if (pending_limits_.load(std::memory_order_relaxed)) [[unlikely]] adopt_limits();
+    if (pending_routes_.load(std::memory_order_relaxed)) [[unlikely]] adopt_routes();
+    const size_t feedback = drain_feedback();
+
+    const size_t lanes = lanes_.size();
+    const size_t share = std::max<size_t>(1, RISK_BATCH_SIZE / lanes);
+
+    size_t total = 0;
+    for (size_t n = 0; n < lanes && total < RISK_BATCH_SIZE; ++n) {
+        InputLane& lane = *lanes_[(next_lane_ + n) % lanes];
+        const size_t count = lane.queue->try_pop_bulk(
+            drain_buffer_.data(), std::min(share, RISK_BATCH_SIZE - total));
+        if (count == 0) continue;
+        if (total == 0) batch_now_ = now_timestamp();  // One clock read per batch
+        for (size_t i = 0; i < count; ++i) process_request(drain_buffer_[i]);
+        total += count;
     }
+    next_lane_ = (next_lane_ + 1) % lanes;
+    flush_all_outbound();  // One push per engine the batch routed to
 
-    local_stats_.processed += count;
-    return count;
+    local_stats_.processed += total;
+    return total + feedback;
+}
+
+size_t RiskManager::drain_feedback() {
+    size_t total = 0;
+    for (auto* ring : feedback_rings_) {
+        const size_t count = ring->try_pop_bulk(feedback_buffer_.data(), RISK_FEEDBACK_BATCH);
+        for (size_t i = 0; i < count; ++i) apply_feedback(feedback_buffer_[i]);
+        total += count;
+    }
+    local_stats_.feedback_applied += total;
+    return total;
+}
+
+bool RiskManager::any_lane_pending() {
+    if (pending_limits_.load(std::memory_order_relaxed)) return true;  // Adopt it even when idle
+    if (pending_routes_.load(std::memory_order_relaxed)) return true;
+    for (auto& lane : lanes_) {
+        if (!lane->queue->consumer_empty()) return true;
+    }
+    for (auto* ring : feedback_rings_) {
+        if (!ring->consumer_empty()) return true;
+    }
+    return false;
+}
+
+void RiskManager::process_request(const RiskRequest& request) {
+    switch (request.type) {
+        case RiskRequest::NEW_ORDER:
+            process_new_order(request.order, request.instrument);
+            break;
+
+        case RiskRequest::CANCEL_ORDER:
+            process_cancel(request.cancel.order_id, request.client_raw);
+            break;
+
+        case RiskRequest::MODIFY_ORDER:
+            process_modify(request.modify.order_id, request.client_raw,
+                           request.modify.new_quantity, request.modify.new_price);
+            break;
+
+        case RiskRequest::MASS_CANCEL:
+            process_mass_cancel(request.client_raw, request.mass_cancel.symbol);
+            break;
+    }
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -224,30 +513,36 @@ size_t RiskManager::drain_batch() {
  *
  * Validation sequence (fail-fast — cheapest checks first):
  *   1. Null check
- *   2. Symbol allowed (hash lookup)
+ *   2. Symbol allowed (stamped id → array index; hash if unstamped)
  *   3. Order size (integer compare)
  *   4. Rate limit (counter check)
  *   5. Duplicate order (hash lookup)
  *   6. Price collar (integer arithmetic)
  *   7. Credit limit (integer arithmetic)
- *   8. Update state + route to matching engine
+ *   8. Position / working quantity (dense client × symbol slot)
+ *   9. Update state + stage for the matching engine (pushed at batch end)
  */
-void RiskManager::process_new_order(Order* order) {
+void RiskManager::process_new_order(Order* order, InstrumentID instrument) {
     if (!order) [[unlikely]] {
         ++local_stats_.rejected;
         return;
     }
+    if (tracer_) [[unlikely]] tracer_->stamp(*order, OrderStage::RISK_DEQUEUE);
 
     // ── Symbol lookup (zero allocation) ──
     const Symbol& sym = order->symbol;
-    auto sym_it = symbol_configs_.find(sym);
-
-    if (sym_it == symbol_configs_.end()) [[unlikely]] {
+    RiskSymbolIndex symbol_index;
+    if (!find_symbol(*order, instrument, symbol_index)) [[unlikely]] {
         reject_order(order, RiskResult::REJECTED_SYMBOL);
         return;
     }
-
-    const SymbolConfig& sym_config = sym_it->second;
+    const InstrumentState state = symbol_states_[symbol_index]->load(std::memory_order_relaxed);
+    if (state != InstrumentState::OPEN) [[unlikely]] {
+        reject_order(order, state == InstrumentState::HALTED ? RiskResult::REJECTED_HALTED
+                                                             : RiskResult::REJECTED_SYMBOL);
+        return;
+    }
+    const SymbolConfig& sym_config = symbol_configs_[symbol_index];
 
     // ── Order size check (cheapest) ──
     if (order->quantity == 0 ||
@@ -256,8 +551,13 @@ void RiskManager::process_new_order(Order* order) {
         return;
     }
 
-    // ── Get/create client state ──
-    auto& client = get_or_create_client(order->client_id);
+    // ── Client slot (array index by the gateway-stamped id) ──
+    ClientRiskState* client_slot = find_client(order->owner, order->client_id, true);
+    if (!client_slot) [[unlikely]] {
+        reject_order(order, RiskResult::REJECTED_CAPACITY);
+        return;
+    }
+    auto& client = *client_slot;
 
     // ── Rate limit check ──
     if (!check_rate_limit(client)) [[unlikely]] {
@@ -266,14 +566,14 @@ void RiskManager::process_new_order(Order* order) {
     }
 
     // ── Duplicate check ──
-    if (client.active_orders.count(order->id)) [[unlikely]] {
+    if (order_index_.contains(order->id)) [[unlikely]] {
         reject_order(order, RiskResult::REJECTED_DUPLICATE);
         return;
     }
 
     // ── Price collar check (integer arithmetic, no float) ──
     if (config_.price_collar_enabled &&
-        !check_price_collar_int(order, sym_config)) [[unlikely]] {
+        !check_price_collar_int(symbol_index, order->price, sym_config)) [[unlikely]] {
         reject_order(order, RiskResult::REJECTED_PRICE);
         return;
     }
@@ -286,37 +586,43 @@ void RiskManager::process_new_order(Order* order) {
         return;
     }
 
+    // ── Position / working quantity (one dense slot per client × symbol) ──
+    SymbolPosition& position = position_of(client, symbol_index);
+    if (!check_position(position, order->side, order->quantity)) [[unlikely]] {
+        reject_order(order, RiskResult::REJECTED_POSITION);
+        return;
+    }
+
     // ── All checks passed — update state and route ──
+    // Undone (on the stack, newest first) unless the engine takes the order
+    UndoLog<3> undo;
 
-    // Track active order (for cancel ownership + duplicate detection)
-    client.active_orders.insert(order->id);
-    client.notional_exposure_scaled += order_notional;
-
-    // Track order→symbol mapping (for targeted cancel routing)
-    order_symbol_index_[order->id] = sym;
-
-    // Route to matching engine (direct FixedString lookup, no std::string)
-    auto me_it = matching_engines_.find(sym);
-    if (me_it != matching_engines_.end()) [[likely]] {
-        if (!me_it->second->submit_order(order)) [[unlikely]] {
-            // Matching engine queue full — rollback state
-            client.active_orders.erase(order->id);
-            client.notional_exposure_scaled -= order_notional;
-            order_symbol_index_.erase(order->id);
-            reject_order(order, RiskResult::REJECTED_QUEUE_FULL);
-            return;
-        }
-    } else [[unlikely]] {
+    // Track live order (duplicate detection, cancel ownership + routing)
+    if (!order_index_.insert(order->id, ActiveOrder{sym, &client, order->price, order->quantity,
+                                                    symbol_index, order->side})) [[unlikely]] {
+        reject_order(order, RiskResult::REJECTED_CAPACITY);
+        return;
+    }
+    undo.on_rollback<[](OrderIdMap<ActiveOrder>& index, uint64_t id) { index.erase(id); }>(
+        order_index_, order->id);
+    undo.add(client.notional_exposure_scaled, order_notional);
+    undo.add((order->side == Side::BUY) ? position.open_buy : position.open_sell, order->quantity);
+    order->owner = client.raw_id;  // Single-compare ownership for self-trade prevention
+
+    // Route to matching engine (same symbol slot)
+    const EngineRoute& route = routes_[symbol_index];
+    if (!route.engine) [[unlikely]] {
         // No matching engine for symbol (config error)
-        client.active_orders.erase(order->id);
-        client.notional_exposure_scaled -= order_notional;
-        order_symbol_index_.erase(order->id);
+        undo.rollback();
         reject_order(order, RiskResult::REJECTED_SYMBOL);
         return;
     }
+    if (tracer_) [[unlikely]] tracer_->stamp(*order, OrderStage::RISK_APPROVE);
+    undo.commit();  // A full engine lane unwinds it at the flush instead (unstage_order)
 
     order->status = OrderStatus::ACCEPTED;
     ++local_stats_.approved;
+    stage(route.outbound, route.engine->new_order_request(order, route.book), order);
 }
 
 /**
@@ -325,36 +631,197 @@ void RiskManager::process_new_order(Order* order) {
  * Unlike the old broadcast approach, we look up the order's symbol
  * and route the cancel to the specific matching engine.
  */
-void RiskManager::process_cancel(OrderID order_id, ClientID client_id) {
+void RiskManager::process_cancel(OrderID order_id, ClientIDRaw client_raw) {
     // Ownership check
-    auto client_it = client_states_.find(client_id);
-    if (client_it == client_states_.end()) [[unlikely]] {
+    const ClientRiskState* client = find_client(client_raw, ClientID{}, false);
+    const ActiveOrder* entry = order_index_.find(order_id);
+    if (!client || !entry || entry->owner != client) [[unlikely]] {
         ++local_stats_.cancels_rejected;
         return;
     }
 
-    auto& client = client_it->second;
-    if (client.active_orders.count(order_id) == 0) [[unlikely]] {
-        ++local_stats_.cancels_rejected;
+    // Route cancel to the order's matching engine
+    const EngineRoute& route = routes_[entry->symbol_index];
+    if (route.engine) stage(route.outbound, OrderRequest::make_cancel(order_id, route.book));
+
+    // The entry (and its notional) is released by the engine's DONE feedback
+    ++local_stats_.cancels_accepted;
+}
+
+/**
+ * Mass cancel: one request per engine instead of one per order. The
+ * books sweep their own order index, so orders still queued ahead of
+ * this request on our engine lane are swept too. Live entries here are
+ * released by the DONE feedback of each cancelled order.
+ */
+void RiskManager::process_mass_cancel(ClientIDRaw client_raw, const Symbol& symbol) {
+    const ClientRiskState* client = find_client(client_raw, ClientID{}, false);
+    if (!client) [[unlikely]] return;  // Never traded here: nothing to cancel
+
+    ++local_stats_.mass_cancels;
+    if (!symbol.empty()) {
+        auto it = symbol_index_.find(symbol);
+        if (it == symbol_index_.end() || !routes_[it->second].engine) return;
+        const EngineRoute& route = routes_[it->second];
+        stage(route.outbound, OrderRequest::make_mass_cancel(client->raw_id, route.book));
+        return;
+    }
+    for (uint32_t i = 0; i < outbound_.size(); ++i) {
+        stage(i, OrderRequest::make_mass_cancel(client->raw_id, NO_BOOK));
+    }
+}
+
+/**
+ * Process cancel/replace.
+ *
+ * Same ownership lookup as cancel, then the new terms are re-checked
+ * (size, rate limit, collar, credit on the notional increase) before
+ * a single MODIFY_ORDER is routed to the matching engine.
+ * Exposure moves to the new terms at once (up or down), so it always
+ * equals the sum of live entries' price × quantity.
+ */
+void RiskManager::process_modify(OrderID order_id, ClientIDRaw client_raw,
+                                 Quantity new_quantity, Price new_price) {
+    ClientRiskState* client_slot = find_client(client_raw, ClientID{}, false);
+    ActiveOrder* entry = order_index_.find(order_id);
+    if (entry && routes_[entry->symbol_index].engine) {
+        // Pushed directly, so a full lane refuses it before exposure moves: what is staged goes first
+        flush_outbound(outbound_[routes_[entry->symbol_index].outbound]);
+        entry = order_index_.find(order_id);  // The order itself may not have fit
+    }
+    if (!client_slot || !entry || entry->owner != client_slot) [[unlikely]] {
+        ++local_stats_.modifies_rejected;
         return;
     }
+    auto& client = *client_slot;
 
-    // Look up symbol for targeted routing
-    auto sym_it = order_symbol_index_.find(order_id);
-    if (sym_it != order_symbol_index_.end()) {
-        // Route cancel to specific matching engine
-        auto me_it = matching_engines_.find(sym_it->second);
-        if (me_it != matching_engines_.end()) {
-            (void)me_it->second->cancel_order(order_id, client_id);
-        }
+    const Price price = new_price ? new_price : entry->price;
+    const SymbolConfig& sym_config = symbol_configs_[entry->symbol_index];
+    if (new_quantity == 0 || new_quantity > config_.max_order_size ||
+        !check_rate_limit(client)) [[unlikely]] {
+        ++local_stats_.modifies_rejected;
+        return;
+    }
+    // Not open: only a same-price size-down, the one modify a halted book takes
+    if (symbol_states_[entry->symbol_index]->load(std::memory_order_relaxed) != InstrumentState::OPEN &&
+        (price != entry->price || new_quantity > entry->quantity)) [[unlikely]] {
+        ++local_stats_.modifies_rejected;
+        return;
+    }
+    if (config_.price_collar_enabled &&
+        !check_price_collar_int(entry->symbol_index, price, sym_config)) [[unlikely]] {
+        ++local_stats_.modifies_rejected;
+        return;
+    }
 
-        order_symbol_index_.erase(sym_it);
+    const uint64_t old_notional = entry->price * entry->quantity;
+    const uint64_t new_notional = price * new_quantity;
+    const uint64_t increase = (new_notional > old_notional) ? new_notional - old_notional : 0;
+    if (client.notional_exposure_scaled + increase > max_notional_scaled_) [[unlikely]] {
+        ++local_stats_.modifies_rejected;
+        return;
     }
 
-    // Update client state
-    client.active_orders.erase(order_id);
-    // Note: notional reduction happens when cancel confirmed by matching engine
-    ++local_stats_.cancels_accepted;
+    SymbolPosition& position = position_of(client, entry->symbol_index);
+    uint64_t& working = (entry->side == Side::BUY) ? position.open_buy : position.open_sell;
+    if (new_quantity > entry->quantity &&
+        !check_position(position, entry->side, new_quantity - entry->quantity)) [[unlikely]] {
+        ++local_stats_.modifies_rejected;
+        return;
+    }
+
+    const EngineRoute& route = routes_[entry->symbol_index];
+    if (!route.engine ||
+        !route.engine->modify_order(order_id, ClientID{}, new_quantity, new_price,
+                                    route.book, engine_lane_)) [[unlikely]] {
+        ++local_stats_.modifies_rejected;
+        return;
+    }
+
+    client.notional_exposure_scaled += new_notional;
+    release_exposure(client, old_notional);
+    working += new_quantity;
+    working -= std::min<uint64_t>(entry->quantity, working);
+    entry->price    = price;
+    entry->quantity = new_quantity;
+    ++local_stats_.modifies_accepted;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Outbound Staging
+// ═══════════════════════════════════════════════════════════════
+
+void RiskManager::stage(uint32_t outbound, const OrderRequest& request, Order* order) {
+    Outbound& out = outbound_[outbound];
+    out.requests[out.count] = request;
+    out.orders[out.count] = order;
+    if (++out.count == RISK_OUTBOUND_BATCH) [[unlikely]] flush_outbound(out);
+}
+
+/**
+ * One bulk push of what was staged for an engine: one cache line
+ * handover per batch instead of one per request. What the lane has no
+ * room for is dropped as a refused single push was — approved orders are
+ * unwound and rejected (REJECTED_QUEUE_FULL), cancels are lost.
+ */
+void RiskManager::flush_outbound(Outbound& out) {
+    if (out.count == 0) return;
+    const size_t pushed = out.engine->submit_requests(out.requests.data(), out.count, engine_lane_);
+    ++local_stats_.engine_pushes;
+    for (size_t i = pushed; i < out.count; ++i) {
+        if (out.orders[i]) [[unlikely]] unstage_order(out.orders[i]);
+    }
+    out.count = 0;
+}
+
+void RiskManager::flush_all_outbound() {
+    for (Outbound& out : outbound_) flush_outbound(out);
+}
+
+void RiskManager::unstage_order(Order* order) {
+    if (ActiveOrder* entry = order_index_.find(order->id)) {
+        SymbolPosition& position = position_of(*entry->owner, entry->symbol_index);
+        uint64_t& working = (entry->side == Side::BUY) ? position.open_buy : position.open_sell;
+        working -= std::min<uint64_t>(entry->quantity, working);
+        release_exposure(*entry->owner, calculate_notional_int(order));
+        order_index_.erase(order->id);
+    }
+    --local_stats_.approved;
+    reject_order(order, RiskResult::REJECTED_QUEUE_FULL);
+}
+
+/**
+ * Unwind live-order state from engine feedback.
+ *   FILL: the executed quantity is no longer working — release its
+ *         notional at the entry's (limit) price and move it into the
+ *         client's net position in the symbol. The fill that leaves
+ *         nothing open is terminal: the id is forgotten there, so a
+ *         DONE dropped on a full ring cannot strand it
+ *   DONE: release whatever is still open and forget the id, which
+ *         also frees it for the duplicate check
+ * Unknown ids (orders that bypassed risk, or already filled) are ignored.
+ */
+void RiskManager::apply_feedback(const RiskFeedback& feedback) {
+    ActiveOrder* entry = order_index_.find(feedback.order_id);
+    if (!entry) [[unlikely]] return;
+
+    SymbolPosition& position = position_of(*entry->owner, entry->symbol_index);
+    const bool buy = (entry->side == Side::BUY);
+    uint64_t& working = buy ? position.open_buy : position.open_sell;
+
+    if (feedback.type == RiskFeedback::FILL) {
+        const Quantity executed = std::min(feedback.quantity, entry->quantity);
+        release_exposure(*entry->owner, entry->price * executed);
+        entry->quantity -= executed;
+        working -= std::min<uint64_t>(executed, working);
+        const auto signed_qty = static_cast<int64_t>(executed);
+        position.net += buy ? signed_qty : -signed_qty;
+        if (entry->quantity == 0) order_index_.erase(feedback.order_id);
+    } else {
+        release_exposure(*entry->owner, entry->price * entry->quantity);
+        working -= std::min<uint64_t>(entry->quantity, working);
+        order_index_.erase(feedback.order_id);
+    }
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -379,24 +846,19 @@ void RiskManager::process_cancel(OrderID order_id, ClientID client_id) {
  * Reference price comes from last trade or initial config.
  * If no reference price exists, collar check is SKIPPED (not failed).
  */
-bool RiskManager::check_price_collar_int(const Order* order,
+bool RiskManager::check_price_collar_int(RiskSymbolIndex symbol, Price price,
                                           const SymbolConfig& sym_config) const {
-    // Look up reference price for this symbol
-    auto ref_it = reference_prices_.find(order->symbol);
-    if (ref_it == reference_prices_.end()) {
-        // No reference price yet — skip collar (allow first trades)
-        return true;
-    }
-
-    const Price ref_price = ref_it->second;
-    if (ref_price == 0) return true;  // No meaningful reference
+    // Last trade published by the owning engine (see reference_prices.hpp)
+    const Price ref_price =
+        reference_slots_[symbol]->price.load(std::memory_order_relaxed);
+    if (ref_price == 0) return true;  // No reference yet — skip collar (allow first trades)
 
     const uint64_t collar_pct = sym_config.price_collar_pct;  // e.g., 10 = 10%
 
     // order_price * 100 must be within [ref * (100 - pct), ref * (100 + pct)]
     // Using 128-bit multiplication to prevent overflow for large prices
     const __uint128_t order_scaled =
-        static_cast<__uint128_t>(order->price) * 100;
+        static_cast<__uint128_t>(price) * 100;
     const __uint128_t ref_lower =
         static_cast<__uint128_t>(ref_price) * (100 - collar_pct);
     const __uint128_t ref_upper =
@@ -406,30 +868,32 @@ bool RiskManager::check_price_collar_int(const Order* order,
 }
 
 /**
- * Rate limit check using nanosecond timestamp.
- *
- * Sliding window: count orders within the last 1 second.
- * When window expires, reset counter.
- *
- * Uses now_timestamp() (nanosecond uint64_t) instead of
- * steady_clock::now() + chrono comparison for consistency
- * with the rest of the codebase.
+ * Position limits for adding `added` to the working quantity on `side`
+ * (0 limits are off). Worst case assumes every working order on that
+ * side fills:
+ *   buy : net + open_buy + added            ≤ max_position
+ *   sell: open_sell + added - net           ≤ max_position
+ *   both: open_<side> + added               ≤ max_open_quantity
  */
-bool RiskManager::check_rate_limit(ClientRiskState& client) {
-    const Timestamp now = now_timestamp();
-
-    // Reset window if expired
-    if (now - client.window_start_ns >= RATE_LIMIT_WINDOW_NS) {
-        client.orders_in_window = 0;
-        client.window_start_ns = now;
-    }
-
-    if (client.orders_in_window >= config_.max_orders_per_second) {
-        return false;
-    }
+bool RiskManager::check_position(const SymbolPosition& position, Side side,
+                                 uint64_t added) const {
+    const uint64_t working = ((side == Side::BUY) ? position.open_buy : position.open_sell) + added;
+    if (config_.max_open_quantity != 0 && working > config_.max_open_quantity) return false;
+    if (config_.max_position == 0) return true;
+
+    const int64_t worst = (side == Side::BUY)
+        ? position.net + static_cast<int64_t>(working)
+        : static_cast<int64_t>(working) - position.net;
+    return worst <= static_cast<int64_t>(config_.max_position);
+}
 
-    ++client.orders_in_window;
-    return true;
+/**
+ * Token bucket per client: max_orders_per_second refilled continuously,
+ * at most rate_limit_burst held. Refill uses the batch timestamp taken
+ * in drain_batch(), so a batch costs one clock read, not one per order.
+ */
+bool RiskManager::check_rate_limit(ClientRiskState& client) {
+    return rate_limit_.try_consume(client.rate_bucket, batch_now_);
 }
 
 /**
@@ -459,32 +923,66 @@ uint64_t RiskManager::calculate_notional_int(const Order* order) const {
 // ═══════════════════════════════════════════════════════════════
 
 /**
- * Get or create client risk state.
+ * Client slot for a directory id: one bounds check and one array index.
  *
- * The unordered_map operator[] creates a default entry if not found.
- * This is a cold-path allocation (happens once per new client).
- * Subsequent lookups for the same client are O(1) hash lookup.
+ * raw == 0 means the caller did not resolve the client (direct API use);
+ * the ClientID is then looked up in the shared directory — a mutex, so
+ * the gateway always stamps the id. A slot is initialised the first time
+ * its client trades through this shard; cancels/modifies never create one.
  */
-ClientRiskState& RiskManager::get_or_create_client(const ClientID& id) {
-    auto it = client_states_.find(id);
-    if (it != client_states_.end()) [[likely]] {
-        return it->second;
+ClientRiskState* RiskManager::find_client(ClientIDRaw raw, const ClientID& id, bool create) {
+    if (raw == 0) [[unlikely]] {
+        raw = create ? directory_->resolve(id) : directory_->find(id);
     }
+    if (raw == 0 || raw >= clients_.size()) [[unlikely]] return nullptr;
 
-    // New client — create state
-    auto [new_it, inserted] = client_states_.emplace(id, ClientRiskState{});
-    new_it->second.window_start_ns = now_timestamp();
-    return new_it->second;
+    ClientRiskState& client = clients_[raw];
+    if (client.raw_id == 0) [[unlikely]] {
+        if (!create) return nullptr;
+        client.raw_id = raw;
+    }
+    return &client;
 }
 
+namespace {
+
+/** Client-facing reason for a risk reject. */
+ErrorCode risk_error_code(RiskResult reason) {
+    switch (reason) {
+        case RiskResult::REJECTED_SIZE:
+        case RiskResult::REJECTED_PRICE:
+        case RiskResult::REJECTED_CREDIT:
+        case RiskResult::REJECTED_POSITION:   return ErrorCode::RISK_LIMIT_EXCEEDED;
+        case RiskResult::REJECTED_DUPLICATE:  return ErrorCode::ORDER_DUPLICATE;
+        case RiskResult::REJECTED_HALTED:     return ErrorCode::ORDER_HALTED;
+        case RiskResult::REJECTED_SYMBOL:
+        case RiskResult::REJECTED_OWNERSHIP:  return ErrorCode::ORDER_INVALID;
+        case RiskResult::REJECTED_RATE_LIMIT:
+        case RiskResult::REJECTED_QUEUE_FULL:
+        case RiskResult::REJECTED_CAPACITY:   return ErrorCode::SYSTEM_OVERLOAD;
+        case RiskResult::APPROVED:            break;
+    }
+    return ErrorCode::ORDER_INVALID;
+}
+
+} // namespace
+
 /**
- * Reject order and update stats.
+ * Reject order, report it to the gateway and update stats.
  * Logging is rate-limited to prevent flooding under attack.
  */
 void RiskManager::reject_order(Order* order, RiskResult reason) {
     order->status = OrderStatus::REJECTED;
     ++local_stats_.rejected;
 
+    if (execution_egress_.connected()) [[likely]] {
+        (void)execution_egress_.publish(
+            ExecutionReport::make_reject(order->id,
+                                         static_cast<uint32_t>(risk_error_code(reason)),
+                                         order->ingress),
+            order->ingress);
+    }
+
     // Rate-limited logging (at most once per 1000 rejections per reason)
     if (local_stats_.rejected % 1000 == 1) {
         LOG_WARN("Order {} rejected: reason={}", order->id,
@@ -493,35 +991,47 @@ void RiskManager::reject_order(Order* order, RiskResult reason) {
 }
 
 // ═══════════════════════════════════════════════════════════════
-//  Backoff Strategy
+//  Statistics
 // ═══════════════════════════════════════════════════════════════
 
-void RiskManager::spin_wait() {
-    for (size_t i = 0; i < RISK_SPIN_ITERS; ++i) {
-        if (!input_queue_->consumer_empty()) return;
+SymbolPosition RiskManager::position(const ClientID& client, const Symbol& symbol) const {
+    const ClientIDRaw raw = directory_->find(client);
+    auto sym_it = symbol_index_.find(symbol);
+    if (raw == 0 || raw >= clients_.size() || sym_it == symbol_index_.end()) return {};
+    return positions_[raw * symbol_configs_.size() + sym_it->second];
+}
 
-        for (size_t p = 0; p < RISK_PAUSE_PER_SPIN; ++p) {
-#ifdef __x86_64__
-            _mm_pause();
-#elif defined(__aarch64__)
-            asm volatile("yield" ::: "memory");
-#endif
-        }
+std::vector<IngressLaneStats> RiskManager::lane_stats() const {
+    std::vector<IngressLaneStats> stats;
+    stats.reserve(lanes_.size());
+    for (const auto& lane : lanes_) {
+        stats.push_back({
+            .depth     = lane->queue->size(),
+            .submitted = lane->submitted.load(std::memory_order_relaxed),
+            .drops     = lane->drops.load(std::memory_order_relaxed),
+            .capacity  = lane->queue->capacity(),
+            .telemetry = lane->queue->telemetry(),
+        });
     }
-    sched_yield();
+    return stats;
 }
 
-// ═══════════════════════════════════════════════════════════════
-//  Statistics
-// ═══════════════════════════════════════════════════════════════
-
-void RiskManager::maybe_flush_stats() {
-    if (local_stats_.processed % RISK_STATS_FLUSH == 0) {
+/**
+ * Busy: once RISK_STATS_FLUSH requests have gone by since the last flush
+ * (a batch can step over any multiple). Idle: whatever has changed, so
+ * a quiet shard never hides its last requests.
+ */
+void RiskManager::maybe_flush_stats(bool idle) {
+    const size_t since = local_stats_.processed - flushed_processed_;
+    if (since >= RISK_STATS_FLUSH ||
+        (idle && (since != 0 || local_stats_.feedback_applied != flushed_feedback_))) {
         flush_stats();
     }
 }
 
 void RiskManager::flush_stats() {
+    flushed_processed_ = local_stats_.processed;
+    flushed_feedback_  = local_stats_.feedback_applied;
     stats_atomic_.processed.store(
         local_stats_.processed, std::memory_order_relaxed);
     stats_atomic_.approved.store(
@@ -532,6 +1042,31 @@ void RiskManager::flush_stats() {
         local_stats_.cancels_accepted, std::memory_order_relaxed);
     stats_atomic_.cancels_rejected.store(
         local_stats_.cancels_rejected, std::memory_order_relaxed);
+    stats_atomic_.modifies_accepted.store(
+        local_stats_.modifies_accepted, std::memory_order_relaxed);
+    stats_atomic_.modifies_rejected.store(
+        local_stats_.modifies_rejected, std::memory_order_relaxed);
+    stats_atomic_.feedback_applied.store(
+        local_stats_.feedback_applied, std::memory_order_relaxed);
+    stats_atomic_.mass_cancels.store(
+        local_stats_.mass_cancels, std::memory_order_relaxed);
+    stats_atomic_.engine_pushes.store(
+        local_stats_.engine_pushes, std::memory_order_relaxed);
+    if (stats_block_) {
+        StatsCounters counters;
+        counters.flushes = ++stats_flushes_;
+        counters.values[RISK_PROCESSED]         = local_stats_.processed;
+        counters.values[RISK_APPROVED]          = local_stats_.approved;
+        counters.values[RISK_REJECTED]          = local_stats_.rejected;
+        counters.values[RISK_CANCELS_ACCEPTED]  = local_stats_.cancels_accepted;
+        counters.values[RISK_CANCELS_REJECTED]  = local_stats_.cancels_rejected;
+        counters.values[RISK_MODIFIES_ACCEPTED] = local_stats_.modifies_accepted;
+        counters.values[RISK_MODIFIES_REJECTED] = local_stats_.modifies_rejected;
+        counters.values[RISK_FEEDBACK_APPLIED]  = local_stats_.feedback_applied;
+        counters.values[RISK_MASS_CANCELS]      = local_stats_.mass_cancels;
+        counters.values[RISK_ENGINE_PUSHES]     = local_stats_.engine_pushes;
+        stats_block_->publish(counters);
+    }
 }
 
 } // namespace rtes
\ No newline at end of file
@@ -0,0 +1,193 @@
+/**
+ * @file session_capture.cpp
+ * @brief Inbound frame capture lanes, writer thread and reader
+ */
+
+#include "rtes/session_capture.hpp"
+#include "rtes/logger.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace rtes {
+
+namespace {
+
+constexpr size_t FIRST_CHUNK_PAYLOAD = CAPTURE_CHUNK_BYTES - sizeof(CaptureEventHeader);
+constexpr auto   CAPTURE_POLL        = std::chrono::milliseconds(1);
+constexpr size_t CAPTURE_FILE_BUFFER = 1 << 20;
+
+constexpr size_t chunks_for(size_t length) {
+    return length <= FIRST_CHUNK_PAYLOAD
+               ? 1
+               : 1 + (length - FIRST_CHUNK_PAYLOAD + CAPTURE_CHUNK_BYTES - 1) / CAPTURE_CHUNK_BYTES;
+}
+
+uint64_t steady_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+constexpr size_t MAX_EVENT_CHUNKS = chunks_for(SESSION_CAPTURE_MAX_FRAME);
+
+} // namespace
+
+SessionCapture::SessionCapture(std::string path, size_t reactors, size_t lane_chunks)
+    : path_(std::move(path))
+{
+    // A lane must hold the largest frame, or that frame could never be pushed
+    lane_chunks = std::max(lane_chunks, MAX_EVENT_CHUNKS);
+    for (size_t i = 0; i < std::max<size_t>(reactors, 1); ++i) {
+        lanes_.push_back(std::make_unique<Lane>(lane_chunks));
+    }
+}
+
+SessionCapture::~SessionCapture() {
+    stop();
+}
+
+bool SessionCapture::start() {
+    if (running_.load(std::memory_order_relaxed)) return true;
+    file_ = std::fopen(path_.c_str(), "wb");
+    if (!file_) {
+        LOG_ERROR("Cannot create session capture {}: {}", path_, std::strerror(errno));
+        return false;
+    }
+    std::setvbuf(file_, nullptr, _IOFBF, CAPTURE_FILE_BUFFER);
+
+    SessionCaptureFileHeader header;
+    std::memcpy(header.magic, SESSION_CAPTURE_MAGIC, sizeof(header.magic));
+    header.reactors          = static_cast<uint32_t>(lanes_.size());
+    header.start_steady_ns   = steady_ns();
+    header.start_realtime_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    std::fwrite(&header, sizeof(header), 1, file_);
+
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&SessionCapture::run, this);
+    LOG_INFO("Session capture → {} ({} lanes of {} chunks)", path_, lanes_.size(),
+             lanes_.front()->queue.capacity());
+    return true;
+}
+
+void SessionCapture::stop() {
+    bool expected = true;
+    if (!running_.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) return;
+    if (thread_.joinable()) thread_.join();
+    drain();  // What the reactors left behind
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+uint64_t SessionCapture::drops() const {
+    uint64_t total = 0;
+    for (const auto& lane : lanes_) total += lane->drops.load(std::memory_order_relaxed);
+    return total;
+}
+
+void SessionCapture::record(size_t reactor, CaptureEventType type, uint16_t connection,
+                            uint32_t generation, const uint8_t* data, size_t length) {
+    Lane& lane = *lanes_[reactor];
+    if (length > SESSION_CAPTURE_MAX_FRAME) [[unlikely]] {
+        lane.drops.fetch_add(1, std::memory_order_relaxed);
+        LOG_WARN("Session capture dropped a {}-byte frame (max {})", length, SESSION_CAPTURE_MAX_FRAME);
+        return;
+    }
+
+    CaptureEventHeader header;
+    header.time_ns    = steady_ns();
+    header.generation = generation;
+    header.connection = connection;
+    header.length     = static_cast<uint16_t>(length);
+    header.type       = type;
+    header.reactor    = static_cast<uint8_t>(reactor);
+
+    const size_t chunks = chunks_for(length);
+    if (chunks == 1) [[likely]] {
+        CaptureChunk chunk;
+        std::memcpy(chunk.bytes, &header, sizeof(header));
+        if (length) std::memcpy(chunk.bytes + sizeof(header), data, length);
+        if (!lane.queue.push(chunk)) lane.drops.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // All chunks become visible together (one head store), or none are pushed
+    if (lane.queue.capacity() - lane.queue.size() < chunks) {
+        lane.drops.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    std::array<CaptureChunk, MAX_EVENT_CHUNKS> staged;
+    auto* bytes = reinterpret_cast<uint8_t*>(staged.data());
+    std::memcpy(bytes, &header, sizeof(header));
+    std::memcpy(bytes + sizeof(header), data, length);
+    (void)lane.queue.try_push_bulk(staged.data(), chunks);
+}
+
+void SessionCapture::run() {
+    while (running_.load(std::memory_order_relaxed)) {
+        if (drain() == 0) {
+            std::fflush(file_);  // Idle: a crash loses at most the last poll's events
+            std::this_thread::sleep_for(CAPTURE_POLL);
+        }
+    }
+}
+
+size_t SessionCapture::drain() {
+    size_t   events  = 0;
+    uint64_t written = 0;
+    std::array<CaptureChunk, MAX_EVENT_CHUNKS> event;
+    const auto* bytes = reinterpret_cast<const uint8_t*>(event.data());
+    for (auto& lane : lanes_) {
+        while (lane->queue.pop(event[0])) {
+            CaptureEventHeader header;
+            std::memcpy(&header, bytes, sizeof(header));
+            // Pushed in one bulk with the first chunk: already visible
+            for (size_t i = 1; i < chunks_for(header.length); ++i) (void)lane->queue.pop(event[i]);
+            std::fwrite(bytes, sizeof(header) + header.length, 1, file_);
+            written += sizeof(header) + header.length;
+            ++events;
+        }
+    }
+    events_.fetch_add(events, std::memory_order_relaxed);
+    bytes_.fetch_add(written, std::memory_order_relaxed);
+    return events;
+}
+
+bool read_session_capture(const std::string& path,
+                          const std::function<void(const CaptureEventHeader&, const uint8_t*)>& on_event,
+                          SessionCaptureFileHeader* header_out, bool* truncated) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    std::setvbuf(file, nullptr, _IOFBF, CAPTURE_FILE_BUFFER);
+
+    SessionCaptureFileHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, SESSION_CAPTURE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SESSION_CAPTURE_VERSION) {
+        std::fclose(file);
+        return false;
+    }
+    if (header_out) *header_out = header;
+
+    std::vector<uint8_t> frame(UINT16_MAX);  // Any CaptureEventHeader::length
+    CaptureEventHeader event;
+    size_t got;
+    bool   cut = false;
+    while ((got = std::fread(&event, 1, sizeof(event), file)) == sizeof(event)) {
+        if (event.length && std::fread(frame.data(), event.length, 1, file) != 1) {
+            cut = true;
+            break;
+        }
+        on_event(event, frame.data());
+    }
+    cut = cut || got != 0;
+    std::fclose(file);
+    if (cut) LOG_WARN("Session capture {} ends in a truncated event; it was not read", path);
+    if (truncated) *truncated = cut;
+    return true;
+}
+
+} // namespace rtes
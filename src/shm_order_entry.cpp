@@ -0,0 +1,648 @@
+#include "rtes/shm_order_entry.hpp"
+#include "rtes/client_directory.hpp"
+#include "rtes/error_handling.hpp"
+#include "rtes/instrument_directory.hpp"
+#include "rtes/logger.hpp"
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+namespace rtes {
+
+namespace {
+
+inline constexpr size_t   SHM_EXEC_BATCH      = 256;
+inline constexpr size_t   SHM_STATS_FLUSH     = 4096;     // Requests between stats publishes
+inline constexpr size_t   SHM_NAME_MAX        = 96;       // Fits the logon socket's abstract address
+inline constexpr uint64_t SHM_LOGON_INTERVAL  = 1 << 10;  // Busy poll passes between logon checks
+inline constexpr uint64_t SHM_REAP_INTERVAL   = 1 << 16;  // Poll passes between liveness checks
+inline constexpr uint64_t SHM_LOGON_TIMEOUT_NS = 1'000'000'000;  // Connected, no ShmLogon yet: dropped
+inline constexpr auto     SHM_ATTACH_TIMEOUT  = std::chrono::seconds(1);  // Client wait for the gateway's answer
+
+size_t session_bytes() {
+    return sizeof(ShmEntryHeader) + sizeof(ShmEntrySlot);
+}
+
+ShmEntrySlot* session_slot(void* map) {
+    return reinterpret_cast<ShmEntrySlot*>(static_cast<std::byte*>(map) + sizeof(ShmEntryHeader));
+}
+
+/**
+ * The gateway's logon socket. Abstract ("\0rtes_shm/<name>"): nothing on
+ * disk to go stale after a crash, and a second exchange on the same name
+ * fails to bind. Accepts the POSIX-shm spelling "/name" too.
+ */
+sockaddr_un logon_address(const std::string& name, socklen_t& length) {
+    const std::string path = "rtes_shm/" + (name.front() == '/' ? name.substr(1) : name);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path + 1, path.data(), path.size());  // sun_path[0] stays '\0'
+    length = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + 1 + path.size());
+    return addr;
+}
+
+/** One logon reply, with the session's memfd attached when `memfd` >= 0 */
+bool send_reply(int fd, ShmLogonReply& reply, int memfd) {
+    iovec iov{&reply, sizeof(reply)};
+    msghdr msg{};
+    msg.msg_iov    = &iov;
+    msg.msg_iovlen = 1;
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))]{};
+    if (memfd >= 0) {
+        msg.msg_control    = control;
+        msg.msg_controllen = sizeof(control);
+        cmsghdr* cmsg   = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type  = SCM_RIGHTS;
+        cmsg->cmsg_len   = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(cmsg), &memfd, sizeof(int));
+    }
+    return ::sendmsg(fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT) == static_cast<ssize_t>(sizeof(reply));
+}
+
+ShmResponse make_response(ShmResponseType type, OrderID order_id, Timestamp now) {
+    ShmResponse response{};
+    response.type         = type;
+    response.order_id     = order_id;
+    response.timestamp_ns = now;
+    return response;
+}
+
+} // namespace
+
+// ═══════════════════════════════════════════════════════════════
+//  Gateway (exchange process)
+// ═══════════════════════════════════════════════════════════════
+
+ShmGateway::ShmGateway(std::string shm_name, size_t clients, RiskManager* risk_manager,
+                       OrderPool* order_pool, GatewayReactor reactor)
+    : shm_name_(std::move(shm_name))
+    , slot_count_(clients)
+    , risk_shards_{risk_manager}
+    , order_pool_(order_pool)
+    , reactor_(reactor)
+    , sessions_(clients)
+    , order_routes_(order_pool ? order_pool->max_capacity() : 1)
+{
+    if (shm_name_.empty() || shm_name_.size() > SHM_NAME_MAX) {
+        throw std::invalid_argument("ShmGateway needs a name of 1 to 96 characters");
+    }
+    if (clients == 0 || clients > UINT16_MAX) throw std::invalid_argument("ShmGateway client slots out of range");
+    if (!risk_manager || !order_pool) throw std::invalid_argument("ShmGateway needs risk and an order pool");
+    execution_buffer_.resize(SHM_EXEC_BATCH);
+    request_buffer_.resize(MAX_BATCH_ENTRIES);
+    pending_.reserve(clients);
+}
+
+ShmGateway::~ShmGateway() {
+    stop();
+}
+
+void ShmGateway::set_risk_shards(std::vector<RiskManager*> shards) {
+    if (!shards.empty()) risk_shards_ = std::move(shards);
+}
+
+void ShmGateway::set_execution_queues(std::vector<SPSCQueue<ExecutionReport>*> queues) {
+    execution_queues_ = std::move(queues);
+}
+
+void ShmGateway::set_drop_copy(DropCopyServer* server) {
+    drop_copy_ = server && reactor_ < server->reactor_count() ? server->reactor_queue(reactor_) : nullptr;
+}
+
+void ShmGateway::start() {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return;
+
+    socklen_t length = 0;
+    const sockaddr_un addr = logon_address(shm_name_, length);
+    const int fd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::bind(fd, reinterpret_cast<const sockaddr*>(&addr), length) != 0 ||
+        ::listen(fd, static_cast<int>(std::min<size_t>(slot_count_, SOMAXCONN))) != 0) {
+        const int error = errno;
+        if (fd >= 0) ::close(fd);
+        running_.store(false);
+        throw std::runtime_error("Cannot listen for shared memory logons on " + shm_name_ + ": " +
+                                 std::strerror(error));
+    }
+    listen_fd_ = fd;
+    thread_ = std::thread(&ShmGateway::poll_loop, this);
+}
+
+void ShmGateway::stop() {
+    bool expected = true;
+    if (!running_.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) return;
+    if (thread_.joinable()) thread_.join();
+
+    for (Session& session : sessions_) {
+        if (!session.open) continue;
+        session.header->running.store(0, std::memory_order_release);
+        if (session_auth_) session_auth_->release(session.grant);
+        session.open = false;
+        unmap_session(session);
+    }
+    for (const PendingLogon& pending : pending_) ::close(pending.fd);
+    pending_.clear();
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+    flush_stats();
+}
+
+void ShmGateway::poll_loop() {
+    applied_placement_.store(apply_thread_placement(placement_, "shm_gateway"), std::memory_order_relaxed);
+
+    uint64_t passes = 0;
+    while (running_.load(std::memory_order_relaxed)) {
+        bool worked = false;
+        for (size_t s = 0; s < slot_count_; ++s) worked |= poll_slot(s);
+        const uint64_t received = local_stats_.requests_received;
+        drain_executions();
+
+        ++passes;
+        if (passes % SHM_REAP_INTERVAL == 0) reap_dead_clients();
+        if (worked || local_stats_.requests_received != received) {
+            idle_.on_work();
+            if (passes % SHM_LOGON_INTERVAL == 0) accept_logons();
+            if (local_stats_.requests_received - last_flush_at_ >= SHM_STATS_FLUSH) flush_stats();
+        } else {
+            if (local_stats_.requests_received != last_flush_at_) flush_stats();
+            accept_logons();  // Idle anyway: a logon waits no longer than one pass
+            idle_.idle([this] { return has_work(); });
+        }
+    }
+}
+
+/** One session's queued requests and detach. @return true if anything happened */
+bool ShmGateway::poll_slot(size_t s) {
+    Session& session = sessions_[s];
+    if (!session.open) return false;
+    const uint32_t state = session.slot->state.load(std::memory_order_acquire);
+    bool worked = take_requests(s) != 0;
+    if (state == SHM_SLOT_CLOSING) {
+        while (take_requests(s) != 0) {}
+        close_session(s, SessionEnd::DETACHED);
+        worked = true;
+    }
+    return worked;
+}
+
+/**
+ * Take new logon connections and read the ShmLogon of those that sent
+ * it. At most one connection per slot waits at a time; one that sends
+ * nothing within a second is dropped.
+ */
+void ShmGateway::accept_logons() {
+    const uint64_t now = now_timestamp();
+    while (pending_.size() < slot_count_) {
+        const int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) break;
+        pending_.push_back({fd, now + SHM_LOGON_TIMEOUT_NS});
+    }
+    for (size_t i = 0; i < pending_.size();) {
+        ShmLogon logon;
+        const ssize_t n = ::recv(pending_[i].fd, &logon, sizeof(logon), MSG_DONTWAIT);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && now < pending_[i].deadline_ns) {
+            ++i;
+            continue;
+        }
+        const int fd = pending_[i].fd;
+        pending_[i] = pending_.back();
+        pending_.pop_back();
+        if (n == static_cast<ssize_t>(sizeof(logon))) {
+            answer_logon(fd, logon);
+        } else {
+            ::close(fd);
+        }
+    }
+}
+
+/**
+ * Answer a logon as TcpGateway answers a LOGON: create the session's
+ * object and hand it over, or refuse. Under session auth the token must
+ * belong to the client it logs on as.
+ */
+void ShmGateway::answer_logon(int fd, ShmLogon& logon) {
+    ucred peer{};
+    socklen_t peer_length = sizeof(peer);
+    if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &peer, &peer_length) != 0) peer.pid = 0;
+
+    ClientID client = logon.client_id;
+    client.data[sizeof(client.data) - 1] = '\0';
+    size_t s = 0;
+    while (s < slot_count_ && sessions_[s].open) ++s;
+    Session* session = s < slot_count_ ? &sessions_[s] : nullptr;
+
+    const char* refusal = nullptr;
+    if (logon.magic != SHM_ENTRY_MAGIC || logon.version != SHM_ENTRY_VERSION) {
+        refusal = "protocol version mismatch";
+    } else if (client.empty()) {
+        refusal = "no client id";
+    } else if (!session) {
+        refusal = "every slot is taken";
+    } else if (session_auth_) {
+        const std::string_view token(logon.auth_token, ::strnlen(logon.auth_token, sizeof(logon.auth_token) - 1));
+        if (!session_auth_->authenticate(token, session->grant, std::string_view(client.c_str()))) {
+            ++local_stats_.auth_rejects;
+            refusal = "authentication failed";
+        }
+    }
+    std::memset(logon.auth_token, 0, sizeof(logon.auth_token));
+    if (!refusal) {
+        // Requests carry the directory id only; without a directory, risk's resolves it
+        session->client     = client;
+        session->client_raw = client_directory_ ? client_directory_->resolve(client)
+                                                : risk_shards_[0]->resolve_client(client);
+        if (client_directory_ && session->client_raw == 0) refusal = "client capacity exceeded";
+    }
+    const int memfd = refusal ? -1 : create_session(s, static_cast<uint32_t>(peer.pid));
+    if (!refusal && memfd < 0) refusal = "cannot create the session";
+
+    ShmLogonReply reply;
+    reply.accepted = refusal ? 0 : 1;
+    if (refusal) std::strncpy(reply.reason, refusal, sizeof(reply.reason) - 1);
+    const bool sent = send_reply(fd, reply, memfd);
+    if (memfd >= 0) ::close(memfd);  // The strategy holds its own descriptor now
+    if (!refusal && !sent) refusal = "logon socket closed";
+
+    if (refusal) [[unlikely]] {
+        if (session) {
+            if (session_auth_) session_auth_->release(session->grant);
+            unmap_session(*session);
+        }
+        LOG_WARN("Shared memory order entry: logon of {} (pid {}) refused: {}",
+                 client.c_str(), peer.pid, refusal);
+        ::close(fd);
+        return;
+    }
+
+    session->conn = fd;
+    session->open = true;
+    ++session->generation;
+    ++local_stats_.sessions_opened;
+    LOG_INFO("Shared memory order entry: slot {} opened for {} (pid {})", s, client.c_str(), peer.pid);
+}
+
+/**
+ * Create and map slot `s`'s object for a new session. Sealed at its size:
+ * the strategy's descriptor cannot shrink it under the gateway's mapping.
+ * @return the memfd to hand over, or -1
+ */
+int ShmGateway::create_session(size_t s, uint32_t pid) {
+    const size_t size = session_bytes();
+    const int fd = ::memfd_create("rtes_shm_session", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) return -1;
+    void* map = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(size)) == 0 &&
+        ::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == 0) {
+        map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+    }
+    if (map == MAP_FAILED) {
+        LOG_ERROR("Shared memory order entry: cannot create a session: {}", std::strerror(errno));
+        ::close(fd);
+        return -1;
+    }
+#ifdef MADV_HUGEPAGE
+    ::madvise(map, size, MADV_HUGEPAGE);  // Honoured when shmem THP is enabled; rings are hot on both sides
+#endif
+
+    Session& session = sessions_[s];
+    session.header = new (map) ShmEntryHeader{};
+    session.slot   = new (session_slot(map)) ShmEntrySlot{};
+    session.header->slot        = static_cast<uint32_t>(s);
+    session.header->gateway_pid = static_cast<uint32_t>(::getpid());
+    session.slot->pid           = pid;
+    session.slot->client_id     = session.client;
+    session.header->running.store(1, std::memory_order_release);
+    return fd;
+}
+
+void ShmGateway::close_session(size_t s, SessionEnd end) {
+    Session& session = sessions_[s];
+    if (cancel_on_disconnect_ && !session.client.empty() &&
+        !risk_for(session.client_raw)->submit_mass_cancel(session.client, Symbol{}, risk_lane_,
+                                                          session.client_raw)) [[unlikely]] {
+        LOG_WARN("Cancel-on-disconnect for {} dropped: risk queue full", session.client.c_str());
+    }
+    session.open = false;  // Reports for its orders are dropped from here on
+    if (session_auth_) session_auth_->release(session.grant);
+    if (end == SessionEnd::SLOW_CONSUMER) {
+        ++local_stats_.slow_consumers;
+        LOG_WARN("Shared memory order entry: slot {} closed for {}: response ring full (slow consumer)",
+                 s, session.client.c_str());
+        // The strategy keeps its mapping and sees CLOSED (unless it detached meanwhile)
+        uint32_t expected = SHM_SLOT_ACTIVE;
+        (void)session.slot->state.compare_exchange_strong(expected, SHM_SLOT_CLOSED, std::memory_order_acq_rel);
+    } else {
+        if (end == SessionEnd::REAPED) ++local_stats_.sessions_reaped;
+        LOG_INFO("Shared memory order entry: slot {} closed for {}{}", s, session.client.c_str(),
+                 end == SessionEnd::REAPED ? " (process gone)" : "");
+    }
+    unmap_session(session);
+}
+
+/** Drop the gateway's mapping and logon socket; the slot index is free for the next logon. */
+void ShmGateway::unmap_session(Session& session) {
+    if (session.header) ::munmap(session.header, session_bytes());
+    if (session.conn >= 0) ::close(session.conn);
+    session.header = nullptr;
+    session.slot   = nullptr;
+    session.conn   = -1;
+}
+
+/**
+ * A strategy that died without detaching leaves its session ACTIVE, but
+ * the kernel closes its end of the logon socket: close the session for it.
+ */
+void ShmGateway::reap_dead_clients() {
+    for (size_t s = 0; s < slot_count_; ++s) {
+        Session& session = sessions_[s];
+        if (!session.open) continue;
+        char byte;
+        const ssize_t n = ::recv(session.conn, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+        if (n > 0 || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))) continue;
+        // Detached first, then exited: poll_slot() closes that one
+        if (session.slot->state.load(std::memory_order_acquire) == SHM_SLOT_CLOSING) continue;
+        while (take_requests(s) != 0) {}
+        close_session(s, SessionEnd::REAPED);
+    }
+}
+
+/**
+ * Stage up to one BATCH worth of a session's requests and hand them to
+ * its risk shard with one enqueue, through the same BatchStager as a TCP
+ * BATCH frame. Requests carry no client: they trade as the logon client.
+ * Takes no more than the response ring can answer, so every request gets
+ * its ack. @return requests taken
+ */
+size_t ShmGateway::take_requests(size_t s) {
+    Session& session = sessions_[s];
+    ShmEntrySlot& slot = *session.slot;
+    const size_t room  = std::min<size_t>(slot.responses.free_space(), MAX_BATCH_ENTRIES);
+    const size_t count = slot.requests.pop(request_buffer_.data(), room);
+    if (count == 0) return 0;
+
+    BatchSender sender;
+    sender.client_id     = &session.client;
+    sender.client_raw    = session.client_raw;
+    sender.request_owner = session.client_raw;
+    sender.permissions   = session_auth_ ? session_auth_->permissions(session.grant) : ~0u;
+    sender.ingress       = reactor_;
+    sender.now           = now_timestamp();
+    batch_.stage(request_buffer_.data(), count, sender, instrument_directory_, *order_pool_,
+                 &order_routes_, {static_cast<uint32_t>(s), session.generation, session.client_raw});
+    (void)batch_.submit(*risk_for(session.client_raw), risk_lane_, *order_pool_, &order_routes_);
+    local_stats_.pool_exhausted     += batch_.counts().pool_exhausted;
+    local_stats_.reports_unroutable += batch_.counts().unroutable;
+    local_stats_.requests_rejected  += batch_.counts().rejected;
+    local_stats_.auth_rejects       += batch_.counts().not_permitted;
+
+    for (size_t i = 0; i < count; ++i) {
+        ShmResponse ack = make_response(SHM_ACK, request_buffer_[i].order_id, sender.now);
+        ack.action = request_buffer_[i].action;
+        ack.reason = batch_.reason(i);
+        if (ack.reason != BATCH_OK) ack.status = static_cast<uint8_t>(OrderStatus::REJECTED);
+        (void)slot.responses.push(ack);  // Room reserved above
+    }
+    local_stats_.requests_received += count;
+    return count;
+}
+
+bool ShmGateway::has_work() const {
+    for (auto* queue : execution_queues_) {
+        if (!queue->consumer_empty()) return true;
+    }
+    for (const Session& session : sessions_) {
+        if (session.open && (session.slot->state.load(std::memory_order_relaxed) != SHM_SLOT_ACTIVE ||
+                             !session.slot->requests.empty())) {
+            return true;
+        }
+    }
+    return !running_.load(std::memory_order_relaxed);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Execution Reports (engines/risk → this reactor → slot)
+// ═══════════════════════════════════════════════════════════════
+
+void ShmGateway::drain_executions() {
+    for (auto* queue : execution_queues_) {
+        size_t count;
+        do {
+            count = queue->try_pop_bulk(execution_buffer_.data(), SHM_EXEC_BATCH);
+            for (size_t i = 0; i < count; ++i) route_execution(execution_buffer_[i]);
+        } while (count == SHM_EXEC_BATCH);
+    }
+}
+
+void ShmGateway::route_execution(const ExecutionReport& report) {
+    switch (report.type) {
+        case ExecutionReport::FILL: {
+            // Each side of the fill that is ours gets its own response
+            ShmResponse fill = make_response(SHM_FILL, 0, report.fill.timestamp);
+            fill.trade_id = report.fill.id;
+            fill.quantity = report.fill.quantity;
+            fill.price    = report.fill.price;
+            if (report.reactor == reactor_) {
+                fill.order_id = report.fill.buy_order_id;
+                fill.side     = static_cast<uint8_t>(Side::BUY);
+                const OrderRoute* route = order_routes_.find(fill.order_id);
+                respond(route, fill);
+                if (drop_copy_) publish_drop_copy(report, route, Side::BUY);
+            }
+            if (report.sell_reactor == reactor_) {
+                fill.order_id = report.fill.sell_order_id;
+                fill.side     = static_cast<uint8_t>(Side::SELL);
+                const OrderRoute* route = order_routes_.find(fill.order_id);
+                respond(route, fill);
+                if (drop_copy_) publish_drop_copy(report, route, Side::SELL);
+            }
+            break;
+        }
+        case ExecutionReport::DONE: {
+            ShmResponse done = make_response(SHM_DONE, report.order.order_id, now_timestamp());
+            done.status   = static_cast<uint8_t>(report.status);
+            done.quantity = report.order.filled_quantity;
+            const OrderRoute* route = order_routes_.find(done.order_id);
+            respond(route, done);
+            if (drop_copy_) publish_drop_copy(report, route);
+            order_routes_.erase(done.order_id);
+            break;
+        }
+        case ExecutionReport::REJECTED: {
+            ShmResponse reject = make_response(SHM_REJECT, report.order.order_id, now_timestamp());
+            reject.status = static_cast<uint8_t>(OrderStatus::REJECTED);
+            reject.error  = static_cast<uint16_t>(report.reason);
+            const OrderRoute* route = order_routes_.find(reject.order_id);
+            respond(route, reject);
+            if (drop_copy_) publish_drop_copy(report, route);
+            order_routes_.erase(reject.order_id);
+            break;
+        }
+    }
+}
+
+/**
+ * Push to the route's slot if the client that sent the order is still
+ * attached. A full ring closes the session, as TcpGateway drops a slow
+ * consumer: a strategy must not keep trading on reports it never got.
+ */
+void ShmGateway::respond(const OrderRoute* route, const ShmResponse& response) {
+    if (!route) {
+        ++local_stats_.reports_unroutable;
+        return;
+    }
+    const Session& session = sessions_[route->slot];
+    if (!session.open || session.generation != route->generation) return;
+    if (!session.slot->responses.push(response)) [[unlikely]] {
+        close_session(route->slot, SessionEnd::SLOW_CONSUMER);
+    }
+}
+
+/**
+ * Copy a report to drop copy under the route's firm, whether or not the
+ * strategy is still attached: post-trade consumers get every outcome.
+ */
+void ShmGateway::publish_drop_copy(const ExecutionReport& report, const OrderRoute* route, Side side) {
+    if (!route || route->client == 0) return;
+    DropCopyRecord record;
+    record.report = report;
+    record.client = route->client;
+    record.side   = side;
+    if (!drop_copy_->push(record)) [[unlikely]] ++local_stats_.drop_copy_overflows;
+}
+
+void ShmGateway::flush_stats() {
+    last_flush_at_ = local_stats_.requests_received;
+    stats_atomic_.sessions_opened.store(local_stats_.sessions_opened, std::memory_order_relaxed);
+    stats_atomic_.sessions_reaped.store(local_stats_.sessions_reaped, std::memory_order_relaxed);
+    stats_atomic_.requests_received.store(local_stats_.requests_received, std::memory_order_relaxed);
+    stats_atomic_.requests_rejected.store(local_stats_.requests_rejected, std::memory_order_relaxed);
+    stats_atomic_.slow_consumers.store(local_stats_.slow_consumers, std::memory_order_relaxed);
+    stats_atomic_.auth_rejects.store(local_stats_.auth_rejects, std::memory_order_relaxed);
+    stats_atomic_.drop_copy_overflows.store(local_stats_.drop_copy_overflows, std::memory_order_relaxed);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Client (strategy process)
+// ═══════════════════════════════════════════════════════════════
+
+std::unique_ptr<ShmOrderEntryClient> ShmOrderEntryClient::attach(const std::string& shm_name,
+                                                                 const ClientID& client_id,
+                                                                 std::string_view auth_token) {
+    if (shm_name.empty() || shm_name.size() > SHM_NAME_MAX || client_id.empty() ||
+        auth_token.size() >= sizeof(ShmLogon::auth_token)) {
+        return nullptr;
+    }
+    const int conn = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (conn < 0) return nullptr;
+
+    ShmLogon logon;
+    logon.client_id = client_id;
+    std::memcpy(logon.auth_token, auth_token.data(), auth_token.size());
+    socklen_t length = 0;
+    const sockaddr_un addr = logon_address(shm_name, length);
+
+    // The gateway answers within a poll pass or two; an accepted logon carries the session's memfd
+    ShmLogonReply reply;
+    iovec iov{&reply, sizeof(reply)};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))]{};
+    msghdr msg{};
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+    const timeval timeout{std::chrono::seconds(SHM_ATTACH_TIMEOUT).count(), 0};
+    int memfd = -1;
+    if (::setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0 &&
+        ::connect(conn, reinterpret_cast<const sockaddr*>(&addr), length) == 0 &&
+        ::send(conn, &logon, sizeof(logon), MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(logon)) &&
+        ::recvmsg(conn, &msg, MSG_CMSG_CLOEXEC) == static_cast<ssize_t>(sizeof(reply))) {
+        const cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            std::memcpy(&memfd, CMSG_DATA(cmsg), sizeof(int));
+        }
+    }
+    std::memset(logon.auth_token, 0, sizeof(logon.auth_token));
+
+    const size_t size = session_bytes();
+    void* map = MAP_FAILED;
+    if (memfd >= 0) {
+        struct stat st{};
+        if (reply.accepted && ::fstat(memfd, &st) == 0 && static_cast<size_t>(st.st_size) == size) {
+            map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, memfd, 0);
+        }
+        ::close(memfd);
+    }
+    if (map == MAP_FAILED) {
+        ::close(conn);  // Refused, unanswered or no gateway: one answered later sees the socket closed
+        return nullptr;
+    }
+    const auto* header = static_cast<const ShmEntryHeader*>(map);
+    if (header->magic != SHM_ENTRY_MAGIC || header->version != SHM_ENTRY_VERSION ||
+        header->slot_size != sizeof(ShmEntrySlot)) {
+        ::munmap(map, size);
+        ::close(conn);
+        return nullptr;
+    }
+    return std::unique_ptr<ShmOrderEntryClient>(new ShmOrderEntryClient(conn, map, size));
+}
+
+ShmOrderEntryClient::ShmOrderEntryClient(int conn, void* map, size_t map_size)
+    : conn_(conn)
+    , map_(map)
+    , map_size_(map_size)
+    , header_(static_cast<ShmEntryHeader*>(map))
+    , slot_(session_slot(map))
+{}
+
+ShmOrderEntryClient::~ShmOrderEntryClient() {
+    // CLOSED: the gateway already dropped the session, and only this mapping is left
+    uint32_t expected = SHM_SLOT_ACTIVE;
+    (void)slot_->state.compare_exchange_strong(expected, SHM_SLOT_CLOSING, std::memory_order_acq_rel);
+    ::munmap(map_, map_size_);
+    ::close(conn_);
+}
+
+bool ShmOrderEntryClient::new_order(OrderID order_id, InstrumentID instrument, Side side, OrderType type,
+                                    Quantity quantity, Price price, Quantity display_quantity,
+                                    Price stop_price) {
+    BatchEntryV2 entry{};
+    entry.action           = BATCH_NEW_ORDER;
+    entry.side             = static_cast<uint8_t>(side);
+    entry.order_type       = static_cast<uint8_t>(type);
+    entry.instrument       = instrument;
+    entry.order_id         = order_id;
+    entry.quantity         = static_cast<uint32_t>(quantity);
+    entry.display_quantity = static_cast<uint32_t>(display_quantity);
+    entry.price            = price;
+    entry.stop_price       = stop_price;
+    return send(entry);
+}
+
+bool ShmOrderEntryClient::cancel(OrderID order_id) {
+    BatchEntryV2 entry{};
+    entry.action   = BATCH_CANCEL_ORDER;
+    entry.order_id = order_id;
+    return send(entry);
+}
+
+bool ShmOrderEntryClient::modify(OrderID order_id, Quantity new_quantity, Price new_price) {
+    BatchEntryV2 entry{};
+    entry.action   = BATCH_MODIFY_ORDER;
+    entry.order_id = order_id;
+    entry.quantity = static_cast<uint32_t>(new_quantity);
+    entry.price    = new_price;
+    return send(entry);
+}
+
+} // namespace rtes
@@ -0,0 +1,138 @@
+#include "rtes/snapshot_publisher.hpp"
+#include "rtes/logger.hpp"
+
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace rtes {
+
+inline constexpr Timestamp SNAPSHOT_SLEEP_STEP_NS = 1'000'000;  // stop() latency bound
+inline constexpr Timestamp SNAPSHOT_PACE_WAIT_NS  = 100'000;    // Retry step when out of tokens
+inline constexpr int       SNAPSHOT_TTL           = 1;
+
+SnapshotPublisher::SnapshotPublisher(const std::string& group, uint16_t port,
+                                     std::vector<SnapshotSource> sources)
+    : sources_(std::move(sources))
+{
+    dest_.sin_family = AF_INET;
+    dest_.sin_port   = htons(port);
+    inet_pton(AF_INET, group.c_str(), &dest_.sin_addr);
+}
+
+SnapshotPublisher::~SnapshotPublisher() {
+    stop();
+}
+
+bool SnapshotPublisher::set_authentication(std::string_view key) {
+    auto auth = std::make_unique<DatagramAuthenticator>(key);
+    if (!auth->ready()) return false;
+    auth_ = std::move(auth);
+    return true;
+}
+
+void SnapshotPublisher::start() {
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return;
+
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        running_.store(false);
+        throw std::runtime_error("Failed to start snapshot publisher");
+    }
+    socket_fd_.reset(fd);
+    int ttl = SNAPSHOT_TTL;
+    setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+
+    thread_ = std::thread(&SnapshotPublisher::run, this);
+    LOG_INFO("Snapshot channel: {} books, {} bytes/s, cycle every {} ms",
+             sources_.size(), rate_, interval_ms_);
+}
+
+void SnapshotPublisher::stop() {
+    bool expected = true;
+    if (!running_.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) return;
+    if (thread_.joinable()) thread_.join();
+    socket_fd_.close();
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Publisher Thread
+// ═══════════════════════════════════════════════════════════════
+
+void SnapshotPublisher::run() {
+    constexpr size_t datagram = sizeof(UdpPacketHeader) + sizeof(DepthSnapshotMessage);
+    const TokenBucketLimit limit(rate_, 1'000'000'000, std::max<uint64_t>(rate_ / 10, datagram));
+    TokenBucket bucket;
+    uint8_t buffer[datagram + MD_AUTH_TAG_BYTES];
+
+    while (running_.load(std::memory_order_relaxed)) {
+        const Timestamp cycle_start = now_timestamp();
+        for (size_t i = 0; i < sources_.size(); ++i) {
+            DepthSnapshot depth;
+            if (!sources_[i].engine->read_depth(depth, sources_[i].book)) {
+                books_skipped_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            size_t length = build_snapshot(sources_[i], static_cast<uint32_t>(i), depth, buffer);
+            if (auth_) length = auth_->sign(buffer, length);
+
+            while (rate_ != 0 && !limit.try_consume(bucket, now_timestamp(), length)) {
+                if (!sleep_until(now_timestamp() + SNAPSHOT_PACE_WAIT_NS)) return;
+            }
+            sendto(socket_fd_.get(), buffer, length, 0,
+                   reinterpret_cast<const sockaddr*>(&dest_), sizeof(dest_));
+            snapshots_sent_.fetch_add(1, std::memory_order_relaxed);
+        }
+        cycles_.fetch_add(1, std::memory_order_relaxed);
+        if (!sleep_until(cycle_start + Timestamp{interval_ms_} * 1'000'000)) return;
+    }
+}
+
+/** One datagram: a UdpPacketHeader and one DepthSnapshotMessage. @return its length */
+size_t SnapshotPublisher::build_snapshot(const SnapshotSource& source, uint32_t index,
+                                         const DepthSnapshot& depth, uint8_t* out) {
+    const uint64_t seq = next_sequence_++;
+    DepthSnapshotMessage msg;
+    msg.header = UdpMessageHeader(DEPTH_SNAPSHOT, sizeof(DepthSnapshotMessage), seq, depth.timestamp_ns);
+    static_assert(sizeof(msg.symbol) == sizeof(source.symbol.data));
+    std::memcpy(msg.symbol, source.symbol.data, sizeof(msg.symbol));
+    msg.update_sequence = depth.update_sequence;
+    msg.book_index      = index;
+    msg.book_count      = static_cast<uint32_t>(sources_.size());
+    msg.channel         = source.channel;
+
+    const size_t bids = std::min(depth.bid_levels, MAX_DEPTH_LEVELS);
+    const size_t asks = std::min(depth.ask_levels, MAX_DEPTH_LEVELS);
+    for (size_t i = 0; i < bids; ++i) {
+        msg.levels[i] = {depth.bids[i].price, depth.bids[i].quantity, depth.bids[i].order_count};
+    }
+    for (size_t i = 0; i < asks; ++i) {
+        msg.levels[bids + i] = {depth.asks[i].price, depth.asks[i].quantity, depth.asks[i].order_count};
+    }
+    msg.num_bid_levels = static_cast<uint8_t>(bids);
+    msg.num_ask_levels = static_cast<uint8_t>(asks);
+
+    UdpPacketHeader packet{};
+    packet.sequence      = seq;
+    packet.message_count = 1;
+    packet.length        = static_cast<uint16_t>(sizeof(packet) + sizeof(msg));
+    std::memcpy(out, &packet, sizeof(packet));
+    std::memcpy(out + sizeof(packet), &msg, sizeof(msg));
+    return packet.length;
+}
+
+bool SnapshotPublisher::sleep_until(Timestamp deadline) {
+    for (;;) {
+        if (!running_.load(std::memory_order_relaxed)) return false;
+        const Timestamp now = now_timestamp();
+        if (now >= deadline) return true;
+        std::this_thread::sleep_for(
+            std::chrono::nanoseconds(std::min(deadline - now, SNAPSHOT_SLEEP_STEP_NS)));
+    }
+}
+
+} // namespace rtes
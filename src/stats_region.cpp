@@ -0,0 +1,159 @@
+#include "rtes/stats_region.hpp"
+#include "rtes/logger.hpp"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <new>
+
+namespace rtes {
+
+namespace {
+
+size_t region_bytes(size_t capacity) {
+    return sizeof(StatsRegionHeader) + capacity * sizeof(StatsBlock);
+}
+
+/** POSIX shm names are "/name"; accept either spelling */
+std::string shm_path(const std::string& name) {
+    return name.front() == '/' ? name : "/" + name;
+}
+
+/** Creator of an existing region; 0 if it is gone, -1 if unreadable (assume live) */
+pid_t region_owner(const std::string& path) {
+    const int fd = ::shm_open(path.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) return errno == ENOENT ? 0 : -1;
+    struct stat st{};
+    void* map = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(StatsRegionHeader)) {
+        map = ::mmap(nullptr, sizeof(StatsRegionHeader), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (map == MAP_FAILED) return -1;
+    const auto* header = static_cast<const StatsRegionHeader*>(map);
+    const pid_t owner = header->magic == STATS_REGION_MAGIC ? header->owner_pid : -1;
+    ::munmap(map, sizeof(StatsRegionHeader));
+    if (owner > 0 && ::kill(owner, 0) < 0 && errno == ESRCH) return 0;
+    return owner > 0 ? owner : -1;
+}
+
+} // namespace
+
+std::unique_ptr<StatsRegion> StatsRegion::create(size_t capacity, const std::string& shm_name) {
+    capacity = std::max<size_t>(capacity, 1);
+    const size_t size = region_bytes(capacity);
+
+    void* map = MAP_FAILED;
+    if (shm_name.empty()) {
+        map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    } else {
+        const std::string path = shm_path(shm_name);
+        int fd = ::shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        if (fd < 0 && errno == EEXIST) {
+            // Only a dead creator's region is replaced: a live one's readers keep theirs
+            if (const pid_t owner = region_owner(path); owner != 0) {
+                LOG_ERROR("Stats region {} is in use (process {}); remove it if that is stale",
+                          path, owner);
+                return nullptr;
+            }
+            ::shm_unlink(path.c_str());
+            fd = ::shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+        }
+        if (fd < 0) {
+            LOG_ERROR("Cannot create stats region {}: {}", path, std::strerror(errno));
+            return nullptr;
+        }
+        if (::ftruncate(fd, static_cast<off_t>(size)) == 0) {
+            map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        }
+        const int error = errno;
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            LOG_ERROR("Cannot map stats region {}: {}", path, std::strerror(error));
+            ::shm_unlink(path.c_str());
+            return nullptr;
+        }
+    }
+    if (map == MAP_FAILED) {
+        LOG_ERROR("Cannot map stats region: {}", std::strerror(errno));
+        return nullptr;
+    }
+
+    auto* header = new (map) StatsRegionHeader{};
+    header->capacity        = static_cast<uint32_t>(capacity);
+    header->owner_pid       = ::getpid();
+    header->created_unix_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    return std::unique_ptr<StatsRegion>(new StatsRegion(map, size, shm_name, true));
+}
+
+std::unique_ptr<StatsRegion> StatsRegion::open(const std::string& shm_name) {
+    if (shm_name.empty()) return nullptr;
+    const std::string path = shm_path(shm_name);
+    const int fd = ::shm_open(path.c_str(), O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0) return nullptr;
+
+    struct stat st{};
+    void* map = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(StatsRegionHeader)) {
+        map = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    ::close(fd);
+    if (map == MAP_FAILED) return nullptr;
+
+    const auto* header = static_cast<const StatsRegionHeader*>(map);
+    const size_t size = static_cast<size_t>(st.st_size);
+    if (header->magic != STATS_REGION_MAGIC || header->version != STATS_REGION_VERSION ||
+        header->block_size != sizeof(StatsBlock) || region_bytes(header->capacity) > size) {
+        LOG_WARN("Stats region {} has an unknown layout", path);
+        ::munmap(map, size);
+        return nullptr;
+    }
+    return std::unique_ptr<StatsRegion>(new StatsRegion(map, size, shm_name, false));
+}
+
+StatsRegion::StatsRegion(void* map, size_t map_size, std::string shm_name, bool owner)
+    : header_(static_cast<StatsRegionHeader*>(map))
+    , blocks_(reinterpret_cast<StatsBlock*>(static_cast<std::byte*>(map) + sizeof(StatsRegionHeader)))
+    , map_(map)
+    , map_size_(map_size)
+    , shm_name_(std::move(shm_name))
+    , owner_(owner)
+{}
+
+StatsRegion::~StatsRegion() {
+    ::munmap(map_, map_size_);
+    if (owner_ && !shm_name_.empty()) ::shm_unlink(shm_path(shm_name_).c_str());
+}
+
+StatsBlock* StatsRegion::add(std::string_view name, StatsKind kind) {
+    const uint32_t used = header_->blocks.load(std::memory_order_relaxed);
+    if (!owner_ || used >= header_->capacity) return nullptr;
+
+    auto* block = new (&blocks_[used]) StatsBlock{};
+    std::memcpy(block->name, name.data(), std::min(name.size(), sizeof(block->name) - 1));
+    block->kind = kind;
+    header_->blocks.store(used + 1, std::memory_order_release);
+    return block;
+}
+
+std::vector<StatsSample> StatsRegion::snapshot() const {
+    const size_t used = std::min<size_t>(header_->blocks.load(std::memory_order_acquire), header_->capacity);
+    std::vector<StatsSample> samples(used);
+    for (size_t i = 0; i < used; ++i) {
+        const StatsBlock& block = blocks_[i];
+        StatsSample& sample = samples[i];
+        sample.name.assign(block.name, strnlen(block.name, sizeof(block.name)));
+        sample.kind       = block.kind;
+        sample.consistent = block.counters.read(sample.counters);
+    }
+    return samples;
+}
+
+} // namespace rtes
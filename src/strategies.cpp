@@ -15,8 +15,8 @@ void MarketMakerStrategy::on_start() {
 }
 
 void MarketMakerStrategy::on_tick() {
-    // Update quotes periodically
-    if (random_int(1, 1000) <= 10) {  // 1% chance per tick
+    // Update quotes periodically, and right after being hit
+    if (requote_.exchange(false) || random_int(1, 1000) <= 10) {  // 1% chance per tick
         update_quotes();
     }
 }
@@ -35,10 +35,8 @@ void MarketMakerStrategy::on_trade(const TradeMessage& trade) {
     // Adjust base price based on trades
     base_price_ = trade.price;
     
-    // Cancel and replace quotes after being hit
-    cancel_existing_orders();
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    update_quotes();
+    // Cancel and replace quotes after being hit (next tick: never block the receiver)
+    requote_.store(true);
 }
 
 void MarketMakerStrategy::update_quotes() {
@@ -5,14 +5,17 @@
 #include "rtes/thread_safety.hpp"
 
 #include <sys/socket.h>
-#include <poll.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <fcntl.h>
+#include <sched.h>
+#include <time.h>
 #include <unistd.h>
 #include <cerrno>
 #include <cstring>
 #include <algorithm>
+#include <chrono>
+#include <string>
 
 // --- Cross-Platform Networking Macros (macOS vs Linux) ---
 #ifdef __APPLE__
@@ -24,25 +27,150 @@
 
 #else
     #include <sys/epoll.h>
+    #include <sys/ioctl.h>
+    #include <linux/tls.h>
+    #ifndef SO_PREFER_BUSY_POLL
+        #define SO_PREFER_BUSY_POLL 69
+    #endif
+    #ifndef EPIOCSPARAMS
+        // Per-epoll busy poll (Linux 6.9+); older headers lack it
+        struct epoll_params {
+            uint32_t busy_poll_usecs;
+            uint16_t busy_poll_budget;
+            uint8_t  prefer_busy_poll;
+            uint8_t  pad;
+        };
+        #define EPIOCSPARAMS _IOW(0x8A, 0x01, struct epoll_params)
+    #endif
 #endif
 
 namespace rtes {
 
-inline constexpr size_t MAX_CONNECTIONS      = 1024;
 inline constexpr size_t MAX_MESSAGE_SIZE     = 4096;
 inline constexpr size_t EPOLL_MAX_EVENTS     = 64;
 inline constexpr size_t STATS_FLUSH_INTERVAL = 4096;
 inline constexpr int    EPOLL_TIMEOUT_MS     = 10;
-inline constexpr int    ACCEPT_POLL_MS       = 50;
+inline constexpr size_t MAX_REACTORS         = size_t{UINT8_MAX} + 1;  // GatewayReactor range
 inline constexpr int    LISTEN_BACKLOG       = 128;
+inline constexpr size_t EXEC_BATCH_SIZE      = 256;
+inline constexpr unsigned URING_ENTRIES      = 1024;
+inline constexpr auto     URING_DRAIN_TIMEOUT = std::chrono::seconds(1);  // stop(): in-flight ops to complete
+static_assert(ReadBuffer::MIN_FREE >= MAX_MESSAGE_SIZE, "make_room() must fit a whole frame");
+static_assert(SESSION_CAPTURE_MAX_FRAME >= MAX_MESSAGE_SIZE, "session capture must take every frame whole");
+
+// io_uring user_data: [op:32][fd:32], or [op:32][connection:32] for RECV / SEND
+enum UringOp : uint64_t {
+    URING_ACCEPT = 1,
+    URING_RECV,
+    URING_SEND,
+    URING_DOORBELL,
+    URING_CANCEL
+};
+
+inline uint64_t uring_data(UringOp op, uint32_t target) {
+    return (static_cast<uint64_t>(op) << 32) | target;
+}
+
+// Poller event key: a listen / doorbell fd, or [1][generation:31][connection:32]
+inline constexpr uint64_t CONNECTION_EVENT = uint64_t{1} << 63;
+
+inline uint64_t connection_key(const ConnectionState& conn) {
+    return CONNECTION_EVENT | (static_cast<uint64_t>(conn.generation & 0x7FFFFFFF) << 32) | conn.id;
+}
+
+/** The connection an event key names, nullptr if it closed since the key was armed */
+inline ConnectionState* connection_of(ConnectionSlab& slab, uint64_t key) {
+    ConnectionState& conn = slab[static_cast<ConnectionID>(key)];
+    const bool live = conn.in_use && (conn.generation & 0x7FFFFFFF) == ((key >> 32) & 0x7FFFFFFF);
+    return live ? &conn : nullptr;
+}
+
+/** Kernel receive timestamps (SO_TIMESTAMPNS) are CLOCK_REALTIME. */
+inline uint64_t realtime_ns() {
+    timespec ts{};
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/** TLS record content type of application data (RFC 8446, 5.1) */
+inline constexpr uint8_t TLS_RECORD_APPLICATION_DATA = 23;
+
+/**
+ * recv() into the read buffer, also returning when the kernel received
+ * the data (SO_TIMESTAMPNS cmsg; now if the socket gave none). On a kTLS
+ * socket the kernel adds each record's type; only a non-data record
+ * (alert, KeyUpdate) ends the session.
+ */
+ssize_t recv_stamped(int fd, ReadBuffer& buf, uint64_t& rx_ns) {
+#ifdef __linux__
+    iovec iov{buf.write_ptr(), buf.remaining()};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(timespec)) + CMSG_SPACE(sizeof(uint8_t))];
+    msghdr msg{};
+    msg.msg_iov        = &iov;
+    msg.msg_iovlen     = 1;
+    msg.msg_control    = control;
+    msg.msg_controllen = sizeof(control);
+    const ssize_t bytes = recvmsg(fd, &msg, 0);
+    rx_ns = 0;
+    if (bytes > 0) {
+        for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+            if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPNS) {
+                timespec ts;
+                std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                rx_ns = static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL +
+                        static_cast<uint64_t>(ts.tv_nsec);
+            }
+#ifdef TLS_GET_RECORD_TYPE
+            if (c->cmsg_level == SOL_TLS && c->cmsg_type == TLS_GET_RECORD_TYPE &&
+                *CMSG_DATA(c) != TLS_RECORD_APPLICATION_DATA) [[unlikely]] {
+                errno = EIO;
+                return -1;
+            }
+#endif
+        }
+    }
+    if (rx_ns == 0) rx_ns = realtime_ns();
+    return bytes;
+#else
+    rx_ns = realtime_ns();
+    return recv(fd, buf.write_ptr(), buf.remaining(), 0);
+#endif
+}
+
+// OrderAckMessage::status
+inline constexpr uint8_t ACK_ACCEPTED  = 1;
+inline constexpr uint8_t ACK_REJECTED  = 2;
+inline constexpr uint8_t ACK_CANCELLED = 3;
+inline constexpr uint8_t ACK_FILLED    = 4;
+
+GatewayBackend parse_gateway_backend(std::string_view name) {
+    return name == "io_uring" ? GatewayBackend::IO_URING : GatewayBackend::EPOLL;
+}
 
 // ═══════════════════════════════════════════════════════════════
 //  ConnectionState Implementation
 // ═══════════════════════════════════════════════════════════════
 
-ConnectionState::ConnectionState(int raw_fd)
-    : fd(raw_fd), connect_time(now_timestamp())
-{
+void ConnectionState::reopen(int raw_fd) {
+    fd.reset(raw_fd);
+    ++generation;
+    read_buf.clear();
+    write_buf.clear();
+    flush_queued      = false;
+    closing           = false;
+    recv_armed        = false;
+    send_inflight     = false;
+    retiring          = false;
+    tls               = nullptr;
+    client_id         = ClientID{};
+    client_raw        = 0;
+    session           = 0;
+    protocol          = PROTOCOL_V1;
+    authenticated     = false;
+    grant             = SessionGrant{};
+    connected         = true;
+    connect_time      = now_timestamp();
+    messages_received = 0;
     setup_socket();
 }
 
@@ -63,16 +191,61 @@ void ConnectionState::setup_socket() {
 }
 
 void ConnectionState::disconnect() {
-    connected = false;
+    connected    = false;
+    flush_queued = false;  // Skipped if still on the reactor's flush list
     fd.close();
 }
 
+// ═══════════════════════════════════════════════════════════════
+//  ConnectionSlab Implementation
+// ═══════════════════════════════════════════════════════════════
+
+ConnectionSlab::ConnectionSlab(size_t capacity)
+    : region_(sizeof(ConnectionState) * capacity)
+    , slots_(static_cast<ConnectionState*>(region_.data()))
+    , capacity_(capacity)
+{
+    for (size_t i = 0; i < capacity_; ++i) {
+        new (&slots_[i]) ConnectionState();
+        slots_[i].id = static_cast<ConnectionID>(i);
+    }
+    free_.reserve(capacity_);
+    for (size_t i = capacity_; i-- > 0;) free_.push_back(static_cast<ConnectionID>(i));
+}
+
+ConnectionSlab::~ConnectionSlab() {
+    for (size_t i = 0; i < capacity_; ++i) slots_[i].~ConnectionState();
+}
+
+ConnectionState* ConnectionSlab::open(int fd) {
+    if (free_.empty()) [[unlikely]] return nullptr;
+    ConnectionState& conn = slots_[free_.back()];
+    free_.pop_back();
+    conn.reopen(fd);
+    conn.in_use = true;
+    return &conn;
+}
+
+void ConnectionSlab::close(ConnectionState& conn) {
+    conn.in_use = false;
+    free_.push_back(conn.id);
+}
+
 // ═══════════════════════════════════════════════════════════════
 //  TcpGateway Construction & Lifecycle
 // ═══════════════════════════════════════════════════════════════
 
-TcpGateway::TcpGateway(uint16_t port, RiskManager* risk_manager, OrderPool* order_pool)
-    : port_(port), risk_manager_(risk_manager), order_pool_(order_pool)
+TcpGateway::Reactor::Reactor(GatewayReactor reactor_index, size_t max_orders)
+    : index(reactor_index)
+    , sessions(0)
+    , order_routes(max_orders)
+{
+    batch_traces.reserve(MAX_BATCH_ENTRIES);
+}
+
+TcpGateway::TcpGateway(uint16_t port, RiskManager* risk_manager, OrderPool* order_pool,
+                       size_t reactors)
+    : port_(port), risk_shards_{risk_manager}, order_pool_(order_pool)
 {
     SecurityConfig security_config;
     security_config.rate_limit_per_second = 1000;
@@ -81,51 +254,117 @@ TcpGateway::TcpGateway(uint16_t port, RiskManager* risk_manager, OrderPool* orde
     security_config.hmac_key.assign("dev_hmac_key_32chars_long_enough_key");
     secure_network_ = std::make_unique<SecureNetworkLayer>(security_config);
 
-    connections_.resize(MAX_CONNECTIONS);
-    LOG_INFO("TCP gateway initialized on port {}", port_);
+    reactors = std::clamp<size_t>(reactors, 1, MAX_REACTORS);
+    for (size_t i = 0; i < reactors; ++i) {
+        reactors_.push_back(std::make_unique<Reactor>(
+            static_cast<GatewayReactor>(i), order_pool ? order_pool->max_capacity() : 1));
+    }
+    LOG_INFO("TCP gateway initialized on port {} ({} reactors)", port_, reactors);
 }
 
 TcpGateway::~TcpGateway() {
     stop();
 }
 
+void TcpGateway::set_execution_queues(std::vector<SPSCQueue<ExecutionReport>*> queues,
+                                      EventDoorbell* doorbell, size_t reactor) {
+    Reactor& r = *reactors_.at(reactor);
+    r.execution_queues   = std::move(queues);
+    r.execution_doorbell = doorbell;
+    r.execution_buffer.resize(EXEC_BATCH_SIZE);
+}
+
+void TcpGateway::set_drop_copy(DropCopyServer* server) {
+    for (size_t i = 0; i < reactors_.size(); ++i) {
+        reactors_[i]->drop_copy = server && i < server->reactor_count() ? server->reactor_queue(i)
+                                                                          : nullptr;
+    }
+}
+
+void TcpGateway::set_order_tracer(OrderTracer* tracer) {
+    tracer_ = tracer;
+    for (size_t i = 0; i < reactors_.size(); ++i) {
+        reactors_[i]->trace_sink = tracer ? tracer->reactor_sink(i) : nullptr;
+    }
+}
+
+void TcpGateway::set_risk_shards(std::vector<RiskManager*> shards) {
+    if (!shards.empty()) risk_shards_ = std::move(shards);
+}
+
 void TcpGateway::start() {
     bool expected = false;
     if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return;
 
-    if (!setup_listen_socket() || !setup_epoll()) {
-        running_.store(false);
-        throw std::runtime_error("Failed to start TCP Gateway");
+    if (backend_ == GatewayBackend::IO_URING && tls_) {
+        LOG_WARN("TLS handshakes need readiness events, TCP gateway uses epoll instead of io_uring");
+        backend_ = GatewayBackend::EPOLL;
+    } else if (backend_ == GatewayBackend::IO_URING && !setup_uring()) {
+        backend_ = GatewayBackend::EPOLL;
+    }
+
+    for (auto& r : reactors_) {
+        r->risk_lane = static_cast<RiskLane>(risk_lane_ + r->index);
+        r->connections = std::make_unique<ConnectionSlab>(max_connections_);
+        r->sessions    = SessionRegistry(max_connections_);
+        r->pending_writes.reserve(max_connections_);
+        if (!setup_listen_socket(*r) || (!r->uring && !setup_epoll(*r))) {
+            running_.store(false);
+            for (auto& opened : reactors_) {
+                opened->uring.reset();
+                opened->epoll_fd.close();
+                opened->listen_fd.close();
+            }
+            throw std::runtime_error("Failed to start TCP Gateway");
+        }
     }
 
-    acceptor_thread_ = std::thread(&TcpGateway::acceptor_loop, this);
-    worker_thread_   = std::thread(&TcpGateway::worker_loop, this);
+    for (auto& r : reactors_) {
+        r->thread = std::thread(&TcpGateway::reactor_loop, this, std::ref(*r));
+    }
 }
 
 void TcpGateway::stop() {
     bool expected = true;
     if (!running_.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) return;
 
-    if (acceptor_thread_.joinable()) acceptor_thread_.join();
-    if (worker_thread_.joinable()) worker_thread_.join();
+    for (auto& r : reactors_) {
+        if (r->thread.joinable()) r->thread.join();
+    }
 
-    for (auto& conn : connections_) {
-        if (conn) {
-            conn->disconnect();
-            conn.reset();
+    for (auto& r : reactors_) {
+        // The ring first: until their last CQE, recvs and sends use the slab's buffers
+#ifdef __linux__
+        const bool drained = !r->uring || drain_uring(*r);
+#else
+        const bool drained = true;
+#endif
+        r->uring.reset();
+        r->connections->for_each_open([this](ConnectionState& conn) {
+            if (conn.tls) tls_->abort(conn.tls);
+            if (session_auth_) session_auth_->release(conn.grant);
+            conn.disconnect();
+        });
+        if (drained) {
+            r->connections.reset();
+        } else {
+            (void)r->connections.release();  // Leaked: the kernel may still write into it
         }
+        flush_stats(*r);
+        r->epoll_fd.close();
+        r->listen_fd.close();
     }
-
-    flush_stats();
-    epoll_fd_.close();
-    listen_fd_.close();
 }
 
 // ═══════════════════════════════════════════════════════════════
 //  Socket & Reactor Setup
 // ═══════════════════════════════════════════════════════════════
 
-bool TcpGateway::setup_listen_socket() {
+/**
+ * Every reactor binds its own socket to the same port; SO_REUSEPORT makes
+ * the kernel hash each incoming connection to one of them.
+ */
+bool TcpGateway::setup_listen_socket(Reactor& r) {
     int fd = socket(AF_INET, SOCK_STREAM, 0);
     if (fd < 0) return false;
 
@@ -133,11 +372,20 @@ bool TcpGateway::setup_listen_socket() {
     int flags = fcntl(fd, F_GETFL, 0);
     fcntl(fd, F_SETFL, flags | O_NONBLOCK);
 
-    listen_fd_.reset(fd);
+    r.listen_fd.reset(fd);
 
     int opt = 1;
     setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
     setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt));
+#ifdef __linux__
+    // Reuseport picks the listener whose incoming CPU ran the SYN's softirq
+    if (incoming_cpu_ && r.placement.core >= 0) {
+        const int cpu = r.placement.core;
+        if (setsockopt(fd, SOL_SOCKET, SO_INCOMING_CPU, &cpu, sizeof(cpu)) < 0) {
+            LOG_WARN("SO_INCOMING_CPU {} on reactor {}: {}", cpu, r.index, std::strerror(errno));
+        }
+    }
+#endif
 
     struct sockaddr_in addr{};
     addr.sin_family      = AF_INET;
@@ -147,68 +395,80 @@ bool TcpGateway::setup_listen_socket() {
     if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) return false;
     if (listen(fd, LISTEN_BACKLOG) < 0) return false;
 
+    // Port 0: the first reactor's ephemeral port is the one the others join
+    if (port_ == 0) {
+        socklen_t len = sizeof(addr);
+        if (getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) == 0) {
+            port_ = ntohs(addr.sin_port);
+        }
+    }
     return true;
 }
 
-bool TcpGateway::setup_epoll() {
+bool TcpGateway::setup_epoll(Reactor& r) {
 #ifdef __APPLE__
     int fd = kqueue();
 #else
     int fd = epoll_create1(EPOLL_CLOEXEC);
 #endif
     if (fd < 0) return false;
-    epoll_fd_.reset(fd);
-    return true;
-}
-
-// ═══════════════════════════════════════════════════════════════
-//  Acceptor & Worker Threads
-// ═══════════════════════════════════════════════════════════════
-
-void TcpGateway::acceptor_loop() {
-    struct pollfd pfd{};
-    pfd.fd     = listen_fd_.get();
-    pfd.events = POLLIN;
-
-    while (running_.load(std::memory_order_relaxed)) {
-        if (poll(&pfd, 1, ACCEPT_POLL_MS) <= 0) continue;
-        if (!(pfd.revents & POLLIN)) continue;
-
-        while (running_.load(std::memory_order_relaxed)) {
-            struct sockaddr_in client_addr{};
-            socklen_t addr_len = sizeof(client_addr);
-
-            int client_fd = accept(listen_fd_.get(), reinterpret_cast<sockaddr*>(&client_addr), &addr_len);
-            if (client_fd < 0) {
-                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
-                break;
-            }
-
-            if (static_cast<size_t>(client_fd) >= MAX_CONNECTIONS) {
-                ::close(client_fd);
-                continue;
-            }
-
-            auto conn = std::make_unique<ConnectionState>(client_fd);
+    r.epoll_fd.reset(fd);
 
 #ifdef __APPLE__
-            struct kevent ev;
-            EV_SET(&ev, client_fd, EVFILT_READ, EV_ADD | EV_CLEAR, 0, 0, NULL);
-            kevent(epoll_fd_.get(), &ev, 1, NULL, 0, NULL);
+    struct kevent ev;
+    EV_SET(&ev, r.listen_fd.get(), EVFILT_READ, EV_ADD, 0, 0, NULL);
+    if (kevent(fd, &ev, 1, NULL, 0, NULL) < 0) return false;
 #else
-            struct epoll_event ev{};
-            ev.events  = EPOLLIN | EPOLLET;
-            ev.data.fd = client_fd;
-            epoll_ctl(epoll_fd_.get(), EPOLL_CTL_ADD, client_fd, &ev);
+    struct epoll_event ev{};
+    ev.events  = EPOLLIN;
+    ev.data.fd = r.listen_fd.get();
+    if (epoll_ctl(fd, EPOLL_CTL_ADD, ev.data.fd, &ev) < 0) return false;
+    if (busy_poll_us_ > 0) apply_busy_poll(fd, true);
+
+    if (r.execution_doorbell && r.execution_doorbell->fd() >= 0) {
+        ev.events  = EPOLLIN;
+        ev.data.fd = r.execution_doorbell->fd();
+        epoll_ctl(fd, EPOLL_CTL_ADD, ev.data.fd, &ev);
+    }
 #endif
+    return true;
+}
 
-            connections_[client_fd] = std::move(conn);
-            ++local_stats_.connections_accepted;
+/** One ring per reactor; all or none, so the backend is uniform. */
+bool TcpGateway::setup_uring() {
+    IoUring::Options options;
+    options.entries     = URING_ENTRIES;
+    options.sqpoll_core = sqpoll_core_;
+    for (auto& r : reactors_) {
+        r->uring = std::make_unique<IoUring>();
+        if (!r->uring->init(options)) {
+            LOG_WARN("io_uring unavailable ({}), TCP gateway falls back to epoll",
+                     std::strerror(errno));
+            for (auto& undo : reactors_) undo->uring.reset();
+            return false;
         }
     }
+    LOG_INFO("TCP gateway using io_uring{}", sqpoll_core_ >= 0 ? " with SQPOLL" : "");
+    return true;
 }
 
-void TcpGateway::worker_loop() {
+// ═══════════════════════════════════════════════════════════════
+//  Reactor Threads
+// ═══════════════════════════════════════════════════════════════
+
+void TcpGateway::reactor_loop(Reactor& r) {
+    const std::string name = r.index == 0 ? std::string("tcp_gateway")
+                                          : "tcp_gateway_" + std::to_string(r.index);
+    r.applied_placement.store(apply_thread_placement(r.placement, name.c_str()),
+                              std::memory_order_relaxed);
+#ifdef __linux__
+    if (r.uring) {
+        uring_loop(r);
+        return;
+    }
+#endif
+    const int  listen_fd = r.listen_fd.get();
+    const bool spinning  = idle_policy_ != IdlePolicy::SPIN_PARK;
 #ifdef __APPLE__
     std::array<struct kevent, EPOLL_MAX_EVENTS> events{};
     struct timespec ts {0, EPOLL_TIMEOUT_MS * 1000000};
@@ -218,158 +478,1164 @@ void TcpGateway::worker_loop() {
 
     while (running_.load(std::memory_order_relaxed)) {
 #ifdef __APPLE__
-        int n = kevent(epoll_fd_.get(), NULL, 0, events.data(), EPOLL_MAX_EVENTS, &ts);
+        // No doorbell here: reports wait for the next kevent timeout
+        int n = kevent(r.epoll_fd.get(), NULL, 0, events.data(), EPOLL_MAX_EVENTS, &ts);
         for (int i = 0; i < n; ++i) {
-            int fd = events[i].ident;
-            if (events[i].flags & (EV_EOF | EV_ERROR)) { remove_connection(fd); continue; }
-            if (events[i].filter == EVFILT_READ) handle_client_data(fd);
+            const auto key = reinterpret_cast<uint64_t>(events[i].udata);
+            if (!(key & CONNECTION_EVENT)) {
+                if (static_cast<int>(events[i].ident) == listen_fd) accept_connections(r);
+                continue;
+            }
+            ConnectionState* conn = connection_of(*r.connections, key);
+            if (!conn) continue;  // Closed earlier in this batch
+            if (events[i].flags & (EV_EOF | EV_ERROR)) { remove_connection(r, *conn); continue; }
+            if (events[i].filter == EVFILT_READ) handle_client_data(r, *conn);
+            if (events[i].filter == EVFILT_WRITE) handle_writable(r, *conn);
         }
 #else
-        int n = epoll_wait(epoll_fd_.get(), events.data(), EPOLL_MAX_EVENTS, EPOLL_TIMEOUT_MS);
+        // Spinning reactors never block, so producers need not ring them
+        const int timeout = spinning ? 0 : arm_execution_doorbell(r) ? EPOLL_TIMEOUT_MS : 0;
+        int n = epoll_wait(r.epoll_fd.get(), events.data(), EPOLL_MAX_EVENTS, timeout);
+        if (!spinning && r.execution_doorbell) r.execution_doorbell->disarm();
         for (int i = 0; i < n; ++i) {
-            int fd = events[i].data.fd;
-            if (events[i].events & (EPOLLERR | EPOLLHUP)) { remove_connection(fd); continue; }
-            if (events[i].events & EPOLLIN) handle_client_data(fd);
+            const uint64_t key = events[i].data.u64;
+            if (!(key & CONNECTION_EVENT)) [[unlikely]] {
+                const int fd = static_cast<int>(key);
+                if (fd == listen_fd) {
+                    accept_connections(r);
+                } else if (r.execution_doorbell && fd == r.execution_doorbell->fd()) {
+                    r.execution_doorbell->clear();
+                }
+                continue;
+            }
+            ConnectionState* conn = connection_of(*r.connections, key);
+            if (!conn) continue;  // Closed earlier in this batch
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) { remove_connection(r, *conn); continue; }
+            if (events[i].events & EPOLLIN) handle_client_data(r, *conn);
+            if (events[i].events & EPOLLOUT) handle_writable(r, *conn);
         }
+        if (n <= 0 && idle_policy_ == IdlePolicy::SPIN_YIELD) sched_yield();
 #endif
-        maybe_flush_stats();
+        drain_executions(r);
+        flush_writes(r);
+        maybe_flush_stats(r);
     }
 }
 
-void TcpGateway::handle_client_data(int fd) {
-    if (static_cast<size_t>(fd) >= connections_.size() || !connections_[fd]) return;
-    auto& conn = *connections_[fd];
+/**
+ * Accept everything queued on this reactor's socket. The connection is
+ * registered before the next epoll_wait on the thread that will read it
+ * (epoll reports data that arrived before EPOLL_CTL_ADD), so no first
+ * message can be missed. The poller carries the connection's slot, not
+ * its fd.
+ */
+void TcpGateway::accept_connections(Reactor& r) {
+    for (;;) {
+        struct sockaddr_in client_addr{};
+        socklen_t addr_len = sizeof(client_addr);
 
+        int client_fd = accept(r.listen_fd.get(), reinterpret_cast<sockaddr*>(&client_addr), &addr_len);
+        if (client_fd < 0) break;  // EAGAIN: backlog drained
+        ConnectionState* conn = install_connection(r, client_fd);
+        if (!conn) continue;
+        if (tls_) [[unlikely]] {
+            conn->tls = tls_->begin(client_fd);
+            if (!conn->tls) {
+                ++r.local_stats.tls_failures;
+                remove_connection(r, *conn);
+                continue;
+            }
+        }
+
+#ifdef __APPLE__
+        void* key = reinterpret_cast<void*>(connection_key(*conn));
+        struct kevent ev[2];
+        EV_SET(&ev[0], client_fd, EVFILT_READ, EV_ADD | EV_CLEAR, 0, 0, key);
+        EV_SET(&ev[1], client_fd, EVFILT_WRITE, EV_ADD | EV_CLEAR, 0, 0, key);
+        kevent(r.epoll_fd.get(), ev, 2, NULL, 0, NULL);
+#else
+        // Edge-triggered EPOLLOUT only fires when a full send buffer drains,
+        // so it costs nothing until a client falls behind
+        struct epoll_event ev{};
+        ev.events   = EPOLLIN | EPOLLOUT | EPOLLET;
+        ev.data.u64 = connection_key(*conn);
+        epoll_ctl(r.epoll_fd.get(), EPOLL_CTL_ADD, client_fd, &ev);
+#endif
+    }
+}
+
+/** Slab slot for a new fd. nullptr: every slot is taken, fd refused. */
+ConnectionState* TcpGateway::install_connection(Reactor& r, int client_fd) {
+    ConnectionState* conn = r.connections->open(client_fd);
+    if (!conn) [[unlikely]] {
+        ::close(client_fd);
+        ++r.local_stats.sessions_refused;
+        return nullptr;
+    }
+    if (busy_poll_us_ > 0) apply_busy_poll(client_fd, false);
+#ifdef __linux__
+    if (rx_timestamps_ && backend_ == GatewayBackend::EPOLL) {
+        int flag = 1;
+        setsockopt(client_fd, SOL_SOCKET, SO_TIMESTAMPNS, &flag, sizeof(flag));  // Ingress latency
+    }
+#endif
+    ++r.local_stats.connections_accepted;
+    return conn;
+}
+
+/**
+ * Busy polling (Linux): an empty read spins on the device queue for up to
+ * busy_poll_us_ instead of sleeping until the next interrupt. On a socket
+ * this covers recv(); on an epoll set (EPIOCSPARAMS, 6.9+) it covers
+ * epoll_wait. Needs CAP_NET_ADMIN above net.core.busy_read; a refusal is
+ * logged once and the gateway runs without it.
+ */
+void TcpGateway::apply_busy_poll(int fd, bool epoll_set) {
+#ifdef __linux__
+    static std::atomic<bool> warned{false};
+    int ok;
+    if (epoll_set) {
+        epoll_params params{};
+        params.busy_poll_usecs  = busy_poll_us_;
+        params.busy_poll_budget = 8;  // Kernel default (BUSY_POLL_BUDGET)
+        params.prefer_busy_poll = 1;
+        ok = ioctl(fd, EPIOCSPARAMS, &params);
+    } else {
+        const int usecs  = static_cast<int>(busy_poll_us_);
+        const int prefer = 1;
+        ok = setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &usecs, sizeof(usecs));
+        if (ok == 0) ok = setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer, sizeof(prefer));
+    }
+    if (ok < 0 && !warned.exchange(true, std::memory_order_relaxed)) {
+        LOG_WARN("Gateway busy poll ({} us) not applied to {}: {}", busy_poll_us_,
+                 epoll_set ? "epoll set" : "socket", std::strerror(errno));
+    }
+#else
+    (void)fd;
+    (void)epoll_set;
+#endif
+}
+
+/** First data on the connection is its logon: give it a routable session. */
+bool TcpGateway::open_session(Reactor& r, ConnectionState& conn) {
+    if (conn.session != 0) [[likely]] return true;
+    conn.session = r.sessions.open(&conn);
+    if (conn.session != 0) return true;
+    ++r.local_stats.sessions_refused;
+    return false;
+}
+
+void TcpGateway::handle_client_data(Reactor& r, ConnectionState& conn) {
+    if (conn.tls && !advance_tls(r, conn)) [[unlikely]] return;
+    if (!open_session(r, conn)) [[unlikely]] {
+        remove_connection(r, conn);
+        return;
+    }
+
+    const int fd = conn.fd.get();
     for (;;) {
-        ssize_t bytes = recv(fd, conn.read_buf.write_ptr(), conn.read_buf.remaining(), 0);
+        conn.read_buf.make_room();
+        uint64_t rx_ns = 0;
+        // kTLS needs no cmsg buffer here: without one, the kernel fails a
+        // non-data record's read with EIO
+        ssize_t bytes = rx_timestamps_ ? recv_stamped(fd, conn.read_buf, rx_ns)
+                                       : recv(fd, conn.read_buf.write_ptr(), conn.read_buf.remaining(), 0);
         if (bytes > 0) {
             conn.read_buf.advance_write(static_cast<size_t>(bytes));
-            while (try_process_message(conn)) {
-                ++local_stats_.messages_received;
+            const uint64_t before = r.local_stats.messages_received;
+            while (try_process_message(r, conn)) {
+                ++r.local_stats.messages_received;
+            }
+            if (rx_timestamps_ && r.local_stats.messages_received != before) record_ingress(r, rx_ns);
+            if (conn.closing) [[unlikely]] {
+                remove_connection(r, conn);
+                return;
             }
         } else if (bytes == 0) {
-            remove_connection(fd);
+            remove_connection(r, conn);
             return;
         } else {
             if (errno == EAGAIN || errno == EWOULDBLOCK) break;
-            remove_connection(fd);
+            remove_connection(r, conn);
             return;
         }
     }
 }
 
+/**
+ * Step a session's handshake as far as the socket allows. True once the
+ * kernel holds both directions' keys: the session is then read like a
+ * plain one, starting with whatever followed the handshake (edge-
+ * triggered, so it must be read now). Edge-triggered EPOLLIN and EPOLLOUT
+ * both lead back here while it waits. A failed or non-offloaded
+ * handshake removes the connection.
+ */
+bool TcpGateway::advance_tls(Reactor& r, ConnectionState& conn) {
+    switch (tls_->advance(conn.tls)) {
+        case TlsOffload::Status::WANT_READ:
+        case TlsOffload::Status::WANT_WRITE:
+            return false;
+        case TlsOffload::Status::DONE:
+            conn.tls = nullptr;
+            ++r.local_stats.tls_sessions;
+            return true;
+        case TlsOffload::Status::FAILED:
+        case TlsOffload::Status::NO_OFFLOAD:
+            break;
+    }
+    conn.tls = nullptr;  // Freed by advance()
+    ++r.local_stats.tls_failures;
+    remove_connection(r, conn);
+    return false;
+}
+
+/**
+ * Per-message authorization under set_session_auth(): a bitmask test
+ * against the grant the logon stored, re-read only after a revocation.
+ */
+bool TcpGateway::authorize(Reactor& r, ConnectionState& conn, uint32_t permission, uint64_t order_id) {
+    if (session_auth_->allowed(conn.grant, permission)) [[likely]] return true;
+    ++r.local_stats.auth_rejects;
+    send_reject(r, conn, order_id, conn.grant.id == 0  ? "Not logged on"
+                                   : conn.grant.mask == 0 ? "Session revoked"
+                                                          : "Not permitted");
+    return false;
+}
+
+/**
+ * A logged-on session acts for its logon client only: a v1 message's own
+ * client_id must be that one. Sessions that never logged on (v1 without
+ * session auth) have no identity to hold them to.
+ */
+bool TcpGateway::owns_client(Reactor& r, ConnectionState& conn, const ClientID& client, uint64_t order_id) {
+    if (!conn.authenticated || client == conn.client_id) [[likely]] return true;
+    ++r.local_stats.auth_rejects;
+    send_reject(r, conn, order_id, "Not the session's client");
+    return false;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  io_uring Reactor (Linux)
+// ═══════════════════════════════════════════════════════════════
+
+#ifdef __linux__
+
+/**
+ * Same shape as the epoll loop, but readiness is replaced by completions:
+ * one multishot accept, one recv per connection (straight into its read
+ * buffer, re-armed on completion), one sendmsg per flushed session, and a
+ * multishot poll on the execution doorbell. Every SQE queued during an
+ * iteration goes out in the next submit().
+ */
+void TcpGateway::uring_loop(Reactor& r) {
+    IoUring& ring = *r.uring;
+    IoUring::prep_accept_multishot(ring.get_sqe(), r.listen_fd.get(),
+                                   uring_data(URING_ACCEPT, r.listen_fd.get()));
+    if (r.execution_doorbell && r.execution_doorbell->fd() >= 0) {
+        IoUring::prep_poll_multishot(ring.get_sqe(), r.execution_doorbell->fd(),
+                                     uring_data(URING_DOORBELL, r.execution_doorbell->fd()));
+    }
+
+    const bool spinning = idle_policy_ != IdlePolicy::SPIN_PARK;
+    while (running_.load(std::memory_order_relaxed)) {
+        if (spinning) {
+            ring.submit();
+        } else {
+            ring.submit(arm_execution_doorbell(r), EPOLL_TIMEOUT_MS);
+            if (r.execution_doorbell) r.execution_doorbell->disarm();
+        }
+        size_t completions = 0;
+        ring.for_each_cqe([&](const io_uring_cqe& cqe) {
+            uring_complete(r, cqe.user_data, cqe.res, cqe.flags);
+            ++completions;
+        });
+        if (completions == 0 && idle_policy_ == IdlePolicy::SPIN_YIELD) sched_yield();
+        drain_executions(r);
+        flush_writes(r);
+        maybe_flush_stats(r);
+    }
+}
+
+/**
+ * Cancel every recv and send still in flight and reap their completions,
+ * discarding them. Reactor thread joined. @return false if some did not
+ * complete in URING_DRAIN_TIMEOUT (their buffers must then stay allocated)
+ */
+bool TcpGateway::drain_uring(Reactor& r) {
+    IoUring& ring = *r.uring;
+    size_t in_flight = 0;
+    r.connections->for_each_open([&](ConnectionState& conn) {
+        if (conn.recv_armed) {
+            IoUring::prep_cancel(ring.get_sqe(), uring_data(URING_RECV, conn.id), uring_data(URING_CANCEL, conn.id));
+            ++in_flight;
+        }
+        if (conn.send_inflight) {
+            IoUring::prep_cancel(ring.get_sqe(), uring_data(URING_SEND, conn.id), uring_data(URING_CANCEL, conn.id));
+            ++in_flight;
+        }
+    });
+
+    const auto deadline = std::chrono::steady_clock::now() + URING_DRAIN_TIMEOUT;
+    while (in_flight > 0 && std::chrono::steady_clock::now() < deadline) {
+        ring.submit(true, 10);
+        ring.for_each_cqe([&](const io_uring_cqe& cqe) {
+            const auto target = static_cast<uint32_t>(cqe.user_data);
+            switch (static_cast<UringOp>(cqe.user_data >> 32)) {
+                case URING_ACCEPT:
+                    if (cqe.res >= 0) ::close(cqe.res);  // Too late to serve
+                    break;
+                case URING_RECV:
+                    if ((*r.connections)[target].recv_armed) --in_flight;
+                    (*r.connections)[target].recv_armed = false;
+                    break;
+                case URING_SEND:
+                    if ((*r.connections)[target].send_inflight) --in_flight;
+                    (*r.connections)[target].send_inflight = false;
+                    break;
+                default:  // Doorbell polls and the cancels themselves
+                    break;
+            }
+        });
+    }
+    if (in_flight > 0) {
+        LOG_ERROR("Gateway reactor {}: {} io_uring ops still in flight at stop, connection slab leaked",
+                  r.index, in_flight);
+        return false;
+    }
+    return true;
+}
+
+void TcpGateway::uring_complete(Reactor& r, uint64_t user_data, int32_t res, uint32_t flags) {
+    const auto target = static_cast<uint32_t>(user_data);  // fd, or connection for RECV / SEND
+    const bool more   = flags & IORING_CQE_F_MORE;
+    switch (static_cast<UringOp>(user_data >> 32)) {
+        case URING_ACCEPT:
+            if (res >= 0) {
+                if (ConnectionState* conn = install_connection(r, res)) uring_arm_recv(r, *conn);
+            }
+            if (!more && running_.load(std::memory_order_relaxed)) {
+                IoUring::prep_accept_multishot(r.uring->get_sqe(), static_cast<int>(target), user_data);
+            }
+            break;
+        case URING_RECV:
+            uring_on_recv(r, (*r.connections)[target], res);
+            break;
+        case URING_SEND:
+            uring_on_send(r, (*r.connections)[target], res);
+            break;
+        case URING_DOORBELL:
+            r.execution_doorbell->clear();
+            if (!more) IoUring::prep_poll_multishot(r.uring->get_sqe(), static_cast<int>(target), user_data);
+            break;
+        case URING_CANCEL:  // Only issued by drain_uring()
+            break;
+    }
+}
+
+void TcpGateway::uring_arm_recv(Reactor& r, ConnectionState& conn) {
+    conn.read_buf.make_room();
+    IoUring::prep_recv(r.uring->get_sqe(), conn.fd.get(), conn.read_buf.write_ptr(),
+                       conn.read_buf.remaining(), uring_data(URING_RECV, conn.id));
+    conn.recv_armed = true;
+}
+
+void TcpGateway::uring_on_recv(Reactor& r, ConnectionState& conn, int32_t res) {
+    conn.recv_armed = false;  // The slot is held until its last CQE
+
+    if (res > 0 && !conn.retiring) [[likely]] {
+        conn.read_buf.advance_write(static_cast<size_t>(res));
+        if (open_session(r, conn)) {
+            // No cmsg on a plain recv CQE: the clock starts at the completion
+            const uint64_t rx_ns  = rx_timestamps_ ? realtime_ns() : 0;
+            const uint64_t before = r.local_stats.messages_received;
+            while (try_process_message(r, conn)) {
+                ++r.local_stats.messages_received;
+            }
+            if (rx_timestamps_ && r.local_stats.messages_received != before) record_ingress(r, rx_ns);
+        } else {
+            conn.closing = true;
+        }
+        if (!conn.closing) {
+            uring_arm_recv(r, conn);
+            return;
+        }
+    }
+    remove_connection(r, conn);  // EOF, error, bad frame, or already retiring
+}
+
+void TcpGateway::uring_send(Reactor& r, ConnectionState& conn) {
+    if (conn.send_inflight || conn.write_buf.empty()) return;  // Completion re-queues the rest
+    conn.send_msg = msghdr{};
+    conn.send_msg.msg_iov    = conn.send_iov;
+    conn.send_msg.msg_iovlen = conn.write_buf.pending(conn.send_iov);
+    IoUring::prep_sendmsg(r.uring->get_sqe(), conn.fd.get(), &conn.send_msg,
+                          uring_data(URING_SEND, conn.id));
+    conn.send_inflight = true;
+    ++r.local_stats.send_calls;
+}
+
+void TcpGateway::uring_on_send(Reactor& r, ConnectionState& conn, int32_t res) {
+    conn.send_inflight = false;
+    if (res > 0 && !conn.retiring) [[likely]] {
+        conn.write_buf.consume(static_cast<size_t>(res));
+        if (!conn.write_buf.empty()) queue_flush(r, conn);
+        return;
+    }
+    conn.closing = true;
+    remove_connection(r, conn);
+}
+
+#endif // __linux__
+
 // ═══════════════════════════════════════════════════════════════
 //  Message Processing
 // ═══════════════════════════════════════════════════════════════
 
-bool TcpGateway::try_process_message(ConnectionState& conn) {
+bool TcpGateway::try_process_message(Reactor& r, ConnectionState& conn) {
+    if (conn.closing) [[unlikely]] return false;  // Responses could not reach it
+
+    if (conn.protocol == PROTOCOL_V2) {
+        if (conn.read_buf.size() < sizeof(MessageHeaderV2)) return false;
+        const auto* header = reinterpret_cast<const MessageHeaderV2*>(conn.read_buf.data());
+        if (header->length < sizeof(MessageHeaderV2) || header->length > MAX_MESSAGE_SIZE) {
+            conn.closing = true;
+            return false;
+        }
+        if (conn.read_buf.size() < header->length) return false;
+
+        if (capture_) [[unlikely]] capture_frame(r, conn, header->length);
+        process_message_v2(r, conn, conn.read_buf.data(), header->length);
+        conn.read_buf.consume(header->length);
+        return true;
+    }
+
     if (conn.read_buf.size() < sizeof(MessageHeader)) return false;
 
     const auto* header = reinterpret_cast<const MessageHeader*>(conn.read_buf.data());
     if (header->length < sizeof(MessageHeader) || header->length > MAX_MESSAGE_SIZE) {
-        conn.disconnect();
+        conn.closing = true;  // Framing lost: the caller drops the connection
         return false;
     }
 
     if (conn.read_buf.size() < header->length) return false;
 
-    process_message(conn, conn.read_buf.data(), header->length);
+    if (capture_) [[unlikely]] capture_frame(r, conn, header->length);
+    process_message(r, conn, conn.read_buf.data(), header->length);
     conn.read_buf.consume(header->length);
     return true;
 }
 
-void TcpGateway::process_message(ConnectionState& conn, const uint8_t* data, size_t length) {
+void TcpGateway::capture_frame(Reactor& r, ConnectionState& conn, size_t length) {
+    capture_->record(r.index, CaptureEventType::FRAME, static_cast<uint16_t>(conn.id), conn.generation,
+                     conn.read_buf.data(), length);
+}
+
+void TcpGateway::process_message(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length) {
     const auto* header = reinterpret_cast<const MessageHeader*>(data);
     
     // Checksum logic bypassed for brevity - adapt as needed based on ProtocolUtils
     
     switch (header->type) {
-        case NEW_ORDER: handle_new_order(conn, data, length); break;
-        case CANCEL_ORDER: handle_cancel_order(conn, data, length); break;
+        case NEW_ORDER: handle_new_order(r, conn, data, length); break;
+        case CANCEL_ORDER: handle_cancel_order(r, conn, data, length); break;
+        case MODIFY_ORDER: handle_modify_order(r, conn, data, length); break;
+        case MASS_CANCEL: handle_mass_cancel(r, conn, data, length); break;
+        case LOGON: handle_logon(r, conn, data, length); break;
         case HEARTBEAT: break;
         default: break;
     }
 }
 
-void TcpGateway::handle_new_order(ConnectionState& conn, const uint8_t* data, size_t length) {
+/**
+ * Bind the session to a client and pick its protocol. Later messages on
+ * the same session are framed in the chosen version — including any
+ * already sitting in the read buffer behind the logon.
+ */
+void TcpGateway::handle_logon(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length) {
+    if (length < LOGON_MIN_LENGTH) return;
+    const auto& msg = *reinterpret_cast<const LogonMessage*>(data);
+
+    const ClientID client(msg.client_id.c_str());
+    if (client.empty()) {
+        send_reject(r, conn, 0, "Logon without client id");
+        return;
+    }
+    if (msg.protocol_version != PROTOCOL_V1 && msg.protocol_version != PROTOCOL_V2) {
+        send_reject(r, conn, 0, "Unsupported protocol version");
+        return;
+    }
+    if (msg.protocol_version == PROTOCOL_V2 && !instrument_directory_) {
+        send_reject(r, conn, 0, "Protocol v2 unavailable");
+        return;
+    }
+    if (session_auth_) {
+        // Read in place: bounded by the frame and the field, NUL or not
+        const char* token = msg.auth_token.c_str();
+        const size_t token_length = length < sizeof(LogonMessage) ? 0
+            : strnlen(token, msg.auth_token.max_length() + 1);
+        if (!session_auth_->authenticate(std::string_view(token, token_length), conn.grant,
+                                         std::string_view(client.c_str()))) {
+            ++r.local_stats.auth_rejects;
+            send_reject(r, conn, 0, "Authentication failed");
+            return;
+        }
+    }
+    if (resolve_client(conn, client, true) == 0 && client_directory_) [[unlikely]] {
+        send_reject(r, conn, 0, "Client capacity exceeded");
+        return;
+    }
+    conn.client_id     = client;  // Also without a directory: v2 has no other identity
+    conn.protocol      = msg.protocol_version;
+    conn.authenticated = true;
+    send_ack(r, conn, 0, ACK_ACCEPTED, "Logon accepted");
+}
+
+/**
+ * Decoded in place from the read buffer straight into the pooled order:
+ * the fixed-width string fields are copied as bytes, never re-parsed.
+ */
+void TcpGateway::handle_new_order(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length) {
     if (length < sizeof(NewOrderMessage)) return;
     const auto& msg = *reinterpret_cast<const NewOrderMessage*>(data);
+    if (session_auth_ && !authorize(r, conn, SESSION_PLACE_ORDER, msg.order_id)) [[unlikely]] return;
 
-    Order* order = order_pool_->allocate();
-    if (!order) {
-        send_reject(conn, msg.order_id, "Order pool exhausted");
-        ++local_stats_.pool_exhausted;
+    Order* order = allocate_order(r, conn, msg.order_id);
+    if (!order) return;
+
+    order->client_id.assign_field(msg.client_id.c_str());
+    if (!owns_client(r, conn, order->client_id, msg.order_id)) [[unlikely]] {
+        order_pool_->deallocate(order);
+        return;
+    }
+    const ClientIDRaw client_raw = resolve_client(conn, order->client_id, true);
+    if (client_directory_ && client_raw == 0) [[unlikely]] {
+        order_pool_->deallocate(order);
+        send_reject(r, conn, msg.order_id, "Client capacity exceeded");
         return;
     }
 
     order->id                 = msg.order_id;
-    order->client_id          = ClientID(msg.client_id.c_str());
-    order->symbol             = Symbol(msg.symbol.c_str());
+    order->owner              = client_raw;
+    order->symbol.assign_field(msg.symbol.c_str());
     order->side               = static_cast<Side>(msg.side);
     order->type               = static_cast<OrderType>(msg.order_type);
     order->quantity           = msg.quantity;
     order->remaining_quantity = msg.quantity;
     order->price              = msg.price;
-    order->status             = OrderStatus::PENDING;
-    order->timestamp          = now_timestamp();
+    order->display_quantity   = msg.display_quantity;
+    order->stop_price         = msg.stop_price;
+    // Hashed here, on the reactor, so the risk worker indexes instead
+    const InstrumentID instrument = instrument_directory_ ? instrument_directory_->find(order->symbol)
+                                                          : INVALID_INSTRUMENT;
+    submit_new_order(r, conn, order, client_raw, instrument);
+}
+
+void TcpGateway::handle_cancel_order(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length) {
+    if (length < sizeof(CancelOrderMessage)) return;
+    const auto& msg = *reinterpret_cast<const CancelOrderMessage*>(data);
+    if (session_auth_ && !authorize(r, conn, SESSION_CANCEL_ORDER, msg.order_id)) [[unlikely]] return;
+
+    ClientID client;
+    client.assign_field(msg.client_id.c_str());
+    if (!owns_client(r, conn, client, msg.order_id)) [[unlikely]] return;
+    submit_cancel(r, conn, msg.order_id, client, resolve_client(conn, client, false));
+}
+
+void TcpGateway::handle_modify_order(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length) {
+    if (length < sizeof(ModifyOrderMessage)) return;
+    const auto& msg = *reinterpret_cast<const ModifyOrderMessage*>(data);
+    if (session_auth_ && !authorize(r, conn, SESSION_CANCEL_ORDER, msg.order_id)) [[unlikely]] return;
+
+    ClientID client;
+    client.assign_field(msg.client_id.c_str());
+    if (!owns_client(r, conn, client, msg.order_id)) [[unlikely]] return;
+    submit_modify(r, conn, msg.order_id, client, resolve_client(conn, client, false),
+                  msg.new_quantity, msg.new_price);
+}
+
+void TcpGateway::handle_mass_cancel(Reactor& r, ConnectionState& conn, const uint8_t* data, size_t length) {
+    if (length < sizeof(MassCancelMessage)) return;
+    const auto& msg = *reinterpret_cast<const MassCancelMessage*>(data);
+    if (session_auth_ && !authorize(r, conn, SESSION_CANCEL_ORDER, 0)) [[unlikely]] return;
 
-    if (risk_manager_->submit_order(order)) {
-        send_ack(conn, msg.order_id, 1, "Accepted");
+    ClientID client = conn.client_id;
+    Symbol   symbol;
+    switch (msg.scope) {
+        case MASS_CANCEL_SESSION: break;
+        case MASS_CANCEL_SYMBOL:  symbol.assign_field(msg.symbol.c_str()); [[fallthrough]];
+        case MASS_CANCEL_CLIENT:  client.assign_field(msg.client_id.c_str()); break;
+        default:
+            send_reject(r, conn, 0, "Invalid mass cancel scope");
+            return;
+    }
+    if (client.empty()) {
+        send_reject(r, conn, 0, "No client to cancel");
+        return;
+    }
+    if (!owns_client(r, conn, client, 0)) [[unlikely]] return;
+    if (submit_mass_cancel(r, conn, client, symbol)) {
+        send_ack(r, conn, 0, ACK_ACCEPTED, "Mass cancel submitted");
+    } else {
+        send_reject(r, conn, 0, "Cancel queue full");
+    }
+}
+
+bool TcpGateway::submit_mass_cancel(Reactor& r, ConnectionState& conn, const ClientID& client,
+                                    const Symbol& symbol) {
+    const ClientIDRaw client_raw = resolve_client(conn, client, false);
+    if (client_directory_ && client_raw == 0) return true;  // Never traded: nothing to cancel
+    ++r.local_stats.mass_cancels;
+    return risk_for(client_raw)->submit_mass_cancel(client, symbol, r.risk_lane, client_raw);
+}
+
+Order* TcpGateway::allocate_order(Reactor& r, ConnectionState& conn, OrderID order_id) {
+    Order* order = order_pool_->allocate();
+    if (!order) [[unlikely]] {
+        send_reject(r, conn, order_id, "Order pool exhausted");
+        ++r.local_stats.pool_exhausted;
+    }
+    return order;
+}
+
+void TcpGateway::submit_new_order(Reactor& r, ConnectionState& conn, Order* order,
+                                  ClientIDRaw client_raw, InstrumentID instrument) {
+    order->hidden_quantity = 0;
+    order->status          = OrderStatus::PENDING;
+    order->timestamp       = now_timestamp();
+    order->ingress         = r.index;
+
+    // Reports are routed by order id — a second live order with the same
+    // id would steal the first one's fills
+    const OrderID order_id = order->id;
+    const bool routed = !r.execution_queues.empty();
+    if (routed && r.order_routes.contains(order_id)) [[unlikely]] {
+        order_pool_->deallocate(order);
+        send_reject(r, conn, order_id, "Duplicate order id");
+        return;
+    }
+
+    const OrderTraceStart traced = tracer_ ? tracer_->begin(*order) : OrderTraceStart{};
+    if (risk_for(client_raw)->submit_order(order, r.risk_lane, instrument)) {
+        // Inserted before the next drain_executions(), so no report can miss it
+        if (routed && !r.order_routes.insert(order_id, {conn.session, client_raw})) [[unlikely]] {
+            ++r.local_stats.reports_unroutable;
+        }
+        send_ack(r, conn, order_id, ACK_ACCEPTED, "Accepted");
+        if (traced) [[unlikely]] tracer_->acked(traced, r.trace_sink);
     } else {
         order_pool_->deallocate(order);
-        send_reject(conn, msg.order_id, "Risk queue full");
+        send_reject(r, conn, order_id, "Risk queue full");
     }
 }
 
-void TcpGateway::handle_cancel_order(ConnectionState& conn, const uint8_t* data, size_t length) {
-    if (length < sizeof(CancelOrderMessage)) return;
-    const auto& msg = *reinterpret_cast<const CancelOrderMessage*>(data);
+void TcpGateway::submit_cancel(Reactor& r, ConnectionState& conn, OrderID order_id,
+                               const ClientID& client, ClientIDRaw client_raw) {
+    if (risk_for(client_raw)->submit_cancel(order_id, client, r.risk_lane, client_raw)) {
+        send_ack(r, conn, order_id, 1, "Cancel submitted");
+    } else {
+        send_reject(r, conn, order_id, "Cancel queue full");
+    }
+}
+
+void TcpGateway::submit_modify(Reactor& r, ConnectionState& conn, OrderID order_id,
+                               const ClientID& client, ClientIDRaw client_raw,
+                               Quantity new_quantity, Price new_price) {
+    if (risk_for(client_raw)->submit_modify(order_id, client, new_quantity, new_price,
+                                            r.risk_lane, client_raw)) {
+        send_ack(r, conn, order_id, 1, "Modify submitted");
+    } else {
+        send_reject(r, conn, order_id, "Modify queue full");
+    }
+}
+
+/**
+ * The directory is hit once per session (and again only if the session
+ * switches client ids). Unknown clients on cancel/modify are not
+ * registered — they cannot own a live order.
+ */
+ClientIDRaw TcpGateway::resolve_client(ConnectionState& conn, const ClientID& client, bool create) {
+    if (!client_directory_) {
+        if (create) conn.client_id = client;  // Session scope for mass cancel
+        return 0;
+    }
+    if (conn.client_raw != 0 && conn.client_id == client) [[likely]] return conn.client_raw;
+
+    const ClientIDRaw raw = create ? client_directory_->resolve(client)
+                                   : client_directory_->find(client);
+    if (raw != 0) {
+        conn.client_id  = client;
+        conn.client_raw = raw;
+    }
+    return raw;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Protocol v2 (after a v2 LOGON)
+// ═══════════════════════════════════════════════════════════════
+
+/** Order fields shared by NewOrderV2 and a BATCH new-order entry. */
+template <typename Msg>
+void fill_order_v2(Order& order, const Msg& msg, const Symbol& symbol, const ConnectionState& conn) {
+    order.id                 = msg.order_id;
+    order.client_id          = conn.client_id;
+    order.owner              = conn.client_raw;
+    order.symbol             = symbol;
+    order.side               = static_cast<Side>(msg.side);
+    order.type               = static_cast<OrderType>(msg.order_type);
+    order.quantity           = msg.quantity;
+    order.remaining_quantity = msg.quantity;
+    order.price              = msg.price;
+    order.display_quantity   = msg.display_quantity;
+    order.stop_price         = msg.stop_price;
+}
+
+/**
+ * Same requests as v1 with the strings gone: the client is the one the
+ * session logged on as (conn.client_id / client_raw, resolved once) and
+ * the symbol is an index into the instrument directory.
+ */
+void TcpGateway::process_message_v2(Reactor& r, ConnectionState& conn, const uint8_t* data,
+                                    size_t length) {
+    switch (reinterpret_cast<const MessageHeaderV2*>(data)->type) {
+        case NEW_ORDER:    handle_new_order_v2(r, conn, data, length); break;
+        case CANCEL_ORDER: handle_cancel_order_v2(r, conn, data, length); break;
+        case MODIFY_ORDER: handle_modify_order_v2(r, conn, data, length); break;
+        case MASS_CANCEL:  handle_mass_cancel_v2(r, conn, data, length); break;
+        case BATCH:        handle_batch_v2(r, conn, data, length); break;
+        default: break;  // HEARTBEAT and unknown types
+    }
+}
+
+void TcpGateway::handle_new_order_v2(Reactor& r, ConnectionState& conn, const uint8_t* data,
+                                     size_t length) {
+    if (length < sizeof(NewOrderV2)) return;
+    const auto& msg = *reinterpret_cast<const NewOrderV2*>(data);
+    if (session_auth_ && !authorize(r, conn, SESSION_PLACE_ORDER, msg.order_id)) [[unlikely]] return;
+
+    const Symbol* symbol = instrument_directory_->symbol(msg.instrument);
+    if (!symbol) [[unlikely]] {
+        send_reject(r, conn, msg.order_id, "Unknown instrument");
+        return;
+    }
+    Order* order = allocate_order(r, conn, msg.order_id);
+    if (!order) return;
+
+    fill_order_v2(*order, msg, *symbol, conn);
+    submit_new_order(r, conn, order, conn.client_raw, msg.instrument);
+}
+
+void TcpGateway::handle_cancel_order_v2(Reactor& r, ConnectionState& conn, const uint8_t* data,
+                                        size_t length) {
+    if (length < sizeof(CancelOrderV2)) return;
+    const auto& msg = *reinterpret_cast<const CancelOrderV2*>(data);
+    if (session_auth_ && !authorize(r, conn, SESSION_CANCEL_ORDER, msg.order_id)) [[unlikely]] return;
+    submit_cancel(r, conn, msg.order_id, conn.client_id, conn.client_raw);
+}
 
-    if (risk_manager_->submit_cancel(msg.order_id, ClientID(msg.client_id.c_str()))) {
-        send_ack(conn, msg.order_id, 1, "Cancel submitted");
+void TcpGateway::handle_modify_order_v2(Reactor& r, ConnectionState& conn, const uint8_t* data,
+                                        size_t length) {
+    if (length < sizeof(ModifyOrderV2)) return;
+    const auto& msg = *reinterpret_cast<const ModifyOrderV2*>(data);
+    if (session_auth_ && !authorize(r, conn, SESSION_CANCEL_ORDER, msg.order_id)) [[unlikely]] return;
+    submit_modify(r, conn, msg.order_id, conn.client_id, conn.client_raw,
+                  msg.new_quantity, msg.new_price);
+}
+
+void TcpGateway::handle_mass_cancel_v2(Reactor& r, ConnectionState& conn, const uint8_t* data,
+                                       size_t length) {
+    if (length < sizeof(MassCancelV2)) return;
+    const auto& msg = *reinterpret_cast<const MassCancelV2*>(data);
+    if (session_auth_ && !authorize(r, conn, SESSION_CANCEL_ORDER, 0)) [[unlikely]] return;
+
+    Symbol symbol;
+    switch (msg.scope) {
+        case MASS_CANCEL_SESSION:
+        case MASS_CANCEL_CLIENT:
+            break;
+        case MASS_CANCEL_SYMBOL:
+            if (const Symbol* found = instrument_directory_->symbol(msg.instrument)) {
+                symbol = *found;
+                break;
+            }
+            send_reject(r, conn, 0, "Unknown instrument");
+            return;
+        default:
+            send_reject(r, conn, 0, "Invalid mass cancel scope");
+            return;
+    }
+    if (submit_mass_cancel(r, conn, conn.client_id, symbol)) {
+        send_ack(r, conn, 0, ACK_ACCEPTED, "Mass cancel submitted");
     } else {
-        send_reject(conn, msg.order_id, "Cancel queue full");
+        send_reject(r, conn, 0, "Cancel queue full");
+    }
+}
+
+/**
+ * Stage every entry as a RiskRequest, hand them to the client's risk
+ * shard with one bulk enqueue, and answer with one BATCH_ACK. Entries
+ * the gateway refuses (or that do not fit the lane) are rejected in the
+ * ack; the rest are accepted exactly as if sent one by one.
+ */
+void TcpGateway::handle_batch_v2(Reactor& r, ConnectionState& conn, const uint8_t* data,
+                                 size_t length) {
+    if (length < sizeof(BatchV2)) return;
+    const auto& msg = *reinterpret_cast<const BatchV2*>(data);
+    const size_t count = msg.count;
+    if (count > MAX_BATCH_ENTRIES ||
+        length < sizeof(BatchV2) + count * sizeof(BatchEntryV2)) [[unlikely]] {
+        send_reject(r, conn, 0, "Malformed batch");
+        return;
     }
+    const auto* entries = reinterpret_cast<const BatchEntryV2*>(data + sizeof(BatchV2));
+
+    struct {
+        BatchAckMessage header;
+        BatchAckEntry   entries[MAX_BATCH_ENTRIES];
+    } ack;
+    static_assert(sizeof(ack) == sizeof(BatchAckMessage) + MAX_BATCH_ENTRIES * sizeof(BatchAckEntry),
+                  "Entries follow the header with no padding");
+    const Timestamp now = now_timestamp();
+    // Without execution queues nothing is routed back: no route table to keep
+    OrderIdMap<OrderRoute>* routes = r.execution_queues.empty() ? nullptr : &r.order_routes;
+    BatchSender sender;
+    sender.client_id  = &conn.client_id;
+    sender.client_raw = conn.client_raw;
+    // Requests carry the directory id only; without a directory, risk's resolves it
+    sender.request_owner = conn.client_raw ? conn.client_raw : risk_for(0)->resolve_client(conn.client_id);
+    // One grant check per batch; each entry then tests its action's bit
+    sender.permissions = session_auth_ ? session_auth_->permissions(conn.grant) : ~0u;
+    sender.ingress     = r.index;
+    sender.now         = now;
+
+    BatchStager<OrderRoute>& batch = r.batch;
+    batch.stage(entries, count, sender, instrument_directory_, *order_pool_, routes,
+                {conn.session, conn.client_raw});
+    // The order may be matched and its slot reused once pushed: keep the tick here
+    r.batch_traces.clear();
+    if (tracer_) [[unlikely]] {
+        for (const RiskRequest& req : batch.requests()) {
+            r.batch_traces.push_back(req.type == RiskRequest::NEW_ORDER ? tracer_->begin(*req.order)
+                                                                        : OrderTraceStart{});
+        }
+    }
+    const size_t pushed = batch.submit(*risk_for(conn.client_raw), r.risk_lane, *order_pool_, routes);
+    r.local_stats.auth_rejects       += batch.counts().not_permitted;
+    r.local_stats.pool_exhausted     += batch.counts().pool_exhausted;
+    r.local_stats.reports_unroutable += batch.counts().unroutable;
+    r.local_stats.orders_rejected    += batch.counts().rejected;
+
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t reason = batch.reason(i);
+        ack.entries[i] = {entries[i].order_id, reason == BATCH_OK ? ACK_ACCEPTED : ACK_REJECTED, reason};
+    }
+    const size_t bytes = sizeof(BatchAckMessage) + count * sizeof(BatchAckEntry);
+    ack.header.header   = MessageHeader(BATCH_ACK, static_cast<uint32_t>(bytes),
+                                        r.local_stats.next_sequence++, now);
+    ack.header.count    = static_cast<uint16_t>(count);
+    ack.header.accepted = static_cast<uint16_t>(pushed);
+    enqueue(r, conn, &ack, bytes);
+    if (tracer_) [[unlikely]] {
+        for (size_t i = 0; i < pushed; ++i) tracer_->acked(r.batch_traces[i], r.trace_sink);
+    }
+}
+
+
+// ═══════════════════════════════════════════════════════════════
+//  Execution Reports (engines/risk → owning reactor → session)
+// ═══════════════════════════════════════════════════════════════
+
+/**
+ * Arm the doorbell, then re-check the queues (Dekker handshake with
+ * EventDoorbell::ring()). @return true if it is safe to block.
+ */
+bool TcpGateway::arm_execution_doorbell(Reactor& r) {
+    if (!r.execution_doorbell) return true;
+    r.execution_doorbell->arm();
+    for (auto* queue : r.execution_queues) {
+        if (!queue->consumer_empty()) return false;
+    }
+    return true;
+}
+
+void TcpGateway::drain_executions(Reactor& r) {
+    for (auto* queue : r.execution_queues) {
+        size_t count;
+        do {
+            count = queue->try_pop_bulk(r.execution_buffer.data(), EXEC_BATCH_SIZE);
+            for (size_t i = 0; i < count; ++i) route_execution(r, r.execution_buffer[i]);
+        } while (count == EXEC_BATCH_SIZE);
+    }
+}
+
+void TcpGateway::route_execution(Reactor& r, const ExecutionReport& report) {
+    switch (report.type) {
+        case ExecutionReport::FILL: {
+            // A fill across reactors arrives at both; each sends its own side
+            const OrderRoute* buy  = report.reactor == r.index
+                ? find_route(r, report.fill.buy_order_id) : nullptr;
+            const OrderRoute* sell = report.sell_reactor == r.index
+                ? find_route(r, report.fill.sell_order_id) : nullptr;
+            ConnectionState* buyer  = session_of(r, buy);
+            ConnectionState* seller = session_of(r, sell);
+            if (buyer) send_trade(r, *buyer, report.fill);
+            if (seller && seller != buyer) send_trade(r, *seller, report.fill);
+            if (r.drop_copy) {
+                publish_drop_copy(r, report, buy, Side::BUY);
+                publish_drop_copy(r, report, sell, Side::SELL);
+            }
+            break;
+        }
+        case ExecutionReport::DONE: {
+            const OrderRoute* route = find_route(r, report.order.order_id);
+            if (ConnectionState* conn = session_of(r, route)) {
+                const bool filled = report.status == OrderStatus::FILLED;
+                send_ack(r, *conn, report.order.order_id,
+                         filled ? ACK_FILLED : ACK_CANCELLED,
+                         filled ? "Filled" : "Cancelled");
+            }
+            if (r.drop_copy) publish_drop_copy(r, report, route);
+            r.order_routes.erase(report.order.order_id);
+            break;
+        }
+        case ExecutionReport::REJECTED: {
+            const OrderRoute* route = find_route(r, report.order.order_id);
+            if (ConnectionState* conn = session_of(r, route)) {
+                const auto message =
+                    make_error_code(static_cast<ErrorCode>(report.reason)).message();
+                send_reject(r, *conn, report.order.order_id, message.c_str());
+            }
+            if (r.drop_copy) publish_drop_copy(r, report, route);
+            r.order_routes.erase(report.order.order_id);
+            break;
+        }
+    }
+}
+
+/** Route recorded for order_id, or nullptr if unknown. */
+const TcpGateway::OrderRoute* TcpGateway::find_route(Reactor& r, OrderID order_id) {
+    const OrderRoute* route = r.order_routes.find(order_id);
+    if (!route) ++r.local_stats.reports_unroutable;
+    return route;
+}
+
+/** Live session of a route, or nullptr if unknown or disconnected since. */
+ConnectionState* TcpGateway::session_of(Reactor& r, const OrderRoute* route) {
+    if (!route) return nullptr;
+    ConnectionState* conn = r.sessions.find(route->session);
+    return (conn && conn->connected) ? conn : nullptr;
+}
+
+/**
+ * Copy a report to drop copy under the route's firm. The session need not
+ * be alive: post-trade consumers still get the outcome of its orders.
+ */
+void TcpGateway::publish_drop_copy(Reactor& r, const ExecutionReport& report,
+                                   const OrderRoute* route, Side side) {
+    if (!route || route->client == 0) return;
+    DropCopyRecord record;
+    record.report = report;
+    record.client = route->client;
+    record.side   = side;
+    if (!r.drop_copy->push(record)) [[unlikely]] ++r.local_stats.drop_copy_overflows;
 }
 
-void TcpGateway::send_ack(ConnectionState& conn, uint64_t order_id, uint8_t status, const char* reason) {
+// ═══════════════════════════════════════════════════════════════
+//  Egress (per-session write buffers, one sendmsg per flush)
+// ═══════════════════════════════════════════════════════════════
+
+/**
+ * Queue a response on the session. A full buffer is written out first;
+ * if the client still has not drained it, it is too slow to keep and is
+ * closed at the next flush.
+ */
+bool TcpGateway::enqueue(Reactor& r, ConnectionState& conn, const void* message, size_t length) {
+    if (conn.closing) [[unlikely]] return false;
+    queue_flush(r, conn);
+    if (!conn.write_buf.append(message, length)) [[unlikely]] {
+        // An in-flight io_uring send owns the buffer head: no direct write
+        if (conn.send_inflight || !write_pending(r, conn) ||
+            !conn.write_buf.append(message, length)) {
+            if (!conn.closing) ++r.local_stats.slow_consumers;
+            conn.closing = true;
+            return false;
+        }
+    }
+    ++r.local_stats.messages_sent;
+    return true;
+}
+
+void TcpGateway::queue_flush(Reactor& r, ConnectionState& conn) {
+    if (conn.flush_queued) return;
+    conn.flush_queued = true;
+    r.pending_writes.push_back(&conn);
+}
+
+/**
+ * Write as much of the session's buffer as the socket takes.
+ * @return false if the connection failed (closing is set)
+ */
+bool TcpGateway::write_pending(Reactor& r, ConnectionState& conn) {
+    while (!conn.write_buf.empty()) {
+        iovec iov[2];
+        msghdr msg{};
+        msg.msg_iov    = iov;
+        msg.msg_iovlen = conn.write_buf.pending(iov);
+
+        const ssize_t sent = sendmsg(conn.fd.get(), &msg, MSG_NOSIGNAL);
+        ++r.local_stats.send_calls;
+        if (sent > 0) {
+            conn.write_buf.consume(static_cast<size_t>(sent));
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return true;  // Rest goes out on EPOLLOUT
+        } else {
+            conn.closing = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Once per loop iteration, after input and execution reports are handled. */
+void TcpGateway::flush_writes(Reactor& r) {
+    for (ConnectionState* conn : r.pending_writes) {
+        if (!conn->flush_queued) continue;  // Closed since it was queued
+        conn->flush_queued = false;
+        if (!conn->closing) [[likely]] {
+#ifdef __linux__
+            if (r.uring) {
+                uring_send(r, *conn);
+                continue;
+            }
+#endif
+            if (write_pending(r, *conn)) continue;
+        }
+        remove_connection(r, *conn);
+    }
+    r.pending_writes.clear();
+}
+
+/** The socket drained: resume writing whatever is still buffered. */
+void TcpGateway::handle_writable(Reactor& r, ConnectionState& conn) {
+    if (conn.tls) [[unlikely]] {
+        handle_client_data(r, conn);  // Handshake step that waited for room to write
+        return;
+    }
+    if (!conn.write_buf.empty()) queue_flush(r, conn);
+}
+
+void TcpGateway::send_ack(Reactor& r, ConnectionState& conn, uint64_t order_id, uint8_t status, const char* reason) {
     OrderAckMessage ack{};
-    ack.header = MessageHeader(ORDER_ACK, sizeof(OrderAckMessage), local_stats_.next_sequence++, now_timestamp());
+    ack.header = MessageHeader(ORDER_ACK, sizeof(OrderAckMessage), r.local_stats.next_sequence++, now_timestamp());
     ack.order_id = order_id;
     ack.status   = status;
-    if (reason) ack.reason.assign(reason);
+    if (reason) ack.reason.assign_truncate(reason);  // Error texts may exceed 31 chars
 
-    ssize_t sent = send(conn.fd.get(), &ack, sizeof(ack), MSG_NOSIGNAL);
-    if (sent > 0) ++local_stats_.messages_sent;
+    enqueue(r, conn, &ack, sizeof(ack));
 }
 
-void TcpGateway::send_reject(ConnectionState& conn, uint64_t order_id, const char* reason) {
-    send_ack(conn, order_id, 2, reason);
-    ++local_stats_.orders_rejected;
+void TcpGateway::send_reject(Reactor& r, ConnectionState& conn, uint64_t order_id, const char* reason) {
+    send_ack(r, conn, order_id, ACK_REJECTED, reason);
+    ++r.local_stats.orders_rejected;
 }
 
-void TcpGateway::remove_connection(int fd) {
-    if (static_cast<size_t>(fd) >= connections_.size()) return;
+void TcpGateway::send_trade(Reactor& r, ConnectionState& conn, const Trade& trade) {
+    TradeMessage msg{};
+    msg.header = MessageHeader(TRADE_REPORT, sizeof(TradeMessage), r.local_stats.next_sequence++, now_timestamp());
+    msg.trade_id      = trade.id;
+    msg.buy_order_id  = trade.buy_order_id;
+    msg.sell_order_id = trade.sell_order_id;
+    msg.symbol.assign(trade.symbol.c_str());
+    msg.quantity      = trade.quantity;
+    msg.price         = trade.price;
+    msg.timestamp_ns  = trade.timestamp;
+
+    enqueue(r, conn, &msg, sizeof(msg));
+}
+
+void TcpGateway::remove_connection(Reactor& r, ConnectionState& conn) {
+    if (!conn.in_use) return;
+    const int fd = conn.fd.get();
 #ifdef __APPLE__
     // kqueue automatically removes closed descriptors
 #else
-    epoll_ctl(epoll_fd_.get(), EPOLL_CTL_DEL, fd, nullptr);
+    if (r.uring) {
+        // In-flight ops hold the socket: shut it down so they complete, and
+        // finish here on the last CQE (the slot stays taken until then)
+        if (conn.recv_armed || conn.send_inflight) {
+            if (!conn.retiring) {
+                conn.retiring     = true;
+                conn.connected    = false;  // No more reports routed to it
+                conn.flush_queued = false;
+                shutdown(fd, SHUT_RDWR);
+            }
+            return;
+        }
+    } else {
+        epoll_ctl(r.epoll_fd.get(), EPOLL_CTL_DEL, fd, nullptr);
+    }
 #endif
-    connections_[fd].reset();
-    ++local_stats_.disconnections;
+    if (cancel_on_disconnect_ && !conn.client_id.empty() &&
+        !submit_mass_cancel(r, conn, conn.client_id, Symbol{})) [[unlikely]] {
+        LOG_WARN("Cancel-on-disconnect for {} dropped: risk queue full", conn.client_id.c_str());
+    }
+    if (capture_) [[unlikely]] {
+        capture_->record(r.index, CaptureEventType::CLOSE, static_cast<uint16_t>(conn.id), conn.generation,
+                         nullptr, 0);
+    }
+    if (conn.tls) [[unlikely]] {
+        tls_->abort(conn.tls);
+        conn.tls = nullptr;
+    }
+    if (session_auth_) session_auth_->release(conn.grant);
+    r.sessions.close(conn.session);
+    conn.disconnect();
+    r.connections->close(conn);
+    ++r.local_stats.disconnections;
+}
+
+void TcpGateway::record_ingress(Reactor& r, uint64_t rx_realtime_ns) {
+    const uint64_t now     = realtime_ns();
+    const uint64_t latency = now > rx_realtime_ns ? now - rx_realtime_ns : 0;
+    ++r.local_stats.ingress_samples;
+    r.local_stats.ingress_latency_sum_ns += latency;
+    r.local_stats.ingress_latency_max_ns = std::max(r.local_stats.ingress_latency_max_ns, latency);
+}
+
+IngressLatency TcpGateway::ingress_latency() const {
+    IngressLatency latency;
+    uint64_t sum = 0;
+    for (const auto& r : reactors_) {
+        latency.samples += r->stats_atomic.ingress_samples.load(std::memory_order_relaxed);
+        sum += r->stats_atomic.ingress_latency_sum_ns.load(std::memory_order_relaxed);
+        latency.max_ns = std::max(latency.max_ns,
+                                  r->stats_atomic.ingress_latency_max_ns.load(std::memory_order_relaxed));
+    }
+    latency.avg_ns = latency.samples ? sum / latency.samples : 0;
+    return latency;
 }
 
-void TcpGateway::maybe_flush_stats() {
-    if (local_stats_.messages_received % STATS_FLUSH_INTERVAL == 0 && local_stats_.messages_received > 0) {
-        flush_stats();
+void TcpGateway::maybe_flush_stats(Reactor& r) {
+    if (r.local_stats.messages_received % STATS_FLUSH_INTERVAL == 0 && r.local_stats.messages_received > 0) {
+        flush_stats(r);
     }
 }
 
-void TcpGateway::flush_stats() {
-    stats_atomic_.connections_accepted.store(local_stats_.connections_accepted, std::memory_order_relaxed);
-    stats_atomic_.messages_received.store(local_stats_.messages_received, std::memory_order_relaxed);
-    stats_atomic_.messages_sent.store(local_stats_.messages_sent, std::memory_order_relaxed);
-    stats_atomic_.disconnections.store(local_stats_.disconnections, std::memory_order_relaxed);
+void TcpGateway::flush_stats(Reactor& r) {
+    r.stats_atomic.connections_accepted.store(r.local_stats.connections_accepted, std::memory_order_relaxed);
+    r.stats_atomic.messages_received.store(r.local_stats.messages_received, std::memory_order_relaxed);
+    r.stats_atomic.messages_sent.store(r.local_stats.messages_sent, std::memory_order_relaxed);
+    r.stats_atomic.disconnections.store(r.local_stats.disconnections, std::memory_order_relaxed);
+    r.stats_atomic.send_calls.store(r.local_stats.send_calls, std::memory_order_relaxed);
+    r.stats_atomic.slow_consumers.store(r.local_stats.slow_consumers, std::memory_order_relaxed);
+    r.stats_atomic.drop_copy_overflows.store(r.local_stats.drop_copy_overflows, std::memory_order_relaxed);
+    r.stats_atomic.tls_sessions.store(r.local_stats.tls_sessions, std::memory_order_relaxed);
+    r.stats_atomic.tls_failures.store(r.local_stats.tls_failures, std::memory_order_relaxed);
+    r.stats_atomic.auth_rejects.store(r.local_stats.auth_rejects, std::memory_order_relaxed);
+    r.stats_atomic.ingress_samples.store(r.local_stats.ingress_samples, std::memory_order_relaxed);
+    r.stats_atomic.ingress_latency_sum_ns.store(r.local_stats.ingress_latency_sum_ns, std::memory_order_relaxed);
+    r.stats_atomic.ingress_latency_max_ns.store(r.local_stats.ingress_latency_max_ns, std::memory_order_relaxed);
 }
 
 } // namespace rtes
\ No newline at end of file
@@ -0,0 +1,73 @@
+/**
+ * @file thread_affinity.cpp
+ * @brief CPU pinning, SCHED_FIFO and memory locking for hot threads
+ */
+
+#include "rtes/thread_affinity.hpp"
+#include "rtes/logger.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+namespace rtes {
+
+ThreadPlacement apply_thread_placement(const ThreadPlacement& placement, const char* name) {
+    ThreadPlacement applied;
+
+#if defined(__linux__)
+    pthread_setname_np(pthread_self(), name);  // Truncation error ignored — name is cosmetic
+
+    if (placement.core >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(placement.core, &cpus);
+        const int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (rc == 0) {
+            applied.core = placement.core;
+        } else {
+            LOG_WARN("Could not pin {} to core {}: {}", name, placement.core, std::strerror(rc));
+        }
+    }
+
+    if (placement.fifo_priority > 0) {
+        sched_param param{};
+        param.sched_priority = placement.fifo_priority;
+        const int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (rc == 0) {
+            applied.fifo_priority = placement.fifo_priority;
+        } else {
+            LOG_WARN("Could not set SCHED_FIFO {} for {}: {}", placement.fifo_priority, name, std::strerror(rc));
+        }
+    }
+
+    if (applied.core >= 0 || applied.fifo_priority > 0) {
+        LOG_INFO("Thread {} placed: core={} fifo_priority={}", name, applied.core, applied.fifo_priority);
+    }
+#else
+    (void)placement;
+    (void)name;
+#endif
+
+    return applied;
+}
+
+bool lock_process_memory() {
+#if defined(__linux__)
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        LOG_WARN("mlockall failed: {}", std::strerror(errno));
+        return false;
+    }
+    LOG_INFO("Process memory locked (mlockall)");
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace rtes
@@ -0,0 +1,136 @@
+/**
+ * @file tls_offload.cpp
+ * @brief Non-blocking OpenSSL handshake handing the session to kernel TLS
+ */
+
+#include "rtes/tls_offload.hpp"
+#include "rtes/logger.hpp"
+
+#include <atomic>
+
+#ifndef RTES_NO_OPENSSL
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#endif
+
+namespace rtes {
+
+#ifndef RTES_NO_OPENSSL
+
+namespace {
+
+// What kTLS implements (TLS_CIPHER_AES_GCM_128/256, TLS_CIPHER_CHACHA20_POLY1305)
+constexpr const char* KTLS_CIPHERS_TLS12 =
+    "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:"
+    "ECDHE-ECDSA-AES256-GCM-SHA384:ECDHE-RSA-AES256-GCM-SHA384:"
+    "ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305";
+constexpr const char* KTLS_CIPHERS_TLS13 =
+    "TLS_AES_128_GCM_SHA256:TLS_AES_256_GCM_SHA384:TLS_CHACHA20_POLY1305_SHA256";
+
+std::string last_ssl_error() {
+    char text[256] = "unknown error";
+    if (const unsigned long code = ERR_get_error()) ERR_error_string_n(code, text, sizeof(text));
+    ERR_clear_error();
+    return text;
+}
+
+} // namespace
+
+TlsOffload::~TlsOffload() {
+    SSL_CTX_free(ctx_);
+}
+
+bool TlsOffload::init(const TlsOptions& options) {
+    SSL_CTX* ctx = SSL_CTX_new(TLS_server_method());
+    if (!ctx) return false;
+    SSL_CTX_set_min_proto_version(ctx, TLS1_2_VERSION);
+    SSL_CTX_set_options(ctx, SSL_OP_ENABLE_KTLS | SSL_OP_NO_RENEGOTIATION | SSL_OP_NO_TICKET |
+                                 SSL_OP_CIPHER_SERVER_PREFERENCE);
+    SSL_CTX_set_num_tickets(ctx, 0);  // No post-handshake records for the kernel to carry
+    SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_OFF);
+
+    const bool ok =
+        SSL_CTX_set_cipher_list(ctx, KTLS_CIPHERS_TLS12) == 1 &&
+        SSL_CTX_set_ciphersuites(ctx, KTLS_CIPHERS_TLS13) == 1 &&
+        SSL_CTX_use_certificate_chain_file(ctx, options.cert_file.c_str()) == 1 &&
+        SSL_CTX_use_PrivateKey_file(ctx, options.key_file.c_str(), SSL_FILETYPE_PEM) == 1 &&
+        SSL_CTX_check_private_key(ctx) == 1 &&
+        (options.ca_file.empty() ||
+         SSL_CTX_load_verify_locations(ctx, options.ca_file.c_str(), nullptr) == 1);
+    if (!ok) {
+        LOG_ERROR("TLS: cannot use certificate {} / key {}: {}", options.cert_file, options.key_file,
+                  last_ssl_error());
+        SSL_CTX_free(ctx);
+        return false;
+    }
+    if (!options.ca_file.empty()) {
+        SSL_CTX_set_verify(ctx, SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, nullptr);
+    }
+    SSL_CTX_free(ctx_);
+    ctx_ = ctx;
+    return true;
+}
+
+TlsHandshake* TlsOffload::begin(int fd) {
+    SSL* ssl = SSL_new(ctx_);
+    if (!ssl) return nullptr;
+    // Socket BIO without BIO_CLOSE: freeing the SSL leaves the fd to the gateway
+    if (SSL_set_fd(ssl, fd) != 1) {
+        SSL_free(ssl);
+        return nullptr;
+    }
+    SSL_set_accept_state(ssl);
+    return ssl;
+}
+
+TlsOffload::Status TlsOffload::advance(TlsHandshake* ssl) {
+    const int ret = SSL_do_handshake(ssl);
+    if (ret != 1) {
+        switch (SSL_get_error(ssl, ret)) {
+            case SSL_ERROR_WANT_READ:  return Status::WANT_READ;
+            case SSL_ERROR_WANT_WRITE: return Status::WANT_WRITE;
+            default:
+                ERR_clear_error();
+                SSL_free(ssl);
+                return Status::FAILED;
+        }
+    }
+    const bool offloaded = BIO_get_ktls_send(SSL_get_wbio(ssl)) && BIO_get_ktls_recv(SSL_get_rbio(ssl));
+    if (!offloaded) {
+        static std::atomic<bool> warned{false};
+        if (!warned.exchange(true, std::memory_order_relaxed)) {
+            LOG_WARN("TLS: {} {} session not offloaded to the kernel (tx {}, rx {}); such sessions are "
+                     "refused. Needs the tls module (modprobe tls) and OpenSSL with kTLS",
+                     SSL_get_version(ssl), SSL_get_cipher_name(ssl),
+                     BIO_get_ktls_send(SSL_get_wbio(ssl)) ? "yes" : "no",
+                     BIO_get_ktls_recv(SSL_get_rbio(ssl)) ? "yes" : "no");
+        }
+    }
+    // No SSL_shutdown: the kernel owns the session now, and close_notify would
+    // have to go through it
+    SSL_free(ssl);
+    return offloaded ? Status::DONE : Status::NO_OFFLOAD;
+}
+
+void TlsOffload::abort(TlsHandshake* ssl) {
+    SSL_free(ssl);
+}
+
+#else  // RTES_NO_OPENSSL
+
+TlsOffload::~TlsOffload() = default;
+
+bool TlsOffload::init(const TlsOptions&) {
+    LOG_ERROR("TLS: built without OpenSSL");
+    return false;
+}
+
+TlsHandshake* TlsOffload::begin(int) { return nullptr; }
+
+TlsOffload::Status TlsOffload::advance(TlsHandshake*) { return Status::FAILED; }
+
+void TlsOffload::abort(TlsHandshake*) {}
+
+#endif
+
+} // namespace rtes
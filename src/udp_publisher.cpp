@@ -6,48 +6,121 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <algorithm>
+#include <bit>
 #include <cerrno>
+#include <cstddef>
 #include <cstring>
 
 #ifdef __linux__
 #include <sys/sendfile.h>
 #endif
 
-#ifdef __x86_64__
-#include <immintrin.h>
-#include <sched.h>
-#endif
-
 namespace rtes {
 
 inline constexpr size_t MD_SPIN_ITERS = 256;
-inline constexpr size_t MD_PAUSE_PER_SPIN = 4;
 inline constexpr size_t MD_STATS_FLUSH = 2048;
 inline constexpr int SOCKET_SNDBUF_SIZE = 262144;
+
+static_assert(sizeof(UdpPacketHeader) + sizeof(DepthUpdateMessage) + MD_AUTH_TAG_BYTES <= MD_MIN_DATAGRAM,
+              "The largest message and a tag must fit in the smallest datagram");
+static_assert(sizeof(UdpPacketHeader) == MD_PACKET_HEADER_BYTES &&
+              offsetof(UdpPacketHeader, length) == MD_PACKET_LENGTH_OFFSET &&
+              offsetof(UdpPacketHeader, flags) == MD_PACKET_FLAGS_OFFSET);
+
+inline constexpr size_t MD_SYMBOL_BYTES = sizeof(BBOUpdateMessage::symbol);
+static_assert(MD_SYMBOL_BYTES == sizeof(TradeUpdateMessage::symbol) &&
+              MD_SYMBOL_BYTES == sizeof(DepthUpdateMessage::symbol) &&
+              MD_SYMBOL_BYTES <= sizeof(MarketDataEvent::symbol));
+
+namespace {
+
+/** Store `value` at `offset` of a packed message encoded in place (one unaligned store) */
+template <typename V>
+inline void put(uint8_t *out, size_t offset, const V &value) {
+    std::memcpy(out + offset, &value, sizeof(value));
+}
+
+/**
+ * Header of a `Msg` with the fields known at compile time pre-filled
+ * (type, length); put_header patches in the sequence and timestamp.
+ */
+template <typename Msg, uint32_t Type>
+inline constexpr UdpMessageHeader header_template{Type, sizeof(Msg), 0, 0};
+
+template <typename Msg, uint32_t Type>
+inline void put_header(uint8_t *out, uint64_t seq, Timestamp ts) {
+    UdpMessageHeader header = header_template<Msg, Type>;
+    header.sequence = seq;
+    header.timestamp_ns = ts;
+    std::memcpy(out, &header, sizeof(header));
+}
+
+/** Wire symbols are the first 8 bytes of MarketDataEvent::symbol */
+inline void put_symbol(uint8_t *out, size_t offset, const char *symbol) {
+    std::memcpy(out + offset, symbol, MD_SYMBOL_BYTES);
+}
+
+/** Same book level: symbol, side and price */
+bool same_level(const MarketDataEvent &a, const MarketDataEvent &b) {
+    return a.level.price == b.level.price && a.level.side == b.level.side &&
+           std::memcmp(a.symbol, b.symbol, sizeof(a.symbol)) == 0;
+}
+
+} // namespace
+
 inline constexpr int MULTICAST_TTL = 1;
 
-UdpPublisher::UdpPublisher(const std::string &multicast_group, uint16_t port, MPMCQueue<MarketDataEvent> *input_queue)
-    : multicast_group_(multicast_group), port_(port), input_queue_(input_queue) {
-    std::memset(&multicast_addr_, 0, sizeof(multicast_addr_));
-    multicast_addr_.sin_family = AF_INET;
-    multicast_addr_.sin_port = htons(port_);
-    inet_pton(AF_INET, multicast_group.c_str(), &multicast_addr_.sin_addr);
+UdpPublisher::UdpPublisher(const std::string &multicast_group, uint16_t port, MarketDataLane *input_queue, IdleStrategy *idle)
+    : own_idle_(IdlePolicy::SPIN_YIELD, MD_SPIN_ITERS), idle_(idle ? idle : &own_idle_) {
+    if (!multicast_group.empty()) add_channel(0, multicast_group, port);
+    if (input_queue) add_input(input_queue);
+}
+
+void UdpPublisher::add_input(MarketDataLane *lane) { inputs_.push_back(lane); }
+
+void UdpPublisher::add_channel(uint8_t channel, const std::string &group, uint16_t port) {
+    if (channel >= channels_.size()) channels_.resize(channel + size_t{1});
+    Channel &ch = channels_[channel];
+    std::memset(&ch.addr, 0, sizeof(ch.addr));
+    ch.addr.sin_family = AF_INET;
+    ch.addr.sin_port = htons(port);
+    inet_pton(AF_INET, group.c_str(), &ch.addr.sin_addr);
+    ch.next_sequence = 1;
+    ch.id = channel;
+    ch.enabled = true;
 }
 
 UdpPublisher::~UdpPublisher() { stop(); }
 
+void UdpPublisher::set_max_datagram_size(size_t bytes) {
+    max_datagram_ = std::clamp(bytes, MD_MIN_DATAGRAM, MD_MAX_DATAGRAM);
+}
+
+bool UdpPublisher::set_authentication(std::string_view key) {
+    auto auth = std::make_unique<DatagramAuthenticator>(key);
+    if (!auth->ready()) return false;
+    auth_ = std::move(auth);
+    tag_bytes_ = MD_AUTH_TAG_BYTES;
+    return true;
+}
+
 void UdpPublisher::start() {
     bool expected = false;
     if (!running_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) return;
     if (!setup_socket()) { running_.store(false); return; }
+    if (!xdp_options_.interface.empty()) setup_af_xdp();
     worker_thread_ = std::thread(&UdpPublisher::worker_loop, this);
 }
 
 void UdpPublisher::stop() {
     bool expected = true;
     if (!running_.compare_exchange_strong(expected, false, std::memory_order_acq_rel)) return;
+    idle_->notify();  // Unpark the worker so it sees running_ == false
     if (worker_thread_.joinable()) worker_thread_.join();
     socket_fd_.close();
+    xdp_.reset();
+    xdp_active_.store(false, std::memory_order_relaxed);
     flush_stats();
 }
 
@@ -64,111 +137,406 @@ bool UdpPublisher::setup_socket() {
     return true;
 }
 
+void UdpPublisher::setup_af_xdp() {
+    xdp_options_.ttl = MULTICAST_TTL;
+    auto xdp = std::make_unique<AfXdpSocket>();
+    if (!xdp->init(xdp_options_)) {
+        LOG_WARN("AF_XDP unavailable on {} queue {} ({}), market data uses the kernel UDP path",
+                 xdp_options_.interface, xdp_options_.queue, std::strerror(errno));
+        return;
+    }
+    size_t bypassed = 0;
+    for (Channel &channel : channels_) {
+        if (!channel.enabled) continue;
+        channel.xdp_destination = xdp->add_destination(channel.addr);
+        if (channel.xdp_destination >= 0) {
+            ++bypassed;
+        } else {
+            LOG_WARN("Market data channel {} is not multicast, it keeps the kernel UDP path", channel.id);
+        }
+    }
+    LOG_INFO("Market data via AF_XDP on {} queue {}{}: {} channel(s)", xdp_options_.interface,
+             xdp_options_.queue, xdp_options_.zero_copy ? " (zero-copy)" : "", bypassed);
+    xdp_ = std::move(xdp);
+    xdp_active_.store(true, std::memory_order_relaxed);
+}
+
 void UdpPublisher::worker_loop() {
+    applied_placement_.store(apply_thread_placement(placement_, "udp_publisher"),
+                             std::memory_order_relaxed);
     std::array<MarketDataEvent, MD_BATCH_SIZE> events{};
     std::array<SendBuffer, SENDMMSG_BATCH> send_buffers{};
     while (running_.load(std::memory_order_relaxed)) {
         size_t event_count = drain_events(events);
         if (event_count > 0) {
+            idle_->on_work();
             size_t msg_count = build_datagrams(events, event_count, send_buffers);
             if (msg_count > 0) batch_send(send_buffers, msg_count);
             maybe_flush_stats();
         } else {
-            spin_wait();
+            idle_->idle([this] {
+                return std::any_of(inputs_.begin(), inputs_.end(),
+                                   [](MarketDataLane *lane) { return !lane->consumer_empty(); });
+            });
         }
     }
 }
 
 size_t UdpPublisher::drain_events(std::array<MarketDataEvent, MD_BATCH_SIZE> &events) {
+    const size_t lanes = inputs_.size();
+    if (lanes == 0) [[unlikely]] return 0;
+
     size_t count = 0;
-    while (count < MD_BATCH_SIZE && input_queue_->pop(events[count])) ++count;
+    for (size_t i = 0; i < lanes && count < MD_BATCH_SIZE; ++i) {
+        MarketDataLane *lane = inputs_[(next_input_ + i) % lanes];
+        count += lane->try_pop_bulk(events.data() + count, MD_BATCH_SIZE - count);
+    }
+    next_input_ = (next_input_ + 1) % lanes;
     return count;
 }
 
+/**
+ * Encode a drained batch into packets, channel by channel: each channel
+ * has its own destination and sequence space, and a packet never mixes
+ * channels. Events of a channel this publisher does not serve are
+ * counted and dropped. A full buffer array is sent mid-batch; returns
+ * the packets left for the caller to send.
+ */
 size_t UdpPublisher::build_datagrams(const std::array<MarketDataEvent, MD_BATCH_SIZE> &events, size_t event_count, std::array<SendBuffer, SENDMMSG_BATCH> &buffers) {
-    size_t msg_count = 0;
-    for (size_t i = 0; i < event_count && msg_count < SENDMMSG_BATCH; ++i) {
-        const auto &event = events[i];
-        auto &buf = buffers[msg_count];
-        if (event.type == MarketDataEvent::BBO_UPDATE) {
-            buf.length = build_bbo_datagram(event, buf.data);
+    std::array<bool, MD_BATCH_SIZE> taken{};
+    std::array<const MarketDataEvent *, MD_BATCH_SIZE> mine;
+    size_t packet_count = 0;
+    const Timestamp ts = now_timestamp();  // One publish time for the whole batch
+
+    for (size_t first = 0; first < event_count; ++first) {
+        if (taken[first]) continue;
+        const uint8_t id = events[first].channel;
+        size_t count = 0;
+        for (size_t i = first; i < event_count; ++i) {
+            if (taken[i] || events[i].channel != id) continue;
+            taken[i] = true;
+            mine[count++] = &events[i];
+        }
+        if (id >= channels_.size() || !channels_[id].enabled) [[unlikely]] {
+            local_stats_.unrouted += count;
+            continue;
+        }
+        packet_count = pack_channel(channels_[id], mine.data(), count, ts, buffers, packet_count);
+    }
+    return packet_count;
+}
+
+/**
+ * Pack one channel's events: each datagram is a UdpPacketHeader followed
+ * by as many messages as fit in max_datagram_ bytes (less the tag when
+ * signing), so a burst costs a handful of packets rather than one per
+ * message. A signed packet gets its tag as it is closed. Nothing waits for a
+ * packet to fill — the last one of a batch goes out part-full.
+ *
+ * BBO, trade, sweep and order (market by order) events map one-to-one to
+ * messages; order events are never coalesced, their sequence is the book's. DEPTH_LEVEL events are
+ * coalesced per (symbol, side, price) — only a level's last state in the
+ * batch goes out — and packed into DepthUpdateMessages after the rest,
+ * so the depth message rate is bounded by distinct levels per batch, not
+ * by the order rate. With BBO conflation, a BBO followed by a later one
+ * for the same symbol in the batch is dropped.
+ */
+size_t UdpPublisher::pack_channel(Channel &channel, const MarketDataEvent *const *events, size_t event_count,
+                                  Timestamp ts, std::array<SendBuffer, SENDMMSG_BATCH> &buffers,
+                                  size_t packet_count) {
+    std::array<const MarketDataEvent *, MD_BATCH_SIZE> levels;
+    size_t level_count = 0;
+
+    // Walk backwards: the first BBO seen per symbol is its last, the rest are superseded
+    std::array<bool, MD_BATCH_SIZE> superseded{};
+    if (bbo_conflation_) {
+        std::array<const MarketDataEvent *, MD_BATCH_SIZE> latest;
+        size_t latest_count = 0;
+        for (size_t i = event_count; i-- > 0;) {
+            if (events[i]->type != MarketDataEvent::BBO_UPDATE) continue;
+            size_t j = 0;
+            while (j < latest_count &&
+                   std::memcmp(latest[j]->symbol, events[i]->symbol, sizeof(events[i]->symbol)) != 0) ++j;
+            if (j < latest_count) {
+                superseded[i] = true;
+                ++local_stats_.bbo_conflated;
+            } else {
+                latest[latest_count++] = events[i];
+            }
+        }
+    }
+
+    bool open = false;
+    auto close_packet = [&] {
+        SendBuffer &buf = buffers[packet_count++];
+        UdpPacketHeader header{};
+        header.sequence = channel.next_sequence - buf.messages;
+        header.message_count = buf.messages;
+        header.length = static_cast<uint16_t>(buf.length);
+        std::memcpy(buf.data, &header, sizeof(header));
+        if (auth_) buf.length = auth_->sign(buf.data, buf.length);
+        if (retransmit_queue_) retain(channel, buf);
+        open = false;
+    };
+    // Room for a message of `bytes`, closing the packet (and sending a full array) as needed
+    auto reserve = [&](size_t bytes) -> SendBuffer & {
+        if (open && buffers[packet_count].length + bytes + tag_bytes_ > max_datagram_) close_packet();
+        if (!open) {
+            if (packet_count == SENDMMSG_BATCH) [[unlikely]] {
+                batch_send(buffers, packet_count);
+                packet_count = 0;
+            }
+            buffers[packet_count].length = sizeof(UdpPacketHeader);
+            buffers[packet_count].messages = 0;
+            buffers[packet_count].dest = &channel.addr;
+            buffers[packet_count].xdp_destination = channel.xdp_destination;
+            open = true;
+        }
+        return buffers[packet_count];
+    };
+    auto append = [&](SendBuffer &buf, size_t bytes) {
+        buf.length += bytes;
+        ++buf.messages;
+        ++channel.next_sequence;
+    };
+
+    for (size_t i = 0; i < event_count; ++i) {
+        const auto &event = *events[i];
+        if (event.type == MarketDataEvent::DEPTH_LEVEL) {
+            size_t j = 0;
+            while (j < level_count && !same_level(*levels[j], event)) ++j;
+            levels[j] = &event;  // Later state of a level replaces the earlier one
+            if (j == level_count) ++level_count;
+        } else if (event.type == MarketDataEvent::BBO_UPDATE) {
+            if (superseded[i]) continue;
+            SendBuffer &buf = reserve(sizeof(BBOUpdateMessage));
+            append(buf, build_bbo_message(event, channel.next_sequence, ts, buf.data + buf.length));
         } else if (event.type == MarketDataEvent::TRADE) {
-            buf.length = build_trade_datagram(event, buf.data);
+            SendBuffer &buf = reserve(sizeof(TradeUpdateMessage));
+            append(buf, build_trade_message(event, channel.next_sequence, ts, buf.data + buf.length));
+        } else if (event.type == MarketDataEvent::ORDER_EVENT) {
+            SendBuffer &buf = reserve(sizeof(OrderUpdateMessage));
+            append(buf, build_order_message(event, channel.next_sequence, ts, buf.data + buf.length));
+        } else if (event.type == MarketDataEvent::SWEEP) {
+            SendBuffer &buf = reserve(sizeof(SweepSummaryMessage));
+            append(buf, build_sweep_message(event, channel.next_sequence, ts, buf.data + buf.length));
+        }
+    }
+
+    std::array<bool, MD_BATCH_SIZE> sent{};
+    for (size_t i = 0; i < level_count; ++i) {
+        if (sent[i]) continue;
+        SendBuffer &buf = reserve(sizeof(DepthUpdateMessage));
+        append(buf, build_depth_message(levels.data() + i, level_count - i, sent.data() + i,
+                                        channel.next_sequence, ts, buf.data + buf.length));
+    }
+    if (open) close_packet();
+    return packet_count;
+}
+
+/** Hand a finished datagram to the retransmission ring; dropped (and counted) if it is full. */
+void UdpPublisher::retain(const Channel &channel, const SendBuffer &buf) {
+    RetransmitRecord record;
+    record.length = static_cast<uint16_t>(buf.length);
+    record.channel = channel.id;
+    std::memcpy(record.data, buf.data, buf.length);
+    if (!retransmit_queue_->push(record)) [[unlikely]] ++local_stats_.retransmit_overflows;
+}
+
+size_t UdpPublisher::build_bbo_message(const MarketDataEvent &event, uint64_t seq, Timestamp ts, uint8_t *out) {
+    put_header<BBOUpdateMessage, rtes::BBO_UPDATE>(out, seq, ts);
+    put_symbol(out, offsetof(BBOUpdateMessage, symbol), event.symbol);
+    put(out, offsetof(BBOUpdateMessage, bid_price), event.bbo.bid_price);
+    put(out, offsetof(BBOUpdateMessage, bid_quantity), event.bbo.bid_quantity);
+    put(out, offsetof(BBOUpdateMessage, ask_price), event.bbo.ask_price);
+    put(out, offsetof(BBOUpdateMessage, ask_quantity), event.bbo.ask_quantity);
+    return sizeof(BBOUpdateMessage);
+}
+
+size_t UdpPublisher::build_trade_message(const MarketDataEvent &event, uint64_t seq, Timestamp ts, uint8_t *out) {
+    put_header<TradeUpdateMessage, rtes::TRADE_UPDATE>(out, seq, ts);
+    put(out, offsetof(TradeUpdateMessage, trade_id), event.trade.id);
+    put_symbol(out, offsetof(TradeUpdateMessage, symbol), event.symbol);
+    put(out, offsetof(TradeUpdateMessage, quantity), event.trade.quantity);
+    put(out, offsetof(TradeUpdateMessage, price), event.trade.price);
+    put(out, offsetof(TradeUpdateMessage, aggressor_side), event.aggressor_side);
+    put(out, offsetof(TradeUpdateMessage, match_timestamp_ns), event.trade.timestamp);
+
+    if (event.trade.timestamp != 0 && ts >= event.trade.timestamp) [[likely]] {
+        const uint64_t delay = ts - event.trade.timestamp;
+        MarketDataDelay &stats = local_stats_.delay;
+        const size_t bucket = delay == 0 ? 0 : std::bit_width((delay - 1) / md_delay_bound_ns(0));
+        ++stats.buckets[std::min(bucket, MD_DELAY_BUCKETS - 1)];
+        ++stats.samples;
+        stats.sum_ns += delay;
+        stats.max_ns = std::max(stats.max_ns, delay);
+    }
+    return sizeof(TradeUpdateMessage);
+}
+
+size_t UdpPublisher::build_order_message(const MarketDataEvent &event, uint64_t seq, Timestamp ts, uint8_t *out) {
+    put_header<OrderUpdateMessage, rtes::ORDER_UPDATE>(out, seq, ts);
+    put_symbol(out, offsetof(OrderUpdateMessage, symbol), event.symbol);
+    put(out, offsetof(OrderUpdateMessage, order_id), event.order.order_id);
+    put(out, offsetof(OrderUpdateMessage, price), event.order.price);
+    put(out, offsetof(OrderUpdateMessage, remaining), event.order.remaining);
+    put(out, offsetof(OrderUpdateMessage, quantity), event.order.quantity);
+    put(out, offsetof(OrderUpdateMessage, kind), static_cast<uint8_t>(event.order.kind));
+    put(out, offsetof(OrderUpdateMessage, side), static_cast<uint8_t>(event.order.side));
+    return sizeof(OrderUpdateMessage);
+}
+
+size_t UdpPublisher::build_sweep_message(const MarketDataEvent &event, uint64_t seq, Timestamp ts, uint8_t *out) {
+    put_header<SweepSummaryMessage, rtes::SWEEP_SUMMARY>(out, seq, ts);
+    put_symbol(out, offsetof(SweepSummaryMessage, symbol), event.symbol);
+    put(out, offsetof(SweepSummaryMessage, first_trade_id), event.sweep.first_trade_id);
+    put(out, offsetof(SweepSummaryMessage, first_price), event.sweep.first_price);
+    put(out, offsetof(SweepSummaryMessage, last_price), event.sweep.last_price);
+    put(out, offsetof(SweepSummaryMessage, quantity), event.sweep.quantity);
+    put(out, offsetof(SweepSummaryMessage, fills), event.sweep.fills);
+    put(out, offsetof(SweepSummaryMessage, aggressor_side), event.aggressor_side);
+    return sizeof(SweepSummaryMessage);
+}
+
+/**
+ * Pack levels[0]'s symbol: every unsent level of that symbol, up to
+ * DEPTH_UPDATE_SIDE_LEVELS per side, bids first. Marks what it packed;
+ * the rest goes in the next message. Level slots left unused are zeroed.
+ */
+size_t UdpPublisher::build_depth_message(const MarketDataEvent *const *levels, size_t count,
+                                         bool *sent, uint64_t seq, Timestamp ts, uint8_t *out) {
+    put_header<DepthUpdateMessage, rtes::DEPTH_UPDATE>(out, seq, ts);
+    put_symbol(out, offsetof(DepthUpdateMessage, symbol), levels[0]->symbol);
+
+    uint8_t *const bids = out + offsetof(DepthUpdateMessage, levels);
+    std::array<DepthUpdateLevel, DEPTH_UPDATE_SIDE_LEVELS> asks;
+    size_t bid_count = 0, ask_count = 0;
+    uint64_t update_sequence = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (sent[i] || std::memcmp(levels[i]->symbol, levels[0]->symbol, sizeof(levels[i]->symbol)) != 0) continue;
+        const auto &level = levels[i]->level;
+        const DepthUpdateLevel entry{level.price, level.quantity, level.order_count};
+        update_sequence = std::max(update_sequence, level.update_sequence);
+        if (level.side == Side::BUY) {
+            if (bid_count == DEPTH_UPDATE_SIDE_LEVELS) continue;
+            put(bids, bid_count++ * sizeof(DepthUpdateLevel), entry);
         } else {
-            continue;
+            if (ask_count == DEPTH_UPDATE_SIDE_LEVELS) continue;
+            asks[ask_count++] = entry;
         }
-        if (buf.length > 0) ++msg_count;
-    }
-    return msg_count;
-}
-
-size_t UdpPublisher::build_bbo_datagram(const MarketDataEvent &event, uint8_t *out) {
-    const Timestamp ts = now_timestamp();
-    const uint64_t seq = local_stats_.next_sequence++;
-    BBOUpdateMessage msg{};
-    msg.header = UdpMessageHeader(rtes::BBO_UPDATE, sizeof(BBOUpdateMessage), seq, ts);
-    std::memcpy(msg.symbol, event.symbol, sizeof(msg.symbol));
-    msg.bid_price = event.bbo.bid_price;
-    msg.bid_quantity = event.bbo.bid_quantity;
-    msg.ask_price = event.bbo.ask_price;
-    msg.ask_quantity = event.bbo.ask_quantity;
-    std::memcpy(out, &msg, sizeof(msg));
-    return sizeof(msg);
-}
-
-size_t UdpPublisher::build_trade_datagram(const MarketDataEvent &event, uint8_t *out) {
-    const Timestamp ts = now_timestamp();
-    const uint64_t seq = local_stats_.next_sequence++;
-    TradeUpdateMessage msg{};
-    msg.header = UdpMessageHeader(rtes::TRADE_UPDATE, sizeof(TradeUpdateMessage), seq, ts);
-    msg.trade_id = event.trade.id;
-    std::memcpy(msg.symbol, event.symbol, sizeof(msg.symbol));
-    msg.quantity = event.trade.quantity;
-    msg.price = event.trade.price;
-    msg.aggressor_side = 1;
-    std::memcpy(out, &msg, sizeof(msg));
-    return sizeof(msg);
+        sent[i] = true;
+    }
+    std::memcpy(bids + bid_count * sizeof(DepthUpdateLevel), asks.data(), ask_count * sizeof(DepthUpdateLevel));
+    const size_t used = (bid_count + ask_count) * sizeof(DepthUpdateLevel);
+    std::memset(bids + used, 0, 2 * DEPTH_UPDATE_SIDE_LEVELS * sizeof(DepthUpdateLevel) - used);
+
+    put(out, offsetof(DepthUpdateMessage, update_sequence), update_sequence);
+    put(out, offsetof(DepthUpdateMessage, num_bid_levels), static_cast<uint8_t>(bid_count));
+    put(out, offsetof(DepthUpdateMessage, num_ask_levels), static_cast<uint8_t>(ask_count));
+    return sizeof(DepthUpdateMessage);
 }
 
 void UdpPublisher::batch_send(const std::array<SendBuffer, SENDMMSG_BATCH> &buffers, size_t count) {
+    if (xdp_) {
+        xdp_send(buffers, count);
+        return;
+    }
+    std::array<const SendBuffer *, SENDMMSG_BATCH> batch;
+    for (size_t i = 0; i < count; ++i) batch[i] = &buffers[i];
+    kernel_send(batch, count);
+}
+
+/** The datagrams through the kernel UDP stack, in one sendmmsg where available. Returns those sent. */
+size_t UdpPublisher::kernel_send(const std::array<const SendBuffer *, SENDMMSG_BATCH> &buffers, size_t count) {
+    size_t sent = 0;
 #ifdef __linux__
     std::array<struct iovec, SENDMMSG_BATCH> iovecs{};
     std::array<struct mmsghdr, SENDMMSG_BATCH> msgs{};
     for (size_t i = 0; i < count; ++i) {
-        iovecs[i].iov_base = const_cast<uint8_t *>(buffers[i].data);
-        iovecs[i].iov_len = buffers[i].length;
-        msgs[i].msg_hdr.msg_name = &multicast_addr_;
-        msgs[i].msg_hdr.msg_namelen = sizeof(multicast_addr_);
+        iovecs[i].iov_base = const_cast<uint8_t *>(buffers[i]->data);
+        iovecs[i].iov_len = buffers[i]->length;
+        msgs[i].msg_hdr.msg_name = const_cast<sockaddr_in *>(buffers[i]->dest);
+        msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
         msgs[i].msg_hdr.msg_iov = &iovecs[i];
         msgs[i].msg_hdr.msg_iovlen = 1;
     }
-    int sent = sendmmsg(socket_fd_.get(), msgs.data(), static_cast<unsigned int>(count), MSG_DONTWAIT);
-    if (sent > 0) {
-        local_stats_.messages_sent += static_cast<size_t>(sent);
+    const int result = count ? sendmmsg(socket_fd_.get(), msgs.data(), static_cast<unsigned int>(count), MSG_DONTWAIT) : 0;
+    sent = result > 0 ? static_cast<size_t>(result) : 0;
+    for (size_t i = 0; i < sent; ++i) {
+        local_stats_.messages_sent += buffers[i]->messages;
+        ++local_stats_.packets_sent;
     }
 #else
     for (size_t i = 0; i < count; ++i) {
-        ssize_t sent = sendto(socket_fd_.get(), buffers[i].data, buffers[i].length, 0,
-                              reinterpret_cast<const sockaddr *>(&multicast_addr_), sizeof(multicast_addr_));
-        if (sent > 0) local_stats_.messages_sent++;
+        if (sendto(socket_fd_.get(), buffers[i]->data, buffers[i]->length, 0,
+                   reinterpret_cast<const sockaddr *>(buffers[i]->dest), sizeof(sockaddr_in)) > 0) {
+            local_stats_.messages_sent += buffers[i]->messages;
+            ++local_stats_.packets_sent;
+            ++sent;
+        }
     }
 #endif
+    return sent;
 }
 
-void UdpPublisher::spin_wait() {
-#ifdef __x86_64__
-    sched_yield();
-#else
-    std::this_thread::yield();
-#endif
+/**
+ * The batch onto the TX ring in one submit. A full ring or frame pool
+ * drops the datagram (as a full socket buffer does for sendmmsg); the
+ * kernel path would reorder it behind frames still queued. Datagrams of
+ * channels without an XDP destination still leave in one sendmmsg.
+ */
+void UdpPublisher::xdp_send(const std::array<SendBuffer, SENDMMSG_BATCH> &buffers, size_t count) {
+    std::array<const SendBuffer *, SENDMMSG_BATCH> kernel;
+    size_t kernel_count = 0;
+    bool queued = false;
+    for (size_t i = 0; i < count; ++i) {
+        const SendBuffer &buf = buffers[i];
+        if (buf.xdp_destination < 0) {
+            kernel[kernel_count++] = &buf;
+            continue;
+        }
+        if (!xdp_->enqueue(buf.xdp_destination, buf.data, buf.length)) {
+            ++local_stats_.send_failures;
+            continue;
+        }
+        queued = true;
+        local_stats_.messages_sent += buf.messages;
+        ++local_stats_.packets_sent;
+    }
+    if (queued) xdp_->submit();
+    if (kernel_count > 0) local_stats_.send_failures += kernel_count - kernel_send(kernel, kernel_count);
+}
+
+MarketDataDelay UdpPublisher::publish_delay() const {
+    MarketDataDelay out;
+    out.samples = stats_atomic_.delay_samples.load(std::memory_order_relaxed);
+    out.sum_ns = stats_atomic_.delay_sum_ns.load(std::memory_order_relaxed);
+    out.max_ns = stats_atomic_.delay_max_ns.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < MD_DELAY_BUCKETS; ++i) {
+        out.buckets[i] = stats_atomic_.delay_buckets[i].load(std::memory_order_relaxed);
+    }
+    return out;
 }
 
 void UdpPublisher::maybe_flush_stats() {
-    if (local_stats_.messages_sent % MD_STATS_FLUSH == 0 && local_stats_.messages_sent > 0) flush_stats();
+    if (local_stats_.messages_sent - local_stats_.flushed_at >= MD_STATS_FLUSH) flush_stats();
 }
 
 void UdpPublisher::flush_stats() {
+    local_stats_.flushed_at = local_stats_.messages_sent;
     stats_atomic_.messages_sent.store(local_stats_.messages_sent, std::memory_order_relaxed);
+    stats_atomic_.packets_sent.store(local_stats_.packets_sent, std::memory_order_relaxed);
+    stats_atomic_.unrouted.store(local_stats_.unrouted, std::memory_order_relaxed);
+    stats_atomic_.bbo_conflated.store(local_stats_.bbo_conflated, std::memory_order_relaxed);
+    stats_atomic_.retransmit_overflows.store(local_stats_.retransmit_overflows, std::memory_order_relaxed);
+    stats_atomic_.send_failures.store(local_stats_.send_failures, std::memory_order_relaxed);
+    const MarketDataDelay &delay = local_stats_.delay;
+    stats_atomic_.delay_samples.store(delay.samples, std::memory_order_relaxed);
+    stats_atomic_.delay_sum_ns.store(delay.sum_ns, std::memory_order_relaxed);
+    stats_atomic_.delay_max_ns.store(delay.max_ns, std::memory_order_relaxed);
+    for (size_t i = 0; i < MD_DELAY_BUCKETS; ++i) {
+        stats_atomic_.delay_buckets[i].store(delay.buckets[i], std::memory_order_relaxed);
+    }
 }
 
 } // namespace rtes
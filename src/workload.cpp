@@ -0,0 +1,273 @@
+/**
+ * @file workload.cpp
+ * @brief Synthetic order flow profiles for the benchmarks
+ */
+
+#include "rtes/workload.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace rtes {
+
+namespace {
+
+constexpr Quantity LOT = 100;
+constexpr size_t   MIN_MID_TICKS = 200;
+constexpr size_t   MARKET_MAKER_QUOTES = 256;   // Tracked per symbol; older ones are assumed taken
+constexpr size_t   ZIPF_RESTING = 1024;
+constexpr size_t   LADDER_EXTRA_LEVELS = 5;     // MOMENTUM: quoted beyond the sweep
+constexpr size_t   LADDER_ORDERS_PER_LEVEL = 2;
+constexpr double   TREND_PERSISTENCE = 0.7;
+
+Side opposite(Side side) { return side == Side::BUY ? Side::SELL : Side::BUY; }
+
+} // namespace
+
+WorkloadGenerator::WorkloadGenerator(const WorkloadOptions& options)
+    : options_(options)
+    , rng_(options.seed) {
+    if (options_.tick == 0) throw std::invalid_argument("Workload tick must be > 0");
+    options_.mid -= options_.mid % options_.tick;
+    if (options_.mid / options_.tick < MIN_MID_TICKS) {
+        throw std::invalid_argument("Workload mid must be at least 200 ticks");
+    }
+    if (options_.profile == WorkloadProfile::MOMENTUM &&
+        (options_.sweep_levels == 0 || options_.mid / options_.tick < 4 * options_.sweep_levels + 20)) {
+        throw std::invalid_argument("Workload sweep must be 1 to (mid / tick - 20) / 4 levels");
+    }
+
+    symbols_ = options_.symbols;
+    if (symbols_.empty()) {
+        for (size_t i = 0; i < options_.symbol_count; ++i) symbols_.push_back("SYM" + std::to_string(i));
+    }
+    if (symbols_.empty()) throw std::invalid_argument("Workload needs at least one symbol");
+    books_.resize(symbols_.size());
+    for (Book& book : books_) book.mid = options_.mid;
+
+    double exponent = options_.zipf_exponent;
+    if (exponent < 0) exponent = options_.profile == WorkloadProfile::ZIPF ? 1.1 : 0.0;
+    if (exponent > 0 && symbols_.size() > 1) {
+        double total = 0;
+        for (size_t i = 0; i < symbols_.size(); ++i) {
+            total += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+            zipf_cdf_.push_back(total);
+        }
+        for (double& p : zipf_cdf_) p /= total;
+    }
+}
+
+WorkloadRequest WorkloadGenerator::next() {
+    if (pending_head_ == pending_.size()) {
+        pending_.clear();
+        pending_head_ = 0;
+        while (pending_.empty()) refill();
+    }
+    return pending_[pending_head_++];
+}
+
+const char* WorkloadGenerator::profile_name(WorkloadProfile profile) {
+    switch (profile) {
+        case WorkloadProfile::UNIFORM:      return "uniform";
+        case WorkloadProfile::MARKET_MAKER: return "market_maker";
+        case WorkloadProfile::ZIPF:         return "zipf";
+        case WorkloadProfile::MOMENTUM:     return "momentum";
+        case WorkloadProfile::AUCTION_OPEN: return "auction_open";
+    }
+    return "unknown";
+}
+
+std::optional<WorkloadProfile> WorkloadGenerator::parse_profile(std::string_view name) {
+    for (WorkloadProfile profile : ALL_WORKLOAD_PROFILES) {
+        if (name == profile_name(profile)) return profile;
+    }
+    return std::nullopt;
+}
+
+// ─── Profiles ───
+
+void WorkloadGenerator::refill() {
+    switch (options_.profile) {
+        case WorkloadProfile::UNIFORM:      refill_uniform();      break;
+        case WorkloadProfile::MARKET_MAKER: refill_market_maker(); break;
+        case WorkloadProfile::ZIPF:         refill_zipf();         break;
+        case WorkloadProfile::MOMENTUM:     refill_momentum();     break;
+        case WorkloadProfile::AUCTION_OPEN: refill_auction_open(); break;
+    }
+}
+
+void WorkloadGenerator::refill_uniform() {
+    const uint32_t symbol = pick_symbol();
+    const Side side = chance(0.5) ? Side::BUY : Side::SELL;
+    const auto ticks = static_cast<int64_t>(uniform(0, 200)) - 100;
+    new_order(symbol, side, OrderType::LIMIT, offset(books_[symbol].mid, side, ticks),
+              uniform(100, 1000), false);
+}
+
+void WorkloadGenerator::refill_market_maker() {
+    const uint32_t symbol = pick_symbol();
+    Book& book = books_[symbol];
+    drift(book);
+
+    // Quotes cluster at the touch: 40% one tick off the mid, 10% five ticks
+    const uint64_t r = uniform(0, 99);
+    const int64_t ticks = r < 40 ? 1 : r < 65 ? 2 : r < 80 ? 3 : r < 90 ? 4 : 5;
+    const Side side = chance(0.5) ? Side::BUY : Side::SELL;
+    new_order(symbol, side, OrderType::LIMIT, offset(book.mid, side, ticks), uniform(1, 5) * LOT, true);
+
+    if (chance(options_.cancel_ratio)) {
+        cancel_random(symbol);
+    } else {
+        const Side taker = chance(0.5) ? Side::BUY : Side::SELL;
+        new_order(symbol, taker, OrderType::IOC, offset(book.mid, taker, -2), uniform(1, 3) * LOT, false);
+    }
+    if (book.resting.size() > MARKET_MAKER_QUOTES) {
+        book.resting[uniform(0, book.resting.size() - 1)] = book.resting.back();
+        book.resting.pop_back();
+    }
+}
+
+void WorkloadGenerator::refill_zipf() {
+    const uint32_t symbol = pick_symbol();
+    Book& book = books_[symbol];
+    drift(book);
+
+    const uint64_t r = uniform(0, 99);
+    const Side side = chance(0.5) ? Side::BUY : Side::SELL;
+    if (r < 25 && !book.resting.empty()) {
+        cancel_random(symbol);
+    } else if (r < 40) {
+        new_order(symbol, side, OrderType::IOC, offset(book.mid, side, -5), uniform(1, 5) * LOT, false);
+    } else {
+        new_order(symbol, side, OrderType::LIMIT, offset(book.mid, side, static_cast<int64_t>(uniform(1, 10))),
+                  uniform(1, 5) * LOT, true);
+    }
+    if (book.resting.size() > ZIPF_RESTING) {
+        book.resting[uniform(0, book.resting.size() - 1)] = book.resting.back();
+        book.resting.pop_back();
+    }
+}
+
+void WorkloadGenerator::refill_momentum() {
+    const uint32_t symbol = pick_symbol();
+    Book& book = books_[symbol];
+    const auto sweep = static_cast<int64_t>(options_.sweep_levels);
+
+    // Requote: pull what is left of the last ladder, quote a fresh one
+    while (!book.resting.empty()) cancel(symbol, book.resting.size() - 1);
+    const int64_t levels = sweep + static_cast<int64_t>(LADDER_EXTRA_LEVELS);
+    for (int64_t level = 1; level <= levels; ++level) {
+        for (size_t i = 0; i < LADDER_ORDERS_PER_LEVEL; ++i) {
+            new_order(symbol, Side::BUY, OrderType::LIMIT, offset(book.mid, Side::BUY, level), LOT, true);
+            new_order(symbol, Side::SELL, OrderType::LIMIT, offset(book.mid, Side::SELL, level), LOT, true);
+        }
+    }
+
+    // The burst: one IOC through `sweep` levels, exactly their quantity
+    if (!chance(TREND_PERSISTENCE)) book.trend = -book.trend;
+    const Price jump = static_cast<Price>(sweep) * options_.tick;
+    // The mid stays within [mid / 2, mid * 2]; the constructor keeps the lowest ladder above 0
+    if ((book.trend > 0 && book.mid + jump > options_.mid * 2) ||
+        (book.trend < 0 && book.mid < options_.mid / 2 + jump)) {
+        book.trend = -book.trend;
+    }
+    const Side taker = book.trend > 0 ? Side::BUY : Side::SELL;
+    const Side passive = opposite(taker);
+    const Price limit = offset(book.mid, passive, sweep);
+    new_order(symbol, taker, OrderType::IOC, limit,
+              static_cast<Quantity>(sweep) * LADDER_ORDERS_PER_LEVEL * LOT, false);
+    std::erase_if(book.resting, [&](const Resting& r) {
+        return r.side == passive && (passive == Side::SELL ? r.price <= limit : r.price >= limit);
+    });
+    book.mid = book.trend > 0 ? book.mid + jump : book.mid - jump;
+}
+
+void WorkloadGenerator::refill_auction_open() {
+    const uint32_t symbol = pick_symbol();
+    Book& book = books_[symbol];
+
+    set_phase(symbol, TradingPhase::AUCTION);
+    for (size_t i = 0; i < options_.auction_orders; ++i) {
+        // Half the flood is priced through the mid: the book crosses until the uncross
+        const Side side = chance(0.5) ? Side::BUY : Side::SELL;
+        const auto ticks = static_cast<int64_t>(uniform(0, 20)) - 10;
+        new_order(symbol, side, OrderType::LIMIT, offset(book.mid, side, ticks), uniform(1, 10) * LOT, true);
+    }
+    set_phase(symbol, TradingPhase::CONTINUOUS);
+    while (!book.resting.empty()) cancel(symbol, book.resting.size() - 1);
+
+    const auto move = static_cast<int64_t>(uniform(0, 10)) - 5;
+    book.mid = offset(book.mid, Side::SELL, move);
+}
+
+// ─── Helpers ───
+
+uint32_t WorkloadGenerator::pick_symbol() {
+    if (zipf_cdf_.empty()) return static_cast<uint32_t>(uniform(0, symbols_.size() - 1));
+    const double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng_);
+    const auto it = std::lower_bound(zipf_cdf_.begin(), zipf_cdf_.end(), u);
+    return static_cast<uint32_t>(std::min<size_t>(it - zipf_cdf_.begin(), symbols_.size() - 1));
+}
+
+uint64_t WorkloadGenerator::uniform(uint64_t lo, uint64_t hi) {
+    return std::uniform_int_distribution<uint64_t>(lo, hi)(rng_);
+}
+
+bool WorkloadGenerator::chance(double p) {
+    return std::uniform_real_distribution<double>(0.0, 1.0)(rng_) < p;
+}
+
+void WorkloadGenerator::drift(Book& book) {
+    if (!chance(0.05)) return;
+    const Price moved = offset(book.mid, Side::SELL, chance(0.5) ? 1 : -1);
+    if (moved >= options_.mid / 2 && moved <= options_.mid * 2) book.mid = moved;
+}
+
+Price WorkloadGenerator::offset(Price mid, Side side, int64_t ticks) const {
+    const int64_t away = (side == Side::BUY ? -ticks : ticks) * static_cast<int64_t>(options_.tick);
+    return static_cast<Price>(static_cast<int64_t>(mid) + away);
+}
+
+OrderID WorkloadGenerator::new_order(uint32_t symbol, Side side, OrderType type, Price price,
+                                     Quantity quantity, bool track) {
+    WorkloadRequest request;
+    request.type       = WorkloadRequest::NEW_ORDER;
+    request.symbol     = symbol;
+    request.id         = next_id_++;
+    request.side       = side;
+    request.order_type = type;
+    request.price      = price;
+    request.quantity   = quantity;
+    pending_.push_back(request);
+    if (track) books_[symbol].resting.push_back({request.id, side, price});
+    return request.id;
+}
+
+void WorkloadGenerator::cancel(uint32_t symbol, size_t resting_index) {
+    std::vector<Resting>& resting = books_[symbol].resting;
+    WorkloadRequest request;
+    request.type   = WorkloadRequest::CANCEL;
+    request.symbol = symbol;
+    request.id     = resting[resting_index].id;
+    request.side   = resting[resting_index].side;
+    request.price  = resting[resting_index].price;
+    pending_.push_back(request);
+    resting[resting_index] = resting.back();
+    resting.pop_back();
+}
+
+void WorkloadGenerator::cancel_random(uint32_t symbol) {
+    const size_t count = books_[symbol].resting.size();
+    if (count) cancel(symbol, uniform(0, count - 1));
+}
+
+void WorkloadGenerator::set_phase(uint32_t symbol, TradingPhase phase) {
+    WorkloadRequest request;
+    request.type   = WorkloadRequest::SET_PHASE;
+    request.symbol = symbol;
+    request.phase  = phase;
+    pending_.push_back(request);
+}
+
+} // namespace rtes
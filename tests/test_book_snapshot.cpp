@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include "rtes/book_snapshot.hpp"
+#include "rtes/event_journal.hpp"
+#include "rtes/matching_engine.hpp"
+#include "rtes/memory_pool.hpp"
+
+#include <unistd.h>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rtes {
+
+namespace {
+
+void collect_trade(const Trade& trade, void* ctx) {
+    static_cast<std::vector<Trade>*>(ctx)->push_back(trade);
+}
+
+Order* make_order(OrderPool& pool, OrderID id, Side side, Quantity qty, Price price,
+                  const char* symbol = "AAPL") {
+    auto* order = pool.allocate();
+    new (order) Order(id, "100", symbol, side, OrderType::LIMIT, qty, price);
+    return order;
+}
+
+std::string snapshot_dir(const char* name) {
+    const auto dir = std::filesystem::temp_directory_path() /
+                     (std::string(name) + "-" + std::to_string(::getpid()));
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir.string();
+}
+
+/** Trades the engine published, in order */
+std::vector<Trade> drain_trades(MarketDataLane& lane) {
+    std::vector<Trade> trades;
+    MarketDataEvent event;
+    while (lane.pop(event)) {
+        if (event.type == MarketDataEvent::TRADE) trades.push_back(event.trade);
+    }
+    return trades;
+}
+
+} // namespace
+
+TEST(BookSnapshotTest, CaptureAndRestoreKeepQueuePriorityAndTradeIds) {
+    OrderPool pool(100);
+    std::vector<Trade> trades;
+    OrderBook book("AAPL", pool, collect_trade, &trades);
+
+    ASSERT_TRUE(book.add_order(make_order(pool, 1, Side::SELL, 100, 15100)).has_value());
+    ASSERT_TRUE(book.add_order(make_order(pool, 2, Side::SELL, 50, 15100)).has_value());
+    Order* iceberg = make_order(pool, 3, Side::SELL, 300, 15200);
+    iceberg->display_quantity = 100;
+    ASSERT_TRUE(book.add_order(iceberg).has_value());
+    ASSERT_TRUE(book.add_order(make_order(pool, 4, Side::BUY, 200, 14900)).has_value());
+    Order* stop = make_order(pool, 5, Side::BUY, 100, 0);
+    stop->type = OrderType::STOP;
+    stop->stop_price = 15300;
+    ASSERT_TRUE(book.add_order(stop).has_value());
+    ASSERT_TRUE(book.add_order(make_order(pool, 6, Side::BUY, 30, 15100)).has_value());
+    ASSERT_EQ(trades.size(), 1u);
+
+    BookImage image;
+    book.capture(image);
+    EXPECT_STREQ(image.header.symbol, "AAPL");
+    EXPECT_EQ(image.header.order_count, 5u);
+    EXPECT_EQ(image.header.next_trade_id, 2u);
+    EXPECT_EQ(image.header.last_trade_price, 15100);
+
+    OrderPool restored_pool(100);
+    std::vector<Trade> restored_trades;
+    OrderBook restored("AAPL", restored_pool, collect_trade, &restored_trades);
+    ASSERT_TRUE(restored.restore(image).has_value());
+    EXPECT_FALSE(restored.restore(image).has_value());  // Only into an empty book
+
+    EXPECT_EQ(restored.order_count(), 5u);
+    EXPECT_EQ(restored.best_bid(), 14900);
+    EXPECT_EQ(restored.best_ask(), 15100);
+    EXPECT_EQ(restored.ask_quantity(), 120u);
+
+    // Order 1 (partly filled) is still ahead of order 2; trade ids carry on
+    ASSERT_TRUE(restored.add_order(make_order(restored_pool, 7, Side::BUY, 170, 15200)).has_value());
+    ASSERT_EQ(restored_trades.size(), 3u);
+    EXPECT_EQ(restored_trades[0].sell_order_id, 1u);
+    EXPECT_EQ(restored_trades[0].quantity, 70u);
+    EXPECT_EQ(restored_trades[0].id, 2u);
+    EXPECT_EQ(restored_trades[1].sell_order_id, 2u);
+    EXPECT_EQ(restored_trades[1].quantity, 50u);
+    EXPECT_EQ(restored_trades[2].sell_order_id, 3u);  // Iceberg slice only
+    EXPECT_EQ(restored_trades[2].quantity, 50u);
+    EXPECT_EQ(restored.best_ask(), 15200);
+    EXPECT_EQ(restored.ask_quantity(), 50u);
+
+    // The stop was parked, not rested
+    EXPECT_TRUE(restored.cancel_order(5).has_value());
+    EXPECT_EQ(restored.order_count(), 2u);
+}
+
+TEST(BookSnapshotTest, EngineRestartsFromSnapshotAndJournalTail) {
+    const std::string dir = snapshot_dir("rtes-book-snapshot");
+    const std::string journal_path = dir + "/events.journal";
+    {
+        EventJournal journal(journal_path);
+        BookSnapshotWriter writer(dir, journal.path(), journal.run_id());
+        OrderPool pool(100);
+        MarketDataLane market_data(1000);
+        MatchingEngine engine("shard-0", {{"AAPL", {}}}, pool);
+        engine.set_market_data_queue(&market_data);
+        engine.set_event_journal(journal.add_engine(engine.name()));
+        engine.set_book_snapshots(writer.add_engine(engine.name()), std::chrono::hours(1));
+        ASSERT_TRUE(journal.start());
+        writer.start();
+        engine.start();
+        // The first snapshot is due at start, before any order
+        while (writer.snapshots_written() < 1) std::this_thread::yield();
+
+        ASSERT_TRUE(engine.submit_order(make_order(pool, 1, Side::SELL, 100, 15000)));
+        ASSERT_TRUE(engine.submit_order(make_order(pool, 2, Side::SELL, 50, 15000)));
+        ASSERT_TRUE(engine.submit_order(make_order(pool, 3, Side::SELL, 70, 15100)));
+        ASSERT_TRUE(engine.submit_order(make_order(pool, 4, Side::BUY, 30, 15000)));
+        ASSERT_TRUE(engine.cancel_order(3, ClientID("100")));
+        ASSERT_TRUE(engine.submit_order(make_order(pool, 5, Side::BUY, 20, 14900)));
+        engine.stop();  // Leaves its final snapshot in the slot
+        writer.stop();
+        journal.stop();
+        EXPECT_EQ(writer.snapshots_written(), 2u);
+        EXPECT_EQ(writer.write_errors(), 0u);
+    }
+
+    const auto check_restored = [](MatchingEngine& engine, OrderPool& pool, MarketDataLane& market_data) {
+        engine.start();
+        ASSERT_TRUE(engine.submit_order(make_order(pool, 6, Side::BUY, 100, 15000)));
+        engine.stop();
+        const auto trades = drain_trades(market_data);
+        ASSERT_EQ(trades.size(), 2u);
+        EXPECT_EQ(trades[0].sell_order_id, 1u);
+        EXPECT_EQ(trades[0].quantity, 70u);
+        EXPECT_EQ(trades[0].id, 2u);
+        EXPECT_EQ(trades[1].sell_order_id, 2u);
+        EXPECT_EQ(trades[1].quantity, 30u);
+        EXPECT_EQ(trades[1].id, 3u);
+    };
+
+    {   // Latest snapshot holds everything: nothing to replay
+        OrderPool pool(100);
+        MarketDataLane market_data(1000);
+        MatchingEngine engine("shard-0", {{"AAPL", {}}}, pool);
+        engine.set_market_data_queue(&market_data);
+        const RestoreResult result = restore_engine(engine, dir);
+        EXPECT_FALSE(result.snapshot.empty());
+        EXPECT_EQ(result.orders, 3u);
+        EXPECT_EQ(result.replayed, 0u);
+        EXPECT_TRUE(drain_trades(market_data).empty());  // Restoring publishes nothing
+        check_restored(engine, pool, market_data);
+    }
+
+    // Without it, the empty start-up snapshot plus every journaled request
+    std::filesystem::remove(latest_book_snapshot(dir, "shard-0"));
+    {
+        OrderPool pool(100);
+        MarketDataLane market_data(1000);
+        MatchingEngine engine("shard-0", {{"AAPL", {}}}, pool);
+        engine.set_market_data_queue(&market_data);
+        const RestoreResult result = restore_engine(engine, dir);
+        EXPECT_EQ(result.orders, 0u);
+        EXPECT_EQ(result.replayed, 6u);
+        EXPECT_EQ(result.journal_gaps, 0u);
+        EXPECT_TRUE(drain_trades(market_data).empty());  // The replayed trade was published already
+        check_restored(engine, pool, market_data);
+    }
+    std::filesystem::remove_all(dir);
+}
+
+} // namespace rtes
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "rtes/datagram_auth.hpp"
+#include "rtes/udp_publisher.hpp"
+
+#ifndef RTES_NO_OPENSSL
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#endif
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+namespace rtes {
+
+namespace {
+
+/** A packet of `messages` filler bytes with its header filled in */
+std::vector<uint8_t> make_packet(uint64_t sequence, size_t messages) {
+    std::vector<uint8_t> datagram(sizeof(UdpPacketHeader) + messages + MD_AUTH_TAG_BYTES);
+    UdpPacketHeader header{};
+    header.sequence = sequence;
+    header.message_count = 1;
+    header.length = static_cast<uint16_t>(sizeof(UdpPacketHeader) + messages);
+    std::memcpy(datagram.data(), &header, sizeof(header));
+    for (size_t i = 0; i < messages; ++i) datagram[sizeof(header) + i] = static_cast<uint8_t>(sequence + i);
+    return datagram;
+}
+
+} // namespace
+
+TEST(DatagramAuthTest, TagIsTruncatedHmacSha256OfTheFlaggedPacket) {
+    DatagramAuthenticator auth("0123456789abcdef0123456789abcdef");
+    if (!auth.ready()) GTEST_SKIP() << "Built without OpenSSL";
+
+    // Several datagrams through one context: each starts from the stored key state
+    for (uint64_t sequence = 1; sequence <= 3; ++sequence) {
+        auto datagram = make_packet(sequence, 100 * sequence);
+        const size_t length = datagram.size() - MD_AUTH_TAG_BYTES;
+        ASSERT_EQ(auth.sign(datagram.data(), length), datagram.size());
+
+        UdpPacketHeader header;
+        std::memcpy(&header, datagram.data(), sizeof(header));
+        EXPECT_EQ(header.flags, UDP_PACKET_AUTHENTICATED);
+        EXPECT_EQ(header.length, length);
+#ifndef RTES_NO_OPENSSL
+        uint8_t expected[EVP_MAX_MD_SIZE];
+        unsigned int expected_length = 0;
+        const std::string key = "0123456789abcdef0123456789abcdef";
+        ASSERT_NE(HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()), datagram.data(), length,
+                       expected, &expected_length), nullptr);
+        EXPECT_EQ(std::memcmp(datagram.data() + length, expected, MD_AUTH_TAG_BYTES), 0);
+#endif
+        EXPECT_TRUE(auth.verify(datagram.data(), datagram.size()));
+    }
+}
+
+TEST(DatagramAuthTest, TamperedUnsignedOrShortDatagramsFail) {
+    DatagramAuthenticator auth("feed-key");
+    DatagramAuthenticator other("another-key");
+    if (!auth.ready()) GTEST_SKIP() << "Built without OpenSSL";
+
+    auto datagram = make_packet(7, 64);
+    const size_t size = auth.sign(datagram.data(), datagram.size() - MD_AUTH_TAG_BYTES);
+    ASSERT_TRUE(auth.verify(datagram.data(), size));
+    EXPECT_FALSE(other.verify(datagram.data(), size));
+    EXPECT_FALSE(auth.verify(datagram.data(), size - 1));                       // Tag cut short
+    EXPECT_FALSE(auth.verify(datagram.data(), MD_PACKET_HEADER_BYTES - 1));
+
+    for (size_t i : {size_t{0}, MD_PACKET_FLAGS_OFFSET + 1, sizeof(UdpPacketHeader) + 10, size - 1}) {
+        auto tampered = datagram;
+        tampered[i] ^= 0x01;
+        EXPECT_FALSE(auth.verify(tampered.data(), size)) << "byte " << i;
+    }
+
+    auto unsigned_packet = make_packet(8, 64);  // No flag, whatever follows
+    EXPECT_FALSE(auth.verify(unsigned_packet.data(), unsigned_packet.size()));
+
+    DatagramAuthenticator keyless("");
+    EXPECT_FALSE(keyless.ready());
+    EXPECT_FALSE(keyless.verify(datagram.data(), size));
+}
+
+TEST(DatagramAuthTest, BatchVerifyFlagsEachDatagram) {
+    DatagramAuthenticator auth("feed-key");
+    if (!auth.ready()) GTEST_SKIP() << "Built without OpenSSL";
+
+    std::vector<std::vector<uint8_t>> batch;
+    for (uint64_t sequence = 1; sequence <= 8; ++sequence) {
+        batch.push_back(make_packet(sequence, 40));
+        auth.sign(batch.back().data(), batch.back().size() - MD_AUTH_TAG_BYTES);
+    }
+    batch[2].back() ^= 0xFF;  // Bad tag
+    batch[5][20] ^= 0xFF;     // Bad payload
+
+    std::array<const uint8_t*, 8> datagrams;
+    std::array<size_t, 8> sizes;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        datagrams[i] = batch[i].data();
+        sizes[i] = batch[i].size();
+    }
+    bool ok[8];
+    EXPECT_EQ(auth.verify_batch(datagrams.data(), sizes.data(), batch.size(), ok), 6u);
+    for (size_t i = 0; i < batch.size(); ++i) EXPECT_EQ(ok[i], i != 2 && i != 5) << i;
+}
+
+} // namespace rtes
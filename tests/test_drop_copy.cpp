@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include "rtes/drop_copy.hpp"
+#include "rtes/tcp_gateway.hpp"
+#include "rtes/risk_manager.hpp"
+#include "rtes/memory_pool.hpp"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <thread>
+#include <chrono>
+
+namespace rtes {
+
+namespace {
+
+int connect_to(uint16_t port) {
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    timeval timeout{2, 0};
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    EXPECT_EQ(connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    return sock;
+}
+
+bool recv_exact(int sock, void* buffer, size_t size) {
+    return recv(sock, buffer, size, MSG_WAITALL) == static_cast<ssize_t>(size);
+}
+
+// Development tokens (RTES_AUTH_MODE=development): an admin reads every firm
+constexpr const char* ADMIN_TOKEN  = "dev_admin_root0000000000000000000000";
+constexpr const char* TRADER_TOKEN = "dev_trader_alice000000000000000000";  // User alice00000000000
+
+DropCopyRequest make_request(const char* firm, uint64_t next_sequence, const char* token = ADMIN_TOKEN) {
+    setenv("RTES_AUTH_MODE", "development", 1);
+    DropCopyRequest request;
+    request.header = MessageHeader(DROP_COPY_REQUEST, sizeof(DropCopyRequest), 1,
+                                   ProtocolUtils::get_timestamp_ns());
+    request.client_id = firm;
+    request.next_sequence = next_sequence;
+    request.auth_token = token;
+    return request;
+}
+
+NewOrderMessage make_order(uint64_t id, const char* client, Side side) {
+    NewOrderMessage msg;
+    msg.header = MessageHeader(NEW_ORDER, sizeof(NewOrderMessage), 1, ProtocolUtils::get_timestamp_ns());
+    msg.order_id = id;
+    msg.client_id = client;
+    msg.symbol = "AAPL";
+    msg.side = static_cast<uint8_t>(side);
+    msg.quantity = 100;
+    msg.price = 15000;
+    msg.order_type = static_cast<uint8_t>(OrderType::LIMIT);
+    return msg;
+}
+
+} // namespace
+
+TEST(DropCopyTest, StreamsOneFirmsReportsAndReplaysFromASequence) {
+    constexpr uint16_t order_port     = 18897;
+    constexpr uint16_t drop_copy_port = 18898;
+    RiskConfig risk_config;
+    risk_config.max_order_size = 10000;
+    risk_config.max_notional_per_client = 1000000.0;
+    risk_config.max_orders_per_second = 1000;
+    risk_config.price_collar_enabled = false;
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}};
+
+    OrderPool pool(100);
+    MatchingEngine engine("AAPL", pool);
+    RiskManager risk(risk_config, symbols);
+    risk.add_matching_engine("AAPL", &engine);
+    ClientDirectory clients(16);
+
+    EventDoorbell doorbell;
+    SPSCQueue<ExecutionReport> engine_reports(256);
+    SPSCQueue<ExecutionReport> risk_reports(256);
+    engine.set_execution_queue(&engine_reports, &doorbell);
+    risk.set_execution_queue(&risk_reports, &doorbell);
+    risk.set_client_directory(&clients);
+
+    DropCopyServer drop_copy(drop_copy_port, 1, &clients, 64);
+    TcpGateway gateway(order_port, &risk, &pool);
+    gateway.set_client_directory(&clients);
+    gateway.set_execution_queues({&engine_reports, &risk_reports}, &doorbell);
+    gateway.set_drop_copy(&drop_copy);
+    drop_copy.start();
+    engine.start();
+    risk.start();
+    gateway.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // Subscribed before the firm has ever traded
+    const int subscriber = connect_to(drop_copy_port);
+    auto subscribe = make_request("100", 0);
+    ASSERT_EQ(send(subscriber, &subscribe, sizeof(subscribe), 0), static_cast<ssize_t>(sizeof(subscribe)));
+    DropCopyAck ack;
+    ASSERT_TRUE(recv_exact(subscriber, &ack, sizeof(ack)));
+    EXPECT_EQ(ack.header.type, DROP_COPY_ACK);
+    EXPECT_EQ(ack.status, 1);
+    EXPECT_EQ(ack.next_sequence, 1u);
+
+    // Firm 100 sells, firm 200 buys it all: 100 sees its side only
+    const int trader = connect_to(order_port);
+    const auto sell = make_order(1, "100", Side::SELL);
+    const auto buy  = make_order(2, "200", Side::BUY);
+    ASSERT_EQ(send(trader, &sell, sizeof(sell), 0), static_cast<ssize_t>(sizeof(sell)));
+    ASSERT_EQ(send(trader, &buy, sizeof(buy), 0), static_cast<ssize_t>(sizeof(buy)));
+
+    DropCopyReport reports[2];
+    ASSERT_TRUE(recv_exact(subscriber, reports, sizeof(reports)));
+    EXPECT_EQ(reports[0].header.type, DROP_COPY_REPORT);
+    EXPECT_EQ(reports[0].header.sequence, 1u);
+    EXPECT_EQ(reports[0].exec_type, DROP_COPY_FILL);
+    EXPECT_EQ(reports[0].side, static_cast<uint8_t>(Side::SELL));
+    EXPECT_EQ(reports[0].order_id, 1u);
+    EXPECT_EQ(reports[0].quantity, 100u);
+    EXPECT_EQ(reports[0].price, 15000u);
+    EXPECT_STREQ(reports[0].symbol.c_str(), "AAPL");
+    EXPECT_EQ(reports[1].header.sequence, 2u);
+    EXPECT_EQ(reports[1].exec_type, DROP_COPY_DONE);
+    EXPECT_EQ(reports[1].order_id, 1u);
+    EXPECT_EQ(reports[1].status, static_cast<uint8_t>(OrderStatus::FILLED));
+    EXPECT_EQ(reports[1].leaves_quantity, 0u);
+
+    // Gap replay: rewind to sequence 2 and get it again
+    auto replay = make_request("100", 2);
+    ASSERT_EQ(send(subscriber, &replay, sizeof(replay), 0), static_cast<ssize_t>(sizeof(replay)));
+    ASSERT_TRUE(recv_exact(subscriber, &ack, sizeof(ack)));
+    EXPECT_EQ(ack.status, 1);
+    EXPECT_EQ(ack.next_sequence, 2u);
+    DropCopyReport replayed;
+    ASSERT_TRUE(recv_exact(subscriber, &replayed, sizeof(replayed)));
+    EXPECT_EQ(replayed.header.sequence, 2u);
+    EXPECT_EQ(replayed.exec_type, DROP_COPY_DONE);
+
+    close(trader);
+    close(subscriber);
+    gateway.stop();
+    risk.stop();
+    engine.stop();
+    drop_copy.stop();
+    EXPECT_EQ(drop_copy.reports_journaled(), 4u);  // Fill and done for each firm
+    EXPECT_EQ(drop_copy.replays(), 1u);
+    EXPECT_EQ(gateway.drop_copy_overflows(), 0u);
+}
+
+TEST(DropCopyTest, ReplayPastTheJournalStartsAtTheOldestKeptReport) {
+    constexpr uint16_t port = 18899;
+    ClientDirectory clients(4);
+    const ClientIDRaw firm = clients.resolve(ClientID("100"));
+    constexpr size_t journal = 4;
+
+    DropCopyServer drop_copy(port, 1, &clients, journal);
+    drop_copy.start();
+
+    // Six reports through a four-entry journal: sequences 1 and 2 are gone
+    for (OrderID id = 1; id <= 6; ++id) {
+        DropCopyRecord record;
+        record.report = ExecutionReport::make_reject(id, 2000);
+        record.client = firm;
+        ASSERT_TRUE(drop_copy.reactor_queue(0)->push(record));
+    }
+    for (int i = 0; i < 100 && drop_copy.reports_journaled() < 6; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    const int subscriber = connect_to(port);
+    auto replay = make_request("100", 1);
+    ASSERT_EQ(send(subscriber, &replay, sizeof(replay), 0), static_cast<ssize_t>(sizeof(replay)));
+    DropCopyAck ack;
+    ASSERT_TRUE(recv_exact(subscriber, &ack, sizeof(ack)));
+    EXPECT_EQ(ack.status, 1);
+    EXPECT_EQ(ack.next_sequence, 3u);
+    DropCopyReport reports[journal];
+    ASSERT_TRUE(recv_exact(subscriber, reports, sizeof(reports)));
+    for (size_t i = 0; i < journal; ++i) {
+        EXPECT_EQ(reports[i].header.sequence, 3 + i);
+        EXPECT_EQ(reports[i].exec_type, DROP_COPY_REJECTED);
+        EXPECT_EQ(reports[i].order_id, 3 + i);
+        EXPECT_EQ(reports[i].reason, 2000u);
+    }
+
+    close(subscriber);
+    drop_copy.stop();
+}
+
+TEST(DropCopyTest, SubscriberMustBeEntitledToTheFirm) {
+    constexpr uint16_t port = 18900;
+    ClientDirectory clients(4);
+    const ClientIDRaw own   = clients.resolve(ClientID("alice00000000000"));
+    const ClientIDRaw other = clients.resolve(ClientID("100"));
+
+    DropCopyServer drop_copy(port, 1, &clients, 16);
+    drop_copy.start();
+    for (const ClientIDRaw firm : {other, own}) {
+        DropCopyRecord record;
+        record.report = ExecutionReport::make_reject(firm, 2000);
+        record.client = firm;
+        ASSERT_TRUE(drop_copy.reactor_queue(0)->push(record));
+    }
+    for (int i = 0; i < 100 && drop_copy.reports_journaled() < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    const int subscriber = connect_to(port);
+    DropCopyAck ack;
+
+    // Another firm's reports, and no token at all: refused
+    for (const char* token : {TRADER_TOKEN, ""}) {
+        auto request = make_request("100", 1, token);
+        ASSERT_EQ(send(subscriber, &request, sizeof(request), 0), static_cast<ssize_t>(sizeof(request)));
+        ASSERT_TRUE(recv_exact(subscriber, &ack, sizeof(ack)));
+        EXPECT_EQ(ack.status, 2);
+    }
+
+    // Its own firm: only its own report follows
+    auto request = make_request("alice00000000000", 1, TRADER_TOKEN);
+    ASSERT_EQ(send(subscriber, &request, sizeof(request), 0), static_cast<ssize_t>(sizeof(request)));
+    ASSERT_TRUE(recv_exact(subscriber, &ack, sizeof(ack)));
+    EXPECT_EQ(ack.status, 1);
+    DropCopyReport report;
+    ASSERT_TRUE(recv_exact(subscriber, &report, sizeof(report)));
+    EXPECT_EQ(report.order_id, own);
+
+    close(subscriber);
+    drop_copy.stop();
+    EXPECT_EQ(drop_copy.requests_refused(), 2u);
+}
+
+} // namespace rtes
@@ -0,0 +1,229 @@
+#include <gtest/gtest.h>
+#include "rtes/event_journal.hpp"
+#include "rtes/matching_engine.hpp"
+#include "rtes/memory_pool.hpp"
+
+#include <unistd.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rtes {
+
+namespace {
+
+std::string journal_path(const char* name) {
+    return (std::filesystem::temp_directory_path() /
+            (std::string(name) + "-" + std::to_string(::getpid()) + ".journal")).string();
+}
+
+JournalRecord cancel_record(OrderID id) {
+    JournalRecord record;
+    record.type     = JournalRecordType::CANCEL_ORDER;
+    record.order.id = id;
+    return record;
+}
+
+} // namespace
+
+TEST(EventJournalTest, WritesSequencedRecordsPerEngine) {
+    const std::string path = journal_path("rtes-journal-basic");
+    JournalOptions options;
+    options.sync = JournalSync::BATCH;
+    options.buffer_bytes = 2 * JOURNAL_BLOCK;  // Forces writes that fill the buffer
+    EventJournal journal(path, options);
+    JournalLane* first  = journal.add_engine("AAPL");
+    JournalLane* second = journal.add_engine("shard-0");
+    ASSERT_TRUE(journal.start());
+
+    constexpr size_t RECORDS = 200;
+    for (OrderID id = 1; id <= RECORDS; ++id) {
+        JournalRecord record = cancel_record(id);
+        (id % 2 ? first : second)->append(record);
+    }
+    journal.stop();
+    EXPECT_EQ(journal.records_written(), RECORDS);
+    EXPECT_EQ(journal.drops(), 0u);
+    EXPECT_GT(journal.syncs(), 0u);
+    EXPECT_EQ(journal.write_errors(), 0u);
+
+    // No padding left at the end: header block, then exactly the records
+    EXPECT_EQ(std::filesystem::file_size(path), JOURNAL_BLOCK + RECORDS * sizeof(JournalRecord));
+
+    JournalFileHeader header;
+    uint64_t next_seq[2] = {1, 1};
+    size_t seen = 0;
+    ASSERT_TRUE(read_journal(path, [&](const JournalRecord& record) {
+        ASSERT_LT(record.engine, 2u);
+        EXPECT_EQ(record.type, JournalRecordType::CANCEL_ORDER);
+        EXPECT_EQ(record.seq, next_seq[record.engine]++);
+        EXPECT_EQ(record.order.id % 2, record.engine == 0 ? 1u : 0u);
+        ++seen;
+    }, &header));
+    EXPECT_EQ(seen, RECORDS);
+    EXPECT_EQ(header.engine_count, 2u);
+    EXPECT_STREQ(header.engine_names[0], "AAPL");
+    EXPECT_STREQ(header.engine_names[1], "shard-0");
+    std::filesystem::remove(path);
+}
+
+TEST(EventJournalTest, FullLaneDropsWithoutBlockingAndLeavesAGap) {
+    const std::string path = journal_path("rtes-journal-drops");
+    JournalOptions options;
+    options.lane_capacity = 4;
+    EventJournal journal(path, options);
+    JournalLane* lane = journal.add_engine("AAPL");
+
+    // Journal thread not running yet: the lane fills and the rest is dropped
+    for (OrderID id = 1; id <= 6; ++id) {
+        JournalRecord record = cancel_record(id);
+        lane->append(record);
+    }
+    EXPECT_EQ(lane->drops(), 2u);
+    ASSERT_TRUE(journal.start());
+    while (journal.records_written() < 4) std::this_thread::yield();
+    JournalRecord record = cancel_record(7);
+    lane->append(record);
+    journal.stop();
+
+    std::vector<uint64_t> seqs;
+    ASSERT_TRUE(read_journal(path, [&](const JournalRecord& r) { seqs.push_back(r.seq); }));
+    EXPECT_EQ(seqs, (std::vector<uint64_t>{1, 2, 3, 4, 7}));
+    EXPECT_EQ(journal.drops(), 2u);
+    std::filesystem::remove(path);
+}
+
+TEST(EventJournalTest, MappedSegmentsRollOverAndReadInPlace) {
+    const std::string path = journal_path("rtes-journal-segments");
+    JournalOptions options;
+    options.segment_bytes = JOURNAL_BLOCK + 8 * sizeof(JournalRecord);  // Rounded up: 32 records a segment
+    EventJournal journal(path, options);
+    JournalLane* lane = journal.add_engine("AAPL");
+    ASSERT_TRUE(journal.start());
+
+    constexpr size_t RECORDS = 100;
+    for (OrderID id = 1; id <= RECORDS; ++id) {
+        JournalRecord record = cancel_record(id);
+        lane->append(record);
+    }
+    journal.stop();
+    EXPECT_EQ(journal.records_written(), RECORDS);
+    EXPECT_EQ(journal.drops(), 0u);
+    EXPECT_EQ(journal.write_errors(), 0u);
+    EXPECT_EQ(journal.segments(), 4u);
+
+    const auto segments = list_journal_segments(path);
+    ASSERT_EQ(segments.size(), 4u);
+    EXPECT_EQ(segments[1], path.substr(0, path.size() - 8) + "-000001.journal");
+
+    uint64_t next_seq = 1;
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < segments.size(); ++i) {
+        MappedJournal segment;
+        ASSERT_TRUE(segment.open(segments[i]));
+        EXPECT_EQ(segment.header().segment, i);
+        EXPECT_EQ(segment.header().run_id, journal.run_id());
+        EXPECT_STREQ(segment.header().engine_names[0], "AAPL");
+        EXPECT_EQ(segment.records().size(), i < 3 ? 32u : 4u);
+        for (const JournalRecord& record : segment.records()) {
+            EXPECT_EQ(record.seq, next_seq);
+            EXPECT_EQ(record.order.id, next_seq);
+            ++next_seq;
+        }
+        // Closed segments are trimmed to their records
+        const auto size = std::filesystem::file_size(segments[i]);
+        EXPECT_EQ(size, JOURNAL_BLOCK + segment.records().size() * sizeof(JournalRecord));
+        bytes += size;
+    }
+    EXPECT_EQ(next_seq, RECORDS + 1);
+    EXPECT_EQ(journal.bytes_written(), bytes);
+
+    // Another journal under the same name must not overwrite this one
+    EventJournal again(path, options);
+    again.add_engine("AAPL");
+    EXPECT_FALSE(again.start());
+    EXPECT_NE(again.run_id(), journal.run_id());
+    EXPECT_EQ(std::filesystem::file_size(segments[0]), JOURNAL_BLOCK + 32 * sizeof(JournalRecord));
+    for (const auto& segment : segments) std::filesystem::remove(segment);
+}
+
+TEST(EventJournalTest, UnclosedSegmentEndsAtFirstZeroRecord) {
+    // What a crash leaves: the preallocated segment, records, then zeroes
+    const std::string path = journal_path("rtes-journal-unclosed");
+    {
+        JournalFileHeader header;
+        std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+        std::vector<char> file(4 * JOURNAL_BLOCK, 0);
+        std::memcpy(file.data(), &header, sizeof(header));
+        for (OrderID id = 1; id <= 3; ++id) {
+            JournalRecord record = cancel_record(id);
+            record.seq = id;
+            std::memcpy(file.data() + JOURNAL_BLOCK + (id - 1) * sizeof(record), &record, sizeof(record));
+        }
+        std::ofstream(path, std::ios::binary).write(file.data(), static_cast<std::streamsize>(file.size()));
+    }
+
+    MappedJournal journal;
+    ASSERT_TRUE(journal.open(path));
+    ASSERT_EQ(journal.records().size(), 3u);
+    EXPECT_EQ(journal.records().back().seq, 3u);
+
+    MappedJournal moved = std::move(journal);
+    EXPECT_EQ(moved.records().size(), 3u);
+    EXPECT_TRUE(journal.records().empty());
+    EXPECT_FALSE(journal.open(path + ".missing"));
+    std::filesystem::remove(path);
+}
+
+TEST(EventJournalTest, EngineJournalsRequestsBeforeTheirOutputs) {
+    const std::string path = journal_path("rtes-journal-engine");
+    EventJournal journal(path);
+    OrderPool pool(100);
+    MarketDataLane market_data(1000);
+    MatchingEngine engine("journal", {{"AAPL", {}}}, pool);
+    engine.set_market_data_queue(&market_data);
+    engine.set_event_journal(journal.add_engine(engine.name()));
+    ASSERT_TRUE(journal.start());
+
+    auto* sell = pool.allocate();
+    new (sell) Order(1, "100", "AAPL", Side::SELL, OrderType::LIMIT, 100, 15000);
+    auto* buy = pool.allocate();
+    new (buy) Order(2, "101", "AAPL", Side::BUY, OrderType::LIMIT, 40, 15000);
+
+    engine.start();
+    ASSERT_TRUE(engine.submit_order(sell));
+    ASSERT_TRUE(engine.submit_order(buy));
+    ASSERT_TRUE(engine.cancel_order(1, ClientID("100")));
+    engine.stop();
+    journal.stop();
+
+    std::vector<JournalRecord> records;
+    ASSERT_TRUE(read_journal(path, [&](const JournalRecord& r) { records.push_back(r); }));
+    std::vector<JournalRecordType> types;
+    for (const auto& r : records) types.push_back(r.type);
+    EXPECT_EQ(types, (std::vector<JournalRecordType>{
+        JournalRecordType::NEW_ORDER, JournalRecordType::NEW_ORDER, JournalRecordType::TRADE,
+        JournalRecordType::ORDER_DONE, JournalRecordType::CANCEL_ORDER, JournalRecordType::ORDER_DONE}));
+    ASSERT_EQ(records.size(), 6u);
+
+    EXPECT_EQ(records[0].new_order.id, 1u);
+    EXPECT_EQ(records[0].new_order.side, Side::SELL);
+    EXPECT_EQ(records[0].new_order.quantity, 100u);
+    EXPECT_EQ(records[0].new_order.price, 15000);
+    EXPECT_STREQ(records[0].new_order.symbol.c_str(), "AAPL");
+    EXPECT_STREQ(records[0].new_order.client_id.c_str(), "100");
+    EXPECT_EQ(records[2].trade.quantity, 40u);
+    EXPECT_EQ(records[3].done.id, 2u);                   // Buyer filled in full
+    EXPECT_EQ(records[3].done.status, OrderStatus::FILLED);
+    EXPECT_EQ(records[5].done.id, 1u);                   // Seller's rest cancelled
+    EXPECT_EQ(records[5].done.filled_quantity, 40u);
+    for (size_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(records[i].seq, i + 1);
+        EXPECT_NE(records[i].time, 0u);
+    }
+    std::filesystem::remove(path);
+}
+
+} // namespace rtes
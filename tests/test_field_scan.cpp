@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include "rtes/field_scan.hpp"
+#include "rtes/types.hpp"
+
+#include <string>
+
+namespace rtes {
+
+namespace {
+
+size_t reference_find_outside(const std::string& text, FieldCharset charset) {
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (!in_charset(static_cast<unsigned char>(text[i]), charset)) return i;
+    }
+    return text.size();
+}
+
+} // namespace
+
+TEST(FieldScanTest, MatchesTheScalarDefinitionForEveryByte) {
+    for (FieldCharset charset : {FieldCharset::SYMBOL, FieldCharset::CLIENT_ID, FieldCharset::PRINTABLE}) {
+        for (int c = 0; c < 256; ++c) {
+            const std::string text(16, static_cast<char>(c));
+            EXPECT_EQ(find_outside(text, charset), reference_find_outside(text, charset))
+                << "byte " << c << " charset " << static_cast<int>(charset);
+        }
+    }
+    EXPECT_EQ(find_outside("AZ09", FieldCharset::SYMBOL), 4u);
+    EXPECT_EQ(find_outside("AZ09a", FieldCharset::SYMBOL), 4u);
+    EXPECT_EQ(find_outside("client_01-b", FieldCharset::CLIENT_ID), 11u);
+    EXPECT_EQ(find_outside("client 01", FieldCharset::CLIENT_ID), 6u);
+    EXPECT_EQ(find_outside("tab\tok\r\n", FieldCharset::PRINTABLE), 8u);
+    EXPECT_EQ(find_outside("\x7f", FieldCharset::PRINTABLE), 0u);
+}
+
+TEST(FieldScanTest, FindsTheFirstStrayByteAtAnyOffsetAndLength) {
+    // Whole blocks, partial tails and both at once; nothing past size is read
+    for (size_t size = 0; size <= 40; ++size) {
+        const std::string clean(size, 'A');
+        EXPECT_EQ(find_outside(clean, FieldCharset::SYMBOL), size);
+        for (size_t bad = 0; bad < size; ++bad) {
+            std::string text = clean;
+            text[bad] = '!';
+            if (bad + 1 < size) text[size - 1] = '?';  // A later stray byte must not win
+            EXPECT_EQ(find_outside(text, FieldCharset::SYMBOL), bad) << "size " << size;
+        }
+    }
+    const char buffer[] = "AAAAAAAA!";
+    EXPECT_EQ(find_outside(buffer, 8, FieldCharset::SYMBOL), 8u);  // Stray byte just past the end
+}
+
+TEST(FieldScanTest, FixedWidthFieldNeedsCleanTextAndATerminator) {
+    Symbol symbol("MSFT");
+    EXPECT_EQ(field_length(symbol.data, sizeof(symbol.data), FieldCharset::SYMBOL), 4u);
+
+    symbol.assign("msft");
+    EXPECT_EQ(field_length(symbol.data, sizeof(symbol.data), FieldCharset::SYMBOL), INVALID_FIELD);
+
+    // Bytes after the terminator are not text
+    char field[8] = {'I', 'B', 'M', '\0', '!', '!', '!', '!'};
+    EXPECT_EQ(field_length(field, sizeof(field), FieldCharset::SYMBOL), 3u);
+    char full[8] = {'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H'};  // No terminator
+    EXPECT_EQ(field_length(full, sizeof(full), FieldCharset::SYMBOL), INVALID_FIELD);
+
+    ClientID client("desk_7-algo");
+    EXPECT_EQ(field_length(client.data, sizeof(client.data), FieldCharset::CLIENT_ID), 11u);
+    EXPECT_EQ(field_length(ClientID().data, 32, FieldCharset::CLIENT_ID), 0u);
+}
+
+} // namespace rtes
@@ -4,8 +4,11 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <atomic>
+#include <cerrno>
 #include <thread>
 #include <chrono>
+#include <string>
 
 namespace rtes {
 
@@ -21,6 +24,11 @@ protected:
         server->add_handler("/json", [](const std::string&, const std::string&) {
             return "{\"status\": \"ok\"}";
         });
+
+        server->add_admin_handler("/admin", [this](const std::string&, const std::string& query) {
+            ++admin_calls;
+            return "done " + query;
+        }, "config_reload");
         
         server->start();
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
@@ -30,9 +38,9 @@ protected:
         server->stop();
     }
     
-    std::string send_http_request(const std::string& request) {
+    static int connect_to(uint16_t port) {
         int sock = socket(AF_INET, SOCK_STREAM, 0);
-        if (sock < 0) return "";
+        if (sock < 0) return -1;
         
         struct timeval timeout{};
         timeout.tv_sec = 2;
@@ -42,12 +50,24 @@ protected:
         struct sockaddr_in addr{};
         addr.sin_family = AF_INET;
         addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
-        addr.sin_port = htons(18080);
+        addr.sin_port = htons(port);
         
         if (connect(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
             close(sock);
-            return "";
+            return -1;
         }
+        return sock;
+    }
+
+    static size_t count_of(const std::string& text, const std::string& what) {
+        size_t count = 0;
+        for (size_t at = text.find(what); at != std::string::npos; at = text.find(what, at + 1)) ++count;
+        return count;
+    }
+
+    std::string send_http_request(const std::string& request, uint16_t port = 18080) {
+        int sock = connect_to(port);
+        if (sock < 0) return "";
         
         send(sock, request.c_str(), request.length(), 0);
         
@@ -64,6 +84,7 @@ protected:
     }
     
     std::unique_ptr<HttpServer> server;
+    std::atomic<int> admin_calls{0};
 };
 
 TEST_F(HttpServerTest, BasicGetRequest) {
@@ -91,6 +112,28 @@ TEST_F(HttpServerTest, NotFoundResponse) {
     EXPECT_NE(response.find("Not Found"), std::string::npos);
 }
 
+TEST_F(HttpServerTest, AdminHandlerNeedsPostAndAnAuthorizedToken) {
+    setenv("RTES_AUTH_MODE", "development", 1);
+    auto request = [](const std::string& method, const std::string& token) {
+        std::string text = method + " /admin?symbol=AAPL HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n";
+        if (!token.empty()) text += "Authorization: Bearer " + token + "\r\n";
+        return text + "\r\n";
+    };
+    const std::string admin = "dev_admin_root0000000000000000000000";
+
+    EXPECT_NE(send_http_request(request("GET", admin)).find("HTTP/1.1 405"), std::string::npos);
+    EXPECT_NE(send_http_request(request("POST", "")).find("HTTP/1.1 401"), std::string::npos);
+    EXPECT_NE(send_http_request(request("POST", "dev_trader_alice000000000000000000")).find("HTTP/1.1 403"),
+              std::string::npos);
+    EXPECT_EQ(admin_calls.load(), 0);
+
+    const std::string response = send_http_request(request("POST", admin));
+    EXPECT_NE(response.find("HTTP/1.1 200 OK"), std::string::npos);
+    EXPECT_NE(response.find("done symbol=AAPL"), std::string::npos);
+    EXPECT_EQ(admin_calls.load(), 1);
+    unsetenv("RTES_AUTH_MODE");
+}
+
 TEST_F(HttpServerTest, MultipleRequests) {
     for (int i = 0; i < 5; ++i) {
         std::string request = "GET /test HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
@@ -133,4 +176,138 @@ TEST_F(HttpServerTest, ConcurrentRequests) {
     EXPECT_EQ(server->requests_served(), num_threads);
 }
 
+TEST_F(HttpServerTest, KeepAliveServesPipelinedRequests) {
+    int sock = connect_to(18080);
+    ASSERT_GE(sock, 0);
+
+    // Two keep-alive requests in one segment, then one that closes
+    const std::string pipelined = "GET /test HTTP/1.1\r\nHost: localhost\r\n\r\n"
+                                  "GET /json?x=1 HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    send(sock, pipelined.data(), pipelined.size(), 0);
+    const std::string last = "GET /test HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+    send(sock, last.data(), last.size(), 0);
+
+    std::string response;
+    char buffer[4096];
+    ssize_t received;
+    while ((received = recv(sock, buffer, sizeof(buffer), 0)) > 0) response.append(buffer, received);
+    close(sock);
+
+    EXPECT_EQ(count_of(response, "HTTP/1.1 200 OK"), 3u);
+    EXPECT_EQ(count_of(response, "Connection: keep-alive"), 2u);
+    EXPECT_EQ(count_of(response, "Connection: close"), 1u);
+    EXPECT_LT(response.find("Hello, World!"), response.find("{\"status\": \"ok\"}"));
+    EXPECT_EQ(server->connections_accepted(), 1u);
+    EXPECT_EQ(server->requests_served(), 3u);
+}
+
+TEST_F(HttpServerTest, StalledClientDoesNotBlockOthers) {
+    int stalled = connect_to(18080);
+    ASSERT_GE(stalled, 0);
+    const std::string partial = "GET /test HTTP/1.1\r\nHost: loc";
+    send(stalled, partial.data(), partial.size(), 0);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::string response = send_http_request("GET /json HTTP/1.1\r\nConnection: close\r\n\r\n");
+    EXPECT_NE(response.find("HTTP/1.1 200 OK"), std::string::npos);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+
+    // The stalled request still completes when the rest arrives
+    const std::string rest = "alhost\r\nConnection: close\r\n\r\n";
+    send(stalled, rest.data(), rest.size(), 0);
+    char buffer[4096];
+    const ssize_t received = recv(stalled, buffer, sizeof(buffer), 0);
+    ASSERT_GT(received, 0);
+    EXPECT_NE(std::string(buffer, received).find("Hello, World!"), std::string::npos);
+    close(stalled);
+}
+
+TEST_F(HttpServerTest, ClientThatNeverReadsIsClosed) {
+    int sock = connect_to(18080);
+    ASSERT_GE(sock, 0);
+    for (int i = 0; i < 200 && server->connections_open() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(server->connections_open(), 1u);
+
+    // Pipeline requests and never read: the responses back up on the server
+    std::string batch;
+    for (int i = 0; i < 1000; ++i) batch += "GET /test HTTP/1.1\r\n\r\n";
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (send(sock, batch.data(), batch.size(), MSG_NOSIGNAL | MSG_DONTWAIT) < 0 && errno != EAGAIN) break;
+        if (server->connections_open() == 0) break;
+    }
+    EXPECT_EQ(server->connections_open(), 0u);
+    EXPECT_LT(server->requests_served(), 1000000u);
+    close(sock);
+}
+
+TEST_F(HttpServerTest, CachedHandlerRendersPerIntervalNotPerRequest) {
+    std::atomic<int> renders{0};
+    HttpServer cached_server(18081);
+    cached_server.add_cached_handler("/metrics", [&](const std::string&, const std::string&) {
+        return "render " + std::to_string(renders.fetch_add(1) + 1);
+    }, std::chrono::hours(1));
+    cached_server.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    for (int i = 0; i < 5; ++i) {
+        std::string response = send_http_request("GET /metrics HTTP/1.1\r\nConnection: close\r\n\r\n", 18081);
+        EXPECT_NE(response.find("render 1"), std::string::npos) << response;
+    }
+    EXPECT_EQ(renders.load(), 1);
+    EXPECT_EQ(cached_server.requests_served(), 5u);
+    cached_server.stop();
+}
+
+TEST_F(HttpServerTest, EventStreamSharesSnapshotsAndSendsDeltas) {
+    std::atomic<int> samples{0};
+    std::atomic<int> trades{0};
+    HttpServer stream_server(18082);
+    stream_server.add_event_stream("/events", [&] {
+        samples.fetch_add(1);
+        return HttpEventFields{{"trades", std::to_string(trades.load())}, {"orders", "7"}};
+    }, std::chrono::milliseconds(20));
+    stream_server.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(samples.load(), 0);  // Nobody subscribed: the source is not sampled
+
+    auto read_until = [](int sock, std::string& seen, const std::string& what) {
+        char buffer[4096];
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (seen.find(what) == std::string::npos && std::chrono::steady_clock::now() < deadline) {
+            const ssize_t received = recv(sock, buffer, sizeof(buffer), 0);
+            if (received <= 0) break;
+            seen.append(buffer, received);
+        }
+        return seen.find(what) != std::string::npos;
+    };
+
+    const std::string request = "GET /events HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    int first = connect_to(18082);
+    int second = connect_to(18082);
+    ASSERT_GE(first, 0);
+    ASSERT_GE(second, 0);
+    send(first, request.data(), request.size(), 0);
+    send(second, request.data(), request.size(), 0);
+
+    std::string seen_first, seen_second;
+    ASSERT_TRUE(read_until(first, seen_first, "event: snapshot"));
+    ASSERT_TRUE(read_until(second, seen_second, "event: snapshot"));
+    EXPECT_NE(seen_first.find("Content-Type: text/event-stream"), std::string::npos);
+    EXPECT_NE(seen_first.find("data: {\"orders\":7,\"trades\":0}"), std::string::npos);
+
+    trades.store(3);
+    ASSERT_TRUE(read_until(first, seen_first, "data: {\"trades\":3}"));
+    ASSERT_TRUE(read_until(second, seen_second, "data: {\"trades\":3}"));
+    EXPECT_EQ(count_of(seen_first, "event: snapshot"), 1u);
+
+    close(first);
+    close(second);
+    stream_server.stop();
+    // One sample per tick, shared by both subscribers
+    EXPECT_EQ(static_cast<uint64_t>(samples.load()), stream_server.stream_ticks());
+}
+
 } // namespace rtes
\ No newline at end of file
@@ -95,6 +95,50 @@ TEST_F(InputValidationTest, NewOrderMessageSanitization) {
     msg.quantity = 2000000;
     result = MessageValidator::sanitize_message_fields(msg);
     EXPECT_TRUE(result.has_error());
+    
+    // IOC / FOK / post-only accepted, but need a price
+    msg.quantity = 100;
+    msg.order_type = static_cast<uint8_t>(OrderType::POST_ONLY);
+    result = MessageValidator::sanitize_message_fields(msg);
+    EXPECT_TRUE(result.has_value());
+    msg.order_type = static_cast<uint8_t>(OrderType::IOC);
+    msg.price = 0;
+    result = MessageValidator::sanitize_message_fields(msg);
+    EXPECT_TRUE(result.has_error());
+    
+    // Stop types need a trigger price
+    msg.price = 15000;
+    msg.order_type = static_cast<uint8_t>(OrderType::STOP_LIMIT);
+    result = MessageValidator::sanitize_message_fields(msg);
+    EXPECT_TRUE(result.has_error());
+    msg.stop_price = 14500;
+    result = MessageValidator::sanitize_message_fields(msg);
+    EXPECT_TRUE(result.has_value());
+    
+    // Unknown order type
+    msg.order_type = 8;
+    result = MessageValidator::sanitize_message_fields(msg);
+    EXPECT_TRUE(result.has_error());
+}
+
+TEST_F(InputValidationTest, ModifyOrderMessageSanitization) {
+    ModifyOrderMessage msg;
+    msg.order_id = 12345;
+    msg.client_id.assign("CLIENT123");
+    msg.symbol.assign("AAPL");
+    msg.new_quantity = 50;
+    msg.new_price = 0;  // Keep price
+    
+    auto result = MessageValidator::sanitize_message_fields(msg);
+    EXPECT_TRUE(result.has_value());
+    
+    // Zero quantity (use cancel instead)
+    msg.new_quantity = 0;
+    result = MessageValidator::sanitize_message_fields(msg);
+    EXPECT_TRUE(result.has_error());
+    
+    MessageHeader header(MODIFY_ORDER, sizeof(ModifyOrderMessage), 1, 0);
+    EXPECT_TRUE(MessageValidator::validate_message_header(header).has_value());
 }
 
 TEST_F(InputValidationTest, CancelOrderMessageSanitization) {
@@ -283,6 +327,48 @@ TEST_F(InputValidationTest, CrossFieldValidation) {
     EXPECT_FALSE(FieldValidators::validate_percentage(150.0));
 }
 
+TEST_F(InputValidationTest, SymbolsAreCleanedOnlyWhenDirty) {
+    CancelOrderMessage msg;
+    msg.order_id = 1;
+    msg.symbol.assign("MSFT");
+    ASSERT_TRUE(MessageValidator::sanitize_message_fields(msg).has_value());
+    EXPECT_EQ(msg.symbol, "MSFT");
+
+    msg.symbol.assign("ms-ft");
+    ASSERT_TRUE(MessageValidator::sanitize_message_fields(msg).has_value());
+    EXPECT_EQ(msg.symbol, "MSFT");
+}
+
+TEST_F(InputValidationTest, BatchEntriesAreRangeCheckedTogether) {
+    auto entry = [](uint8_t action) {
+        BatchEntryV2 e{};
+        e.action     = action;
+        e.side       = static_cast<uint8_t>(Side::BUY);
+        e.order_type = static_cast<uint8_t>(OrderType::LIMIT);
+        e.order_id   = 7;
+        e.quantity   = 100;
+        e.price      = 15000;
+        return e;
+    };
+    std::vector<BatchEntryV2> entries(10, entry(BATCH_NEW_ORDER));
+    entries[1].quantity = 0;
+    entries[2].side = 9;
+    entries[3].order_type = 42;
+    entries[4].price = 0;                                        // Limit without a price
+    entries[5].display_quantity = 101;
+    entries[6].order_type = static_cast<uint8_t>(OrderType::MARKET);
+    entries[6].price = 0;                                        // Market: no price needed
+    entries[7] = entry(BATCH_CANCEL_ORDER);
+    entries[7].quantity = 0;                                     // Unused by a cancel
+    entries[8] = entry(BATCH_MODIFY_ORDER);
+    entries[8].quantity = MessageValidator::MAX_ORDER_QUANTITY + 1;
+    entries[9] = entry(0);                                       // Unknown action
+
+    std::vector<uint8_t> valid(entries.size(), 2);
+    EXPECT_EQ(MessageValidator::validate_batch_entries(entries.data(), entries.size(), valid.data()), 7u);
+    EXPECT_EQ(valid, (std::vector<uint8_t>{1, 0, 0, 0, 0, 0, 1, 1, 0, 0}));
+}
+
 TEST_F(InputValidationTest, MessageTypeValidation) {
     EXPECT_TRUE(MessageValidator::is_valid_message_type(NEW_ORDER));
     EXPECT_TRUE(MessageValidator::is_valid_message_type(CANCEL_ORDER));
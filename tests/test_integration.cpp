@@ -101,6 +101,47 @@ TEST_F(IntegrationTest, MultiSymbolTrading) {
     EXPECT_EQ(msft_engine->orders_processed(), 1);
 }
 
+TEST_F(IntegrationTest, InstrumentIdsIndexTheEngines) {
+    // Ids follow config order; the id table agrees with the symbol map
+    const InstrumentDirectory* instruments = exchange->get_instrument_directory();
+    ASSERT_NE(instruments, nullptr);
+    EXPECT_EQ(exchange->get_matching_engine(instruments->find(Symbol("AAPL"))),
+              exchange->get_matching_engine("AAPL"));
+    EXPECT_EQ(exchange->get_matching_engine(instruments->find(Symbol("MSFT"))),
+              exchange->get_matching_engine("MSFT"));
+    EXPECT_NE(exchange->get_matching_engine(InstrumentID{0}), nullptr);
+    EXPECT_EQ(exchange->get_matching_engine(INVALID_INSTRUMENT), nullptr);
+}
+
+TEST(SymbolLifecycleTest, ListHaltAndResumeMoveTheStateByte) {
+    auto config = std::make_unique<Config>();
+    config->exchange.name = "LIFECYCLE";
+    config->performance.order_pool_size = 1000;
+    config->symbols = {{"AAPL", 0.01, 1, 10.0}, {"NEWCO", 0.01, 1, 10.0}};
+    config->symbols[1].listed = false;
+    Exchange exchange(std::move(config));
+
+    const Symbol aapl("AAPL"), newco("NEWCO");
+    EXPECT_EQ(exchange.symbol_state(aapl), InstrumentState::OPEN);
+    EXPECT_EQ(exchange.symbol_state(newco), InstrumentState::UNLISTED);
+    EXPECT_EQ(exchange.symbol_state(Symbol("ZZZZ")), InstrumentState::UNLISTED);
+
+    // Reserved from construction: same engine table, id and risk slot as any symbol
+    ASSERT_NE(exchange.get_matching_engine(newco), nullptr);
+    EXPECT_FALSE(exchange.halt_symbol(newco));   // Not listed yet
+    EXPECT_TRUE(exchange.list_symbol(newco));
+    EXPECT_FALSE(exchange.list_symbol(newco));
+    EXPECT_EQ(exchange.symbol_state(newco), InstrumentState::OPEN);
+
+    EXPECT_FALSE(exchange.resume_symbol(aapl));  // Not halted
+    EXPECT_TRUE(exchange.halt_symbol(aapl));
+    EXPECT_EQ(exchange.symbol_state(aapl), InstrumentState::HALTED);
+    EXPECT_FALSE(exchange.halt_symbol(aapl));
+    EXPECT_TRUE(exchange.resume_symbol(aapl));
+    EXPECT_EQ(exchange.symbol_state(aapl), InstrumentState::OPEN);
+    EXPECT_FALSE(exchange.list_symbol(Symbol("ZZZZ")));
+}
+
 TEST_F(IntegrationTest, RiskRejectionFlow) {
     auto* risk_manager = exchange->get_risk_manager();
     OrderPool pool(100);
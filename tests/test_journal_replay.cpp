@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "rtes/journal_replay.hpp"
+#include "rtes/matching_engine.hpp"
+#include "rtes/memory_pool.hpp"
+
+#include <unistd.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace rtes {
+
+namespace {
+
+std::string journal_path(const char* name) {
+    return (std::filesystem::temp_directory_path() /
+            (std::string(name) + "-" + std::to_string(::getpid()) + ".journal")).string();
+}
+
+/** Journal a shard trading two books: sweeps, a modify, cancels and a reject */
+void record_session(const std::string& path) {
+    EventJournal journal(path);
+    OrderPool pool(1000);
+    MarketDataLane market_data(10000);
+    MatchingEngine engine("shard-0", {{"AAPL", {}}, {"MSFT", {}}}, pool);
+    engine.set_market_data_queue(&market_data);
+    engine.set_event_journal(journal.add_engine(engine.name()));
+    ASSERT_TRUE(journal.start());
+    engine.start();
+
+    OrderID id = 0;
+    for (BookIndex book = 0; book < 2; ++book) {
+        const char* symbol = book == 0 ? "AAPL" : "MSFT";
+        for (int i = 0; i < 20; ++i) {
+            auto* order = pool.allocate();
+            const Side side = i % 2 ? Side::BUY : Side::SELL;
+            new (order) Order(++id, "100", symbol, side, OrderType::LIMIT, 10 + i, 15000 + (i % 5) - 2);
+            ASSERT_TRUE(engine.submit_order(order, book));
+        }
+        ASSERT_TRUE(engine.modify_order(id, ClientID("100"), 5, 15010, book));
+        ASSERT_TRUE(engine.cancel_order(id - 1, ClientID("100"), book));
+    }
+    auto* invalid = pool.allocate();
+    new (invalid) Order(++id, "100", "AAPL", Side::BUY, OrderType::LIMIT, 0, 15000);  // Rejected
+    ASSERT_TRUE(engine.submit_order(invalid, 0));
+    engine.stop();
+    journal.stop();
+    ASSERT_EQ(journal.drops(), 0u);
+}
+
+} // namespace
+
+TEST(JournalReplayTest, ReplayReproducesTheRecordedOutputs) {
+    const std::string path = journal_path("rtes-replay-identical");
+    record_session(path);
+
+    size_t trades = 0, records = 0;
+    ASSERT_TRUE(read_journal(path, [&](const JournalRecord& r) {
+        ++records;
+        if (r.type == JournalRecordType::TRADE) ++trades;
+    }));
+    ASSERT_GT(trades, 0u);
+
+    const ReplayReport report = replay_journal(path);
+    EXPECT_TRUE(report.error.empty()) << report.error;
+    EXPECT_TRUE(report.ok());
+    EXPECT_EQ(report.records, records);
+    EXPECT_EQ(report.requests, 45u);  // 40 orders, 2 modifies, 2 cancels, the reject
+    ASSERT_EQ(report.engines.size(), 1u);
+    EXPECT_EQ(report.engines[0].engine, "shard-0");
+    EXPECT_EQ(report.engines[0].outputs, records);
+    EXPECT_TRUE(report.mismatches.empty());
+
+    // The layout the exchange would build must agree with the journal
+    std::vector<EngineLayout> layout{{"shard-0", {{"AAPL", {}}, {"MSFT", {}}}, 0}};
+    EXPECT_TRUE(replay_journal(path, layout).ok());
+    layout[0].books[1].symbol = "GOOGL";
+    EXPECT_FALSE(replay_journal(path, layout).error.empty());
+    layout[0].name = "shard-1";
+    EXPECT_FALSE(replay_journal(path, layout).error.empty());
+    std::filesystem::remove(path);
+}
+
+TEST(JournalReplayTest, AlteredTradeIsReportedAsMismatch) {
+    const std::string path = journal_path("rtes-replay-altered");
+    record_session(path);
+
+    // Change the quantity of the first trade in place
+    std::vector<JournalRecord> records;
+    ASSERT_TRUE(read_journal(path, [&](const JournalRecord& r) { records.push_back(r); }));
+    size_t index = 0;
+    while (records[index].type != JournalRecordType::TRADE) ++index;
+    JournalRecord altered = records[index];
+    altered.trade.quantity += 1;
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(JOURNAL_BLOCK + index * sizeof(JournalRecord)));
+        file.write(reinterpret_cast<const char*>(&altered), sizeof(altered));
+    }
+
+    const ReplayReport report = replay_journal(path);
+    EXPECT_TRUE(report.error.empty()) << report.error;
+    EXPECT_FALSE(report.ok());
+    EXPECT_EQ(report.engines[0].mismatches, 1u);
+    ASSERT_EQ(report.mismatches.size(), 1u);
+    EXPECT_EQ(report.mismatches[0].seq, altered.seq);
+    EXPECT_NE(report.mismatches[0].detail.find("trade"), std::string::npos);
+    std::filesystem::remove(path);
+}
+
+} // namespace rtes
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "rtes/logger.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rtes {
+
+namespace {
+
+/** format_record() of the record the deferred path would build */
+template<typename... Args>
+std::string round_trip(std::format_string<Args...> fmt, const Args&... args, bool* truncated = nullptr) {
+    LogRecord record;
+    (detail::log_encode(record, args), ...);
+    if (truncated) *truncated = record.truncated;
+    return Logger::format_record(fmt.get(), record);
+}
+
+} // namespace
+
+TEST(LoggerTest, RecordFormatsLikeStdFormat) {
+    const std::string symbol = "AAPL";
+    bool truncated = true;
+    EXPECT_EQ((round_trip<uint64_t, int, std::string, double, bool, char>(
+                  "order {} {} {} @ {:.2f} ioc={} side={}", 42, -7, symbol, 150.256, true, 'B', &truncated)),
+              "order 42 -7 AAPL @ 150.26 ioc=true side=B");
+    EXPECT_FALSE(truncated);
+
+    EXPECT_EQ((round_trip<int, int>("{{{0}}} {1}-{0} {1:>4}|", 1, 2)), "{1} 2-1    2|");
+    EXPECT_EQ(round_trip<>("no args"), "no args");
+}
+
+TEST(LoggerTest, OversizedArgumentsAreCutShort) {
+    const std::string big(LOG_PAYLOAD_BYTES * 2, 'x');
+    bool truncated = false;
+    const std::string text = round_trip<std::string, int>("{} then {}", big, 99, &truncated);  // 99 dropped
+    EXPECT_TRUE(truncated);
+    EXPECT_EQ(text.rfind("xxx", 0), 0u);
+    EXPECT_NE(text.find(" then ? [truncated]"), std::string::npos);
+    EXPECT_LT(text.size(), big.size());
+}
+
+TEST(LoggerTest, DeferredWritesFromManyThreads) {
+    Logger& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    logger.set_rate_limit(std::chrono::milliseconds(0));
+    const uint64_t written = logger.written();
+    const uint64_t dropped = logger.dropped();
+
+    logger.start_async();
+    ASSERT_TRUE(logger.is_async());
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 100;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < PER_THREAD; ++i) LOG_INFO("deferred test thread {} line {}", t, i);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    logger.stop_async();
+    EXPECT_FALSE(logger.is_async());
+
+    // The rings of the exited threads went back to the pool
+    logger.start_async();
+    std::thread([] { LOG_INFO("deferred test reuse"); }).join();
+    logger.stop_async();
+
+    EXPECT_EQ(logger.written() + (logger.dropped() - dropped) - written, THREADS * PER_THREAD + 1u);
+}
+
+TEST(LoggerTest, RecordsStdoutRefusesAreLostNotWritten) {
+    Logger& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    logger.set_rate_limit(std::chrono::milliseconds(0));
+    const int full = open("/dev/full", O_WRONLY);
+    if (full < 0) GTEST_SKIP() << "no /dev/full";
+    const uint64_t written = logger.written();
+    const uint64_t lost = logger.lost();
+
+    std::cout.flush();
+    const int saved = dup(STDOUT_FILENO);
+    dup2(full, STDOUT_FILENO);
+    logger.start_async();
+    std::thread([] { for (int i = 0; i < 10; ++i) LOG_INFO("deferred test refused line {}", i); }).join();
+    logger.stop_async();
+    std::cout.clear();
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    close(full);
+
+    EXPECT_EQ(logger.written(), written);
+    EXPECT_EQ(logger.lost() - lost, 10u);
+}
+
+TEST(LoggerTest, SitesThrottleAndSwitchOffIndependently) {
+    Logger& logger = Logger::instance();
+    logger.set_level(LogLevel::INFO);
+    logger.set_rate_limit(std::chrono::milliseconds(0));
+
+    auto noisy = [](int i) { LOG_INFO("site test noisy {}", i); };
+    auto quiet = [](int i) { LOG_INFO("site test quiet {}", i); };
+    noisy(0);
+    quiet(0);
+    const std::vector<LogSite*> found = LogSiteRegistry::instance().match("test_logger.cpp");
+    LogSite* noisy_site = nullptr;
+    LogSite* quiet_site = nullptr;
+    for (LogSite* site : found) {
+        if (site->format == "site test noisy {}") noisy_site = site;
+        if (site->format == "site test quiet {}") quiet_site = site;
+    }
+    ASSERT_NE(noisy_site, nullptr);
+    ASSERT_NE(quiet_site, nullptr);
+    EXPECT_NE(noisy_site->id, quiet_site->id);
+    EXPECT_EQ(noisy_site->level, LogLevel::INFO);
+    EXPECT_EQ(LogSiteRegistry::instance().find(noisy_site->id), noisy_site);
+    EXPECT_EQ(LogSiteRegistry::instance().match("test_logger.cpp", noisy_site->line).size(), 1u);
+
+    noisy_site->rate_limit_ns.store(std::chrono::nanoseconds(std::chrono::hours(1)).count());
+    for (int i = 1; i <= 10; ++i) {
+        noisy(i);
+        quiet(i);
+    }
+    EXPECT_EQ(noisy_site->suppressed.load(), 9u);  // noisy(1) opened the window
+    EXPECT_EQ(quiet_site->suppressed.load(), 0u);
+
+    quiet_site->enabled.store(false);
+    quiet(11);
+    EXPECT_EQ(quiet_site->suppressed.load(), 0u);  // Off, not throttled
+    quiet_site->enabled.store(true);
+    noisy_site->rate_limit_ns.store(-1);
+}
+
+} // namespace rtes
@@ -1,8 +1,10 @@
 #include <gtest/gtest.h>
 #include "rtes/matching_engine.hpp"
+#include "rtes/book_rebalancer.hpp"
 #include "rtes/memory_pool.hpp"
 #include <thread>
 #include <chrono>
+#include <sched.h>
 
 namespace rtes {
 
@@ -10,7 +12,7 @@ class MatchingEngineTest : public ::testing::Test {
 protected:
     void SetUp() override {
         pool = std::make_unique<OrderPool>(1000);
-        market_data_queue = std::make_unique<MPMCQueue<MarketDataEvent>>(1000);
+        market_data_queue = std::make_unique<MarketDataLane>(1000);
         engine = std::make_unique<MatchingEngine>("AAPL", *pool);
         engine->set_market_data_queue(market_data_queue.get());
         engine->start();
@@ -28,7 +30,7 @@ protected:
     }
     
     std::unique_ptr<OrderPool> pool;
-    std::unique_ptr<MPMCQueue<MarketDataEvent>> market_data_queue;
+    std::unique_ptr<MarketDataLane> market_data_queue;
     std::unique_ptr<MatchingEngine> engine;
 };
 
@@ -140,4 +142,686 @@ TEST_F(MatchingEngineTest, BBOUpdates) {
     EXPECT_TRUE(found_bbo);
 }
 
+TEST(ShardedMatchingEngineTest, DispatchesByBookIndex) {
+    OrderPool pool(100);
+    MarketDataLane market_data(1000);
+    MatchingEngine engine("shard-0", {{"AAPL", {}}, {"MSFT", {}}}, pool);
+    engine.set_market_data_queue(&market_data);
+
+    ASSERT_EQ(engine.book_count(), 2);
+    const BookIndex msft = engine.book_index(Symbol("MSFT"));
+    ASSERT_EQ(msft, 1);
+    EXPECT_EQ(engine.book_index(Symbol("GOOGL")), NO_BOOK);
+
+    auto* sell = pool.allocate();
+    new (sell) Order(1, "100", "MSFT", Side::SELL, OrderType::LIMIT, 100, 30000);
+    auto* buy = pool.allocate();
+    new (buy) Order(2, "101", "MSFT", Side::BUY, OrderType::LIMIT, 100, 30000);
+
+    engine.start();
+    EXPECT_TRUE(engine.submit_order(sell, msft));
+    EXPECT_TRUE(engine.submit_order(buy, msft));
+    EXPECT_FALSE(engine.cancel_order(1, ClientID("100"), 2));  // No such book
+    engine.stop();  // Drains and flushes stats
+
+    EXPECT_EQ(engine.trades_executed(), 1);
+    MarketDataEvent event;
+    bool found_trade = false;
+    while (market_data.pop(event)) {
+        EXPECT_STREQ(event.symbol, "MSFT");
+        if (event.type == MarketDataEvent::TRADE) found_trade = true;
+    }
+    EXPECT_TRUE(found_trade);
+}
+
+TEST(ShardedMatchingEngineTest, RoutesMarketDataPerBookChannel) {
+    OrderPool pool(100);
+    MarketDataLane default_queue(100);
+    MarketDataLane msft_queue(100);
+    MatchingEngine engine("shard-0", {{"AAPL", {}}, {"MSFT", {}}}, pool);
+    engine.set_market_data_queue(&default_queue);
+    engine.set_market_data_route(1, 3, &msft_queue);
+
+    auto* aapl = pool.allocate();
+    new (aapl) Order(1, "100", "AAPL", Side::BUY, OrderType::LIMIT, 100, 15000);
+    auto* msft = pool.allocate();
+    new (msft) Order(2, "100", "MSFT", Side::BUY, OrderType::LIMIT, 100, 30000);
+
+    engine.start();
+    EXPECT_TRUE(engine.submit_order(aapl, 0));
+    EXPECT_TRUE(engine.submit_order(msft, 1));
+    engine.stop();
+
+    MarketDataEvent event;
+    ASSERT_TRUE(default_queue.pop(event));
+    EXPECT_STREQ(event.symbol, "AAPL");
+    EXPECT_EQ(event.channel, 0);
+    EXPECT_FALSE(default_queue.pop(event));
+    ASSERT_TRUE(msft_queue.pop(event));
+    EXPECT_STREQ(event.symbol, "MSFT");
+    EXPECT_EQ(event.channel, 3);
+    EXPECT_FALSE(msft_queue.pop(event));
+}
+
+TEST(ShardedMatchingEngineTest, OrderFeedGoesToItsOwnChannel) {
+    OrderPool pool(100);
+    MarketDataLane market_data(100);
+    MarketDataLane order_feed(100);
+    MatchingEngine engine("shard-0", {{"AAPL", {}}, {"MSFT", {}}}, pool);
+    engine.set_market_data_queue(&market_data);
+    engine.set_order_feed_route(1, 5, &order_feed);
+
+    auto* aapl = pool.allocate();
+    new (aapl) Order(1, "100", "AAPL", Side::BUY, OrderType::LIMIT, 100, 15000);
+    auto* rest = pool.allocate();
+    new (rest) Order(2, "100", "MSFT", Side::BUY, OrderType::LIMIT, 100, 30000);
+    auto* hit = pool.allocate();
+    new (hit) Order(3, "101", "MSFT", Side::SELL, OrderType::LIMIT, 40, 30000);
+
+    engine.start();
+    EXPECT_TRUE(engine.submit_order(aapl, 0));
+    EXPECT_TRUE(engine.submit_order(rest, 1));
+    EXPECT_TRUE(engine.submit_order(hit, 1));
+    engine.stop();
+
+    // Only the routed book reports, and only on the order feed
+    MarketDataEvent event;
+    while (market_data.pop(event)) EXPECT_NE(event.type, MarketDataEvent::ORDER_EVENT);
+    ASSERT_TRUE(order_feed.pop(event));
+    EXPECT_EQ(event.type, MarketDataEvent::ORDER_EVENT);
+    EXPECT_STREQ(event.symbol, "MSFT");
+    EXPECT_EQ(event.channel, 5);
+    EXPECT_EQ(event.order.kind, OrderEvent::ADD);
+    EXPECT_EQ(event.order.order_id, 2u);
+    ASSERT_TRUE(order_feed.pop(event));
+    EXPECT_EQ(event.order.kind, OrderEvent::EXECUTE);
+    EXPECT_EQ(event.order.remaining, 60u);
+    EXPECT_EQ(event.order.quantity, 40u);
+    EXPECT_FALSE(order_feed.pop(event));
+}
+
+TEST(IncrementalDepthTest, EmitsLevelStateAfterEachChange) {
+    OrderPool pool(100);
+    MarketDataLane market_data(1000);
+    MatchingEngine engine("AAPL", pool);
+    engine.set_market_data_queue(&market_data);
+    DepthPublishPolicy policy;
+    policy.incremental = true;
+    engine.set_depth_publishing(policy);
+
+    auto* sell = pool.allocate();
+    new (sell) Order(1, "100", "AAPL", Side::SELL, OrderType::LIMIT, 100, 15000);
+    auto* buy = pool.allocate();
+    new (buy) Order(2, "101", "AAPL", Side::BUY, OrderType::LIMIT, 40, 15000);
+
+    engine.start();
+    EXPECT_TRUE(engine.submit_order(sell));
+    EXPECT_TRUE(engine.submit_order(buy));
+    EXPECT_TRUE(engine.cancel_order(1, ClientID("100")));
+    engine.stop();
+
+    std::vector<MarketDataEvent::LevelData> levels;
+    MarketDataEvent event;
+    while (market_data.pop(event)) {
+        if (event.type != MarketDataEvent::DEPTH_LEVEL) continue;
+        EXPECT_STREQ(event.symbol, "AAPL");
+        levels.push_back(event.level);
+    }
+    // Rest 100, partial fill leaves 60, cancel deletes the level
+    ASSERT_EQ(levels.size(), 3u);
+    for (const auto& level : levels) {
+        EXPECT_EQ(level.side, Side::SELL);
+        EXPECT_EQ(level.price, 15000u);
+    }
+    EXPECT_EQ(levels[0].quantity, 100u);
+    EXPECT_EQ(levels[0].order_count, 1u);
+    EXPECT_EQ(levels[1].quantity, 60u);
+    EXPECT_EQ(levels[2].quantity, 0u);
+    EXPECT_EQ(levels[2].order_count, 0u);
+}
+
+TEST(IncrementalDepthTest, RejectsMoreLevelsThanPublishedDepthHolds) {
+    OrderPool pool(10);
+    MatchingEngine engine("AAPL", pool);
+    DepthPublishPolicy policy;
+    policy.levels = MAX_DEPTH_LEVELS + 1;
+    EXPECT_THROW(engine.set_depth_publishing(policy), std::invalid_argument);
+    policy.levels = MAX_DEPTH_LEVELS;
+    EXPECT_NO_THROW(engine.set_depth_publishing(policy));
+}
+
+TEST(BboConflationTest, OneBboPerBookPerBatchTradesKept) {
+    OrderPool pool(100);
+    MarketDataLane market_data(1000);
+    MatchingEngine engine("shard-0", {{"AAPL", {}}, {"MSFT", {}}}, pool);
+    engine.set_market_data_queue(&market_data);
+    engine.set_bbo_conflation(true);
+
+    // Queued before start so the engine drains them as one batch
+    Order* orders[4];
+    for (auto*& order : orders) order = pool.allocate();
+    new (orders[0]) Order(1, "100", "AAPL", Side::SELL, OrderType::LIMIT, 100, 15000);
+    new (orders[1]) Order(2, "100", "AAPL", Side::BUY, OrderType::LIMIT, 100, 14900);
+    new (orders[2]) Order(3, "101", "AAPL", Side::BUY, OrderType::LIMIT, 40, 15000);
+    new (orders[3]) Order(4, "100", "MSFT", Side::BUY, OrderType::LIMIT, 100, 30000);
+    EXPECT_TRUE(engine.submit_order(orders[0], 0));
+    EXPECT_TRUE(engine.submit_order(orders[1], 0));
+    EXPECT_TRUE(engine.submit_order(orders[2], 0));
+    EXPECT_TRUE(engine.submit_order(orders[3], 1));
+    engine.start();
+    engine.stop();
+
+    int trades = 0;
+    std::vector<MarketDataEvent> bbos;
+    MarketDataEvent event;
+    while (market_data.pop(event)) {
+        if (event.type == MarketDataEvent::TRADE) ++trades;
+        if (event.type == MarketDataEvent::BBO_UPDATE) bbos.push_back(event);
+    }
+    EXPECT_EQ(trades, 1);
+    ASSERT_EQ(bbos.size(), 2u);
+    EXPECT_STREQ(bbos[0].symbol, "AAPL");
+    EXPECT_EQ(bbos[0].bbo.bid_price, 14900u);
+    EXPECT_EQ(bbos[0].bbo.ask_price, 15000u);
+    EXPECT_EQ(bbos[0].bbo.ask_quantity, 60u);
+    EXPECT_STREQ(bbos[1].symbol, "MSFT");
+    EXPECT_EQ(bbos[1].bbo.bid_price, 30000u);
+}
+
+TEST(TradeMarketDataTest, CarriesTheIncomingOrdersSide) {
+    OrderPool pool(100);
+    MarketDataLane market_data(1000);
+    MatchingEngine engine("shard-0", {{"AAPL", {}}}, pool);
+    engine.set_market_data_queue(&market_data);
+
+    Order* orders[4];
+    for (auto*& order : orders) order = pool.allocate();
+    new (orders[0]) Order(1, "100", "AAPL", Side::SELL, OrderType::LIMIT, 100, 15000);
+    new (orders[1]) Order(2, "101", "AAPL", Side::BUY, OrderType::LIMIT, 40, 15000);
+    new (orders[2]) Order(3, "100", "AAPL", Side::BUY, OrderType::LIMIT, 100, 14900);
+    new (orders[3]) Order(4, "101", "AAPL", Side::SELL, OrderType::LIMIT, 30, 14900);
+    engine.start();
+    for (auto* order : orders) EXPECT_TRUE(engine.submit_order(order, 0));
+    engine.stop();
+
+    std::vector<MarketDataEvent> trades;
+    MarketDataEvent event;
+    while (market_data.pop(event)) {
+        if (event.type == MarketDataEvent::TRADE) trades.push_back(event);
+    }
+    ASSERT_EQ(trades.size(), 2u);
+    EXPECT_EQ(trades[0].aggressor_side, static_cast<uint8_t>(Side::BUY));
+    EXPECT_EQ(trades[1].aggressor_side, static_cast<uint8_t>(Side::SELL));
+    EXPECT_NE(trades[0].trade.timestamp, 0u);
+    EXPECT_LE(trades[0].trade.timestamp, trades[1].trade.timestamp);
+}
+
+TEST(TradeMarketDataTest, SweepPublishesItsTradesAsOneRunThenTheSummary) {
+    constexpr int resting = 40;  // More than one TRADE_BATCH
+    OrderPool pool(100);
+    MarketDataLane market_data(1024);
+    MatchingEngine engine("shard-0", {{"AAPL", {}}}, pool);
+    engine.set_market_data_queue(&market_data);
+    engine.set_sweep_summary(true);
+    engine.start();
+    for (int i = 0; i < resting; ++i) {
+        auto* sell = pool.allocate();
+        new (sell) Order(i + 1, "100", "AAPL", Side::SELL, OrderType::LIMIT, 10, 15000 + i);
+        ASSERT_TRUE(engine.submit_order(sell));
+    }
+    auto* buy = pool.allocate();
+    new (buy) Order(100, "101", "AAPL", Side::BUY, OrderType::LIMIT, 10 * resting + 5, 16000);
+    ASSERT_TRUE(engine.submit_order(buy));
+    engine.stop();
+
+    std::vector<MarketDataEvent> events;
+    MarketDataEvent event;
+    while (market_data.pop(event)) events.push_back(event);
+    auto first_trade = std::find_if(events.begin(), events.end(), [](const MarketDataEvent& e) {
+        return e.type == MarketDataEvent::TRADE;
+    });
+    ASSERT_GE(events.end() - first_trade, resting + 2);
+
+    // Every fill in order, then the summary, then the book's other events
+    for (int i = 0; i < resting; ++i) {
+        ASSERT_EQ(first_trade[i].type, MarketDataEvent::TRADE) << i;
+        EXPECT_EQ(first_trade[i].trade.price, static_cast<Price>(15000 + i));
+    }
+    const MarketDataEvent& sweep = first_trade[resting];
+    ASSERT_EQ(sweep.type, MarketDataEvent::SWEEP);
+    EXPECT_EQ(sweep.aggressor_side, static_cast<uint8_t>(Side::BUY));
+    EXPECT_EQ(sweep.sweep.fills, static_cast<uint32_t>(resting));
+    EXPECT_EQ(sweep.sweep.quantity, static_cast<Quantity>(10 * resting));
+    EXPECT_EQ(sweep.sweep.first_trade_id, first_trade[0].trade.id);
+    EXPECT_EQ(sweep.sweep.first_price, 15000u);
+    EXPECT_EQ(sweep.sweep.last_price, static_cast<Price>(15000 + resting - 1));
+    EXPECT_STREQ(sweep.symbol, "AAPL");
+    EXPECT_EQ(first_trade[resting + 1].type, MarketDataEvent::BBO_UPDATE);
+    EXPECT_EQ(engine.get_stats().md_drops, 0u);
+}
+
+TEST(BBOTableTest, BooksPublishTheirTopIntoTheExchangeTable) {
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}, {"MSFT", 0.01, 1, 10.0}};
+    OrderPool pool(16);
+    MatchingEngine engine("shard-0", {{"AAPL", {}}, {"MSFT", {}}}, pool);
+    BBOTable table(symbols);
+    engine.set_bbo_table(table);
+
+    auto* bid = pool.allocate();
+    new (bid) Order(1, "100", "AAPL", Side::BUY, OrderType::LIMIT, 30, 14900);
+    auto* ask = pool.allocate();
+    new (ask) Order(2, "100", "AAPL", Side::SELL, OrderType::LIMIT, 20, 15100);
+    auto* behind = pool.allocate();
+    new (behind) Order(3, "100", "AAPL", Side::SELL, OrderType::LIMIT, 20, 15200);
+    const BookIndex book = engine.book_index(Symbol("AAPL"));
+    engine.start();
+    ASSERT_TRUE(engine.submit_order(bid, book));
+    ASSERT_TRUE(engine.submit_order(ask, book));
+    ASSERT_TRUE(engine.submit_order(behind, book));
+    engine.stop();
+
+    BBOSnapshot aapl;
+    ASSERT_TRUE(table.slot(Symbol("AAPL"))->read(aapl));
+    EXPECT_EQ(aapl.bid_price, 14900u);
+    EXPECT_EQ(aapl.bid_quantity, 30u);
+    EXPECT_EQ(aapl.ask_price, 15100u);
+    EXPECT_EQ(aapl.ask_quantity, 20u);
+    EXPECT_EQ(aapl.sequence, 2u);  // The order behind the best published nothing
+
+    BBOSnapshot msft;
+    ASSERT_TRUE(table.slot(Symbol("MSFT"))->read(msft));
+    EXPECT_EQ(msft.bid_price, 0u);
+    EXPECT_EQ(msft.sequence, 0u);
+}
+
+TEST(FairSchedulingTest, QuietBookIsNotStuckBehindABurst) {
+    constexpr int burst = 40;
+    OrderPool pool(100);
+    MarketDataLane market_data(1024);
+    MatchingEngine engine("shard-0", {{"AAPL", {}}, {"MSFT", {}}}, pool);
+    engine.set_market_data_queue(&market_data);
+    engine.set_fair_scheduling(4);
+    const BookIndex aapl = engine.book_index(Symbol("AAPL"));
+    const BookIndex msft = engine.book_index(Symbol("MSFT"));
+
+    // Queued before the thread starts: the whole AAPL burst ahead of MSFT
+    OrderID id = 1;
+    for (int i = 0; i < burst; ++i) {
+        auto* order = pool.allocate();
+        new (order) Order(id++, "100", "AAPL", Side::BUY, OrderType::LIMIT, 10, 15000 + i);
+        ASSERT_TRUE(engine.submit_order(order, aapl));
+    }
+    for (int i = 0; i < 4; ++i) {
+        auto* order = pool.allocate();
+        new (order) Order(id++, "100", "MSFT", Side::BUY, OrderType::LIMIT, 10, 30000 + i);
+        ASSERT_TRUE(engine.submit_order(order, msft));
+    }
+    engine.start();
+    engine.stop();
+
+    // Every order raises its book's bid: one BBO each, in matching order
+    std::vector<std::string> matched;
+    MarketDataEvent event;
+    while (market_data.pop(event)) {
+        if (event.type == MarketDataEvent::BBO_UPDATE) matched.emplace_back(event.symbol);
+    }
+    ASSERT_EQ(matched.size(), static_cast<size_t>(burst + 4));
+    const auto last_msft = std::find(matched.rbegin(), matched.rend(), "MSFT");
+    EXPECT_LE(matched.rend() - last_msft, 8);  // MSFT's turn came after one AAPL slice
+
+    const std::vector<BookScheduleStats> stats = engine.schedule_stats();
+    ASSERT_EQ(stats.size(), 2u);
+    EXPECT_EQ(stats[aapl].symbol, "AAPL");
+    EXPECT_EQ(stats[aapl].requests, static_cast<uint64_t>(burst));
+    EXPECT_EQ(stats[msft].requests, 4u);
+    EXPECT_EQ(stats[aapl].backlog, 0u);
+    EXPECT_GE(stats[aapl].delay_max_ns, stats[msft].delay_max_ns);
+}
+
+TEST(FairSchedulingTest, MassCancelOfEveryBookWaitsForStagedRequests) {
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}, {"MSFT", 0.01, 1, 10.0}};
+    OrderPool pool(32);
+    MatchingEngine engine("shard-0", {{"AAPL", {}}, {"MSFT", {}}}, pool);
+    BBOTable table(symbols);
+    engine.set_bbo_table(table);
+    engine.set_fair_scheduling(1);
+    const BookIndex aapl = engine.book_index(Symbol("AAPL"));
+    const BookIndex msft = engine.book_index(Symbol("MSFT"));
+
+    auto submit = [&](OrderID id, const char* symbol, BookIndex book) {
+        auto* order = pool.allocate();
+        new (order) Order(id, "100", symbol, Side::BUY, OrderType::LIMIT, 10, 15000);
+        order->owner = 7;
+        ASSERT_TRUE(engine.submit_order(order, book));
+    };
+    for (OrderID id = 1; id <= 8; ++id) submit(id, "AAPL", aapl);
+    ASSERT_TRUE(engine.mass_cancel(7, NO_BOOK));
+    submit(9, "MSFT", msft);
+    engine.start();
+    engine.stop();
+
+    BBOSnapshot top;
+    ASSERT_TRUE(table.slot(Symbol("AAPL"))->read(top));
+    EXPECT_EQ(top.bid_price, 0u);  // Rested first, then cancelled
+    ASSERT_TRUE(table.slot(Symbol("MSFT"))->read(top));
+    EXPECT_EQ(top.bid_price, 15000u);  // Came after the cancel
+}
+
+TEST(BookMigrationTest, MovedBookKeepsItsOrdersAndWhatWasSentAheadOfIt) {
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}, {"MSFT", 0.01, 1, 10.0}};
+    OrderPool pool(32);
+    BBOTable table(symbols);
+    // Lane 0: the producer; lane 1: control
+    MatchingEngine a("shard-0", {{"AAPL", {}}, {"MSFT", {}, 1, false}}, pool, 2);
+    MatchingEngine b("shard-1", {{"MSFT", {}}, {"AAPL", {}, 1, false}}, pool, 2);
+    a.set_bbo_table(table);
+    b.set_bbo_table(table);
+    a.start();
+    b.start();
+
+    MatchingEngine* route = &a;
+    auto submit = [&](OrderID id, Side side, Quantity quantity, Price price, ClientIDRaw owner) {
+        auto* order = pool.allocate();
+        new (order) Order(id, "100", "AAPL", side, OrderType::LIMIT, quantity, price);
+        order->owner = owner;
+        ASSERT_TRUE(route->submit_order(order, route->book_index(Symbol("AAPL"))));
+    };
+    submit(1, Side::SELL, 10, 15000, 7);
+    submit(2, Side::SELL, 10, 15100, 9);
+
+    // Sent to b before it has the book: held, then matched ahead of anything later
+    const auto result = migrate_book(Symbol("AAPL"), a, b, 1, [&] {
+        route = &b;
+        submit(3, Side::BUY, 4, 15000, 8);
+        EXPECT_TRUE(b.mass_cancel(9, NO_BOOK));
+        return true;
+    });
+    ASSERT_TRUE(result.moved);
+    EXPECT_TRUE(a.release_idle());
+
+    submit(4, Side::BUY, 5, 15000, 8);
+    b.stop();
+    a.stop();
+
+    BBOSnapshot top;
+    ASSERT_TRUE(table.slot(Symbol("AAPL"))->read(top));
+    EXPECT_EQ(top.ask_price, 15000u);  // Order 2 cancelled, order 1 left with 10 - 4 - 5
+    EXPECT_EQ(top.ask_quantity, 1u);
+    EXPECT_EQ(top.bid_price, 0u);
+
+    EXPECT_EQ(a.book_requests()[a.book_index(Symbol("AAPL"))], 2u);
+    EXPECT_EQ(b.book_requests()[b.book_index(Symbol("AAPL"))], 2u);
+
+    // Depth stays readable through either engine
+    DepthSnapshot from_a, from_b;
+    ASSERT_TRUE(a.read_depth(from_a, a.book_index(Symbol("AAPL"))));
+    ASSERT_TRUE(b.read_depth(from_b, b.book_index(Symbol("AAPL"))));
+    EXPECT_EQ(from_a.update_sequence, from_b.update_sequence);
+    EXPECT_EQ(from_b.ask_levels, 1u);
+}
+
+TEST(BookMigrationTest, ReleaseWaitsUntilMarketDataIsRead) {
+    OrderPool pool(8);
+    MarketDataLane md_queue(64);
+    MatchingEngine a("shard-0", {{"AAPL", {}}}, pool, 2);
+    MatchingEngine b("shard-1", {{"MSFT", {}}, {"AAPL", {}, 1, false}}, pool, 2);
+    a.set_market_data_queue(&md_queue);
+    a.start();
+    b.start();
+
+    auto* order = pool.allocate();
+    new (order) Order(1, "100", "AAPL", Side::BUY, OrderType::LIMIT, 10, 15000);
+    ASSERT_TRUE(a.submit_order(order));
+    ASSERT_TRUE(a.release_book(0, 1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(a.book_released());  // Its events are still queued: b must not overtake them
+
+    MarketDataEvent event;
+    while (md_queue.pop(event)) {}
+    for (int i = 0; i < 1000 && !a.book_released(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(a.book_released());
+
+    ASSERT_TRUE(b.adopt_book(a, b.book_index(Symbol("AAPL")), 1));
+    for (int i = 0; i < 1000 && !a.release_idle(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(a.release_idle());
+    b.stop();
+    a.stop();
+}
+
+TEST(BookMigrationTest, RefusedBeforeReroutingUnlessOneHostsAndTheOtherIsVacant) {
+    OrderPool pool(8);
+    MatchingEngine a("shard-0", {{"AAPL", {}}}, pool, 2);
+    MatchingEngine b("shard-1", {{"MSFT", {}}, {"AAPL", {}, 1, false}}, pool, 2);
+    MatchingEngine c("shard-2", {{"AAPL", {}}}, pool, 2);
+    const BookIndex vacant = b.book_index(Symbol("AAPL"));
+    EXPECT_TRUE(a.hosts_book(0));
+    EXPECT_FALSE(b.hosts_book(vacant));
+    a.start();
+    b.start();
+    c.start();
+
+    // Past the reroute a move cannot be undone: these must never get there
+    bool rerouted = false;
+    auto reroute = [&] { rerouted = true; return true; };
+    EXPECT_FALSE(migrate_book(Symbol("AAPL"), b, a, 1, reroute).moved);  // b has nothing to release
+    EXPECT_FALSE(migrate_book(Symbol("AAPL"), a, c, 1, reroute).moved);  // c has its own book
+    EXPECT_FALSE(rerouted);
+
+    ASSERT_TRUE(migrate_book(Symbol("AAPL"), a, b, 1, reroute).moved);
+    EXPECT_TRUE(rerouted);
+    EXPECT_FALSE(a.hosts_book(0));
+    for (int i = 0; i < 1000 && !b.hosts_book(vacant); ++i) {  // Adopted once b's worker applies it
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(b.hosts_book(vacant));
+    c.stop();
+    b.stop();
+    a.stop();
+}
+
+TEST(BookRebalancerTest, ProposesTheBookThatEvensOutTheEngines) {
+    OrderPool pool(32);
+    MatchingEngine a("shard-0", {{"AAPL", {}}, {"MSFT", {}}, {"GOOG", {}}, {"IBM", {}, 1, false}}, pool);
+    MatchingEngine b("shard-1", {{"IBM", {}}, {"AAPL", {}, 1, false}, {"MSFT", {}, 1, false},
+                                 {"GOOG", {}, 1, false}}, pool);
+    BookRebalancer rebalancer({&a, &b}, {.imbalance = 1.5, .min_requests = 5});
+
+    OrderID next_id = 1;
+    auto submit = [&](MatchingEngine& engine, const char* symbol, int count) {
+        for (int i = 0; i < count; ++i) {
+            auto* order = pool.allocate();
+            new (order) Order(next_id++, "100", symbol, Side::BUY, OrderType::LIMIT, 10, 15000);
+            ASSERT_TRUE(engine.submit_order(order, engine.book_index(Symbol(symbol))));
+        }
+    };
+    submit(a, "AAPL", 6);
+    submit(a, "MSFT", 4);
+    submit(a, "GOOG", 1);
+    submit(b, "IBM", 2);
+    a.start();
+    b.start();
+    a.stop();
+    b.stop();
+
+    // 11 against 2: moving MSFT leaves 7 and 6; AAPL would leave 5 and 8
+    const auto move = rebalancer.sample();
+    ASSERT_TRUE(move.has_value());
+    EXPECT_EQ(move->symbol, Symbol("MSFT"));
+    EXPECT_EQ(move->from, &a);
+    EXPECT_EQ(move->to, &b);
+    EXPECT_EQ(move->requests, 4u);
+
+    EXPECT_FALSE(rebalancer.sample().has_value());  // Nothing since the last sample
+}
+
+TEST(ThreadPlacementTest, EngineReportsAppliedCore) {
+    cpu_set_t allowed;
+    ASSERT_EQ(sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+    int core = 0;
+    while (!CPU_ISSET(core, &allowed)) ++core;
+
+    OrderPool pool(10);
+    MatchingEngine engine("AAPL", pool);
+    EXPECT_EQ(engine.applied_placement().core, -1);
+
+    engine.set_thread_placement(ThreadPlacement{core, 0});
+    engine.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    engine.stop();
+
+    EXPECT_EQ(engine.applied_placement().core, core);
+    EXPECT_EQ(engine.applied_placement().fifo_priority, 0);
+}
+
+TEST(IdleStrategyTest, ParkedEngineWakesOnSubmit) {
+    OrderPool pool(10);
+    MarketDataLane md_queue(64);
+    MatchingEngine engine("AAPL", pool);
+    engine.set_market_data_queue(&md_queue);
+    engine.set_idle_policy(IdlePolicy::SPIN_PARK);
+    engine.start();
+
+    // Idle long enough to exhaust the spin budget and park
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_TRUE(engine.set_trading_phase(TradingPhase::AUCTION));
+
+    MarketDataEvent event;
+    bool published = false;
+    for (int i = 0; i < 1000 && !published; ++i) {
+        published = md_queue.pop(event);
+        if (!published) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    engine.stop();
+
+    ASSERT_TRUE(published);
+    EXPECT_EQ(event.type, MarketDataEvent::PHASE_CHANGE);
+
+    const IdleStats idle = engine.idle_stats();
+    EXPECT_EQ(idle.policy, IdlePolicy::SPIN_PARK);
+    EXPECT_GT(idle.parks, 0u);
+    EXPECT_GE(idle.idle_periods, 1u);
+    EXPECT_GE(idle.wakeups, 1u);
+    EXPECT_LE(idle.wake_latency_avg_ns, idle.wake_latency_max_ns);
+}
+
+TEST(EngineMaintenanceTest, IdleEnginePrunesDrainedLevelsAndFlushesStats) {
+    OrderPool pool(64);
+    MarketDataLane md_queue(4096);
+    MatchingEngine engine("AAPL", pool);
+    engine.set_market_data_queue(&md_queue);
+
+    // Twenty levels, each drained by a cancel: tombstones in the book. All
+    // queued before start(), so they land in one batch and the worker's
+    // first idle moment finds every tombstone at once.
+    for (OrderID id = 1; id <= 20; ++id) {
+        auto* order = pool.allocate();
+        new (order) Order(id, "100", "AAPL", Side::SELL, OrderType::LIMIT, 10, 15000 + 100 * id);
+        ASSERT_TRUE(engine.submit_order(order));
+    }
+    for (OrderID id = 1; id <= 20; ++id) ASSERT_TRUE(engine.cancel_order(id, ClientID("100")));
+    engine.start();
+
+    // Idle: the counters are flushed and the book pruned without waiting for stop()
+    MatchingEngine::Stats stats{};
+    for (int i = 0; i < 1000; ++i) {
+        stats = engine.get_stats();
+        if (stats.books_pruned > 0 && stats.orders_accepted == 20) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(stats.orders_accepted, 20u);
+    EXPECT_EQ(stats.books_pruned, 1u);  // One pass took all twenty tombstones
+    engine.stop();
+    EXPECT_EQ(engine.get_stats().books_pruned, 1u);
+}
+
+TEST(VolatilityPauseTest, BandBreachPausesThenResumesOnTimer) {
+    OrderPool pool(20);
+    MarketDataLane md_queue(256);
+    OrderBookOptions options;
+    options.price_band_bps = 100;  // 1%
+    MatchingEngine engine("AAPL", pool, options);
+    engine.set_market_data_queue(&md_queue);
+    engine.set_volatility_pause(std::chrono::milliseconds(20));
+    engine.start();
+
+    auto submit = [&](OrderID id, const char* client, Side side, Quantity qty, Price price) {
+        auto* order = pool.allocate();
+        new (order) Order(id, client, "AAPL", side, OrderType::LIMIT, qty, price);
+        ASSERT_TRUE(engine.submit_order(order));
+    };
+    submit(1, "100", Side::SELL, 100, 15000);  // Trade at 15000: band 14850..15150
+    submit(2, "101", Side::BUY, 100, 15000);
+    submit(3, "100", Side::SELL, 100, 15200);
+    submit(4, "101", Side::BUY, 200, 15300);   // Only the band stops it
+
+    std::vector<MarketDataEvent::PhaseData> phases;
+    for (int i = 0; i < 2000 && phases.size() < 2; ++i) {
+        MarketDataEvent event;
+        if (!md_queue.pop(event)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        if (event.type == MarketDataEvent::PHASE_CHANGE) phases.push_back(event.phase);
+    }
+    engine.stop();
+
+    ASSERT_EQ(phases.size(), 2u);
+    EXPECT_EQ(phases[0].phase, TradingPhase::AUCTION);
+    EXPECT_TRUE(phases[0].volatility_pause);
+    EXPECT_EQ(phases[1].phase, TradingPhase::CONTINUOUS);  // Timer-driven uncross
+    EXPECT_FALSE(phases[1].volatility_pause);
+    EXPECT_EQ(phases[1].price, 15200);
+    EXPECT_EQ(phases[1].volume, 100);
+}
+
+TEST(ExecutionReportTest, ReportsFillsRejectsAndDoneInOrder) {
+    OrderPool pool(10);
+    SPSCQueue<ExecutionReport> reports(64);
+    MatchingEngine engine("AAPL", pool);
+    engine.set_execution_queue(&reports);
+
+    auto* sell = pool.allocate();
+    new (sell) Order(1, "100", "AAPL", Side::SELL, OrderType::LIMIT, 100, 15000);
+    auto* buy = pool.allocate();
+    new (buy) Order(2, "101", "AAPL", Side::BUY, OrderType::LIMIT, 60, 15000);
+    auto* post = pool.allocate();
+    new (post) Order(3, "101", "AAPL", Side::BUY, OrderType::POST_ONLY, 10, 15000);
+
+    engine.start();
+    ASSERT_TRUE(engine.submit_order(sell));
+    ASSERT_TRUE(engine.submit_order(buy));
+    ASSERT_TRUE(engine.submit_order(post));
+    ASSERT_TRUE(engine.cancel_order(1, ClientID("100")));
+    engine.stop();
+
+    std::vector<ExecutionReport> seen;
+    ExecutionReport report;
+    while (reports.pop(report)) seen.push_back(report);
+    ASSERT_EQ(seen.size(), 4u);  // Resting sell reports nothing until it leaves
+
+    EXPECT_EQ(seen[0].type, ExecutionReport::FILL);
+    EXPECT_EQ(seen[0].fill.buy_order_id, 2u);
+    EXPECT_EQ(seen[0].fill.sell_order_id, 1u);
+    EXPECT_EQ(seen[0].fill.quantity, 60u);
+
+    EXPECT_EQ(seen[1].type, ExecutionReport::DONE);
+    EXPECT_EQ(seen[1].order.order_id, 2u);
+    EXPECT_EQ(seen[1].status, OrderStatus::FILLED);
+    EXPECT_EQ(seen[1].order.filled_quantity, 60u);
+
+    EXPECT_EQ(seen[2].type, ExecutionReport::REJECTED);
+    EXPECT_EQ(seen[2].order.order_id, 3u);
+    EXPECT_EQ(seen[2].reason, static_cast<uint32_t>(ErrorCode::ORDER_WOULD_CROSS));
+
+    EXPECT_EQ(seen[3].type, ExecutionReport::DONE);
+    EXPECT_EQ(seen[3].order.order_id, 1u);
+    EXPECT_EQ(seen[3].status, OrderStatus::CANCELLED);
+    EXPECT_EQ(seen[3].order.filled_quantity, 60u);
+    EXPECT_EQ(seen[3].order.leaves_quantity, 40u);
+}
+
 } // namespace rtes
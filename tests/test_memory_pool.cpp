@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include "rtes/memory_pool.hpp"
+#include "rtes/order_book.hpp"
+#include "rtes/spsc_queue.hpp"
 #include "rtes/types.hpp"
+#include <set>
 #include <thread>
 #include <vector>
 
@@ -98,4 +101,252 @@ TEST_F(MemoryPoolTest, OrderConstruction) {
     pool->deallocate(order);
 }
 
+TEST(MemoryPoolMagazineTest, BlockIsCappedToAShareOfTheCapacity) {
+    EXPECT_EQ(OrderPool(1000, 128).magazine_block(), 0u);  // 1000 / 1024 < minimum
+    EXPECT_EQ(OrderPool(65536, 128).magazine_block(), 64u);
+    EXPECT_EQ(OrderPool(1 << 20, 1024).magazine_block(), 256u);
+    EXPECT_EQ(OrderPool(1 << 20, 0).magazine_block(), 0u);
+}
+
+TEST(MemoryPoolMagazineTest, StatsStayExactWhenOneThreadAllocatesAndAnotherFrees) {
+    constexpr size_t capacity = 65536;
+    constexpr size_t orders = 5000;
+    OrderPool pool(capacity, 64);
+    ASSERT_EQ(pool.magazine_block(), 64u);
+
+    std::vector<Order*> allocated;
+    std::thread gateway([&] {
+        for (size_t i = 0; i < orders; ++i) allocated.push_back(pool.allocate());
+    });
+    gateway.join();
+    EXPECT_EQ(pool.allocated(), orders);
+    EXPECT_EQ(pool.get_stats().high_water_mark, orders);
+    EXPECT_EQ(std::set<Order*>(allocated.begin(), allocated.end()).size(), orders);
+
+    std::thread engine([&] {
+        for (Order* order : allocated) pool.deallocate(order);
+        EXPECT_LE(pool.cached(), 2 * pool.magazine_block());
+    });
+    engine.join();
+
+    // Both threads have exited: their magazines went back to the stack
+    const auto stats = pool.get_stats();
+    EXPECT_EQ(stats.allocated, 0u);
+    EXPECT_EQ(stats.available, capacity);
+    EXPECT_EQ(stats.cached, 0u);
+
+    // So one thread can still take every slot
+    std::vector<Order*> all;
+    for (size_t i = 0; i < capacity; ++i) {
+        Order* order = pool.allocate();
+        ASSERT_NE(order, nullptr);
+        all.push_back(order);
+    }
+    EXPECT_EQ(pool.allocate(), nullptr);
+    EXPECT_EQ(pool.allocated(), capacity);
+    for (Order* order : all) pool.deallocate(order);
+    EXPECT_EQ(pool.allocated(), 0u);
+}
+
+TEST(MemoryPoolMagazineTest, ConcurrentAllocateAndFreeNeverHandsOutASlotTwice) {
+    constexpr size_t capacity = 65536;
+    constexpr int threads = 4;
+    constexpr int rounds = 2000;
+    OrderPool pool(capacity, 64);
+
+    std::atomic<int> duplicates{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            std::vector<Order*> held;
+            for (int i = 0; i < rounds; ++i) {
+                for (int k = 0; k < 50; ++k) {
+                    Order* order = pool.allocate();
+                    if (!order) continue;
+                    if (order->id != 0) duplicates.fetch_add(1);
+                    order->id = static_cast<OrderID>(t + 1);
+                    held.push_back(order);
+                }
+                for (Order* order : held) {
+                    order->id = 0;
+                    pool.deallocate(order);
+                }
+                held.clear();
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+    EXPECT_EQ(duplicates.load(), 0);
+    EXPECT_EQ(pool.allocated(), 0u);
+    EXPECT_EQ(pool.cached(), 0u);
+}
+
+TEST(PageRegionTest, SmallRegionsAndTheDefaultPolicyUseTheHeap) {
+    PageRegion region(1000);
+    EXPECT_EQ(region.backing(), PageBacking::HEAP);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(region.data()) % 64, 0u);
+    EXPECT_GE(region.size(), 1000u);
+
+    const PagePolicy saved = page_policy();
+    PagePolicy thp;
+    thp.backing = PageBacking::TRANSPARENT;
+    set_page_policy(thp);
+    EXPECT_EQ(PageRegion(4096).backing(), PageBacking::HEAP);  // Below min_bytes
+    set_page_policy(saved);
+}
+
+TEST(PageRegionTest, HugePagesFallBackAndComeZeroedAndAligned) {
+    const PagePolicy saved = page_policy();
+    PagePolicy huge;
+    huge.backing = PageBacking::HUGE_2M;  // Falls back to THP without a hugetlbfs reserve
+    set_page_policy(huge);
+
+    constexpr size_t bytes = 3 * HUGE_PAGE_2M + 100;
+    PageRegion region(bytes);
+    EXPECT_NE(region.backing(), PageBacking::HEAP);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(region.data()) % HUGE_PAGE_2M, 0u);
+    const auto* data = static_cast<const uint8_t*>(region.data());
+    EXPECT_EQ(data[0], 0);
+    EXPECT_EQ(data[bytes - 1], 0);
+
+    PageRegion moved(std::move(region));
+    EXPECT_EQ(region.data(), nullptr);
+    EXPECT_EQ(moved.data(), data);
+
+    // Pools and queues report what they got
+    OrderPool pool(100000);
+    EXPECT_EQ(pool.get_stats().pages, moved.backing());
+    SPSCQueue<uint64_t> queue(1 << 20);
+    EXPECT_EQ(queue.page_backing(), moved.backing());
+    EXPECT_TRUE(queue.push(7));
+    set_page_policy(saved);
+}
+
+TEST(SegmentedPoolTest, SplitsTheCapacityAndFreesEachSlotToItsHomePool) {
+    // Two pools on the one node every machine has; this thread's node maps to the last
+    const int node = numa_online_nodes().front();
+    OrderPool pool(101, 0, {node, node});
+    ASSERT_EQ(pool.segments(), 2u);
+    EXPECT_EQ(pool.segment(0).capacity(), 51u);
+    EXPECT_EQ(pool.segment(1).capacity(), 50u);
+    EXPECT_EQ(pool.capacity(), 101u);
+    const int bound = pool.segment(0).numa_node();
+    EXPECT_TRUE(bound == node || bound == -1);  // -1 where mbind is not permitted
+
+    // The local pool first, then the other one; every slot numbered once
+    std::vector<Order*> orders;
+    std::set<uint32_t> seen;
+    while (Order* order = pool.allocate()) {
+        const uint32_t handle = pool.handle(order);
+        EXPECT_TRUE(seen.insert(handle).second);
+        EXPECT_EQ(pool.at(handle), order);
+        orders.push_back(order);
+    }
+    ASSERT_EQ(orders.size(), 101u);
+    EXPECT_TRUE(pool.segment(1).owns(orders.front()));
+    EXPECT_TRUE(pool.segment(0).owns(orders.back()));
+    EXPECT_EQ(pool.get_stats().allocated, 101u);
+
+    for (Order* order : orders) pool.deallocate(order);
+    EXPECT_EQ(pool.segment(0).allocated(), 0u);
+    EXPECT_EQ(pool.segment(1).allocated(), 0u);
+    EXPECT_EQ(pool.available(), 101u);
+}
+
+TEST(SegmentedPoolTest, GrowsBySegmentsAndParksIdleOnes) {
+    OrderPool pool(100, 0, {}, 64);
+    EXPECT_EQ(pool.segments(), 1u);
+    std::vector<Order*> orders;
+    while (Order* order = pool.allocate()) orders.push_back(order);
+    ASSERT_EQ(orders.size(), 100u);
+    const uint32_t first = pool.handle(orders.front());
+
+    // A new segment: old handles still resolve, new ones are [segment][slot]
+    ASSERT_TRUE(pool.grow());
+    EXPECT_EQ(pool.segments(), 2u);
+    EXPECT_EQ(pool.capacity(), 164u);
+    Order* grown = pool.allocate();
+    ASSERT_NE(grown, nullptr);
+    EXPECT_TRUE(pool.segment(1).owns(grown));
+    EXPECT_EQ(pool.at(pool.handle(grown)), grown);
+    EXPECT_EQ(pool.at(first), orders.front());
+
+    // In use: not idle. Once empty its pages go back and its slots are parked
+    EXPECT_EQ(pool.release_idle_segments(), 0u);
+    pool.deallocate(grown);
+    if (pool.release_idle_segments() == 1) {  // 0 where the pages are mlocked
+        EXPECT_EQ(pool.parked(), 64u);
+        EXPECT_EQ(pool.capacity(), 100u);
+        EXPECT_EQ(pool.allocated(), 100u);
+        EXPECT_EQ(pool.allocate(), nullptr);
+
+        // grow() revives the parked segment before building another
+        ASSERT_TRUE(pool.grow());
+        EXPECT_EQ(pool.segments(), 2u);
+        EXPECT_EQ(pool.parked(), 0u);
+        EXPECT_EQ(pool.capacity(), 164u);
+    }
+
+    for (int i = 0; i < 64; ++i) ASSERT_NE(pool.allocate(), nullptr);
+    EXPECT_EQ(pool.allocate(), nullptr);
+    pool.deallocate_bulk(orders.data(), orders.size());
+    EXPECT_EQ(pool.allocated(), 64u);
+
+    // Fixed-size pools do not grow
+    OrderPool fixed(16);
+    EXPECT_FALSE(fixed.grow());
+    EXPECT_EQ(fixed.segments(), 1u);
+    EXPECT_EQ(fixed.max_capacity(), 16u);
+}
+
+TEST(SegmentedPoolTest, GrowthStopsAtMaxCapacity) {
+    OrderPool pool(100, 0, {}, 64, 250);  // Room for two growth segments, not a third
+    EXPECT_EQ(pool.max_capacity(), 228u);
+    EXPECT_TRUE(pool.grow());
+    EXPECT_TRUE(pool.grow());
+    EXPECT_FALSE(pool.grow());
+    EXPECT_EQ(pool.capacity(), pool.max_capacity());
+
+    // An order book sized from it holds every order the grown pool can hand out
+    OrderBook book("AAPL", pool);
+    for (OrderID id = 1; id <= pool.max_capacity(); ++id) {
+        Order* order = pool.allocate();
+        ASSERT_NE(order, nullptr);
+        new (order) Order(id, "100", "AAPL", Side::BUY, OrderType::LIMIT, 10, 10000 + id);
+        ASSERT_TRUE(book.add_order(order).has_value());
+    }
+    EXPECT_EQ(pool.allocate(), nullptr);
+}
+
+TEST(MemoryPoolBulkTest, DeallocateBulkReturnsEverySlotOnce) {
+    for (const size_t block : {size_t{0}, size_t{64}}) {
+        OrderPool pool(65536, block);
+        std::vector<Order*> orders;
+        for (int i = 0; i < 1000; ++i) orders.push_back(pool.allocate());
+        orders.push_back(nullptr);  // Skipped
+
+        pool.deallocate_bulk(orders.data(), orders.size());
+        EXPECT_EQ(pool.allocated(), 0u);
+
+        // Every slot comes back exactly once
+        std::set<Order*> seen;
+        for (size_t i = 0; i < pool.capacity(); ++i) {
+            Order* order = pool.allocate();
+            ASSERT_NE(order, nullptr);
+            ASSERT_TRUE(seen.insert(order).second);
+        }
+        EXPECT_EQ(pool.allocate(), nullptr);
+    }
+
+    // Across node pools: each run back to its own pool
+    const int node = numa_online_nodes().front();
+    OrderPool split(64, 0, {node, node});
+    std::vector<Order*> orders;
+    while (Order* order = split.allocate()) orders.push_back(order);
+    std::swap(orders.front(), orders.back());  // Interleave the two pools' runs
+    split.deallocate_bulk(orders.data(), orders.size());
+    EXPECT_EQ(split.segment(0).allocated(), 0u);
+    EXPECT_EQ(split.segment(1).allocated(), 0u);
+}
+
 } // namespace rtes
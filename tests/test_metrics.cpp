@@ -127,4 +127,48 @@ TEST_F(MetricsTest, DefaultLatencyBuckets) {
     EXPECT_GT(stats.bucket_counts.size(), 10);  // Should have many buckets for latency
 }
 
+TEST_F(MetricsTest, ShardedUpdatesSumAcrossThreads) {
+    // More threads than shards: the overflow ones share the last shard
+    auto* counter = METRICS_COUNTER("sharded_counter");
+    auto* histogram = METRICS_HISTOGRAM("sharded_histogram", std::vector<double>({1.0, 10.0}));
+    constexpr int num_threads = static_cast<int>(METRIC_SHARDS) + 8;
+    constexpr int per_thread = 1000;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([counter, histogram]() {
+            for (int j = 0; j < per_thread; ++j) {
+                counter->increment();
+                histogram->observe(j % 2 ? 0.5 : 5.0);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    EXPECT_EQ(counter->get(), static_cast<uint64_t>(num_threads * per_thread));
+    const auto stats = histogram->get_stats();
+    EXPECT_EQ(stats.count, static_cast<uint64_t>(num_threads * per_thread));
+    EXPECT_EQ(stats.bucket_counts[0], static_cast<uint64_t>(num_threads * per_thread / 2));
+    EXPECT_DOUBLE_EQ(stats.sum, num_threads * per_thread / 2 * 5.5);
+}
+
+TEST_F(MetricsTest, LabeledSeriesResolveOnce) {
+    auto& registry = MetricsRegistry::instance();
+    auto* aapl = registry.get_counter("labeled_orders_total", {{"symbol", "AAPL"}});
+    auto* msft = registry.get_counter("labeled_orders_total", {{"symbol", "MSFT"}});
+    EXPECT_NE(aapl, msft);
+    EXPECT_EQ(aapl, registry.get_counter("labeled_orders_total", {{"symbol", "AAPL"}}));
+
+    aapl->increment(3);
+    auto* latency = registry.get_histogram("labeled_latency_seconds", {0.001}, {{"stage", "risk"}});
+    latency->observe(0.0005);
+
+    const std::string output = registry.get_prometheus_output();
+    EXPECT_NE(output.find("labeled_orders_total{symbol=\"AAPL\"} 3"), std::string::npos);
+    EXPECT_NE(output.find("labeled_orders_total{symbol=\"MSFT\"} 0"), std::string::npos);
+    EXPECT_NE(output.find("labeled_latency_seconds_bucket{stage=\"risk\",le=\"0.001\"} 1"),
+              std::string::npos);
+    EXPECT_NE(output.find("labeled_latency_seconds_count{stage=\"risk\"} 1"), std::string::npos);
+}
+
 } // namespace rtes
\ No newline at end of file
@@ -116,6 +116,29 @@ TEST_F(ObservabilityTest, AnomalyDetection) {
     EXPECT_TRUE(detector.is_anomaly("test_metric", 150.0));
 }
 
+TEST_F(ObservabilityTest, PreRegisteredHandles) {
+    auto& perf = PerformanceCounters::instance();
+    OperationCounters& op = perf.operation("handle_operation");
+    EXPECT_EQ(&op, &perf.operation("handle_operation"));
+
+    for (int i = 1; i <= 1000; ++i) {
+        PerformanceCounters::record_latency(op, std::chrono::nanoseconds(i * 1000));
+        PerformanceCounters::record_throughput(op);
+    }
+    EXPECT_NEAR(perf.get_avg_latency("handle_operation"), 500.5, 1.0);
+    EXPECT_NEAR(perf.get_latency_percentile("handle_operation", 99), 990.0, 990.0 / 32);
+    EXPECT_EQ(perf.get_throughput("handle_operation"), 1000u);
+    EXPECT_EQ(perf.get_avg_latency("never_recorded"), 0.0);
+
+    auto& detector = AnomalyDetector::instance();
+    AnomalyMetric& metric = detector.configure_metric("handle_metric", {0.0, 1.0, 3.0, 100});
+    EXPECT_TRUE(metric.is_anomaly(10.0));  // Configured baseline until MIN_SAMPLES
+    for (int i = 0; i < 200; ++i) metric.update(1000.0 + (i % 10));
+    EXPECT_EQ(&metric, &detector.metric("handle_metric"));
+    EXPECT_FALSE(detector.is_anomaly("handle_metric", 1005.0));
+    EXPECT_TRUE(detector.is_anomaly("handle_metric", 1100.0));
+}
+
 TEST_F(ObservabilityTest, AlertManager) {
     auto& alert_manager = AlertManager::instance();
     auto& metrics = MetricsCollector::instance();
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include "rtes/order_book.hpp"
 #include "rtes/memory_pool.hpp"
+#include <atomic>
+#include <map>
+#include <thread>
 
 namespace rtes {
 
@@ -35,7 +38,7 @@ TEST_F(OrderBookTest, BasicOrderPlacement) {
     auto* buy_order = create_order(1, ClientID("100"), Side::BUY, 1000, 15000);
     auto* sell_order = create_order(2, ClientID("101"), Side::SELL, 500, 15100);
     
-    // FIX: add_order returns Result<void>, not bool — use .has_value()
+    // FIX: add_order returns a Result, not bool — use .has_value()
     EXPECT_TRUE(book->add_order(buy_order).has_value());
     EXPECT_TRUE(book->add_order(sell_order).has_value());
     
@@ -149,4 +152,1259 @@ TEST_F(OrderBookTest, MarketDepth) {
     EXPECT_EQ(depth.asks[2].quantity, 350);
 }
 
+// ═══════════════════════════════════════════════════════════════
+//  Intrusive level mode (OrderBookOptions::intrusive_levels)
+// ═══════════════════════════════════════════════════════════════
+
+class IntrusiveOrderBookTest : public OrderBookTest {
+protected:
+    void SetUp() override {
+        pool = std::make_unique<OrderPool>(1000);
+        OrderBookOptions options;
+        options.intrusive_levels = true;
+        book = std::make_unique<OrderBook>("AAPL", *pool,
+            test_trade_handler, &trades, options);
+    }
+};
+
+TEST_F(IntrusiveOrderBookTest, PriceTimePriority) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("101"), Side::BUY, 200, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("102"), Side::BUY, 300, 15000)).has_value());
+    EXPECT_EQ(book->bid_quantity(), 600);
+
+    EXPECT_TRUE(book->add_order(create_order(4, ClientID("103"), Side::SELL, 150, 15000)).has_value());
+
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].buy_order_id, 1);
+    EXPECT_EQ(trades[0].quantity, 100);
+    EXPECT_EQ(trades[1].buy_order_id, 2);
+    EXPECT_EQ(trades[1].quantity, 50);
+    EXPECT_EQ(book->bid_quantity(), 450);
+}
+
+TEST_F(IntrusiveOrderBookTest, CancelFromMiddleAndBack) {
+    for (OrderID id = 1; id <= 4; ++id) {
+        EXPECT_TRUE(book->add_order(create_order(id, ClientID("100"), Side::SELL, 100, 15100)).has_value());
+    }
+
+    // Unlink middle and tail — FIFO order of the survivors is preserved
+    EXPECT_TRUE(book->cancel_order(2).has_value());
+    EXPECT_TRUE(book->cancel_order(4).has_value());
+    EXPECT_EQ(book->order_count(), 2);
+    EXPECT_EQ(book->ask_quantity(), 200);
+
+    EXPECT_TRUE(book->add_order(create_order(5, ClientID("101"), Side::BUY, 200, 15100)).has_value());
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].sell_order_id, 1);
+    EXPECT_EQ(trades[1].sell_order_id, 3);
+    EXPECT_EQ(book->best_ask(), 0);
+    EXPECT_EQ(book->order_count(), 0);
+}
+
+TEST_F(IntrusiveOrderBookTest, CancelLastOrderRemovesLevel) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 14900)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("100"), Side::BUY, 100, 15000)).has_value());
+
+    EXPECT_TRUE(book->cancel_order(2).has_value());
+    EXPECT_EQ(book->best_bid(), 14900);
+    EXPECT_EQ(book->bid_quantity(), 100);
+
+    // A new order at the removed price starts a fresh, empty level
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("100"), Side::BUY, 50, 15000)).has_value());
+    EXPECT_EQ(book->best_bid(), 15000);
+    EXPECT_EQ(book->bid_quantity(), 50);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Tick ladder backend (OrderBookOptions::tick_ladder)
+// ═══════════════════════════════════════════════════════════════
+
+class LadderOrderBookTest : public OrderBookTest {
+protected:
+    void SetUp() override {
+        pool = std::make_unique<OrderPool>(1000);
+        OrderBookOptions options;
+        options.tick_ladder  = true;
+        options.tick         = 50;    // $0.005
+        options.ladder_ticks = 64;    // Small window to exercise growth
+        book = std::make_unique<OrderBook>("AAPL", *pool,
+            test_trade_handler, &trades, options);
+    }
+};
+
+TEST_F(LadderOrderBookTest, BestPriceAndDepthOrdering) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 14900)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("100"), Side::BUY, 200, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("100"), Side::BUY, 300, 14950)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(4, ClientID("101"), Side::SELL, 150, 15200)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(5, ClientID("101"), Side::SELL, 250, 15100)).has_value());
+
+    EXPECT_EQ(book->best_bid(), 15000);
+    EXPECT_EQ(book->best_ask(), 15100);
+
+    DepthSnapshot depth;
+    book->get_depth(depth, 10);
+    ASSERT_EQ(depth.bid_levels, 3);
+    ASSERT_EQ(depth.ask_levels, 2);
+    EXPECT_EQ(depth.bids[0].price, 15000);
+    EXPECT_EQ(depth.bids[1].price, 14950);
+    EXPECT_EQ(depth.bids[2].price, 14900);
+    EXPECT_EQ(depth.asks[0].price, 15100);
+    EXPECT_EQ(depth.asks[1].price, 15200);
+}
+
+TEST_F(LadderOrderBookTest, SweepAdvancesToNextTick) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::SELL, 100, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("100"), Side::SELL, 100, 15300)).has_value());
+
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("101"), Side::BUY, 150, 15300)).has_value());
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].price, 15000);
+    EXPECT_EQ(trades[1].price, 15300);
+    EXPECT_EQ(book->best_ask(), 15300);
+    EXPECT_EQ(book->ask_quantity(), 50);
+
+    EXPECT_TRUE(book->cancel_order(2).has_value());
+    EXPECT_EQ(book->best_ask(), 0);
+}
+
+TEST_F(LadderOrderBookTest, RejectsOffTickLimitPrice) {
+    EXPECT_FALSE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 15025)).has_value());
+    EXPECT_EQ(book->order_count(), 0);
+}
+
+TEST_F(LadderOrderBookTest, GrowsWhenSpanExceedsWindow) {
+    // 64-tick window × 50 = 3200 price units; span these well past it
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 10000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("100"), Side::BUY, 100, 20000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("100"), Side::BUY, 100, 15000)).has_value());
+
+    EXPECT_EQ(book->best_bid(), 20000);
+    EXPECT_TRUE(book->cancel_order(2).has_value());
+    EXPECT_EQ(book->best_bid(), 15000);
+    EXPECT_TRUE(book->cancel_order(3).has_value());
+    EXPECT_EQ(book->best_bid(), 10000);
+}
+
+TEST_F(OrderBookTest, ReleaseBatchHoldsFilledOrdersUntilFlushed) {
+    OrderReleaseBatch batch(*pool);
+    book->set_release_batch(&batch);
+    for (OrderID id = 1; id <= 3; ++id) {
+        ASSERT_TRUE(book->add_order(create_order(id, ClientID("100"), Side::SELL, 10, 15000)).has_value());
+    }
+
+    // Sweeps all three resting orders; the aggressor is the caller's to retire
+    Order* buy = create_order(4, ClientID("101"), Side::BUY, 30, 15000);
+    ASSERT_TRUE(book->add_order(buy).has_value());
+    ASSERT_EQ(trades.size(), 3u);
+    EXPECT_EQ(batch.size(), 3u);
+    EXPECT_EQ(pool->allocated(), 4u);
+
+    batch.flush();
+    EXPECT_EQ(batch.size(), 0u);
+    EXPECT_EQ(pool->allocated(), 1u);
+    pool->deallocate(buy);
+}
+
+TEST(FlatPriceBookLadderTest, WindowFollowsDriftingMarket) {
+    OrderBookOptions options;
+    options.tick_ladder  = true;
+    options.tick         = 1;
+    options.ladder_ticks = 64;
+    OrderPool pool(16);
+    FlatPriceBook<false> asks(pool, options);
+
+    // Walk the only level far beyond the initial window — ring reuses slots
+    for (Price p = 1000; p < 1000 + 10 * 64; ++p) {
+        asks.find_or_insert(p);
+        if (p > 1000) asks.remove(p - 1);
+        ASSERT_EQ(asks.level_count(), 1);
+        ASSERT_EQ(asks.best_price(), p);
+    }
+    EXPECT_EQ(asks.find(1000), nullptr);
+}
+
+TEST(LevelSearchTest, MatchesStdLowerBoundInBothDirections) {
+    // Every size around the SIMD block and halving boundaries; keys above 2^63 check the unsigned order
+    for (size_t n = 0; n <= 3 * LEVEL_SEARCH_BLOCK + 1; ++n) {
+        std::vector<Price> asks(n), bids(n);
+        for (size_t i = 0; i < n; ++i) {
+            asks[i] = (i % 3 == 2) ? (uint64_t{1} << 63) + 20 * i : 100 + 20 * i;
+        }
+        std::sort(asks.begin(), asks.end());
+        bids.assign(asks.rbegin(), asks.rend());
+        std::vector<Price> targets = {0, 1, std::numeric_limits<Price>::max()};
+        for (Price key : asks) targets.insert(targets.end(), {key - 1, key, key + 1});
+        for (Price target : targets) {
+            EXPECT_EQ(level_lower_bound<false>(asks.data(), n, target),
+                      static_cast<size_t>(std::lower_bound(asks.begin(), asks.end(), target) - asks.begin()))
+                << "n " << n << " ask target " << target;
+            EXPECT_EQ(level_lower_bound<true>(bids.data(), n, target),
+                      static_cast<size_t>(std::lower_bound(bids.begin(), bids.end(), target, std::greater<>()) -
+                                          bids.begin()))
+                << "n " << n << " bid target " << target;
+        }
+    }
+}
+
+TEST(FlatPriceBookTest, DeepSideKeepsKeysInStepWithLevels) {
+    OrderPool pool(1000);
+    FlatPriceBook<true> bids(pool);
+    std::map<Price, Order*, std::greater<>> live;  // Reference: live levels, best first
+
+    // Hundreds of levels, inserted out of order; drained levels become
+    // tombstones, removed non-empty ones are erased, prune_empty compacts
+    uint64_t state = 7;
+    auto next = [&](uint64_t bound) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (state >> 33) % bound;
+    };
+    for (int step = 0; step < 4000; ++step) {
+        const Price p = 10000 + 10 * next(600);
+        auto it = live.find(p);
+        if (it == live.end()) {
+            if (next(4) == 0) continue;  // Bias towards a deep book
+            Order* order = pool.allocate();
+            new (order) Order(step, "100", "AAPL", Side::BUY, OrderType::LIMIT, 10, p);
+            bids.find_or_insert(p).push_back(order);
+            live[p] = order;
+        } else {
+            if (next(2)) bids.find(p)->pop_front(10);  // Drained: tombstone
+            bids.remove(p);
+            pool.deallocate(it->second);
+            live.erase(it);
+        }
+        if (step % 1000 == 999) bids.prune_empty();
+
+        if (step % 250 == 0) {
+            for (Price q = 9995; q <= 16005; q += 5) {
+                ASSERT_EQ(bids.find(q) != nullptr, live.count(q) == 1) << "step " << step << " price " << q;
+            }
+            ASSERT_EQ(bids.best_price(), live.empty() ? 0 : live.begin()->first);
+            auto expected = live.begin();
+            bids.for_each_level([&](const FlatLevel& level) {
+                EXPECT_EQ(level.price, expected->first);
+                ++expected;
+                return true;
+            });
+            EXPECT_EQ(expected, live.end());
+        }
+    }
+    EXPECT_GT(live.size(), 200u);
+    for (auto& [price, order] : live) pool.deallocate(order);
+}
+
+TEST(FlatPriceBookTest, CountsTombstonesUntilPruned) {
+    OrderPool pool(16);
+    FlatPriceBook<true> bids(pool);
+    Order* orders[3];
+    for (int i = 0; i < 3; ++i) {
+        orders[i] = pool.allocate();
+        new (orders[i]) Order(i + 1, "100", "AAPL", Side::BUY, OrderType::LIMIT, 10, 15000 - 100 * i);
+        bids.find_or_insert(orders[i]->price).push_back(orders[i]);
+    }
+
+    bids.best_level().pop_front(10);
+    bids.remove_best();                       // Drained best: tombstone
+    ASSERT_TRUE(bids.find(14800)->remove(orders[2]));
+    bids.remove(14800);                       // Drained by cancel: tombstone
+    bids.remove(14900);                       // Still has an order: erased, not a tombstone
+    EXPECT_EQ(bids.tombstones(), 2u);
+
+    bids.find_or_insert(15000).push_back(orders[0]);  // Re-armed in place
+    EXPECT_EQ(bids.tombstones(), 1u);
+    bids.prune_empty();
+    EXPECT_EQ(bids.tombstones(), 0u);
+    EXPECT_EQ(bids.level_count(), 1u);
+    for (Order* order : orders) pool.deallocate(order);
+}
+
+TEST(LevelChunkTest, QueueSpansChunksAndRecyclesThemAsTheyDrain) {
+    LevelChunkPool chunks(2);
+    LevelChunkQueue queue(&chunks);
+    std::vector<OrderHandle> expected;
+    for (OrderHandle h = 0; h < 3 * LEVEL_CHUNK_ORDERS + 5; ++h) {
+        queue.push_back(h);
+        expected.push_back(h);
+    }
+    EXPECT_GE(chunks.capacity(), 4u);  // Grew past its first slab
+    EXPECT_EQ(chunks.capacity() - chunks.available(), 4u);
+
+    // Empty the second chunk through cancels: it leaves the chain at once
+    for (OrderHandle h = LEVEL_CHUNK_ORDERS; h < 2 * LEVEL_CHUNK_ORDERS; ++h) {
+        ASSERT_TRUE(queue.remove(h));
+        expected.erase(std::find(expected.begin(), expected.end(), h));
+    }
+    EXPECT_FALSE(queue.remove(LEVEL_CHUNK_ORDERS));
+    EXPECT_EQ(chunks.capacity() - chunks.available(), 3u);
+    ASSERT_TRUE(queue.remove(5));  // Middle of the head chunk
+    expected.erase(expected.begin() + 5);
+
+    std::vector<OrderHandle> seen;
+    queue.for_each([&](OrderHandle h) { seen.push_back(h); });
+    EXPECT_EQ(seen, expected);
+
+    // Pops cross the chunk boundaries in FIFO order
+    EXPECT_EQ(queue.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(queue.front(), expected[i]);
+        if (i + 1 < expected.size()) {
+            ASSERT_EQ(queue.second(), expected[i + 1]);
+        }
+        queue.pop_front();
+    }
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(chunks.available(), chunks.capacity());
+}
+
+TEST(FlatPriceBookTest, LevelsGiveTheirChunksBackWhenTheyDrain) {
+    OrderPool pool(200);
+    FlatPriceBook<false> asks(pool);
+    const LevelChunkPool& chunks = *asks.level_chunks();
+    const size_t capacity = chunks.capacity();
+
+    std::vector<Order*> orders;
+    for (OrderID id = 1; id <= 150; ++id) {
+        Order* order = pool.allocate();
+        new (order) Order(id, "100", "AAPL", Side::SELL, OrderType::LIMIT, 10, 15000 + 10 * (id % 3));
+        asks.find_or_insert(order->price).push_back(order);
+        orders.push_back(order);
+    }
+    EXPECT_LT(chunks.available(), capacity);
+
+    // Drain every level from the front, with a cancel mid-queue; levels become tombstones holding nothing
+    ASSERT_TRUE(asks.find(15010)->remove(orders[30]));
+    while (!asks.empty()) {
+        FlatLevel& level = asks.best_level();
+        Order* second = level.second();
+        level.pop_front(level.front()->remaining_quantity);
+        if (level.empty()) asks.remove_best();
+        else               ASSERT_EQ(level.front(), second);
+    }
+    EXPECT_EQ(chunks.available(), chunks.capacity());
+    EXPECT_EQ(chunks.capacity(), capacity);  // No growth: 150 orders fit the first slab
+    for (Order* order : orders) pool.deallocate(order);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  IOC / FOK / post-only
+// ═══════════════════════════════════════════════════════════════
+
+TEST_F(OrderBookTest, IocRemainderDoesNotRest) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::SELL, 100, 15000)).has_value());
+
+    Order* ioc = create_order(2, ClientID("101"), Side::BUY, 150, 15000);
+    ioc->type = OrderType::IOC;
+    EXPECT_TRUE(book->add_order(ioc).has_value());
+
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].quantity, 100);
+    EXPECT_EQ(ioc->remaining_quantity, 50);
+    EXPECT_EQ(ioc->status, OrderStatus::CANCELLED);
+    EXPECT_EQ(book->best_bid(), 0);
+    EXPECT_EQ(book->cancel_order(2).error(), make_error_code(ErrorCode::ORDER_NOT_FOUND));
+}
+
+TEST_F(OrderBookTest, FokFillsInFullOrNotAtAll) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::SELL, 100, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("100"), Side::SELL, 100, 15100)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("100"), Side::SELL, 100, 15200)).has_value());
+
+    // 250 available at ≤ 15200, but only 200 at ≤ 15100
+    Order* short_fok = create_order(4, ClientID("101"), Side::BUY, 250, 15100);
+    short_fok->type = OrderType::FOK;
+    auto result = book->add_order(short_fok);
+    ASSERT_TRUE(result.has_error());
+    EXPECT_EQ(result.error(), make_error_code(ErrorCode::ORDER_UNFILLABLE));
+    EXPECT_TRUE(trades.empty());
+    EXPECT_EQ(book->best_ask(), 15000);
+
+    Order* fok = create_order(5, ClientID("101"), Side::BUY, 250, 15200);
+    fok->type = OrderType::FOK;
+    EXPECT_TRUE(book->add_order(fok).has_value());
+    EXPECT_EQ(trades.size(), 3);
+    EXPECT_EQ(fok->status, OrderStatus::FILLED);
+    EXPECT_EQ(book->best_ask(), 15200);
+    EXPECT_EQ(book->ask_quantity(), 50);
+}
+
+TEST_F(OrderBookTest, PostOnlyRejectedWhenCrossing) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::SELL, 100, 15000)).has_value());
+
+    Order* crossing = create_order(2, ClientID("101"), Side::BUY, 100, 15000);
+    crossing->type = OrderType::POST_ONLY;
+    auto result = book->add_order(crossing);
+    ASSERT_TRUE(result.has_error());
+    EXPECT_EQ(result.error(), make_error_code(ErrorCode::ORDER_WOULD_CROSS));
+    EXPECT_TRUE(trades.empty());
+
+    Order* passive = create_order(3, ClientID("101"), Side::BUY, 100, 14900);
+    passive->type = OrderType::POST_ONLY;
+    EXPECT_TRUE(book->add_order(passive).has_value());
+    EXPECT_EQ(book->best_bid(), 14900);
+    EXPECT_EQ(passive->status, OrderStatus::ACCEPTED);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Cancel/replace
+// ═══════════════════════════════════════════════════════════════
+
+TEST_F(OrderBookTest, ModifySizeDownKeepsPriority) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::SELL, 100, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("101"), Side::SELL, 100, 15000)).has_value());
+
+    EXPECT_TRUE(book->modify_order(1, 40).has_value());
+    EXPECT_EQ(book->ask_quantity(), 140);
+
+    // Order 1 is still first in the queue
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("102"), Side::BUY, 40, 15000)).has_value());
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].sell_order_id, 1);
+    EXPECT_EQ(book->ask_quantity(), 100);
+}
+
+TEST_F(OrderBookTest, ModifySizeUpLosesPriority) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::SELL, 100, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("101"), Side::SELL, 100, 15000)).has_value());
+
+    EXPECT_TRUE(book->modify_order(1, 150).has_value());
+    EXPECT_EQ(book->ask_quantity(), 250);
+
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("102"), Side::BUY, 50, 15000)).has_value());
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].sell_order_id, 2);
+}
+
+TEST_F(OrderBookTest, ModifyPriceMovesAndMayMatch) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 14900)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("101"), Side::SELL, 60, 15000)).has_value());
+
+    // Reprice the bid through the ask: 60 trades, 40 rests at 15000
+    EXPECT_TRUE(book->modify_order(1, 100, 15000).has_value());
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].quantity, 60);
+    EXPECT_EQ(book->best_bid(), 15000);
+    EXPECT_EQ(book->bid_quantity(), 40);
+    EXPECT_EQ(book->best_ask(), 0);
+
+    EXPECT_EQ(book->modify_order(99, 10).error(), make_error_code(ErrorCode::ORDER_NOT_FOUND));
+    EXPECT_EQ(book->modify_order(1, 0).error(), make_error_code(ErrorCode::ORDER_INVALID));
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Iceberg / reserve orders
+// ═══════════════════════════════════════════════════════════════
+
+TEST_F(OrderBookTest, IcebergShowsOnlyDisplaySlice) {
+    Order* iceberg = create_order(1, ClientID("100"), Side::SELL, 500, 15000);
+    iceberg->display_quantity = 100;
+    EXPECT_TRUE(book->add_order(iceberg).has_value());
+
+    EXPECT_EQ(book->ask_quantity(), 100);
+    DepthSnapshot depth;
+    book->get_depth(depth);
+    ASSERT_EQ(depth.ask_levels, 1);
+    EXPECT_EQ(depth.asks[0].quantity, 100);
+    EXPECT_EQ(iceberg->hidden_quantity, 400);
+}
+
+TEST_F(OrderBookTest, IcebergRefreshJoinsBackOfQueue) {
+    Order* iceberg = create_order(1, ClientID("100"), Side::SELL, 250, 15000);
+    iceberg->display_quantity = 100;
+    EXPECT_TRUE(book->add_order(iceberg).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("101"), Side::SELL, 50, 15000)).has_value());
+
+    // Fill the first slice — refreshed slice queues behind order 2
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("102"), Side::BUY, 120, 15000)).has_value());
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].sell_order_id, 1);
+    EXPECT_EQ(trades[0].quantity, 100);
+    EXPECT_EQ(trades[1].sell_order_id, 2);
+    EXPECT_EQ(trades[1].quantity, 20);
+    EXPECT_EQ(book->ask_quantity(), 130);  // 30 of order 2 + 100 slice
+
+    // Drain the rest: last slice is the 50 left in reserve
+    EXPECT_TRUE(book->add_order(create_order(4, ClientID("102"), Side::BUY, 180, 15000)).has_value());
+    EXPECT_EQ(book->best_ask(), 0);
+    EXPECT_EQ(book->cancel_order(1).error(), make_error_code(ErrorCode::ORDER_NOT_FOUND));
+}
+
+TEST_F(OrderBookTest, IcebergAggressorTradesFullSize) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::SELL, 300, 15000)).has_value());
+
+    Order* iceberg = create_order(2, ClientID("101"), Side::BUY, 500, 15000);
+    iceberg->display_quantity = 50;
+    EXPECT_TRUE(book->add_order(iceberg).has_value());
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].quantity, 300);
+
+    // Remaining 200 rests as a 50 slice + 150 reserve
+    EXPECT_EQ(book->bid_quantity(), 50);
+    EXPECT_EQ(iceberg->hidden_quantity, 150);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Stop / stop-limit triggers
+// ═══════════════════════════════════════════════════════════════
+
+TEST_F(OrderBookTest, StopParkedOutsideVisibleBook) {
+    Order* stop = create_order(1, ClientID("100"), Side::BUY, 100, 0);
+    stop->type = OrderType::STOP;
+    stop->stop_price = 15100;
+    EXPECT_TRUE(book->add_order(stop).has_value());
+
+    EXPECT_EQ(book->best_bid(), 0);
+    EXPECT_TRUE(trades.empty());
+    EXPECT_TRUE(book->cancel_order(1).has_value());
+}
+
+TEST_F(OrderBookTest, StopFiresWhenTradeReachesStopPrice) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::SELL, 100, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("100"), Side::SELL, 100, 15100)).has_value());
+
+    Order* stop = create_order(3, ClientID("101"), Side::BUY, 100, 0);
+    stop->type = OrderType::STOP;
+    stop->stop_price = 15000;
+    EXPECT_TRUE(book->add_order(stop).has_value());
+    EXPECT_TRUE(trades.empty());
+
+    // Trade at 15000 fires the stop within the same call; it lifts 15100
+    EXPECT_TRUE(book->add_order(create_order(4, ClientID("102"), Side::BUY, 100, 15000)).has_value());
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[1].buy_order_id, 3);
+    EXPECT_EQ(trades[1].price, 15100);
+    EXPECT_EQ(book->best_ask(), 0);
+}
+
+TEST_F(OrderBookTest, StopLimitRestsAtLimitAfterTrigger) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 15000)).has_value());
+
+    Order* stop = create_order(2, ClientID("101"), Side::SELL, 50, 14900);
+    stop->type = OrderType::STOP_LIMIT;
+    stop->stop_price = 15000;
+    EXPECT_TRUE(book->add_order(stop).has_value());
+
+    // Sell 100 @ 15000 trades; sell stop (last ≤ 15000) becomes a limit at 14900
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("102"), Side::SELL, 100, 15000)).has_value());
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(book->best_ask(), 14900);
+    EXPECT_EQ(book->ask_quantity(), 50);
+    EXPECT_TRUE(book->cancel_order(2).has_value());
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Self-trade prevention
+// ═══════════════════════════════════════════════════════════════
+
+class SelfTradeOrderBookTest : public OrderBookTest {
+protected:
+    void use_mode(SelfTradePrevention mode) {
+        OrderBookOptions options;
+        options.self_trade = mode;
+        book.reset();
+        book = std::make_unique<OrderBook>("AAPL", *pool, test_trade_handler, &trades, options);
+    }
+
+    Order* owned(OrderID id, ClientIDRaw owner, Side side, Quantity qty, Price price) {
+        Order* o = create_order(id, ClientID("100"), side, qty, price);
+        o->owner = owner;
+        return o;
+    }
+};
+
+TEST_F(SelfTradeOrderBookTest, CancelNewestKeepsResting) {
+    use_mode(SelfTradePrevention::CANCEL_NEWEST);
+    EXPECT_TRUE(book->add_order(owned(1, 7, Side::SELL, 100, 15000)).has_value());
+
+    Order* aggressor = owned(2, 7, Side::BUY, 100, 15000);
+    EXPECT_TRUE(book->add_order(aggressor).has_value());
+    EXPECT_TRUE(trades.empty());
+    EXPECT_EQ(aggressor->status, OrderStatus::CANCELLED);
+    EXPECT_EQ(book->best_bid(), 0);
+    EXPECT_EQ(book->ask_quantity(), 100);
+}
+
+TEST_F(SelfTradeOrderBookTest, CancelOldestSweepsPastOwnOrder) {
+    use_mode(SelfTradePrevention::CANCEL_OLDEST);
+    EXPECT_TRUE(book->add_order(owned(1, 7, Side::SELL, 100, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(owned(2, 8, Side::SELL, 100, 15000)).has_value());
+
+    EXPECT_TRUE(book->add_order(owned(3, 7, Side::BUY, 100, 15000)).has_value());
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].sell_order_id, 2);
+    EXPECT_EQ(book->best_ask(), 0);
+    EXPECT_EQ(book->cancel_order(1).error(), make_error_code(ErrorCode::ORDER_NOT_FOUND));
+}
+
+TEST_F(SelfTradeOrderBookTest, CancelBothRemovesPair) {
+    use_mode(SelfTradePrevention::CANCEL_BOTH);
+    EXPECT_TRUE(book->add_order(owned(1, 7, Side::SELL, 100, 15000)).has_value());
+
+    EXPECT_TRUE(book->add_order(owned(2, 7, Side::BUY, 50, 15000)).has_value());
+    EXPECT_TRUE(trades.empty());
+    EXPECT_EQ(book->best_ask(), 0);
+    EXPECT_EQ(book->best_bid(), 0);
+}
+
+TEST_F(SelfTradeOrderBookTest, DecrementReducesBothWithoutTrade) {
+    use_mode(SelfTradePrevention::DECREMENT);
+    EXPECT_TRUE(book->add_order(owned(1, 7, Side::SELL, 100, 15000)).has_value());
+
+    EXPECT_TRUE(book->add_order(owned(2, 7, Side::BUY, 30, 15000)).has_value());
+    EXPECT_TRUE(trades.empty());
+    EXPECT_EQ(book->ask_quantity(), 70);
+    EXPECT_EQ(book->best_bid(), 0);
+
+    // Different owner still trades
+    EXPECT_TRUE(book->add_order(owned(3, 8, Side::BUY, 70, 15000)).has_value());
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].quantity, 70);
+}
+
+TEST_F(SelfTradeOrderBookTest, MassCancelSweepsOneOwner) {
+    EXPECT_TRUE(book->add_order(owned(1, 7, Side::SELL, 100, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(owned(2, 7, Side::SELL, 100, 15100)).has_value());
+    EXPECT_TRUE(book->add_order(owned(3, 8, Side::SELL, 100, 15200)).has_value());
+    EXPECT_TRUE(book->add_order(owned(4, 7, Side::BUY, 100, 14900)).has_value());
+    Order* stop = owned(5, 7, Side::BUY, 100, 0);
+    stop->type = OrderType::STOP;
+    stop->stop_price = 15500;
+    EXPECT_TRUE(book->add_order(stop).has_value());
+
+    EXPECT_EQ(book->mass_cancel(7), 4u);
+    EXPECT_EQ(book->order_count(), 1u);
+    EXPECT_EQ(book->best_ask(), 15200);
+    EXPECT_EQ(book->best_bid(), 0);
+    EXPECT_EQ(book->mass_cancel(7), 0u);
+    EXPECT_EQ(book->mass_cancel(0), 0u);  // Unknown owner never matches
+    EXPECT_TRUE(book->cancel_order(3).has_value());
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Call auction
+// ═══════════════════════════════════════════════════════════════
+
+TEST_F(OrderBookTest, AuctionAccumulatesCrossedBook) {
+    book->begin_auction();
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 15100)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("101"), Side::SELL, 100, 15000)).has_value());
+
+    EXPECT_TRUE(trades.empty());
+    EXPECT_EQ(book->best_bid(), 15100);
+    EXPECT_EQ(book->best_ask(), 15000);
+
+    Order* market = create_order(3, ClientID("102"), Side::BUY, 100, 0);
+    market->type = OrderType::MARKET;
+    EXPECT_EQ(book->add_order(market).error(), ErrorCode::ORDER_INVALID);
+    pool->deallocate(market);
+}
+
+TEST_F(OrderBookTest, UncrossAtVolumeMaximizingPrice) {
+    book->begin_auction();
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 15200)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("100"), Side::BUY, 200, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("101"), Side::SELL, 150, 14900)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(4, ClientID("101"), Side::SELL, 100, 15000)).has_value());
+
+    // 14900 → 150, 15000 → 250, 15200 → 100
+    const AuctionResult indicative = book->indicative_uncross();
+    EXPECT_EQ(indicative.price, 15000);
+    EXPECT_EQ(indicative.volume, 250);
+
+    const AuctionResult result = book->uncross();
+    EXPECT_EQ(result.volume, 250);
+    EXPECT_EQ(book->phase(), TradingPhase::CONTINUOUS);
+    ASSERT_EQ(trades.size(), 3);
+    for (const Trade& t : trades) EXPECT_EQ(t.price, 15000);
+
+    EXPECT_EQ(book->best_bid(), 15000);
+    EXPECT_EQ(book->bid_quantity(), 50);
+    EXPECT_EQ(book->best_ask(), 0);
+}
+
+TEST_F(OrderBookTest, SweepFillsShareOneMatchTime) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::SELL, 100, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("100"), Side::SELL, 100, 15100)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("101"), Side::BUY, 200, 15100)).has_value());
+
+    ASSERT_EQ(trades.size(), 2u);
+    EXPECT_EQ(book->sweep_aggressor(), static_cast<uint8_t>(Side::BUY));
+    EXPECT_NE(trades[0].timestamp, 0u);
+    EXPECT_EQ(trades[0].timestamp, trades[1].timestamp);
+
+    EXPECT_TRUE(book->add_order(create_order(4, ClientID("100"), Side::BUY, 50, 14900)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(5, ClientID("101"), Side::SELL, 50, 14900)).has_value());
+    ASSERT_EQ(trades.size(), 3u);
+    EXPECT_EQ(book->sweep_aggressor(), static_cast<uint8_t>(Side::SELL));
+    EXPECT_GE(trades[2].timestamp, trades[1].timestamp);
+}
+
+TEST_F(OrderBookTest, UncrossHasNoAggressor) {
+    book->begin_auction();
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("101"), Side::SELL, 100, 15000)).has_value());
+
+    EXPECT_EQ(book->uncross().volume, 100);
+    ASSERT_EQ(trades.size(), 1u);
+    EXPECT_EQ(book->sweep_aggressor(), 0);
+}
+
+TEST_F(OrderBookTest, UncrossWithoutCrossOnlyReopens) {
+    book->begin_auction();
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 14900)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("101"), Side::SELL, 100, 15000)).has_value());
+
+    EXPECT_EQ(book->uncross().volume, 0);
+    EXPECT_TRUE(trades.empty());
+    EXPECT_EQ(book->phase(), TradingPhase::CONTINUOUS);
+
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("102"), Side::BUY, 100, 15000)).has_value());
+    EXPECT_EQ(trades.size(), 1);
+}
+
+TEST_F(OrderBookTest, HaltedBookIsCancelOnly) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("100"), Side::BUY, 100, 14900)).has_value());
+    book->halt();
+    EXPECT_EQ(book->phase(), TradingPhase::HALTED);
+
+    Order* sell = create_order(3, ClientID("101"), Side::SELL, 100, 15000);
+    EXPECT_EQ(book->add_order(sell).error(), ErrorCode::ORDER_HALTED);
+    pool->deallocate(sell);
+    EXPECT_EQ(book->modify_order(1, 200, 0).error(), ErrorCode::ORDER_HALTED);
+    EXPECT_EQ(book->modify_order(1, 100, 15100).error(), ErrorCode::ORDER_HALTED);
+    EXPECT_TRUE(book->modify_order(1, 60, 0).has_value());  // Size-down keeps its place
+    EXPECT_TRUE(book->cancel_order(2).has_value());
+    EXPECT_EQ(book->bid_quantity(), 60);
+    EXPECT_TRUE(trades.empty());
+
+    // Resume: nothing crossed, so the uncross only reopens
+    EXPECT_EQ(book->uncross().volume, 0);
+    EXPECT_EQ(book->phase(), TradingPhase::CONTINUOUS);
+    EXPECT_TRUE(book->add_order(create_order(4, ClientID("101"), Side::SELL, 60, 15000)).has_value());
+    EXPECT_EQ(trades.size(), 1);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Price band (OrderBookOptions::price_band_bps)
+// ═══════════════════════════════════════════════════════════════
+
+class PriceBandOrderBookTest : public OrderBookTest {
+protected:
+    void SetUp() override {
+        OrderBookTest::SetUp();
+        OrderBookOptions options;
+        options.price_band_bps = 100;  // 1% either side of the last trade
+        book.reset();
+        book = std::make_unique<OrderBook>("AAPL", *pool, test_trade_handler, &trades, options);
+    }
+
+    /** Trade once at `price` to anchor the band, then rest two asks */
+    void anchor_and_offer(Price price) {
+        EXPECT_EQ(book->band_high(), std::numeric_limits<Price>::max());  // No trade, no band
+        EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::SELL, 100, price)).has_value());
+        EXPECT_TRUE(book->add_order(create_order(2, ClientID("101"), Side::BUY, 100, price)).has_value());
+        EXPECT_EQ(book->band_low(), price - price / 100);
+        EXPECT_EQ(book->band_high(), price + price / 100);
+        EXPECT_TRUE(book->add_order(create_order(3, ClientID("100"), Side::SELL, 100, 15100)).has_value());
+        EXPECT_TRUE(book->add_order(create_order(4, ClientID("100"), Side::SELL, 100, 15200)).has_value());
+        trades.clear();
+    }
+};
+
+TEST_F(PriceBandOrderBookTest, LimitSweepStopsAtTheBandAndPauses) {
+    anchor_and_offer(15000);  // Band 14850..15150
+
+    // 15100 is inside, 15200 is not: the remainder rests in a volatility auction
+    EXPECT_TRUE(book->add_order(create_order(5, ClientID("101"), Side::BUY, 200, 15300)).has_value());
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].price, 15100);
+    EXPECT_EQ(book->phase(), TradingPhase::AUCTION);
+    EXPECT_EQ(book->volatility_pauses(), 1u);
+    EXPECT_EQ(book->best_bid(), 15300);
+    EXPECT_EQ(book->bid_quantity(), 100);
+
+    // The uncross prints through the band and re-anchors it
+    const AuctionResult result = book->uncross();
+    EXPECT_EQ(result.volume, 100);
+    EXPECT_EQ(book->phase(), TradingPhase::CONTINUOUS);
+    EXPECT_EQ(book->band_low(), result.price - result.price / 100);
+    EXPECT_EQ(book->band_high(), result.price + result.price / 100);
+}
+
+TEST_F(PriceBandOrderBookTest, LimitBelowTheBandDoesNotPause) {
+    anchor_and_offer(15000);
+
+    // Stopped by its own price, not the band
+    EXPECT_TRUE(book->add_order(create_order(5, ClientID("101"), Side::BUY, 200, 15100)).has_value());
+    EXPECT_EQ(trades.size(), 1);
+    EXPECT_EQ(book->phase(), TradingPhase::CONTINUOUS);
+    EXPECT_EQ(book->volatility_pauses(), 0u);
+}
+
+TEST_F(PriceBandOrderBookTest, MarketRemainderIsCancelledAndFokStaysInside) {
+    anchor_and_offer(15000);
+
+    // FOK fillable only through the band: rejected, no pause
+    Order* fok = create_order(5, ClientID("101"), Side::BUY, 200, 15200);
+    fok->type = OrderType::FOK;
+    EXPECT_EQ(book->add_order(fok).error(), ErrorCode::ORDER_UNFILLABLE);
+    pool->deallocate(fok);
+    EXPECT_EQ(book->phase(), TradingPhase::CONTINUOUS);
+
+    Order* market = create_order(6, ClientID("101"), Side::BUY, 200, 0);
+    market->type = OrderType::MARKET;
+    EXPECT_TRUE(book->add_order(market).has_value());
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].price, 15100);
+    EXPECT_EQ(market->status, OrderStatus::CANCELLED);
+    EXPECT_EQ(book->phase(), TradingPhase::AUCTION);
+    EXPECT_EQ(book->best_ask(), 15200);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Queue positions (OrderBookOptions::queue_positions)
+// ═══════════════════════════════════════════════════════════════
+
+class QueuePositionOrderBookTest : public OrderBookTest {
+protected:
+    /** 0: vector levels, 1: intrusive levels, 2: tick ladder */
+    void use_layout(int layout) {
+        OrderBookOptions options;
+        options.queue_positions  = true;
+        options.intrusive_levels = (layout == 1);
+        options.tick_ladder      = (layout == 2);
+        options.tick             = 100;
+        book.reset();
+        book = std::make_unique<OrderBook>("AAPL", *pool, test_trade_handler, &trades, options);
+    }
+
+    void expect_ahead(OrderID id, uint32_t orders, Quantity quantity) {
+        auto position = book->queue_position(id);
+        ASSERT_TRUE(position.has_value()) << "order " << id;
+        EXPECT_EQ(position.value().orders_ahead, orders) << "order " << id;
+        EXPECT_EQ(position.value().quantity_ahead, quantity) << "order " << id;
+    }
+};
+
+TEST_F(QueuePositionOrderBookTest, AheadFollowsFillsCancelsAndModifies) {
+    for (int layout = 0; layout < 3; ++layout) {
+        SCOPED_TRACE(layout);
+        use_layout(layout);
+        EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 15000)).has_value());
+        EXPECT_TRUE(book->add_order(create_order(2, ClientID("100"), Side::BUY, 200, 15000)).has_value());
+        EXPECT_TRUE(book->add_order(create_order(3, ClientID("100"), Side::BUY, 300, 15000)).has_value());
+        EXPECT_TRUE(book->add_order(create_order(4, ClientID("100"), Side::BUY, 50, 14900)).has_value());
+        expect_ahead(1, 0, 0);
+        expect_ahead(2, 1, 100);
+        expect_ahead(3, 2, 300);
+        expect_ahead(4, 0, 0);  // Its own level
+
+        EXPECT_TRUE(book->add_order(create_order(5, ClientID("101"), Side::SELL, 40, 15000)).has_value());
+        expect_ahead(3, 2, 260);                      // Partial fill of the front
+        EXPECT_TRUE(book->cancel_order(2).has_value());
+        expect_ahead(3, 1, 60);                       // Cancel from the middle
+        EXPECT_TRUE(book->modify_order(1, 20, 0).has_value());
+        expect_ahead(3, 1, 20);                       // Size-down keeps its place
+        EXPECT_TRUE(book->modify_order(1, 80, 0).has_value());
+        expect_ahead(3, 0, 0);                        // Size-up requeues behind
+        expect_ahead(1, 1, 300);
+
+        EXPECT_TRUE(book->add_order(create_order(6, ClientID("101"), Side::SELL, 300, 15000)).has_value());
+        expect_ahead(1, 0, 0);
+        EXPECT_EQ(book->queue_position(3).error(), ErrorCode::ORDER_NOT_FOUND);
+    }
+}
+
+TEST_F(QueuePositionOrderBookTest, LevelRenumbersWhenItRunsOutOfPositions) {
+    use_layout(0);
+    // Far more arrivals than the first tree's 64 positions, with churn at the front
+    for (OrderID id = 1; id <= 200; ++id) {
+        EXPECT_TRUE(book->add_order(create_order(id, ClientID("100"), Side::SELL, 10, 15000)).has_value());
+    }
+    for (OrderID id = 1; id <= 150; ++id) EXPECT_TRUE(book->cancel_order(id).has_value());
+    for (OrderID id = 201; id <= 300; ++id) {
+        EXPECT_TRUE(book->add_order(create_order(id, ClientID("100"), Side::SELL, 10, 15000)).has_value());
+    }
+    expect_ahead(151, 0, 0);
+    expect_ahead(300, 149, 1490);
+
+    // Iceberg: the next slice queues at the back
+    Order* iceberg = create_order(301, ClientID("100"), Side::SELL, 30, 15000);
+    iceberg->display_quantity = 10;
+    EXPECT_TRUE(book->add_order(iceberg).has_value());
+    expect_ahead(301, 150, 1500);
+    EXPECT_TRUE(book->add_order(create_order(302, ClientID("101"), Side::BUY, 1500, 15000)).has_value());
+    expect_ahead(301, 0, 0);
+    EXPECT_TRUE(book->add_order(create_order(303, ClientID("101"), Side::BUY, 10, 15000)).has_value());
+    expect_ahead(301, 0, 0);  // Second slice, alone at the level
+}
+
+TEST_F(OrderBookTest, QueuePositionNeedsTheOption) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 15000)).has_value());
+    EXPECT_EQ(book->queue_position(1).error(), ErrorCode::ORDER_INVALID);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Market by order (OrderEvent callback)
+// ═══════════════════════════════════════════════════════════════
+
+static void test_order_event_handler(const OrderEvent& event, void* ctx) {
+    static_cast<std::vector<OrderEvent>*>(ctx)->push_back(event);
+}
+
+class OrderEventOrderBookTest : public OrderBookTest {
+protected:
+    void SetUp() override {
+        pool = std::make_unique<OrderPool>(1000);
+        book = std::make_unique<OrderBook>("AAPL", *pool, nullptr, &events);
+        book->set_order_event_callback(test_order_event_handler);
+    }
+
+    void expect_event(size_t i, OrderEvent::Kind kind, OrderID id, Price price,
+                      Quantity remaining, Quantity quantity = 0) {
+        ASSERT_LT(i, events.size());
+        SCOPED_TRACE(i);
+        EXPECT_EQ(events[i].kind, kind);
+        EXPECT_EQ(events[i].order_id, id);
+        EXPECT_EQ(events[i].price, price);
+        EXPECT_EQ(events[i].remaining, remaining);
+        EXPECT_EQ(events[i].quantity, quantity);
+    }
+
+    std::vector<OrderEvent> events;
+};
+
+TEST_F(OrderEventOrderBookTest, ReportsEveryChangeToRestingOrders) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("100"), Side::BUY, 200, 15000)).has_value());
+    EXPECT_TRUE(book->modify_order(1, 60, 0).has_value());
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("101"), Side::SELL, 100, 15000)).has_value());
+    EXPECT_TRUE(book->cancel_order(2).has_value());
+
+    ASSERT_EQ(events.size(), 6u);
+    expect_event(0, OrderEvent::ADD, 1, 15000, 100);
+    EXPECT_EQ(events[0].side, Side::BUY);
+    expect_event(1, OrderEvent::ADD, 2, 15000, 200);
+    expect_event(2, OrderEvent::MODIFY, 1, 15000, 60);
+    expect_event(3, OrderEvent::EXECUTE, 1, 15000, 0, 60);   // Passive side only: 3 never rests
+    expect_event(4, OrderEvent::EXECUTE, 2, 15000, 160, 40);
+    expect_event(5, OrderEvent::CANCEL, 2, 15000, 160);
+
+    // Iceberg: each slice is an ADD at the back; the reserve is never shown
+    events.clear();
+    Order* iceberg = create_order(4, ClientID("100"), Side::SELL, 30, 15100);
+    iceberg->display_quantity = 10;
+    EXPECT_TRUE(book->add_order(iceberg).has_value());
+    EXPECT_TRUE(book->add_order(create_order(5, ClientID("101"), Side::BUY, 15, 15100)).has_value());
+    EXPECT_TRUE(book->modify_order(4, 20, 15200).has_value());
+    EXPECT_TRUE(book->add_order(create_order(6, ClientID("101"), Side::BUY, 50, 15300)).has_value());
+
+    ASSERT_EQ(events.size(), 10u);
+    expect_event(0, OrderEvent::ADD, 4, 15100, 10);
+    expect_event(1, OrderEvent::EXECUTE, 4, 15100, 0, 10);
+    expect_event(2, OrderEvent::ADD, 4, 15100, 10);
+    expect_event(3, OrderEvent::EXECUTE, 4, 15100, 5, 5);
+    expect_event(4, OrderEvent::CANCEL, 4, 15100, 5);          // Price move: leaves the old level
+    expect_event(5, OrderEvent::ADD, 4, 15200, 10);
+    expect_event(6, OrderEvent::EXECUTE, 4, 15200, 0, 10);
+    expect_event(7, OrderEvent::ADD, 4, 15200, 10);
+    expect_event(8, OrderEvent::EXECUTE, 4, 15200, 0, 10);
+    expect_event(9, OrderEvent::ADD, 6, 15300, 30);           // Aggressor remainder rests
+    EXPECT_EQ(events[9].side, Side::BUY);
+}
+
+TEST_F(OrderEventOrderBookTest, EventsRebuildTheDepth) {
+    // Replica: live orders by id, as a subscriber would keep them
+    std::map<OrderID, OrderEvent> live;
+    auto replay = [&] {
+        for (const OrderEvent& e : events) {
+            if (e.kind == OrderEvent::CANCEL || e.remaining == 0) live.erase(e.order_id);
+            else live[e.order_id] = e;
+        }
+        events.clear();
+    };
+    auto expect_depth = [&] {
+        replay();
+        std::map<std::pair<Side, Price>, std::pair<Quantity, uint32_t>> levels;
+        for (const auto& [id, e] : live) {
+            auto& level = levels[{e.side, e.price}];
+            level.first += e.remaining;
+            ++level.second;
+        }
+        DepthSnapshot depth;
+        book->get_depth(depth);
+        size_t seen = 0;
+        auto check = [&](Side side, const auto& book_levels, size_t count) {
+            for (size_t i = 0; i < count; ++i, ++seen) {
+                const auto& level = levels[{side, book_levels[i].price}];
+                EXPECT_EQ(level.first, book_levels[i].quantity) << book_levels[i].price;
+                EXPECT_EQ(level.second, book_levels[i].order_count) << book_levels[i].price;
+            }
+        };
+        check(Side::BUY, depth.bids, depth.bid_levels);
+        check(Side::SELL, depth.asks, depth.ask_levels);
+        EXPECT_EQ(levels.size(), seen);
+    };
+
+    // Deterministic churn: rests, crosses, cancels, modifies, icebergs
+    uint64_t state = 12345;
+    auto next = [&](uint64_t bound) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        return (state >> 33) % bound;
+    };
+    OrderID id = 1;
+    for (int step = 0; step < 400; ++step) {
+        const uint64_t action = next(10);
+        if (action < 6 || book->order_count() == 0) {
+            const Side side = next(2) ? Side::BUY : Side::SELL;
+            Order* order = create_order(id++, ClientID("100"), side, 10 * (1 + next(20)), 14900 + 10 * next(20));
+            if (next(5) == 0) order->display_quantity = 10;
+            EXPECT_TRUE(book->add_order(order).has_value());
+        } else if (action < 8) {
+            (void)book->cancel_order(1 + next(id - 1));
+        } else {
+            (void)book->modify_order(1 + next(id - 1), 10 * (1 + next(20)), next(2) ? 0 : 14900 + 10 * next(20));
+        }
+        if (step % 50 == 0) expect_depth();
+    }
+    expect_depth();
+
+    // Uncross: both sides execute
+    book->begin_auction();
+    EXPECT_TRUE(book->add_order(create_order(id++, ClientID("100"), Side::BUY, 500, 15200)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(id++, ClientID("101"), Side::SELL, 500, 14800)).has_value());
+    EXPECT_GT(book->uncross().volume, 0u);
+    expect_depth();
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Lazy level removal (sorted-vector tombstones)
+// ═══════════════════════════════════════════════════════════════
+
+TEST_F(OrderBookTest, DrainedLevelTombstonedAndReused) {
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::SELL, 100, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("100"), Side::SELL, 100, 15100)).has_value());
+
+    // Sweep drains 15000 — best skips the tombstone
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("101"), Side::BUY, 100, 15000)).has_value());
+    EXPECT_EQ(book->best_ask(), 15100);
+
+    DepthSnapshot depth;
+    book->get_depth(depth);
+    EXPECT_EQ(depth.ask_levels, 1);
+
+    // Price reappears — tombstone re-armed in place
+    EXPECT_TRUE(book->add_order(create_order(4, ClientID("100"), Side::SELL, 50, 15000)).has_value());
+    EXPECT_EQ(book->best_ask(), 15000);
+    book->get_depth(depth);
+    ASSERT_EQ(depth.ask_levels, 2);
+    EXPECT_EQ(depth.asks[0].quantity, 50);
+}
+
+TEST_F(OrderBookTest, PruneDropsTombstones) {
+    FlatPriceBook<false> asks{*pool, OrderBookOptions{}};
+    Order* a = create_order(1, ClientID("100"), Side::SELL, 10, 15000);
+    Order* b = create_order(2, ClientID("100"), Side::SELL, 10, 15100);
+    Order* c = create_order(3, ClientID("100"), Side::SELL, 10, 15200);
+    asks.find_or_insert(15000).push_back(a);
+    asks.find_or_insert(15100).push_back(b);
+    asks.find_or_insert(15200).push_back(c);
+
+    // Drain a middle level — stays as a tombstone until prune
+    ASSERT_TRUE(asks.find(15100)->remove(b));
+    asks.remove(15100);
+    EXPECT_EQ(asks.find(15100), nullptr);
+    EXPECT_EQ(asks.level_count(), 3);
+
+    // Drain the best — first live level advances past the tombstone
+    asks.best_level().pop_front(10);
+    asks.remove_best();
+    EXPECT_EQ(asks.best_price(), 15200);
+    EXPECT_EQ(asks.level_count(), 1);
+
+    // Prune compacts storage; a price behind the best re-inserts cleanly
+    asks.prune_empty();
+    EXPECT_EQ(asks.level_count(), 1);
+    Order* d = create_order(4, ClientID("100"), Side::SELL, 10, 15100);
+    asks.find_or_insert(15100).push_back(d);
+    EXPECT_EQ(asks.best_price(), 15100);
+    EXPECT_EQ(asks.level_count(), 2);
+}
+
+TEST_F(OrderBookTest, OperationsReportWhatTheyChanged) {
+    auto added = book->add_order(create_order(1, ClientID("100"), Side::SELL, 100, 15000));
+    ASSERT_TRUE(added.has_value());
+    EXPECT_TRUE(added.value().ask_moved);
+    EXPECT_FALSE(added.value().bid_moved);
+    EXPECT_EQ(added.value().levels, 1u);
+    EXPECT_EQ(added.value().fills, 0u);
+    ASSERT_TRUE(book->add_order(create_order(2, ClientID("100"), Side::SELL, 100, 15100)).has_value());
+    ASSERT_TRUE(book->add_order(create_order(3, ClientID("100"), Side::SELL, 100, 15100)).has_value());
+
+    BBOSnapshot before;
+    ASSERT_TRUE(book->read_bbo(before));
+
+    // Behind the best: nothing at the top moved, the snapshot is left alone
+    auto behind = book->add_order(create_order(4, ClientID("100"), Side::SELL, 100, 15200));
+    ASSERT_TRUE(behind.has_value());
+    EXPECT_FALSE(behind.value().top_changed());
+    EXPECT_EQ(behind.value().levels, 1u);
+    BBOSnapshot after;
+    ASSERT_TRUE(book->read_bbo(after));
+    EXPECT_EQ(after.sequence, before.sequence);
+
+    // Joining the best only resizes the top
+    auto joined = book->add_order(create_order(5, ClientID("100"), Side::SELL, 50, 15000));
+    ASSERT_TRUE(joined.has_value());
+    EXPECT_FALSE(joined.value().moved());
+    EXPECT_TRUE(joined.value().top_resized);
+    ASSERT_TRUE(book->read_bbo(after));
+    EXPECT_EQ(after.ask_quantity, 150u);
+
+    // A sweep through two levels, four resting orders hit
+    auto swept = book->add_order(create_order(6, ClientID("101"), Side::BUY, 300, 15100));
+    ASSERT_TRUE(swept.has_value());
+    EXPECT_EQ(swept.value().fills, 4u);
+    EXPECT_EQ(swept.value().levels, 2u);
+    EXPECT_FALSE(swept.value().bid_moved);
+    EXPECT_TRUE(swept.value().ask_moved);
+    EXPECT_EQ(book->best_ask(), 15100);
+
+    auto cancelled = book->cancel_order(4);
+    ASSERT_TRUE(cancelled.has_value());
+    EXPECT_FALSE(cancelled.value().top_changed());
+    EXPECT_EQ(cancelled.value().levels, 1u);
+
+    auto modified = book->modify_order(3, 40);
+    ASSERT_TRUE(modified.has_value());
+    EXPECT_TRUE(modified.value().top_resized);
+    EXPECT_EQ(book->last_change().levels, 1u);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  Cross-thread depth snapshots
+// ═══════════════════════════════════════════════════════════════
+
+TEST_F(OrderBookTest, PublishedDepthReadable) {
+    DepthSnapshot depth;
+    EXPECT_FALSE(book->read_depth(depth));  // Nothing published yet
+
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::BUY, 100, 14900)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("101"), Side::SELL, 200, 15100)).has_value());
+    book->publish_depth(5);
+
+    ASSERT_TRUE(book->read_depth(depth));
+    EXPECT_EQ(depth.version, 1);
+    EXPECT_EQ(depth.bid_levels, 1);
+    EXPECT_EQ(depth.ask_levels, 1);
+    EXPECT_EQ(depth.bids[0].price, 14900);
+    EXPECT_EQ(depth.asks[0].quantity, 200);
+
+    // Snapshot is a copy — later book changes are invisible until republished
+    EXPECT_TRUE(book->cancel_order(1).has_value());
+    ASSERT_TRUE(book->read_depth(depth));
+    EXPECT_EQ(depth.bid_levels, 1);
+
+    book->publish_depth(5);
+    ASSERT_TRUE(book->read_depth(depth));
+    EXPECT_EQ(depth.version, 2);
+    EXPECT_EQ(depth.bid_levels, 0);
+}
+
+TEST_F(OrderBookTest, LevelChangesReportTouchedLevelsWithCurrentState) {
+    struct Change { Side side; Price price; Quantity quantity; uint32_t orders; };
+    std::vector<Change> changes;
+    auto drain = [&] {
+        changes.clear();
+        book->drain_level_changes([&](Side side, Price price, Quantity quantity, uint32_t orders) {
+            changes.push_back({side, price, quantity, orders});
+        });
+    };
+
+    // Off by default
+    EXPECT_TRUE(book->add_order(create_order(1, ClientID("100"), Side::SELL, 100, 15000)).has_value());
+    drain();
+    EXPECT_TRUE(changes.empty());
+
+    book->track_level_changes(true);
+    EXPECT_TRUE(book->add_order(create_order(2, ClientID("100"), Side::SELL, 50, 15000)).has_value());
+    EXPECT_TRUE(book->add_order(create_order(3, ClientID("100"), Side::SELL, 70, 15100)).has_value());
+    drain();
+    ASSERT_EQ(changes.size(), 2u);
+    EXPECT_EQ(changes[0].side, Side::SELL);
+    EXPECT_EQ(changes[0].price, 15000u);
+    EXPECT_EQ(changes[0].quantity, 150u);
+    EXPECT_EQ(changes[0].orders, 2u);
+    EXPECT_EQ(changes[1].price, 15100u);
+    EXPECT_EQ(changes[1].quantity, 70u);
+
+    // Sweep empties both ask levels; the remainder rests as a bid at 15100
+    EXPECT_TRUE(book->add_order(create_order(4, ClientID("101"), Side::BUY, 250, 15100)).has_value());
+    drain();
+    ASSERT_EQ(changes.size(), 3u);
+    EXPECT_EQ(changes[0].price, 15000u);
+    EXPECT_EQ(changes[0].quantity, 0u);   // Level gone
+    EXPECT_EQ(changes[0].orders, 0u);
+    EXPECT_EQ(changes[1].side, Side::SELL);
+    EXPECT_EQ(changes[1].price, 15100u);
+    EXPECT_EQ(changes[1].quantity, 0u);
+    EXPECT_EQ(changes[2].side, Side::BUY);
+    EXPECT_EQ(changes[2].price, 15100u);
+    EXPECT_EQ(changes[2].quantity, 30u);
+    EXPECT_EQ(changes[2].orders, 1u);
+
+    // Size-down in place and cancel both report the level
+    EXPECT_TRUE(book->modify_order(4, 10, 15100).has_value());
+    drain();
+    ASSERT_EQ(changes.size(), 1u);
+    EXPECT_EQ(changes[0].quantity, 10u);
+    EXPECT_TRUE(book->cancel_order(4).has_value());
+    drain();
+    ASSERT_EQ(changes.size(), 1u);
+    EXPECT_EQ(changes[0].quantity, 0u);
+}
+
+TEST(DepthSnapshotBufferTest, ConcurrentReadsAreConsistent) {
+    DepthSnapshotBuffer buffer;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+    std::atomic<uint64_t> reads{0};
+
+    // Every published snapshot has all fields derived from one value;
+    // a torn copy would mix values from two publishes.
+    std::thread reader([&] {
+        DepthSnapshot snap;
+        while (!done.load(std::memory_order_relaxed)) {
+            if (!buffer.read(snap)) continue;
+            reads.fetch_add(1, std::memory_order_relaxed);
+            const uint64_t v = snap.bids[0].quantity;
+            for (size_t i = 0; i < MAX_DEPTH_LEVELS; ++i) {
+                if (snap.bids[i].quantity != v || snap.asks[i].quantity != v) {
+                    torn.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                }
+            }
+            if (snap.version != v) torn.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    for (uint64_t v = 1; v <= 200000; ++v) {
+        buffer.publish([v](DepthSnapshot& s) {
+            for (size_t i = 0; i < MAX_DEPTH_LEVELS; ++i) {
+                s.bids[i].quantity = v;
+                s.asks[i].quantity = v;
+            }
+        });
+    }
+    done.store(true);
+    reader.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    DepthSnapshot last;
+    ASSERT_TRUE(buffer.read(last));
+    EXPECT_EQ(last.version, 200000);
+}
+
 } // namespace rtes
\ No newline at end of file
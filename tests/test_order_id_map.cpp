@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "rtes/order_id_map.hpp"
+#include <random>
+#include <unordered_map>
+
+namespace rtes {
+
+TEST(OrderIdMapTest, InsertFindErase) {
+    OrderIdMap<uint32_t> map(16);
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(map.capacity(), 32);
+
+    EXPECT_TRUE(map.insert(42, 7));
+    ASSERT_NE(map.find(42), nullptr);
+    EXPECT_EQ(*map.find(42), 7);
+    EXPECT_TRUE(map.contains(42));
+    EXPECT_EQ(map.find(43), nullptr);
+
+    EXPECT_TRUE(map.erase(42));
+    EXPECT_FALSE(map.erase(42));
+    EXPECT_FALSE(map.contains(42));
+    EXPECT_TRUE(map.empty());
+}
+
+TEST(OrderIdMapTest, RejectsDuplicateAndReservedKey) {
+    OrderIdMap<uint32_t> map(4);
+    EXPECT_TRUE(map.insert(1, 10));
+    EXPECT_FALSE(map.insert(1, 20));
+    EXPECT_EQ(*map.find(1), 10);
+
+    EXPECT_FALSE(map.insert(OrderIdMap<uint32_t>::EMPTY_KEY, 1));
+    EXPECT_EQ(map.find(OrderIdMap<uint32_t>::EMPTY_KEY), nullptr);
+    EXPECT_EQ(map.size(), 1);
+}
+
+TEST(OrderIdMapTest, FailsInsteadOfGrowingWhenFull) {
+    OrderIdMap<uint32_t> map(8);
+    for (OrderID id = 1; id <= 8; ++id) EXPECT_TRUE(map.insert(id, 0));
+    EXPECT_FALSE(map.insert(9, 0));
+    EXPECT_EQ(map.size(), 8);
+
+    EXPECT_TRUE(map.erase(3));
+    EXPECT_TRUE(map.insert(9, 0));
+}
+
+TEST(OrderIdMapTest, BackwardShiftKeepsProbeRunsIntact) {
+    // Randomized insert/erase against std::unordered_map as oracle.
+    // Small table, high churn: exercises wrap-around and run shifting.
+    OrderIdMap<uint64_t> map(512);
+    std::unordered_map<OrderID, uint64_t> oracle;
+    std::mt19937_64 rng(12345);
+
+    for (int step = 0; step < 200000; ++step) {
+        const OrderID id = rng() % 2048;
+        if (oracle.size() < 512 && (rng() & 1)) {
+            const bool expect = oracle.emplace(id, id * 3).second;
+            EXPECT_EQ(map.insert(id, id * 3), expect);
+        } else {
+            EXPECT_EQ(map.erase(id), oracle.erase(id) == 1);
+        }
+        if (step % 1000 == 0) {
+            ASSERT_EQ(map.size(), oracle.size());
+            for (const auto& [k, v] : oracle) {
+                const uint64_t* found = map.find(k);
+                ASSERT_NE(found, nullptr);
+                ASSERT_EQ(*found, v);
+            }
+        }
+    }
+
+    size_t visited = 0;
+    map.for_each([&](OrderID k, uint64_t v) {
+        ++visited;
+        EXPECT_EQ(oracle.at(k), v);
+    });
+    EXPECT_EQ(visited, oracle.size());
+}
+
+} // namespace rtes
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include "rtes/order_trace.hpp"
+#include "rtes/matching_engine.hpp"
+#include "rtes/memory_pool.hpp"
+
+#include <format>
+#include <string>
+#include <vector>
+
+namespace rtes {
+
+TEST(OrderTraceTest, HopsBuildStageSpans) {
+    OrderPool pool(64);
+    OrderTracer tracer(pool, 1);
+    OrderTraceSink* engine_sink = tracer.add_sink();
+
+    Order* order = pool.allocate();
+    new (order) Order(7, "100", "AAPL", Side::BUY, OrderType::LIMIT, 100, 15000);
+    const OrderHandle handle = pool.handle(order);
+
+    const OrderTraceStart recv = tracer.begin(*order);
+    ASSERT_TRUE(recv);
+    EXPECT_EQ(recv.order_id, order->id);
+    tracer.stamp(*order, OrderStage::RISK_DEQUEUE);
+    tracer.stamp(*order, OrderStage::RISK_APPROVE);
+    tracer.acked(recv, tracer.reactor_sink(0));
+    tracer.stamp(handle, order->id, OrderStage::ENGINE_DEQUEUE);
+    tracer.finish(handle, order->id, engine_sink);
+
+    EXPECT_EQ(tracer.drain(), 2u);
+    const OrderTraceSnapshot snap = tracer.snapshot();
+    EXPECT_EQ(snap.traces, 2u);
+    EXPECT_EQ(snap.dropped, 0u);
+    for (OrderSpan span : {OrderSpan::GATEWAY_TO_RISK, OrderSpan::RISK_CHECK, OrderSpan::RISK_TO_ENGINE,
+                           OrderSpan::MATCH, OrderSpan::RECV_TO_MATCHED, OrderSpan::RECV_TO_ACK}) {
+        EXPECT_EQ(snap.span(span).count(), 1u) << order_span_name(span);
+    }
+    EXPECT_GE(snap.span(OrderSpan::RECV_TO_MATCHED).max_ns(), snap.span(OrderSpan::MATCH).max_ns());
+
+    // A reused slot starts from a clean record: only the new order's stages count
+    tracer.begin(*order);
+    tracer.stamp(handle, order->id, OrderStage::ENGINE_DEQUEUE);
+    tracer.finish(handle, order->id, engine_sink);
+    tracer.drain();
+    EXPECT_EQ(tracer.snapshot().span(OrderSpan::RISK_CHECK).count(), 1u);
+    EXPECT_EQ(tracer.snapshot().span(OrderSpan::MATCH).count(), 2u);
+}
+
+TEST(OrderTraceTest, SamplesByOrderIdAndSkipsForeignOrders) {
+    OrderPool pool(64);
+    OrderTracer tracer(pool, 16);
+    EXPECT_EQ(tracer.sample_every(), 16u);
+
+    size_t sampled = 0;
+    for (OrderID id = 1; id <= 16384; ++id) sampled += tracer.sampled(id) ? 1 : 0;
+    EXPECT_GT(sampled, 16384u / 16 / 2);
+    EXPECT_LT(sampled, 16384u / 16 * 2);
+
+    // Not from the pool: never traced
+    OrderID id = 1;
+    while (!tracer.sampled(id)) ++id;
+    Order foreign(id, "100", "AAPL", Side::BUY, OrderType::LIMIT, 100, 15000);
+    EXPECT_FALSE(tracer.begin(foreign));
+}
+
+TEST(OrderTraceTest, EngineFinishesSampledOrders) {
+    OrderPool pool(100);
+    MarketDataLane market_data(1000);
+    MatchingEngine engine("trace", {{"AAPL", {}}}, pool);
+    engine.set_market_data_queue(&market_data);
+    OrderTracer tracer(pool, 1);
+    engine.set_order_tracer(&tracer);
+
+    auto* sell = pool.allocate();
+    new (sell) Order(1, "100", "AAPL", Side::SELL, OrderType::LIMIT, 100, 15000);
+    auto* buy = pool.allocate();
+    new (buy) Order(2, "101", "AAPL", Side::BUY, OrderType::LIMIT, 100, 15000);
+
+    engine.start();
+    EXPECT_TRUE(engine.submit_order(sell));
+    EXPECT_TRUE(engine.submit_order(buy));
+    engine.stop();
+    tracer.drain();
+
+    const OrderTraceSnapshot snap = tracer.snapshot();
+    EXPECT_EQ(snap.traces, 2u);
+    EXPECT_EQ(snap.span(OrderSpan::MATCH).count(), 2u);
+    EXPECT_EQ(snap.span(OrderSpan::GATEWAY_TO_RISK).count(), 0u);  // Never passed the gateway
+}
+
+TEST(OrderTraceTest, ExportsLinkedSpans) {
+    OrderPool pool(64);
+    OrderTracer tracer(pool, 1);
+    OrderTraceSink* engine_sink = tracer.add_sink();
+    std::vector<TraceSpan> exported;
+    tracer.set_span_exporter([&](const TraceSpan* spans, size_t count) {
+        exported.insert(exported.end(), spans, spans + count);
+    });
+
+    Order* order = pool.allocate();
+    new (order) Order(42, "100", "AAPL", Side::BUY, OrderType::LIMIT, 100, 15000);
+    const OrderHandle handle = pool.handle(order);
+    const OrderTraceStart start = tracer.begin(*order);
+    tracer.stamp(*order, OrderStage::RISK_DEQUEUE);
+    tracer.stamp(*order, OrderStage::RISK_APPROVE);
+    tracer.acked(start, tracer.reactor_sink(0));
+    tracer.stamp(handle, order->id, OrderStage::ENGINE_DEQUEUE);
+    tracer.finish(handle, order->id, engine_sink);
+    tracer.drain();
+
+    // Root + 4 stage spans from the engine's record, recv_to_ack from the gateway's
+    ASSERT_EQ(exported.size(), 6u);
+    EXPECT_EQ(tracer.exported_spans(), 6u);
+    const uint64_t trace_id = trace_id_for(42);
+    const uint64_t root_id  = span_id_for(trace_id, ORDER_SPAN_ROOT);
+    size_t roots = 0;
+    for (const TraceSpan& span : exported) {
+        EXPECT_EQ(span.trace_id, trace_id);
+        EXPECT_EQ(span.order_id, 42u);
+        EXPECT_LE(span.start_unix_ns, span.end_unix_ns);
+        if (span.parent_span_id == 0) {
+            ++roots;
+            EXPECT_EQ(span.span_id, root_id);
+            EXPECT_STREQ(span.name, "order");
+        } else {
+            EXPECT_EQ(span.parent_span_id, root_id);
+        }
+    }
+    EXPECT_EQ(roots, 1u);
+
+    const std::string json = spans_to_otlp_json(exported.data(), exported.size());
+    EXPECT_EQ(json.find('\n'), std::string::npos);
+    EXPECT_NE(json.find(R"("traceId":")" + std::format("{:032x}", trace_id) + '"'), std::string::npos);
+    EXPECT_NE(json.find(R"("name":"recv_to_ack")"), std::string::npos);
+    EXPECT_NE(json.find(R"("intValue":"42")"), std::string::npos);
+}
+
+} // namespace rtes
@@ -0,0 +1,56 @@
+#include <gtest/gtest.h>
+#include "rtes/perf_counters.hpp"
+
+#include <unistd.h>
+
+namespace rtes {
+
+TEST(PerfCountersTest, SampleNormalizesPerUnit) {
+    PerfCounterSample sample;
+    EXPECT_TRUE(sample.empty());
+    EXPECT_EQ(sample.per(10, PerfEvent::CYCLES), 0.0);
+    EXPECT_EQ(sample.ipc(), 0.0);
+
+    sample.values[static_cast<size_t>(PerfEvent::CYCLES)] = 2000;
+    sample.valid[static_cast<size_t>(PerfEvent::CYCLES)] = true;
+    sample.values[static_cast<size_t>(PerfEvent::INSTRUCTIONS)] = 5000;
+    sample.valid[static_cast<size_t>(PerfEvent::INSTRUCTIONS)] = true;
+    EXPECT_FALSE(sample.empty());
+    EXPECT_DOUBLE_EQ(sample.per(10, PerfEvent::CYCLES), 200.0);
+    EXPECT_EQ(sample.per(0, PerfEvent::CYCLES), 0.0);
+    EXPECT_EQ(sample.per(10, PerfEvent::LLC_MISSES), 0.0);  // Not counted
+    EXPECT_DOUBLE_EQ(sample.ipc(), 2.5);
+}
+
+TEST(PerfCountersTest, EventNames) {
+    EXPECT_STREQ(perf_event_name(PerfEvent::CYCLES), "cycles");
+    EXPECT_STREQ(perf_event_name(PerfEvent::DTLB_MISSES), "dtlb_misses");
+    EXPECT_STREQ(perf_event_name(PerfEvent::BRANCH_MISSES), "branch_misses");
+}
+
+TEST(PerfCountersTest, CountsInstructionsOfThisThread) {
+    PerfCounters counters;
+    if (!counters.available()) GTEST_SKIP() << "No perf counters here: " << counters.error();
+
+    volatile uint64_t sink = 0;
+    counters.start();
+    for (uint64_t i = 0; i < 1000000; ++i) sink = sink + i;
+    const PerfCounterSample sample = counters.stop();
+    if (!sample.has(PerfEvent::INSTRUCTIONS)) GTEST_SKIP() << "No instruction counter";
+    EXPECT_GT(sample.value(PerfEvent::INSTRUCTIONS), 1000000u);
+
+    // Stopped counters do not advance; start() resets
+    counters.start();
+    const PerfCounterSample idle = counters.stop();
+    EXPECT_LT(idle.value(PerfEvent::INSTRUCTIONS), sample.value(PerfEvent::INSTRUCTIONS));
+}
+
+TEST(PerfCountersTest, MissingProcessIsUnavailable) {
+    PerfCounters counters(static_cast<pid_t>(-2));
+    EXPECT_FALSE(counters.available());
+    EXPECT_FALSE(counters.error().empty());
+    counters.start();
+    EXPECT_TRUE(counters.stop().empty());
+}
+
+} // namespace rtes
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "rtes/performance_optimizer.hpp"
+#include <atomic>
 #include <thread>
 #include <vector>
 #include <chrono>
@@ -167,30 +168,64 @@ TEST_F(PerformanceOptimizerTest, LatencyTracker) {
 }
 
 TEST_F(PerformanceOptimizerTest, LatencyTrackerConcurrency) {
+    // One owner thread records while another takes snapshots
     LatencyTracker tracker;
-    const int num_threads = 4;
-    const int measurements_per_thread = 1000;
-    
-    std::vector<std::thread> threads;
-    
-    for (int t = 0; t < num_threads; ++t) {
-        threads.emplace_back([&tracker, measurements_per_thread, t]() {
-            for (int i = 0; i < measurements_per_thread; ++i) {
-                tracker.record_latency(1000 + t * 100 + i);
-            }
-        });
-    }
-    
-    for (auto& thread : threads) {
-        thread.join();
+    const int measurements = 4000;
+    std::atomic<bool> done{false};
+
+    std::thread reader([&]() {
+        uint64_t last = 0;
+        while (!done.load()) {
+            const uint64_t count = tracker.snapshot().count();
+            EXPECT_GE(count, last);
+            last = count;
+        }
+    });
+    for (int i = 0; i < measurements; ++i) {
+        tracker.record_latency(1000 + i);
     }
-    
+    done.store(true);
+    reader.join();
+
     auto stats = tracker.get_stats();
-    EXPECT_EQ(stats.count, num_threads * measurements_per_thread);
+    EXPECT_EQ(stats.count, measurements);
     EXPECT_GT(stats.avg_ns, 0);
     EXPECT_GT(stats.max_ns, stats.min_ns);
 }
 
+TEST_F(PerformanceOptimizerTest, LatencyHistogramPercentilesAndMerge) {
+    LatencyTracker tracker;
+    for (uint64_t i = 1; i <= 10000; ++i) tracker.record_latency(i * 100);  // 100 ns .. 1 ms
+
+    const auto stats = tracker.get_stats();
+    // Bucket upper bounds: within 1/32 of the exact rank value, never below it
+    EXPECT_GE(stats.p50_ns, 500000u);
+    EXPECT_LE(stats.p50_ns, 500000u + 500000u / 32);
+    EXPECT_GE(stats.p99_ns, 990000u);
+    EXPECT_LE(stats.p99_ns, 990000u + 990000u / 32);
+    EXPECT_GE(stats.p999_ns, 999000u);
+    EXPECT_LE(stats.p999_ns, stats.max_ns);  // Bucket bound capped at the maximum seen
+
+    LatencyHistogram slow;
+    for (int i = 0; i < 10000; ++i) slow.record(5000000);  // 5 ms
+    LatencyHistogram merged = tracker.snapshot();
+    merged.merge(slow);
+    EXPECT_EQ(merged.count(), 20000u);
+    EXPECT_LE(merged.percentile(25), 500000u + 500000u / 32);
+    EXPECT_EQ(merged.percentile(99), 5000000u);
+
+    uint64_t exported = 0;
+    uint64_t previous_upper = 0;
+    merged.for_each_bucket([&](uint64_t lower, uint64_t upper, uint64_t count) {
+        EXPECT_GT(lower, previous_upper);
+        EXPECT_GE(upper, lower);
+        previous_upper = upper;
+        exported += count;
+    });
+    EXPECT_EQ(exported, merged.count());
+    EXPECT_EQ(latency_buckets::index(UINT64_MAX), latency_buckets::COUNT - 1);
+}
+
 TEST_F(PerformanceOptimizerTest, MemoryMonitor) {
     MemoryMonitor monitor;
     
@@ -268,6 +303,23 @@ TEST_F(PerformanceOptimizerTest, ScopedLatencyMeasurement) {
     EXPECT_LT(stats.avg_ns, 200000); // At most 200μs
 }
 
+TEST_F(PerformanceOptimizerTest, ScopedLatencyMeasurementSamplesOneCallInN) {
+    LatencyTracker tracker;
+    tracker.set_sample_every(3);  // Rounded up to 4
+
+    for (int i = 0; i < 8; ++i) {
+        ScopedLatencyMeasurement measure(tracker);
+        if (i == 4) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    // Calls 0 and 4 were timed; the calibrated TSC sees the 2 ms sleep
+    auto stats = tracker.get_stats();
+    EXPECT_EQ(stats.count, 2u);
+    EXPECT_GE(stats.max_ns, 1500000u);
+    EXPECT_LT(stats.max_ns, 50000000u);
+    EXPECT_GT(TscClock::ns_per_tick(), 0.0);
+}
+
 TEST_F(PerformanceOptimizerTest, PerformanceOptimizerIntegration) {
     PerformanceOptimizer optimizer;
     
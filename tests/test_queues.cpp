@@ -1,9 +1,16 @@
 #include <gtest/gtest.h>
 #include "rtes/spsc_queue.hpp"
 #include "rtes/mpmc_queue.hpp"
+#include "rtes/broadcast_ring.hpp"
+#include "rtes/seqlock.hpp"
+#include "rtes/stats_region.hpp"
 #include <thread>
+#include <algorithm>
 #include <vector>
 #include <atomic>
+#include <chrono>
+#include <sys/wait.h>
+#include <unistd.h>
 
 namespace rtes {
 
@@ -84,6 +91,48 @@ TEST_F(SPSCQueueTest, ProducerConsumer) {
     EXPECT_EQ(consumed.load(), num_items);
 }
 
+TEST_F(SPSCQueueTest, BulkWrapsAndPreservesOrder) {
+    // Move the indices close to the end of the 1024-slot ring
+    int value;
+    for (int i = 0; i < 1000; ++i) {
+        ASSERT_TRUE(queue->push(i));
+        ASSERT_TRUE(queue->pop(value));
+    }
+
+    std::vector<int> in(1100);
+    for (int i = 0; i < 1100; ++i) in[i] = i;
+    EXPECT_EQ(queue->try_push_bulk(in.data(), in.size()), 1024u);  // Short push when full
+    EXPECT_EQ(queue->try_push_bulk(in.data(), 1), 0u);
+
+    std::vector<int> out(1024);
+    EXPECT_EQ(queue->try_pop_bulk(out.data(), 64), 64u);
+    EXPECT_EQ(queue->try_pop_bulk(out.data() + 64, 2048), 960u);
+    EXPECT_EQ(queue->try_pop_bulk(out.data(), 1), 0u);
+    for (int i = 0; i < 1024; ++i) EXPECT_EQ(out[i], i);
+}
+
+TEST_F(SPSCQueueTest, TelemetrySamplesDepthAndResidence) {
+    EXPECT_EQ(queue->telemetry().sample_every, 0u);  // Off by default
+    queue->enable_telemetry(3);                      // Rounded up to 4
+
+    std::vector<int> in(10, 0);
+    ASSERT_EQ(queue->try_push_bulk(in.data(), in.size()), 10u);  // Samples positions 0, 4, 8
+    ASSERT_TRUE(queue->push(10));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    std::vector<int> out(8);
+    ASSERT_EQ(queue->try_pop_bulk(out.data(), 5), 5u);  // Takes positions 0 and 4
+    int value;
+    ASSERT_TRUE(queue->pop(value));
+
+    const QueueTelemetry telemetry = queue->telemetry();
+    EXPECT_EQ(telemetry.sample_every, 4u);
+    EXPECT_EQ(telemetry.high_water, 9u);  // Position 8, on top of 8 queued
+    EXPECT_EQ(telemetry.samples, 2u);
+    EXPECT_GE(telemetry.residence_max_ns, 1'000'000u);
+    EXPECT_GE(telemetry.residence_sum_ns, 2'000'000u);
+}
+
 class MPMCQueueTest : public ::testing::Test {
 protected:
     void SetUp() override {
@@ -155,4 +204,287 @@ TEST_F(MPMCQueueTest, MultipleProducersConsumers) {
     EXPECT_EQ(consumed.load(), produced.load());
 }
 
-} // namespace rtes
\ No newline at end of file
+TEST_F(MPMCQueueTest, BulkRunsKeepPerProducerOrder) {
+    constexpr int num_producers = 4;
+    constexpr int items_per_producer = 4000;
+    constexpr int chunk = 16;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; ++p) {
+        producers.emplace_back([&, p]() {
+            int values[chunk];
+            for (int i = 0; i < items_per_producer;) {
+                const int n = std::min(chunk, items_per_producer - i);
+                for (int k = 0; k < n; ++k) values[k] = p * items_per_producer + i + k;
+                const size_t pushed = queue->try_push_bulk(values, n);
+                if (pushed == 0) std::this_thread::yield();
+                i += static_cast<int>(pushed);
+            }
+        });
+    }
+
+    std::vector<int> next(num_producers, 0);
+    int out[64];
+    int consumed = 0;
+    bool ordered = true;
+    while (consumed < num_producers * items_per_producer) {
+        const size_t n = queue->try_pop_bulk(out, 64);
+        for (size_t i = 0; i < n; ++i) {
+            const int p = out[i] / items_per_producer;
+            ordered &= (out[i] % items_per_producer == next[p]);
+            ++next[p];
+        }
+        consumed += static_cast<int>(n);
+    }
+
+    for (auto& p : producers) p.join();
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(queue->try_pop_bulk(out, 64), 0u);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//  BroadcastRing
+// ═══════════════════════════════════════════════════════════════
+
+TEST_F(MPMCQueueTest, TelemetrySamplesDepthAndResidence) {
+    queue->enable_telemetry(2);
+    for (int i = 0; i < 6; ++i) ASSERT_TRUE(queue->push(i));  // Samples positions 0, 2, 4
+
+    int out[6];
+    ASSERT_EQ(queue->try_pop_bulk(out, 6), 6u);
+    const QueueTelemetry telemetry = queue->telemetry();
+    EXPECT_EQ(telemetry.high_water, 5u);
+    EXPECT_EQ(telemetry.samples, 3u);
+}
+
+TEST(BroadcastRingTest, EveryReaderSeesEveryEventAndTheSlowestGates) {
+    BroadcastRing<int> ring(4);
+    auto* audit = ring.add_reader(true);
+
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(ring.push(i));
+    int value;
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(ring.pop(value));
+        EXPECT_EQ(value, i);
+    }
+    // The primary reader caught up, but the audit reader still holds the ring
+    EXPECT_FALSE(ring.push(4));
+    ASSERT_TRUE(audit->pop(value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(ring.push(4));
+    EXPECT_FALSE(ring.push(5));
+
+    int out[8];
+    ASSERT_EQ(audit->try_pop_bulk(out, 8), 4u);
+    EXPECT_EQ(out[0], 1);
+    EXPECT_EQ(out[3], 4);
+    ASSERT_TRUE(ring.pop(value));
+    EXPECT_EQ(value, 4);
+    EXPECT_TRUE(ring.consumer_empty());
+    EXPECT_TRUE(audit->consumer_empty());
+}
+
+TEST(BroadcastRingTest, OptionalReaderIsLappedNotWaitedFor) {
+    BroadcastRing<int> ring(4);
+    auto* dashboard = ring.add_reader(false);
+
+    int value;
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(ring.push(i));
+        ASSERT_TRUE(ring.pop(value));
+    }
+
+    // Only the last ring's worth is still held
+    int out[8];
+    ASSERT_EQ(dashboard->try_pop_bulk(out, 8), 4u);
+    EXPECT_EQ(out[0], 6);
+    EXPECT_EQ(out[3], 9);
+    EXPECT_EQ(dashboard->lapped(), 6u);
+    EXPECT_EQ(dashboard->try_pop_bulk(out, 8), 0u);
+}
+
+TEST(BroadcastRingTest, ConcurrentReadersKeepOrder) {
+    constexpr int items = 100000;
+    BroadcastRing<int> ring(256);
+    auto* journal = ring.add_reader(true);
+    auto* monitor = ring.add_reader(false);
+
+    std::thread producer([&] {
+        for (int i = 0; i < items;) {
+            if (ring.push(i)) ++i; else std::this_thread::yield();
+        }
+    });
+    auto drain_required = [&](BroadcastRing<int>::Reader& reader, bool& ordered) {
+        int out[32];
+        for (int next = 0; next < items;) {
+            const size_t n = reader.try_pop_bulk(out, 32);
+            if (n == 0) std::this_thread::yield();
+            for (size_t k = 0; k < n; ++k) ordered &= out[k] == next++;
+        }
+    };
+    bool primary_ordered = true, journal_ordered = true;
+    std::thread primary([&] { drain_required(ring.primary(), primary_ordered); });
+    std::thread journal_thread([&] { drain_required(*journal, journal_ordered); });
+
+    // Rising values; what is missing was counted as lapped
+    uint64_t seen = 0;
+    bool rising = true;
+    int last = -1, out[32];
+    while (last < items - 1) {
+        const size_t n = monitor->try_pop_bulk(out, 32);
+        if (n == 0) std::this_thread::yield();
+        for (size_t k = 0; k < n; ++k) {
+            rising &= out[k] > last;
+            last = out[k];
+        }
+        seen += n;
+    }
+
+    producer.join();
+    primary.join();
+    journal_thread.join();
+    EXPECT_TRUE(primary_ordered);
+    EXPECT_TRUE(journal_ordered);
+    EXPECT_TRUE(rising);
+    EXPECT_EQ(seen + monitor->lapped(), static_cast<uint64_t>(items));
+}
+
+TEST(SeqlockTest, ReadersNeverSeeATornValue) {
+    struct Wide {
+        uint64_t words[5];
+    };
+    Seqlock<Wide> lock;
+    lock.store(Wide{});
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+    std::atomic<uint64_t> reads[2]{};
+
+    auto reader = [&](size_t index) {
+        Wide value;
+        while (!done.load(std::memory_order_relaxed)) {
+            if (!lock.read(value)) continue;
+            // The writer stores the same counter in every word
+            for (uint64_t word : value.words) {
+                if (word != value.words[0]) torn.fetch_add(1, std::memory_order_relaxed);
+            }
+            reads[index].fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+    std::thread first(reader, 0), second(reader, 1);
+
+    // Keep writing until both readers have raced it: on one CPU the minimum
+    // number of writes can finish before either reader is scheduled
+    constexpr uint64_t min_writes = 200000;
+    constexpr uint64_t min_reads  = 64;
+    uint64_t writes = 0;
+    while (writes < min_writes || reads[0].load(std::memory_order_relaxed) < min_reads ||
+           reads[1].load(std::memory_order_relaxed) < min_reads) {
+        Wide value;
+        std::fill(std::begin(value.words), std::end(value.words), ++writes);
+        lock.store(value);
+    }
+    done.store(true);
+    first.join();
+    second.join();
+
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_EQ(lock.version(), writes + 1);
+    Wide last;
+    ASSERT_TRUE(lock.read(last));
+    EXPECT_EQ(last.words[4], writes);
+}
+
+TEST(StatsRegionTest, SidecarReadsWhatOwnersPublish) {
+    const std::string name = "rtes_test_stats_" + std::to_string(::getpid());
+    auto region = StatsRegion::create(2, name);
+    ASSERT_NE(region, nullptr);
+    StatsBlock* engine = region->add("shard-0", StatsKind::ENGINE);
+    StatsBlock* risk   = region->add("risk_manager", StatsKind::RISK);
+    ASSERT_NE(engine, nullptr);
+    ASSERT_NE(risk, nullptr);
+    EXPECT_EQ(region->add("one-too-many", StatsKind::ENGINE), nullptr);
+
+    // A second mapping stands in for the sidecar process
+    auto sidecar = StatsRegion::open(name);
+    ASSERT_NE(sidecar, nullptr);
+    EXPECT_EQ(sidecar->add("intruder", StatsKind::RISK), nullptr);
+
+    StatsCounters counters;
+    counters.flushes = 3;
+    counters.values[ENGINE_TRADES] = 42;
+    engine->publish(counters);
+    counters.values[ENGINE_TRADES] = 0;
+    counters.values[RISK_APPROVED] = 7;
+    risk->publish(counters);
+
+    auto samples = sidecar->snapshot();
+    ASSERT_EQ(samples.size(), 2u);
+    EXPECT_EQ(samples[0].name, "shard-0");
+    EXPECT_EQ(samples[0].kind, StatsKind::ENGINE);
+    EXPECT_TRUE(samples[0].consistent);
+    EXPECT_EQ(samples[0].counters.flushes, 3u);
+    EXPECT_EQ(samples[0].counters.values[ENGINE_TRADES], 42u);
+    EXPECT_EQ(samples[1].name, "risk_manager");
+    EXPECT_EQ(samples[1].kind, StatsKind::RISK);
+    EXPECT_EQ(samples[1].counters.values[RISK_APPROVED], 7u);
+
+    // A live creator's region is never replaced under its readers
+    EXPECT_EQ(StatsRegion::create(2, name), nullptr);
+    EXPECT_EQ(sidecar->snapshot().size(), 2u);
+
+    // The creator unlinks the name; a sidecar attaching later finds nothing
+    sidecar.reset();
+    region.reset();
+    EXPECT_EQ(StatsRegion::open(name), nullptr);
+}
+
+TEST(StatsRegionTest, CrashedCreatorsRegionIsReplaced) {
+    const std::string name = "rtes_test_stale_" + std::to_string(::getpid());
+    const pid_t child = ::fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        auto region = StatsRegion::create(1, name);
+        if (!region || !region->add("shard-0", StatsKind::ENGINE)) ::_exit(1);
+        ::_exit(0);  // Dies without unlinking, as a crash would
+    }
+    int status = 0;
+    ASSERT_EQ(::waitpid(child, &status, 0), child);
+    ASSERT_EQ(WEXITSTATUS(status), 0);
+    ASSERT_NE(StatsRegion::open(name), nullptr);
+
+    auto region = StatsRegion::create(1, name);
+    ASSERT_NE(region, nullptr);
+    EXPECT_TRUE(StatsRegion::open(name)->snapshot().empty());  // Not the crashed run's blocks
+}
+
+TEST(StatsRegionTest, SnapshotWhileOwnerPublishes) {
+    auto region = StatsRegion::create(1);
+    ASSERT_NE(region, nullptr);
+    StatsBlock* block = region->add("shard-0", StatsKind::ENGINE);
+    ASSERT_NE(block, nullptr);
+
+    std::atomic<bool> done{false};
+    std::thread owner([&] {
+        StatsCounters counters;
+        while (!done.load(std::memory_order_relaxed)) {
+            ++counters.flushes;
+            std::fill(std::begin(counters.values), std::end(counters.values), counters.flushes);
+            block->publish(counters);
+        }
+    });
+
+    uint64_t last = 0;
+    for (int i = 0; i < 20000; ++i) {
+        auto samples = region->snapshot();
+        ASSERT_EQ(samples.size(), 1u);
+        if (!samples[0].consistent) continue;
+        const StatsCounters& seen = samples[0].counters;
+        for (uint64_t value : seen.values) ASSERT_EQ(value, seen.flushes);
+        EXPECT_GE(seen.flushes, last);
+        last = seen.flushes;
+    }
+    done.store(true);
+    owner.join();
+}
+
+} // namespace rtes
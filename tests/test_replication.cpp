@@ -0,0 +1,264 @@
+#include <gtest/gtest.h>
+#include "rtes/replication.hpp"
+#include "rtes/memory_pool.hpp"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef RTES_NO_OPENSSL
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#endif
+
+namespace rtes {
+
+namespace {
+
+const std::string SECRET = "replication-test-secret";
+
+/** Replication authenticates the primary with OpenSSL's HMAC */
+constexpr bool replication_available() {
+#ifdef RTES_NO_OPENSSL
+    return false;
+#else
+    return true;
+#endif
+}
+
+std::string journal_path(const char* name) {
+    return (std::filesystem::temp_directory_path() /
+            (std::string(name) + "-" + std::to_string(::getpid()) + ".journal")).string();
+}
+
+uint16_t test_port(uint16_t offset) {
+    return static_cast<uint16_t>(21000 + (::getpid() % 2000) * 4 + offset);
+}
+
+Order* make_order(OrderPool& pool, OrderID id, Side side, Quantity quantity, Price price) {
+    auto* order = pool.allocate();
+    new (order) Order(id, "100", "AAPL", side, OrderType::LIMIT, quantity, price);
+    return order;
+}
+
+template <typename Predicate>
+bool wait_until(Predicate done) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+std::vector<Trade> drain_trades(MarketDataLane& lane) {
+    std::vector<Trade> trades;
+    MarketDataEvent event;
+    while (lane.pop(event)) {
+        if (event.type == MarketDataEvent::TRADE) trades.push_back(event.trade);
+    }
+    return trades;
+}
+
+} // namespace
+
+TEST(ReplicationTest, StandbyFollowsThePrimaryAndTakesOver) {
+    if (!replication_available()) GTEST_SKIP() << "Built without OpenSSL";
+    const uint16_t port = test_port(0);
+    OrderPool standby_pool(100);
+    MarketDataLane standby_market_data(1000);
+    MatchingEngine standby_engine("shard-0", {{"AAPL", {}}}, standby_pool);
+    standby_engine.set_market_data_queue(&standby_market_data);
+    ReplicationStandby standby("127.0.0.1", port, SECRET, {&standby_engine}, {}, std::chrono::milliseconds(0));
+    standby.start();
+
+    const std::string path = journal_path("rtes-replication-primary");
+    {
+        EventJournal journal(path);
+        ReplicationPrimary primary("127.0.0.1:" + std::to_string(port), SECRET, ReplicationMode::ASYNC, 1 << 20);
+        OrderPool pool(100);
+        MarketDataLane market_data(1000);
+        MatchingEngine engine("shard-0", {{"AAPL", {}}}, pool);
+        engine.set_market_data_queue(&market_data);
+        engine.set_event_journal(journal.add_engine(engine.name()));
+        primary.add_engine(&engine);
+        journal.set_replicator(&primary);
+        ASSERT_TRUE(journal.start());
+        ASSERT_TRUE(primary.connected());
+        engine.start();
+
+        ASSERT_TRUE(engine.submit_order(make_order(pool, 1, Side::SELL, 100, 15000)));
+        ASSERT_TRUE(engine.submit_order(make_order(pool, 2, Side::SELL, 50, 15000)));
+        ASSERT_TRUE(engine.submit_order(make_order(pool, 3, Side::SELL, 70, 15100)));
+        ASSERT_TRUE(engine.submit_order(make_order(pool, 4, Side::BUY, 30, 15000)));
+        ASSERT_TRUE(engine.cancel_order(3, ClientID("100")));
+        ASSERT_TRUE(engine.modify_order(2, ClientID("100"), 40, 15000));
+        engine.stop();
+        journal.stop();  // Sends what is left
+        EXPECT_EQ(primary.records_sent(), 6u);
+        EXPECT_EQ(drain_trades(market_data).size(), 1u);
+    }
+    ASSERT_TRUE(wait_until([&] { return standby.requests_applied() == 6; }));
+    EXPECT_TRUE(drain_trades(standby_market_data).empty());  // The primary published those
+
+    standby.promote();
+    EXPECT_TRUE(standby.promotion_due());
+    standby_engine.start();
+    ASSERT_TRUE(standby_engine.submit_order(make_order(standby_pool, 5, Side::BUY, 200, 15000)));
+    standby_engine.stop();
+
+    // Order 1's rest, then order 2 (modified down in place), trade ids carrying on
+    const auto trades = drain_trades(standby_market_data);
+    ASSERT_EQ(trades.size(), 2u);
+    EXPECT_EQ(trades[0].sell_order_id, 1u);
+    EXPECT_EQ(trades[0].quantity, 70u);
+    EXPECT_EQ(trades[0].id, 2u);
+    EXPECT_EQ(trades[1].sell_order_id, 2u);
+    EXPECT_EQ(trades[1].quantity, 40u);
+    EXPECT_EQ(trades[1].id, 3u);
+    std::filesystem::remove(path);
+}
+
+TEST(ReplicationTest, GatedReportsWaitForTheAck) {
+    const std::string path = journal_path("rtes-replication-gate");
+    EventJournal journal(path);
+    OrderPool pool(100);
+    SPSCQueue<ExecutionReport> reports(1024);
+    MatchingEngine engine("shard-0", {{"AAPL", {}}}, pool);
+    engine.set_execution_queue(&reports);
+    JournalLane* lane = journal.add_engine(engine.name());
+    engine.set_event_journal(lane);
+    std::atomic<uint64_t> acked{0};
+    engine.set_replication_gate(&acked);
+    ASSERT_TRUE(journal.start());
+    engine.start();
+
+    ASSERT_TRUE(engine.submit_order(make_order(pool, 1, Side::SELL, 100, 15000)));
+    ASSERT_TRUE(engine.submit_order(make_order(pool, 2, Side::BUY, 100, 15000)));  // Fills both: seq 2
+    ASSERT_TRUE(wait_until([&] { return journal.records_written() >= 5; }));       // 2 requests, trade, 2 done
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_TRUE(reports.empty());
+
+    acked.store(1, std::memory_order_release);  // Order 1 alone produced nothing
+    engine.wake();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_TRUE(reports.empty());
+
+    acked.store(2, std::memory_order_release);
+    engine.wake();
+    ASSERT_TRUE(wait_until([&] { return !reports.empty(); }));
+    engine.stop();
+    journal.stop();
+
+    size_t count = 0;
+    ExecutionReport report;
+    while (reports.pop(report)) ++count;
+    EXPECT_GE(count, 3u);  // Fill and both dones
+    std::filesystem::remove(path);
+}
+
+TEST(ReplicationTest, SyncPrimaryReleasesReportsOnceTheStandbyHasThem) {
+    if (!replication_available()) GTEST_SKIP() << "Built without OpenSSL";
+    const uint16_t port = test_port(1);
+    OrderPool standby_pool(100);
+    MatchingEngine standby_engine("shard-0", {{"AAPL", {}}}, standby_pool);
+    ReplicationStandby standby("127.0.0.1", port, SECRET, {&standby_engine}, {}, std::chrono::milliseconds(0));
+    standby.start();
+
+    const std::string path = journal_path("rtes-replication-sync");
+    EventJournal journal(path);
+    ReplicationPrimary primary("127.0.0.1:" + std::to_string(port), SECRET, ReplicationMode::SYNC, 1 << 20);
+    OrderPool pool(100);
+    SPSCQueue<ExecutionReport> reports(1024);
+    MatchingEngine engine("shard-0", {{"AAPL", {}}}, pool);
+    engine.set_execution_queue(&reports);
+    engine.set_event_journal(journal.add_engine(engine.name()));
+    engine.set_replication_gate(primary.acked(0));
+    primary.add_engine(&engine);
+    journal.set_replicator(&primary);
+    ASSERT_TRUE(journal.start());
+    ASSERT_TRUE(primary.connected());
+    engine.start();
+
+    ASSERT_TRUE(engine.submit_order(make_order(pool, 1, Side::SELL, 100, 15000)));
+    ASSERT_TRUE(engine.submit_order(make_order(pool, 2, Side::BUY, 100, 15000)));
+    ASSERT_TRUE(wait_until([&] { return !reports.empty(); }));
+    EXPECT_EQ(standby.requests_applied(), 2u);  // Acked before any report went out
+    EXPECT_GE(primary.acked(0)->load(), 2u);
+
+    engine.stop();
+    journal.stop();
+    standby.promote();
+    std::filesystem::remove(path);
+}
+
+TEST(ReplicationTest, StandbyRefusesPeersWithoutTheSecretAndOversizedFrames) {
+    if (!replication_available()) GTEST_SKIP() << "Built without OpenSSL";
+#ifndef RTES_NO_OPENSSL
+    const uint16_t port = test_port(3);
+    OrderPool pool(10);
+    MatchingEngine engine("shard-0", {{"AAPL", {}}}, pool);
+    ReplicationStandby standby("127.0.0.1", port, SECRET, {&engine}, {}, std::chrono::milliseconds(0));
+    standby.start();
+
+    JournalFileHeader hello;
+    std::memcpy(hello.magic, JOURNAL_MAGIC, sizeof(hello.magic));
+    hello.engine_count = 1;
+    std::strcpy(hello.engine_names[0], "shard-0");
+
+    // Answers the challenge with the hello MAC'd under `secret`, then sends `frame`
+    auto peer = [&](const std::string& secret, const ReplicationFrame& frame) {
+        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port   = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        ASSERT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        uint8_t message[REPLICATION_CHALLENGE_BYTES + sizeof(hello)];
+        ASSERT_EQ(::recv(fd, message, REPLICATION_CHALLENGE_BYTES, MSG_WAITALL),
+                  static_cast<ssize_t>(REPLICATION_CHALLENGE_BYTES));
+        std::memcpy(message + REPLICATION_CHALLENGE_BYTES, &hello, sizeof(hello));
+        uint8_t mac[REPLICATION_MAC_BYTES];
+        unsigned int written = 0;
+        HMAC(EVP_sha256(), secret.data(), static_cast<int>(secret.size()), message, sizeof(message), mac, &written);
+        ::send(fd, &hello, sizeof(hello), MSG_NOSIGNAL);
+        ::send(fd, mac, sizeof(mac), MSG_NOSIGNAL);
+        ::send(fd, &frame, sizeof(frame), MSG_NOSIGNAL);
+        char byte;
+        EXPECT_LE(::recv(fd, &byte, 1, 0), 0);  // Closed by the standby
+        ::close(fd);
+    };
+
+    peer("not-the-secret", ReplicationFrame{REPLICATION_MAGIC, 1});
+    EXPECT_FALSE(standby.connected());
+    EXPECT_EQ(standby.peers_refused(), 1u);
+
+    // Authenticated, but a count no primary sends: refused before any allocation
+    peer(SECRET, ReplicationFrame{REPLICATION_MAGIC, std::numeric_limits<uint32_t>::max()});
+    ASSERT_TRUE(wait_until([&] { return standby.peers_refused() == 2; }));
+    EXPECT_EQ(standby.requests_applied(), 0u);
+    standby.promote();
+#endif
+}
+
+TEST(ReplicationTest, UnreachableStandbyLeavesThePrimaryUngated) {
+    if (!replication_available()) GTEST_SKIP() << "Built without OpenSSL";
+    ReplicationPrimary primary("127.0.0.1:" + std::to_string(test_port(2)), SECRET, ReplicationMode::SYNC,
+                               1 << 20);
+    JournalFileHeader header;
+    header.engine_count = 1;
+    EXPECT_FALSE(primary.connect(header));
+    EXPECT_FALSE(primary.connected());
+    EXPECT_EQ(primary.acked(0)->load(), std::numeric_limits<uint64_t>::max());
+}
+
+} // namespace rtes
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include "rtes/retransmission.hpp"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <thread>
+#include <chrono>
+
+namespace rtes {
+
+namespace {
+
+sockaddr_in loopback(uint16_t port) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    return addr;
+}
+
+int open_socket(uint16_t port) {
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr = loopback(port);
+    EXPECT_EQ(bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    timeval timeout{1, 0};
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return sock;
+}
+
+/** Send a request padded to `size` bytes */
+void send_request(int sock, uint16_t server_port, uint8_t channel, uint64_t from_sequence, uint32_t count,
+                  size_t size = MD_MAX_DATAGRAM) {
+    uint8_t datagram[MD_MAX_DATAGRAM] = {};
+    RetransmitRequest req;
+    req.header = UdpMessageHeader(RETRANSMIT_REQUEST, sizeof(req), 7, 0);
+    req.from_sequence = from_sequence;
+    req.count = count;
+    req.channel = channel;
+    std::memcpy(datagram, &req, sizeof(req));
+    const sockaddr_in server = loopback(server_port);
+    EXPECT_EQ(sendto(sock, datagram, size, 0, reinterpret_cast<const sockaddr*>(&server), sizeof(server)),
+              static_cast<ssize_t>(size));
+}
+
+RetransmitResponse request(int sock, uint16_t server_port, uint8_t channel,
+                           uint64_t from_sequence, uint32_t count, size_t size = MD_MAX_DATAGRAM) {
+    send_request(sock, server_port, channel, from_sequence, count, size);
+    RetransmitResponse response;
+    EXPECT_EQ(recv(sock, &response, sizeof(response), 0), static_cast<ssize_t>(sizeof(response)));
+    EXPECT_EQ(response.header.type, RETRANSMIT_RESPONSE);
+    EXPECT_EQ(response.header.sequence, 7u);
+    return response;
+}
+
+/** The next replayed datagram's packet header */
+UdpPacketHeader receive_packet(int sock) {
+    uint8_t buffer[MD_MAX_DATAGRAM];
+    UdpPacketHeader packet{};
+    const ssize_t received = recv(sock, buffer, sizeof(buffer), 0);
+    EXPECT_GT(received, static_cast<ssize_t>(sizeof(packet)));
+    if (received > 0) std::memcpy(&packet, buffer, sizeof(packet));
+    EXPECT_EQ(packet.length, received);
+    return packet;
+}
+
+} // namespace
+
+TEST(RetransmissionTest, ReplaysKeptDatagramsForASequenceRange) {
+    constexpr uint16_t feed_port   = 19994;
+    constexpr uint16_t server_port = 19993;
+    constexpr int trades = 21;  // Three packets of 7 at the minimum datagram size
+    const int feed = open_socket(feed_port);
+    const int requester = open_socket(0);
+
+    RetransmissionServer server("127.0.0.1", server_port, 1, 1, 2);  // Keeps the last two packets
+    server.start();
+
+    MarketDataLane queue(64);
+    UdpPublisher publisher("127.0.0.1", feed_port, &queue);
+    publisher.set_max_datagram_size(MD_MIN_DATAGRAM);
+    publisher.set_retransmission(server.publisher_queue(0));
+    for (int i = 0; i < trades; ++i) {
+        ASSERT_TRUE(queue.push(MarketDataEvent::make_trade("AAPL", Trade(i + 1, 1, 2, "AAPL", 100, 15000))));
+    }
+    publisher.start();
+    for (int i = 0; i < 500 && server.packets_kept() < 3; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    ASSERT_EQ(server.packets_kept(), 3u);
+
+    // Inside the second packet
+    auto response = request(requester, server_port, 0, 10, 4);
+    EXPECT_EQ(response.status, RETRANSMIT_OK);
+    EXPECT_EQ(response.packet_count, 1u);
+    EXPECT_EQ(response.first_sequence, 8u);
+    EXPECT_EQ(response.last_sequence, 14u);
+    EXPECT_EQ(response.oldest_sequence, 8u);
+    auto packet = receive_packet(requester);
+    EXPECT_EQ(packet.sequence, 8u);
+    EXPECT_EQ(packet.message_count, 7u);
+
+    // From the start: the first packet has left the history
+    response = request(requester, server_port, 0, 1, trades);
+    EXPECT_EQ(response.status, RETRANSMIT_PARTIAL);
+    EXPECT_EQ(response.packet_count, 2u);
+    EXPECT_EQ(response.first_sequence, 8u);
+    EXPECT_EQ(response.last_sequence, 21u);
+    EXPECT_EQ(receive_packet(requester).sequence, 8u);
+    EXPECT_EQ(receive_packet(requester).sequence, 15u);
+
+    // Not published yet, and a channel that does not exist
+    EXPECT_EQ(request(requester, server_port, 0, trades + 1, 10).status, RETRANSMIT_UNAVAILABLE);
+    EXPECT_EQ(request(requester, server_port, 5, 1, 10).status, RETRANSMIT_INVALID);
+
+    // Unpadded, a request earns its response and no datagram
+    response = request(requester, server_port, 0, 10, 4, sizeof(RetransmitRequest));
+    EXPECT_EQ(response.status, RETRANSMIT_PAD_REQUEST);
+    EXPECT_EQ(response.packet_count, 0u);
+
+    publisher.stop();
+    server.stop();
+    close(feed);
+    close(requester);
+    EXPECT_EQ(server.requests(), 5u);
+    EXPECT_EQ(server.packets_replayed(), 3u);
+    EXPECT_EQ(server.requests_unfilled(), 3u);
+    EXPECT_EQ(server.requests_throttled(), 0u);
+    EXPECT_EQ(publisher.retransmit_overflows(), 0u);
+}
+
+TEST(RetransmissionTest, RepliesAreBoundedByRequestSizeAndPerSourceRate) {
+    constexpr uint16_t feed_port   = 19996;
+    constexpr uint16_t server_port = 19995;
+    const int feed = open_socket(feed_port);
+    const int requester = open_socket(0);
+
+    RetransmissionServer server("127.0.0.1", server_port, 1, 1, 64);
+    server.start();
+    MarketDataLane queue(64);
+    UdpPublisher publisher("127.0.0.1", feed_port, &queue);
+    publisher.set_retransmission(server.publisher_queue(0));
+    for (int i = 0; i < 40; ++i) {
+        ASSERT_TRUE(queue.push(MarketDataEvent::make_trade("AAPL", Trade(i + 1, 1, 2, "AAPL", 100, 15000))));
+    }
+    publisher.start();
+    for (int i = 0; i < 500 && server.packets_kept() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    ASSERT_GT(server.packets_kept(), 0u);
+
+    // A byte short of earning the response: no answer at all
+    send_request(requester, server_port, 0, 1, 40, sizeof(RetransmitResponse) / RETRANSMIT_AMPLIFICATION);
+    for (int i = 0; i < 500 && server.requests() < 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(server.requests_throttled(), 1u);
+
+    // One source asking back to back runs dry within a second's budget
+    const uint64_t most = RETRANSMIT_SOURCE_RATE / sizeof(RetransmitResponse);
+    for (uint64_t sent = 1; server.requests_throttled() == 1 && sent < most; ++sent) {
+        send_request(requester, server_port, 0, 1, 40);
+        for (int i = 0; i < 1000 && server.requests() <= sent; ++i) {
+            std::this_thread::sleep_for(std::chrono::microseconds(10));
+        }
+    }
+    EXPECT_GT(server.requests_throttled(), 1u);
+
+    publisher.stop();
+    server.stop();
+    close(feed);
+    close(requester);
+}
+
+} // namespace rtes
@@ -4,6 +4,8 @@
 #include "rtes/matching_engine.hpp"
 #include <thread>
 #include <chrono>
+#include <memory>
+#include <vector>
 
 namespace rtes {
 
@@ -112,8 +114,10 @@ TEST_F(RiskManagerTest, RateLimitRejection) {
 }
 
 TEST_F(RiskManagerTest, CreditLimitRejection) {
+    // 2000 @ $150 is $300k of resting notional: three fit under the $1M limit
     for (int i = 0; i < 10; ++i) {
-        auto* order = create_order(i + 1, ClientID("100"), "AAPL", Side::BUY, 10000, 15000);
+        auto* order = create_order(i + 1, ClientID("100"), "AAPL", Side::BUY, 2000,
+                                   150 * PRICE_SCALE);
         // FIX: Suppress [[nodiscard]] warning
         (void)risk_manager->submit_order(order);
     }
@@ -135,7 +139,10 @@ TEST_F(RiskManagerTest, OrderCancellation) {
     
     std::this_thread::sleep_for(std::chrono::milliseconds(10));
     
-    EXPECT_EQ(risk_manager->get_stats().processed, 1);
+    // processed counts every request; only the owner's cancel is accepted
+    EXPECT_EQ(risk_manager->get_stats().processed, 3);
+    EXPECT_EQ(risk_manager->get_stats().cancels_accepted, 1);
+    EXPECT_EQ(risk_manager->get_stats().cancels_rejected, 1);
 }
 
 TEST_F(RiskManagerTest, MultipleClients) {
@@ -178,4 +185,456 @@ TEST_F(RiskManagerTest, HighThroughput) {
     EXPECT_EQ(risk_manager->get_stats().processed, static_cast<uint64_t>(num_orders));
 }
 
-} // namespace rtes
\ No newline at end of file
+TEST(RiskManagerLaneTest, DrainsEveryLaneAndCountsPerLane) {
+    RiskConfig risk_config;
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}};
+    OrderPool pool(16);
+    RiskManager risk(risk_config, symbols, 64, 2);
+    ASSERT_EQ(risk.lane_count(), 2u);
+
+    // Unknown symbol: rejected without needing an engine
+    auto make = [&](OrderID id) {
+        auto* order = pool.allocate();
+        new (order) Order(id, "100", "MSFT", Side::BUY, OrderType::LIMIT, 10, 15000);
+        return order;
+    };
+    for (OrderID id = 1; id <= 3; ++id) ASSERT_TRUE(risk.submit_order(make(id), 0));
+    for (OrderID id = 4; id <= 5; ++id) ASSERT_TRUE(risk.submit_order(make(id), 1));
+    EXPECT_FALSE(risk.submit_cancel(1, ClientID("100"), 2));  // No such lane
+
+    auto lanes = risk.lane_stats();
+    ASSERT_EQ(lanes.size(), 2u);
+    EXPECT_EQ(lanes[0].depth, 3u);
+    EXPECT_EQ(lanes[1].depth, 2u);
+    EXPECT_EQ(lanes[0].submitted, 3u);
+    EXPECT_EQ(lanes[1].drops, 0u);
+
+    risk.start();
+    risk.stop();  // Drains every lane and flushes stats
+
+    EXPECT_EQ(risk.get_stats().processed, 5u);
+    EXPECT_EQ(risk.get_stats().rejected, 5u);
+    lanes = risk.lane_stats();
+    EXPECT_EQ(lanes[0].depth, 0u);
+    EXPECT_EQ(lanes[1].depth, 0u);
+}
+
+TEST(RiskManagerShardTest, ClientsStayOnTheirShardAndEngineLane) {
+    RiskConfig risk_config;
+    risk_config.price_collar_enabled = false;
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}};
+    OrderPool pool(16);
+    MatchingEngine engine("AAPL", pool, {}, 2);
+    ASSERT_EQ(engine.lane_count(), 2u);
+
+    ClientDirectory directory(8);
+    std::vector<std::unique_ptr<RiskManager>> shards;
+    for (IngressLane i = 0; i < 2; ++i) {
+        shards.push_back(std::make_unique<RiskManager>(risk_config, symbols, 64));
+        shards.back()->set_engine_lane(i);
+        shards.back()->set_client_directory(&directory);
+        shards.back()->add_matching_engine("AAPL", &engine);
+    }
+
+    // Dense ids 1 and 2 → one client per shard
+    ClientID clients[2];
+    ClientIDRaw ids[2];
+    for (const char* name : {"100", "101"}) {
+        const ClientIDRaw raw = directory.resolve(ClientID(name));
+        clients[risk_shard_for(raw, 2)] = ClientID(name);
+        ids[risk_shard_for(raw, 2)] = raw;
+    }
+    EXPECT_EQ(directory.resolve(ClientID("100")), 1u);  // Stable
+    EXPECT_EQ(directory.find(ClientID("999")), 0u);
+    EXPECT_EQ(risk_shard_for(ids[1], 1), 0u);
+
+    auto make = [&](OrderID id, size_t shard) {
+        auto* order = pool.allocate();
+        new (order) Order(id, clients[shard].c_str(), "AAPL", Side::BUY, OrderType::LIMIT, 10, 15000);
+        order->owner = ids[shard];
+        return order;
+    };
+    ASSERT_TRUE(shards[0]->submit_order(make(1, 0)));
+    ASSERT_TRUE(shards[1]->submit_order(make(2, 1)));
+    // Wrong shard: the client has no state there
+    ASSERT_TRUE(shards[1]->submit_cancel(1, clients[0], 0, ids[0]));
+
+    for (auto& shard : shards) {
+        shard->start();
+        shard->stop();  // Drains and flushes stats
+    }
+
+    EXPECT_EQ(shards[0]->get_stats().approved, 1u);
+    EXPECT_EQ(shards[1]->get_stats().approved, 1u);
+    EXPECT_EQ(shards[1]->get_stats().cancels_rejected, 1u);
+
+    // Each shard produced into its own engine lane
+    auto lanes = engine.lane_stats();
+    ASSERT_EQ(lanes.size(), 2u);
+    EXPECT_EQ(lanes[0].submitted, 1u);
+    EXPECT_EQ(lanes[1].submitted, 1u);
+
+    engine.start();
+    engine.stop();  // Drains both lanes
+    EXPECT_EQ(engine.orders_processed(), 2u);
+    EXPECT_EQ(engine.lane_stats()[1].depth, 0u);
+}
+
+namespace {
+
+/**
+ * RiskManager wired to one engine per symbol, each engine reporting back
+ * on its own feedback ring. Nothing runs on its own: the drain_*() and
+ * pump() steps run each stage to empty with a start()/stop() pair, so the
+ * tests below never wait on timing.
+ */
+struct RiskPipeline {
+    RiskPipeline(const RiskConfig& config, std::vector<SymbolConfig> symbol_configs)
+        : symbols(std::move(symbol_configs)), risk(config, symbols, 64) {
+        std::vector<SPSCQueue<RiskFeedback>*> feedback;
+        for (const auto& symbol : symbols) {
+            engines.push_back(std::make_unique<MatchingEngine>(symbol.symbol, pool));
+            rings.push_back(std::make_unique<SPSCQueue<RiskFeedback>>(64));
+            engines.back()->set_risk_feedback({rings.back().get()});
+            feedback.push_back(rings.back().get());
+            risk.add_matching_engine(symbol.symbol, engines.back().get());
+        }
+        risk.set_feedback_rings(std::move(feedback));
+    }
+
+    MatchingEngine& engine(size_t i) { return *engines[i]; }
+    SPSCQueue<RiskFeedback>& ring(size_t i) { return *rings[i]; }
+
+    Order* make(OrderID id, const char* client, const char* symbol, Side side = Side::BUY,
+                Quantity quantity = 10, Price price = 15000) {
+        auto* order = pool.allocate();
+        new (order) Order(id, client, symbol, side, OrderType::LIMIT, quantity, price);
+        return order;
+    }
+
+    void submit(OrderID id, const char* client, const char* symbol, Side side = Side::BUY,
+                Quantity quantity = 10, Price price = 15000) {
+        ASSERT_TRUE(risk.submit_order(make(id, client, symbol, side, quantity, price)));
+    }
+
+    void drain_risk() { risk.start(); risk.stop(); }
+
+    void drain_engines() {
+        for (auto& engine : engines) { engine->start(); engine->stop(); }
+    }
+
+    /** risk → engines → feedback → risk */
+    void pump() {
+        drain_risk();
+        drain_engines();
+        drain_risk();
+    }
+
+    std::vector<SymbolConfig>                             symbols;
+    OrderPool                                             pool{16};
+    std::vector<std::unique_ptr<MatchingEngine>>          engines;
+    std::vector<std::unique_ptr<SPSCQueue<RiskFeedback>>> rings;
+    RiskManager                                           risk;
+};
+
+} // namespace
+
+TEST(RiskManagerFeedbackTest, FillsAndCancelsReleaseExposure) {
+    RiskConfig risk_config;
+    risk_config.price_collar_enabled = false;
+    risk_config.max_notional_per_client = 200000.0 / PRICE_SCALE;  // Room for one 10 @ 15000
+    RiskPipeline rig(risk_config, {{"AAPL", 0.01, 1, 10.0}});
+
+    rig.submit(1, "100", "AAPL");
+    rig.pump();
+    rig.submit(2, "100", "AAPL");  // Over the credit limit while #1 works
+    rig.pump();
+    EXPECT_EQ(rig.risk.get_stats().approved, 1u);
+    EXPECT_EQ(rig.risk.get_stats().rejected, 1u);
+
+    rig.submit(3, "200", "AAPL", Side::SELL);  // Fills #1 — both sides report FILL + DONE
+    rig.pump();
+    EXPECT_EQ(rig.risk.get_stats().feedback_applied, 4u);
+
+    rig.submit(4, "100", "AAPL");  // Exposure was released by the fill
+    rig.pump();
+    EXPECT_EQ(rig.risk.get_stats().approved, 3u);
+
+    ASSERT_TRUE(rig.risk.submit_cancel(4, ClientID("100")));
+    rig.pump();
+    rig.submit(4, "100", "AAPL");  // Cancel released exposure and the id
+    rig.pump();
+    EXPECT_EQ(rig.risk.get_stats().approved, 4u);
+    EXPECT_EQ(rig.risk.get_stats().rejected, 1u);
+}
+
+TEST(RiskManagerFeedbackTest, TracksPositionAndEnforcesLimits) {
+    RiskConfig risk_config;
+    risk_config.price_collar_enabled = false;
+    risk_config.max_position = 15;
+    risk_config.max_open_quantity = 10;
+    RiskPipeline rig(risk_config, {{"AAPL", 0.01, 1, 10.0}, {"MSFT", 0.01, 1, 10.0}});
+    RiskManager& risk = rig.risk;
+
+    rig.submit(1, "100", "AAPL", Side::BUY, 10);
+    rig.submit(2, "100", "AAPL", Side::BUY, 1);   // Working buy would be 11 > max_open_quantity
+    rig.pump();
+    EXPECT_EQ(risk.get_stats().rejected, 1u);
+    EXPECT_EQ(risk.position(ClientID("100"), Symbol("AAPL")).open_buy, 10u);
+
+    rig.submit(3, "200", "AAPL", Side::SELL, 10);  // Fills #1: client 100 is long 10
+    rig.pump();
+    SymbolPosition pos = risk.position(ClientID("100"), Symbol("AAPL"));
+    EXPECT_EQ(pos.net, 10);
+    EXPECT_EQ(pos.open_buy, 0u);
+    EXPECT_EQ(risk.position(ClientID("200"), Symbol("AAPL")).net, -10);
+    EXPECT_EQ(risk.position(ClientID("100"), Symbol("MSFT")).net, 0);
+
+    rig.submit(4, "100", "AAPL", Side::BUY, 6);    // Long 10 + 6 > max_position
+    rig.submit(5, "100", "AAPL", Side::BUY, 5);    // Long 10 + 5 = max_position
+    rig.submit(6, "100", "AAPL", Side::SELL, 10);  // Selling reduces the position
+    rig.pump();
+    EXPECT_EQ(risk.get_stats().rejected, 2u);
+    EXPECT_EQ(risk.get_stats().approved, 4u);
+}
+
+TEST(RiskManagerFeedbackTest, OversizedFillMovesOnlyTheWorkingQuantity) {
+    RiskConfig risk_config;
+    risk_config.price_collar_enabled = false;
+    RiskPipeline rig(risk_config, {{"AAPL", 0.01, 1, 10.0}});
+
+    rig.submit(1, "100", "AAPL");
+    rig.drain_risk();
+
+    // A fill larger than what is working (stale or duplicated report)
+    ASSERT_TRUE(rig.ring(0).push(RiskFeedback::make_fill(1, 25, 15000)));
+    rig.drain_risk();
+
+    const SymbolPosition pos = rig.risk.position(ClientID("100"), Symbol("AAPL"));
+    EXPECT_EQ(pos.net, 10);
+    EXPECT_EQ(pos.open_buy, 0u);
+}
+
+TEST(RiskManagerFeedbackTest, CompletingFillFreesTheIdWithoutDone) {
+    RiskConfig risk_config;
+    risk_config.price_collar_enabled = false;
+    RiskPipeline rig(risk_config, {{"AAPL", 0.01, 1, 10.0}});
+
+    rig.submit(1, "100", "AAPL");
+    rig.drain_risk();
+
+    // The order's DONE never arrives (dropped on a full ring)
+    ASSERT_TRUE(rig.ring(0).push(RiskFeedback::make_fill(1, 10, 15000)));
+    rig.drain_risk();
+
+    rig.submit(1, "100", "AAPL");  // Not a duplicate: the fill retired the id
+    rig.drain_risk();
+    EXPECT_EQ(rig.risk.get_stats().approved, 2u);
+    EXPECT_EQ(rig.risk.get_stats().rejected, 0u);
+}
+
+TEST(RiskManagerReferencePriceTest, CollarFollowsEngineTrades) {
+    RiskConfig risk_config;
+    risk_config.price_collar_enabled = true;
+    RiskPipeline rig(risk_config, {{"AAPL", 0.01, 1, 10.0}});
+    ReferencePriceTable prices(rig.symbols);
+    rig.engine(0).set_reference_prices(prices);
+    rig.risk.set_reference_prices(&prices);
+
+    rig.submit(1, "100", "AAPL", Side::BUY, 10, 15000);  // No reference yet — collar skipped
+    rig.submit(2, "200", "AAPL", Side::SELL, 10, 15000);
+    rig.pump();
+    EXPECT_EQ(prices.slot(Symbol("AAPL"))->price.load(), 15000u);
+
+    rig.submit(3, "100", "AAPL", Side::BUY, 10, 20000);  // > 10% above the last trade
+    rig.submit(4, "100", "AAPL", Side::BUY, 10, 16000);
+    rig.pump();
+    EXPECT_EQ(rig.risk.get_stats().approved, 3u);
+    EXPECT_EQ(rig.risk.get_stats().rejected, 1u);
+
+    rig.risk.update_reference_price(Symbol("AAPL"), 19000);  // Seeds the shared slot
+    EXPECT_EQ(prices.slot(Symbol("AAPL"))->price.load(), 19000u);
+}
+
+TEST(RiskManagerRateLimitTest, BurstIsBoundedByTokenBucket) {
+    RiskConfig risk_config;
+    risk_config.price_collar_enabled = false;
+    risk_config.max_orders_per_second = 10;
+    risk_config.rate_limit_burst = 5;
+    RiskPipeline rig(risk_config, {{"AAPL", 0.01, 1, 10.0}});
+
+    for (OrderID id = 1; id <= 8; ++id) rig.submit(id, "100", "AAPL");
+    rig.drain_risk();
+    EXPECT_EQ(rig.risk.get_stats().approved, 5u);
+    EXPECT_EQ(rig.risk.get_stats().rejected, 3u);
+}
+
+TEST(RiskManagerLimitsTest, ReloadedLimitsApplyAtTheNextBatchWithoutRestart) {
+    RiskConfig risk_config;
+    risk_config.max_order_size = 100;
+    RiskPipeline rig(risk_config, {{"AAPL", 0.01, 1, 10.0}});
+    RiskManager& risk = rig.risk;
+    risk.update_reference_price(Symbol("AAPL"), 15000);
+
+    rig.submit(1, "100", "AAPL", Side::BUY, 200, 16000);  // Over max_order_size
+    rig.submit(2, "100", "AAPL", Side::BUY, 50, 16000);   // 6.7% above the reference: inside the 10% collar
+    rig.drain_risk();  // Stats are flushed on stop
+    EXPECT_EQ(risk.get_stats().approved, 1u);
+    EXPECT_EQ(risk.get_stats().rejected, 1u);
+    EXPECT_EQ(risk.limits_generation(), 1u);
+
+    // Published to a running worker: larger orders, tighter collar; a
+    // symbol without a book is ignored
+    risk.start();
+    RiskConfig reloaded = risk_config;
+    reloaded.max_order_size = 1000;
+    const uint64_t generation =
+        risk.update_limits(reloaded, {{"AAPL", 0.01, 1, 5.0}, {"ZZZZ", 0.01, 1, 1.0}});
+    EXPECT_EQ(generation, 2u);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (risk.limits_generation() != generation && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(risk.limits_generation(), generation);  // Adopted while idle
+
+    rig.submit(3, "100", "AAPL", Side::BUY, 200, 15000);  // Now within max_order_size
+    rig.submit(4, "100", "AAPL", Side::BUY, 50, 16000);   // Now outside the 5% collar
+    risk.stop();
+    EXPECT_EQ(risk.get_stats().approved, 2u);
+    EXPECT_EQ(risk.get_stats().rejected, 2u);
+}
+
+TEST(RiskManagerLimitsTest, InstrumentStateGatesNewOrdersAndModifies) {
+    RiskConfig risk_config;
+    risk_config.price_collar_enabled = false;
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}, {"NEWCO", 0.01, 1, 10.0}};
+    symbols[1].listed = false;
+    InstrumentDirectory instruments(symbols);
+    RiskPipeline rig(risk_config, symbols);
+    RiskManager& risk = rig.risk;
+    SPSCQueue<ExecutionReport> reports(64);
+    risk.set_execution_queue(&reports);
+    risk.set_instrument_directory(&instruments);
+
+    auto submit = [&](OrderID id, const char* symbol) {
+        auto* order = rig.make(id, "100", symbol, Side::BUY, 100);
+        order->owner = risk.resolve_client(order->client_id);
+        ASSERT_TRUE(risk.submit_order(order, 0, instruments.find(Symbol(symbol))));
+    };
+    auto next_reject = [&] {
+        ExecutionReport report;
+        return reports.pop(report) ? report.reason : 0u;
+    };
+
+    submit(1, "AAPL");
+    submit(2, "NEWCO");  // Reserved, not listed: unknown
+    rig.drain_risk();
+    EXPECT_EQ(risk.get_stats().approved, 1u);
+    EXPECT_EQ(next_reject(), static_cast<uint32_t>(ErrorCode::ORDER_INVALID));
+
+    // Halted: new orders out, modifies only shrink, cancels go through
+    instruments.set_state(instruments.find(Symbol("AAPL")), InstrumentState::HALTED);
+    instruments.set_state(instruments.find(Symbol("NEWCO")), InstrumentState::OPEN);
+    submit(3, "AAPL");
+    submit(4, "NEWCO");
+    ASSERT_TRUE(risk.submit_modify(1, ClientID("100"), 100, 15100));
+    ASSERT_TRUE(risk.submit_modify(1, ClientID("100"), 50));
+    ASSERT_TRUE(risk.submit_cancel(1, ClientID("100")));
+    rig.drain_risk();
+    EXPECT_EQ(next_reject(), static_cast<uint32_t>(ErrorCode::ORDER_HALTED));
+    const auto stats = risk.get_stats();
+    EXPECT_EQ(stats.approved, 2u);
+    EXPECT_EQ(stats.rejected, 2u);
+    EXPECT_EQ(stats.modifies_rejected, 1u);
+    EXPECT_EQ(stats.modifies_accepted, 1u);
+    EXPECT_EQ(stats.cancels_accepted, 1u);
+}
+
+TEST(RiskManagerMassCancelTest, FansOutOncePerEngineAndReleasesExposure) {
+    RiskConfig risk_config;
+    risk_config.price_collar_enabled = false;
+    risk_config.max_notional_per_client = 400000.0 / PRICE_SCALE;  // Room for two 10 @ 15000
+    RiskPipeline rig(risk_config, {{"AAPL", 0.01, 1, 10.0}, {"MSFT", 0.01, 1, 10.0}});
+    RiskManager& risk = rig.risk;
+
+    rig.submit(1, "100", "AAPL");
+    rig.submit(2, "100", "MSFT");
+    rig.submit(3, "200", "AAPL");
+    rig.pump();
+    EXPECT_EQ(risk.get_stats().feedback_applied, 0u);
+
+    ASSERT_TRUE(risk.submit_mass_cancel(ClientID("100"), Symbol("MSFT")));
+    rig.pump();
+    EXPECT_EQ(risk.get_stats().feedback_applied, 1u);  // DONE for #2 only
+
+    ASSERT_TRUE(risk.submit_mass_cancel(ClientID("100")));
+    rig.pump();
+    EXPECT_EQ(risk.get_stats().feedback_applied, 2u);  // #1; client 200's #3 survives
+    EXPECT_EQ(risk.get_stats().mass_cancels, 2u);
+
+    rig.submit(4, "100", "AAPL");  // Exposure was released by the DONE feedback
+    rig.submit(5, "100", "MSFT");
+    rig.pump();
+    EXPECT_EQ(risk.get_stats().approved, 5u);
+    EXPECT_EQ(risk.get_stats().rejected, 0u);
+}
+
+TEST(RiskManagerOutboundTest, BatchReachesEachEngineInOnePush) {
+    RiskConfig risk_config;
+    risk_config.price_collar_enabled = false;
+    risk_config.max_orders_per_second = 1000;
+    risk_config.max_notional_per_client = 1000000.0;
+    RiskPipeline rig(risk_config, {{"AAPL", 0.01, 1, 10.0}, {"MSFT", 0.01, 1, 10.0}});
+    MatchingEngine& aapl = rig.engine(0);
+    MatchingEngine& msft = rig.engine(1);
+
+    for (OrderID id = 1; id <= 10; ++id) rig.submit(id, "100", id % 2 ? "AAPL" : "MSFT");
+    ASSERT_TRUE(rig.risk.submit_cancel(1, ClientID("100")));  // Staged behind order 1, same push
+    rig.drain_risk();
+
+    EXPECT_EQ(rig.risk.get_stats().approved, 10u);
+    EXPECT_EQ(rig.risk.get_stats().engine_pushes, 2u);  // One per engine, not one per request
+    EXPECT_EQ(aapl.lane_stats()[0].submitted, 6u);
+    EXPECT_EQ(msft.lane_stats()[0].submitted, 5u);
+
+    rig.drain_engines();
+    EXPECT_EQ(aapl.get_stats().orders_accepted, 5u);
+    EXPECT_EQ(msft.get_stats().orders_accepted, 5u);
+    EXPECT_EQ(rig.ring(0).size(), 1u);  // DONE for #1: the cancel arrived after its order
+}
+
+TEST(RiskManagerInstrumentTest, StampedIdsRouteWithoutTheSymbolHash) {
+    RiskConfig risk_config;
+    risk_config.price_collar_enabled = false;
+    RiskPipeline rig(risk_config, {{"AAPL", 0.01, 1, 10.0}, {"MSFT", 0.01, 1, 10.0}});
+    RiskManager& risk = rig.risk;
+    // Directory in another order, with an instrument risk does not know
+    std::vector<SymbolConfig> listed = {{"MSFT", 0.01, 1, 10.0}, {"GOOG", 0.01, 1, 10.0},
+                                        {"AAPL", 0.01, 1, 10.0}};
+    InstrumentDirectory instruments(listed);
+    risk.set_instrument_directory(&instruments);
+
+    auto submit = [&](OrderID id, const char* symbol, InstrumentID instrument) {
+        ASSERT_TRUE(risk.submit_order(rig.make(id, "100", symbol), 0, instrument));
+    };
+    submit(1, "AAPL", instruments.find(Symbol("AAPL")));
+    submit(2, "MSFT", instruments.find(Symbol("MSFT")));
+    submit(3, "GOOG", instruments.find(Symbol("GOOG")));  // Listed, but not ours
+    submit(4, "MSFT", INVALID_INSTRUMENT);                 // Unstamped: hashed
+    rig.drain_risk();
+    rig.drain_engines();
+
+    EXPECT_EQ(risk.get_stats().approved, 3u);
+    EXPECT_EQ(risk.get_stats().rejected, 1u);
+    EXPECT_EQ(rig.engine(0).get_stats().orders_accepted, 1u);
+    EXPECT_EQ(rig.engine(1).get_stats().orders_accepted, 2u);
+
+    // Cancels route by the live entry's symbol slot: MSFT answers with DONE
+    ASSERT_TRUE(risk.submit_cancel(2, ClientID("100")));
+    rig.pump();
+    EXPECT_EQ(risk.get_stats().cancels_accepted, 1u);
+    EXPECT_EQ(risk.get_stats().feedback_applied, 1u);
+    EXPECT_EQ(rig.ring(0).size(), 0u);
+}
+
+} // namespace rtes
@@ -152,4 +152,55 @@ TEST_F(SecurityTest, SecureLogging) {
     LOG_INFO_SAFE("Info: {} {}", "param1", "param2");
     LOG_WARN_SAFE("Warning: {}", "issue");
     LOG_ERROR_SAFE("Error: {}", "problem");
-}
\ No newline at end of file
+}
+
+TEST_F(SecurityTest, SessionAuthCacheGrantsAtLogonAndRevokesByEpoch) {
+    setenv("RTES_AUTH_MODE", "development", 1);
+    const std::string trader = "dev_trader_alice000000000000000000";
+    const std::string admin  = "dev_admin_root0000000000000000000000";
+    SessionAuthCache cache(2);
+
+    SessionGrant first, second, third;
+    EXPECT_FALSE(cache.authenticate("dev_trader_short", first));
+    EXPECT_EQ(first.id, 0u);
+    EXPECT_FALSE(cache.allowed(first, SESSION_PLACE_ORDER));
+
+    ASSERT_TRUE(cache.authenticate(trader, first));
+    ASSERT_TRUE(cache.authenticate(admin, second));
+    EXPECT_FALSE(cache.authenticate(trader, third));  // Full
+    EXPECT_TRUE(cache.allowed(first, SESSION_PLACE_ORDER | SESSION_CANCEL_ORDER));
+    EXPECT_TRUE(cache.allowed(second, SESSION_PLACE_ORDER));
+    EXPECT_EQ(cache.active(), 2u);
+
+    // Revoking one user moves the epoch; only its sessions lose their grant
+    const uint64_t epoch = cache.epoch();
+    EXPECT_EQ(cache.revoke_user("alice00000000000"), 1u);
+    EXPECT_EQ(cache.epoch(), epoch + 1);
+    EXPECT_FALSE(cache.allowed(first, SESSION_CANCEL_ORDER));
+    EXPECT_EQ(first.mask, 0u);
+    EXPECT_TRUE(cache.allowed(second, SESSION_CANCEL_ORDER));
+    EXPECT_EQ(second.epoch, cache.epoch());
+
+    // A released slot is reused under a new id
+    const uint32_t old_id = first.id;
+    cache.release(first);
+    EXPECT_EQ(first.id, 0u);
+    ASSERT_TRUE(cache.authenticate(trader, third));
+    EXPECT_NE(third.id, old_id);
+    EXPECT_EQ(third.id & 0xFFFF, old_id & 0xFFFF);
+    EXPECT_TRUE(cache.allowed(third, SESSION_PLACE_ORDER));
+
+    // A token binds to its own user's client only, and a refused re-logon
+    // drops the grant the session held
+    EXPECT_FALSE(cache.authenticate(trader, third, "bob0000000000000"));
+    EXPECT_EQ(third.id, 0u);
+    EXPECT_FALSE(cache.allowed(third, SESSION_PLACE_ORDER));
+    EXPECT_EQ(cache.active(), 1u);
+    ASSERT_TRUE(cache.authenticate(trader, third, "alice00000000000"));
+    EXPECT_TRUE(cache.allowed(third, SESSION_PLACE_ORDER));
+
+    cache.revoke_all();
+    EXPECT_FALSE(cache.allowed(second, SESSION_PLACE_ORDER));
+    EXPECT_FALSE(cache.allowed(third, SESSION_PLACE_ORDER));
+    unsetenv("RTES_AUTH_MODE");
+}
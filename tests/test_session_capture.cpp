@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+#include "rtes/session_capture.hpp"
+#include "rtes/tcp_gateway.hpp"
+#include "rtes/risk_manager.hpp"
+#include "rtes/memory_pool.hpp"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace rtes {
+
+namespace {
+
+struct Captured {
+    CaptureEventHeader   header;
+    std::vector<uint8_t> bytes;
+};
+
+std::vector<Captured> read_all(const std::string& path) {
+    std::vector<Captured> events;
+    EXPECT_TRUE(read_session_capture(path, [&](const CaptureEventHeader& header, const uint8_t* data) {
+        events.push_back({header, std::vector<uint8_t>(data, data + header.length)});
+    }));
+    return events;
+}
+
+std::vector<uint8_t> pattern(size_t length, uint8_t seed) {
+    std::vector<uint8_t> bytes(length);
+    for (size_t i = 0; i < length; ++i) bytes[i] = static_cast<uint8_t>(seed + i * 7);
+    return bytes;
+}
+
+} // namespace
+
+TEST(SessionCaptureTest, FramesOfAnySizeRoundTripInOrder) {
+    const std::string path = "/tmp/rtes_capture_roundtrip.cap";
+    const auto small = pattern(100, 1);
+    const auto large = pattern(3000, 2);   // Continuation chunks
+    const auto exact = pattern(232, 3);    // Fills the first chunk exactly
+    {
+        SessionCapture capture(path, 2);
+        ASSERT_TRUE(capture.start());
+        capture.record(0, CaptureEventType::FRAME, 5, 1, small.data(), small.size());
+        capture.record(0, CaptureEventType::FRAME, 5, 1, large.data(), large.size());
+        capture.record(1, CaptureEventType::FRAME, 9, 3, exact.data(), exact.size());
+        capture.record(0, CaptureEventType::CLOSE, 5, 1, nullptr, 0);
+        capture.stop();
+        EXPECT_EQ(capture.events_written(), 4u);
+        EXPECT_EQ(capture.drops(), 0u);
+    }
+
+    SessionCaptureFileHeader header;
+    std::vector<Captured> events;
+    ASSERT_TRUE(read_session_capture(path, [&](const CaptureEventHeader& event, const uint8_t* data) {
+        events.push_back({event, std::vector<uint8_t>(data, data + event.length)});
+    }, &header));
+    EXPECT_EQ(header.reactors, 2u);
+    ASSERT_EQ(events.size(), 4u);
+
+    // Reactor 0's events in order, then reactor 1's (one drain pass)
+    EXPECT_EQ(events[0].bytes, small);
+    EXPECT_EQ(events[1].bytes, large);
+    EXPECT_EQ(events[2].header.type, CaptureEventType::CLOSE);
+    EXPECT_EQ(events[2].header.connection, 5u);
+    EXPECT_EQ(events[3].bytes, exact);
+    EXPECT_EQ(events[3].header.reactor, 1u);
+    EXPECT_EQ(events[3].header.generation, 3u);
+    EXPECT_LE(events[0].header.time_ns, events[1].header.time_ns);
+    std::remove(path.c_str());
+}
+
+TEST(SessionCaptureTest, FullLaneDropsWholeFramesOnly) {
+    const std::string path = "/tmp/rtes_capture_full.cap";
+    const auto small = pattern(100, 4);
+    const auto large = pattern(4000, 5);  // 17 chunks
+    SessionCapture capture(path, 1, 64);  // Writer not started: nothing drains
+
+    size_t accepted = 0;
+    for (int i = 0; i < 60; ++i) {
+        capture.record(0, CaptureEventType::FRAME, 1, 1, small.data(), small.size());
+    }
+    accepted += 60;
+    capture.record(0, CaptureEventType::FRAME, 1, 1, large.data(), large.size());  // 4 chunks left: dropped
+    for (int i = 0; i < 10; ++i) capture.record(0, CaptureEventType::FRAME, 1, 1, small.data(), small.size());
+    accepted += 4;
+    EXPECT_EQ(capture.drops(), 1u + 6u);
+
+    ASSERT_TRUE(capture.start());
+    capture.stop();
+    const auto events = read_all(path);
+    ASSERT_EQ(events.size(), accepted);
+    for (const auto& event : events) EXPECT_EQ(event.bytes, small);
+    std::remove(path.c_str());
+}
+
+TEST(SessionCaptureTest, TruncatedLastEventIsReported) {
+    const std::string path = "/tmp/rtes_capture_truncated.cap";
+    const auto frame = pattern(500, 6);
+    {
+        SessionCapture capture(path, 1);
+        ASSERT_TRUE(capture.start());
+        capture.record(0, CaptureEventType::FRAME, 1, 1, frame.data(), frame.size());
+        capture.record(0, CaptureEventType::FRAME, 1, 1, frame.data(), frame.size());
+        capture.stop();
+    }
+    bool truncated = true;
+    ASSERT_TRUE(read_session_capture(path, [](const auto&, const auto*) {}, nullptr, &truncated));
+    EXPECT_FALSE(truncated);
+
+    std::FILE* file = std::fopen(path.c_str(), "rb+");
+    ASSERT_NE(file, nullptr);
+    std::fseek(file, 0, SEEK_END);
+    ASSERT_EQ(ftruncate(fileno(file), std::ftell(file) - 100), 0);  // The writer died mid-frame
+    std::fclose(file);
+
+    size_t events = 0;
+    ASSERT_TRUE(read_session_capture(path, [&](const CaptureEventHeader& header, const uint8_t* data) {
+        EXPECT_EQ(std::vector<uint8_t>(data, data + header.length), frame);
+        ++events;
+    }, nullptr, &truncated));
+    EXPECT_EQ(events, 1u);
+    EXPECT_TRUE(truncated);
+    std::remove(path.c_str());
+}
+
+TEST(SessionCaptureTest, MissingOrForeignFileIsRejected) {
+    EXPECT_FALSE(read_session_capture("/tmp/rtes_capture_missing.cap", [](const auto&, const auto*) {}));
+    const std::string path = "/tmp/rtes_capture_foreign.cap";
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    std::fputs("not a capture file at all, just text", file);
+    std::fclose(file);
+    EXPECT_FALSE(read_session_capture(path, [](const auto&, const auto*) {}));
+    std::remove(path.c_str());
+}
+
+TEST(SessionCaptureTest, GatewayCapturesEveryInboundFrameAndTheDisconnect) {
+    constexpr uint16_t port = 18900;
+    const std::string path = "/tmp/rtes_capture_gateway.cap";
+    RiskConfig risk_config;
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}};
+    OrderPool pool(100);
+    RiskManager risk(risk_config, symbols);
+
+    SessionCapture capture(path, 1);
+    ASSERT_TRUE(capture.start());
+    TcpGateway gateway(port, &risk, &pool);
+    gateway.set_session_capture(&capture);
+    gateway.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const int sock = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+
+    std::vector<NewOrderMessage> orders(3);
+    for (size_t i = 0; i < orders.size(); ++i) {
+        orders[i].header = MessageHeader(NEW_ORDER, sizeof(NewOrderMessage), i + 1, 0);
+        orders[i].order_id = i + 1;
+        orders[i].client_id = "100";
+        orders[i].symbol = "AAPL";
+        orders[i].quantity = 100;
+        orders[i].price = 15000;
+    }
+    // Two frames in one segment, one split across two
+    ASSERT_EQ(send(sock, orders.data(), 2 * sizeof(NewOrderMessage), 0),
+              static_cast<ssize_t>(2 * sizeof(NewOrderMessage)));
+    const auto* third = reinterpret_cast<const uint8_t*>(&orders[2]);
+    ASSERT_EQ(send(sock, third, 10, 0), 10);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_EQ(send(sock, third + 10, sizeof(NewOrderMessage) - 10, 0),
+              static_cast<ssize_t>(sizeof(NewOrderMessage) - 10));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    close(sock);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    gateway.stop();
+    capture.stop();
+
+    const auto events = read_all(path);
+    ASSERT_EQ(events.size(), 4u);
+    for (size_t i = 0; i < 3; ++i) {
+        ASSERT_EQ(events[i].header.type, CaptureEventType::FRAME);
+        ASSERT_EQ(events[i].bytes.size(), sizeof(NewOrderMessage));
+        EXPECT_EQ(std::memcmp(events[i].bytes.data(), &orders[i], sizeof(NewOrderMessage)), 0);
+        EXPECT_EQ(events[i].header.connection, events[3].header.connection);
+        EXPECT_EQ(events[i].header.generation, events[3].header.generation);
+    }
+    EXPECT_EQ(events[3].header.type, CaptureEventType::CLOSE);
+    std::remove(path.c_str());
+}
+
+} // namespace rtes
@@ -0,0 +1,312 @@
+#include <gtest/gtest.h>
+#include "rtes/shm_order_entry.hpp"
+#include "rtes/client_directory.hpp"
+#include "rtes/instrument_directory.hpp"
+#include "rtes/risk_manager.hpp"
+#include "rtes/memory_pool.hpp"
+#include "rtes/stats_region.hpp"
+#include <unistd.h>
+#include <thread>
+#include <chrono>
+
+namespace rtes {
+
+namespace {
+
+/** Next response of `client`, or one with type 0 after two seconds */
+ShmResponse next_response(ShmOrderEntryClient& client) {
+    ShmResponse response{};
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (client.poll(&response, 1) == 0) {
+        if (std::chrono::steady_clock::now() > deadline) return ShmResponse{};
+        std::this_thread::yield();
+    }
+    return response;
+}
+
+} // namespace
+
+class ShmOrderEntryTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        risk_config.max_order_size = 10000;
+        risk_config.max_notional_per_client = 1000000.0;
+        risk_config.max_orders_per_second = 1000;
+        risk_config.price_collar_enabled = false;
+        name = "rtes_test_entry_" + std::to_string(::getpid());
+    }
+
+    /** Engine, risk and a gateway of `slots` slots, all running */
+    void start(size_t slots, bool cancel_on_disconnect = false) {
+        engine = std::make_unique<MatchingEngine>("AAPL", pool);
+        risk   = std::make_unique<RiskManager>(risk_config, symbols);
+        risk->add_matching_engine("AAPL", engine.get());
+        engine->set_execution_queue(&engine_reports);
+        engine->set_stats_block(stats->add("AAPL", StatsKind::ENGINE));
+        risk->set_execution_queue(&risk_reports);
+        risk->set_client_directory(&clients);
+
+        gateway = std::make_unique<ShmGateway>(name, slots, risk.get(), &pool, GatewayReactor{0});
+        gateway->set_client_directory(&clients);
+        gateway->set_instrument_directory(&instruments);
+        gateway->set_execution_queues({&engine_reports, &risk_reports});
+        gateway->set_cancel_on_disconnect(cancel_on_disconnect);
+        gateway->set_session_auth(session_auth);
+        gateway->set_drop_copy(drop_copy);
+        engine->start();
+        risk->start();
+        gateway->start();
+    }
+
+    void TearDown() override {
+        if (gateway) gateway->stop();
+        if (risk) risk->stop();
+        if (engine) engine->stop();
+    }
+
+    RiskConfig risk_config;
+    std::vector<SymbolConfig> symbols = {{"MSFT", 0.01, 1, 10.0}, {"AAPL", 0.01, 1, 10.0}};
+    OrderPool pool{100};
+    InstrumentDirectory instruments{symbols};
+    ClientDirectory clients{16};
+    SPSCQueue<ExecutionReport> engine_reports{256};
+    SPSCQueue<ExecutionReport> risk_reports{256};
+    std::unique_ptr<StatsRegion> stats = StatsRegion::create(1);
+    std::unique_ptr<MatchingEngine> engine;
+    std::unique_ptr<RiskManager> risk;
+    std::unique_ptr<ShmGateway> gateway;
+    SessionAuthCache* session_auth{nullptr};
+    DropCopyServer* drop_copy{nullptr};
+    std::string name;
+};
+
+TEST_F(ShmOrderEntryTest, StrategiesTradeThroughTheirSlots) {
+    start(4);
+    auto seller = ShmOrderEntryClient::attach(name, ClientID("100"));
+    auto buyer  = ShmOrderEntryClient::attach(name, ClientID("101"));
+    ASSERT_NE(seller, nullptr);
+    ASSERT_NE(buyer, nullptr);
+    EXPECT_NE(seller->slot(), buyer->slot());
+    EXPECT_TRUE(seller->gateway_running());
+    // No shared region to map: each session is an object handed to its strategy alone
+    EXPECT_NE(::access(("/dev/shm/" + name).c_str(), F_OK), 0);
+
+    // Refused by the gateway itself: acked with the BATCH reason
+    ASSERT_TRUE(seller->new_order(7, 42, Side::SELL, OrderType::LIMIT, 100, 15000));
+    ShmResponse response = next_response(*seller);
+    EXPECT_EQ(response.type, SHM_ACK);
+    EXPECT_EQ(response.order_id, 7u);
+    EXPECT_EQ(response.reason, BATCH_UNKNOWN_INSTRUMENT);
+    ASSERT_TRUE(seller->new_order(8, 1, Side::SELL, OrderType::LIMIT, 0, 15000));
+    response = next_response(*seller);
+    EXPECT_EQ(response.order_id, 8u);
+    EXPECT_EQ(response.reason, BATCH_INVALID_FIELDS);
+
+    ASSERT_TRUE(seller->new_order(1, 1, Side::SELL, OrderType::LIMIT, 100, 15000));
+    response = next_response(*seller);
+    EXPECT_EQ(response.type, SHM_ACK);
+    EXPECT_EQ(response.action, BATCH_NEW_ORDER);
+    EXPECT_EQ(response.reason, BATCH_OK);
+
+    ASSERT_TRUE(buyer->new_order(2, 1, Side::BUY, OrderType::LIMIT, 60, 15000));
+    EXPECT_EQ(next_response(*buyer).reason, BATCH_OK);
+
+    // Each side hears of the fill as its own order
+    response = next_response(*buyer);
+    ASSERT_EQ(response.type, SHM_FILL);
+    EXPECT_EQ(response.order_id, 2u);
+    EXPECT_EQ(response.side, static_cast<uint8_t>(Side::BUY));
+    EXPECT_EQ(response.quantity, 60u);
+    EXPECT_EQ(response.price, 15000u);
+    response = next_response(*buyer);
+    ASSERT_EQ(response.type, SHM_DONE);
+    EXPECT_EQ(response.status, static_cast<uint8_t>(OrderStatus::FILLED));
+    EXPECT_EQ(response.quantity, 60u);
+
+    response = next_response(*seller);
+    ASSERT_EQ(response.type, SHM_FILL);
+    EXPECT_EQ(response.order_id, 1u);
+    EXPECT_EQ(response.side, static_cast<uint8_t>(Side::SELL));
+
+    // Cancel by id alone: the owner is the slot's client
+    ASSERT_TRUE(seller->cancel(1));
+    response = next_response(*seller);
+    EXPECT_EQ(response.type, SHM_ACK);
+    EXPECT_EQ(response.action, BATCH_CANCEL_ORDER);
+    response = next_response(*seller);
+    ASSERT_EQ(response.type, SHM_DONE);
+    EXPECT_EQ(response.order_id, 1u);
+    EXPECT_EQ(response.status, static_cast<uint8_t>(OrderStatus::CANCELLED));
+    EXPECT_EQ(response.quantity, 60u);
+}
+
+TEST_F(ShmOrderEntryTest, DetachFreesTheSlotAndCancelsItsOrders) {
+    start(1, true);
+    auto first = ShmOrderEntryClient::attach(name, ClientID("100"));
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(ShmOrderEntryClient::attach(name, ClientID("101")), nullptr);  // Every slot taken
+
+    ASSERT_TRUE(first->new_order(1, 1, Side::SELL, OrderType::LIMIT, 100, 15000));
+    ASSERT_EQ(next_response(*first).reason, BATCH_OK);
+    first.reset();
+
+    // The gateway frees the slot once it has drained the detached session
+    std::unique_ptr<ShmOrderEntryClient> second;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (!(second = ShmOrderEntryClient::attach(name, ClientID("101"))) &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+    ASSERT_NE(second, nullptr);
+
+    ASSERT_TRUE(second->new_order(2, 1, Side::BUY, OrderType::LIMIT, 10, 14000));
+    EXPECT_EQ(next_response(*second).reason, BATCH_OK);
+
+    // The detached client's resting order was cancelled for it
+    uint64_t cancelled = 0;
+    while (cancelled == 0 && std::chrono::steady_clock::now() < deadline + std::chrono::seconds(2)) {
+        cancelled = stats->snapshot()[0].counters.values[ENGINE_CANCELS_ACCEPTED];
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(cancelled, 1u);
+
+    gateway->stop();
+    EXPECT_FALSE(second->gateway_running());
+    EXPECT_EQ(gateway->sessions_opened(), 2u);
+    EXPECT_EQ(ShmOrderEntryClient::attach(name, ClientID("102")), nullptr);  // No one listens
+}
+
+TEST_F(ShmOrderEntryTest, ReportsAreCopiedToDropCopyUnderEachSidesFirm) {
+    DropCopyServer server(0, 1, &clients, 64);  // Not started: the test drains its queue
+    drop_copy = &server;
+    start(2);
+    auto seller = ShmOrderEntryClient::attach(name, ClientID("100"));
+    auto buyer  = ShmOrderEntryClient::attach(name, ClientID("101"));
+    ASSERT_NE(seller, nullptr);
+    ASSERT_NE(buyer, nullptr);
+
+    ASSERT_TRUE(seller->new_order(1, 1, Side::SELL, OrderType::LIMIT, 100, 15000));
+    ASSERT_EQ(next_response(*seller).reason, BATCH_OK);
+    ASSERT_TRUE(buyer->new_order(2, 1, Side::BUY, OrderType::LIMIT, 60, 15000));
+    ASSERT_EQ(next_response(*buyer).reason, BATCH_OK);
+    ASSERT_TRUE(buyer->new_order(3, 1, Side::BUY, OrderType::LIMIT, 20000, 15000));  // Over max_order_size
+    ASSERT_EQ(next_response(*buyer).reason, BATCH_OK);
+
+    std::vector<DropCopyRecord> records;
+    auto* queue = server.reactor_queue(0);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (records.size() < 4 && std::chrono::steady_clock::now() < deadline) {
+        DropCopyRecord record;
+        if (queue->try_pop_bulk(&record, 1) == 1) records.push_back(record);
+        else std::this_thread::yield();
+    }
+    ASSERT_EQ(records.size(), 4u);
+
+    const ClientIDRaw firm_100 = clients.resolve(ClientID("100"));
+    const ClientIDRaw firm_101 = clients.resolve(ClientID("101"));
+    EXPECT_EQ(records[0].report.type, ExecutionReport::FILL);
+    EXPECT_EQ(records[0].client, firm_101);
+    EXPECT_EQ(records[0].side, Side::BUY);
+    EXPECT_EQ(records[1].report.type, ExecutionReport::FILL);
+    EXPECT_EQ(records[1].client, firm_100);
+    EXPECT_EQ(records[1].side, Side::SELL);
+    // Engine and risk reports arrive on separate queues: either order
+    const bool done_first = records[2].report.type == ExecutionReport::DONE;
+    const DropCopyRecord& done   = records[done_first ? 2 : 3];
+    const DropCopyRecord& reject = records[done_first ? 3 : 2];
+    EXPECT_EQ(done.report.type, ExecutionReport::DONE);
+    EXPECT_EQ(done.report.order.order_id, 2u);
+    EXPECT_EQ(done.client, firm_101);
+    EXPECT_EQ(reject.report.type, ExecutionReport::REJECTED);
+    EXPECT_EQ(reject.report.order.order_id, 3u);
+    EXPECT_EQ(reject.client, firm_101);
+
+    gateway->stop();
+    EXPECT_EQ(gateway->drop_copy_overflows(), 0u);
+}
+
+TEST_F(ShmOrderEntryTest, FullResponseRingClosesTheSessionAndCancelsItsOrders) {
+    start(2, true);
+    auto slow  = ShmOrderEntryClient::attach(name, ClientID("100"));
+    auto other = ShmOrderEntryClient::attach(name, ClientID("101"));
+    ASSERT_NE(slow, nullptr);
+    ASSERT_NE(other, nullptr);
+
+    ASSERT_TRUE(slow->new_order(1, 1, Side::SELL, OrderType::LIMIT, 100, 15000));
+    ASSERT_EQ(next_response(*slow).reason, BATCH_OK);
+
+    // Never read: acks fill the response ring, then the request ring backs up
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    OrderID id = 1000;
+    while (std::chrono::steady_clock::now() < deadline) {
+        if (!slow->new_order(++id, 42, Side::SELL, OrderType::LIMIT, 1, 15000)) break;
+    }
+    ASSERT_TRUE(slow->session_open());
+
+    // Its fill finds the ring full: the session closes instead of losing it
+    ASSERT_TRUE(other->new_order(2, 1, Side::BUY, OrderType::LIMIT, 10, 15000));
+    EXPECT_EQ(next_response(*other).reason, BATCH_OK);
+    while (slow->session_open() && std::chrono::steady_clock::now() < deadline + std::chrono::seconds(2)) {
+        std::this_thread::yield();
+    }
+    EXPECT_FALSE(slow->session_open());
+
+    // The other 90 were cancelled for it
+    uint64_t cancelled = 0;
+    while (cancelled == 0 && std::chrono::steady_clock::now() < deadline + std::chrono::seconds(4)) {
+        cancelled = stats->snapshot()[0].counters.values[ENGINE_CANCELS_ACCEPTED];
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(cancelled, 1u);
+
+    // The slot is free at once, for a new object: the closed strategy still
+    // reads its own unread acks, and nothing of the next session
+    auto next = ShmOrderEntryClient::attach(name, ClientID("102"));
+    ASSERT_NE(next, nullptr);
+    EXPECT_EQ(next->slot(), slow->slot());
+    ShmResponse stale{};
+    ASSERT_EQ(slow->poll(&stale, 1), 1u);
+    EXPECT_EQ(stale.type, SHM_ACK);
+    ASSERT_TRUE(next->new_order(3, 1, Side::BUY, OrderType::LIMIT, 10, 14000));
+    EXPECT_EQ(next_response(*next).order_id, 3u);
+    slow.reset();
+
+    gateway->stop();
+    EXPECT_EQ(gateway->slow_consumers(), 1u);
+}
+
+TEST_F(ShmOrderEntryTest, SessionAuthChecksTheTokenAtAttachAndTheGrantPerRequest) {
+    setenv("RTES_AUTH_MODE", "development", 1);
+    SessionAuthCache auth(2);
+    session_auth = &auth;
+    start(2);
+
+    const std::string alice = "dev_trader_alice000000000000000000";
+    EXPECT_EQ(ShmOrderEntryClient::attach(name, ClientID("alice00000000000")), nullptr);
+    EXPECT_EQ(ShmOrderEntryClient::attach(name, ClientID("alice00000000000"), "dev_trader_short"), nullptr);
+    // A token trades only as its own user
+    EXPECT_EQ(ShmOrderEntryClient::attach(name, ClientID("100"), alice), nullptr);
+
+    // Refused logons take no slot: both are still there
+    auto entry = ShmOrderEntryClient::attach(name, ClientID("alice00000000000"), alice);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(auth.active(), 1u);
+
+    ASSERT_TRUE(entry->new_order(1, 1, Side::SELL, OrderType::LIMIT, 100, 15000));
+    EXPECT_EQ(next_response(*entry).reason, BATCH_OK);
+
+    // Revoked from another thread: the next request sees the new epoch
+    EXPECT_EQ(auth.revoke_user("alice00000000000"), 1u);
+    ASSERT_TRUE(entry->new_order(2, 1, Side::SELL, OrderType::LIMIT, 100, 15000));
+    const ShmResponse refused = next_response(*entry);
+    EXPECT_EQ(refused.type, SHM_ACK);
+    EXPECT_EQ(refused.reason, BATCH_NOT_PERMITTED);
+    EXPECT_EQ(refused.status, static_cast<uint8_t>(OrderStatus::REJECTED));
+
+    gateway->stop();
+    EXPECT_EQ(auth.active(), 0u);  // Released at stop
+    EXPECT_EQ(gateway->auth_rejects(), 4u);
+    unsetenv("RTES_AUTH_MODE");
+}
+
+} // namespace rtes
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "rtes/snapshot_publisher.hpp"
+#include "rtes/memory_pool.hpp"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+namespace rtes {
+
+TEST(SnapshotPublisherTest, SendsPublishedDepthTaggedWithTheBookUpdate) {
+    constexpr uint16_t port = 19992;
+    int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(receiver, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(bind(receiver, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    timeval timeout{1, 0};
+    setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    OrderPool pool(100);
+    MarketDataLane market_data(1000);
+    MatchingEngine engine("shard-0", {{"AAPL", {}}, {"MSFT", {}}}, pool);
+    engine.set_market_data_queue(&market_data);
+    DepthPublishPolicy policy;
+    policy.every_events = 1;
+    policy.incremental = true;
+    engine.set_depth_publishing(policy);
+
+    // Three book updates on AAPL; MSFT never changes and has no depth
+    Order* orders[3];
+    for (auto*& order : orders) order = pool.allocate();
+    new (orders[0]) Order(1, "100", "AAPL", Side::BUY, OrderType::LIMIT, 100, 14900);
+    new (orders[1]) Order(2, "100", "AAPL", Side::SELL, OrderType::LIMIT, 100, 15100);
+    new (orders[2]) Order(3, "101", "AAPL", Side::BUY, OrderType::LIMIT, 30, 15100);
+    engine.start();
+    for (auto* order : orders) EXPECT_TRUE(engine.submit_order(order, 0));
+    engine.stop();
+
+    uint64_t last_update = 0;
+    MarketDataEvent event;
+    while (market_data.pop(event)) {
+        if (event.type != MarketDataEvent::DEPTH_LEVEL) continue;
+        EXPECT_GE(event.level.update_sequence, last_update);
+        last_update = event.level.update_sequence;
+    }
+    EXPECT_EQ(last_update, 3u);
+
+    SnapshotPublisher snapshots("127.0.0.1", port,
+                                {{&engine, 0, Symbol("AAPL"), 2}, {&engine, 1, Symbol("MSFT"), 0}});
+    snapshots.start();
+
+    uint8_t buffer[MD_MAX_DATAGRAM];
+    const ssize_t received = recv(receiver, buffer, sizeof(buffer), 0);
+    ASSERT_EQ(received, static_cast<ssize_t>(sizeof(UdpPacketHeader) + sizeof(DepthSnapshotMessage)));
+    snapshots.stop();
+    close(receiver);
+
+    UdpPacketHeader packet;
+    std::memcpy(&packet, buffer, sizeof(packet));
+    EXPECT_EQ(packet.sequence, 1u);
+    EXPECT_EQ(packet.message_count, 1u);
+    DepthSnapshotMessage msg;
+    std::memcpy(&msg, buffer + sizeof(packet), sizeof(msg));
+    EXPECT_EQ(msg.header.type, DEPTH_SNAPSHOT);
+    EXPECT_STREQ(msg.symbol, "AAPL");
+    EXPECT_EQ(msg.update_sequence, last_update);
+    EXPECT_EQ(msg.book_index, 0u);
+    EXPECT_EQ(msg.book_count, 2u);
+    EXPECT_EQ(msg.channel, 2);
+    ASSERT_EQ(msg.num_bid_levels, 1);
+    ASSERT_EQ(msg.num_ask_levels, 1);
+    EXPECT_EQ(msg.levels[0].price, 14900u);
+    EXPECT_EQ(msg.levels[0].quantity, 100u);
+    EXPECT_EQ(msg.levels[1].price, 15100u);
+    EXPECT_EQ(msg.levels[1].quantity, 70u);  // After the 30 lot traded
+
+    EXPECT_EQ(snapshots.snapshots_sent(), 1u);
+    EXPECT_EQ(snapshots.books_skipped(), 1u);
+}
+
+} // namespace rtes
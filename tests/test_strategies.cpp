@@ -2,6 +2,8 @@
 #include "rtes/strategies.hpp"
 #include <thread>
 #include <chrono>
+#include <cstddef>
+#include <cstring>
 
 namespace rtes {
 
@@ -81,6 +83,38 @@ TEST_F(StrategiesTest, ClientBaseUtilities) {
     EXPECT_GT(id2, id1);
 }
 
+TEST_F(StrategiesTest, ReceiveBytesDecodesAcksFieldByField) {
+    class TestClient : public ClientBase {
+    public:
+        TestClient() : ClientBase("localhost", 8888, 999) {}
+        void on_tick() override {}
+        void on_order_ack(const OrderAckMessage& ack) override {
+            order_id = ack.order_id;
+            reason   = ack.reason.to_string();
+        }
+        uint64_t    order_id{0};
+        std::string reason;
+    };
+
+    // As the gateway sends it; garbage after the reason's NUL, its
+    // stored length included, must not reach the decoded string
+    std::vector<std::byte> wire(sizeof(OrderAckMessage), std::byte{0xff});
+    const MessageHeader header(ORDER_ACK, sizeof(OrderAckMessage), 1, 0);
+    const uint64_t order_id = 42;
+    const uint8_t  status   = 1;
+    std::memcpy(wire.data(), &header, sizeof(header));
+    std::memcpy(wire.data() + offsetof(OrderAckMessage, order_id), &order_id, sizeof(order_id));
+    std::memcpy(wire.data() + offsetof(OrderAckMessage, status), &status, sizeof(status));
+    std::memcpy(wire.data() + offsetof(OrderAckMessage, reason), "OK", 3);
+
+    TestClient client;
+    client.receive_bytes(wire.data(), 10);  // Split across reads
+    client.receive_bytes(wire.data() + 10, wire.size() - 10);
+    EXPECT_EQ(client.orders_acked(), 1u);
+    EXPECT_EQ(client.order_id, 42u);
+    EXPECT_EQ(client.reason, "OK");
+}
+
 // Integration test that would require a running exchange
 TEST_F(StrategiesTest, DISABLED_IntegrationTest) {
     // This test is disabled by default as it requires a running exchange
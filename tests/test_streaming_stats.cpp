@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include "rtes/streaming_stats.hpp"
+
+#include <cmath>
+#include <vector>
+
+namespace rtes {
+
+TEST(StreamingStatsTest, WelfordMatchesTwoPassStatistics) {
+    const std::vector<double> values{100.0, 101.5, 99.0, 250.0, 98.25, 100.75, 1e-3, 103.0};
+    StreamingStats stats;
+    for (double v : values) stats.observe(v);
+
+    double mean = 0.0;
+    for (double v : values) mean += v;
+    mean /= static_cast<double>(values.size());
+    double variance = 0.0;
+    for (double v : values) variance += (v - mean) * (v - mean);
+    variance /= static_cast<double>(values.size());
+
+    EXPECT_EQ(stats.count(), values.size());
+    EXPECT_NEAR(stats.mean(), mean, 1e-9);
+    EXPECT_NEAR(stats.variance(), variance, 1e-6);
+    EXPECT_NEAR(stats.std_dev(), std::sqrt(variance), 1e-9);
+}
+
+TEST(StreamingStatsTest, WindowedStatsFollowALevelShift) {
+    StreamingStats stats(20);
+    for (int i = 0; i < 20; ++i) stats.observe(10.0 + (i % 2));  // Exact: mean 10.5, sd 0.5
+    EXPECT_NEAR(stats.mean(), 10.5, 1e-9);
+    EXPECT_NEAR(stats.std_dev(), 0.5, 1e-9);
+
+    // Past the window the EWMA forgets: after ~5 windows the old level is gone
+    for (int i = 0; i < 100; ++i) stats.observe(50.0);
+    EXPECT_NEAR(stats.mean(), 50.0, 0.01);
+    EXPECT_LT(stats.std_dev(), 0.5);
+
+    stats.set_window(0);
+    EXPECT_EQ(stats.count(), 0u);
+    EXPECT_EQ(stats.mean(), 0.0);
+}
+
+} // namespace rtes
@@ -250,4 +250,960 @@ TEST_F(TcpGatewayTest, MultipleClients) {
     }
 }
 
-} // namespace rtes
\ No newline at end of file
+TEST(TcpGatewayExecutionTest, RoutesFillsAndDoneToOwningSessions) {
+    constexpr uint16_t port = 18889;
+    RiskConfig risk_config;
+    risk_config.max_order_size = 10000;
+    risk_config.max_notional_per_client = 1000000.0;
+    risk_config.max_orders_per_second = 1000;
+    risk_config.price_collar_enabled = false;
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}};
+
+    OrderPool pool(100);
+    MatchingEngine engine("AAPL", pool);
+    RiskManager risk(risk_config, symbols);
+    risk.add_matching_engine("AAPL", &engine);
+
+    EventDoorbell doorbell;
+    SPSCQueue<ExecutionReport> engine_reports(256);
+    SPSCQueue<ExecutionReport> risk_reports(256);
+    engine.set_execution_queue(&engine_reports, &doorbell);
+    risk.set_execution_queue(&risk_reports, &doorbell);
+
+    TcpGateway gateway(port, &risk, &pool);
+    gateway.set_execution_queues({&engine_reports, &risk_reports}, &doorbell);
+    engine.start();
+    risk.start();
+    gateway.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    auto connect_client = [&] {
+        int sock = socket(AF_INET, SOCK_STREAM, 0);
+        timeval timeout{2, 0};
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        EXPECT_EQ(connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        return sock;
+    };
+    auto send_order = [](int sock, uint64_t id, const char* client, Side side, uint64_t qty) {
+        NewOrderMessage msg;
+        msg.header = MessageHeader(NEW_ORDER, sizeof(NewOrderMessage), id,
+                                   ProtocolUtils::get_timestamp_ns());
+        msg.order_id = id;
+        msg.client_id = client;
+        msg.symbol = "AAPL";
+        msg.side = static_cast<uint8_t>(side);
+        msg.quantity = qty;
+        msg.price = 15000;
+        msg.order_type = static_cast<uint8_t>(OrderType::LIMIT);
+        ASSERT_EQ(send(sock, &msg, sizeof(msg), 0), static_cast<ssize_t>(sizeof(msg)));
+    };
+    auto recv_exact = [](int sock, void* buffer, size_t size) {
+        size_t total = 0;
+        while (total < size) {
+            ssize_t n = recv(sock, static_cast<char*>(buffer) + total, size - total, 0);
+            if (n <= 0) return false;
+            total += static_cast<size_t>(n);
+        }
+        return true;
+    };
+
+    const int seller = connect_client();
+    const int buyer  = connect_client();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    OrderAckMessage ack;
+    send_order(seller, 1, "100", Side::SELL, 100);
+    ASSERT_TRUE(recv_exact(seller, &ack, sizeof(ack)));
+    EXPECT_EQ(ack.status, 1);  // Received
+    send_order(buyer, 2, "101", Side::BUY, 100);
+    ASSERT_TRUE(recv_exact(buyer, &ack, sizeof(ack)));
+    EXPECT_EQ(ack.status, 1);
+
+    // Each side gets the trade, then its own Filled — nothing else
+    for (int sock : {seller, buyer}) {
+        TradeMessage trade;
+        ASSERT_TRUE(recv_exact(sock, &trade, sizeof(trade)));
+        EXPECT_EQ(trade.header.type, TRADE_REPORT);
+        EXPECT_EQ(trade.buy_order_id, 2u);
+        EXPECT_EQ(trade.sell_order_id, 1u);
+        EXPECT_EQ(trade.quantity, 100u);
+
+        ASSERT_TRUE(recv_exact(sock, &ack, sizeof(ack)));
+        EXPECT_EQ(ack.header.type, ORDER_ACK);
+        EXPECT_EQ(ack.order_id, sock == seller ? 1u : 2u);
+        EXPECT_EQ(ack.status, 4);  // Filled
+    }
+
+    // Unknown symbol: rejected by risk, reason text from ErrorCode
+    NewOrderMessage bad;
+    bad.header = MessageHeader(NEW_ORDER, sizeof(NewOrderMessage), 3,
+                               ProtocolUtils::get_timestamp_ns());
+    bad.order_id = 3;
+    bad.client_id = "101";
+    bad.symbol = "MSFT";
+    bad.side = static_cast<uint8_t>(Side::BUY);
+    bad.quantity = 10;
+    bad.price = 15000;
+    bad.order_type = static_cast<uint8_t>(OrderType::LIMIT);
+    ASSERT_EQ(send(buyer, &bad, sizeof(bad), 0), static_cast<ssize_t>(sizeof(bad)));
+    ASSERT_TRUE(recv_exact(buyer, &ack, sizeof(ack)));
+    EXPECT_EQ(ack.status, 1);
+    ASSERT_TRUE(recv_exact(buyer, &ack, sizeof(ack)));
+    EXPECT_EQ(ack.order_id, 3u);
+    EXPECT_EQ(ack.status, 2);
+    EXPECT_STREQ(ack.reason.c_str(), "Invalid order");
+
+    close(seller);
+    close(buyer);
+    gateway.stop();
+    risk.stop();
+    engine.stop();
+}
+
+TEST(TcpGatewayExecutionTest, ReactorsRouteReportsToTheirOwnSessions) {
+    constexpr uint16_t port = 18890;
+    constexpr size_t reactors = 2;
+    RiskConfig risk_config;
+    risk_config.max_order_size = 10000;
+    risk_config.max_notional_per_client = 1000000.0;
+    risk_config.max_orders_per_second = 1000;
+    risk_config.price_collar_enabled = false;
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}};
+
+    OrderPool pool(100);
+    MatchingEngine engine("AAPL", pool);
+    RiskManager risk(risk_config, symbols, 100, reactors);  // One ingress lane per reactor
+    risk.add_matching_engine("AAPL", &engine);
+
+    // Each producer gets one queue per reactor
+    std::vector<std::unique_ptr<EventDoorbell>> doorbells;
+    std::vector<std::unique_ptr<SPSCQueue<ExecutionReport>>> queues;
+    std::vector<EventDoorbell*> bells;
+    std::vector<SPSCQueue<ExecutionReport>*> engine_queues, risk_queues;
+    for (size_t r = 0; r < reactors; ++r) {
+        doorbells.push_back(std::make_unique<EventDoorbell>());
+        bells.push_back(doorbells.back().get());
+        for (auto* producer : {&engine_queues, &risk_queues}) {
+            queues.push_back(std::make_unique<SPSCQueue<ExecutionReport>>(256));
+            producer->push_back(queues.back().get());
+        }
+    }
+    engine.set_execution_queues(engine_queues, bells);
+    risk.set_execution_queues(risk_queues, bells);
+
+    TcpGateway gateway(port, &risk, &pool, reactors);
+    ASSERT_EQ(gateway.reactor_count(), reactors);
+    for (size_t r = 0; r < reactors; ++r) {
+        gateway.set_execution_queues({engine_queues[r], risk_queues[r]}, bells[r], r);
+    }
+    engine.start();
+    risk.start();
+    gateway.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    auto connect_client = [&] {
+        int sock = socket(AF_INET, SOCK_STREAM, 0);
+        timeval timeout{2, 0};
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        EXPECT_EQ(connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        return sock;
+    };
+    auto send_order = [](int sock, uint64_t id, const char* client, Side side) {
+        NewOrderMessage msg;
+        msg.header = MessageHeader(NEW_ORDER, sizeof(NewOrderMessage), id,
+                                   ProtocolUtils::get_timestamp_ns());
+        msg.order_id = id;
+        msg.client_id = client;
+        msg.symbol = "AAPL";
+        msg.side = static_cast<uint8_t>(side);
+        msg.quantity = 10;
+        msg.price = 15000;
+        msg.order_type = static_cast<uint8_t>(OrderType::LIMIT);
+        ASSERT_EQ(send(sock, &msg, sizeof(msg), 0), static_cast<ssize_t>(sizeof(msg)));
+    };
+    auto recv_exact = [](int sock, void* buffer, size_t size) {
+        size_t total = 0;
+        while (total < size) {
+            ssize_t n = recv(sock, static_cast<char*>(buffer) + total, size - total, 0);
+            if (n <= 0) return false;
+            total += static_cast<size_t>(n);
+        }
+        return true;
+    };
+
+    // Whichever reactors the kernel picks, every side hears only its own reports
+    std::vector<int> socks;
+    for (int i = 0; i < 4; ++i) socks.push_back(connect_client());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    for (uint64_t pair = 0; pair < 2; ++pair) {
+        const int seller = socks[pair * 2];
+        const int buyer  = socks[pair * 2 + 1];
+        const uint64_t sell_id = 10 + pair * 2;
+        const uint64_t buy_id  = sell_id + 1;
+
+        OrderAckMessage ack;
+        send_order(seller, sell_id, pair == 0 ? "100" : "102", Side::SELL);
+        ASSERT_TRUE(recv_exact(seller, &ack, sizeof(ack)));
+        EXPECT_EQ(ack.status, 1);
+        send_order(buyer, buy_id, pair == 0 ? "101" : "103", Side::BUY);
+        ASSERT_TRUE(recv_exact(buyer, &ack, sizeof(ack)));
+        EXPECT_EQ(ack.status, 1);
+
+        for (int sock : {seller, buyer}) {
+            TradeMessage trade;
+            ASSERT_TRUE(recv_exact(sock, &trade, sizeof(trade)));
+            EXPECT_EQ(trade.header.type, TRADE_REPORT);
+            EXPECT_EQ(trade.buy_order_id, buy_id);
+            EXPECT_EQ(trade.sell_order_id, sell_id);
+
+            ASSERT_TRUE(recv_exact(sock, &ack, sizeof(ack)));
+            EXPECT_EQ(ack.order_id, sock == seller ? sell_id : buy_id);
+            EXPECT_EQ(ack.status, 4);  // Filled
+        }
+    }
+
+    for (int sock : socks) close(sock);
+    gateway.stop();
+    risk.stop();
+    engine.stop();
+    EXPECT_EQ(gateway.connections_accepted(), 4u);
+}
+
+TEST(TcpGatewayExecutionTest, ConnectionStormKeepsEveryFirstMessage) {
+    constexpr uint16_t port = 18891;
+    constexpr size_t reactors = 2;
+    constexpr int clients = 32;
+    RiskConfig risk_config;
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}};
+
+    OrderPool pool(clients * 2);
+    RiskManager risk(risk_config, symbols, clients * 2, reactors);
+    TcpGateway gateway(port, &risk, &pool, reactors);
+    gateway.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // Two waves, so the second reuses the first wave's connection slots
+    for (int wave = 0; wave < 2; ++wave) {
+        std::vector<int> socks;
+        for (int i = 0; i < clients; ++i) {
+            int sock = socket(AF_INET, SOCK_STREAM, 0);
+            timeval timeout{2, 0};
+            setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            addr.sin_port = htons(port);
+            ASSERT_EQ(connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+
+            // Logon and first order written straight after connect, no pause
+            NewOrderMessage msg;
+            const uint64_t id = static_cast<uint64_t>(wave * clients + i + 1);
+            msg.header = MessageHeader(NEW_ORDER, sizeof(NewOrderMessage), id,
+                                       ProtocolUtils::get_timestamp_ns());
+            msg.order_id = id;
+            msg.client_id = "100";
+            msg.symbol = "AAPL";
+            msg.side = static_cast<uint8_t>(Side::BUY);
+            msg.quantity = 1;
+            msg.price = 15000;
+            msg.order_type = static_cast<uint8_t>(OrderType::LIMIT);
+            ASSERT_EQ(send(sock, &msg, sizeof(msg), 0), static_cast<ssize_t>(sizeof(msg)));
+            socks.push_back(sock);
+        }
+        for (int i = 0; i < clients; ++i) {
+            OrderAckMessage ack;
+            ASSERT_EQ(recv(socks[i], &ack, sizeof(ack), MSG_WAITALL),
+                      static_cast<ssize_t>(sizeof(ack))) << "client " << i;
+            EXPECT_EQ(ack.order_id, static_cast<uint64_t>(wave * clients + i + 1));
+            EXPECT_EQ(ack.status, 1);
+        }
+        for (int sock : socks) close(sock);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    gateway.stop();
+    EXPECT_EQ(gateway.connections_accepted(), 2u * clients);
+    EXPECT_EQ(gateway.messages_received(), 2u * clients);
+}
+
+TEST(TcpGatewayExecutionTest, BurstOfOrdersIsAckedWithFewWrites) {
+    constexpr uint16_t port = 18892;
+    constexpr int orders = 50;
+    RiskConfig risk_config;
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}};
+
+    OrderPool pool(orders);
+    RiskManager risk(risk_config, symbols, orders);
+    TcpGateway gateway(port, &risk, &pool);
+    gateway.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    timeval timeout{2, 0};
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+
+    // All orders in one segment
+    std::vector<NewOrderMessage> burst(orders);
+    for (int i = 0; i < orders; ++i) {
+        auto& msg = burst[i];
+        msg.header = MessageHeader(NEW_ORDER, sizeof(NewOrderMessage), i + 1,
+                                   ProtocolUtils::get_timestamp_ns());
+        msg.order_id = static_cast<uint64_t>(i + 1);
+        msg.client_id = "100";
+        msg.symbol = "AAPL";
+        msg.side = static_cast<uint8_t>(Side::BUY);
+        msg.quantity = 1;
+        msg.price = 15000;
+        msg.order_type = static_cast<uint8_t>(OrderType::LIMIT);
+    }
+    const size_t bytes = burst.size() * sizeof(NewOrderMessage);
+    ASSERT_EQ(send(sock, burst.data(), bytes, 0), static_cast<ssize_t>(bytes));
+
+    std::vector<OrderAckMessage> acks(orders);
+    ASSERT_EQ(recv(sock, acks.data(), acks.size() * sizeof(OrderAckMessage), MSG_WAITALL),
+              static_cast<ssize_t>(acks.size() * sizeof(OrderAckMessage)));
+    for (int i = 0; i < orders; ++i) {
+        EXPECT_EQ(acks[i].order_id, static_cast<uint64_t>(i + 1));
+        EXPECT_EQ(acks[i].status, 1);
+    }
+
+    close(sock);
+    gateway.stop();
+    EXPECT_EQ(gateway.messages_sent(), static_cast<uint64_t>(orders));
+    EXPECT_LT(gateway.send_calls(), static_cast<uint64_t>(orders) / 5);  // Was one per ack
+    EXPECT_EQ(gateway.slow_consumers(), 0u);
+}
+
+TEST(TcpGatewayExecutionTest, IoUringBackendRoutesFillsAndBatchesAcks) {
+    constexpr uint16_t port = 18893;
+    constexpr int burst_orders = 40;
+    RiskConfig risk_config;
+    risk_config.max_order_size = 10000;
+    risk_config.max_notional_per_client = 1000000.0;
+    risk_config.max_orders_per_second = 1000;
+    risk_config.price_collar_enabled = false;
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}};
+
+    OrderPool pool(100);
+    MatchingEngine engine("AAPL", pool);
+    RiskManager risk(risk_config, symbols);
+    risk.add_matching_engine("AAPL", &engine);
+
+    EventDoorbell doorbell;
+    SPSCQueue<ExecutionReport> engine_reports(256);
+    SPSCQueue<ExecutionReport> risk_reports(256);
+    engine.set_execution_queue(&engine_reports, &doorbell);
+    risk.set_execution_queue(&risk_reports, &doorbell);
+
+    TcpGateway gateway(port, &risk, &pool);
+    gateway.set_backend(GatewayBackend::IO_URING);
+    gateway.set_execution_queues({&engine_reports, &risk_reports}, &doorbell);
+    engine.start();
+    risk.start();
+    gateway.start();
+    if (gateway.backend() != GatewayBackend::IO_URING) {
+        gateway.stop();
+        risk.stop();
+        engine.stop();
+        GTEST_SKIP() << "io_uring not available";
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    auto connect_client = [&] {
+        int sock = socket(AF_INET, SOCK_STREAM, 0);
+        timeval timeout{2, 0};
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        EXPECT_EQ(connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        return sock;
+    };
+    auto make_order = [](uint64_t id, const char* client, Side side, uint64_t qty, Price price) {
+        NewOrderMessage msg;
+        msg.header = MessageHeader(NEW_ORDER, sizeof(NewOrderMessage), id,
+                                   ProtocolUtils::get_timestamp_ns());
+        msg.order_id = id;
+        msg.client_id = client;
+        msg.symbol = "AAPL";
+        msg.side = static_cast<uint8_t>(side);
+        msg.quantity = qty;
+        msg.price = price;
+        msg.order_type = static_cast<uint8_t>(OrderType::LIMIT);
+        return msg;
+    };
+    auto recv_exact = [](int sock, void* buffer, size_t size) {
+        return recv(sock, buffer, size, MSG_WAITALL) == static_cast<ssize_t>(size);
+    };
+
+    const int seller = connect_client();
+    const int buyer  = connect_client();
+
+    OrderAckMessage ack;
+    auto sell = make_order(1, "100", Side::SELL, 100, 15000);
+    ASSERT_EQ(send(seller, &sell, sizeof(sell), 0), static_cast<ssize_t>(sizeof(sell)));
+    ASSERT_TRUE(recv_exact(seller, &ack, sizeof(ack)));
+    EXPECT_EQ(ack.status, 1);
+    auto buy = make_order(2, "101", Side::BUY, 100, 15000);
+    ASSERT_EQ(send(buyer, &buy, sizeof(buy), 0), static_cast<ssize_t>(sizeof(buy)));
+    ASSERT_TRUE(recv_exact(buyer, &ack, sizeof(ack)));
+    EXPECT_EQ(ack.status, 1);
+
+    for (int sock : {seller, buyer}) {
+        TradeMessage trade;
+        ASSERT_TRUE(recv_exact(sock, &trade, sizeof(trade)));
+        EXPECT_EQ(trade.buy_order_id, 2u);
+        EXPECT_EQ(trade.sell_order_id, 1u);
+        ASSERT_TRUE(recv_exact(sock, &ack, sizeof(ack)));
+        EXPECT_EQ(ack.order_id, sock == seller ? 1u : 2u);
+        EXPECT_EQ(ack.status, 4);  // Filled
+    }
+
+    // Resting bids in one segment, parsed from completed recvs
+    std::vector<NewOrderMessage> burst;
+    for (int i = 0; i < burst_orders; ++i) {
+        burst.push_back(make_order(100 + i, "101", Side::BUY, 1, 14000));
+    }
+    const size_t bytes = burst.size() * sizeof(NewOrderMessage);
+    ASSERT_EQ(send(buyer, burst.data(), bytes, 0), static_cast<ssize_t>(bytes));
+    std::vector<OrderAckMessage> acks(burst_orders);
+    ASSERT_TRUE(recv_exact(buyer, acks.data(), acks.size() * sizeof(OrderAckMessage)));
+    for (int i = 0; i < burst_orders; ++i) {
+        EXPECT_EQ(acks[i].order_id, static_cast<uint64_t>(100 + i));
+        EXPECT_EQ(acks[i].status, 1);
+    }
+
+    // The buyer stays connected: stop() cancels its armed recv before freeing its buffer
+    close(seller);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const auto stopping = std::chrono::steady_clock::now();
+    gateway.stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - stopping, std::chrono::milliseconds(500));
+    char eof;
+    EXPECT_EQ(recv(buyer, &eof, 1, 0), 0);
+    close(buyer);
+    risk.stop();
+    engine.stop();
+    EXPECT_EQ(gateway.connections_accepted(), 2u);
+    EXPECT_LT(gateway.send_calls(), static_cast<uint64_t>(burst_orders) / 4);
+}
+
+TEST(TcpGatewayExecutionTest, ProtocolV2OrdersUseSessionIdentityAndInstrumentIds) {
+    constexpr uint16_t port = 18894;
+    RiskConfig risk_config;
+    risk_config.max_order_size = 10000;
+    risk_config.max_notional_per_client = 1000000.0;
+    risk_config.max_orders_per_second = 1000;
+    risk_config.price_collar_enabled = false;
+    std::vector<SymbolConfig> symbols = {{"MSFT", 0.01, 1, 10.0}, {"AAPL", 0.01, 1, 10.0}};
+
+    OrderPool pool(100);
+    MatchingEngine engine("AAPL", pool);
+    RiskManager risk(risk_config, symbols);
+    risk.add_matching_engine("AAPL", &engine);
+    InstrumentDirectory instruments(symbols);
+    ClientDirectory clients(16);
+
+    EventDoorbell doorbell;
+    SPSCQueue<ExecutionReport> engine_reports(256);
+    SPSCQueue<ExecutionReport> risk_reports(256);
+    engine.set_execution_queue(&engine_reports, &doorbell);
+    risk.set_execution_queue(&risk_reports, &doorbell);
+    risk.set_client_directory(&clients);
+
+    TcpGateway gateway(port, &risk, &pool);
+    gateway.set_client_directory(&clients);
+    gateway.set_instrument_directory(&instruments);
+    gateway.set_execution_queues({&engine_reports, &risk_reports}, &doorbell);
+    engine.start();
+    risk.start();
+    gateway.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    auto connect_client = [&] {
+        int sock = socket(AF_INET, SOCK_STREAM, 0);
+        timeval timeout{2, 0};
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port);
+        EXPECT_EQ(connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        return sock;
+    };
+    auto make_logon = [](const char* client, uint8_t version) {
+        LogonMessage msg;
+        msg.header = MessageHeader(LOGON, sizeof(LogonMessage), 0, ProtocolUtils::get_timestamp_ns());
+        msg.client_id = client;
+        msg.protocol_version = version;
+        return msg;
+    };
+    auto make_order = [](uint64_t id, InstrumentID instrument, Side side, uint32_t qty) {
+        NewOrderV2 msg{};
+        msg.header     = {sizeof(NewOrderV2), NEW_ORDER};
+        msg.order_id   = id;
+        msg.instrument = instrument;
+        msg.side       = static_cast<uint8_t>(side);
+        msg.order_type = static_cast<uint8_t>(OrderType::LIMIT);
+        msg.quantity   = qty;
+        msg.price      = 15000;
+        return msg;
+    };
+    auto recv_exact = [](int sock, void* buffer, size_t size) {
+        return recv(sock, buffer, size, MSG_WAITALL) == static_cast<ssize_t>(size);
+    };
+
+    EXPECT_EQ(instruments.find(Symbol("AAPL")), 1);
+    EXPECT_LT(sizeof(NewOrderV2) * 2, sizeof(NewOrderMessage));
+
+    const int seller = connect_client();
+    const int buyer  = connect_client();
+    OrderAckMessage ack;
+
+    // Unsupported version: refused, the session stays on v1
+    auto bad_logon = make_logon("100", 9);
+    ASSERT_EQ(send(seller, &bad_logon, sizeof(bad_logon), 0), static_cast<ssize_t>(sizeof(bad_logon)));
+    ASSERT_TRUE(recv_exact(seller, &ack, sizeof(ack)));
+    EXPECT_EQ(ack.status, 2);
+    EXPECT_STREQ(ack.reason.c_str(), "Unsupported protocol version");
+
+    // Logon and two v2 orders in one segment: the switch applies mid-buffer
+    struct {
+        LogonMessage logon;
+        NewOrderV2   unknown;
+        NewOrderV2   sell;
+    } segment{make_logon("100", PROTOCOL_V2),
+              make_order(7, 42, Side::SELL, 100),
+              make_order(1, 1, Side::SELL, 100)};
+    static_assert(sizeof(segment) == sizeof(LogonMessage) + 2 * sizeof(NewOrderV2), "Messages back to back");
+    ASSERT_EQ(send(seller, &segment, sizeof(segment), 0), static_cast<ssize_t>(sizeof(segment)));
+    OrderAckMessage acks[3];
+    ASSERT_TRUE(recv_exact(seller, acks, sizeof(acks)));
+    EXPECT_EQ(acks[0].order_id, 0u);
+    EXPECT_STREQ(acks[0].reason.c_str(), "Logon accepted");
+    EXPECT_EQ(acks[1].order_id, 7u);
+    EXPECT_STREQ(acks[1].reason.c_str(), "Unknown instrument");
+    EXPECT_EQ(acks[2].order_id, 1u);
+    EXPECT_EQ(acks[2].status, 1);
+
+    auto buyer_logon = make_logon("101", PROTOCOL_V2);
+    ASSERT_EQ(send(buyer, &buyer_logon, sizeof(buyer_logon), 0), static_cast<ssize_t>(sizeof(buyer_logon)));
+    ASSERT_TRUE(recv_exact(buyer, &ack, sizeof(ack)));
+    EXPECT_EQ(ack.status, 1);
+    auto buy = make_order(2, 1, Side::BUY, 60);
+    ASSERT_EQ(send(buyer, &buy, sizeof(buy), 0), static_cast<ssize_t>(sizeof(buy)));
+    ASSERT_TRUE(recv_exact(buyer, &ack, sizeof(ack)));
+    EXPECT_EQ(ack.status, 1);
+
+    TradeMessage trade;
+    ASSERT_TRUE(recv_exact(buyer, &trade, sizeof(trade)));
+    EXPECT_EQ(trade.sell_order_id, 1u);
+    EXPECT_EQ(trade.quantity, 60u);
+    EXPECT_STREQ(trade.symbol.c_str(), "AAPL");
+    ASSERT_TRUE(recv_exact(buyer, &ack, sizeof(ack)));
+    EXPECT_EQ(ack.status, 4);  // Filled
+    ASSERT_TRUE(recv_exact(seller, &trade, sizeof(trade)));
+
+    // Cancel by id alone: the owner is the session's client
+    CancelOrderV2 cancel{};
+    cancel.header   = {sizeof(CancelOrderV2), CANCEL_ORDER};
+    cancel.order_id = 1;
+    ASSERT_EQ(send(seller, &cancel, sizeof(cancel), 0), static_cast<ssize_t>(sizeof(cancel)));
+    ASSERT_TRUE(recv_exact(seller, &ack, sizeof(ack)));
+    EXPECT_STREQ(ack.reason.c_str(), "Cancel submitted");
+    ASSERT_TRUE(recv_exact(seller, &ack, sizeof(ack)));
+    EXPECT_EQ(ack.order_id, 1u);
+    EXPECT_EQ(ack.status, 3);  // Cancelled
+
+    close(seller);
+    close(buyer);
+    gateway.stop();
+    risk.stop();
+    engine.stop();
+}
+
+TEST(TcpGatewayExecutionTest, BatchFrameIsEnqueuedTogetherAndAckedOnce) {
+    constexpr uint16_t port = 18895;
+    RiskConfig risk_config;
+    risk_config.max_order_size = 10000;
+    risk_config.max_notional_per_client = 1000000.0;
+    risk_config.max_orders_per_second = 1000;
+    risk_config.price_collar_enabled = false;
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}};
+
+    OrderPool pool(100);
+    MatchingEngine engine("AAPL", pool);
+    RiskManager risk(risk_config, symbols);
+    risk.add_matching_engine("AAPL", &engine);
+    InstrumentDirectory instruments(symbols);
+
+    EventDoorbell doorbell;
+    SPSCQueue<ExecutionReport> engine_reports(256);
+    SPSCQueue<ExecutionReport> risk_reports(256);
+    engine.set_execution_queue(&engine_reports, &doorbell);
+    risk.set_execution_queue(&risk_reports, &doorbell);
+
+    TcpGateway gateway(port, &risk, &pool);
+    gateway.set_instrument_directory(&instruments);
+    gateway.set_execution_queues({&engine_reports, &risk_reports}, &doorbell);
+    engine.start();
+    risk.start();
+    gateway.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    timeval timeout{2, 0};
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    auto recv_exact = [&](void* buffer, size_t size) {
+        return recv(sock, buffer, size, MSG_WAITALL) == static_cast<ssize_t>(size);
+    };
+
+    LogonMessage logon;
+    logon.header = MessageHeader(LOGON, sizeof(LogonMessage), 0, ProtocolUtils::get_timestamp_ns());
+    logon.client_id = "100";
+    logon.protocol_version = PROTOCOL_V2;
+    ASSERT_EQ(send(sock, &logon, sizeof(logon), 0), static_cast<ssize_t>(sizeof(logon)));
+    OrderAckMessage ack;
+    ASSERT_TRUE(recv_exact(&ack, sizeof(ack)));
+    ASSERT_EQ(ack.status, 1);
+
+    // A quote update: three bids, a bad instrument, a repeated id, then
+    // a cancel of the first bid — all in one frame
+    constexpr size_t entry_count = 6;
+    struct {
+        BatchV2      header;
+        BatchEntryV2 entries[entry_count];
+    } batch{};
+    static_assert(sizeof(batch) == sizeof(BatchV2) + entry_count * sizeof(BatchEntryV2), "One frame");
+    batch.header.header = {sizeof(batch), BATCH};
+    batch.header.count  = entry_count;
+    auto bid = [](uint64_t id, InstrumentID instrument, Price price) {
+        BatchEntryV2 entry{};
+        entry.action     = BATCH_NEW_ORDER;
+        entry.side       = static_cast<uint8_t>(Side::BUY);
+        entry.order_type = static_cast<uint8_t>(OrderType::LIMIT);
+        entry.instrument = instrument;
+        entry.order_id   = id;
+        entry.quantity   = 10;
+        entry.price      = price;
+        return entry;
+    };
+    batch.entries[0] = bid(1, 0, 14900);
+    batch.entries[1] = bid(2, 0, 14800);
+    batch.entries[2] = bid(3, 0, 14700);
+    batch.entries[3] = bid(4, 9, 14600);
+    batch.entries[4] = bid(2, 0, 14500);
+    batch.entries[5].action   = BATCH_CANCEL_ORDER;
+    batch.entries[5].order_id = 1;
+    ASSERT_EQ(send(sock, &batch, sizeof(batch), 0), static_cast<ssize_t>(sizeof(batch)));
+
+    struct {
+        BatchAckMessage header;
+        BatchAckEntry   entries[entry_count];
+    } batch_ack;
+    static_assert(sizeof(batch_ack) == sizeof(BatchAckMessage) + entry_count * sizeof(BatchAckEntry), "One frame");
+    ASSERT_TRUE(recv_exact(&batch_ack, sizeof(batch_ack)));
+    EXPECT_EQ(batch_ack.header.header.type, BATCH_ACK);
+    EXPECT_EQ(batch_ack.header.header.length, sizeof(batch_ack));
+    EXPECT_EQ(batch_ack.header.count, entry_count);
+    EXPECT_EQ(batch_ack.header.accepted, 4);
+    const uint8_t expected_reason[entry_count] = {BATCH_OK, BATCH_OK, BATCH_OK,
+                                              BATCH_UNKNOWN_INSTRUMENT, BATCH_DUPLICATE_ID, BATCH_OK};
+    for (size_t i = 0; i < entry_count; ++i) {
+        EXPECT_EQ(batch_ack.entries[i].order_id, batch.entries[i].order_id);
+        EXPECT_EQ(batch_ack.entries[i].reason, expected_reason[i]) << i;
+        EXPECT_EQ(batch_ack.entries[i].status, expected_reason[i] == BATCH_OK ? 1 : 2) << i;
+    }
+
+    // The cancel ran after its order: the only report is its Cancelled
+    ASSERT_TRUE(recv_exact(&ack, sizeof(ack)));
+    EXPECT_EQ(ack.order_id, 1u);
+    EXPECT_EQ(ack.status, 3);
+
+    close(sock);
+    gateway.stop();
+    risk.stop();
+    engine.stop();
+    EXPECT_EQ(gateway.messages_received(), 2u);  // Logon + one batch
+}
+
+TEST(TcpGatewayExecutionTest, SessionAuthChecksTheTokenOnceAndEachMessageAgainstItsGrant) {
+    constexpr uint16_t port = 18897;
+    setenv("RTES_AUTH_MODE", "development", 1);
+    RiskConfig risk_config;
+    risk_config.price_collar_enabled = false;
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}};
+    OrderPool pool(100);
+    RiskManager risk(risk_config, symbols);
+    SessionAuthCache auth(16);
+
+    TcpGateway gateway(port, &risk, &pool);
+    gateway.set_session_auth(&auth);
+    gateway.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const int sock = socket(AF_INET, SOCK_STREAM, 0);
+    timeval timeout{2, 0};
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+
+    auto exchange = [&](const void* msg, size_t size) {
+        OrderAckMessage ack;
+        EXPECT_EQ(send(sock, msg, size, 0), static_cast<ssize_t>(size));
+        EXPECT_EQ(recv(sock, &ack, sizeof(ack), MSG_WAITALL), static_cast<ssize_t>(sizeof(ack)));
+        return ack;
+    };
+    auto order = [](uint64_t id, const char* client = "alice00000000000") {
+        NewOrderMessage msg;
+        msg.header = MessageHeader(NEW_ORDER, sizeof(NewOrderMessage), id, 0);
+        msg.order_id = id;
+        msg.client_id = client;
+        msg.symbol = "AAPL";
+        msg.side = 1;
+        msg.order_type = 2;
+        msg.quantity = 100;
+        msg.price = 15000;
+        return msg;
+    };
+    LogonMessage logon;
+    logon.header = MessageHeader(LOGON, sizeof(LogonMessage), 0, 0);
+    logon.client_id = "100";
+    logon.protocol_version = PROTOCOL_V1;
+
+    auto early = order(1);
+    EXPECT_STREQ(exchange(&early, sizeof(early)).reason.c_str(), "Not logged on");
+
+    // A logon without the token field is still parsed, and refused
+    LogonMessage short_logon = logon;
+    short_logon.header.length = LOGON_MIN_LENGTH;
+    EXPECT_STREQ(exchange(&short_logon, LOGON_MIN_LENGTH).reason.c_str(), "Authentication failed");
+
+    // The token is alice's: it cannot log on as client 100
+    logon.auth_token = "dev_trader_alice000000000000000000";
+    EXPECT_STREQ(exchange(&logon, sizeof(logon)).reason.c_str(), "Authentication failed");
+    EXPECT_EQ(auth.active(), 0u);
+
+    logon.client_id = "alice00000000000";
+    EXPECT_STREQ(exchange(&logon, sizeof(logon)).reason.c_str(), "Logon accepted");
+    EXPECT_EQ(auth.active(), 1u);
+
+    auto placed = order(2);
+    const OrderAckMessage accepted = exchange(&placed, sizeof(placed));
+    EXPECT_EQ(accepted.order_id, 2u);
+    EXPECT_STREQ(accepted.reason.c_str(), "Accepted");
+
+    // Messages for another client are refused, whatever the grant allows
+    auto foreign = order(4, "100");
+    EXPECT_STREQ(exchange(&foreign, sizeof(foreign)).reason.c_str(), "Not the session's client");
+    CancelOrderMessage cancel;
+    cancel.header = MessageHeader(CANCEL_ORDER, sizeof(CancelOrderMessage), 5, 0);
+    cancel.order_id = 2;
+    cancel.client_id = "100";
+    EXPECT_STREQ(exchange(&cancel, sizeof(cancel)).reason.c_str(), "Not the session's client");
+
+    // Revoked from another thread: the next message sees the new epoch
+    EXPECT_EQ(auth.revoke_user("alice00000000000"), 1u);
+    auto revoked = order(3);
+    EXPECT_STREQ(exchange(&revoked, sizeof(revoked)).reason.c_str(), "Session revoked");
+
+    // A refused re-logon leaves the session without its old grant
+    logon.auth_token = "dev_trader_bob";
+    EXPECT_STREQ(exchange(&logon, sizeof(logon)).reason.c_str(), "Authentication failed");
+    EXPECT_EQ(auth.active(), 0u);
+
+    close(sock);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    gateway.stop();
+    EXPECT_EQ(auth.active(), 0u);  // Released at disconnect
+    EXPECT_EQ(gateway.auth_rejects(), 7u);
+    unsetenv("RTES_AUTH_MODE");
+}
+
+TEST(TcpGatewayExecutionTest, BusySpinReactorPollsReportsAndMeasuresIngress) {
+    constexpr uint16_t port = 18896;
+    RiskConfig risk_config;
+    risk_config.max_order_size = 10000;
+    risk_config.max_notional_per_client = 1000000.0;
+    risk_config.max_orders_per_second = 1000;
+    risk_config.price_collar_enabled = false;
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}};
+
+    OrderPool pool(100);
+    MatchingEngine engine("AAPL", pool);
+    RiskManager risk(risk_config, symbols);
+    risk.add_matching_engine("AAPL", &engine);
+
+    EventDoorbell doorbell;
+    SPSCQueue<ExecutionReport> engine_reports(256);
+    SPSCQueue<ExecutionReport> risk_reports(256);
+    engine.set_execution_queue(&engine_reports, &doorbell);
+    risk.set_execution_queue(&risk_reports, &doorbell);
+
+    TcpGateway gateway(port, &risk, &pool);
+    gateway.set_execution_queues({&engine_reports, &risk_reports}, &doorbell);
+    gateway.set_idle_policy(IdlePolicy::BUSY_SPIN);
+    gateway.set_busy_poll(50);  // Best effort: refused without CAP_NET_ADMIN
+    gateway.set_ingress_timestamps(true);
+    engine.start();
+    risk.start();
+    gateway.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    timeval timeout{2, 0};
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    auto recv_exact = [&](void* buffer, size_t size) {
+        return recv(sock, buffer, size, MSG_WAITALL) == static_cast<ssize_t>(size);
+    };
+
+    NewOrderMessage order_msg;
+    order_msg.header = MessageHeader(NEW_ORDER, sizeof(NewOrderMessage), 1,
+                                     ProtocolUtils::get_timestamp_ns());
+    order_msg.order_id = 7;
+    order_msg.client_id = "100";
+    order_msg.symbol = "AAPL";
+    order_msg.side = static_cast<uint8_t>(Side::BUY);
+    order_msg.quantity = 10;
+    order_msg.price = 15000;
+    order_msg.order_type = static_cast<uint8_t>(OrderType::LIMIT);
+    ASSERT_EQ(send(sock, &order_msg, sizeof(order_msg), 0), static_cast<ssize_t>(sizeof(order_msg)));
+    OrderAckMessage ack;
+    ASSERT_TRUE(recv_exact(&ack, sizeof(ack)));
+    EXPECT_EQ(ack.status, 1);
+
+    // The Cancelled report arrives without the doorbell ever being armed
+    CancelOrderMessage cancel_msg;
+    cancel_msg.header = MessageHeader(CANCEL_ORDER, sizeof(CancelOrderMessage), 2,
+                                      ProtocolUtils::get_timestamp_ns());
+    cancel_msg.order_id = 7;
+    cancel_msg.client_id = "100";
+    cancel_msg.symbol = "AAPL";
+    ASSERT_EQ(send(sock, &cancel_msg, sizeof(cancel_msg), 0), static_cast<ssize_t>(sizeof(cancel_msg)));
+    bool cancelled = false;
+    for (int i = 0; i < 3 && !cancelled; ++i) {
+        ASSERT_TRUE(recv_exact(&ack, sizeof(ack)));
+        cancelled = ack.order_id == 7 && ack.status == 3;
+    }
+    EXPECT_TRUE(cancelled);
+
+    close(sock);
+    gateway.stop();
+    risk.stop();
+    engine.stop();
+
+    const IngressLatency ingress = gateway.ingress_latency();
+    EXPECT_EQ(ingress.samples, 2u);  // One per segment carrying a message
+    EXPECT_GT(ingress.max_ns, 0u);
+    EXPECT_LE(ingress.avg_ns, ingress.max_ns);
+}
+
+TEST(ReadBufferTest, ConsumeNeverMovesAndRoomIsMadeOnlyWhenShort) {
+    ReadBuffer buf;
+    auto fill = [&](size_t n, uint8_t value) {
+        std::memset(buf.write_ptr(), value, n);
+        buf.advance_write(n);
+    };
+
+    fill(3000, 1);
+    buf.consume(1000);
+    const uint8_t* parsed = buf.data();
+    buf.make_room();  // 5192 free at the tail: nothing moves
+    EXPECT_EQ(buf.data(), parsed);
+    EXPECT_EQ(buf.remaining(), ReadBuffer::CAPACITY - 3000);
+
+    fill(3000, 2);
+    buf.consume(4500);  // 500 unparsed bytes of value 2 left at offset 5500
+    EXPECT_EQ(buf.size(), 500u);
+    buf.make_room();    // Tail short of a full frame: the 500 move to the front
+    EXPECT_EQ(buf.remaining(), ReadBuffer::CAPACITY - 500);
+    EXPECT_EQ(buf.data()[0], 2);
+    EXPECT_EQ(buf.data()[499], 2);
+
+    buf.consume(500);   // Drained: back to an empty buffer, no copy
+    EXPECT_EQ(buf.size(), 0u);
+    EXPECT_EQ(buf.remaining(), ReadBuffer::CAPACITY);
+}
+
+TEST(SessionRegistryTest, ReusedSlotDoesNotResolveStaleId) {
+    SessionRegistry registry(2);
+    ConnectionState* first  = reinterpret_cast<ConnectionState*>(0x1000);
+    ConnectionState* second = reinterpret_cast<ConnectionState*>(0x2000);
+
+    const SessionID a = registry.open(first);
+    const SessionID b = registry.open(second);
+    ASSERT_NE(a, 0u);
+    ASSERT_NE(b, 0u);
+    EXPECT_EQ(registry.open(first), 0u);  // Full
+    EXPECT_EQ(registry.find(a), first);
+
+    registry.close(a);
+    EXPECT_EQ(registry.find(a), nullptr);
+    const SessionID c = registry.open(second);
+    EXPECT_EQ(c & 0xFFFF, a & 0xFFFF);  // Same slot, new generation
+    EXPECT_NE(c, a);
+    EXPECT_EQ(registry.find(a), nullptr);
+    EXPECT_EQ(registry.find(c), second);
+    EXPECT_EQ(registry.open_count(), 2u);
+}
+
+TEST(ConnectionSlabTest, SlotsArePreBuiltAndReusedByConnectionId) {
+    ConnectionSlab slab(2);
+    EXPECT_EQ(slab.capacity(), 2u);
+    EXPECT_EQ(slab.open_count(), 0u);
+
+    ConnectionState* a = slab.open(socket(AF_INET, SOCK_STREAM, 0));
+    ConnectionState* b = slab.open(socket(AF_INET, SOCK_STREAM, 0));
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % 64, 0u);
+    EXPECT_EQ(&slab[a->id], a);
+    EXPECT_NE(a->id, b->id);
+    EXPECT_TRUE(a->in_use && a->connected);
+
+    const int refused = socket(AF_INET, SOCK_STREAM, 0);
+    EXPECT_EQ(slab.open(refused), nullptr);  // Full: the caller closes the fd
+    close(refused);
+
+    // Closed slot comes back first, under the same id and a new generation
+    const ConnectionID id = a->id;
+    const uint32_t generation = a->generation;
+    a->disconnect();
+    slab.close(*a);
+    EXPECT_EQ(slab.open_count(), 1u);
+    ConnectionState* c = slab.open(socket(AF_INET, SOCK_STREAM, 0));
+    ASSERT_EQ(c, a);
+    EXPECT_EQ(c->id, id);
+    EXPECT_NE(c->generation, generation);
+    EXPECT_TRUE(c->read_buf.size() == 0 && c->write_buf.empty());
+}
+
+} // namespace rtes
@@ -0,0 +1,277 @@
+#include <gtest/gtest.h>
+#include "rtes/tls_offload.hpp"
+#include "rtes/tcp_gateway.hpp"
+#include "rtes/risk_manager.hpp"
+#include "rtes/memory_pool.hpp"
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#ifndef RTES_NO_OPENSSL
+#include <openssl/evp.h>
+#include <openssl/opensslv.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#endif
+
+namespace rtes {
+
+TEST(TlsOffloadTest, MissingCertificateIsRejected) {
+    TlsOffload tls;
+    EXPECT_FALSE(tls.init({"/tmp/rtes_tls_missing.pem", "/tmp/rtes_tls_missing.key", ""}));
+    EXPECT_FALSE(tls.ready());
+}
+
+#if !defined(RTES_NO_OPENSSL) && OPENSSL_VERSION_NUMBER >= 0x30000000L
+
+namespace {
+
+const std::string CERT_FILE = "/tmp/rtes_tls_test_cert.pem";
+const std::string KEY_FILE  = "/tmp/rtes_tls_test_key.pem";
+
+/** Self-signed P-256 certificate and key for localhost, written as PEM */
+bool write_self_signed() {
+    EVP_PKEY* key = EVP_PKEY_Q_keygen(nullptr, nullptr, "EC", "P-256");
+    X509* cert = X509_new();
+    bool ok = key && cert;
+    if (ok) {
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+        X509_set_pubkey(cert, key);
+        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                                   reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        ok = X509_sign(cert, key, EVP_sha256()) > 0;
+    }
+    std::FILE* cert_out = ok ? std::fopen(CERT_FILE.c_str(), "w") : nullptr;
+    std::FILE* key_out = ok ? std::fopen(KEY_FILE.c_str(), "w") : nullptr;
+    ok = cert_out && key_out && PEM_write_X509(cert_out, cert) == 1 &&
+         PEM_write_PrivateKey(key_out, key, nullptr, nullptr, 0, nullptr, nullptr) == 1;
+    if (cert_out) std::fclose(cert_out);
+    if (key_out) std::fclose(key_out);
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    return ok;
+}
+
+int listen_loopback(uint16_t port) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    const int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 4) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int connect_loopback(uint16_t port) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/** Blocking OpenSSL client on a connected socket (no certificate check) */
+struct TlsClient {
+    SSL_CTX* ctx{SSL_CTX_new(TLS_client_method())};
+    SSL*     ssl{nullptr};
+
+    ~TlsClient() {
+        SSL_free(ssl);
+        SSL_CTX_free(ctx);
+    }
+
+    bool connect(int fd) {
+        ssl = SSL_new(ctx);
+        SSL_set_fd(ssl, fd);
+        return SSL_connect(ssl) == 1;
+    }
+};
+
+class TlsOffloadHandshakeTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(write_self_signed());
+        ASSERT_TRUE(tls_.init({CERT_FILE, KEY_FILE, ""}));
+    }
+
+    void TearDown() override {
+        std::remove(CERT_FILE.c_str());
+        std::remove(KEY_FILE.c_str());
+    }
+
+    TlsOffload tls_;
+};
+
+} // namespace
+
+TEST_F(TlsOffloadHandshakeTest, NonBlockingHandshakeHandsTheSessionToTheKernel) {
+    constexpr uint16_t port = 18920;
+    const int listener = listen_loopback(port);
+    ASSERT_GE(listener, 0);
+
+    // Client: handshake, then plain SSL_write; with kTLS the server reads it with recv()
+    bool client_ok = false;
+    std::thread client([&] {
+        const int fd = connect_loopback(port);
+        if (fd < 0) return;
+        TlsClient tls_client;
+        client_ok = tls_client.connect(fd);
+        if (client_ok) SSL_write(tls_client.ssl, "ping", 4);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        close(fd);
+    });
+
+    const int fd = accept(listener, nullptr, nullptr);
+    ASSERT_GE(fd, 0);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+    TlsHandshake* handshake = tls_.begin(fd);
+    ASSERT_NE(handshake, nullptr);
+    TlsOffload::Status status;
+    int steps = 0;
+    while (true) {
+        status = tls_.advance(handshake);
+        if (status != TlsOffload::Status::WANT_READ && status != TlsOffload::Status::WANT_WRITE) break;
+        pollfd pfd{fd, static_cast<short>(status == TlsOffload::Status::WANT_READ ? POLLIN : POLLOUT), 0};
+        ASSERT_GT(poll(&pfd, 1, 2000), 0);
+        ++steps;
+    }
+    EXPECT_GT(steps, 0);  // Waited on the socket at least once instead of blocking
+
+    if (status == TlsOffload::Status::DONE) {
+        char text[8] = {};
+        pollfd pfd{fd, POLLIN, 0};
+        ASSERT_GT(poll(&pfd, 1, 2000), 0);
+        EXPECT_EQ(recv(fd, text, sizeof(text), 0), 4);
+        EXPECT_STREQ(text, "ping");
+    } else {
+        // Kernel without the tls module: the handshake itself completed
+        EXPECT_EQ(status, TlsOffload::Status::NO_OFFLOAD);
+    }
+    client.join();
+    EXPECT_TRUE(client_ok);
+    close(fd);
+    close(listener);
+}
+
+TEST_F(TlsOffloadHandshakeTest, GatewayRefusesPlaintextAndCountsSessions) {
+    constexpr uint16_t port = 18921;
+    RiskConfig risk_config;
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}};
+    OrderPool pool(100);
+    RiskManager risk(risk_config, symbols);
+
+    TcpGateway gateway(port, &risk, &pool);
+    gateway.set_tls(&tls_);
+    gateway.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // A plaintext order is not a ClientHello: the handshake fails and the connection closes
+    const int plain = connect_loopback(port);
+    ASSERT_GE(plain, 0);
+    NewOrderMessage order;
+    order.header = MessageHeader(NEW_ORDER, sizeof(NewOrderMessage), 1, 0);
+    order.order_id = 1;
+    order.client_id = "100";
+    order.symbol = "AAPL";
+    order.quantity = 100;
+    order.price = 15000;
+    ASSERT_EQ(send(plain, &order, sizeof(order), 0), static_cast<ssize_t>(sizeof(order)));
+    char byte;
+    pollfd pfd{plain, POLLIN, 0};
+    ASSERT_GT(poll(&pfd, 1, 2000), 0);
+    EXPECT_LE(recv(plain, &byte, 1, 0), 0);
+    close(plain);
+
+    // A TLS client completes the handshake either way; the session is kept
+    // only if the kernel took it
+    const int fd = connect_loopback(port);
+    ASSERT_GE(fd, 0);
+    TlsClient client;
+    EXPECT_TRUE(client.connect(fd));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    close(fd);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    gateway.stop();
+
+    EXPECT_EQ(gateway.tls_sessions() + gateway.tls_failures(), 2u);
+    EXPECT_GE(gateway.tls_failures(), 1u);
+    EXPECT_EQ(gateway.messages_received(), 0u);
+}
+
+TEST_F(TlsOffloadHandshakeTest, GatewayTakesOrdersOverKernelTls) {
+    constexpr uint16_t port = 18922;
+    RiskConfig risk_config;
+    risk_config.price_collar_enabled = false;
+    std::vector<SymbolConfig> symbols = {{"AAPL", 0.01, 1, 10.0}};
+    OrderPool pool(100);
+    RiskManager risk(risk_config, symbols);
+
+    TcpGateway gateway(port, &risk, &pool);
+    gateway.set_tls(&tls_);
+    gateway.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const int fd = connect_loopback(port);
+    ASSERT_GE(fd, 0);
+    timeval timeout{2, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    TlsClient client;
+    ASSERT_TRUE(client.connect(fd));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    if (gateway.tls_sessions() == 0) {
+        close(fd);
+        gateway.stop();
+        GTEST_SKIP() << "Kernel without the tls module";
+    }
+
+    // Every record the kernel hands over carries its type; data records are orders
+    NewOrderMessage order;
+    order.header = MessageHeader(NEW_ORDER, sizeof(NewOrderMessage), 1, 0);
+    order.order_id = 1;
+    order.client_id = "100";
+    order.symbol = "AAPL";
+    order.side = 1;
+    order.order_type = 2;
+    order.quantity = 100;
+    order.price = 15000;
+    for (uint64_t id = 1; id <= 2; ++id) {
+        order.order_id = id;
+        ASSERT_EQ(SSL_write(client.ssl, &order, sizeof(order)), static_cast<int>(sizeof(order)));
+        OrderAckMessage ack;
+        ASSERT_EQ(SSL_read(client.ssl, &ack, sizeof(ack)), static_cast<int>(sizeof(ack)));
+        EXPECT_EQ(ack.order_id, id);
+        EXPECT_STREQ(ack.reason.c_str(), "Accepted");
+    }
+    close(fd);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    gateway.stop();
+    EXPECT_EQ(gateway.messages_received(), 2u);
+}
+
+#endif
+
+} // namespace rtes
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include "rtes/token_bucket.hpp"
+
+namespace rtes {
+
+TEST(TokenBucketTest, StartsFullThenRefillsExactly) {
+    TokenBucketLimit limit(3, 1'000'000'000, 3);  // 3 per second
+    TokenBucket bucket;
+    const Timestamp t0 = 1'000;
+
+    for (int i = 0; i < 3; ++i) EXPECT_TRUE(limit.try_consume(bucket, t0));
+    EXPECT_FALSE(limit.try_consume(bucket, t0));
+
+    // 1/3 s = one token; fractions carry over instead of being dropped
+    EXPECT_FALSE(limit.try_consume(bucket, t0 + 333'333'333));
+    EXPECT_TRUE(limit.try_consume(bucket, t0 + 333'333'334));
+    EXPECT_FALSE(limit.try_consume(bucket, t0 + 500'000'000));
+    EXPECT_TRUE(limit.try_consume(bucket, t0 + 666'666'667));
+}
+
+TEST(TokenBucketTest, NoDoubleBurstAcrossSecondBoundary) {
+    TokenBucketLimit limit(100, 1'000'000'000, 100);
+    TokenBucket bucket;
+    const Timestamp t0 = 1'000;
+
+    int accepted = 0;
+    for (int i = 0; i < 100; ++i) accepted += limit.try_consume(bucket, t0 + 990'000'000);
+    for (int i = 0; i < 100; ++i) accepted += limit.try_consume(bucket, t0 + 1'010'000'000);
+    EXPECT_EQ(accepted, 102);  // A window counter would allow 200
+}
+
+TEST(TokenBucketTest, BurstCapsIdleAccumulation) {
+    TokenBucketLimit limit(1000, 1'000'000'000, 5);
+    TokenBucket bucket;
+    EXPECT_EQ(limit.burst(), 5u);
+
+    EXPECT_TRUE(limit.try_consume(bucket, 1, 5));
+    int accepted = 0;
+    for (int i = 0; i < 10; ++i) accepted += limit.try_consume(bucket, 3'600'000'000'000ULL);
+    EXPECT_EQ(accepted, 5);
+}
+
+TEST(TokenBucketTest, ZeroRateNeverRefills) {
+    TokenBucketLimit limit(0, 1'000'000'000, 0);
+    TokenBucket bucket;
+    EXPECT_FALSE(limit.try_consume(bucket, 1));
+    EXPECT_FALSE(limit.try_consume(bucket, 10'000'000'000ULL));
+}
+
+} // namespace rtes
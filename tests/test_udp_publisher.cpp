@@ -17,7 +17,7 @@ namespace rtes {
 class UdpPublisherTest : public ::testing::Test {
 protected:
     void SetUp() override {
-        market_data_queue = std::make_unique<MPMCQueue<MarketDataEvent>>(1000);
+        market_data_queue = std::make_unique<MarketDataLane>(1000);
         publisher = std::make_unique<UdpPublisher>("239.0.0.1", 19999, market_data_queue.get());
         
         // Setup receiver socket
@@ -60,14 +60,26 @@ protected:
         setsockopt(receiver_fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
     }
     
+    // Next message of the current packet; receives a packet when it runs out
     bool receive_message(void* buffer, size_t size) {
-        ssize_t received = recv(receiver_fd_, buffer, size, 0);
-        return received == static_cast<ssize_t>(size);
+        if (packet_offset_ >= packet_length_) {
+            ssize_t received = recv(receiver_fd_, packet_, sizeof(packet_), 0);
+            if (received < static_cast<ssize_t>(sizeof(UdpPacketHeader))) return false;
+            packet_length_ = static_cast<size_t>(received);
+            packet_offset_ = sizeof(UdpPacketHeader);
+        }
+        if (packet_offset_ + size > packet_length_) return false;
+        std::memcpy(buffer, packet_ + packet_offset_, size);
+        packet_offset_ += size;
+        return true;
     }
     
-    std::unique_ptr<MPMCQueue<MarketDataEvent>> market_data_queue;
+    std::unique_ptr<MarketDataLane> market_data_queue;
     std::unique_ptr<UdpPublisher> publisher;
     int receiver_fd_{-1};
+    uint8_t packet_[MD_MAX_DATAGRAM];
+    size_t packet_length_{0};
+    size_t packet_offset_{0};
 };
 
 TEST_F(UdpPublisherTest, BBOUpdate) {
@@ -105,6 +117,7 @@ TEST_F(UdpPublisherTest, TradeUpdate) {
     // Create trade event
     MarketDataEvent event;
     event.type = MarketDataEvent::TRADE;
+    event.aggressor_side = 1;
     event.trade = Trade(12345, 1001, 1002, "MSFT", 200, 30000);
     
     // Send event
@@ -198,4 +211,524 @@ TEST_F(UdpPublisherTest, HighThroughput) {
     EXPECT_GT(publisher->messages_sent(), 0u);
 }
 
-} // namespace rtes
\ No newline at end of file
+TEST(UdpPacketingTest, PacksABurstIntoFewDatagrams) {
+    constexpr uint16_t port = 19998;
+    constexpr int trades = 10;
+    int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(receiver, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(bind(receiver, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    timeval timeout{1, 0};
+    setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    // Unicast loopback destination; the smallest payload holds 8 trades
+    MarketDataLane queue(64);
+    UdpPublisher publisher("127.0.0.1", port, &queue);
+    publisher.set_max_datagram_size(0);
+    const size_t per_packet = (MD_MIN_DATAGRAM - sizeof(UdpPacketHeader)) / sizeof(TradeUpdateMessage);
+    for (int i = 0; i < trades; ++i) {
+        ASSERT_TRUE(queue.push(MarketDataEvent::make_trade("AAPL", Trade(i + 1, 1, 2, "AAPL", 100, 15000))));
+    }
+    publisher.start();
+
+    uint64_t next_sequence = 1;
+    size_t packets = 0;
+    uint8_t buffer[MD_MAX_DATAGRAM];
+    while (next_sequence <= trades) {
+        const ssize_t received = recv(receiver, buffer, sizeof(buffer), 0);
+        ASSERT_GT(received, static_cast<ssize_t>(sizeof(UdpPacketHeader)));
+        ASSERT_LE(received, static_cast<ssize_t>(MD_MIN_DATAGRAM));
+        UdpPacketHeader packet;
+        std::memcpy(&packet, buffer, sizeof(packet));
+        EXPECT_EQ(packet.sequence, next_sequence);
+        EXPECT_EQ(packet.length, received);
+        EXPECT_EQ(packet.message_count, packets == 0 ? per_packet : trades - per_packet);
+
+        for (size_t i = 0; i < packet.message_count; ++i) {
+            TradeUpdateMessage msg;
+            std::memcpy(&msg, buffer + sizeof(UdpPacketHeader) + i * sizeof(msg), sizeof(msg));
+            EXPECT_EQ(msg.header.type, TRADE_UPDATE);
+            EXPECT_EQ(msg.header.length, sizeof(TradeUpdateMessage));
+            EXPECT_EQ(msg.header.sequence, next_sequence);
+            EXPECT_EQ(msg.trade_id, next_sequence);
+            ++next_sequence;
+        }
+        ++packets;
+    }
+    publisher.stop();
+    close(receiver);
+
+    EXPECT_EQ(packets, 2u);
+    EXPECT_EQ(publisher.messages_sent(), static_cast<size_t>(trades));
+    EXPECT_EQ(publisher.packets_sent(), 2u);
+}
+
+TEST(UdpPacketingTest, SignedDatagramsLeaveRoomForTheirTag) {
+    constexpr uint16_t port = 19987;
+    constexpr int trades = 10;
+    int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(receiver, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(bind(receiver, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    timeval timeout{1, 0};
+    setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    MarketDataLane queue(64);
+    UdpPublisher publisher("127.0.0.1", port, &queue);
+    publisher.set_max_datagram_size(0);
+    if (!publisher.set_authentication("feed-key")) GTEST_SKIP() << "Built without OpenSSL";
+    const size_t per_packet =
+        (MD_MIN_DATAGRAM - sizeof(UdpPacketHeader) - MD_AUTH_TAG_BYTES) / sizeof(TradeUpdateMessage);
+    for (int i = 0; i < trades; ++i) {
+        ASSERT_TRUE(queue.push(MarketDataEvent::make_trade("AAPL", Trade(i + 1, 1, 2, "AAPL", 100, 15000))));
+    }
+    publisher.start();
+
+    DatagramAuthenticator feed("feed-key");
+    DatagramAuthenticator other("other-key");
+    uint64_t next_sequence = 1;
+    uint8_t buffer[MD_MAX_DATAGRAM];
+    while (next_sequence <= trades) {
+        const ssize_t received = recv(receiver, buffer, sizeof(buffer), 0);
+        ASSERT_GT(received, static_cast<ssize_t>(sizeof(UdpPacketHeader)));
+        ASSERT_LE(received, static_cast<ssize_t>(MD_MIN_DATAGRAM));
+        UdpPacketHeader packet;
+        std::memcpy(&packet, buffer, sizeof(packet));
+        EXPECT_EQ(packet.sequence, next_sequence);
+        EXPECT_EQ(packet.length + MD_AUTH_TAG_BYTES, static_cast<size_t>(received));
+        EXPECT_EQ(packet.flags & UDP_PACKET_AUTHENTICATED, UDP_PACKET_AUTHENTICATED);
+        EXPECT_EQ(packet.message_count, next_sequence == 1 ? per_packet : trades - per_packet);
+        EXPECT_TRUE(feed.verify(buffer, static_cast<size_t>(received)));
+        EXPECT_FALSE(other.verify(buffer, static_cast<size_t>(received)));
+        next_sequence += packet.message_count;
+    }
+    publisher.stop();
+    close(receiver);
+    EXPECT_EQ(publisher.packets_sent(), 2u);
+}
+
+TEST(UdpPacketingTest, ChannelsHaveTheirOwnDestinationAndSequence) {
+    constexpr uint16_t ports[2] = {19996, 19997};
+    int receivers[2];
+    for (int c = 0; c < 2; ++c) {
+        receivers[c] = socket(AF_INET, SOCK_DGRAM, 0);
+        ASSERT_GE(receivers[c], 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(ports[c]);
+        ASSERT_EQ(bind(receivers[c], reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        timeval timeout{1, 0};
+        setsockopt(receivers[c], SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    }
+
+    // No default channel: this publisher serves channels 0 and 1 only
+    MarketDataLane queue(64);
+    UdpPublisher publisher("", 0, &queue);
+    publisher.add_channel(0, "127.0.0.1", ports[0]);
+    publisher.add_channel(1, "127.0.0.1", ports[1]);
+    const uint8_t channels[] = {0, 1, 1, 0, 1, 7};  // 7 is not served here
+    for (size_t i = 0; i < std::size(channels); ++i) {
+        auto event = MarketDataEvent::make_trade(channels[i] == 0 ? "AAPL" : "MSFT",
+                                                 Trade(i + 1, 1, 2, "AAPL", 100, 15000));
+        event.channel = channels[i];
+        ASSERT_TRUE(queue.push(event));
+    }
+    publisher.start();
+
+    const std::vector<uint64_t> expected_trades[2] = {{1, 4}, {2, 3, 5}};
+    uint8_t buffer[MD_MAX_DATAGRAM];
+    for (int c = 0; c < 2; ++c) {
+        const ssize_t received = recv(receivers[c], buffer, sizeof(buffer), 0);
+        ASSERT_GT(received, static_cast<ssize_t>(sizeof(UdpPacketHeader)));
+        UdpPacketHeader packet;
+        std::memcpy(&packet, buffer, sizeof(packet));
+        EXPECT_EQ(packet.sequence, 1u);  // Each channel counts from 1
+        ASSERT_EQ(packet.message_count, expected_trades[c].size());
+        for (size_t i = 0; i < packet.message_count; ++i) {
+            TradeUpdateMessage msg;
+            std::memcpy(&msg, buffer + sizeof(UdpPacketHeader) + i * sizeof(msg), sizeof(msg));
+            EXPECT_EQ(msg.header.sequence, i + 1);
+            EXPECT_EQ(msg.trade_id, expected_trades[c][i]);
+            EXPECT_STREQ(msg.symbol, c == 0 ? "AAPL" : "MSFT");
+        }
+    }
+    publisher.stop();
+    close(receivers[0]);
+    close(receivers[1]);
+
+    EXPECT_EQ(publisher.messages_sent(), 5u);
+    EXPECT_EQ(publisher.packets_sent(), 2u);
+    EXPECT_EQ(publisher.unrouted(), 1u);
+}
+
+TEST(UdpPacketingTest, BboConflationKeepsTheLatestBboPerSymbol) {
+    constexpr uint16_t port = 19995;
+    int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(receiver, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(bind(receiver, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    timeval timeout{1, 0};
+    setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    MarketDataLane queue(64);
+    UdpPublisher publisher("127.0.0.1", port, &queue);
+    publisher.set_bbo_conflation(true);
+    ASSERT_TRUE(queue.push(MarketDataEvent::make_bbo("AAPL", 14900, 100, 15000, 100)));
+    ASSERT_TRUE(queue.push(MarketDataEvent::make_bbo("MSFT", 29900, 100, 30000, 100)));
+    ASSERT_TRUE(queue.push(MarketDataEvent::make_trade("AAPL", Trade(1, 1, 2, "AAPL", 100, 15000))));
+    ASSERT_TRUE(queue.push(MarketDataEvent::make_bbo("AAPL", 14900, 100, 15100, 50)));
+    publisher.start();
+
+    // AAPL's first BBO is superseded; the trade between them is not
+    uint8_t buffer[MD_MAX_DATAGRAM];
+    const ssize_t received = recv(receiver, buffer, sizeof(buffer), 0);
+    ASSERT_GT(received, static_cast<ssize_t>(sizeof(UdpPacketHeader)));
+    UdpPacketHeader packet;
+    std::memcpy(&packet, buffer, sizeof(packet));
+    ASSERT_EQ(packet.message_count, 3u);
+
+    size_t offset = sizeof(UdpPacketHeader);
+    BBOUpdateMessage msft;
+    std::memcpy(&msft, buffer + offset, sizeof(msft));
+    EXPECT_EQ(msft.header.type, BBO_UPDATE);
+    EXPECT_STREQ(msft.symbol, "MSFT");
+    offset += sizeof(msft);
+    TradeUpdateMessage trade;
+    std::memcpy(&trade, buffer + offset, sizeof(trade));
+    EXPECT_EQ(trade.header.type, TRADE_UPDATE);
+    offset += sizeof(trade);
+    BBOUpdateMessage aapl;
+    std::memcpy(&aapl, buffer + offset, sizeof(aapl));
+    EXPECT_EQ(aapl.header.type, BBO_UPDATE);
+    EXPECT_STREQ(aapl.symbol, "AAPL");
+    EXPECT_EQ(aapl.ask_price, 15100u);
+    EXPECT_EQ(aapl.ask_quantity, 50u);
+    EXPECT_EQ(aapl.header.sequence, 3u);  // Sequence is dense over what was sent
+
+    publisher.stop();
+    close(receiver);
+    EXPECT_EQ(publisher.messages_sent(), 3u);
+    EXPECT_EQ(publisher.bbo_conflated(), 1u);
+}
+
+TEST(UdpPacketingTest, TradeCarriesAggressorAndMatchTime) {
+    constexpr uint16_t port = 19991;
+    int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(receiver, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(bind(receiver, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    timeval timeout{1, 0};
+    setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    const Timestamp match_time = now_timestamp();
+    MarketDataLane queue(64);
+    UdpPublisher publisher("127.0.0.1", port, &queue);
+    ASSERT_TRUE(queue.push(MarketDataEvent::make_trade(
+        "AAPL", Trade(1, 1, 2, "AAPL", 100, 15000, match_time), static_cast<uint8_t>(Side::SELL))));
+    publisher.start();
+
+    uint8_t buffer[MD_MAX_DATAGRAM];
+    const ssize_t received = recv(receiver, buffer, sizeof(buffer), 0);
+    ASSERT_EQ(received, static_cast<ssize_t>(sizeof(UdpPacketHeader) + sizeof(TradeUpdateMessage)));
+    TradeUpdateMessage trade;
+    std::memcpy(&trade, buffer + sizeof(UdpPacketHeader), sizeof(trade));
+    EXPECT_EQ(trade.aggressor_side, static_cast<uint8_t>(Side::SELL));
+    EXPECT_EQ(trade.match_timestamp_ns, match_time);
+    EXPECT_GE(trade.header.timestamp_ns, match_time);
+
+    publisher.stop();
+    close(receiver);
+    const MarketDataDelay delay = publisher.publish_delay();
+    EXPECT_EQ(delay.samples, 1u);
+    EXPECT_EQ(delay.max_ns, delay.sum_ns);
+    uint64_t bucketed = 0;
+    for (uint64_t count : delay.buckets) bucketed += count;
+    EXPECT_EQ(bucketed, 1u);
+}
+
+TEST(UdpPacketingTest, OrderEventEncodesWithoutClientIdentity) {
+    constexpr uint16_t port = 19986;
+    int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(receiver, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(bind(receiver, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    timeval timeout{1, 0};
+    setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    MarketDataLane queue(64);
+    UdpPublisher publisher("127.0.0.1", port, &queue);
+    OrderEvent order_event;
+    order_event.order_id  = 42;
+    order_event.price     = 15000;
+    order_event.remaining = 60;
+    order_event.quantity  = 40;
+    order_event.kind      = OrderEvent::EXECUTE;
+    order_event.side      = Side::SELL;
+    ASSERT_TRUE(queue.push(MarketDataEvent::make_order_event("AAPL", order_event)));
+    publisher.start();
+
+    uint8_t buffer[MD_MAX_DATAGRAM];
+    const ssize_t received = recv(receiver, buffer, sizeof(buffer), 0);
+    ASSERT_EQ(received, static_cast<ssize_t>(sizeof(UdpPacketHeader) + sizeof(OrderUpdateMessage)));
+    OrderUpdateMessage msg;
+    std::memcpy(&msg, buffer + sizeof(UdpPacketHeader), sizeof(msg));
+    EXPECT_EQ(msg.header.type, ORDER_UPDATE);
+    EXPECT_EQ(msg.header.length, sizeof(OrderUpdateMessage));
+    EXPECT_EQ(msg.header.sequence, 1u);
+    EXPECT_STREQ(msg.symbol, "AAPL");
+    EXPECT_EQ(msg.order_id, 42u);
+    EXPECT_EQ(msg.price, 15000u);
+    EXPECT_EQ(msg.remaining, 60u);
+    EXPECT_EQ(msg.quantity, 40u);
+    EXPECT_EQ(msg.kind, OrderEvent::EXECUTE);
+    EXPECT_EQ(msg.side, static_cast<uint8_t>(Side::SELL));
+
+    publisher.stop();
+    close(receiver);
+}
+
+TEST(UdpPacketingTest, SweepSummaryEncodesTheWholeSweep) {
+    constexpr uint16_t port = 19985;
+    int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(receiver, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(bind(receiver, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    timeval timeout{1, 0};
+    setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    MarketDataLane queue(64);
+    UdpPublisher publisher("127.0.0.1", port, &queue);
+    MarketDataEvent sweep{};
+    sweep.type = MarketDataEvent::SWEEP;
+    sweep.aggressor_side = static_cast<uint8_t>(Side::BUY);
+    std::strncpy(sweep.symbol, "AAPL", sizeof(sweep.symbol));
+    sweep.sweep.first_trade_id = 7;
+    sweep.sweep.first_price    = 15000;
+    sweep.sweep.last_price     = 15020;
+    sweep.sweep.quantity       = 300;
+    sweep.sweep.fills          = 3;
+    ASSERT_TRUE(queue.push(sweep));
+    publisher.start();
+
+    uint8_t buffer[MD_MAX_DATAGRAM];
+    const ssize_t received = recv(receiver, buffer, sizeof(buffer), 0);
+    ASSERT_EQ(received, static_cast<ssize_t>(sizeof(UdpPacketHeader) + sizeof(SweepSummaryMessage)));
+    SweepSummaryMessage msg;
+    std::memcpy(&msg, buffer + sizeof(UdpPacketHeader), sizeof(msg));
+    EXPECT_EQ(msg.header.type, SWEEP_SUMMARY);
+    EXPECT_EQ(msg.header.length, sizeof(SweepSummaryMessage));
+    EXPECT_STREQ(msg.symbol, "AAPL");
+    EXPECT_EQ(msg.first_trade_id, 7u);
+    EXPECT_EQ(msg.first_price, 15000u);
+    EXPECT_EQ(msg.last_price, 15020u);
+    EXPECT_EQ(msg.quantity, 300u);
+    EXPECT_EQ(msg.fills, 3u);
+    EXPECT_EQ(msg.aggressor_side, static_cast<uint8_t>(Side::BUY));
+
+    publisher.stop();
+    close(receiver);
+}
+
+TEST(UdpPacketingTest, DrainsEveryLaneKeepingEachLanesOrder) {
+    constexpr uint16_t port = 19990;
+    constexpr int per_lane = 100;  // More than one drain's worth across the two lanes
+    int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(receiver, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(bind(receiver, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    timeval timeout{1, 0};
+    setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    // One lane per engine: AAPL trades on the first, MSFT on the second
+    MarketDataLane aapl_lane(128);
+    MarketDataLane msft_lane(128);
+    UdpPublisher publisher("127.0.0.1", port, &aapl_lane);
+    publisher.add_input(&msft_lane);
+    for (int i = 1; i <= per_lane; ++i) {
+        ASSERT_TRUE(aapl_lane.push(MarketDataEvent::make_trade("AAPL", Trade(i, 1, 2, "AAPL", 100, 15000))));
+        ASSERT_TRUE(msft_lane.push(MarketDataEvent::make_trade("MSFT", Trade(i, 1, 2, "MSFT", 100, 30000))));
+    }
+    publisher.start();
+
+    uint64_t last_aapl = 0, last_msft = 0, next_sequence = 1;
+    uint8_t buffer[MD_MAX_DATAGRAM];
+    while (last_aapl < per_lane || last_msft < per_lane) {
+        const ssize_t received = recv(receiver, buffer, sizeof(buffer), 0);
+        ASSERT_GT(received, static_cast<ssize_t>(sizeof(UdpPacketHeader)));
+        UdpPacketHeader packet;
+        std::memcpy(&packet, buffer, sizeof(packet));
+        EXPECT_EQ(packet.sequence, next_sequence);
+        next_sequence += packet.message_count;
+        for (size_t m = 0; m < packet.message_count; ++m) {
+            TradeUpdateMessage msg;
+            std::memcpy(&msg, buffer + sizeof(packet) + m * sizeof(msg), sizeof(msg));
+            uint64_t& last = std::strcmp(msg.symbol, "AAPL") == 0 ? last_aapl : last_msft;
+            EXPECT_EQ(msg.trade_id, last + 1);
+            last = msg.trade_id;
+        }
+    }
+    publisher.stop();
+    close(receiver);
+    EXPECT_EQ(publisher.messages_sent(), 2u * per_lane);
+}
+
+TEST(UdpPacketingTest, EncodesInPlaceWithOnePublishTimePerBatch) {
+    constexpr uint16_t port = 19989;
+    int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(receiver, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(bind(receiver, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    timeval timeout{1, 0};
+    setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    MarketDataLane queue(64);
+    UdpPublisher publisher("127.0.0.1", port, &queue);
+    const MarketDataEvent bbo_event = MarketDataEvent::make_bbo("AAPL", 14900, 100, 15000, 200);
+    ASSERT_TRUE(queue.push(bbo_event));
+    ASSERT_TRUE(queue.push(MarketDataEvent::make_trade("AAPL", Trade(7, 1, 2, "AAPL", 50, 15000, 1234),
+                                                       static_cast<uint8_t>(Side::BUY))));
+    ASSERT_TRUE(queue.push(MarketDataEvent::make_level("AAPL", Side::SELL, 15000, 150, 2, 9)));
+    publisher.start();
+
+    uint8_t buffer[MD_MAX_DATAGRAM];
+    const ssize_t received = recv(receiver, buffer, sizeof(buffer), 0);
+    publisher.stop();
+    close(receiver);
+    ASSERT_EQ(received, static_cast<ssize_t>(sizeof(UdpPacketHeader) + sizeof(BBOUpdateMessage) +
+                                             sizeof(TradeUpdateMessage) + sizeof(DepthUpdateMessage)));
+
+    size_t offset = sizeof(UdpPacketHeader);
+    BBOUpdateMessage bbo;
+    std::memcpy(&bbo, buffer + offset, sizeof(bbo));
+    offset += sizeof(bbo);
+    TradeUpdateMessage trade;
+    std::memcpy(&trade, buffer + offset, sizeof(trade));
+    offset += sizeof(trade);
+    DepthUpdateMessage depth;
+    std::memcpy(&depth, buffer + offset, sizeof(depth));
+
+    // Byte-identical to the message built field by field
+    BBOUpdateMessage expected;
+    expected.header = UdpMessageHeader(BBO_UPDATE, sizeof(BBOUpdateMessage), 1, bbo.header.timestamp_ns);
+    std::memcpy(expected.symbol, bbo_event.symbol, sizeof(expected.symbol));
+    expected.bid_price = 14900;
+    expected.bid_quantity = 100;
+    expected.ask_price = 15000;
+    expected.ask_quantity = 200;
+    EXPECT_EQ(std::memcmp(&bbo, &expected, sizeof(bbo)), 0);
+
+    EXPECT_EQ(trade.header.type, TRADE_UPDATE);
+    EXPECT_EQ(trade.header.length, sizeof(TradeUpdateMessage));
+    EXPECT_EQ(trade.header.sequence, 2u);
+    EXPECT_EQ(trade.trade_id, 7u);
+    EXPECT_STREQ(trade.symbol, "AAPL");
+    EXPECT_EQ(trade.aggressor_side, static_cast<uint8_t>(Side::BUY));
+    EXPECT_EQ(trade.match_timestamp_ns, 1234u);
+
+    EXPECT_EQ(depth.header.type, DEPTH_UPDATE);
+    EXPECT_EQ(depth.header.sequence, 3u);
+    EXPECT_EQ(depth.update_sequence, 9u);
+    EXPECT_EQ(depth.num_bid_levels, 0);
+    ASSERT_EQ(depth.num_ask_levels, 1);
+    EXPECT_EQ(depth.levels[0].price, 15000u);
+    EXPECT_EQ(depth.levels[0].quantity, 150u);
+    EXPECT_EQ(depth.levels[1].price, 0u);  // Unused slots are zeroed
+
+    EXPECT_NE(bbo.header.timestamp_ns, 0u);
+    EXPECT_EQ(trade.header.timestamp_ns, bbo.header.timestamp_ns);
+    EXPECT_EQ(depth.header.timestamp_ns, bbo.header.timestamp_ns);
+}
+
+TEST(UdpPacketingTest, AfXdpFrameHeaderAddressesTheMulticastGroup) {
+    const uint8_t src_mac[6] = {0x02, 0x11, 0x22, 0x33, 0x44, 0x55};
+    sockaddr_in source{};
+    inet_pton(AF_INET, "10.0.0.7", &source.sin_addr);
+    sockaddr_in group{};
+    inet_pton(AF_INET, "239.129.2.3", &group.sin_addr);
+    group.sin_port = htons(30001);
+
+    auto header = AfXdpSocket::build_frame_header(src_mac, source, group, 1);
+    std::vector<uint8_t> frame(header.begin(), header.end());
+    frame.resize(frame.size() + 100);
+    AfXdpSocket::finish_frame_header(frame.data(), 100);
+
+    const uint8_t dst_mac[6] = {0x01, 0x00, 0x5e, 0x01, 0x02, 0x03};  // 239.129.2.3 low 23 bits
+    EXPECT_EQ(std::memcmp(frame.data(), dst_mac, 6), 0);
+    EXPECT_EQ(std::memcmp(frame.data() + 6, src_mac, 6), 0);
+    EXPECT_EQ(frame[12], 0x08);
+    EXPECT_EQ(frame[13], 0x00);
+
+    const uint8_t* ip = frame.data() + 14;
+    EXPECT_EQ(ip[0], 0x45);
+    EXPECT_EQ(ip[2] << 8 | ip[3], 20 + 8 + 100);
+    EXPECT_EQ(ip[8], 1);
+    EXPECT_EQ(ip[9], IPPROTO_UDP);
+    EXPECT_EQ(std::memcmp(ip + 12, &source.sin_addr, 4), 0);
+    EXPECT_EQ(std::memcmp(ip + 16, &group.sin_addr, 4), 0);
+    uint32_t sum = 0;  // A valid header sums to 0xffff, checksum included
+    for (int i = 0; i < 20; i += 2) sum += ip[i] << 8 | ip[i + 1];
+    while (sum >> 16) sum = (sum & 0xffff) + (sum >> 16);
+    EXPECT_EQ(sum, 0xffffu);
+
+    const uint8_t* udp = ip + 20;
+    EXPECT_EQ(udp[0] << 8 | udp[1], 30001);  // Source port defaults to the group's
+    EXPECT_EQ(udp[2] << 8 | udp[3], 30001);
+    EXPECT_EQ(udp[4] << 8 | udp[5], 8 + 100);
+}
+
+TEST(UdpPacketingTest, FallsBackToTheKernelPathWithoutAfXdp) {
+    constexpr uint16_t port = 19988;
+    int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(receiver, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    ASSERT_EQ(bind(receiver, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+    timeval timeout{1, 0};
+    setsockopt(receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    MarketDataLane queue(64);
+    UdpPublisher publisher("127.0.0.1", port, &queue);
+    AfXdpSocket::Options xdp;
+    xdp.interface = "rtes-none0";
+    publisher.set_af_xdp(xdp);
+    ASSERT_TRUE(queue.push(MarketDataEvent::make_trade("AAPL", Trade(1, 1, 2, "AAPL", 100, 15000))));
+    publisher.start();
+    EXPECT_FALSE(publisher.af_xdp_active());
+
+    uint8_t buffer[MD_MAX_DATAGRAM];
+    EXPECT_EQ(recv(receiver, buffer, sizeof(buffer), 0),
+              static_cast<ssize_t>(sizeof(UdpPacketHeader) + sizeof(TradeUpdateMessage)));
+    publisher.stop();
+    close(receiver);
+    EXPECT_EQ(publisher.messages_sent(), 1u);
+    EXPECT_EQ(publisher.send_failures(), 0u);
+}
+
+} // namespace rtes
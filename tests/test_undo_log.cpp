@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include "rtes/undo_log.hpp"
+#include "rtes/order_id_map.hpp"
+
+#include <type_traits>
+
+namespace rtes {
+
+TEST(UndoLogTest, RollbackRestoresFieldsNewestFirst) {
+    uint64_t exposure = 1000;
+    uint32_t open     = 7;
+    int16_t  net      = -3;
+    double   price    = 1.5;
+    {
+        UndoLog<8> undo;
+        undo.add(exposure, 250u);
+        undo.add(exposure, 50u);  // Same field twice: the older saved value wins
+        undo.set(open, 9u);
+        undo.add(net, 5);
+        undo.set(price, 2.25);
+        EXPECT_EQ(undo.size(), 5u);
+        EXPECT_EQ(exposure, 1300u);
+        EXPECT_EQ(open, 9u);
+        EXPECT_EQ(net, 2);
+        undo.rollback();
+        EXPECT_EQ(undo.size(), 0u);
+    }
+    EXPECT_EQ(exposure, 1000u);
+    EXPECT_EQ(open, 7u);
+    EXPECT_EQ(net, -3);
+    EXPECT_EQ(price, 1.5);
+}
+
+TEST(UndoLogTest, ScopeExitRollsBackUnlessCommitted) {
+    uint64_t value = 10;
+    {
+        UndoLog<2> undo;
+        undo.add(value, 5u);
+    }
+    EXPECT_EQ(value, 10u);
+    {
+        UndoLog<2> undo;
+        undo.add(value, 5u);
+        undo.commit();
+    }
+    EXPECT_EQ(value, 15u);
+}
+
+TEST(UndoLogTest, CompensationUndoesAnInsert) {
+    OrderIdMap<uint64_t> index(16);
+    uint64_t total = 0;
+    {
+        UndoLog<2> undo;
+        ASSERT_TRUE(index.insert(42, 100));
+        undo.on_rollback<[](OrderIdMap<uint64_t>& map, uint64_t id) { map.erase(id); }>(index, 42);
+        undo.add(total, 100u);
+        EXPECT_TRUE(index.contains(42));
+    }
+    EXPECT_FALSE(index.contains(42));
+    EXPECT_EQ(total, 0u);
+}
+
+TEST(UndoLogTest, LivesOnTheStack) {
+    static_assert(UndoLog<4>::capacity() == 4);
+    static_assert(!std::is_copy_constructible_v<UndoLog<4>>);
+    EXPECT_LE(sizeof(UndoLog<4>), 4 * 3 * sizeof(uint64_t) + sizeof(size_t));
+}
+
+} // namespace rtes
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "rtes/workload.hpp"
+#include "rtes/memory_pool.hpp"
+#include "rtes/order_book.hpp"
+
+#include <map>
+#include <vector>
+
+namespace rtes {
+
+namespace {
+
+std::vector<WorkloadRequest> generate(const WorkloadOptions& options, size_t count) {
+    WorkloadGenerator generator(options);
+    std::vector<WorkloadRequest> stream;
+    for (size_t i = 0; i < count; ++i) stream.push_back(generator.next());
+    return stream;
+}
+
+} // namespace
+
+TEST(WorkloadTest, ProfileNamesRoundTrip) {
+    for (WorkloadProfile profile : ALL_WORKLOAD_PROFILES) {
+        EXPECT_EQ(WorkloadGenerator::parse_profile(WorkloadGenerator::profile_name(profile)), profile);
+    }
+    EXPECT_FALSE(WorkloadGenerator::parse_profile("random"));
+}
+
+TEST(WorkloadTest, SameSeedSameStreamAndSequentialIds) {
+    WorkloadOptions options;
+    options.profile = WorkloadProfile::ZIPF;
+    const auto first = generate(options, 5000);
+    const auto second = generate(options, 5000);
+    OrderID next_id = 1;
+    for (size_t i = 0; i < first.size(); ++i) {
+        ASSERT_EQ(first[i].type, second[i].type);
+        ASSERT_EQ(first[i].id, second[i].id);
+        ASSERT_EQ(first[i].price, second[i].price);
+        ASSERT_EQ(first[i].price % options.tick, 0u);
+        if (first[i].type == WorkloadRequest::NEW_ORDER) {
+            ASSERT_EQ(first[i].id, next_id++);
+        }
+    }
+}
+
+TEST(WorkloadTest, MarketMakerCancelsMostQuotes) {
+    WorkloadOptions options;
+    options.profile = WorkloadProfile::MARKET_MAKER;
+    size_t quotes = 0, cancels = 0, takers = 0;
+    for (const auto& request : generate(options, 200000)) {
+        if (request.type == WorkloadRequest::CANCEL) ++cancels;
+        else if (request.order_type == OrderType::LIMIT) ++quotes;
+        else ++takers;
+    }
+    EXPECT_NEAR(static_cast<double>(cancels) / quotes, 0.95, 0.01);
+    EXPECT_NEAR(static_cast<double>(takers) / quotes, 0.05, 0.01);
+}
+
+TEST(WorkloadTest, ZipfConcentratesOnTheFirstSymbols) {
+    WorkloadOptions options;
+    options.profile = WorkloadProfile::ZIPF;
+    std::vector<size_t> per_symbol(options.symbol_count);
+    for (const auto& request : generate(options, 100000)) ++per_symbol[request.symbol];
+    EXPECT_GT(per_symbol[0], per_symbol[1]);
+    EXPECT_GT(per_symbol[0], per_symbol.back() * 5);  // 8^1.1 ≈ 9.8 expected
+}
+
+TEST(WorkloadTest, AuctionFloodIsBracketedByPhaseChanges) {
+    WorkloadOptions options;
+    options.profile = WorkloadProfile::AUCTION_OPEN;
+    options.auction_orders = 100;
+    const auto stream = generate(options, 300);
+    ASSERT_EQ(stream[0].type, WorkloadRequest::SET_PHASE);
+    EXPECT_EQ(stream[0].phase, TradingPhase::AUCTION);
+    for (size_t i = 1; i <= 100; ++i) {
+        ASSERT_EQ(stream[i].type, WorkloadRequest::NEW_ORDER);
+        ASSERT_EQ(stream[i].symbol, stream[0].symbol);
+    }
+    ASSERT_EQ(stream[101].type, WorkloadRequest::SET_PHASE);
+    EXPECT_EQ(stream[101].phase, TradingPhase::CONTINUOUS);
+    for (size_t i = 102; i < 202; ++i) EXPECT_EQ(stream[i].type, WorkloadRequest::CANCEL);
+}
+
+TEST(WorkloadTest, MomentumBurstSweepsTheConfiguredLevels) {
+    WorkloadOptions options;
+    options.profile = WorkloadProfile::MOMENTUM;
+    options.symbol_count = 1;
+    options.sweep_levels = 20;
+    OrderPool pool(10000);
+    OrderBook book("SYM0", pool, nullptr, nullptr, {});
+
+    std::vector<Price> sweep_prices;
+    WorkloadGenerator generator(options);
+    for (size_t bursts = 0; bursts < 10;) {
+        const WorkloadRequest request = generator.next();
+        if (request.type == WorkloadRequest::CANCEL) {
+            EXPECT_TRUE(book.cancel_order(request.id).has_value());  // Swept orders are not cancelled
+            continue;
+        }
+        ASSERT_EQ(request.type, WorkloadRequest::NEW_ORDER);
+        Order* order = pool.allocate();
+        new (order) Order(request.id, "100", "SYM0", request.side, request.order_type, request.quantity, request.price);
+        const Price touch = request.side == Side::BUY ? book.best_ask() : book.best_bid();
+        ASSERT_TRUE(book.add_order(order).has_value());
+        if (request.order_type != OrderType::IOC) continue;
+
+        EXPECT_EQ(order->status, OrderStatus::FILLED);
+        const Price through = request.side == Side::BUY ? request.price - touch : touch - request.price;
+        EXPECT_EQ(through, 19 * options.tick);  // The touch and 19 levels behind it
+        pool.deallocate(order);
+        ++bursts;
+    }
+}
+
+} // namespace rtes
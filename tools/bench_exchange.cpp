@@ -1,5 +1,9 @@
 #include "rtes/strategies.hpp"
+#include "rtes/latency_histogram.hpp"
+#include "rtes/workload.hpp"
+#include <algorithm>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <thread>
 #include <chrono>
@@ -7,6 +11,128 @@
 
 using namespace rtes;
 
+/**
+ * Sends a workload profile's stream (see workload.hpp) at a fixed rate
+ * and times each new order from its send to the first response for it.
+ * Ids line up: the profile numbers new orders 1, 2, 3... as ClientBase
+ * does. Phase changes are not client messages; they are counted and
+ * skipped, so an auction flood arrives as a burst of crossing orders.
+ */
+class WorkloadClient : public ClientBase {
+public:
+    WorkloadClient(const std::string& host, uint16_t port, uint32_t client_id, size_t capacity)
+        : ClientBase(host, port, client_id), capacity_(capacity),
+          sent_(std::make_unique<std::atomic<int64_t>[]>(capacity)),
+          answered_(std::make_unique<std::atomic<bool>[]>(capacity)) {}
+
+    /** Send `rate` requests/s for `duration`; false if the connection failed */
+    bool run_profile(WorkloadGenerator& generator, double rate, std::chrono::seconds duration) {
+        if (!connect()) return false;
+        start_receiver();
+        const auto& symbols = generator.symbols();
+        const auto gap = std::chrono::nanoseconds(static_cast<int64_t>(1e9 / rate));
+        const auto start = std::chrono::steady_clock::now();
+        auto due = start;
+        while (std::chrono::steady_clock::now() - start < duration) {
+            const WorkloadRequest request = generator.next();
+            due += gap;
+            std::this_thread::sleep_until(due);
+            if (!send_request(request, symbols)) break;
+        }
+        seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::this_thread::sleep_for(std::chrono::seconds(1));  // Let the last responses in
+        stop_receiver();
+        disconnect();
+        return true;
+    }
+
+    /** Receiver thread's histogram: read after run_profile() */
+    const LatencyHistogram& histogram() const { return histogram_; }
+    uint64_t cancels_sent() const { return cancels_sent_; }
+    uint64_t phases_skipped() const { return phases_skipped_; }
+    double   seconds() const { return seconds_; }
+
+protected:
+    void on_tick() override {}
+
+    void on_order_ack(const OrderAckMessage& ack) override { record(ack.order_id); }
+
+    void on_trade(const TradeMessage& trade) override {
+        record(trade.buy_order_id);
+        record(trade.sell_order_id);
+    }
+
+private:
+    /** False once a new order's id is past the send-time table: the run is over */
+    bool send_request(const WorkloadRequest& request, const std::vector<std::string>& symbols) {
+        switch (request.type) {
+            case WorkloadRequest::NEW_ORDER:
+                if (request.id > capacity_) return false;
+                sent_[request.id - 1].store(static_cast<int64_t>(ProtocolUtils::get_timestamp_ns()),
+                                            std::memory_order_release);
+                send_new_order(symbols[request.symbol], request.side, request.quantity,
+                               request.price, request.order_type);
+                break;
+            case WorkloadRequest::CANCEL:
+                send_cancel_order(request.id, symbols[request.symbol]);
+                ++cancels_sent_;
+                break;
+            case WorkloadRequest::SET_PHASE:
+                ++phases_skipped_;
+                break;
+        }
+        return true;
+    }
+
+    void record(uint64_t order_id) {
+        const auto now = static_cast<int64_t>(ProtocolUtils::get_timestamp_ns());
+        if (order_id == 0 || order_id > capacity_) return;
+        const size_t index = order_id - 1;
+        const int64_t sent = sent_[index].load(std::memory_order_acquire);
+        if (sent == 0 || answered_[index].exchange(true, std::memory_order_relaxed)) return;
+        histogram_.record(static_cast<uint64_t>(std::max<int64_t>(0, now - sent)));
+    }
+
+    size_t capacity_;
+    std::unique_ptr<std::atomic<int64_t>[]> sent_;  // Indexed by order id - 1
+    std::unique_ptr<std::atomic<bool>[]>    answered_;
+    LatencyHistogram histogram_;
+    uint64_t cancels_sent_{0};
+    uint64_t phases_skipped_{0};
+    double   seconds_{0};
+};
+
+int run_workload(const std::string& host, uint16_t port, WorkloadOptions options,
+                 double rate, int duration_s) {
+    WorkloadGenerator generator(options);
+    WorkloadClient client(host, port, 9999, static_cast<size_t>(rate * duration_s) + 1);
+    std::cout << "Profile: " << WorkloadGenerator::profile_name(options.profile)
+              << " at " << rate << " requests/sec for " << duration_s << " s\n";
+    if (!client.run_profile(generator, rate, std::chrono::seconds(duration_s))) {
+        std::cerr << "Failed to connect to exchange\n";
+        return 1;
+    }
+
+    const LatencyHistogram& latency = client.histogram();
+    std::cout << "\n=== Benchmark Results ===\n";
+    std::cout << "Orders sent: " << client.orders_sent() << "\n";
+    std::cout << "Cancels sent: " << client.cancels_sent() << "\n";
+    if (client.phases_skipped()) std::cout << "Phase changes skipped: " << client.phases_skipped() << "\n";
+    std::cout << "Responses: " << client.orders_acked() << " accepted, " << client.orders_rejected()
+              << " rejected/cancelled/filled, " << client.trades_received() << " trades\n";
+    if (client.seconds() > 0) {
+        std::cout << "Throughput: " << (client.orders_sent() + client.cancels_sent()) / client.seconds()
+                  << " requests/sec\n";
+    }
+    std::cout << "Order latency (send to first response, " << latency.count() << " orders):\n";
+    std::cout << "  p50: " << latency.percentile(50) / 1000.0 << " μs\n";
+    std::cout << "  p90: " << latency.percentile(90) / 1000.0 << " μs\n";
+    std::cout << "  p99: " << latency.percentile(99) / 1000.0 << " μs\n";
+    std::cout << "  p99.9: " << latency.percentile(99.9) / 1000.0 << " μs\n";
+    std::cout << "  max: " << latency.max_ns() / 1000.0 << " μs\n";
+    return 0;
+}
+
 std::vector<std::string> split_symbols(const std::string& symbols_str) {
     std::vector<std::string> symbols;
     std::stringstream ss(symbols_str);
@@ -22,8 +148,12 @@ std::vector<std::string> split_symbols(const std::string& symbols_str) {
 int main(int argc, char* argv[]) {
     std::string symbols_str = "AAPL,MSFT";
     int num_orders = 1000000;
-    std::string host = "localhost";
+    std::string host = "127.0.0.1";
     uint16_t port = 8888;
+    std::string profile_name;
+    WorkloadOptions workload;
+    double rate = 20000;
+    int duration_s = 10;
     
     // Parse command line arguments
     for (int i = 1; i < argc; i += 2) {
@@ -41,6 +171,22 @@ int main(int argc, char* argv[]) {
             host = argv[i + 1];
         } else if (arg == "--port") {
             port = std::stoi(argv[i + 1]);
+        } else if (arg == "--profile") {
+            profile_name = argv[i + 1];
+        } else if (arg == "--rate") {
+            rate = std::stod(argv[i + 1]);
+        } else if (arg == "--duration") {
+            duration_s = std::stoi(argv[i + 1]);
+        } else if (arg == "--mid") {
+            workload.mid = price_from_double(std::stod(argv[i + 1]));
+        } else if (arg == "--cancel-ratio") {
+            workload.cancel_ratio = std::stod(argv[i + 1]);
+        } else if (arg == "--zipf") {
+            workload.zipf_exponent = std::stod(argv[i + 1]);
+        } else if (arg == "--sweep-levels") {
+            workload.sweep_levels = std::stoull(argv[i + 1]);
+        } else if (arg == "--auction-orders") {
+            workload.auction_orders = std::stoull(argv[i + 1]);
         }
     }
     
@@ -50,6 +196,23 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    if (!profile_name.empty()) {
+        const auto profile = WorkloadGenerator::parse_profile(profile_name);
+        if (!profile || rate <= 0 || duration_s <= 0) {
+            std::cerr << "Usage: --profile uniform|market_maker|zipf|momentum|auction_open"
+                         " [--rate <requests/s>] [--duration <s>] [--mid <price>]\n";
+            return 1;
+        }
+        workload.profile = *profile;
+        workload.symbols = symbols;
+        try {
+            return run_workload(host, port, workload, rate, duration_s);
+        } catch (const std::invalid_argument& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+    }
+
     std::cout << "Exchange Benchmark\n";
     std::cout << "Symbols: " << symbols_str << "\n";
     std::cout << "Target orders: " << num_orders << "\n";
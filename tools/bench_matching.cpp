@@ -1,111 +1,287 @@
-#include "rtes/matching_engine.hpp"
+#include "rtes/latency_histogram.hpp"
 #include "rtes/memory_pool.hpp"
+#include "rtes/order_book.hpp"
+#include "rtes/perf_counters.hpp"
+#include "rtes/workload.hpp"
 #include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
-#include <random>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Matching benchmark over the workload profiles (see workload.hpp).
+ *
+ * Each profile's request stream is generated up front, then applied to
+ * one OrderBook per symbol on this thread. Every request is timed on its
+ * own, so the percentiles are the book's cost per request (plus ~20 ns
+ * of clock reads), not a queue's. Throughput is requests over the wall
+ * time of the loop.
+ *
+ * With --counters the loop is also wrapped in hardware counters
+ * (perf_counters.hpp) and the counts are reported per request. They
+ * include the two clock reads around every request.
+ */
 
 namespace rtes {
 
-void benchmark_matching_engine() {
-    constexpr size_t num_orders = 50000;
-    // Worst case: every order rests with no matches → need num_orders pool slots.
-    constexpr size_t pool_size = num_orders + 1024;
-    // Each order can generate at most one trade + one BBO event.
-    constexpr size_t md_queue_size = num_orders * 2 + 1024;
-
-    OrderPool pool(pool_size);
-    MPMCQueue<MarketDataEvent> market_data_queue(md_queue_size);
-    MatchingEngine engine("AAPL", pool);
-
-    engine.set_market_data_queue(&market_data_queue);
-    engine.start();
-
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> side_dist(1, 2);
-    std::uniform_int_distribution<> price_dist(14900, 15100);
-    std::uniform_int_distribution<> qty_dist(100, 1000);
-
-    auto start = std::chrono::high_resolution_clock::now();
-
-    size_t submitted = 0;
-    size_t push_fails = 0;
-    for (size_t i = 0; i < num_orders; ++i) {
-        auto* order = pool.allocate();
-        if (!order) {
-            std::cerr << "POOL EXHAUSTED at " << i << std::endl;
-            while (!(order = pool.allocate()))
-                std::this_thread::sleep_for(std::chrono::microseconds(10));
-        }
+struct ProfileResult {
+    WorkloadProfile  profile{WorkloadProfile::UNIFORM};
+    size_t           requests{0};
+    double           seconds{0};
+    uint64_t         trades{0};
+    uint64_t         rejects{0};   // Cancels that missed, refused orders
+    uint64_t         pool_exhausted{0};
+    LatencyHistogram all;
+    LatencyHistogram by_type[3];   // Indexed by WorkloadRequest::Type
+    PerfCounterSample counters;    // Empty unless --counters
+};
+
+void count_trade(const Trade&, void* ctx) { ++*static_cast<uint64_t*>(ctx); }
+
+ProfileResult run_profile(const WorkloadOptions& options, size_t requests, const OrderBookOptions& book_options,
+                          PerfCounters* counters) {
+    WorkloadGenerator generator(options);
+    std::vector<WorkloadRequest> stream;
+    stream.reserve(requests);
+    for (size_t i = 0; i < requests; ++i) stream.push_back(generator.next());
+
+    ProfileResult result;
+    result.profile = options.profile;
+    result.requests = requests;
 
-        Side side = (side_dist(gen) == 1) ? Side::BUY : Side::SELL;
-        Price price = price_dist(gen);
-        Quantity qty = qty_dist(gen);
-
-        order->id = i + 1;
-        order->client_id.assign("100");
-        order->symbol.assign("AAPL");
-        order->side = side;
-        order->type = OrderType::LIMIT;
-        order->quantity = qty;
-        order->price = price;
-        order->remaining_quantity = qty;
-        order->status = OrderStatus::PENDING;
-
-        int retries = 0;
-        while (!engine.submit_order(order)) {
-            ++push_fails;
-            ++retries;
-            std::this_thread::sleep_for(std::chrono::microseconds(1));
-            if (retries > 1000) {
-                std::cerr << "PUSH FAILED after 1000 retries at order " << i << std::endl;
+    // Worst case every order rests (uniform never cancels)
+    OrderPool pool(std::min<size_t>(requests, size_t{1} << 22) + 1024);
+    std::vector<std::unique_ptr<OrderBook>> books;
+    for (const auto& symbol : generator.symbols()) {
+        books.push_back(std::make_unique<OrderBook>(symbol, pool, &count_trade, &result.trades, book_options));
+    }
+
+    if (counters) counters->start();
+    const auto start = std::chrono::steady_clock::now();
+    for (const WorkloadRequest& request : stream) {
+        OrderBook& book = *books[request.symbol];
+        const auto t0 = std::chrono::steady_clock::now();
+        switch (request.type) {
+            case WorkloadRequest::NEW_ORDER: {
+                Order* order = pool.allocate();
+                if (!order) {
+                    ++result.pool_exhausted;
+                    continue;
+                }
+                new (order) Order(request.id, "100", generator.symbols()[request.symbol].c_str(),
+                                  request.side, request.order_type, request.quantity, request.price);
+                if (!book.add_order(order).has_value()) {
+                    ++result.rejects;
+                    pool.deallocate(order);
+                } else if (order->status == OrderStatus::FILLED || order->status == OrderStatus::CANCELLED) {
+                    pool.deallocate(order);  // Aggressor that did not rest
+                }
                 break;
             }
+            case WorkloadRequest::CANCEL:
+                if (!book.cancel_order(request.id).has_value()) ++result.rejects;
+                break;
+            case WorkloadRequest::SET_PHASE:
+                if (request.phase == TradingPhase::AUCTION) book.begin_auction();
+                else                                        (void)book.uncross();
+                break;
         }
+        const auto elapsed = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count());
+        result.all.record(elapsed);
+        result.by_type[request.type].record(elapsed);
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (counters) result.counters = counters->stop();
+    return result;
+}
 
-        ++submitted;
+void print_row(const char* name, const LatencyHistogram& histogram, double seconds) {
+    std::cout << "  " << std::left << std::setw(14) << name << std::right
+              << std::setw(10) << histogram.count();
+    if (seconds > 0) std::cout << std::setw(14) << static_cast<uint64_t>(histogram.count() / seconds);
+    else             std::cout << std::setw(14) << "";
+    for (double p : {50.0, 90.0, 99.0, 99.9}) std::cout << std::setw(10) << histogram.percentile(p);
+    std::cout << std::setw(12) << histogram.max_ns() << "\n";
+}
+
+void print_result(const ProfileResult& result) {
+    std::cout << WorkloadGenerator::profile_name(result.profile) << ": "
+              << result.trades << " trades, " << result.rejects << " rejects";
+    if (result.pool_exhausted) std::cout << ", " << result.pool_exhausted << " orders dropped (pool exhausted)";
+    std::cout << "\n";
+    std::cout << "  " << std::left << std::setw(14) << "request" << std::right << std::setw(10) << "count"
+              << std::setw(14) << "requests/s" << std::setw(10) << "p50 ns" << std::setw(10) << "p90"
+              << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(12) << "max" << "\n";
+    print_row("all", result.all, result.seconds);
+    const char* names[] = {"new_order", "cancel", "set_phase"};
+    for (size_t type = 0; type < 3; ++type) {
+        if (result.by_type[type].count()) print_row(names[type], result.by_type[type], 0);
     }
-    std::cout << "Submitted: " << submitted << ", Push fails: " << push_fails << std::endl;
-
-    // Wait for the engine to process every submitted order (with timeout)
-    auto wait_start = std::chrono::high_resolution_clock::now();
-    size_t processed = engine.orders_processed();
-    while (engine.orders_processed() < submitted) {
-        std::this_thread::sleep_for(std::chrono::microseconds(10));
-        auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::high_resolution_clock::now() - wait_start);
-        if (waited > std::chrono::milliseconds(5000)) {
-            std::cerr << "TIMEOUT waiting for processing. Processed: " 
-                      << engine.orders_processed() << "/" << submitted << std::endl;
-            break;
+    if (!result.counters.empty()) {
+        std::cout << "  per request:" << std::fixed << std::setprecision(2);
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            const auto event = static_cast<PerfEvent>(i);
+            if (result.counters.has(event)) {
+                std::cout << " " << perf_event_name(event) << " " << result.counters.per(result.requests, event);
+            }
         }
+        if (result.counters.ipc() > 0) std::cout << ", ipc " << result.counters.ipc();
+        if (result.counters.multiplexed) std::cout << " (multiplexed)";
+        std::cout << "\n";
+        std::cout.unsetf(std::ios::floatfield);
     }
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
-
-    engine.stop();
-
-    std::cout << "Matching Engine Benchmark:\n";
-    std::cout << "  Orders submitted:   " << submitted << "\n";
-    std::cout << "  Orders processed:   " << engine.orders_processed() << "\n";
-    std::cout << "  Trades executed:    " << engine.trades_executed() << "\n";
-    std::cout << "  Total time:         " << duration.count() / 1000.0 << " ms\n";
-    std::cout << "  Avg latency:        " << duration.count() / (double)submitted << " μs/order\n";
-    std::cout << "  Throughput:         " << (submitted * 1e6) / duration.count() << " orders/sec\n";
-
-    MarketDataEvent event;
-    size_t md_events = 0;
-    while (market_data_queue.pop(event)) ++md_events;
-    std::cout << "  Market data events: " << md_events << "\n";
+    std::cout << "\n";
+}
+
+void write_histogram(std::ostream& out, const LatencyHistogram& histogram) {
+    out << "{\"count\": " << histogram.count() << ", \"mean_ns\": " << histogram.mean_ns()
+        << ", \"p50_ns\": " << histogram.percentile(50) << ", \"p90_ns\": " << histogram.percentile(90)
+        << ", \"p99_ns\": " << histogram.percentile(99) << ", \"p999_ns\": " << histogram.percentile(99.9)
+        << ", \"max_ns\": " << histogram.max_ns() << "}";
+}
+
+/** Results as JSON, for tools/perf_gate.py */
+bool write_json(const std::string& path, const std::vector<ProfileResult>& results) {
+    std::ofstream out(path);
+    const char* names[] = {"new_order", "cancel", "set_phase"};
+    out << "{\"profiles\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const ProfileResult& result = results[i];
+        out << "  {\"profile\": \"" << WorkloadGenerator::profile_name(result.profile) << "\""
+            << ", \"requests\": " << result.requests
+            << ", \"requests_per_second\": " << std::fixed << std::setprecision(1)
+            << (result.seconds > 0 ? result.requests / result.seconds : 0.0)
+            << ", \"trades\": " << result.trades << ", \"rejects\": " << result.rejects
+            << ",\n   \"latency\": ";
+        write_histogram(out, result.all);
+        for (size_t type = 0; type < 3; ++type) {
+            if (!result.by_type[type].count()) continue;
+            out << ",\n   \"" << names[type] << "\": ";
+            write_histogram(out, result.by_type[type]);
+        }
+        if (!result.counters.empty()) {
+            out << ",\n   \"counters_per_request\": {";
+            const char* separator = "";
+            for (size_t e = 0; e < PERF_EVENT_COUNT; ++e) {
+                const auto event = static_cast<PerfEvent>(e);
+                if (!result.counters.has(event)) continue;
+                out << separator << "\"" << perf_event_name(event) << "\": "
+                    << std::setprecision(4) << result.counters.per(result.requests, event);
+                separator = ", ";
+            }
+            out << "}, \"multiplexed\": " << (result.counters.multiplexed ? "true" : "false")
+                << std::setprecision(1);
+        }
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]}\n";
+    return static_cast<bool>(out);
+}
+
+void usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --profile <name|all>    uniform, market_maker, zipf, momentum, auction_open (default: all)\n"
+              << "  --requests <n>          Requests per profile (default: 1000000)\n"
+              << "  --symbols <n>           Books (default: 8)\n"
+              << "  --cancel-ratio <r>      market_maker cancels per quote (default: 0.95)\n"
+              << "  --zipf <s>              Symbol popularity exponent (default: 1.1 for zipf, else uniform)\n"
+              << "  --sweep-levels <n>      Levels a momentum burst sweeps (default: 20)\n"
+              << "  --auction-orders <n>    Orders per auction call (default: 5000)\n"
+              << "  --seed <n>              Generator seed (default: 42)\n"
+              << "  --tick-ladder           Tick-ladder price index (default: sorted vector)\n"
+              << "  --intrusive-levels      Intrusive level queues (default: vectors)\n"
+              << "  --counters              Hardware counters per request (cycles, instructions, L1d/LLC/dTLB\n"
+              << "                          and branch misses)\n"
+              << "  --json <file>           Also write the results as JSON\n";
 }
 
 } // namespace rtes
 
-int main() {
-    std::cout << "Matching Engine Benchmarks\n";
-    std::cout << "===========================\n\n";
+int main(int argc, char* argv[]) {
+    using namespace rtes;
 
-    rtes::benchmark_matching_engine();
+    WorkloadOptions options;
+    OrderBookOptions book_options;
+    std::vector<WorkloadProfile> profiles(ALL_WORKLOAD_PROFILES.begin(), ALL_WORKLOAD_PROFILES.end());
+    size_t requests = 1000000;
+    std::string json_path;
+    bool use_counters = false;
 
-    return 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--profile" && has_value) {
+            const std::string name = argv[++i];
+            if (name != "all") {
+                const auto profile = WorkloadGenerator::parse_profile(name);
+                if (!profile) {
+                    std::cerr << "Unknown profile: " << name << "\n";
+                    return EXIT_FAILURE;
+                }
+                profiles = {*profile};
+            }
+        } else if (arg == "--requests" && has_value) {
+            requests = std::stoull(argv[++i]);
+        } else if (arg == "--symbols" && has_value) {
+            options.symbol_count = std::stoull(argv[++i]);
+        } else if (arg == "--cancel-ratio" && has_value) {
+            options.cancel_ratio = std::stod(argv[++i]);
+        } else if (arg == "--zipf" && has_value) {
+            options.zipf_exponent = std::stod(argv[++i]);
+        } else if (arg == "--sweep-levels" && has_value) {
+            options.sweep_levels = std::stoull(argv[++i]);
+        } else if (arg == "--auction-orders" && has_value) {
+            options.auction_orders = std::stoull(argv[++i]);
+        } else if (arg == "--seed" && has_value) {
+            options.seed = std::stoull(argv[++i]);
+        } else if (arg == "--tick-ladder") {
+            book_options.tick_ladder = true;
+        } else if (arg == "--intrusive-levels") {
+            book_options.intrusive_levels = true;
+        } else if (arg == "--counters") {
+            use_counters = true;
+        } else if (arg == "--json" && has_value) {
+            json_path = argv[++i];
+        } else {
+            usage(argv[0]);
+            return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    book_options.tick = options.tick;
+
+    std::cout << "Matching Benchmark: " << requests << " requests per profile, "
+              << options.symbol_count << " symbols, "
+              << (book_options.tick_ladder ? "tick ladder" : "sorted vector") << ", "
+              << (book_options.intrusive_levels ? "intrusive" : "vector") << " levels\n\n";
+
+    std::unique_ptr<PerfCounters> counters;
+    if (use_counters) {
+        counters = std::make_unique<PerfCounters>();
+        if (!counters->available()) {
+            std::cerr << "Hardware counters unavailable (" << counters->error() << "); continuing without\n\n";
+            counters.reset();
+        }
+    }
+
+    std::vector<ProfileResult> results;
+    for (WorkloadProfile profile : profiles) {
+        options.profile = profile;
+        try {
+            results.push_back(run_profile(options, requests, book_options, counters.get()));
+        } catch (const std::invalid_argument& e) {
+            std::cerr << WorkloadGenerator::profile_name(profile) << ": " << e.what() << "\n";
+            return EXIT_FAILURE;
+        }
+        print_result(results.back());
+    }
+    if (!json_path.empty() && !write_json(json_path, results)) {
+        std::cerr << "Failed to write " << json_path << "\n";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
 }
@@ -0,0 +1,392 @@
+/**
+ * @file bench_micro.cpp
+ * @brief Microbenchmarks of the book structures, queues and pools
+ *
+ * Google Benchmark suite comparing the structural choices that are
+ * fixed per symbol or per component:
+ *
+ *   book/<index>/<levels>      OrderBook rest/match/cancel churn over
+ *                              FlatPriceBook backend × FlatLevel mode
+ *   level_lookup/<index>       FlatPriceBook::find at a given depth
+ *   level_cancel/<levels>      One level's life: queue, cancel, drain
+ *   order_index/<map>          OrderIdMap vs std::unordered_map
+ *   spsc|mpmc/<op>             Single vs bulk push/pop, same thread
+ *                              and handed across threads
+ *   pool/<magazines>           MemoryPool allocate/free per thread
+ *
+ * Inputs are seeded, so runs on one machine are comparable. For a
+ * result file to track across releases:
+ *
+ *   ./bench_micro --benchmark_out=micro.json --benchmark_out_format=json
+ *   ./bench_micro --benchmark_filter='^book/' --benchmark_repetitions=5
+ */
+
+#include "rtes/matching_engine.hpp"
+#include "rtes/memory_pool.hpp"
+#include "rtes/mpmc_queue.hpp"
+#include "rtes/order_book.hpp"
+#include "rtes/order_id_map.hpp"
+#include "rtes/spsc_queue.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace rtes {
+namespace {
+
+constexpr Price BOOK_MID = 100 * PRICE_SCALE;
+constexpr Quantity ORDER_QTY = 100;
+constexpr uint32_t SEED = 42;
+
+Order* make_order(OrderPool& pool, OrderID id, Side side, Price price, OrderType type = OrderType::LIMIT) {
+    Order* order = pool.allocate();
+    if (order) new (order) Order(id, "100", "AAPL", side, type, ORDER_QTY, price);
+    return order;
+}
+
+/** Spin on a full/empty queue; yield now and then so one core still makes progress */
+void backoff(uint32_t& spins) {
+    if ((++spins & 63) == 0) std::this_thread::yield();
+}
+
+// ─── OrderBook churn ───
+
+/**
+ * A book `depth` ticks deep per side with `orders_per_level` equal-size
+ * orders queued at each tick. Each iteration either cancels a random
+ * resting order (cancel_pct %) or sends an order that takes the front
+ * of one best level, then rests a replacement on the same side at a
+ * random tick — the book keeps its shape for the whole run.
+ */
+class ChurnBook {
+public:
+    ChurnBook(size_t depth, size_t orders_per_level, const OrderBookOptions& options)
+        : pool_(depth * orders_per_level * 2 + 1024)
+        , book_("AAPL", pool_, nullptr, this, options)
+        , slot_of_(depth * orders_per_level * 2 + 1024)
+        , depth_(depth)
+        , tick_(options.tick)
+        , rng_(SEED) {
+        book_.set_order_done_callback(&ChurnBook::on_done);
+        for (size_t level = 1; level <= depth; ++level) {
+            for (size_t i = 0; i < orders_per_level; ++i) {
+                rest(Side::BUY, level);
+                rest(Side::SELL, level);
+            }
+        }
+    }
+
+    void cancel_random() {
+        const Resting victim = live_[rng_() % live_.size()];
+        (void)book_.cancel_order(victim.id);
+        rest(victim.side, 1 + rng_() % depth_);
+    }
+
+    void take_best() {
+        const Side passive = (rng_() & 1) ? Side::BUY : Side::SELL;
+        const Price price = passive == Side::BUY ? book_.best_bid() : book_.best_ask();
+        Order* order = make_order(pool_, next_id_++,
+                                  passive == Side::BUY ? Side::SELL : Side::BUY, price);
+        (void)book_.add_order(order);
+        if (order->status == OrderStatus::FILLED || order->status == OrderStatus::CANCELLED) {
+            pool_.deallocate(order);
+        }
+        rest(passive, 1 + rng_() % depth_);
+    }
+
+    [[nodiscard]] uint32_t next_random() { return rng_(); }
+
+private:
+    struct Resting {
+        OrderID id;
+        Side side;
+    };
+
+    void rest(Side side, size_t level) {
+        const Price offset = static_cast<Price>(level) * tick_;
+        const Price price = side == Side::BUY ? BOOK_MID - offset : BOOK_MID + offset;
+        const OrderID id = next_id_++;
+        (void)slot_of_.insert(id, static_cast<uint32_t>(live_.size()));
+        live_.push_back({id, side});
+        (void)book_.add_order(make_order(pool_, id, side, price));
+    }
+
+    static void on_done(const Order& order, void* ctx) {
+        auto* self = static_cast<ChurnBook*>(ctx);
+        const uint32_t* slot = self->slot_of_.find(order.id);
+        if (!slot) return;
+        const uint32_t i = *slot;
+        self->slot_of_.erase(order.id);
+        if (i + 1 != self->live_.size()) {
+            self->live_[i] = self->live_.back();
+            *self->slot_of_.find(self->live_[i].id) = i;
+        }
+        self->live_.pop_back();
+    }
+
+    OrderPool pool_;
+    OrderBook book_;
+    std::vector<Resting> live_;
+    OrderIdMap<uint32_t> slot_of_;  // Order id → index in live_
+    size_t depth_;
+    Price tick_;
+    OrderID next_id_{1};
+    std::mt19937 rng_;
+};
+
+template<bool Ladder, bool Intrusive>
+void BM_BookChurn(benchmark::State& state) {
+    const size_t depth = static_cast<size_t>(state.range(0));
+    OrderBookOptions options;
+    options.tick_ladder = Ladder;
+    options.intrusive_levels = Intrusive;
+    options.ladder_ticks = depth * 4;
+    ChurnBook book(depth, static_cast<size_t>(state.range(1)), options);
+    const uint32_t cancel_pct = static_cast<uint32_t>(state.range(2));
+
+    for (auto _ : state) {
+        if (book.next_random() % 100 < cancel_pct) book.cancel_random();
+        else                                       book.take_best();
+    }
+    state.SetItemsProcessed(state.iterations() * 2);  // The request and its replacement
+}
+
+// ─── FlatPriceBook lookup ───
+
+template<bool Ladder>
+void BM_LevelLookup(benchmark::State& state) {
+    const size_t depth = static_cast<size_t>(state.range(0));
+    OrderBookOptions options;
+    options.tick_ladder = Ladder;
+    options.ladder_ticks = depth * 2;
+    OrderPool pool(depth + 16);
+    FlatPriceBook<true> bids(pool, options);
+    for (size_t level = 1; level <= depth; ++level) {
+        const Price price = BOOK_MID - static_cast<Price>(level) * options.tick;
+        bids.find_or_insert(price).push_back(make_order(pool, level, Side::BUY, price));
+    }
+
+    std::mt19937 rng(SEED);
+    std::vector<Price> probes(4096);
+    for (auto& price : probes) price = BOOK_MID - static_cast<Price>(1 + rng() % depth) * options.tick;
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bids.find(probes[i++ & (probes.size() - 1)]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// ─── FlatLevel cancel ───
+
+template<bool Intrusive>
+void BM_LevelCancel(benchmark::State& state) {
+    const size_t count = static_cast<size_t>(state.range(0));
+    const size_t cancels = count * static_cast<size_t>(state.range(1)) / 100;
+    OrderPool pool(count + 16);
+    std::vector<Order*> orders;
+    for (size_t i = 0; i < count; ++i) orders.push_back(make_order(pool, i + 1, Side::BUY, BOOK_MID));
+
+    std::vector<size_t> victims(count);
+    std::iota(victims.begin(), victims.end(), 0);
+    std::shuffle(victims.begin(), victims.end(), std::mt19937(SEED));
+    victims.resize(cancels);
+
+    LevelChunkPool chunks;
+    FlatLevel level(BOOK_MID, pool, Intrusive, &chunks);
+    for (auto _ : state) {
+        level.reset(BOOK_MID);
+        for (Order* order : orders) level.push_back(order);
+        for (size_t i : victims) level.remove(orders[i]);
+        while (!level.empty()) level.pop_front(level.front()->remaining_quantity);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+
+// ─── Order id index ───
+
+using StdOrderIndex = std::unordered_map<OrderID, uint32_t>;
+
+bool index_insert(OrderIdMap<uint32_t>& map, OrderID id) { return map.insert(id, 0); }
+bool index_insert(StdOrderIndex& map, OrderID id) { return map.emplace(id, 0).second; }
+const uint32_t* index_find(OrderIdMap<uint32_t>& map, OrderID id) { return map.find(id); }
+const uint32_t* index_find(StdOrderIndex& map, OrderID id) {
+    auto it = map.find(id);
+    return it == map.end() ? nullptr : &it->second;
+}
+
+template<typename Map>
+Map make_index(size_t live) {
+    if constexpr (std::is_same_v<Map, StdOrderIndex>) {
+        Map map;
+        map.reserve(live);
+        return map;
+    } else {
+        return Map(live);
+    }
+}
+
+/** Sliding window of `live` sequential ids: insert the newest, look one up, erase the oldest */
+template<typename Map>
+void BM_OrderIndex(benchmark::State& state) {
+    const size_t live = static_cast<size_t>(state.range(0));
+    Map map = make_index<Map>(live + 1);
+    OrderID next = 1;
+    for (; next <= live; ++next) (void)index_insert(map, next);
+
+    std::mt19937 rng(SEED);
+    std::vector<OrderID> offsets(4096);
+    for (auto& offset : offsets) offset = rng() % live;
+
+    size_t i = 0;
+    for (auto _ : state) {
+        (void)index_insert(map, next);
+        benchmark::DoNotOptimize(index_find(map, next - offsets[i++ & (offsets.size() - 1)]));
+        map.erase(next - live);
+        ++next;
+    }
+    state.SetItemsProcessed(state.iterations() * 3);
+}
+
+// ─── Queues ───
+
+/** Push then pop `batch` reports on one thread: the per-element cost without a cache line handoff */
+template<typename Queue>
+void BM_QueueRoundTrip(benchmark::State& state) {
+    const size_t batch = static_cast<size_t>(state.range(0));
+    Queue queue(4096);
+    std::vector<ExecutionReport> in(batch), out(batch);
+    for (auto _ : state) {
+        if (batch == 1) {
+            (void)queue.push(in[0]);
+            (void)queue.pop(out[0]);
+        } else {
+            (void)queue.try_push_bulk(in.data(), batch);
+            (void)queue.try_pop_bulk(out.data(), batch);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch));
+}
+
+/**
+ * Even threads produce, odd threads consume, `batch` reports per
+ * iteration each (every thread runs the same iteration count, so
+ * the totals balance). batch 1 uses push()/pop(), larger the bulk calls.
+ */
+template<typename Queue>
+void BM_QueueHandoff(benchmark::State& state) {
+    static std::unique_ptr<Queue> queue;
+    if (state.thread_index() == 0) queue = std::make_unique<Queue>(4096);
+    const size_t batch = static_cast<size_t>(state.range(0));
+    const bool producer = (state.thread_index() % 2) == 0;
+    std::vector<ExecutionReport> items(batch);
+
+    for (auto _ : state) {
+        uint32_t spins = 0;
+        for (size_t done = 0; done < batch;) {
+            size_t moved;
+            if (batch == 1) {
+                moved = producer ? queue->push(items[0]) : queue->pop(items[0]);
+            } else {
+                moved = producer ? queue->try_push_bulk(items.data() + done, batch - done)
+                                 : queue->try_pop_bulk(items.data() + done, batch - done);
+            }
+            if (moved == 0) backoff(spins);
+            done += moved;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch));
+    if (state.thread_index() == 0) queue.reset();
+}
+
+// ─── MemoryPool ───
+
+/** Each thread allocates `batch` orders then frees them, sharing one pool */
+template<size_t MagazineBlock>
+void BM_PoolCycle(benchmark::State& state) {
+    static std::unique_ptr<MemoryPool<Order>> pool;
+    if (state.thread_index() == 0) pool = std::make_unique<MemoryPool<Order>>(size_t{1} << 16, MagazineBlock);
+    const size_t batch = static_cast<size_t>(state.range(0));
+    std::vector<Order*> held(batch);
+
+    for (auto _ : state) {
+        for (auto& order : held) order = pool->allocate();
+        for (Order* order : held) {
+            if (order) pool->deallocate(order);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batch) * 2);
+    if (state.thread_index() == 0) pool.reset();
+}
+
+// ─── Registration ───
+
+template<bool Ladder, bool Intrusive>
+void register_book(const char* name) {
+    benchmark::RegisterBenchmark(name, BM_BookChurn<Ladder, Intrusive>)
+        ->ArgNames({"depth", "orders_per_level", "cancel_pct"})
+        ->ArgsProduct({{10, 100, 1000}, {1, 16, 128}, {10, 50, 90}});
+}
+
+void register_all() {
+    register_book<false, false>("book/sorted_vector/chunked_levels");
+    register_book<false, true>("book/sorted_vector/intrusive_levels");
+    register_book<true, false>("book/tick_ladder/chunked_levels");
+    register_book<true, true>("book/tick_ladder/intrusive_levels");
+
+    for (auto* bench : {benchmark::RegisterBenchmark("level_lookup/sorted_vector", BM_LevelLookup<false>),
+                        benchmark::RegisterBenchmark("level_lookup/tick_ladder", BM_LevelLookup<true>)}) {
+        bench->ArgName("depth")->Arg(10)->Arg(100)->Arg(1000)->Arg(10000);
+    }
+
+    for (auto* bench : {benchmark::RegisterBenchmark("level_cancel/chunked_levels", BM_LevelCancel<false>),
+                        benchmark::RegisterBenchmark("level_cancel/intrusive_levels", BM_LevelCancel<true>)}) {
+        bench->ArgNames({"orders_per_level", "cancel_pct"})->ArgsProduct({{16, 128, 1024}, {10, 50, 90}});
+    }
+
+    for (auto* bench : {benchmark::RegisterBenchmark("order_index/order_id_map", BM_OrderIndex<OrderIdMap<uint32_t>>),
+                        benchmark::RegisterBenchmark("order_index/unordered_map", BM_OrderIndex<StdOrderIndex>)}) {
+        bench->ArgName("live")->Arg(1 << 10)->Arg(1 << 16)->Arg(1 << 20);
+    }
+
+    for (auto* bench : {benchmark::RegisterBenchmark("spsc/round_trip", BM_QueueRoundTrip<SPSCQueue<ExecutionReport>>),
+                        benchmark::RegisterBenchmark("mpmc/round_trip", BM_QueueRoundTrip<MPMCQueue<ExecutionReport>>)}) {
+        bench->ArgName("batch")->Arg(1)->Arg(16)->Arg(64);
+    }
+    benchmark::RegisterBenchmark("spsc/handoff", BM_QueueHandoff<SPSCQueue<ExecutionReport>>)
+        ->ArgName("batch")->Arg(1)->Arg(16)->Arg(64)->Threads(2)->UseRealTime();
+    benchmark::RegisterBenchmark("mpmc/handoff", BM_QueueHandoff<MPMCQueue<ExecutionReport>>)
+        ->ArgName("batch")->Arg(1)->Arg(16)->Arg(64)->Threads(2)->Threads(4)->UseRealTime();
+
+    for (auto* bench : {benchmark::RegisterBenchmark("pool/shared_stack", BM_PoolCycle<0>),
+                        benchmark::RegisterBenchmark("pool/magazines", BM_PoolCycle<32>)}) {
+        bench->ArgName("batch")->Arg(1)->Arg(64)->Threads(1)->Threads(2)->Threads(4)->UseRealTime();
+    }
+}
+
+} // namespace
+} // namespace rtes
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    rtes::register_all();
+#ifdef RTES_NO_INSTRUMENTATION
+    benchmark::AddCustomContext("rtes_instrumentation", "off");
+#else
+    benchmark::AddCustomContext("rtes_instrumentation", "on");
+#endif
+    benchmark::AddCustomContext("rtes_order_bytes", std::to_string(sizeof(rtes::Order)));
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -1,10 +1,21 @@
 #include "rtes/strategies.hpp"
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <thread>
 #include <chrono>
 #include <atomic>
 #include <csignal>
+#include <cerrno>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 using namespace rtes;
 
@@ -14,16 +25,194 @@ void signal_handler(int) {
     shutdown_requested.store(true);
 }
 
+/**
+ * Pure order flow: `per_tick` IOC orders each tick, alternating sides
+ * around one price. Nothing rests, so the books stay empty however long
+ * it runs; for message-rate tests rather than realistic trading.
+ */
+class FlowStrategy : public ClientBase {
+public:
+    FlowStrategy(const std::string& host, uint16_t port, uint32_t client_id,
+                 const std::string& symbol, int per_tick)
+        : ClientBase(host, port, client_id), symbol_(symbol), per_tick_(per_tick) {}
+
+protected:
+    void on_tick() override {
+        for (int i = 0; i < per_tick_; ++i) {
+            const Side side = (next_order_id_ & 1) ? Side::BUY : Side::SELL;
+            if (!send_new_order(symbol_, side, 10, 150000 + random_int(-5, 5), OrderType::IOC)) break;
+        }
+    }
+
+private:
+    std::string symbol_;
+    int per_tick_;
+};
+
+/**
+ * One thread multiplexing many sessions over epoll. Each session is a
+ * ClientBase in buffered mode: every tick the strategies run, then each
+ * session's queued messages go out in one send (pipelined, no waiting on
+ * responses). Responses are read as they arrive and fed back to the
+ * strategies. A session whose socket is full keeps its outbox and
+ * waits for EPOLLOUT; its strategy sees failed sends until it drains.
+ */
+class SessionReactor {
+public:
+    explicit SessionReactor(std::chrono::microseconds tick) : tick_(tick), epoll_fd_(epoll_create1(EPOLL_CLOEXEC)) {}
+
+    ~SessionReactor() {
+        stop();
+        if (epoll_fd_ >= 0) close(epoll_fd_);
+    }
+
+    /** Take a connected session; before start() */
+    bool add(ClientBase* session) {
+        const int fd = session->fd();
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        session->set_buffered(true);
+
+        epoll_event event{};
+        event.events  = EPOLLIN;
+        event.data.u64 = sessions_.size();
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) return false;
+        sessions_.push_back({session, false, false});
+        return true;
+    }
+
+    void start(std::chrono::steady_clock::time_point end) {
+        running_.store(true);
+        thread_ = std::thread([this, end] { run(end); });
+    }
+
+    void stop() {
+        running_.store(false);
+        if (thread_.joinable()) thread_.join();
+    }
+
+    size_t sessions() const { return sessions_.size(); }
+    uint64_t bytes_sent() const { return bytes_sent_.load(std::memory_order_relaxed); }
+    uint64_t sends() const { return sends_.load(std::memory_order_relaxed); }
+
+private:
+    struct Session {
+        ClientBase* client;
+        bool        want_write;  // EPOLLOUT armed
+        bool        closed;
+    };
+
+    std::chrono::microseconds tick_;
+    int                       epoll_fd_;
+    std::vector<Session>      sessions_;
+    std::thread               thread_;
+    std::atomic<bool>         running_{false};
+    std::atomic<uint64_t>     bytes_sent_{0};
+    std::atomic<uint64_t>     sends_{0};
+
+    void run(std::chrono::steady_clock::time_point end) {
+        for (size_t i = 0; i < sessions_.size(); ++i) {
+            sessions_[i].client->start_session();
+            flush(sessions_[i], i);
+        }
+        std::vector<epoll_event> events(256);
+        std::vector<std::byte> buffer(64 * 1024);
+        auto next_tick = std::chrono::steady_clock::now();
+
+        while (running_.load(std::memory_order_relaxed) && !shutdown_requested.load(std::memory_order_relaxed)) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= end) break;
+            if (now >= next_tick) {
+                for (size_t i = 0; i < sessions_.size(); ++i) {
+                    Session& s = sessions_[i];
+                    if (s.closed) continue;
+                    s.client->tick();
+                    if (!s.want_write) flush(s, i);
+                }
+                next_tick += tick_;
+                if (next_tick < now) next_tick = now + tick_;  // Overloaded: do not bunch ticks up
+                now = std::chrono::steady_clock::now();
+            }
+
+            const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next_tick - now).count();
+            const int ready = epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()),
+                                         static_cast<int>(std::max<int64_t>(0, wait)));
+            for (int e = 0; e < ready; ++e) {
+                const size_t index = events[e].data.u64;
+                Session& s = sessions_[index];
+                if (s.closed) continue;
+                if (events[e].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) read_all(s, buffer);
+                if (!s.closed && (events[e].events & EPOLLOUT)) flush(s, index);
+            }
+        }
+        for (Session& s : sessions_) {
+            if (!s.closed) s.client->stop_session();
+        }
+    }
+
+    void read_all(Session& s, std::vector<std::byte>& buffer) {
+        while (true) {
+            const ssize_t n = recv(s.client->fd(), buffer.data(), buffer.size(), 0);
+            if (n > 0) {
+                s.client->receive_bytes(buffer.data(), static_cast<size_t>(n));
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+            close_session(s);
+            return;
+        }
+    }
+
+    /** Send the session's outbox; arm EPOLLOUT for what the socket does not take */
+    void flush(Session& s, size_t index) {
+        auto& outbox = s.client->outbox();
+        size_t sent = 0;
+        while (sent < outbox.size()) {
+            const ssize_t n = send(s.client->fd(), outbox.data() + sent, outbox.size() - sent, MSG_NOSIGNAL);
+            if (n > 0) {
+                sent += static_cast<size_t>(n);
+                sends_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            close_session(s);
+            return;
+        }
+        bytes_sent_.fetch_add(sent, std::memory_order_relaxed);
+        outbox.erase(outbox.begin(), outbox.begin() + static_cast<std::ptrdiff_t>(sent));
+
+        const bool want_write = !outbox.empty();
+        if (want_write == s.want_write) return;
+        epoll_event event{};
+        event.events   = EPOLLIN | (want_write ? EPOLLOUT : 0u);
+        event.data.u64 = index;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, s.client->fd(), &event);
+        s.want_write = want_write;
+    }
+
+    void close_session(Session& s) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, s.client->fd(), nullptr);
+        s.closed = true;
+        s.client->stop_session();
+    }
+};
+
 class LoadGenerator {
 public:
     LoadGenerator(const std::string& host, uint16_t port, const std::vector<std::string>& symbols)
         : host_(host), port_(port), symbols_(symbols) {}
     
-    void run(int num_clients, int duration_seconds) {
-        std::cout << "Starting load test with " << num_clients << " clients for " 
-                  << duration_seconds << " seconds\n";
+    /**
+     * @param reactors    Threads sharing the sessions
+     * @param flow        > 0: every session is a FlowStrategy sending this many orders per tick
+     */
+    void run(int num_clients, int duration_seconds, int reactors, std::chrono::microseconds tick, int flow) {
+        std::cout << "Starting load test with " << num_clients << " clients on " << reactors
+                  << " reactor thread(s) for " << duration_seconds << " seconds\n";
         
-        std::vector<std::thread> client_threads;
         std::vector<std::unique_ptr<ClientBase>> clients;
         
         // Create diverse mix of strategies
@@ -33,22 +222,26 @@ public:
             
             std::unique_ptr<ClientBase> client;
             
-            switch (i % 4) {
-                case 0:  // Market makers (25%)
-                    client = std::make_unique<MarketMakerStrategy>(host_, port_, client_id, symbol);
-                    break;
-                case 1:  // Liquidity takers (25%)
-                    client = std::make_unique<LiquidityTakerStrategy>(host_, port_, client_id, symbol);
-                    break;
-                case 2:  // Momentum traders (25%)
-                    client = std::make_unique<MomentumStrategy>(host_, port_, client_id, symbol);
-                    break;
-                case 3:  // Arbitrageurs (25%)
-                    {
-                        std::string symbol2 = symbols_[(i + 1) % symbols_.size()];
-                        client = std::make_unique<ArbitrageStrategy>(host_, port_, client_id, symbol, symbol2);
-                    }
-                    break;
+            if (flow > 0) {
+                client = std::make_unique<FlowStrategy>(host_, port_, client_id, symbol, flow);
+            } else {
+                switch (i % 4) {
+                    case 0:  // Market makers (25%)
+                        client = std::make_unique<MarketMakerStrategy>(host_, port_, client_id, symbol);
+                        break;
+                    case 1:  // Liquidity takers (25%)
+                        client = std::make_unique<LiquidityTakerStrategy>(host_, port_, client_id, symbol);
+                        break;
+                    case 2:  // Momentum traders (25%)
+                        client = std::make_unique<MomentumStrategy>(host_, port_, client_id, symbol);
+                        break;
+                    case 3:  // Arbitrageurs (25%)
+                        {
+                            std::string symbol2 = symbols_[(i + 1) % symbols_.size()];
+                            client = std::make_unique<ArbitrageStrategy>(host_, port_, client_id, symbol, symbol2);
+                        }
+                        break;
+                }
             }
             
             if (client->connect()) {
@@ -60,14 +253,19 @@ public:
         
         std::cout << "Connected " << clients.size() << " clients\n";
         
-        // Start all clients
-        auto start_time = std::chrono::steady_clock::now();
-        
-        for (auto& client : clients) {
-            client_threads.emplace_back([&client, duration_seconds]() {
-                client->run(std::chrono::seconds(duration_seconds));
-            });
+        // Sessions dealt round-robin to the reactors
+        std::vector<std::unique_ptr<SessionReactor>> pool;
+        for (int r = 0; r < std::max(1, reactors); ++r) pool.push_back(std::make_unique<SessionReactor>(tick));
+        for (size_t i = 0; i < clients.size(); ++i) {
+            if (!pool[i % pool.size()]->add(clients[i].get())) {
+                std::cerr << "Failed to register client " << i << " with its reactor\n";
+            }
         }
+
+        // Start all reactors
+        auto start_time = std::chrono::steady_clock::now();
+        const auto end_time = start_time + std::chrono::seconds(duration_seconds);
+        for (auto& reactor : pool) reactor->start(end_time);
         
         // Monitor progress
         while (!shutdown_requested.load()) {
@@ -86,17 +284,23 @@ public:
             std::this_thread::sleep_for(std::chrono::seconds(1));
         }
         
-        // Wait for all clients to finish
-        for (auto& thread : client_threads) {
-            if (thread.joinable()) {
-                thread.join();
-            }
+        // Wait for all reactors to finish
+        uint64_t bytes = 0, sends = 0;
+        for (auto& reactor : pool) {
+            reactor->stop();
+            bytes += reactor->bytes_sent();
+            sends += reactor->sends();
         }
         
-        auto end_time = std::chrono::steady_clock::now();
-        auto total_elapsed = std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time);
+        auto end_time_actual = std::chrono::steady_clock::now();
+        auto total_elapsed = std::chrono::duration_cast<std::chrono::seconds>(end_time_actual - start_time);
         
         print_final_statistics(clients, total_elapsed.count());
+        if (sends > 0) {
+            std::cout << "Send syscalls: " << sends << " (" << static_cast<double>(bytes) / sends
+                      << " bytes each)\n";
+        }
+        for (auto& client : clients) client->disconnect();
     }
 
 private:
@@ -168,7 +372,10 @@ void print_usage(const char* program_name) {
     std::cout << "Options:\n";
     std::cout << "  --host <host>        Exchange host (default: localhost)\n";
     std::cout << "  --port <port>        Exchange port (default: 8888)\n";
-    std::cout << "  --clients <num>      Number of clients (default: 10)\n";
+    std::cout << "  --clients <num>      Number of sessions (default: 10)\n";
+    std::cout << "  --reactors <num>     Threads multiplexing the sessions (default: 2)\n";
+    std::cout << "  --tick-us <us>       Strategy tick per session (default: 1000)\n";
+    std::cout << "  --flow <n>           Replace the strategy mix: n IOC orders per session per tick\n";
     std::cout << "  --duration <sec>     Test duration in seconds (default: 60)\n";
     std::cout << "  --symbols <list>     Comma-separated symbol list (default: AAPL,MSFT,GOOGL)\n";
     std::cout << "  --help               Show this help\n";
@@ -191,6 +398,9 @@ int main(int argc, char* argv[]) {
     uint16_t port = 8888;
     int num_clients = 10;
     int duration = 60;
+    int reactors = 2;
+    int tick_us = 1000;
+    int flow = 0;
     std::string symbols_str = "AAPL,MSFT,GOOGL";
     
     // Parse command line arguments
@@ -207,6 +417,12 @@ int main(int argc, char* argv[]) {
             port = std::stoi(argv[i + 1]);
         } else if (arg == "--clients") {
             num_clients = std::stoi(argv[i + 1]);
+        } else if (arg == "--reactors") {
+            reactors = std::stoi(argv[i + 1]);
+        } else if (arg == "--tick-us") {
+            tick_us = std::max(1, std::stoi(argv[i + 1]));
+        } else if (arg == "--flow") {
+            flow = std::stoi(argv[i + 1]);
         } else if (arg == "--duration") {
             duration = std::stoi(argv[i + 1]);
         } else if (arg == "--symbols") {
@@ -231,7 +447,7 @@ int main(int argc, char* argv[]) {
     }
     
     LoadGenerator generator(host, port, symbols);
-    generator.run(num_clients, duration);
+    generator.run(num_clients, duration, reactors, std::chrono::microseconds(tick_us), flow);
     
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,301 @@
+#!/usr/bin/env python3
+"""
+Performance regression gate against a stored per-host baseline.
+
+Runs bench_micro (book structures, queues, pools) and bench_matching
+(workload profiles) several times and compares every metric with the
+baseline recorded on the same host:
+
+    throughput          micro items/s, matching requests/s (higher is better)
+    p99, p99.9 latency  matching, per profile              (lower is better)
+
+A metric REGRESSED when the 95% (or --confidence 99) Welch confidence
+interval of the change in its mean lies entirely on the bad side of
+zero, and the change is larger than --threshold percent. With one
+sample on either side, there is no interval and only the threshold
+applies. Exit status: 0 pass, 1 regression, 2 could not run (including
+no baseline for this host, unless --allow-missing-baseline).
+
+Usage (from the build directory, or via `make perf_gate` / `make perf_baseline`):
+    python3 tools/perf_gate.py --build-dir build --record     # Store this host's baseline
+    python3 tools/perf_gate.py --build-dir build              # Compare with it
+    python3 tools/perf_gate.py --build-dir build --if-changed origin/main
+"""
+
+import argparse
+import datetime
+import json
+import math
+import os
+import platform
+import socket
+import statistics
+import subprocess
+import sys
+import tempfile
+
+SOURCE_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# Paths whose changes warrant a verdict (--if-changed)
+WATCHED_PATHS = [
+    "include/rtes/order_book.hpp", "src/order_book.cpp",
+    "include/rtes/order_id_map.hpp",
+    "include/rtes/spsc_queue.hpp", "include/rtes/mpmc_queue.hpp",
+    "include/rtes/memory_pool.hpp",
+    "include/rtes/matching_engine.hpp", "src/matching_engine.cpp",
+    "include/rtes/types.hpp",
+]
+
+# One representative point per family: a few minutes at most with the defaults
+DEFAULT_MICRO_FILTER = "|".join([
+    "^book/.*/depth:100/orders_per_level:16/cancel_pct:50$",
+    "^level_lookup/.*/depth:1000$",
+    "^level_cancel/.*/orders_per_level:128/cancel_pct:50$",
+    "^order_index/.*/live:65536$",
+    "^spsc/round_trip/",
+    "^mpmc/round_trip/",
+    "^pool/.*/threads:1$",
+])
+
+# Two-sided Student t critical values by degrees of freedom
+T_TABLE = {
+    95: {1: 12.706, 2: 4.303, 3: 3.182, 4: 2.776, 5: 2.571, 6: 2.447, 7: 2.365, 8: 2.306,
+         9: 2.262, 10: 2.228, 12: 2.179, 15: 2.131, 20: 2.086, 25: 2.060, 30: 2.042,
+         40: 2.021, 60: 2.000, 120: 1.980},
+    99: {1: 63.657, 2: 9.925, 3: 5.841, 4: 4.604, 5: 4.032, 6: 3.707, 7: 3.499, 8: 3.355,
+         9: 3.250, 10: 3.169, 12: 3.055, 15: 2.947, 20: 2.845, 25: 2.787, 30: 2.750,
+         40: 2.704, 60: 2.660, 120: 2.617},
+}
+T_INFINITY = {95: 1.960, 99: 2.576}
+
+
+def t_critical(df, confidence):
+    """Critical value for df degrees of freedom (rounded down to a tabulated df: conservative)"""
+    table = T_TABLE[confidence]
+    if df >= 120:
+        return T_INFINITY[confidence] if df > 1000 else table[120]
+    usable = [d for d in table if d <= max(1, math.floor(df))]
+    return table[max(usable)]
+
+
+def host_info(build_dir):
+    cpu = platform.processor() or "unknown"
+    try:
+        with open("/proc/cpuinfo") as f:
+            for line in f:
+                if line.startswith("model name"):
+                    cpu = line.split(":", 1)[1].strip()
+                    break
+    except OSError:
+        pass
+    build_type = ""
+    try:
+        with open(os.path.join(build_dir, "CMakeCache.txt")) as f:
+            for line in f:
+                if line.startswith("CMAKE_BUILD_TYPE:"):
+                    build_type = line.split("=", 1)[1].strip()
+    except OSError:
+        pass
+    git = subprocess.run(["git", "-C", SOURCE_DIR, "describe", "--always", "--dirty"],
+                         capture_output=True, text=True).stdout.strip()
+    return {
+        "host": socket.gethostname(),
+        "cpu": cpu,
+        "cpus": os.cpu_count(),
+        "kernel": platform.release(),
+        "build_type": build_type or "(none)",
+        "git": git,
+        "recorded": datetime.datetime.now(datetime.timezone.utc).isoformat(timespec="seconds"),
+    }
+
+
+def add_sample(metrics, name, value, better):
+    metric = metrics.setdefault(name, {"better": better, "samples": []})
+    metric["samples"].append(value)
+
+
+def run_micro(build_dir, args, metrics):
+    binary = os.path.join(build_dir, "bench_micro")
+    if not os.path.exists(binary):
+        print(f"perf_gate: {binary} not built (needs Google Benchmark); skipping microbenchmarks")
+        return True
+    with tempfile.NamedTemporaryFile(suffix=".json") as out:
+        command = [binary, f"--benchmark_filter={args.micro_filter}",
+                   f"--benchmark_repetitions={args.repetitions}",
+                   f"--benchmark_min_time={args.micro_min_time}",
+                   f"--benchmark_out={out.name}", "--benchmark_out_format=json"]
+        print("perf_gate: " + " ".join(command), flush=True)
+        if subprocess.run(command, stdout=subprocess.DEVNULL).returncode != 0:
+            print("perf_gate: bench_micro failed", file=sys.stderr)
+            return False
+        results = json.load(open(out.name))
+    for entry in results.get("benchmarks", []):
+        if entry.get("run_type") != "iteration" or "items_per_second" not in entry:
+            continue
+        name = entry.get("run_name", entry["name"])
+        add_sample(metrics, f"micro/{name}/items_per_second", entry["items_per_second"], "higher")
+    return True
+
+
+def run_matching(build_dir, args, metrics):
+    binary = os.path.join(build_dir, "bench_matching")
+    if not os.path.exists(binary):
+        print(f"perf_gate: {binary} not built", file=sys.stderr)
+        return False
+    with tempfile.NamedTemporaryFile(suffix=".json") as out:
+        command = [binary, "--profile", args.profile, "--requests", str(args.matching_requests),
+                   "--json", out.name]
+        print("perf_gate: " + " ".join(command) + f"  (x{args.repetitions})", flush=True)
+        for _ in range(args.repetitions):
+            if subprocess.run(command, stdout=subprocess.DEVNULL).returncode != 0:
+                print("perf_gate: bench_matching failed", file=sys.stderr)
+                return False
+            for profile in json.load(open(out.name))["profiles"]:
+                prefix = f"matching/{profile['profile']}"
+                add_sample(metrics, f"{prefix}/requests_per_second", profile["requests_per_second"], "higher")
+                add_sample(metrics, f"{prefix}/p99_ns", profile["latency"]["p99_ns"], "lower")
+                add_sample(metrics, f"{prefix}/p999_ns", profile["latency"]["p999_ns"], "lower")
+    return True
+
+
+def compare(name, base, current, threshold, confidence):
+    """(verdict, relative change %, CI of the change % or None)"""
+    b, c = base["samples"], current["samples"]
+    mb, mc = statistics.fmean(b), statistics.fmean(c)
+    if mb == 0:
+        return "ok", 0.0, None
+    change = (mc - mb) / mb * 100.0
+    interval = None
+    if len(b) >= 2 and len(c) >= 2:
+        vb, vc = statistics.variance(b) / len(b), statistics.variance(c) / len(c)
+        se = math.sqrt(vb + vc)
+        if se > 0:
+            df = (vb + vc) ** 2 / ((vb ** 2) / (len(b) - 1) + (vc ** 2) / (len(c) - 1))
+            half = t_critical(df, confidence) * se / mb * 100.0
+        else:
+            half = 0.0
+        interval = (change - half, change + half)
+
+    # Worse is a drop in throughput, a rise in latency
+    higher = base["better"] == "higher"
+    worse = -change if higher else change
+    significant_worse = interval is None or (interval[1] < 0 if higher else interval[0] > 0)
+    significant_better = interval is None or (interval[0] > 0 if higher else interval[1] < 0)
+    if worse > threshold and significant_worse:
+        return "REGRESSED", change, interval
+    if -worse > threshold and significant_better:
+        return "improved", change, interval
+    return "ok", change, interval
+
+
+def format_interval(interval):
+    return "n/a" if interval is None else f"[{interval[0]:+.1f}, {interval[1]:+.1f}]"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Performance regression gate against a per-host baseline")
+    parser.add_argument("--build-dir", default=".", help="Directory holding bench_micro and bench_matching")
+    parser.add_argument("--baseline-dir", default=os.path.join(SOURCE_DIR, "perf", "baselines"))
+    parser.add_argument("--host", default=socket.gethostname(), help="Baseline name (default: hostname)")
+    parser.add_argument("--record", action="store_true", help="Store this run as the host's baseline")
+    parser.add_argument("--allow-missing-baseline", action="store_true",
+                        help="Pass (gate skipped) instead of failing when the host has no baseline")
+    parser.add_argument("--repetitions", type=int, default=5)
+    parser.add_argument("--threshold", type=float, default=5.0, help="Smallest change flagged, in %%")
+    parser.add_argument("--confidence", type=int, choices=(95, 99), default=95)
+    parser.add_argument("--micro-filter", default=DEFAULT_MICRO_FILTER)
+    parser.add_argument("--micro-min-time", default="0.1", help="Seconds per microbenchmark repetition")
+    parser.add_argument("--profile", default="all", help="bench_matching profile(s)")
+    parser.add_argument("--matching-requests", type=int, default=200000)
+    parser.add_argument("--skip-micro", action="store_true")
+    parser.add_argument("--skip-matching", action="store_true")
+    parser.add_argument("--if-changed", metavar="REV",
+                        help="Pass without running unless a watched path changed since REV")
+    parser.add_argument("--report", help="Also write the verdicts as JSON")
+    args = parser.parse_args()
+
+    if args.if_changed:
+        diff = subprocess.run(["git", "-C", SOURCE_DIR, "diff", "--name-only", args.if_changed, "--"] + WATCHED_PATHS,
+                              capture_output=True, text=True)
+        if diff.returncode != 0:
+            print(f"perf_gate: git diff against {args.if_changed} failed: {diff.stderr.strip()}", file=sys.stderr)
+            return 2
+        if not diff.stdout.strip():
+            print(f"perf_gate: no watched path changed since {args.if_changed}; nothing to check")
+            return 0
+
+    baseline_path = os.path.join(args.baseline_dir, f"{args.host}.json")
+    if not args.record and not os.path.exists(baseline_path):
+        if args.allow_missing_baseline:
+            print(f"perf_gate: no baseline for {args.host}, gate skipped")
+            return 0
+        print(f"perf_gate: no baseline at {baseline_path}; record one with --record (make perf_baseline)",
+              file=sys.stderr)
+        return 2
+
+    build_dir = os.path.abspath(args.build_dir)
+    info = host_info(build_dir)
+    if info["build_type"] != "Release":
+        print(f"perf_gate: warning: build type is {info['build_type']}, not Release")
+
+    metrics = {}
+    if not args.skip_micro and not run_micro(build_dir, args, metrics):
+        return 2
+    if not args.skip_matching and not run_matching(build_dir, args, metrics):
+        return 2
+    if not metrics:
+        print("perf_gate: nothing measured", file=sys.stderr)
+        return 2
+
+    if args.record:
+        os.makedirs(args.baseline_dir, exist_ok=True)
+        with open(baseline_path, "w") as f:
+            json.dump({**info, "metrics": metrics}, f, indent=1, sort_keys=True)
+        print(f"perf_gate: baseline written to {baseline_path} ({len(metrics)} metrics)")
+        return 0
+
+    baseline = json.load(open(baseline_path))
+    for key in ("cpu", "cpus", "build_type"):
+        if baseline.get(key) != info[key]:
+            print(f"perf_gate: warning: baseline {key} was {baseline.get(key)}, now {info[key]}")
+    print(f"perf_gate: comparing with {baseline_path} (git {baseline.get('git')}, {baseline.get('recorded')})\n")
+
+    rows = []
+    for name in sorted(set(metrics) | set(baseline["metrics"])):
+        if name not in baseline["metrics"]:
+            rows.append((name, "new", None, None, None, statistics.fmean(metrics[name]["samples"])))
+            continue
+        if name not in metrics:
+            if not args.skip_micro and not args.skip_matching:
+                rows.append((name, "not run", None, None, statistics.fmean(baseline["metrics"][name]["samples"]), None))
+            continue
+        verdict, change, interval = compare(name, baseline["metrics"][name], metrics[name],
+                                            args.threshold, args.confidence)
+        rows.append((name, verdict, change, interval,
+                     statistics.fmean(baseline["metrics"][name]["samples"]),
+                     statistics.fmean(metrics[name]["samples"])))
+
+    width = max(len(row[0]) for row in rows)
+    print(f"{'metric':<{width}}  {'baseline':>14}  {'current':>14}  {'change %':>9}  "
+          f"{str(args.confidence) + '% CI':>16}  verdict")
+    for name, verdict, change, interval, base_mean, current_mean in rows:
+        base_text = f"{base_mean:14.1f}" if base_mean is not None else f"{'-':>14}"
+        current_text = f"{current_mean:14.1f}" if current_mean is not None else f"{'-':>14}"
+        change_text = f"{change:+9.1f}" if change is not None else f"{'-':>9}"
+        print(f"{name:<{width}}  {base_text}  {current_text}  {change_text}  "
+              f"{format_interval(interval):>16}  {verdict}")
+
+    regressed = [row for row in rows if row[1] == "REGRESSED"]
+    if args.report:
+        with open(args.report, "w") as f:
+            json.dump({"host": info, "baseline": baseline_path,
+                       "verdicts": [{"metric": r[0], "verdict": r[1], "change_pct": r[2],
+                                     "ci_pct": r[3], "baseline": r[4], "current": r[5]} for r in rows]},
+                      f, indent=1)
+    print(f"\nperf_gate: {len(regressed)} regression(s) in {len(rows)} metrics "
+          f"(threshold {args.threshold}%, {args.confidence}% confidence)")
+    return 1 if regressed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,5 +1,8 @@
 #include "rtes/strategies.hpp"
 #include "rtes/market_data.hpp"
+#include "rtes/latency_histogram.hpp"
+#include "rtes/perf_counters.hpp"
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <thread>
@@ -7,6 +10,10 @@
 #include <atomic>
 #include <fstream>
 #include <iomanip>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -14,40 +21,55 @@
 
 using namespace rtes;
 
+// Fixed-memory log-linear histogram (≤3.1% bucket error), reported in μs
 struct LatencyStats {
-    std::vector<double> latencies;
-    double min_latency = std::numeric_limits<double>::max();
-    double max_latency = 0.0;
-    double sum_latency = 0.0;
-    
+    LatencyHistogram histogram;
+
     void add_sample(double latency_us) {
-        latencies.push_back(latency_us);
-        min_latency = std::min(min_latency, latency_us);
-        max_latency = std::max(max_latency, latency_us);
-        sum_latency += latency_us;
+        histogram.record(static_cast<uint64_t>(latency_us * 1000.0));
     }
-    
-    void calculate_percentiles() {
-        if (latencies.empty()) return;
-        std::sort(latencies.begin(), latencies.end());
-    }
-    
-    double get_percentile(double p) const {
-        if (latencies.empty()) return 0.0;
-        size_t index = static_cast<size_t>(latencies.size() * p / 100.0);
-        index = std::min(index, latencies.size() - 1);
-        return latencies[index];
+
+    double get_percentile(double p) const { return histogram.percentile(p) / 1000.0; }
+    double get_average() const { return histogram.mean_ns() / 1000.0; }
+    double min_latency() const { return histogram.min_ns() / 1000.0; }
+    double max_latency() const { return histogram.max_ns() / 1000.0; }
+    uint64_t samples() const { return histogram.count(); }
+};
+
+/**
+ * Hardware counters of the exchange process (--counters-pid), started
+ * and stopped around a phase and reported per order sent. They count
+ * every exchange thread, so busy-polling threads add their idle spin:
+ * compare phases at the same offered load.
+ */
+class PhaseCounters {
+public:
+    explicit PhaseCounters(PerfCounters* counters) : counters_(counters) {
+        if (counters_) counters_->start();
     }
-    
-    double get_average() const {
-        return latencies.empty() ? 0.0 : sum_latency / latencies.size();
+
+    void report(uint64_t orders) {
+        if (!counters_) return;
+        const PerfCounterSample sample = counters_->stop();
+        counters_ = nullptr;
+        if (sample.empty()) return;
+        std::cout << "  Exchange per order:" << std::fixed << std::setprecision(1);
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+            const auto event = static_cast<PerfEvent>(i);
+            if (sample.has(event)) std::cout << " " << perf_event_name(event) << " " << sample.per(orders, event);
+        }
+        std::cout << std::setprecision(2) << ", ipc " << sample.ipc()
+                  << (sample.multiplexed ? " (multiplexed)" : "") << std::endl;
     }
+
+private:
+    PerfCounters* counters_;
 };
 
 class PerformanceHarness {
 public:
-    PerformanceHarness(const std::string& host, uint16_t port) 
-        : host_(host), port_(port) {}
+    PerformanceHarness(const std::string& host, uint16_t port, PerfCounters* counters = nullptr)
+        : host_(host), port_(port), counters_(counters) {}
     
     void run_comprehensive_test() {
         std::cout << "=== RTES Performance Harness ===" << std::endl;
@@ -75,6 +97,7 @@ public:
 private:
     std::string host_;
     uint16_t port_;
+    PerfCounters* counters_;  // Exchange process, nullptr = not counting
     std::vector<std::string> test_results_;
     
     bool verify_exchange_health() {
@@ -117,6 +140,7 @@ private:
         // Measure latency for individual orders
         std::cout << "Measuring order latency..." << std::endl;
         
+        PhaseCounters phase(counters_);
         for (int i = 0; i < 1000; ++i) {
             auto start = std::chrono::high_resolution_clock::now();
             
@@ -129,16 +153,15 @@ private:
             auto latency_us = std::chrono::duration<double, std::micro>(end - start).count();
             stats.add_sample(latency_us);
         }
+        phase.report(1000);
         
         client.disconnect();
         
-        stats.calculate_percentiles();
-        
         std::cout << "Results:" << std::endl;
-        std::cout << "  Samples: " << stats.latencies.size() << std::endl;
+        std::cout << "  Samples: " << stats.samples() << std::endl;
         std::cout << "  Average: " << std::fixed << std::setprecision(2) << stats.get_average() << "μs" << std::endl;
-        std::cout << "  Min: " << stats.min_latency << "μs" << std::endl;
-        std::cout << "  Max: " << stats.max_latency << "μs" << std::endl;
+        std::cout << "  Min: " << stats.min_latency() << "μs" << std::endl;
+        std::cout << "  Max: " << stats.max_latency() << "μs" << std::endl;
         std::cout << "  P50: " << stats.get_percentile(50) << "μs" << std::endl;
         std::cout << "  P90: " << stats.get_percentile(90) << "μs" << std::endl;
         std::cout << "  P99: " << stats.get_percentile(99) << "μs" << std::endl;
@@ -184,6 +207,7 @@ private:
             }
             
             // Run test
+            PhaseCounters phase(counters_);
             auto start_time = std::chrono::high_resolution_clock::now();
             
             for (auto& client : clients) {
@@ -209,6 +233,7 @@ private:
             
             std::cout << "  Orders: " << total_orders << ", Throughput: " 
                       << std::fixed << std::setprecision(0) << throughput << " orders/sec" << std::endl;
+            phase.report(total_orders);
             
             if (throughput >= 100000) {
                 throughput_slo_met = true;
@@ -262,6 +287,7 @@ private:
             }
         }
         
+        PhaseCounters phase(counters_);
         auto start_time = std::chrono::high_resolution_clock::now();
         
         for (auto& client : clients) {
@@ -313,6 +339,7 @@ private:
         std::cout << "  Total orders: " << total_orders << std::endl;
         std::cout << "  Rejected: " << total_rejected << " (" << reject_rate << "%)" << std::endl;
         std::cout << "  Trades: " << total_trades << std::endl;
+        phase.report(total_orders);
         
         bool sustained_slo = reject_rate < 5.0;  // Less than 5% reject rate
         std::cout << "  SLO Check: " << (sustained_slo ? "✓" : "✗") << " Reject rate" << std::endl;
@@ -339,6 +366,7 @@ private:
         
         std::cout << "Sending burst of orders..." << std::endl;
         
+        PhaseCounters phase(counters_);
         auto start = std::chrono::high_resolution_clock::now();
         
         // Send rapid burst
@@ -361,6 +389,7 @@ private:
         std::cout << "  Burst rate: " << std::fixed << std::setprecision(0) << burst_rate << " orders/sec" << std::endl;
         std::cout << "  Orders sent: " << client.orders_sent() << std::endl;
         std::cout << "  Orders acked: " << client.orders_acked() << std::endl;
+        phase.report(client.orders_sent());
         
         bool burst_slo = burst_rate >= 500000;  // 500K orders/sec burst capability
         std::cout << "  SLO Check: " << (burst_slo ? "✓" : "✗") << " Burst rate" << std::endl;
@@ -481,36 +510,293 @@ private:
     }
 };
 
+// ─────────────────────────────────────────────────────────────
+// Open loop: sends on a fixed timeline, whatever the responses do
+// ─────────────────────────────────────────────────────────────
+
+/**
+ * The tests above wait on the exchange between sends (closed loop), so
+ * when it saturates they slow down with it and never record the queueing
+ * they stopped causing (coordinated omission). Here every order has an
+ * intended send time fixed in advance by the offered rate; its latency
+ * runs from that time to its final response, so time the sender spent
+ * behind schedule counts against the exchange.
+ *
+ * Orders are IOC buys against an empty book: each ends in one final
+ * response (cancelled, or rejected by risk) and the book stays empty.
+ */
+enum class Arrival { CONSTANT, POISSON };
+
+struct OpenLoopOptions {
+    std::vector<double> rates;          // Offered orders/sec, one run each
+    double      duration_s{10.0};
+    Arrival     arrival{Arrival::CONSTANT};
+    std::string symbol{"AAPL"};
+    double      drain_s{2.0};           // Wait for the last responses
+    double      p99_slo_us{100.0};      // For the knee
+    std::string hdr_prefix;             // Non-empty: <prefix>-<rate>.hgrm per rate
+};
+
+struct OpenLoopResult {
+    double           offered_rate{0};
+    uint64_t         sent{0};
+    uint64_t         responses{0};
+    uint64_t         rejected{0};
+    double           achieved_rate{0};  // Responses per second of the run
+    double           max_send_lag_us{0};
+    LatencyHistogram histogram;         // Intended send → final response, ns
+};
+
+class OpenLoopClient : public ClientBase {
+public:
+    OpenLoopClient(const std::string& host, uint16_t port, uint32_t client_id, size_t capacity)
+        : ClientBase(host, port, client_id), capacity_(capacity),
+          intended_(std::make_unique<std::atomic<int64_t>[]>(capacity)),
+          answered_(std::make_unique<std::atomic<bool>[]>(capacity)) {}
+
+    /** Record the intended send time of the next order; false once capacity is used */
+    bool schedule(int64_t intended_ns) {
+        if (scheduled_ == capacity_) return false;
+        intended_[scheduled_++].store(intended_ns, std::memory_order_release);
+        return true;
+    }
+
+    uint64_t responses() const { return responses_.load(std::memory_order_acquire); }
+    uint64_t rejected() const { return rejected_.load(std::memory_order_relaxed); }
+    /** Receiver thread's histogram: read after stop_receiver() */
+    const LatencyHistogram& histogram() const { return histogram_; }
+
+protected:
+    void on_tick() override {}
+
+    void on_order_ack(const OrderAckMessage& ack) override {
+        const auto now = ProtocolUtils::get_timestamp_ns();
+        if (ack.status == 1 || ack.order_id == 0 || ack.order_id > capacity_) return;  // Accepted: not final
+        const size_t index = ack.order_id - 1;
+        if (answered_[index].exchange(true, std::memory_order_relaxed)) return;
+        const int64_t intended = intended_[index].load(std::memory_order_acquire);
+        histogram_.record(static_cast<uint64_t>(std::max<int64_t>(0, static_cast<int64_t>(now) - intended)));
+        if (ack.status == 2) rejected_.fetch_add(1, std::memory_order_relaxed);
+        responses_.fetch_add(1, std::memory_order_release);
+    }
+
+private:
+    size_t capacity_;
+    size_t scheduled_{0};  // Sender thread
+    std::unique_ptr<std::atomic<int64_t>[]> intended_;  // Indexed by order id - 1 (ids start at 1)
+    std::unique_ptr<std::atomic<bool>[]>    answered_;
+    LatencyHistogram      histogram_;
+    std::atomic<uint64_t> responses_{0};
+    std::atomic<uint64_t> rejected_{0};
+};
+
+/** Percentile distribution in HdrHistogram's .hgrm text form (values in μs) */
+void write_hgrm(const std::string& path, const LatencyHistogram& histogram) {
+    std::ofstream out(path);
+    out << std::setw(12) << "Value" << std::setw(15) << "Percentile" << std::setw(11) << "TotalCount"
+        << std::setw(18) << "1/(1-Percentile)" << "\n\n";
+    const double total = static_cast<double>(histogram.count());
+    uint64_t seen = 0;
+    histogram.for_each_bucket([&](uint64_t, uint64_t upper_ns, uint64_t count) {
+        seen += count;
+        const double percentile = static_cast<double>(seen) / total;
+        out << std::fixed << std::setw(12) << std::setprecision(3)
+            << std::min(upper_ns, histogram.max_ns()) / 1000.0
+            << std::setw(15) << std::setprecision(12) << percentile << std::setw(11) << seen;
+        if (percentile < 1.0) out << std::setw(18) << std::setprecision(2) << 1.0 / (1.0 - percentile);
+        out << "\n";
+    });
+    out << std::fixed << std::setprecision(3)
+        << "#[Mean    = " << histogram.mean_ns() / 1000.0 << ", Max = " << histogram.max_ns() / 1000.0 << "]\n"
+        << "#[Total count    = " << histogram.count() << "]\n";
+}
+
+OpenLoopResult run_open_loop(const std::string& host, uint16_t port, uint32_t client_id,
+                             double rate, const OpenLoopOptions& options) {
+    OpenLoopResult result;
+    result.offered_rate = rate;
+    const auto planned = static_cast<size_t>(rate * options.duration_s);
+    OpenLoopClient client(host, port, client_id, planned + 1);
+    if (planned == 0 || !client.connect()) return result;
+    client.start_receiver();
+
+    // The whole timeline is fixed before the first send
+    std::mt19937_64 rng(client_id);
+    std::exponential_distribution<double> gap(rate);
+    const auto spacing_ns = 1e9 / rate;
+    const int64_t start = static_cast<int64_t>(ProtocolUtils::get_timestamp_ns()) + 10'000'000;
+    double offset_ns = 0;
+    for (size_t i = 0; i < planned; ++i) {
+        const int64_t intended = start + static_cast<int64_t>(offset_ns);
+        offset_ns += options.arrival == Arrival::POISSON ? gap(rng) * 1e9 : spacing_ns;
+
+        int64_t now = static_cast<int64_t>(ProtocolUtils::get_timestamp_ns());
+        while (now < intended) {
+            // Sleep while far ahead; spin the last stretch
+            if (intended - now > 200'000) std::this_thread::sleep_for(std::chrono::microseconds(100));
+            now = static_cast<int64_t>(ProtocolUtils::get_timestamp_ns());
+        }
+        result.max_send_lag_us = std::max(result.max_send_lag_us, (now - intended) / 1000.0);
+        client.schedule(intended);
+        if (!client.send_new_order(options.symbol, Side::BUY, 1, 100000, OrderType::IOC)) break;
+        ++result.sent;
+    }
+    const int64_t send_end = static_cast<int64_t>(ProtocolUtils::get_timestamp_ns());
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(options.drain_s);
+    while (client.responses() < result.sent && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    client.stop_receiver();
+    client.disconnect();
+
+    result.responses = client.responses();
+    result.rejected  = client.rejected();
+    result.histogram = client.histogram();
+    const double seconds = std::max(1e-9, (send_end - start) / 1e9);
+    result.achieved_rate = result.responses / seconds;
+    return result;
+}
+
+int run_open_loop_sweep(const std::string& host, uint16_t port, const OpenLoopOptions& options,
+                        PerfCounters* counters) {
+    std::cout << "=== Open-Loop Rate Sweep ===" << std::endl;
+    std::cout << "Target: " << host << ":" << port << ", " << options.duration_s << " s per rate, "
+              << (options.arrival == Arrival::POISSON ? "Poisson" : "constant") << " arrivals, IOC orders on "
+              << options.symbol << std::endl;
+    std::cout << "Latency: intended send time → final response (μs)\n" << std::endl;
+    std::cout << std::setw(10) << "offered" << std::setw(10) << "achieved" << std::setw(9) << "sent"
+              << std::setw(9) << "lost" << std::setw(8) << "rej" << std::setw(9) << "p50"
+              << std::setw(9) << "p90" << std::setw(9) << "p99" << std::setw(9) << "p99.9"
+              << std::setw(9) << "p99.99" << std::setw(10) << "max" << std::setw(11) << "send lag" << std::endl;
+
+    double knee = 0;
+    uint32_t client_id = 60000;
+    for (double rate : options.rates) {
+        PhaseCounters phase(counters);
+        const OpenLoopResult r = run_open_loop(host, port, client_id++, rate, options);
+        if (r.sent == 0) {
+            std::cerr << "  " << rate << "/s: connection failed" << std::endl;
+            return 1;
+        }
+        const auto& h = r.histogram;
+        const auto us = [&](double p) { return h.percentile(p) / 1000.0; };
+        std::cout << std::fixed << std::setprecision(0) << std::setw(10) << r.offered_rate
+                  << std::setw(10) << r.achieved_rate << std::setw(9) << r.sent
+                  << std::setw(9) << r.sent - r.responses << std::setw(8) << r.rejected
+                  << std::setprecision(1) << std::setw(9) << us(50) << std::setw(9) << us(90)
+                  << std::setw(9) << us(99) << std::setw(9) << us(99.9) << std::setw(9) << us(99.99)
+                  << std::setw(10) << h.max_ns() / 1000.0 << std::setw(11) << r.max_send_lag_us << std::endl;
+        phase.report(r.sent);
+
+        // Sustained: every order answered and the tail within the SLO
+        if (r.responses == r.sent && us(99) <= options.p99_slo_us) knee = std::max(knee, rate);
+        if (!options.hdr_prefix.empty()) {
+            std::ostringstream name;
+            name << options.hdr_prefix << "-" << static_cast<uint64_t>(rate) << ".hgrm";
+            write_hgrm(name.str(), h);
+        }
+    }
+    std::cout << "\nHighest rate meeting p99 ≤ " << options.p99_slo_us << " μs with no lost orders: ";
+    if (knee > 0) std::cout << std::setprecision(0) << knee << " orders/sec" << std::endl;
+    else std::cout << "none" << std::endl;
+    return 0;
+}
+
+/** "10000,20000" or "from:to:step" */
+std::vector<double> parse_rates(const std::string& text) {
+    std::vector<double> rates;
+    if (std::count(text.begin(), text.end(), ':') == 2) {
+        const size_t a = text.find(':');
+        const size_t b = text.find(':', a + 1);
+        const double from = std::stod(text.substr(0, a));
+        const double to   = std::stod(text.substr(a + 1, b - a - 1));
+        const double step = std::stod(text.substr(b + 1));
+        for (double rate = from; step > 0 && rate <= to + step / 2; rate += step) rates.push_back(rate);
+        return rates;
+    }
+    std::stringstream stream(text);
+    for (std::string item; std::getline(stream, item, ',');) {
+        if (!item.empty()) rates.push_back(std::stod(item));
+    }
+    return rates;
+}
+
 int main(int argc, char* argv[]) {
     std::string host = "localhost";
     uint16_t port = 8888;
+    bool open_loop = false;
+    OpenLoopOptions open_loop_options;
+    pid_t counters_pid = 0;
     
     // Parse command line arguments
-    for (int i = 1; i < argc; i += 2) {
-        if (i + 1 >= argc && std::string(argv[i]) != "--help") {
-            std::cerr << "Missing value for " << argv[i] << std::endl;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help") {
+            std::cout << "Usage: " << argv[0] << " [options]\n";
+            std::cout << "Options:\n";
+            std::cout << "  --host <host>      Exchange host (default: localhost)\n";
+            std::cout << "  --port <port>      Exchange port (default: 8888)\n";
+            std::cout << "  --open-loop        Rate sweep on a fixed send timeline instead of the test suite\n";
+            std::cout << "  --rates <list>     Offered orders/sec: \"a,b,c\" or \"from:to:step\" (default: 10000)\n";
+            std::cout << "  --duration <s>     Seconds per rate (default: 10)\n";
+            std::cout << "  --arrival <kind>   constant or poisson (default: constant)\n";
+            std::cout << "  --symbol <sym>     Instrument (default: AAPL)\n";
+            std::cout << "  --p99-slo <us>     p99 bound for the reported knee (default: 100)\n";
+            std::cout << "  --hdr <prefix>     Write <prefix>-<rate>.hgrm percentile files\n";
+            std::cout << "  --counters-pid <pid>  Hardware counters of the exchange process, per order and phase\n";
+            std::cout << "  --help             Show this help\n";
+            return 0;
+        }
+        if (arg == "--open-loop") {
+            open_loop = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
             return 1;
         }
-        
-        std::string arg = argv[i];
+        const std::string value = argv[++i];
         if (arg == "--host") {
-            host = argv[i + 1];
+            host = value;
         } else if (arg == "--port") {
-            port = std::stoi(argv[i + 1]);
-        } else if (arg == "--help") {
-            std::cout << "Usage: " << argv[0] << " [options]\n";
-            std::cout << "Options:\n";
-            std::cout << "  --host <host>    Exchange host (default: localhost)\n";
-            std::cout << "  --port <port>    Exchange port (default: 8888)\n";
-            std::cout << "  --help           Show this help\n";
-            return 0;
+            port = std::stoi(value);
+        } else if (arg == "--rates") {
+            open_loop_options.rates = parse_rates(value);
+        } else if (arg == "--duration") {
+            open_loop_options.duration_s = std::stod(value);
+        } else if (arg == "--arrival") {
+            open_loop_options.arrival = value == "poisson" ? Arrival::POISSON : Arrival::CONSTANT;
+        } else if (arg == "--symbol") {
+            open_loop_options.symbol = value;
+        } else if (arg == "--p99-slo") {
+            open_loop_options.p99_slo_us = std::stod(value);
+        } else if (arg == "--hdr") {
+            open_loop_options.hdr_prefix = value;
+        } else if (arg == "--counters-pid") {
+            counters_pid = static_cast<pid_t>(std::stol(value));
         } else {
             std::cerr << "Unknown option: " << arg << std::endl;
             return 1;
         }
     }
     
-    PerformanceHarness harness(host, port);
+    std::unique_ptr<PerfCounters> counters;
+    if (counters_pid > 0) {
+        counters = std::make_unique<PerfCounters>(counters_pid);
+        if (!counters->available()) {
+            std::cerr << "Hardware counters unavailable for pid " << counters_pid << " (" << counters->error()
+                      << "); continuing without" << std::endl;
+            counters.reset();
+        }
+    }
+
+    if (open_loop) {
+        if (open_loop_options.rates.empty()) open_loop_options.rates = {10000};
+        return run_open_loop_sweep(host, port, open_loop_options, counters.get());
+    }
+
+    PerformanceHarness harness(host, port, counters.get());
     harness.run_comprehensive_test();
     
     return 0;
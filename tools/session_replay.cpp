@@ -0,0 +1,291 @@
+#include "rtes/session_capture.hpp"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+/**
+ * Re-send a session capture (see session_capture.hpp) to an exchange.
+ *
+ * Every captured session gets its own TCP connection, opened at its
+ * first frame and closed at its CLOSE event. Frames go out in capture
+ * time order across sessions, at the captured gaps divided by --speed
+ * (or back to back with --speed max), so interleaving and bursts are
+ * kept. Responses are read and discarded, so the exchange never sees a
+ * slow consumer. The capture is loaded whole, so memory use is about
+ * the file's size.
+ *
+ * The send lag shows how far the replayer fell behind the schedule.
+ * When it is large, the replay did not reproduce the capture's bursts.
+ */
+
+namespace rtes {
+
+namespace {
+
+struct Event {
+    CaptureEventHeader header;
+    size_t             offset;  // Into the frame bytes
+};
+
+using SessionKey = std::tuple<uint8_t, uint16_t, uint32_t>;  // reactor, connection, generation
+
+SessionKey key_of(const CaptureEventHeader& header) {
+    return {header.reactor, header.connection, header.generation};
+}
+
+int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int connect_to(const std::string& host, uint16_t port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port   = htons(port);
+    if (::inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1 ||
+        ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    const int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return fd;
+}
+
+bool send_all(int fd, const uint8_t* data, size_t length) {
+    while (length > 0) {
+        const ssize_t sent = ::send(fd, data, length, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += sent;
+        length -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+class Replayer {
+public:
+    Replayer(std::string host, uint16_t port) : host_(std::move(host)), port_(port), epoll_fd_(::epoll_create1(0)) {}
+
+    ~Replayer() {
+        for (const auto& [key, fd] : sessions_) ::close(fd);
+        for (int fd : closing_) ::close(fd);
+        ::close(epoll_fd_);
+    }
+
+    /** Send one captured event; false if its session could not connect */
+    bool replay(const Event& event, const uint8_t* frame) {
+        const SessionKey key = key_of(event.header);
+        auto it = sessions_.find(key);
+        if (event.header.type == CaptureEventType::CLOSE) {
+            if (it != sessions_.end()) {
+                // Half close: a close() with responses unread would reset the
+                // connection and discard frames the exchange has not read yet
+                ::shutdown(it->second, SHUT_WR);
+                closing_.push_back(it->second);
+                sessions_.erase(it);
+            }
+            return true;
+        }
+        if (it == sessions_.end()) {
+            const int fd = connect_to(host_, port_);
+            if (fd < 0) return false;
+            epoll_event ev{};
+            ev.events  = EPOLLIN;
+            ev.data.fd = fd;
+            ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+            it = sessions_.emplace(key, fd).first;
+            ++sessions_opened_;
+        }
+        if (!send_all(it->second, frame, event.header.length)) return false;
+        ++frames_sent_;
+        bytes_sent_ += event.header.length;
+        return true;
+    }
+
+    /** Read whatever responses arrived, waiting up to timeout_ms for the first */
+    void drain(int timeout_ms) {
+        epoll_event events[64];
+        const int ready = ::epoll_wait(epoll_fd_, events, 64, timeout_ms);
+        for (int i = 0; i < ready; ++i) {
+            uint8_t buffer[65536];
+            const ssize_t got = ::recv(events[i].data.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (got > 0) {
+                bytes_received_ += static_cast<uint64_t>(got);
+            } else if (got == 0) {
+                ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, events[i].data.fd, nullptr);  // Exchange closed it
+            }
+        }
+    }
+
+    uint64_t sessions_opened() const { return sessions_opened_; }
+    uint64_t frames_sent() const { return frames_sent_; }
+    uint64_t bytes_sent() const { return bytes_sent_; }
+    uint64_t bytes_received() const { return bytes_received_; }
+
+private:
+    std::string                  host_;
+    uint16_t                     port_;
+    int                          epoll_fd_;
+    std::map<SessionKey, int>    sessions_;
+    std::vector<int>             closing_;  // Half closed, read until the exchange closes
+    uint64_t                     sessions_opened_{0};
+    uint64_t                     frames_sent_{0};
+    uint64_t                     bytes_sent_{0};
+    uint64_t                     bytes_received_{0};
+};
+
+void print_info(const std::vector<Event>& events, const SessionCaptureFileHeader& header) {
+    std::map<SessionKey, uint64_t> frames;
+    uint64_t bytes = 0;
+    size_t   burst = 0;  // Most frames within one millisecond
+    size_t   window_start = 0;
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (events[i].header.type != CaptureEventType::FRAME) continue;
+        ++frames[key_of(events[i].header)];
+        bytes += events[i].header.length;
+        while (events[i].header.time_ns - events[window_start].header.time_ns > 1'000'000) ++window_start;
+        burst = std::max(burst, i - window_start + 1);
+    }
+    const double span_s = events.empty() ? 0.0
+                              : (events.back().header.time_ns - events.front().header.time_ns) / 1e9;
+    uint64_t total = 0;
+    for (const auto& [key, count] : frames) total += count;
+    std::cout << "Reactors:   " << header.reactors << "\n"
+              << "Sessions:   " << frames.size() << "\n"
+              << "Frames:     " << total << " (" << bytes << " bytes)\n"
+              << "Span:       " << std::fixed << std::setprecision(3) << span_s << " s\n"
+              << "Peak:       " << burst << " frames in 1 ms\n";
+}
+
+} // namespace
+
+} // namespace rtes
+
+int main(int argc, char* argv[]) {
+    using namespace rtes;
+
+    std::string path;
+    std::string host = "127.0.0.1";
+    uint16_t    port = 8888;
+    double      speed = 1.0;  // 0 = max
+    double      drain_s = 2.0;
+    bool        info = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (arg == "--host" && has_value) {
+            host = argv[++i];
+        } else if (arg == "--port" && has_value) {
+            port = static_cast<uint16_t>(std::stoi(argv[++i]));
+        } else if (arg == "--speed" && has_value) {
+            const std::string value = argv[++i];
+            speed = value == "max" ? 0.0 : std::stod(value);
+        } else if (arg == "--drain" && has_value) {
+            drain_s = std::stod(argv[++i]);
+        } else if (arg == "--info") {
+            info = true;
+        } else if (arg == "--help" || arg[0] == '-') {
+            std::cout << "Usage: " << argv[0] << " <capture> [options]\n"
+                      << "  --host <ip>        Exchange address (default: 127.0.0.1)\n"
+                      << "  --port <port>      Order entry port (default: 8888)\n"
+                      << "  --speed <x|max>    Time scale: 1 = as captured, 10 = ten times faster,\n"
+                      << "                     max = back to back (default: 1)\n"
+                      << "  --drain <s>        Read responses this long after the last frame (default: 2)\n"
+                      << "  --info             Summarize the capture, do not send\n";
+            return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+        } else {
+            path = arg;
+        }
+    }
+    if (path.empty() || speed < 0) {
+        std::cerr << "Usage: " << argv[0] << " <capture> [--speed <x|max>] [--host <ip>] [--port <port>]\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<Event>   events;
+    std::vector<uint8_t> frames;
+    SessionCaptureFileHeader header;
+    bool truncated = false;
+    const bool ok = read_session_capture(path, [&](const CaptureEventHeader& event, const uint8_t* data) {
+        events.push_back({event, frames.size()});
+        frames.insert(frames.end(), data, data + event.length);
+    }, &header, &truncated);
+    if (!ok) {
+        std::cerr << "Not a session capture: " << path << "\n";
+        return EXIT_FAILURE;
+    }
+    if (truncated) std::cerr << "Capture ends in a truncated event: replaying the events before it\n";
+    // Each reactor's events are in order; the writer interleaves reactors by drain pass
+    std::stable_sort(events.begin(), events.end(), [](const Event& a, const Event& b) {
+        return a.header.time_ns < b.header.time_ns;
+    });
+
+    if (info) {
+        print_info(events, header);
+        return EXIT_SUCCESS;
+    }
+    if (events.empty()) {
+        std::cerr << "Empty capture\n";
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Replaying " << events.size() << " events to " << host << ":" << port << " at ";
+    if (speed > 0) std::cout << speed << "x" << std::endl;
+    else           std::cout << "max speed" << std::endl;
+
+    Replayer replayer(host, port);
+    const uint64_t first = events.front().header.time_ns;
+    const int64_t  start = now_ns();
+    int64_t  max_lag_ns = 0;
+    uint64_t failed = 0;
+    for (size_t i = 0; i < events.size(); ++i) {
+        const Event& event = events[i];
+        if (speed > 0) {
+            const int64_t due = start + static_cast<int64_t>((event.header.time_ns - first) / speed);
+            for (int64_t now = now_ns(); now < due; now = now_ns()) {
+                // Read responses while far ahead; spin the last stretch
+                if (due - now > 2'000'000) replayer.drain(1);
+                else if (due - now > 200'000) std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            max_lag_ns = std::max(max_lag_ns, now_ns() - due);
+        } else if ((i & 63) == 0) {
+            replayer.drain(0);
+        }
+        if (!replayer.replay(event, frames.data() + event.offset)) ++failed;
+    }
+    const double replay_s = (now_ns() - start) / 1e9;
+    const auto drain_end = std::chrono::steady_clock::now() + std::chrono::duration<double>(drain_s);
+    while (std::chrono::steady_clock::now() < drain_end) replayer.drain(10);
+
+    const double captured_s = (events.back().header.time_ns - first) / 1e9;
+    std::cout << std::fixed << std::setprecision(3)
+              << "Sessions:   " << replayer.sessions_opened() << "\n"
+              << "Frames:     " << replayer.frames_sent() << " (" << replayer.bytes_sent() << " bytes)"
+              << (failed ? ", " + std::to_string(failed) + " not sent (connect/send failed)" : "") << "\n"
+              << "Responses:  " << replayer.bytes_received() << " bytes\n"
+              << "Span:       " << replay_s << " s (captured " << captured_s << " s)\n";
+    if (speed > 0) std::cout << "Send lag:   " << max_lag_ns / 1000.0 << " us max behind schedule\n";
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
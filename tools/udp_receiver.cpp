@@ -1,12 +1,24 @@
 #include "rtes/market_data.hpp"
+#include "rtes/datagram_auth.hpp"
 #include <iostream>
+#include <iomanip>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <poll.h>
 #include <unistd.h>
 #include <cstring>
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <bit>
 #include <csignal>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 using namespace rtes;
 
@@ -16,159 +28,557 @@ void signal_handler(int) {
     running.store(false);
 }
 
+namespace {
+
+constexpr size_t RECV_BATCH = 64;          // Datagrams per recvmmsg
+constexpr size_t RECV_BUFFER = 2048;       // Larger than any datagram the publisher sends
+constexpr int    RECV_SOCKET_BUFFER = 8 << 20;
+constexpr int    POLL_TIMEOUT_MS = 100;    // Ctrl+C latency when the feed is quiet
+
+/**
+ * Log2 histogram of nanosecond delays: bucket i counts delays below 2^i ns.
+ * Percentiles are reported as the bucket's upper bound (within 2×).
+ */
+struct LatencyHistogram {
+    std::array<uint64_t, 64> buckets{};
+    uint64_t count{0};
+    uint64_t sum_ns{0};
+    uint64_t max_ns{0};
+
+    void record(int64_t delay_ns) {
+        const uint64_t ns = delay_ns > 0 ? static_cast<uint64_t>(delay_ns) : 0;
+        ++buckets[std::min<size_t>(std::bit_width(ns), buckets.size() - 1)];
+        ++count;
+        sum_ns += ns;
+        max_ns = std::max(max_ns, ns);
+    }
+
+    uint64_t percentile(double p) const {
+        const uint64_t rank = static_cast<uint64_t>(static_cast<double>(count) * p);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen > rank) return std::min(i == 0 ? 0 : uint64_t{1} << i, max_ns);
+        }
+        return max_ns;
+    }
+
+    void print(const char* name) const {
+        if (count == 0) return;
+        std::cout << "  " << std::left << std::setw(18) << name << std::right
+                  << " n=" << count
+                  << " avg=" << sum_ns / count / 1000.0 << "us"
+                  << " p50<=" << percentile(0.50) / 1000.0 << "us"
+                  << " p99<=" << percentile(0.99) / 1000.0 << "us"
+                  << " p99.9<=" << percentile(0.999) / 1000.0 << "us"
+                  << " max=" << max_ns / 1000.0 << "us\n";
+    }
+};
+
+/** One multicast group:port, with its own socket and sequence space */
+struct Channel {
+    std::string group;
+    uint16_t    port{0};
+    int         fd{-1};
+    uint64_t    expected_sequence{0};  // 0 = nothing received yet
+    uint64_t    packets{0};
+    uint64_t    messages{0};
+    uint64_t    gaps{0};
+    uint64_t    messages_missed{0};
+    uint64_t    stale_packets{0};      // Duplicate or reordered
+    uint64_t    auth_failures{0};      // Unsigned or bad tag (with --auth-key), dropped
+};
+
+/** A symbol's book, rebuilt from depth updates and snapshots */
+struct Book {
+    struct Level {
+        uint64_t quantity{0};
+        uint32_t order_count{0};
+    };
+    std::map<uint64_t, Level, std::greater<>> bids;
+    std::map<uint64_t, Level>                 asks;
+    uint64_t update_sequence{0};  // Latest book update applied
+    uint64_t depth_messages{0};
+    uint64_t snapshots_applied{0};
+    uint64_t order_updates{0};    // Market-by-order messages
+    uint64_t sweeps{0};           // Sweep summaries
+
+    // From BBO and trade messages
+    uint64_t bbo_bid{0}, bbo_ask{0};
+    uint64_t trades{0}, volume{0}, last_price{0};
+
+    void set_level(bool bid, const DepthLevel& level) {
+        if (bid) set(bids, level);
+        else     set(asks, level);
+    }
+
+private:
+    template <typename Side>
+    static void set(Side& side, const DepthLevel& level) {
+        if (level.quantity == 0) side.erase(level.price);
+        else side[level.price] = {level.quantity, level.order_count};
+    }
+};
+
+std::string symbol_of(const char (&symbol)[8]) {
+    return std::string(symbol, strnlen(symbol, sizeof(symbol)));
+}
+
+} // namespace
+
 class UdpReceiver {
 public:
-    UdpReceiver(const std::string& group, uint16_t port) 
-        : multicast_group_(group), port_(port) {}
-    
+    /**
+     * `handler` = reference feed handler: books and statistics instead of
+     * printing each message. `auth` (optional) = drop datagrams without a
+     * valid tag.
+     */
+    UdpReceiver(std::vector<Channel> channels, bool handler, unsigned report_interval_s,
+                std::unique_ptr<DatagramAuthenticator> auth)
+        : channels_(std::move(channels)), handler_(handler), report_interval_s_(report_interval_s),
+          auth_(std::move(auth)) {}
+
     bool start() {
-        socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
-        if (socket_fd_ < 0) {
+        for (Channel& channel : channels_) {
+            if (!open(channel)) return false;
+            std::cout << "Listening on " << channel.group << ":" << channel.port << "\n";
+        }
+        std::cout << "Press Ctrl+C to stop\n\n";
+        return true;
+    }
+
+    void run() {
+        std::vector<pollfd> fds;
+        for (const Channel& channel : channels_) fds.push_back({channel.fd, POLLIN, 0});
+        Timestamp next_report = now_timestamp() + Timestamp{report_interval_s_} * 1'000'000'000;
+
+        while (running.load(std::memory_order_relaxed)) {
+            if (poll(fds.data(), fds.size(), POLL_TIMEOUT_MS) > 0) {
+                for (size_t i = 0; i < fds.size(); ++i) {
+                    if (fds[i].revents & POLLIN) drain(channels_[i]);
+                }
+            }
+            if (handler_ && report_interval_s_ > 0 && now_timestamp() >= next_report) {
+                report_interval();
+                next_report += Timestamp{report_interval_s_} * 1'000'000'000;
+            }
+        }
+        report_totals();
+    }
+
+    void stop() {
+        for (Channel& channel : channels_) {
+            if (channel.fd >= 0) close(channel.fd);
+            channel.fd = -1;
+        }
+    }
+
+private:
+    std::vector<Channel> channels_;
+    bool handler_;
+    unsigned report_interval_s_;
+    std::unique_ptr<DatagramAuthenticator> auth_;
+
+    std::array<std::array<uint8_t, RECV_BUFFER>, RECV_BATCH> buffers_{};
+    std::unordered_map<std::string, Book> books_;
+    LatencyHistogram publish_latency_;  // Publisher send → receive
+    LatencyHistogram match_latency_;    // Engine match → receive (trades)
+    uint64_t unknown_messages_{0};
+    uint64_t batches_{0};
+
+    // Snapshot of the counters at the last interval report
+    uint64_t reported_messages_{0};
+    uint64_t reported_packets_{0};
+    Timestamp reported_at_{now_timestamp()};
+
+    bool open(Channel& channel) {
+        channel.fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (channel.fd < 0) {
             std::cerr << "Failed to create socket\n";
             return false;
         }
-        
+
         // Allow multiple receivers on same port
         int reuse = 1;
-        setsockopt(socket_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
-        
-        // Bind to any address on the specified port
+        setsockopt(channel.fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        // Ride out bursts while a batch is being processed
+        int rcvbuf = RECV_SOCKET_BUFFER;
+        setsockopt(channel.fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+        struct ip_mreq mreq{};
+        inet_pton(AF_INET, channel.group.c_str(), &mreq.imr_multiaddr);
+        mreq.imr_interface.s_addr = INADDR_ANY;
+        const bool multicast = IN_MULTICAST(ntohl(mreq.imr_multiaddr.s_addr));
+
+        // Bind the group itself (any address for unicast): a socket bound to
+        // INADDR_ANY also receives every other group joined on this port
         struct sockaddr_in addr{};
         addr.sin_family = AF_INET;
-        addr.sin_addr.s_addr = INADDR_ANY;
-        addr.sin_port = htons(port_);
-        
-        if (bind(socket_fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        addr.sin_addr.s_addr = multicast ? mreq.imr_multiaddr.s_addr : INADDR_ANY;
+        addr.sin_port = htons(channel.port);
+
+        if (bind(channel.fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
             std::cerr << "Failed to bind socket\n";
             return false;
         }
-        
-        // Join multicast group
-        struct ip_mreq mreq{};
-        inet_pton(AF_INET, multicast_group_.c_str(), &mreq.imr_multiaddr);
-        mreq.imr_interface.s_addr = INADDR_ANY;
-        
-        if (setsockopt(socket_fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+        if (!multicast) return true;
+
+#ifdef IP_MULTICAST_ALL
+        // Only the groups this socket joined, not every group the host has
+        int all = 0;
+        setsockopt(channel.fd, IPPROTO_IP, IP_MULTICAST_ALL, &all, sizeof(all));
+#endif
+        if (setsockopt(channel.fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
             std::cerr << "Failed to join multicast group\n";
             return false;
         }
-        
-        std::cout << "Listening on " << multicast_group_ << ":" << port_ << "\n";
-        std::cout << "Press Ctrl+C to stop\n\n";
-        
         return true;
     }
-    
-    void run() {
-        uint8_t buffer[1024];
-        uint64_t expected_sequence = 1;
-        uint64_t messages_received = 0;
-        uint64_t gaps_detected = 0;
-        
-        while (running.load()) {
-            ssize_t received = recv(socket_fd_, buffer, sizeof(buffer), 0);
-            if (received < static_cast<ssize_t>(sizeof(UdpMessageHeader))) {
-                continue;
-            }
-            
-            const UdpMessageHeader* header = reinterpret_cast<const UdpMessageHeader*>(buffer);
-            
-            // Check for gaps
-            if (header->sequence != expected_sequence) {
-                if (messages_received > 0) {  // Skip first message gap check
-                    gaps_detected++;
-                    std::cout << "GAP DETECTED: Expected " << expected_sequence 
-                              << ", got " << header->sequence << "\n";
+
+    /**
+     * Every datagram queued on the channel, RECV_BATCH per syscall. With
+     * a key, each batch's tags are checked in one pass before any of it
+     * is parsed; failures are counted and dropped.
+     */
+    void drain(Channel& channel) {
+        std::array<iovec, RECV_BATCH> iovecs{};
+        std::array<mmsghdr, RECV_BATCH> msgs{};
+        for (size_t i = 0; i < RECV_BATCH; ++i) {
+            iovecs[i] = {buffers_[i].data(), RECV_BUFFER};
+            msgs[i].msg_hdr.msg_iov = &iovecs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        for (;;) {
+            const int received = recvmmsg(channel.fd, msgs.data(), RECV_BATCH, MSG_DONTWAIT, nullptr);
+            if (received <= 0) return;
+            ++batches_;
+            const Timestamp now = now_timestamp();  // One clock read per batch
+            std::array<bool, RECV_BATCH> authentic;
+            authentic.fill(true);
+            if (auth_) {
+                std::array<const uint8_t*, RECV_BATCH> datagrams;
+                std::array<size_t, RECV_BATCH> sizes;
+                for (int i = 0; i < received; ++i) {
+                    datagrams[i] = buffers_[i].data();
+                    sizes[i] = msgs[i].msg_len;
                 }
-                expected_sequence = header->sequence;
+                const size_t passed = auth_->verify_batch(datagrams.data(), sizes.data(), received, authentic.data());
+                channel.auth_failures += static_cast<size_t>(received) - passed;
             }
-            expected_sequence++;
-            messages_received++;
-            
-            // Process message based on type
-            switch (header->type) {
-                case BBO_UPDATE:
-                    if (received >= static_cast<ssize_t>(sizeof(BBOUpdateMessage))) {
-                        process_bbo_update(*reinterpret_cast<const BBOUpdateMessage*>(buffer));
-                    }
-                    break;
-                    
-                case TRADE_UPDATE:
-                    if (received >= static_cast<ssize_t>(sizeof(TradeUpdateMessage))) {
-                        process_trade_update(*reinterpret_cast<const TradeUpdateMessage*>(buffer));
-                    }
-                    break;
-                    
-                case DEPTH_UPDATE:
-                    if (received >= static_cast<ssize_t>(sizeof(DepthUpdateMessage))) {
-                        process_depth_update(*reinterpret_cast<const DepthUpdateMessage*>(buffer));
-                    }
-                    break;
-                    
-                default:
-                    std::cout << "Unknown message type: " << header->type << "\n";
-                    break;
+            for (int i = 0; i < received; ++i) {
+                if (authentic[i]) on_packet(channel, buffers_[i].data(), msgs[i].msg_len, now);
             }
+            if (received < static_cast<int>(RECV_BATCH)) return;
         }
-        
-        std::cout << "\nStatistics:\n";
-        std::cout << "Messages received: " << messages_received << "\n";
-        std::cout << "Gaps detected: " << gaps_detected << "\n";
     }
-    
-    void stop() {
-        if (socket_fd_ >= 0) {
-            close(socket_fd_);
-            socket_fd_ = -1;
+
+    void on_packet(Channel& channel, const uint8_t* data, size_t received, Timestamp now) {
+        if (received < sizeof(UdpPacketHeader)) return;
+        UdpPacketHeader packet;
+        std::memcpy(&packet, data, sizeof(packet));
+        ++channel.packets;
+
+        // Gap detection on packet boundaries: a packet carries message_count consecutive sequences
+        if (channel.expected_sequence != 0 && packet.sequence != channel.expected_sequence) {
+            if (packet.sequence < channel.expected_sequence) {
+                ++channel.stale_packets;
+                return;
+            }
+            ++channel.gaps;
+            channel.messages_missed += packet.sequence - channel.expected_sequence;
+            if (!handler_) {
+                std::cout << "GAP DETECTED on " << channel.group << ":" << channel.port
+                          << ": Expected " << channel.expected_sequence
+                          << ", got " << packet.sequence << "\n";
+            }
+        }
+        channel.expected_sequence = packet.sequence + packet.message_count;
+
+        size_t offset = sizeof(UdpPacketHeader);
+        for (uint16_t i = 0; i < packet.message_count; ++i) {
+            if (offset + sizeof(UdpMessageHeader) > received) break;
+            const uint8_t* message = data + offset;
+            UdpMessageHeader header;
+            std::memcpy(&header, message, sizeof(header));
+            const size_t remaining = received - offset;
+            if (header.length < sizeof(UdpMessageHeader) || header.length > remaining) break;
+            offset += header.length;
+            ++channel.messages;
+            if (handler_) publish_latency_.record(static_cast<int64_t>(now - header.timestamp_ns));
+            dispatch(header.type, message, remaining, now);
+        }
+    }
+
+    void dispatch(uint32_t type, const uint8_t* message, size_t remaining, Timestamp now) {
+        switch (type) {
+            case BBO_UPDATE:
+                if (remaining >= sizeof(BBOUpdateMessage)) {
+                    process_bbo_update(*reinterpret_cast<const BBOUpdateMessage*>(message));
+                }
+                break;
+
+            case TRADE_UPDATE:
+                if (remaining >= sizeof(TradeUpdateMessage)) {
+                    process_trade_update(*reinterpret_cast<const TradeUpdateMessage*>(message), now);
+                }
+                break;
+
+            case DEPTH_UPDATE:
+                if (remaining >= sizeof(DepthUpdateMessage)) {
+                    process_depth_update(*reinterpret_cast<const DepthUpdateMessage*>(message));
+                }
+                break;
+
+            case SWEEP_SUMMARY:
+                if (remaining >= sizeof(SweepSummaryMessage)) {
+                    process_sweep_summary(*reinterpret_cast<const SweepSummaryMessage*>(message));
+                }
+                break;
+
+            case ORDER_UPDATE:
+                if (remaining >= sizeof(OrderUpdateMessage)) {
+                    process_order_update(*reinterpret_cast<const OrderUpdateMessage*>(message));
+                }
+                break;
+
+            case DEPTH_SNAPSHOT:
+                if (remaining >= sizeof(DepthSnapshotMessage)) {
+                    process_depth_snapshot(*reinterpret_cast<const DepthSnapshotMessage*>(message));
+                }
+                break;
+
+            default:
+                ++unknown_messages_;
+                if (!handler_) std::cout << "Unknown message type: " << type << "\n";
+                break;
         }
     }
 
-private:
-    std::string multicast_group_;
-    uint16_t port_;
-    int socket_fd_{-1};
-    
     void process_bbo_update(const BBOUpdateMessage& msg) {
-        std::cout << "BBO " << msg.symbol 
+        if (handler_) {
+            Book& book = books_[symbol_of(msg.symbol)];
+            book.bbo_bid = msg.bid_price;
+            book.bbo_ask = msg.ask_price;
+            return;
+        }
+        std::cout << "BBO " << msg.symbol
                   << " Bid:" << (msg.bid_price / 10000.0) << "x" << msg.bid_quantity
                   << " Ask:" << (msg.ask_price / 10000.0) << "x" << msg.ask_quantity
                   << " Seq:" << msg.header.sequence << "\n";
     }
-    
-    void process_trade_update(const TradeUpdateMessage& msg) {
-        std::cout << "TRADE " << msg.symbol 
+
+    void process_trade_update(const TradeUpdateMessage& msg, Timestamp now) {
+        if (handler_) {
+            Book& book = books_[symbol_of(msg.symbol)];
+            ++book.trades;
+            book.volume += msg.quantity;
+            book.last_price = msg.price;
+            match_latency_.record(static_cast<int64_t>(now - msg.match_timestamp_ns));
+            return;
+        }
+        std::cout << "TRADE " << msg.symbol
                   << " ID:" << msg.trade_id
                   << " " << msg.quantity << "@" << (msg.price / 10000.0)
-                  << " Side:" << (msg.aggressor_side == 1 ? "BUY" : "SELL")
+                  << " Side:" << (msg.aggressor_side == 1 ? "BUY" : msg.aggressor_side == 2 ? "SELL" : "AUCTION")
+                  << " Delay:" << (msg.header.timestamp_ns - msg.match_timestamp_ns) << "ns"
                   << " Seq:" << msg.header.sequence << "\n";
     }
-    
+
+    void process_sweep_summary(const SweepSummaryMessage& msg) {
+        if (handler_) {
+            ++books_[symbol_of(msg.symbol)].sweeps;
+            return;
+        }
+        std::cout << "SWEEP " << msg.symbol
+                  << " " << (msg.aggressor_side == 1 ? "BUY " : "SELL ") << msg.fills << " fills "
+                  << msg.quantity << " " << (msg.first_price / 10000.0) << "-" << (msg.last_price / 10000.0)
+                  << " FirstID:" << msg.first_trade_id
+                  << " Seq:" << msg.header.sequence << "\n";
+    }
+
+    void process_order_update(const OrderUpdateMessage& msg) {
+        if (handler_) {
+            ++books_[symbol_of(msg.symbol)].order_updates;
+            return;
+        }
+        static constexpr const char* KINDS[] = {"?", "ADD", "EXEC", "CANCEL", "MODIFY"};
+        std::cout << "ORDER " << msg.symbol << " " << KINDS[msg.kind <= 4 ? msg.kind : 0]
+                  << " ID:" << msg.order_id
+                  << " " << (msg.side == 1 ? "BUY " : "SELL ") << msg.remaining << "@" << (msg.price / 10000.0);
+        if (msg.quantity) std::cout << " Traded:" << msg.quantity;
+        std::cout << " Seq:" << msg.header.sequence << "\n";
+    }
+
     void process_depth_update(const DepthUpdateMessage& msg) {
-        std::cout << "DEPTH " << msg.symbol 
+        if (handler_) {
+            // One update may span several messages with the same update_sequence
+            Book& book = books_[symbol_of(msg.symbol)];
+            ++book.depth_messages;
+            if (msg.update_sequence < book.update_sequence) return;  // Already in the snapshot
+            book.update_sequence = msg.update_sequence;
+            const int count = std::min(msg.num_bid_levels + msg.num_ask_levels, 20);
+            for (int i = 0; i < count; ++i) book.set_level(i < msg.num_bid_levels, msg.levels[i]);
+            return;
+        }
+        std::cout << "DEPTH " << msg.symbol
                   << " Bids:" << static_cast<int>(msg.num_bid_levels)
                   << " Asks:" << static_cast<int>(msg.num_ask_levels)
+                  << " Update:" << msg.update_sequence
+                  << " Seq:" << msg.header.sequence << "\n";
+        const int count = std::min(msg.num_bid_levels + msg.num_ask_levels, 20);
+        for (int i = 0; i < count; ++i) {
+            std::cout << "  " << (i < msg.num_bid_levels ? "BID " : "ASK ")
+                      << msg.levels[i].quantity << "@" << (msg.levels[i].price / 10000.0)
+                      << " (" << msg.levels[i].order_count << " orders)\n";
+        }
+    }
+
+    void process_depth_snapshot(const DepthSnapshotMessage& msg) {
+        if (handler_) {
+            // Replaces the book unless incremental updates have already moved past it
+            Book& book = books_[symbol_of(msg.symbol)];
+            if (msg.update_sequence <= book.update_sequence) return;
+            book.bids.clear();
+            book.asks.clear();
+            book.update_sequence = msg.update_sequence;
+            ++book.snapshots_applied;
+            const int count = std::min(msg.num_bid_levels + msg.num_ask_levels, 40);
+            for (int i = 0; i < count; ++i) book.set_level(i < msg.num_bid_levels, msg.levels[i]);
+            return;
+        }
+        std::cout << "SNAPSHOT " << msg.symbol
+                  << " (" << (msg.book_index + 1) << "/" << msg.book_count << ")"
+                  << " Channel:" << static_cast<int>(msg.channel)
+                  << " Update:" << msg.update_sequence
                   << " Seq:" << msg.header.sequence << "\n";
+        const int count = std::min(msg.num_bid_levels + msg.num_ask_levels, 40);
+        for (int i = 0; i < count; ++i) {
+            std::cout << "  " << (i < msg.num_bid_levels ? "BID " : "ASK ")
+                      << msg.levels[i].quantity << "@" << (msg.levels[i].price / 10000.0)
+                      << " (" << msg.levels[i].order_count << " orders)\n";
+        }
+    }
+
+    uint64_t total(uint64_t Channel::*counter) const {
+        uint64_t sum = 0;
+        for (const Channel& channel : channels_) sum += channel.*counter;
+        return sum;
+    }
+
+    void report_interval() {
+        const Timestamp now = now_timestamp();
+        const double seconds = static_cast<double>(now - reported_at_) / 1e9;
+        const uint64_t messages = total(&Channel::messages);
+        const uint64_t packets = total(&Channel::packets);
+        std::cout << std::fixed << std::setprecision(0)
+                  << (messages - reported_messages_) / seconds << " msg/s, "
+                  << (packets - reported_packets_) / seconds << " pkt/s, "
+                  << total(&Channel::gaps) << " gaps, "
+                  << std::setprecision(1)
+                  << "publish->recv p99<=" << publish_latency_.percentile(0.99) / 1000.0 << "us\n"
+                  << std::defaultfloat;
+        reported_messages_ = messages;
+        reported_packets_ = packets;
+        reported_at_ = now;
+    }
+
+    void report_totals() {
+        std::cout << "\nStatistics:\n";
+        std::cout << "Messages received: " << total(&Channel::messages) << "\n";
+        std::cout << "Packets received: " << total(&Channel::packets) << "\n";
+        std::cout << "Gaps detected: " << total(&Channel::gaps) << "\n";
+        if (auth_) std::cout << "Authentication failures: " << total(&Channel::auth_failures) << "\n";
+        if (!handler_) return;
+
+        const uint64_t packets = total(&Channel::packets);
+        std::cout << "Datagrams per recvmmsg: " << (batches_ ? static_cast<double>(packets) / batches_ : 0.0) << "\n";
+        std::cout << "Unknown messages: " << unknown_messages_ << "\n";
+        for (const Channel& channel : channels_) {
+            std::cout << "  " << channel.group << ":" << channel.port
+                      << " packets=" << channel.packets << " messages=" << channel.messages
+                      << " gaps=" << channel.gaps << " missed=" << channel.messages_missed
+                      << " stale=" << channel.stale_packets << "\n";
+        }
+
+        std::cout << "Latency (same-host monotonic clock):\n";
+        publish_latency_.print("publish->recv");
+        match_latency_.print("match->recv");
+
+        std::cout << "Books:\n";
+        std::vector<const std::pair<const std::string, Book>*> sorted;
+        for (const auto& entry : books_) sorted.push_back(&entry);
+        std::sort(sorted.begin(), sorted.end(), [](auto* a, auto* b) { return a->first < b->first; });
+        for (const auto* entry : sorted) {
+            const Book& book = entry->second;
+            std::cout << "  " << std::left << std::setw(8) << entry->first << std::right
+                      << " update=" << book.update_sequence
+                      << " levels=" << book.bids.size() << "x" << book.asks.size();
+            if (!book.bids.empty()) std::cout << " bid=" << book.bids.begin()->first / 10000.0;
+            if (!book.asks.empty()) std::cout << " ask=" << book.asks.begin()->first / 10000.0;
+            std::cout << " bbo=" << book.bbo_bid / 10000.0 << "/" << book.bbo_ask / 10000.0
+                      << " trades=" << book.trades << " volume=" << book.volume
+                      << " last=" << book.last_price / 10000.0
+                      << " snapshots=" << book.snapshots_applied;
+            if (book.order_updates) std::cout << " orders=" << book.order_updates;
+            if (book.sweeps) std::cout << " sweeps=" << book.sweeps;
+            std::cout << "\n";
+        }
     }
 };
 
 int main(int argc, char* argv[]) {
-    if (argc != 3) {
-        std::cout << "Usage: " << argv[0] << " <multicast_group> <port>\n";
+    bool handler = false;
+    unsigned interval = 1;
+    std::string auth_key;
+    std::vector<Channel> channels;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--handler") {
+            handler = true;
+        } else if (arg == "--interval" && i + 1 < argc) {
+            interval = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--auth-key" && i + 1 < argc) {
+            auth_key = argv[++i];
+        } else if (i + 1 < argc) {
+            Channel channel;
+            channel.group = arg;
+            channel.port = static_cast<uint16_t>(std::stoi(argv[++i]));
+            channels.push_back(std::move(channel));
+        } else {
+            channels.clear();
+            break;
+        }
+    }
+    if (channels.empty()) {
+        std::cout << "Usage: " << argv[0] << " [--handler [--interval SECONDS]] [--auth-key KEY] <group> <port> [<group> <port> ...]\n";
         std::cout << "Example: " << argv[0] << " 239.0.0.1 9999\n";
+        std::cout << "         " << argv[0] << " --handler 239.0.0.1 9999 239.0.0.2 9999 239.0.0.9 9998\n";
+        std::cout << "  --handler   Build books and report rates, gaps and latency instead of printing messages\n";
+        std::cout << "  --interval  Seconds between handler reports (0 = only at exit, default 1)\n";
+        std::cout << "  --auth-key  Drop datagrams without a valid tag for this key (performance.market_data_auth_key)\n";
         return 1;
     }
-    
+
     std::signal(SIGINT, signal_handler);
     std::signal(SIGTERM, signal_handler);
-    
-    UdpReceiver receiver(argv[1], std::stoi(argv[2]));
-    
+
+    std::unique_ptr<DatagramAuthenticator> auth;
+    if (!auth_key.empty()) {
+        auth = std::make_unique<DatagramAuthenticator>(auth_key);
+        if (!auth->ready()) {
+            std::cerr << "Datagram authentication is unavailable in this build\n";
+            return 1;
+        }
+    }
+
+    UdpReceiver receiver(std::move(channels), handler, interval, std::move(auth));
+
     if (!receiver.start()) {
         return 1;
     }
-    
+
     receiver.run();
     receiver.stop();
-    
+
     return 0;
-}
\ No newline at end of file
+}